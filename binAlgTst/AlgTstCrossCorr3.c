@@ -0,0 +1,337 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _AlgTstCrossCorr3_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binAlgTst/AlgTstCrossCorr3.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for AlgCrossCorrelate2D() and AlgCrossCorrelate2DFT().
+* 		Random arrays are cross correlated by both functions,
+* 		with a single Fourier transform of the first array
+* 		being used for several cross correlations by
+* 		AlgCrossCorrelate2DFT(), and the results are compared
+* 		with a direct (spatial domain) circular cross
+* 		correlation.
+* \ingroup	binAlgTst
+*/
+#include <stdio.h>
+#include <float.h>
+#include <Alc.h>
+#include <Alg.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char     *optarg;
+extern int      optind,
+		opterr,
+		optopt;
+
+static void			AlgTstCrossCorr3Direct(
+				  double **cc,
+				  double **data0,
+				  double **data1,
+				  int nX,
+				  int nY);
+static double			AlgTstCrossCorr3Diff(
+				  double **data0,
+				  double **data1,
+				  int nX,
+				  int nY);
+
+int		main(int argc, char *argv[])
+{
+  int		idS,
+  		idR,
+		idX,
+		idY,
+		nX,
+		nY,
+		option,
+		ok = 1,
+		usage = 0,
+		nRep = 3,
+		verbose = 0;
+  long		seed = 0;
+  double	d,
+  		maxD = 0.0;
+  double	**data0 = NULL,
+  		**data1 = NULL,
+		**ft0 = NULL,
+		**cc0 = NULL,
+		**cc1 = NULL;
+  AlgError	errNum = ALG_ERR_NONE;
+  const double	eps = 1.0e-9;
+  const int	nSz = 4,
+  		szX[4] = {8, 32, 64, 16},
+  		szY[4] = {8, 16, 64, 128};
+  static char	optList[] = "hn:s:v";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'n':
+        if((sscanf(optarg, "%d", &nRep) != 1) || (nRep < 1))
+	{
+	  usage = 1;
+	}
+	break;
+      case 's':
+        if(sscanf(optarg, "%ld", &seed) != 1)
+	{
+	  usage = 1;
+	}
+	break;
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0);
+  if(ok)
+  {
+    AlgRandSeed(seed);
+  }
+  for(idS = 0; ok && (idS < nSz); ++idS)
+  {
+    nX = szX[idS];
+    nY = szY[idS];
+    if((AlcDouble2Malloc(&data0, nY, nX) != ALC_ER_NONE) ||
+       (AlcDouble2Malloc(&data1, nY, nX) != ALC_ER_NONE) ||
+       (AlcDouble2Malloc(&ft0, nY, nX) != ALC_ER_NONE) ||
+       (AlcDouble2Malloc(&cc0, nY, nX) != ALC_ER_NONE) ||
+       (AlcDouble2Malloc(&cc1, nY, nX) != ALC_ER_NONE))
+    {
+      ok = 0;
+      (void )fprintf(stderr, "%s: Failed to allocate data arrays.\n", *argv);
+    }
+    if(ok)
+    {
+      /* Transform the first array just once for all repeats. */
+      for(idY = 0; idY < nY; ++idY)
+      {
+	for(idX = 0; idX < nX; ++idX)
+	{
+	  data0[idY][idX] = ft0[idY][idX] = AlgRandUniform() - 0.5;
+	}
+      }
+      errNum = AlgFourReal2D(ft0, 1, nX, nY);
+    }
+    for(idR = 0; ok && (errNum == ALG_ERR_NONE) && (idR < nRep); ++idR)
+    {
+      for(idY = 0; idY < nY; ++idY)
+      {
+	for(idX = 0; idX < nX; ++idX)
+	{
+	  data1[idY][idX] = AlgRandUniform() - 0.5;
+	}
+      }
+      AlgTstCrossCorr3Direct(cc0, data0, data1, nX, nY);
+      /* AlgCrossCorrelate2D() overwrites both arrays, so use copies with
+       * the result being left in the first. */
+      for(idY = 0; idY < nY; ++idY)
+      {
+	for(idX = 0; idX < nX; ++idX)
+	{
+	  cc1[idY][idX] = data0[idY][idX];
+	}
+      }
+      errNum = AlgCrossCorrelate2D(cc1, data1, nX, nY);
+      if(errNum == ALG_ERR_NONE)
+      {
+	d = AlgTstCrossCorr3Diff(cc0, cc1, nX, nY);
+	maxD = ALG_MAX(maxD, d);
+	if(verbose)
+	{
+	  (void )fprintf(stderr, "%s: %dx%d AlgCrossCorrelate2D() %g\n",
+	  		 *argv, nX, nY, d);
+	}
+	if(d > eps)
+	{
+	  ok = 0;
+	  (void )fprintf(stderr,
+	  		 "%s: %dx%d AlgCrossCorrelate2D() differs from direct "
+			 "cross correlation by %g.\n",
+			 *argv, nX, nY, d);
+	}
+      }
+      if(ok && (errNum == ALG_ERR_NONE))
+      {
+	/* AlgCrossCorrelate2D() has transformed data1, so make new data
+	 * for the cross correlation with the transform of data0. */
+	for(idY = 0; idY < nY; ++idY)
+	{
+	  for(idX = 0; idX < nX; ++idX)
+	  {
+	    data1[idY][idX] = cc1[idY][idX] = AlgRandUniform() - 0.5;
+	  }
+	}
+	AlgTstCrossCorr3Direct(cc0, data0, data1, nX, nY);
+	errNum = AlgCrossCorrelate2DFT(ft0, cc1, nX, nY);
+	if(errNum == ALG_ERR_NONE)
+	{
+	  d = AlgTstCrossCorr3Diff(cc0, cc1, nX, nY);
+	  maxD = ALG_MAX(maxD, d);
+	  if(verbose)
+	  {
+	    (void )fprintf(stderr, "%s: %dx%d AlgCrossCorrelate2DFT() %g\n",
+	    		   *argv, nX, nY, d);
+	  }
+	  if(d > eps)
+	  {
+	    ok = 0;
+	    (void )fprintf(stderr,
+			   "%s: %dx%d AlgCrossCorrelate2DFT() differs from "
+			   "direct cross correlation by %g.\n",
+			   *argv, nX, nY, d);
+	  }
+	}
+      }
+    }
+    if(ok && (errNum != ALG_ERR_NONE))
+    {
+      ok = 0;
+      (void )fprintf(stderr, "%s: Failed to cross correlate %dx%d arrays.\n",
+      		     *argv, nX, nY);
+    }
+    Alc2Free((void **)data0);
+    Alc2Free((void **)data1);
+    Alc2Free((void **)ft0);
+    Alc2Free((void **)cc0);
+    Alc2Free((void **)cc1);
+    data0 = data1 = ft0 = cc0 = cc1 = NULL;
+  }
+  if(ok)
+  {
+    (void )printf("%s: Frequency domain cross correlations match direct "
+    		  "cross correlation (maximum difference %g).\n",
+		  *argv, maxD);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-n #] [-s #] [-v]\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -n  Number of repeats for each array size (default 3).\n"
+    "  -s  Seed for random number generator (default 0).\n"
+    "  -v  Verbose output.\n"
+    "Tests AlgCrossCorrelate2D() and AlgCrossCorrelate2DFT() by cross\n"
+    "correlating random arrays of several sizes, with the Fourier\n"
+    "transform of the first array being reused by\n"
+    "AlgCrossCorrelate2DFT(), and comparing the results with a direct\n"
+    "circular cross correlation.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \ingroup	binAlgTst
+* \brief	Computes the circular cross correlation of the two
+* 		given arrays directly, with the same layout as the
+* 		frequency domain functions, ie with a shift of
+* 		(dX, dY) at cc[dY][dX] (modulo the array size) and
+* 		scaled by the number of array elements because the
+* 		inverse Fourier transform is not normalised.
+* \param	cc			Destination array.
+* \param	data0			First array.
+* \param	data1			Second array.
+* \param	nX			Number of columns.
+* \param	nY			Number of lines.
+*/
+static void	AlgTstCrossCorr3Direct(double **cc, double **data0,
+				       double **data1, int nX, int nY)
+{
+  int		dX,
+  		dY,
+		idX,
+		idY;
+
+  for(dY = 0; dY < nY; ++dY)
+  {
+    for(dX = 0; dX < nX; ++dX)
+    {
+      double	sum = 0.0;
+
+      for(idY = 0; idY < nY; ++idY)
+      {
+	double	*r0,
+		*r1;
+
+        r0 = data0[(idY + dY) % nY];
+	r1 = data1[idY];
+	for(idX = 0; idX < nX; ++idX)
+	{
+	  sum += r0[(idX + dX) % nX] * r1[idX];
+	}
+      }
+      cc[dY][dX] = sum * nX * nY;
+    }
+  }
+}
+
+/*!
+* \return	Maximum absolute difference scaled by the maximum
+* 		absolute value of the first array.
+* \ingroup	binAlgTst
+* \brief	Compares two arrays.
+* \param	data0			First (reference) array.
+* \param	data1			Second array.
+* \param	nX			Number of columns.
+* \param	nY			Number of lines.
+*/
+static double	AlgTstCrossCorr3Diff(double **data0, double **data1,
+				     int nX, int nY)
+{
+  int		idX,
+  		idY;
+  double	mx = DBL_EPSILON,
+  		d = 0.0;
+
+  for(idY = 0; idY < nY; ++idY)
+  {
+    for(idX = 0; idX < nX; ++idX)
+    {
+      mx = ALG_MAX(mx, fabs(data0[idY][idX]));
+      d = ALG_MAX(d, fabs(data0[idY][idX] - data1[idY][idX]));
+    }
+  }
+  return(d / mx);
+}
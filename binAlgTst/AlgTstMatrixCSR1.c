@@ -0,0 +1,345 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _AlgTstMatrixCSR1_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binAlgTst/AlgTstMatrixCSR1.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+* 
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for compressed sparse row matrices and the
+* 		preconditioned iterative solvers. A sparse symmetric
+* 		positive definite matrix is built for the five point
+* 		Laplacian (plus a small diagonal shift) on a square grid,
+* 		both as a linked list row matrix and as a compressed
+* 		sparse row matrix, their products with a vector are
+* 		compared and then the system is solved using either
+* 		AlgMatrixCGSolve() or AlgMatrixSolveLSQRPrecond().
+* \ingroup	binAlgTst
+*/
+#include <sys/time.h>
+#include <stdio.h>
+#include <float.h>
+#include <Alc.h>
+#include <Alg.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char     *optarg;
+extern int      optind,
+		opterr,
+		optopt;
+
+int             main(int argc, char *argv[])
+{
+  int		option,
+		ok = 0,
+		itr = 10000,
+		lsqr = 0,
+		timer = 0,
+		usage = 0;
+  long		lItr = 0;
+  size_t	idx,
+		nG = 64,
+		nN = 0,
+		nT = 0;
+  double	del = 0.0,
+		res = 0.0,
+		tol = 1.0e-9;
+  double	*bV = NULL,
+		*xV = NULL,
+		*tV = NULL,
+		*uV = NULL;
+  AlgMatrix	aM,
+		cM,
+		lM,
+		wM;
+  AlgMatrixTriple *tri = NULL;
+  AlgMatrixPrecond *pc = NULL;
+  AlgMatrixPrecondType pcType = ALG_MATRIX_PRECOND_NONE;
+  AlgMatrixType	aType = ALG_MATRIX_CSR;
+  AlgError      errCode = ALG_ERR_NONE;
+  struct timeval times[3];
+  const char	*optList = "hi:ln:p:t:LT";
+
+  aM.core = cM.core = lM.core = wM.core = NULL;
+  while((usage == 0) && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'i':
+        if((sscanf(optarg, "%d", &itr) != 1) || (itr < 1))
+	{
+	  usage = 1;
+	}
+	break;
+      case 'l':
+        lsqr = 1;
+	break;
+      case 'n':
+        if((sscanf(optarg, "%zd", &nG) != 1) || (nG < 2))
+	{
+	  usage = 1;
+	}
+	break;
+      case 'p':
+        switch(*optarg)
+	{
+	  case 'n':
+	    pcType = ALG_MATRIX_PRECOND_NONE;
+	    break;
+	  case 'j':
+	    pcType = ALG_MATRIX_PRECOND_JACOBI;
+	    break;
+	  case 'i':
+	    pcType = ALG_MATRIX_PRECOND_ICHOL;
+	    break;
+	  default:
+	    usage = 1;
+	    break;
+	}
+	break;
+      case 't':
+        if((sscanf(optarg, "%lg", &tol) != 1) || (tol <= 0.0))
+	{
+	  usage = 1;
+	}
+	break;
+      case 'L':
+	aType = ALG_MATRIX_LLR;
+	break;
+      case 'T':
+	timer = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0);
+  if(ok)
+  {
+    nN = nG * nG;
+    if(((tri = (AlgMatrixTriple *)
+	       AlcMalloc(6 * nN * sizeof(AlgMatrixTriple))) == NULL) ||
+       ((bV = (double *)AlcMalloc(nN * sizeof(double))) == NULL) ||
+       ((xV = (double *)AlcMalloc(nN * sizeof(double))) == NULL) ||
+       ((tV = (double *)AlcMalloc(nN * sizeof(double))) == NULL) ||
+       ((uV = (double *)AlcMalloc(nN * sizeof(double))) == NULL) ||
+       ((lM.llr = AlgMatrixLLRNew(nN, nN, 5 * nN, 0.0, &errCode)) == NULL) ||
+       ((wM.rect = AlgMatrixRectNew(4, nN, &errCode)) == NULL))
+    {
+      (void )fprintf(stderr, "%s: Failed to allocate matrices\n", *argv);
+      ok = 0;
+    }
+  }
+  if(ok)
+  {
+    size_t	idX,
+		idY;
+
+    /* Build the matrix as triples, with the diagonal split into two
+     * triples to test summing, and as a linked list row matrix. */
+    for(idY = 0; idY < nG; ++idY)
+    {
+      for(idX = 0; idX < nG; ++idX)
+      {
+	size_t	i;
+
+	i = idY * nG + idX;
+	tri[nT].row = tri[nT].col = i; tri[nT++].val = 2.0;
+	tri[nT].row = tri[nT].col = i; tri[nT++].val = 2.01;
+	(void )AlgMatrixSet(lM, i, i, 4.01);
+	if(idX > 0)
+	{
+	  tri[nT].row = i; tri[nT].col = i - 1; tri[nT++].val = -1.0;
+	  (void )AlgMatrixSet(lM, i, i - 1, -1.0);
+	}
+	if(idX < nG - 1)
+	{
+	  tri[nT].row = i; tri[nT].col = i + 1; tri[nT++].val = -1.0;
+	  (void )AlgMatrixSet(lM, i, i + 1, -1.0);
+	}
+	if(idY > 0)
+	{
+	  tri[nT].row = i; tri[nT].col = i - nG; tri[nT++].val = -1.0;
+	  (void )AlgMatrixSet(lM, i, i - nG, -1.0);
+	}
+	if(idY < nG - 1)
+	{
+	  tri[nT].row = i; tri[nT].col = i + nG; tri[nT++].val = -1.0;
+	  (void )AlgMatrixSet(lM, i, i + nG, -1.0);
+	}
+      }
+    }
+    /* Shuffle the triples. */
+    AlgRandSeed(0);
+    for(idx = nT - 1; idx > 0; --idx)
+    {
+      size_t	j;
+      AlgMatrixTriple t;
+
+      j = (size_t )(AlgRandUniform() * (idx + 1)) % (idx + 1);
+      t = tri[idx]; tri[idx] = tri[j]; tri[j] = t;
+    }
+    aM.csr = AlgMatrixCSRFromTriples(nN, nN, nT, tri, 0.0, &errCode);
+    if(errCode == ALG_ERR_NONE)
+    {
+      cM.csr = AlgMatrixCSRFromLLR(lM.llr, &errCode);
+    }
+    if(errCode != ALG_ERR_NONE)
+    {
+      (void )fprintf(stderr, "%s: Failed to build CSR matrices (%d).\n",
+		     *argv, (int )errCode);
+      ok = 0;
+    }
+  }
+  if(ok)
+  {
+    /* Compare the products of the matrices with a vector. */
+    for(idx = 0; idx < nN; ++idx)
+    {
+      xV[idx] = AlgRandUniform() - 0.5;
+    }
+    AlgMatrixVectorMul(bV, lM, xV);
+    AlgMatrixVectorMul(tV, aM, xV);
+    AlgMatrixVectorMul(uV, cM, xV);
+    for(idx = 0; idx < nN; ++idx)
+    {
+      del = ALG_MAX(del, fabs(bV[idx] - tV[idx]));
+      del = ALG_MAX(del, fabs(bV[idx] - uV[idx]));
+    }
+    AlgMatrixTVectorMul(tV, aM, xV);
+    for(idx = 0; idx < nN; ++idx)
+    {
+      del = ALG_MAX(del, fabs(bV[idx] - tV[idx]));
+    }
+    if((aM.csr->numEnt != lM.llr->numEnt) || (del > 1.0e-12))
+    {
+      (void )fprintf(stderr, "%s: Matrix products differ (%g).\n",
+		     *argv, del);
+      ok = 0;
+    }
+    else
+    {
+      (void )printf("%s: nnz = %zd, product difference = %g\n",
+		    *argv, aM.csr->numEnt, del);
+    }
+  }
+  if(ok)
+  {
+    AlgMatrix	sM;
+
+    /* Solve A x = b for the known x (in uV). */
+    sM = (aType == ALG_MATRIX_LLR)? lM: aM;
+    AlgVectorCopy(uV, xV, nN);
+    AlgMatrixVectorMul(bV, aM, uV);
+    AlgVectorZero(xV, nN);
+    gettimeofday(times + 0, NULL);
+    if(lsqr)
+    {
+      errCode = AlgMatrixSolveLSQRPrecond(sM, bV, xV, pcType, 0.0,
+      					  tol, tol, itr, 0, NULL, &lItr,
+					  NULL, NULL, NULL, NULL, NULL);
+      itr = (int )lItr;
+    }
+    else
+    {
+      if(pcType != ALG_MATRIX_PRECOND_NONE)
+      {
+        pc = AlgMatrixPrecondNew(sM, pcType, &errCode);
+      }
+      if(errCode == ALG_ERR_NONE)
+      {
+	errCode = AlgMatrixCGSolve(sM, xV, bV, wM,
+				   (pc)? AlgMatrixPrecondApply: NULL, pc,
+				   tol, itr, &res, &itr);
+      }
+    }
+    gettimeofday(times + 1, NULL);
+    if(errCode != ALG_ERR_NONE)
+    {
+      (void )fprintf(stderr, "%s: Failed to solve (%d).\n",
+		     *argv, (int )errCode);
+      ok = 0;
+    }
+    else
+    {
+      del = 0.0;
+      for(idx = 0; idx < nN; ++idx)
+      {
+	double	d;
+
+	d = xV[idx] - uV[idx];
+	del += d * d;
+      }
+      del = sqrt(del / nN);
+      (void )printf("%s: RMS = %g\n", *argv, del);
+      (void )printf("%s: itr = %d\n", *argv, itr);
+      if(timer)
+      {
+	ALC_TIMERSUB(times + 1, times + 0, times + 2);
+	(void )printf("%s: Elapsed time = %g\n",
+		      *argv, times[2].tv_sec + (0.000001 * times[2].tv_usec));
+      }
+      if(del > 1.0e-3)
+      {
+        ok = 0;
+      }
+    }
+  }
+  AlgMatrixPrecondFree(pc);
+  AlgMatrixFree(aM);
+  AlgMatrixFree(cM);
+  AlgMatrixFree(lM);
+  AlgMatrixFree(wM);
+  AlcFree(tri);
+  AlcFree(bV);
+  AlcFree(xV);
+  AlcFree(tV);
+  AlcFree(uV);
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s [-h] [-i#] [-l] [-n#] [-p<n|j|i>] [-t#] [-L] [-T]\n%s",
+    *argv,
+    "  -h  Output this help message.\n"
+    "  -i  Maximum number of iterations.\n"
+    "  -l  Solve using LSQR rather than conjugate gradients.\n"
+    "  -n  Grid size, the matrix has the square of this many rows.\n"
+    "  -p  Preconditioner: n none, j Jacobi or i incomplete Cholesky.\n"
+    "  -t  Tolerance value.\n"
+    "  -L  Solve using the linked list row matrix.\n"
+    "  -T  Time the solver.\n");
+  }
+  exit(ok == 0);
+}
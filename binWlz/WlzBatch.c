@@ -0,0 +1,1434 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzBatch_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlz/WlzBatch.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Runs a script of Woolz operations on objects held in
+* 		memory.
+* \ingroup	BinWlz
+*
+* \par Binary
+* \ref wlzbatch "WlzBatch"
+*/
+
+/*!
+\ingroup BinWlz
+\defgroup wlzbatch WlzBatch
+\par Name
+WlzBatch - runs a script of Woolz operations on objects held in memory.
+\par Synopsis
+\verbatim
+WlzBatch [-h] [-n] [-v] [<script file>]
+\endverbatim
+\par Options
+<table width="500" border="0">
+  <tr>
+    <td><b>-h</b></td>
+    <td>Help, prints usage message.</td>
+  </tr>
+  <tr>
+    <td><b>-n</b></td>
+    <td>Parse the script and print the execution schedule without
+        running it.</td>
+  </tr>
+  <tr>
+    <td><b>-v</b></td>
+    <td>Verbose operation.</td>
+  </tr>
+</table>
+\par Description
+Reads a script (from the given file or the standard input) and runs
+the Woolz operations it contains on objects held in memory, avoiding
+the cost of writing and reading intermediate objects and of starting
+a process for each operation in a pipeline.
+Each line of the script is either blank, a comment starting with '#'
+or one of the following (lines must be shorter than 4095 characters
+and a '#' at the start of a line or after white space starts a comment
+which runs to the end of the line):
+\verbatim
+<name> = read <file>
+<name> = <operation> [<options>] <input name> [<input name> ...]
+write <name> <file>
+\endverbatim
+where the file name "-" is the standard input or output.
+Each name may only be defined once and must be defined before it is
+used. The operations and their options are the same as those of the
+corresponding binaries, but with named objects in place of files:
+<table width="500" border="0">
+  <tr><td>WlzAffineTransformObj</td>
+      <td>[-2] [-3] [-L] [-R] [-i] [-a#] [-b#] [-s#] [-u#] [-v#]
+          [-w#] [-x#] [-y#] [-z#] &lt;in&gt;</td></tr>
+  <tr><td>WlzConvertPix</td> <td>[-t#] &lt;in&gt;</td></tr>
+  <tr><td>WlzDiffDomain</td> <td>&lt;in&gt; &lt;in&gt;</td></tr>
+  <tr><td>WlzDilation</td> <td>[-c#] [-r#] &lt;in&gt;</td></tr>
+  <tr><td>WlzDomain</td> <td>&lt;in&gt;</td></tr>
+  <tr><td>WlzErosion</td> <td>[-c#] [-r#] &lt;in&gt;</td></tr>
+  <tr><td>WlzGauss</td> <td>[-w#[,#]] [-x#] [-y#] &lt;in&gt;</td></tr>
+  <tr><td>WlzIntersect</td> <td>&lt;in&gt; [&lt;in&gt; ...]</td></tr>
+  <tr><td>WlzSampleObj</td>
+      <td>[-x#] [-y#] [-z#] [-a] [-e] [-g] [-i] [-m] [-p] &lt;in&gt;</td></tr>
+  <tr><td>WlzSetBackground</td> <td>[-b#] &lt;in&gt;</td></tr>
+  <tr><td>WlzShiftObj</td> <td>[-g] [-x#] [-y#] [-z#] &lt;in&gt;</td></tr>
+  <tr><td>WlzThreshold</td> <td>[-t#] [-v#] [-H] [-L] [-E] &lt;in&gt;</td></tr>
+  <tr><td>WlzUnion</td> <td>&lt;in&gt; [&lt;in&gt; ...]</td></tr>
+</table>
+The script is a directed acyclic graph: operations which do not depend
+on each other are run in parallel (when built with OpenMP) and each
+object is freed as soon as the last operation that uses it has run.
+Reads from the standard input and writes to the standard output are
+done in script order. A file which is written by the script is only
+read after it has been written and is only written after all earlier
+reads and writes of it, with files being identified by the names given
+in the script.
+\par Examples
+\verbatim
+# smooth.wsc
+in = read in.wlz
+sm = WlzGauss -w 5 in
+hi = WlzThreshold -v 100 -H sm
+lo = WlzThreshold -v 20 -L sm
+dm = WlzDomain hi
+write dm hi.wlz
+write lo -
+\endverbatim
+\verbatim
+WlzBatch smooth.wsc >lo.wlz
+\endverbatim
+Reads an object from in.wlz, smooths it and thresholds the smoothed
+object twice (these two thresholds run concurrently). The domain of the
+high thresholded object is written to hi.wlz and the low thresholded
+object is written to the standard output.
+\par File
+\ref WlzBatch.c "WlzBatch.c"
+\par See Also
+\ref BinWlz "WlzIntro(1)"
+\ref wlzaffinetransformobj "WlzAffineTransformObj(1)"
+\ref wlzgauss "WlzGauss(1)"
+\ref wlzthreshold "WlzThreshold(1)"
+*/
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <Wlz.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char     *optarg;
+extern int      optind,
+                opterr,
+                optopt;
+
+#define WLZBATCH_MAX_TOK	(256)
+#define WLZBATCH_MAX_LINE	(4096)
+
+typedef enum _WlzBatchOpType
+{
+  WLZBATCH_OP_READ,
+  WLZBATCH_OP_WRITE,
+  WLZBATCH_OP_AFFINE,
+  WLZBATCH_OP_CONVERT,
+  WLZBATCH_OP_DIFF,
+  WLZBATCH_OP_DILATION,
+  WLZBATCH_OP_DOMAIN,
+  WLZBATCH_OP_EROSION,
+  WLZBATCH_OP_GAUSS,
+  WLZBATCH_OP_INTERSECT,
+  WLZBATCH_OP_SAMPLE,
+  WLZBATCH_OP_SETBGD,
+  WLZBATCH_OP_SHIFT,
+  WLZBATCH_OP_THRESHOLD,
+  WLZBATCH_OP_UNION
+} WlzBatchOpType;
+
+/*!
+* \struct	_WlzBatchOpDesc
+* \brief	Description of a script operation.
+*/
+typedef struct _WlzBatchOpDesc
+{
+  const char	*name;		/*!< Operation (binary) name. */
+  WlzBatchOpType op;		/*!< Operation. */
+  const char	*optList;	/*!< Options as for getopt(). */
+  int		minIn;		/*!< Minimum number of inputs. */
+  int		maxIn;		/*!< Maximum number of inputs, < 0 for
+  				     no limit. */
+} WlzBatchOpDesc;
+
+/*!
+* \struct	_WlzBatchPar
+* \brief	Parameters of the script operations.
+*/
+typedef struct _WlzBatchPar
+{
+  int		flg;		/*!< Operation specific flag. */
+  WlzIVertex3	iV;		/*!< Shift or sampling factors. */
+  double	tr[9];		/*!< Affine transform primitives in the
+  				     order of the WlzAffineTransformObj
+				     options x, y, z, s, a, b, u, v, w. */
+  int		deriv[2];	/*!< Gaussian derivatives. */
+  double	width[2];	/*!< Gaussian widths. */
+  int		radius;		/*!< Morphological radius. */
+  WlzConnectType conn;		/*!< Morphological connectivity. */
+  WlzGreyType	gType;		/*!< Grey type. */
+  WlzPixelV	pV;		/*!< Threshold or background value. */
+  WlzThresholdType thrType;	/*!< Threshold type. */
+  WlzSampleFn	samFn;		/*!< Sampling function. */
+  WlzInterpolationType interp;	/*!< Interpolation. */
+  WlzTransformType trType;	/*!< Transform type. */
+} WlzBatchPar;
+
+/*!
+* \struct	_WlzBatchNode
+* \brief	A single line of the script, ie a node of the operation
+* 		graph.
+*/
+typedef struct _WlzBatchNode
+{
+  int		line;		/*!< Line number in the script. */
+  const WlzBatchOpDesc *desc;	/*!< Operation description. */
+  char		*name;		/*!< Name of the output object or NULL. */
+  char		*file;		/*!< File for read or write. */
+  int		nIn;		/*!< Number of inputs. */
+  int		*in;		/*!< Indices of the input nodes. */
+  int		nAfter;		/*!< Number of nodes which must be run
+  				     before this one because they read or
+				     write the same file. */
+  int		*after;		/*!< Indices of those nodes. */
+  int		level;		/*!< Execution level, all nodes at the
+  				     same level may be run in parallel. */
+  int		nUse;		/*!< Number of nodes yet to use the
+  				     output object. */
+  WlzBatchPar	par;		/*!< Operation parameters. */
+  WlzObject	*obj;		/*!< Output object. */
+  WlzErrorNum	errNum;		/*!< Error from running the operation. */
+} WlzBatchNode;
+
+/*!
+* \struct	_WlzBatchOpt
+* \brief	Option scanner state, this is used in place of getopt()
+* 		so that each script line is parsed independently.
+*/
+typedef struct _WlzBatchOpt
+{
+  int		ind;		/*!< Index of the next token. */
+  int		sub;		/*!< Index within the current token. */
+  char		*arg;		/*!< Option argument. */
+} WlzBatchOpt;
+
+static const WlzBatchOpDesc wlzBatchOps[] =
+{
+  {"read",			WLZBATCH_OP_READ,	"",	0, 0},
+  {"write",			WLZBATCH_OP_WRITE,	"",	1, 1},
+  {"WlzAffineTransformObj",	WLZBATCH_OP_AFFINE,
+  				"23LRia:b:s:u:v:w:x:y:z:",	1, 1},
+  {"WlzConvertPix",		WLZBATCH_OP_CONVERT,	"t:",	1, 1},
+  {"WlzDiffDomain",		WLZBATCH_OP_DIFF,	"",	2, 2},
+  {"WlzDilation",		WLZBATCH_OP_DILATION,	"c:r:",	1, 1},
+  {"WlzDomain",			WLZBATCH_OP_DOMAIN,	"",	1, 1},
+  {"WlzErosion",		WLZBATCH_OP_EROSION,	"c:r:",	1, 1},
+  {"WlzGauss",			WLZBATCH_OP_GAUSS,	"w:x:y:", 1, 1},
+  {"WlzIntersect",		WLZBATCH_OP_INTERSECT,	"",	1, -1},
+  {"WlzSampleObj",		WLZBATCH_OP_SAMPLE,	"x:y:z:aegimp", 1, 1},
+  {"WlzSetBackground",		WLZBATCH_OP_SETBGD,	"b:",	1, 1},
+  {"WlzShiftObj",		WLZBATCH_OP_SHIFT,	"gx:y:z:", 1, 1},
+  {"WlzThreshold",		WLZBATCH_OP_THRESHOLD,	"HLEt:v:", 1, 1},
+  {"WlzUnion",			WLZBATCH_OP_UNION,	"",	1, -1}
+};
+
+static int			WlzBatchGetOpt(
+				  WlzBatchOpt *opt,
+				  int argc,
+				  char **argv,
+				  const char *optList);
+static int			WlzBatchFindName(
+				  WlzBatchNode *nodes,
+				  int nNodes,
+				  const char *name);
+static WlzErrorNum		WlzBatchParseLine(
+				  WlzBatchNode *node,
+				  WlzBatchNode *nodes,
+				  int nNodes,
+				  char *str,
+				  const char **dstMsg);
+static WlzErrorNum		WlzBatchFileDeps(
+				  WlzBatchNode *node,
+				  WlzBatchNode *nodes,
+				  int nNodes);
+static WlzErrorNum		WlzBatchParseOpts(
+				  WlzBatchNode *node,
+				  int argc,
+				  char **argv,
+				  int *dstInd);
+static WlzErrorNum		WlzBatchRun(
+				  WlzBatchNode *node,
+				  WlzBatchNode *nodes);
+static WlzObject		*WlzBatchMorph(
+				  WlzObject *obj,
+				  WlzBatchPar *par,
+				  int dilate,
+				  WlzErrorNum *dstErr);
+static void			WlzBatchFreeNodes(
+				  WlzBatchNode *nodes,
+				  int nNodes);
+
+int             main(int argc, char **argv)
+{
+  int		idx,
+  		idN,
+		idL,
+  		option,
+		lineNum = 0,
+		nNodes = 0,
+		maxNodes = 0,
+		nLvl = 0,
+		ok = 1,
+		usage = 0,
+		noRunFlag = 0,
+		verbose = 0;
+  int		*lvlNodes = NULL;
+  char		*inFileStr;
+  const char	*errMsg = NULL;
+  FILE		*fP = NULL;
+  WlzBatchNode	*nodes = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  char		lineBuf[WLZBATCH_MAX_LINE];
+  static char	optList[] = "hnv",
+  		inFileStrDef[] = "-";
+
+  opterr = 0;
+  inFileStr = inFileStrDef;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'n':
+        noRunFlag = 1;
+	break;
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h':
+      default:
+        usage = 1;
+	ok = 0;
+	break;
+    }
+  }
+  if(ok && (optind < argc))
+  {
+    if((optind + 1) != argc)
+    {
+      usage = 1;
+      ok = 0;
+    }
+    else
+    {
+      inFileStr = *(argv + optind);
+    }
+  }
+  /* Read and parse the script, building the operation graph. */
+  if(ok)
+  {
+    if((fP = (strcmp(inFileStr, "-")?
+	      fopen(inFileStr, "r"): stdin)) == NULL)
+    {
+      ok = 0;
+      (void )fprintf(stderr, "%s: failed to open script file %s.\n",
+                     *argv, inFileStr);
+    }
+  }
+  while(ok && (fgets(lineBuf, sizeof(lineBuf), fP) != NULL))
+  {
+    ++lineNum;
+    if(nNodes >= maxNodes)
+    {
+      maxNodes = (maxNodes + 64) * 2;
+      if((nodes = (WlzBatchNode *)
+                  AlcRealloc(nodes, maxNodes * sizeof(WlzBatchNode))) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      (void )memset(nodes + nNodes, 0, sizeof(WlzBatchNode));
+      nodes[nNodes].line = lineNum;
+      if((strchr(lineBuf, '\n') == NULL) && !feof(fP))
+      {
+        errNum = WLZ_ERR_PARAM_DATA;
+	errMsg = "line too long";
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = WlzBatchParseLine(nodes + nNodes, nodes, nNodes,
+      				 lineBuf, &errMsg);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if(nodes[nNodes].desc != NULL)
+      {
+	++nNodes;
+      }
+    }
+    else
+    {
+      ok = 0;
+      if(errMsg == NULL)
+      {
+        (void )WlzStringFromErrorNum(errNum, &errMsg);
+      }
+      (void )fprintf(stderr, "%s: failed to parse line %d of %s (%s).\n",
+      		     *argv, lineNum, inFileStr, errMsg);
+      if(nodes)
+      {
+        WlzBatchFreeNodes(nodes + nNodes, 1);
+      }
+    }
+  }
+  if(fP && strcmp(inFileStr, "-"))
+  {
+    (void )fclose(fP);
+  }
+  /* Assign execution levels: each node is run after all of its inputs
+   * and after all earlier nodes which access the same file. */
+  if(ok)
+  {
+    for(idN = 0; idN < nNodes; ++idN)
+    {
+      WlzBatchNode *nd;
+
+      nd = nodes + idN;
+      nd->level = 0;
+      for(idx = 0; idx < nd->nAfter; ++idx)
+      {
+        nd->level = WLZ_MAX(nd->level, nodes[nd->after[idx]].level + 1);
+      }
+      for(idx = 0; idx < nd->nIn; ++idx)
+      {
+        nd->level = WLZ_MAX(nd->level, nodes[nd->in[idx]].level + 1);
+	++(nodes[nd->in[idx]].nUse);
+      }
+      nLvl = WLZ_MAX(nLvl, nd->level + 1);
+    }
+    if((nNodes > 0) &&
+       ((lvlNodes = (int *)AlcMalloc(nNodes * sizeof(int))) == NULL))
+    {
+      ok = 0;
+      (void )fprintf(stderr, "%s: failed to allocate memory.\n", *argv);
+    }
+  }
+  if(ok && noRunFlag)
+  {
+    for(idL = 0; idL < nLvl; ++idL)
+    {
+      (void )printf("level %d:\n", idL);
+      for(idN = 0; idN < nNodes; ++idN)
+      {
+        if(nodes[idN].level == idL)
+	{
+	  (void )printf("  line %d: %s %s\n", nodes[idN].line,
+	  		nodes[idN].desc->name,
+			(nodes[idN].name)? nodes[idN].name: nodes[idN].file);
+	}
+      }
+    }
+  }
+  /* Run the operations level by level, freeing objects as soon as they
+   * have been used by all of their consumers. */
+  idL = 0;
+  while(ok && (noRunFlag == 0) && (idL < nLvl))
+  {
+    int		nLvlNodes = 0;
+
+    for(idN = 0; idN < nNodes; ++idN)
+    {
+      if(nodes[idN].level == idL)
+      {
+        lvlNodes[nLvlNodes++] = idN;
+      }
+    }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) if(nLvlNodes > 1)
+#endif
+    for(idx = 0; idx < nLvlNodes; ++idx)
+    {
+      WlzBatchNode *nd;
+
+      nd = nodes + lvlNodes[idx];
+      nd->errNum = WlzBatchRun(nd, nodes);
+      if(verbose)
+      {
+#ifdef _OPENMP
+#pragma omp critical (WlzBatchVerbose)
+#endif
+	{
+	  (void )fprintf(stderr, "%s: line %d %s %s (%d).\n",
+	  		 *argv, nd->line, nd->desc->name,
+			 (nd->name)? nd->name: nd->file, nd->errNum);
+	}
+      }
+    }
+    for(idx = 0; idx < nLvlNodes; ++idx)
+    {
+      WlzBatchNode *nd;
+
+      nd = nodes + lvlNodes[idx];
+      if(nd->errNum != WLZ_ERR_NONE)
+      {
+	ok = 0;
+	(void )WlzStringFromErrorNum(nd->errNum, &errMsg);
+	(void )fprintf(stderr, "%s: failed at line %d of %s, %s (%s).\n",
+		       *argv, nd->line, inFileStr, nd->desc->name, errMsg);
+      }
+      for(idN = 0; idN < nd->nIn; ++idN)
+      {
+        WlzBatchNode *iNd;
+
+	iNd = nodes + nd->in[idN];
+	if(--(iNd->nUse) <= 0)
+	{
+	  (void )WlzFreeObj(iNd->obj);
+	  iNd->obj = NULL;
+	}
+      }
+      if(nd->nUse <= 0)
+      {
+        (void )WlzFreeObj(nd->obj);
+	nd->obj = NULL;
+      }
+    }
+    ++idL;
+  }
+  AlcFree(lvlNodes);
+  if(nodes)
+  {
+    WlzBatchFreeNodes(nodes, nNodes);
+    AlcFree(nodes);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s [-h] [-n] [-v] [<script file>]\n"
+    "Runs a script of Woolz operations on objects held in memory.\n"
+    "Version: %s\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -n  Parse the script and print the execution schedule but don't\n"
+    "      run it.\n"
+    "  -v  Verbose operation.\n"
+    "Each script line (shorter than 4095 characters) is blank, a comment\n"
+    "starting with a '#' at the start of the line or after white space, or\n"
+    "one of:\n"
+    "  <name> = read <file>\n"
+    "  <name> = <operation> [<options>] <input name> [<input name> ...]\n"
+    "  write <name> <file>\n"
+    "where a file name of - is the standard input or output. The\n"
+    "operations and their options are as for the binaries of the\n"
+    "same names:\n",
+    *argv,
+    WlzVersion());
+    for(idx = 2; idx < sizeof(wlzBatchOps) / sizeof(WlzBatchOpDesc); ++idx)
+    {
+      (void )fprintf(stderr, "  %s\n", wlzBatchOps[idx].name);
+    }
+    (void )fprintf(stderr,
+    "Independent operations are run in parallel and objects are freed\n"
+    "as soon as their last consumer has run. Reads and writes of the\n"
+    "same file are run in script order.\n"
+    "Example:\n"
+    "  in = read in.wlz\n"
+    "  sm = WlzGauss -w 5 in\n"
+    "  th = WlzThreshold -v 100 -H sm\n"
+    "  write th -\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	Option character, '?' for an unknown option or a missing
+* 		argument and -1 when there are no more options.
+* \brief	Scans the given tokens for options in the same way as
+* 		getopt() but using the given state rather than globals.
+* \param	opt			Option scanner state, which should
+* 					be initialised to {1, 0, NULL}.
+* \param	argc			Number of tokens.
+* \param	argv			Tokens.
+* \param	optList			Options as for getopt().
+*/
+static int	WlzBatchGetOpt(WlzBatchOpt *opt, int argc, char **argv,
+			       const char *optList)
+{
+  int		c = -1;
+  char		*tok;
+  const char	*oP;
+
+  opt->arg = NULL;
+  if(opt->sub == 0)
+  {
+    if((opt->ind < argc) && (argv[opt->ind][0] == '-') &&
+       (argv[opt->ind][1] != '\0'))
+    {
+      if(strcmp(argv[opt->ind], "--") == 0)
+      {
+        ++(opt->ind);
+      }
+      else
+      {
+	opt->sub = 1;
+      }
+    }
+  }
+  if(opt->sub > 0)
+  {
+    tok = argv[opt->ind];
+    c = tok[opt->sub++];
+    if((c == ':') || ((oP = strchr(optList, c)) == NULL))
+    {
+      c = '?';
+    }
+    else if(*(oP + 1) == ':')
+    {
+      if(tok[opt->sub] != '\0')
+      {
+        opt->arg = tok + opt->sub;
+      }
+      else if(opt->ind + 1 < argc)
+      {
+        opt->arg = argv[++(opt->ind)];
+      }
+      else
+      {
+        c = '?';
+      }
+      opt->sub = 0;
+      ++(opt->ind);
+    }
+    if((opt->sub > 0) && (tok[opt->sub] == '\0'))
+    {
+      opt->sub = 0;
+      ++(opt->ind);
+    }
+  }
+  return(c);
+}
+
+/*!
+* \return	Index of the node with the given output name or -1 if
+* 		not found.
+* \brief	Finds the node which defines the given name.
+* \param	nodes			Nodes defined so far.
+* \param	nNodes			Number of nodes.
+* \param	name			Given name.
+*/
+static int	WlzBatchFindName(WlzBatchNode *nodes, int nNodes,
+				 const char *name)
+{
+  int		idx;
+
+  for(idx = nNodes - 1; idx >= 0; --idx)
+  {
+    if(nodes[idx].name && (strcmp(nodes[idx].name, name) == 0))
+    {
+      break;
+    }
+  }
+  return(idx);
+}
+
+/*!
+* \return	Woolz error code.
+* \brief	Parses a single script line into the given node. Blank and
+* 		comment lines leave the node's operation description NULL.
+* \param	node			Node to set.
+* \param	nodes			Nodes defined so far.
+* \param	nNodes			Number of nodes defined so far.
+* \param	str			Script line, modified.
+* \param	dstMsg			Destination pointer for an error
+* 					message which is only set if more
+* 					specific than the error code.
+*/
+static WlzErrorNum WlzBatchParseLine(WlzBatchNode *node,
+				WlzBatchNode *nodes, int nNodes,
+				char *str, const char **dstMsg)
+{
+  int		idx,
+  		nTok = 0,
+		ind = 0;
+  char		*tok[WLZBATCH_MAX_TOK];
+  char		*tP;
+  const char	*opName = NULL,
+  		*msg = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  /* A '#' only starts a comment at the start of a line or after white
+   * space, so that it may be used within names and file names. */
+  tP = str;
+  while((tP = strchr(tP, '#')) != NULL)
+  {
+    if((tP == str) || isspace((unsigned char )*(tP - 1)))
+    {
+      *tP = '\0';
+      break;
+    }
+    ++tP;
+  }
+  tP = strtok(str, " \t\r\n");
+  while((tP != NULL) && (nTok < WLZBATCH_MAX_TOK))
+  {
+    tok[nTok++] = tP;
+    tP = strtok(NULL, " \t\r\n");
+  }
+  if(tP != NULL)
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+    msg = "too many tokens";
+  }
+  else if(nTok > 0)
+  {
+    /* Find the operation and the output name. */
+    if((nTok > 2) && (strcmp(tok[1], "=") == 0))
+    {
+      opName = tok[2];
+      ind = 3;
+      if(WlzBatchFindName(nodes, nNodes, tok[0]) >= 0)
+      {
+        errNum = WLZ_ERR_PARAM_DATA;
+	msg = "name redefined";
+      }
+      else if((node->name = AlcStrDup(tok[0])) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+    }
+    else
+    {
+      opName = tok[0];
+      ind = 1;
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      for(idx = 0; idx < sizeof(wlzBatchOps) / sizeof(WlzBatchOpDesc);
+          ++idx)
+      {
+	if(strcmp(opName, wlzBatchOps[idx].name) == 0)
+	{
+	  node->desc = wlzBatchOps + idx;
+	  break;
+	}
+      }
+      if((node->desc == NULL) ||
+         ((node->desc->op == WLZBATCH_OP_WRITE) && (node->name != NULL)) ||
+         ((node->desc->op != WLZBATCH_OP_WRITE) && (node->name == NULL)))
+      {
+        errNum = WLZ_ERR_PARAM_DATA;
+	msg = (node->desc == NULL)? "unknown operation": "syntax error";
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = WlzBatchParseOpts(node, nTok, tok, &ind);
+      if(errNum != WLZ_ERR_NONE)
+      {
+        msg = "bad option";
+      }
+    }
+    /* Input names, then a file name for read and write. */
+    if(errNum == WLZ_ERR_NONE)
+    {
+      int	nIn;
+
+      nIn = nTok - ind;
+      if((node->desc->op == WLZBATCH_OP_READ) ||
+         (node->desc->op == WLZBATCH_OP_WRITE))
+      {
+        --nIn;
+      }
+      if((nIn < node->desc->minIn) ||
+         ((node->desc->maxIn >= 0) && (nIn > node->desc->maxIn)))
+      {
+        errNum = WLZ_ERR_PARAM_DATA;
+	msg = "wrong number of inputs";
+      }
+      else if((nIn > 0) &&
+              ((node->in = (int *)AlcMalloc(nIn * sizeof(int))) == NULL))
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      else
+      {
+	while((errNum == WLZ_ERR_NONE) && (node->nIn < nIn))
+	{
+	  if((idx = WlzBatchFindName(nodes, nNodes, tok[ind])) < 0)
+	  {
+	    errNum = WLZ_ERR_PARAM_DATA;
+	    msg = "undefined name";
+	  }
+	  else
+	  {
+	    node->in[node->nIn++] = idx;
+	    ++ind;
+	  }
+	}
+      }
+    }
+    if((errNum == WLZ_ERR_NONE) && (ind < nTok))
+    {
+      if((node->file = AlcStrDup(tok[ind])) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      else
+      {
+        errNum = WlzBatchFileDeps(node, nodes, nNodes);
+      }
+    }
+  }
+  if(dstMsg)
+  {
+    *dstMsg = msg;
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \brief	Sets the nodes which must be run before the given read or
+* 		write node because they access the same file. A read
+* 		depends on the last earlier write of the file, so that
+* 		files written by the script may be read back by it. A
+* 		write depends on the last earlier write of the file and
+* 		on all reads of the file since that write. The standard
+* 		input and output are treated as streams which are only
+* 		read or only written, so reads of the standard input
+* 		depend on the previous read of it and writes to the
+* 		standard output on the previous write to it. Files are
+* 		identified by the names given in the script.
+* \param	node			Node with its operation and file set.
+* \param	nodes			Nodes defined so far.
+* \param	nNodes			Number of nodes defined so far.
+*/
+static WlzErrorNum WlzBatchFileDeps(WlzBatchNode *node,
+				WlzBatchNode *nodes, int nNodes)
+{
+  int		idx,
+  		isStd,
+		isWrite,
+  		lastWrite;
+  WlzBatchNode	*nd;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  isStd = (strcmp(node->file, "-") == 0);
+  isWrite = (node->desc->op == WLZBATCH_OP_WRITE);
+  /* Find the last writer of the file, which for the standard input is the
+   * last reader of it since reads consume the stream. */
+  for(lastWrite = nNodes - 1; lastWrite >= 0; --lastWrite)
+  {
+    nd = nodes + lastWrite;
+    if(nd->file && (strcmp(nd->file, node->file) == 0) &&
+       ((isStd && (nd->desc->op == node->desc->op)) ||
+        (!isStd && (nd->desc->op == WLZBATCH_OP_WRITE))))
+    {
+      break;
+    }
+  }
+  node->nAfter = (lastWrite >= 0)? 1: 0;
+  /* A write must also follow all reads of the file since its last write. */
+  if(isWrite && !isStd)
+  {
+    for(idx = lastWrite + 1; idx < nNodes; ++idx)
+    {
+      nd = nodes + idx;
+      if(nd->file && (nd->desc->op == WLZBATCH_OP_READ) &&
+         (strcmp(nd->file, node->file) == 0))
+      {
+        ++(node->nAfter);
+      }
+    }
+  }
+  if(node->nAfter > 0)
+  {
+    if((node->after = (int *)
+                      AlcMalloc(node->nAfter * sizeof(int))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      node->nAfter = 0;
+      if(lastWrite >= 0)
+      {
+	node->after[node->nAfter++] = lastWrite;
+      }
+      if(isWrite && !isStd)
+      {
+	for(idx = lastWrite + 1; idx < nNodes; ++idx)
+	{
+	  nd = nodes + idx;
+	  if(nd->file && (nd->desc->op == WLZBATCH_OP_READ) &&
+	     (strcmp(nd->file, node->file) == 0))
+	  {
+	    node->after[node->nAfter++] = idx;
+	  }
+	}
+      }
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \brief	Parses the options of a script line into the parameters
+* 		of the given node, using the same options and defaults
+* 		as the corresponding binary.
+* \param	node			Node with its operation set.
+* \param	argc			Number of tokens.
+* \param	argv			Tokens.
+* \param	dstInd			Index of the first token after the
+* 					operation name on entry and of the
+* 					first non-option token on return.
+*/
+static WlzErrorNum WlzBatchParseOpts(WlzBatchNode *node,
+				int argc, char **argv, int *dstInd)
+{
+  int		c,
+  		iV;
+  WlzBatchOpt	opt;
+  WlzBatchPar	*par;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  par = &(node->par);
+  par->iV.vtX = par->iV.vtY = par->iV.vtZ = 0;
+  par->tr[3] = 1.0;
+  par->width[0] = par->width[1] = 3.0;
+  par->conn = WLZ_8_CONNECTED;
+  par->radius = 1;
+  par->gType = WLZ_GREY_UBYTE;
+  par->thrType = WLZ_THRESH_HIGH;
+  par->pV.type = WLZ_GREY_DOUBLE;
+  par->samFn = WLZ_SAMPLEFN_POINT;
+  par->interp = WLZ_INTERPOLATION_NEAREST;
+  par->trType = WLZ_TRANSFORM_2D_AFFINE;
+  switch(node->desc->op)
+  {
+    case WLZBATCH_OP_SAMPLE:
+      par->iV.vtX = par->iV.vtY = par->iV.vtZ = 1;
+      break;
+    case WLZBATCH_OP_SETBGD:
+      par->pV.v.dbv = 0.0;
+      break;
+    case WLZBATCH_OP_THRESHOLD:
+      par->gType = WLZ_GREY_INT;
+      par->pV.v.dbv = 170.0;
+      break;
+    default:
+      break;
+  }
+  opt.ind = *dstInd;
+  opt.sub = 0;
+  while((errNum == WLZ_ERR_NONE) &&
+        ((c = WlzBatchGetOpt(&opt, argc, argv, node->desc->optList)) != -1))
+  {
+    switch(node->desc->op)
+    {
+      case WLZBATCH_OP_AFFINE:
+	switch(c)
+	{
+	  case '2':
+	    par->trType = WLZ_TRANSFORM_2D_AFFINE;
+	    break;
+	  case '3':
+	    par->trType = WLZ_TRANSFORM_3D_AFFINE;
+	    break;
+	  case 'L':
+	    par->interp = WLZ_INTERPOLATION_LINEAR;
+	    break;
+	  case 'R':
+	    par->flg |= 1;
+	    break;
+	  case 'i':
+	    par->flg |= 2;
+	    break;
+	  case '?':
+	    errNum = WLZ_ERR_PARAM_DATA;
+	    break;
+	  default:
+	    iV = (int )(strchr("xyzsabuvw", c) - "xyzsabuvw");
+	    if(sscanf(opt.arg, "%lg", par->tr + iV) != 1)
+	    {
+	      errNum = WLZ_ERR_PARAM_DATA;
+	    }
+	    break;
+	}
+	break;
+      case WLZBATCH_OP_CONVERT:
+	if((c != 't') || (sscanf(opt.arg, "%d", &iV) != 1) ||
+	   ((iV != WLZ_GREY_INT) && (iV != WLZ_GREY_SHORT) &&
+	    (iV != WLZ_GREY_UBYTE) && (iV != WLZ_GREY_FLOAT) &&
+	    (iV != WLZ_GREY_DOUBLE) && (iV != WLZ_GREY_RGBA)))
+	{
+	  errNum = WLZ_ERR_PARAM_DATA;
+	}
+	else
+	{
+	  par->gType = (WlzGreyType )iV;
+	}
+	break;
+      case WLZBATCH_OP_DILATION: /* FALLTHROUGH */
+      case WLZBATCH_OP_EROSION:
+	if((c == '?') || (sscanf(opt.arg, "%d", &iV) != 1))
+	{
+	  errNum = WLZ_ERR_PARAM_DATA;
+	}
+	else if(c == 'r')
+	{
+	  par->radius = WLZ_CLAMP(iV, 1, 100);
+	}
+	else
+	{
+	  switch(iV)
+	  {
+	    case 4:
+	      par->conn = WLZ_4_CONNECTED;
+	      break;
+	    case 6:
+	      par->conn = WLZ_6_CONNECTED;
+	      break;
+	    case 8:
+	      par->conn = WLZ_8_CONNECTED;
+	      break;
+	    case 18:
+	      par->conn = WLZ_18_CONNECTED;
+	      break;
+	    case 26:
+	      par->conn = WLZ_26_CONNECTED;
+	      break;
+	    default:
+	      errNum = WLZ_ERR_PARAM_DATA;
+	      break;
+	  }
+	}
+	break;
+      case WLZBATCH_OP_GAUSS:
+	switch(c)
+	{
+	  case 'w':
+	    switch(sscanf(opt.arg, "%lg,%lg", par->width, par->width + 1))
+	    {
+	      case 1:
+		par->width[1] = par->width[0];
+		break;
+	      case 2:
+		break;
+	      default:
+		errNum = WLZ_ERR_PARAM_DATA;
+		break;
+	    }
+	    break;
+	  case 'x': /* FALLTHROUGH */
+	  case 'y':
+	    if(sscanf(opt.arg, "%d", par->deriv + (c == 'y')) != 1)
+	    {
+	      errNum = WLZ_ERR_PARAM_DATA;
+	    }
+	    break;
+	  default:
+	    errNum = WLZ_ERR_PARAM_DATA;
+	    break;
+	}
+	break;
+      case WLZBATCH_OP_SAMPLE:
+	switch(c)
+	{
+	  case 'a':
+	    par->samFn = WLZ_SAMPLEFN_MAX;
+	    break;
+	  case 'e':
+	    par->samFn = WLZ_SAMPLEFN_MEDIAN;
+	    break;
+	  case 'g':
+	    par->samFn = WLZ_SAMPLEFN_GAUSS;
+	    break;
+	  case 'i':
+	    par->samFn = WLZ_SAMPLEFN_MIN;
+	    break;
+	  case 'm':
+	    par->samFn = WLZ_SAMPLEFN_MEAN;
+	    break;
+	  case 'p':
+	    par->samFn = WLZ_SAMPLEFN_POINT;
+	    break;
+	  case 'x': /* FALLTHROUGH */
+	  case 'y': /* FALLTHROUGH */
+	  case 'z':
+	    if((sscanf(opt.arg, "%d", &iV) != 1) || (iV < 1))
+	    {
+	      errNum = WLZ_ERR_PARAM_DATA;
+	    }
+	    else
+	    {
+	      *((c == 'x')? &(par->iV.vtX):
+	        (c == 'y')? &(par->iV.vtY): &(par->iV.vtZ)) = iV;
+	    }
+	    break;
+	  default:
+	    errNum = WLZ_ERR_PARAM_DATA;
+	    break;
+	}
+	break;
+      case WLZBATCH_OP_SETBGD:
+	if((c != 'b') || (sscanf(opt.arg, "%lg", &(par->pV.v.dbv)) != 1))
+	{
+	  errNum = WLZ_ERR_PARAM_DATA;
+	}
+	break;
+      case WLZBATCH_OP_SHIFT:
+	switch(c)
+	{
+	  case 'g':
+	    par->flg = 1;
+	    break;
+	  case 'x': /* FALLTHROUGH */
+	  case 'y': /* FALLTHROUGH */
+	  case 'z':
+	    if(sscanf(opt.arg, "%d", &iV) != 1)
+	    {
+	      errNum = WLZ_ERR_PARAM_DATA;
+	    }
+	    else
+	    {
+	      *((c == 'x')? &(par->iV.vtX):
+	        (c == 'y')? &(par->iV.vtY): &(par->iV.vtZ)) = iV;
+	    }
+	    break;
+	  default:
+	    errNum = WLZ_ERR_PARAM_DATA;
+	    break;
+	}
+	break;
+      case WLZBATCH_OP_THRESHOLD:
+	switch(c)
+	{
+	  case 'H':
+	    par->thrType = WLZ_THRESH_HIGH;
+	    break;
+	  case 'L':
+	    par->thrType = WLZ_THRESH_LOW;
+	    break;
+	  case 'E':
+	    par->thrType = WLZ_THRESH_EQUAL;
+	    break;
+	  case 't':
+	    if((sscanf(opt.arg, "%d", &iV) != 1) ||
+	       ((iV != WLZ_GREY_INT) && (iV != WLZ_GREY_SHORT) &&
+	        (iV != WLZ_GREY_UBYTE) && (iV != WLZ_GREY_FLOAT) &&
+		(iV != WLZ_GREY_DOUBLE)))
+	    {
+	      errNum = WLZ_ERR_PARAM_DATA;
+	    }
+	    else
+	    {
+	      par->gType = (WlzGreyType )iV;
+	    }
+	    break;
+	  case 'v':
+	    par->pV.v.dbv = atof(opt.arg);
+	    break;
+	  default:
+	    errNum = WLZ_ERR_PARAM_DATA;
+	    break;
+	}
+	break;
+      default:
+	errNum = WLZ_ERR_PARAM_DATA;
+	break;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    switch(node->desc->op)
+    {
+      case WLZBATCH_OP_AFFINE:
+	if((par->flg & 1) == 0)
+	{
+	  par->tr[4] *= WLZ_M_PI / 180;
+	  par->tr[5] *= WLZ_M_PI / 180;
+	  par->tr[7] *= WLZ_M_PI / 180;
+	}
+	break;
+      case WLZBATCH_OP_THRESHOLD:
+	/* The threshold value is held as a double until the options
+	 * have all been parsed since the type may follow the value. */
+	errNum = WlzValueConvertPixel(&(par->pV), par->pV, par->gType);
+	break;
+      default:
+	break;
+    }
+  }
+  *dstInd = opt.ind;
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \brief	Runs the operation of a single node, setting its output
+* 		object. Input objects are never modified so that they
+* 		can be shared by concurrently run nodes.
+* \param	node			Node to run.
+* \param	nodes			All nodes.
+*/
+static WlzErrorNum WlzBatchRun(WlzBatchNode *node, WlzBatchNode *nodes)
+{
+  int		idx;
+  FILE		*fP = NULL;
+  WlzObject	*obj = NULL,
+  		*rObj = NULL;
+  WlzObject	**objs = NULL;
+  WlzValues	nullValues;
+  WlzAffineTransform *tr;
+  WlzBatchPar	*par;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  par = &(node->par);
+  nullValues.core = NULL;
+  if(node->nIn > 0)
+  {
+    obj = nodes[node->in[0]].obj;
+  }
+  switch(node->desc->op)
+  {
+    case WLZBATCH_OP_READ:
+      errNum = WLZ_ERR_READ_EOF;
+      if((fP = (strcmp(node->file, "-")?
+               fopen(node->file, "r"): stdin)) != NULL)
+      {
+        rObj = WlzReadObj(fP, &errNum);
+	if(strcmp(node->file, "-"))
+	{
+	  (void )fclose(fP);
+	}
+      }
+      break;
+    case WLZBATCH_OP_WRITE:
+      errNum = WLZ_ERR_WRITE_EOF;
+      if((fP = (strcmp(node->file, "-")?
+               fopen(node->file, "w"): stdout)) != NULL)
+      {
+        errNum = WlzWriteObj(fP, obj);
+	if(strcmp(node->file, "-"))
+	{
+	  if(fclose(fP) && (errNum == WLZ_ERR_NONE))
+	  {
+	    errNum = WLZ_ERR_WRITE_INCOMPLETE;
+	  }
+	}
+	else
+	{
+	  (void )fflush(fP);
+	}
+      }
+      break;
+    case WLZBATCH_OP_AFFINE:
+      tr = WlzAffineTransformFromPrimVal(par->trType,
+      				par->tr[0], par->tr[1], par->tr[2],
+				par->tr[3], par->tr[4], par->tr[5],
+				par->tr[6], par->tr[7], par->tr[8],
+				(par->flg & 2) != 0, &errNum);
+      if(errNum == WLZ_ERR_NONE)
+      {
+        rObj = WlzAffineTransformObj(obj, tr, par->interp, &errNum);
+      }
+      (void )WlzFreeAffineTransform(tr);
+      break;
+    case WLZBATCH_OP_CONVERT:
+      rObj = WlzConvertPix(obj, par->gType, &errNum);
+      break;
+    case WLZBATCH_OP_DIFF:
+      rObj = WlzDiffDomain(obj, nodes[node->in[1]].obj, &errNum);
+      break;
+    case WLZBATCH_OP_DILATION:
+      rObj = WlzBatchMorph(obj, par, 1, &errNum);
+      break;
+    case WLZBATCH_OP_EROSION:
+      rObj = WlzBatchMorph(obj, par, 0, &errNum);
+      break;
+    case WLZBATCH_OP_DOMAIN:
+      if(obj == NULL)
+      {
+        errNum = WLZ_ERR_OBJECT_NULL;
+      }
+      else if(((obj->type == WLZ_2D_DOMAINOBJ) ||
+               (obj->type == WLZ_3D_DOMAINOBJ)) && obj->values.core)
+      {
+        rObj = WlzMakeMain(obj->type, obj->domain, nullValues,
+			   NULL, NULL, &errNum);
+      }
+      else
+      {
+        rObj = obj;
+      }
+      break;
+    case WLZBATCH_OP_GAUSS:
+      rObj = WlzGauss2(obj, par->width[0], par->width[1],
+      		       par->deriv[0], par->deriv[1], &errNum);
+      break;
+    case WLZBATCH_OP_INTERSECT: /* FALLTHROUGH */
+    case WLZBATCH_OP_UNION:
+      if((objs = (WlzObject **)
+                 AlcMalloc(node->nIn * sizeof(WlzObject *))) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      else
+      {
+        for(idx = 0; idx < node->nIn; ++idx)
+	{
+	  objs[idx] = nodes[node->in[idx]].obj;
+	}
+	rObj = (node->desc->op == WLZBATCH_OP_UNION)?
+	       WlzUnionN(node->nIn, objs, 1, &errNum):
+	       WlzIntersectN(node->nIn, objs, 1, &errNum);
+	AlcFree(objs);
+      }
+      break;
+    case WLZBATCH_OP_SAMPLE:
+      rObj = WlzSampleObj(obj, par->iV, par->samFn, &errNum);
+      break;
+    case WLZBATCH_OP_SETBGD:
+      rObj = WlzSetBackGroundNewObj(obj, par->pV, &errNum);
+      break;
+    case WLZBATCH_OP_SHIFT:
+      if(par->flg && obj && obj->domain.core)
+      {
+	WlzIBox3	box;
+
+	box = WlzBoundingBox3I(obj, &errNum);
+	par->iV.vtX = -(box.xMin);
+	par->iV.vtY = -(box.yMin);
+	par->iV.vtZ = -(box.zMin);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+	rObj = WlzShiftObject(obj, par->iV.vtX, par->iV.vtY, par->iV.vtZ,
+			      &errNum);
+      }
+      break;
+    case WLZBATCH_OP_THRESHOLD:
+      rObj = WlzThreshold(obj, par->pV, par->thrType, &errNum);
+      break;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    node->obj = WlzAssignObject(rObj, NULL);
+  }
+  else if(rObj != obj)
+  {
+    (void )WlzFreeObj(rObj);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Dilated or eroded object.
+* \brief	Dilates or erodes the given object in the same way as the
+* 		WlzDilation and WlzErosion binaries, ie using a sphere
+* 		structuring element if the radius is greater than one.
+* \param	obj			Given object.
+* \param	par			Parameters.
+* \param	dilate			Dilate if non-zero else erode.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzBatchMorph(WlzObject *obj, WlzBatchPar *par,
+				int dilate, WlzErrorNum *dstErr)
+{
+  WlzObject	*sObj = NULL,
+  		*rObj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(obj == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if(par->radius > 1)
+  {
+    sObj = WlzAssignObject(
+           WlzMakeSphereObject(((obj->type == WLZ_2D_DOMAINOBJ) ||
+	                        (par->conn == WLZ_8_CONNECTED) ||
+				(par->conn == WLZ_4_CONNECTED))?
+			       WLZ_2D_DOMAINOBJ: WLZ_3D_DOMAINOBJ,
+			       par->radius, 0.0, 0.0, 0.0, &errNum), NULL);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      rObj = (dilate)? WlzStructDilation(obj, sObj, &errNum):
+                       WlzStructErosion(obj, sObj, &errNum);
+    }
+    (void )WlzFreeObj(sObj);
+  }
+  else
+  {
+    rObj = (dilate)? WlzDilation(obj, par->conn, &errNum):
+                     WlzErosion(obj, par->conn, &errNum);
+  }
+  *dstErr = errNum;
+  return(rObj);
+}
+
+/*!
+* \brief	Frees the objects and storage held by the given nodes but
+* 		not the node array itself.
+* \param	nodes			Nodes.
+* \param	nNodes			Number of nodes.
+*/
+static void	WlzBatchFreeNodes(WlzBatchNode *nodes, int nNodes)
+{
+  int		idx;
+
+  for(idx = 0; idx < nNodes; ++idx)
+  {
+    (void )WlzFreeObj(nodes[idx].obj);
+    AlcFree(nodes[idx].name);
+    AlcFree(nodes[idx].file);
+    AlcFree(nodes[idx].in);
+    AlcFree(nodes[idx].after);
+  }
+}
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
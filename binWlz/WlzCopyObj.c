@@ -57,7 +57,7 @@ WlzCopyObj - reads an object and writes it out again which can be useful for
              moving to a new file format.
 \par Synopsis
 \verbatim
-WlzCopyObj [-h] [-o<output file>] [<input file> [... <input file>]]
+WlzCopyObj [-h] [-z] [-o<output file>] [<input file> [... <input file>]]
 \endverbatim
 \par Options
 <table width="500" border="0">
@@ -69,10 +69,16 @@ WlzCopyObj [-h] [-o<output file>] [<input file> [... <input file>]]
     <td><b>-o</b></td>
     <td>Output object file.</td>
   </tr>
+  <tr> 
+    <td><b>-z</b></td>
+    <td>Compress the grey values of the output objects.</td>
+  </tr>
 </table>
 \par Description
 Reads objects and writes them out again which can be useful for
 moving to a new file format.
+Compressed grey values are decompressed on reading, so the -z option
+may be used to compress objects and its omission to decompress them.
 \par Examples
 \verbatim
 WlzCopyObj -o new.wlz old.wlz
@@ -99,7 +105,8 @@ extern char     *optarg;
 
 static WlzErrorNum 		WlzCopyObj(
 				  FILE *outFP,
-				  const char *inFile);
+				  const char *inFile,
+				  WlzIOCompression cmp);
 
 int		main(int argc, char *argv[])
 {
@@ -108,11 +115,12 @@ int		main(int argc, char *argv[])
   		option,
   		usage = 0;
   FILE		*fP = NULL;
+  WlzIOCompression cmp = WLZ_IOCMP_NONE;
   char		*inFileStr,
   		*outFileStr;
   const char	*errMsgStr;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
-  static char   optList[] = "ho:";
+  static char   optList[] = "ho:z";
   const char    inFileStrDef[] = "-",
   	        outFileStrDef[] = "-";
 
@@ -126,6 +134,9 @@ int		main(int argc, char *argv[])
       case 'o':
         outFileStr = optarg;
 	break;
+      case 'z':
+        cmp = WLZ_IOCMP_RLE;
+	break;
       case 'h':
       default:
 	usage = 1;
@@ -149,11 +160,11 @@ int		main(int argc, char *argv[])
     for(idx = 0; (errNum == WLZ_ERR_NONE) && (optind + idx < argc); ++idx)
     {
       inFileStr = *(argv + optind + idx);
-      errNum = WlzCopyObj(fP, inFileStr);
+      errNum = WlzCopyObj(fP, inFileStr, cmp);
     }
     if((errNum == WLZ_ERR_NONE) && (idx == 0))
     {
-      errNum = WlzCopyObj(fP, inFileStr);
+      errNum = WlzCopyObj(fP, inFileStr, cmp);
     }
     if(errNum != WLZ_ERR_NONE)
     {
@@ -171,13 +182,14 @@ int		main(int argc, char *argv[])
   if(usage)
   {
     fprintf(stderr,
-            "Usage: %s [-h] [-o<out file>] [<in file> [... <in file>]]\n"
+            "Usage: %s [-h] [-z] [-o<out file>] [<in file> [... <in file>]]\n"
             "Reads objects and writes them out again which can be useful for\n"
             "moving to a new file format.\n"
 	    "Version: %s\n"
 	    "Options:\n"
 	    "  -h  Help, prints this usage message.\n"
 	    "  -o  Output file.\n"
+	    "  -z  Compress the grey values of the output objects.\n"
             "Examples:\n"
 	    "  %s -o new.wlz old.wlz\n"
 	    "  %s <old.wlz >new.wlz\n"
@@ -197,8 +209,10 @@ int		main(int argc, char *argv[])
 * \param	outFP			Output file pointer.
 * \param	inFile			Input file string, which may use "-"
 * 					to specify the standard input.
+* \param	cmp			Grey value compression method.
 */
-static WlzErrorNum WlzCopyObj(FILE *outFP, const char *inFile)
+static WlzErrorNum WlzCopyObj(FILE *outFP, const char *inFile,
+			      WlzIOCompression cmp)
 {
   WlzObject	*obj = NULL;
   FILE		*inFP = NULL;
@@ -216,7 +230,7 @@ static WlzErrorNum WlzCopyObj(FILE *outFP, const char *inFile)
     }
     while((errNum == WLZ_ERR_NONE) && (obj != NULL))
     {
-      errNum = WlzWriteObj(outFP, obj);
+      errNum = WlzWriteObjCmp(outFP, obj, cmp);
       (void )WlzFreeObj(obj); obj = NULL;
       if(errNum == WLZ_ERR_NONE)
       {
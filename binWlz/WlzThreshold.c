@@ -49,7 +49,7 @@ static char _WlzThreshold_c[] = "University of Edinburgh $Id$";
 WlzThreshold - thresholds a grey-level object.
 \par Synopsis
 \verbatim
-WlzThreshold [-h] [-t#] [-v#] [-H] [-L] [-E] [<input object>]
+WlzThreshold [-h] [-s] [-t#] [-v#] [-H] [-L] [-E] [<input object>]
 \endverbatim
 \par Options
 <table width="500" border="0">
@@ -57,6 +57,14 @@ WlzThreshold [-h] [-t#] [-v#] [-H] [-L] [-E] [<input object>]
     <td><b>-h</b></td>
     <td>Help, prints usage message.</td>
   </tr>
+  <tr> 
+    <td><b>-s</b></td>
+    <td>Stream 3D objects, reading, thresholding and writing them one
+        plane at a time so that objects which are too large to fit in
+	memory may be thresholded. The input must be a seekable file
+	(not a pipe) containing only 3D domain objects, an error is
+	reported if it is not seekable.</td>
+  </tr>
   <tr> 
     <td><b>-t</b></td> <td>Threshold pixel type:
       <table width="500" border="0">
@@ -122,10 +130,25 @@ extern int 	optind, opterr, optopt;
 extern char     *optarg;
 #endif /* __STDC__ ] */
 
+typedef struct _WlzThresholdData
+{
+  WlzPixelV		thresh;
+  WlzThresholdType	highLow;
+} WlzThresholdData;
+
+static WlzObject *WlzThresholdPlane(WlzObject *obj, int plane, void *data,
+				    WlzErrorNum *dstErr)
+{
+  WlzThresholdData *tData;
+
+  tData = (WlzThresholdData *)data;
+  return(WlzThreshold(obj, tData->thresh, tData->highLow, dstErr));
+}
+
 static void usage(char *proc_str)
 {
   fprintf(stderr,
-      "Usage:\t%s [-t#] [-v#] [-H] [-L] [-E] [-h] [<input file>]\n"
+      "Usage:\t%s [-s] [-t#] [-v#] [-H] [-L] [-E] [-h] [<input file>]\n"
       "\tThreshold a grey-level woolz object\n"
       "\twriting the new object to standard output\n"
       "Version: %s\n"
@@ -134,6 +157,9 @@ static void usage(char *proc_str)
       "(default).\n"
       "\t  -L        Threshold low, keep pixels below threshold value.\n"
       "\t  -E        Threshold equal, keep pixels equal to threshold value.\n"
+      "\t  -s        Stream 3D objects one plane at a time, the input\n"
+      "\t            must be a seekable file (not a pipe) of 3D domain\n"
+      "\t            objects.\n"
       "\t  -t#       Threshold pixel type:\n"
       "\t            # = %d: integer (default)\n"
       "\t                %d: short\n"
@@ -156,8 +182,9 @@ int main(int	argc,
 
   WlzObject	*obj, *nobj;
   FILE		*inFile;
-  char 		optList[] = "HLEht:v:";
-  int		option;
+  char 		optList[] = "HLEhst:v:";
+  int		option,
+  		stream = 0;
   WlzThresholdType highLow = WLZ_THRESH_HIGH;
   WlzGreyType	threshpixtype = WLZ_GREY_INT;
   WlzPixelV	thresh;
@@ -230,6 +257,10 @@ int main(int	argc,
       highLow = WLZ_THRESH_EQUAL;
       break;
 
+    case 's':
+      stream = 1;
+      break;
+
     case 'h':
     default:
       usage(argv[0]);
@@ -247,8 +278,42 @@ int main(int	argc,
     }
   }
 
+  /* streaming seeks back over each plane's values, so a pipe or
+     terminal can't be streamed */
+  if( stream && (fseek(inFile, 0L, SEEK_CUR) != 0) ){
+    fprintf(stderr,
+	    "%s: -s requires seekable input (not a pipe or terminal), give\n"
+	    "an input file or redirect the standard input from a file.\n",
+	    argv[0]);
+    if( inFile != stdin ){
+      fclose(inFile);
+    }
+    return 1;
+  }
+
+  /* stream 3D objects, thresholding each plane as it's read */
+  if( stream ){
+    WlzThresholdData tData;
+
+    tData.thresh = thresh;
+    tData.highLow = highLow;
+    while((errNum = WlzPlaneStreamApply(inFile, stdout, NULL,
+    					WlzThresholdPlane, &tData,
+					WLZ_IOCMP_NONE)) == WLZ_ERR_NONE){
+      /* empty */
+    }
+    if((errNum != WLZ_ERR_READ_EOF) && (errNum != WLZ_ERR_EOO)){
+      (void )WlzStringFromErrorNum(errNum, &errMsg);
+      (void )fprintf(stderr, "%s: failed to threshold object stream (%s).\n",
+		     argv[0], errMsg);
+      return(1);
+    }
+    errNum = WLZ_ERR_NONE;
+  }
+
   /* read objects and threshold if possible */
-  while(((obj = WlzAssignObject(WlzReadObj(inFile, NULL), NULL)) != NULL) &&
+  while((stream == 0) &&
+        ((obj = WlzAssignObject(WlzReadObj(inFile, NULL), NULL)) != NULL) &&
         (errNum == WLZ_ERR_NONE))
   {
     switch( obj->type )
@@ -0,0 +1,88 @@
+#!/bin/sh
+#set -x
+#
+# Tests the scheduling of file reads and writes by WlzBatch. Scripts which
+# read back a file written earlier in the script, overwrite a file read
+# earlier in the script and write the same file twice are first checked
+# using the schedule printed by WlzBatch -n and are then run, with the
+# bounding boxes of the objects in the files being checked.
+# The Woolz binaries must be on the PATH.
+
+T=`mktemp -d ${TMPDIR:-/tmp}/WlzBatchTest.XXXXXX` || exit 1
+trap 'rm -rf $T' 0 1 2 15
+FAIL=0
+
+# Prints the schedule level of the given script line.
+Level()
+{
+  WlzBatch -n $1 | awk -v L=$2 '
+    /^level/ {lvl = $2 + 0}
+    $1 == "line" && ($2 + 0) == L {print lvl}'
+}
+
+# Checks that the first given script line is scheduled before the second.
+Before()
+{
+  L0=`Level $1 $2`
+  L1=`Level $1 $3`
+  if [ -z "$L0" ] || [ -z "$L1" ] || [ $L0 -ge $L1 ]
+  then
+    echo "$0: line $2 of $1 is not scheduled before line $3."
+    FAIL=1
+  fi
+}
+
+# Checks the bounding box of the object in the given file.
+Box()
+{
+  B=`WlzBoundingBox $1`
+  if [ "$B" != "$2" ]
+  then
+    echo "$0: $1 has bounding box $B but should have $2."
+    FAIL=1
+  fi
+}
+
+WlzMakeRect -x 0,9 -y 0,9 >$T/a.wlz
+
+# Read after write.
+cat >$T/raw.wsc <<EOF
+a = read $T/a.wlz
+b = WlzShiftObj -x 100 a
+write b $T/b.wlz
+c = read $T/b.wlz
+write c $T/c.wlz
+EOF
+Before $T/raw.wsc 3 4
+WlzBatch $T/raw.wsc || FAIL=1
+Box $T/c.wlz "100 0 0 109 9 0"
+
+# Write after read, c.wlz must be read before it is overwritten.
+cat >$T/war.wsc <<EOF
+x = read $T/a.wlz
+y = WlzShiftObj -x 50 x
+z = read $T/c.wlz
+write y $T/c.wlz
+write z $T/d.wlz
+EOF
+Before $T/war.wsc 3 4
+WlzBatch $T/war.wsc || FAIL=1
+Box $T/c.wlz "50 0 0 59 9 0"
+Box $T/d.wlz "100 0 0 109 9 0"
+
+# Write after write, the last write must win.
+cat >$T/waw.wsc <<EOF
+p = read $T/a.wlz
+q = WlzShiftObj -y 20 p
+write q $T/e.wlz
+write p $T/e.wlz
+EOF
+Before $T/waw.wsc 3 4
+WlzBatch $T/waw.wsc || FAIL=1
+Box $T/e.wlz "0 0 0 9 9 0"
+
+if [ $FAIL -eq 0 ]
+then
+  echo "$0: file reads and writes are run in script order."
+fi
+exit $FAIL
@@ -0,0 +1,258 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstArrayMapped_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstArrayMapped.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for 3D objects with memory mapped values, checking
+* 		that a plane of the object may still be used after the
+* 		3D object has been free'd.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+static short	WlzTstArrayMappedVal(int x, int y, int z);
+
+int		main(int argc, char *argv[])
+{
+  int		idX,
+  		idY,
+		idZ,
+  		option,
+  		ok = 1,
+		usage = 0,
+		plane = 1,
+		nBad = 0;
+  long		offset = 13;
+  short		val;
+  WlzIVertex3	org,
+  		sz;
+  FILE		*fP = NULL;
+  WlzObject	*obj = NULL,
+  		*plnObj = NULL;
+  WlzGreyValueWSpace *gVWSp = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  static char	optList[] = "ho:p:x:y:z:";
+
+  opterr = 0;
+  sz.vtX = 37;
+  sz.vtY = 23;
+  sz.vtZ = 5;
+  org.vtX = -3;
+  org.vtY = 4;
+  org.vtZ = 2;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'o':
+        offset = atol(optarg);
+	break;
+      case 'p':
+        plane = atoi(optarg);
+	break;
+      case 'x':
+        sz.vtX = atoi(optarg);
+	break;
+      case 'y':
+        sz.vtY = atoi(optarg);
+	break;
+      case 'z':
+        sz.vtZ = atoi(optarg);
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  if((usage == 0) &&
+     ((optind != argc) || (offset < 0) || (sz.vtX < 1) || (sz.vtY < 1) ||
+      (sz.vtZ < 1) || (plane < 0) || (plane >= sz.vtZ)))
+  {
+    usage = 1;
+  }
+  ok = !usage;
+  /* Write the values to a temporary file following some leading bytes
+   * so that the values are not page aligned. */
+  if(ok)
+  {
+    if((fP = tmpfile()) == NULL)
+    {
+      ok = 0;
+      (void )fprintf(stderr, "%s: Failed to create temporary file.\n",
+		     *argv);
+    }
+    else
+    {
+      for(idX = 0; ok && (idX < offset); ++idX)
+      {
+        ok = fputc(0xff, fP) != EOF;
+      }
+      for(idZ = 0; ok && (idZ < sz.vtZ); ++idZ)
+      {
+	for(idY = 0; ok && (idY < sz.vtY); ++idY)
+	{
+	  for(idX = 0; ok && (idX < sz.vtX); ++idX)
+	  {
+	    val = WlzTstArrayMappedVal(idX, idY, idZ);
+	    ok = fwrite(&val, sizeof(short), 1, fP) == 1;
+	  }
+	}
+      }
+      if(ok)
+      {
+        ok = fflush(fP) == 0;
+      }
+      if(!ok)
+      {
+	(void )fprintf(stderr, "%s: Failed to write temporary file.\n",
+		       *argv);
+      }
+    }
+  }
+  if(ok)
+  {
+    obj = WlzAssignObject(
+    	  WlzFromArrayMapped1D(WLZ_3D_DOMAINOBJ, sz, org, WLZ_GREY_SHORT,
+			       fileno(fP), offset, 0, &errNum), NULL);
+    if(errNum == WLZ_ERR_UNIMPLEMENTED)
+    {
+      (void )fprintf(stderr, "%s: Memory mapping is not available.\n",
+      		     *argv);
+      (void )fclose(fP);
+      return(0);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      plnObj = WlzAssignObject(
+	       WlzMakeMain(WLZ_2D_DOMAINOBJ,
+			   obj->domain.p->domains[plane],
+			   obj->values.vox->values[plane],
+			   NULL, NULL, &errNum), NULL);
+    }
+    if(errNum != WLZ_ERR_NONE)
+    {
+      ok = 0;
+      (void )WlzStringFromErrorNum(errNum, &errMsg);
+      (void )fprintf(stderr,
+		     "%s: Failed to create mapped object (%s).\n",
+		     *argv, errMsg);
+    }
+  }
+  /* Free the 3D object and close the file while the plane is held. */
+  (void )WlzFreeObj(obj);
+  obj = NULL;
+  if(fP)
+  {
+    (void )fclose(fP);
+  }
+  if(ok)
+  {
+    gVWSp = WlzGreyValueMakeWSp(plnObj, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      for(idY = 0; idY < sz.vtY; ++idY)
+      {
+	for(idX = 0; idX < sz.vtX; ++idX)
+	{
+	  WlzGreyValueGet(gVWSp, 0.0, org.vtY + idY, org.vtX + idX);
+	  if((gVWSp->gType != WLZ_GREY_SHORT) ||
+	     (gVWSp->gVal[0].shv != WlzTstArrayMappedVal(idX, idY, plane)))
+	  {
+	    ++nBad;
+	  }
+	}
+      }
+    }
+    WlzGreyValueFreeWSp(gVWSp);
+    if((errNum != WLZ_ERR_NONE) || (nBad > 0))
+    {
+      ok = 0;
+      (void )fprintf(stderr,
+		     "%s: Plane %d has %d incorrect values after the 3D "
+		     "object was free'd.\n",
+		     *argv, plane, nBad);
+    }
+  }
+  (void )WlzFreeObj(plnObj);
+  if(ok)
+  {
+    (void )printf("%s: Plane values correct after the 3D object was "
+		  "free'd.\n", *argv);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-o#] [-p#] [-x#] [-y#] [-z#]\n"
+    "Creates a 3D object with values memory mapped from a temporary\n"
+    "file, keeps one of its planes, frees the 3D object and then checks\n"
+    "the values of the plane.\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -o  Byte offset of the values in the file (default 13).\n"
+    "  -p  Plane to keep (default 1).\n"
+    "  -x  Number of columns (default 37).\n"
+    "  -y  Number of lines (default 23).\n"
+    "  -z  Number of planes (default 5).\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	Test value.
+* \ingroup	BinWlzTst
+* \brief	Computes the test value for the given array position.
+* \param	x			Column index.
+* \param	y			Line index.
+* \param	z			Plane index.
+*/
+static short	WlzTstArrayMappedVal(int x, int y, int z)
+{
+  return((short )(((z * 1009) + (y * 31) + x) & 0x7fff));
+}
@@ -0,0 +1,293 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstBasisFnTPSEdit_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstBasisFnTPSEdit.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for editable thin plate spline transforms which
+* 		applies a random sequence of control point additions,
+* 		moves and removals, comparing the edited transform with
+* 		one computed afresh by WlzBasisFnTPS2DFromCPts() after
+* 		each edit.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+static void			WlzTstBasisFnTPSEditRndPts(
+				  WlzDVertex2 *dPt,
+				  WlzDVertex2 *sPt,
+				  double size);
+static double			WlzTstBasisFnTPSEditCmp(
+				  WlzBasisFn *fn0,
+				  WlzBasisFn *fn1,
+				  double size);
+
+int		main(int argc, char *argv[])
+{
+  int		idE,
+		idP,
+		option,
+  		ok = 1,
+		usage = 0,
+		nEdit = 50,
+		nPts = 10,
+		maxPts = 0,
+		verbose = 0;
+  long		seed = 0;
+  double	tol = 1.0e-6,
+  		size = 100.0,
+		maxErr = 0.0;
+  WlzDVertex2	*dPts = NULL,
+  		*sPts = NULL;
+  WlzBasisFnTPS2DEdit *edt = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*op = "new",
+  		*errMsg;
+  static char	optList[] = "he:n:s:t:v";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'e':
+        nEdit = atoi(optarg);
+	break;
+      case 'n':
+        nPts = atoi(optarg);
+	break;
+      case 's':
+        seed = atol(optarg);
+	break;
+      case 't':
+        tol = atof(optarg);
+	break;
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  if((usage == 0) &&
+     ((optind != argc) || (nPts < 4) || (nEdit < 0) || (tol <= 0.0)))
+  {
+    usage = 1;
+  }
+  ok = !usage;
+  if(ok)
+  {
+    /* Every edit may be an addition. */
+    maxPts = nPts + nEdit;
+    if(((dPts = (WlzDVertex2 *)
+                AlcMalloc(maxPts * sizeof(WlzDVertex2))) == NULL) ||
+       ((sPts = (WlzDVertex2 *)
+                AlcMalloc(maxPts * sizeof(WlzDVertex2))) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      srand48(seed);
+      for(idP = 0; idP < nPts; ++idP)
+      {
+	WlzTstBasisFnTPSEditRndPts(dPts + idP, sPts + idP, size);
+      }
+      edt = WlzBasisFnTPS2DEditNew(nPts, dPts, sPts, &errNum);
+    }
+  }
+  for(idE = 0; ok && (errNum == WLZ_ERR_NONE) && (idE <= nEdit); ++idE)
+  {
+    double	err;
+    WlzBasisFn	*fn = NULL;
+
+    /* Edit zero is the new transform, after this edit randomly. */
+    if(idE > 0)
+    {
+      double	r;
+
+      r = drand48();
+      idP = (int )(drand48() * nPts) % nPts;
+      if(r < 0.4)
+      {
+	op = "add";
+	WlzTstBasisFnTPSEditRndPts(dPts + nPts, sPts + nPts, size);
+	errNum = WlzBasisFnTPS2DEditAdd(edt, dPts[nPts], sPts[nPts]);
+	++nPts;
+      }
+      else if((r < 0.7) || (nPts <= 4))
+      {
+	op = "move";
+	WlzTstBasisFnTPSEditRndPts(dPts + idP, sPts + idP, size);
+	errNum = WlzBasisFnTPS2DEditMove(edt, idP, dPts[idP], sPts[idP]);
+      }
+      else
+      {
+	op = "remove";
+	errNum = WlzBasisFnTPS2DEditRemove(edt, idP);
+	--nPts;
+	(void )memmove(dPts + idP, dPts + idP + 1,
+		       (nPts - idP) * sizeof(WlzDVertex2));
+	(void )memmove(sPts + idP, sPts + idP + 1,
+		       (nPts - idP) * sizeof(WlzDVertex2));
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      fn = WlzBasisFnTPS2DFromCPts(nPts, dPts, sPts, NULL, NULL, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      err = WlzTstBasisFnTPSEditCmp(edt->basisTr->basisFn, fn, size);
+      maxErr = WLZ_MAX(maxErr, err);
+      if(verbose)
+      {
+	(void )fprintf(stderr, "%s: edit %d %s (%d points) error %g\n",
+		       *argv, idE, op, nPts, err);
+      }
+      if(err > tol)
+      {
+	ok = 0;
+	(void )fprintf(stderr,
+		       "%s: edit %d (%s) differs from a new transform by "
+		       "%g.\n",
+		       *argv, idE, op, err);
+      }
+    }
+    (void )WlzBasisFnFree(fn);
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to %s transform (%s).\n",
+		   *argv, op, errMsg);
+  }
+  if(ok)
+  {
+    (void )printf("%s: %d edits, maximum relative difference %g.\n",
+		  *argv, nEdit, maxErr);
+  }
+  (void )WlzBasisFnTPS2DEditFree(edt);
+  AlcFree(dPts);
+  AlcFree(sPts);
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-e#] [-n#] [-s#] [-t#] [-v]\n"
+    "Applies a random sequence of control point additions, moves and\n"
+    "removals to an editable thin plate spline transform, comparing the\n"
+    "transform with one computed by WlzBasisFnTPS2DFromCPts() after each\n"
+    "edit.\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -e  Number of edits (default 50).\n"
+    "  -n  Initial number of control points (default 10).\n"
+    "  -s  Seed for the random number generator (default 0).\n"
+    "  -t  Tolerance for the maximum difference relative to the\n"
+    "      size of the region (default 1.0e-6).\n"
+    "  -v  Verbose output.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \ingroup	BinWlzTst
+* \brief	Sets a random destination control point within the
+* 		region and a source control point displaced from it.
+* \param	dPt			Destination control point.
+* \param	sPt			Source control point.
+* \param	size			Size of the region.
+*/
+static void	WlzTstBasisFnTPSEditRndPts(WlzDVertex2 *dPt,
+				WlzDVertex2 *sPt, double size)
+{
+  dPt->vtX = drand48() * size;
+  dPt->vtY = drand48() * size;
+  sPt->vtX = dPt->vtX + ((drand48() - 0.5) * size * 0.1);
+  sPt->vtY = dPt->vtY + ((drand48() - 0.5) * size * 0.1);
+}
+
+/*!
+* \return	Maximum difference relative to the size of the region.
+* \ingroup	BinWlzTst
+* \brief	Compares two thin plate spline basis functions on a
+* 		grid which extends beyond the region of the control
+* 		points.
+* \param	fn0			First basis function.
+* \param	fn1			Second basis function.
+* \param	size			Size of the region.
+*/
+static double	WlzTstBasisFnTPSEditCmp(WlzBasisFn *fn0, WlzBasisFn *fn1,
+				double size)
+{
+  int		idX,
+  		idY;
+  const int	nGrid = 24;
+  double	d,
+  		maxD = 0.0;
+  WlzDVertex2	p,
+  		v0,
+		v1;
+
+  for(idY = 0; idY <= nGrid; ++idY)
+  {
+    p.vtY = size * (((1.5 * idY) / nGrid) - 0.25);
+    for(idX = 0; idX <= nGrid; ++idX)
+    {
+      p.vtX = size * (((1.5 * idX) / nGrid) - 0.25);
+      v0 = WlzBasisFnValueTPS2D(fn0, p);
+      v1 = WlzBasisFnValueTPS2D(fn1, p);
+      d = WLZ_MAX(fabs(v0.vtX - v1.vtX), fabs(v0.vtY - v1.vtY));
+      maxD = WLZ_MAX(maxD, d);
+    }
+  }
+  return(maxD / size);
+}
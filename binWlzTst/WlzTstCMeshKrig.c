@@ -0,0 +1,866 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstCMeshKrig_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstCMeshKrig.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for the grouped ordinary kriging used by conforming
+* 		mesh transforms. WlzKrigOWeightsSolveN() is compared
+* 		with WlzKrigOWeightsSolve() for random neighbourhoods.
+* 		The displacements which WlzCMeshProduct() finds by
+* 		kriging, for nodes displaced outside of the second mesh,
+* 		and the values which WlzCMeshToDomObjValues() finds with
+* 		WLZ_INTERPOLATION_KRIG are compared with those found
+* 		by kriging each node or pixel on its own, with the
+* 		model semi-variogram set up afresh every time.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+static int			WlzTstCMeshKrigSolveN(
+				  int dim,
+				  double eps,
+				  WlzErrorNum *dstErr);
+static int			WlzTstCMeshKrigProduct(
+				  int dim,
+				  double eps,
+				  int *dstNKrig,
+				  WlzErrorNum *dstErr);
+static int			WlzTstCMeshKrigInterp(
+				  double eps,
+				  int *dstNPix,
+				  WlzErrorNum *dstErr);
+static WlzErrorNum		WlzTstCMeshKrigWeights(
+				  int dim,
+				  double range,
+				  int nNbr,
+				  WlzVertexP nbr,
+				  WlzDVertex3 pos,
+				  double *wgt);
+static WlzObject		*WlzTstCMeshKrigMakeTr(
+				  int dim,
+				  double r,
+				  double x,
+				  double maxDist,
+				  WlzErrorNum *dstErr);
+
+int		main(int argc, char *argv[])
+{
+  int		dim,
+  		nKrig,
+		nPix,
+  		option,
+		ok = 1,
+		usage = 0,
+		verbose = 0;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  const double	eps = 1.0e-6;
+  static char	optList[] = "hv";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0) && (optind == argc);
+  usage = !ok;
+  if(ok)
+  {
+    AlgRandSeed(0);
+  }
+  for(dim = 2; ok && (errNum == WLZ_ERR_NONE) && (dim <= 3); ++dim)
+  {
+    ok = WlzTstCMeshKrigSolveN(dim, eps, &errNum);
+    if((errNum == WLZ_ERR_NONE) && (verbose || !ok))
+    {
+      (void )fprintf(stderr, "%s: %dD WlzKrigOWeightsSolveN() %s.\n",
+		     *argv, dim,
+		     (ok)? "ok": "differs from WlzKrigOWeightsSolve()");
+    }
+    if(ok && (errNum == WLZ_ERR_NONE))
+    {
+      ok = WlzTstCMeshKrigProduct(dim, eps, &nKrig, &errNum);
+      if((errNum == WLZ_ERR_NONE) && (verbose || !ok))
+      {
+	(void )fprintf(stderr, "%s: %dD WlzCMeshProduct() with %d kriged "
+		       "nodes %s.\n",
+		       *argv, dim, nKrig,
+		       (ok)? "ok": "differs from kriging each node");
+      }
+    }
+  }
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    ok = WlzTstCMeshKrigInterp(eps, &nPix, &errNum);
+    if((errNum == WLZ_ERR_NONE) && (verbose || !ok))
+    {
+      (void )fprintf(stderr, "%s: WlzCMeshToDomObjValues() kriging with %d "
+		     "pixels %s.\n",
+		     *argv, nPix,
+		     (ok)? "ok": "differs from kriging each pixel");
+    }
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to test mesh kriging (%s).\n",
+		   *argv, errMsg);
+  }
+  if(ok)
+  {
+    (void )printf("%s: Grouped mesh kriging matches kriging each position "
+    		  "on its own.\n", *argv);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-v]\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -v  Verbose output.\n"
+    "Tests WlzKrigOWeightsSolveN() against WlzKrigOWeightsSolve() and\n"
+    "the kriging of WlzCMeshProduct() and of WlzCMeshToDomObjValues()\n"
+    "against kriging each node or pixel on its own.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	Non-zero if the weights match.
+* \ingroup	BinWlzTst
+* \brief	Computes the kriging weights for random positions within
+* 		random neighbourhoods using WlzKrigOWeightsSolveN() and
+* 		compares them with those computed by
+* 		WlzTstCMeshKrigWeights(). One of the positions is at a
+* 		neighbour, for which the weight of that neighbour must
+* 		be one.
+* \param	dim			Dimension, 2 or 3.
+* \param	eps			Tolerance for the weights.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstCMeshKrigSolveN(int dim, double eps,
+				      WlzErrorNum *dstErr)
+{
+  int		idR,
+  		idN,
+		idP,
+		ok = 1;
+  int		*wSp = NULL;
+  double	*posSV = NULL,
+  		*wgt = NULL;
+  AlgMatrix	modelSV;
+  WlzVertexP	nbr;
+  WlzDVertex3	*pos = NULL;
+  WlzKrigModelFn modelFn;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const int	nRep = 5,
+  		maxNbr = 12,
+		nPos = 20;
+  const double	range = 20.0;
+
+  nbr.v = NULL;
+  modelSV.core = NULL;
+  WlzKrigSetModelFn(&modelFn, WLZ_KRIG_MODELFN_LINEAR, 0.0, 0.1, range);
+  modelSV = AlgMatrixNew(ALG_MATRIX_RECT, maxNbr + 1, maxNbr + 1, 0, 0.0,
+  			 NULL);
+  if((modelSV.core == NULL) ||
+     ((wSp = (int *)AlcMalloc(sizeof(int) * (maxNbr + 1))) == NULL) ||
+     ((wgt = (double *)AlcMalloc(sizeof(double) * (maxNbr + 1))) == NULL) ||
+     ((posSV = (double *)
+               AlcMalloc(sizeof(double) * nPos * (maxNbr + 1))) == NULL) ||
+     ((pos = (WlzDVertex3 *)
+             AlcMalloc(sizeof(WlzDVertex3) * nPos)) == NULL) ||
+     ((nbr.v = AlcMalloc(sizeof(WlzDVertex3) * maxNbr)) == NULL))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  for(idR = 0; ok && (errNum == WLZ_ERR_NONE) && (idR < nRep); ++idR)
+  {
+    int		nNbr;
+
+    /* Random neighbourhood and positions, with the first position at a
+     * neighbour. */
+    nNbr = maxNbr - idR;
+    for(idN = 0; idN < nNbr; ++idN)
+    {
+      if(dim == 2)
+      {
+        nbr.d2[idN].vtX = 10.0 * AlgRandUniform();
+        nbr.d2[idN].vtY = 10.0 * AlgRandUniform();
+      }
+      else
+      {
+        nbr.d3[idN].vtX = 10.0 * AlgRandUniform();
+        nbr.d3[idN].vtY = 10.0 * AlgRandUniform();
+        nbr.d3[idN].vtZ = 10.0 * AlgRandUniform();
+      }
+    }
+    for(idP = 0; idP < nPos; ++idP)
+    {
+      if(idP == 0)
+      {
+	pos[idP].vtX = (dim == 2)? nbr.d2[idR].vtX: nbr.d3[idR].vtX;
+	pos[idP].vtY = (dim == 2)? nbr.d2[idR].vtY: nbr.d3[idR].vtY;
+	pos[idP].vtZ = (dim == 2)? 0.0: nbr.d3[idR].vtZ;
+      }
+      else
+      {
+	pos[idP].vtX = 12.0 * AlgRandUniform() - 1.0;
+	pos[idP].vtY = 12.0 * AlgRandUniform() - 1.0;
+	pos[idP].vtZ = (dim == 2)? 0.0: 12.0 * AlgRandUniform() - 1.0;
+      }
+    }
+    modelSV.rect->nR = modelSV.rect->nC = nNbr + 1;
+    errNum = (dim == 2)?
+             WlzKrigOSetModelSV2D(modelSV, &modelFn, nNbr, nbr.d2, wSp):
+             WlzKrigOSetModelSV3D(modelSV, &modelFn, nNbr, nbr.d3, wSp);
+    for(idP = 0; (errNum == WLZ_ERR_NONE) && (idP < nPos); ++idP)
+    {
+      double	*sv;
+
+      sv = posSV + (idP * (nNbr + 1));
+      if(dim == 2)
+      {
+	WlzDVertex2 p;
+
+	p.vtX = pos[idP].vtX;
+	p.vtY = pos[idP].vtY;
+	errNum = WlzKrigOSetPosSV2D(sv, &modelFn, nNbr, nbr.d2, p);
+      }
+      else
+      {
+	errNum = WlzKrigOSetPosSV3D(sv, &modelFn, nNbr, nbr.d3, pos[idP]);
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = WlzKrigOWeightsSolveN(modelSV, nPos, posSV, wSp,
+      				     WLZ_MESH_TOLERANCE);
+    }
+    for(idP = 0; ok && (errNum == WLZ_ERR_NONE) && (idP < nPos); ++idP)
+    {
+      double	sum = 0.0;
+      double	*w;
+
+      w = posSV + (idP * (nNbr + 1));
+      errNum = WlzTstCMeshKrigWeights(dim, range, nNbr, nbr, pos[idP], wgt);
+      for(idN = 0; ok && (errNum == WLZ_ERR_NONE) && (idN < nNbr); ++idN)
+      {
+	sum += w[idN];
+        if((fabs(w[idN] - wgt[idN]) > eps) ||
+	   ((idP == 0) &&
+	    (fabs(w[idN] - ((idN == idR)? 1.0: 0.0)) > eps)))
+	{
+	  ok = 0;
+	  (void )fprintf(stderr, "WlzTstCMeshKrigSolveN: Weight %d of "
+	  		 "position %d is %g but should be %g.\n",
+			 idN, idP, w[idN], wgt[idN]);
+	}
+      }
+      if(ok && (errNum == WLZ_ERR_NONE) && (fabs(sum - 1.0) > eps))
+      {
+        ok = 0;
+	(void )fprintf(stderr, "WlzTstCMeshKrigSolveN: Weights of position "
+		       "%d sum to %g.\n", idP, sum);
+      }
+    }
+  }
+  AlgMatrixFree(modelSV);
+  AlcFree(wSp);
+  AlcFree(wgt);
+  AlcFree(posSV);
+  AlcFree(pos);
+  AlcFree(nbr.v);
+  *dstErr = errNum;
+  return(ok);
+}
+
+/*!
+* \return	Non-zero if the product's kriged displacements match.
+* \ingroup	BinWlzTst
+* \brief	Computes the product of two mesh transforms with the
+* 		displaced nodes of the first falling outside of the
+* 		second along one side, so that many of the product's
+* 		displacements are found by kriging. Each of these
+* 		displacements is compared with that found by kriging
+* 		the node on its own, using the ring of nodes around the
+* 		closest node of the second mesh.
+* \param	dim			Dimension, 2 or 3.
+* \param	eps			Tolerance for the displacements.
+* \param	dstNKrig		Destination pointer for the number of
+* 					kriged nodes.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstCMeshKrigProduct(int dim, double eps, int *dstNKrig,
+				       WlzErrorNum *dstErr)
+{
+  int		idN,
+  		nNod = 0,
+		nKrig = 0,
+		maxIdxBuf = 0,
+		ok = 1;
+  int		*nodTab = NULL,
+  		*idxBuf = NULL;
+  double	range = 0.0;
+  double	*wgt = NULL;
+  WlzVertexP	nbr;
+  WlzObject	*tr0 = NULL,
+  		*tr1 = NULL,
+		*trP = NULL,
+		*trI = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const WlzDVertex3 dsp = {1.5, -0.5, 0.7};
+
+  nbr.v = NULL;
+  tr0 = WlzAssignObject(
+        WlzTstCMeshKrigMakeTr(dim, (dim == 2)? 20.0: 12.0, 0.0,
+			      (dim == 2)? 6.0: 8.0, &errNum), NULL);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    tr1 = WlzAssignObject(
+	  WlzTstCMeshKrigMakeTr(dim, (dim == 2)? 18.0: 11.0, 1.0,
+				(dim == 2)? 6.0: 8.0, &errNum), NULL);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    double	*d;
+
+    nNod = (dim == 2)? tr0->domain.cm2->res.nod.maxEnt:
+                       tr0->domain.cm3->res.nod.maxEnt;
+    range = 2.0 * sqrt((dim == 2)? tr1->domain.cm2->maxSqEdgLen:
+    				   tr1->domain.cm3->maxSqEdgLen);
+    for(idN = 0; idN < nNod; ++idN)
+    {
+      d = (double *)WlzIndexedValueGet(tr0->values.x, idN);
+      d[0] = dsp.vtX;
+      d[1] = dsp.vtY;
+      if(dim == 3)
+      {
+        d[2] = dsp.vtZ;
+      }
+    }
+    trP = WlzAssignObject(WlzCMeshProduct(tr0, tr1, &errNum), NULL);
+  }
+  /* The product's mesh is that of the intersection, with the node table
+   * mapping the nodes of the first mesh to its nodes. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    trI = WlzAssignObject(WlzCMeshIntersect(tr0, tr1, 1, &nodTab, &errNum),
+    			  NULL);
+  }
+  if((errNum == WLZ_ERR_NONE) &&
+     ((nbr.v = AlcMalloc(sizeof(WlzDVertex3) * 64)) == NULL))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  for(idN = 0; ok && (errNum == WLZ_ERR_NONE) && (idN < nNod); ++idN)
+  {
+    int		idE,
+    		idC,
+		idR,
+		nNbr = 0;
+    double	*dP;
+    WlzDVertex3	p,
+    		q,
+		d;
+
+    if(nodTab[idN] >= 0)
+    {
+      /* Find the displaced position and whether it is within the second
+       * mesh, if it is then it isn't kriged. */
+      if(dim == 2)
+      {
+	WlzCMeshNod2D *nod;
+
+        nod = (WlzCMeshNod2D *)AlcVectorItemGet(tr0->domain.cm2->res.nod.vec,
+						idN);
+	p.vtX = nod->pos.vtX;
+	p.vtY = nod->pos.vtY;
+	p.vtZ = 0.0;
+	idE = WlzCMeshElmEnclosingPos2D(tr1->domain.cm2, -1,
+					p.vtX + dsp.vtX, p.vtY + dsp.vtY,
+					0, NULL);
+      }
+      else
+      {
+	WlzCMeshNod3D *nod;
+
+        nod = (WlzCMeshNod3D *)AlcVectorItemGet(tr0->domain.cm3->res.nod.vec,
+						idN);
+	p = nod->pos;
+	idE = WlzCMeshElmEnclosingPos3D(tr1->domain.cm3, -1,
+					p.vtX + dsp.vtX, p.vtY + dsp.vtY,
+					p.vtZ + dsp.vtZ, 0, NULL);
+      }
+      if(idE < 0)
+      {
+	WLZ_VTX_3_ADD(q, p, dsp);
+	if(dim == 2)
+	{
+	  WlzDVertex2 q2;
+	  WlzCMeshNod2D *nod;
+
+	  q2.vtX = q.vtX;
+	  q2.vtY = q.vtY;
+	  idC = WlzCMeshClosestNod2D(tr1->domain.cm2, q2);
+	  nod = (WlzCMeshNod2D *)AlcVectorItemGet(tr1->domain.cm2->res.nod.vec,
+	  					  idC);
+	  nNbr = WlzCMeshNodRingNodIndices2D(nod, &maxIdxBuf, &idxBuf,
+	  				     &errNum);
+	}
+	else
+	{
+	  WlzCMeshNod3D *nod;
+
+	  idC = WlzCMeshClosestNod3D(tr1->domain.cm3, q);
+	  nod = (WlzCMeshNod3D *)AlcVectorItemGet(tr1->domain.cm3->res.nod.vec,
+	  					  idC);
+	  nNbr = WlzCMeshNodRingNodIndices3D(nod, &maxIdxBuf, &idxBuf,
+	  				     &errNum);
+	}
+	if((errNum == WLZ_ERR_NONE) && (nNbr > 63))
+	{
+	  errNum = WLZ_ERR_DOMAIN_DATA;
+	}
+	if((errNum == WLZ_ERR_NONE) &&
+	   ((wgt = (double *)AlcRealloc(wgt,
+	   			sizeof(double) * (nNbr + 1))) == NULL))
+	{
+	  errNum = WLZ_ERR_MEM_ALLOC;
+	}
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  for(idR = 0; idR < nNbr; ++idR)
+	  {
+	    if(dim == 2)
+	    {
+	      nbr.d2[idR] = ((WlzCMeshNod2D *)
+	      		     AlcVectorItemGet(tr1->domain.cm2->res.nod.vec,
+			     		      idxBuf[idR]))->pos;
+	    }
+	    else
+	    {
+	      nbr.d3[idR] = ((WlzCMeshNod3D *)
+	      		     AlcVectorItemGet(tr1->domain.cm3->res.nod.vec,
+			     		      idxBuf[idR]))->pos;
+	    }
+	  }
+	  errNum = WlzTstCMeshKrigWeights(dim, range, nNbr, nbr, q, wgt);
+	}
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  /* The product's displacement is the kriged displacement plus the
+	   * first displacement. */
+	  d = dsp;
+	  for(idR = 0; idR < nNbr; ++idR)
+	  {
+	    double *d1;
+
+	    d1 = (double *)WlzIndexedValueGet(tr1->values.x, idxBuf[idR]);
+	    d.vtX += wgt[idR] * d1[0];
+	    d.vtY += wgt[idR] * d1[1];
+	    if(dim == 3)
+	    {
+	      d.vtZ += wgt[idR] * d1[2];
+	    }
+	  }
+	  ++nKrig;
+	  dP = (double *)WlzIndexedValueGet(trP->values.x, nodTab[idN]);
+	  if((fabs(dP[0] - d.vtX) > eps) || (fabs(dP[1] - d.vtY) > eps) ||
+	     ((dim == 3) && (fabs(dP[2] - d.vtZ) > eps)))
+	  {
+	    ok = 0;
+	    (void )fprintf(stderr, "WlzTstCMeshKrigProduct: Node %d at "
+	    		   "%g,%g,%g has displacement %g,%g,%g but should "
+			   "have %g,%g,%g.\n",
+			   idN, p.vtX, p.vtY, p.vtZ,
+			   dP[0], dP[1], (dim == 3)? dP[2]: 0.0,
+			   d.vtX, d.vtY, d.vtZ);
+	  }
+	}
+      }
+    }
+  }
+  AlcFree(nodTab);
+  AlcFree(idxBuf);
+  AlcFree(wgt);
+  AlcFree(nbr.v);
+  (void )WlzFreeObj(tr0);
+  (void )WlzFreeObj(tr1);
+  (void )WlzFreeObj(trP);
+  (void )WlzFreeObj(trI);
+  *dstNKrig = nKrig;
+  *dstErr = errNum;
+  return(ok);
+}
+
+/*!
+* \return	Non-zero if the interpolated values match.
+* \ingroup	BinWlzTst
+* \brief	Interpolates the values of a 2D mesh throughout a
+* 		rectangle which extends beyond the mesh, using
+* 		WlzCMeshToDomObjValues() with WLZ_INTERPOLATION_KRIG, and
+* 		compares the values with those found by kriging each
+* 		pixel on its own. The rings of nodes are chosen just as
+* 		by WlzCMeshToDomObjValues(), around the enclosing element
+* 		or if there is none around the closest node, with the
+* 		last enclosing element being used to start each search
+* 		along an interval.
+* \param	eps			Tolerance for the values.
+* \param	dstNPix			Destination pointer for the number of
+* 					pixels.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstCMeshKrigInterp(double eps, int *dstNPix,
+				      WlzErrorNum *dstErr)
+{
+  int		nPix = 0,
+  		maxIdxBuf = 0,
+		ok = 1;
+  int		*idxBuf = NULL;
+  double	range = 0.0;
+  double	*wgt = NULL;
+  WlzVertexP	nbr;
+  WlzValues	val;
+  WlzPixelV	bgdV;
+  WlzCMesh2D	*mesh = NULL;
+  WlzObject	*tr = NULL,
+  		*mObj = NULL,
+		*rObj = NULL,
+		*iObj = NULL;
+  WlzIntervalWSpace iWSp;
+  WlzGreyWSpace	gWSp;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  nbr.v = NULL;
+  val.core = NULL;
+  tr = WlzAssignObject(
+       WlzTstCMeshKrigMakeTr(2, 20.0, 0.0, 5.0, &errNum), NULL);
+  /* Mesh object with a smooth but non-linear scalar value at each node. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    mesh = tr->domain.cm2;
+    range = 2.0 * sqrt(mesh->maxSqEdgLen);
+    mObj = WlzAssignObject(
+           WlzMakeMain(WLZ_CMESH_2D, tr->domain, val, NULL, NULL, &errNum),
+	   NULL);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    val.x = WlzMakeIndexedValues(mObj, 0, NULL, WLZ_GREY_DOUBLE,
+    				 WLZ_VALUE_ATTACH_NOD, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idN;
+
+    mObj->values = WlzAssignValues(val, NULL);
+    for(idN = 0; idN < mesh->res.nod.maxEnt; ++idN)
+    {
+      WlzCMeshNod2D *nod;
+
+      nod = (WlzCMeshNod2D *)AlcVectorItemGet(mesh->res.nod.vec, idN);
+      *(double *)WlzIndexedValueGet(val.x, idN) =
+          (0.3 * nod->pos.vtX) - (0.2 * nod->pos.vtY) +
+	  (5.0 * sin(0.2 * nod->pos.vtX) * cos(0.15 * nod->pos.vtY));
+    }
+    bgdV.type = WLZ_GREY_INT;
+    bgdV.v.inv = 0;
+    iObj = WlzAssignObject(
+           WlzMakeRect(-24, 24, -26, 25, WLZ_GREY_ERROR, NULL, bgdV,
+	   	       NULL, NULL, &errNum), NULL);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    rObj = WlzAssignObject(
+           WlzCMeshToDomObjValues(iObj, mObj, WLZ_INTERPOLATION_KRIG,
+	   			  &errNum), NULL);
+  }
+  if((errNum == WLZ_ERR_NONE) &&
+     ((nbr.v = AlcMalloc(sizeof(WlzDVertex2) * 64)) == NULL))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = WlzInitGreyScan(rObj, &iWSp, &gWSp);
+  }
+  while(ok && (errNum == WLZ_ERR_NONE) &&
+        ((errNum = WlzNextGreyInterval(&iWSp)) == WLZ_ERR_NONE))
+  {
+    int		idI,
+		idE0 = -1;
+    WlzDVertex3	p;
+
+    p.vtY = iWSp.linpos;
+    p.vtZ = 0.0;
+    for(idI = 0; ok && (errNum == WLZ_ERR_NONE) &&
+                 (idI <= iWSp.rgtpos - iWSp.lftpos); ++idI)
+    {
+      int	idE1,
+      		idN,
+		idR,
+		nNbr = 0;
+      double	v,
+      		v0;
+
+      p.vtX = iWSp.lftpos + idI;
+      idE1 = WlzCMeshElmEnclosingPos2D(mesh, idE0, p.vtX, p.vtY, 0, &idN);
+      if(idE1 >= 0)
+      {
+        nNbr = WlzCMeshElmRingNodIndices2D(
+	       (WlzCMeshElm2D *)AlcVectorItemGet(mesh->res.elm.vec, idE1),
+	       &maxIdxBuf, &idxBuf, &errNum);
+	idE0 = idE1;
+      }
+      else if(idN >= 0)
+      {
+        nNbr = WlzCMeshNodRingNodIndices2D(
+	       (WlzCMeshNod2D *)AlcVectorItemGet(mesh->res.nod.vec, idN),
+	       &maxIdxBuf, &idxBuf, &errNum);
+	idE0 = -1;
+      }
+      else
+      {
+        errNum = WLZ_ERR_DOMAIN_DATA;
+      }
+      if((errNum == WLZ_ERR_NONE) && (nNbr > 63))
+      {
+	errNum = WLZ_ERR_DOMAIN_DATA;
+      }
+      if((errNum == WLZ_ERR_NONE) &&
+	 ((wgt = (double *)AlcRealloc(wgt,
+				      sizeof(double) * (nNbr + 1))) == NULL))
+      {
+	errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+	for(idR = 0; idR < nNbr; ++idR)
+	{
+	  nbr.d2[idR] = ((WlzCMeshNod2D *)
+			 AlcVectorItemGet(mesh->res.nod.vec,
+					  idxBuf[idR]))->pos;
+	}
+	errNum = WlzTstCMeshKrigWeights(2, range, nNbr, nbr, p, wgt);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+	v = 0.0;
+	for(idR = 0; idR < nNbr; ++idR)
+	{
+	  v += wgt[idR] * *(double *)WlzIndexedValueGet(val.x, idxBuf[idR]);
+	}
+	v0 = gWSp.u_grintptr.dbp[idI];
+	++nPix;
+	if(fabs(v - v0) > eps)
+	{
+	  ok = 0;
+	  (void )fprintf(stderr, "WlzTstCMeshKrigInterp: Pixel %g,%g has "
+	  		 "value %g but should have %g.\n",
+			 p.vtX, p.vtY, v0, v);
+	}
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_EOO)
+  {
+    errNum = WLZ_ERR_NONE;
+  }
+  AlcFree(idxBuf);
+  AlcFree(wgt);
+  AlcFree(nbr.v);
+  (void )WlzFreeObj(tr);
+  (void )WlzFreeObj(mObj);
+  (void )WlzFreeObj(rObj);
+  (void )WlzFreeObj(iObj);
+  *dstNPix = nPix;
+  *dstErr = errNum;
+  return(ok);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	BinWlzTst
+* \brief	Computes the ordinary kriging weights for a single
+* 		position, with a linear model and the model
+* 		semi-variogram being set up and decomposed afresh.
+* \param	dim			Dimension, 2 or 3.
+* \param	range			Range of the linear model.
+* \param	nNbr			Number of neighbours.
+* \param	nbr			Neighbour positions, 2 or 3D double
+* 					vertices.
+* \param	pos			Position, with z ignored in 2D.
+* \param	wgt			Destination for the nNbr + 1 weights.
+*/
+static WlzErrorNum WlzTstCMeshKrigWeights(int dim, double range, int nNbr,
+				          WlzVertexP nbr, WlzDVertex3 pos,
+					  double *wgt)
+{
+  int		*wSp = NULL;
+  AlgMatrix	modelSV;
+  WlzKrigModelFn modelFn;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  WlzKrigSetModelFn(&modelFn, WLZ_KRIG_MODELFN_LINEAR, 0.0, 0.1, range);
+  modelSV = AlgMatrixNew(ALG_MATRIX_RECT, nNbr + 1, nNbr + 1, 0, 0.0, NULL);
+  if((modelSV.core == NULL) ||
+     ((wSp = (int *)AlcMalloc(sizeof(int) * (nNbr + 1))) == NULL))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else if(dim == 2)
+  {
+    WlzDVertex2	p;
+
+    p.vtX = pos.vtX;
+    p.vtY = pos.vtY;
+    errNum = WlzKrigOSetModelSV2D(modelSV, &modelFn, nNbr, nbr.d2, wSp);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = WlzKrigOSetPosSV2D(wgt, &modelFn, nNbr, nbr.d2, p);
+    }
+  }
+  else
+  {
+    errNum = WlzKrigOSetModelSV3D(modelSV, &modelFn, nNbr, nbr.d3, wSp);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = WlzKrigOSetPosSV3D(wgt, &modelFn, nNbr, nbr.d3, pos);
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = WlzKrigOWeightsSolve(modelSV, wgt, wSp, WLZ_MESH_TOLERANCE);
+  }
+  AlgMatrixFree(modelSV);
+  AlcFree(wSp);
+  return(errNum);
+}
+
+/*!
+* \return	New mesh transform or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Makes a conforming mesh transform with zero displacements
+* 		for a disc or sphere, with the 2nd mesh transform having
+* 		displacements which vary smoothly with position.
+* \param	dim			Dimension, 2 or 3.
+* \param	r			Radius of the disc or sphere.
+* \param	x			Column coordinate of the centre.
+* \param	maxDist			Maximum distance between nodes.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstCMeshKrigMakeTr(int dim, double r, double x,
+				        double maxDist, WlzErrorNum *dstErr)
+{
+  WlzObject	*obj = NULL,
+  		*tr = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  obj = WlzAssignObject(
+        WlzMakeSphereObject((dim == 2)? WLZ_2D_DOMAINOBJ: WLZ_3D_DOMAINOBJ,
+			    r, x, 0.0, 0.0, &errNum), NULL);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    tr = WlzCMeshTransformFromObj(obj, WLZ_MESH_GENMETHOD_CONFORM,
+    				  2.0, maxDist, NULL, 0, &errNum);
+  }
+  if((errNum == WLZ_ERR_NONE) && (x > DBL_EPSILON))
+  {
+    int		idN,
+    		nNod;
+
+    nNod = (dim == 2)? tr->domain.cm2->res.nod.maxEnt:
+                       tr->domain.cm3->res.nod.maxEnt;
+    for(idN = 0; idN < nNod; ++idN)
+    {
+      double	*d;
+      WlzDVertex3 p;
+
+      if(dim == 2)
+      {
+        WlzCMeshNod2D *nod;
+
+	nod = (WlzCMeshNod2D *)AlcVectorItemGet(tr->domain.cm2->res.nod.vec,
+						idN);
+	p.vtX = nod->pos.vtX;
+	p.vtY = nod->pos.vtY;
+	p.vtZ = 0.0;
+      }
+      else
+      {
+        WlzCMeshNod3D *nod;
+
+	nod = (WlzCMeshNod3D *)AlcVectorItemGet(tr->domain.cm3->res.nod.vec,
+						idN);
+	p = nod->pos;
+      }
+      d = (double *)WlzIndexedValueGet(tr->values.x, idN);
+      d[0] = 0.5 * sin(0.3 * p.vtY);
+      d[1] = 0.05 * p.vtX;
+      if(dim == 3)
+      {
+        d[2] = 0.4 * cos(0.2 * p.vtX);
+      }
+    }
+  }
+  (void )WlzFreeObj(obj);
+  *dstErr = errNum;
+  return(tr);
+}
@@ -0,0 +1,925 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstCMeshLattice_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstCMeshLattice.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for the lattices used to transform vertices with
+* 		conforming mesh transforms. Vertices at the nodes, edge
+* 		midpoints, face centroids and centroids of the elements
+* 		of meshes made by WlzCMeshFromObj2D() and
+* 		WlzCMeshFromObj3D(), together with random vertices in
+* 		and around the meshes, are transformed using a lattice
+* 		and using a general search of the mesh and the results
+* 		are compared. Because the edge midpoints and face
+* 		centroids include all positions on the faces of the
+* 		lattice cells at which the mesh would have hanging nodes
+* 		if it were not conforming, any mismatch of the elements
+* 		on either side of a change in cell size is found. The
+* 		lattice cached with a mesh transform is checked to be
+* 		rebuilt when the displacements are changed and the
+* 		transformation of vertices within the first element
+* 		of a mesh is checked for each of the vertex types.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+static int			WlzTstCMeshLatticeDiff(
+				  WlzObject *tr,
+				  double eps,
+				  int *dstNVtx,
+				  double *dstCov,
+				  WlzErrorNum *dstErr);
+static int			WlzTstCMeshLatticeCache(
+				  WlzObject *tr,
+				  double eps,
+				  WlzErrorNum *dstErr);
+static int			WlzTstCMeshLatticeElm0(
+				  int dim,
+				  double eps,
+				  WlzErrorNum *dstErr);
+static int			WlzTstCMeshLatticeCmp(
+				  int dim,
+				  int nVtx,
+				  WlzDVertex3 *vtx0,
+				  WlzDVertex3 *vtx1,
+				  double eps);
+static int			WlzTstCMeshLatticeVtx(
+				  WlzObject *tr,
+				  WlzDVertex3 **dstVtx,
+				  WlzErrorNum *dstErr);
+static WlzErrorNum		WlzTstCMeshLatticeTrVtx(
+				  WlzObject *tr,
+				  WlzCMeshLattice *lat,
+				  int useCache,
+				  int nVtx,
+				  WlzDVertex3 *vtx);
+static WlzObject		*WlzTstCMeshLatticeMakeTr(
+				  int dim,
+				  int affine,
+				  WlzErrorNum *dstErr);
+static void			WlzTstCMeshLatticeSetDsp(
+				  WlzObject *tr,
+				  int affine,
+				  double off);
+
+int		main(int argc, char *argv[])
+{
+  int		dim,
+  		nVtx,
+  		option,
+		ok = 1,
+		usage = 0,
+		verbose = 0;
+  double	cov;
+  WlzObject	*tr = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  const double	eps = 1.0e-6;
+  static char	optList[] = "hv";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0) && (optind == argc);
+  usage = !ok;
+  if(ok)
+  {
+    AlgRandSeed(0);
+  }
+  for(dim = 2; ok && (errNum == WLZ_ERR_NONE) && (dim <= 3); ++dim)
+  {
+    tr = WlzTstCMeshLatticeMakeTr(dim, 0, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      ok = WlzTstCMeshLatticeDiff(tr, eps, &nVtx, &cov, &errNum);
+      if((errNum == WLZ_ERR_NONE) && (verbose || !ok))
+      {
+	(void )fprintf(stderr, "%s: %dD lattice with coverage %g for %d "
+		       "vertices %s.\n",
+		       *argv, dim, cov, nVtx,
+		       (ok)? "ok": "differs from general mesh search");
+      }
+    }
+    if(ok && (errNum == WLZ_ERR_NONE))
+    {
+      ok = WlzTstCMeshLatticeCache(tr, eps, &errNum);
+      if((errNum == WLZ_ERR_NONE) && (verbose || !ok))
+      {
+	(void )fprintf(stderr, "%s: %dD cached lattice %s.\n",
+		       *argv, dim,
+		       (ok)? "ok": "is not rebuilt for new displacements");
+      }
+    }
+    (void )WlzFreeObj(tr);
+    tr = NULL;
+    if(ok && (errNum == WLZ_ERR_NONE))
+    {
+      ok = WlzTstCMeshLatticeElm0(dim, eps, &errNum);
+      if((errNum == WLZ_ERR_NONE) && (verbose || !ok))
+      {
+	(void )fprintf(stderr, "%s: %dD transform within first element %s.\n",
+		       *argv, dim,
+		       (ok)? "ok": "is wrong");
+      }
+    }
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to test mesh lattices (%s).\n",
+		   *argv, errMsg);
+  }
+  if(ok)
+  {
+    (void )printf("%s: Mesh transforms using lattices match those using "
+    		  "a general mesh search.\n", *argv);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-v]\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -v  Verbose output.\n"
+    "Tests conforming mesh transforms of vertices using lattices against\n"
+    "transforms using a general search of the mesh, that cached lattices\n"
+    "are rebuilt when the displacements are changed and the transform of\n"
+    "vertices within the first mesh element.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	Non-zero if the transformed vertices match.
+* \ingroup	BinWlzTst
+* \brief	Transforms vertices at the nodes, edge midpoints, face
+* 		centroids (3D) and centroids of the mesh elements along
+* 		with random vertices in and around the mesh, using a
+* 		lattice, using the lattice cached with the transform and
+* 		using a general mesh search, then compares the results.
+* 		The lattice must cover most of the mesh for the test to
+* 		be of use, so the test fails if it does not.
+* \param	tr			Conforming mesh transform.
+* \param	eps			Tolerance for the transformed vertices.
+* \param	dstNVtx			Destination pointer for the number of
+* 					vertices.
+* \param	dstCov			Destination pointer for the coverage
+* 					of the lattice.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstCMeshLatticeDiff(WlzObject *tr, double eps,
+				       int *dstNVtx, double *dstCov,
+				       WlzErrorNum *dstErr)
+{
+  int		dim,
+  		nVtx,
+		ok = 0;
+  WlzDVertex3	*vtx0 = NULL,
+  		*vtx1 = NULL,
+		*vtx2 = NULL;
+  WlzCMeshLattice *lat = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  *dstCov = 0.0;
+  dim = (tr->type == WLZ_CMESH_2D)? 2: 3;
+  nVtx = WlzTstCMeshLatticeVtx(tr, &vtx0, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(((vtx1 = (WlzDVertex3 *)
+                AlcMalloc(sizeof(WlzDVertex3) * nVtx)) == NULL) ||
+       ((vtx2 = (WlzDVertex3 *)
+                AlcMalloc(sizeof(WlzDVertex3) * nVtx)) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    lat = WlzCMeshLatticeNew(tr, 0.0, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    *dstCov = lat->coverage;
+    (void )memcpy(vtx1, vtx0, sizeof(WlzDVertex3) * nVtx);
+    (void )memcpy(vtx2, vtx0, sizeof(WlzDVertex3) * nVtx);
+    errNum = WlzTstCMeshLatticeTrVtx(tr, NULL, 0, nVtx, vtx1);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = WlzTstCMeshLatticeTrVtx(tr, lat, 0, nVtx, vtx2);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    ok = (lat->coverage > 0.5) &&
+         WlzTstCMeshLatticeCmp(dim, nVtx, vtx1, vtx2, eps);
+  }
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    (void )memcpy(vtx2, vtx0, sizeof(WlzDVertex3) * nVtx);
+    errNum = WlzTstCMeshLatticeTrVtx(tr, NULL, 1, nVtx, vtx2);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      ok = WlzTstCMeshLatticeCmp(dim, nVtx, vtx1, vtx2, eps);
+    }
+  }
+  (void )WlzCMeshLatticeFree(lat);
+  AlcFree(vtx0);
+  AlcFree(vtx1);
+  AlcFree(vtx2);
+  *dstNVtx = nVtx;
+  *dstErr = errNum;
+  return(ok);
+}
+
+/*!
+* \return	Non-zero if the cached lattice is correct.
+* \ingroup	BinWlzTst
+* \brief	Checks that the lattice cached with the transform is
+* 		built for a large number of vertices, that it is then
+* 		reused and that after the displacements have been
+* 		changed the transformed vertices match those found
+* 		using a general mesh search.
+* \param	tr			Conforming mesh transform.
+* \param	eps			Tolerance for the transformed vertices.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstCMeshLatticeCache(WlzObject *tr, double eps,
+				        WlzErrorNum *dstErr)
+{
+  int		dim,
+  		nVtx,
+		ok = 0;
+  WlzDVertex3	*vtx0 = NULL,
+  		*vtx1 = NULL,
+		*vtx2 = NULL;
+  WlzCMeshLattice *lat0 = NULL,
+  		*lat1 = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  dim = (tr->type == WLZ_CMESH_2D)? 2: 3;
+  nVtx = WlzTstCMeshLatticeVtx(tr, &vtx0, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(((vtx1 = (WlzDVertex3 *)
+                AlcMalloc(sizeof(WlzDVertex3) * nVtx)) == NULL) ||
+       ((vtx2 = (WlzDVertex3 *)
+                AlcMalloc(sizeof(WlzDVertex3) * nVtx)) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    lat0 = WlzCMeshLatticeCached(tr, nVtx, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    lat1 = WlzCMeshLatticeCached(tr, nVtx, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    ok = (lat0 != NULL) && (lat0 == lat1);
+  }
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    WlzTstCMeshLatticeSetDsp(tr, 0, 1.5);
+    (void )memcpy(vtx1, vtx0, sizeof(WlzDVertex3) * nVtx);
+    (void )memcpy(vtx2, vtx0, sizeof(WlzDVertex3) * nVtx);
+    errNum = WlzTstCMeshLatticeTrVtx(tr, NULL, 0, nVtx, vtx1);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = WlzTstCMeshLatticeTrVtx(tr, NULL, 1, nVtx, vtx2);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      ok = WlzTstCMeshLatticeCmp(dim, nVtx, vtx1, vtx2, eps);
+    }
+  }
+  AlcFree(vtx0);
+  AlcFree(vtx1);
+  AlcFree(vtx2);
+  *dstErr = errNum;
+  return(ok);
+}
+
+/*!
+* \return	Non-zero if the transformed vertices are correct.
+* \ingroup	BinWlzTst
+* \brief	Transforms a single vertex within the first element
+* 		of a mesh transform which has affine displacements,
+* 		using the integer, float and double vertex array
+* 		transform functions, and compares the results with
+* 		the affine transform.
+* \param	dim			Dimension, 2 or 3.
+* \param	eps			Tolerance for the transformed vertices.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstCMeshLatticeElm0(int dim, double eps,
+				       WlzErrorNum *dstErr)
+{
+  int		idN,
+		ok = 0;
+  WlzIVertex3	iPos;
+  WlzDVertex3	pos,
+  		dPos,
+		iDPos;
+  WlzObject	*tr;
+  WlzDVertex3	nPos[4];
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  tr = WlzTstCMeshLatticeMakeTr(dim, 1, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    /* Find the node positions and centroid of the first element. */
+    if(dim == 2)
+    {
+      WlzCMeshElm2D *elm;
+
+      elm = (WlzCMeshElm2D *)AlcVectorItemGet(tr->domain.cm2->res.elm.vec, 0);
+      for(idN = 0; idN < 3; ++idN)
+      {
+	nPos[idN].vtX = elm->edu[idN].nod->pos.vtX;
+	nPos[idN].vtY = elm->edu[idN].nod->pos.vtY;
+	nPos[idN].vtZ = 0.0;
+      }
+      pos.vtX = (nPos[0].vtX + nPos[1].vtX + nPos[2].vtX) / 3.0;
+      pos.vtY = (nPos[0].vtY + nPos[1].vtY + nPos[2].vtY) / 3.0;
+      pos.vtZ = 0.0;
+      ok = WlzCMeshElmEnclosingPos2D(tr->domain.cm2, -1,
+      				     pos.vtX, pos.vtY, 0, NULL) == 0;
+    }
+    else
+    {
+      WlzCMeshElm3D *elm;
+
+      elm = (WlzCMeshElm3D *)AlcVectorItemGet(tr->domain.cm3->res.elm.vec, 0);
+      nPos[0] = WLZ_CMESH_ELM3D_GET_NODE_0(elm)->pos;
+      nPos[1] = WLZ_CMESH_ELM3D_GET_NODE_1(elm)->pos;
+      nPos[2] = WLZ_CMESH_ELM3D_GET_NODE_2(elm)->pos;
+      nPos[3] = WLZ_CMESH_ELM3D_GET_NODE_3(elm)->pos;
+      WLZ_VTX_3_ZERO(pos);
+      for(idN = 0; idN < 4; ++idN)
+      {
+        WLZ_VTX_3_ADD(pos, pos, nPos[idN]);
+      }
+      WLZ_VTX_3_SCALE(pos, pos, 0.25);
+      ok = WlzCMeshElmEnclosingPos3D(tr->domain.cm3, -1,
+      				     pos.vtX, pos.vtY, pos.vtZ, 0, NULL) == 0;
+    }
+    /* Find an integer vertex which a mesh search finds to be within the
+     * first element, without which the integer vertex transforms can't
+     * be tested. */
+    if(ok)
+    {
+      int	found = 0;
+      WlzIBox3	box;
+      WlzIVertex3 p;
+
+      box.xMin = box.xMax = WLZ_NINT(nPos[0].vtX);
+      box.yMin = box.yMax = WLZ_NINT(nPos[0].vtY);
+      box.zMin = box.zMax = WLZ_NINT(nPos[0].vtZ);
+      for(idN = 1; idN <= dim; ++idN)
+      {
+	box.xMin = WLZ_MIN(box.xMin, WLZ_NINT(nPos[idN].vtX));
+	box.xMax = WLZ_MAX(box.xMax, WLZ_NINT(nPos[idN].vtX));
+	box.yMin = WLZ_MIN(box.yMin, WLZ_NINT(nPos[idN].vtY));
+	box.yMax = WLZ_MAX(box.yMax, WLZ_NINT(nPos[idN].vtY));
+	box.zMin = WLZ_MIN(box.zMin, WLZ_NINT(nPos[idN].vtZ));
+	box.zMax = WLZ_MAX(box.zMax, WLZ_NINT(nPos[idN].vtZ));
+      }
+      for(p.vtZ = box.zMin; !found && (p.vtZ <= box.zMax); ++p.vtZ)
+      {
+	for(p.vtY = box.yMin; !found && (p.vtY <= box.yMax); ++p.vtY)
+	{
+	  for(p.vtX = box.xMin; !found && (p.vtX <= box.xMax); ++p.vtX)
+	  {
+	    found = ((dim == 2)?
+		     WlzCMeshElmEnclosingPos2D(tr->domain.cm2, -1,
+					       p.vtX, p.vtY, 0, NULL):
+		     WlzCMeshElmEnclosingPos3D(tr->domain.cm3, -1,
+					       p.vtX, p.vtY, p.vtZ,
+					       0, NULL)) == 0;
+	    if(found)
+	    {
+	      iPos = p;
+	    }
+	  }
+	}
+      }
+      ok = found;
+    }
+  }
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    WlzDVertex3	tPos;
+    WlzDVertex3	tVtx[3];
+
+    /* The affine transform of the displacements is that of
+     * WlzTstCMeshLatticeSetDsp(). */
+    dPos.vtX = pos.vtX + (0.1 * pos.vtX) + (0.2 * pos.vtY) + 1.3;
+    dPos.vtY = pos.vtY - (0.3 * pos.vtX) + (0.1 * pos.vtZ) - 0.7;
+    dPos.vtZ = pos.vtZ + (0.2 * pos.vtY) - (0.1 * pos.vtZ) + 0.4;
+    WLZ_VTX_3_SET(tPos, iPos.vtX, iPos.vtY, iPos.vtZ);
+    iDPos.vtX = tPos.vtX + (0.1 * tPos.vtX) + (0.2 * tPos.vtY) + 1.3;
+    iDPos.vtY = tPos.vtY - (0.3 * tPos.vtX) + (0.1 * tPos.vtZ) - 0.7;
+    iDPos.vtZ = tPos.vtZ + (0.2 * tPos.vtY) - (0.1 * tPos.vtZ) + 0.4;
+    if(dim == 2)
+    {
+      WlzIVertex2 iV;
+      WlzFVertex2 fV;
+      WlzDVertex2 dV;
+
+      iV.vtX = iPos.vtX;
+      iV.vtY = iPos.vtY;
+      fV.vtX = pos.vtX;
+      fV.vtY = pos.vtY;
+      dV.vtX = pos.vtX;
+      dV.vtY = pos.vtY;
+      errNum = WlzCMeshTransformVtxAry2I(tr, 1, &iV);
+      if(errNum == WLZ_ERR_NONE)
+      {
+        errNum = WlzCMeshTransformVtxAry2F(tr, 1, &fV);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+        errNum = WlzCMeshTransformVtxAry2D(tr, 1, &dV);
+      }
+      tVtx[0].vtX = iV.vtX; tVtx[0].vtY = iV.vtY; tVtx[0].vtZ = 0.0;
+      tVtx[1].vtX = fV.vtX; tVtx[1].vtY = fV.vtY; tVtx[1].vtZ = 0.0;
+      tVtx[2].vtX = dV.vtX; tVtx[2].vtY = dV.vtY; tVtx[2].vtZ = 0.0;
+      iDPos.vtZ = dPos.vtZ = 0.0;
+    }
+    else
+    {
+      WlzIVertex3 iV;
+      WlzFVertex3 fV;
+      WlzDVertex3 dV;
+
+      iV = iPos;
+      WLZ_VTX_3_SET(fV, pos.vtX, pos.vtY, pos.vtZ);
+      dV = pos;
+      errNum = WlzCMeshTransformVtxAry3I(tr, 1, &iV);
+      if(errNum == WLZ_ERR_NONE)
+      {
+        errNum = WlzCMeshTransformVtxAry3F(tr, 1, &fV);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+        errNum = WlzCMeshTransformVtxAry3D(tr, 1, &dV);
+      }
+      WLZ_VTX_3_SET(tVtx[0], iV.vtX, iV.vtY, iV.vtZ);
+      WLZ_VTX_3_SET(tVtx[1], fV.vtX, fV.vtY, fV.vtZ);
+      tVtx[2] = dV;
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      iDPos.vtX = WLZ_NINT(iDPos.vtX);
+      iDPos.vtY = WLZ_NINT(iDPos.vtY);
+      iDPos.vtZ = WLZ_NINT(iDPos.vtZ);
+      ok = WlzTstCMeshLatticeCmp(dim, 1, &iDPos, tVtx + 0, eps) &&
+	   WlzTstCMeshLatticeCmp(dim, 1, &dPos, tVtx + 1, 1.0e-3) &&
+	   WlzTstCMeshLatticeCmp(dim, 1, &dPos, tVtx + 2, eps);
+    }
+  }
+  (void )WlzFreeObj(tr);
+  *dstErr = errNum;
+  return(ok);
+}
+
+/*!
+* \return	Non-zero if the vertices match.
+* \ingroup	BinWlzTst
+* \brief	Compares two arrays of vertices.
+* \param	dim			Dimension, 2 or 3.
+* \param	nVtx			Number of vertices.
+* \param	vtx0			First array of vertices.
+* \param	vtx1			Second array of vertices.
+* \param	eps			Tolerance for the vertex components.
+*/
+static int	WlzTstCMeshLatticeCmp(int dim, int nVtx, WlzDVertex3 *vtx0,
+				      WlzDVertex3 *vtx1, double eps)
+{
+  int		idV;
+
+  for(idV = 0; idV < nVtx; ++idV)
+  {
+    if((fabs(vtx0[idV].vtX - vtx1[idV].vtX) > eps) ||
+       (fabs(vtx0[idV].vtY - vtx1[idV].vtY) > eps) ||
+       ((dim == 3) && (fabs(vtx0[idV].vtZ - vtx1[idV].vtZ) > eps)))
+    {
+      break;
+    }
+  }
+  return(idV == nVtx);
+}
+
+/*!
+* \return	Number of vertices.
+* \ingroup	BinWlzTst
+* \brief	Makes an array of vertices at the nodes, edge midpoints,
+* 		face centroids (3D) and centroids of the mesh elements
+* 		together with random vertices within the bounding box of
+* 		the mesh, which is expanded so that some are outside of
+* 		it.
+* \param	tr			Conforming mesh transform.
+* \param	dstVtx			Destination pointer for the vertices.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstCMeshLatticeVtx(WlzObject *tr, WlzDVertex3 **dstVtx,
+				      WlzErrorNum *dstErr)
+{
+  int		idE,
+  		idN,
+		idR,
+		nNod,
+		nElm,
+		nPE,
+		nVtx = 0;
+  WlzDBox3	bBox;
+  WlzDVertex3	*vtx = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const int	nRnd = 1000;
+
+  if(tr->type == WLZ_CMESH_2D)
+  {
+    WlzCMesh2D	*mesh;
+
+    mesh = tr->domain.cm2;
+    nNod = mesh->res.nod.maxEnt;
+    nElm = mesh->res.elm.maxEnt;
+    nPE = 4;
+    bBox.xMin = mesh->bBox.xMin; bBox.xMax = mesh->bBox.xMax;
+    bBox.yMin = mesh->bBox.yMin; bBox.yMax = mesh->bBox.yMax;
+    bBox.zMin = bBox.zMax = 0.0;
+  }
+  else
+  {
+    WlzCMesh3D	*mesh;
+
+    mesh = tr->domain.cm3;
+    nNod = mesh->res.nod.maxEnt;
+    nElm = mesh->res.elm.maxEnt;
+    nPE = 11;
+    bBox = mesh->bBox;
+  }
+  if((vtx = (WlzDVertex3 *)AlcMalloc(sizeof(WlzDVertex3) *
+                                     (nNod + (nPE * nElm) + nRnd))) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else if(tr->type == WLZ_CMESH_2D)
+  {
+    WlzCMesh2D	*mesh;
+
+    mesh = tr->domain.cm2;
+    for(idN = 0; idN < nNod; ++idN)
+    {
+      WlzCMeshNod2D *nod;
+
+      nod = (WlzCMeshNod2D *)AlcVectorItemGet(mesh->res.nod.vec, idN);
+      if(nod->idx >= 0)
+      {
+	vtx[nVtx].vtX = nod->pos.vtX;
+	vtx[nVtx].vtY = nod->pos.vtY;
+	vtx[nVtx++].vtZ = 0.0;
+      }
+    }
+    for(idE = 0; idE < nElm; ++idE)
+    {
+      WlzCMeshElm2D *elm;
+
+      elm = (WlzCMeshElm2D *)AlcVectorItemGet(mesh->res.elm.vec, idE);
+      if(elm->idx >= 0)
+      {
+	WlzDVertex2 c;
+
+	WLZ_VTX_2_ZERO(c);
+	for(idN = 0; idN < 3; ++idN)
+	{
+	  WlzDVertex2 p0,
+		      p1;
+
+	  p0 = elm->edu[idN].nod->pos;
+	  p1 = elm->edu[(idN + 1) % 3].nod->pos;
+	  WLZ_VTX_2_ADD(c, c, p0);
+	  vtx[nVtx].vtX = 0.5 * (p0.vtX + p1.vtX);
+	  vtx[nVtx].vtY = 0.5 * (p0.vtY + p1.vtY);
+	  vtx[nVtx++].vtZ = 0.0;
+	}
+	vtx[nVtx].vtX = c.vtX / 3.0;
+	vtx[nVtx].vtY = c.vtY / 3.0;
+	vtx[nVtx++].vtZ = 0.0;
+      }
+    }
+  }
+  else
+  {
+    WlzCMesh3D	*mesh;
+
+    mesh = tr->domain.cm3;
+    for(idN = 0; idN < nNod; ++idN)
+    {
+      WlzCMeshNod3D *nod;
+
+      nod = (WlzCMeshNod3D *)AlcVectorItemGet(mesh->res.nod.vec, idN);
+      if(nod->idx >= 0)
+      {
+	vtx[nVtx++] = nod->pos;
+      }
+    }
+    for(idE = 0; idE < nElm; ++idE)
+    {
+      WlzCMeshElm3D *elm;
+
+      elm = (WlzCMeshElm3D *)AlcVectorItemGet(mesh->res.elm.vec, idE);
+      if(elm->idx >= 0)
+      {
+	int	    idM;
+	WlzDVertex3 c;
+	WlzDVertex3 p[4];
+
+	p[0] = WLZ_CMESH_ELM3D_GET_NODE_0(elm)->pos;
+	p[1] = WLZ_CMESH_ELM3D_GET_NODE_1(elm)->pos;
+	p[2] = WLZ_CMESH_ELM3D_GET_NODE_2(elm)->pos;
+	p[3] = WLZ_CMESH_ELM3D_GET_NODE_3(elm)->pos;
+	WLZ_VTX_3_ZERO(c);
+	for(idN = 0; idN < 4; ++idN)
+	{
+	  WLZ_VTX_3_ADD(c, c, p[idN]);
+	  for(idM = idN + 1; idM < 4; ++idM)
+	  {
+	    WLZ_VTX_3_ADD(vtx[nVtx], p[idN], p[idM]);
+	    WLZ_VTX_3_SCALE(vtx[nVtx], vtx[nVtx], 0.5);
+	    ++nVtx;
+	  }
+	}
+	/* Centroids of the faces opposite each node. */
+	for(idN = 0; idN < 4; ++idN)
+	{
+	  WLZ_VTX_3_SUB(vtx[nVtx], c, p[idN]);
+	  WLZ_VTX_3_SCALE(vtx[nVtx], vtx[nVtx], 1.0 / 3.0);
+	  ++nVtx;
+	}
+	WLZ_VTX_3_SCALE(vtx[nVtx], c, 0.25);
+	++nVtx;
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    for(idR = 0; idR < nRnd; ++idR)
+    {
+      vtx[nVtx].vtX = bBox.xMin - 2.0 +
+                      ((bBox.xMax - bBox.xMin + 4.0) * AlgRandUniform());
+      vtx[nVtx].vtY = bBox.yMin - 2.0 +
+                      ((bBox.yMax - bBox.yMin + 4.0) * AlgRandUniform());
+      vtx[nVtx].vtZ = (tr->type == WLZ_CMESH_2D)? 0.0:
+                      bBox.zMin - 2.0 +
+                      ((bBox.zMax - bBox.zMin + 4.0) * AlgRandUniform());
+      ++nVtx;
+    }
+  }
+  *dstVtx = vtx;
+  *dstErr = errNum;
+  return(nVtx);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	BinWlzTst
+* \brief	Transforms an array of vertices in place, either using
+* 		the given lattice, which may be NULL for a general mesh
+* 		search, or using the lattice cached with the transform.
+* \param	tr			Conforming mesh transform.
+* \param	lat			Given lattice, may be NULL.
+* \param	useCache		Use the cached lattice if non-zero,
+* 					in which case the given lattice is
+* 					ignored.
+* \param	nVtx			Number of vertices.
+* \param	vtx			Vertices to transform.
+*/
+static WlzErrorNum WlzTstCMeshLatticeTrVtx(WlzObject *tr,
+					   WlzCMeshLattice *lat,
+					   int useCache,
+					   int nVtx, WlzDVertex3 *vtx)
+{
+  int		idV;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(tr->type == WLZ_CMESH_2D)
+  {
+    WlzDVertex2	*vtx2;
+
+    if((vtx2 = (WlzDVertex2 *)
+               AlcMalloc(sizeof(WlzDVertex2) * nVtx)) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      for(idV = 0; idV < nVtx; ++idV)
+      {
+	vtx2[idV].vtX = vtx[idV].vtX;
+	vtx2[idV].vtY = vtx[idV].vtY;
+      }
+      errNum = (useCache)?
+	       WlzCMeshTransformVtxAry2D(tr, nVtx, vtx2):
+	       WlzCMeshTransformVtxAryLat2D(tr, lat, nVtx, vtx2);
+      for(idV = 0; idV < nVtx; ++idV)
+      {
+	vtx[idV].vtX = vtx2[idV].vtX;
+	vtx[idV].vtY = vtx2[idV].vtY;
+      }
+      AlcFree(vtx2);
+    }
+  }
+  else
+  {
+    errNum = (useCache)?
+	     WlzCMeshTransformVtxAry3D(tr, nVtx, vtx):
+	     WlzCMeshTransformVtxAryLat3D(tr, lat, nVtx, vtx);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	New conforming mesh transform.
+* \ingroup	BinWlzTst
+* \brief	Makes a conforming mesh transform from a sphere unioned
+* 		with a cuboid, so that the mesh has elements of several
+* 		sizes, and sets its displacements.
+* \param	dim			Dimension, 2 or 3.
+* \param	affine			Use affine displacements and larger
+* 					elements if non-zero.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstCMeshLatticeMakeTr(int dim, int affine,
+					   WlzErrorNum *dstErr)
+{
+  WlzObject	*obj = NULL,
+  		*obj0 = NULL,
+		*obj1 = NULL,
+  		*tr = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(dim == 2)
+  {
+    obj0 = WlzAssignObject(
+	   WlzMakeSphereObject(WLZ_2D_DOMAINOBJ, 20.0, 0.3, 0.0, 0.0,
+	   		       &errNum), NULL);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      obj1 = WlzAssignObject(
+	     WlzMakeRectangleObject(6.0, 10.0, 20.0, 10.0, &errNum), NULL);
+    }
+  }
+  else
+  {
+    obj0 = WlzAssignObject(
+	   WlzMakeSphereObject(WLZ_3D_DOMAINOBJ, 8.0, 0.3, 0.0, 0.0,
+	   		       &errNum), NULL);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      obj1 = WlzAssignObject(
+	     WlzMakeCuboidObject(WLZ_3D_DOMAINOBJ, 3.0, 5.0, 3.0,
+	     			 8.0, 4.0, 0.0, &errNum), NULL);
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    obj = WlzAssignObject(WlzUnion2(obj0, obj1, &errNum), NULL);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    tr = WlzCMeshTransformFromObj(obj, WLZ_MESH_GENMETHOD_CONFORM,
+    				  (affine)? 4.0: 1.0, (dim == 2)? 8.0: 6.0,
+				  NULL, 0, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    WlzTstCMeshLatticeSetDsp(tr, affine, 0.0);
+  }
+  (void )WlzFreeObj(obj0);
+  (void )WlzFreeObj(obj1);
+  (void )WlzFreeObj(obj);
+  *dstErr = errNum;
+  return(tr);
+}
+
+/*!
+* \ingroup	BinWlzTst
+* \brief	Sets the displacements of a conforming mesh transform.
+* \param	tr			Conforming mesh transform.
+* \param	affine			Use affine displacements if non-zero.
+* \param	off			Offset added to the displacements
+* 					when they are not affine.
+*/
+static void	WlzTstCMeshLatticeSetDsp(WlzObject *tr, int affine,
+					 double off)
+{
+  int		idN,
+  		dim,
+		nNod;
+
+  dim = (tr->type == WLZ_CMESH_2D)? 2: 3;
+  nNod = (dim == 2)? tr->domain.cm2->res.nod.maxEnt:
+                     tr->domain.cm3->res.nod.maxEnt;
+  for(idN = 0; idN < nNod; ++idN)
+  {
+    double	*d;
+    WlzDVertex3 p;
+
+    if(dim == 2)
+    {
+      WlzCMeshNod2D *nod;
+
+      nod = (WlzCMeshNod2D *)AlcVectorItemGet(tr->domain.cm2->res.nod.vec,
+                                              idN);
+      p.vtX = nod->pos.vtX;
+      p.vtY = nod->pos.vtY;
+      p.vtZ = 0.0;
+    }
+    else
+    {
+      WlzCMeshNod3D *nod;
+
+      nod = (WlzCMeshNod3D *)AlcVectorItemGet(tr->domain.cm3->res.nod.vec,
+                                              idN);
+      p = nod->pos;
+    }
+    d = (double *)WlzIndexedValueGet(tr->values.x, idN);
+    if(affine)
+    {
+      d[0] = (0.1 * p.vtX) + (0.2 * p.vtY) + 1.3;
+      d[1] = -(0.3 * p.vtX) + (0.1 * p.vtZ) - 0.7;
+    }
+    else
+    {
+      d[0] = (0.5 * sin(0.3 * p.vtY)) + (0.02 * p.vtX * p.vtY) + off;
+      d[1] = (0.005 * p.vtX * p.vtX) - off;
+    }
+    if(dim == 3)
+    {
+      d[2] = (affine)? (0.2 * p.vtY) - (0.1 * p.vtZ) + 0.4:
+                       0.3 * cos(0.02 * p.vtX * p.vtY) + p.vtZ * off;
+    }
+  }
+}
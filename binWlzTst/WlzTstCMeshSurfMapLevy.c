@@ -0,0 +1,494 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstCMeshSurfMapLevy_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstCMeshSurfMapLevy.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for WlzCMeshCompSurfMap(), which computes a least
+* 		squares conformal map using WlzCMeshCompSurfMapLevy().
+* 		A curved surface mesh with elements of varying size is
+* 		mapped to a plane and the
+* 		node displacements are compared with those found by
+* 		solving the same least squares conformal map system
+* 		assembled as a linked list row matrix, which is solved
+* 		by the original damped LSQR solver.
+* \ingroup	BinWlzTst
+*/
+#include <stdio.h>
+#include <string.h>
+#include <float.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char     *optarg;
+extern int      optind,
+		opterr,
+		optopt;
+
+static WlzCMesh2D5		*WlzTstCMeshSurfMapLevyMesh(
+				  int nX,
+				  int nY,
+				  WlzErrorNum *dstErr);
+static WlzErrorNum		WlzTstCMeshSurfMapLevyRef(
+				  WlzCMesh2D5 *mesh,
+				  int nP,
+				  WlzDVertex3 *dPV,
+				  int *pIdx,
+				  double *dsp);
+
+int		main(int argc, char *argv[])
+{
+  int		idN,
+  		nN = 0,
+		option,
+		ok = 1,
+		usage = 0,
+		verbose = 0,
+		nX = 24,
+		nY = 16;
+  int		pIdx[2];
+  double	d,
+  		maxD = 0.0;
+  double	*dsp = NULL;
+  WlzDVertex3	dPV[2],
+  		sPV[2];
+  WlzCMesh2D5	*mesh = NULL;
+  WlzObject	*mObj = NULL,
+  		*mapObj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  const double	eps = 1.0e-6;
+  static char	optList[] = "hvx:y:";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'v':
+        verbose = 1;
+	break;
+      case 'x':
+        if((sscanf(optarg, "%d", &nX) != 1) || (nX < 1))
+	{
+	  usage = 1;
+	}
+	break;
+      case 'y':
+        if((sscanf(optarg, "%d", &nY) != 1) || (nY < 1))
+	{
+	  usage = 1;
+	}
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0) && (optind == argc);
+  usage = !ok;
+  if(ok)
+  {
+    mesh = WlzTstCMeshSurfMapLevyMesh(nX, nY, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      WlzDomain	dom;
+      WlzValues	val;
+
+      dom.cm2d5 = mesh;
+      val.core = NULL;
+      mObj = WlzAssignObject(
+             WlzMakeMain(WLZ_CMESH_2D5, dom, val, NULL, NULL, &errNum),
+	     NULL);
+      if(errNum != WLZ_ERR_NONE)
+      {
+        (void )WlzCMeshFree2D5(mesh);
+      }
+    }
+  }
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    WlzCMeshNod2D5 *nod;
+
+    /* Pin the nodes closest to the first and last nodes of the middle
+     * row of the grid, as WlzCMeshCompSurfMap() does, so that the same
+     * nodes are pinned for the reference. */
+    nN = mesh->res.nod.numEnt;
+    for(idN = 0; idN < 2; ++idN)
+    {
+      nod = (WlzCMeshNod2D5 *)AlcVectorItemGet(mesh->res.nod.vec,
+      				((nY / 2) * (nX + 1)) + ((idN)? nX: 0));
+      sPV[idN] = nod->pos;
+      pIdx[idN] = WlzCMeshClosestNod2D5(mesh, sPV[idN]);
+      dPV[idN].vtX = (idN)? 2.0 * nX: 0.0;
+      dPV[idN].vtY = 0.0;
+      dPV[idN].vtZ = 0.0;
+    }
+    if((pIdx[0] < 0) || (pIdx[0] >= pIdx[1]))
+    {
+      ok = 0;
+      (void )fprintf(stderr, "%s: Failed to find distinct pinned nodes.\n",
+      		     *argv);
+    }
+    else if((dsp = (double *)AlcMalloc(sizeof(double) * 3 * nN)) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      errNum = WlzTstCMeshSurfMapLevyRef(mesh, 2, dPV, pIdx, dsp);
+    }
+  }
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    mapObj = WlzAssignObject(
+    	     WlzCMeshCompSurfMap(mObj, 2, dPV, 2, sPV, &errNum), NULL);
+  }
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    for(idN = 0; idN < nN; ++idN)
+    {
+      int	idC;
+      double	*mDsp;
+
+      mDsp = (double *)WlzIndexedValueGet(mapObj->values.x, idN);
+      for(idC = 0; idC < 3; ++idC)
+      {
+        d = fabs(mDsp[idC] - dsp[(3 * idN) + idC]);
+	maxD = WLZ_MAX(maxD, d);
+      }
+    }
+    if(verbose)
+    {
+      (void )fprintf(stderr, "%s: %d nodes, %d elements, maximum "
+      		     "difference %g\n",
+		     *argv, nN, mesh->res.elm.numEnt, maxD);
+    }
+    if(maxD > eps)
+    {
+      ok = 0;
+      (void )fprintf(stderr,
+      		     "%s: Surface map differs from that of the original "
+		     "solver by %g.\n",
+		     *argv, maxD);
+    }
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to compute surface maps (%s).\n",
+		   *argv, errMsg);
+  }
+  AlcFree(dsp);
+  (void )WlzFreeObj(mapObj);
+  (void )WlzFreeObj(mObj);
+  if(ok)
+  {
+    (void )printf("%s: Surface map matches that of the original solver "
+    		  "(maximum difference %g).\n",
+		  *argv, maxD);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-v] [-x #] [-y #]\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -v  Verbose output.\n"
+    "  -x  Number of grid cells along the surface (default 24).\n"
+    "  -y  Number of grid cells across the surface (default 16).\n"
+    "Tests WlzCMeshCompSurfMap() by mapping a curved surface mesh,\n"
+    "with elements of varying size, to a plane and comparing the node\n"
+    "displacements with those found by solving the same system as a\n"
+    "linked list row matrix using the original damped LSQR solver.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New mesh or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Makes a 2D5 mesh on a curved surface from a grid of
+* 		nodes with non-uniform spacing, each grid cell being
+* 		split into two triangular elements. Node indices are
+* 		(nX + 1) * j + i for the i'th node of the j'th row.
+* \param	nX			Number of grid cells in x.
+* \param	nY			Number of grid cells in y.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzCMesh2D5 *WlzTstCMeshSurfMapLevyMesh(int nX, int nY,
+					       WlzErrorNum *dstErr)
+{
+  int		idX,
+  		idY,
+		nNod,
+		nElm;
+  WlzCMesh2D5	*mesh = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  nNod = (nX + 1) * (nY + 1);
+  nElm = 2 * nX * nY;
+  mesh = WlzCMeshNew2D5(&errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((AlcVectorExtendAndGet(mesh->res.nod.vec, nNod) == NULL) ||
+       (AlcVectorExtendAndGet(mesh->res.elm.vec, nElm) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    for(idY = 0; idY <= nY; ++idY)
+    {
+      for(idX = 0; idX <= nX; ++idX)
+      {
+	double	x,
+		y;
+        WlzCMeshNod2D5 *nod;
+
+	/* Spacing increasing along x and varying across y. */
+	x = idX + (0.05 * idX * idX);
+	y = idY + (0.3 * sin(idY));
+	nod = WlzCMeshAllocNod2D5(mesh);
+	nod->pos.vtX = x;
+	nod->pos.vtY = y;
+	nod->pos.vtZ = (0.02 * (x - nX) * (x - nX)) + (0.05 * y * y);
+      }
+    }
+    WlzCMeshUpdateBBox2D5(mesh);
+    errNum = WlzCMeshReassignGridCells2D5(mesh, nNod);
+  }
+  for(idY = 0; (errNum == WLZ_ERR_NONE) && (idY < nY); ++idY)
+  {
+    for(idX = 0; (errNum == WLZ_ERR_NONE) && (idX < nX); ++idX)
+    {
+      int	idN;
+      WlzCMeshNod2D5 *nod[4];
+
+      for(idN = 0; idN < 4; ++idN)
+      {
+        nod[idN] = (WlzCMeshNod2D5 *)
+		   AlcVectorItemGet(mesh->res.nod.vec,
+		                    ((idY + (idN / 2)) * (nX + 1)) +
+				    idX + (idN % 2));
+      }
+      (void )WlzCMeshNewElm2D5(mesh, nod[0], nod[1], nod[3], 1, &errNum);
+      if(errNum == WLZ_ERR_NONE)
+      {
+	(void )WlzCMeshNewElm2D5(mesh, nod[0], nod[3], nod[2], 1, &errNum);
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    WlzCMeshUpdateMaxSqEdgLen2D5(mesh);
+  }
+  else if(mesh)
+  {
+    (void )WlzCMeshFree2D5(mesh);
+    mesh = NULL;
+  }
+  *dstErr = errNum;
+  return(mesh);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	BinWlzTst
+* \brief	Computes the least squares conformal map of the given
+* 		mesh as WlzCMeshCompSurfMapLevy() did before compressed
+* 		sparse row matrices were used, ie with the system
+* 		assembled as linked list row matrices and solved by
+* 		unpreconditioned damped LSQR. The mesh must not have
+* 		deleted nodes or elements.
+* \param	mesh			Given mesh.
+* \param	nP			Number of pinned nodes.
+* \param	dPV			Destination coordinates of the pinned
+* 					nodes.
+* \param	pIdx			Indices of the pinned nodes, which
+* 					must increase.
+* \param	dsp			Destination for the three displacement
+* 					components of each node.
+*/
+static WlzErrorNum WlzTstCMeshSurfMapLevyRef(WlzCMesh2D5 *mesh, int nP,
+					     WlzDVertex3 *dPV, int *pIdx,
+					     double *dsp)
+{
+  int		idE,
+		idN,
+		nE,
+		nN;
+  int		*pTb = NULL;
+  double	*bV = NULL,
+  		*bUV = NULL,
+		*xV = NULL;
+  AlgMatrix	aM,
+  		bPM;
+  AlgError	algErr = ALG_ERR_NONE;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const double	tol = 0.000001;
+
+  aM.core = NULL;
+  bPM.core = NULL;
+  nE = mesh->res.elm.numEnt;
+  nN = mesh->res.nod.numEnt;
+  if(((pTb = (int *)AlcMalloc(sizeof(int) * nN)) == NULL) ||
+     ((bUV = (double *)AlcMalloc(sizeof(double) * 2 * nP)) == NULL) ||
+     ((bV = (double *)AlcMalloc(sizeof(double) * 2 * nE)) == NULL) ||
+     ((xV = (double *)AlcCalloc(2 * nN, sizeof(double))) == NULL))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    aM = AlgMatrixNew(ALG_MATRIX_LLR, 2 * nE, 2 * nN, 6 * nE, tol, &algErr);
+    if(algErr == ALG_ERR_NONE)
+    {
+      bPM = AlgMatrixNew(ALG_MATRIX_LLR, 2 * nE, 2 * nP, 6 * nE, tol,
+                         &algErr);
+    }
+    errNum = WlzErrorFromAlg(algErr);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    /* Look up table from node index to pinned node or -1. */
+    for(idN = 0; idN < nN; ++idN)
+    {
+      pTb[idN] = -1;
+    }
+    for(idN = 0; idN < nP; ++idN)
+    {
+      pTb[pIdx[idN]] = idN;
+      bUV[idN] = dPV[idN].vtX;
+      bUV[idN + nP] = dPV[idN].vtY;
+    }
+    for(idE = 0; idE < nE; ++idE)
+    {
+      double	d,
+		l0,
+		a2;
+      double	wR[3],
+		wI[3];
+      WlzDVertex2 q2;
+      WlzDVertex3 u[3],
+		  v[3],
+		  p[3];
+      WlzCMeshNod2D5 *nod[3];
+      WlzCMeshElm2D5 *elm;
+
+      elm = (WlzCMeshElm2D5 *)AlcVectorItemGet(mesh->res.elm.vec, idE);
+      nod[0] = WLZ_CMESH_ELM2D5_GET_NODE_0(elm); p[0] = nod[0]->pos;
+      nod[1] = WLZ_CMESH_ELM2D5_GET_NODE_1(elm); p[1] = nod[1]->pos;
+      nod[2] = WLZ_CMESH_ELM2D5_GET_NODE_2(elm); p[2] = nod[2]->pos;
+      /* Complex weights of the nodes in the element's own basis. */
+      WLZ_VTX_3_SUB(v[0], p[1], p[0]);
+      WLZ_VTX_3_SUB(v[1], p[2], p[0]);
+      WLZ_VTX_3_CROSS(v[2], v[0], v[1]);
+      a2 = WLZ_VTX_3_LENGTH(v[2]);
+      d = 1.0 / sqrt(a2);
+      l0 = WLZ_VTX_3_LENGTH(v[0]);
+      WLZ_VTX_3_SCALE(u[0], v[0], 1.0 / l0);
+      WLZ_VTX_3_SCALE(u[2], v[2], 1.0 / a2);
+      WLZ_VTX_3_CROSS(u[1], u[2], u[0]);
+      q2.vtX = WLZ_VTX_3_DOT(v[1], u[0]);
+      q2.vtY = WLZ_VTX_3_DOT(v[1], u[1]);
+      wR[0] = d * (q2.vtX - l0);
+      wI[0] = d * q2.vtY;
+      wR[1] = d * -q2.vtX;
+      wI[1] = d * -q2.vtY;
+      wR[2] = d * l0;
+      wI[2] = 0.0;
+      for(idN = 0; idN < 3; ++idN)
+      {
+	int	idV,
+		idQ;
+
+	idV = nod[idN]->idx;
+	if((idQ = pTb[idV]) < 0)
+	{
+	  (void )AlgMatrixSet(aM, idE,      idV,       wR[idN]);
+	  (void )AlgMatrixSet(aM, idE + nE, idV,      -wI[idN]);
+	  (void )AlgMatrixSet(aM, idE,      idV + nN,  wI[idN]);
+	  (void )AlgMatrixSet(aM, idE + nE, idV + nN,  wR[idN]);
+	}
+	else
+	{
+	  (void )AlgMatrixSet(bPM, idE,      idQ,       wR[idN]);
+	  (void )AlgMatrixSet(bPM, idE + nE, idQ,      -wI[idN]);
+	  (void )AlgMatrixSet(bPM, idE,      idQ + nP,  wI[idN]);
+	  (void )AlgMatrixSet(bPM, idE + nE, idQ + nP,  wR[idN]);
+	}
+      }
+    }
+    AlgMatrixVectorMul(bV, bPM, bUV);
+    errNum = WlzErrorFromAlg(
+             AlgMatrixSolveLSQR(aM, bV, xV, 1.0e-3, 1.0e-9, 1.0e-9, 10000, 0,
+	     			NULL, NULL, NULL, NULL, NULL, NULL, NULL));
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    for(idN = 0; idN < nN; ++idN)
+    {
+      double	*d;
+      WlzCMeshNod2D5 *nod;
+
+      d = dsp + (3 * idN);
+      nod = (WlzCMeshNod2D5 *)AlcVectorItemGet(mesh->res.nod.vec, idN);
+      if(pTb[idN] < 0)
+      {
+	d[0] = -(xV[idN     ] + nod->pos.vtX);
+	d[1] = -(xV[idN + nN] + nod->pos.vtY);
+      }
+      else
+      {
+	d[0] = dPV[pTb[idN]].vtX - nod->pos.vtX;
+	d[1] = dPV[pTb[idN]].vtY - nod->pos.vtY;
+      }
+      d[2] = -(nod->pos.vtZ);
+    }
+  }
+  AlgMatrixFree(aM);
+  AlgMatrixFree(bPM);
+  AlcFree(pTb);
+  AlcFree(bUV);
+  AlcFree(bV);
+  AlcFree(xV);
+  return(errNum);
+}
@@ -0,0 +1,911 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstConvexHull_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstConvexHull.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for WlzObjToConvexHull(), WlzConvexHullFromVtx2()
+* 		and WlzConvexHullFromVtx3(). The convex hulls of 2 and
+* 		3D domain objects and of random integer vertices, many
+* 		of which are coplanar or repeated, are checked to be
+* 		closed convex polygons or polyhedra which contain every
+* 		given pixel, voxel or vertex, with each hull vertex
+* 		being a given vertex and a true corner of the hull.
+* 		The convex hulls of the domain objects are also
+* 		compared with those computed from every interval end
+* 		of the objects, with the large sphere having enough
+* 		candidate vertices for them to be split into blocks.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+/*!
+* \struct	_WlzTstConvexHullCnr
+* \ingroup	BinWlzTst
+* \brief	Rank of the normals of the faces which share a convex
+* 		hull vertex, with the normals used to find it.
+* 		Typedef: ::WlzTstConvexHullCnr
+*/
+typedef struct _WlzTstConvexHullCnr
+{
+  int		rank;			/*!< Rank of the normals so far. */
+  WlzLVertex3	n0;			/*!< First normal. */
+  WlzLVertex3	n1;			/*!< Cross product of the first
+  					     normal with a second which is
+					     not parallel to it. */
+} WlzTstConvexHullCnr;
+
+static WlzObject		*WlzTstConvexHullMakeObj(
+				  int idC,
+				  WlzErrorNum *dstErr);
+static WlzIVertex3		*WlzTstConvexHullItvEnds(
+				  WlzObject *obj,
+				  int *dstNPts,
+				  WlzErrorNum *dstErr);
+static WlzIVertex3		*WlzTstConvexHullRandPts(
+				  int idC,
+				  int *dstNPts,
+				  WlzErrorNum *dstErr);
+static WlzIVertex3		*WlzTstConvexHullVtx(
+				  WlzDomain dom,
+				  int dim,
+				  int *dstNVtx,
+				  WlzErrorNum *dstErr);
+static int			WlzTstConvexHullChk2(
+				  WlzConvHullDomain2 *cvh,
+				  int nPts,
+				  WlzIVertex3 *pts);
+static int			WlzTstConvexHullChk3(
+				  WlzConvHullDomain3 *cvh,
+				  int nPts,
+				  WlzIVertex3 *pts);
+static int			WlzTstConvexHullSameVtx(
+				  WlzDomain dom0,
+				  WlzDomain dom1,
+				  int dim,
+				  WlzErrorNum *dstErr);
+static int			WlzTstConvexHullVtxCmp(
+				  const void *p0,
+				  const void *p1);
+
+int		main(int argc, char *argv[])
+{
+  int		idC,
+  		dim,
+		nPts = 0,
+		nAll = 0,
+		option,
+		ok = 1,
+		usage = 0,
+		verbose = 0;
+  WlzDomain	dom,
+  		vDom;
+  WlzVertexP	vtx;
+  WlzIVertex3	*pts = NULL;
+  WlzObject	*obj = NULL,
+  		*cObj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  const int	nObjCase = 7,
+  		nCase = 10,
+		maxChkPts = 20000;
+  const char	*caseStr[10] = {"2D rectangle",
+  				"2D disc with a hole",
+				"2D union of discs",
+				"3D cuboid",
+				"3D sphere with a hole",
+				"3D union of spheres",
+				"3D large sphere",
+				"2D random vertices",
+				"3D random lattice vertices",
+				"3D random vertices in a ball"};
+  static char	optList[] = "hv";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0) && (optind == argc);
+  usage = !ok;
+  if(ok)
+  {
+    AlgRandSeed(0);
+  }
+  for(idC = 0; ok && (errNum == WLZ_ERR_NONE) && (idC < nCase); ++idC)
+  {
+    dom.core = NULL;
+    vDom.core = NULL;
+    dim = ((idC < 3) || (idC == 7))? 2: 3;
+    if(idC < nObjCase)
+    {
+      /* Convex hull of a domain object and of all it's interval ends. */
+      obj = WlzAssignObject(WlzTstConvexHullMakeObj(idC, &errNum), NULL);
+      if(errNum == WLZ_ERR_NONE)
+      {
+        pts = WlzTstConvexHullItvEnds(obj, &nPts, &errNum);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+        cObj = WlzAssignObject(WlzObjToConvexHull(obj, &errNum), NULL);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+        dom = WlzAssignDomain(cObj->domain, NULL);
+      }
+    }
+    else
+    {
+      pts = WlzTstConvexHullRandPts(idC, &nPts, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if(dim == 2)
+      {
+	/* Two dimensional vertices have z = 0, so the 3D vertices can be
+	 * packed into a 2D array in place. */
+	int	idP;
+
+	vtx.i2 = (WlzIVertex2 *)AlcMalloc(nPts * sizeof(WlzIVertex2));
+	if(vtx.i2 == NULL)
+	{
+	  errNum = WLZ_ERR_MEM_ALLOC;
+	}
+	else
+	{
+	  for(idP = 0; idP < nPts; ++idP)
+	  {
+	    vtx.i2[idP].vtX = pts[idP].vtX;
+	    vtx.i2[idP].vtY = pts[idP].vtY;
+	  }
+	  vDom.cvh2 = WlzConvexHullFromVtx2(WLZ_VERTEX_I2, nPts, vtx,
+	  				    &errNum);
+	  AlcFree(vtx.v);
+	}
+      }
+      else
+      {
+        vtx.i3 = pts;
+	vDom.cvh3 = WlzConvexHullFromVtx3(WLZ_VERTEX_I3, nPts, vtx, &errNum);
+      }
+    }
+    nAll = nPts;
+    if((errNum == WLZ_ERR_NONE) && (dom.core != NULL) && (nPts > maxChkPts))
+    {
+      /* Checking that the convex hull contains the vertices of the convex
+       * hull of all the interval ends is equivalent to checking it contains
+       * all the interval ends and is much quicker for large objects. */
+      AlcFree(pts);
+      pts = WlzTstConvexHullVtx(vDom, dim, &nPts, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if(dom.core == NULL)
+      {
+        dom = vDom;
+	vDom.core = NULL;
+      }
+      ok = (dim == 2)? WlzTstConvexHullChk2(dom.cvh2, nPts, pts):
+                       WlzTstConvexHullChk3(dom.cvh3, nPts, pts);
+      if(ok && (vDom.core != NULL))
+      {
+	ok = WlzTstConvexHullSameVtx(dom, vDom, dim, &errNum);
+	if((errNum == WLZ_ERR_NONE) && !ok)
+	{
+	  (void )fprintf(stderr,
+	  		 "%s: Convex hull vertices of the %s differ from those "
+			 "of it's interval ends.\n",
+			 *argv, caseStr[idC]);
+	}
+      }
+      if((errNum == WLZ_ERR_NONE) && (verbose || !ok))
+      {
+	(void )fprintf(stderr, "%s: %s, %d vertices, %d hull vertices %s.\n",
+		       *argv, caseStr[idC], nAll,
+		       (dim == 2)? dom.cvh2->nVertices: dom.cvh3->nVertices,
+		       (ok)? "ok": "incorrect");
+      }
+    }
+    if(dom.core != NULL)
+    {
+      (void )WlzFreeDomain(dom);
+    }
+    if(vDom.core != NULL)
+    {
+      (void )WlzFreeDomain(vDom);
+    }
+    AlcFree(pts);
+    (void )WlzFreeObj(cObj);
+    (void )WlzFreeObj(obj);
+    pts = NULL;
+    cObj = obj = NULL;
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to test convex hulls (%s).\n",
+		   *argv, errMsg);
+  }
+  if(ok)
+  {
+    (void )printf("%s: Convex hulls contain their vertices and have only "
+    		  "corner vertices.\n", *argv);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-v]\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -v  Verbose output.\n"
+    "Tests WlzObjToConvexHull(), WlzConvexHullFromVtx2() and\n"
+    "WlzConvexHullFromVtx3() by checking that the convex hulls of 2 and\n"
+    "3D domain objects and of random vertices are closed and convex,\n"
+    "contain every given vertex and have only given vertices which are\n"
+    "corners of the hull. The convex hulls of the domain objects are\n"
+    "also compared with those of all their interval ends.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New object or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Makes one of the test domain objects.
+* \param	idC			Index of the test case.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstConvexHullMakeObj(int idC, WlzErrorNum *dstErr)
+{
+  int		idS;
+  WlzObjectType	oType;
+  WlzPixelV	bgdV;
+  WlzObject	*obj = NULL,
+  		*obj0 = NULL,
+		*obj1 = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const double	sph[4][4] = {{12.0,  0.0,  0.0,  0.0},
+  			     { 9.0, 17.0,  4.0, -3.0},
+			     { 7.0, -6.0, 15.0,  8.0},
+			     { 5.0,  3.0, -9.0, 14.0}};
+
+  oType = (idC < 3)? WLZ_2D_DOMAINOBJ: WLZ_3D_DOMAINOBJ;
+  switch(idC)
+  {
+    case 0:
+      bgdV.type = WLZ_GREY_INT;
+      bgdV.v.inv = 0;
+      obj = WlzMakeRect(-3, 11, 5, 29, WLZ_GREY_ERROR, NULL, bgdV,
+      			NULL, NULL, &errNum);
+      break;
+    case 3:
+      obj = WlzMakeCuboidObject(oType, 9.0, 4.0, 6.0, 3.0, -2.0, 7.0,
+      				&errNum);
+      break;
+    case 1: /* FALLTHROUGH */
+    case 4:
+      /* A hole gives lines with several intervals. */
+      obj0 = WlzAssignObject(
+	     WlzMakeSphereObject(oType, 20.0, 3.0, -2.0, 7.0, &errNum),
+	     NULL);
+      if(errNum == WLZ_ERR_NONE)
+      {
+	obj1 = WlzAssignObject(
+	       WlzMakeSphereObject(oType, 8.0, 9.0, -2.0, 7.0, &errNum),
+	       NULL);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+	obj = WlzDiffDomain(obj0, obj1, &errNum);
+      }
+      break;
+    case 2: /* FALLTHROUGH */
+    case 5:
+      for(idS = 0; (errNum == WLZ_ERR_NONE) && (idS < 4); ++idS)
+      {
+	obj1 = WlzAssignObject(
+	       WlzMakeSphereObject(oType, sph[idS][0], sph[idS][1],
+	       			   sph[idS][2], sph[idS][3], &errNum), NULL);
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  if(obj0 == NULL)
+	  {
+	    obj0 = obj1;
+	  }
+	  else
+	  {
+	    obj = WlzAssignObject(WlzUnion2(obj0, obj1, &errNum), NULL);
+	    (void )WlzFreeObj(obj0);
+	    (void )WlzFreeObj(obj1);
+	    obj0 = obj;
+	  }
+	  obj1 = NULL;
+	}
+      }
+      obj = obj0;
+      obj0 = NULL;
+      if(obj != NULL)
+      {
+        /* Remove the link added above, leaving that of obj0. */
+	--(obj->linkcount);
+      }
+      break;
+    case 6:
+      obj = WlzMakeSphereObject(oType, 100.0, 1.0, 2.0, 3.0, &errNum);
+      break;
+    default:
+      errNum = WLZ_ERR_PARAM_DATA;
+      break;
+  }
+  (void )WlzFreeObj(obj0);
+  (void )WlzFreeObj(obj1);
+  if((errNum != WLZ_ERR_NONE) && (obj != NULL))
+  {
+    (void )WlzFreeObj(obj);
+    obj = NULL;
+  }
+  *dstErr = errNum;
+  return(obj);
+}
+
+/*!
+* \return	New array of vertices or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Collects the ends of every interval of the given 2 or 3D
+* 		domain object, with z = 0 for a 2D object.
+* \param	obj			Given domain object.
+* \param	dstNPts			Destination pointer for the number of
+* 					vertices.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzIVertex3 *WlzTstConvexHullItvEnds(WlzObject *obj, int *dstNPts,
+					    WlzErrorNum *dstErr)
+{
+  int		idP,
+  		nPl,
+		nPts = 0,
+		maxPts;
+  WlzValues	nullVal;
+  WlzIVertex3	*pts = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  nullVal.core = NULL;
+  nPl = (obj->type == WLZ_2D_DOMAINOBJ)? 1:
+        obj->domain.p->lastpl - obj->domain.p->plane1 + 1;
+  maxPts = 2 * (int )WlzVolume(obj, &errNum);
+  if((errNum == WLZ_ERR_NONE) &&
+     ((pts = (WlzIVertex3 *)AlcMalloc(maxPts * sizeof(WlzIVertex3))) == NULL))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  for(idP = 0; (errNum == WLZ_ERR_NONE) && (idP < nPl); ++idP)
+  {
+    int		z = 0;
+    WlzDomain	dom;
+    WlzObject	*obj2 = NULL;
+    WlzIntervalWSpace iWSp;
+
+    if(obj->type == WLZ_2D_DOMAINOBJ)
+    {
+      dom = obj->domain;
+    }
+    else
+    {
+      z = obj->domain.p->plane1 + idP;
+      dom = obj->domain.p->domains[idP];
+    }
+    if(dom.core != NULL)
+    {
+      obj2 = WlzAssignObject(
+	     WlzMakeMain(WLZ_2D_DOMAINOBJ, dom, nullVal, NULL, NULL,
+			 &errNum), NULL);
+      if(errNum == WLZ_ERR_NONE)
+      {
+	errNum = WlzInitRasterScan(obj2, &iWSp, WLZ_RASTERDIR_ILIC);
+      }
+      while((errNum == WLZ_ERR_NONE) &&
+	    ((errNum = WlzNextInterval(&iWSp)) == WLZ_ERR_NONE))
+      {
+	pts[nPts].vtX = iWSp.lftpos;
+	pts[nPts].vtY = iWSp.linpos;
+	pts[nPts].vtZ = z;
+	pts[nPts + 1].vtX = iWSp.rgtpos;
+	pts[nPts + 1].vtY = iWSp.linpos;
+	pts[nPts + 1].vtZ = z;
+	nPts += 2;
+      }
+      if(errNum == WLZ_ERR_EOO)
+      {
+	errNum = WLZ_ERR_NONE;
+      }
+      (void )WlzFreeObj(obj2);
+    }
+  }
+  if((errNum != WLZ_ERR_NONE) && (pts != NULL))
+  {
+    AlcFree(pts);
+    pts = NULL;
+  }
+  *dstNPts = nPts;
+  *dstErr = errNum;
+  return(pts);
+}
+
+/*!
+* \return	New array of vertices or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Makes random integer vertices, with z = 0 for 2D
+* 		vertices. The vertices are either within a small square
+* 		or cube, so that many are coplanar or repeated, or within
+* 		a ball with enough vertices to be split into blocks.
+* \param	idC			Index of the test case.
+* \param	dstNPts			Destination pointer for the number of
+* 					vertices.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzIVertex3 *WlzTstConvexHullRandPts(int idC, int *dstNPts,
+					    WlzErrorNum *dstErr)
+{
+  int		idP,
+  		nPts;
+  WlzIVertex3	*pts = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const double	r = 40.0;
+
+  nPts = (idC == 7)? 2000: (idC == 8)? 3000: 30000;
+  if((pts = (WlzIVertex3 *)AlcMalloc(nPts * sizeof(WlzIVertex3))) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    idP = 0;
+    while(idP < nPts)
+    {
+      WlzDVertex3 p;
+
+      switch(idC)
+      {
+        case 7:
+	  pts[idP].vtX = (int )(AlgRandUniform() * 30.0) - 10;
+	  pts[idP].vtY = (int )(AlgRandUniform() * 30.0) + 5;
+	  pts[idP].vtZ = 0;
+	  ++idP;
+	  break;
+	case 8:
+	  pts[idP].vtX = (int )(AlgRandUniform() * 15.0) - 3;
+	  pts[idP].vtY = (int )(AlgRandUniform() * 15.0) + 2;
+	  pts[idP].vtZ = (int )(AlgRandUniform() * 15.0) - 7;
+	  ++idP;
+	  break;
+	default:
+	  p.vtX = (2.0 * AlgRandUniform() - 1.0) * r;
+	  p.vtY = (2.0 * AlgRandUniform() - 1.0) * r;
+	  p.vtZ = (2.0 * AlgRandUniform() - 1.0) * r;
+	  if(WLZ_VTX_3_LENGTH(p) <= r)
+	  {
+	    WLZ_VTX_3_NINT(pts[idP], p);
+	    ++idP;
+	  }
+	  break;
+      }
+    }
+  }
+  *dstNPts = nPts;
+  *dstErr = errNum;
+  return(pts);
+}
+
+/*!
+* \return	New sorted array of the convex hull vertices or NULL on
+* 		error.
+* \ingroup	BinWlzTst
+* \brief	Copies the vertices of a 2 or 3D convex hull domain, which
+* 		must be integer vertices, sorted by WlzTstConvexHullVtxCmp()
+* 		and with z = 0 for 2D vertices.
+* \param	dom			Convex hull domain.
+* \param	dim			Dimension, 2 or 3.
+* \param	dstNVtx			Destination pointer for the number of
+* 					vertices.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzIVertex3 *WlzTstConvexHullVtx(WlzDomain dom, int dim,
+					int *dstNVtx, WlzErrorNum *dstErr)
+{
+  int		idV,
+  		nVtx;
+  WlzIVertex3	*vtx = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  nVtx = (dim == 2)? dom.cvh2->nVertices: dom.cvh3->nVertices;
+  if(((dim == 2) && (dom.cvh2->vtxType != WLZ_VERTEX_I2)) ||
+     ((dim == 3) && (dom.cvh3->vtxType != WLZ_VERTEX_I3)))
+  {
+    errNum = WLZ_ERR_DOMAIN_TYPE;
+  }
+  else if((vtx = (WlzIVertex3 *)
+                 AlcMalloc((nVtx + 1) * sizeof(WlzIVertex3))) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    for(idV = 0; idV < nVtx; ++idV)
+    {
+      if(dim == 2)
+      {
+        vtx[idV].vtX = dom.cvh2->vertices.i2[idV].vtX;
+        vtx[idV].vtY = dom.cvh2->vertices.i2[idV].vtY;
+        vtx[idV].vtZ = 0;
+      }
+      else
+      {
+        vtx[idV] = dom.cvh3->vertices.i3[idV];
+      }
+    }
+    qsort(vtx, nVtx, sizeof(WlzIVertex3), WlzTstConvexHullVtxCmp);
+  }
+  *dstNVtx = nVtx;
+  *dstErr = errNum;
+  return(vtx);
+}
+
+/*!
+* \return	Non-zero if the convex hull is correct.
+* \ingroup	BinWlzTst
+* \brief	Checks a 2D convex hull: that it's vertices are given
+* 		vertices which make strictly convex turns all in the same
+* 		direction and that every given vertex is inside or on
+* 		the hull.
+* \param	cvh			Convex hull domain.
+* \param	nPts			Number of given vertices.
+* \param	pts			Given vertices, these are sorted.
+*/
+static int	WlzTstConvexHullChk2(WlzConvHullDomain2 *cvh,
+				     int nPts, WlzIVertex3 *pts)
+{
+  int		idV,
+  		idP,
+		nVtx,
+		sgn = 0,
+  		ok = 1;
+  WlzIVertex2	*vtx;
+
+  nVtx = cvh->nVertices;
+  vtx = cvh->vertices.i2;
+  qsort(pts, nPts, sizeof(WlzIVertex3), WlzTstConvexHullVtxCmp);
+  if((cvh->vtxType != WLZ_VERTEX_I2) || (nVtx < 3))
+  {
+    ok = 0;
+    (void )fprintf(stderr, "WlzTstConvexHullChk2: Bad vertex type or "
+    		   "too few vertices.\n");
+  }
+  for(idV = 0; ok && (idV < nVtx); ++idV)
+  {
+    long	c;
+    WlzIVertex2	v0,
+    		v1,
+		v2;
+    WlzIVertex3	key;
+
+    v0 = vtx[idV];
+    v1 = vtx[(idV + 1) % nVtx];
+    v2 = vtx[(idV + 2) % nVtx];
+    key.vtX = v0.vtX;
+    key.vtY = v0.vtY;
+    key.vtZ = 0;
+    c = ((long )(v1.vtX - v0.vtX) * (v2.vtY - v1.vtY)) -
+        ((long )(v1.vtY - v0.vtY) * (v2.vtX - v1.vtX));
+    if(idV == 0)
+    {
+      sgn = (c > 0)? 1: -1;
+    }
+    if(sgn * c <= 0)
+    {
+      ok = 0;
+      (void )fprintf(stderr, "WlzTstConvexHullChk2: Vertex %d,%d is not a "
+		     "convex corner.\n", v1.vtX, v1.vtY);
+    }
+    else if(bsearch(&key, pts, nPts, sizeof(WlzIVertex3),
+    		    WlzTstConvexHullVtxCmp) == NULL)
+    {
+      ok = 0;
+      (void )fprintf(stderr, "WlzTstConvexHullChk2: Vertex %d,%d is not a "
+		     "given vertex.\n", v0.vtX, v0.vtY);
+    }
+    for(idP = 0; ok && (idP < nPts); ++idP)
+    {
+      c = ((long )(v1.vtX - v0.vtX) * (pts[idP].vtY - v0.vtY)) -
+          ((long )(v1.vtY - v0.vtY) * (pts[idP].vtX - v0.vtX));
+      if(sgn * c < 0)
+      {
+	ok = 0;
+	(void )fprintf(stderr, "WlzTstConvexHullChk2: Vertex %d,%d is "
+		       "outside the convex hull.\n",
+		       pts[idP].vtX, pts[idP].vtY);
+      }
+    }
+  }
+  return(ok);
+}
+
+/*!
+* \return	Non-zero if the convex hull is correct.
+* \ingroup	BinWlzTst
+* \brief	Checks a 3D convex hull: that it is a closed triangulated
+* 		surface, that every hull vertex is a given vertex, that
+* 		it's faces are all oriented the same way with respect to
+* 		the given vertices, so that every given vertex is inside
+* 		or on the hull, and that the normals of the faces which
+* 		share each hull vertex span all three dimensions, ie the
+* 		vertex is a true corner of the hull.
+* 		Integer arithmetic is used throughout so the checks are
+* 		exact.
+* \param	cvh			Convex hull domain.
+* \param	nPts			Number of given vertices.
+* \param	pts			Given vertices, these are sorted.
+*/
+static int	WlzTstConvexHullChk3(WlzConvHullDomain3 *cvh,
+				     int nPts, WlzIVertex3 *pts)
+{
+  int		idF,
+  		idV,
+		idP,
+		nVtx,
+		nFce,
+		sgn = 0,
+  		ok = 1;
+  int		*fce;
+  WlzIVertex3	*vtx;
+  WlzLVertex3	*nrm = NULL;
+  WlzTstConvexHullCnr *cnrs = NULL;
+
+  nVtx = cvh->nVertices;
+  nFce = cvh->nFaces;
+  vtx = cvh->vertices.i3;
+  fce = cvh->faces;
+  qsort(pts, nPts, sizeof(WlzIVertex3), WlzTstConvexHullVtxCmp);
+  if((cvh->vtxType != WLZ_VERTEX_I3) || (nVtx < 4) ||
+     (nFce != (2 * nVtx) - 4))
+  {
+    ok = 0;
+    (void )fprintf(stderr, "WlzTstConvexHullChk3: Bad vertex type or "
+    		   "numbers of vertices (%d) and faces (%d).\n", nVtx, nFce);
+  }
+  else if(((nrm = (WlzLVertex3 *)
+                  AlcMalloc(nFce * sizeof(WlzLVertex3))) == NULL) ||
+	  ((cnrs = (WlzTstConvexHullCnr *)
+	           AlcCalloc(nVtx, sizeof(WlzTstConvexHullCnr))) == NULL))
+  {
+    ok = 0;
+    (void )fprintf(stderr, "WlzTstConvexHullChk3: Failed to allocate "
+    		   "workspace.\n");
+  }
+  /* The hull vertices must be given vertices. */
+  for(idV = 0; ok && (idV < nVtx); ++idV)
+  {
+    if(bsearch(vtx + idV, pts, nPts, sizeof(WlzIVertex3),
+    	       WlzTstConvexHullVtxCmp) == NULL)
+    {
+      ok = 0;
+      (void )fprintf(stderr, "WlzTstConvexHullChk3: Vertex %d,%d,%d is not "
+		     "a given vertex.\n",
+		     vtx[idV].vtX, vtx[idV].vtY, vtx[idV].vtZ);
+    }
+  }
+  /* Compute face normals, the faces must all be oriented the same way
+   * with respect to all the given vertices, so these must all be inside
+   * or on the hull. */
+  for(idF = 0; ok && (idF < nFce); ++idF)
+  {
+    int		*f;
+    WlzLVertex3	e0,
+    		e1;
+
+    f = fce + (3 * idF);
+    if((f[0] < 0) || (f[0] >= nVtx) || (f[1] < 0) || (f[1] >= nVtx) ||
+       (f[2] < 0) || (f[2] >= nVtx))
+    {
+      ok = 0;
+      (void )fprintf(stderr, "WlzTstConvexHullChk3: Face %d has a bad "
+      		     "vertex index.\n", idF);
+    }
+    else
+    {
+      WLZ_VTX_3_SUB(e0, vtx[f[1]], vtx[f[0]]);
+      WLZ_VTX_3_SUB(e1, vtx[f[2]], vtx[f[0]]);
+      WLZ_VTX_3_CROSS(nrm[idF], e0, e1);
+      if((nrm[idF].vtX == 0) && (nrm[idF].vtY == 0) && (nrm[idF].vtZ == 0))
+      {
+	ok = 0;
+	(void )fprintf(stderr, "WlzTstConvexHullChk3: Face %d is "
+		       "degenerate.\n", idF);
+      }
+    }
+    for(idP = 0; ok && (idP < nPts); ++idP)
+    {
+      long	d;
+      WlzLVertex3 p;
+
+      WLZ_VTX_3_SUB(p, pts[idP], vtx[f[0]]);
+      d = WLZ_VTX_3_DOT(nrm[idF], p);
+      if((sgn == 0) && (d != 0))
+      {
+        sgn = (d > 0)? 1: -1;
+      }
+      if(sgn * d < 0)
+      {
+	ok = 0;
+	(void )fprintf(stderr, "WlzTstConvexHullChk3: Vertex %d,%d,%d is "
+		       "outside face %d of the convex hull.\n",
+		       (int )(p.vtX + vtx[f[0]].vtX),
+		       (int )(p.vtY + vtx[f[0]].vtY),
+		       (int )(p.vtZ + vtx[f[0]].vtZ), idF);
+      }
+    }
+  }
+  /* Check the hull vertices are true corners, ie that the normals of
+   * the faces which share each vertex span all three dimensions. */
+  for(idF = 0; ok && (idF < nFce); ++idF)
+  {
+    int		idJ;
+
+    for(idJ = 0; idJ < 3; ++idJ)
+    {
+      WlzLVertex3 c;
+      WlzTstConvexHullCnr *cnr;
+
+      cnr = cnrs + fce[(3 * idF) + idJ];
+      switch(cnr->rank)
+      {
+	case 0:
+	  cnr->n0 = nrm[idF];
+	  cnr->rank = 1;
+	  break;
+	case 1:
+	  WLZ_VTX_3_CROSS(cnr->n1, cnr->n0, nrm[idF]);
+	  if((cnr->n1.vtX != 0) || (cnr->n1.vtY != 0) || (cnr->n1.vtZ != 0))
+	  {
+	    cnr->rank = 2;
+	  }
+	  break;
+	case 2:
+	  c = nrm[idF];
+	  if(WLZ_VTX_3_DOT(cnr->n1, c) != 0)
+	  {
+	    cnr->rank = 3;
+	  }
+	  break;
+	default:
+	  break;
+      }
+    }
+  }
+  for(idV = 0; ok && (idV < nVtx); ++idV)
+  {
+    if(cnrs[idV].rank < 3)
+    {
+      ok = 0;
+      (void )fprintf(stderr, "WlzTstConvexHullChk3: Vertex %d,%d,%d is not "
+		     "a corner of the convex hull.\n",
+		     vtx[idV].vtX, vtx[idV].vtY, vtx[idV].vtZ);
+    }
+  }
+  AlcFree(cnrs);
+  AlcFree(nrm);
+  return(ok);
+}
+
+/*!
+* \return	Non-zero if the convex hulls have the same vertices.
+* \ingroup	BinWlzTst
+* \brief	Compares the vertex sets of two 2 or 3D convex hulls.
+* \param	dom0			First convex hull domain.
+* \param	dom1			Second convex hull domain.
+* \param	dim			Dimension, 2 or 3.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstConvexHullSameVtx(WlzDomain dom0, WlzDomain dom1,
+				        int dim, WlzErrorNum *dstErr)
+{
+  int		n0 = 0,
+  		n1 = 0,
+		ok = 0;
+  WlzIVertex3	*vtx0 = NULL,
+  		*vtx1 = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  vtx0 = WlzTstConvexHullVtx(dom0, dim, &n0, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    vtx1 = WlzTstConvexHullVtx(dom1, dim, &n1, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    ok = (n0 == n1) && (memcmp(vtx0, vtx1, n0 * sizeof(WlzIVertex3)) == 0);
+  }
+  AlcFree(vtx0);
+  AlcFree(vtx1);
+  *dstErr = errNum;
+  return(ok);
+}
+
+/*!
+* \return	Sorting order.
+* \ingroup	BinWlzTst
+* \brief	Compares integer vertices by z, then y, then x for
+* 		sorting and searching.
+* \param	p0			First vertex.
+* \param	p1			Second vertex.
+*/
+static int	WlzTstConvexHullVtxCmp(const void *p0, const void *p1)
+{
+  int		c;
+  const WlzIVertex3 *v0,
+  		*v1;
+
+  v0 = (const WlzIVertex3 *)p0;
+  v1 = (const WlzIVertex3 *)p1;
+  if((c = v0->vtZ - v1->vtZ) == 0)
+  {
+    if((c = v0->vtY - v1->vtY) == 0)
+    {
+      c = v0->vtX - v1->vtX;
+    }
+  }
+  return(c);
+}
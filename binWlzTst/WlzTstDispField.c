@@ -0,0 +1,429 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstDispField_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstDispField.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for displacement field transforms which creates
+* 		rectangular and tiled displacement fields from an affine
+* 		transform, compares the field transformed vertices with
+* 		the affine transformed vertices and then compares the
+* 		fields after writing them to a file and reading them
+* 		back.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+static double			WlzTstDispFieldCmpTr(
+				  WlzDispFieldTransform *dft,
+				  WlzAffineTransform *aTr,
+				  int dim,
+				  int nVtx,
+				  WlzErrorNum *dstErr);
+static WlzDispFieldTransform	*WlzTstDispFieldRoundTrip(
+				  WlzDispFieldTransform *dft,
+				  WlzErrorNum *dstErr);
+
+int		main(int argc, char *argv[])
+{
+  int		idF,
+  		option,
+  		ok = 1,
+		usage = 0,
+		dim = 3,
+		nVtx = 1000,
+		verbose = 0;
+  long		seed = 0;
+  size_t	tileSz = 0;
+  double	tol = 1.0e-3,
+  		size = 30.0,
+		maxErr = 0.0;
+  WlzObject	*refObj = NULL;
+  WlzAffineTransform *aTr = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*op = "create",
+  		*errMsg;
+  static char	optList[] = "23hn:r:s:t:T:v";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case '2':
+        dim = 2;
+	break;
+      case '3':
+        dim = 3;
+	break;
+      case 'n':
+        nVtx = atoi(optarg);
+	break;
+      case 'r':
+        size = atof(optarg);
+	break;
+      case 's':
+        seed = atol(optarg);
+	break;
+      case 't':
+        tileSz = (size_t )atol(optarg);
+	break;
+      case 'T':
+        tol = atof(optarg);
+	break;
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  if((usage == 0) &&
+     ((optind != argc) || (nVtx < 1) || (size < 4.0) || (tol <= 0.0)))
+  {
+    usage = 1;
+  }
+  ok = !usage;
+  if(ok)
+  {
+    /* Tiles of width 4 which do not divide the lattice. */
+    if(tileSz == 0)
+    {
+      tileSz = (dim == 2)? 16: 64;
+    }
+    srand48(seed);
+    if(dim == 2)
+    {
+      refObj = WlzMakeRectangleObject(size / 2.0 + 0.3, size / 3.0 + 0.3,
+      				      size / 2.0, size / 3.0, &errNum);
+      if(errNum == WLZ_ERR_NONE)
+      {
+        aTr = WlzAffineTransformFromPrimVal(WLZ_TRANSFORM_2D_AFFINE,
+				(drand48() - 0.5) * size,
+				(drand48() - 0.5) * size, 0.0,
+				0.8 + (0.4 * drand48()),
+				(drand48() - 0.5) * ALG_M_PI,
+				0.0, 0.0, 0.0, 0.0, 0, &errNum);
+      }
+    }
+    else
+    {
+      refObj = WlzMakeCuboidObject(WLZ_3D_DOMAINOBJ,
+      				   size / 2.0 + 0.3, size / 3.0 + 0.3,
+				   size / 4.0 + 0.3,
+				   size / 2.0, size / 3.0, size / 4.0,
+				   &errNum);
+      if(errNum == WLZ_ERR_NONE)
+      {
+        aTr = WlzAffineTransformFromPrimVal(WLZ_TRANSFORM_3D_AFFINE,
+				(drand48() - 0.5) * size,
+				(drand48() - 0.5) * size,
+				(drand48() - 0.5) * size,
+				0.8 + (0.4 * drand48()),
+				(drand48() - 0.5) * ALG_M_PI,
+				(drand48() - 0.5) * ALG_M_PI,
+				0.0, 0.0, 0.0, 0, &errNum);
+      }
+    }
+    refObj = WlzAssignObject(refObj, NULL);
+  }
+  /* Field zero has rectangular values and field one tiled values. */
+  for(idF = 0; ok && (errNum == WLZ_ERR_NONE) && (idF < 2); ++idF)
+  {
+    double	err;
+    WlzDomain	dom;
+    WlzTransform tr;
+    WlzDispFieldTransform *dft = NULL,
+    		*rdft = NULL;
+
+    op = "create";
+    tr.affine = aTr;
+    dom.df = WlzDispFieldFromTransform(tr, refObj, (idF)? tileSz: 0,
+    				       &errNum);
+    dft = WlzAssignDomain(dom, NULL).df;
+    if(errNum == WLZ_ERR_NONE)
+    {
+      op = "apply";
+      err = WlzTstDispFieldCmpTr(dft, aTr, dim, nVtx, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      maxErr = WLZ_MAX(maxErr, err);
+      if(verbose)
+      {
+        (void )fprintf(stderr, "%s: %s field error %g\n",
+		       *argv, (idF)? "tiled": "rectangular", err);
+      }
+      op = "write and read";
+      rdft = WlzTstDispFieldRoundTrip(dft, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      op = "apply";
+      err = WlzTstDispFieldCmpTr(rdft, aTr, dim, nVtx, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      maxErr = WLZ_MAX(maxErr, err);
+      if(verbose)
+      {
+        (void )fprintf(stderr, "%s: %s field error %g after reading\n",
+		       *argv, (idF)? "tiled": "rectangular", err);
+      }
+    }
+    (void )WlzFreeDispFieldTransform(dft);
+    (void )WlzFreeDispFieldTransform(rdft);
+    if((errNum == WLZ_ERR_NONE) && (maxErr > tol))
+    {
+      ok = 0;
+      (void )fprintf(stderr,
+		     "%s: %s field differs from the affine transform by "
+		     "%g.\n",
+		     *argv, (idF)? "Tiled": "Rectangular", maxErr);
+    }
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to %s displacement field (%s).\n",
+		   *argv, op, errMsg);
+  }
+  if(ok)
+  {
+    (void )printf("%s: Rectangular and tiled %dD fields, maximum "
+		  "difference %g.\n", *argv, dim, maxErr);
+  }
+  (void )WlzFreeAffineTransform(aTr);
+  (void )WlzFreeObj(refObj);
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-2] [-3] [-h] [-n#] [-r#] [-s#] [-t#] [-T#] [-v]\n"
+    "Creates rectangular and tiled displacement fields from a random\n"
+    "affine transform, compares the field transformed vertices with the\n"
+    "affine transformed vertices and repeats the comparison after the\n"
+    "fields have been written to a file and read back.\n"
+    "Options:\n"
+    "  -2  Use a 2D transform.\n"
+    "  -3  Use a 3D transform (default).\n"
+    "  -h  Prints this usage information.\n"
+    "  -n  Number of vertices compared (default 1000).\n"
+    "  -r  Size of the field lattice (default 30).\n"
+    "  -s  Seed for the random number generator (default 0).\n"
+    "  -t  Number of values per tile of the tiled field (default 16\n"
+    "      for 2D and 64 for 3D).\n"
+    "  -T  Tolerance for the maximum difference (default 1.0e-3).\n"
+    "  -v  Verbose output.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	Maximum difference between the field and affine
+* 		transformed vertices.
+* \ingroup	BinWlzTst
+* \brief	Transforms random vertices within the lattice of the
+* 		displacement field using both the displacement field
+* 		and the affine transform.
+* \param	dft			Displacement field transform.
+* \param	aTr			Affine transform.
+* \param	dim			Dimension, 2 or 3.
+* \param	nVtx			Number of vertices.
+* \param	dstErr			Destination error pointer.
+*/
+static double	WlzTstDispFieldCmpTr(WlzDispFieldTransform *dft,
+				WlzAffineTransform *aTr, int dim,
+				int nVtx, WlzErrorNum *dstErr)
+{
+  int		idN;
+  double	d,
+  		maxD = 0.0;
+  WlzIBox3	bBox;
+  WlzDVertex3	*vtx = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  bBox = WlzBoundingBox3I(dft->field->o[0], &errNum);
+  if((errNum == WLZ_ERR_NONE) &&
+     ((vtx = (WlzDVertex3 *)AlcMalloc(nVtx * sizeof(WlzDVertex3))) == NULL))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    for(idN = 0; idN < nVtx; ++idN)
+    {
+      vtx[idN].vtX = bBox.xMin + (drand48() * (bBox.xMax - bBox.xMin));
+      vtx[idN].vtY = bBox.yMin + (drand48() * (bBox.yMax - bBox.yMin));
+      vtx[idN].vtZ = (dim == 2)? 0.0:
+                     bBox.zMin + (drand48() * (bBox.zMax - bBox.zMin));
+    }
+    if(dim == 2)
+    {
+      WlzDVertex2 *v2 = NULL;
+
+      if((v2 = (WlzDVertex2 *)
+               AlcMalloc(nVtx * sizeof(WlzDVertex2))) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      else
+      {
+	for(idN = 0; idN < nVtx; ++idN)
+	{
+	  v2[idN].vtX = vtx[idN].vtX;
+	  v2[idN].vtY = vtx[idN].vtY;
+	}
+        errNum = WlzDispFieldTransformVtxAry2D(dft, nVtx, v2);
+      }
+      for(idN = 0; (errNum == WLZ_ERR_NONE) && (idN < nVtx); ++idN)
+      {
+        WlzDVertex2 s,
+		    t;
+
+	s.vtX = vtx[idN].vtX;
+	s.vtY = vtx[idN].vtY;
+	t = WlzAffineTransformVertexD2(aTr, s, &errNum);
+	d = WLZ_MAX(fabs(t.vtX - v2[idN].vtX), fabs(t.vtY - v2[idN].vtY));
+	maxD = WLZ_MAX(maxD, d);
+      }
+      AlcFree(v2);
+    }
+    else
+    {
+      WlzDVertex3 *v3 = NULL;
+
+      if((v3 = (WlzDVertex3 *)
+               AlcMalloc(nVtx * sizeof(WlzDVertex3))) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      else
+      {
+	(void )memcpy(v3, vtx, nVtx * sizeof(WlzDVertex3));
+        errNum = WlzDispFieldTransformVtxAry3D(dft, nVtx, v3);
+      }
+      for(idN = 0; (errNum == WLZ_ERR_NONE) && (idN < nVtx); ++idN)
+      {
+        WlzDVertex3 t;
+
+	t = WlzAffineTransformVertexD3(aTr, vtx[idN], &errNum);
+	d = WLZ_MAX(fabs(t.vtX - v3[idN].vtX), fabs(t.vtY - v3[idN].vtY));
+	d = WLZ_MAX(d, fabs(t.vtZ - v3[idN].vtZ));
+	maxD = WLZ_MAX(maxD, d);
+      }
+      AlcFree(v3);
+    }
+  }
+  AlcFree(vtx);
+  *dstErr = errNum;
+  return(maxD);
+}
+
+/*!
+* \return	Displacement field transform read back from the file or
+* 		NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Writes the given displacement field transform to a
+* 		temporary file and then reads it back.
+* \param	dft			Displacement field transform.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzDispFieldTransform *WlzTstDispFieldRoundTrip(
+				WlzDispFieldTransform *dft,
+				WlzErrorNum *dstErr)
+{
+  FILE		*fP = NULL;
+  WlzDomain	dom;
+  WlzValues	val;
+  WlzObject	*obj = NULL,
+  		*rObj = NULL;
+  WlzDispFieldTransform *rdft = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  dom.df = dft;
+  val.core = NULL;
+  obj = WlzAssignObject(
+  	WlzMakeMain(WLZ_DISP_TRANS, dom, val, NULL, NULL, &errNum), NULL);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((fP = tmpfile()) == NULL)
+    {
+      errNum = WLZ_ERR_WRITE_EOF;
+    }
+    else
+    {
+      errNum = WlzWriteObj(fP, obj);
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    rewind(fP);
+    rObj = WlzAssignObject(WlzReadObj(fP, &errNum), NULL);
+  }
+  if((errNum == WLZ_ERR_NONE) &&
+     ((rObj->type != WLZ_DISP_TRANS) ||
+      (rObj->domain.df->type != dft->type)))
+  {
+    errNum = WLZ_ERR_OBJECT_TYPE;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    rdft = (WlzDispFieldTransform *)
+           WlzAssignDomain(rObj->domain, NULL).df;
+  }
+  if(fP)
+  {
+    (void )fclose(fP);
+  }
+  (void )WlzFreeObj(obj);
+  (void )WlzFreeObj(rObj);
+  *dstErr = errNum;
+  return(rdft);
+}
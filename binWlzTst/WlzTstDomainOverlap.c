@@ -0,0 +1,310 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstDomainOverlap_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstDomainOverlap.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for WlzDomainOverlapMatrix() which compares the
+* 		overlap matrix of sets of randomly placed circles or
+* 		spheres with the areas or volumes of the pairwise
+* 		intersections.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+static WlzObject		**WlzTstDomainOverlapObjs(
+				  int dim,
+				  int nObj,
+				  double size,
+				  WlzErrorNum *dstErr);
+static void			WlzTstDomainOverlapFreeObjs(
+				  int nObj,
+				  WlzObject **objs);
+
+int		main(int argc, char *argv[])
+{
+  int		idA,
+  		idB,
+  		option,
+  		ok = 1,
+		usage = 0,
+		dim = 3,
+		nA = 20,
+		nB = 15,
+		nBad = 0,
+		verbose = 0;
+  long		seed = 0;
+  double	size = 40.0;
+  WlzObject	**aObjs = NULL,
+  		**bObjs = NULL;
+  AlgMatrixCSR	*mat = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  static char	optList[] = "23ha:b:r:s:v";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case '2':
+        dim = 2;
+	break;
+      case '3':
+        dim = 3;
+	break;
+      case 'a':
+        nA = atoi(optarg);
+	break;
+      case 'b':
+        nB = atoi(optarg);
+	break;
+      case 'r':
+        size = atof(optarg);
+	break;
+      case 's':
+        seed = atol(optarg);
+	break;
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  if((usage == 0) &&
+     ((optind != argc) || (nA < 1) || (nB < 0) || (size < 4.0)))
+  {
+    usage = 1;
+  }
+  ok = !usage;
+  if(ok)
+  {
+    srand48(seed);
+    aObjs = WlzTstDomainOverlapObjs(dim, nA, size, &errNum);
+    if((errNum == WLZ_ERR_NONE) && (nB > 0))
+    {
+      bObjs = WlzTstDomainOverlapObjs(dim, nB, size, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      /* With no second set the first set is compared with itself. */
+      mat = WlzDomainOverlapMatrix(nA, aObjs, nB, bObjs, &errNum);
+    }
+    if(errNum != WLZ_ERR_NONE)
+    {
+      ok = 0;
+      (void )WlzStringFromErrorNum(errNum, &errMsg);
+      (void )fprintf(stderr,
+		     "%s: Failed to compute overlap matrix (%s).\n",
+		     *argv, errMsg);
+    }
+  }
+  if(ok)
+  {
+    WlzObject	**oObjs;
+
+    if(bObjs == NULL)
+    {
+      nB = nA;
+    }
+    oObjs = (bObjs)? bObjs: aObjs;
+    for(idA = 0; (errNum == WLZ_ERR_NONE) && (idA < nA); ++idA)
+    {
+      for(idB = 0; (errNum == WLZ_ERR_NONE) && (idB < nB); ++idB)
+      {
+	WlzLong	 ovl = 0;
+	double	val;
+	WlzObject *iObj = NULL;
+
+	if((aObjs[idA]->type != WLZ_EMPTY_OBJ) &&
+	   (oObjs[idB]->type != WLZ_EMPTY_OBJ))
+	{
+	  iObj = WlzAssignObject(
+		 WlzIntersect2(aObjs[idA], oObjs[idB], &errNum), NULL);
+	  if((errNum == WLZ_ERR_NONE) && (iObj->type != WLZ_EMPTY_OBJ))
+	  {
+	    ovl = (dim == 2)? WlzArea(iObj, &errNum):
+	                      WlzVolume(iObj, &errNum);
+	  }
+	  (void )WlzFreeObj(iObj);
+	}
+	val = AlgMatrixCSRValue(mat, idA, idB);
+	if(fabs(val - (double )ovl) > 0.5)
+	{
+	  ++nBad;
+	  if(verbose)
+	  {
+	    (void )fprintf(stderr,
+			   "%s: overlap (%d, %d) is %g but should be %ld.\n",
+			   *argv, idA, idB, val, (long )ovl);
+	  }
+	}
+      }
+    }
+    if(errNum != WLZ_ERR_NONE)
+    {
+      ok = 0;
+      (void )WlzStringFromErrorNum(errNum, &errMsg);
+      (void )fprintf(stderr,
+		     "%s: Failed to compute intersection (%s).\n",
+		     *argv, errMsg);
+    }
+    else if(nBad > 0)
+    {
+      ok = 0;
+      (void )fprintf(stderr,
+		     "%s: %d of the %d overlaps are incorrect.\n",
+		     *argv, nBad, nA * nB);
+    }
+    else
+    {
+      (void )printf("%s: All %d overlaps are correct.\n", *argv, nA * nB);
+    }
+  }
+  AlgMatrixCSRFree(mat);
+  WlzTstDomainOverlapFreeObjs(nA, aObjs);
+  WlzTstDomainOverlapFreeObjs(nB, bObjs);
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-2] [-3] [-h] [-a#] [-b#] [-r#] [-s#] [-v]\n"
+    "Computes the overlap matrix of randomly placed circles or spheres\n"
+    "using WlzDomainOverlapMatrix() and compares it with the areas or\n"
+    "volumes of the pairwise intersections. The last object of each set\n"
+    "is empty.\n"
+    "Options:\n"
+    "  -2  Use 2D circles.\n"
+    "  -3  Use 3D spheres (default).\n"
+    "  -h  Prints this usage information.\n"
+    "  -a  Number of objects in the first set (default 20).\n"
+    "  -b  Number of objects in the second set, if zero the first set\n"
+    "      is compared with itself (default 15).\n"
+    "  -r  Size of the region containing the objects (default 40).\n"
+    "  -s  Seed for the random number generator (default 0).\n"
+    "  -v  Verbose output.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New array of objects or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Creates an array of randomly placed circles or spheres
+* 		of random radius, with the last object being empty.
+* \param	dim			Dimension, 2 or 3.
+* \param	nObj			Number of objects.
+* \param	size			Size of the region containing the
+* 					objects.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject **WlzTstDomainOverlapObjs(int dim, int nObj, double size,
+				WlzErrorNum *dstErr)
+{
+  int		idO;
+  WlzObject	**objs;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((objs = (WlzObject **)AlcCalloc(nObj, sizeof(WlzObject *))) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  for(idO = 0; (errNum == WLZ_ERR_NONE) && (idO < nObj); ++idO)
+  {
+    double	r;
+    WlzDVertex3	c;
+    WlzObject	*obj;
+
+    r = 1.0 + (drand48() * size / 4.0);
+    c.vtX = drand48() * size;
+    c.vtY = drand48() * size;
+    c.vtZ = drand48() * size;
+    if(idO == nObj - 1)
+    {
+      obj = WlzMakeEmpty(&errNum);
+    }
+    else if(dim == 2)
+    {
+      obj = WlzMakeCircleObject(r, c.vtX, c.vtY, &errNum);
+    }
+    else
+    {
+      obj = WlzMakeSphereObject(WLZ_3D_DOMAINOBJ, r, c.vtX, c.vtY, c.vtZ,
+      				&errNum);
+    }
+    objs[idO] = WlzAssignObject(obj, NULL);
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    WlzTstDomainOverlapFreeObjs(nObj, objs);
+    objs = NULL;
+  }
+  *dstErr = errNum;
+  return(objs);
+}
+
+/*!
+* \ingroup	BinWlzTst
+* \brief	Frees an array of objects.
+* \param	nObj			Number of objects.
+* \param	objs			Array of objects, may be NULL.
+*/
+static void	WlzTstDomainOverlapFreeObjs(int nObj, WlzObject **objs)
+{
+  int		idO;
+
+  if(objs)
+  {
+    for(idO = 0; idO < nObj; ++idO)
+    {
+      (void )WlzFreeObj(objs[idO]);
+    }
+    AlcFree(objs);
+  }
+}
@@ -0,0 +1,374 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstDomainQueryIdx_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstDomainQueryIdx.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for the domain query index functions. Point in
+* 		domain queries made using WlzMakeDomainQueryIdx() and
+* 		the single and batch query functions, both with and
+* 		without a bitset, are compared with WlzInsideDomain()
+* 		for every integer point in and around the bounding box
+* 		and for random double precision points. The domains
+* 		include rectangles, lines with several intervals and a
+* 		3D domain with a missing plane.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+static WlzObject		*WlzTstDomainQueryIdxMakeObj(
+				  int idO,
+				  WlzErrorNum *dstErr);
+static int			WlzTstDomainQueryIdxCmp(
+				  WlzObject *obj,
+				  int bitset,
+				  int nRand,
+				  WlzErrorNum *dstErr);
+
+int		main(int argc, char *argv[])
+{
+  int		idO,
+  		idB,
+		option,
+		ok = 1,
+		usage = 0,
+		verbose = 0,
+		nRand = 10000;
+  long		seed = 0;
+  WlzObject	*obj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  const int	nObj = 5;
+  static char	optList[] = "hn:s:v";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'n':
+        if((sscanf(optarg, "%d", &nRand) != 1) || (nRand < 0))
+	{
+	  usage = 1;
+	}
+	break;
+      case 's':
+        if(sscanf(optarg, "%ld", &seed) != 1)
+	{
+	  usage = 1;
+	}
+	break;
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0) && (optind == argc);
+  usage = !ok;
+  if(ok)
+  {
+    AlgRandSeed(seed);
+  }
+  for(idO = 0; ok && (errNum == WLZ_ERR_NONE) && (idO < nObj); ++idO)
+  {
+    obj = WlzAssignObject(WlzTstDomainQueryIdxMakeObj(idO, &errNum), NULL);
+    for(idB = 0; ok && (errNum == WLZ_ERR_NONE) && (idB < 2); ++idB)
+    {
+      ok = WlzTstDomainQueryIdxCmp(obj, idB, nRand, &errNum);
+      if(verbose || !ok)
+      {
+        (void )fprintf(stderr, "%s: Domain %d %s bitset %s.\n",
+		       *argv, idO, (idB)? "with": "without",
+		       (ok)? "ok": "differs from WlzInsideDomain()");
+      }
+    }
+    (void )WlzFreeObj(obj);
+    obj = NULL;
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to test domain query index (%s).\n",
+		   *argv, errMsg);
+  }
+  if(ok)
+  {
+    (void )printf("%s: Domain query index queries match "
+    		  "WlzInsideDomain().\n", *argv);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-n #] [-s #] [-v]\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -n  Number of random double precision points (default 10000).\n"
+    "  -s  Seed for random number generator (default 0).\n"
+    "  -v  Verbose output.\n"
+    "Tests the domain query index functions by comparing their point in\n"
+    "domain classification with that of WlzInsideDomain() for 2 and 3D\n"
+    "domains.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New domain object or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Makes one of the test domain objects: a 2D rectangle,
+* 		a 2D disc with an offset hole, a 3D cuboid, a 3D sphere
+* 		with an offset hole and the same shell with a missing
+* 		plane.
+* \param	idO			Index of the object.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstDomainQueryIdxMakeObj(int idO, WlzErrorNum *dstErr)
+{
+  WlzObjectType	oType;
+  WlzPixelV	bgdV;
+  WlzObject	*obj = NULL,
+  		*obj0 = NULL,
+		*obj1 = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  bgdV.type = WLZ_GREY_UBYTE;
+  bgdV.v.ubv = 0;
+  oType = (idO < 2)? WLZ_2D_DOMAINOBJ: WLZ_3D_DOMAINOBJ;
+  switch(idO)
+  {
+    case 0:
+      obj = WlzMakeRect(-7, 20, 3, 41, WLZ_GREY_ERROR, NULL, bgdV,
+      			NULL, NULL, &errNum);
+      break;
+    case 2:
+      obj = WlzMakeCuboid(-2, 5, -7, 20, 3, 41, WLZ_GREY_ERROR, bgdV,
+      			  NULL, NULL, &errNum);
+      break;
+    default:
+      /* Lines through the hole have two intervals. */
+      obj0 = WlzAssignObject(
+      	     WlzMakeSphereObject(oType, 17.0, 11.0, -4.0, 3.0, &errNum), NULL);
+      if(errNum == WLZ_ERR_NONE)
+      {
+        obj1 = WlzAssignObject(
+	       WlzMakeSphereObject(oType, 6.0, 15.0, -2.0, 5.0, &errNum),
+	       NULL);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+        obj = WlzDiffDomain(obj0, obj1, &errNum);
+      }
+      (void )WlzFreeObj(obj0);
+      (void )WlzFreeObj(obj1);
+      break;
+  }
+  if((errNum == WLZ_ERR_NONE) && (idO == 4))
+  {
+    int		idP;
+    WlzPlaneDomain *pDom;
+
+    /* Remove a plane from the middle of the domain. */
+    pDom = obj->domain.p;
+    idP = (pDom->lastpl - pDom->plane1) / 2;
+    (void )WlzFreeDomain(pDom->domains[idP]);
+    pDom->domains[idP].core = NULL;
+  }
+  if((errNum != WLZ_ERR_NONE) && (obj != NULL))
+  {
+    (void )WlzFreeObj(obj);
+    obj = NULL;
+  }
+  *dstErr = errNum;
+  return(obj);
+}
+
+/*!
+* \return	Non-zero if all queries match WlzInsideDomain().
+* \ingroup	BinWlzTst
+* \brief	Builds a domain query index for the given object and
+* 		compares its classification of points with that of
+* 		WlzInsideDomain(), using WlzDomainQueryIdxInside() and
+* 		the batch query functions for every integer point in the
+* 		bounding box grown by two and random double precision
+* 		points within the same box.
+* \param	obj			Given domain object.
+* \param	bitset			Build a bitset if non-zero.
+* \param	nRand			Number of random points.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstDomainQueryIdxCmp(WlzObject *obj, int bitset,
+					int nRand, WlzErrorNum *dstErr)
+{
+  int		eq = 0,
+  		nPos = 0;
+  int		*in = NULL,
+  		*ref = NULL;
+  WlzIBox3	box;
+  WlzIVertex3	*iPos = NULL;
+  WlzIVertex2	*iPos2 = NULL;
+  WlzDVertex3	*dPos = NULL;
+  WlzDomainQueryIdx *idx = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const int	g = 2;
+
+  box = WlzBoundingBox3I(obj, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    box.xMin -= g;
+    box.yMin -= g;
+    box.zMin -= g;
+    box.xMax += g;
+    box.yMax += g;
+    box.zMax += g;
+    nPos = (box.xMax - box.xMin + 1) * (box.yMax - box.yMin + 1) *
+           (box.zMax - box.zMin + 1);
+    nPos = WLZ_MAX(nPos, nRand);
+    if(((in = (int *)AlcMalloc(nPos * sizeof(int))) == NULL) ||
+       ((ref = (int *)AlcMalloc(nPos * sizeof(int))) == NULL) ||
+       ((iPos = (WlzIVertex3 *)
+                AlcMalloc(nPos * sizeof(WlzIVertex3))) == NULL) ||
+       ((iPos2 = (WlzIVertex2 *)
+                 AlcMalloc(nPos * sizeof(WlzIVertex2))) == NULL) ||
+       ((dPos = (WlzDVertex3 *)
+                AlcMalloc(nPos * sizeof(WlzDVertex3))) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    idx = WlzMakeDomainQueryIdx(obj, bitset, &errNum);
+  }
+  /* Every integer point, one at a time and as a batch. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idN,
+    		idP,
+    		idL,
+		idK;
+
+    eq = 1;
+    idN = 0;
+    for(idP = box.zMin; idP <= box.zMax; ++idP)
+    {
+      for(idL = box.yMin; idL <= box.yMax; ++idL)
+      {
+	for(idK = box.xMin; idK <= box.xMax; ++idK)
+	{
+	  iPos[idN].vtX = idK;
+	  iPos[idN].vtY = idL;
+	  iPos[idN].vtZ = idP;
+	  ref[idN] = WlzInsideDomain(obj, idP, idL, idK, NULL) != 0;
+	  if((WlzDomainQueryIdxInside(idx, idP, idL, idK) != 0) != ref[idN])
+	  {
+	    eq = 0;
+	  }
+	  ++idN;
+	}
+      }
+    }
+    nPos = idN;
+    errNum = WlzDomainQueryIdxInsideI3(idx, nPos, iPos, in);
+    for(idN = 0; eq && (errNum == WLZ_ERR_NONE) && (idN < nPos); ++idN)
+    {
+      eq = (in[idN] != 0) == ref[idN];
+    }
+  }
+  /* The 2D batch query of a 3D index is on plane zero. */
+  if(eq && (errNum == WLZ_ERR_NONE))
+  {
+    int		idN,
+    		n2 = 0;
+
+    for(idN = 0; idN < nPos; ++idN)
+    {
+      if((obj->type == WLZ_2D_DOMAINOBJ) || (iPos[idN].vtZ == 0))
+      {
+	iPos2[n2].vtX = iPos[idN].vtX;
+	iPos2[n2].vtY = iPos[idN].vtY;
+	ref[n2++] = ref[idN];
+      }
+    }
+    errNum = WlzDomainQueryIdxInsideI2(idx, n2, iPos2, in);
+    for(idN = 0; eq && (errNum == WLZ_ERR_NONE) && (idN < n2); ++idN)
+    {
+      eq = (in[idN] != 0) == ref[idN];
+    }
+  }
+  /* Random double precision points. */
+  if(eq && (errNum == WLZ_ERR_NONE))
+  {
+    int		idN;
+
+    for(idN = 0; idN < nRand; ++idN)
+    {
+      dPos[idN].vtX = box.xMin + (AlgRandUniform() * (box.xMax - box.xMin));
+      dPos[idN].vtY = box.yMin + (AlgRandUniform() * (box.yMax - box.yMin));
+      dPos[idN].vtZ = box.zMin + (AlgRandUniform() * (box.zMax - box.zMin));
+      ref[idN] = WlzInsideDomain(obj, dPos[idN].vtZ, dPos[idN].vtY,
+      				 dPos[idN].vtX, NULL) != 0;
+    }
+    errNum = WlzDomainQueryIdxInsideD3(idx, nRand, dPos, in);
+    for(idN = 0; eq && (errNum == WLZ_ERR_NONE) && (idN < nRand); ++idN)
+    {
+      eq = (in[idN] != 0) == ref[idN];
+    }
+  }
+  (void )WlzFreeDomainQueryIdx(idx);
+  AlcFree(in);
+  AlcFree(ref);
+  AlcFree(iPos);
+  AlcFree(iPos2);
+  AlcFree(dPos);
+  *dstErr = errNum;
+  return(eq);
+}
@@ -0,0 +1,479 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstIteratePartition_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstIteratePartition.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for the functions which scan partitioned objects
+* 		concurrently, comparing the results for objects with
+* 		tiled and non-tiled values using several thread counts.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Wlz.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+/*!
+* \ingroup	BinWlzTst
+* \brief	Operations applied to the objects.
+*/
+typedef enum _WlzTstIteratePartitionOpType
+{
+  WLZTST_ITERATEPARTITION_MULADD = 0,	/*!< WlzScalarMulAdd(). */
+  WLZTST_ITERATEPARTITION_INC,		/*!< WlzGreyIncValuesInDomain(). */
+  WLZTST_ITERATEPARTITION_SET,		/*!< WlzGreySetValue(). */
+  WLZTST_ITERATEPARTITION_NOP		/*!< Number of operations. */
+} WlzTstIteratePartitionOpType;
+
+static WlzObject		*WlzTstIteratePartitionObj(
+				  int dim,
+				  double size,
+				  double radius,
+				  size_t tileSz,
+				  WlzErrorNum *dstErr);
+static WlzObject		*WlzTstIteratePartitionOp(
+				  WlzTstIteratePartitionOpType op,
+				  WlzObject *gObj,
+				  WlzObject *dObj,
+				  WlzErrorNum *dstErr);
+static int			WlzTstIteratePartitionCmp(
+				  WlzObject *obj0,
+				  WlzObject *obj1,
+				  WlzErrorNum *dstErr);
+
+int		main(int argc, char *argv[])
+{
+  int		idO,
+  		nThr,
+  		option,
+  		ok = 1,
+		usage = 0,
+		dim = 2,
+		maxThr = 4,
+		nBad = 0,
+		verbose = 0;
+  size_t	tileSz = 64;
+  double	size = 100.0;
+  WlzObject	*dObj = NULL;
+  WlzObject	*refObj[WLZTST_ITERATEPARTITION_NOP] = {NULL};
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  const char	*opStr[WLZTST_ITERATEPARTITION_NOP] =
+		{
+		  "WlzScalarMulAdd()",
+		  "WlzGreyIncValuesInDomain()",
+		  "WlzGreySetValue()"
+		};
+  static char	optList[] = "23hn:r:t:v";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case '2':
+        dim = 2;
+	break;
+      case '3':
+        dim = 3;
+	break;
+      case 'n':
+        maxThr = atoi(optarg);
+	break;
+      case 'r':
+        size = atof(optarg);
+	break;
+      case 't':
+        tileSz = atol(optarg);
+	break;
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  if((usage == 0) &&
+     ((optind != argc) || (maxThr < 1) || (size < 8.0) ||
+      (tileSz < 2) || ((tileSz & (tileSz - 1)) != 0)))
+  {
+    usage = 1;
+  }
+  ok = !usage;
+  if(ok)
+  {
+    /* Domain within which values are incremented, inside the objects. */
+    dObj = WlzTstIteratePartitionObj(dim, size, size / 3.0, 0, &errNum);
+  }
+#ifndef _OPENMP
+  maxThr = 1;
+#endif
+  for(nThr = 1; ok && (errNum == WLZ_ERR_NONE) && (nThr <= maxThr); ++nThr)
+  {
+#ifdef _OPENMP
+    omp_set_num_threads(nThr);
+#endif
+    for(idO = 0; (errNum == WLZ_ERR_NONE) &&
+                 (idO < WLZTST_ITERATEPARTITION_NOP); ++idO)
+    {
+      int	nBad0 = 0,
+      		nBad1 = 0;
+      WlzObject	*obj[2] = {NULL},
+      		*rObj[2] = {NULL};
+
+      /* Apply the operation to objects with non-tiled and tiled values. */
+      obj[0] = WlzTstIteratePartitionObj(dim, size, size / 2.0, 0, &errNum);
+      if(errNum == WLZ_ERR_NONE)
+      {
+	obj[1] = WlzTstIteratePartitionObj(dim, size, size / 2.0, tileSz,
+					   &errNum);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+        rObj[0] = WlzTstIteratePartitionOp(idO, obj[0], dObj, &errNum);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+        rObj[1] = WlzTstIteratePartitionOp(idO, obj[1], dObj, &errNum);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+        nBad0 = WlzTstIteratePartitionCmp(rObj[0], rObj[1], &errNum);
+      }
+      /* Results with a single thread are the reference for the rest. */
+      if(errNum == WLZ_ERR_NONE)
+      {
+	if(refObj[idO] == NULL)
+	{
+	  refObj[idO] = WlzAssignObject(rObj[0], NULL);
+	}
+	else
+	{
+	  nBad1 = WlzTstIteratePartitionCmp(refObj[idO], rObj[0], &errNum);
+	}
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+	if(verbose)
+	{
+	  (void )fprintf(stderr,
+	                 "%s: %s with %d thread(s), %d tiled and %d "
+			 "reference values differ.\n",
+			 *argv, opStr[idO], nThr, nBad0, nBad1);
+	}
+	if(nBad0 + nBad1 > 0)
+	{
+	  (void )fprintf(stderr,
+	                 "%s: %s with %d thread(s) gives %d tiled and %d "
+			 "single thread values which differ.\n",
+			 *argv, opStr[idO], nThr, nBad0, nBad1);
+	}
+	nBad += nBad0 + nBad1;
+      }
+      else
+      {
+	(void )WlzStringFromErrorNum(errNum, &errMsg);
+	(void )fprintf(stderr, "%s: %s failed with %d thread(s) (%s).\n",
+		       *argv, opStr[idO], nThr, errMsg);
+      }
+      (void )WlzFreeObj(obj[0]);
+      (void )WlzFreeObj(obj[1]);
+      (void )WlzFreeObj(rObj[0]);
+      (void )WlzFreeObj(rObj[1]);
+    }
+  }
+  if(ok)
+  {
+    if((errNum != WLZ_ERR_NONE) || (nBad > 0))
+    {
+      ok = 0;
+    }
+    else
+    {
+      (void )printf("%s: %dD tiled and non-tiled values match with up to "
+		    "%d thread(s).\n",
+		    *argv, dim, maxThr);
+    }
+  }
+  for(idO = 0; idO < WLZTST_ITERATEPARTITION_NOP; ++idO)
+  {
+    (void )WlzFreeObj(refObj[idO]);
+  }
+  (void )WlzFreeObj(dObj);
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-2] [-3] [-h] [-n#] [-r#] [-t#] [-v]\n"
+    "Applies WlzScalarMulAdd(), WlzGreyIncValuesInDomain() and\n"
+    "WlzGreySetValue() to circular or spherical objects with tiled and\n"
+    "non-tiled values, using from one up to the given number of threads.\n"
+    "The results for tiled values and for each number of threads are\n"
+    "compared with those for non-tiled values using a single thread.\n"
+    "Options:\n"
+    "  -2  Use 2D objects (default).\n"
+    "  -3  Use 3D objects.\n"
+    "  -h  Prints this usage information.\n"
+    "  -n  Maximum number of threads (default 4).\n"
+    "  -r  Size of the region containing the objects (default 100).\n"
+    "  -t  Number of values in each tile, which must be an integral\n"
+    "      power of two (default 64).\n"
+    "  -v  Verbose output.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New assigned object or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Creates a circle or sphere centred in the region with
+* 		int values which increment through the object.
+* \param	dim			Dimension, 2 or 3.
+* \param	size			Size of the region.
+* \param	radius			Radius of the circle or sphere.
+* \param	tileSz			Number of values in each tile,
+* 					if zero the values are not tiled.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstIteratePartitionObj(int dim, double size,
+				double radius, size_t tileSz,
+				WlzErrorNum *dstErr)
+{
+  int		val = 1;
+  double	c;
+  WlzObject	*dObj = NULL,
+  		*gObj = NULL,
+		*tObj = NULL;
+  WlzPixelV	bgdV;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  c = size / 2.0;
+  if(dim == 2)
+  {
+    dObj = WlzMakeCircleObject(radius, c, c, &errNum);
+  }
+  else
+  {
+    dObj = WlzMakeSphereObject(WLZ_3D_DOMAINOBJ, radius, c, c, c, &errNum);
+  }
+  dObj = WlzAssignObject(dObj, NULL);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    bgdV.type = WLZ_GREY_INT;
+    bgdV.v.inv = 0;
+    gObj = WlzAssignObject(
+           WlzNewObjectValues(dObj,
+			      WlzGreyTableType(WLZ_GREY_TAB_RAGR,
+					       WLZ_GREY_INT, NULL),
+			      bgdV, 0, bgdV, &errNum), NULL);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = WlzGreySetIncValues(gObj, &val);
+  }
+  if((errNum == WLZ_ERR_NONE) && (tileSz > 0))
+  {
+    tObj = WlzMakeTiledValuesFromObj(gObj, tileSz, 1, WLZ_GREY_INT, bgdV,
+    				     &errNum);
+    (void )WlzFreeObj(gObj);
+    gObj = WlzAssignObject(tObj, NULL);
+  }
+  (void )WlzFreeObj(dObj);
+  if(errNum != WLZ_ERR_NONE)
+  {
+    (void )WlzFreeObj(gObj);
+    gObj = NULL;
+  }
+  *dstErr = errNum;
+  return(gObj);
+}
+
+/*!
+* \return	Assigned object with the result of the operation.
+* \ingroup	BinWlzTst
+* \brief	Applies the given operation to the grey valued object,
+* 		for operations which modify the values in place the
+* 		result is the given object.
+* \param	op			Operation.
+* \param	gObj			Given grey valued object.
+* \param	dObj			Domain object within which values
+* 					are incremented.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstIteratePartitionOp(WlzTstIteratePartitionOpType op,
+				WlzObject *gObj, WlzObject *dObj,
+				WlzErrorNum *dstErr)
+{
+  WlzObject	*rObj = NULL;
+  WlzPixelV	m,
+  		a;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  switch(op)
+  {
+    case WLZTST_ITERATEPARTITION_MULADD:
+      m.type = a.type = WLZ_GREY_DOUBLE;
+      m.v.dbv = 0.5;
+      a.v.dbv = -3.0;
+      rObj = WlzScalarMulAdd(gObj, m, a, WLZ_GREY_FLOAT, &errNum);
+      break;
+    case WLZTST_ITERATEPARTITION_INC:
+      errNum = WlzGreyIncValuesInDomain(gObj, dObj);
+      rObj = gObj;
+      break;
+    case WLZTST_ITERATEPARTITION_SET:
+      a.type = WLZ_GREY_INT;
+      a.v.inv = 42;
+      errNum = WlzGreySetValue(gObj, a);
+      rObj = gObj;
+      break;
+    default:
+      errNum = WLZ_ERR_PARAM_DATA;
+      break;
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    if(rObj != gObj)
+    {
+      (void )WlzFreeObj(rObj);
+    }
+    rObj = NULL;
+  }
+  *dstErr = errNum;
+  return(WlzAssignObject(rObj, NULL));
+}
+
+/*!
+* \return	Number of positions at which the objects differ.
+* \ingroup	BinWlzTst
+* \brief	Compares two grey valued domain objects at every position
+* 		within the union of their bounding boxes, counting the
+* 		positions which are within only one of the objects or at
+* 		which the grey values differ.
+* \param	obj0			First object.
+* \param	obj1			Second object.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstIteratePartitionCmp(WlzObject *obj0, WlzObject *obj1,
+				WlzErrorNum *dstErr)
+{
+  int		nBad = 0;
+  WlzIBox3	b0,
+  		b1;
+  WlzGreyValueWSpace *gVWSp0 = NULL,
+  		*gVWSp1 = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  b0 = WlzBoundingBox3I(obj0, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    b1 = WlzBoundingBox3I(obj1, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gVWSp0 = WlzGreyValueMakeWSp(obj0, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gVWSp1 = WlzGreyValueMakeWSp(obj1, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idX,
+    		idY,
+		idZ;
+
+    b0.xMin = WLZ_MIN(b0.xMin, b1.xMin);
+    b0.yMin = WLZ_MIN(b0.yMin, b1.yMin);
+    b0.zMin = WLZ_MIN(b0.zMin, b1.zMin);
+    b0.xMax = WLZ_MAX(b0.xMax, b1.xMax);
+    b0.yMax = WLZ_MAX(b0.yMax, b1.yMax);
+    b0.zMax = WLZ_MAX(b0.zMax, b1.zMax);
+    for(idZ = b0.zMin; idZ <= b0.zMax; ++idZ)
+    {
+      for(idY = b0.yMin; idY <= b0.yMax; ++idY)
+      {
+	for(idX = b0.xMin; idX <= b0.xMax; ++idX)
+	{
+	  int	in0,
+	  	in1;
+
+	  in0 = WlzInsideDomain(obj0, idZ, idY, idX, NULL);
+	  in1 = WlzInsideDomain(obj1, idZ, idY, idX, NULL);
+	  if(in0 != in1)
+	  {
+	    ++nBad;
+	  }
+	  else if(in0)
+	  {
+	    WlzPixelV	p0,
+	    		p1;
+
+	    WlzGreyValueGet(gVWSp0, idZ, idY, idX);
+	    WlzGreyValueGet(gVWSp1, idZ, idY, idX);
+	    p0.type = gVWSp0->gType;
+	    p0.v = gVWSp0->gVal[0];
+	    p1.type = gVWSp1->gType;
+	    p1.v = gVWSp1->gVal[0];
+	    (void )WlzValueConvertPixel(&p0, p0, WLZ_GREY_DOUBLE);
+	    (void )WlzValueConvertPixel(&p1, p1, WLZ_GREY_DOUBLE);
+	    if(p0.v.dbv != p1.v.dbv)
+	    {
+	      ++nBad;
+	    }
+	  }
+	}
+      }
+    }
+  }
+  WlzGreyValueFreeWSp(gVWSp0);
+  WlzGreyValueFreeWSp(gVWSp1);
+  *dstErr = errNum;
+  return(nBad);
+}
@@ -0,0 +1,560 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstMatchICP_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstMatchICP.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for the concurrent registration of contour shells
+* 		by WlzMatchICPObjs() and WlzMatchICPObjsTgt(). A target
+* 		contour with several shells is matched to source
+* 		contours in which each shell has been given its own
+* 		shift. The match points found using one thread are
+* 		compared with those found using several threads and
+* 		with those found using a single matching target for
+* 		several sources. Each match point pair is also checked
+* 		against the known shift of its shell, with the target
+* 		match point being checked against the target contour's
+* 		vertices by an exhaustive search.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <limits.h>
+#include <Wlz.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+/*!
+* \struct	_WlzTstMatchICPRes
+* \ingroup	BinWlzTst
+* \brief	Match points found by a single match.
+*/
+typedef struct _WlzTstMatchICPRes
+{
+  int		nMatch;			/*!< Number of match points. */
+  WlzVertexP	tMatch;			/*!< Target match points. */
+  WlzVertexP	sMatch;			/*!< Source match points. */
+} WlzTstMatchICPRes;
+
+static int			WlzTstMatchICPCmp(
+				  const char *prog,
+				  const char *str,
+				  WlzTstMatchICPRes *r0,
+				  WlzTstMatchICPRes *r1);
+static int			WlzTstMatchICPCheck(
+				  const char *prog,
+				  int src,
+				  WlzObject *tObj,
+				  WlzTstMatchICPRes *res);
+static WlzObject		*WlzTstMatchICPObj(
+				  int src,
+				  WlzErrorNum *dstErr);
+static WlzErrorNum		WlzTstMatchICPRun(
+				  WlzMatchICPTarget *tgt,
+				  WlzObject *tObj,
+				  int src,
+				  WlzTstMatchICPRes *res);
+static int			WlzTstMatchICPShell(
+				  int src,
+				  WlzDVertex2 p);
+static void			WlzTstMatchICPResFree(
+				  WlzTstMatchICPRes *res);
+
+/* Shell centres (x, y) and the shifts of the shells in the source contours, with
+ * the first set of shifts being for the target. */
+#define WLZTST_MATCHICP_NSHL	(4)
+#define WLZTST_MATCHICP_NSRC	(2)
+static const int WlzTstMatchICPCtr[WLZTST_MATCHICP_NSHL][2] =
+{
+  {0, 0}, {50, 0}, {0, 50}, {50, 50}
+};
+static const int WlzTstMatchICPShift[WLZTST_MATCHICP_NSRC + 1]
+				    [WLZTST_MATCHICP_NSHL][2] =
+{
+  {{0, 0},  {0, 0},   {0, 0},   {0, 0}},
+  {{3, 1},  {-2, 2},  {1, -3},  {-2, -1}},
+  {{-1, 2}, {2, 3},   {-3, -1}, {2, -2}}
+};
+
+int		main(int argc, char *argv[])
+{
+  int		idS,
+  		nThr,
+  		option,
+		ok = 1,
+		usage = 0,
+		maxThr = 4,
+		verbose = 0;
+  char		buf[64];
+  WlzObject	*tObj = NULL;
+  WlzMatchICPTarget *tgt = NULL;
+  WlzTstMatchICPRes res0[WLZTST_MATCHICP_NSRC],
+  		res1;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  static char	optList[] = "hvt:";
+
+  opterr = 0;
+  (void )memset(res0, 0, sizeof(WlzTstMatchICPRes) * WLZTST_MATCHICP_NSRC);
+  (void )memset(&res1, 0, sizeof(WlzTstMatchICPRes));
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 't':
+        if((sscanf(optarg, "%d", &maxThr) != 1) || (maxThr < 1))
+	{
+	  usage = 1;
+	}
+	break;
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0) && (optind == argc);
+  usage = !ok;
+#ifndef _OPENMP
+  maxThr = 1;
+#endif
+  if(ok)
+  {
+    tObj = WlzAssignObject(WlzTstMatchICPObj(0, &errNum), NULL);
+  }
+  /* Match each source using a single thread, checking the match points
+   * against the known shifts. */
+#ifdef _OPENMP
+  omp_set_num_threads(1);
+#endif
+  for(idS = 0; ok && (errNum == WLZ_ERR_NONE) &&
+               (idS < WLZTST_MATCHICP_NSRC); ++idS)
+  {
+    errNum = WlzTstMatchICPRun(NULL, tObj, idS + 1, res0 + idS);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      ok = WlzTstMatchICPCheck(*argv, idS + 1, tObj, res0 + idS);
+      if(verbose)
+      {
+        (void )fprintf(stderr, "%s: Source %d has %d match points.\n",
+		       *argv, idS + 1, res0[idS].nMatch);
+      }
+    }
+  }
+  /* Match with more threads, the match points must be the same. */
+  for(nThr = 2; ok && (errNum == WLZ_ERR_NONE) && (nThr <= maxThr); ++nThr)
+  {
+#ifdef _OPENMP
+    omp_set_num_threads(nThr);
+#endif
+    for(idS = 0; ok && (errNum == WLZ_ERR_NONE) &&
+                 (idS < WLZTST_MATCHICP_NSRC); ++idS)
+    {
+      errNum = WlzTstMatchICPRun(NULL, tObj, idS + 1, &res1);
+      if(errNum == WLZ_ERR_NONE)
+      {
+	(void )sprintf(buf, "source %d with %d threads", idS + 1, nThr);
+	ok = WlzTstMatchICPCmp(*argv, buf, res0 + idS, &res1);
+	if(verbose)
+	{
+	  (void )fprintf(stderr, "%s: Matched %s.\n", *argv, buf);
+	}
+      }
+      WlzTstMatchICPResFree(&res1);
+    }
+  }
+  /* Match all sources to a single matching target. */
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    tgt = WlzMatchICPTargetNew(tObj->domain.ctr, 15, &errNum);
+  }
+  for(idS = 0; ok && (errNum == WLZ_ERR_NONE) &&
+               (idS < WLZTST_MATCHICP_NSRC); ++idS)
+  {
+    errNum = WlzTstMatchICPRun(tgt, tObj, idS + 1, &res1);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      (void )sprintf(buf, "source %d with a single target", idS + 1);
+      ok = WlzTstMatchICPCmp(*argv, buf, res0 + idS, &res1);
+      if(verbose)
+      {
+	(void )fprintf(stderr, "%s: Matched %s.\n", *argv, buf);
+      }
+    }
+    WlzTstMatchICPResFree(&res1);
+  }
+  (void )WlzMatchICPTargetFree(tgt);
+  for(idS = 0; idS < WLZTST_MATCHICP_NSRC; ++idS)
+  {
+    WlzTstMatchICPResFree(res0 + idS);
+  }
+  (void )WlzFreeObj(tObj);
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to match contours (%s).\n",
+		   *argv, errMsg);
+  }
+  if(ok)
+  {
+    (void )printf("%s: Concurrently matched shells are the same as those "
+    		  "matched by a single thread.\n", *argv);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-v] [-t #]\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -v  Verbose output.\n"
+    "  -t  Maximum number of threads (default 4).\n"
+    "Tests the concurrent registration of contour shells by\n"
+    "WlzMatchICPObjs() and WlzMatchICPObjsTgt(), comparing the match\n"
+    "points found using from one up to the maximum number of threads\n"
+    "and checking them against the known shift of each shell.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New contour object or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Makes a 2D boundary contour object with a shell for each
+* 		of the shapes, which are a disc joined with an off centre
+* 		rectangle so that they have no rotational symmetry.
+* \param	src			Index of the shifts, zero for the
+* 					target.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstMatchICPObj(int src, WlzErrorNum *dstErr)
+{
+  int		idH;
+  WlzObject	*obj = NULL,
+		*cObj = NULL;
+  WlzDomain	dom;
+  WlzValues	val;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  dom.core = NULL;
+  val.core = NULL;
+  for(idH = 0; (errNum == WLZ_ERR_NONE) && (idH < WLZTST_MATCHICP_NSHL);
+       ++idH)
+  {
+    double	x,
+    		y;
+    WlzObject	*o[3] = {NULL};
+
+    x = WlzTstMatchICPCtr[idH][0] + WlzTstMatchICPShift[src][idH][0];
+    y = WlzTstMatchICPCtr[idH][1] + WlzTstMatchICPShift[src][idH][1];
+    o[0] = WlzMakeSphereObject(WLZ_2D_DOMAINOBJ, 10.0, x, y, 0.0, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      o[1] = WlzMakeCuboidObject(WLZ_2D_DOMAINOBJ, 14.0, 4.0, 0.0,
+				 x + 6.0, y + 5.0, 0.0, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      o[2] = WlzUnion2(o[0], o[1], &errNum);
+    }
+    (void )WlzFreeObj(o[0]);
+    (void )WlzFreeObj(o[1]);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if(obj)
+      {
+	o[0] = WlzUnion2(obj, o[2], &errNum);
+	(void )WlzFreeObj(obj);
+	(void )WlzFreeObj(o[2]);
+	obj = o[0];
+      }
+      else
+      {
+	obj = o[2];
+      }
+    }
+    else
+    {
+      (void )WlzFreeObj(o[2]);
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    dom.ctr = WlzContourObj(obj, WLZ_CONTOUR_MTD_BND, 0.0, 1.0, 1, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    cObj = WlzMakeMain(WLZ_CONTOUR, dom, val, NULL, NULL, &errNum);
+    if(cObj == NULL)
+    {
+      (void )WlzFreeContour(dom.ctr);
+    }
+  }
+  (void )WlzFreeObj(obj);
+  *dstErr = errNum;
+  return(cObj);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	BinWlzTst
+* \brief	Makes a new source contour and matches it to the target,
+* 		using the parameters of WlzMatchICPObj(1).
+* \param	tgt			Matching target, if NULL then
+* 					WlzMatchICPObjs() is used with the
+* 					target object.
+* \param	tObj			Target object.
+* \param	src			Index of the source shifts.
+* \param	res			Destination for the match points.
+*/
+static WlzErrorNum WlzTstMatchICPRun(WlzMatchICPTarget *tgt,
+				     WlzObject *tObj, int src,
+				     WlzTstMatchICPRes *res)
+{
+  WlzObject	*sObj;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const int	maxItr = 200,
+		minSpx = 15,
+		minSegSpx = 10,
+		brkFlg = INT_MAX,
+		matchImpNN = 7;
+  const double	delta = 0.01,
+  		maxAng = 30.0 * ALG_M_PI / 180.0,
+		maxDeform = 0.5,
+		maxDisp = 25.0,
+		matchImpThr = 1.5;
+
+  sObj = WlzAssignObject(WlzTstMatchICPObj(src, &errNum), NULL);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = (tgt)?
+	     WlzMatchICPObjsTgt(tgt, sObj, NULL,
+				&(res->nMatch), &(res->tMatch),
+				&(res->sMatch), maxItr, minSpx, minSegSpx,
+				brkFlg, maxDisp, maxAng, maxDeform,
+				matchImpNN, matchImpThr, delta):
+	     WlzMatchICPObjs(tObj, sObj, NULL,
+			     &(res->nMatch), &(res->tMatch), &(res->sMatch),
+			     maxItr, minSpx, minSegSpx, brkFlg,
+			     maxDisp, maxAng, maxDeform,
+			     matchImpNN, matchImpThr, delta);
+  }
+  (void )WlzFreeObj(sObj);
+  return(errNum);
+}
+
+/*!
+* \return	Non-zero if the match points are identical.
+* \ingroup	BinWlzTst
+* \brief	Compares two sets of match points.
+* \param	prog			Program name for messages.
+* \param	str			Description of the second set.
+* \param	r0			First (reference) match points.
+* \param	r1			Second match points.
+*/
+static int	WlzTstMatchICPCmp(const char *prog, const char *str,
+				  WlzTstMatchICPRes *r0,
+				  WlzTstMatchICPRes *r1)
+{
+  int		idM,
+  		ok;
+
+  ok = r0->nMatch == r1->nMatch;
+  for(idM = 0; ok && (idM < r0->nMatch); ++idM)
+  {
+    ok = (r0->tMatch.d2[idM].vtX == r1->tMatch.d2[idM].vtX) &&
+	 (r0->tMatch.d2[idM].vtY == r1->tMatch.d2[idM].vtY) &&
+	 (r0->sMatch.d2[idM].vtX == r1->sMatch.d2[idM].vtX) &&
+	 (r0->sMatch.d2[idM].vtY == r1->sMatch.d2[idM].vtY);
+  }
+  if(!ok)
+  {
+    (void )fprintf(stderr, "%s: The %d match points of %s differ from the "
+		   "%d found using a single thread.\n",
+		   prog, r1->nMatch, str, r0->nMatch);
+  }
+  return(ok);
+}
+
+/*!
+* \return	Non-zero if the match points are correct.
+* \ingroup	BinWlzTst
+* \brief	Checks that there are match points for every shell, that
+* 		each target match point is a vertex of the target contour
+* 		and that each pair of match points is on the same shell
+* 		and close to being related by the shift of that shell.
+* \param	prog			Program name for messages.
+* \param	src			Index of the source shifts.
+* \param	tObj			Target object.
+* \param	res			Match points.
+*/
+static int	WlzTstMatchICPCheck(const char *prog, int src,
+				    WlzObject *tObj, WlzTstMatchICPRes *res)
+{
+  int		idH,
+  		idM,
+		ok;
+  int		nShl[WLZTST_MATCHICP_NSHL] = {0};
+  WlzGMModel	*tGM;
+  const double	tol = 5.0;
+
+  tGM = tObj->domain.ctr->model;
+  ok = res->nMatch > 0;
+  for(idM = 0; ok && (idM < res->nMatch); ++idM)
+  {
+    int		idV,
+    		hS,
+		hT;
+    double	dMin;
+    WlzDVertex2	s,
+    		t,
+		u;
+    AlcVector	*vec;
+
+    s = res->sMatch.d2[idM];
+    t = res->tMatch.d2[idM];
+    /* The target match point must be on the same shell as the source
+     * match point, but may have slid along the boundary where it is
+     * straight. */
+    hS = WlzTstMatchICPShell(src, s);
+    hT = WlzTstMatchICPShell(0, t);
+    ++nShl[hS];
+    u.vtX = t.vtX - (s.vtX - WlzTstMatchICPShift[src][hS][0]);
+    u.vtY = t.vtY - (s.vtY - WlzTstMatchICPShift[src][hS][1]);
+    if((hS != hT) || (WLZ_VTX_2_LENGTH(u) > tol))
+    {
+      ok = 0;
+      (void )fprintf(stderr, "%s: Source %d match points %g,%g and %g,%g "
+		     "are not related by the shell's shift.\n",
+		     prog, src, t.vtX, t.vtY, s.vtX, s.vtY);
+    }
+    /* Search all the target vertices for the target match point. */
+    dMin = DBL_MAX;
+    vec = tGM->res.vertexG.vec;
+    for(idV = 0; ok && (idV < tGM->res.vertexG.numIdx); ++idV)
+    {
+      WlzGMVertexG2D *vG;
+
+      vG = (WlzGMVertexG2D *)AlcVectorItemGet(vec, idV);
+      if(vG->idx >= 0)
+      {
+        WLZ_VTX_2_SUB(u, t, vG->vtx);
+	dMin = WLZ_MIN(dMin, WLZ_VTX_2_SQRLEN(u));
+      }
+    }
+    if(ok && (dMin > DBL_EPSILON))
+    {
+      ok = 0;
+      (void )fprintf(stderr, "%s: Source %d target match point %g,%g is "
+		     "not a target vertex.\n",
+		     prog, src, t.vtX, t.vtY);
+    }
+  }
+  for(idH = 0; ok && (idH < WLZTST_MATCHICP_NSHL); ++idH)
+  {
+    if(nShl[idH] == 0)
+    {
+      ok = 0;
+      (void )fprintf(stderr, "%s: Source %d shell %d has no match points.\n",
+		     prog, src, idH);
+    }
+  }
+  if(res->nMatch == 0)
+  {
+    (void )fprintf(stderr, "%s: Source %d has no match points.\n",
+		   prog, src);
+  }
+  return(ok);
+}
+
+/*!
+* \return	Index of the shell.
+* \ingroup	BinWlzTst
+* \brief	Finds the shell of a contour which has the nearest
+* 		(shifted) centre to the given position.
+* \param	src			Index of the shifts, zero for the
+* 					target.
+* \param	p			Given position.
+*/
+static int	WlzTstMatchICPShell(int src, WlzDVertex2 p)
+{
+  int		idH,
+  		idS = 0;
+  double	d,
+  		dMin = DBL_MAX;
+  WlzDVertex2	u;
+
+  for(idH = 0; idH < WLZTST_MATCHICP_NSHL; ++idH)
+  {
+    u.vtX = p.vtX -
+	    (WlzTstMatchICPCtr[idH][0] + WlzTstMatchICPShift[src][idH][0]);
+    u.vtY = p.vtY -
+	    (WlzTstMatchICPCtr[idH][1] + WlzTstMatchICPShift[src][idH][1]);
+    d = WLZ_VTX_2_SQRLEN(u);
+    if(d < dMin)
+    {
+      dMin = d;
+      idS = idH;
+    }
+  }
+  return(idS);
+}
+
+/*!
+* \ingroup	BinWlzTst
+* \brief	Frees the match points.
+* \param	res			Match points.
+*/
+static void	WlzTstMatchICPResFree(WlzTstMatchICPRes *res)
+{
+  AlcFree(res->tMatch.v);
+  AlcFree(res->sMatch.v);
+  (void )memset(res, 0, sizeof(WlzTstMatchICPRes));
+}
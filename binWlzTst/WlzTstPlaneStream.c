@@ -0,0 +1,627 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstPlaneStream_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstPlaneStream.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for plane streams. Objects with and without values
+* 		and with empty planes are read one plane at a time and
+* 		written one plane at a time, both with the plane domains
+* 		written directly to the output file and with them
+* 		spooled, and with and without compression. The objects
+* 		read back are compared with the originals. A truncated
+* 		file is checked to give an error when its property list
+* 		is read.
+* \ingroup	BinWlzTst
+*/
+#include <stdio.h>
+#include <string.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char     *optarg;
+extern int      optind,
+		opterr,
+		optopt;
+
+static WlzObject		*WlzTstPlaneStreamMakeObj(
+				  int values,
+				  WlzErrorNum *dstErr);
+static WlzErrorNum		WlzTstPlaneStreamCopy(
+				  FILE *inFP,
+				  FILE *outFP,
+				  int known,
+				  WlzObject *obj,
+				  int *dstDirect);
+static int			WlzTstPlaneStreamCmpObj(
+				  WlzObject *obj0,
+				  WlzObject *obj1,
+				  WlzErrorNum *dstErr);
+static FILE			*WlzTstPlaneStreamWrite(
+				  WlzObject *obj,
+				  WlzErrorNum *dstErr);
+
+int		main(int argc, char *argv[])
+{
+  int		idV,
+  		idM,
+		option,
+		ok = 1,
+		usage = 0,
+		verbose = 0;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  const char	*modeStr[4] =
+  		{
+		  "direct", "spooled", "applied", "applied compressed"
+		};
+  static char	optList[] = "hv";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0) && (optind == argc);
+  usage = !ok;
+  for(idV = 0; ok && (idV < 2); ++idV)
+  {
+    WlzObject	*obj = NULL;
+
+    obj = WlzAssignObject(WlzTstPlaneStreamMakeObj(idV, &errNum), NULL);
+    for(idM = 0; ok && (errNum == WLZ_ERR_NONE) && (idM < 4); ++idM)
+    {
+      int	direct = -1;
+      FILE	*inFP = NULL,
+      		*outFP = NULL;
+      WlzObject	*rObj = NULL;
+
+      inFP = WlzTstPlaneStreamWrite(obj, &errNum);
+      if(errNum == WLZ_ERR_NONE)
+      {
+        if((outFP = tmpfile()) == NULL)
+	{
+	  errNum = WLZ_ERR_FILE_OPEN;
+	}
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+        switch(idM)
+	{
+	  case 0:
+	    errNum = WlzTstPlaneStreamCopy(inFP, outFP, 1, obj, &direct);
+	    ok = (direct == 1);
+	    break;
+	  case 1:
+	    errNum = WlzTstPlaneStreamCopy(inFP, outFP, 0, obj, &direct);
+	    ok = (direct == 0);
+	    break;
+	  default:
+	    errNum = WlzPlaneStreamApply(inFP, outFP, NULL, NULL, NULL,
+	    			(idM == 2)? WLZ_IOCMP_NONE: WLZ_IOCMP_RLE);
+	    break;
+	}
+	if(!ok)
+	{
+	  (void )fprintf(stderr, "%s: Plane stream was not written %s.\n",
+	  		 *argv, modeStr[idM]);
+	}
+      }
+      if(ok && (errNum == WLZ_ERR_NONE))
+      {
+        if(fseek(outFP, 0, SEEK_SET) != 0)
+	{
+	  errNum = WLZ_ERR_READ_INCOMPLETE;
+	}
+	else
+	{
+	  rObj = WlzAssignObject(WlzReadObj(outFP, &errNum), NULL);
+	}
+      }
+      if(ok && (errNum == WLZ_ERR_NONE))
+      {
+        ok = WlzTstPlaneStreamCmpObj(obj, rObj, &errNum);
+	if(!ok)
+	{
+	  (void )fprintf(stderr,
+	  		 "%s: Object %s values differs after being %s.\n",
+			 *argv, (idV)? "with": "without", modeStr[idM]);
+	}
+      }
+      if(verbose)
+      {
+        (void )fprintf(stderr, "%s: object %s values %s %s\n",
+		       *argv, (idV)? "with": "without", modeStr[idM],
+		       (ok && (errNum == WLZ_ERR_NONE))? "ok": "failed");
+      }
+      if(inFP)
+      {
+        (void )fclose(inFP);
+      }
+      if(outFP)
+      {
+        (void )fclose(outFP);
+      }
+      (void )WlzFreeObj(rObj);
+    }
+    if(ok && (errNum == WLZ_ERR_NONE))
+    {
+      size_t	sz;
+      FILE	*inFP = NULL,
+      		*trFP = NULL;
+      char	*buf = NULL;
+      WlzPlaneStream *rS = NULL;
+
+      /* Truncate the file in its property list and check that reading
+       * the last plane fails. */
+      inFP = WlzTstPlaneStreamWrite(obj, &errNum);
+      if(errNum == WLZ_ERR_NONE)
+      {
+        if((fseek(inFP, 0, SEEK_END) != 0) ||
+	   ((sz = (size_t )ftell(inFP)) < 2) ||
+	   (fseek(inFP, 0, SEEK_SET) != 0))
+	{
+	  errNum = WLZ_ERR_READ_INCOMPLETE;
+	}
+	else if(((buf = (char *)AlcMalloc(sz)) == NULL) ||
+	        ((trFP = tmpfile()) == NULL))
+	{
+	  errNum = WLZ_ERR_MEM_ALLOC;
+	}
+	else if((fread(buf, 1, sz, inFP) != sz) ||
+	        (fwrite(buf, 1, sz - 2, trFP) != sz - 2) ||
+		(fseek(trFP, 0, SEEK_SET) != 0))
+	{
+	  errNum = WLZ_ERR_WRITE_INCOMPLETE;
+	}
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+	WlzErrorNum errNum2 = WLZ_ERR_NONE;
+
+        rS = WlzPlaneStreamReadOpen(trFP, &errNum);
+	while(errNum2 == WLZ_ERR_NONE)
+	{
+	  (void )WlzFreeObj(WlzPlaneStreamReadPlane(rS, &errNum2));
+	}
+	if(errNum2 == WLZ_ERR_EOO)
+	{
+	  ok = 0;
+	  (void )fprintf(stderr,
+	                 "%s: Truncated property list not detected.\n",
+			 *argv);
+	}
+	else if(verbose)
+	{
+	  (void )WlzStringFromErrorNum(errNum2, &errMsg);
+	  (void )fprintf(stderr, "%s: object %s values truncated %s\n",
+	                 *argv, (idV)? "with": "without", errMsg);
+	}
+      }
+      if(rS)
+      {
+        (void )WlzPlaneStreamFree(rS);
+      }
+      if(inFP)
+      {
+        (void )fclose(inFP);
+      }
+      if(trFP)
+      {
+        (void )fclose(trFP);
+      }
+      AlcFree(buf);
+    }
+    (void )WlzFreeObj(obj);
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to test plane streams (%s).\n",
+		   *argv, errMsg);
+  }
+  if(ok)
+  {
+    (void )printf("%s: Objects written through plane streams match the "
+    		  "objects read.\n", *argv);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-v]\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -v  Verbose output.\n"
+    "Tests plane streams by reading 3D objects, with and without values\n"
+    "and with empty planes, one plane at a time and writing them one\n"
+    "plane at a time, with the plane domains written directly to the\n"
+    "output file and spooled and with and without compression. The\n"
+    "objects read back are compared with the originals and a file\n"
+    "truncated in its property list is checked to give an error.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New 3D object or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Makes a 3D object which is the union of two balls with
+* 		empty planes between them, with a name property and, if
+* 		required, with int values.
+* \param	values			Object has values if non-zero.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstPlaneStreamMakeObj(int values, WlzErrorNum *dstErr)
+{
+  WlzObject	*obj = NULL,
+  		*uObj = NULL;
+  WlzObject	*sObj[2] = {NULL, NULL};
+  WlzPixelV	bgdV;
+  WlzProperty	prop;
+  WlzValues	val;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  val.core = NULL;
+  prop.core = NULL;
+  bgdV.type = WLZ_GREY_INT;
+  bgdV.v.inv = 7;
+  sObj[0] = WlzAssignObject(
+  	    WlzMakeSphereObject(WLZ_3D_DOMAINOBJ, 12.0, 3.0, -5.0, 0.0,
+  	                        &errNum), NULL);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    sObj[1] = WlzAssignObject(
+              WlzMakeSphereObject(WLZ_3D_DOMAINOBJ, 9.0, 20.0, 4.0, 40.0,
+	                          &errNum), NULL);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    uObj = WlzAssignObject(WlzUnion2(sObj[0], sObj[1], &errNum), NULL);
+  }
+  if((errNum == WLZ_ERR_NONE) && values)
+  {
+    val.vox = WlzNewValuesVox(uObj,
+                              WlzGreyTableType(WLZ_GREY_TAB_RAGR,
+			                       WLZ_GREY_INT, NULL),
+			      bgdV, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    obj = WlzMakeMain(WLZ_3D_DOMAINOBJ, uObj->domain, val, NULL, NULL,
+    		      &errNum);
+  }
+  else if(val.core)
+  {
+    (void )WlzFreeValues(val);
+  }
+  if((errNum == WLZ_ERR_NONE) && values)
+  {
+    int		idP,
+    		nP;
+    WlzPlaneDomain *pDom;
+
+    pDom = obj->domain.p;
+    nP = pDom->lastpl - pDom->plane1 + 1;
+    for(idP = 0; (errNum == WLZ_ERR_NONE) && (idP < nP); ++idP)
+    {
+      if(pDom->domains[idP].core)
+      {
+	WlzObject *pObj;
+	WlzIntervalWSpace iWSp;
+	WlzGreyWSpace gWSp;
+
+	pObj = WlzMakeMain(WLZ_2D_DOMAINOBJ, pDom->domains[idP],
+			   obj->values.vox->values[idP], NULL, NULL,
+			   &errNum);
+	if((errNum == WLZ_ERR_NONE) &&
+	   ((errNum = WlzInitGreyScan(pObj, &iWSp, &gWSp)) == WLZ_ERR_NONE))
+	{
+	  while((errNum = WlzNextGreyInterval(&iWSp)) == WLZ_ERR_NONE)
+	  {
+	    int	idK;
+
+	    for(idK = 0; idK <= iWSp.rgtpos - iWSp.lftpos; ++idK)
+	    {
+	      gWSp.u_grintptr.inp[idK] = ((iWSp.lftpos + idK) * 3) +
+	                                 (iWSp.linpos * 101) + (idP * 10007);
+	    }
+	  }
+	  if(errNum == WLZ_ERR_EOO)
+	  {
+	    errNum = WLZ_ERR_NONE;
+	  }
+	}
+	(void )WlzFreeObj(pObj);
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((obj->plist = WlzAssignPropertyList(
+		     WlzMakePropertyList(&errNum), NULL)) != NULL)
+    {
+      prop.name = WlzMakeNameProperty("plane stream test", &errNum);
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    (void )WlzAssignProperty(prop, NULL);
+    if(AlcDLPListEntryAppend(obj->plist->list, NULL, (void *)(prop.core),
+			     WlzFreePropertyListEntry) != ALC_ER_NONE)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  (void )WlzFreeObj(sObj[0]);
+  (void )WlzFreeObj(sObj[1]);
+  (void )WlzFreeObj(uObj);
+  if((errNum != WLZ_ERR_NONE) && obj)
+  {
+    (void )WlzFreeObj(obj);
+    obj = NULL;
+  }
+  *dstErr = errNum;
+  return(obj);
+}
+
+/*!
+* \return	Temporary file positioned at its start or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Writes the given object to a temporary file.
+* \param	obj			Given object.
+* \param	dstErr			Destination error pointer.
+*/
+static FILE	*WlzTstPlaneStreamWrite(WlzObject *obj, WlzErrorNum *dstErr)
+{
+  FILE		*fP;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((fP = tmpfile()) == NULL)
+  {
+    errNum = WLZ_ERR_FILE_OPEN;
+  }
+  else if(((errNum = WlzWriteObj(fP, obj)) == WLZ_ERR_NONE) &&
+          (fseek(fP, 0, SEEK_SET) != 0))
+  {
+    errNum = WLZ_ERR_WRITE_INCOMPLETE;
+  }
+  if((errNum != WLZ_ERR_NONE) && fP)
+  {
+    (void )fclose(fP);
+    fP = NULL;
+  }
+  *dstErr = errNum;
+  return(fP);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	BinWlzTst
+* \brief	Copies a 3D object from one file to another using plane
+* 		streams, comparing each plane read with the plane of the
+* 		given object.
+* \param	inFP			Input file.
+* \param	outFP			Output file.
+* \param	known			If non-zero the last plane is given
+* 					when the output stream is opened.
+* \param	obj			Object in the input file.
+* \param	dstDirect		Destination pointer for non-zero if
+* 					the plane domains were written
+* 					directly to the output file, set to
+* 					-1 if a plane differs.
+*/
+static WlzErrorNum WlzTstPlaneStreamCopy(FILE *inFP, FILE *outFP, int known,
+					 WlzObject *obj, int *dstDirect)
+{
+  int		direct = -1;
+  WlzDVertex3	voxSz;
+  WlzPlaneStream *rS = NULL,
+  		*wS = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  rS = WlzPlaneStreamReadOpen(inFP, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    voxSz.vtX = rS->voxelSz[0];
+    voxSz.vtY = rS->voxelSz[1];
+    voxSz.vtZ = rS->voxelSz[2];
+    wS = WlzPlaneStreamWriteOpen(outFP, NULL, rS->plane1,
+                                 (known)? rS->lastpl: rS->plane1 - 1,
+				 voxSz, WLZ_IOCMP_NONE, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    direct = wS->hdrOff >= 0;
+  }
+  while(errNum == WLZ_ERR_NONE)
+  {
+    int		pl,
+    		idP;
+    WlzObject	*pObj = NULL,
+    		*oObj = NULL;
+    WlzPlaneDomain *pDom;
+
+    pl = rS->plane;
+    pObj = WlzAssignObject(WlzPlaneStreamReadPlane(rS, &errNum), NULL);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      WlzValues	val;
+
+      pDom = obj->domain.p;
+      idP = pl - pDom->plane1;
+      val.core = (obj->values.core)? obj->values.vox->values[idP].core: NULL;
+      if(pDom->domains[idP].core == NULL)
+      {
+        oObj = WlzMakeEmpty(&errNum);
+      }
+      else
+      {
+	oObj = WlzMakeMain(WLZ_2D_DOMAINOBJ, pDom->domains[idP], val,
+			   NULL, NULL, &errNum);
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      (void )WlzAssignObject(oObj, NULL);
+      if(!WlzTstPlaneStreamCmpObj(oObj, pObj, &errNum))
+      {
+        direct = -1;
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = WlzPlaneStreamWritePlane(wS, pObj);
+    }
+    (void )WlzFreeObj(oObj);
+    (void )WlzFreeObj(pObj);
+  }
+  if((errNum == WLZ_ERR_EOO) && (wS != NULL))
+  {
+    wS->plist = WlzAssignPropertyList(rS->plist, NULL);
+    errNum = WlzPlaneStreamWriteClose(wS);
+  }
+  if(rS)
+  {
+    (void )WlzPlaneStreamFree(rS);
+  }
+  if(wS)
+  {
+    (void )WlzPlaneStreamFree(wS);
+  }
+  *dstDirect = direct;
+  return(errNum);
+}
+
+/*!
+* \return	Non-zero if the objects are equal.
+* \ingroup	BinWlzTst
+* \brief	Compares the types, bounding boxes, domains, values and
+* 		name properties of two 2D or 3D domain objects or empty
+* 		objects.
+* \param	obj0			First object.
+* \param	obj1			Second object.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstPlaneStreamCmpObj(WlzObject *obj0, WlzObject *obj1,
+					WlzErrorNum *dstErr)
+{
+  int		eq;
+  WlzIBox3	box[2];
+  WlzGreyValueWSpace *gVWSp[2] = {NULL, NULL};
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  eq = (obj0->type == obj1->type) &&
+       ((obj0->values.core == NULL) == (obj1->values.core == NULL)) &&
+       ((obj0->plist == NULL) == (obj1->plist == NULL));
+  if(eq && (obj0->type != WLZ_EMPTY_OBJ))
+  {
+    box[0] = WlzBoundingBox3I(obj0, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      box[1] = WlzBoundingBox3I(obj1, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      eq = (box[0].xMin == box[1].xMin) && (box[0].xMax == box[1].xMax) &&
+           (box[0].yMin == box[1].yMin) && (box[0].yMax == box[1].yMax) &&
+           (box[0].zMin == box[1].zMin) && (box[0].zMax == box[1].zMax);
+    }
+    if((errNum == WLZ_ERR_NONE) && (obj0->type == WLZ_3D_DOMAINOBJ))
+    {
+      eq = eq &&
+           (obj0->domain.p->plane1 == obj1->domain.p->plane1) &&
+           (obj0->domain.p->lastpl == obj1->domain.p->lastpl);
+    }
+  }
+  if(eq && (errNum == WLZ_ERR_NONE) && obj0->plist)
+  {
+    WlzProperty	prop[2];
+
+    prop[0] = WlzGetProperty(obj0->plist->list, WLZ_PROPERTY_NAME, NULL);
+    prop[1] = WlzGetProperty(obj1->plist->list, WLZ_PROPERTY_NAME, NULL);
+    eq = (prop[0].core != NULL) && (prop[1].core != NULL) &&
+         (strcmp(prop[0].name->name, prop[1].name->name) == 0);
+  }
+  if(eq && (errNum == WLZ_ERR_NONE) && obj0->values.core)
+  {
+    gVWSp[0] = WlzGreyValueMakeWSp(obj0, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      gVWSp[1] = WlzGreyValueMakeWSp(obj1, &errNum);
+    }
+  }
+  if(eq && (errNum == WLZ_ERR_NONE) && (obj0->type != WLZ_EMPTY_OBJ))
+  {
+    int		idP,
+    		idL,
+		idK;
+
+    for(idP = box[0].zMin; eq && (idP <= box[0].zMax); ++idP)
+    {
+      for(idL = box[0].yMin; eq && (idL <= box[0].yMax); ++idL)
+      {
+	for(idK = box[0].xMin; eq && (idK <= box[0].xMax); ++idK)
+	{
+	  int	in;
+
+	  in = WlzInsideDomain(obj0, idP, idL, idK, NULL);
+	  eq = (in != 0) == (WlzInsideDomain(obj1, idP, idL, idK, NULL) != 0);
+	  if(eq && in && gVWSp[0])
+	  {
+	    WlzGreyValueGet(gVWSp[0], idP, idL, idK);
+	    WlzGreyValueGet(gVWSp[1], idP, idL, idK);
+	    eq = gVWSp[0]->gVal[0].inv == gVWSp[1]->gVal[0].inv;
+	  }
+	}
+      }
+    }
+  }
+  WlzGreyValueFreeWSp(gVWSp[0]);
+  WlzGreyValueFreeWSp(gVWSp[1]);
+  *dstErr = errNum;
+  return(eq);
+}
@@ -0,0 +1,442 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstProjectRayCast_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstProjectRayCast.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for WlzProjectObjRayCast(). A 3D sphere with a
+* 		hole and integer or floating point values is projected
+* 		by ray casting along each of the axes, with and without
+* 		a projection depth, and the maximum, mean and sum
+* 		projections are compared with those found by simply
+* 		stepping along the rays a voxel at a time. The views
+* 		are axis aligned with rays through voxel centres and
+* 		the depth limits lie on voxel faces, so every voxel
+* 		visited has unit path length.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+static WlzObject		*WlzTstProjectRayCastMakeObj(
+				  WlzGreyType gType,
+				  WlzErrorNum *dstErr);
+static int			WlzTstProjectRayCastCmp(
+				  WlzObject *obj,
+				  WlzThreeDViewStruct *vStr,
+				  WlzProjectRayMode mode,
+				  double depth,
+				  WlzObject *prjObj,
+				  int *dstNHit,
+				  WlzErrorNum *dstErr);
+
+int		main(int argc, char *argv[])
+{
+  int		idG,
+  		idV,
+		idD,
+		idM,
+		nHit,
+		option,
+		ok = 1,
+		usage = 0,
+		verbose = 0;
+  WlzObject	*obj = NULL,
+  		*prjObj = NULL;
+  WlzThreeDViewStruct *vStr = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  const int	nView = 5;
+  const double	depths[2] = {0.0, 3.5};
+  /* Euler angles (theta, phi, zeta) in degrees of axis aligned views. */
+  const double	views[5][3] = {{  0.0,   0.0,  0.0},
+  			       {  0.0, 180.0,  0.0},
+			       {  0.0,  90.0,  0.0},
+			       { 90.0,  90.0,  0.0},
+			       {180.0,  90.0, 90.0}};
+  const WlzGreyType gTypes[2] = {WLZ_GREY_INT, WLZ_GREY_FLOAT};
+  const WlzProjectRayMode modes[3] = {WLZ_PROJECT_RAY_MODE_MIP,
+  				      WLZ_PROJECT_RAY_MODE_MEAN,
+				      WLZ_PROJECT_RAY_MODE_SUM};
+  const char	*modeStr[3] = {"maximum", "mean", "sum"};
+  static char	optList[] = "hv";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0) && (optind == argc);
+  usage = !ok;
+  for(idG = 0; ok && (errNum == WLZ_ERR_NONE) && (idG < 2); ++idG)
+  {
+    obj = WlzAssignObject(
+    	  WlzTstProjectRayCastMakeObj(gTypes[idG], &errNum), NULL);
+    for(idV = 0; ok && (errNum == WLZ_ERR_NONE) && (idV < nView); ++idV)
+    {
+      vStr = WlzMake3DViewStruct(WLZ_3D_VIEW_STRUCT, &errNum);
+      if(errNum == WLZ_ERR_NONE)
+      {
+	vStr->theta = views[idV][0] * WLZ_M_PI / 180.0;
+	vStr->phi = views[idV][1] * WLZ_M_PI / 180.0;
+	vStr->zeta = views[idV][2] * WLZ_M_PI / 180.0;
+	vStr->dist = 2.0;
+	vStr->fixed.vtX = 3.0;
+	vStr->fixed.vtY = -2.0;
+	vStr->fixed.vtZ = 5.0;
+	vStr->view_mode = WLZ_ZETA_MODE;
+	vStr->scale = 1.0;
+	vStr->voxelRescaleFlg = 0;
+	errNum = WlzInit3DViewStruct(vStr, obj);
+      }
+      for(idD = 0; ok && (errNum == WLZ_ERR_NONE) && (idD < 2); ++idD)
+      {
+	for(idM = 0; ok && (errNum == WLZ_ERR_NONE) && (idM < 3); ++idM)
+	{
+	  prjObj = WlzAssignObject(
+	  	   WlzProjectObjRayCast(obj, vStr, modes[idM], depths[idD],
+		   			0.0, 0.0, 0.0, &errNum), NULL);
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    ok = WlzTstProjectRayCastCmp(obj, vStr, modes[idM], depths[idD],
+	    				 prjObj, &nHit, &errNum);
+	  }
+	  if((errNum == WLZ_ERR_NONE) && (verbose || !ok))
+	  {
+	    (void )fprintf(stderr,
+	    		   "%s: %s %s projection, view %g,%g,%g, depth %g, "
+			   "%d rays hit %s.\n",
+			   *argv, (idG)? "float": "int", modeStr[idM],
+			   views[idV][0], views[idV][1], views[idV][2],
+			   depths[idD], nHit,
+			   (ok)? "ok": "differs from the simple projection");
+	  }
+	  (void )WlzFreeObj(prjObj);
+	  prjObj = NULL;
+	}
+      }
+      (void )WlzFree3DViewStruct(vStr);
+      vStr = NULL;
+    }
+    (void )WlzFreeObj(obj);
+    obj = NULL;
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to test ray cast projection (%s).\n",
+		   *argv, errMsg);
+  }
+  if(ok)
+  {
+    (void )printf("%s: Ray cast projections match simple projections.\n",
+    		  *argv);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-v]\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -v  Verbose output.\n"
+    "Tests WlzProjectObjRayCast() by comparing axis aligned maximum,\n"
+    "mean and sum projections of a 3D object, with and without a\n"
+    "projection depth, with those found by stepping along the rays a\n"
+    "voxel at a time.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New object or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Makes the test object, a sphere with an off centre hole
+* 		and values which vary along each of the axes.
+* \param	gType			Grey type, int or float.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstProjectRayCastMakeObj(WlzGreyType gType,
+					      WlzErrorNum *dstErr)
+{
+  WlzObjectType	vType;
+  WlzIBox3	box;
+  WlzPixelV	bgdV;
+  WlzObject	*sObj = NULL,
+  		*hObj = NULL,
+		*dObj = NULL,
+		*obj = NULL;
+  WlzGreyValueWSpace *gVWSp = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  bgdV.type = WLZ_GREY_INT;
+  bgdV.v.inv = 0;
+  sObj = WlzAssignObject(
+	 WlzMakeSphereObject(WLZ_3D_DOMAINOBJ, 9.0, 4.0, 2.0, 6.0, &errNum),
+	 NULL);
+  /* A hole gives rays which leave and reenter the domain. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    hObj = WlzAssignObject(
+	   WlzMakeSphereObject(WLZ_3D_DOMAINOBJ, 3.0, 6.0, 2.0, 6.0, &errNum),
+	   NULL);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    dObj = WlzAssignObject(WlzDiffDomain(sObj, hObj, &errNum), NULL);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    vType = WlzGreyTableType(WLZ_GREY_TAB_RAGR, gType, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    obj = WlzNewObjectValues(dObj, vType, bgdV, 0, bgdV, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    box = WlzBoundingBox3I(obj, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gVWSp = WlzGreyValueMakeWSp(obj, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idP,
+		idL,
+		idK,
+		val;
+
+    for(idP = box.zMin; idP <= box.zMax; ++idP)
+    {
+      for(idL = box.yMin; idL <= box.yMax; ++idL)
+      {
+	for(idK = box.xMin; idK <= box.xMax; ++idK)
+	{
+	  if(WlzInsideDomain(obj, idP, idL, idK, NULL))
+	  {
+	    val = (idK * 7) + (idL * 13) + (idP * 3) + 400;
+	    WlzGreyValueGet(gVWSp, idP, idL, idK);
+	    if(gType == WLZ_GREY_INT)
+	    {
+	      *(gVWSp->gPtr[0].inp) = val;
+	    }
+	    else
+	    {
+	      *(gVWSp->gPtr[0].flp) = val + 0.25f;
+	    }
+	  }
+	}
+      }
+    }
+  }
+  WlzGreyValueFreeWSp(gVWSp);
+  (void )WlzFreeObj(sObj);
+  (void )WlzFreeObj(hObj);
+  (void )WlzFreeObj(dObj);
+  if((errNum != WLZ_ERR_NONE) && (obj != NULL))
+  {
+    (void )WlzFreeObj(obj);
+    obj = NULL;
+  }
+  *dstErr = errNum;
+  return(obj);
+}
+
+/*!
+* \return	Non-zero if the projection matches the simple projection.
+* \ingroup	BinWlzTst
+* \brief	Projects the given object by stepping along each ray from
+* 		the view's projection plane a voxel at a time and
+* 		compares the domain and values with those of the given
+* 		ray cast projection. The view must be axis aligned with
+* 		integer fixed point and distance.
+* \param	obj			Given 3D object.
+* \param	vStr			Initialised view structure.
+* \param	mode			Projection mode.
+* \param	depth			Projection depth, no limit if zero.
+* \param	prjObj			Ray cast projection.
+* \param	dstNHit			Destination pointer for the number of
+* 					rays which hit the object.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstProjectRayCastCmp(WlzObject *obj,
+					WlzThreeDViewStruct *vStr,
+					WlzProjectRayMode mode,
+					double depth,
+					WlzObject *prjObj,
+					int *dstNHit,
+					WlzErrorNum *dstErr)
+{
+  int		ok = 1,
+  		nHit = 0;
+  WlzIBox3	prjBox;
+  WlzAffineTransform *invTr = NULL;
+  WlzGreyValueWSpace *gVWSp = NULL,
+  		*pVWSp = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const double	eps = 1.0e-4;
+
+  invTr = WlzAffineTransformInverse(vStr->trans, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gVWSp = WlzGreyValueMakeWSp(obj, &errNum);
+  }
+  if((errNum == WLZ_ERR_NONE) && (prjObj->type == WLZ_2D_DOMAINOBJ))
+  {
+    pVWSp = WlzGreyValueMakeWSp(prjObj, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    prjBox.xMin = WLZ_NINT(vStr->minvals.vtX) - 1;
+    prjBox.yMin = WLZ_NINT(vStr->minvals.vtY) - 1;
+    prjBox.zMin = (int )floor(vStr->minvals.vtZ) - 1;
+    prjBox.xMax = WLZ_NINT(vStr->maxvals.vtX) + 1;
+    prjBox.yMax = WLZ_NINT(vStr->maxvals.vtY) + 1;
+    prjBox.zMax = (int )ceil(vStr->maxvals.vtZ) + 1;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		u,
+    		v,
+		w,
+		n,
+		inside;
+    double	val,
+    		sum,
+		max,
+		prjVal;
+    WlzIVertex3	p;
+    double	**m;
+
+    m = invTr->mat;
+    for(v = prjBox.yMin; ok && (v <= prjBox.yMax); ++v)
+    {
+      for(u = prjBox.xMin; ok && (u <= prjBox.xMax); ++u)
+      {
+        n = 0;
+	sum = 0.0;
+	max = -DBL_MAX;
+	for(w = prjBox.zMin; w <= prjBox.zMax; ++w)
+	{
+	  if((depth < DBL_EPSILON) || (fabs(w - vStr->dist) <= depth))
+	  {
+	    /* Rays pass through voxel centres, so round away any error in
+	     * the inverse view transform. */
+	    p.vtX = WLZ_NINT((m[0][0] * u) + (m[0][1] * v) + (m[0][2] * w) +
+	    		     m[0][3]);
+	    p.vtY = WLZ_NINT((m[1][0] * u) + (m[1][1] * v) + (m[1][2] * w) +
+	    		     m[1][3]);
+	    p.vtZ = WLZ_NINT((m[2][0] * u) + (m[2][1] * v) + (m[2][2] * w) +
+	    		     m[2][3]);
+	    if(WlzInsideDomain(obj, p.vtZ, p.vtY, p.vtX, NULL))
+	    {
+	      WlzGreyValueGet(gVWSp, p.vtZ, p.vtY, p.vtX);
+	      val = (gVWSp->gType == WLZ_GREY_INT)? gVWSp->gVal[0].inv:
+	      					    gVWSp->gVal[0].flv;
+	      ++n;
+	      sum += val;
+	      max = WLZ_MAX(max, val);
+	    }
+	  }
+	}
+	inside = (pVWSp != NULL) && WlzInsideDomain(prjObj, 0, v, u, NULL);
+	if(inside != (n > 0))
+	{
+	  ok = 0;
+	  (void )fprintf(stderr,
+	  		 "WlzTstProjectRayCastCmp: ray (%d,%d) %s the object "
+			 "but is %s the projection.\n",
+			 u, v, (n > 0)? "hits": "misses",
+			 (inside)? "inside": "outside");
+	}
+	else if(n > 0)
+	{
+	  ++nHit;
+	  switch(mode)
+	  {
+	    case WLZ_PROJECT_RAY_MODE_MIP:
+	      val = max;
+	      break;
+	    case WLZ_PROJECT_RAY_MODE_MEAN:
+	      val = sum / n;
+	      break;
+	    default:
+	      val = sum;
+	      break;
+	  }
+	  WlzGreyValueGet(pVWSp, 0, v, u);
+	  prjVal = pVWSp->gVal[0].flv;
+	  if(fabs(prjVal - val) > eps * WLZ_MAX(1.0, fabs(val)))
+	  {
+	    ok = 0;
+	    (void )fprintf(stderr,
+	    		   "WlzTstProjectRayCastCmp: ray (%d,%d) has value "
+			   "%g but should have %g.\n",
+			   u, v, prjVal, val);
+	  }
+	}
+      }
+    }
+  }
+  WlzGreyValueFreeWSp(gVWSp);
+  WlzGreyValueFreeWSp(pVWSp);
+  (void )WlzFreeAffineTransform(invTr);
+  *dstNHit = nHit;
+  *dstErr = errNum;
+  return(ok);
+}
@@ -0,0 +1,522 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstReadObjMapped_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstReadObjMapped.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for WlzReadObjMapped(). Objects with rectangular
+* 		value tables of several grey types, including a 3D
+* 		object and a compound object, are written to files and
+* 		read back by WlzReadObj() and by WlzReadObjMapped() with
+* 		both copy on write and read only mappings. The values
+* 		read are compared and the values of a copy on write
+* 		object are modified to check that neither the file nor
+* 		another object mapped from it is changed.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+static WlzObject		*WlzTstReadObjMappedMakeObj(
+				  WlzGreyType gType,
+				  int dim,
+				  WlzErrorNum *dstErr);
+static int			WlzTstReadObjMappedCmpObj(
+				  WlzObject *obj0,
+				  WlzObject *obj1,
+				  WlzErrorNum *dstErr);
+static WlzErrorNum		WlzTstReadObjMappedSetObj(
+				  WlzObject *obj,
+				  int inc);
+
+int		main(int argc, char *argv[])
+{
+  int		idO,
+		option,
+		ok = 1,
+		usage = 0,
+		verbose = 0;
+  char		*dir = NULL,
+		*fStr = NULL;
+  WlzObject	*obj = NULL;
+  WlzObject	*rObj[4] = {NULL};
+  FILE		*fP = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  const int	nObj = 7;
+  const WlzGreyType gTypes[7] = {WLZ_GREY_UBYTE, WLZ_GREY_SHORT,
+  				 WLZ_GREY_INT, WLZ_GREY_RGBA,
+				 WLZ_GREY_FLOAT, WLZ_GREY_SHORT,
+				 WLZ_GREY_INT};
+  const int	dims[7] = {2, 2, 2, 2, 2, 3, 0};
+  static char	optList[] = "hv";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0) && (optind == argc);
+  usage = !ok;
+  if(ok)
+  {
+    if(((dir = AlcStrDup("/tmp/WlzTstReadObjMappedXXXXXX")) == NULL) ||
+       (mkdtemp(dir) == NULL))
+    {
+      errNum = WLZ_ERR_WRITE_EOF;
+    }
+    else if((fStr = (char *)AlcMalloc(strlen(dir) + 32)) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      (void )sprintf(fStr, "%s/obj.wlz", dir);
+    }
+  }
+  for(idO = 0; ok && (errNum == WLZ_ERR_NONE) && (idO < nObj); ++idO)
+  {
+    int		idR;
+
+    obj = WlzAssignObject(
+          WlzTstReadObjMappedMakeObj(gTypes[idO], dims[idO], &errNum), NULL);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if((fP = fopen(fStr, "wb")) == NULL)
+      {
+        errNum = WLZ_ERR_WRITE_EOF;
+      }
+      else
+      {
+        errNum = WlzWriteObj(fP, obj);
+	(void )fclose(fP);
+      }
+    }
+    /* Read the object by WlzReadObj(), as read only and twice as copy on
+     * write. */
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if((fP = fopen(fStr, "rb")) == NULL)
+      {
+        errNum = WLZ_ERR_READ_EOF;
+      }
+      else
+      {
+        rObj[0] = WlzAssignObject(WlzReadObj(fP, &errNum), NULL);
+	(void )fclose(fP);
+      }
+    }
+    for(idR = 1; (errNum == WLZ_ERR_NONE) && (idR < 4); ++idR)
+    {
+      rObj[idR] = WlzAssignObject(
+		  WlzReadObjMapped(fStr, idR == 1, &errNum), NULL);
+    }
+    for(idR = 0; ok && (errNum == WLZ_ERR_NONE) && (idR < 4); ++idR)
+    {
+      ok = WlzTstReadObjMappedCmpObj(obj, rObj[idR], &errNum);
+      if(verbose || !ok)
+      {
+        (void )fprintf(stderr, "%s: Object %d read by %s %s.\n",
+		       *argv, idO,
+		       (idR == 0)? "WlzReadObj()":
+		       (idR == 1)? "WlzReadObjMapped() read only":
+		                   "WlzReadObjMapped() copy on write",
+		       (ok)? "ok": "differs");
+      }
+    }
+    /* Modify one copy on write object, which must then differ while the
+     * other and the file are unchanged. */
+    if(ok && (errNum == WLZ_ERR_NONE))
+    {
+      errNum = WlzTstReadObjMappedSetObj(rObj[2], 1);
+    }
+    if(ok && (errNum == WLZ_ERR_NONE))
+    {
+      ok = !WlzTstReadObjMappedCmpObj(obj, rObj[2], &errNum) &&
+           (errNum == WLZ_ERR_NONE) &&
+           WlzTstReadObjMappedCmpObj(obj, rObj[3], &errNum) &&
+           (errNum == WLZ_ERR_NONE) &&
+           WlzTstReadObjMappedCmpObj(obj, rObj[1], &errNum);
+    }
+    if(ok && (errNum == WLZ_ERR_NONE))
+    {
+      (void )WlzFreeObj(rObj[2]);
+      rObj[2] = WlzAssignObject(WlzReadObjMapped(fStr, 0, &errNum), NULL);
+      if(errNum == WLZ_ERR_NONE)
+      {
+	ok = WlzTstReadObjMappedCmpObj(obj, rObj[2], &errNum);
+      }
+    }
+    if(verbose || !ok)
+    {
+      (void )fprintf(stderr, "%s: Object %d copy on write %s.\n",
+		     *argv, idO, (ok)? "ok": "modified the file or another "
+		     "object");
+    }
+    for(idR = 0; idR < 4; ++idR)
+    {
+      (void )WlzFreeObj(rObj[idR]);
+      rObj[idR] = NULL;
+    }
+    (void )WlzFreeObj(obj);
+    obj = NULL;
+  }
+  if(fStr)
+  {
+    (void )unlink(fStr);
+  }
+  if(dir)
+  {
+    (void )rmdir(dir);
+  }
+  AlcFree(fStr);
+  AlcFree(dir);
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to test mapped reads (%s).\n",
+		   *argv, errMsg);
+  }
+  if(ok)
+  {
+    (void )printf("%s: Objects read by WlzReadObjMapped() match those "
+    		  "read by WlzReadObj().\n", *argv);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-v]\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -v  Verbose output.\n"
+    "Tests WlzReadObjMapped() by reading objects with rectangular value\n"
+    "tables using copy on write and read only mappings and comparing\n"
+    "them with the objects written and with those read by WlzReadObj().\n"
+    "The values of a copy on write object are modified to check that\n"
+    "the file and other objects mapped from it are not changed.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New object or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Makes an object with rectangular value tables of the given
+* 		grey type. The values span a range which prevents them
+* 		being packed into a smaller type when written.
+* \param	gType			Grey type.
+* \param	dim			Dimension, 2 or 3 for a domain object
+* 					or 0 for a compound array of 2D
+* 					objects.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstReadObjMappedMakeObj(WlzGreyType gType, int dim,
+					     WlzErrorNum *dstErr)
+{
+  WlzPixelV	bgdV;
+  WlzObject	*obj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  bgdV.type = WLZ_GREY_INT;
+  bgdV.v.inv = 0;
+  (void )WlzValueConvertPixel(&bgdV, bgdV, gType);
+  if(dim == 0)
+  {
+    int		idC;
+    WlzObject	*cObj[2] = {NULL};
+    WlzCompoundArray *cpd = NULL;
+
+    for(idC = 0; (errNum == WLZ_ERR_NONE) && (idC < 2); ++idC)
+    {
+      cObj[idC] = WlzTstReadObjMappedMakeObj(gType, 2, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      cpd = WlzMakeCompoundArray(WLZ_COMPOUND_ARR_1, 3, 2, cObj,
+      				 WLZ_2D_DOMAINOBJ, &errNum);
+    }
+    if(cpd == NULL)
+    {
+      (void )WlzFreeObj(cObj[0]);
+      (void )WlzFreeObj(cObj[1]);
+    }
+    obj = (WlzObject *)cpd;
+  }
+  else if(dim == 2)
+  {
+    WlzObjectType vType;
+    WlzObject	*rObj;
+
+    rObj = WlzMakeRect(-3, 40, 7, 66, WLZ_GREY_ERROR, NULL, bgdV,
+    		       NULL, NULL, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      vType = WlzGreyTableType(WLZ_GREY_TAB_RECT, gType, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      obj = WlzNewObjectValues(rObj, vType, bgdV, 0, bgdV, &errNum);
+    }
+    (void )WlzFreeObj(rObj);
+  }
+  else
+  {
+    obj = WlzMakeCuboid(2, 9, -3, 40, 7, 66, gType, bgdV, NULL, NULL,
+    			&errNum);
+  }
+  if((errNum == WLZ_ERR_NONE) && (dim != 0))
+  {
+    errNum = WlzTstReadObjMappedSetObj(obj, 0);
+  }
+  if((errNum != WLZ_ERR_NONE) && (obj != NULL))
+  {
+    (void )WlzFreeObj(obj);
+    obj = NULL;
+  }
+  *dstErr = errNum;
+  return(obj);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	BinWlzTst
+* \brief	Sets the values of a 2D or 3D object to a pattern of
+* 		values which differ at every voxel, or increments the
+* 		existing values.
+* \param	obj			Given object.
+* \param	inc			If non-zero the values are incremented,
+* 					otherwise they are set.
+*/
+static WlzErrorNum WlzTstReadObjMappedSetObj(WlzObject *obj, int inc)
+{
+  WlzIBox3	box;
+  WlzGreyValueWSpace *gVWSp = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(obj->type == WLZ_COMPOUND_ARR_1)
+  {
+    int		idC;
+    WlzCompoundArray *cpd;
+
+    cpd = (WlzCompoundArray *)obj;
+    for(idC = 0; (errNum == WLZ_ERR_NONE) && (idC < cpd->n); ++idC)
+    {
+      errNum = WlzTstReadObjMappedSetObj(cpd->o[idC], inc);
+    }
+  }
+  else
+  {
+    box = WlzBoundingBox3I(obj, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      gVWSp = WlzGreyValueMakeWSp(obj, &errNum);
+    }
+  }
+  if(gVWSp != NULL)
+  {
+    int		idP,
+    		idL,
+		idK;
+
+    for(idP = box.zMin; idP <= box.zMax; ++idP)
+    {
+      for(idL = box.yMin; idL <= box.yMax; ++idL)
+      {
+	for(idK = box.xMin; idK <= box.xMax; ++idK)
+	{
+	  int	v;
+
+	  v = (idK * 3) + (idL * 131) + (idP * 1009);
+	  WlzGreyValueGet(gVWSp, idP, idL, idK);
+	  switch(gVWSp->gType)
+	  {
+	    case WLZ_GREY_UBYTE:
+	      *(gVWSp->gPtr[0].ubp) = (inc)? *(gVWSp->gPtr[0].ubp) + 1:
+	      				     (WlzUByte )(v & 0xff);
+	      break;
+	    case WLZ_GREY_SHORT:
+	      *(gVWSp->gPtr[0].shp) = (inc)? *(gVWSp->gPtr[0].shp) + 1:
+	      				     (short )(v - 5000);
+	      break;
+	    case WLZ_GREY_INT:
+	      *(gVWSp->gPtr[0].inp) = (inc)? *(gVWSp->gPtr[0].inp) + 1:
+	      				     (v * 40503) - 100000;
+	      break;
+	    case WLZ_GREY_FLOAT:
+	      *(gVWSp->gPtr[0].flp) = (inc)? *(gVWSp->gPtr[0].flp) + 1.0f:
+	      				     (float )v / 7.0f;
+	      break;
+	    case WLZ_GREY_RGBA:
+	      if(inc)
+	      {
+	        *(gVWSp->gPtr[0].rgbp) ^= 0x01;
+	      }
+	      else
+	      {
+		WLZ_RGBA_RGBA_SET(*(gVWSp->gPtr[0].rgbp),
+				  v & 0xff, (v >> 3) & 0xff, (v >> 6) & 0xff,
+				  255);
+	      }
+	      break;
+	    default:
+	      errNum = WLZ_ERR_GREY_TYPE;
+	      break;
+	  }
+	}
+      }
+    }
+  }
+  WlzGreyValueFreeWSp(gVWSp);
+  return(errNum);
+}
+
+/*!
+* \return	Non-zero if the objects have the same values.
+* \ingroup	BinWlzTst
+* \brief	Compares the values of an object read with those of the
+* 		original object, recursing into compound arrays.
+* \param	obj0			Original object.
+* \param	obj1			Object read.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstReadObjMappedCmpObj(WlzObject *obj0, WlzObject *obj1,
+					  WlzErrorNum *dstErr)
+{
+  int		eq = 0;
+  WlzIBox3	box;
+  WlzGreyValueWSpace *gVWSp[2] = {NULL, NULL};
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((obj1 == NULL) || (obj1->type != obj0->type))
+  {
+    errNum = WLZ_ERR_OBJECT_TYPE;
+  }
+  else if(obj0->type == WLZ_COMPOUND_ARR_1)
+  {
+    int		idC;
+    WlzCompoundArray *cpd0,
+    		*cpd1;
+
+    cpd0 = (WlzCompoundArray *)obj0;
+    cpd1 = (WlzCompoundArray *)obj1;
+    eq = (cpd0->n == cpd1->n);
+    for(idC = 0; eq && (errNum == WLZ_ERR_NONE) && (idC < cpd0->n); ++idC)
+    {
+      eq = WlzTstReadObjMappedCmpObj(cpd0->o[idC], cpd1->o[idC], &errNum);
+    }
+  }
+  else
+  {
+    box = WlzBoundingBox3I(obj0, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      gVWSp[0] = WlzGreyValueMakeWSp(obj0, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      gVWSp[1] = WlzGreyValueMakeWSp(obj1, &errNum);
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (gVWSp[1] != NULL))
+  {
+    int		idP,
+    		idL,
+		idK;
+
+    eq = 1;
+    for(idP = box.zMin; eq && (idP <= box.zMax); ++idP)
+    {
+      for(idL = box.yMin; eq && (idL <= box.yMax); ++idL)
+      {
+	for(idK = box.xMin; eq && (idK <= box.xMax); ++idK)
+	{
+	  WlzGreyValueGet(gVWSp[0], idP, idL, idK);
+	  WlzGreyValueGet(gVWSp[1], idP, idL, idK);
+	  eq = (gVWSp[0]->gType == gVWSp[1]->gType);
+	  if(eq)
+	  {
+	    switch(gVWSp[0]->gType)
+	    {
+	      case WLZ_GREY_UBYTE:
+		eq = gVWSp[0]->gVal[0].ubv == gVWSp[1]->gVal[0].ubv;
+		break;
+	      case WLZ_GREY_SHORT:
+		eq = gVWSp[0]->gVal[0].shv == gVWSp[1]->gVal[0].shv;
+		break;
+	      case WLZ_GREY_INT:
+		eq = gVWSp[0]->gVal[0].inv == gVWSp[1]->gVal[0].inv;
+		break;
+	      case WLZ_GREY_FLOAT:
+		eq = gVWSp[0]->gVal[0].flv == gVWSp[1]->gVal[0].flv;
+		break;
+	      case WLZ_GREY_RGBA:
+		eq = gVWSp[0]->gVal[0].rgbv == gVWSp[1]->gVal[0].rgbv;
+		break;
+	      default:
+		eq = 0;
+		break;
+	    }
+	  }
+	}
+      }
+    }
+  }
+  WlzGreyValueFreeWSp(gVWSp[0]);
+  WlzGreyValueFreeWSp(gVWSp[1]);
+  *dstErr = errNum;
+  return(eq);
+}
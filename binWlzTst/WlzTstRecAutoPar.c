@@ -0,0 +1,520 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstRecAutoPar_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstRecAutoPar.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for RecAutoPar() which registers a list of
+* 		synthetic sections, each being a translated window on
+* 		the same pattern, with increasing numbers of concurrent
+* 		pair registrations. The transforms are compared with
+* 		those found by registering each pair in turn using
+* 		RecRegisterPair() and with the known translations.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <float.h>
+#include <Reconstruct.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+/*!
+* \ingroup	BinWlzTst
+* \brief	Gaussian blob of the synthetic pattern.
+*/
+typedef struct _WlzTstRecAutoParBlob
+{
+  double	x;			/*!< Column of the blob centre. */
+  double	y;			/*!< Line of the blob centre. */
+  double	s;			/*!< Width of the blob. */
+  double	a;			/*!< Amplitude of the blob. */
+} WlzTstRecAutoParBlob;
+
+/*!
+* \ingroup	BinWlzTst
+* \brief	Transforms recorded by the section update function.
+*/
+typedef struct _WlzTstRecAutoParRes
+{
+  int		nSec;			/*!< Number of sections. */
+  WlzAffineTransform **tr;		/*!< Transform for each section. */
+} WlzTstRecAutoParRes;
+
+static WlzObject		*WlzTstRecAutoParObj(
+				  int size,
+				  WlzIVertex2 shift,
+				  int nBlob,
+				  WlzTstRecAutoParBlob *blob,
+				  WlzErrorNum *dstErr);
+static void			WlzTstRecAutoParSecFn(
+				  RecSection *sec,
+				  void *data);
+static double			WlzTstRecAutoParCmp(
+				  WlzAffineTransform *tr0,
+				  WlzAffineTransform *tr1);
+
+int		main(int argc, char *argv[])
+{
+  int		idB,
+  		idP,
+  		idS,
+		cancel = 0,
+  		option,
+  		ok = 1,
+		usage = 0,
+		maxPar = 4,
+		nSec = 6,
+		size = 128,
+		verbose = 0;
+  long		seed = 0;
+  double	d,
+  		maxD = 0.0,
+		maxT = 0.0;
+  const int	nBlob = 40;
+  WlzIVertex2	*shift = NULL;
+  WlzAffineTransform **refTr = NULL;
+  WlzObject	**objs = NULL;
+  char		**files = NULL;
+  WlzTstRecAutoParBlob *blob = NULL;
+  WlzTstRecAutoParRes res;
+  RecControl	rCtrl;
+  RecPPControl	ppCtrl;
+  RecError	recErr = REC_ERR_NONE;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  char		*eMsg = NULL;
+  const char	*errMsg;
+  static char	optList[] = "hn:p:r:s:v";
+
+  opterr = 0;
+  res.nSec = 0;
+  res.tr = NULL;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'n':
+        nSec = atoi(optarg);
+	break;
+      case 'p':
+        maxPar = atoi(optarg);
+	break;
+      case 'r':
+        size = atoi(optarg);
+	break;
+      case 's':
+        seed = atol(optarg);
+	break;
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  if((usage == 0) &&
+     ((optind != argc) || (nSec < 2) || (maxPar < 1) || (size < 32)))
+  {
+    usage = 1;
+  }
+  ok = !usage;
+  if(ok)
+  {
+    if(((shift = (WlzIVertex2 *)
+                 AlcCalloc(nSec, sizeof(WlzIVertex2))) == NULL) ||
+       ((objs = (WlzObject **)
+                AlcCalloc(nSec, sizeof(WlzObject *))) == NULL) ||
+       ((files = (char **)AlcCalloc(nSec, sizeof(char *))) == NULL) ||
+       ((refTr = (WlzAffineTransform **)
+                 AlcCalloc(nSec, sizeof(WlzAffineTransform *))) == NULL) ||
+       ((res.tr = (WlzAffineTransform **)
+                  AlcCalloc(nSec, sizeof(WlzAffineTransform *))) == NULL) ||
+       ((blob = (WlzTstRecAutoParBlob *)
+                AlcMalloc(nBlob * sizeof(WlzTstRecAutoParBlob))) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  /* Make the section images, each translated by a few pixels from the
+   * previous one, and write them to temporary files. */
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    srand48(seed);
+    res.nSec = nSec;
+    for(idB = 0; idB < nBlob; ++idB)
+    {
+      blob[idB].x = (drand48() - 0.25) * 1.5 * size;
+      blob[idB].y = (drand48() - 0.25) * 1.5 * size;
+      blob[idB].s = 3.0 + (drand48() * 5.0);
+      blob[idB].a = 100.0 + (drand48() * 150.0);
+    }
+    for(idS = 0; (errNum == WLZ_ERR_NONE) && (idS < nSec); ++idS)
+    {
+      int	fd;
+      FILE	*fP = NULL;
+
+      if(idS > 0)
+      {
+	shift[idS].vtX = shift[idS - 1].vtX + (int )(drand48() * 9.0) - 4;
+	shift[idS].vtY = shift[idS - 1].vtY + (int )(drand48() * 9.0) - 4;
+      }
+      objs[idS] = WlzAssignObject(
+		  WlzTstRecAutoParObj(size, shift[idS], nBlob, blob,
+				      &errNum), NULL);
+      if(errNum == WLZ_ERR_NONE)
+      {
+	if(((files[idS] = AlcStrDup("/tmp/WlzTstRecAutoParXXXXXX")) == NULL) ||
+	   ((fd = mkstemp(files[idS])) < 0))
+	{
+	  AlcFree(files[idS]);
+	  files[idS] = NULL;
+	  errNum = WLZ_ERR_WRITE_EOF;
+	}
+	else if((fP = fdopen(fd, "w")) == NULL)
+	{
+	  (void )close(fd);
+	  errNum = WLZ_ERR_WRITE_EOF;
+	}
+	else
+	{
+	  errNum = WlzWriteObj(fP, objs[idS]);
+	  if(fclose(fP) != 0)
+	  {
+	    errNum = WLZ_ERR_WRITE_EOF;
+	  }
+	}
+      }
+    }
+    if(errNum != WLZ_ERR_NONE)
+    {
+      ok = 0;
+      (void )WlzStringFromErrorNum(errNum, &errMsg);
+      (void )fprintf(stderr, "%s: Failed to create sections (%s).\n",
+		     *argv, errMsg);
+    }
+  }
+  if(ok)
+  {
+    rCtrl.method = (RecMethod )(REC_MTHD_TRANS | REC_MTHD_ROTATE);
+    rCtrl.xLim = REC_DEF_XLIM;
+    rCtrl.yLim = REC_DEF_YLIM;
+    rCtrl.rLim = REC_DEF_RLIM;
+    rCtrl.itLim = REC_DEF_ITLIM;
+    rCtrl.firstIdx = 0;
+    rCtrl.lastIdx = nSec - 1;
+    (void )memset(&ppCtrl, 0, sizeof(RecPPControl));
+    ppCtrl.method = REC_PP_NONE;
+    /* Register each pair in turn, as RecAuto() did before pairs could
+     * be registered concurrently. */
+    for(idS = 1; (recErr == REC_ERR_NONE) && (idS < nSec); ++idS)
+    {
+      double	cc;
+      int	itr;
+
+      /* Start from an identity transform as RecSecMake() does. */
+      refTr[idS] = WlzAssignAffineTransform(
+		   WlzAffineTransformFromPrimVal(WLZ_TRANSFORM_2D_AFFINE,
+						 0.0, 0.0, 0.0, 1.0, 0.0, 0.0,
+						 0.0, 0.0, 0.0, 0, &errNum),
+		   NULL);
+      recErr = (errNum == WLZ_ERR_NONE)?
+	       RecRegisterPair(refTr + idS, &cc, &itr, &rCtrl, &ppCtrl,
+			       objs[idS - 1], objs[idS], NULL, NULL, &eMsg):
+	       REC_ERR_WLZ;
+      if(recErr == REC_ERR_NONE)
+      {
+	/* The transform brings section idS into register with the
+	 * previous section. */
+	d = WLZ_MAX(fabs(refTr[idS]->mat[0][2] -
+		         (shift[idS].vtX - shift[idS - 1].vtX)),
+		    fabs(refTr[idS]->mat[1][2] -
+		         (shift[idS].vtY - shift[idS - 1].vtY)));
+	maxT = WLZ_MAX(maxT, d);
+	if(verbose)
+	{
+	  (void )fprintf(stderr,
+	  		 "%s: pair %d shift (%d, %d) found (%g, %g)\n",
+			 *argv, idS,
+			 shift[idS].vtX - shift[idS - 1].vtX,
+			 shift[idS].vtY - shift[idS - 1].vtY,
+			 refTr[idS]->mat[0][2], refTr[idS]->mat[1][2]);
+	}
+      }
+    }
+    if(recErr != REC_ERR_NONE)
+    {
+      ok = 0;
+      (void )fprintf(stderr, "%s: Failed to register pair (%s).\n",
+		     *argv, (eMsg)? eMsg: RecErrorToStr(recErr));
+    }
+    /* Only the overlap of the windows correlates so the translations
+     * found are biased towards zero, allow for this. */
+    else if(maxT > 1.5)
+    {
+      ok = 0;
+      (void )fprintf(stderr,
+		     "%s: Pair registration misses the known translation "
+		     "by %g.\n",
+		     *argv, maxT);
+    }
+  }
+  for(idP = 1; ok && (idP <= maxPar); ++idP)
+  {
+    HGUDlpList	*secList = NULL;
+
+    /* Register the list with up to idP concurrent pair registrations. */
+    if((secList = HGUDlpListCreate(NULL)) == NULL)
+    {
+      recErr = REC_ERR_MALLOC;
+    }
+    for(idS = 0; (recErr == REC_ERR_NONE) && (idS < nSec); ++idS)
+    {
+      RecSection *sec;
+
+      if(((sec = RecSecMake(idS, 0, 0.0, files[idS], NULL, NULL)) == NULL) ||
+         (HGUDlpListAppend(secList, NULL, sec,
+	                   (void (*)(void *))RecSecFree) == NULL))
+      {
+	recErr = REC_ERR_MALLOC;
+      }
+    }
+    if(recErr == REC_ERR_NONE)
+    {
+      recErr = RecAutoPar(&rCtrl, &ppCtrl, secList, &cancel,
+			  WlzTstRecAutoParSecFn, &res, NULL, NULL,
+			  idP, &eMsg);
+    }
+    if(recErr == REC_ERR_NONE)
+    {
+      maxD = 0.0;
+      for(idS = 1; idS < nSec; ++idS)
+      {
+	d = WlzTstRecAutoParCmp(refTr[idS], res.tr[idS]);
+	maxD = WLZ_MAX(maxD, d);
+      }
+      if(verbose)
+      {
+	(void )fprintf(stderr,
+		       "%s: %d concurrent pairs, maximum difference %g\n",
+		       *argv, idP, maxD);
+      }
+      if(maxD > 1.0e-6)
+      {
+	ok = 0;
+	(void )fprintf(stderr,
+		       "%s: With %d concurrent pairs the transforms differ "
+		       "from those of pairs registered in turn by %g.\n",
+		       *argv, idP, maxD);
+      }
+    }
+    else
+    {
+      ok = 0;
+      (void )fprintf(stderr,
+		     "%s: Failed to register sections with %d concurrent "
+		     "pairs (%s).\n",
+		     *argv, idP, (eMsg)? eMsg: RecErrorToStr(recErr));
+    }
+    for(idS = 0; idS < nSec; ++idS)
+    {
+      (void )WlzFreeAffineTransform(res.tr[idS]);
+      res.tr[idS] = NULL;
+    }
+    if(secList)
+    {
+      HGUDlpListDestroy(secList);
+    }
+  }
+  if(ok)
+  {
+    (void )printf("%s: %d sections registered with up to %d concurrent "
+		  "pairs match pairs registered in turn.\n",
+		  *argv, nSec, maxPar);
+  }
+  for(idS = 0; idS < res.nSec; ++idS)
+  {
+    (void )WlzFreeObj(objs[idS]);
+    (void )WlzFreeAffineTransform(refTr[idS]);
+    if(files[idS])
+    {
+      (void )unlink(files[idS]);
+      AlcFree(files[idS]);
+    }
+  }
+  AlcFree(shift);
+  AlcFree(objs);
+  AlcFree(files);
+  AlcFree(refTr);
+  AlcFree(res.tr);
+  AlcFree(blob);
+  AlcFree(eMsg);
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-n#] [-p#] [-r#] [-s#] [-v]\n"
+    "Registers a list of synthetic sections, each a translated window\n"
+    "on the same pattern, using RecAutoPar() with from one up to the\n"
+    "given number of concurrent pair registrations and compares the\n"
+    "transforms with those found by registering each pair in turn.\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -n  Number of sections (default 6).\n"
+    "  -p  Maximum number of concurrent pair registrations (default 4).\n"
+    "  -r  Size of the section images (default 128).\n"
+    "  -s  Seed for the random number generator (default 0).\n"
+    "  -v  Verbose output.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New section image or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Creates a square section image of Gaussian blobs, with
+* 		the pattern translated by the given shift.
+* \param	size			Width and height of the image.
+* \param	shift			Translation of the pattern.
+* \param	nBlob			Number of blobs.
+* \param	blob			The blobs.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstRecAutoParObj(int size, WlzIVertex2 shift,
+				int nBlob, WlzTstRecAutoParBlob *blob,
+				WlzErrorNum *dstErr)
+{
+  int		idB,
+  		idX,
+		idY;
+  WlzUByte	**ary = NULL;
+  WlzIVertex2	org,
+  		sz;
+  WlzObject	*obj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(AlcUnchar2Malloc(&ary, size, size) != ALC_ER_NONE)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    for(idY = 0; idY < size; ++idY)
+    {
+      for(idX = 0; idX < size; ++idX)
+      {
+	double	v = 0.0;
+
+	for(idB = 0; idB < nBlob; ++idB)
+	{
+	  double dx,
+	  	 dy;
+
+	  dx = idX + shift.vtX - blob[idB].x;
+	  dy = idY + shift.vtY - blob[idB].y;
+	  v += blob[idB].a * exp(-((dx * dx) + (dy * dy)) /
+	                         (2.0 * blob[idB].s * blob[idB].s));
+	}
+	ary[idY][idX] = (WlzUByte )WLZ_CLAMP(v, 0.0, 255.0);
+      }
+    }
+    org.vtX = org.vtY = 0;
+    sz.vtX = sz.vtY = size;
+    obj = WlzFromArray2D((void **)ary, sz, org, WLZ_GREY_UBYTE,
+			 WLZ_GREY_UBYTE, 0.0, 1.0, 0, 0, &errNum);
+    Alc2Free((void **)ary);
+  }
+  *dstErr = errNum;
+  return(obj);
+}
+
+/*!
+* \ingroup	BinWlzTst
+* \brief	Section update function which records a copy of the
+* 		section's transform.
+* \param	sec			Registered section.
+* \param	data			Used to pass the recorded transforms.
+*/
+static void	WlzTstRecAutoParSecFn(RecSection *sec, void *data)
+{
+  WlzTstRecAutoParRes *res;
+
+  res = (WlzTstRecAutoParRes *)data;
+  if(sec && sec->transform && (sec->index >= 0) && (sec->index < res->nSec))
+  {
+    (void )WlzFreeAffineTransform(res->tr[sec->index]);
+    res->tr[sec->index] = WlzAssignAffineTransform(
+    			  WlzAffineTransformCopy(sec->transform, NULL),
+			  NULL);
+  }
+}
+
+/*!
+* \return	Maximum difference between the matrix elements or a
+* 		large value if either transform is missing.
+* \ingroup	BinWlzTst
+* \brief	Compares two 2D affine transforms.
+* \param	tr0			First transform.
+* \param	tr1			Second transform.
+*/
+static double	WlzTstRecAutoParCmp(WlzAffineTransform *tr0,
+				    WlzAffineTransform *tr1)
+{
+  int		idX,
+  		idY;
+  double	d = DBL_MAX;
+
+  if(tr0 && tr1)
+  {
+    d = 0.0;
+    for(idY = 0; idY < 3; ++idY)
+    {
+      for(idX = 0; idX < 3; ++idX)
+      {
+	d = WLZ_MAX(d, fabs(tr0->mat[idY][idX] - tr1->mat[idY][idX]));
+      }
+    }
+  }
+  return(d);
+}
@@ -0,0 +1,412 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstRecRegPyramid_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstRecRegPyramid.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for coarse to fine registration by RecRegisterPair().
+* 		Pairs of synthetic sections are made, the second of
+* 		each pair being a rotated and translated copy of the
+* 		first, and these are registered both at a single
+* 		resolution and using a resolution pyramid. The two
+* 		transforms must agree with each other and with the
+* 		known transform.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <Reconstruct.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+/*!
+* \ingroup	BinWlzTst
+* \brief	Gaussian blob of the synthetic pattern.
+*/
+typedef struct _WlzTstRecRegPyramidBlob
+{
+  double	x;			/*!< Column of the blob centre. */
+  double	y;			/*!< Line of the blob centre. */
+  double	s;			/*!< Width of the blob. */
+  double	a;			/*!< Amplitude of the blob. */
+} WlzTstRecRegPyramidBlob;
+
+static WlzObject		*WlzTstRecRegPyramidObj(
+				  int size,
+				  WlzAffineTransform *tr,
+				  int nBlob,
+				  WlzTstRecRegPyramidBlob *blob,
+				  WlzErrorNum *dstErr);
+static void			WlzTstRecRegPyramidCmp(
+				  double *dstDC,
+				  double *dstDR,
+				  WlzAffineTransform *tr0,
+				  WlzAffineTransform *tr1,
+				  int size);
+
+int		main(int argc, char *argv[])
+{
+  int		idB,
+  		idR,
+		itr,
+  		option,
+  		ok = 1,
+		usage = 0,
+		nRep = 4,
+		nBlob,
+		size = 256,
+		verbose = 0;
+  long		seed = 0;
+  double	cc,
+		maxDC[3],
+		maxDR[3];
+  WlzDVertex2	tran;
+  WlzAffineTransform *tr[3];
+  WlzObject	*objs[2];
+  WlzTstRecRegPyramidBlob *blob = NULL;
+  RecControl	rCtrl;
+  RecPPControl	ppCtrl;
+  RecError	recErr = REC_ERR_NONE;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  char		*eMsg = NULL;
+  const double	maxRot = 8.0,
+  		tolC = 2.0,
+		tolR = 1.0;
+  const char	*errMsg;
+  static char	optList[] = "hn:r:s:v";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'n':
+        nRep = atoi(optarg);
+	break;
+      case 'r':
+        size = atoi(optarg);
+	break;
+      case 's':
+        seed = atol(optarg);
+	break;
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  if((usage == 0) && ((optind != argc) || (nRep < 1) || (size < 128)))
+  {
+    usage = 1;
+  }
+  ok = !usage;
+  if(ok)
+  {
+    nBlob = (size * size) / 400;
+    if((blob = (WlzTstRecRegPyramidBlob *)
+               AlcMalloc(nBlob * sizeof(WlzTstRecRegPyramidBlob))) == NULL)
+    {
+      ok = 0;
+      (void )fprintf(stderr, "%s: Failed to allocate blobs.\n", *argv);
+    }
+  }
+  if(ok)
+  {
+    srand48(seed);
+    rCtrl.method = (RecMethod )(REC_MTHD_TRANS | REC_MTHD_ROTATE);
+    rCtrl.xLim = REC_DEF_XLIM;
+    rCtrl.yLim = REC_DEF_YLIM;
+    rCtrl.rLim = REC_DEF_RLIM;
+    rCtrl.itLim = REC_DEF_ITLIM;
+    rCtrl.firstIdx = 0;
+    rCtrl.lastIdx = 1;
+    (void )memset(&ppCtrl, 0, sizeof(RecPPControl));
+    ppCtrl.method = REC_PP_NONE;
+    maxDC[0] = maxDC[1] = maxDC[2] = 0.0;
+    maxDR[0] = maxDR[1] = maxDR[2] = 0.0;
+  }
+  for(idR = 0; ok && (idR < nRep); ++idR)
+  {
+    int		idT;
+
+    tr[0] = tr[1] = tr[2] = NULL;
+    objs[0] = objs[1] = NULL;
+    for(idB = 0; idB < nBlob; ++idB)
+    {
+      blob[idB].x = (drand48() * 1.5 - 0.25) * size;
+      blob[idB].y = (drand48() * 1.5 - 0.25) * size;
+      blob[idB].s = 3.0 + (drand48() * 5.0);
+      blob[idB].a = 100.0 + (drand48() * 150.0);
+    }
+    /* The known transform rotates about the centre of the image, then
+     * translates by up to two thirds of the translation limits. */
+    tran.vtX = (drand48() - 0.5) * 4.0 * REC_DEF_XLIM / 3.0;
+    tran.vtY = (drand48() - 0.5) * 4.0 * REC_DEF_YLIM / 3.0;
+    {
+      double	ang,
+      		cA,
+		sA,
+		c;
+
+      ang = (drand48() - 0.5) * 2.0 * maxRot * WLZ_M_PI / 180.0;
+      cA = cos(ang);
+      sA = sin(ang);
+      c = 0.5 * (size - 1);
+      tr[0] = WlzAssignAffineTransform(
+	      WlzAffineTransformFromPrimVal(WLZ_TRANSFORM_2D_AFFINE,
+		    tran.vtX + c - (cA * c) + (sA * c),
+		    tran.vtY + c - (sA * c) - (cA * c), 0.0,
+		    1.0, ang, 0.0, 0.0, 0.0, 0.0, 0, &errNum), NULL);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      objs[0] = WlzAssignObject(
+		WlzTstRecRegPyramidObj(size, NULL, nBlob, blob,
+				       &errNum), NULL);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      objs[1] = WlzAssignObject(
+		WlzTstRecRegPyramidObj(size, tr[0], nBlob, blob,
+				       &errNum), NULL);
+    }
+    if(errNum != WLZ_ERR_NONE)
+    {
+      ok = 0;
+      (void )WlzStringFromErrorNum(errNum, &errMsg);
+      (void )fprintf(stderr, "%s: Failed to create sections (%s).\n",
+		     *argv, errMsg);
+    }
+    /* Register at a single resolution and then using the pyramid. */
+    for(idT = 1; ok && (idT < 3); ++idT)
+    {
+      if(idT == 2)
+      {
+        rCtrl.method = (RecMethod )(rCtrl.method | REC_MTHD_PYRAMID);
+      }
+      recErr = RecRegisterPair(tr + idT, &cc, &itr, &rCtrl, &ppCtrl,
+			       objs[0], objs[1], NULL, NULL, &eMsg);
+      rCtrl.method = (RecMethod )(rCtrl.method & ~REC_MTHD_PYRAMID);
+      if(recErr != REC_ERR_NONE)
+      {
+	ok = 0;
+	(void )fprintf(stderr, "%s: Failed to register pair (%s).\n",
+		       *argv, (eMsg)? eMsg: RecErrorToStr(recErr));
+      }
+    }
+    if(ok)
+    {
+      double	dC[3],
+      		dR[3];
+      const char *cmpStr[3] = {"single resolution and known",
+			       "pyramid and known",
+			       "pyramid and single resolution"};
+
+      WlzTstRecRegPyramidCmp(dC + 0, dR + 0, tr[0], tr[1], size);
+      WlzTstRecRegPyramidCmp(dC + 1, dR + 1, tr[0], tr[2], size);
+      WlzTstRecRegPyramidCmp(dC + 2, dR + 2, tr[1], tr[2], size);
+      if(verbose)
+      {
+	(void )fprintf(stderr,
+		       "%s: pair %d differences %g %g %g, %g %g %g\n",
+		       *argv, idR, dC[0], dC[1], dC[2], dR[0], dR[1], dR[2]);
+      }
+      for(idT = 0; idT < 3; ++idT)
+      {
+        maxDC[idT] = WLZ_MAX(maxDC[idT], dC[idT]);
+        maxDR[idT] = WLZ_MAX(maxDR[idT], dR[idT]);
+	if(ok && ((dC[idT] > tolC) || (dR[idT] > tolR)))
+	{
+	  ok = 0;
+	  (void )fprintf(stderr,
+	  		 "%s: For pair %d the %s transforms differ by %g "
+			 "at the centre and %g degrees.\n",
+			 *argv, idR, cmpStr[idT], dC[idT], dR[idT]);
+	}
+      }
+    }
+    for(idT = 0; idT < 3; ++idT)
+    {
+      (void )WlzFreeAffineTransform(tr[idT]);
+    }
+    (void )WlzFreeObj(objs[0]);
+    (void )WlzFreeObj(objs[1]);
+  }
+  if(ok)
+  {
+    (void )printf("%s: Pyramid and single resolution registration of %d "
+		  "pairs agree (maximum differences %g %g %g, "
+		  "%g %g %g).\n",
+		  *argv, nRep, maxDC[0], maxDC[1], maxDC[2],
+		  maxDR[0], maxDR[1], maxDR[2]);
+  }
+  AlcFree(blob);
+  AlcFree(eMsg);
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-n#] [-r#] [-s#] [-v]\n"
+    "Registers pairs of synthetic sections, the second of each pair being\n"
+    "a rotated and translated copy of the first, using RecRegisterPair()\n"
+    "both at a single resolution and with a resolution pyramid. The\n"
+    "transforms are compared with each other and the known transform by\n"
+    "the distance between the images of the section centre and by the\n"
+    "difference between their rotations.\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -n  Number of pairs (default 4).\n"
+    "  -r  Size of the section images (default 256).\n"
+    "  -s  Seed for the random number generator (default 0).\n"
+    "  -v  Verbose output.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New section image or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Creates a square section image of Gaussian blobs, with
+* 		the value at each pixel being that of the pattern at
+* 		the pixel's position transformed by the given transform.
+* \param	size			Width and height of the image.
+* \param	tr			Transform, may be NULL for identity.
+* \param	nBlob			Number of blobs.
+* \param	blob			The blobs.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstRecRegPyramidObj(int size, WlzAffineTransform *tr,
+				int nBlob, WlzTstRecRegPyramidBlob *blob,
+				WlzErrorNum *dstErr)
+{
+  int		idB,
+  		idX,
+		idY;
+  WlzUByte	**ary = NULL;
+  WlzIVertex2	org,
+  		sz;
+  WlzObject	*obj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(AlcUnchar2Malloc(&ary, size, size) != ALC_ER_NONE)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    for(idY = 0; idY < size; ++idY)
+    {
+      for(idX = 0; idX < size; ++idX)
+      {
+	double	v = 0.0;
+	WlzDVertex2 p;
+
+	p.vtX = idX;
+	p.vtY = idY;
+	if(tr)
+	{
+	  p = WlzAffineTransformVertexD2(tr, p, NULL);
+	}
+	for(idB = 0; idB < nBlob; ++idB)
+	{
+	  double dx,
+	  	 dy;
+
+	  dx = p.vtX - blob[idB].x;
+	  dy = p.vtY - blob[idB].y;
+	  v += blob[idB].a * exp(-((dx * dx) + (dy * dy)) /
+	                         (2.0 * blob[idB].s * blob[idB].s));
+	}
+	ary[idY][idX] = (WlzUByte )WLZ_CLAMP(v, 0.0, 255.0);
+      }
+    }
+    org.vtX = org.vtY = 0;
+    sz.vtX = sz.vtY = size;
+    obj = WlzFromArray2D((void **)ary, sz, org, WLZ_GREY_UBYTE,
+			 WLZ_GREY_UBYTE, 0.0, 1.0, 0, 0, &errNum);
+    Alc2Free((void **)ary);
+  }
+  *dstErr = errNum;
+  return(obj);
+}
+
+/*!
+* \ingroup	BinWlzTst
+* \brief	Compares two 2D rigid body transforms by the distance
+* 		between the images of the section centre and by the
+* 		difference between their rotations. Both differences are
+* 		set to a large value if either transform is missing.
+* \param	dstDC			Destination pointer for the distance
+* 					between the images of the centre.
+* \param	dstDR			Destination pointer for the difference
+* 					between the rotations (degrees).
+* \param	tr0			First transform.
+* \param	tr1			Second transform.
+* \param	size			Width and height of the section.
+*/
+static void	WlzTstRecRegPyramidCmp(double *dstDC, double *dstDR,
+				       WlzAffineTransform *tr0,
+				       WlzAffineTransform *tr1, int size)
+{
+  double	dC = DBL_MAX,
+  		dR = DBL_MAX;
+  WlzDVertex2	p,
+  		q0,
+		q1;
+
+  if(tr0 && tr1)
+  {
+    p.vtX = p.vtY = 0.5 * (size - 1);
+    q0 = WlzAffineTransformVertexD2(tr0, p, NULL);
+    q1 = WlzAffineTransformVertexD2(tr1, p, NULL);
+    WLZ_VTX_2_SUB(q0, q0, q1);
+    dC = WLZ_VTX_2_LENGTH(q0);
+    dR = fabs(atan2(tr0->mat[1][0], tr0->mat[0][0]) -
+              atan2(tr1->mat[1][0], tr1->mat[0][0])) * 180.0 / WLZ_M_PI;
+  }
+  *dstDC = dC;
+  *dstDR = dR;
+}
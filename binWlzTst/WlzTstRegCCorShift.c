@@ -0,0 +1,385 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstRegCCorShift_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstRegCCorShift.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for registration using frequency domain cross
+* 		correlation by WlzRegCCorObjs(). Pairs of synthetic
+* 		images are made, the second of each pair being a
+* 		translated (and for rigid body registration rotated)
+* 		copy of the first. The registration transforms must
+* 		agree with the known transforms.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+/*!
+* \ingroup	BinWlzTst
+* \brief	Gaussian blob of the synthetic pattern.
+*/
+typedef struct _WlzTstRegCCorShiftBlob
+{
+  double	x;			/*!< Column of the blob centre. */
+  double	y;			/*!< Line of the blob centre. */
+  double	s;			/*!< Width of the blob. */
+  double	a;			/*!< Amplitude of the blob. */
+} WlzTstRegCCorShiftBlob;
+
+static WlzObject		*WlzTstRegCCorShiftObj(
+				  int size,
+				  WlzAffineTransform *tr,
+				  int nBlob,
+				  WlzTstRegCCorShiftBlob *blob,
+				  WlzErrorNum *dstErr);
+static void			WlzTstRegCCorShiftCmp(
+				  double *dstDC,
+				  double *dstDR,
+				  WlzAffineTransform *tr0,
+				  WlzAffineTransform *tr1,
+				  int size);
+
+int		main(int argc, char *argv[])
+{
+  int		idB,
+  		idR,
+		idT,
+		conv,
+  		option,
+  		ok = 1,
+		usage = 0,
+		nRep = 4,
+		nBlob,
+		size = 256,
+		verbose = 0;
+  long		seed = 0;
+  double	cc,
+		maxDC = 0.0,
+		maxDR = 0.0;
+  WlzDVertex2	maxTran;
+  WlzAffineTransform *tr[2];
+  WlzObject	*objs[2];
+  WlzTstRegCCorShiftBlob *blob = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  /* The rotation found from the windowed polar samples is only accurate
+   * to about three degrees, but the translation found after it still
+   * puts the centre within a pixel or two. */
+  const double	maxRot = 8.0,
+  		tolC = 2.0,
+		tolR = 4.0;
+  const WlzTransformType trType[2] = {WLZ_TRANSFORM_2D_TRANS,
+  				      WLZ_TRANSFORM_2D_REG};
+  const char	*errMsg;
+  static char	optList[] = "hn:r:s:v";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'n':
+        nRep = atoi(optarg);
+	break;
+      case 'r':
+        size = atoi(optarg);
+	break;
+      case 's':
+        seed = atol(optarg);
+	break;
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  if((usage == 0) && ((optind != argc) || (nRep < 1) || (size < 128)))
+  {
+    usage = 1;
+  }
+  ok = !usage;
+  if(ok)
+  {
+    nBlob = (size * size) / 400;
+    if((blob = (WlzTstRegCCorShiftBlob *)
+               AlcMalloc(nBlob * sizeof(WlzTstRegCCorShiftBlob))) == NULL)
+    {
+      ok = 0;
+      (void )fprintf(stderr, "%s: Failed to allocate blobs.\n", *argv);
+    }
+  }
+  if(ok)
+  {
+    srand48(seed);
+    maxTran.vtX = maxTran.vtY = size / 4;
+  }
+  for(idR = 0; ok && (idR < nRep); ++idR)
+  {
+    for(idB = 0; idB < nBlob; ++idB)
+    {
+      blob[idB].x = (drand48() * 1.5 - 0.25) * size;
+      blob[idB].y = (drand48() * 1.5 - 0.25) * size;
+      blob[idB].s = 3.0 + (drand48() * 5.0);
+      blob[idB].a = 100.0 + (drand48() * 150.0);
+    }
+    for(idT = 0; ok && (idT < 2); ++idT)
+    {
+      double	ang = 0.0,
+		dC,
+		dR;
+      WlzDVertex2 tran;
+
+      tr[0] = tr[1] = NULL;
+      objs[0] = objs[1] = NULL;
+      /* The known transform rotates about the centre of the image, then
+       * translates by up to two thirds of the translation limits. */
+      tran.vtX = (drand48() - 0.5) * 4.0 * maxTran.vtX / 3.0;
+      tran.vtY = (drand48() - 0.5) * 4.0 * maxTran.vtY / 3.0;
+      if(trType[idT] == WLZ_TRANSFORM_2D_REG)
+      {
+        ang = (drand48() - 0.5) * 2.0 * maxRot * WLZ_M_PI / 180.0;
+      }
+      {
+	double	cA,
+		sA,
+		c;
+
+	cA = cos(ang);
+	sA = sin(ang);
+	c = 0.5 * (size - 1);
+	tr[0] = WlzAssignAffineTransform(
+		WlzAffineTransformFromPrimVal(WLZ_TRANSFORM_2D_AFFINE,
+		      tran.vtX + c - (cA * c) + (sA * c),
+		      tran.vtY + c - (sA * c) - (cA * c), 0.0,
+		      1.0, ang, 0.0, 0.0, 0.0, 0.0, 0, &errNum), NULL);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+	objs[0] = WlzAssignObject(
+		  WlzTstRegCCorShiftObj(size, NULL, nBlob, blob,
+					&errNum), NULL);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+	objs[1] = WlzAssignObject(
+		  WlzTstRegCCorShiftObj(size, tr[0], nBlob, blob,
+					&errNum), NULL);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+	tr[1] = WlzRegCCorObjs(objs[0], objs[1], NULL, trType[idT],
+			       maxTran, 2.0 * maxRot * WLZ_M_PI / 180.0, 10,
+			       WLZ_WINDOWFN_WELCH, 0, 0, &conv, &cc, &errNum);
+      }
+      if(errNum != WLZ_ERR_NONE)
+      {
+	ok = 0;
+	(void )WlzStringFromErrorNum(errNum, &errMsg);
+	(void )fprintf(stderr, "%s: Failed to register pair %d (%s).\n",
+		       *argv, idR, errMsg);
+      }
+      else
+      {
+	WlzTstRegCCorShiftCmp(&dC, &dR, tr[0], tr[1], size);
+	maxDC = WLZ_MAX(maxDC, dC);
+	maxDR = WLZ_MAX(maxDR, dR);
+	if(verbose)
+	{
+	  (void )fprintf(stderr,
+	  		 "%s: pair %d %s differences %g %g\n",
+			 *argv, idR, (idT)? "rigid": "translation", dC, dR);
+	}
+	if((dC > tolC) || (dR > tolR))
+	{
+	  ok = 0;
+	  (void )fprintf(stderr,
+			 "%s: For pair %d the %s registration differs from "
+			 "the known transform by %g at the centre and %g "
+			 "degrees.\n",
+			 *argv, idR, (idT)? "rigid body": "translation",
+			 dC, dR);
+	}
+      }
+      (void )WlzFreeAffineTransform(tr[0]);
+      (void )WlzFreeAffineTransform(tr[1]);
+      (void )WlzFreeObj(objs[0]);
+      (void )WlzFreeObj(objs[1]);
+    }
+  }
+  if(ok)
+  {
+    (void )printf("%s: Registration of %d pairs agrees with the known "
+		  "transforms (maximum differences %g %g).\n",
+		  *argv, nRep, maxDC, maxDR);
+  }
+  AlcFree(blob);
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-n#] [-r#] [-s#] [-v]\n"
+    "Registers pairs of synthetic images, the second of each pair being\n"
+    "a translated or a rotated and translated copy of the first, using\n"
+    "WlzRegCCorObjs(). The transforms are compared with the known\n"
+    "transforms by the distance between the images of the centre and by\n"
+    "the difference between their rotations.\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -n  Number of pairs (default 4).\n"
+    "  -r  Size of the images (default 256).\n"
+    "  -s  Seed for the random number generator (default 0).\n"
+    "  -v  Verbose output.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New image or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Creates a square image of Gaussian blobs, with
+* 		the value at each pixel being that of the pattern at
+* 		the pixel's position transformed by the given transform.
+* \param	size			Width and height of the image.
+* \param	tr			Transform, may be NULL for identity.
+* \param	nBlob			Number of blobs.
+* \param	blob			The blobs.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstRegCCorShiftObj(int size, WlzAffineTransform *tr,
+				int nBlob, WlzTstRegCCorShiftBlob *blob,
+				WlzErrorNum *dstErr)
+{
+  int		idB,
+  		idX,
+		idY;
+  WlzUByte	**ary = NULL;
+  WlzIVertex2	org,
+  		sz;
+  WlzObject	*obj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(AlcUnchar2Malloc(&ary, size, size) != ALC_ER_NONE)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    for(idY = 0; idY < size; ++idY)
+    {
+      for(idX = 0; idX < size; ++idX)
+      {
+	double	v = 0.0;
+	WlzDVertex2 p;
+
+	p.vtX = idX;
+	p.vtY = idY;
+	if(tr)
+	{
+	  p = WlzAffineTransformVertexD2(tr, p, NULL);
+	}
+	for(idB = 0; idB < nBlob; ++idB)
+	{
+	  double dx,
+	  	 dy;
+
+	  dx = p.vtX - blob[idB].x;
+	  dy = p.vtY - blob[idB].y;
+	  v += blob[idB].a * exp(-((dx * dx) + (dy * dy)) /
+	                         (2.0 * blob[idB].s * blob[idB].s));
+	}
+	ary[idY][idX] = (WlzUByte )WLZ_CLAMP(v, 0.0, 255.0);
+      }
+    }
+    org.vtX = org.vtY = 0;
+    sz.vtX = sz.vtY = size;
+    obj = WlzFromArray2D((void **)ary, sz, org, WLZ_GREY_UBYTE,
+			 WLZ_GREY_UBYTE, 0.0, 1.0, 0, 0, &errNum);
+    Alc2Free((void **)ary);
+  }
+  *dstErr = errNum;
+  return(obj);
+}
+
+/*!
+* \ingroup	BinWlzTst
+* \brief	Compares two 2D rigid body transforms by the distance
+* 		between the images of the image centre and by the
+* 		difference between their rotations. Both differences are
+* 		set to a large value if either transform is missing.
+* \param	dstDC			Destination pointer for the distance
+* 					between the images of the centre.
+* \param	dstDR			Destination pointer for the difference
+* 					between the rotations (degrees).
+* \param	tr0			First transform.
+* \param	tr1			Second transform.
+* \param	size			Width and height of the image.
+*/
+static void	WlzTstRegCCorShiftCmp(double *dstDC, double *dstDR,
+				       WlzAffineTransform *tr0,
+				       WlzAffineTransform *tr1, int size)
+{
+  double	dC = DBL_MAX,
+  		dR = DBL_MAX;
+  WlzDVertex2	p,
+  		q0,
+		q1;
+
+  if(tr0 && tr1)
+  {
+    p.vtX = p.vtY = 0.5 * (size - 1);
+    q0 = WlzAffineTransformVertexD2(tr0, p, NULL);
+    q1 = WlzAffineTransformVertexD2(tr1, p, NULL);
+    WLZ_VTX_2_SUB(q0, q0, q1);
+    dC = WLZ_VTX_2_LENGTH(q0);
+    dR = fabs(atan2(tr0->mat[1][0], tr0->mat[0][0]) -
+              atan2(tr1->mat[1][0], tr1->mat[0][0])) * 180.0 / WLZ_M_PI;
+  }
+  *dstDC = dC;
+  *dstDR = dR;
+}
@@ -0,0 +1,747 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstRegICP_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         WlzTstRegICP.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Benchmark for the point-to-point and point-to-plane
+*		iterative closest point registration functions.
+* \ingroup	BinWlzTst
+*/
+
+#include <sys/time.h>
+#include <math.h>
+#include <float.h>
+#include <string.h>
+#include <stdio.h>
+#include <Wlz.h>
+
+/* Externals required by getopt  - not in ANSI C standard */
+#ifdef __STDC__ /* [ */
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern int      optind, opterr, optopt;
+extern char     *optarg;
+#endif /* __STDC__ ] */
+
+typedef enum _WlzTstRegICPSolver
+{
+  WLZTST_REGICP_POINT = 0,   /* Point-to-point ICP, WlzRegICPVertices(). */
+  WLZTST_REGICP_PLANE,  /* Point-to-plane ICP, WlzRegICPVerticesPlane(). */
+  WLZTST_REGICP_CNT  /* Keep last, not a solver but the count of solvers. */
+} WlzTstRegICPSolver;
+
+typedef struct _WlzTstRegICPPair
+{
+  const char	*name;		/* Name of the contour pair. */
+  int		shape;		/* Target contour shape. */
+  double	rot;		/* Source rotation (degrees). */
+  double	tX;		/* Source column translation. */
+  double	tY;		/* Source line translation. */
+  double	sX;		/* Source column scale. */
+  double	sY;		/* Source line scale. */
+  double	shr;		/* Source shear. */
+  double	keep;		/* Fraction of the source contour kept. */
+  int		affine;		/* Non zero for affine registration. */
+} WlzTstRegICPPair;
+
+static WlzObject		*WlzTstRegICPMakeShape(
+				  int shape,
+				  WlzErrorNum *dstErr);
+static WlzObject		*WlzTstRegICPReadObj(
+				  char *fStr,
+				  WlzErrorNum *dstErr);
+static WlzErrorNum		WlzTstRegICPMakeSource(
+				  const WlzTstRegICPPair *pair,
+				  int tCnt,
+				  WlzDVertex2 *tVx,
+				  WlzDVertex2 *tNr,
+				  double noise,
+				  double outFrac,
+				  int *dstSCnt,
+				  int *dstInCnt,
+				  WlzDVertex2 **dstSVx,
+				  WlzDVertex2 **dstSNr,
+				  WlzDVertex2 **dstCVx);
+static void			WlzTstRegICPEval(
+				  AlcKDTTree *tree,
+				  WlzAffineTransform *tr,
+				  WlzVertexType vType,
+				  int sCnt,
+				  WlzVertexP sVx,
+				  int inCnt,
+				  WlzDVertex2 *cVx,
+				  double *dstRes,
+				  double *dstTrErr);
+static void 			WlzTstRegICPTimerStart(
+				  struct timeval *t);
+static double 			WlzTstRegICPTimerStop(
+				  struct timeval *t,
+				  double rep);
+
+/* Standard contour pairs. The source contours are the target contours
+ * transformed about their centroid. */
+static const WlzTstRegICPPair WlzTstRegICPStdPairs[] =
+{
+  {"circles-rigid",   0,  6.0,  5.0, -4.0, 1.00, 1.00, 0.00, 1.0, 0},
+  {"circles-affine",  0,  4.0, -3.0,  2.0, 1.04, 0.97, 0.03, 1.0, 1},
+  {"ring-rigid",      1, 10.0,  8.0,  6.0, 1.00, 1.00, 0.00, 1.0, 0},
+  {"box-rigid",       2,  8.0, -6.0,  5.0, 1.00, 1.00, 0.00, 1.0, 0},
+  {"box-affine",      2,  3.0,  4.0, -2.0, 0.96, 1.05, -0.04, 1.0, 1},
+  {"circles-partial", 0,  5.0,  4.0,  3.0, 1.00, 1.00, 0.00, 0.6, 0}
+};
+
+int		main(int argc, char *argv[])
+{
+  int		idP,
+  		idR,
+		idS,
+  		nPair,
+		option,
+		affine = 0,
+		usage = 0,
+		repeats = 1,
+		maxItr = 200,
+		nLvl = 3;
+  double	trim = 0.9,
+  		relTol = 1.0e-03,
+		delta = 0.1,
+		minDistWgt = 0.25,
+		noise = 0.0,
+		outFrac = 0.0;
+  char		*tFileStr = NULL,
+  		*sFileStr = NULL;
+  FILE		*fP = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  struct timeval times[3];
+  const char	*solverStr[WLZTST_REGICP_CNT] = {"point", "plane"};
+  static char	optList[] = "ahr:i:T:l:e:d:w:n:O:t:s:";
+  const WlzTstRegICPPair filePair =
+  {
+    "files", -1, 0.0, 0.0, 0.0, 1.0, 1.0, 0.0, 1.0, 0
+  };
+
+  fP = stdout;
+  while((usage == 0) && ((option = getopt(argc, argv, optList)) != EOF))
+  {
+    switch(option)
+    {
+      case 'a':
+        affine = 1;
+	break;
+      case 'r':
+        usage = (sscanf(optarg, "%d", &repeats) != 1) || (repeats < 1);
+	break;
+      case 'i':
+        usage = (sscanf(optarg, "%d", &maxItr) != 1) || (maxItr < 1);
+	break;
+      case 'T':
+        usage = (sscanf(optarg, "%lg", &trim) != 1) ||
+	        (trim <= 0.0) || (trim > 1.0);
+	break;
+      case 'l':
+        usage = (sscanf(optarg, "%d", &nLvl) != 1) || (nLvl < 1);
+	break;
+      case 'e':
+        usage = (sscanf(optarg, "%lg", &relTol) != 1) || (relTol < 0.0);
+	break;
+      case 'd':
+        usage = (sscanf(optarg, "%lg", &delta) != 1);
+	break;
+      case 'w':
+        usage = (sscanf(optarg, "%lg", &minDistWgt) != 1) ||
+	        (minDistWgt < 0.0) || (minDistWgt > 1.0);
+	break;
+      case 'n':
+        usage = (sscanf(optarg, "%lg", &noise) != 1) || (noise < 0.0);
+	break;
+      case 'O':
+        usage = (sscanf(optarg, "%lg", &outFrac) != 1) ||
+	        (outFrac < 0.0) || (outFrac > 1.0);
+	break;
+      case 't':
+        tFileStr = optarg;
+	break;
+      case 's':
+        sFileStr = optarg;
+	break;
+      case 'h':   /* FALLTHROUGH */
+      default:
+        usage = 1;
+	break;
+    }
+  }
+  if((usage == 0) && ((tFileStr == NULL) != (sFileStr == NULL)))
+  {
+    usage = 1;
+  }
+  if(usage)
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  nPair = (tFileStr)? 1:
+          sizeof(WlzTstRegICPStdPairs) / sizeof(WlzTstRegICPPair);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    (void )fprintf(fP, "%-16s %-6s %4s %5s %12s %12s %12s\n",
+		   "pair", "solver", "conv", "itr", "time", "residual",
+		   "trErr");
+  }
+  for(idP = 0; (errNum == WLZ_ERR_NONE) && (idP < nPair); ++idP)
+  {
+    int		tCnt = 0,
+    		sCnt = 0,
+		inCnt = 0;
+    int		*shfBuf = NULL;
+    WlzVertexType vType = WLZ_VERTEX_D2;
+    WlzTransformType trType;
+    WlzVertexP	tVx,
+    		tNr,
+		sVx,
+		sNr;
+    WlzDVertex2	*cVx = NULL;
+    WlzObject	*tObj = NULL,
+    		*sObj = NULL;
+    AlcKDTTree	*tree = NULL;
+    const WlzTstRegICPPair *pair;
+
+    tVx.v = tNr.v = sVx.v = sNr.v = NULL;
+    pair = (tFileStr)? &filePair: WlzTstRegICPStdPairs + idP;
+    /* Get the target and source vertices with their normals. */
+    if(tFileStr)
+    {
+      tObj = WlzTstRegICPReadObj(tFileStr, &errNum);
+      if(errNum == WLZ_ERR_NONE)
+      {
+        sObj = WlzTstRegICPReadObj(sFileStr, &errNum);
+      }
+    }
+    else
+    {
+      tObj = WlzTstRegICPMakeShape(pair->shape, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      tVx = WlzVerticesFromObj(tObj, &tNr, &tCnt, &vType, &errNum);
+      if((errNum == WLZ_ERR_NONE) && (tNr.v == NULL))
+      {
+        errNum = WLZ_ERR_PARAM_DATA;
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if(sObj)
+      {
+	WlzVertexType sVType;
+
+        sVx = WlzVerticesFromObj(sObj, &sNr, &sCnt, &sVType, &errNum);
+	if((errNum == WLZ_ERR_NONE) && (sVType != vType))
+	{
+	  errNum = WLZ_ERR_PARAM_TYPE;
+	}
+      }
+      else
+      {
+	errNum = WlzTstRegICPMakeSource(pair, tCnt, tVx.d2, tNr.d2,
+					noise, outFrac, &sCnt, &inCnt,
+					&(sVx.d2), &(sNr.d2), &cVx);
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if((shfBuf = (int *)AlcMalloc(sizeof(int) * tCnt)) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      else
+      {
+	tree = WlzVerticesBuildTree(vType, tCnt, tVx, shfBuf, &errNum);
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if(vType == WLZ_VERTEX_D2)
+      {
+        trType = (pair->affine || affine)? WLZ_TRANSFORM_2D_AFFINE:
+	                                   WLZ_TRANSFORM_2D_REG;
+      }
+      else
+      {
+        trType = (affine)? WLZ_TRANSFORM_3D_AFFINE: WLZ_TRANSFORM_3D_REG;
+      }
+    }
+    /* Register using each of the solvers. */
+    for(idS = 0; (errNum == WLZ_ERR_NONE) && (idS < WLZTST_REGICP_CNT);
+        ++idS)
+    {
+      int	conv = 0,
+      		itr = 0;
+      double	res = 0.0,
+      		trErr = 0.0,
+		tm;
+      WlzAffineTransform *tr = NULL;
+
+      WlzTstRegICPTimerStart(times);
+      for(idR = 0; (errNum == WLZ_ERR_NONE) && (idR < repeats); ++idR)
+      {
+        (void )WlzFreeAffineTransform(tr);
+	switch(idS)
+	{
+	  case WLZTST_REGICP_POINT:
+	    tr = WlzRegICPVertices(tVx, tNr, tCnt, sVx, sNr, sCnt, vType, 0,
+				   NULL, trType, &conv, &itr, maxItr,
+				   delta, minDistWgt, &errNum);
+	    break;
+	  case WLZTST_REGICP_PLANE:
+	    tr = WlzRegICPVerticesPlane(tVx, tNr, tCnt, sVx, sNr, sCnt,
+	    				vType, 0, NULL, trType, &conv, &itr,
+					maxItr, trim, nLvl, relTol, &errNum);
+	    break;
+	}
+	if(errNum == WLZ_ERR_ALG_CONVERGENCE)
+	{
+	  /* Report non-convergence rather than failing the benchmark. */
+	  errNum = WLZ_ERR_NONE;
+	}
+      }
+      tm = WlzTstRegICPTimerStop(times, repeats);
+      if(errNum == WLZ_ERR_NONE)
+      {
+	if(tr)
+	{
+	  WlzTstRegICPEval(tree, tr, vType, sCnt, sVx, inCnt, cVx,
+			   &res, &trErr);
+	  (void )fprintf(fP, "%-16s %-6s %4d %5d %12g %12g ",
+			 pair->name, solverStr[idS], conv, itr, tm, res);
+	  if(cVx)
+	  {
+	    (void )fprintf(fP, "%12g\n", trErr);
+	  }
+	  else
+	  {
+	    (void )fprintf(fP, "%12s\n", "-");
+	  }
+	}
+	else
+	{
+	  (void )fprintf(fP, "%-16s %-6s %4d %5d %12g %12s %12s\n",
+			 pair->name, solverStr[idS], conv, itr, tm, "-", "-");
+	}
+      }
+      (void )WlzFreeAffineTransform(tr);
+    }
+    (void )AlcKDTTreeFree(tree);
+    AlcFree(shfBuf);
+    AlcFree(tVx.v);
+    AlcFree(tNr.v);
+    AlcFree(sVx.v);
+    AlcFree(sNr.v);
+    AlcFree(cVx);
+    (void )WlzFreeObj(tObj);
+    (void )WlzFreeObj(sObj);
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    const char	*errMsg,
+    	 	*errStr;
+
+    errStr = WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Error - %s (%s)\n",
+                   argv[0], errMsg, errStr);
+  }
+  if(usage != 0)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s [-h] [-a] [-r#] [-i#] [-T#] [-l#] [-e#] [-d#] [-w#]\n"
+    "       [-n#] [-O#] [-t<target file> -s<source file>]\n"
+    "Benchmarks the point-to-point (WlzRegICPVertices) and the trimmed\n"
+    "coarse to fine point-to-plane (WlzRegICPVerticesPlane) ICP\n"
+    "registration functions. Unless target and source files are given\n"
+    "a set of standard 2D contour pairs is used, for which the source\n"
+    "contours are the target contours transformed by known transforms.\n"
+    "For each pair and solver the output gives the convergence flag,\n"
+    "the number of iterations, the mean time (seconds), the root mean\n"
+    "square distance from the registered source vertices to their\n"
+    "nearest target vertices and (for the standard pairs only) the\n"
+    "root mean square error of the registered source vertices with\n"
+    "respect to their known positions.\n"
+    "Options with current values in brackets are:\n"
+    "  -h  Help, prints this usage message.\n"
+    "  -a  Affine rather than rigid body registration for the given\n"
+    "      files (%s).\n"
+    "  -r  Number of repeats for timing (%d).\n"
+    "  -i  Maximum number of iterations (%d).\n"
+    "  -T  Fraction of matches used by the point-to-plane solver (%g).\n"
+    "  -l  Number of coarse to fine levels for the point-to-plane\n"
+    "      solver (%d).\n"
+    "  -e  Relative tolerance for the point-to-plane solver (%g).\n"
+    "  -d  Convergence tolerance for the point-to-point solver (%g).\n"
+    "  -w  Minimum distance weight for the point-to-point solver (%g).\n"
+    "  -n  Standard deviation of the noise added to the standard\n"
+    "      source contours (%g).\n"
+    "  -O  Fraction of outlier vertices added to the standard source\n"
+    "      contours (%g).\n"
+    "  -t  Target object file (%s).\n"
+    "  -s  Source object file (%s).\n",
+    argv[0],
+    (affine)? "true": "false",
+    repeats,
+    maxItr,
+    trim,
+    nLvl,
+    relTol,
+    delta,
+    minDistWgt,
+    noise,
+    outFrac,
+    (tFileStr)? tFileStr: "null",
+    (sFileStr)? sFileStr: "null");
+  }
+  return(errNum);
+}
+
+/*!
+* \return	New contour object.
+* \ingroup	BinWlzTst
+* \brief	Creates a 2D contour object for one of the standard
+*		target shapes: 0 a union of circles, 1 a ring of
+*		circles of increasing radius and 2 a rectangle with a
+*		circular boss.
+* \param	shape			Shape index.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstRegICPMakeShape(int shape, WlzErrorNum *dstErr)
+{
+  int		idx,
+  		nCmp;
+  double	ang;
+  WlzDomain	dom;
+  WlzValues	val;
+  WlzObject	*cmpObj,
+  		*tObj,
+		*uObj = NULL,
+		*cObj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  val.core = NULL;
+  nCmp = (shape == 2)? 2: 6;
+  for(idx = 0; (errNum == WLZ_ERR_NONE) && (idx < nCmp); ++idx)
+  {
+    switch(shape)
+    {
+      case 0:
+	cmpObj = WlzMakeCircleObject(10.0 + (3.0 * idx),
+				     60.0 + ((idx % 3) * 40.0),
+				     60.0 + ((idx / 3) * 40.0), &errNum);
+	break;
+      case 1:
+	ang = (2.0 * ALG_M_PI * idx) / nCmp;
+	cmpObj = WlzMakeCircleObject(12.0 + (4.0 * idx),
+				     150.0 + (60.0 * cos(ang)),
+				     150.0 + (60.0 * sin(ang)), &errNum);
+	break;
+      default:
+	cmpObj = (idx == 0)?
+		 WlzMakeRectangleObject(80.0, 40.0, 150.0, 100.0, &errNum):
+		 WlzMakeCircleObject(30.0, 210.0, 140.0, &errNum);
+	break;
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if(uObj == NULL)
+      {
+	uObj = cmpObj;
+      }
+      else
+      {
+	tObj = WlzUnion2(uObj, cmpObj, &errNum);
+	(void )WlzFreeObj(uObj);
+	(void )WlzFreeObj(cmpObj);
+	uObj = tObj;
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    dom.ctr = WlzContourObj(uObj, WLZ_CONTOUR_MTD_BND, 0.0, 1.0, 1,
+    			    &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    cObj = WlzMakeMain(WLZ_CONTOUR, dom, val, NULL, NULL, &errNum);
+  }
+  (void )WlzFreeObj(uObj);
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(cObj);
+}
+
+/*!
+* \return	Object read from the file.
+* \ingroup	BinWlzTst
+* \brief	Reads an object from the given file.
+* \param	fStr			File name, "-" for the standard input.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstRegICPReadObj(char *fStr, WlzErrorNum *dstErr)
+{
+  FILE		*fP;
+  WlzObject	*obj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_READ_EOF;
+
+  if((fP = (strcmp(fStr, "-")? fopen(fStr, "r"): stdin)) != NULL)
+  {
+    obj = WlzReadObj(fP, &errNum);
+    if(strcmp(fStr, "-"))
+    {
+      (void )fclose(fP);
+    }
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(obj);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	BinWlzTst
+* \brief	Creates the source vertices and normals for a standard pair
+*		by transforming the target vertices about their centroid,
+*		keeping only the given fraction of the contour, adding
+*		noise and then appending outlier vertices.
+* \param	pair			The standard pair.
+* \param	tCnt			Number of target vertices.
+* \param	tVx			Target vertices.
+* \param	tNr			Target normals.
+* \param	noise			Standard deviation of the noise.
+* \param	outFrac			Fraction of outlier vertices.
+* \param	dstSCnt			Destination for the number of source
+*					vertices.
+* \param	dstInCnt		Destination for the number of source
+*					vertices which are not outliers.
+* \param	dstSVx			Destination for the source vertices.
+* \param	dstSNr			Destination for the source normals.
+* \param	dstCVx			Destination for the target vertices
+*					corresponding to the first
+*					*dstInCnt source vertices.
+*/
+static WlzErrorNum WlzTstRegICPMakeSource(const WlzTstRegICPPair *pair,
+				int tCnt, WlzDVertex2 *tVx, WlzDVertex2 *tNr,
+				double noise, double outFrac,
+				int *dstSCnt, int *dstInCnt,
+				WlzDVertex2 **dstSVx, WlzDVertex2 **dstSNr,
+				WlzDVertex2 **dstCVx)
+{
+  int		idx,
+  		inCnt,
+		outCnt;
+  double	ang,
+  		cA,
+		sA;
+  double	trD[3][3];
+  double	*trA[3];
+  WlzDVertex2	c,
+		v,
+  		bMin,
+		bMax;
+  WlzDVertex2	*sVx = NULL,
+  		*sNr = NULL,
+		*cVx = NULL;
+  WlzAffineTransform *tr = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  inCnt = (int )ceil(pair->keep * tCnt);
+  outCnt = (int )ceil(outFrac * inCnt);
+  if(((sVx = (WlzDVertex2 *)
+             AlcMalloc(sizeof(WlzDVertex2) * (inCnt + outCnt))) == NULL) ||
+     ((sNr = (WlzDVertex2 *)
+             AlcMalloc(sizeof(WlzDVertex2) * (inCnt + outCnt))) == NULL) ||
+     ((cVx = (WlzDVertex2 *)
+             AlcMalloc(sizeof(WlzDVertex2) * inCnt)) == NULL))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    /* x' = R S (x - c) + c + t, where S is scale with shear. */
+    WLZ_VTX_2_ZERO(c);
+    for(idx = 0; idx < tCnt; ++idx)
+    {
+      WLZ_VTX_2_ADD(c, c, tVx[idx]);
+    }
+    WLZ_VTX_2_SCALE(c, c, 1.0 / tCnt);
+    ang = pair->rot * ALG_M_PI / 180.0;
+    cA = cos(ang);
+    sA = sin(ang);
+    trA[0] = trD[0];
+    trA[1] = trD[1];
+    trA[2] = trD[2];
+    trD[0][0] = cA * pair->sX;
+    trD[0][1] = (cA * pair->shr) - (sA * pair->sY);
+    trD[1][0] = sA * pair->sX;
+    trD[1][1] = (sA * pair->shr) + (cA * pair->sY);
+    trD[0][2] = c.vtX + pair->tX - (trD[0][0] * c.vtX) - (trD[0][1] * c.vtY);
+    trD[1][2] = c.vtY + pair->tY - (trD[1][0] * c.vtX) - (trD[1][1] * c.vtY);
+    trD[2][0] = trD[2][1] = 0.0;
+    trD[2][2] = 1.0;
+    tr = WlzAffineTransformFromMatrix(WLZ_TRANSFORM_2D_AFFINE, trA, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    AlgRandSeed(0);
+    bMin.vtX = bMin.vtY = DBL_MAX;
+    bMax.vtX = bMax.vtY = -DBL_MAX;
+    for(idx = 0; idx < inCnt; ++idx)
+    {
+      cVx[idx] = tVx[idx];
+      v = WlzAffineTransformVertexD2(tr, tVx[idx], NULL);
+      if(noise > DBL_EPSILON)
+      {
+        v.vtX += AlgRandNormal(0.0, noise);
+        v.vtY += AlgRandNormal(0.0, noise);
+      }
+      sVx[idx] = v;
+      sNr[idx] = WlzAffineTransformNormalD2(tr, tNr[idx], NULL);
+      bMin.vtX = WLZ_MIN(bMin.vtX, v.vtX);
+      bMin.vtY = WLZ_MIN(bMin.vtY, v.vtY);
+      bMax.vtX = WLZ_MAX(bMax.vtX, v.vtX);
+      bMax.vtY = WLZ_MAX(bMax.vtY, v.vtY);
+    }
+    for(idx = inCnt; idx < inCnt + outCnt; ++idx)
+    {
+      ang = 2.0 * ALG_M_PI * AlgRandUniform();
+      sVx[idx].vtX = bMin.vtX + ((bMax.vtX - bMin.vtX) * AlgRandUniform());
+      sVx[idx].vtY = bMin.vtY + ((bMax.vtY - bMin.vtY) * AlgRandUniform());
+      sNr[idx].vtX = cos(ang);
+      sNr[idx].vtY = sin(ang);
+    }
+    *dstSCnt = inCnt + outCnt;
+    *dstInCnt = inCnt;
+    *dstSVx = sVx;
+    *dstSNr = sNr;
+    *dstCVx = cVx;
+  }
+  else
+  {
+    AlcFree(sVx);
+    AlcFree(sNr);
+    AlcFree(cVx);
+  }
+  (void )WlzFreeAffineTransform(tr);
+  return(errNum);
+}
+
+/*!
+* \ingroup	BinWlzTst
+* \brief	Evaluates a registration, computing the root mean square
+*		distance from the registered source vertices to their
+*		nearest target vertices and, if the corresponding target
+*		vertices are known, the root mean square distance from the
+*		registered source vertices to them.
+* \param	tree			kD-tree of the target vertices.
+* \param	tr			Registration transform.
+* \param	vType			Type of vertices.
+* \param	sCnt			Number of source vertices.
+* \param	sVx			Source vertices.
+* \param	inCnt			Number of source vertices with known
+*					corresponding target vertices.
+* \param	cVx			Target vertices corresponding to the
+*					first inCnt source vertices, may be
+*					NULL.
+* \param	dstRes			Destination for the residual.
+* \param	dstTrErr		Destination for the registration error.
+*/
+static void	WlzTstRegICPEval(AlcKDTTree *tree, WlzAffineTransform *tr,
+				 WlzVertexType vType, int sCnt,
+				 WlzVertexP sVx, int inCnt, WlzDVertex2 *cVx,
+				 double *dstRes, double *dstTrErr)
+{
+  int		idx;
+  double	dist,
+		sumD2 = 0.0,
+		sumE2 = 0.0;
+  double	datD[3];
+  WlzDVertex2	v2;
+  WlzDVertex3	v3;
+
+  for(idx = 0; idx < sCnt; ++idx)
+  {
+    if(vType == WLZ_VERTEX_D2)
+    {
+      v2 = WlzAffineTransformVertexD2(tr, sVx.d2[idx], NULL);
+      datD[0] = v2.vtX;
+      datD[1] = v2.vtY;
+      if(cVx && (idx < inCnt))
+      {
+        WLZ_VTX_2_SUB(v2, v2, cVx[idx]);
+	sumE2 += WLZ_VTX_2_SQRLEN(v2);
+      }
+    }
+    else
+    {
+      v3 = WlzAffineTransformVertexD3(tr, sVx.d3[idx], NULL);
+      datD[0] = v3.vtX;
+      datD[1] = v3.vtY;
+      datD[2] = v3.vtZ;
+    }
+    dist = 0.0;
+    (void )AlcKDTGetNN(tree, datD, DBL_MAX, &dist, NULL);
+    sumD2 += dist * dist;
+  }
+  *dstRes = (sCnt > 0)? sqrt(sumD2 / sCnt): 0.0;
+  *dstTrErr = (inCnt > 0)? sqrt(sumE2 / inCnt): 0.0;
+}
+
+static void WlzTstRegICPTimerStart(struct timeval *t)
+{
+  gettimeofday(t + 0, NULL);
+}
+
+static double WlzTstRegICPTimerStop(struct timeval *t, double rep)
+{
+  double s;
+
+  gettimeofday(t + 1, NULL);
+  ALC_TIMERSUB(t + 1, t + 0, t + 2);
+  s = t[2].tv_sec + (0.000001 * t[2].tv_usec);
+  if(rep > 0)
+  {
+    s /= rep;
+  }
+  return(s);
+}
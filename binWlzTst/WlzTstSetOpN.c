@@ -0,0 +1,532 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstSetOpN_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstSetOpN.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for WlzSetOpN(), WlzUnionN() and WlzIntersectN().
+* 		Overlapping 2 and 3D objects with integer values are
+* 		combined with every minimum coverage by WlzSetOpN() and
+* 		the domains and mean values are compared with those
+* 		found by counting, at every pixel/voxel, the objects
+* 		which cover it. The unions and intersections are also
+* 		compared with those built pairwise by WlzUnion2() and
+* 		WlzIntersect2(), and with WlzUnionN() and WlzIntersectN().
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+static WlzObject		*WlzTstSetOpNMakeObj(
+				  WlzObjectType oType,
+				  int idO,
+				  WlzErrorNum *dstErr);
+static WlzObject		*WlzTstSetOpNPairwise(
+				  int n,
+				  WlzObject **objs,
+				  int uni,
+				  WlzErrorNum *dstErr);
+static int			WlzTstSetOpNCmpCov(
+				  int n,
+				  WlzObject **objs,
+				  WlzObject *rObj,
+				  int minCov,
+				  int uvt,
+				  WlzIBox3 box,
+				  WlzErrorNum *dstErr);
+static int			WlzTstSetOpNCmpDom(
+				  WlzObject *obj0,
+				  WlzObject *obj1,
+				  WlzIBox3 box,
+				  WlzErrorNum *dstErr);
+
+int		main(int argc, char *argv[])
+{
+  int		idD,
+  		idO,
+		idC,
+		idU,
+		option,
+		ok = 1,
+		usage = 0,
+		verbose = 0;
+  WlzIBox3	box;
+  WlzObject	*rObj = NULL,
+  		*pObj = NULL;
+  WlzObject	*objs[6] = {NULL};
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  const int	nObj = 6;
+  const WlzObjectType oTypes[2] = {WLZ_2D_DOMAINOBJ, WLZ_3D_DOMAINOBJ};
+  static char	optList[] = "hv";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0) && (optind == argc);
+  usage = !ok;
+  for(idD = 0; ok && (errNum == WLZ_ERR_NONE) && (idD < 2); ++idD)
+  {
+    /* The last object is empty. */
+    for(idO = 0; (errNum == WLZ_ERR_NONE) && (idO < nObj); ++idO)
+    {
+      objs[idO] = WlzAssignObject(
+                  WlzTstSetOpNMakeObj(oTypes[idD], idO, &errNum), NULL);
+    }
+    /* Box covering all of the objects with a margin. */
+    for(idO = 0; (errNum == WLZ_ERR_NONE) && (idO < nObj - 1); ++idO)
+    {
+      WlzIBox3	b;
+
+      b = WlzBoundingBox3I(objs[idO], &errNum);
+      if(idO == 0)
+      {
+        box = b;
+      }
+      else
+      {
+	box.xMin = WLZ_MIN(box.xMin, b.xMin);
+	box.yMin = WLZ_MIN(box.yMin, b.yMin);
+	box.zMin = WLZ_MIN(box.zMin, b.zMin);
+	box.xMax = WLZ_MAX(box.xMax, b.xMax);
+	box.yMax = WLZ_MAX(box.yMax, b.yMax);
+	box.zMax = WLZ_MAX(box.zMax, b.zMax);
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      box.xMin -= 2;
+      box.yMin -= 2;
+      box.xMax += 2;
+      box.yMax += 2;
+      if(idD > 0)
+      {
+        box.zMin -= 2;
+	box.zMax += 2;
+      }
+    }
+    /* Every minimum coverage, with and without values, including the
+     * empty object. */
+    for(idC = 1; ok && (errNum == WLZ_ERR_NONE) && (idC < nObj); ++idC)
+    {
+      for(idU = 0; ok && (errNum == WLZ_ERR_NONE) && (idU < 2); ++idU)
+      {
+	rObj = WlzAssignObject(WlzSetOpN(nObj, objs, idC, idU, &errNum),
+			       NULL);
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  ok = WlzTstSetOpNCmpCov(nObj, objs, rObj, idC, idU, box, &errNum);
+	  if(verbose || !ok)
+	  {
+	    (void )fprintf(stderr, "%s: %dD coverage %d%s %s.\n",
+			   *argv, idD + 2, idC, (idU)? " with values": "",
+			   (ok)? "ok": "differs from the coverage count");
+	  }
+	}
+	(void )WlzFreeObj(rObj);
+	rObj = NULL;
+      }
+    }
+    /* Union and intersection of the non-empty objects, pairwise and by
+     * WlzUnionN() and WlzIntersectN(). */
+    for(idU = 0; ok && (errNum == WLZ_ERR_NONE) && (idU < 2); ++idU)
+    {
+      int	n;
+
+      n = nObj - 1;
+      pObj = WlzAssignObject(WlzTstSetOpNPairwise(n, objs, idU, &errNum),
+      			     NULL);
+      if(errNum == WLZ_ERR_NONE)
+      {
+	rObj = WlzAssignObject(
+	       WlzSetOpN(n, objs, (idU)? 1: n, 0, &errNum), NULL);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+	ok = WlzTstSetOpNCmpDom(pObj, rObj, box, &errNum);
+      }
+      (void )WlzFreeObj(rObj);
+      rObj = NULL;
+      if(ok && (errNum == WLZ_ERR_NONE))
+      {
+	rObj = WlzAssignObject((idU)? WlzUnionN(n, objs, 1, &errNum):
+				      WlzIntersectN(n, objs, 1, &errNum),
+			       NULL);
+      }
+      if(ok && (errNum == WLZ_ERR_NONE))
+      {
+	ok = WlzTstSetOpNCmpDom(pObj, rObj, box, &errNum) &&
+	     (errNum == WLZ_ERR_NONE) &&
+	     WlzTstSetOpNCmpCov(n, objs, rObj, (idU)? 1: n, 1, box, &errNum);
+      }
+      if(verbose || !ok)
+      {
+	(void )fprintf(stderr, "%s: %dD %s %s.\n",
+		       *argv, idD + 2, (idU)? "union": "intersection",
+		       (ok)? "ok": "differs from the pairwise result");
+      }
+      (void )WlzFreeObj(rObj);
+      (void )WlzFreeObj(pObj);
+      rObj = pObj = NULL;
+    }
+    for(idO = 0; idO < nObj; ++idO)
+    {
+      (void )WlzFreeObj(objs[idO]);
+      objs[idO] = NULL;
+    }
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to test N-ary set operations (%s).\n",
+		   *argv, errMsg);
+  }
+  if(ok)
+  {
+    (void )printf("%s: N-ary set operations match coverage counts and "
+    		  "pairwise unions and intersections.\n", *argv);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-v]\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -v  Verbose output.\n"
+    "Tests WlzSetOpN(), WlzUnionN() and WlzIntersectN() by comparing\n"
+    "their domains and mean values with those found by counting the\n"
+    "objects which cover each pixel/voxel and with unions and\n"
+    "intersections built pairwise.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New object or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Makes one of the test objects, a sphere (or disc) with
+* 		a hole and integer values, or for the last object an
+* 		empty object.
+* \param	oType			Object type, 2 or 3D domain object.
+* \param	idO			Index of the object.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstSetOpNMakeObj(WlzObjectType oType, int idO,
+				      WlzErrorNum *dstErr)
+{
+  WlzObjectType	vType;
+  WlzIBox3	box;
+  WlzPixelV	bgdV;
+  WlzObject	*sObj = NULL,
+  		*hObj = NULL,
+		*dObj = NULL,
+		*obj = NULL;
+  WlzGreyValueWSpace *gVWSp = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const int	nSph = 5;
+  const double	sph[5][4] = {{14.0,  0.0,  0.0, 0.0},
+  			     {10.0,  9.0,  4.0, 2.0},
+			     {12.0,  5.0, 11.0, 4.0},
+			     { 9.0,  1.0,  6.0, 4.0},
+			     {11.0,  7.0,  5.0, 5.0}};
+
+  if(idO >= nSph)
+  {
+    obj = WlzMakeEmpty(&errNum);
+  }
+  else
+  {
+    bgdV.type = WLZ_GREY_INT;
+    bgdV.v.inv = idO;
+    sObj = WlzAssignObject(
+	   WlzMakeSphereObject(oType, sph[idO][0], sph[idO][1],
+	                       sph[idO][2], sph[idO][3], &errNum), NULL);
+    /* A hole gives lines with several intervals. */
+    if(errNum == WLZ_ERR_NONE)
+    {
+      hObj = WlzAssignObject(
+	     WlzMakeSphereObject(oType, sph[idO][0] / 3.0,
+	                         sph[idO][1] + 2.0, sph[idO][2],
+				 sph[idO][3], &errNum), NULL);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      dObj = WlzAssignObject(WlzDiffDomain(sObj, hObj, &errNum), NULL);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      vType = WlzGreyTableType(WLZ_GREY_TAB_RAGR, WLZ_GREY_INT, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      obj = WlzNewObjectValues(dObj, vType, bgdV, 0, bgdV, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      box = WlzBoundingBox3I(obj, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      gVWSp = WlzGreyValueMakeWSp(obj, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      int	idP,
+		idL,
+		idK;
+
+      for(idP = box.zMin; idP <= box.zMax; ++idP)
+      {
+	for(idL = box.yMin; idL <= box.yMax; ++idL)
+	{
+	  for(idK = box.xMin; idK <= box.xMax; ++idK)
+	  {
+	    if(WlzInsideDomain(obj, idP, idL, idK, NULL))
+	    {
+	      WlzGreyValueGet(gVWSp, idP, idL, idK);
+	      *(gVWSp->gPtr[0].inp) = (idK * 7) + (idL * 13) + (idP * 3) +
+	      			      (idO * 101);
+	    }
+	  }
+	}
+      }
+    }
+    WlzGreyValueFreeWSp(gVWSp);
+    (void )WlzFreeObj(sObj);
+    (void )WlzFreeObj(hObj);
+    (void )WlzFreeObj(dObj);
+  }
+  if((errNum != WLZ_ERR_NONE) && (obj != NULL))
+  {
+    (void )WlzFreeObj(obj);
+    obj = NULL;
+  }
+  *dstErr = errNum;
+  return(obj);
+}
+
+/*!
+* \return	New object or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Computes the union or intersection of the given objects
+* 		pairwise using WlzUnion2() or WlzIntersect2().
+* \param	n			Number of objects.
+* \param	objs			Array of objects.
+* \param	uni			Union if non-zero, otherwise
+* 					intersection.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstSetOpNPairwise(int n, WlzObject **objs, int uni,
+				       WlzErrorNum *dstErr)
+{
+  int		idO;
+  WlzObject	*obj,
+  		*tObj;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  obj = WlzAssignObject(objs[0], NULL);
+  for(idO = 1; (errNum == WLZ_ERR_NONE) && (idO < n); ++idO)
+  {
+    tObj = (uni)? WlzUnion2(obj, objs[idO], &errNum):
+                  WlzIntersect2(obj, objs[idO], &errNum);
+    (void )WlzFreeObj(obj);
+    obj = WlzAssignObject(tObj, NULL);
+  }
+  if((errNum != WLZ_ERR_NONE) && (obj != NULL))
+  {
+    (void )WlzFreeObj(obj);
+    obj = NULL;
+  }
+  *dstErr = errNum;
+  return(obj);
+}
+
+/*!
+* \return	Non-zero if the result matches the coverage counts.
+* \ingroup	BinWlzTst
+* \brief	Checks that every pixel/voxel of the given box is within
+* 		the result object if and only if it is covered by at
+* 		least the given number of objects and, if values are
+* 		required, that the result's value is the mean of the
+* 		values of the covering objects (truncated as for
+* 		integer grey types).
+* \param	n			Number of objects.
+* \param	objs			Array of objects.
+* \param	rObj			Result object.
+* \param	minCov			Minimum coverage.
+* \param	uvt			Check values if non-zero.
+* \param	box			Box to check.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstSetOpNCmpCov(int n, WlzObject **objs,
+				   WlzObject *rObj, int minCov, int uvt,
+				   WlzIBox3 box, WlzErrorNum *dstErr)
+{
+  int		idO,
+  		eq = 0;
+  WlzGreyValueWSpace *rVWSp = NULL;
+  WlzGreyValueWSpace **gVWSp = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((gVWSp = (WlzGreyValueWSpace **)
+              AlcCalloc(n, sizeof(WlzGreyValueWSpace *))) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  for(idO = 0; uvt && (errNum == WLZ_ERR_NONE) && (idO < n); ++idO)
+  {
+    if(objs[idO]->type != WLZ_EMPTY_OBJ)
+    {
+      gVWSp[idO] = WlzGreyValueMakeWSp(objs[idO], &errNum);
+    }
+  }
+  if(uvt && (errNum == WLZ_ERR_NONE) && (rObj->type != WLZ_EMPTY_OBJ))
+  {
+    rVWSp = WlzGreyValueMakeWSp(rObj, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idP,
+    		idL,
+		idK;
+
+    eq = 1;
+    for(idP = box.zMin; eq && (idP <= box.zMax); ++idP)
+    {
+      for(idL = box.yMin; eq && (idL <= box.yMax); ++idL)
+      {
+	for(idK = box.xMin; eq && (idK <= box.xMax); ++idK)
+	{
+	  int	cnt = 0,
+	  	in;
+	  double sum = 0.0;
+
+	  for(idO = 0; idO < n; ++idO)
+	  {
+	    if((objs[idO]->type != WLZ_EMPTY_OBJ) &&
+	       WlzInsideDomain(objs[idO], idP, idL, idK, NULL))
+	    {
+	      ++cnt;
+	      if(uvt)
+	      {
+		WlzGreyValueGet(gVWSp[idO], idP, idL, idK);
+		sum += gVWSp[idO]->gVal[0].inv;
+	      }
+	    }
+	  }
+	  in = (rObj->type != WLZ_EMPTY_OBJ) &&
+	       WlzInsideDomain(rObj, idP, idL, idK, NULL);
+	  eq = (in != 0) == (cnt >= minCov);
+	  if(eq && in && uvt)
+	  {
+	    WlzGreyValueGet(rVWSp, idP, idL, idK);
+	    eq = (rVWSp->gType == WLZ_GREY_INT) &&
+	         (rVWSp->gVal[0].inv == (int )(sum / cnt));
+	  }
+	}
+      }
+    }
+  }
+  for(idO = 0; (gVWSp != NULL) && (idO < n); ++idO)
+  {
+    WlzGreyValueFreeWSp(gVWSp[idO]);
+  }
+  AlcFree(gVWSp);
+  WlzGreyValueFreeWSp(rVWSp);
+  *dstErr = errNum;
+  return(eq);
+}
+
+/*!
+* \return	Non-zero if the domains are the same within the box.
+* \ingroup	BinWlzTst
+* \brief	Compares the domains of two objects at every pixel/voxel
+* 		of the given box.
+* \param	obj0			First object.
+* \param	obj1			Second object.
+* \param	box			Box to check.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstSetOpNCmpDom(WlzObject *obj0, WlzObject *obj1,
+				   WlzIBox3 box, WlzErrorNum *dstErr)
+{
+  int		idP,
+  		idL,
+		idK,
+		eq = 1;
+
+  for(idP = box.zMin; eq && (idP <= box.zMax); ++idP)
+  {
+    for(idL = box.yMin; eq && (idL <= box.yMax); ++idL)
+    {
+      for(idK = box.xMin; eq && (idK <= box.xMax); ++idK)
+      {
+        int	in0,
+		in1;
+
+	in0 = (obj0->type != WLZ_EMPTY_OBJ) &&
+	      WlzInsideDomain(obj0, idP, idL, idK, NULL);
+	in1 = (obj1->type != WLZ_EMPTY_OBJ) &&
+	      WlzInsideDomain(obj1, idP, idL, idK, NULL);
+	eq = (in0 != 0) == (in1 != 0);
+      }
+    }
+  }
+  *dstErr = WLZ_ERR_NONE;
+  return(eq);
+}
@@ -0,0 +1,452 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstStack3D_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstStack3D.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for the concurrent reading of 3D objects from
+* 		section files, by WlzEffReadObjStack() and by
+* 		WlzConstruct3DObjFromFile(). A 3D object is written as
+* 		a stack of PNM sections and as 2D Woolz sections, which
+* 		are then read back concurrently and compared with the
+* 		original. Reading is also checked to fail cleanly when
+* 		a section file is missing.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <Wlz.h>
+#include <WlzExtFF.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+static WlzObject		*WlzTstStack3DMakeObj(
+				  int nX,
+				  int nY,
+				  int nZ,
+				  WlzErrorNum *dstErr);
+static int			WlzTstStack3DCmpObj(
+				  WlzObject *obj0,
+				  WlzObject *obj1,
+				  int skipPl,
+				  WlzErrorNum *dstErr);
+
+int		main(int argc, char *argv[])
+{
+  int		idP,
+		option,
+		ok = 1,
+		usage = 0,
+		verbose = 0,
+		nZ = 24;
+  char		*dir = NULL,
+		*stkStr = NULL;
+  char		**secStr = NULL;
+  WlzObject	*obj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  const int	nX = 67,
+  		nY = 45,
+		skipPl = 5;
+  static char	optList[] = "hvz:";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'v':
+        verbose = 1;
+	break;
+      case 'z':
+        if((sscanf(optarg, "%d", &nZ) != 1) || (nZ <= skipPl))
+	{
+	  usage = 1;
+	}
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0) && (optind == argc);
+  usage = !ok;
+  if(ok)
+  {
+    obj = WlzAssignObject(WlzTstStack3DMakeObj(nX, nY, nZ, &errNum), NULL);
+  }
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    if(((dir = AlcStrDup("/tmp/WlzTstStack3DXXXXXX")) == NULL) ||
+       (mkdtemp(dir) == NULL))
+    {
+      errNum = WLZ_ERR_WRITE_EOF;
+    }
+    else if(((stkStr = (char *)AlcMalloc(strlen(dir) + 32)) == NULL) ||
+            ((secStr = (char **)AlcCalloc(nZ, sizeof(char *))) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  /* Stack of PNM sections read by WlzEffReadObjStack(). */
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    WlzObject	*rObj = NULL;
+
+    (void )sprintf(stkStr, "%s/stk.pgm", dir);
+    errNum = WlzEffWriteObjStack(stkStr, WLZEFF_FORMAT_PNM, obj);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      rObj = WlzAssignObject(
+             WlzEffReadObjStack(stkStr, WLZEFF_FORMAT_PNM, &errNum), NULL);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      ok = WlzTstStack3DCmpObj(obj, rObj, -1, &errNum);
+      if(!ok)
+      {
+        (void )fprintf(stderr, "%s: Stack of sections read differs from "
+		       "that written.\n", *argv);
+      }
+      else if(verbose)
+      {
+        (void )fprintf(stderr, "%s: stack of %d PNM sections ok\n",
+		       *argv, nZ);
+      }
+    }
+    (void )WlzFreeObj(rObj);
+  }
+  /* Remove a section file, reading the stack should now fail. */
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    WlzObject	*rObj;
+    WlzErrorNum	errNum2 = WLZ_ERR_NONE;
+
+    (void )sprintf(stkStr, "%s/stk%0*d.pgm", dir,
+    		   WLZEFF_STACK_NAMEDIGITS, skipPl);
+    if(unlink(stkStr) != 0)
+    {
+      errNum = WLZ_ERR_FILE_OPEN;
+    }
+    else
+    {
+      (void )sprintf(stkStr, "%s/stk.pgm", dir);
+      rObj = WlzEffReadObjStack(stkStr, WLZEFF_FORMAT_PNM, &errNum2);
+      if((rObj != NULL) || (errNum2 == WLZ_ERR_NONE))
+      {
+        ok = 0;
+	(void )fprintf(stderr, "%s: Missing PNM section not detected.\n",
+		       *argv);
+	(void )WlzFreeObj(rObj);
+      }
+      else if(verbose)
+      {
+	(void )WlzStringFromErrorNum(errNum2, &errMsg);
+	(void )fprintf(stderr, "%s: missing PNM section gives %s\n",
+		       *argv, errMsg);
+      }
+    }
+  }
+  /* 2D Woolz sections, with one empty plane, read by
+   * WlzConstruct3DObjFromFile(). */
+  for(idP = 0; ok && (errNum == WLZ_ERR_NONE) && (idP < nZ); ++idP)
+  {
+    if(idP != skipPl)
+    {
+      FILE	*fP = NULL;
+
+      if((secStr[idP] = (char *)AlcMalloc(strlen(dir) + 32)) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      else
+      {
+	(void )sprintf(secStr[idP], "%s/sec%06d.wlz", dir, idP);
+	if((fP = fopen(secStr[idP], "w")) == NULL)
+	{
+	  errNum = WLZ_ERR_WRITE_EOF;
+	}
+	else
+	{
+	  WlzObject *pObj;
+
+	  pObj = WlzMakeMain(WLZ_2D_DOMAINOBJ,
+	  		     obj->domain.p->domains[idP],
+			     obj->values.vox->values[idP], NULL, NULL,
+			     &errNum);
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    errNum = WlzWriteObj(fP, pObj);
+	  }
+	  (void )WlzFreeObj(pObj);
+	  if(fclose(fP) != 0)
+	  {
+	    errNum = WLZ_ERR_WRITE_EOF;
+	  }
+	}
+      }
+    }
+  }
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    WlzObject	*rObj;
+
+    rObj = WlzAssignObject(
+           WlzConstruct3DObjFromFile(nZ, secStr, 0, 1.0f, 1.0f, 1.0f,
+				     &errNum), NULL);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      ok = WlzTstStack3DCmpObj(obj, rObj, skipPl, &errNum);
+      if(!ok)
+      {
+        (void )fprintf(stderr, "%s: Object constructed from sections "
+		       "differs from that written.\n", *argv);
+      }
+      else if(verbose)
+      {
+        (void )fprintf(stderr, "%s: %d Woolz sections with an empty "
+		       "plane ok\n", *argv, nZ);
+      }
+    }
+    (void )WlzFreeObj(rObj);
+  }
+  /* Remove the last section file, construction should now fail. */
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    WlzObject	*rObj;
+    WlzErrorNum	errNum2 = WLZ_ERR_NONE;
+
+    if(unlink(secStr[nZ - 1]) != 0)
+    {
+      errNum = WLZ_ERR_FILE_OPEN;
+    }
+    else
+    {
+      rObj = WlzConstruct3DObjFromFile(nZ, secStr, 0, 1.0f, 1.0f, 1.0f,
+				       &errNum2);
+      if((rObj != NULL) || (errNum2 == WLZ_ERR_NONE))
+      {
+        ok = 0;
+	(void )fprintf(stderr, "%s: Missing Woolz section not detected.\n",
+		       *argv);
+	(void )WlzFreeObj(rObj);
+      }
+      else if(verbose)
+      {
+	(void )WlzStringFromErrorNum(errNum2, &errMsg);
+	(void )fprintf(stderr, "%s: missing Woolz section gives %s\n",
+		       *argv, errMsg);
+      }
+    }
+  }
+  /* Remove the remaining files and the directory. */
+  if(dir)
+  {
+    for(idP = 0; idP < nZ; ++idP)
+    {
+      if(secStr && secStr[idP])
+      {
+        (void )unlink(secStr[idP]);
+	AlcFree(secStr[idP]);
+      }
+      if(stkStr)
+      {
+	(void )sprintf(stkStr, "%s/stk%0*d.pgm", dir,
+		       WLZEFF_STACK_NAMEDIGITS, idP);
+	(void )unlink(stkStr);
+      }
+    }
+    if(stkStr)
+    {
+      (void )sprintf(stkStr, "%s/stk.ctr", dir);
+      (void )unlink(stkStr);
+    }
+    (void )rmdir(dir);
+  }
+  AlcFree(secStr);
+  AlcFree(stkStr);
+  AlcFree(dir);
+  (void )WlzFreeObj(obj);
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to test reading sections (%s).\n",
+		   *argv, errMsg);
+  }
+  if(ok)
+  {
+    (void )printf("%s: Objects read from sections match those "
+    		  "written.\n", *argv);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-v] [-z #]\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -v  Verbose output.\n"
+    "  -z  Number of sections (default 24).\n"
+    "Tests the concurrent reading of 3D objects from section files by\n"
+    "WlzEffReadObjStack() and WlzConstruct3DObjFromFile(). A 3D object\n"
+    "is written as a stack of PNM sections and as 2D Woolz sections,\n"
+    "which are read back and compared with the original. Reading is also\n"
+    "checked to fail when a section file is missing.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New 3D object or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Makes a cuboid with unsigned byte values which differ
+* 		between planes.
+* \param	nX			Number of columns.
+* \param	nY			Number of lines.
+* \param	nZ			Number of planes.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstStack3DMakeObj(int nX, int nY, int nZ,
+				       WlzErrorNum *dstErr)
+{
+  int		idP,
+  		idL,
+		idK;
+  WlzPixelV	bgdV;
+  WlzObject	*obj;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  bgdV.type = WLZ_GREY_UBYTE;
+  bgdV.v.ubv = 0;
+  obj = WlzMakeCuboid(0, nZ - 1, 0, nY - 1, 0, nX - 1, WLZ_GREY_UBYTE,
+  		      bgdV, NULL, NULL, &errNum);
+  for(idP = 0; (errNum == WLZ_ERR_NONE) && (idP < nZ); ++idP)
+  {
+    WlzUByte	*vP;
+
+    vP = obj->values.vox->values[idP].r->values.ubp;
+    for(idL = 0; idL < nY; ++idL)
+    {
+      for(idK = 0; idK < nX; ++idK)
+      {
+        *vP++ = (WlzUByte )((idK * 3) + (idL * 5) + (idP * 7));
+      }
+    }
+  }
+  *dstErr = errNum;
+  return(obj);
+}
+
+/*!
+* \return	Non-zero if the objects have the same values.
+* \ingroup	BinWlzTst
+* \brief	Compares the values of a 3D object read from sections with
+* 		those of the original object, the plane skipped (if any)
+* 		being required to be empty.
+* \param	obj0			Original object.
+* \param	obj1			Object read.
+* \param	skipPl			Plane which was not written or -1.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstStack3DCmpObj(WlzObject *obj0, WlzObject *obj1,
+				    int skipPl, WlzErrorNum *dstErr)
+{
+  int		eq = 0;
+  WlzIBox3	box;
+  WlzGreyValueWSpace *gVWSp[2] = {NULL, NULL};
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((obj1 == NULL) || (obj1->type != WLZ_3D_DOMAINOBJ))
+  {
+    errNum = WLZ_ERR_OBJECT_TYPE;
+  }
+  else
+  {
+    box = WlzBoundingBox3I(obj0, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gVWSp[0] = WlzGreyValueMakeWSp(obj0, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gVWSp[1] = WlzGreyValueMakeWSp(obj1, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idP,
+    		idL,
+		idK;
+
+    eq = 1;
+    for(idP = box.zMin; eq && (idP <= box.zMax); ++idP)
+    {
+      for(idL = box.yMin; eq && (idL <= box.yMax); ++idL)
+      {
+	for(idK = box.xMin; eq && (idK <= box.xMax); ++idK)
+	{
+	  int	in;
+
+	  in = WlzInsideDomain(obj1, idP, idL, idK, NULL) != 0;
+	  if(idP == skipPl)
+	  {
+	    eq = !in;
+	  }
+	  else if((eq = in) != 0)
+	  {
+	    WlzGreyValueGet(gVWSp[0], idP, idL, idK);
+	    WlzGreyValueGet(gVWSp[1], idP, idL, idK);
+	    eq = (gVWSp[1]->gType == WLZ_GREY_UBYTE) &&
+	         (gVWSp[0]->gVal[0].ubv == gVWSp[1]->gVal[0].ubv);
+	  }
+	}
+      }
+    }
+  }
+  WlzGreyValueFreeWSp(gVWSp[0]);
+  WlzGreyValueFreeWSp(gVWSp[1]);
+  *dstErr = errNum;
+  return(eq);
+}
@@ -0,0 +1,444 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstTiffTiled_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstTiffTiled.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for the tiled TIFF reader and writer,
+* 		WlzEffReadObjTiffTiled() and WlzEffWriteObjTiffTiled().
+* 		Objects of each supported grey type, with sizes which
+* 		are not multiples of the TIFF tile width so that the
+* 		last column and row of tiles are partial, are written
+* 		as classic and BigTIFF tiled files, read back and
+* 		compared with the originals. A striped TIFF file is
+* 		also read by the tiled reader.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <Wlz.h>
+#include <WlzExtFF.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+static WlzObject		*WlzTstTiffTiledMakeObj(
+				  WlzGreyType gType,
+				  WlzIBox2 box,
+				  WlzErrorNum *dstErr);
+static int			WlzTstTiffTiledCmpObj(
+				  WlzObject *obj0,
+				  WlzObject *obj1,
+				  WlzErrorNum *dstErr);
+static int			WlzTstTiffTiledIsBig(
+				  const char *fStr);
+
+int		main(int argc, char *argv[])
+{
+  int		idB,
+  		idG,
+		idT,
+		option,
+		ok = 1,
+		usage = 0,
+		verbose = 0;
+  size_t	tileSz = 1024;
+  char		*dir = NULL,
+		*fStr = NULL;
+  WlzIBox2	box;
+  WlzObject	*obj = NULL,
+  		*rObj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  const int	nGType = 5,
+  		nTW = 2;
+  const int	tW[2] = {16, 48};
+  const WlzGreyType gTypes[5] = {WLZ_GREY_UBYTE, WLZ_GREY_SHORT,
+  				 WLZ_GREY_INT, WLZ_GREY_FLOAT,
+				 WLZ_GREY_RGBA};
+  static char	optList[] = "ht:v";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 't':
+        if(sscanf(optarg, "%zu", &tileSz) != 1)
+	{
+	  usage = 1;
+	}
+	break;
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0) && (optind == argc);
+  usage = !ok;
+  /* The object size is not a multiple of either TIFF tile width. */
+  box.xMin = 5;
+  box.yMin = 9;
+  box.xMax = box.xMin + 100;
+  box.yMax = box.yMin + 70;
+  if(ok)
+  {
+    if(((dir = AlcStrDup("/tmp/WlzTstTiffTiledXXXXXX")) == NULL) ||
+       (mkdtemp(dir) == NULL))
+    {
+      errNum = WLZ_ERR_WRITE_EOF;
+    }
+    else if((fStr = (char *)AlcMalloc(strlen(dir) + 32)) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      (void )sprintf(fStr, "%s/obj.tif", dir);
+    }
+  }
+  for(idG = 0; ok && (errNum == WLZ_ERR_NONE) && (idG < nGType); ++idG)
+  {
+    obj = WlzAssignObject(
+    	  WlzTstTiffTiledMakeObj(gTypes[idG], box, &errNum), NULL);
+    for(idT = 0; ok && (errNum == WLZ_ERR_NONE) && (idT < nTW); ++idT)
+    {
+      for(idB = 0; ok && (errNum == WLZ_ERR_NONE) && (idB < 2); ++idB)
+      {
+	errNum = WlzEffWriteObjTiffTiled(fStr, obj, tW[idT], idB);
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  if(WlzTstTiffTiledIsBig(fStr) != idB)
+	  {
+	    ok = 0;
+	    (void )fprintf(stderr,
+	    		   "%s: File written is%s BigTIFF (grey type %d, "
+			   "tile width %d).\n",
+			   *argv, (idB)? " not": "", gTypes[idG], tW[idT]);
+	  }
+	}
+	if(ok && (errNum == WLZ_ERR_NONE))
+	{
+	  rObj = WlzAssignObject(
+		 WlzEffReadObjTiffTiled(fStr, tileSz, &errNum), NULL);
+	}
+	if(ok && (errNum == WLZ_ERR_NONE))
+	{
+	  ok = (rObj->values.core != NULL) &&
+	       WlzGreyTableIsTiled(rObj->values.core->type) &&
+	       WlzTstTiffTiledCmpObj(obj, rObj, &errNum);
+	  if(verbose || !ok)
+	  {
+	    (void )fprintf(stderr,
+			   "%s: Grey type %d, tile width %d, BigTIFF %d %s.\n",
+			   *argv, gTypes[idG], tW[idT], idB,
+			   (ok)? "ok": "differs");
+	  }
+	}
+	(void )WlzFreeObj(rObj);
+	rObj = NULL;
+      }
+    }
+    /* Read a striped TIFF file with the tiled reader. */
+    if(ok && (errNum == WLZ_ERR_NONE) && (gTypes[idG] == WLZ_GREY_UBYTE))
+    {
+      errNum = WlzEffWriteObjTiff(fStr, obj);
+      if(errNum == WLZ_ERR_NONE)
+      {
+	rObj = WlzAssignObject(
+	       WlzEffReadObjTiffTiled(fStr, tileSz, &errNum), NULL);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+        ok = WlzTstTiffTiledCmpObj(obj, rObj, &errNum);
+	if(verbose || !ok)
+	{
+	  (void )fprintf(stderr, "%s: Striped TIFF %s.\n",
+	  		 *argv, (ok)? "ok": "differs");
+	}
+      }
+      (void )WlzFreeObj(rObj);
+      rObj = NULL;
+    }
+    (void )WlzFreeObj(obj);
+    obj = NULL;
+  }
+  if(fStr)
+  {
+    (void )unlink(fStr);
+  }
+  if(dir)
+  {
+    (void )rmdir(dir);
+  }
+  AlcFree(fStr);
+  AlcFree(dir);
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to test tiled TIFF files (%s).\n",
+		   *argv, errMsg);
+  }
+  if(ok)
+  {
+    (void )printf("%s: Objects read from tiled TIFF files match those "
+    		  "written.\n", *argv);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-t #] [-v]\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -t  Number of values in each Woolz tile (default 1024).\n"
+    "  -v  Verbose output.\n"
+    "Tests WlzEffWriteObjTiffTiled() and WlzEffReadObjTiffTiled() by\n"
+    "writing objects of each supported grey type, with partial edge\n"
+    "tiles, as classic and BigTIFF tiled files, reading them back and\n"
+    "comparing them with the originals.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New 2D object or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Makes a rectangular object with values of the given grey
+* 		type which differ at every pixel.
+* \param	gType			Grey type.
+* \param	box			Bounding box of the object.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstTiffTiledMakeObj(WlzGreyType gType, WlzIBox2 box,
+					 WlzErrorNum *dstErr)
+{
+  WlzObjectType	vType;
+  WlzPixelV	bgdV;
+  WlzObject	*rObj = NULL,
+  		*obj = NULL;
+  WlzGreyValueWSpace *gVWSp = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  bgdV.type = WLZ_GREY_INT;
+  bgdV.v.inv = 0;
+  rObj = WlzMakeRect(box.yMin, box.yMax, box.xMin, box.xMax,
+  		     WLZ_GREY_ERROR, NULL, bgdV, NULL, NULL, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    (void )WlzValueConvertPixel(&bgdV, bgdV, gType);
+    vType = WlzGreyTableType(WLZ_GREY_TAB_RECT, gType, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    obj = WlzNewObjectValues(rObj, vType, bgdV, 0, bgdV, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gVWSp = WlzGreyValueMakeWSp(obj, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idL,
+    		idK;
+
+    for(idL = box.yMin; idL <= box.yMax; ++idL)
+    {
+      for(idK = box.xMin; idK <= box.xMax; ++idK)
+      {
+        int	v;
+
+	v = (idK * 3) + (idL * 131);
+	WlzGreyValueGet(gVWSp, 0, idL, idK);
+	switch(gType)
+	{
+	  case WLZ_GREY_UBYTE:
+	    *(gVWSp->gPtr[0].ubp) = (WlzUByte )(v & 0xff);
+	    break;
+	  case WLZ_GREY_SHORT:
+	    *(gVWSp->gPtr[0].shp) = (short )(v - 5000);
+	    break;
+	  case WLZ_GREY_INT:
+	    *(gVWSp->gPtr[0].inp) = (v * 40503) - 100000;
+	    break;
+	  case WLZ_GREY_FLOAT:
+	    *(gVWSp->gPtr[0].flp) = (float )v / 7.0f;
+	    break;
+	  case WLZ_GREY_RGBA:
+	    WLZ_RGBA_RGBA_SET(*(gVWSp->gPtr[0].rgbp),
+	    		      v & 0xff, (v >> 3) & 0xff, (v >> 6) & 0xff,
+			      255);
+	    break;
+	  default:
+	    break;
+	}
+      }
+    }
+  }
+  WlzGreyValueFreeWSp(gVWSp);
+  (void )WlzFreeObj(rObj);
+  if((errNum != WLZ_ERR_NONE) && (obj != NULL))
+  {
+    (void )WlzFreeObj(obj);
+    obj = NULL;
+  }
+  *dstErr = errNum;
+  return(obj);
+}
+
+/*!
+* \return	Non-zero if the objects have the same domain and values.
+* \ingroup	BinWlzTst
+* \brief	Compares the values of a 2D object read from a TIFF file
+* 		with those of the original object.
+* \param	obj0			Original object.
+* \param	obj1			Object read.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstTiffTiledCmpObj(WlzObject *obj0, WlzObject *obj1,
+				      WlzErrorNum *dstErr)
+{
+  int		eq = 0;
+  WlzIBox2	box0,
+  		box1;
+  WlzGreyValueWSpace *gVWSp[2] = {NULL, NULL};
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((obj1 == NULL) || (obj1->type != WLZ_2D_DOMAINOBJ))
+  {
+    errNum = WLZ_ERR_OBJECT_TYPE;
+  }
+  else
+  {
+    box0 = WlzBoundingBox2I(obj0, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    box1 = WlzBoundingBox2I(obj1, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gVWSp[0] = WlzGreyValueMakeWSp(obj0, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gVWSp[1] = WlzGreyValueMakeWSp(obj1, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idL,
+		idK;
+
+    eq = (box0.xMin == box1.xMin) && (box0.yMin == box1.yMin) &&
+         (box0.xMax == box1.xMax) && (box0.yMax == box1.yMax);
+    for(idL = box0.yMin; eq && (idL <= box0.yMax); ++idL)
+    {
+      for(idK = box0.xMin; eq && (idK <= box0.xMax); ++idK)
+      {
+	WlzGreyValueGet(gVWSp[0], 0, idL, idK);
+	WlzGreyValueGet(gVWSp[1], 0, idL, idK);
+	eq = (gVWSp[0]->gType == gVWSp[1]->gType);
+	if(eq)
+	{
+	  switch(gVWSp[0]->gType)
+	  {
+	    case WLZ_GREY_UBYTE:
+	      eq = gVWSp[0]->gVal[0].ubv == gVWSp[1]->gVal[0].ubv;
+	      break;
+	    case WLZ_GREY_SHORT:
+	      eq = gVWSp[0]->gVal[0].shv == gVWSp[1]->gVal[0].shv;
+	      break;
+	    case WLZ_GREY_INT:
+	      eq = gVWSp[0]->gVal[0].inv == gVWSp[1]->gVal[0].inv;
+	      break;
+	    case WLZ_GREY_FLOAT:
+	      eq = gVWSp[0]->gVal[0].flv == gVWSp[1]->gVal[0].flv;
+	      break;
+	    case WLZ_GREY_RGBA:
+	      eq = gVWSp[0]->gVal[0].rgbv == gVWSp[1]->gVal[0].rgbv;
+	      break;
+	    default:
+	      eq = 0;
+	      break;
+	  }
+	}
+      }
+    }
+  }
+  WlzGreyValueFreeWSp(gVWSp[0]);
+  WlzGreyValueFreeWSp(gVWSp[1]);
+  *dstErr = errNum;
+  return(eq);
+}
+
+/*!
+* \return	One if the file is a BigTIFF file, zero if it is a
+* 		classic TIFF file and -1 on error.
+* \ingroup	BinWlzTst
+* \brief	Checks the version number in the TIFF file header.
+* \param	fStr			File name.
+*/
+static int	WlzTstTiffTiledIsBig(const char *fStr)
+{
+  int		big = -1;
+  FILE		*fP;
+  unsigned char	hdr[4];
+
+  if((fP = fopen(fStr, "rb")) != NULL)
+  {
+    if(fread(hdr, 1, 4, fP) == 4)
+    {
+      int	ver;
+
+      /* Version 42 for classic and 43 for BigTIFF in either byte order. */
+      ver = (hdr[0] == 'I')? hdr[2] | (hdr[3] << 8): hdr[3] | (hdr[2] << 8);
+      big = (ver == 43)? 1: (ver == 42)? 0: -1;
+    }
+    (void )fclose(fP);
+  }
+  return(big);
+}
@@ -0,0 +1,684 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstTransformChain_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstTransformChain.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for transform chains which checks that applying a
+* 		chain in a single pass matches applying its transforms
+* 		in turn, both for vertices and for grey valued objects,
+* 		and that cyclic chains are rejected.
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+static WlzAffineTransform	*WlzTstTransformChainAffine(
+				  int dim,
+				  int integral,
+				  double size,
+				  WlzErrorNum *dstErr);
+static WlzTransformChain	*WlzTstTransformChainMake(
+				  int dim,
+				  int nTr,
+				  WlzAffineTransform **tr,
+				  WlzErrorNum *dstErr);
+static WlzObject		*WlzTstTransformChainObj(
+				  int dim,
+				  double size,
+				  WlzErrorNum *dstErr);
+static double			WlzTstTransformChainCmpVtx(
+				  int dim,
+				  int nTr,
+				  WlzAffineTransform **tr,
+				  WlzTransformChain *chain,
+				  double size,
+				  int nVtx,
+				  WlzErrorNum *dstErr);
+static int			WlzTstTransformChainCmpObj(
+				  WlzObject *obj0,
+				  WlzObject *obj1,
+				  WlzErrorNum *dstErr);
+static WlzErrorNum		WlzTstTransformChainCycle(
+				  int dim);
+
+int		main(int argc, char *argv[])
+{
+  int		idT,
+  		option,
+  		ok = 1,
+		usage = 0,
+		dim = 3,
+		nTr = 3,
+		nVtx = 1000,
+		nBad = 0,
+		verbose = 0;
+  long		seed = 0;
+  double	tol = 1.0e-9,
+  		size = 30.0,
+		err = 0.0;
+  WlzObject	*obj = NULL,
+  		*cObj = NULL,
+		*sObj = NULL;
+  WlzTransformChain *chain = NULL;
+  WlzAffineTransform **tr = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*op = "create transforms",
+  		*errMsg;
+  static char	optList[] = "23hn:r:s:t:T:v";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case '2':
+        dim = 2;
+	break;
+      case '3':
+        dim = 3;
+	break;
+      case 'n':
+        nVtx = atoi(optarg);
+	break;
+      case 'r':
+        size = atof(optarg);
+	break;
+      case 's':
+        seed = atol(optarg);
+	break;
+      case 't':
+        nTr = atoi(optarg);
+	break;
+      case 'T':
+        tol = atof(optarg);
+	break;
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  if((usage == 0) &&
+     ((optind != argc) || (nTr < 2) || (nVtx < 1) || (size < 4.0) ||
+      (tol <= 0.0)))
+  {
+    usage = 1;
+  }
+  ok = !usage;
+  if(ok)
+  {
+    srand48(seed);
+    if((tr = (WlzAffineTransform **)
+             AlcCalloc(nTr, sizeof(WlzAffineTransform *))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  /* Compare vertices transformed by a chain of random affine transforms
+   * with those transformed by each affine transform in turn. */
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    for(idT = 0; (errNum == WLZ_ERR_NONE) && (idT < nTr); ++idT)
+    {
+      tr[idT] = WlzTstTransformChainAffine(dim, 0, size, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      op = "create chain";
+      chain = WlzTstTransformChainMake(dim, nTr, tr, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      op = "transform vertices";
+      err = WlzTstTransformChainCmpVtx(dim, nTr, tr, chain, size, nVtx,
+				       &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if(verbose)
+      {
+	(void )fprintf(stderr, "%s: vertex error %g\n", *argv, err);
+      }
+      if(err > tol)
+      {
+	ok = 0;
+	(void )fprintf(stderr,
+		       "%s: Chain transformed vertices differ by %g.\n",
+		       *argv, err);
+      }
+    }
+    (void )WlzFreeTransformChain(chain);
+    chain = NULL;
+    for(idT = 0; idT < nTr; ++idT)
+    {
+      (void )WlzFreeAffineTransform(tr[idT]);
+      tr[idT] = NULL;
+    }
+  }
+  /* Compare an object transformed by a chain of integral translations
+   * in a single pass with the object transformed by each translation in
+   * turn, for which nearest neighbour interpolation is exact. */
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    op = "create object";
+    obj = WlzAssignObject(WlzTstTransformChainObj(dim, size, &errNum),
+    			  NULL);
+    for(idT = 0; (errNum == WLZ_ERR_NONE) && (idT < nTr); ++idT)
+    {
+      op = "create transforms";
+      tr[idT] = WlzTstTransformChainAffine(dim, 1, size, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      op = "create chain";
+      chain = WlzTstTransformChainMake(dim, nTr, tr, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      op = "transform object";
+      cObj = WlzAssignObject(
+             WlzTransformChainObj(obj, chain, WLZ_INTERPOLATION_NEAREST,
+	     			  &errNum), NULL);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      sObj = WlzAssignObject(obj, NULL);
+      for(idT = 0; (errNum == WLZ_ERR_NONE) && (idT < nTr); ++idT)
+      {
+	WlzObject *tObj;
+
+	tObj = WlzAssignObject(
+	       WlzAffineTransformObj(sObj, tr[idT], WLZ_INTERPOLATION_NEAREST,
+				     &errNum), NULL);
+	(void )WlzFreeObj(sObj);
+	sObj = tObj;
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      op = "compare objects";
+      nBad = WlzTstTransformChainCmpObj(cObj, sObj, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if(verbose)
+      {
+	(void )fprintf(stderr, "%s: %d object values differ\n",
+		       *argv, nBad);
+      }
+      if(nBad > 0)
+      {
+	ok = 0;
+	(void )fprintf(stderr,
+		       "%s: %d values of the chain transformed object "
+		       "differ.\n",
+		       *argv, nBad);
+      }
+    }
+    (void )WlzFreeObj(obj);
+    (void )WlzFreeObj(cObj);
+    (void )WlzFreeObj(sObj);
+    (void )WlzFreeTransformChain(chain);
+    for(idT = 0; idT < nTr; ++idT)
+    {
+      (void )WlzFreeAffineTransform(tr[idT]);
+    }
+  }
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    op = "check cyclic chains";
+    errNum = WlzTstTransformChainCycle(dim);
+  }
+  AlcFree(tr);
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to %s (%s).\n",
+		   *argv, op, errMsg);
+  }
+  if(ok)
+  {
+    (void )printf("%s: %dD chains of %d transforms match their "
+		  "transforms applied in turn.\n", *argv, dim, nTr);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-2] [-3] [-h] [-n#] [-r#] [-s#] [-t#] [-T#] [-v]\n"
+    "Checks that a chain of random affine transforms gives the same\n"
+    "transformed vertices as its transforms applied in turn, that a\n"
+    "grey valued object transformed in a single pass by a chain of\n"
+    "integral translations matches the object transformed by each\n"
+    "translation in turn and that cyclic chains are rejected.\n"
+    "Options:\n"
+    "  -2  Use 2D transforms.\n"
+    "  -3  Use 3D transforms (default).\n"
+    "  -h  Prints this usage information.\n"
+    "  -n  Number of vertices compared (default 1000).\n"
+    "  -r  Size of the region (default 30).\n"
+    "  -s  Seed for the random number generator (default 0).\n"
+    "  -t  Number of transforms in each chain (default 3).\n"
+    "  -T  Tolerance for the maximum vertex difference relative to\n"
+    "      the size of the region (default 1.0e-9).\n"
+    "  -v  Verbose output.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New affine transform or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Creates a random affine transform.
+* \param	dim			Dimension, 2 or 3.
+* \param	integral		If non-zero the transform is a
+* 					translation by whole numbers of
+* 					pixels or voxels, otherwise it has
+* 					a random rotation, scale and
+* 					translation.
+* \param	size			Size of the region.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzAffineTransform *WlzTstTransformChainAffine(int dim, int integral,
+				double size, WlzErrorNum *dstErr)
+{
+  double	s = 1.0,
+  		theta = 0.0,
+		phi = 0.0;
+  WlzDVertex3	t;
+  WlzAffineTransform *tr;
+
+  t.vtX = (drand48() - 0.5) * size * 0.2;
+  t.vtY = (drand48() - 0.5) * size * 0.2;
+  t.vtZ = (dim == 2)? 0.0: (drand48() - 0.5) * size * 0.2;
+  if(integral)
+  {
+    t.vtX = floor(t.vtX + 0.5);
+    t.vtY = floor(t.vtY + 0.5);
+    t.vtZ = floor(t.vtZ + 0.5);
+  }
+  else
+  {
+    s = 0.9 + (0.2 * drand48());
+    theta = (drand48() - 0.5) * ALG_M_PI_2;
+    phi = (dim == 2)? 0.0: (drand48() - 0.5) * ALG_M_PI_2;
+  }
+  tr = WlzAffineTransformFromPrimVal((dim == 2)? WLZ_TRANSFORM_2D_AFFINE:
+					         WLZ_TRANSFORM_3D_AFFINE,
+				     t.vtX, t.vtY, t.vtZ, s, theta, phi,
+				     0.0, 0.0, 0.0, 0, dstErr);
+  /* Assigned so that the transform outlives the chains it is in. */
+  return(WlzAssignAffineTransform(tr, NULL));
+}
+
+/*!
+* \return	New transform chain or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Creates a transform chain from the given affine transforms
+* 		with all but the first transform being in a nested chain,
+* 		so that nested chains are also tested.
+* \param	dim			Dimension, 2 or 3.
+* \param	nTr			Number of transforms.
+* \param	tr			Array of affine transforms.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzTransformChain *WlzTstTransformChainMake(int dim, int nTr,
+				WlzAffineTransform **tr, WlzErrorNum *dstErr)
+{
+  int		idT;
+  WlzTransformType cType;
+  WlzTransform	t;
+  WlzTransformChain *chain = NULL,
+  		*nChain = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  cType = (dim == 2)? WLZ_TRANSFORM_2D_CHAIN: WLZ_TRANSFORM_3D_CHAIN;
+  t.chain = WlzMakeTransformChain(cType, &errNum);
+  chain = WlzAssignTransform(t, NULL).chain;
+  if(errNum == WLZ_ERR_NONE)
+  {
+    t.chain = WlzMakeTransformChain(cType, &errNum);
+    nChain = WlzAssignTransform(t, NULL).chain;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    t.affine = tr[0];
+    errNum = WlzTransformChainAppend(chain, t);
+  }
+  for(idT = 1; (errNum == WLZ_ERR_NONE) && (idT < nTr); ++idT)
+  {
+    t.affine = tr[idT];
+    errNum = WlzTransformChainAppend(nChain, t);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    t.chain = nChain;
+    errNum = WlzTransformChainAppend(chain, t);
+  }
+  (void )WlzFreeTransformChain(nChain);
+  if(errNum != WLZ_ERR_NONE)
+  {
+    (void )WlzFreeTransformChain(chain);
+    chain = NULL;
+  }
+  *dstErr = errNum;
+  return(chain);
+}
+
+/*!
+* \return	New object or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Creates a 2D or 3D rectangular object with integer values
+* 		which increment through the object, so that each value
+* 		identifies the pixel or voxel it came from.
+* \param	dim			Dimension, 2 or 3.
+* \param	size			Size of the region.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstTransformChainObj(int dim, double size,
+				WlzErrorNum *dstErr)
+{
+  int		val = 1;
+  WlzObject	*dObj = NULL,
+  		*gObj = NULL;
+  WlzPixelV	bgdV;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(dim == 2)
+  {
+    dObj = WlzMakeRectangleObject(size / 2.0, size / 3.0,
+				  size / 2.0, size / 2.0, &errNum);
+  }
+  else
+  {
+    dObj = WlzMakeCuboidObject(WLZ_3D_DOMAINOBJ,
+			       size / 2.0, size / 3.0, size / 4.0,
+			       size / 2.0, size / 2.0, size / 2.0, &errNum);
+  }
+  dObj = WlzAssignObject(dObj, NULL);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    bgdV.type = WLZ_GREY_INT;
+    bgdV.v.inv = 0;
+    gObj = WlzNewObjectValues(dObj,
+			      WlzGreyTableType(WLZ_GREY_TAB_RAGR,
+					       WLZ_GREY_INT, NULL),
+			      bgdV, 0, bgdV, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = WlzGreySetIncValues(gObj, &val);
+  }
+  (void )WlzFreeObj(dObj);
+  if(errNum != WLZ_ERR_NONE)
+  {
+    (void )WlzFreeObj(gObj);
+    gObj = NULL;
+  }
+  *dstErr = errNum;
+  return(gObj);
+}
+
+/*!
+* \return	Maximum difference relative to the size of the region.
+* \ingroup	BinWlzTst
+* \brief	Transforms random vertices using the given chain and
+* 		using each of the given affine transforms in turn.
+* \param	dim			Dimension, 2 or 3.
+* \param	nTr			Number of affine transforms.
+* \param	tr			Array of affine transforms.
+* \param	chain			Transform chain.
+* \param	size			Size of the region.
+* \param	nVtx			Number of vertices.
+* \param	dstErr			Destination error pointer.
+*/
+static double	WlzTstTransformChainCmpVtx(int dim, int nTr,
+				WlzAffineTransform **tr,
+				WlzTransformChain *chain, double size,
+				int nVtx, WlzErrorNum *dstErr)
+{
+  int		idN,
+  		idT;
+  double	d,
+  		maxD = 0.0;
+  WlzDVertex3	*sVtx = NULL,
+  		*cVtx = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(((sVtx = (WlzDVertex3 *)
+              AlcMalloc(nVtx * sizeof(WlzDVertex3))) == NULL) ||
+     ((cVtx = (WlzDVertex3 *)
+              AlcMalloc(nVtx * sizeof(WlzDVertex3))) == NULL))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    for(idN = 0; idN < nVtx; ++idN)
+    {
+      sVtx[idN].vtX = drand48() * size;
+      sVtx[idN].vtY = drand48() * size;
+      sVtx[idN].vtZ = (dim == 2)? 0.0: drand48() * size;
+    }
+    (void )memcpy(cVtx, sVtx, nVtx * sizeof(WlzDVertex3));
+    errNum = WlzTransformChainVtxAry(chain, nVtx, cVtx);
+  }
+  for(idN = 0; (errNum == WLZ_ERR_NONE) && (idN < nVtx); ++idN)
+  {
+    WlzDVertex3 v;
+
+    v = sVtx[idN];
+    for(idT = 0; (errNum == WLZ_ERR_NONE) && (idT < nTr); ++idT)
+    {
+      if(dim == 2)
+      {
+        WlzDVertex2 v2;
+
+	v2.vtX = v.vtX;
+	v2.vtY = v.vtY;
+	v2 = WlzAffineTransformVertexD2(tr[idT], v2, &errNum);
+	v.vtX = v2.vtX;
+	v.vtY = v2.vtY;
+      }
+      else
+      {
+	v = WlzAffineTransformVertexD3(tr[idT], v, &errNum);
+      }
+    }
+    d = WLZ_MAX(fabs(v.vtX - cVtx[idN].vtX), fabs(v.vtY - cVtx[idN].vtY));
+    if(dim == 3)
+    {
+      d = WLZ_MAX(d, fabs(v.vtZ - cVtx[idN].vtZ));
+    }
+    maxD = WLZ_MAX(maxD, d);
+  }
+  AlcFree(sVtx);
+  AlcFree(cVtx);
+  *dstErr = errNum;
+  return(maxD / size);
+}
+
+/*!
+* \return	Number of positions at which the objects differ.
+* \ingroup	BinWlzTst
+* \brief	Compares two grey valued domain objects at every position
+* 		within the union of their bounding boxes, counting the
+* 		positions which are within only one of the objects or at
+* 		which the grey values differ.
+* \param	obj0			First object.
+* \param	obj1			Second object.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstTransformChainCmpObj(WlzObject *obj0, WlzObject *obj1,
+				WlzErrorNum *dstErr)
+{
+  int		nBad = 0;
+  WlzIBox3	b0,
+  		b1;
+  WlzGreyValueWSpace *gVWSp0 = NULL,
+  		*gVWSp1 = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((obj0->type != obj1->type) ||
+     ((obj0->type != WLZ_2D_DOMAINOBJ) && (obj0->type != WLZ_3D_DOMAINOBJ)))
+  {
+    errNum = WLZ_ERR_OBJECT_TYPE;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    b0 = WlzBoundingBox3I(obj0, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    b1 = WlzBoundingBox3I(obj1, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gVWSp0 = WlzGreyValueMakeWSp(obj0, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gVWSp1 = WlzGreyValueMakeWSp(obj1, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idX,
+    		idY,
+		idZ;
+
+    b0.xMin = WLZ_MIN(b0.xMin, b1.xMin);
+    b0.yMin = WLZ_MIN(b0.yMin, b1.yMin);
+    b0.zMin = WLZ_MIN(b0.zMin, b1.zMin);
+    b0.xMax = WLZ_MAX(b0.xMax, b1.xMax);
+    b0.yMax = WLZ_MAX(b0.yMax, b1.yMax);
+    b0.zMax = WLZ_MAX(b0.zMax, b1.zMax);
+    for(idZ = b0.zMin; idZ <= b0.zMax; ++idZ)
+    {
+      for(idY = b0.yMin; idY <= b0.yMax; ++idY)
+      {
+	for(idX = b0.xMin; idX <= b0.xMax; ++idX)
+	{
+	  int	in0,
+	  	in1;
+
+	  in0 = WlzInsideDomain(obj0, idZ, idY, idX, NULL);
+	  in1 = WlzInsideDomain(obj1, idZ, idY, idX, NULL);
+	  if(in0 != in1)
+	  {
+	    ++nBad;
+	  }
+	  else if(in0)
+	  {
+	    WlzGreyValueGet(gVWSp0, idZ, idY, idX);
+	    WlzGreyValueGet(gVWSp1, idZ, idY, idX);
+	    if(gVWSp0->gVal[0].inv != gVWSp1->gVal[0].inv)
+	    {
+	      ++nBad;
+	    }
+	  }
+	}
+      }
+    }
+  }
+  WlzGreyValueFreeWSp(gVWSp0);
+  WlzGreyValueFreeWSp(gVWSp1);
+  *dstErr = errNum;
+  return(nBad);
+}
+
+/*!
+* \return	Woolz error code, WLZ_ERR_PARAM_DATA if a cyclic chain
+* 		was not rejected.
+* \ingroup	BinWlzTst
+* \brief	Checks that appending a chain to itself, directly or
+* 		through nested chains, is rejected. Chain 1 is appended
+* 		to chain 0 and chain 2 to chain 1, after which appending
+* 		chain 0 to any of the chains would make a cycle.
+* \param	dim			Dimension, 2 or 3.
+*/
+static WlzErrorNum WlzTstTransformChainCycle(int dim)
+{
+  int		idC;
+  WlzTransformType cType;
+  WlzTransform	t;
+  WlzTransformChain *chain[3] = {NULL};
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  cType = (dim == 2)? WLZ_TRANSFORM_2D_CHAIN: WLZ_TRANSFORM_3D_CHAIN;
+  for(idC = 0; (errNum == WLZ_ERR_NONE) && (idC < 3); ++idC)
+  {
+    t.chain = WlzMakeTransformChain(cType, &errNum);
+    chain[idC] = WlzAssignTransform(t, NULL).chain;
+  }
+  for(idC = 1; (errNum == WLZ_ERR_NONE) && (idC < 3); ++idC)
+  {
+    t.chain = chain[idC];
+    errNum = WlzTransformChainAppend(chain[idC - 1], t);
+  }
+  for(idC = 0; (errNum == WLZ_ERR_NONE) && (idC < 3); ++idC)
+  {
+    t.chain = chain[0];
+    if(WlzTransformChainAppend(chain[idC], t) != WLZ_ERR_PARAM_DATA)
+    {
+      errNum = WLZ_ERR_PARAM_DATA;
+    }
+  }
+  /* Appending a chain which is not an ancestor is not a cycle. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    t.chain = chain[2];
+    errNum = WlzTransformChainAppend(chain[0], t);
+  }
+  for(idC = 0; idC < 3; ++idC)
+  {
+    (void )WlzFreeTransformChain(chain[idC]);
+  }
+  return(errNum);
+}
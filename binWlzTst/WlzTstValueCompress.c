@@ -0,0 +1,728 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstValueCompress_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstValueCompress.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for the compression of grey values in the Woolz file
+* 		format. Objects with values of each grey type are
+* 		written compressed and read back, as 2D and 3D objects
+* 		and as objects with tiled values, and the values read are
+* 		compared with those written. Tiles which are read
+* 		compressed are checked to be decoded only when accessed.
+* 		Random access to single blocks and compressed value
+* 		streams are also tested.
+* \ingroup	BinWlzTst
+*/
+#include <stdio.h>
+#include <string.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char     *optarg;
+extern int      optind,
+		opterr,
+		optopt;
+
+/*!
+* \struct	_WlzTstValueCompressCase
+* \ingroup	BinWlzTst
+* \brief	A grey type and the range of its test values, the range
+* 		being used to give each of the packings of integer values.
+*/
+typedef struct _WlzTstValueCompressCase
+{
+  WlzGreyType	gType;
+  int		range;
+} WlzTstValueCompressCase;
+
+static WlzObject		*WlzTstValueCompressMakeObj(
+				  int dim,
+				  WlzGreyType gType,
+				  int range,
+				  WlzErrorNum *dstErr);
+static WlzErrorNum		WlzTstValueCompressFill2D(
+				  WlzObject *obj,
+				  int pl,
+				  int range);
+static WlzObject		*WlzTstValueCompressRW(
+				  WlzObject *obj,
+				  WlzIOCompression cmp,
+				  WlzErrorNum *dstErr);
+static int			WlzTstValueCompressCmpObj(
+				  WlzObject *obj0,
+				  WlzObject *obj1,
+				  WlzErrorNum *dstErr);
+static int			WlzTstValueCompressNDecoded(
+				  WlzObject *obj);
+static int			WlzTstValueCompressBlocks(
+				  int verbose,
+				  char *prog);
+
+int		main(int argc, char *argv[])
+{
+  int		idC,
+  		dim,
+		tiled,
+		option,
+		ok = 1,
+		usage = 0,
+		verbose = 0;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  const int	nCase = 8;
+  const WlzTstValueCompressCase tstCase[8] =
+  {
+    {WLZ_GREY_INT,    200},
+    {WLZ_GREY_INT,    20000},
+    {WLZ_GREY_INT,    2000000},
+    {WLZ_GREY_SHORT,  200},
+    {WLZ_GREY_SHORT,  20000},
+    {WLZ_GREY_UBYTE,  256},
+    {WLZ_GREY_FLOAT,  0},
+    {WLZ_GREY_DOUBLE, 0}
+  };
+  static char	optList[] = "hv";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0) && (optind == argc);
+  usage = !ok;
+  if(ok)
+  {
+    ok = WlzTstValueCompressBlocks(verbose, *argv);
+  }
+  /* Objects of each grey type (and RGBA as the last case) in 2D and 3D,
+   * with and without tiled values. */
+  for(idC = 0; ok && (idC <= nCase); ++idC)
+  {
+    WlzGreyType	gType;
+    int		range;
+
+    gType = (idC < nCase)? tstCase[idC].gType: WLZ_GREY_RGBA;
+    range = (idC < nCase)? tstCase[idC].range: 256;
+    for(dim = 2; ok && (dim <= 3); ++dim)
+    {
+      for(tiled = 0; ok && (tiled <= 1); ++tiled)
+      {
+	int	nDec[2];
+	WlzObject *obj = NULL,
+		  *tObj = NULL,
+		  *rObj = NULL,
+		  *r2Obj = NULL;
+
+	nDec[0] = nDec[1] = 0;
+	obj = WlzAssignObject(
+	      WlzTstValueCompressMakeObj(dim, gType, range, &errNum), NULL);
+	if((errNum == WLZ_ERR_NONE) && tiled)
+	{
+	  WlzPixelV bgdV;
+
+	  bgdV = WlzGetBackground(obj, &errNum);
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    tObj = WlzAssignObject(
+	           WlzMakeTiledValuesFromObj(obj, 4096, 1, gType, bgdV,
+		   			     &errNum), NULL);
+	  }
+	}
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  rObj = WlzAssignObject(
+	         WlzTstValueCompressRW((tiled)? tObj: obj, WLZ_IOCMP_RLE,
+		 		       &errNum), NULL);
+	}
+	if((errNum == WLZ_ERR_NONE) && tiled)
+	{
+	  WlzGreyValueWSpace *gVWSp;
+
+	  /* No tile should be decoded until it is accessed and then just
+	   * the tile accessed should be decoded. */
+	  nDec[0] = WlzTstValueCompressNDecoded(rObj);
+	  gVWSp = WlzGreyValueMakeWSp(rObj, &errNum);
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    WlzGreyValueGet(gVWSp, 2, -3, 7);
+	    nDec[1] = WlzTstValueCompressNDecoded(rObj);
+	  }
+	  WlzGreyValueFreeWSp(gVWSp);
+	}
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  ok = WlzTstValueCompressCmpObj(obj, rObj, &errNum);
+	}
+	if(ok && (errNum == WLZ_ERR_NONE) && tiled)
+	{
+	  /* Write the tiled values uncompressed so that all the tiles
+	   * are decoded, and check them. */
+	  r2Obj = WlzAssignObject(
+	          WlzTstValueCompressRW(rObj, WLZ_IOCMP_NONE, &errNum), NULL);
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    ok = WlzTstValueCompressCmpObj(obj, r2Obj, &errNum);
+	  }
+	  if(ok && ((nDec[0] != 0) || (nDec[1] != 1)))
+	  {
+	    ok = 0;
+	    (void )fprintf(stderr,
+	                   "%s: Tiles not decoded on demand (%d %d).\n",
+			   *argv, nDec[0], nDec[1]);
+	  }
+	}
+	if(verbose)
+	{
+	  (void )fprintf(stderr,
+	                 "%s: grey type %d range %d dim %d tiled %d "
+			 "tiles decoded %d %d, %s\n",
+			 *argv, (int )gType, range, dim, tiled,
+			 nDec[0], nDec[1], (ok)? "ok": "failed");
+	}
+	if(!ok)
+	{
+	  (void )fprintf(stderr,
+	                 "%s: Values differ after compression (grey type %d, "
+			 "range %d, dimension %d, tiled %d).\n",
+			 *argv, (int )gType, range, dim, tiled);
+	}
+	(void )WlzFreeObj(obj);
+	(void )WlzFreeObj(tObj);
+	(void )WlzFreeObj(rObj);
+	(void )WlzFreeObj(r2Obj);
+	if(errNum != WLZ_ERR_NONE)
+	{
+	  ok = 0;
+	  (void )WlzStringFromErrorNum(errNum, &errMsg);
+	  (void )fprintf(stderr,
+	                 "%s: Failed to test compression of values (grey "
+			 "type %d, dimension %d, tiled %d) (%s).\n",
+			 *argv, (int )gType, dim, tiled, errMsg);
+	}
+      }
+    }
+  }
+  if(ok)
+  {
+    (void )printf("%s: Compressed values match the values written.\n",
+    		  *argv);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-v]\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -v  Verbose output.\n"
+    "Tests the compression of grey values by writing 2D and 3D objects\n"
+    "with values of each grey type, with and without tiled values, using\n"
+    "compression and checking the values read back. Tiles which are read\n"
+    "compressed are checked to be decoded only when accessed. Random\n"
+    "access to single compressed blocks and compressed value streams\n"
+    "are also tested.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New object or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Makes a 2D disc or 3D ball with values of the given grey
+* 		type. The 2D values are large enough to be compressed in
+* 		several blocks.
+* \param	dim			Dimension, 2 or 3.
+* \param	gType			Grey type.
+* \param	range			Range of integer values.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstValueCompressMakeObj(int dim, WlzGreyType gType,
+					     int range, WlzErrorNum *dstErr)
+{
+  WlzObject	*sObj = NULL,
+  		*obj = NULL;
+  WlzPixelV	bgdV;
+  WlzValues	val;
+  WlzObjectType	gTT;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  val.core = NULL;
+  bgdV.type = WLZ_GREY_INT;
+  bgdV.v.inv = 3;
+  (void )WlzValueConvertPixel(&bgdV, bgdV, gType);
+  gTT = WlzGreyTableType(WLZ_GREY_TAB_RAGR, gType, NULL);
+  sObj = WlzMakeSphereObject((dim == 2)? WLZ_2D_DOMAINOBJ: WLZ_3D_DOMAINOBJ,
+  			     (dim == 2)? 500.0: 30.0, 7.0, -3.0, 2.0, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(dim == 2)
+    {
+      val.v = WlzNewValueTb(sObj, gTT, bgdV, &errNum);
+    }
+    else
+    {
+      val.vox = WlzNewValuesVox(sObj, gTT, bgdV, &errNum);
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    obj = WlzMakeMain(sObj->type, sObj->domain, val, NULL, NULL, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(dim == 2)
+    {
+      errNum = WlzTstValueCompressFill2D(obj, 0, range);
+    }
+    else
+    {
+      int	idP,
+      		nP;
+      WlzPlaneDomain *pDom;
+
+      pDom = obj->domain.p;
+      nP = pDom->lastpl - pDom->plane1 + 1;
+      for(idP = 0; (errNum == WLZ_ERR_NONE) && (idP < nP); ++idP)
+      {
+        if(pDom->domains[idP].core)
+	{
+	  WlzObject *pObj;
+
+	  pObj = WlzMakeMain(WLZ_2D_DOMAINOBJ, pDom->domains[idP],
+	                     obj->values.vox->values[idP], NULL, NULL,
+			     &errNum);
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    errNum = WlzTstValueCompressFill2D(pObj, pDom->plane1 + idP,
+	    				       range);
+	  }
+	  (void )WlzFreeObj(pObj);
+	}
+      }
+    }
+  }
+  else if(val.core)
+  {
+    (void )WlzFreeValues(val);
+  }
+  (void )WlzFreeObj(sObj);
+  if((errNum != WLZ_ERR_NONE) && obj)
+  {
+    (void )WlzFreeObj(obj);
+    obj = NULL;
+  }
+  *dstErr = errNum;
+  return(obj);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	BinWlzTst
+* \brief	Sets the values of a 2D object to smooth ramps with a
+* 		little noise, so that some blocks compress and others
+* 		may not.
+* \param	obj			2D object with values.
+* \param	pl			Plane of the object.
+* \param	range			Range of integer values.
+*/
+static WlzErrorNum WlzTstValueCompressFill2D(WlzObject *obj, int pl,
+					     int range)
+{
+  int		idK;
+  WlzIntervalWSpace iWSp;
+  WlzGreyWSpace	gWSp;
+  WlzErrorNum	errNum;
+
+  if((errNum = WlzInitGreyScan(obj, &iWSp, &gWSp)) == WLZ_ERR_NONE)
+  {
+    while((errNum = WlzNextGreyInterval(&iWSp)) == WLZ_ERR_NONE)
+    {
+      int	ln;
+      WlzGreyP	gP;
+
+      ln = iWSp.linpos;
+      gP = gWSp.u_grintptr;
+      for(idK = 0; idK <= iWSp.rgtpos - iWSp.lftpos; ++idK)
+      {
+	int	kl,
+		n,
+		v;
+
+        kl = iWSp.lftpos + idK;
+	/* Noise only in the left half of the object. */
+	n = (kl < 0)? ((kl * 7919) ^ (ln * 104729) ^ (pl * 31)) & 0x7: 0;
+	v = (kl / 3) + (ln * 2) + (pl * 5) + n;
+	switch(gWSp.pixeltype)
+	{
+	  case WLZ_GREY_INT:
+	    gP.inp[idK] = (v % range) - ((range > 256)? range / 2: 0);
+	    if(range > 65536)
+	    {
+	      gP.inp[idK] *= 37;
+	    }
+	    break;
+	  case WLZ_GREY_SHORT:
+	    gP.shp[idK] = (short )((v % range) - ((range > 256)? range / 2: 0));
+	    break;
+	  case WLZ_GREY_UBYTE:
+	    gP.ubp[idK] = (WlzUByte )(v % range);
+	    break;
+	  case WLZ_GREY_FLOAT:
+	    gP.flp[idK] = (float )(v * 0.37 - 1000.0);
+	    break;
+	  case WLZ_GREY_DOUBLE:
+	    gP.dbp[idK] = v * 1.0e-3 - 1.0 / 3.0;
+	    break;
+	  case WLZ_GREY_RGBA:
+	    WLZ_RGBA_RGBA_SET(gP.rgbp[idK], v % 256, (v / 2) % 256, n, 255);
+	    break;
+	  default:
+	    break;
+	}
+      }
+    }
+    if(errNum == WLZ_ERR_EOO)
+    {
+      errNum = WLZ_ERR_NONE;
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Object read back or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Writes the given object to a temporary file with the given
+* 		compression and then reads it back.
+* \param	obj			Given object.
+* \param	cmp			Compression method.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstValueCompressRW(WlzObject *obj, WlzIOCompression cmp,
+				        WlzErrorNum *dstErr)
+{
+  FILE		*fP;
+  WlzObject	*rObj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((fP = tmpfile()) == NULL)
+  {
+    errNum = WLZ_ERR_FILE_OPEN;
+  }
+  else
+  {
+    if(((errNum = WlzWriteObjCmp(fP, obj, cmp)) == WLZ_ERR_NONE) &&
+       (fseek(fP, 0, SEEK_SET) == 0))
+    {
+      rObj = WlzReadObj(fP, &errNum);
+    }
+    (void )fclose(fP);
+  }
+  *dstErr = errNum;
+  return(rObj);
+}
+
+/*!
+* \return	Non-zero if the values of the objects are equal.
+* \ingroup	BinWlzTst
+* \brief	Compares the values of two objects within the domain of
+* 		the first, using random access to the values so that the
+* 		tiles of tiled values are decoded as they are accessed.
+* \param	obj0			First object.
+* \param	obj1			Second object.
+* \param	dstErr			Destination error pointer.
+*/
+static int	WlzTstValueCompressCmpObj(WlzObject *obj0, WlzObject *obj1,
+					  WlzErrorNum *dstErr)
+{
+  int		eq = 1;
+  WlzIBox3	box;
+  WlzGreyValueWSpace *gVWSp[2] = {NULL, NULL};
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  box = WlzBoundingBox3I(obj0, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gVWSp[0] = WlzGreyValueMakeWSp(obj0, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gVWSp[1] = WlzGreyValueMakeWSp(obj1, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idP,
+    		idL,
+		idK;
+
+    for(idP = box.zMin; eq && (idP <= box.zMax); ++idP)
+    {
+      for(idL = box.yMin; eq && (idL <= box.yMax); ++idL)
+      {
+	for(idK = box.xMin; eq && (idK <= box.xMax); ++idK)
+	{
+	  if(WlzInsideDomain(obj0, idP, idL, idK, NULL))
+	  {
+	    WlzGreyV	v0,
+	    		v1;
+
+	    WlzGreyValueGet(gVWSp[0], idP, idL, idK);
+	    WlzGreyValueGet(gVWSp[1], idP, idL, idK);
+	    v0 = gVWSp[0]->gVal[0];
+	    v1 = gVWSp[1]->gVal[0];
+	    if(gVWSp[1]->gType != gVWSp[0]->gType)
+	    {
+	      eq = 0;
+	    }
+	    else
+	    {
+	      switch(gVWSp[0]->gType)
+	      {
+		case WLZ_GREY_INT:
+		  eq = v0.inv == v1.inv;
+		  break;
+		case WLZ_GREY_SHORT:
+		  eq = v0.shv == v1.shv;
+		  break;
+		case WLZ_GREY_UBYTE:
+		  eq = v0.ubv == v1.ubv;
+		  break;
+		case WLZ_GREY_FLOAT:
+		  eq = v0.flv == v1.flv;
+		  break;
+		case WLZ_GREY_DOUBLE:
+		  eq = v0.dbv == v1.dbv;
+		  break;
+		case WLZ_GREY_RGBA:
+		  eq = v0.rgbv == v1.rgbv;
+		  break;
+		default:
+		  eq = 0;
+		  break;
+	      }
+	    }
+	  }
+	}
+      }
+    }
+  }
+  WlzGreyValueFreeWSp(gVWSp[0]);
+  WlzGreyValueFreeWSp(gVWSp[1]);
+  *dstErr = errNum;
+  return(eq);
+}
+
+/*!
+* \return	Number of decoded tiles or -1 if the object does not have
+* 		tiled values which were read compressed.
+* \ingroup	BinWlzTst
+* \brief	Counts the tiles of an object with tiled values that have
+* 		been decoded since the values were read.
+* \param	obj			Given object.
+*/
+static int	WlzTstValueCompressNDecoded(WlzObject *obj)
+{
+  int		n = -1;
+  WlzTiledValues *tv;
+
+  if(obj && obj->values.core &&
+     WlzGreyTableIsTiled(obj->values.core->type) &&
+     ((tv = obj->values.t)->tileDecoded != NULL))
+  {
+    size_t	idx;
+
+    n = 0;
+    for(idx = 0; idx < tv->numTiles; ++idx)
+    {
+      n += tv->tileDecoded[idx] != 0;
+    }
+  }
+  return(n);
+}
+
+/*!
+* \return	Non-zero if the tests pass.
+* \ingroup	BinWlzTst
+* \brief	Tests random access to single blocks using
+* 		WlzValueCmpDecodeBlk() and that a compressed value stream,
+* 		given the raw bytes in irregular pieces and read back
+* 		using WlzValueCmpRead(), gives the same buffer as
+* 		WlzValueCmpEncode().
+* \param	verbose			Verbose output if non-zero.
+* \param	prog			Program name for messages.
+*/
+static int	WlzTstValueCompressBlocks(int verbose, char *prog)
+{
+  int		idB,
+  		nBlk = 0,
+  		ok = 1;
+  size_t	idx,
+		bufSz = 0,
+		strSz = 0,
+		rdSz = 0,
+		rSz = 0;
+  FILE		*fP = NULL;
+  WlzUByte	*raw = NULL,
+  		*buf = NULL,
+		*str = NULL,
+		*rd = NULL,
+		*blk = NULL;
+  WlzValueCmpStream *cStr = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const size_t	hdrSz = 7,
+  		blkSz = 4096,
+  		rawSz = 1000003;
+
+  if(((raw = (WlzUByte *)AlcMalloc(rawSz)) == NULL) ||
+     ((blk = (WlzUByte *)AlcMalloc(blkSz)) == NULL))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    /* Short values which are smooth in places and noisy elsewhere. */
+    for(idx = 0; idx < rawSz; ++idx)
+    {
+      raw[idx] = ((idx / 50000) % 2)? (WlzUByte )((idx * 2654435761u) >> 13):
+                                      (WlzUByte )((idx % 2)? idx / 512: 0);
+    }
+    buf = WlzValueCmpEncode(WLZ_IOCMP_RLE, 2, 1, hdrSz, raw, rawSz, blkSz,
+    			    &bufSz, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = WlzValueCmpInfo(buf, bufSz, NULL, NULL, NULL, &nBlk);
+  }
+  /* Decode the blocks in reverse order. */
+  for(idB = nBlk - 1; ok && (errNum == WLZ_ERR_NONE) && (idB >= 0); --idB)
+  {
+    errNum = WlzValueCmpDecodeBlk(buf, bufSz, idB, blk, &rSz);
+    if((errNum == WLZ_ERR_NONE) &&
+       ((rSz != WLZ_MIN(blkSz, rawSz - hdrSz - (idB * blkSz))) ||
+        memcmp(blk, raw + hdrSz + (idB * blkSz), rSz)))
+    {
+      ok = 0;
+      (void )fprintf(stderr, "%s: Block %d decoded incorrectly.\n",
+      		     prog, idB);
+    }
+  }
+  /* Stream the same bytes to memory in irregular pieces. */
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    cStr = WlzValueCmpStreamOpen(NULL, WLZ_IOCMP_RLE, 2, 1, raw, hdrSz,
+    				 blkSz, &errNum);
+    idx = hdrSz;
+    while((errNum == WLZ_ERR_NONE) && (idx < rawSz))
+    {
+      size_t	n;
+
+      n = WLZ_MIN((idx * 7) % 20011 + 1, rawSz - idx);
+      errNum = WlzValueCmpStreamPut(cStr, raw + idx, n);
+      idx += n;
+    }
+    if(cStr)
+    {
+      WlzErrorNum errNum2;
+
+      str = WlzValueCmpStreamClose(cStr, &strSz, &errNum2);
+      if(errNum == WLZ_ERR_NONE)
+      {
+        errNum = errNum2;
+      }
+    }
+  }
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    if((fP = tmpfile()) == NULL)
+    {
+      errNum = WLZ_ERR_FILE_OPEN;
+    }
+    else
+    {
+      if((fwrite(str, 1, strSz, fP) != strSz) ||
+         (fseek(fP, 0, SEEK_SET) != 0))
+      {
+        errNum = WLZ_ERR_WRITE_INCOMPLETE;
+      }
+      else
+      {
+        rd = WlzValueCmpRead(fP, &rdSz, &errNum);
+      }
+      (void )fclose(fP);
+    }
+  }
+  if(ok && (errNum == WLZ_ERR_NONE))
+  {
+    if((rdSz != bufSz) || memcmp(rd, buf, bufSz))
+    {
+      ok = 0;
+      (void )fprintf(stderr, "%s: Compressed value stream differs from "
+      		     "compressed buffer.\n", prog);
+    }
+  }
+  if(verbose)
+  {
+    (void )fprintf(stderr, "%s: %lu raw bytes, %d blocks, %lu compressed "
+    		   "bytes, %lu stream bytes\n",
+		   prog, (unsigned long )rawSz, nBlk, (unsigned long )bufSz,
+		   (unsigned long )strSz);
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    const char	*errMsg;
+
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to test compressed blocks (%s).\n",
+    		   prog, errMsg);
+  }
+  AlcFree(raw);
+  AlcFree(blk);
+  AlcFree(buf);
+  AlcFree(str);
+  AlcFree(rd);
+  return(ok);
+}
@@ -0,0 +1,508 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTstZonalStats_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         binWlzTst/WlzTstZonalStats.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Test for WlzZonalGreyStats(). Zonal statistics of 2 and
+* 		3D grey objects of each grey type, over index objects
+* 		of each index type with overlapping but different
+* 		domains, are compared with those computed by a simple
+* 		loop over every pixel/voxel using WlzInsideDomain()
+* 		and WlzGreyValueGet().
+* \ingroup	BinWlzTst
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <Wlz.h>
+
+extern int      getopt(int argc, char * const *argv, const char *optstring);
+
+extern char	*optarg;
+extern int	optind,
+		opterr,
+		optopt;
+
+static WlzObject		*WlzTstZonalStatsMakeObj(
+				  WlzObjectType oType,
+				  WlzGreyType gType,
+				  int label,
+				  WlzErrorNum *dstErr);
+static WlzZonalStats		*WlzTstZonalStatsNaive(
+				  WlzObject *gObj,
+				  WlzObject *lObj,
+				  int nZone,
+				  int nBin,
+				  double binOrg,
+				  double binWidth,
+				  WlzErrorNum *dstErr);
+static int			WlzTstZonalStatsCmp(
+				  WlzZonalStats *zs0,
+				  WlzZonalStats *zs1);
+
+int		main(int argc, char *argv[])
+{
+  int		idD,
+  		idG,
+		idL,
+		idZ,
+		option,
+		ok = 1,
+		usage = 0,
+		verbose = 0;
+  WlzObject	*gObj = NULL,
+  		*lObj = NULL;
+  WlzZonalStats	*zs0 = NULL,
+  		*zs1 = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const char	*errMsg;
+  const int	nGType = 6,
+  		nLType = 3,
+		nBin = 10;
+  const double	binOrg = 20.0,
+  		binWidth = 15.0;
+  const WlzGreyType gTypes[6] = {WLZ_GREY_UBYTE, WLZ_GREY_SHORT,
+  				 WLZ_GREY_INT, WLZ_GREY_FLOAT,
+				 WLZ_GREY_DOUBLE, WLZ_GREY_RGBA},
+  		lTypes[3] = {WLZ_GREY_UBYTE, WLZ_GREY_SHORT, WLZ_GREY_INT};
+  const WlzObjectType oTypes[2] = {WLZ_2D_DOMAINOBJ, WLZ_3D_DOMAINOBJ};
+  static char	optList[] = "hv";
+
+  opterr = 0;
+  while(ok && ((option = getopt(argc, argv, optList)) != -1))
+  {
+    switch(option)
+    {
+      case 'v':
+        verbose = 1;
+	break;
+      case 'h': /* FALLTHROUGH */
+      default:
+	usage = 1;
+	break;
+    }
+  }
+  ok = (usage == 0) && (optind == argc);
+  usage = !ok;
+  for(idD = 0; ok && (errNum == WLZ_ERR_NONE) && (idD < 2); ++idD)
+  {
+    for(idG = 0; ok && (errNum == WLZ_ERR_NONE) && (idG < nGType); ++idG)
+    {
+      gObj = WlzAssignObject(
+             WlzTstZonalStatsMakeObj(oTypes[idD], gTypes[idG], 0, &errNum),
+	     NULL);
+      for(idL = 0; ok && (errNum == WLZ_ERR_NONE) && (idL < nLType); ++idL)
+      {
+        lObj = WlzAssignObject(
+	       WlzTstZonalStatsMakeObj(oTypes[idD], lTypes[idL], 1, &errNum),
+	       NULL);
+	/* Given and computed numbers of zones, with and without
+	 * histograms. */
+	for(idZ = 0; ok && (errNum == WLZ_ERR_NONE) && (idZ < 4); ++idZ)
+	{
+	  int	nZ,
+	  	nB;
+
+	  nZ = (idZ & 1)? 0: 5;
+	  nB = (idZ & 2)? nBin: 0;
+	  zs0 = WlzTstZonalStatsNaive(gObj, lObj, nZ, nB, binOrg, binWidth,
+	  			      &errNum);
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    zs1 = WlzZonalGreyStats(gObj, lObj, nZ, nB, binOrg, binWidth,
+	    			    &errNum);
+	  }
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    ok = WlzTstZonalStatsCmp(zs0, zs1);
+	    if(verbose || !ok)
+	    {
+	      (void )fprintf(stderr,
+	      		     "%s: %dD grey type %d, index type %d, %d zones, "
+			     "%d bins %s.\n",
+			     *argv, idD + 2, gTypes[idG], lTypes[idL],
+			     zs0->nZone, nB, (ok)? "ok": "differ");
+	    }
+	  }
+	  (void )WlzFreeZonalStats(zs0);
+	  (void )WlzFreeZonalStats(zs1);
+	  zs0 = zs1 = NULL;
+	}
+	(void )WlzFreeObj(lObj);
+	lObj = NULL;
+      }
+      (void )WlzFreeObj(gObj);
+      gObj = NULL;
+    }
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    ok = 0;
+    (void )WlzStringFromErrorNum(errNum, &errMsg);
+    (void )fprintf(stderr, "%s: Failed to test zonal statistics (%s).\n",
+		   *argv, errMsg);
+  }
+  if(ok)
+  {
+    (void )printf("%s: Zonal statistics match those computed by a simple "
+    		  "loop.\n", *argv);
+  }
+  if(usage)
+  {
+    (void )fprintf(stderr,
+    "Usage: %s%s",
+    *argv,
+    " [-h] [-v]\n"
+    "Options:\n"
+    "  -h  Prints this usage information.\n"
+    "  -v  Verbose output.\n"
+    "Tests WlzZonalGreyStats() by comparing its statistics with those\n"
+    "computed by a simple loop over every pixel/voxel, for 2 and 3D grey\n"
+    "objects of each grey type and index objects of each index type.\n");
+  }
+  return(!ok);
+}
+
+/*!
+* \return	New object or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Makes a spherical (or circular) grey or index object.
+* 		The index object is offset from the grey object so their
+* 		domains only partly overlap and its values include
+* 		values outside of the range of zones.
+* \param	oType			Object type, 2 or 3D domain object.
+* \param	gType			Grey type.
+* \param	label			Make an index object if non-zero.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTstZonalStatsMakeObj(WlzObjectType oType,
+					  WlzGreyType gType, int label,
+					  WlzErrorNum *dstErr)
+{
+  WlzObjectType	vType;
+  WlzIBox3	box;
+  WlzPixelV	bgdV;
+  WlzObject	*sObj = NULL,
+  		*obj = NULL;
+  WlzGreyValueWSpace *gVWSp = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  bgdV.type = WLZ_GREY_INT;
+  bgdV.v.inv = 0;
+  (void )WlzValueConvertPixel(&bgdV, bgdV, gType);
+  sObj = WlzAssignObject(
+         WlzMakeSphereObject(oType, 15.0, (label)? 8.0: 0.0,
+			     (label)? -5.0: 0.0, (label)? 3.0: 0.0,
+			     &errNum), NULL);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    vType = WlzGreyTableType(WLZ_GREY_TAB_RAGR, gType, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    obj = WlzNewObjectValues(sObj, vType, bgdV, 0, bgdV, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    box = WlzBoundingBox3I(obj, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gVWSp = WlzGreyValueMakeWSp(obj, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idP,
+    		idL,
+		idK;
+
+    for(idP = box.zMin; idP <= box.zMax; ++idP)
+    {
+      for(idL = box.yMin; idL <= box.yMax; ++idL)
+      {
+	for(idK = box.xMin; idK <= box.xMax; ++idK)
+	{
+	  if(WlzInsideDomain(obj, idP, idL, idK, NULL))
+	  {
+	    int	v;
+
+	    if(label)
+	    {
+	      /* Zones -1 to 6, with -1 replaced by 7 for unsigned bytes. */
+	      v = (((idK + 40) / 5) + ((idL + 40) / 4) + idP) % 8 - 1;
+	      if((v < 0) && (gType == WLZ_GREY_UBYTE))
+	      {
+		v = 7;
+	      }
+	    }
+	    else
+	    {
+	      v = ((idK * 37) + (idL * 11) + (idP * 5)) & 0xff;
+	    }
+	    WlzGreyValueGet(gVWSp, idP, idL, idK);
+	    switch(gType)
+	    {
+	      case WLZ_GREY_UBYTE:
+		*(gVWSp->gPtr[0].ubp) = (WlzUByte )v;
+		break;
+	      case WLZ_GREY_SHORT:
+		*(gVWSp->gPtr[0].shp) = (short )((label)? v: v - 100);
+		break;
+	      case WLZ_GREY_INT:
+		*(gVWSp->gPtr[0].inp) = (label)? v: v * 1001;
+		break;
+	      case WLZ_GREY_FLOAT:
+		*(gVWSp->gPtr[0].flp) = (float )v / 3.0f;
+		break;
+	      case WLZ_GREY_DOUBLE:
+		*(gVWSp->gPtr[0].dbp) = ((double )v / 7.0) - 10.0;
+		break;
+	      case WLZ_GREY_RGBA:
+		WLZ_RGBA_RGBA_SET(*(gVWSp->gPtr[0].rgbp),
+				  v, 255 - v, (v * 3) & 0xff, 255);
+		break;
+	      default:
+		errNum = WLZ_ERR_GREY_TYPE;
+		break;
+	    }
+	  }
+	}
+      }
+    }
+  }
+  WlzGreyValueFreeWSp(gVWSp);
+  (void )WlzFreeObj(sObj);
+  if((errNum != WLZ_ERR_NONE) && (obj != NULL))
+  {
+    (void )WlzFreeObj(obj);
+    obj = NULL;
+  }
+  *dstErr = errNum;
+  return(obj);
+}
+
+/*!
+* \return	New zonal statistics or NULL on error.
+* \ingroup	BinWlzTst
+* \brief	Computes zonal statistics by visiting every pixel/voxel
+* 		of the grey object's bounding box, using WlzInsideDomain()
+* 		to test whether it is in both objects' domains and
+* 		WlzGreyValueGet() to get the grey and index values.
+* \param	gObj			Grey object.
+* \param	lObj			Index object.
+* \param	nZone			Number of zones, if not greater than
+* 					zero then one more than the maximum
+* 					index value.
+* \param	nBin			Number of histogram bins per zone.
+* \param	binOrg			Grey value at the start of the first
+* 					histogram bin.
+* \param	binWidth		Width of the histogram bins.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzZonalStats *WlzTstZonalStatsNaive(WlzObject *gObj,
+					    WlzObject *lObj,
+					    int nZone, int nBin,
+					    double binOrg, double binWidth,
+					    WlzErrorNum *dstErr)
+{
+  WlzIBox3	box;
+  WlzZonalStats	*zs = NULL;
+  WlzGreyValueWSpace *gVWSp = NULL,
+  		*lVWSp = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  box = WlzBoundingBox3I(gObj, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gVWSp = WlzGreyValueMakeWSp(gObj, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    lVWSp = WlzGreyValueMakeWSp(lObj, &errNum);
+  }
+  if((errNum == WLZ_ERR_NONE) && (nZone <= 0))
+  {
+    WlzPixelV	minV,
+    		maxV;
+
+    errNum = WlzGreyRange(lObj, &minV, &maxV);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      (void )WlzValueConvertPixel(&maxV, maxV, WLZ_GREY_INT);
+      nZone = maxV.v.inv + 1;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(((zs = (WlzZonalStats *)
+              AlcCalloc(1, sizeof(WlzZonalStats))) == NULL) ||
+       ((zs->count = (WlzLong *)AlcCalloc(nZone, sizeof(WlzLong))) == NULL) ||
+       ((zs->sum = (double *)AlcCalloc(nZone, sizeof(double))) == NULL) ||
+       ((zs->sumSq = (double *)AlcCalloc(nZone, sizeof(double))) == NULL) ||
+       ((zs->min = (double *)AlcCalloc(nZone, sizeof(double))) == NULL) ||
+       ((zs->max = (double *)AlcCalloc(nZone, sizeof(double))) == NULL) ||
+       ((nBin > 0) &&
+        ((zs->hist = (WlzLong *)
+	             AlcCalloc((size_t )nZone * nBin,
+		               sizeof(WlzLong))) == NULL)))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      zs->nZone = nZone;
+      zs->nBin = nBin;
+      zs->binOrg = binOrg;
+      zs->binWidth = binWidth;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idP,
+    		idL,
+		idK;
+
+    for(idP = box.zMin; idP <= box.zMax; ++idP)
+    {
+      for(idL = box.yMin; idL <= box.yMax; ++idL)
+      {
+	for(idK = box.xMin; idK <= box.xMax; ++idK)
+	{
+	  if(WlzInsideDomain(gObj, idP, idL, idK, NULL) &&
+	     WlzInsideDomain(lObj, idP, idL, idK, NULL))
+	  {
+	    int		z;
+	    double	g;
+	    WlzPixelV	pix;
+
+	    WlzGreyValueGet(lVWSp, idP, idL, idK);
+	    pix.type = lVWSp->gType;
+	    pix.v = lVWSp->gVal[0];
+	    (void )WlzValueConvertPixel(&pix, pix, WLZ_GREY_INT);
+	    z = pix.v.inv;
+	    WlzGreyValueGet(gVWSp, idP, idL, idK);
+	    if(gVWSp->gType == WLZ_GREY_RGBA)
+	    {
+	      g = WLZ_RGBA_MODULUS(gVWSp->gVal[0].rgbv);
+	    }
+	    else
+	    {
+	      pix.type = gVWSp->gType;
+	      pix.v = gVWSp->gVal[0];
+	      (void )WlzValueConvertPixel(&pix, pix, WLZ_GREY_DOUBLE);
+	      g = pix.v.dbv;
+	    }
+	    if((z >= 0) && (z < nZone))
+	    {
+	      if(zs->count[z] == 0)
+	      {
+		zs->min[z] = zs->max[z] = g;
+	      }
+	      zs->min[z] = WLZ_MIN(zs->min[z], g);
+	      zs->max[z] = WLZ_MAX(zs->max[z], g);
+	      ++(zs->count[z]);
+	      zs->sum[z] += g;
+	      zs->sumSq[z] += g * g;
+	      if(nBin > 0)
+	      {
+		int	b;
+
+		b = (int )floor((g - binOrg) / binWidth);
+		b = WLZ_CLAMP(b, 0, nBin - 1);
+		++(zs->hist[((size_t )z * nBin) + b]);
+	      }
+	    }
+	  }
+	}
+      }
+    }
+  }
+  WlzGreyValueFreeWSp(gVWSp);
+  WlzGreyValueFreeWSp(lVWSp);
+  if((errNum != WLZ_ERR_NONE) && (zs != NULL))
+  {
+    (void )WlzFreeZonalStats(zs);
+    zs = NULL;
+  }
+  *dstErr = errNum;
+  return(zs);
+}
+
+/*!
+* \return	Non-zero if the statistics match.
+* \ingroup	BinWlzTst
+* \brief	Compares zonal statistics, with the counts, minima,
+* 		maxima and histograms required to be equal and the sums
+* 		required to be equal to within rounding error.
+* \param	zs0			Reference statistics.
+* \param	zs1			Statistics to test.
+*/
+static int	WlzTstZonalStatsCmp(WlzZonalStats *zs0, WlzZonalStats *zs1)
+{
+  int		idZ,
+  		eq;
+  const double	eps = 1.0e-9;
+
+  eq = (zs0->nZone == zs1->nZone) && (zs0->nBin == zs1->nBin) &&
+       ((zs0->hist == NULL) == (zs1->hist == NULL));
+  for(idZ = 0; eq && (idZ < zs0->nZone); ++idZ)
+  {
+    eq = (zs0->count[idZ] == zs1->count[idZ]) &&
+	 (fabs(zs0->sum[idZ] - zs1->sum[idZ]) <=
+	  eps * (1.0 + fabs(zs0->sum[idZ]))) &&
+	 (fabs(zs0->sumSq[idZ] - zs1->sumSq[idZ]) <=
+	  eps * (1.0 + fabs(zs0->sumSq[idZ])));
+    if(eq && (zs0->count[idZ] > 0))
+    {
+      eq = (zs0->min[idZ] == zs1->min[idZ]) &&
+           (zs0->max[idZ] == zs1->max[idZ]);
+    }
+    if(eq && (zs0->hist != NULL))
+    {
+      int	idB;
+
+      for(idB = 0; eq && (idB < zs0->nBin); ++idB)
+      {
+        size_t	i;
+
+	i = ((size_t )idZ * zs0->nBin) + idB;
+	eq = (zs0->hist[i] == zs1->hist[i]);
+      }
+    }
+  }
+  return(eq);
+}
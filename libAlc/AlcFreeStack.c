@@ -48,6 +48,7 @@ static char _AlcFreeStack_c[] = "University of Edinburgh $Id$";
 typedef struct _AlcFreeStack
 {
   void		*data;
+  void		(*freeFn)(void *);
   struct _AlcFreeStack *prev;
 } AlcFreeStack;
 
@@ -74,6 +75,7 @@ void 		*AlcFreeStackPush(void *prev, void *data, AlcErrno *dstErr)
   else
   {
     fPtr->data = data;
+    fPtr->freeFn = NULL;
     fPtr->prev = (AlcFreeStack *)prev;
   }
   if(dstErr)
@@ -83,6 +85,36 @@ void 		*AlcFreeStackPush(void *prev, void *data, AlcErrno *dstErr)
   return((void *)fPtr);
 }
 
+/*!
+* \return	New free stack pointer or NULL on error.
+* \ingroup	AlcFreeStack
+* \brief	Push's the given pointer onto the free stack on top
+*		of the previous free stack pointer, with a function
+*		that will be used to free it instead of AlcFree().
+*		This allows data that was not allocated by AlcMalloc(),
+*		eg memory mapped data, to be kept on a free stack.
+* \param	prev 			Previous free stack pointer.
+* \param	data 			New pointer to push onto the
+*					free stack.
+* \param	freeFn			Function used to free the data,
+* 					if NULL AlcFree() is used.
+* \param	dstErr 			Destination error pointer,
+*					may be NULL
+*/
+void 		*AlcFreeStackPushFn(void *prev, void *data,
+				    void (*freeFn)(void *),
+				    AlcErrno *dstErr)
+{
+  AlcFreeStack *fPtr;
+
+  fPtr = (AlcFreeStack *)AlcFreeStackPush(prev, data, dstErr);
+  if(fPtr)
+  {
+    fPtr->freeFn = freeFn;
+  }
+  return((void *)fPtr);
+}
+
 /*!
 * \return	New free stack pointer or NULL on error.
 * \ingroup	AlcFreeStack
@@ -148,7 +180,14 @@ AlcErrno	AlcFreeStackFree(void *stack)
       entry0 = entry1->prev;
       if(entry1->data)
       {
-        AlcFree(entry1->data);
+	if(entry1->freeFn)
+	{
+	  (*(entry1->freeFn))(entry1->data);
+	}
+	else
+	{
+	  AlcFree(entry1->data);
+	}
       }
       AlcFree(entry1);
     }
@@ -46,6 +46,16 @@ static char _AlgCrossCorr_c[] = "University of Edinburgh $Id$";
 #include <float.h>
 
 
+static AlgError			AlgCrossCorrCheckSz2D(
+				  int nX,
+				  int nY);
+static void			AlgCrossCorrMulConj2D(
+				  double **dst,
+				  double **src0,
+				  double **src1,
+				  int nX,
+				  int nY);
+
 /*!
 * \return	Error code.
 * \ingroup	AlgCorr
@@ -65,25 +75,89 @@ static char _AlgCrossCorr_c[] = "University of Edinburgh $Id$";
 */
 AlgError	AlgCrossCorrelate2D(double **data0, double **data1,
 			            int nX, int nY)
+{
+  AlgError	errNum = ALG_ERR_NONE;
+
+  if((data0 == NULL) || (data1 == NULL))
+  {
+     errNum = ALG_ERR_FUNC;
+  }
+  else
+  {
+    errNum = AlgCrossCorrCheckSz2D(nX, nY);
+  }
+  if(errNum == ALG_ERR_NONE)
+  {
+    AlgFourReal2D(data0, 1, nX, nY);
+    AlgFourReal2D(data1, 1, nX, nY);
+    AlgCrossCorrMulConj2D(data0, data0, data1, nX, nY);
+    AlgFourRealInv2D(data0, 1, nX, nY);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Error code.
+* \ingroup	AlgCorr
+* \brief	Cross correlates the given 2D double arrays, where the
+*		first has already been Fourier transformed using
+*		AlgFourReal2D(), leaving the result in the second of
+*		the two arrays. The first array is not modified so
+*		it may be used for any number of cross correlations
+*		with the same data, avoiding the repeated computation
+*		of its Fourier transform. Given the same data the
+*		result is the same as that of AlgCrossCorrelate2D().
+*		The cross correlation data are un-normalized.
+* \param	ft0			Fourier transform of the first data
+*					(source: AlcDouble2Malloc).
+* \param	data1			Data for/with obj1's FFT 
+*					(source: AlcDouble2Malloc)
+*					which holds the cross	
+*					correlation data on return.
+* \param	nX			Number of columns in each of the
+*					data arrays.
+* \param	nY			Number of lines in each of the
+*					data arrays.
+*/
+AlgError	AlgCrossCorrelate2DFT(double **ft0, double **data1,
+				      int nX, int nY)
+{
+  AlgError	errNum = ALG_ERR_NONE;
+
+  if((ft0 == NULL) || (data1 == NULL))
+  {
+     errNum = ALG_ERR_FUNC;
+  }
+  else
+  {
+    errNum = AlgCrossCorrCheckSz2D(nX, nY);
+  }
+  if(errNum == ALG_ERR_NONE)
+  {
+    AlgFourReal2D(data1, 1, nX, nY);
+    AlgCrossCorrMulConj2D(data1, ft0, data1, nX, nY);
+    AlgFourRealInv2D(data1, 1, nX, nY);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Error code.
+* \ingroup	AlgCorr
+* \brief	Checks that the given array size is valid for the
+*		frequency domain cross correlation functions.
+* \param	nX			Number of columns.
+* \param	nY			Number of lines.
+*/
+static AlgError	AlgCrossCorrCheckSz2D(int nX, int nY)
 {
   int		tI0,
-		tI1,
-		idX,
-		idY,
-  		nX2,
-		nY2;
-  double	tD1,
-		tD2,
-		tD3,
-		tD4;
-  double	*tDP1,
-		*tDP2;
+  		tI1;
   AlgError	errNum = ALG_ERR_NONE;
   const int	minN = 8,
   		maxN = 1048576;
 
-  if((data0 == NULL) || (data1 == NULL) ||
-     (nX < minN) || (nX > maxN) || (nY < minN) || (nY > maxN))
+  if((nX < minN) || (nX > maxN) || (nY < minN) || (nY > maxN))
   {
      errNum = ALG_ERR_FUNC;
   }
@@ -96,49 +170,74 @@ AlgError	AlgCrossCorrelate2D(double **data0, double **data1,
       errNum = ALG_ERR_FUNC;
     }
   }
-  if(errNum == ALG_ERR_NONE)
+  return(errNum);
+}
+
+/*!
+* \ingroup	AlgCorr
+* \brief	Multiplies the first of the two given Fourier transforms
+*		by the complex conjugate of the second. The transforms
+*		are in the packed real format of AlgFourReal2D().
+*		The destination may be either of the two sources.
+* \param	dst			Destination for the product.
+* \param	src0			First Fourier transform.
+* \param	src1			Second Fourier transform.
+* \param	nX			Number of columns in each of the
+*					data arrays.
+* \param	nY			Number of lines in each of the
+*					data arrays.
+*/
+static void	AlgCrossCorrMulConj2D(double **dst, double **src0,
+				      double **src1, int nX, int nY)
+{
+  int		idX,
+		idY,
+  		nX2,
+		nY2;
+  double	tD1,
+		tD2,
+		tD3,
+		tD4;
+  double	*tDP0,
+  		*tDP1,
+		*tDP2;
+
+  nX2 = nX / 2;
+  nY2 = nY / 2;
+  for(idY = 0; idY < nY; ++idY)
   {
-    AlgFourReal2D(data0, 1, nX, nY);
-    AlgFourReal2D(data1, 1, nX, nY);
-    nX2 = nX / 2;
-    nY2 = nY / 2;
-    for(idY = 0; idY < nY; ++idY)
+    tDP0 = *(dst + idY) + 1;
+    tDP1 = *(src0 + idY) + 1;
+    tDP2 = *(src1 + idY) + 1;
+    for(idX = 1; idX < nX2; ++idX)
     {
-      tDP1 = *(data0 + idY) + 1;
-      tDP2 = *(data1 + idY) + 1;
-      for(idX = 1; idX < nX2; ++idX)
-      {
-	tD1 = *tDP1;
-	tD2 = *(tDP1 + nX2);
-	tD3 = *tDP2;
-	tD4 = -*(tDP2 + nX2);
-	*tDP1 = tD1 * tD3 - tD2 * tD4;
-	*(tDP1 + nX2) = tD1 * tD4 + tD2 * tD3;
-	++tDP1;
-	++tDP2;
-      }
+      tD1 = *tDP1;
+      tD2 = *(tDP1 + nX2);
+      tD3 = *tDP2;
+      tD4 = -*(tDP2 + nX2);
+      *tDP0 = tD1 * tD3 - tD2 * tD4;
+      *(tDP0 + nX2) = tD1 * tD4 + tD2 * tD3;
+      ++tDP0;
+      ++tDP1;
+      ++tDP2;
     }
-    for(idX = 0; idX < nX; idX += nX2)
+  }
+  for(idX = 0; idX < nX; idX += nX2)
+  {
+    for(idY = 1; idY < nY2; ++idY)
     {
-      for(idY = 1; idY < nY2; ++idY)
-      {
-	tDP1 = *(data0 + idY) + idX;
-	tDP2 = *(data0 + nY2 + idY) + idX;
-	tD1 = *tDP1;
-	tD2 = *tDP2;
-	tD3 = *(*(data1 + idY) + idX);
-	tD4 = -*(*(data1 + nY2 + idY) + idX);
-	*tDP1 = tD1 * tD3 - tD2 * tD4;
-	*tDP2 = tD1 * tD4 + tD2 * tD3;
-      }
+      tD1 = *(*(src0 + idY) + idX);
+      tD2 = *(*(src0 + nY2 + idY) + idX);
+      tD3 = *(*(src1 + idY) + idX);
+      tD4 = -*(*(src1 + nY2 + idY) + idX);
+      *(*(dst + idY) + idX) = tD1 * tD3 - tD2 * tD4;
+      *(*(dst + nY2 + idY) + idX) = tD1 * tD4 + tD2 * tD3;
     }
-    **data0 *= **data1;
-    **(data0 + nY2) *= **(data1 + nY2);
-    *(*data0 + nX2) *= *(*data1 + nX2);
-    *(*(data0 + nY2) + nX2) *= *(*(data1 + nY2) + nX2);
-    AlgFourRealInv2D(data0, 1, nX, nY);
   }
-  return(errNum);
+  **dst = **src0 * **src1;
+  **(dst + nY2) = **(src0 + nY2) * **(src1 + nY2);
+  *(*dst + nX2) = *(*src0 + nX2) * *(*src1 + nX2);
+  *(*(dst + nY2) + nX2) = *(*(src0 + nY2) + nX2) * *(*(src1 + nY2) + nX2);
 }
 
 /*!
@@ -63,8 +63,9 @@ static AlgError			AlgMatrixLLRWriteAscii(
 * \param	aType			Matrix type.
 * \param	nR			Number of rows.
 * \param	nC			Number of columns.
-* \param	nE			Number of list entries to allocate,
-* 					only used for linked list row matrices,
+* \param	nE			Number of entries to allocate, only
+* 					used for linked list row and
+* 					compressed sparse row matrices,
 * 					may be zero.
 * \param	tol			Matrix tollerance value, only used for
 * 					linked list row matrices.
@@ -88,6 +89,9 @@ AlgMatrix	AlgMatrixNew(AlgMatrixType aType, size_t nR, size_t nC,
     case ALG_MATRIX_LLR:
       mat.llr = AlgMatrixLLRNew(nR, nC, nE, tol, &errNum);
       break;
+    case ALG_MATRIX_CSR:
+      mat.csr = AlgMatrixCSRNew(nR, nC, nE, &errNum);
+      break;
     default:
       errNum = ALG_ERR_MATRIX_TYPE;
       break;
@@ -154,6 +158,9 @@ void		AlgMatrixFree(AlgMatrix mat)
       case ALG_MATRIX_LLR:
         AlgMatrixLLRFree(mat.llr);
         break;
+      case ALG_MATRIX_CSR:
+        AlgMatrixCSRFree(mat.csr);
+        break;
       default:
         break;
     }
@@ -367,6 +374,9 @@ AlgError	AlgMatrixWriteAscii(AlgMatrix mat, FILE *fP)
       case ALG_MATRIX_LLR:
         errNum = AlgMatrixLLRWriteAscii(mat.llr, fP);
 	break;
+      case ALG_MATRIX_CSR:
+        errNum = AlgMatrixCSRWriteAscii(mat.csr, fP);
+	break;
       default:
         errNum = ALG_ERR_MATRIX_TYPE;
 	break;
@@ -625,8 +635,8 @@ AlgMatrix	AlgMatrixReadAscii(AlgMatrixType mType, double tol,
 * \return	Alg error code.
 * \ingroup	AlgMatrix
 * 		Errors can occur because of a memory allocation
-* 		failure in ALG_MATRIX_LLR matrices or an invalid
-* 		matrix type.
+* 		failure in ALG_MATRIX_LLR or ALG_MATRIX_CSR matrices
+* 		or an invalid matrix type.
 * \param	mat			Given matrix.
 * \param	row			Row coordinate.
 * \param	col			Column coordinate.
@@ -644,6 +654,9 @@ AlgError	AlgMatrixSet(AlgMatrix mat,
       case ALG_MATRIX_LLR:
 	errNum = AlgMatrixLLRSet(mat.llr, row, col, val);
 	break;
+      case ALG_MATRIX_CSR:
+	errNum = AlgMatrixCSRSet(mat.csr, row, col, val);
+	break;
       case ALG_MATRIX_SYM:
 	if(col <= row)
 	{
@@ -774,6 +787,9 @@ double		AlgMatrixValue(AlgMatrix mat, size_t row, size_t col)
       case ALG_MATRIX_LLR:
         val = AlgMatrixLLRValue(mat.llr, row, col);
 	break;
+      case ALG_MATRIX_CSR:
+        val = AlgMatrixCSRValue(mat.csr, row, col);
+	break;
       case ALG_MATRIX_SYM:
 	if(col <= row)
 	{
@@ -957,6 +973,9 @@ void		AlgMatrixZero(AlgMatrix mat)
       case ALG_MATRIX_LLR:
         AlgMatrixLLRZero(mat.llr);
         break;
+      case ALG_MATRIX_CSR:
+        AlgMatrixCSRZero(mat.csr);
+        break;
       default:
         break;
     }
@@ -1017,6 +1036,7 @@ void            AlgMatrixLLRZero(AlgMatrixLLR *mat)
 * 		is not appropriate (ie not one of ALG_MATRIX_RECT,
 * 		ALG_MATRIX_SYM or ALG_MATRIX_LLR) or if the elements
 * 		of a ALG_MATRIX_LLR matrix can not be allocated.
+* 		An ALG_MATRIX_CSR matrix may only be set to zero.
 * \ingroup	AlgMatrix
 * \brief	Sets all elements of the given matrix to the given value.
 * \param	mat			Given matrix.
@@ -1039,6 +1059,16 @@ AlgError	AlgMatrixSetAll(AlgMatrix mat, double val)
       case ALG_MATRIX_LLR:
         AlgMatrixLLRSetAll(mat.llr, val);
         break;
+      case ALG_MATRIX_CSR:
+	if(val == 0.0)
+	{
+	  AlgMatrixCSRZero(mat.csr);
+	}
+	else
+	{
+	  errNum = ALG_ERR_MATRIX_TYPE;
+	}
+	break;
       default:
         errNum = ALG_ERR_MATRIX_TYPE;
 	break;
@@ -81,6 +81,9 @@ static void			AlgMatrixCGDebug(
 *		to solve \f$\mathbf{A} \mathbf{z} = \mathbf{r}\f$ for
 *		\f$\mathbf{z}\f$ with the solution overwriting the initial
 *		contents of z.
+*		AlgMatrixPrecondApply() may be used as the preconditioning
+*		function with a preconditioner created by
+*		AlgMatrixPrecondNew() as its data.
 * \param	aM			Matrix \f$\mathbf{A}\f$.
 * \param	xV			Matrix \f$\mathbf{x}\f$ which
 *					should contain an initial estimate
@@ -135,6 +138,7 @@ AlgError	AlgMatrixCGSolve(
   {
     switch(aM.core->type)
     {
+      case ALG_MATRIX_CSR:  /* FALLTHROUGH */
       case ALG_MATRIX_LLR:  /* FALLTHROUGH */
       case ALG_MATRIX_RECT: /* FALLTHROUGH */
       case ALG_MATRIX_SYM:
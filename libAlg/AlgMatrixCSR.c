@@ -0,0 +1,966 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _AlgMatrixCSR_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         libAlg/AlgMatrixCSR.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Allocation, construction and maintenance functions for
+* 		compressed sparse row matrices.
+*
+* 		Compressed sparse row matrices are intended to be built
+* 		once, either from a linked list row matrix or from a
+* 		set of triples, and then used many times by the iterative
+* 		solvers, in which the matrix vector products dominate.
+* \ingroup	AlgMatrix
+*/
+#include <Alg.h>
+#include <float.h>
+#include <string.h>
+
+static int			AlgMatrixCSRTripleColCmp(
+				  const void *p0,
+				  const void *p1);
+static int			AlgMatrixCSRSizeCmp(
+				  const void *p0,
+				  const void *p1);
+static void			AlgMatrixCSRSortRow(
+				  AlgMatrixTriple *t,
+				  size_t n);
+static AlgError			AlgMatrixCSRExpand(
+				  AlgMatrixCSR *mat,
+				  size_t nE);
+
+/*!
+* \return	New compressed sparse row matrix or NULL on error.
+* \ingroup	AlgMatrix
+* \brief	Allocates a new compressed sparse row matrix with no
+* 		non-zero entries but with space for the given number
+* 		of entries.
+* \param	nR			Number of rows.
+* \param	nC			Number of columns.
+* \param	nE			Number of entries to allocate space
+* 					for, may be zero.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+AlgMatrixCSR	*AlgMatrixCSRNew(size_t nR, size_t nC, size_t nE,
+				 AlgError *dstErr)
+{
+  AlgMatrixCSR	*mat = NULL;
+  AlgError	errNum = ALG_ERR_NONE;
+
+  if(nE < 1)
+  {
+    nE = 1;
+  }
+  if(((mat = (AlgMatrixCSR *)AlcCalloc(1, sizeof(AlgMatrixCSR))) == NULL) ||
+     ((mat->rowIdx = (size_t *)AlcCalloc(nR + 1, sizeof(size_t))) == NULL) ||
+     ((mat->colIdx = (size_t *)AlcMalloc(nE * sizeof(size_t))) == NULL) ||
+     ((mat->val = (double *)AlcMalloc(nE * sizeof(double))) == NULL))
+  {
+    AlgMatrixCSRFree(mat);
+    mat = NULL;
+    errNum = ALG_ERR_MALLOC;
+  }
+  else
+  {
+    mat->type = ALG_MATRIX_CSR;
+    mat->nR = nR;
+    mat->nC = nC;
+    mat->maxEnt = nE;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(mat);
+}
+
+/*!
+* \ingroup	AlgMatrix
+* \brief	Frees a compressed sparse row matrix.
+* \param	mat			Compressed sparse row matrix.
+*/
+void		AlgMatrixCSRFree(AlgMatrixCSR *mat)
+{
+  if(mat)
+  {
+    AlcFree(mat->rowIdx);
+    AlcFree(mat->colIdx);
+    AlcFree(mat->val);
+    AlcFree(mat);
+  }
+}
+
+/*!
+* \ingroup      AlgMatrix
+* \brief        Sets all elements of the matrix to zero, which removes
+* 		all entries from the matrix.
+* \param        mat                     Given compressed sparse row matrix.
+*/
+void		AlgMatrixCSRZero(AlgMatrixCSR *mat)
+{
+  mat->numEnt = 0;
+  (void )memset(mat->rowIdx, 0, (mat->nR + 1) * sizeof(size_t));
+}
+
+/*!
+* \return	New compressed sparse row matrix or NULL on error.
+* \ingroup	AlgMatrix
+* \brief	Creates a new compressed sparse row matrix with the
+* 		same entries as the given linked list row matrix.
+* \param	lMat			Given linked list row matrix.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+AlgMatrixCSR	*AlgMatrixCSRFromLLR(AlgMatrixLLR *lMat, AlgError *dstErr)
+{
+  size_t	idR;
+  AlgMatrixCSR	*mat = NULL;
+  AlgError	errNum = ALG_ERR_NONE;
+
+  if(lMat == NULL)
+  {
+    errNum = ALG_ERR_FUNC;
+  }
+  else if(lMat->type != ALG_MATRIX_LLR)
+  {
+    errNum = ALG_ERR_MATRIX_TYPE;
+  }
+  else
+  {
+    mat = AlgMatrixCSRNew(lMat->nR, lMat->nC, lMat->numEnt, &errNum);
+  }
+  if(errNum == ALG_ERR_NONE)
+  {
+    size_t	nE = 0;
+
+    for(idR = 0; idR < lMat->nR; ++idR)
+    {
+      AlgMatrixLLRE *p;
+
+      mat->rowIdx[idR] = nE;
+      for(p = lMat->tbl[idR]; p != NULL; p = p->nxt)
+      {
+        ++nE;
+      }
+    }
+    mat->rowIdx[lMat->nR] = nE;
+    mat->numEnt = nE;
+#ifdef _OPENMP
+    #pragma omp parallel for default(shared)
+#endif
+    for(idR = 0; idR < lMat->nR; ++idR)
+    {
+      size_t	idE;
+      AlgMatrixLLRE *p;
+
+      idE = mat->rowIdx[idR];
+      for(p = lMat->tbl[idR]; p != NULL; p = p->nxt)
+      {
+        mat->colIdx[idE] = p->col;
+	mat->val[idE] = p->val;
+	++idE;
+      }
+    }
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(mat);
+}
+
+/*!
+* \return	New compressed sparse row matrix or NULL on error.
+* \ingroup	AlgMatrix
+* \brief	Creates a new compressed sparse row matrix from the
+* 		given triples. The triples may be in any order, triples
+* 		with the same row and column have their values summed
+* 		and entries with an absolute value less than the given
+* 		tolerance are not kept.
+* \param	nR			Number of rows.
+* \param	nC			Number of columns.
+* \param	nT			Number of triples.
+* \param	tri			Array of triples, which is not
+* 					modified.
+* \param	tol			Lowest absolute non-zero value.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+AlgMatrixCSR	*AlgMatrixCSRFromTriples(size_t nR, size_t nC, size_t nT,
+					 AlgMatrixTriple *tri, double tol,
+					 AlgError *dstErr)
+{
+  size_t	idR,
+		idT;
+  size_t	*cnt = NULL;
+  AlgMatrixTriple *buf = NULL;
+  AlgMatrixCSR	*mat = NULL;
+  AlgError	errNum = ALG_ERR_NONE;
+
+  if((nT > 0) && (tri == NULL))
+  {
+    errNum = ALG_ERR_FUNC;
+  }
+  else
+  {
+    for(idT = 0; idT < nT; ++idT)
+    {
+      if((tri[idT].row >= nR) || (tri[idT].col >= nC))
+      {
+        errNum = ALG_ERR_FUNC;
+	break;
+      }
+    }
+  }
+  if(errNum == ALG_ERR_NONE)
+  {
+    if(((cnt = (size_t *)AlcCalloc(nR + 1, sizeof(size_t))) == NULL) ||
+       ((buf = (AlgMatrixTriple *)
+               AlcMalloc((nT + 1) * sizeof(AlgMatrixTriple))) == NULL))
+    {
+      errNum = ALG_ERR_MALLOC;
+    }
+  }
+  if(errNum == ALG_ERR_NONE)
+  {
+    mat = AlgMatrixCSRNew(nR, nC, nT, &errNum);
+  }
+  if(errNum == ALG_ERR_NONE)
+  {
+    /* Bucket the triples by row. */
+    for(idT = 0; idT < nT; ++idT)
+    {
+      ++(cnt[tri[idT].row + 1]);
+    }
+    for(idR = 0; idR < nR; ++idR)
+    {
+      cnt[idR + 1] += cnt[idR];
+    }
+    for(idT = 0; idT < nT; ++idT)
+    {
+      buf[cnt[tri[idT].row]++] = tri[idT];
+    }
+    for(idR = nR; idR > 0; --idR)
+    {
+      cnt[idR] = cnt[idR - 1];
+    }
+    cnt[0] = 0;
+    /* Sort the entries of each row by column, sum duplicate entries and
+     * remove those that are too small, keeping the number of entries
+     * of each row in the row index. */
+#ifdef _OPENMP
+    #pragma omp parallel for default(shared) schedule(dynamic, 256)
+#endif
+    for(idR = 0; idR < nR; ++idR)
+    {
+      size_t	i0,
+      		i1,
+		i2;
+      AlgMatrixTriple *t;
+
+      i2 = 0;
+      t = buf + cnt[idR];
+      i1 = cnt[idR + 1] - cnt[idR];
+      AlgMatrixCSRSortRow(t, i1);
+      for(i0 = 0; i0 < i1; ++i0)
+      {
+	if((i2 > 0) && (t[i2 - 1].col == t[i0].col))
+	{
+	  t[i2 - 1].val += t[i0].val;
+	}
+	else
+	{
+	  t[i2++] = t[i0];
+	}
+      }
+      i1 = i2;
+      i2 = 0;
+      for(i0 = 0; i0 < i1; ++i0)
+      {
+        if(fabs(t[i0].val) >= tol)
+	{
+	  t[i2++] = t[i0];
+	}
+      }
+      mat->rowIdx[idR + 1] = i2;
+    }
+    for(idR = 0; idR < nR; ++idR)
+    {
+      mat->rowIdx[idR + 1] += mat->rowIdx[idR];
+    }
+    mat->numEnt = mat->rowIdx[nR];
+#ifdef _OPENMP
+    #pragma omp parallel for default(shared)
+#endif
+    for(idR = 0; idR < nR; ++idR)
+    {
+      size_t	i0,
+		i1;
+      AlgMatrixTriple *t;
+
+      t = buf + cnt[idR];
+      i1 = mat->rowIdx[idR];
+      for(i0 = i1; i0 < mat->rowIdx[idR + 1]; ++i0)
+      {
+        mat->colIdx[i0] = t->col;
+	mat->val[i0] = t->val;
+	++t;
+      }
+    }
+  }
+  AlcFree(cnt);
+  AlcFree(buf);
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(mat);
+}
+
+/*!
+* \return	New compressed sparse row matrix or NULL on error.
+* \ingroup	AlgMatrix
+* \brief	Creates a new compressed sparse row matrix with the
+* 		entries of the given matrix which have an absolute
+* 		value of at least the given tolerance. The given matrix
+* 		may be of any type.
+* \param	aM			Given matrix.
+* \param	tol			Lowest absolute non-zero value.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+AlgMatrixCSR	*AlgMatrixCSRFromMatrix(AlgMatrix aM, double tol,
+				        AlgError *dstErr)
+{
+  AlgMatrixCSR	*mat = NULL;
+  AlgError	errNum = ALG_ERR_NONE;
+
+  if(aM.core == NULL)
+  {
+    errNum = ALG_ERR_FUNC;
+  }
+  else
+  {
+    switch(aM.core->type)
+    {
+      case ALG_MATRIX_LLR:
+	mat = AlgMatrixCSRFromLLR(aM.llr, &errNum);
+	break;
+      case ALG_MATRIX_CSR:
+	mat = AlgMatrixCSRNew(aM.csr->nR, aM.csr->nC, aM.csr->numEnt,
+			      &errNum);
+	if(errNum == ALG_ERR_NONE)
+	{
+	  errNum = AlgMatrixCSRCopyInPlace(mat, aM.csr);
+	}
+	break;
+      case ALG_MATRIX_RECT: /* FALLTHROUGH */
+      case ALG_MATRIX_SYM:
+	{
+	  size_t  idR,
+		  idC,
+		  nE = 0;
+
+	  for(idR = 0; idR < aM.core->nR; ++idR)
+	  {
+	    for(idC = 0; idC < aM.core->nC; ++idC)
+	    {
+	      if(fabs(AlgMatrixValue(aM, idR, idC)) >= tol)
+	      {
+		++nE;
+	      }
+	    }
+	  }
+	  mat = AlgMatrixCSRNew(aM.core->nR, aM.core->nC, nE, &errNum);
+	  if(errNum == ALG_ERR_NONE)
+	  {
+	    nE = 0;
+	    for(idR = 0; idR < aM.core->nR; ++idR)
+	    {
+	      mat->rowIdx[idR] = nE;
+	      for(idC = 0; idC < aM.core->nC; ++idC)
+	      {
+		double	v;
+
+		v = AlgMatrixValue(aM, idR, idC);
+		if(fabs(v) >= tol)
+		{
+		  mat->colIdx[nE] = idC;
+		  mat->val[nE] = v;
+		  ++nE;
+		}
+	      }
+	    }
+	    mat->rowIdx[aM.core->nR] = mat->numEnt = nE;
+	  }
+	}
+	break;
+      default:
+	errNum = ALG_ERR_MATRIX_TYPE;
+	break;
+    }
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(mat);
+}
+
+/*!
+* \return	Alg error code.
+* \ingroup	AlgMatrix
+* \brief	Copies the second compressed sparse row matrix to the
+* 		first, expanding the first if required.
+* \param	aM			Destination matrix.
+* \param	bM			Source matrix.
+*/
+AlgError	AlgMatrixCSRCopyInPlace(AlgMatrixCSR *aM, AlgMatrixCSR *bM)
+{
+  AlgError	errNum = ALG_ERR_NONE;
+
+  if((aM == NULL) || (bM == NULL) || (aM->nR != bM->nR))
+  {
+    errNum = ALG_ERR_FUNC;
+  }
+  else if(aM != bM)
+  {
+    if(aM->maxEnt < bM->numEnt)
+    {
+      errNum = AlgMatrixCSRExpand(aM, bM->numEnt);
+    }
+    if(errNum == ALG_ERR_NONE)
+    {
+      aM->nC = bM->nC;
+      aM->numEnt = bM->numEnt;
+      (void )memcpy(aM->rowIdx, bM->rowIdx, (bM->nR + 1) * sizeof(size_t));
+      (void )memcpy(aM->colIdx, bM->colIdx, bM->numEnt * sizeof(size_t));
+      (void )memcpy(aM->val, bM->val, bM->numEnt * sizeof(double));
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	New compressed sparse row matrix or NULL on error.
+* \ingroup	AlgMatrix
+* \brief	Creates the transpose of the given compressed sparse row
+* 		matrix. Products with the transpose of a matrix can then
+* 		be computed by the (parallel) gather rather than scatter
+* 		loops.
+* \param	aM			Given matrix.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+AlgMatrixCSR	*AlgMatrixCSRTranspose(AlgMatrixCSR *aM, AlgError *dstErr)
+{
+  size_t	idC,
+		idR;
+  AlgMatrixCSR	*tM = NULL;
+  AlgError	errNum = ALG_ERR_NONE;
+
+  if(aM == NULL)
+  {
+    errNum = ALG_ERR_FUNC;
+  }
+  else
+  {
+    tM = AlgMatrixCSRNew(aM->nC, aM->nR, aM->numEnt, &errNum);
+  }
+  if(errNum == ALG_ERR_NONE)
+  {
+    size_t	*rI;
+
+    rI = tM->rowIdx;
+    for(idR = 0; idR < aM->numEnt; ++idR)
+    {
+      ++(rI[aM->colIdx[idR] + 1]);
+    }
+    for(idC = 0; idC < aM->nC; ++idC)
+    {
+      rI[idC + 1] += rI[idC];
+    }
+    /* Rows of the matrix are visited in order so the columns of the
+     * transpose are in increasing order. */
+    for(idR = 0; idR < aM->nR; ++idR)
+    {
+      size_t	idE;
+
+      for(idE = aM->rowIdx[idR]; idE < aM->rowIdx[idR + 1]; ++idE)
+      {
+	size_t	idT;
+
+        idT = rI[aM->colIdx[idE]]++;
+	tM->colIdx[idT] = idR;
+	tM->val[idT] = aM->val[idE];
+      }
+    }
+    for(idC = aM->nC; idC > 0; --idC)
+    {
+      rI[idC] = rI[idC - 1];
+    }
+    rI[0] = 0;
+    tM->numEnt = aM->numEnt;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(tM);
+}
+
+/*!
+* \return	New compressed sparse row matrix or NULL on error.
+* \ingroup	AlgMatrix
+* \brief	Computes the matrix of the normal equations
+* 		\f$\mathbf{A}^T \mathbf{A}\f$ for the given compressed
+* 		sparse row matrix \f$\mathbf{A}\f$. Every row of the
+* 		returned matrix has a diagonal entry, which is zero for
+* 		the empty columns of \f$\mathbf{A}\f$.
+* \param	aM			Given matrix \f$\mathbf{A}\f$.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+AlgMatrixCSR	*AlgMatrixCSRNormal(AlgMatrixCSR *aM, AlgError *dstErr)
+{
+  size_t	idC,
+		nE = 0;
+  size_t	*mrk = NULL,
+		*lst = NULL;
+  double	*acc = NULL;
+  AlgMatrixCSR	*tM = NULL,
+		*nM = NULL;
+  AlgError	errNum = ALG_ERR_NONE;
+
+  if(aM == NULL)
+  {
+    errNum = ALG_ERR_FUNC;
+  }
+  else
+  {
+    tM = AlgMatrixCSRTranspose(aM, &errNum);
+  }
+  if(errNum == ALG_ERR_NONE)
+  {
+    if(((mrk = (size_t *)AlcMalloc((aM->nC + 1) * sizeof(size_t))) == NULL) ||
+       ((lst = (size_t *)AlcMalloc((aM->nC + 1) * sizeof(size_t))) == NULL) ||
+       ((acc = (double *)AlcCalloc(aM->nC + 1, sizeof(double))) == NULL))
+    {
+      errNum = ALG_ERR_MALLOC;
+    }
+  }
+  if(errNum == ALG_ERR_NONE)
+  {
+    /* Count the entries of each row of A^T A using the marker array, row j
+     * of A^T A has an entry in column l for every row k of A with entries
+     * in both columns j and l. The diagonal is always present. */
+    for(idC = 0; idC < aM->nC; ++idC)
+    {
+      mrk[idC] = aM->nC;
+    }
+    for(idC = 0; idC < aM->nC; ++idC)
+    {
+      size_t	idT;
+
+      mrk[idC] = idC;
+      ++nE;
+      for(idT = tM->rowIdx[idC]; idT < tM->rowIdx[idC + 1]; ++idT)
+      {
+	size_t	idE,
+		k;
+
+	k = tM->colIdx[idT];
+	for(idE = aM->rowIdx[k]; idE < aM->rowIdx[k + 1]; ++idE)
+	{
+	  if(mrk[aM->colIdx[idE]] != idC)
+	  {
+	    mrk[aM->colIdx[idE]] = idC;
+	    ++nE;
+	  }
+	}
+      }
+    }
+    nM = AlgMatrixCSRNew(aM->nC, aM->nC, nE, &errNum);
+  }
+  if(errNum == ALG_ERR_NONE)
+  {
+    nE = 0;
+    for(idC = 0; idC < aM->nC; ++idC)
+    {
+      mrk[idC] = aM->nC;
+    }
+    for(idC = 0; idC < aM->nC; ++idC)
+    {
+      size_t	idL,
+      		idT,
+      		nL = 0;
+
+      nM->rowIdx[idC] = nE;
+      mrk[idC] = idC;
+      lst[nL++] = idC;
+      acc[idC] = 0.0;
+      for(idT = tM->rowIdx[idC]; idT < tM->rowIdx[idC + 1]; ++idT)
+      {
+	size_t	idE,
+		k;
+	double	t;
+
+	k = tM->colIdx[idT];
+	t = tM->val[idT];
+	for(idE = aM->rowIdx[k]; idE < aM->rowIdx[k + 1]; ++idE)
+	{
+	  size_t l;
+
+	  l = aM->colIdx[idE];
+	  if(mrk[l] != idC)
+	  {
+	    mrk[l] = idC;
+	    lst[nL++] = l;
+	    acc[l] = 0.0;
+	  }
+	  acc[l] += t * aM->val[idE];
+	}
+      }
+      qsort(lst, nL, sizeof(size_t), AlgMatrixCSRSizeCmp);
+      for(idL = 0; idL < nL; ++idL)
+      {
+        nM->colIdx[nE] = lst[idL];
+	nM->val[nE] = acc[lst[idL]];
+	++nE;
+      }
+    }
+    nM->rowIdx[aM->nC] = nM->numEnt = nE;
+  }
+  AlgMatrixCSRFree(tM);
+  AlcFree(mrk);
+  AlcFree(lst);
+  AlcFree(acc);
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(nM);
+}
+
+/*!
+* \return	Value in matrix at given coordinates.
+* \ingroup	AlgMatrix
+* \brief	Returns the value in the matrix at the given coordinates.
+* \param	mat			Compressed sparse row matrix.
+* \param	row			Given row.
+* \param	col			Given column.
+*/
+double		AlgMatrixCSRValue(AlgMatrixCSR *mat, size_t row, size_t col)
+{
+  size_t	lo,
+		hi;
+  double	val = 0.0;
+
+  lo = mat->rowIdx[row];
+  hi = mat->rowIdx[row + 1];
+  while(lo < hi)
+  {
+    size_t	mid;
+
+    mid = (lo + hi) / 2;
+    if(mat->colIdx[mid] < col)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  if((lo < mat->rowIdx[row + 1]) && (mat->colIdx[lo] == col))
+  {
+    val = mat->val[lo];
+  }
+  return(val);
+}
+
+/*!
+* \return	Alg error code.
+* \ingroup	AlgMatrix
+* \brief	Sets the value in the matrix at the given coordinates.
+* 		If there is no entry at the coordinates then one is
+* 		inserted, which requires the entries of all following
+* 		rows to be moved. Building a matrix this way is slow,
+* 		AlgMatrixCSRFromTriples() should be used instead.
+* \param	mat			Compressed sparse row matrix.
+* \param	row			Row coordinate.
+* \param	col			Column coordinate.
+* \param	val			Matrix value.
+*/
+AlgError	AlgMatrixCSRSet(AlgMatrixCSR *mat,
+				size_t row, size_t col, double val)
+{
+  size_t	idE;
+  AlgError	errNum = ALG_ERR_NONE;
+
+  for(idE = mat->rowIdx[row];
+      (idE < mat->rowIdx[row + 1]) && (mat->colIdx[idE] < col); ++idE)
+  {
+  }
+  if((idE < mat->rowIdx[row + 1]) && (mat->colIdx[idE] == col))
+  {
+    mat->val[idE] = val;
+  }
+  else if(val != 0.0)
+  {
+    if(mat->numEnt >= mat->maxEnt)
+    {
+      errNum = AlgMatrixCSRExpand(mat, 2 * mat->maxEnt);
+    }
+    if(errNum == ALG_ERR_NONE)
+    {
+      size_t	idR,
+		nM;
+
+      nM = mat->numEnt - idE;
+      (void )memmove(mat->colIdx + idE + 1, mat->colIdx + idE,
+		     nM * sizeof(size_t));
+      (void )memmove(mat->val + idE + 1, mat->val + idE,
+		     nM * sizeof(double));
+      mat->colIdx[idE] = col;
+      mat->val[idE] = val;
+      for(idR = row + 1; idR <= mat->nR; ++idR)
+      {
+        ++(mat->rowIdx[idR]);
+      }
+      ++(mat->numEnt);
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \ingroup	AlgMatrix
+* \brief	Solves \f$\mathbf{L} \mathbf{y} = \mathbf{x}\f$ for
+* 		\f$\mathbf{y}\f$ by forward substitution, where
+* 		\f$\mathbf{L}\f$ is a lower triangular compressed
+* 		sparse row matrix with the diagonal as the last entry
+* 		of each row. The solution overwrites \f$\mathbf{x}\f$.
+* \param	lM			Lower triangular matrix.
+* \param	xV			Vector \f$\mathbf{x}\f$.
+*/
+void		AlgMatrixCSRLSolve(AlgMatrixCSR *lM, double *xV)
+{
+  size_t	idR;
+
+  for(idR = 0; idR < lM->nR; ++idR)
+  {
+    size_t	idE,
+		idD;
+    double	v;
+
+    v = xV[idR];
+    idD = lM->rowIdx[idR + 1] - 1;
+    for(idE = lM->rowIdx[idR]; idE < idD; ++idE)
+    {
+      v -= lM->val[idE] * xV[lM->colIdx[idE]];
+    }
+    xV[idR] = v / lM->val[idD];
+  }
+}
+
+/*!
+* \ingroup	AlgMatrix
+* \brief	Solves \f$\mathbf{L}^T \mathbf{y} = \mathbf{x}\f$ for
+* 		\f$\mathbf{y}\f$ by backward substitution, where
+* 		\f$\mathbf{L}\f$ is a lower triangular compressed
+* 		sparse row matrix with the diagonal as the last entry
+* 		of each row. The solution overwrites \f$\mathbf{x}\f$.
+* \param	lM			Lower triangular matrix.
+* \param	xV			Vector \f$\mathbf{x}\f$.
+*/
+void		AlgMatrixCSRLTSolve(AlgMatrixCSR *lM, double *xV)
+{
+  size_t	idR;
+
+  for(idR = lM->nR; idR > 0; --idR)
+  {
+    size_t	idE,
+		idD;
+    double	v;
+
+    idD = lM->rowIdx[idR] - 1;
+    v = xV[idR - 1] / lM->val[idD];
+    xV[idR - 1] = v;
+    for(idE = lM->rowIdx[idR - 1]; idE < idD; ++idE)
+    {
+      xV[lM->colIdx[idE]] -= lM->val[idE] * v;
+    }
+  }
+}
+
+/*!
+* \return	Alg error code.
+* \ingroup	AlgMatrix
+* \brief	Writes a compressed sparse row matrix in numeric ASCI
+* 		format to the given file file. The rows are on separate
+* 		lines and the columns of each row are white space
+* 		seperated.
+* \param	mat			Given matrix.
+* \param	fP			Output file pointer.
+*/
+AlgError	AlgMatrixCSRWriteAscii(AlgMatrixCSR *mat, FILE *fP)
+{
+  size_t	idR,
+  		idC;
+  AlgError	errNum = ALG_ERR_NONE;
+
+  for(idR = 0; idR < mat->nR; ++idR)
+  {
+    size_t	idE;
+
+    idE = mat->rowIdx[idR];
+    for(idC = 0; idC < mat->nC; ++idC)
+    {
+      double	val = 0.0;
+
+      if((idE < mat->rowIdx[idR + 1]) && (mat->colIdx[idE] == idC))
+      {
+        val = mat->val[idE++];
+      }
+      (void )fprintf(fP, "%lg ", val);
+    }
+    if(fprintf(fP, "\n") != 1)
+    {
+      errNum = ALG_ERR_WRITE;
+      break;
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Alg error code.
+* \ingroup	AlgMatrix
+* \brief	Ensures that there is space for at least the requested
+* 		number of entries.
+* \param	mat			Compressed sparse row matrix.
+* \param	nE			Required number of entries.
+*/
+static AlgError	AlgMatrixCSRExpand(AlgMatrixCSR *mat, size_t nE)
+{
+  size_t	*cI;
+  double	*vl;
+  AlgError	errNum = ALG_ERR_NONE;
+
+  if(nE > mat->maxEnt)
+  {
+    if((cI = (size_t *)AlcRealloc(mat->colIdx, nE * sizeof(size_t))) == NULL)
+    {
+      errNum = ALG_ERR_MALLOC;
+    }
+    else
+    {
+      mat->colIdx = cI;
+      if((vl = (double *)AlcRealloc(mat->val, nE * sizeof(double))) == NULL)
+      {
+	errNum = ALG_ERR_MALLOC;
+      }
+      else
+      {
+	mat->val = vl;
+	mat->maxEnt = nE;
+      }
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \ingroup	AlgMatrix
+* \brief	Sorts the triples of a single row into increasing column
+* 		order, using an insertion sort for the short rows which
+* 		are typical of sparse matrices.
+* \param	t			Triples of the row.
+* \param	n			Number of triples.
+*/
+static void	AlgMatrixCSRSortRow(AlgMatrixTriple *t, size_t n)
+{
+  if(n > 32)
+  {
+    qsort(t, n, sizeof(AlgMatrixTriple), AlgMatrixCSRTripleColCmp);
+  }
+  else
+  {
+    size_t	i,
+		j;
+
+    for(i = 1; i < n; ++i)
+    {
+      AlgMatrixTriple k;
+
+      k = t[i];
+      for(j = i; (j > 0) && (t[j - 1].col > k.col); --j)
+      {
+        t[j] = t[j - 1];
+      }
+      t[j] = k;
+    }
+  }
+}
+
+/*!
+* \return	Comparison of the triple columns.
+* \ingroup	AlgMatrix
+* \brief	Sort comparison function for triples by column.
+* \param	p0			First triple.
+* \param	p1			Second triple.
+*/
+static int	AlgMatrixCSRTripleColCmp(const void *p0, const void *p1)
+{
+  size_t	c0,
+		c1;
+
+  c0 = ((const AlgMatrixTriple *)p0)->col;
+  c1 = ((const AlgMatrixTriple *)p1)->col;
+  return((c0 > c1) - (c0 < c1));
+}
+
+/*!
+* \return	Comparison of the sizes.
+* \ingroup	AlgMatrix
+* \brief	Sort comparison function for size_t values.
+* \param	p0			First value.
+* \param	p1			Second value.
+*/
+static int	AlgMatrixCSRSizeCmp(const void *p0, const void *p1)
+{
+  size_t	s0,
+		s1;
+
+  s0 = *(const size_t *)p0;
+  s1 = *(const size_t *)p1;
+  return((s0 > s1) - (s0 < s1));
+}
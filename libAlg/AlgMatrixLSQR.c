@@ -47,7 +47,38 @@ static char _AlgMatrixLSQR_c[] = "University of Edinburgh $Id$";
 #include <Alg.h>
 #include <float.h>
 
+/*!
+* \struct	_AlgMatrixLSQROp
+* \ingroup	AlgMatrix
+* \brief	The (right preconditioned) operator used by LSQR, with
+* 		which products with \f$\mathbf{A} \mathbf{R}^{-1}\f$ and
+* 		its transpose are computed.
+*/
+typedef struct _AlgMatrixLSQROp
+{
+  AlgMatrix		aM;	/*!< Matrix \f$\mathbf{A}\f$. */
+  AlgMatrix		tM;	/*!< Transpose of \f$\mathbf{A}\f$ if
+  				     available, otherwise with core NULL. */
+  AlgMatrixPrecondType	pcType;	/*!< Preconditioner type. */
+  double		*dV;	/*!< Inverse column norms of \f$\mathbf{A}\f$
+  				     for Jacobi preconditioning. */
+  AlgMatrixPrecond	*pc;	/*!< Incomplete Cholesky preconditioner for
+  				     \f$\mathbf{A}^T \mathbf{A}\f$. */
+  double		*tV;	/*!< Workspace vector with nC entries. */
+  size_t		nC;	/*!< Number of columns of \f$\mathbf{A}\f$. */
+} AlgMatrixLSQROp;
 
+static void			AlgMatrixLSQRAv(
+				  AlgMatrixLSQROp *op,
+				  double *uV,
+				  double *vV);
+static void			AlgMatrixLSQRATu(
+				  AlgMatrixLSQROp *op,
+				  double *vV,
+				  double *uV);
+static void			AlgMatrixLSQRRInv(
+				  AlgMatrixLSQROp *op,
+				  double *xV);
 static double 			AlgMatrixLSQRNorm2(
 				  double a,
 				  double b);
@@ -184,6 +215,80 @@ AlgError 	AlgMatrixSolveLSQR(AlgMatrix aM,
 				int *dstTerm, long *dstItr, double *dstFNorm,
 				double *dstCondN, double *dstResNorm,
 				double *dstResNormA, double *dstNormX)
+{
+  return(AlgMatrixSolveLSQRPrecond(aM, bV, xV, ALG_MATRIX_PRECOND_NONE,
+  				   damping, relErrA, relErrB, maxItr, condLim,
+				   dstTerm, dstItr, dstFNorm, dstCondN,
+				   dstResNorm, dstResNormA, dstNormX));
+}
+
+/*!
+* \return	Alg error code.
+* \ingroup	AlgMatrix
+* \brief	Solves the same problems as AlgMatrixSolveLSQR() but
+* 		with right preconditioning, ie LSQR is applied to
+* 		\f$\mathbf{A} \mathbf{R}^{-1} \mathbf{y} = \mathbf{b}\f$
+* 		and the solution is then
+* 		\f$\mathbf{x} = \mathbf{R}^{-1} \mathbf{y}\f$.
+* 		For Jacobi preconditioning \f$\mathbf{R}\f$ is the
+* 		diagonal matrix of the column norms of \f$\mathbf{A}\f$
+* 		(ie the square root of the Jacobi preconditioner of the
+* 		normal equations), while for incomplete Cholesky
+* 		preconditioning \f$\mathbf{R} = \mathbf{L}^T\f$ where
+* 		\f$\mathbf{L}\f$ is the IC(0) factor of
+* 		\f$\mathbf{A}^T \mathbf{A}\f$.
+*
+* 		If preconditioning is used or the matrix is a compressed
+* 		sparse row matrix then the transpose of the matrix is
+* 		built so that all matrix vector products are computed
+* 		in parallel. Matrices of other types are converted to
+* 		compressed sparse row matrices when preconditioning is
+* 		used.
+*
+* 		With preconditioning the damping, tolerances, condition
+* 		number and norm estimates all apply to the preconditioned
+* 		system. The initial values of xV are ignored.
+* \param	aM			Matrix A with nR rows and nC columns,
+* 					which is not modified.
+* \param	bV			Vector b with nR entries which are
+* 					modified by this function.
+* \param	xV			Vector with nC entries for the return
+* 					of the solution.
+* \param	pcType			Type of preconditioner.
+* \param	damping			Damping parameter, see
+* 					AlgMatrixSolveLSQR().
+* \param	relErrA			Relative error in A, see
+* 					AlgMatrixSolveLSQR().
+* \param	relErrB			Relative error in b, see
+* 					AlgMatrixSolveLSQR().
+* \param	maxItr			Iteration limit, see
+* 					AlgMatrixSolveLSQR().
+* \param	condLim			Condition number limit, see
+* 					AlgMatrixSolveLSQR().
+* \param	dstTerm			Destination pointer for termination
+* 					code, see AlgMatrixSolveLSQR().
+* \param	dstItr			Destination pointer for the number of
+* 				 	iterations, may be NULL.
+* \param	dstFNorm		Destination pointer for the Frobenius
+* 					norm estimate, may be NULL.
+* \param	dstCondN		Destination pointer for the condition
+* 					number estimate, may be NULL.
+* \param	dstResNorm		Destination pointer for the residual
+* 					norm estimate, may be NULL.
+* \param	dstResNormA		Destination pointer for the normal
+* 					equations residual estimate, may be
+* 					NULL.
+* \param	dstNormX		Destination pointer for the solution
+* 					norm estimate, may be NULL.
+*/
+AlgError 	AlgMatrixSolveLSQRPrecond(AlgMatrix aM,
+				double *bV, double *xV,
+				AlgMatrixPrecondType pcType,
+				double damping, double relErrA, double relErrB,
+				long maxItr, long condLim,
+				int *dstTerm, long *dstItr, double *dstFNorm,
+				double *dstCondN, double *dstResNorm,
+				double *dstResNormA, double *dstNormX)
 {
   long    	idx,
           	termItrMax,
@@ -236,10 +341,19 @@ AlgError 	AlgMatrixSolveLSQR(AlgMatrix aM,
 		zeta = 0.0;
   double	*vV = NULL,
   		*wV = NULL;
+  AlgMatrix	cM;
+  AlgMatrixLSQROp op;
   AlgError	errNum = ALG_ERR_NONE;
 
+  cM.core = NULL;
+  op.aM = aM;
+  op.tM.core = NULL;
+  op.pcType = pcType;
+  op.dV = NULL;
+  op.pc = NULL;
+  op.tV = NULL;
   nR = aM.core->nR;
-  nC = aM.core->nC;
+  op.nC = nC = aM.core->nC;
   if(maxItr <= 0)
   {
     maxItr = nC;
@@ -265,12 +379,97 @@ AlgError 	AlgMatrixSolveLSQR(AlgMatrix aM,
 #endif
   /* Allocate workspace vectors. */
   if(((vV = (double *)AlcCalloc(nC, sizeof(double))) == NULL) ||
-     ((wV = (double *)AlcCalloc(nC, sizeof(double))) == NULL))
+     ((wV = (double *)AlcCalloc(nC, sizeof(double))) == NULL) ||
+     ((op.tV = (double *)AlcCalloc(nC, sizeof(double))) == NULL))
   {
     errNum = ALG_ERR_MALLOC;
   }
+  /* Set up the transposed matrix and preconditioner. */
+  if((errNum == ALG_ERR_NONE) &&
+     ((pcType != ALG_MATRIX_PRECOND_NONE) ||
+      (aM.core->type == ALG_MATRIX_CSR)))
+  {
+    if(aM.core->type != ALG_MATRIX_CSR)
+    {
+      cM.csr = AlgMatrixCSRFromMatrix(aM, 0.0, &errNum);
+      op.aM = cM;
+    }
+    if(errNum == ALG_ERR_NONE)
+    {
+      op.tM.csr = AlgMatrixCSRTranspose(op.aM.csr, &errNum);
+    }
+    if(errNum == ALG_ERR_NONE)
+    {
+      switch(pcType)
+      {
+        case ALG_MATRIX_PRECOND_NONE:
+	  break;
+	case ALG_MATRIX_PRECOND_JACOBI:
+	  if((op.dV = (double *)AlcMalloc(nC * sizeof(double))) == NULL)
+	  {
+	    errNum = ALG_ERR_MALLOC;
+	  }
+	  else
+	  {
+#ifdef _OPENMP
+	    #pragma omp parallel for default(shared) private(idx)
+#endif
+	    for(idx = 0; idx < nC; ++idx)
+	    {
+	      size_t	idE;
+	      double	d = 0.0;
+
+	      for(idE = op.tM.csr->rowIdx[idx];
+	          idE < op.tM.csr->rowIdx[idx + 1]; ++idE)
+	      {
+	        d += op.tM.csr->val[idE] * op.tM.csr->val[idE];
+	      }
+	      op.dV[idx] = (d > DBL_EPSILON)? 1.0 / sqrt(d): 1.0;
+	    }
+	  }
+	  break;
+	case ALG_MATRIX_PRECOND_ICHOL:
+	  {
+	    AlgMatrix	nM;
+
+	    nM.csr = AlgMatrixCSRNormal(op.aM.csr, &errNum);
+	    if(errNum == ALG_ERR_NONE)
+	    {
+	      size_t	idR,
+	      		idE;
+
+	      /* Empty columns of A give zero diagonal entries which are
+	       * replaced by one, leaving these variables unscaled. */
+	      for(idR = 0; idR < nM.csr->nR; ++idR)
+	      {
+		for(idE = nM.csr->rowIdx[idR]; idE < nM.csr->rowIdx[idR + 1];
+		    ++idE)
+		{
+		  if((nM.csr->colIdx[idE] == idR) &&
+		     (fabs(nM.csr->val[idE]) < DBL_EPSILON))
+		  {
+		    nM.csr->val[idE] = 1.0;
+		  }
+		}
+	      }
+	      op.pc = AlgMatrixPrecondNew(nM, ALG_MATRIX_PRECOND_ICHOL,
+	      				  &errNum);
+	    }
+	    AlgMatrixCSRFree(nM.csr);
+	  }
+	  break;
+	default:
+	  errNum = ALG_ERR_FUNC;
+	  break;
+      }
+    }
+  }
   if(errNum == ALG_ERR_NONE)
   {
+    if(pcType != ALG_MATRIX_PRECOND_NONE)
+    {
+      AlgVectorZero(xV, nC);
+    }
     /* Set up the initial vectors u and v for bidiagonalization.  These
      * satisfy  the relations
      * beta*u = b - A*x0 
@@ -283,7 +482,7 @@ AlgError 	AlgMatrixSolveLSQR(AlgMatrix aM,
       /* Scale vector u by the inverse of beta */
       AlgVectorScale(bV, bV, 1.0 / beta, nR);
       /* Compute matrix-vector product A^T*u and store it in vector v */
-      AlgMatrixTVectorMulAdd(vV, aM, bV, vV);
+      AlgMatrixLSQRATu(&op, vV, bV);
       /* Compute Euclidean length of v and store as alpha */
       alpha = AlgVectorNorm(vV, nC);
     }
@@ -350,7 +549,7 @@ AlgError 	AlgMatrixSolveLSQR(AlgMatrix aM,
       /* Scale vector u by -alpha */
       AlgVectorScale(bV, bV, -alpha, nR);
       /* Compute A*v - alpha*u and store in vector u */
-      AlgMatrixVectorMulAdd(bV, aM, vV, bV);
+      AlgMatrixLSQRAv(&op, bV, vV);
       /* Compute Euclidean length of u and store as beta */
       beta = AlgVectorNorm(bV, nR);
       /* Accumulate this quantity to estimate Frobenius norm of matrix A */
@@ -362,7 +561,7 @@ AlgError 	AlgMatrixSolveLSQR(AlgMatrix aM,
 	/* Scale vector v by -beta */
 	AlgVectorScale(vV, vV, -beta, nC);
 	/* Compute A^T*u - beta*v and store in vector v */
-	AlgMatrixTVectorMulAdd(vV, aM, bV, vV);
+	AlgMatrixLSQRATu(&op, vV, bV);
 	/* Compute Euclidean length of v and store as alpha */
 	alpha = AlgVectorNorm(vV, nC);
 	if(alpha > 0.0)
@@ -520,6 +719,8 @@ AlgError 	AlgMatrixSolveLSQR(AlgMatrix aM,
       temp = (double )nR;
     }
     temp = resNorm / sqrt(temp);
+    /* Recover the solution of the unpreconditioned system. */
+    AlgMatrixLSQRRInv(&op, xV);
     if(dstTerm)
     {
       *dstTerm = term;
@@ -551,6 +752,11 @@ AlgError 	AlgMatrixSolveLSQR(AlgMatrix aM,
   }
   AlcFree(vV);
   AlcFree(wV);
+  AlcFree(op.tV);
+  AlcFree(op.dV);
+  AlgMatrixPrecondFree(op.pc);
+  AlgMatrixFree(op.tM);
+  AlgMatrixFree(cM);
 #ifdef ALG_MATRIXLSQR_DEBUG
   (void )fprintf(stderr,
 		 "AlgMatrixSolveLSQR()\n"
@@ -567,6 +773,97 @@ AlgError 	AlgMatrixSolveLSQR(AlgMatrix aM,
   return(errNum);
 }
 
+/*!
+* \ingroup	AlgMatrix
+* \brief	Computes \f$\mathbf{u} = \mathbf{A} \mathbf{R}^{-1}
+* 		\mathbf{v} + \mathbf{u}\f$.
+* \param	op			LSQR operator.
+* \param	uV			Vector \f$\mathbf{u}\f$.
+* \param	vV			Vector \f$\mathbf{v}\f$, which is
+* 					not modified.
+*/
+static void	AlgMatrixLSQRAv(AlgMatrixLSQROp *op, double *uV, double *vV)
+{
+  if(op->pcType == ALG_MATRIX_PRECOND_NONE)
+  {
+    AlgMatrixVectorMulAdd(uV, op->aM, vV, uV);
+  }
+  else
+  {
+    AlgVectorCopy(op->tV, vV, op->nC);
+    AlgMatrixLSQRRInv(op, op->tV);
+    AlgMatrixVectorMulAdd(uV, op->aM, op->tV, uV);
+  }
+}
+
+/*!
+* \ingroup	AlgMatrix
+* \brief	Computes \f$\mathbf{v} = \mathbf{R}^{-T} \mathbf{A}^T
+* 		\mathbf{u} + \mathbf{v}\f$.
+* \param	op			LSQR operator.
+* \param	vV			Vector \f$\mathbf{v}\f$.
+* \param	uV			Vector \f$\mathbf{u}\f$, which is
+* 					not modified.
+*/
+static void	AlgMatrixLSQRATu(AlgMatrixLSQROp *op, double *vV, double *uV)
+{
+  if(op->tM.core == NULL)
+  {
+    AlgMatrixTVectorMul(op->tV, op->aM, uV);
+  }
+  else
+  {
+    AlgMatrixVectorMul(op->tV, op->tM, uV);
+  }
+  switch(op->pcType)
+  {
+    case ALG_MATRIX_PRECOND_JACOBI:
+      {
+        size_t	idx;
+
+	for(idx = 0; idx < op->nC; ++idx)
+	{
+	  op->tV[idx] *= op->dV[idx];
+	}
+      }
+      break;
+    case ALG_MATRIX_PRECOND_ICHOL:
+      AlgMatrixCSRLSolve(op->pc->l, op->tV);
+      break;
+    default:
+      break;
+  }
+  AlgVectorAdd(vV, vV, op->tV, op->nC);
+}
+
+/*!
+* \ingroup	AlgMatrix
+* \brief	Computes \f$\mathbf{R}^{-1} \mathbf{x}\f$ in place.
+* \param	op			LSQR operator.
+* \param	xV			Vector \f$\mathbf{x}\f$.
+*/
+static void	AlgMatrixLSQRRInv(AlgMatrixLSQROp *op, double *xV)
+{
+  switch(op->pcType)
+  {
+    case ALG_MATRIX_PRECOND_JACOBI:
+      {
+        size_t	idx;
+
+	for(idx = 0; idx < op->nC; ++idx)
+	{
+	  xV[idx] *= op->dV[idx];
+	}
+      }
+      break;
+    case ALG_MATRIX_PRECOND_ICHOL:
+      AlgMatrixCSRLTSolve(op->pc->l, xV);
+      break;
+    default:
+      break;
+  }
+}
+
 /*!
 * \return	Norm of the given values.
 * \ingroup	AlgMatrix
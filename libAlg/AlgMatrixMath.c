@@ -45,6 +45,14 @@ static char _AlgMatrixMath_c[] = "University of Edinburgh $Id$";
 #include <float.h>
 #include <Alg.h>
 
+static void			AlgMatrixCSRVectorMulWAdd(
+				  double *aV,
+				  AlgMatrixCSR *bM,
+				  double *cV,
+				  double *dV,
+				  double s,
+				  double t);
+
 /*!
 * \return       void
 * \ingroup      AlgMatrix
@@ -514,6 +522,12 @@ double		AlgMatrixTrace(AlgMatrix aM)
 	trace += AlgMatrixLLRValue(aM.llr, id0, id0);
       }
       break;
+    case ALG_MATRIX_CSR:
+      for(id0 = 0; id0 < nN; ++id0)
+      {
+	trace += AlgMatrixCSRValue(aM.csr, id0, id0);
+      }
+      break;
     default:
       break;
   }
@@ -663,6 +677,9 @@ void            AlgMatrixCopy(AlgMatrix aM, AlgMatrix bM)
     case ALG_MATRIX_LLR:
       (void )AlgMatrixLLRCopyInPlace(aM.llr, bM.llr);
       break;
+    case ALG_MATRIX_CSR:
+      (void )AlgMatrixCSRCopyInPlace(aM.csr, bM.csr);
+      break;
     default:
       break;
   }
@@ -1056,6 +1073,9 @@ void 		AlgMatrixVectorMul(double *aV, AlgMatrix bM, double *cV)
 	}
       }
       break;
+    case ALG_MATRIX_CSR:
+      AlgMatrixCSRVectorMulWAdd(aV, bM.csr, cV, NULL, 1.0, 0.0);
+      break;
     default:
       break;
   }
@@ -1165,6 +1185,9 @@ void 		AlgMatrixVectorMulAdd(double *aV, AlgMatrix bM,
 	}
       }
       break;
+    case ALG_MATRIX_CSR:
+      AlgMatrixCSRVectorMulWAdd(aV, bM.csr, cV, dV, 1.0, 1.0);
+      break;
     default:
       break;
   }
@@ -1261,6 +1284,9 @@ void 		AlgMatrixVectorMulWAdd(double *aV, AlgMatrix bM,
 	}
       }
       break;
+    case ALG_MATRIX_CSR:
+      AlgMatrixCSRVectorMulWAdd(aV, bM.csr, cV, dV, s, t);
+      break;
     default:
       break;
   }
@@ -1347,6 +1373,24 @@ void 		AlgMatrixTVectorMul(double *aV, AlgMatrix bM, double *cV)
 	}
       }
       break;
+    case ALG_MATRIX_CSR:
+      {
+	size_t	id0;
+
+	AlgVectorZero(aV, bM.csr->nC);
+	for(id0 = 0; id0 < bM.csr->nR; ++id0)
+	{
+	  size_t id1;
+	  double c;
+
+	  c = cV[id0];
+	  for(id1 = bM.csr->rowIdx[id0]; id1 < bM.csr->rowIdx[id0 + 1]; ++id1)
+	  {
+	    aV[bM.csr->colIdx[id1]] += bM.csr->val[id1] * c;
+	  }
+	}
+      }
+      break;
     default:
       break;
   }
@@ -1435,6 +1479,24 @@ void 		AlgMatrixTVectorMulAdd(double *aV, AlgMatrix bM,
 	}
       }
       break;
+    case ALG_MATRIX_CSR:
+      {
+	size_t	id0;
+
+	AlgVectorCopy(aV, dV, bM.csr->nC);
+	for(id0 = 0; id0 < bM.csr->nR; ++id0)
+	{
+	  size_t id1;
+	  double c;
+
+	  c = cV[id0];
+	  for(id1 = bM.csr->rowIdx[id0]; id1 < bM.csr->rowIdx[id0 + 1]; ++id1)
+	  {
+	    aV[bM.csr->colIdx[id1]] += bM.csr->val[id1] * c;
+	  }
+	}
+      }
+      break;
     default:
       break;
   }
@@ -1528,3 +1590,55 @@ AlgError	AlgMatrixRawInv3x3(double *a00, double *a01, double *a02,
   }
   return(errNum);
 }
+
+/*!
+* \ingroup      AlgMatrix
+* \brief	Multiplies the compressed sparse row matrix
+* 		\f$\mathbf{B}\f$ by the vector \f$\mathbf{c}\f$ and,
+* 		if given, adds the vector \f$\mathbf{d}\f$ using the
+* 		given weights \f$s\f$ and \f$t\f$:
+*		\f[
+		\mathbf{a} = s \mathbf{B} \mathbf{c} + t \mathbf{d}
+		\f]
+* 		This is the sparse matrix vector product shared by the
+* 		matrix vector multiplication functions.
+* \param	aV			Supplied vector for result.
+* \param	bM			CSR matrix \f$mathbf{B}\f$.
+* \param	cV			Vector \f$\mathbf{c}\f$.
+* \param	dV			Vector \f$\mathbf{d}\f$, may be NULL
+* 					in which case it is not added.
+* \param	s			First weighting scalar \f$s\f$.
+* \param	t			Second weighting scalar \f$t\f$.
+*/
+static void	AlgMatrixCSRVectorMulWAdd(double *aV, AlgMatrixCSR *bM,
+				   double *cV, double *dV, double s, double t)
+{
+  size_t	id0,
+		nR;
+  size_t	*rI,
+		*cI;
+  double	*bA;
+
+  nR = bM->nR;
+  rI = bM->rowIdx;
+  cI = bM->colIdx;
+  bA = bM->val;
+#ifdef _OPENMP
+  #pragma omp parallel for default(shared) private(id0)
+#endif
+  for(id0 = 0; id0 < nR; ++id0)
+  {
+    size_t id1;
+    double v;
+
+    v = 0.0;
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+    #pragma omp simd reduction(+:v)
+#endif
+    for(id1 = rI[id0]; id1 < rI[id0 + 1]; ++id1)
+    {
+      v += bA[id1] * cV[cI[id1]];
+    }
+    aV[id0] = (dV == NULL)? s * v: (s * v) + (t * dV[id0]);
+  }
+}
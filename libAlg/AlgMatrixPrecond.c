@@ -0,0 +1,389 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _AlgMatrixPrecond_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         libAlg/AlgMatrixPrecond.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Preconditioners for the iterative solution of sparse
+* 		linear systems.
+*
+* 		The preconditioners are built once for a matrix
+* 		\f$\mathbf{A}\f$ and then applied, using
+* 		AlgMatrixPrecondApply(), to solve
+* 		\f$\mathbf{M} \mathbf{z} = \mathbf{r}\f$ where
+* 		\f$\mathbf{M} \approx \mathbf{A}\f$. AlgMatrixPrecondApply()
+* 		has the signature required of the preconditioning
+* 		function passed to AlgMatrixCGSolve().
+* \ingroup	AlgMatrix
+*/
+#include <Alg.h>
+#include <float.h>
+#include <string.h>
+
+static AlgMatrixCSR		*AlgMatrixPrecondIChol(
+				  AlgMatrixCSR *aM,
+				  AlgError *dstErr);
+static int			AlgMatrixPrecondICholFactor(
+				  AlgMatrixCSR *lM);
+
+/*!
+* \return	New preconditioner or NULL on error.
+* \ingroup	AlgMatrix
+* \brief	Creates a preconditioner of the requested type for the
+* 		given square matrix.
+* 		Jacobi preconditioning may be used with a matrix of
+* 		any type. Incomplete Cholesky preconditioning requires
+* 		a symmetric positive definite matrix and is most
+* 		efficient for a compressed sparse row matrix, matrices
+* 		of other types are converted. If the IC(0) factorisation
+* 		breaks down then the diagonal of the matrix is
+* 		increasingly shifted until it succeeds.
+* \param	aM			Given square matrix.
+* \param	type			Type of preconditioner.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+AlgMatrixPrecond *AlgMatrixPrecondNew(AlgMatrix aM,
+				      AlgMatrixPrecondType type,
+				      AlgError *dstErr)
+{
+  AlgMatrixPrecond *pc = NULL;
+  AlgError	errNum = ALG_ERR_NONE;
+
+  if((aM.core == NULL) || (aM.core->nR < 1) ||
+     (aM.core->nR != aM.core->nC))
+  {
+    errNum = ALG_ERR_FUNC;
+  }
+  else if((pc = (AlgMatrixPrecond *)
+                AlcCalloc(1, sizeof(AlgMatrixPrecond))) == NULL)
+  {
+    errNum = ALG_ERR_MALLOC;
+  }
+  else
+  {
+    pc->type = type;
+    pc->n = aM.core->nR;
+    switch(type)
+    {
+      case ALG_MATRIX_PRECOND_NONE:
+	break;
+      case ALG_MATRIX_PRECOND_JACOBI:
+	if((pc->dInv = (double *)AlcMalloc(pc->n * sizeof(double))) == NULL)
+	{
+	  errNum = ALG_ERR_MALLOC;
+	}
+	else
+	{
+	  size_t idx;
+
+#ifdef _OPENMP
+	  #pragma omp parallel for default(shared)
+#endif
+	  for(idx = 0; idx < pc->n; ++idx)
+	  {
+	    double d;
+
+	    d = AlgMatrixValue(aM, idx, idx);
+	    pc->dInv[idx] = (fabs(d) > DBL_EPSILON)? 1.0 / d: 1.0;
+	  }
+	}
+	break;
+      case ALG_MATRIX_PRECOND_ICHOL:
+	if(aM.core->type == ALG_MATRIX_CSR)
+	{
+	  pc->l = AlgMatrixPrecondIChol(aM.csr, &errNum);
+	}
+	else
+	{
+	  AlgMatrixCSR *cM;
+
+	  cM = AlgMatrixCSRFromMatrix(aM, 0.0, &errNum);
+	  if(errNum == ALG_ERR_NONE)
+	  {
+	    pc->l = AlgMatrixPrecondIChol(cM, &errNum);
+	  }
+	  AlgMatrixCSRFree(cM);
+	}
+	break;
+      default:
+	errNum = ALG_ERR_FUNC;
+	break;
+    }
+  }
+  if(errNum != ALG_ERR_NONE)
+  {
+    AlgMatrixPrecondFree(pc);
+    pc = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(pc);
+}
+
+/*!
+* \ingroup	AlgMatrix
+* \brief	Frees a preconditioner.
+* \param	pc			Given preconditioner.
+*/
+void		AlgMatrixPrecondFree(AlgMatrixPrecond *pc)
+{
+  if(pc)
+  {
+    AlcFree(pc->dInv);
+    AlgMatrixCSRFree(pc->l);
+    AlcFree(pc);
+  }
+}
+
+/*!
+* \ingroup	AlgMatrix
+* \brief	Applies the preconditioner, solving
+* 		\f$\mathbf{M} \mathbf{z} = \mathbf{r}\f$ for
+* 		\f$\mathbf{z}\f$. This function may be passed, together
+* 		with the preconditioner, to AlgMatrixCGSolve().
+* \param	pDat			The preconditioner, which must be
+* 					an ::AlgMatrixPrecond.
+* \param	aM			Matrix \f$\mathbf{A}\f$, not used.
+* \param	rV			Vector \f$\mathbf{r}\f$.
+* \param	zV			Vector for \f$\mathbf{z}\f$.
+*/
+void		AlgMatrixPrecondApply(void *pDat, AlgMatrix aM,
+				      double *rV, double *zV)
+{
+  AlgMatrixPrecond *pc;
+
+  pc = (AlgMatrixPrecond *)pDat;
+  switch(pc->type)
+  {
+    case ALG_MATRIX_PRECOND_JACOBI:
+      {
+	size_t	idx;
+
+#ifdef _OPENMP
+	#pragma omp parallel for default(shared)
+#endif
+	for(idx = 0; idx < pc->n; ++idx)
+	{
+	  zV[idx] = rV[idx] * pc->dInv[idx];
+	}
+      }
+      break;
+    case ALG_MATRIX_PRECOND_ICHOL:
+      AlgVectorCopy(zV, rV, pc->n);
+      AlgMatrixCSRLSolve(pc->l, zV);
+      AlgMatrixCSRLTSolve(pc->l, zV);
+      break;
+    default:
+      AlgVectorCopy(zV, rV, pc->n);
+      break;
+  }
+}
+
+/*!
+* \return	Lower triangular factor or NULL on error.
+* \ingroup	AlgMatrix
+* \brief	Computes the IC(0) incomplete Cholesky factor of the
+* 		given symmetric compressed sparse row matrix. The factor
+* 		has the sparsity pattern of the lower triangle of the
+* 		matrix. If the factorisation breaks down, because a
+* 		pivot is not positive, then the diagonal is scaled by
+* 		\f$(1 + \alpha)\f$ with \f$\alpha\f$ increasing from
+* 		\f$10^{-3}\f$ until it succeeds.
+* \param	aM			Given symmetric matrix with sorted
+* 					rows.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+static AlgMatrixCSR *AlgMatrixPrecondIChol(AlgMatrixCSR *aM,
+					   AlgError *dstErr)
+{
+  size_t	idR,
+		nE = 0;
+  double	*aV = NULL;
+  AlgMatrixCSR	*lM = NULL;
+  AlgError	errNum = ALG_ERR_NONE;
+
+  /* Count the entries of the lower triangle, each row must have a
+   * positive diagonal entry which is then the last entry of the row. */
+  for(idR = 0; idR < aM->nR; ++idR)
+  {
+    size_t	idE;
+
+    for(idE = aM->rowIdx[idR];
+        (idE < aM->rowIdx[idR + 1]) && (aM->colIdx[idE] <= idR); ++idE)
+    {
+      ++nE;
+    }
+    if((idE == aM->rowIdx[idR]) || (aM->colIdx[idE - 1] != idR) ||
+       (aM->val[idE - 1] <= 0.0))
+    {
+      errNum = ALG_ERR_MATRIX_SINGULAR;
+      break;
+    }
+  }
+  if(errNum == ALG_ERR_NONE)
+  {
+    lM = AlgMatrixCSRNew(aM->nR, aM->nC, nE, &errNum);
+  }
+  if(errNum == ALG_ERR_NONE)
+  {
+    if((aV = (double *)AlcMalloc(nE * sizeof(double))) == NULL)
+    {
+      errNum = ALG_ERR_MALLOC;
+    }
+  }
+  if(errNum == ALG_ERR_NONE)
+  {
+    int		itr;
+    double	alpha = 0.0;
+    const int	maxItr = 10;
+
+    nE = 0;
+    for(idR = 0; idR < aM->nR; ++idR)
+    {
+      size_t	idE;
+
+      lM->rowIdx[idR] = nE;
+      for(idE = aM->rowIdx[idR];
+	  (idE < aM->rowIdx[idR + 1]) && (aM->colIdx[idE] <= idR); ++idE)
+      {
+	lM->colIdx[nE] = aM->colIdx[idE];
+	aV[nE] = aM->val[idE];
+	++nE;
+      }
+    }
+    lM->rowIdx[aM->nR] = lM->numEnt = nE;
+    for(itr = 0; itr < maxItr; ++itr)
+    {
+      (void )memcpy(lM->val, aV, nE * sizeof(double));
+      if(alpha > 0.0)
+      {
+	for(idR = 0; idR < lM->nR; ++idR)
+	{
+	  lM->val[lM->rowIdx[idR + 1] - 1] *= 1.0 + alpha;
+	}
+      }
+      if(AlgMatrixPrecondICholFactor(lM))
+      {
+	break;
+      }
+      alpha = (alpha > 0.0)? alpha * 10.0: 1.0e-3;
+    }
+    if(itr >= maxItr)
+    {
+      errNum = ALG_ERR_MATRIX_SINGULAR;
+    }
+  }
+  AlcFree(aV);
+  if(errNum != ALG_ERR_NONE)
+  {
+    AlgMatrixCSRFree(lM);
+    lM = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(lM);
+}
+
+/*!
+* \return	Non-zero if the factorisation succeeded.
+* \ingroup	AlgMatrix
+* \brief	Factorises the given lower triangle in place, computing
+* 		\f$\mathbf{L}\f$ with the same sparsity pattern.
+* \param	lM			Lower triangle of the matrix with the
+* 					diagonal as the last entry of each
+* 					row.
+*/
+static int	AlgMatrixPrecondICholFactor(AlgMatrixCSR *lM)
+{
+  size_t	idR;
+  int		ok = 1;
+
+  for(idR = 0; ok && (idR < lM->nR); ++idR)
+  {
+    size_t	idE,
+		idD;
+    double	d;
+
+    idD = lM->rowIdx[idR + 1] - 1;
+    for(idE = lM->rowIdx[idR]; idE < idD; ++idE)
+    {
+      size_t	k,
+		q0,
+		q1,
+		q1D;
+      double	s;
+
+      /* L(i,k) = (A(i,k) - sum_{j < k} L(i,j) L(k,j)) / L(k,k) */
+      k = lM->colIdx[idE];
+      s = lM->val[idE];
+      q0 = lM->rowIdx[idR];
+      q1 = lM->rowIdx[k];
+      q1D = lM->rowIdx[k + 1] - 1;
+      while((q0 < idE) && (q1 < q1D))
+      {
+        if(lM->colIdx[q0] == lM->colIdx[q1])
+	{
+	  s -= lM->val[q0++] * lM->val[q1++];
+	}
+	else if(lM->colIdx[q0] < lM->colIdx[q1])
+	{
+	  ++q0;
+	}
+	else
+	{
+	  ++q1;
+	}
+      }
+      lM->val[idE] = s / lM->val[q1D];
+    }
+    d = lM->val[idD];
+    for(idE = lM->rowIdx[idR]; idE < idD; ++idE)
+    {
+      d -= lM->val[idE] * lM->val[idE];
+    }
+    if(d > DBL_EPSILON * fabs(lM->val[idD]))
+    {
+      lM->val[idD] = sqrt(d);
+    }
+    else
+    {
+      ok = 0;
+    }
+  }
+  return(ok);
+}
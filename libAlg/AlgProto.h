@@ -129,6 +129,11 @@ extern AlgError        		AlgCrossCorrelate2D(
 				  double **data1,
 				  int nX,
 				  int nY);
+extern AlgError        		AlgCrossCorrelate2DFT(
+				  double **ft0,
+				  double **data1,
+				  int nX,
+				  int nY);
 extern void            		AlgCrossCorrPeakXY(
 				  int *dstMaxX,
 				  int *dstMaxY,
@@ -502,6 +507,57 @@ extern AlgError        		AlgMatrixWriteAscii(
 				  AlgMatrix mat,
 				  FILE *fP);
 
+/* From AlgMatrixCSR.c */
+extern AlgMatrixCSR		*AlgMatrixCSRNew(
+				  size_t nR,
+				  size_t nC,
+				  size_t nE,
+				  AlgError *dstErr);
+extern void			AlgMatrixCSRFree(
+				  AlgMatrixCSR *mat);
+extern void			AlgMatrixCSRZero(
+				  AlgMatrixCSR *mat);
+extern AlgMatrixCSR		*AlgMatrixCSRFromLLR(
+				  AlgMatrixLLR *lMat,
+				  AlgError *dstErr);
+extern AlgMatrixCSR		*AlgMatrixCSRFromTriples(
+				  size_t nR,
+				  size_t nC,
+				  size_t nT,
+				  AlgMatrixTriple *tri,
+				  double tol,
+				  AlgError *dstErr);
+extern AlgMatrixCSR		*AlgMatrixCSRFromMatrix(
+				  AlgMatrix aM,
+				  double tol,
+				  AlgError *dstErr);
+extern AlgError			AlgMatrixCSRCopyInPlace(
+				  AlgMatrixCSR *aM,
+				  AlgMatrixCSR *bM);
+extern AlgMatrixCSR		*AlgMatrixCSRTranspose(
+				  AlgMatrixCSR *aM,
+				  AlgError *dstErr);
+extern AlgMatrixCSR		*AlgMatrixCSRNormal(
+				  AlgMatrixCSR *aM,
+				  AlgError *dstErr);
+extern double			AlgMatrixCSRValue(
+				  AlgMatrixCSR *mat,
+				  size_t row,
+				  size_t col);
+extern AlgError			AlgMatrixCSRSet(
+				  AlgMatrixCSR *mat,
+                                  size_t row,
+				  size_t col,
+				  double val);
+extern void			AlgMatrixCSRLSolve(
+				  AlgMatrixCSR *lM,
+				  double *xV);
+extern void			AlgMatrixCSRLTSolve(
+				  AlgMatrixCSR *lM,
+				  double *xV);
+extern AlgError			AlgMatrixCSRWriteAscii(
+				  AlgMatrixCSR *mat,
+				  FILE *fP);
 
 /* From AlgMatrixGauss.c */
 extern AlgError			AlgMatrixGaussSolve(
@@ -525,6 +581,23 @@ extern AlgError        		AlgMatrixSolveLSQR(
 				  double *dstResNorm,
 				  double *dstResNormA,
 				  double *dstNormX);
+extern AlgError        		AlgMatrixSolveLSQRPrecond(
+				  AlgMatrix aM,
+				  double *bV,
+				  double *xV,
+				  AlgMatrixPrecondType pcType,
+				  double damping,
+				  double relErrA,
+				  double relErrB,
+				  long maxItr,
+				  long condLim,
+				  int *dstTerm,
+				  long *dstItr,
+				  double *dstFNorm,
+				  double *dstCondN,
+				  double *dstResNorm,
+				  double *dstResNormA,
+				  double *dstNormX);
 
 /* From AlgMatrixLU.c */
 extern AlgError        		AlgMatrixLUSolveRaw3(
@@ -677,6 +750,19 @@ extern AlgError			AlgMatrixCGSolve(
                                   double *dstTol,
 				  int *dstItr);
 
+/* From AlgMatrixPrecond.c */
+extern AlgMatrixPrecond		*AlgMatrixPrecondNew(
+				  AlgMatrix aM,
+				  AlgMatrixPrecondType type,
+				  AlgError *dstErr);
+extern void			AlgMatrixPrecondFree(
+				  AlgMatrixPrecond *pc);
+extern void			AlgMatrixPrecondApply(
+				  void *pDat,
+				  AlgMatrix aM,
+				  double *rV,
+				  double *zV);
+
 /* From AlgMatrixRSEigen.c */
 extern AlgError        		AlgMatrixRSEigen(
 				  AlgMatrix aM,
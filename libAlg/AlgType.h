@@ -113,8 +113,10 @@ typedef enum _AlgMatrixType
 				     matrices should be allocated using the
 				     libAlc symmetric array allocation
 				     functions. */
-  ALG_MATRIX_LLR		/*!< Sparse matrix stored in linked list
+  ALG_MATRIX_LLR,		/*!< Sparse matrix stored in linked list
                                      row format. */
+  ALG_MATRIX_CSR		/*!< Sparse matrix stored in compressed
+  				     sparse row format. */
 } AlgMatrixType;
 
 /*!
@@ -128,6 +130,7 @@ typedef union _AlgMatrix
   struct _AlgMatrixRect	*rect;
   struct _AlgMatrixSym	*sym;
   struct _AlgMatrixLLR	*llr;
+  struct _AlgMatrixCSR	*csr;
 } AlgMatrix;
 
 /*!
@@ -210,6 +213,37 @@ typedef struct _AlgMatrixLLR
   				     for each row of the matrix. */
 } AlgMatrixLLR;
 
+/*!
+* \struct	_AlgMatrixCSR
+* \brief	Compressed sparse row matrix, in which the column indices
+* 		and values of the non-zero entries are stored in two
+* 		contiguous arrays, with the entries of each row stored
+* 		together in increasing column order. The entries of
+* 		row \f$i\f$ are at indices \f$[rowIdx[i], rowIdx[i + 1])\f$.
+* 		Unlike the linked list row matrix the structure of the
+* 		matrix can not be changed once it has been built, but
+* 		matrix vector products are cache friendly and are
+* 		easily computed in parallel.
+* 		Typedef: ::AlgMatrixCSR.
+*/
+typedef struct _AlgMatrixCSR
+{
+  AlgMatrixType type;		/*!< From AlgmatrixCore. */
+  size_t	nR;		/*!< From AlgmatrixCore. */
+  size_t	nC;		/*!< From AlgmatrixCore. */
+  size_t	numEnt;		/*!< Number of (non-zero) entries. */
+  size_t	maxEnt;		/*!< Maximum number of entries. */
+  size_t	*rowIdx;	/*!< Index of the first entry of each row,
+  				     with nR + 1 indices. */
+  size_t	*colIdx;	/*!< Column of each entry. */
+  double	*val;		/*!< Value of each entry. */
+} AlgMatrixCSR;
+
+/*!
+* \struct	_AlgMatrixTriple
+* \brief	A single matrix entry given by its row, column and value.
+* 		Typedef: ::AlgMatrixTriple.
+*/
 typedef struct _AlgMatrixTriple
 {
   size_t	row;		/*!< Row in matrix. */
@@ -217,6 +251,39 @@ typedef struct _AlgMatrixTriple
   double	val;		/*!< Value in the row, column. */
 } AlgMatrixTriple;
 
+/*!
+* \enum		_AlgMatrixPrecondType
+* \brief	Preconditioners for the iterative matrix solvers.
+* 		Typedef: ::AlgMatrixPrecondType.
+*/
+typedef enum _AlgMatrixPrecondType
+{
+  ALG_MATRIX_PRECOND_NONE = 0,	/*!< No preconditioning. */
+  ALG_MATRIX_PRECOND_JACOBI,	/*!< Jacobi (diagonal) preconditioning. */
+  ALG_MATRIX_PRECOND_ICHOL	/*!< Incomplete Cholesky factorisation with
+  				     no fill in, IC(0). */
+} AlgMatrixPrecondType;
+
+/*!
+* \struct	_AlgMatrixPrecond
+* \brief	Preconditioner for a square matrix \f$\mathbf{A}\f$.
+* 		For Jacobi preconditioning the inverse of the diagonal
+* 		is kept, while for incomplete Cholesky preconditioning
+* 		the lower triangular factor \f$\mathbf{L}\f$, with
+* 		\f$\mathbf{A} \approx \mathbf{L} \mathbf{L}^T\f$, is kept
+* 		with the diagonal as the last entry of each row.
+* 		Typedef: ::AlgMatrixPrecond.
+*/
+typedef struct _AlgMatrixPrecond
+{
+  AlgMatrixPrecondType type;	/*!< Type of preconditioner. */
+  size_t	n;		/*!< Number of rows and columns. */
+  double	*dInv;		/*!< Inverse of the diagonal for Jacobi
+  				     preconditioning. */
+  AlgMatrixCSR	*l;		/*!< Lower triangular factor for incomplete
+  				     Cholesky preconditioning. */
+} AlgMatrixPrecond;
+
 /*!
 * \enum		_AlgPadType
 * \brief	Types of daat padding.
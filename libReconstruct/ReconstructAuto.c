@@ -43,10 +43,48 @@ static char _ReconstructAuto_c[] = "University of Edinburgh $Id$";
 #include <Reconstruct.h>
 #include <string.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*!
+* \struct	_RecAutoWorkWrap
+* \ingroup	Reconstruct
+* \brief	Wraps the application supplied work function so that it
+*		may be safely called from concurrent pair registrations.
+*		Typedef: ::RecAutoWorkWrap.
+*/
+typedef struct _RecAutoWorkWrap
+{
+  RecWorkFunction workFn;	/*!< Application supplied work function. */
+  void		*workData;	/*!< Application supplied work data. */
+} RecAutoWorkWrap;
+
+/*!
+* \struct	_RecAutoPair
+* \ingroup	Reconstruct
+* \brief	A single pair registration job, the section being the
+*		second of the pair.
+*		Typedef: ::RecAutoPair.
+*/
+typedef struct _RecAutoPair
+{
+  RecSection	*sec;		/*!< Duplicate of the list section. */
+  int		done;		/*!< Non-zero once registered. */
+  RecError	errFlag;	/*!< Error code for this pair. */
+  char		*eMsg;		/*!< Error message for this pair. */
+} RecAutoPair;
+
+static void			RecAutoWorkFnWrap(
+				  RecState *state,
+				  void *data);
+
 /*!
 * \return	Non zero if registration fails.
 * \ingroup	Reconstruct
 * \brief	Performs the automatic registration of serial sections.
+*		This is equivalent to RecAutoPar() with the number
+*		of concurrent pair registrations set to one.
 * \param	rCtrl			The registration control data
 * 					structure.
 * \param	ppCtrl			Pre-processing control data
@@ -70,28 +108,110 @@ RecError	RecAuto(RecControl *rCtrl, RecPPControl *ppCtrl,
 			RecWorkFunction workFn, void *workData,
 			char **eMsg)
 {
+  RecError	errFlag;
+
+  errFlag = RecAutoPar(rCtrl, ppCtrl, secList, cancelFlag,
+  		       secFn, secData, workFn, workData, 1, eMsg);
+  return(errFlag);
+}
+
+/*!
+* \return	Non zero if registration fails.
+* \ingroup	Reconstruct
+* \brief	Performs the automatic registration of serial sections
+*		with up to the given number of section pairs being
+*		registered concurrently.
+*
+*		The sections are processed in blocks of at most maxPar
+*		pairs. The section images of a block are read in parallel,
+*		the pairs are then registered in parallel and finally the
+*		section update function is called for each section of the
+*		block in list order. At most maxPar + 1 section images
+*		are held in memory at any time. Because each pair's
+*		relative transform depends only on the two section images
+*		of the pair, the results are independent of the number
+*		of concurrent registrations. Cumulative transforms are
+*		not computed here, they should be set in list order using
+*		RecSecCumTransfSet() once registration is complete.
+*
+*		The section update function is always called from the
+*		calling thread. When more than one pair is registered
+*		concurrently the work function may be called from any
+*		of the worker threads, but calls are serialised.
+* \param	rCtrl			The registration control data
+* 					structure.
+* \param	ppCtrl			Pre-processing control data
+*					structure.
+* \param	secList			Section list.
+* \param	cancelFlag		Cancel if flag pointed to is non-zero.
+* \param	secFn			application supplied section update
+*					function. This function is responsible
+*					for replacing the section in the list,
+*					it may also display it, etc, ....
+* \param	secData			Application supplied data for section
+* 					update function.
+* \param	workFn			Application supplied work function.
+* \param	workData		Application supplied data for the
+*					work function.
+* \param	maxPar			Maximum number of section pairs to
+*					register concurrently, if less than
+*					one the number of available threads
+*					is used.
+* \param	eMsg			Pointer for error message strings.
+*/
+RecError	RecAutoPar(RecControl *rCtrl, RecPPControl *ppCtrl,
+			   HGUDlpList *secList, int *cancelFlag,
+			   RecSecUpdateFunction secFn, void *secData,
+			   RecWorkFunction workFn, void *workData,
+			   int maxPar, char **eMsg)
+{
+  int		idP,
+		nPar,
+		nReg,
+  		nPair = 0,
+		first = 1,
+		more = 1;
   RecState	rState;
   RecSection	*oSec0 = NULL,
 		*oSec1 = NULL,
-		*nSec0 = NULL,
-		*nSec1 = NULL;
+		*nSec0 = NULL;
+  RecAutoPair	*pairs = NULL;
   HGUDlpListItem *item = NULL;
+  RecAutoWorkWrap workWrap;
+  RecError	lstErr = REC_ERR_NONE;
   static char	errMsgInvalidListStr[] =
 	     		"Section list or the registration limits are invalid.",
 	     	errMsgMallocStr[] = "Not enough memory available.";
   RecError	errFlag = REC_ERR_NONE;
 
   REC_DBG((REC_DBG_AUTO|REC_DBG_LVL_FN|REC_DBG_LVL_1),
-	  ("RecAuto FE 0x%lx 0x%lx 0x%lx 0x%lx 0x%lx 0x%lx 0x%lx 0x%lx 0x%lx\n",
+	  ("RecAutoPar FE 0x%lx 0x%lx 0x%lx 0x%lx 0x%lx 0x%lx 0x%lx 0x%lx "
+	   "%d 0x%lx\n",
 	   (unsigned long )rCtrl, (unsigned long )ppCtrl,
 	   (unsigned long )secList, (unsigned long )cancelFlag,
 	   (unsigned long )secFn, (unsigned long )secData,
 	   (unsigned long )workFn, (unsigned long )workData,
-	   (unsigned long )eMsg));
+	   maxPar, (unsigned long )eMsg));
+  nPar = maxPar;
+  if(nPar < 1)
+  {
+#ifdef _OPENMP
+    nPar = omp_get_max_threads();
+#else
+    nPar = 1;
+#endif
+  }
+  workWrap.workFn = workFn;
+  workWrap.workData = workData;
   if((rCtrl == NULL) || (ppCtrl == NULL) || (secList == NULL))
   {
     errFlag = REC_ERR_FUNC;
   }
+  else if((pairs = (RecAutoPair *)
+  		   AlcCalloc(nPar, sizeof(RecAutoPair))) == NULL)
+  {
+    errFlag = REC_ERR_MALLOC;
+  }
   if(errFlag == REC_ERR_NONE)
   {
     if(((item = RecSecFindItemIndex(secList, NULL, rCtrl->firstIdx,
@@ -112,25 +232,16 @@ RecError	RecAuto(RecControl *rCtrl, RecPPControl *ppCtrl,
     }
   }
   if(errFlag == REC_ERR_NONE)
-  {
-    if((oSec1 = RecSecNext(secList, item, &item, 1)) == NULL)
-    {
-      errFlag = REC_ERR_LIST;
-    }
-  }
-  if(errFlag == REC_ERR_NONE)
   {
     if((oSec0->index != rCtrl->firstIdx) ||
-       (oSec1->index < rCtrl->firstIdx) ||
-       (oSec1->index > rCtrl->lastIdx))
+       (oSec0->index >= rCtrl->lastIdx))
     {
       errFlag = REC_ERR_LIST;
     }
   }
   if(errFlag == REC_ERR_NONE)
   {
-    if(((nSec0 = RecSecDup(oSec0)) == NULL) ||
-       ((nSec1 = RecSecDup(oSec1)) == NULL))
+    if((nSec0 = RecSecDup(oSec0)) == NULL)
     {
       errFlag = REC_ERR_MALLOC;
     }
@@ -139,40 +250,132 @@ RecError	RecAuto(RecControl *rCtrl, RecPPControl *ppCtrl,
   {
     errFlag = RecFileSecObjRead(nSec0, eMsg);
   }
-  while((errFlag == REC_ERR_NONE) && (*cancelFlag == 0) && (nSec1 != NULL))
+  while((errFlag == REC_ERR_NONE) && (*cancelFlag == 0) && more)
   {
-    if(secFn && nSec0)
+    /* Collect the next block of sections, each being the second section
+     * of a pair. A list error is only reported once the pairs collected
+     * before it have been registered. */
+    nPair = 0;
+    while((lstErr == REC_ERR_NONE) && more && (nPair < nPar))
     {
-      (*secFn)(nSec0, secData);	/* Replaces oSec0 with copy of nSec0 in list */
+      RecSection *prev;
+
+      prev = (nPair > 0)? pairs[nPair - 1].sec: nSec0;
+      if(prev->index >= rCtrl->lastIdx)
+      {
+        more = 0;
+      }
+      else if((oSec1 = RecSecNext(secList, item, &item, 1)) == NULL)
+      {
+        lstErr = REC_ERR_LIST;
+      }
+      else if((oSec1->index < rCtrl->firstIdx) ||
+              (oSec1->index > rCtrl->lastIdx))
+      {
+	if(first)
+	{
+	  lstErr = REC_ERR_LIST;
+	}
+        more = 0;
+      }
+      else if((pairs[nPair].sec = RecSecDup(oSec1)) == NULL)
+      {
+        lstErr = REC_ERR_MALLOC;
+      }
+      else
+      {
+        pairs[nPair].done = 0;
+        pairs[nPair].errFlag = REC_ERR_NONE;
+        pairs[nPair].eMsg = NULL;
+        ++nPair;
+      }
+      first = 0;
     }
-    errFlag = RecFileSecObjRead(nSec1, eMsg);
-    if(errFlag == REC_ERR_NONE)
+    if(lstErr != REC_ERR_NONE)
     {
-      errFlag = RecRegisterPair(&(nSec1->transform),
-				&(nSec1->correl), &(nSec1->iterations),
-      				rCtrl, ppCtrl,
-				nSec0->obj, nSec1->obj,
-      				workFn, workData, eMsg);
+      more = 0;
     }
-    if(errFlag == REC_ERR_NONE)
+    /* Read ahead the section images of the block. */
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nPar) schedule(dynamic, 1) \
+		         if(nPair > 1)
+#endif
+    for(idP = 0; idP < nPair; ++idP)
+    {
+      pairs[idP].errFlag = RecFileSecObjRead(pairs[idP].sec,
+					     &(pairs[idP].eMsg));
+    }
+    /* Only register pairs before the first section that could not be
+     * read. */
+    nReg = 0;
+    while((nReg < nPair) && (pairs[nReg].errFlag == REC_ERR_NONE))
+    {
+      ++nReg;
+    }
+    /* Register the pairs of the block. */
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nPar) schedule(dynamic, 1) \
+		         if(nReg > 1)
+#endif
+    for(idP = 0; idP < nReg; ++idP)
     {
-      RecSecFree(nSec0);
-      nSec0 = nSec1;
-      nSec1 = NULL;
-      if(nSec0->index < rCtrl->lastIdx)
+      RecAutoPair *pair;
+      RecSection *sec0;
+
+      pair = pairs + idP;
+      sec0 = (idP > 0)? pairs[idP - 1].sec: nSec0;
+      if(*cancelFlag == 0)
       {
-        if((oSec1 = RecSecNext(secList, item, &item, 1)) == NULL)
+	pair->errFlag = RecRegisterPair(&(pair->sec->transform),
+					&(pair->sec->correl),
+					&(pair->sec->iterations),
+					rCtrl, ppCtrl,
+					sec0->obj, pair->sec->obj,
+					(workFn)? RecAutoWorkFnWrap: NULL,
+					&workWrap, &(pair->eMsg));
+	pair->done = 1;
+      }
+    }
+    /* Update the sections in list order, stopping at the first pair that
+     * failed or was cancelled. */
+    for(idP = 0; idP < nPair; ++idP)
+    {
+      if((errFlag == REC_ERR_NONE) && pairs[idP].done &&
+         (pairs[idP].errFlag == REC_ERR_NONE))
+      {
+	if(secFn)
 	{
-	  errFlag = REC_ERR_LIST;
+	  (*secFn)(nSec0, secData);  /* Replaces oSec0 with copy of nSec0 */
 	}
-	else if(oSec1->index <= rCtrl->lastIdx)
+	RecSecFree(nSec0);
+	nSec0 = pairs[idP].sec;
+	pairs[idP].sec = NULL;
+      }
+      else
+      {
+	if((errFlag == REC_ERR_NONE) && (pairs[idP].errFlag != REC_ERR_NONE))
 	{
-	  if((nSec1 = RecSecDup(oSec1)) == NULL)
+	  if(secFn)
+	  {
+	    (*secFn)(nSec0, secData);
+	  }
+	  errFlag = pairs[idP].errFlag;
+	  if(*eMsg == NULL)
 	  {
-	    errFlag = REC_ERR_MALLOC;
+	    *eMsg = pairs[idP].eMsg;
+	    pairs[idP].eMsg = NULL;
 	  }
 	}
+	more = 0;
+	RecSecFree(pairs[idP].sec);
+	pairs[idP].sec = NULL;
       }
+      AlcFree(pairs[idP].eMsg);
+      pairs[idP].eMsg = NULL;
+    }
+    if(errFlag == REC_ERR_NONE)
+    {
+      errFlag = lstErr;
     }
   }
   if((errFlag == REC_ERR_NONE) && secFn && nSec0)
@@ -183,9 +386,17 @@ RecError	RecAuto(RecControl *rCtrl, RecPPControl *ppCtrl,
   {
     RecSecFree(nSec0);
   }
-  if(nSec1)
+  if(pairs)
   {
-    RecSecFree(nSec1);
+    for(idP = 0; idP < nPair; ++idP)
+    {
+      if(pairs[idP].sec)
+      {
+        RecSecFree(pairs[idP].sec);
+      }
+      AlcFree(pairs[idP].eMsg);
+    }
+    AlcFree(pairs);
   }
   if(*cancelFlag && (errFlag == REC_ERR_NONE))
   {
@@ -216,7 +427,28 @@ RecError	RecAuto(RecControl *rCtrl, RecPPControl *ppCtrl,
     (*workFn)(&rState, workData);
   }
   REC_DBG((REC_DBG_AUTO|REC_DBG_LVL_FN|REC_DBG_LVL_1),
-	  ("RecAuto FX %d\n",
+	  ("RecAutoPar FX %d\n",
 	   errFlag));
   return(errFlag);
 }
+
+/*!
+* \ingroup	Reconstruct
+* \brief	Calls the application supplied work function, serialising
+*		calls from concurrent pair registrations.
+* \param	state			Registration state.
+* \param	data			Used to pass the wrapped work function
+*					and its data.
+*/
+static void	RecAutoWorkFnWrap(RecState *state, void *data)
+{
+  RecAutoWorkWrap *wrap;
+
+  wrap = (RecAutoWorkWrap *)data;
+#ifdef _OPENMP
+#pragma omp critical (RecAutoWorkFn)
+#endif
+  {
+    (*(wrap->workFn))(state, wrap->workData);
+  }
+}
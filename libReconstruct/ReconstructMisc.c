@@ -332,6 +332,7 @@ const char	*RecMethodToStr(RecMethod method)
 		*mthdTrans =	"Translation match",
 		*mthdRotate =	"Rotation match",
 		*mthdIdentity =	"Identity",
+		*mthdPyramid =	"Coarse to fine resolution pyramid",
 		*mthdStrDef =	"Unknown method";
 
   REC_DBG((REC_DBG_MISC|REC_DBG_LVL_FN|REC_DBG_LVL_1),
@@ -355,6 +356,9 @@ const char	*RecMethodToStr(RecMethod method)
     case REC_MTHD_IDENTITY:
       mthdStr = mthdIdentity;
       break;
+    case REC_MTHD_PYRAMID:
+      mthdStr = mthdPyramid;
+      break;
   }
   REC_DBG((REC_DBG_MISC|REC_DBG_LVL_FN|REC_DBG_LVL_2),
 	  ("RecMethodToStr FX %s\n", mthdStr));
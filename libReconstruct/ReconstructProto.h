@@ -59,6 +59,17 @@ extern RecError			RecAuto(
 				  RecWorkFunction workFn,
 				  void *workData,
 				  char **eMsg);
+extern RecError			RecAutoPar(
+				  RecControl *rCtrl,
+				  RecPPControl *ppCtrl,
+				  HGUDlpList *secList,
+				  int *cancelFlag,
+				  RecSecUpdateFunction secFn,
+				  void *secData,
+				  RecWorkFunction workFn,
+				  void *workData,
+				  int maxPar,
+				  char **eMsg);
 
 /* From ReconstructConstruct3D.c */
 extern RecError			RecConstruct3DObj(
@@ -215,6 +226,17 @@ extern RecError 		RecRotMatch(
 				  double distInc,
 				  int maxRadiusFlag,
 				  RecPPControl *ppCtrl);
+extern RecError 		RecRotMatchLim(
+				  double *angle,
+				  double *value,
+				  WlzObject *obj0,
+				  WlzObject *obj1,
+				  WlzIVertex2 cRot,
+				  double angleInc,
+				  double distInc,
+				  int maxRadiusFlag,
+				  double maxAngle,
+				  RecPPControl *ppCtrl);
 
 /* From ReconstructSection.c */
 extern int			RecSecIsEmpty(
@@ -44,6 +44,33 @@ static char _ReconstructRegister_c[] = "University of Edinburgh $Id$";
 #include <string.h>
 #include <float.h>
 
+static RecError			RecRegSingle(
+				  WlzAffineTransform **dstTrans,
+				  double *dstCrossC,
+				  int *dstIter,
+				  RecControl *rCtrl,
+				  RecPPControl *ppCtrl,
+				  double rotLim,
+				  WlzObject *obj0,
+				  WlzObject *obj1,
+				  RecWorkFunction workFn,
+				  void *workData,
+				  char **eMsg);
+static RecError			RecRegPyramid(
+				  WlzAffineTransform **dstTrans,
+				  double *dstCrossC,
+				  int *dstIter,
+				  RecControl *rCtrl,
+				  RecPPControl *ppCtrl,
+				  WlzObject *obj0,
+				  WlzObject *obj1,
+				  RecWorkFunction workFn,
+				  void *workData,
+				  char **eMsg);
+static WlzAffineTransform	*RecRegScaleTransform(
+				  WlzAffineTransform *tr,
+				  double scale,
+				  WlzErrorNum *dstErr);
 static RecError			RecRegPrincipal(
 				  WlzAffineTransform **transf,
 				  WlzObject **transfObj,
@@ -69,6 +96,10 @@ static RecError			RecRegTranslate(
 * \brief	Calculates the affine transform which when applied
 *               to the second object brings it into register with the
 *               first object.
+*		If the registration method includes REC_MTHD_PYRAMID then
+*		the registration is done coarse to fine using a resolution
+*		pyramid (see RecRegPyramid()), otherwise the objects are
+*		registered at a single resolution.
 * \param	dstTrans		Destination pointer for transform.
 * \param	dstCrossC		Destination pointer for the
 *					cross-correlation value.
@@ -92,6 +123,314 @@ RecError	RecRegisterPair(WlzAffineTransform **dstTrans,
 			        WlzObject *obj0, WlzObject *obj1,
 				RecWorkFunction workFn, void *workData,
 				char **eMsg)
+{
+  RecError	errFlag = REC_ERR_NONE;
+
+  if((rCtrl != NULL) && (rCtrl->method & REC_MTHD_PYRAMID))
+  {
+    errFlag = RecRegPyramid(dstTrans, dstCrossC, dstIter, rCtrl, ppCtrl,
+    			    obj0, obj1, workFn, workData, eMsg);
+  }
+  else
+  {
+    errFlag = RecRegSingle(dstTrans, dstCrossC, dstIter, rCtrl, ppCtrl,
+    			   WLZ_M_PI, obj0, obj1, workFn, workData, eMsg);
+  }
+  return(errFlag);
+}
+
+/*!
+* \return	Error code.
+* \ingroup	Reconstruct
+* \brief	Calculates the affine transform which when applied
+*               to the second object brings it into register with the
+*               first object, using a coarse to fine search.
+*		Both objects are repeatedly subsampled by a factor of two
+*		(with Gaussian smoothing) to build a resolution pyramid
+*		with at most REC_PYR_LVL_MAX levels, the coarsest level
+*		being at least REC_PYR_MIN_SZ in its smallest dimension.
+*		At the coarsest level the full translation limits are
+*		searched, but because the images are small this is cheap.
+*		At each finer level the transform from the level above
+*		is used to initialise a search in which the translation
+*		limits are reduced to REC_PYR_REFINE (but not below
+*		REC_MIN_XLIM and REC_MIN_YLIM) and the rotation is
+*		restricted to within REC_PYR_RREFINE degrees of the
+*		estimate from the level above, so that the expensive
+*		full resolution cross correlations are few and use small
+*		arrays. The pre-processing window is scaled with the
+*		level.
+* \param	dstTrans		Destination pointer for transform.
+* \param	dstCrossC		Destination pointer for the
+*					cross-correlation value.
+* \param	dstIter			Destination pointer for the total
+*                                       number of iterations.
+* \param	rCtrl			The registration control data
+*                                       structure.
+* \param	ppCtrl			Pre-processing control data
+*                                       structure.
+* \param	obj0			First object.
+* \param	obj1			Second object.
+* \param	workFn			Application supplied work
+*                                       function.
+* \param	workData		Application supplied data for
+*                                       the work function.
+* \param	eMsg			Destination pointer for messages.
+*/
+static RecError	RecRegPyramid(WlzAffineTransform **dstTrans,
+			      double *dstCrossC, int *dstIter,
+			      RecControl *rCtrl, RecPPControl *ppCtrl,
+			      WlzObject *obj0, WlzObject *obj1,
+			      RecWorkFunction workFn, void *workData,
+			      char **eMsg)
+{
+  int		idL,
+  		iter,
+		fac,
+		minSz,
+  		nLvl = 1,
+		totIter = 0;
+  double	correl = 0.0,
+  		rotLim;
+  WlzIBox2	box0,
+  		box1;
+  WlzIVertex3	samFac;
+  WlzObject	*lObj0[REC_PYR_LVL_MAX],
+  		*lObj1[REC_PYR_LVL_MAX];
+  WlzAffineTransform *tr = NULL,
+  		*lTr = NULL;
+  RecControl	lCtrl;
+  RecPPControl	lPP;
+  WlzErrorNum	wlzErr = WLZ_ERR_NONE;
+  RecError	errFlag = REC_ERR_NONE;
+
+  REC_DBG((REC_DBG_REG|REC_DBG_LVL_FN|REC_DBG_LVL_1),
+	  ("RecRegPyramid FE 0x%lx 0x%lx 0x%lx 0x%lx 0x%lx 0x%lx 0x%lx\n",
+	   (unsigned long )dstTrans,
+	   (unsigned long )dstCrossC, (unsigned long )dstIter,
+	   (unsigned long )rCtrl, (unsigned long )ppCtrl,
+	   (unsigned long )obj0, (unsigned long )obj1));
+  for(idL = 0; idL < REC_PYR_LVL_MAX; ++idL)
+  {
+    lObj0[idL] = lObj1[idL] = NULL;
+  }
+  if((rCtrl == NULL) || (ppCtrl == NULL) || (obj0 == NULL) || (obj1 == NULL))
+  {
+    errFlag = REC_ERR_FUNC;
+  }
+  else if((obj0->type != WLZ_2D_DOMAINOBJ) ||
+          (obj1->type != WLZ_2D_DOMAINOBJ) ||
+          (obj0->domain.core == NULL) || (obj1->domain.core == NULL))
+  {
+    errFlag = REC_ERR_WLZ;
+  }
+  /* Compute the number of levels. */
+  if(errFlag == REC_ERR_NONE)
+  {
+    box0 = WlzBoundingBox2I(obj0, &wlzErr);
+    if(wlzErr == WLZ_ERR_NONE)
+    {
+      box1 = WlzBoundingBox2I(obj1, &wlzErr);
+    }
+    if(wlzErr == WLZ_ERR_NONE)
+    {
+      minSz = WLZ_MIN(WLZ_MIN(box0.xMax - box0.xMin, box0.yMax - box0.yMin),
+		      WLZ_MIN(box1.xMax - box1.xMin, box1.yMax - box1.yMin)) + 1;
+      while((nLvl < REC_PYR_LVL_MAX) &&
+	    ((minSz >> nLvl) >= REC_PYR_MIN_SZ))
+      {
+	++nLvl;
+      }
+    }
+    errFlag = RecErrorFromWlz(wlzErr);
+  }
+  /* Build the resolution pyramid. */
+  if(errFlag == REC_ERR_NONE)
+  {
+    samFac.vtX = samFac.vtY = 2;
+    samFac.vtZ = 1;
+    lObj0[0] = WlzAssignObject(obj0, NULL);
+    lObj1[0] = WlzAssignObject(obj1, NULL);
+    idL = 1;
+    while((wlzErr == WLZ_ERR_NONE) && (idL < nLvl))
+    {
+      lObj0[idL] = WlzAssignObject(
+                   WlzSampleObj(lObj0[idL - 1], samFac, WLZ_SAMPLEFN_GAUSS,
+		   		&wlzErr), NULL);
+      if(wlzErr == WLZ_ERR_NONE)
+      {
+	lObj1[idL] = WlzAssignObject(
+		     WlzSampleObj(lObj1[idL - 1], samFac, WLZ_SAMPLEFN_GAUSS,
+				  &wlzErr), NULL);
+      }
+      ++idL;
+    }
+    errFlag = RecErrorFromWlz(wlzErr);
+  }
+  /* Only an initial transform that would be used at a single resolution
+   * is used to initialise the coarsest level. */
+  if((errFlag == REC_ERR_NONE) && dstTrans && *dstTrans &&
+     ((rCtrl->method & (REC_MTHD_PRINC | REC_MTHD_IDENTITY)) == 0))
+  {
+    tr = WlzAssignAffineTransform(*dstTrans, NULL);
+  }
+  /* Register from the coarsest to the finest level. */
+  idL = nLvl - 1;
+  while((errFlag == REC_ERR_NONE) && (idL >= 0))
+  {
+    fac = 1 << idL;
+    lCtrl = *rCtrl;
+    lPP = *ppCtrl;
+    lCtrl.method = (RecMethod )((unsigned int )lCtrl.method &
+    				~(unsigned int )REC_MTHD_PYRAMID);
+    if(idL == nLvl - 1)
+    {
+      lCtrl.xLim = WLZ_MAX(REC_MIN_XLIM, ceil(rCtrl->xLim / fac));
+      lCtrl.yLim = WLZ_MAX(REC_MIN_YLIM, ceil(rCtrl->yLim / fac));
+      rotLim = WLZ_M_PI;
+    }
+    else
+    {
+      lCtrl.method = (RecMethod )((unsigned int )lCtrl.method &
+				  ~(unsigned int )(REC_MTHD_PRINC |
+				                   REC_MTHD_IDENTITY));
+      lCtrl.xLim = WLZ_MAX(REC_MIN_XLIM, WLZ_MIN(rCtrl->xLim, REC_PYR_REFINE));
+      lCtrl.yLim = WLZ_MAX(REC_MIN_YLIM, WLZ_MIN(rCtrl->yLim, REC_PYR_REFINE));
+      rotLim = REC_PYR_RREFINE * WLZ_M_PI / 180.0;
+    }
+    lPP.window.size.vtX = WLZ_MIN(ppCtrl->window.size.vtX,
+    				  WLZ_MAX(REC_MIN_WINSZ,
+				  (ppCtrl->window.size.vtX + (fac / 2)) / fac));
+    lPP.window.size.vtY = WLZ_MIN(ppCtrl->window.size.vtY,
+    				  WLZ_MAX(REC_MIN_WINSZ,
+				  (ppCtrl->window.size.vtY + (fac / 2)) / fac));
+    lPP.window.offset.vtX /= fac;
+    lPP.window.offset.vtY /= fac;
+    lPP.erode = (lPP.erode + (fac / 2)) / fac;
+    if(tr)
+    {
+      lTr = WlzAssignAffineTransform(
+            RecRegScaleTransform(tr, 1.0 / fac, &wlzErr), NULL);
+      errFlag = RecErrorFromWlz(wlzErr);
+    }
+    if(errFlag == REC_ERR_NONE)
+    {
+      iter = 0;
+      errFlag = RecRegSingle(&lTr, &correl, &iter, &lCtrl, &lPP, rotLim,
+      			     lObj0[idL], lObj1[idL], workFn, workData, eMsg);
+      totIter += iter;
+      REC_DBG((REC_DBG_REG|REC_DBG_LVL_1),
+	      ("RecRegPyramid 01 %d %d %f %d\n",
+	       idL, iter, correl, errFlag));
+    }
+    if(errFlag == REC_ERR_NONE)
+    {
+      (void )WlzFreeAffineTransform(tr);
+      tr = WlzAssignAffineTransform(
+           RecRegScaleTransform(lTr, fac, &wlzErr), NULL);
+      errFlag = RecErrorFromWlz(wlzErr);
+    }
+    (void )WlzFreeAffineTransform(lTr);
+    lTr = NULL;
+    --idL;
+  }
+  if(errFlag == REC_ERR_NONE)
+  {
+    if(dstTrans)
+    {
+      (void )WlzFreeAffineTransform(*dstTrans);
+      *dstTrans = tr;                               /* Use existing linkcount */
+      tr = NULL;
+    }
+    if(dstCrossC)
+    {
+      *dstCrossC = correl;
+    }
+    if(dstIter)
+    {
+      *dstIter = totIter;
+    }
+  }
+  (void )WlzFreeAffineTransform(tr);
+  for(idL = 0; idL < nLvl; ++idL)
+  {
+    (void )WlzFreeObj(lObj0[idL]);
+    (void )WlzFreeObj(lObj1[idL]);
+  }
+  REC_DBG((REC_DBG_REG|REC_DBG_LVL_FN|REC_DBG_LVL_1),
+	  ("RecRegPyramid FX %d\n",
+	   errFlag));
+  return(errFlag);
+}
+
+/*!
+* \return	New transform.
+* \ingroup	Reconstruct
+* \brief	Creates a new rigid body transform from the given one
+*		for use with objects which have been scaled by the given
+*		factor, ie the translation is scaled but the rotation
+*		is preserved.
+* \param	tr			Given transform.
+* \param	scale			Scale factor.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+static WlzAffineTransform *RecRegScaleTransform(WlzAffineTransform *tr,
+					double scale, WlzErrorNum *dstErr)
+{
+  WlzAffineTransform *nTr = NULL;
+  WlzAffineTransformPrim prim;
+  WlzErrorNum	errNum;
+
+  if((errNum = WlzAffineTransformPrimGet(tr, &prim)) == WLZ_ERR_NONE)
+  {
+    nTr = WlzAffineTransformFromPrimVal(WLZ_TRANSFORM_2D_AFFINE,
+    					prim.tx * scale, prim.ty * scale, 0.0,
+					1.0, prim.theta, 0.0,
+					0.0, 0.0, 0.0,
+					0, &errNum);
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(nTr);
+}
+
+/*!
+* \return	Error code.
+* \ingroup	Reconstruct
+* \brief	Calculates the affine transform which when applied
+*               to the second object brings it into register with the
+*               first object, at a single resolution.
+* \param	dstTrans		Destination pointer for transform.
+* \param	dstCrossC		Destination pointer for the
+*					cross-correlation value.
+* \param	dstIter			Destination pointer for the number
+*                                       of iterations.
+* \param	rCtrl			The registration control data
+*                                       structure.
+* \param	ppCtrl			Pre-processing control data
+*                                       structure.
+* \param	rotLim			Maximum absolute angle (radians) of
+*					the rotation found by each rotation
+*					match, with respect to the current
+*					estimate. Values of pi or more
+*					search all angles.
+* \param	obj0			First object.
+* \param	obj1			Second object.
+* \param	workFn			Application supplied work
+*                                       function.
+* \param	workData		Application supplied data for
+*                                       the work function.
+* \param	eMsg			Destination pointer for messages.
+*/
+static RecError	RecRegSingle(WlzAffineTransform **dstTrans,
+			     double *dstCrossC, int *dstIter,
+			     RecControl *rCtrl, RecPPControl *ppCtrl,
+			     double rotLim,
+			     WlzObject *obj0, WlzObject *obj1,
+			     RecWorkFunction workFn, void *workData,
+			     char **eMsg)
 {
   int		approach = 0,
 		approach0 = 0,
@@ -347,8 +686,8 @@ RecError	RecRegisterPair(WlzAffineTransform **dstTrans,
       {
 	tIV0.vtX = WLZ_NINT(cMass0.vtX);
 	tIV0.vtY = WLZ_NINT(cMass0.vtY);
-	errFlag = RecRotMatch(&tD0, &correl, obj0, trObj,
-			      tIV0, angleInc, distInc, 0, &newPP);
+	errFlag = RecRotMatchLim(&tD0, &correl, obj0, trObj,
+			         tIV0, angleInc, distInc, 0, rotLim, &newPP);
 	REC_DBG((REC_DBG_REG|REC_DBG_LVL_1),
 		("RecRegisterPair 04 %d %d %f %f %d\n",
 		 approach, states[approach].iteration, correl,
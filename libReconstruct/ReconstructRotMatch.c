@@ -51,13 +51,50 @@ static void			RecFindRotPeak(
 				  double *value,
 				  double **data,
 			          double angleInc,
-				  int size);
+				  int size,
+				  int maxOff);
 /*!
 * \return	Error code.
 * \ingroup	Reconstruct.
 * \brief	Performs polar resampling of the givn objects and then
 *               uses cross correlation to find the angle of rotation
 *               which gives the best match between the given objects.
+*		All angles of rotation are searched, see RecRotMatchLim().
+* \param	angle			Destination pointer for angle of
+*					rotation (in radians).
+* \param	value			Destination pointer for the
+*					cross-correlation peak value.
+* \param	obj0			First of two type 1 objects.
+* \param	obj1			Second of two type 1 objects.
+* \param	cRot			Center of rotation for objects.
+* \param	angleInc		Angle increment (radians).
+* \param	distInc			Distance increment.
+* \param	maxRadiusFlag		Use maximum radius for the
+*                                       polar resampling if non zero.
+* \param	ppCtrl			Pre-processing control.
+*/
+RecError	RecRotMatch(double *angle, double *value,
+			    WlzObject *obj0, WlzObject *obj1,
+			    WlzIVertex2 cRot,
+			    double angleInc, double distInc, int maxRadiusFlag,
+			    RecPPControl *ppCtrl)
+{
+  RecError	errFlag;
+
+  errFlag = RecRotMatchLim(angle, value, obj0, obj1, cRot,
+  			   angleInc, distInc, maxRadiusFlag, WLZ_M_PI,
+			   ppCtrl);
+  return(errFlag);
+}
+
+/*!
+* \return	Error code.
+* \ingroup	Reconstruct.
+* \brief	Performs polar resampling of the givn objects and then
+*               uses cross correlation to find the angle of rotation
+*               which gives the best match between the given objects,
+*		with the search for the angle restricted to the given
+*		maximum absolute angle.
 *               Data are accessed as
 * \verbatim
                   *(*(data + line) + column), x == column, y == line.
@@ -73,13 +110,16 @@ static void			RecFindRotPeak(
 * \param	distInc			Distance increment.
 * \param	maxRadiusFlag		Use maximum radius for the
 *                                       polar resampling if non zero.
+* \param	maxAngle		Maximum absolute angle of rotation
+*					(radians) to search for, values of
+*					pi or more search all angles.
 * \param	ppCtrl			Pre-processing control.
 */
-RecError	RecRotMatch(double *angle, double *value,
+RecError	RecRotMatchLim(double *angle, double *value,
 			    WlzObject *obj0, WlzObject *obj1,
 			    WlzIVertex2 cRot,
 			    double angleInc, double distInc, int maxRadiusFlag,
-			    RecPPControl *ppCtrl)
+			    double maxAngle, RecPPControl *ppCtrl)
 {
   int		length,
 		p2Len;
@@ -170,7 +210,11 @@ RecError	RecRotMatch(double *angle, double *value,
   (void )WlzFreeObj(pObj1);
   if(errFlag == REC_ERR_NONE)
   {
-    RecFindRotPeak(angle, value, data0, angleInc, size.vtY);
+    int		maxOff;
+
+    maxOff = (maxAngle < WLZ_M_PI)? (int )floor(maxAngle / angleInc):
+                                    size.vtY;
+    RecFindRotPeak(angle, value, data0, angleInc, size.vtY, maxOff);
     *value /= sqrt(sSq0 * sSq1);
     REC_DBG((REC_DBG_ROT|REC_DBG_LVL_1),
 	    ("RecRotMatch 04 %g %g\n",
@@ -199,6 +243,8 @@ RecError	RecRotMatch(double *angle, double *value,
 *               Data are in wrap around order.
 *               A least squares quadratic is fitted to the cross
 *               correlation maximum.
+*		Only offsets (in wrap around order) with an absolute
+*		value no greater than the given maximum are searched.
 * \param	angle			Destination pointer for the angle
 *					(degrees) for the cross-correlation
 *					maximum.
@@ -208,9 +254,10 @@ RecError	RecRotMatch(double *angle, double *value,
 * \param	angleInc		Angle increment used to find
 *                                       angle from data index.
 * \param	size			Size of data array.
+* \param	maxOff			Maximum absolute offset searched.
 */
 static void	RecFindRotPeak(double *angle, double *value, double **data,
-			       double angleInc, int size)
+			       double angleInc, int size, int maxOff)
 {
   int		idx,
 		maxIdx;
@@ -224,7 +271,8 @@ static void	RecFindRotPeak(double *angle, double *value, double **data,
   maxVal = (**data);
   for(idx = 1; idx < size; ++idx)
   {
-    if(**(data + idx) > maxVal)
+    if(((idx <= maxOff) || ((size - idx) <= maxOff)) &&
+       (**(data + idx) > maxVal))
     {
       maxVal = **(data + idx);
       maxIdx = idx;
@@ -85,7 +85,8 @@ typedef enum
   REC_MTHD_PRINC	= (1),       /* Principle axes (with centre of mass) */
   REC_MTHD_TRANS	= (1<<1),			      /* Translation */
   REC_MTHD_ROTATE	= (1<<2),				 /* Rotation */
-  REC_MTHD_IDENTITY	= (1<<3)	/* Transform initialised to identity */
+  REC_MTHD_IDENTITY	= (1<<3),	/* Transform initialised to identity */
+  REC_MTHD_PYRAMID	= (1<<4)      /* Coarse to fine, resolution pyramid */
 } RecMethod;
 
 typedef enum
@@ -180,6 +181,11 @@ typedef enum
 #define	REC_MIN_RLIM	(1.0)
 #define REC_MAX_RLIM	(180.0)
 #define REC_MAX_RECORD	(256)
+#define REC_PYR_LVL_MAX	(6)	    /* Maximum number of pyramid levels */
+#define REC_PYR_MIN_SZ	(64)  /* Minimum image size at the coarsest level */
+#define REC_PYR_REFINE	(3)  /* Translation limit for the refinement levels */
+#define REC_PYR_RREFINE	(5.0)	/* Rotation limit (degrees) for the
+				   refinement levels */
 #define REC_MAX_LIST	(1000)
 
 #define REC_TRANS_TX_MAX (1000.0)
@@ -73,6 +73,35 @@ static void			WlzProjectObjLineVal(
 				  double vMZY,
 				  WlzIVertex3 p0,
 				  WlzIVertex3 p1);
+static WlzThreeDViewStruct	*WlzProjectViewStruct(
+				  WlzObject *obj,
+				  WlzThreeDViewStruct *vStr,
+				  int rescale,
+				  WlzErrorNum *dstErr);
+static WlzAffineTransform	*WlzProjectRescaleTr(
+				  WlzObject *obj,
+				  WlzThreeDViewStruct *vStr,
+				  WlzIBox2 prjBox,
+				  WlzErrorNum *dstErr);
+static int			WlzProjectRayClip(
+				  double *w0,
+				  double *w1,
+				  WlzDVertex3 org,
+				  WlzDVertex3 dir,
+				  WlzDBox3 box);
+static int			WlzProjectRayCast(
+				  WlzObject *obj,
+				  WlzGreyValueWSpace *gVWSp,
+				  WlzProjectRayMode mode,
+				  WlzDVertex3 org,
+				  WlzDVertex3 dir,
+				  double dirLen,
+				  double w0,
+				  double w1,
+				  double valMin,
+				  double valScale,
+				  double opacity,
+				  float *dstVal);
 
 /*! 
 * \return       projection object
@@ -501,33 +530,9 @@ struct timeval	times[3];
    * is done after the projection. */
   if(errNum == WLZ_ERR_NONE)
   {
-    if((vStr1 = WlzMake3DViewStruct(WLZ_3D_VIEW_STRUCT, &errNum)) != NULL)
+    if((vStr1 = WlzProjectViewStruct(obj, vStr, 0, &errNum)) != NULL)
     {
-      vStr1->fixed = vStr->fixed;
-      vStr1->theta = vStr->theta;
-      vStr1->phi = vStr->phi;
-      vStr1->zeta = vStr->zeta;
-      vStr1->dist = vStr->dist;
-      vStr1->scale = vStr->scale;
-      vStr1->voxelSize[0] = 1.0;
-      vStr1->voxelSize[1] = 1.0;
-      vStr1->voxelSize[2] = 1.0;
-      vStr1->voxelRescaleFlg = 0;
-      vStr1->interp = vStr->interp;
-      vStr1->view_mode = vStr->view_mode;
-      vStr1->up = vStr->up;
-      vStr1->initialised = WLZ_3DVIEWSTRUCT_INIT_NONE;
       vMat = vStr1->trans->mat;
-      errNum = WlzInit3DViewStructAffineTransform(vStr1);
-      if(errNum == WLZ_ERR_NONE)
-      {
-        errNum = Wlz3DViewStructTransformBB(obj, vStr1);
-      }
-      if(errNum != WLZ_ERR_NONE)
-      {
-	WlzFree3DViewStruct(vStr1);
-	vStr1 = NULL;
-      }
     }
   }
   /* Compute bounding box of the projection. */
@@ -543,54 +548,7 @@ struct timeval	times[3];
   /* Compute post projection scaling. */
   if((errNum == WLZ_ERR_NONE) && (vStr->voxelRescaleFlg != 0))
   {
-    WlzIBox2	sBox;
-    WlzIVertex2 sSz;
-    WlzThreeDViewStruct *vStr2;
-
-    vStr2 = WlzMake3DViewStruct(WLZ_3D_VIEW_STRUCT, &errNum);
-    if(errNum == WLZ_ERR_NONE)
-    {
-      vStr2->fixed = vStr->fixed;
-      vStr2->theta = vStr->theta;
-      vStr2->phi = vStr->phi;
-      vStr2->zeta = vStr->zeta;
-      vStr2->dist = vStr->dist;
-      vStr2->scale = vStr->scale;
-      vStr2->voxelSize[0] = vStr->voxelSize[0];
-      vStr2->voxelSize[1] = vStr->voxelSize[1];
-      vStr2->voxelSize[2] = vStr->voxelSize[2];
-      vStr2->voxelRescaleFlg = vStr->voxelRescaleFlg;
-      vStr2->interp = vStr->interp;
-      vStr2->view_mode = vStr->view_mode;
-      vStr2->up = vStr->up;
-      vStr2->initialised = WLZ_3DVIEWSTRUCT_INIT_NONE;
-      errNum = WlzInit3DViewStructAffineTransform(vStr2);
-      if(errNum == WLZ_ERR_NONE)
-      {
-        errNum = Wlz3DViewStructTransformBB(obj, vStr2);
-      }
-      if(errNum == WLZ_ERR_NONE)
-      {
-	sBox.xMin = WLZ_NINT(vStr2->minvals.vtX);
-	sBox.yMin = WLZ_NINT(vStr2->minvals.vtY);
-	sBox.xMax = WLZ_NINT(vStr2->maxvals.vtX);
-	sBox.yMax = WLZ_NINT(vStr2->maxvals.vtY);
-	sSz.vtX = sBox.xMax - sBox.xMin + 1;
-	sSz.vtY = sBox.yMax - sBox.yMin + 1;
-        rescaleTr = WlzMakeAffineTransform(WLZ_TRANSFORM_2D_AFFINE, &errNum);
-      }
-      if(errNum == WLZ_ERR_NONE)
-      {
-        double	**m;
-
-	m = rescaleTr->mat;
-	m[0][0] = (sSz.vtX * eps) / (prjSz.vtX * eps);
-	m[1][1] = (sSz.vtY * eps) / (prjSz.vtY * eps);
-	m[0][2] = sBox.xMin - WLZ_NINT(m[0][0] * prjBox.xMin);
-	m[1][2] = sBox.yMin - WLZ_NINT(m[1][1] * prjBox.yMin);
-      }
-      (void )WlzFree3DViewStruct(vStr2);
-    }
+    rescaleTr = WlzProjectRescaleTr(obj, vStr, prjBox, &errNum);
   }
   /* Compute plane equation, used to clip intervals if depth was given. */
   if((errNum == WLZ_ERR_NONE) && (depth > eps))
@@ -993,6 +951,344 @@ struct timeval	times[3];
   return(prjObj);
 }
 
+/*!
+* \return	New 2D object with the projection or NULL on error.
+* \ingroup	WlzTransform
+* \brief	Projects a 3D domain object onto the plane defined by
+* 		the given view by casting a ray through the object for
+* 		each pixel of the projection. Rays are parallel to the
+* 		normal of the viewing plane and are traversed in the
+* 		direction of increasing distance from the plane.
+*
+* 		Rather than sampling along the whole length of each
+* 		ray, each ray is split into runs of constant line and
+* 		plane and each of these is intersected with the
+* 		intervals of the plane domain, so only the voxels of
+* 		the domain which the ray passes through are visited
+* 		and empty regions are skipped. Each visited voxel is
+* 		weighted by the length of the ray within it. Rays are
+* 		cast in parallel by rows of the projection, so that
+* 		the rays of a row, which visit neighbouring voxels, are
+* 		cast by a single thread; this keeps access to tiled
+* 		values tile coherent.
+*
+* 		The projection modes are:
+* 		WLZ_PROJECT_RAY_MODE_MIP - the maximum value along
+* 		the ray,
+* 		WLZ_PROJECT_RAY_MODE_MEAN - the path length weighted
+* 		mean value along the ray,
+* 		WLZ_PROJECT_RAY_MODE_SUM - the path length weighted
+* 		sum of the values along the ray and
+* 		WLZ_PROJECT_RAY_MODE_ALPHA - front to back alpha
+* 		compositing of the values along the ray with early
+* 		ray termination. The opacity of a voxel with value
+* 		\f$v\f$ for a unit length of ray is
+* 		\f[
+		\alpha = o \frac{v - v_{min}}{v_{max} - v_{min}}
+		\f]
+*		clamped to the range [0-1]. The projected value is the
+*		sum of the voxel values each weighted by it's opacity
+*		and the transparency of all voxels in front of it.
+*		If the object has no values then all voxels of the
+*		domain have the value 1.
+*
+* 		The projection has float values and has the domain of
+* 		those pixels for which the ray passed through the
+* 		given object's domain. Voxel size rescaling is applied
+* 		to the projection as by WlzProjectObjToPlane().
+* \param	obj			The given 3D domain object.
+* \param	vStr			Given view structure defining the
+* 					projection plane.
+* \param	mode			Projection mode.
+* \param	depth			If greater than zero, the projection
+* 					depth perpendicular to the viewing
+* 					plane.
+* \param	valMin			Value with zero opacity, only used
+* 					for alpha compositing.
+* \param	valMax			Value with the given opacity, only
+* 					used for alpha compositing.
+* \param	opacity			Opacity of a unit length of ray
+* 					through voxels with the maximum
+* 					value, in the range [0-1] and only
+* 					used for alpha compositing.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzObject	*WlzProjectObjRayCast(WlzObject *obj,
+				      WlzThreeDViewStruct *vStr,
+				      WlzProjectRayMode mode,
+				      double depth,
+				      double valMin, double valMax,
+				      double opacity,
+				      WlzErrorNum *dstErr)
+{
+  int		nThr = 1;
+  WlzIVertex2	prjSz;
+  WlzIBox2	prjBox = {0};
+  WlzDBox3	objBox;
+  double	wMin = 0.0,
+  		wMax = 0.0;
+  float		**valAry = NULL;
+  WlzUByte	**hitAry = NULL;
+  WlzThreeDViewStruct *vStr1 = NULL;
+  WlzAffineTransform *invTr = NULL,
+  		*rescaleTr = NULL;
+  WlzGreyValueWSpace **gVWSp = NULL;
+  WlzObject	*prjObj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const double	eps = 0.000001;
+
+  if(obj == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if(obj->type != WLZ_3D_DOMAINOBJ)
+  {
+    errNum = WLZ_ERR_OBJECT_TYPE;
+  }
+  else if(obj->domain.core == NULL)
+  {
+    errNum = WLZ_ERR_DOMAIN_NULL;
+  }
+  else if(obj->domain.core->type != WLZ_PLANEDOMAIN_DOMAIN)
+  {
+    errNum = WLZ_ERR_DOMAIN_TYPE;
+  }
+  else if(vStr == NULL)
+  {
+    errNum = WLZ_ERR_TRANSFORM_NULL;
+  }
+  else if((mode != WLZ_PROJECT_RAY_MODE_MIP) &&
+          (mode != WLZ_PROJECT_RAY_MODE_MEAN) &&
+          (mode != WLZ_PROJECT_RAY_MODE_SUM) &&
+          (mode != WLZ_PROJECT_RAY_MODE_ALPHA))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else if((mode == WLZ_PROJECT_RAY_MODE_ALPHA) &&
+          ((valMax - valMin < eps) || (opacity < 0.0) || (opacity > 1.0)))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else if(obj->values.core != NULL)
+  {
+    switch(WlzGreyTypeFromObj(obj, &errNum))
+    {
+      case WLZ_GREY_INT:    /* FALLTHROUGH */
+      case WLZ_GREY_SHORT:  /* FALLTHROUGH */
+      case WLZ_GREY_UBYTE:  /* FALLTHROUGH */
+      case WLZ_GREY_FLOAT:  /* FALLTHROUGH */
+      case WLZ_GREY_DOUBLE:
+        break;
+      default:
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  errNum = WLZ_ERR_GREY_TYPE;
+	}
+	break;
+    }
+  }
+  /* Create new view transform without voxel scaling and it's inverse
+   * which maps projection coordinates to rays through the object. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    vStr1 = WlzProjectViewStruct(obj, vStr, 0, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    invTr = WlzAffineTransformInverse(vStr1->trans, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    prjBox.xMin = WLZ_NINT(vStr1->minvals.vtX);
+    prjBox.yMin = WLZ_NINT(vStr1->minvals.vtY);
+    prjBox.xMax = WLZ_NINT(vStr1->maxvals.vtX);
+    prjBox.yMax = WLZ_NINT(vStr1->maxvals.vtY);
+    prjSz.vtX = prjBox.xMax - prjBox.xMin + 1;
+    prjSz.vtY = prjBox.yMax - prjBox.yMin + 1;
+    wMin = vStr1->minvals.vtZ - 1.0;
+    wMax = vStr1->maxvals.vtZ + 1.0;
+    if(depth > eps)
+    {
+      wMin = ALG_MAX(wMin, vStr1->dist - depth);
+      wMax = ALG_MIN(wMax, vStr1->dist + depth);
+    }
+    objBox.xMin = obj->domain.p->kol1 - 0.5;
+    objBox.yMin = obj->domain.p->line1 - 0.5;
+    objBox.zMin = obj->domain.p->plane1 - 0.5;
+    objBox.xMax = obj->domain.p->lastkl + 0.5;
+    objBox.yMax = obj->domain.p->lastln + 0.5;
+    objBox.zMax = obj->domain.p->lastpl + 0.5;
+  }
+  /* Compute post projection scaling. */
+  if((errNum == WLZ_ERR_NONE) && (vStr->voxelRescaleFlg != 0))
+  {
+    rescaleTr = WlzProjectRescaleTr(obj, vStr, prjBox, &errNum);
+  }
+  /* Allocate the projection value and hit arrays along with a grey value
+   * workspace for each thread. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+#ifdef _OPENMP
+#pragma omp parallel
+    {
+#pragma omp master
+      {
+        nThr = omp_get_num_threads();
+      }
+    }
+#endif
+    if((AlcFloat2Calloc(&valAry, prjSz.vtY, prjSz.vtX) != ALC_ER_NONE) ||
+       (AlcUnchar2Calloc(&hitAry, prjSz.vtY, prjSz.vtX) != ALC_ER_NONE))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (obj->values.core != NULL))
+  {
+    if((gVWSp = (WlzGreyValueWSpace **)
+                AlcCalloc(nThr, sizeof(WlzGreyValueWSpace *))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      int	idT;
+
+      for(idT = 0; (errNum == WLZ_ERR_NONE) && (idT < nThr); ++idT)
+      {
+        gVWSp[idT] = WlzGreyValueMakeWSp(obj, &errNum);
+      }
+    }
+  }
+  /* Cast the rays, in parallel by rows of the projection. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idY;
+    double	**iMat;
+    WlzDVertex3	dir;
+    double	dirLen,
+    		valScale;
+
+    iMat = invTr->mat;
+    dir.vtX = iMat[0][2];
+    dir.vtY = iMat[1][2];
+    dir.vtZ = iMat[2][2];
+    dirLen = WLZ_VTX_3_LENGTH(dir);
+    valScale = (valMax - valMin > eps)? 1.0 / (valMax - valMin): 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(idY = 0; idY < prjSz.vtY; ++idY)
+    {
+      int	idX,
+      		thrId = 0;
+      double	v;
+
+#ifdef _OPENMP
+      thrId = omp_get_thread_num();
+#endif
+      v = prjBox.yMin + idY;
+      for(idX = 0; idX < prjSz.vtX; ++idX)
+      {
+	double	u,
+		w0,
+		w1;
+	WlzDVertex3 org;
+
+	u = prjBox.xMin + idX;
+	org.vtX = (iMat[0][0] * u) + (iMat[0][1] * v) + iMat[0][3];
+	org.vtY = (iMat[1][0] * u) + (iMat[1][1] * v) + iMat[1][3];
+	org.vtZ = (iMat[2][0] * u) + (iMat[2][1] * v) + iMat[2][3];
+	w0 = wMin;
+	w1 = wMax;
+	if(WlzProjectRayClip(&w0, &w1, org, dir, objBox))
+	{
+	  hitAry[idY][idX] = (WlzUByte )WlzProjectRayCast(obj,
+	  			(gVWSp)? gVWSp[thrId]: NULL,
+				mode, org, dir, dirLen, w0, w1,
+				valMin, valScale, opacity,
+				&(valAry[idY][idX]));
+	}
+      }
+    }
+  }
+  if(gVWSp)
+  {
+    int		idT;
+
+    for(idT = 0; idT < nThr; ++idT)
+    {
+      WlzGreyValueFreeWSp(gVWSp[idT]);
+    }
+    AlcFree(gVWSp);
+  }
+  /* Make the projection object using the hit array for it's domain. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    WlzIVertex2	prjOrg;
+    WlzPixelV	tV;
+    WlzObject	*hObj = NULL,
+    		*tObj = NULL,
+		*vObj = NULL;
+
+    prjOrg.vtX = prjBox.xMin;
+    prjOrg.vtY = prjBox.yMin;
+    hObj = WlzAssignObject(
+	   WlzFromArray2D((void **)hitAry, prjSz, prjOrg,
+			  WLZ_GREY_UBYTE, WLZ_GREY_UBYTE,
+			  0.0, 1.0, 0, 0, &errNum), NULL);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      tV.type = WLZ_GREY_UBYTE;
+      tV.v.ubv = 1;
+      tObj = WlzAssignObject(
+	     WlzThreshold(hObj, tV, WLZ_THRESH_HIGH, &errNum), NULL);
+    }
+    if((errNum == WLZ_ERR_NONE) && (tObj->type != WLZ_2D_DOMAINOBJ))
+    {
+      prjObj = WlzMakeEmpty(&errNum);
+    }
+    else if(errNum == WLZ_ERR_NONE)
+    {
+      vObj = WlzAssignObject(
+	     WlzFromArray2D((void **)valAry, prjSz, prjOrg,
+			    WLZ_GREY_FLOAT, WLZ_GREY_FLOAT,
+			    0.0, 1.0, 0, 0, &errNum), NULL);
+      if(errNum == WLZ_ERR_NONE)
+      {
+	prjObj = WlzMakeMain(WLZ_2D_DOMAINOBJ, tObj->domain, vObj->values,
+			     NULL, NULL, &errNum);
+      }
+    }
+    (void )WlzFreeObj(hObj);
+    (void )WlzFreeObj(tObj);
+    (void )WlzFreeObj(vObj);
+  }
+  (void )Alc2Free((void **)valAry);
+  (void )Alc2Free((void **)hitAry);
+  (void )WlzFreeAffineTransform(invTr);
+  (void )WlzFree3DViewStruct(vStr1);
+  /* Scale image. */
+  if(rescaleTr != NULL)
+  {
+    if((errNum == WLZ_ERR_NONE) && (prjObj->type == WLZ_2D_DOMAINOBJ))
+    {
+      WlzObject	*tObj = NULL;
+
+      tObj = WlzAffineTransformObj(prjObj, rescaleTr,
+				   WLZ_INTERPOLATION_NEAREST, &errNum);
+      (void )WlzFreeObj(prjObj);
+      prjObj = tObj;
+    }
+    (void )WlzFreeAffineTransform(rescaleTr);
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(prjObj);
+}
+
 /*!
 * \ingroup	WlzTransform
 * \brief	Sets values in the array to 1 on the straight line segment
@@ -1232,3 +1528,440 @@ static void	WlzProjectObjLineVal(int **ary, WlzUByte lut[256],
     }
   }
 }
+
+/*!
+* \return	New view structure or NULL on error.
+* \ingroup	WlzTransform
+* \brief	Makes a new view structure which has the same view
+* 		parameters as the given view structure and initialises
+* 		both it's transform and bounding box for the given
+* 		object.
+* \param	obj			Given object.
+* \param	vStr			Given view structure.
+* \param	rescale			If zero the voxel size of the new
+* 					view structure is set to unity and
+* 					voxel rescaling is not used, otherwise
+* 					the voxel size and rescale flag are
+* 					those of the given view structure.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+static WlzThreeDViewStruct *WlzProjectViewStruct(WlzObject *obj,
+				WlzThreeDViewStruct *vStr,
+				int rescale,
+				WlzErrorNum *dstErr)
+{
+  WlzThreeDViewStruct *vStr1;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((vStr1 = WlzMake3DViewStruct(WLZ_3D_VIEW_STRUCT, &errNum)) != NULL)
+  {
+    vStr1->fixed = vStr->fixed;
+    vStr1->theta = vStr->theta;
+    vStr1->phi = vStr->phi;
+    vStr1->zeta = vStr->zeta;
+    vStr1->dist = vStr->dist;
+    vStr1->scale = vStr->scale;
+    if(rescale)
+    {
+      vStr1->voxelSize[0] = vStr->voxelSize[0];
+      vStr1->voxelSize[1] = vStr->voxelSize[1];
+      vStr1->voxelSize[2] = vStr->voxelSize[2];
+      vStr1->voxelRescaleFlg = vStr->voxelRescaleFlg;
+    }
+    else
+    {
+      vStr1->voxelSize[0] = 1.0;
+      vStr1->voxelSize[1] = 1.0;
+      vStr1->voxelSize[2] = 1.0;
+      vStr1->voxelRescaleFlg = 0;
+    }
+    vStr1->interp = vStr->interp;
+    vStr1->view_mode = vStr->view_mode;
+    vStr1->up = vStr->up;
+    vStr1->initialised = WLZ_3DVIEWSTRUCT_INIT_NONE;
+    errNum = WlzInit3DViewStructAffineTransform(vStr1);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = Wlz3DViewStructTransformBB(obj, vStr1);
+    }
+    if(errNum != WLZ_ERR_NONE)
+    {
+      WlzFree3DViewStruct(vStr1);
+      vStr1 = NULL;
+    }
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(vStr1);
+}
+
+/*!
+* \return	New 2D affine transform or NULL on error.
+* \ingroup	WlzTransform
+* \brief	Computes the 2D affine transform which applies the
+* 		voxel size rescaling of the given view structure to
+* 		a projection computed without voxel rescaling.
+* \param	obj			Given object.
+* \param	vStr			Given view structure.
+* \param	prjBox			Bounding box of the projection
+* 					computed without voxel rescaling.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+static WlzAffineTransform *WlzProjectRescaleTr(WlzObject *obj,
+				WlzThreeDViewStruct *vStr,
+				WlzIBox2 prjBox,
+				WlzErrorNum *dstErr)
+{
+  WlzIBox2	sBox;
+  WlzIVertex2 	sSz,
+  		prjSz;
+  WlzThreeDViewStruct *vStr2;
+  WlzAffineTransform *rescaleTr = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const double	eps = 0.000001;
+
+  if((vStr2 = WlzProjectViewStruct(obj, vStr, 1, &errNum)) != NULL)
+  {
+    sBox.xMin = WLZ_NINT(vStr2->minvals.vtX);
+    sBox.yMin = WLZ_NINT(vStr2->minvals.vtY);
+    sBox.xMax = WLZ_NINT(vStr2->maxvals.vtX);
+    sBox.yMax = WLZ_NINT(vStr2->maxvals.vtY);
+    sSz.vtX = sBox.xMax - sBox.xMin + 1;
+    sSz.vtY = sBox.yMax - sBox.yMin + 1;
+    prjSz.vtX = prjBox.xMax - prjBox.xMin + 1;
+    prjSz.vtY = prjBox.yMax - prjBox.yMin + 1;
+    rescaleTr = WlzMakeAffineTransform(WLZ_TRANSFORM_2D_AFFINE, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      double	**m;
+
+      m = rescaleTr->mat;
+      m[0][0] = (sSz.vtX * eps) / (prjSz.vtX * eps);
+      m[1][1] = (sSz.vtY * eps) / (prjSz.vtY * eps);
+      m[0][2] = sBox.xMin - WLZ_NINT(m[0][0] * prjBox.xMin);
+      m[1][2] = sBox.yMin - WLZ_NINT(m[1][1] * prjBox.yMin);
+    }
+    (void )WlzFree3DViewStruct(vStr2);
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(rescaleTr);
+}
+
+/*!
+* \return	Non-zero if the clipped ray has non-zero length.
+* \ingroup	WlzTransform
+* \brief	Clips the parametric ray \f$p = o + w d\f$ with
+* 		\f$w_0 \leq w \leq w_1\f$ to the given box.
+* \param	w0			Destination pointer for the minimum
+* 					ray parameter, on entry this is the
+* 					initial minimum.
+* \param	w1			Destination pointer for the maximum
+* 					ray parameter, on entry this is the
+* 					initial maximum.
+* \param	org			Ray origin.
+* \param	dir			Ray direction.
+* \param	box			Box to clip the ray to.
+*/
+static int	WlzProjectRayClip(double *w0, double *w1,
+				  WlzDVertex3 org, WlzDVertex3 dir,
+				  WlzDBox3 box)
+{
+  int		idA;
+  double	t0,
+  		t1;
+  double	o[3],
+  		d[3],
+		bMin[3],
+		bMax[3];
+  const double	eps = 0.000001;
+
+  o[0] = org.vtX; o[1] = org.vtY; o[2] = org.vtZ;
+  d[0] = dir.vtX; d[1] = dir.vtY; d[2] = dir.vtZ;
+  bMin[0] = box.xMin; bMin[1] = box.yMin; bMin[2] = box.zMin;
+  bMax[0] = box.xMax; bMax[1] = box.yMax; bMax[2] = box.zMax;
+  t0 = *w0;
+  t1 = *w1;
+  for(idA = 0; (idA < 3) && (t0 < t1); ++idA)
+  {
+    if(fabs(d[idA]) < eps)
+    {
+      if((o[idA] < bMin[idA]) || (o[idA] > bMax[idA]))
+      {
+        t1 = t0;
+      }
+    }
+    else
+    {
+      double	ta,
+      		tb;
+
+      ta = (bMin[idA] - o[idA]) / d[idA];
+      tb = (bMax[idA] - o[idA]) / d[idA];
+      if(ta > tb)
+      {
+        double	tt;
+
+	tt = ta; ta = tb; tb = tt;
+      }
+      t0 = ALG_MAX(t0, ta);
+      t1 = ALG_MIN(t1, tb);
+    }
+  }
+  *w0 = t0;
+  *w1 = t1;
+  return(t0 < t1);
+}
+
+/*!
+* \return	Non-zero if the ray passed through the object's domain.
+* \ingroup	WlzTransform
+* \brief	Casts a single ray through the given 3D domain object.
+* 		The ray is traversed as a sequence of segments with
+* 		constant line and plane coordinates. Each segment is
+* 		intersected with the intervals of it's line so that
+* 		only voxels of the domain are visited, each being
+* 		weighted by the length of the ray within the voxel.
+* \param	obj			Given 3D domain object.
+* \param	gVWSp			Grey value workspace for the object,
+* 					NULL if the object has no values.
+* \param	mode			Projection mode.
+* \param	org			Ray origin.
+* \param	dir			Ray direction.
+* \param	dirLen			Length of the ray direction vector.
+* \param	w0			Minimum ray parameter.
+* \param	w1			Maximum ray parameter.
+* \param	valMin			Value with zero opacity.
+* \param	valScale		Reciprocal of the opacity value range.
+* \param	opacity			Opacity of unit length of ray with
+* 					maximum value.
+* \param	dstVal			Destination pointer for the projected
+* 					value.
+*/
+static int	WlzProjectRayCast(WlzObject *obj,
+				  WlzGreyValueWSpace *gVWSp,
+				  WlzProjectRayMode mode,
+				  WlzDVertex3 org, WlzDVertex3 dir,
+				  double dirLen, double w0, double w1,
+				  double valMin, double valScale,
+				  double opacity, float *dstVal)
+{
+  int		ln,
+  		pl,
+		hit = 0,
+  		done = 0;
+  double	ta,
+  		tNxtY,
+		tNxtZ,
+		tDltY,
+		tDltZ,
+		valMax = -DBL_MAX,
+		valSum = 0.0,
+		lenSum = 0.0,
+		trans = 1.0;
+  WlzPlaneDomain *pDom;
+  const double	eps = 0.000001,
+  		transMin = 0.01;
+
+  pDom = obj->domain.p;
+  ln = (int )floor(org.vtY + (w0 * dir.vtY) + 0.5);
+  pl = (int )floor(org.vtZ + (w0 * dir.vtZ) + 0.5);
+  if(fabs(dir.vtY) < eps)
+  {
+    tNxtY = tDltY = DBL_MAX;
+  }
+  else
+  {
+    tDltY = fabs(1.0 / dir.vtY);
+    tNxtY = (ln + ((dir.vtY > 0.0)? 0.5: -0.5) - org.vtY) / dir.vtY;
+  }
+  if(fabs(dir.vtZ) < eps)
+  {
+    tNxtZ = tDltZ = DBL_MAX;
+  }
+  else
+  {
+    tDltZ = fabs(1.0 / dir.vtZ);
+    tNxtZ = (pl + ((dir.vtZ > 0.0)? 0.5: -0.5) - org.vtZ) / dir.vtZ;
+  }
+  ta = w0;
+  while(!done && (ta < w1))
+  {
+    int		stepY;
+    double	tb;
+    WlzDomain	dom;
+
+    /* Find the end of this segment of constant line and plane. */
+    stepY = tNxtY <= tNxtZ;
+    tb = ALG_MIN(ALG_MIN(tNxtY, tNxtZ), w1);
+    if((tb > ta) &&
+       (pl >= pDom->plane1) && (pl <= pDom->lastpl) &&
+       ((dom = pDom->domains[pl - pDom->plane1]).core != NULL) &&
+       (ln >= dom.i->line1) && (ln <= dom.i->lastln))
+    {
+      int	idI,
+		nItv,
+		kLo,
+		kHi,
+		fwd;
+      double	xa,
+      		xb;
+      WlzInterval rItv,
+      		*itv;
+
+      /* Find the intervals of this line. */
+      if(dom.i->type == WLZ_INTERVALDOMAIN_INTVL)
+      {
+	WlzIntervalLine *iLn;
+
+	iLn = dom.i->intvlines + ln - dom.i->line1;
+	nItv = iLn->nintvs;
+	itv = iLn->intvs;
+      }
+      else
+      {
+        nItv = 1;
+	rItv.ileft = 0;
+	rItv.iright = dom.i->lastkl - dom.i->kol1;
+	itv = &rItv;
+      }
+      /* Find the range of columns the segment passes through and visit
+       * the domain's voxels within it in ray order. */
+      xa = org.vtX + (ta * dir.vtX);
+      xb = org.vtX + (tb * dir.vtX);
+      fwd = xb >= xa;
+      kLo = (int )floor(ALG_MIN(xa, xb) + 0.5) - dom.i->kol1;
+      kHi = (int )floor(ALG_MAX(xa, xb) + 0.5) - dom.i->kol1;
+      for(idI = 0; !done && (idI < nItv); ++idI)
+      {
+        int	k,
+		k0,
+		k1;
+	WlzInterval *cItv;
+
+	cItv = itv + ((fwd)? idI: nItv - 1 - idI);
+	k0 = ALG_MAX(kLo, cItv->ileft);
+	k1 = ALG_MIN(kHi, cItv->iright);
+	for(k = (fwd)? k0: k1; !done && (k >= k0) && (k <= k1);
+	    k += (fwd)? 1: -1)
+	{
+	  double len;
+
+	  /* Compute the length of the ray in the voxel. */
+	  if(fabs(dir.vtX) < eps)
+	  {
+	    len = tb - ta;
+	  }
+	  else
+	  {
+	    double	tk0,
+	    		tk1,
+			x;
+
+	    x = k + dom.i->kol1 - org.vtX;
+	    tk0 = (x - 0.5) / dir.vtX;
+	    tk1 = (x + 0.5) / dir.vtX;
+	    if(tk0 > tk1)
+	    {
+	      double	tt;
+
+	      tt = tk0; tk0 = tk1; tk1 = tt;
+	    }
+	    len = ALG_MIN(tb, tk1) - ALG_MAX(ta, tk0);
+	  }
+	  /* Ignore slivers of voxels which the ray only touches, as when it
+	   * starts or ends on a voxel face, because rounding may place
+	   * these on either side of the face. */
+	  if(len > eps)
+	  {
+	    double	val = 1.0;
+
+	    len *= dirLen;
+	    hit = 1;
+	    if(gVWSp)
+	    {
+	      WlzGreyValueGet(gVWSp, pl, ln, k + dom.i->kol1);
+	      switch(gVWSp->gType)
+	      {
+		case WLZ_GREY_INT:
+		  val = gVWSp->gVal[0].inv;
+		  break;
+		case WLZ_GREY_SHORT:
+		  val = gVWSp->gVal[0].shv;
+		  break;
+		case WLZ_GREY_UBYTE:
+		  val = gVWSp->gVal[0].ubv;
+		  break;
+		case WLZ_GREY_FLOAT:
+		  val = gVWSp->gVal[0].flv;
+		  break;
+		case WLZ_GREY_DOUBLE:
+		  val = gVWSp->gVal[0].dbv;
+		  break;
+		default:
+		  break;
+	      }
+	    }
+	    switch(mode)
+	    {
+	      case WLZ_PROJECT_RAY_MODE_MIP:
+		valMax = ALG_MAX(valMax, val);
+		break;
+	      case WLZ_PROJECT_RAY_MODE_MEAN: /* FALLTHROUGH */
+	      case WLZ_PROJECT_RAY_MODE_SUM:
+		valSum += val * len;
+		lenSum += len;
+		break;
+	      case WLZ_PROJECT_RAY_MODE_ALPHA:
+		{
+		  double a;
+
+		  a = (val - valMin) * valScale;
+		  a = WLZ_CLAMP(a, 0.0, 1.0) * opacity;
+		  a = 1.0 - pow(1.0 - a, len);
+		  valSum += trans * a * val;
+		  trans *= 1.0 - a;
+		  done = trans < transMin;
+		}
+		break;
+	      default:
+		break;
+	    }
+	  }
+	}
+      }
+    }
+    /* Step to the next line or plane. */
+    if(stepY)
+    {
+      ln += (dir.vtY > 0.0)? 1: -1;
+      tNxtY += tDltY;
+    }
+    else
+    {
+      pl += (dir.vtZ > 0.0)? 1: -1;
+      tNxtZ += tDltZ;
+    }
+    ta = tb;
+  }
+  if(hit)
+  {
+    switch(mode)
+    {
+      case WLZ_PROJECT_RAY_MODE_MIP:
+	*dstVal = (float )valMax;
+	break;
+      case WLZ_PROJECT_RAY_MODE_MEAN:
+	*dstVal = (lenSum > eps)? (float )(valSum / lenSum): 0.0f;
+	break;
+      default:
+	*dstVal = (float )valSum;
+	break;
+    }
+  }
+  return(hit);
+}
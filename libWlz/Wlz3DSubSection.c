@@ -387,6 +387,7 @@ static WlzObject	*WlzGetSubSectionFrom3DTiledValueObj(
 		      ((tOff.vtZ * tv->tileWidth + tOff.vtY) *
 		       tv->tileWidth) + tOff.vtX;
 #endif
+		(void )WlzTiledValuesDecodeTile(tv, idx);
 		switch(gType)
 		{
 	          case WLZ_GREY_INT:
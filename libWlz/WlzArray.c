@@ -47,6 +47,48 @@ static char _WlzArray_c[] = "University of Edinburgh $Id$";
 #include <Wlz.h>
 #include <Wlz.h>
 
+#ifdef HAVE_MMAP
+#define WLZ_USE_MMAP
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+/*!
+* \struct	_WlzArrayMap
+* \ingroup	WlzArray
+* \brief	A memory mapped region of a file which is kept on the
+* 		free stacks of one or more value tables, see
+* 		WlzMapFileRegion(). The mapping is only unmapped when
+* 		the last reference to it is released.
+*/
+typedef struct _WlzArrayMap
+{
+  int		refCnt;		/*!< Number of references to the mapping. */
+  void		*addr;		/*!< Page aligned address of the mapping. */
+  size_t	len;		/*!< Length of the mapping in bytes. */
+} WlzArrayMap;
+
+static WlzArrayMap		*WlzArrayMapNew(
+				  int fd,
+				  long offset,
+				  size_t len,
+				  int readOnly,
+				  void **dstDat,
+				  WlzErrorNum *dstErr);
+static WlzErrorNum		WlzArrayMapPush(
+				  void **freeptr,
+				  WlzArrayMap *map);
+static void			WlzArrayMapFree(
+				  void *data);
+#endif /* WLZ_USE_MMAP */
+
+static void			WlzArrayMapSwap(
+				  WlzUByte *dat,
+				  size_t gSz,
+				  size_t nPln,
+				  size_t nPlnElm);
+
 static WlzErrorNum 		WlzToArrayBit2D(
 				  WlzUByte ***dstP,
 				  WlzObject *srcObj,
@@ -3178,6 +3220,449 @@ WlzObject	*WlzFromArray1D(WlzObjectType oType,
   return(obj);
 }
 
+/*!
+* \return	New object.
+* \ingroup	WlzArray
+* \brief	Creates a new 2D or 3D domain object with values which
+* 		are memory mapped from the given open file rather than
+* 		being read into allocated memory. The file must contain
+* 		the values as a contiguous row major array (column index
+* 		varying fastest, plane index slowest) starting at the
+* 		given byte offset.
+*		The mapping is private (copy on write) so the values of
+*		the returned object may be modified without changing the
+*		file. If the swap flag is set the bytes of each value are
+*		reversed when the object is created, this touches every
+*		page of the mapping.
+*		The mapping is reference counted, with a reference kept
+*		on the free stack of the object's value table and, for
+*		3D objects, on the free stack of each plane's value
+*		table. It is only unmapped when the last of these value
+*		tables is free'd, so planes may be used after the 3D
+*		object has been free'd. The file descriptor is not
+*		retained and may be closed once this function has
+*		returned.
+* \param	oType			Required object type, must be
+      					WLZ_2D_DOMAINOBJ or WLZ_3D_DOMAINOBJ.
+* \param	sz			Size of the required object, ie the
+* 					number of columns, lines and planes.
+*					The number of planes is ignored for
+					WLZ_2D_DOMAINOBJ objects.
+* \param	org			The origin of the object. The plane
+*					origin is ignored for WLZ_2D_DOMAINOBJ
+*					objects.
+* \param	gType			The grey type of the data in the file
+*					and of the resulting object.
+* \param	fd			File descriptor of a file open for
+* 					reading.
+* \param	offset			Byte offset of the first value in the
+* 					file.
+* \param	swap			If non-zero the byte order of the
+* 					values is reversed.
+* \param	dstErr			Destination error pointer, may be NULL.
+* 					WLZ_ERR_UNIMPLEMENTED is returned if
+* 					memory mapping is not available, in
+* 					which case the caller may fall back
+* 					to reading the values.
+*/
+WlzObject	*WlzFromArrayMapped1D(WlzObjectType oType,
+				WlzIVertex3 sz, WlzIVertex3 org,
+				WlzGreyType gType, int fd, long offset,
+				int swap, WlzErrorNum *dstErr)
+{
+  size_t	gSz = 0,
+  		nPln = 1,
+		nPlnElm = 0;
+  WlzGreyP	gDat;
+  WlzObject	*obj = NULL;
+#ifdef WLZ_USE_MMAP
+  WlzArrayMap	*map = NULL;
+#endif /* WLZ_USE_MMAP */
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  gDat.v = NULL;
+  switch(oType)
+  {
+    case WLZ_3D_DOMAINOBJ:
+      nPln = (sz.vtZ > 0)? sz.vtZ: 0;
+      /* FALLTHROUGH */
+    case WLZ_2D_DOMAINOBJ:
+      break;
+    default:
+      errNum = WLZ_ERR_OBJECT_TYPE;
+      break;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    switch(gType)
+    {
+      case WLZ_GREY_INT:    /* FALLTHROUGH */
+      case WLZ_GREY_SHORT:  /* FALLTHROUGH */
+      case WLZ_GREY_UBYTE:  /* FALLTHROUGH */
+      case WLZ_GREY_FLOAT:  /* FALLTHROUGH */
+      case WLZ_GREY_DOUBLE: /* FALLTHROUGH */
+      case WLZ_GREY_RGBA:
+	gSz = WlzGreySize(gType);
+        break;
+      default:
+	errNum = WLZ_ERR_GREY_TYPE;
+	break;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((sz.vtX < 1) || (sz.vtY < 1) || (nPln < 1))
+    {
+      errNum = WLZ_ERR_PARAM_DATA;
+    }
+    else
+    {
+      nPlnElm = (size_t )(sz.vtX) * (size_t )(sz.vtY);
+#ifdef WLZ_USE_MMAP
+      map = WlzArrayMapNew(fd, offset, gSz * nPlnElm * nPln, 0,
+      			   &(gDat.v), &errNum);
+#else /* WLZ_USE_MMAP */
+      errNum = WLZ_ERR_UNIMPLEMENTED;
+#endif /* WLZ_USE_MMAP */
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(swap && (gSz > 1))
+    {
+      WlzArrayMapSwap(gDat.ubp, gSz, nPln, nPlnElm);
+    }
+    obj = WlzFromArray1D(oType, sz, org, gType, gDat, 1, &errNum);
+  }
+#ifdef WLZ_USE_MMAP
+  if(errNum == WLZ_ERR_NONE)
+  {
+    /* The planes of a 3D object all share the single mapping, which is
+     * referenced by the voxel value table and by each of the plane
+     * value tables, since these may be held independently. */
+    if(oType == WLZ_2D_DOMAINOBJ)
+    {
+      errNum = WlzArrayMapPush(&(obj->values.r->freeptr), map);
+    }
+    else
+    {
+      size_t	idP;
+
+      errNum = WlzArrayMapPush(&(obj->values.vox->freeptr), map);
+      for(idP = 0; (errNum == WLZ_ERR_NONE) && (idP < nPln); ++idP)
+      {
+	WlzValues *val2;
+
+	val2 = obj->values.vox->values + idP;
+	if((*val2).r)
+	{
+	  errNum = WlzArrayMapPush(&((*val2).r->freeptr), map);
+	}
+      }
+    }
+  }
+#endif /* WLZ_USE_MMAP */
+  if(errNum != WLZ_ERR_NONE)
+  {
+    (void )WlzFreeObj(obj);
+    obj = NULL;
+  }
+#ifdef WLZ_USE_MMAP
+  /* Release the reference held while creating the object. */
+  if(map)
+  {
+    WlzArrayMapFree(map);
+  }
+#endif /* WLZ_USE_MMAP */
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(obj);
+}
+
+/*!
+* \return	Pointer to the mapped data at the given offset or NULL
+* 		on error.
+* \ingroup	WlzArray
+* \brief	Memory maps a region of the given open file. The mapping
+* 		is private so that, unless it is read only, modifications
+* 		are copy on write and never reach the file. The mapping
+* 		is pushed onto the given free stack, so that it is
+* 		unmapped when the stack is free'd, typically by freeing
+* 		the value table which holds the stack. The file descriptor
+* 		is not retained.
+* \param	fd			File descriptor of a file open for
+* 					reading.
+* \param	offset			Byte offset of the region in the file,
+* 					which need not be page aligned.
+* \param	len			Length of the region in bytes.
+* \param	readOnly		If non-zero the mapping is read only.
+* \param	freeptr			Free stack pointer which is updated
+* 					with the mapping, must not be NULL.
+* \param	dstErr			Destination error pointer, may be NULL.
+* 					WLZ_ERR_UNIMPLEMENTED is returned if
+* 					memory mapping is not available and
+* 					WLZ_ERR_READ_INCOMPLETE if the file is
+* 					too short or can not be mapped.
+*/
+void		*WlzMapFileRegion(int fd, long offset, size_t len,
+				  int readOnly, void **freeptr,
+				  WlzErrorNum *dstErr)
+{
+  void		*dat = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+#ifdef WLZ_USE_MMAP
+  WlzArrayMap	*map = NULL;
+
+  if(freeptr == NULL)
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else
+  {
+    map = WlzArrayMapNew(fd, offset, len, readOnly, &dat, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = WlzArrayMapPush(freeptr, map);
+  }
+  if(map)
+  {
+    WlzArrayMapFree(map);
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    dat = NULL;
+  }
+#else /* WLZ_USE_MMAP */
+  errNum = WLZ_ERR_UNIMPLEMENTED;
+#endif /* WLZ_USE_MMAP */
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(dat);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzArray
+* \brief	Pops the mapping most recently pushed onto the given free
+* 		stack by WlzMapFileRegion() and releases it, so that the
+* 		region is unmapped unless it is still referenced by
+* 		another free stack. This allows a caller to abandon a
+* 		mapping which it can not use.
+* \param	freeptr			Free stack pointer which is updated,
+* 					the top of the stack must be a
+* 					mapping pushed by WlzMapFileRegion().
+*/
+WlzErrorNum	WlzUnmapFileRegion(void **freeptr)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+#ifdef WLZ_USE_MMAP
+  void		*map = NULL;
+  AlcErrno	alcErr = ALC_ER_NONE;
+
+  if((freeptr == NULL) || (*freeptr == NULL))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else
+  {
+    *freeptr = AlcFreeStackPop(*freeptr, &map, &alcErr);
+    if(alcErr != ALC_ER_NONE)
+    {
+      errNum = WLZ_ERR_PARAM_DATA;
+    }
+    else
+    {
+      WlzArrayMapFree(map);
+    }
+  }
+#else /* WLZ_USE_MMAP */
+  errNum = WLZ_ERR_UNIMPLEMENTED;
+#endif /* WLZ_USE_MMAP */
+  return(errNum);
+}
+
+#ifdef WLZ_USE_MMAP
+/*!
+* \return	New mapping or NULL on error.
+* \ingroup	WlzArray
+* \brief	Memory maps a region of the given open file, see
+* 		WlzMapFileRegion(). The new mapping has a single
+* 		reference, which is held by the caller and should be
+* 		released using WlzArrayMapFree().
+* \param	fd			File descriptor of a file open for
+* 					reading.
+* \param	offset			Byte offset of the region in the file.
+* \param	len			Length of the region in bytes.
+* \param	readOnly		If non-zero the mapping is read only.
+* \param	dstDat			Destination pointer for the address
+* 					of the region.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+static WlzArrayMap *WlzArrayMapNew(int fd, long offset, size_t len,
+				int readOnly, void **dstDat,
+				WlzErrorNum *dstErr)
+{
+  long		pgSz,
+  		mapOff = 0;
+  WlzArrayMap	*map = NULL;
+  struct stat	st;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((fd < 0) || (offset < 0) || (len < 1))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else if((fstat(fd, &st) != 0) ||
+	  ((size_t )(st.st_size) < (size_t )offset + len))
+  {
+    errNum = WLZ_ERR_READ_INCOMPLETE;
+  }
+  else if((map = (WlzArrayMap *)AlcCalloc(1, sizeof(WlzArrayMap))) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    /* Mapping offsets must be page aligned. */
+    map->refCnt = 1;
+    pgSz = sysconf(_SC_PAGESIZE);
+    mapOff = (pgSz > 0)? (offset / pgSz) * pgSz: 0;
+    map->len = len + (offset - mapOff);
+    map->addr = mmap(NULL, map->len,
+		     (readOnly)? PROT_READ: PROT_READ | PROT_WRITE,
+		     MAP_PRIVATE, fd, (off_t )mapOff);
+    if(map->addr == MAP_FAILED)
+    {
+      map->addr = NULL;
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    *dstDat = (WlzUByte *)(map->addr) + (offset - mapOff);
+  }
+  else if(map)
+  {
+    WlzArrayMapFree(map);
+    map = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(map);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzArray
+* \brief	Pushes a new reference to the given mapping onto the
+* 		given free stack, so that the reference is released
+* 		when the stack is free'd.
+* \param	freeptr			Free stack pointer which is updated
+* 					with the mapping.
+* \param	map			The mapping.
+*/
+static WlzErrorNum WlzArrayMapPush(void **freeptr, WlzArrayMap *map)
+{
+  void		*stk;
+  AlcErrno	alcErr = ALC_ER_NONE;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  stk = AlcFreeStackPushFn(*freeptr, map, WlzArrayMapFree, &alcErr);
+  if(alcErr != ALC_ER_NONE)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    *freeptr = stk;
+#ifdef _OPENMP
+#pragma omp critical (WlzArrayMap)
+#endif
+    {
+      ++(map->refCnt);
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \ingroup	WlzArray
+* \brief	Releases a reference to a memory mapping created by
+* 		WlzArrayMapNew(), unmapping and freeing it when the
+* 		last reference is released. Used as a free stack
+* 		function.
+* \param	data			The WlzArrayMap to release.
+*/
+static void	WlzArrayMapFree(void *data)
+{
+  int		refCnt;
+  WlzArrayMap	*map;
+
+  if((map = (WlzArrayMap *)data) != NULL)
+  {
+#ifdef _OPENMP
+#pragma omp critical (WlzArrayMap)
+#endif
+    {
+      refCnt = --(map->refCnt);
+    }
+    if(refCnt <= 0)
+    {
+      if(map->addr)
+      {
+	(void )munmap(map->addr, map->len);
+      }
+      AlcFree(map);
+    }
+  }
+}
+#endif /* WLZ_USE_MMAP */
+
+/*!
+* \ingroup	WlzArray
+* \brief	Reverses the byte order of all values in the given
+* 		array in place. Planes are swapped in parallel.
+* \param	dat			The array of values.
+* \param	gSz			Size of each value in bytes.
+* \param	nPln			Number of planes.
+* \param	nPlnElm			Number of values in each plane.
+*/
+static void	WlzArrayMapSwap(WlzUByte *dat, size_t gSz,
+				size_t nPln, size_t nPlnElm)
+{
+  long		idP;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for(idP = 0; idP < (long )nPln; ++idP)
+  {
+    size_t	idE,
+    		idB;
+    WlzUByte	t;
+    WlzUByte	*p;
+
+    p = dat + (gSz * nPlnElm * idP);
+    for(idE = 0; idE < nPlnElm; ++idE)
+    {
+      for(idB = 0; idB < gSz / 2; ++idB)
+      {
+	t = p[idB];
+	p[idB] = p[gSz - idB - 1];
+	p[gSz - idB - 1] = t;
+      }
+      p += gSz;
+    }
+  }
+}
+
 /*!
 * \return	Woolz error code.
 * \ingroup	WlzArray
@@ -4390,8 +4390,8 @@ static void	WlzBasisFnTPS2DCoef(WlzBasisFn *basisFn,
     (basisFn->poly.d2 + 1)->vtY = *(vec + 1) / range;
     (basisFn->poly.d2 + 2)->vtY = *(vec + 2) / range;
     (basisFn->poly.d2 + 0)->vtY = *(vec + 0) -
-			      ((basisFn->poly.d2 + 1)->vtY * extentDB->yMin) -
-			      ((basisFn->poly.d2 + 2)->vtY * extentDB->xMin) -
+			      ((basisFn->poly.d2 + 1)->vtY * extentDB->xMin) -
+			      ((basisFn->poly.d2 + 2)->vtY * extentDB->yMin) -
 			      (log(rangeSq) * sumLogCoeffRSq);
   }
 }
@@ -0,0 +1,1534 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzBasisFnTPSEdit_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         libWlz/WlzBasisFnTPSEdit.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Editable 2D thin plate spline transforms, for which
+* 		control points may be added, moved or removed without
+* 		recomputing the full solution.
+* \ingroup	WlzTransform
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <Wlz.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*!
+* \def		WLZ_BASISFN_TPSEDIT_MAX_UPD
+* \ingroup	WlzTransform
+* \brief	Maximum number of low rank updates between full solutions.
+*/
+#define WLZ_BASISFN_TPSEDIT_MAX_UPD	(64)
+
+/*!
+* \def		WLZ_BASISFN_TPSEDIT_RES_TOL
+* \ingroup	WlzTransform
+* \brief	Tolerance for the control point residuals of an updated
+* 		solution, relative to the maximum control point
+* 		displacement.
+*/
+#define WLZ_BASISFN_TPSEDIT_RES_TOL	(1.0e-9)
+
+/*!
+* \def		WLZ_BASISFN_TPSEDIT_MAX_REF
+* \ingroup	WlzTransform
+* \brief	Maximum number of iterative refinement steps before a
+* 		full solution is computed.
+*/
+#define WLZ_BASISFN_TPSEDIT_MAX_REF	(3)
+
+/*!
+* \def		WLZ_BASISFN_TPSEDIT_BLK_NOD
+* \ingroup	WlzTransform
+* \brief	Approximate number of mesh nodes in each block of the
+* 		displacement cache.
+*/
+#define WLZ_BASISFN_TPSEDIT_BLK_NOD	(16)
+
+static void			WlzBasisFnTPSEditBorder(
+				  WlzBasisFnTPS2DEdit *edt,
+				  WlzDVertex2 u,
+				  int self,
+				  double *a);
+static void			WlzBasisFnTPSEditMatVec(
+				  WlzBasisFnTPS2DEdit *edt,
+				  double *a,
+				  double *w);
+static double			WlzBasisFnTPSEditPhi(
+				  WlzDVertex2 u0,
+				  WlzDVertex2 u1);
+static double			WlzBasisFnTPSEditDPhiMax(
+				  double r0,
+				  double r1);
+static WlzDVertex2		WlzBasisFnTPSEditNrm(
+				  WlzBasisFnTPS2DEdit *edt,
+				  WlzDVertex2 p);
+static WlzErrorNum		WlzBasisFnTPSEditReserve(
+				  WlzBasisFnTPS2DEdit *edt,
+				  int nVtx);
+static WlzErrorNum		WlzBasisFnTPSEditFactor(
+				  WlzBasisFnTPS2DEdit *edt);
+static WlzErrorNum		WlzBasisFnTPSEditSolve(
+				  WlzBasisFnTPS2DEdit *edt);
+static WlzErrorNum		WlzBasisFnTPSEditSolveFactor(
+				  WlzBasisFnTPS2DEdit *edt);
+static WlzErrorNum		WlzBasisFnTPSEditCopyFn(
+				  WlzBasisFn **dstFn,
+				  WlzBasisFn *srcFn);
+static WlzErrorNum		WlzBasisFnTPSEditMeshBlk(
+				  WlzBasisFnTPS2DEdit *edt,
+				  WlzMeshTransform *mesh);
+static double			WlzBasisFnTPSEditBound(
+				  WlzBasisFn *fn0,
+				  WlzBasisFn *fn1,
+				  WlzDVertex2 ctr,
+				  double rad);
+
+/*!
+* \return	New editable thin plate spline transform or NULL on error.
+* \ingroup	WlzTransform
+* \brief	Creates a new editable 2D thin plate spline transform from
+* 		the given control points. The transform is equivalent to
+* 		that computed by WlzBasisFnTPS2DFromCPts() using Euclidean
+* 		distances, but control points may then be added, moved or
+* 		removed using WlzBasisFnTPS2DEditAdd(),
+* 		WlzBasisFnTPS2DEditMove() and WlzBasisFnTPS2DEditRemove()
+* 		at a cost which is quadratic rather than cubic in the
+* 		number of control points. The current transform is
+* 		always available as the basisTr member of the editable
+* 		transform and remains owned by it.
+* \param	nPts			Number of control point pairs, must
+* 					be at least 3.
+* \param	dPts			Destination control points.
+* \param	sPts			Source control points.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzBasisFnTPS2DEdit		*WlzBasisFnTPS2DEditNew(
+				  int nPts,
+				  WlzDVertex2 *dPts,
+				  WlzDVertex2 *sPts,
+				  WlzErrorNum *dstErr)
+{
+  WlzBasisFnTPS2DEdit *edt = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((dPts == NULL) || (sPts == NULL))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if(nPts < 3)
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else if((edt = (WlzBasisFnTPS2DEdit *)
+                 AlcCalloc(1, sizeof(WlzBasisFnTPS2DEdit))) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else if((edt->basisTr = WlzMakeBasisFnTransform(&errNum)) != NULL)
+  {
+    edt->basisTr->type = WLZ_TRANSFORM_2D_BASISFN;
+    if((edt->basisTr->basisFn = (WlzBasisFn *)
+                                AlcCalloc(1, sizeof(WlzBasisFn))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      edt->basisTr->basisFn->type = WLZ_FN_BASIS_2DTPS;
+      edt->basisTr->basisFn->nPoly = 2;
+      if((edt->basisTr->basisFn->poly.v =
+	  AlcCalloc(3, sizeof(WlzDVertex2))) == NULL)
+      {
+	errNum = WLZ_ERR_MEM_ALLOC;
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = WlzBasisFnTPSEditReserve(edt, nPts);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idN;
+    WlzDVertex2	tV;
+    WlzDBox2	box;
+
+    box.xMin = box.xMax = dPts[0].vtX;
+    box.yMin = box.yMax = dPts[0].vtY;
+    for(idN = 1; idN < nPts; ++idN)
+    {
+      box.xMin = WLZ_MIN(box.xMin, dPts[idN].vtX);
+      box.xMax = WLZ_MAX(box.xMax, dPts[idN].vtX);
+      box.yMin = WLZ_MIN(box.yMin, dPts[idN].vtY);
+      box.yMax = WLZ_MAX(box.yMax, dPts[idN].vtY);
+    }
+    edt->org.vtX = box.xMin;
+    edt->org.vtY = box.yMin;
+    edt->range = WLZ_MAX(box.xMax - box.xMin, box.yMax - box.yMin);
+    if(edt->range <= 1.0)
+    {
+      errNum = WLZ_ERR_PARAM_DATA;
+    }
+    else
+    {
+      edt->nVtx = nPts;
+      for(idN = 0; idN < nPts; ++idN)
+      {
+	edt->dVx[idN] = dPts[idN];
+	edt->sVx[idN] = sPts[idN];
+	tV = WlzBasisFnTPSEditNrm(edt, dPts[idN]);
+	edt->nVx[idN] = tV;
+      }
+      errNum = WlzBasisFnTPSEditSolveFactor(edt);
+    }
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    (void )WlzBasisFnTPS2DEditFree(edt);
+    edt = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(edt);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Frees an editable thin plate spline transform along with
+* 		its basis function transform. A mesh transform given to
+* 		WlzBasisFnTPS2DEditSetMesh() is not freed.
+* \param	edt			Given editable transform, may be NULL.
+*/
+WlzErrorNum			WlzBasisFnTPS2DEditFree(
+				  WlzBasisFnTPS2DEdit *edt)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(edt)
+  {
+    AlcFree(edt->dVx);
+    AlcFree(edt->sVx);
+    AlcFree(edt->nVx);
+    AlcFree(edt->buf);
+    if(edt->aI)
+    {
+      (void )AlcDouble2Free(edt->aI);
+    }
+    (void )WlzBasisFnFree(edt->mshFn);
+    AlcFree(edt->mshBlkOff);
+    AlcFree(edt->mshBlkNod);
+    AlcFree(edt->mshBlkErr);
+    errNum = WlzBasisFnFreeTransform(edt->basisTr);
+    AlcFree(edt);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Adds a control point pair to an editable thin plate
+* 		spline transform, the new control point pair being
+* 		appended to the control points.
+* 		The inverse design matrix is updated by bordering.
+* \param	edt			Given editable transform.
+* \param	dPt			Destination control point.
+* \param	sPt			Source control point.
+*/
+WlzErrorNum			WlzBasisFnTPS2DEditAdd(
+				  WlzBasisFnTPS2DEdit *edt,
+				  WlzDVertex2 dPt,
+				  WlzDVertex2 sPt)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(edt == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else
+  {
+    errNum = WlzBasisFnTPSEditReserve(edt, edt->nVtx + 1);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idI,
+    		idJ,
+		m,
+		n;
+    double	s;
+    double	*a,
+    		*w;
+    WlzDVertex2	u;
+
+    n = edt->nVtx;
+    m = n + 3;
+    a = edt->buf;
+    w = edt->buf + edt->maxVtx + 3;
+    u = WlzBasisFnTPSEditNrm(edt, dPt);
+    WlzBasisFnTPSEditBorder(edt, u, -1, a);
+    WlzBasisFnTPSEditMatVec(edt, a, w);
+    s = 0.0;
+    for(idI = 0; idI < m; ++idI)
+    {
+      s -= a[idI] * w[idI];
+    }
+    edt->dVx[n] = dPt;
+    edt->sVx[n] = sPt;
+    edt->nVx[n] = u;
+    edt->nVtx = n + 1;
+    if((fabs(s) > DBL_EPSILON) &&
+       (edt->nUpd < WLZ_BASISFN_TPSEDIT_MAX_UPD))
+    {
+      double	**aI;
+
+      /* Inverse of the bordered matrix from the Schur complement s. */
+      aI = edt->aI;
+      s = 1.0 / s;
+      for(idI = 0; idI < m; ++idI)
+      {
+	double	wI;
+
+	wI = w[idI] * s;
+	for(idJ = 0; idJ < m; ++idJ)
+	{
+	  aI[idI][idJ] += wI * w[idJ];
+	}
+	aI[idI][m] = aI[m][idI] = -wI;
+      }
+      aI[m][m] = s;
+      ++(edt->nUpd);
+      errNum = WlzBasisFnTPSEditSolve(edt);
+    }
+    else
+    {
+      errNum = WlzBasisFnTPSEditSolveFactor(edt);
+    }
+    if(errNum != WLZ_ERR_NONE)
+    {
+      edt->nVtx = n;
+      (void )WlzBasisFnTPSEditSolveFactor(edt);
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Moves a control point pair of an editable thin plate
+* 		spline transform. If only the source control point has
+* 		moved the design matrix is unchanged, otherwise its
+* 		inverse is updated using a rank two Sherman-Morrison-
+* 		Woodbury update.
+* \param	edt			Given editable transform.
+* \param	idx			Index of the control point pair.
+* \param	dPt			New destination control point.
+* \param	sPt			New source control point.
+*/
+WlzErrorNum			WlzBasisFnTPS2DEditMove(
+				  WlzBasisFnTPS2DEdit *edt,
+				  int idx,
+				  WlzDVertex2 dPt,
+				  WlzDVertex2 sPt)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(edt == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if((idx < 0) || (idx >= edt->nVtx))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else
+  {
+    int		k,
+    		m;
+    WlzDVertex2	oD,
+    		oS,
+		oU;
+
+    m = edt->nVtx + 3;
+    k = idx + 3;
+    oD = edt->dVx[idx];
+    oS = edt->sVx[idx];
+    oU = edt->nVx[idx];
+    edt->sVx[idx] = sPt;
+    if(WlzGeomCmpVtx2D(dPt, oD, DBL_EPSILON) == 0)
+    {
+      errNum = WlzBasisFnTPSEditSolve(edt);
+    }
+    else
+    {
+      int	idI,
+      		idJ;
+      double	det,
+      		p,
+		q,
+		r,
+		t,
+		dw;
+      double	*a,
+      		*d,
+		*b,
+		*w;
+      double	**aI;
+
+      aI = edt->aI;
+      a = edt->buf;
+      d = edt->buf + (edt->maxVtx + 3);
+      b = edt->buf + (2 * (edt->maxVtx + 3));
+      w = edt->buf + (3 * (edt->maxVtx + 3));
+      /* Change in the row and column of the design matrix. */
+      WlzBasisFnTPSEditBorder(edt, oU, idx, d);
+      edt->dVx[idx] = dPt;
+      edt->nVx[idx] = WlzBasisFnTPSEditNrm(edt, dPt);
+      WlzBasisFnTPSEditBorder(edt, edt->nVx[idx], idx, a);
+      for(idI = 0; idI < m; ++idI)
+      {
+        d[idI] = a[idI] - d[idI];
+	b[idI] = aI[idI][k];
+      }
+      WlzBasisFnTPSEditMatVec(edt, d, w);
+      dw = 0.0;
+      for(idI = 0; idI < m; ++idI)
+      {
+        dw += d[idI] * w[idI];
+      }
+      /* A' = A + e_k d^T + d e_k^T, inverse updated using the 2x2
+       * capacitance matrix C = I + [d e_k]^T A^{-1} [e_k d]. */
+      det = ((1.0 + w[k]) * (1.0 + w[k])) - (dw * b[k]);
+      if((fabs(det) > DBL_EPSILON) &&
+         (edt->nUpd < WLZ_BASISFN_TPSEDIT_MAX_UPD))
+      {
+	p = (1.0 + w[k]) / det;
+	q = -dw / det;
+	r = -b[k] / det;
+	t = p;
+	for(idI = 0; idI < m; ++idI)
+	{
+	  double bI,
+	  	 wI;
+
+	  bI = b[idI];
+	  wI = w[idI];
+	  for(idJ = 0; idJ < m; ++idJ)
+	  {
+	    aI[idI][idJ] -= (bI * ((p * w[idJ]) + (q * b[idJ]))) +
+	                    (wI * ((r * w[idJ]) + (t * b[idJ])));
+	  }
+	}
+	++(edt->nUpd);
+	errNum = WlzBasisFnTPSEditSolve(edt);
+      }
+      else
+      {
+	errNum = WlzBasisFnTPSEditSolveFactor(edt);
+      }
+    }
+    if(errNum != WLZ_ERR_NONE)
+    {
+      edt->dVx[idx] = oD;
+      edt->sVx[idx] = oS;
+      edt->nVx[idx] = oU;
+      (void )WlzBasisFnTPSEditSolveFactor(edt);
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Removes a control point pair from an editable thin plate
+* 		spline transform, with the following control points
+* 		moving down to fill the gap. The inverse design matrix
+* 		is updated by eliminating the row and column of the
+* 		control point.
+* \param	edt			Given editable transform.
+* \param	idx			Index of the control point pair.
+*/
+WlzErrorNum			WlzBasisFnTPS2DEditRemove(
+				  WlzBasisFnTPS2DEdit *edt,
+				  int idx)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(edt == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if((idx < 0) || (idx >= edt->nVtx) || (edt->nVtx <= 3))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else
+  {
+    int		idI,
+    		k,
+		m,
+		n;
+    double	g;
+    double	*b;
+    double	**aI;
+    WlzDVertex2	oD,
+    		oS;
+
+    n = edt->nVtx;
+    m = n + 3;
+    k = idx + 3;
+    aI = edt->aI;
+    b = edt->buf;
+    g = aI[k][k];
+    for(idI = 0; idI < m; ++idI)
+    {
+      b[idI] = aI[idI][k];
+    }
+    oD = edt->dVx[idx];
+    oS = edt->sVx[idx];
+    for(idI = idx + 1; idI < n; ++idI)
+    {
+      edt->dVx[idI - 1] = edt->dVx[idI];
+      edt->sVx[idI - 1] = edt->sVx[idI];
+      edt->nVx[idI - 1] = edt->nVx[idI];
+    }
+    edt->nVtx = n - 1;
+    if((fabs(g) > DBL_EPSILON) &&
+       (edt->nUpd < WLZ_BASISFN_TPSEDIT_MAX_UPD))
+    {
+      int	idJ;
+
+      /* Rows and columns are only ever moved towards the origin, so
+       * the update and removal can be done in place. */
+      g = 1.0 / g;
+      for(idI = 0; idI < m - 1; ++idI)
+      {
+	int	i0;
+	double	bI;
+
+	i0 = idI + (idI >= k);
+	bI = b[i0] * g;
+	for(idJ = 0; idJ < m - 1; ++idJ)
+	{
+	  int	j0;
+
+	  j0 = idJ + (idJ >= k);
+	  aI[idI][idJ] = aI[i0][j0] - (bI * b[j0]);
+	}
+      }
+      ++(edt->nUpd);
+      errNum = WlzBasisFnTPSEditSolve(edt);
+    }
+    else
+    {
+      errNum = WlzBasisFnTPSEditSolveFactor(edt);
+    }
+    if(errNum != WLZ_ERR_NONE)
+    {
+      for(idI = n - 1; idI > idx; --idI)
+      {
+	edt->dVx[idI] = edt->dVx[idI - 1];
+	edt->sVx[idI] = edt->sVx[idI - 1];
+	edt->nVx[idI] = edt->nVx[idI - 1];
+      }
+      edt->dVx[idx] = oD;
+      edt->sVx[idx] = oS;
+      edt->nVx[idx] = WlzBasisFnTPSEditNrm(edt, oD);
+      edt->nVtx = n;
+      (void )WlzBasisFnTPSEditSolveFactor(edt);
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Sets the node displacements of the given mesh transform
+* 		using the current editable thin plate spline transform,
+* 		in the same way as WlzBasisFnSetMesh(). The mesh transform
+* 		is cached and when it is given again only the nodes for
+* 		which the displacement may have changed by more than the
+* 		given tolerance, since the nodes were last set, are
+* 		recomputed.
+* 		To do this the mesh nodes are grouped into square blocks
+* 		and for each block the change in the transform at the
+* 		block centre, together with a bound on the gradient of
+* 		the change within the block, is used to bound the change
+* 		in displacement of the block's nodes. These bounds are
+* 		accumulated for each block, so the cached displacements
+* 		never differ from those of the current transform by
+* 		more than the tolerance.
+* 		The mesh transform nodes must not be changed other than
+* 		by this function while it is cached.
+* \param	edt			Given editable transform.
+* \param	mesh			Given mesh transform.
+* \param	tol			Tolerance for the displacement of
+* 					each node in each direction, if not
+* 					greater than zero all the nodes are
+* 					recomputed.
+* \param	dstCnt			Destination pointer for the number
+* 					of nodes recomputed, may be NULL.
+*/
+WlzErrorNum			WlzBasisFnTPS2DEditSetMesh(
+				  WlzBasisFnTPS2DEdit *edt,
+				  WlzMeshTransform *mesh,
+				  double tol,
+				  int *dstCnt)
+{
+  int		cnt = 0;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((edt == NULL) || (mesh == NULL))
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if(mesh->type != WLZ_TRANSFORM_2D_MESH)
+  {
+    errNum = WLZ_ERR_TRANSFORM_TYPE;
+  }
+  else if((mesh != edt->mesh) || (edt->mshFn == NULL))
+  {
+    errNum = WlzBasisFnTPSEditMeshBlk(edt, mesh);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      edt->mesh = mesh;
+      tol = 0.0;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idB,
+    		nBlk;
+    double	rad;
+    WlzBasisFn	*fn;
+
+    fn = edt->basisTr->basisFn;
+    nBlk = edt->mshBlkCnt.vtX * edt->mshBlkCnt.vtY;
+    rad = 0.5 * sqrt(2.0) * edt->mshBlkSz;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+:cnt)
+#endif
+    for(idB = 0; idB < nBlk; ++idB)
+    {
+      int	upd = 1;
+
+      if(edt->mshBlkOff[idB] == edt->mshBlkOff[idB + 1])
+      {
+        upd = 0;
+      }
+      else if(tol > 0.0)
+      {
+	double	 bnd;
+	WlzDVertex2 ctr;
+
+	ctr.vtX = edt->mshBlkOrg.vtX +
+	          (((idB % edt->mshBlkCnt.vtX) + 0.5) * edt->mshBlkSz);
+	ctr.vtY = edt->mshBlkOrg.vtY +
+	          (((idB / edt->mshBlkCnt.vtX) + 0.5) * edt->mshBlkSz);
+	bnd = WlzBasisFnTPSEditBound(fn, edt->mshFn, ctr, rad);
+	if(edt->mshBlkErr[idB] + bnd < tol)
+	{
+	  edt->mshBlkErr[idB] += bnd;
+	  upd = 0;
+	}
+      }
+      if(upd)
+      {
+	int	idN;
+
+	for(idN = edt->mshBlkOff[idB]; idN < edt->mshBlkOff[idB + 1]; ++idN)
+	{
+	  WlzMeshNode *nod;
+
+	  nod = mesh->nodes + edt->mshBlkNod[idN];
+	  nod->displacement = WlzBasisFnValueTPS2D(fn, nod->position);
+	}
+	edt->mshBlkErr[idB] = 0.0;
+	cnt += edt->mshBlkOff[idB + 1] - edt->mshBlkOff[idB];
+      }
+    }
+    errNum = WlzBasisFnTPSEditCopyFn(&(edt->mshFn), fn);
+    if(errNum != WLZ_ERR_NONE)
+    {
+      edt->mesh = NULL;
+    }
+  }
+  if(dstCnt)
+  {
+    *dstCnt = cnt;
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Groups the nodes of a mesh transform into square blocks
+* 		each of which has approximately
+* 		::WLZ_BASISFN_TPSEDIT_BLK_NOD nodes.
+* \param	edt			Given editable transform.
+* \param	mesh			Given mesh transform.
+*/
+static WlzErrorNum		WlzBasisFnTPSEditMeshBlk(
+				  WlzBasisFnTPS2DEdit *edt,
+				  WlzMeshTransform *mesh)
+{
+  int		idN,
+  		nBlk = 1;
+  int		*blk = NULL;
+  double	h = 1.0;
+  WlzDBox2	box;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  AlcFree(edt->mshBlkOff);
+  AlcFree(edt->mshBlkNod);
+  AlcFree(edt->mshBlkErr);
+  edt->mshBlkOff = edt->mshBlkNod = NULL;
+  edt->mshBlkErr = NULL;
+  edt->mesh = NULL;
+  box.xMin = box.yMin = box.xMax = box.yMax = 0.0;
+  if(mesh->nNodes > 0)
+  {
+    double	a;
+
+    box.xMin = box.xMax = mesh->nodes[0].position.vtX;
+    box.yMin = box.yMax = mesh->nodes[0].position.vtY;
+    for(idN = 1; idN < mesh->nNodes; ++idN)
+    {
+      WlzDVertex2 p;
+
+      p = mesh->nodes[idN].position;
+      box.xMin = WLZ_MIN(box.xMin, p.vtX);
+      box.xMax = WLZ_MAX(box.xMax, p.vtX);
+      box.yMin = WLZ_MIN(box.yMin, p.vtY);
+      box.yMax = WLZ_MAX(box.yMax, p.vtY);
+    }
+    a = WLZ_MAX(box.xMax - box.xMin, 1.0) * WLZ_MAX(box.yMax - box.yMin, 1.0);
+    h = sqrt(a * WLZ_BASISFN_TPSEDIT_BLK_NOD / mesh->nNodes);
+  }
+  edt->mshBlkSz = h;
+  edt->mshBlkOrg.vtX = box.xMin;
+  edt->mshBlkOrg.vtY = box.yMin;
+  edt->mshBlkCnt.vtX = (int )floor((box.xMax - box.xMin) / h) + 1;
+  edt->mshBlkCnt.vtY = (int )floor((box.yMax - box.yMin) / h) + 1;
+  nBlk = edt->mshBlkCnt.vtX * edt->mshBlkCnt.vtY;
+  if(((edt->mshBlkOff = (int *)AlcCalloc(nBlk + 1, sizeof(int))) == NULL) ||
+     ((edt->mshBlkErr = (double *)AlcCalloc(nBlk, sizeof(double))) == NULL) ||
+     ((edt->mshBlkNod = (int *)AlcMalloc(sizeof(int) *
+                                         WLZ_MAX(mesh->nNodes, 1))) == NULL))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else if((blk = (int *)AlcMalloc(sizeof(int) *
+                                   WLZ_MAX(mesh->nNodes, 1))) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    int		idB;
+
+    /* Counting sort of the nodes by block. */
+    for(idN = 0; idN < mesh->nNodes; ++idN)
+    {
+      int	bX,
+      		bY;
+      WlzDVertex2 p;
+
+      p = mesh->nodes[idN].position;
+      bX = (int )floor((p.vtX - box.xMin) / h);
+      bY = (int )floor((p.vtY - box.yMin) / h);
+      bX = WLZ_MIN(bX, edt->mshBlkCnt.vtX - 1);
+      bY = WLZ_MIN(bY, edt->mshBlkCnt.vtY - 1);
+      blk[idN] = (bY * edt->mshBlkCnt.vtX) + bX;
+      ++(edt->mshBlkOff[blk[idN] + 1]);
+    }
+    for(idB = 0; idB < nBlk; ++idB)
+    {
+      edt->mshBlkOff[idB + 1] += edt->mshBlkOff[idB];
+    }
+    for(idN = 0; idN < mesh->nNodes; ++idN)
+    {
+      edt->mshBlkNod[edt->mshBlkOff[blk[idN]]++] = idN;
+    }
+    for(idB = nBlk; idB > 0; --idB)
+    {
+      edt->mshBlkOff[idB] = edt->mshBlkOff[idB - 1];
+    }
+    edt->mshBlkOff[0] = 0;
+  }
+  AlcFree(blk);
+  return(errNum);
+}
+
+/*!
+* \return	Bound on the change in either component of the
+* 		displacement within the disc.
+* \ingroup	WlzTransform
+* \brief	Computes a bound on the absolute difference between two
+* 		2D thin plate spline basis functions within a disc.
+* 		The difference is written as a sum of terms, one for each
+* 		control point, plus the difference of the polynomials and
+* 		is evaluated at the centre of the disc.
+* 		Terms for control points which are well away from the
+* 		disc are bounded using a third order Taylor expansion
+* 		about the centre of the disc, with the gradient and
+* 		Hessian computed exactly and the third derivative
+* 		bounded. Because the large coefficients of distant control
+* 		points largely cancel this is far tighter than bounding
+* 		the terms individually. Terms for control points near to
+* 		or within the disc are bounded using the maximum gradient
+* 		within the disc.
+* 		Control points which are common to both basis functions
+* 		(these are matched in order, allowing for control points
+* 		having been added, moved or removed) contribute through
+* 		the difference of their coefficients.
+* \param	fn0			First basis function.
+* \param	fn1			Second basis function.
+* \param	ctr			Centre of the disc.
+* \param	rad			Radius of the disc.
+*/
+static double			WlzBasisFnTPSEditBound(
+				  WlzBasisFn *fn0,
+				  WlzBasisFn *fn1,
+				  WlzDVertex2 ctr,
+				  double rad)
+{
+  int		idC,
+  		id0 = 0,
+  		id1 = 0;
+  double	bnd = 0.0;
+  double	d[2],
+  		h[2][3],
+  		n[2],
+		k[2];
+  WlzDVertex2	g[2];
+
+  g[0].vtX = fn0->poly.d2[1].vtX - fn1->poly.d2[1].vtX;
+  g[0].vtY = fn0->poly.d2[2].vtX - fn1->poly.d2[2].vtX;
+  g[1].vtX = fn0->poly.d2[1].vtY - fn1->poly.d2[1].vtY;
+  g[1].vtY = fn0->poly.d2[2].vtY - fn1->poly.d2[2].vtY;
+  d[0] = fn0->poly.d2[0].vtX - fn1->poly.d2[0].vtX +
+         (g[0].vtX * ctr.vtX) + (g[0].vtY * ctr.vtY);
+  d[1] = fn0->poly.d2[0].vtY - fn1->poly.d2[0].vtY +
+         (g[1].vtX * ctr.vtX) + (g[1].vtY * ctr.vtY);
+  for(idC = 0; idC < 2; ++idC)
+  {
+    h[idC][0] = h[idC][1] = h[idC][2] = 0.0;
+    n[idC] = k[idC] = 0.0;
+  }
+  while((id0 < fn0->nVtx) || (id1 < fn1->nVtx))
+  {
+    double	r;
+    double	b[2];
+    WlzDVertex2 t,
+		v;
+
+    if((id0 < fn0->nVtx) && (id1 < fn1->nVtx) &&
+       (WlzGeomCmpVtx2D(fn0->vertices.d2[id0], fn1->vertices.d2[id1],
+                        DBL_EPSILON) == 0))
+    {
+      v = fn0->vertices.d2[id0];
+      b[0] = fn0->basis.d2[id0].vtX - fn1->basis.d2[id1].vtX;
+      b[1] = fn0->basis.d2[id0].vtY - fn1->basis.d2[id1].vtY;
+      ++id0;
+      ++id1;
+    }
+    else if((id1 < fn1->nVtx) &&
+            ((id0 >= fn0->nVtx) ||
+	     ((id1 + 1 < fn1->nVtx) &&
+	      (WlzGeomCmpVtx2D(fn0->vertices.d2[id0],
+	                       fn1->vertices.d2[id1 + 1],
+			       DBL_EPSILON) == 0))))
+    {
+      v = fn1->vertices.d2[id1];
+      b[0] = -(fn1->basis.d2[id1].vtX);
+      b[1] = -(fn1->basis.d2[id1].vtY);
+      ++id1;
+    }
+    else
+    {
+      v = fn0->vertices.d2[id0];
+      b[0] = fn0->basis.d2[id0].vtX;
+      b[1] = fn0->basis.d2[id0].vtY;
+      ++id0;
+    }
+    /* Each term is b f(t) with f(t) = 0.5 r^2 log(r^2) = r^2 log(r),
+     * for which grad f = (2 log(r) + 1) t, the Hessian is
+     * (2 log(r) + 1) I + 2 t t^T / r^2 and the third derivative in
+     * any direction is bounded by 2 sqrt(2) / r. */
+    WLZ_VTX_2_SUB(t, ctr, v);
+    r = WLZ_VTX_2_SQRLEN(t);
+    if(r > DBL_EPSILON)
+    {
+      d[0] += b[0] * 0.5 * r * log(r);
+      d[1] += b[1] * 0.5 * r * log(r);
+    }
+    r = sqrt(r);
+    if(r - rad >= 1.0)
+    {
+      double	f1,
+      		f2,
+		f3;
+
+      f1 = (2.0 * log(r)) + 1.0;
+      f2 = 2.0 / (r * r);
+      f3 = 2.0 * sqrt(2.0) / (r - rad);
+      for(idC = 0; idC < 2; ++idC)
+      {
+	g[idC].vtX += b[idC] * f1 * t.vtX;
+	g[idC].vtY += b[idC] * f1 * t.vtY;
+	h[idC][0] += b[idC] * (f1 + (f2 * t.vtX * t.vtX));
+	h[idC][1] += b[idC] * f2 * t.vtX * t.vtY;
+	h[idC][2] += b[idC] * (f1 + (f2 * t.vtY * t.vtY));
+	k[idC] += fabs(b[idC]) * f3;
+      }
+    }
+    else
+    {
+      double	f1;
+
+      f1 = 0.5 * WlzBasisFnTPSEditDPhiMax(WLZ_MAX(r - rad, 0.0), r + rad);
+      n[0] += fabs(b[0]) * f1;
+      n[1] += fabs(b[1]) * f1;
+    }
+  }
+  for(idC = 0; idC < 2; ++idC)
+  {
+    double	e,
+		s;
+
+    /* Spectral norm of the symmetric Hessian. */
+    e = 0.5 * (h[idC][0] - h[idC][2]);
+    s = (0.5 * fabs(h[idC][0] + h[idC][2])) +
+        sqrt((e * e) + (h[idC][1] * h[idC][1]));
+    e = fabs(d[idC]) + (rad * (WLZ_VTX_2_LENGTH(g[idC]) + n[idC])) +
+        (rad * rad * ((0.5 * s) + (rad * k[idC] / 6.0)));
+    bnd = WLZ_MAX(bnd, e);
+  }
+  return(bnd);
+}
+
+/*!
+* \return	Maximum of \f$|\phi'(r)|\f$ for \f$r_0 \leq r \leq r_1\f$.
+* \ingroup	WlzTransform
+* \brief	Computes the maximum absolute derivative of the thin plate
+* 		spline basis function \f$\phi(r) = r^2 \log(r^2)\f$,
+* 		with \f$\phi'(r) = 2 r (\log(r^2) + 1)\f$, over an interval.
+* 		Within \f$[0, e^{-1/2}]\f$ the derivative is not positive
+* 		with minimum value \f$-4 e^{-3/2}\f$, beyond this it
+* 		increases monotonically.
+* \param	r0			Start of interval, \f$r_0 \geq 0\f$.
+* \param	r1			End of interval, \f$r_1 \geq r_0\f$.
+*/
+static double			WlzBasisFnTPSEditDPhiMax(
+				  double r0,
+				  double r1)
+{
+  double	m0 = 0.0,
+  		m1 = 0.0;
+
+  if(r0 > DBL_EPSILON)
+  {
+    m0 = fabs(2.0 * r0 * ((2.0 * log(r0)) + 1.0));
+  }
+  if(r1 > DBL_EPSILON)
+  {
+    m1 = fabs(2.0 * r1 * ((2.0 * log(r1)) + 1.0));
+  }
+  m0 = WLZ_MAX(m0, m1);
+  if(r0 < exp(-0.5))
+  {
+    m0 = WLZ_MAX(m0, 4.0 * exp(-1.5));
+  }
+  return(m0);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Copies a 2D thin plate spline basis function, reusing the
+* 		destination basis function if it exists.
+* \param	dstFn			Destination basis function pointer.
+* \param	srcFn			Source basis function.
+*/
+static WlzErrorNum		WlzBasisFnTPSEditCopyFn(
+				  WlzBasisFn **dstFn,
+				  WlzBasisFn *srcFn)
+{
+  WlzBasisFn	*fn;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((fn = *dstFn) == NULL)
+  {
+    if(((fn = (WlzBasisFn *)AlcCalloc(1, sizeof(WlzBasisFn))) == NULL) ||
+       ((fn->poly.v = AlcMalloc(3 * sizeof(WlzDVertex2))) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    *dstFn = fn;
+  }
+  if((errNum == WLZ_ERR_NONE) && (fn->maxVx < srcFn->nVtx))
+  {
+    int		max;
+
+    max = srcFn->maxVx;
+    AlcFree(fn->basis.v);
+    AlcFree(fn->vertices.v);
+    fn->maxVx = 0;
+    if(((fn->basis.v = AlcMalloc(max * sizeof(WlzDVertex2))) == NULL) ||
+       ((fn->vertices.v = AlcMalloc(max * sizeof(WlzDVertex2))) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      fn->maxVx = max;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    fn->type = srcFn->type;
+    fn->nPoly = srcFn->nPoly;
+    fn->nBasis = srcFn->nBasis;
+    fn->nVtx = srcFn->nVtx;
+    (void )memcpy(fn->poly.v, srcFn->poly.v, 3 * sizeof(WlzDVertex2));
+    (void )memcpy(fn->basis.v, srcFn->basis.v,
+                  srcFn->nVtx * sizeof(WlzDVertex2));
+    (void )memcpy(fn->vertices.v, srcFn->vertices.v,
+                  srcFn->nVtx * sizeof(WlzDVertex2));
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Makes sure that there is space for the given number of
+* 		control points, preserving the inverse design matrix and
+* 		control points. All of the new arrays are allocated
+* 		before any are committed, so that on error the editable
+* 		transform is unchanged.
+* \param	edt			Given editable transform.
+* \param	nVtx			Required number of control points.
+*/
+static WlzErrorNum		WlzBasisFnTPSEditReserve(
+				  WlzBasisFnTPS2DEdit *edt,
+				  int nVtx)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(nVtx > edt->maxVtx)
+  {
+    int		idI,
+    		max,
+    		mSz;
+    size_t	vSz;
+    double	*buf = NULL;
+    double	**aI = NULL;
+    WlzDVertex2	*dVx = NULL,
+    		*sVx = NULL,
+		*nVx = NULL,
+		*fBs = NULL,
+		*fVx = NULL;
+    WlzBasisFn	*fn;
+
+    max = WLZ_MAX(2 * edt->maxVtx, nVtx + 16);
+    mSz = max + 3;
+    vSz = max * sizeof(WlzDVertex2);
+    fn = edt->basisTr->basisFn;
+    if((AlcDouble2Malloc(&aI, mSz, mSz) != ALC_ER_NONE) ||
+       ((buf = (double *)AlcMalloc(6 * mSz * sizeof(double))) == NULL) ||
+       ((dVx = (WlzDVertex2 *)AlcMalloc(vSz)) == NULL) ||
+       ((sVx = (WlzDVertex2 *)AlcMalloc(vSz)) == NULL) ||
+       ((nVx = (WlzDVertex2 *)AlcMalloc(vSz)) == NULL) ||
+       ((fBs = (WlzDVertex2 *)AlcMalloc(vSz)) == NULL) ||
+       ((fVx = (WlzDVertex2 *)AlcMalloc(vSz)) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+      if(aI)
+      {
+        (void )AlcDouble2Free(aI);
+      }
+      AlcFree(buf);
+      AlcFree(dVx);
+      AlcFree(sVx);
+      AlcFree(nVx);
+      AlcFree(fBs);
+    }
+    else
+    {
+      if(edt->nVtx > 0)
+      {
+        (void )memcpy(dVx, edt->dVx, edt->nVtx * sizeof(WlzDVertex2));
+        (void )memcpy(sVx, edt->sVx, edt->nVtx * sizeof(WlzDVertex2));
+        (void )memcpy(nVx, edt->nVx, edt->nVtx * sizeof(WlzDVertex2));
+      }
+      if(fn->nVtx > 0)
+      {
+        (void )memcpy(fBs, fn->basis.v, fn->nVtx * sizeof(WlzDVertex2));
+        (void )memcpy(fVx, fn->vertices.v, fn->nVtx * sizeof(WlzDVertex2));
+      }
+      if(edt->aI)
+      {
+	int	m;
+
+	m = edt->nVtx + 3;
+	for(idI = 0; idI < m; ++idI)
+	{
+	  (void )memcpy(aI[idI], edt->aI[idI], m * sizeof(double));
+	}
+	(void )AlcDouble2Free(edt->aI);
+      }
+      AlcFree(edt->buf);
+      AlcFree(edt->dVx);
+      AlcFree(edt->sVx);
+      AlcFree(edt->nVx);
+      AlcFree(fn->basis.v);
+      AlcFree(fn->vertices.v);
+      edt->aI = aI;
+      edt->buf = buf;
+      edt->dVx = dVx;
+      edt->sVx = sVx;
+      edt->nVx = nVx;
+      fn->basis.v = fBs;
+      fn->vertices.v = fVx;
+      edt->maxVtx = max;
+      fn->maxVx = max;
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Builds the design matrix and computes its inverse.
+* \param	edt			Given editable transform.
+*/
+static WlzErrorNum		WlzBasisFnTPSEditFactor(
+				  WlzBasisFnTPS2DEdit *edt)
+{
+  int		idI,
+  		m;
+  int		*iV = NULL;
+  double	**aLU = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  m = edt->nVtx + 3;
+  if(((iV = (int *)AlcMalloc(m * sizeof(int))) == NULL) ||
+     (AlcDouble2Malloc(&aLU, m, m) != ALC_ER_NONE))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    for(idI = 0; idI < 3; ++idI)
+    {
+      aLU[idI][0] = aLU[idI][1] = aLU[idI][2] = 0.0;
+    }
+#ifdef _OPENMP
+#pragma omp parallel for if(m >= 256)
+#endif
+    for(idI = 0; idI < edt->nVtx; ++idI)
+    {
+      WlzBasisFnTPSEditBorder(edt, edt->nVx[idI], idI, aLU[idI + 3]);
+      aLU[0][idI + 3] = 1.0;
+      aLU[1][idI + 3] = edt->nVx[idI].vtX;
+      aLU[2][idI + 3] = edt->nVx[idI].vtY;
+    }
+    errNum = WlzErrorFromAlg(AlgMatrixLUDecompRaw(aLU, m, iV, NULL));
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    /* The design matrix is symmetric so each row of its inverse is
+     * found by solving for the corresponding column. */
+#ifdef _OPENMP
+#pragma omp parallel for if(m >= 256)
+#endif
+    for(idI = 0; idI < m; ++idI)
+    {
+      double	*aIR;
+
+      aIR = edt->aI[idI];
+      (void )memset(aIR, 0, m * sizeof(double));
+      aIR[idI] = 1.0;
+      (void )AlgMatrixLUBackSubRaw(aLU, m, iV, aIR);
+    }
+  }
+  AlcFree(iV);
+  if(aLU)
+  {
+    (void )AlcDouble2Free(aLU);
+  }
+  edt->nUpd = 0;
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Computes a full solution for the editable transform.
+* \param	edt			Given editable transform.
+*/
+static WlzErrorNum		WlzBasisFnTPSEditSolveFactor(
+				  WlzBasisFnTPS2DEdit *edt)
+{
+  WlzErrorNum	errNum;
+
+  errNum = WlzBasisFnTPSEditFactor(edt);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = WlzBasisFnTPSEditSolve(edt);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Solves for the basis function and polynomial coefficients
+* 		using the inverse design matrix, checks the residuals at
+* 		the control points and, if these are too large, applies
+* 		iterative refinement. If the residuals remain too large
+* 		following low rank updates the inverse design matrix is
+* 		recomputed and the solution found again. The coefficients
+* 		are then set in the basis function transform.
+* \param	edt			Given editable transform.
+*/
+static WlzErrorNum		WlzBasisFnTPSEditSolve(
+				  WlzBasisFnTPS2DEdit *edt)
+{
+  int		m,
+  		n,
+		idI,
+		nRef = 0,
+		slv = 1,
+		ok = 0;
+  double	bMax = 0.0;
+  double	*bX,
+  		*bY,
+		*vX,
+		*vY,
+		*rX,
+		*rY;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  n = edt->nVtx;
+  m = n + 3;
+  bX = edt->buf;
+  bY = edt->buf + (edt->maxVtx + 3);
+  vX = edt->buf + (2 * (edt->maxVtx + 3));
+  vY = edt->buf + (3 * (edt->maxVtx + 3));
+  rX = edt->buf + (4 * (edt->maxVtx + 3));
+  rY = edt->buf + (5 * (edt->maxVtx + 3));
+  bX[0] = bX[1] = bX[2] = 0.0;
+  bY[0] = bY[1] = bY[2] = 0.0;
+  for(idI = 0; idI < n; ++idI)
+  {
+    bX[idI + 3] = edt->sVx[idI].vtX - edt->dVx[idI].vtX;
+    bY[idI + 3] = edt->sVx[idI].vtY - edt->dVx[idI].vtY;
+    bMax = WLZ_MAX(bMax, WLZ_MAX(fabs(bX[idI + 3]), fabs(bY[idI + 3])));
+  }
+  while((errNum == WLZ_ERR_NONE) && !ok)
+  {
+    double	rMax = 0.0;
+
+    if(slv)
+    {
+      slv = 0;
+#ifdef _OPENMP
+#pragma omp parallel for if(m >= 256)
+#endif
+      for(idI = 0; idI < m; ++idI)
+      {
+	int	idJ;
+	double	sX = 0.0,
+		sY = 0.0;
+	double	*aIR;
+
+	aIR = edt->aI[idI];
+	for(idJ = 0; idJ < m; ++idJ)
+	{
+	  sX += aIR[idJ] * bX[idJ];
+	  sY += aIR[idJ] * bY[idJ];
+	}
+	vX[idI] = sX;
+	vY[idI] = sY;
+      }
+    }
+    /* Residuals of the design equation, with the design matrix
+     * computed on the fly. */
+#ifdef _OPENMP
+#pragma omp parallel for if(m >= 256)
+#endif
+    for(idI = 0; idI < m; ++idI)
+    {
+      int	idJ;
+      double	sX,
+      		sY;
+
+      if(idI < 3)
+      {
+	sX = sY = 0.0;
+	for(idJ = 0; idJ < n; ++idJ)
+	{
+	  double p;
+
+	  p = (idI == 0)? 1.0: (idI == 1)? edt->nVx[idJ].vtX:
+	                                   edt->nVx[idJ].vtY;
+	  sX += p * vX[idJ + 3];
+	  sY += p * vY[idJ + 3];
+	}
+      }
+      else
+      {
+	WlzDVertex2 u;
+
+	u = edt->nVx[idI - 3];
+	sX = vX[0] + (vX[1] * u.vtX) + (vX[2] * u.vtY) - bX[idI];
+	sY = vY[0] + (vY[1] * u.vtX) + (vY[2] * u.vtY) - bY[idI];
+	for(idJ = 0; idJ < n; ++idJ)
+	{
+	  double phi;
+
+	  phi = WlzBasisFnTPSEditPhi(u, edt->nVx[idJ]);
+	  sX += phi * vX[idJ + 3];
+	  sY += phi * vY[idJ + 3];
+	}
+      }
+      rX[idI] = sX;
+      rY[idI] = sY;
+    }
+    for(idI = 0; idI < m; ++idI)
+    {
+      rMax = WLZ_MAX(rMax, WLZ_MAX(fabs(rX[idI]), fabs(rY[idI])));
+    }
+    ok = rMax <= WLZ_BASISFN_TPSEDIT_RES_TOL * (bMax + 1.0);
+    if(!ok)
+    {
+      if(nRef < WLZ_BASISFN_TPSEDIT_MAX_REF)
+      {
+	/* Iterative refinement using the inverse. */
+#ifdef _OPENMP
+#pragma omp parallel for if(m >= 256)
+#endif
+	for(idI = 0; idI < m; ++idI)
+	{
+	  int	idJ;
+	  double sX = 0.0,
+		 sY = 0.0;
+	  double *aIR;
+
+	  aIR = edt->aI[idI];
+	  for(idJ = 0; idJ < m; ++idJ)
+	  {
+	    sX += aIR[idJ] * rX[idJ];
+	    sY += aIR[idJ] * rY[idJ];
+	  }
+	  vX[idI] -= sX;
+	  vY[idI] -= sY;
+	}
+	++nRef;
+      }
+      else if(edt->nUpd > 0)
+      {
+	errNum = WlzBasisFnTPSEditFactor(edt);
+	nRef = 0;
+	slv = 1;
+      }
+      else
+      {
+	/* A fresh inverse is as good as can be done. */
+	ok = 1;
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    double	r2,
+    		s,
+		cX = 0.0,
+		cY = 0.0;
+    WlzBasisFn	*fn;
+
+    /* Convert the coefficients from normalised to the original
+     * coordinates, see WlzBasisFnTPS2DFromCPts(). */
+    fn = edt->basisTr->basisFn;
+    fn->nVtx = n;
+    fn->nBasis = n;
+    r2 = edt->range * edt->range;
+    s = 2.0 / r2;
+    for(idI = 0; idI < n; ++idI)
+    {
+      double	q;
+      WlzDVertex2 t;
+
+      fn->vertices.d2[idI] = edt->dVx[idI];
+      fn->basis.d2[idI].vtX = vX[idI + 3] * s;
+      fn->basis.d2[idI].vtY = vY[idI + 3] * s;
+      WLZ_VTX_2_SUB(t, edt->dVx[idI], edt->org);
+      q = WLZ_VTX_2_SQRLEN(t);
+      cX += vX[idI + 3] * q;
+      cY += vY[idI + 3] * q;
+    }
+    cX *= log(r2) / r2;
+    cY *= log(r2) / r2;
+    fn->poly.d2[1].vtX = vX[1] / edt->range;
+    fn->poly.d2[2].vtX = vX[2] / edt->range;
+    fn->poly.d2[0].vtX = vX[0] - cX -
+                         (fn->poly.d2[1].vtX * edt->org.vtX) -
+                         (fn->poly.d2[2].vtX * edt->org.vtY);
+    fn->poly.d2[1].vtY = vY[1] / edt->range;
+    fn->poly.d2[2].vtY = vY[2] / edt->range;
+    fn->poly.d2[0].vtY = vY[0] - cY -
+                         (fn->poly.d2[1].vtY * edt->org.vtX) -
+                         (fn->poly.d2[2].vtY * edt->org.vtY);
+  }
+  return(errNum);
+}
+
+/*!
+* \ingroup	WlzTransform
+* \brief	Computes a row of the design matrix for a control point at
+* 		the given normalised position.
+* \param	edt			Given editable transform.
+* \param	u			Normalised control point position.
+* \param	self			Index of the control point if it is
+* 					one of the current control points
+* 					otherwise -1.
+* \param	a			Destination for the nVtx + 3 values
+* 					of the row.
+*/
+static void			WlzBasisFnTPSEditBorder(
+				  WlzBasisFnTPS2DEdit *edt,
+				  WlzDVertex2 u,
+				  int self,
+				  double *a)
+{
+  int		idJ;
+
+  a[0] = 1.0;
+  a[1] = u.vtX;
+  a[2] = u.vtY;
+  for(idJ = 0; idJ < edt->nVtx; ++idJ)
+  {
+    a[idJ + 3] = (idJ == self)? 0.0: WlzBasisFnTPSEditPhi(u, edt->nVx[idJ]);
+  }
+}
+
+/*!
+* \ingroup	WlzTransform
+* \brief	Multiplies the given vector by the inverse design matrix.
+* \param	edt			Given editable transform.
+* \param	a			Given vector of nVtx + 3 values.
+* \param	w			Destination vector of nVtx + 3 values.
+*/
+static void			WlzBasisFnTPSEditMatVec(
+				  WlzBasisFnTPS2DEdit *edt,
+				  double *a,
+				  double *w)
+{
+  int		idI,
+  		m;
+
+  m = edt->nVtx + 3;
+#ifdef _OPENMP
+#pragma omp parallel for if(m >= 256)
+#endif
+  for(idI = 0; idI < m; ++idI)
+  {
+    int		idJ;
+    double	s = 0.0;
+    double	*aIR;
+
+    aIR = edt->aI[idI];
+    for(idJ = 0; idJ < m; ++idJ)
+    {
+      s += aIR[idJ] * a[idJ];
+    }
+    w[idI] = s;
+  }
+}
+
+/*!
+* \return	Value of the thin plate spline basis function.
+* \ingroup	WlzTransform
+* \brief	Computes the thin plate spline basis function
+* 		\f$r^2 \log(r^2)\f$ for the given normalised positions.
+* \param	u0			First normalised position.
+* \param	u1			Second normalised position.
+*/
+static double			WlzBasisFnTPSEditPhi(
+				  WlzDVertex2 u0,
+				  WlzDVertex2 u1)
+{
+  double	r2;
+  WlzDVertex2	t;
+
+  WLZ_VTX_2_SUB(t, u0, u1);
+  r2 = WLZ_VTX_2_SQRLEN(t);
+  return((r2 > DBL_EPSILON)? r2 * log(r2): 0.0);
+}
+
+/*!
+* \return	Normalised position.
+* \ingroup	WlzTransform
+* \brief	Normalises a control point position.
+* \param	edt			Given editable transform.
+* \param	p			Given position.
+*/
+static WlzDVertex2		WlzBasisFnTPSEditNrm(
+				  WlzBasisFnTPS2DEdit *edt,
+				  WlzDVertex2 p)
+{
+  WlzDVertex2	u;
+
+  u.vtX = (p.vtX - edt->org.vtX) / edt->range;
+  u.vtY = (p.vtY - edt->org.vtY) / edt->range;
+  return(u);
+}
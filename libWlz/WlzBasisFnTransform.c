@@ -393,6 +393,9 @@ WlzBasisFnTransform *WlzBasisFnTrFromCPts3DParam(WlzFnType type,
 *		distances are used then there is no benefit in using this
 *		function as opposed to WlzBasisFnTPS2DFromCPts().
 *		The full list of control points must be given.
+*		For interactive editing of transforms using Euclidean
+*		distances see WlzBasisFnTPS2DEditNew(), which updates the
+*		existing solution rather than recomputing it.
 * \param	basisTr			Existing basis function transform.
 * \param	nDPts			Number of destination control points.
 * \param	dPts			Destination control points.
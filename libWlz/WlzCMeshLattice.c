@@ -0,0 +1,1755 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzCMeshLattice_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         libWlz/WlzCMeshLattice.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Lattices for fast point location within conforming
+* 		mesh transforms which have elements aligned with a
+* 		regular lattice, such as those made from the balanced
+* 		linear binary tree domains of WlzCMeshFromObj2D()
+* 		and WlzCMeshFromObj3D().
+* \ingroup	WlzTransform
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include <Wlz.h>
+
+/*!
+* \def		WLZ_CMESH_LAT_MAX_LVL
+* \ingroup	WlzTransform
+* \brief	Maximum number of lattice levels.
+*/
+#define WLZ_CMESH_LAT_MAX_LVL	(24)
+
+/*!
+* \def		WLZ_CMESH_LAT_POS_TOL
+* \ingroup	WlzTransform
+* \brief	Tolerance for node positions relative to the lattice
+* 		cell size.
+*/
+#define WLZ_CMESH_LAT_POS_TOL	(1.0e-6)
+
+/*!
+* \def		WLZ_CMESH_LAT_VOL_TOL
+* \ingroup	WlzTransform
+* \brief	Relative tolerance for the area or volume of a complete
+* 		lattice cell.
+*/
+#define WLZ_CMESH_LAT_VOL_TOL	(1.0e-6)
+
+/*!
+* \def		WLZ_CMESH_LAT_BC_TOL
+* \ingroup	WlzTransform
+* \brief	Tolerance for barycentric coordinates when testing
+* 		whether a point is within an element.
+*/
+#define WLZ_CMESH_LAT_BC_TOL	(1.0e-9)
+
+/*!
+* \def		WLZ_CMESH_LAT_CACHE_NOD
+* \ingroup	WlzTransform
+* \brief	Maximum number of mesh nodes per transformed vertex for
+* 		which the lattice cache is used.
+*/
+#define WLZ_CMESH_LAT_CACHE_NOD	(4)
+
+/*!
+* \struct	_WlzCMeshLatRec
+* \ingroup	WlzTransform
+* \brief	Record of either an element or a sub cell within a lattice
+* 		cell, used while building the lattice from the finest
+* 		level upwards.
+*/
+typedef struct _WlzCMeshLatRec
+{
+  int		cel[3];		/*!< Cell indices at the current level. */
+  int		oct;		/*!< Position of the sub cell within the
+  				     cell, only used for sub cells. */
+  int		elm;		/*!< Element table index or -1 for a sub
+  				     cell. */
+  int		nod;		/*!< Tree node of a sub cell or -1. */
+  double	vol;		/*!< Element area or volume, or for a sub
+  				     cell the area or volume of it within
+				     complete cells. */
+} WlzCMeshLatRec;
+
+/*!
+* \struct	_WlzCMeshLatWSp
+* \ingroup	WlzTransform
+* \brief	Workspace used while building a lattice.
+*/
+typedef struct _WlzCMeshLatWSp
+{
+  int		dim;		/*!< Dimension, 2 or 3. */
+  int		nChd;		/*!< Number of sub cells per cell. */
+  int		maxNod;		/*!< Number of tree nodes allocated. */
+  int		nLeaf;		/*!< Number of leaf list entries used. */
+  int		maxLeaf;	/*!< Number of leaf list entries
+  				     allocated. */
+  int		*lvl;		/*!< Level of each element, this being
+  				     the lowest level at which it is
+				     within a single cell or -1. */
+  double	*vol;		/*!< Area or volume of each element. */
+  WlzDBox3	*box;		/*!< Bounding box of each element. */
+  WlzDVertex3	*ref;		/*!< First node of each element. */
+  double	*ext;		/*!< Maximum extent of each element. */
+  int		*mul;		/*!< Non-zero if all node positions of an
+  				     element are multiples of half its
+				     maximum extent from its first node. */
+} WlzCMeshLatWSp;
+
+static int			WlzCMeshLatHalf(
+				  int i);
+static int			WlzCMeshLatElmCell(
+				  WlzCMeshLatWSp *wSp,
+				  WlzDVertex3 org,
+				  double h,
+				  int idE,
+				  int *cel);
+static int			WlzCMeshLatRecCmp(
+				  const void *p0,
+				  const void *p1);
+static int			WlzCMeshLatDblCmp(
+				  const void *p0,
+				  const void *p1);
+static int			WlzCMeshLatNodNew(
+				  WlzCMeshLattice *lat,
+				  WlzCMeshLatWSp *wSp,
+				  WlzErrorNum *dstErr);
+static int			WlzCMeshLatLeafNew(
+				  WlzCMeshLattice *lat,
+				  WlzCMeshLatWSp *wSp,
+				  WlzCMeshLatRec *rec,
+				  int nRec,
+				  double *dstVol,
+				  WlzErrorNum *dstErr);
+static double			WlzCMeshLatCellSz(
+				  WlzCMeshLattice *lat,
+				  WlzCMeshLatWSp *wSp);
+static WlzDVertex3		WlzCMeshLatOrg(
+				  WlzCMeshLattice *lat,
+				  WlzCMeshLatWSp *wSp,
+				  int nLvl);
+static WlzErrorNum		WlzCMeshLatElmTab2D(
+				  WlzCMeshLattice *lat,
+				  WlzCMeshLatWSp *wSp,
+				  WlzObject *mObj);
+static WlzErrorNum		WlzCMeshLatElmTab3D(
+				  WlzCMeshLattice *lat,
+				  WlzCMeshLatWSp *wSp,
+				  WlzObject *mObj);
+static WlzErrorNum		WlzCMeshLatBuild(
+				  WlzCMeshLattice *lat,
+				  WlzCMeshLatWSp *wSp,
+				  double cellSz);
+static WlzErrorNum		WlzCMeshLatCacheKey(
+				  WlzCMeshLatticeCache *cache,
+				  WlzObject *mObj,
+				  int *dstMatch);
+
+/*!
+* \return	New lattice or NULL on error.
+* \ingroup	WlzTransform
+* \brief	Builds a lattice for fast point location within the given
+* 		2D or 3D conforming mesh transform. The elements of the
+* 		mesh are placed in the cells of a regular lattice of
+* 		square (2D) or cubic (3D) cells with side lengths
+* 		\f$c 2^l\f$ at levels \f$l = 0, 1, \ldots\f$, each element
+* 		being placed in the smallest cell which encloses it.
+* 		Cells which are exactly covered by elements are complete
+* 		and within these the element enclosing a point can be
+* 		found using only index arithmetic and a few barycentric
+* 		coordinate tests. The affine transform of each element
+* 		is computed from the mesh displacements when the lattice
+* 		is built, so the lattice must be rebuilt if the
+* 		displacements are changed.
+* 		Meshes which are not aligned with a lattice, for example
+* 		after mesh smoothing, simply give a lattice with few or
+* 		no complete cells: the lattice is then of little use but
+* 		remains correct.
+* \param	mObj			Given 2D or 3D conforming mesh
+* 					transform object, which may have
+* 					NULL values for an identity
+* 					transform.
+* \param	cellSz			Side length of the level zero cells,
+* 					if not greater than zero the cell
+* 					size is found from the mesh elements.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzCMeshLattice			*WlzCMeshLatticeNew(
+				  WlzObject *mObj,
+				  double cellSz,
+				  WlzErrorNum *dstErr)
+{
+  int		nC = 0,
+  		maxElm = 0;
+  WlzCMeshLatWSp wSp;
+  WlzCMeshLattice *lat = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  (void )memset(&wSp, 0, sizeof(WlzCMeshLatWSp));
+  if(mObj == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if(mObj->domain.core == NULL)
+  {
+    errNum = WLZ_ERR_DOMAIN_NULL;
+  }
+  else if((mObj->values.core != NULL) &&
+          (mObj->values.core->type != WLZ_INDEXED_VALUES))
+  {
+    errNum = WLZ_ERR_VALUES_TYPE;
+  }
+  else
+  {
+    switch(mObj->type)
+    {
+      case WLZ_CMESH_2D:
+	wSp.dim = 2;
+	nC = 6;
+	maxElm = mObj->domain.cm2->res.elm.maxEnt;
+        break;
+      case WLZ_CMESH_3D:
+	wSp.dim = 3;
+	nC = 12;
+	maxElm = mObj->domain.cm3->res.elm.maxEnt;
+        break;
+      default:
+        errNum = WLZ_ERR_OBJECT_TYPE;
+	break;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		n;
+
+    n = WLZ_MAX(maxElm, 1);
+    wSp.nChd = 1 << wSp.dim;
+    if(((lat = (WlzCMeshLattice *)
+               AlcCalloc(1, sizeof(WlzCMeshLattice))) == NULL) ||
+       ((lat->elmIdx = (int *)AlcMalloc(sizeof(int) * n)) == NULL) ||
+       ((lat->elmBC = (double *)AlcMalloc(sizeof(double) * nC * n)) == NULL) ||
+       ((lat->elmTr = (double *)AlcMalloc(sizeof(double) * nC * n)) == NULL) ||
+       ((wSp.lvl = (int *)AlcMalloc(sizeof(int) * n)) == NULL) ||
+       ((wSp.mul = (int *)AlcMalloc(sizeof(int) * n)) == NULL) ||
+       ((wSp.vol = (double *)AlcMalloc(sizeof(double) * n)) == NULL) ||
+       ((wSp.ext = (double *)AlcMalloc(sizeof(double) * n)) == NULL) ||
+       ((wSp.box = (WlzDBox3 *)AlcMalloc(sizeof(WlzDBox3) * n)) == NULL) ||
+       ((wSp.ref = (WlzDVertex3 *)AlcMalloc(sizeof(WlzDVertex3) * n)) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      lat->type = mObj->type;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = (wSp.dim == 2)? WlzCMeshLatElmTab2D(lat, &wSp, mObj):
+                             WlzCMeshLatElmTab3D(lat, &wSp, mObj);
+  }
+  if((errNum == WLZ_ERR_NONE) && (lat->nElm > 0))
+  {
+    errNum = WlzCMeshLatBuild(lat, &wSp, cellSz);
+  }
+  AlcFree(wSp.lvl);
+  AlcFree(wSp.mul);
+  AlcFree(wSp.vol);
+  AlcFree(wSp.ext);
+  AlcFree(wSp.box);
+  AlcFree(wSp.ref);
+  if(errNum != WLZ_ERR_NONE)
+  {
+    (void )WlzCMeshLatticeFree(lat);
+    lat = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(lat);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Frees a lattice created by WlzCMeshLatticeNew().
+* \param	lat			Given lattice, may be NULL.
+*/
+WlzErrorNum			WlzCMeshLatticeFree(
+				  WlzCMeshLattice *lat)
+{
+  if(lat)
+  {
+    AlcFree(lat->top);
+    AlcFree(lat->nod);
+    AlcFree(lat->leaf);
+    AlcFree(lat->elmIdx);
+    AlcFree(lat->elmBC);
+    AlcFree(lat->elmTr);
+    AlcFree(lat);
+  }
+  return(WLZ_ERR_NONE);
+}
+
+/*!
+* \return	Cached lattice or NULL if there is no lattice for the
+* 		mesh transform.
+* \ingroup	WlzTransform
+* \brief	Gets the lattice cached with the displacements of the
+* 		given mesh transform, building it if required.
+* 		The cache is compared with the mesh nodes and
+* 		displacements and is reset if either has changed.
+* 		A lattice is only built once the number of vertices
+* 		transformed since the cache was reset, including the
+* 		given number, reaches the number of mesh elements,
+* 		because until then a general search of the mesh is
+* 		cheaper. Comparing the cache costs about as much as
+* 		transforming a few vertices per mesh node, so NULL is
+* 		returned without using the cache when the given number
+* 		of vertices is small compared with the number of nodes.
+* 		The returned lattice is owned by the cache and must not
+* 		be freed. It remains valid until the mesh or its
+* 		displacements are changed. The cache is accessed in an
+* 		OpenMP critical section, so this function may be called
+* 		concurrently for the same mesh transform.
+* \param	mObj			Given 2D or 3D conforming mesh
+* 					transform object. No lattice is
+* 					cached for NULL values.
+* \param	nVtx			Number of vertices that are to be
+* 					transformed.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzCMeshLattice			*WlzCMeshLatticeCached(
+				  WlzObject *mObj,
+				  int nVtx,
+				  WlzErrorNum *dstErr)
+{
+  int		nNod = 0,
+  		nElm = 0;
+  WlzIndexedValues *ixv = NULL;
+  WlzCMeshLattice *lat = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(mObj == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if(mObj->domain.core == NULL)
+  {
+    errNum = WLZ_ERR_DOMAIN_NULL;
+  }
+  else if((mObj->values.core != NULL) &&
+          (mObj->values.core->type != WLZ_INDEXED_VALUES))
+  {
+    errNum = WLZ_ERR_VALUES_TYPE;
+  }
+  else
+  {
+    ixv = mObj->values.x;
+    switch(mObj->type)
+    {
+      case WLZ_CMESH_2D:
+	nNod = mObj->domain.cm2->res.nod.maxEnt;
+	nElm = mObj->domain.cm2->res.elm.numEnt;
+        break;
+      case WLZ_CMESH_3D:
+	nNod = mObj->domain.cm3->res.nod.maxEnt;
+	nElm = mObj->domain.cm3->res.elm.numEnt;
+        break;
+      default:
+        errNum = WLZ_ERR_OBJECT_TYPE;
+	break;
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (ixv != NULL) && (nVtx > 0) &&
+     (nVtx >= nNod / WLZ_CMESH_LAT_CACHE_NOD))
+  {
+#ifdef _OPENMP
+#pragma omp critical (WlzCMeshLatticeCache)
+#endif
+    {
+      int	match = 0;
+      WlzCMeshLatticeCache *cache;
+
+      if((cache = ixv->latCache) == NULL)
+      {
+	if((cache = (WlzCMeshLatticeCache *)
+		    AlcCalloc(1, sizeof(WlzCMeshLatticeCache))) == NULL)
+	{
+	  errNum = WLZ_ERR_MEM_ALLOC;
+	}
+	else
+	{
+	  ixv->latCache = cache;
+	}
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+	(void )WlzCMeshLatCacheKey(cache, mObj, &match);
+	if(!match)
+	{
+	  (void )WlzCMeshLatticeFree(cache->lat);
+	  cache->lat = NULL;
+	  cache->nVtx = 0;
+	  errNum = WlzCMeshLatCacheKey(cache, mObj, NULL);
+	}
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+	cache->nVtx = (nVtx > INT_MAX - cache->nVtx)?
+		      INT_MAX: cache->nVtx + nVtx;
+	if((cache->lat == NULL) && (cache->nVtx >= nElm))
+	{
+	  cache->lat = WlzCMeshLatticeNew(mObj, 0.0, &errNum);
+	}
+	lat = cache->lat;
+      }
+    }
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(lat);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Frees a lattice cache along with its lattice.
+* \param	cache			Given lattice cache, may be NULL.
+*/
+WlzErrorNum			WlzCMeshLatticeCacheFree(
+				  WlzCMeshLatticeCache *cache)
+{
+  if(cache)
+  {
+    (void )WlzCMeshLatticeFree(cache->lat);
+    AlcFree(cache->key);
+    AlcFree(cache);
+  }
+  return(WLZ_ERR_NONE);
+}
+
+/*!
+* \return	Index into the lattice element tables of an element which
+* 		encloses the given position or -1 if the position is not
+* 		within a complete lattice cell.
+* \ingroup	WlzTransform
+* \brief	Locates the element of a 2D lattice which encloses the
+* 		given position. A return value of -1 does not imply that
+* 		the position is outside of the mesh, only that a general
+* 		mesh search is required.
+* \param	lat			Given 2D lattice.
+* \param	pos			Given position.
+*/
+int				WlzCMeshLatticeLocate2D(
+				  WlzCMeshLattice *lat,
+				  WlzDVertex2 pos)
+{
+  int		idE = -1;
+
+  if(lat && (lat->nLvl > 0))
+  {
+    int		iX,
+    		iY;
+    double	h,
+    		fX,
+    		fY;
+
+    h = ldexp(lat->cellSz, lat->nLvl - 1);
+    fX = (pos.vtX - lat->org.vtX) / h;
+    fY = (pos.vtY - lat->org.vtY) / h;
+    iX = (int )floor(fX);
+    iY = (int )floor(fY);
+    fX -= iX;
+    fY -= iY;
+    iX -= lat->tOff.vtX;
+    iY -= lat->tOff.vtY;
+    if((iX >= 0) && (iX < lat->tSz.vtX) && (iY >= 0) && (iY < lat->tSz.vtY))
+    {
+      int	n,
+      		lf = -1;
+
+      n = lat->top[(iY * lat->tSz.vtX) + iX];
+      while(n >= 0)
+      {
+	int	o = 0;
+	int	*b;
+
+        b = lat->nod + (n * 5);
+	if(b[0] >= 0)
+	{
+	  lf = b[0];
+	}
+	fX *= 2.0;
+	fY *= 2.0;
+	if(fX >= 1.0)
+	{
+	  fX -= 1.0;
+	  o |= 1;
+	}
+	if(fY >= 1.0)
+	{
+	  fY -= 1.0;
+	  o |= 2;
+	}
+	n = b[1 + o];
+      }
+      if(lf >= 0)
+      {
+	int	idL,
+		nL;
+	const int *l;
+
+	l = lat->leaf + lf;
+	nL = *l++;
+	for(idL = 0; idL < nL; ++idL)
+	{
+	  double dX,
+	  	 dY,
+		 l1,
+		 l2;
+	  const double *bc;
+
+	  bc = lat->elmBC + (6 * l[idL]);
+	  dX = pos.vtX - bc[4];
+	  dY = pos.vtY - bc[5];
+	  l1 = (bc[0] * dX) + (bc[1] * dY);
+	  l2 = (bc[2] * dX) + (bc[3] * dY);
+	  if((l1 >= -WLZ_CMESH_LAT_BC_TOL) && (l2 >= -WLZ_CMESH_LAT_BC_TOL) &&
+	     (1.0 - l1 - l2 >= -WLZ_CMESH_LAT_BC_TOL))
+	  {
+	    idE = l[idL];
+	    break;
+	  }
+	}
+      }
+    }
+  }
+  return(idE);
+}
+
+/*!
+* \return	Index into the lattice element tables of an element which
+* 		encloses the given position or -1 if the position is not
+* 		within a complete lattice cell.
+* \ingroup	WlzTransform
+* \brief	Locates the element of a 3D lattice which encloses the
+* 		given position. A return value of -1 does not imply that
+* 		the position is outside of the mesh, only that a general
+* 		mesh search is required.
+* \param	lat			Given 3D lattice.
+* \param	pos			Given position.
+*/
+int				WlzCMeshLatticeLocate3D(
+				  WlzCMeshLattice *lat,
+				  WlzDVertex3 pos)
+{
+  int		idE = -1;
+
+  if(lat && (lat->nLvl > 0))
+  {
+    int		iX,
+    		iY,
+		iZ;
+    double	h,
+    		fX,
+    		fY,
+		fZ;
+
+    h = ldexp(lat->cellSz, lat->nLvl - 1);
+    fX = (pos.vtX - lat->org.vtX) / h;
+    fY = (pos.vtY - lat->org.vtY) / h;
+    fZ = (pos.vtZ - lat->org.vtZ) / h;
+    iX = (int )floor(fX);
+    iY = (int )floor(fY);
+    iZ = (int )floor(fZ);
+    fX -= iX;
+    fY -= iY;
+    fZ -= iZ;
+    iX -= lat->tOff.vtX;
+    iY -= lat->tOff.vtY;
+    iZ -= lat->tOff.vtZ;
+    if((iX >= 0) && (iX < lat->tSz.vtX) && (iY >= 0) && (iY < lat->tSz.vtY) &&
+       (iZ >= 0) && (iZ < lat->tSz.vtZ))
+    {
+      int	n,
+      		lf = -1;
+
+      n = lat->top[(((iZ * lat->tSz.vtY) + iY) * lat->tSz.vtX) + iX];
+      while(n >= 0)
+      {
+	int	o = 0;
+	int	*b;
+
+        b = lat->nod + (n * 9);
+	if(b[0] >= 0)
+	{
+	  lf = b[0];
+	}
+	fX *= 2.0;
+	fY *= 2.0;
+	fZ *= 2.0;
+	if(fX >= 1.0)
+	{
+	  fX -= 1.0;
+	  o |= 1;
+	}
+	if(fY >= 1.0)
+	{
+	  fY -= 1.0;
+	  o |= 2;
+	}
+	if(fZ >= 1.0)
+	{
+	  fZ -= 1.0;
+	  o |= 4;
+	}
+	n = b[1 + o];
+      }
+      if(lf >= 0)
+      {
+	int	idL,
+		nL;
+	const int *l;
+
+	l = lat->leaf + lf;
+	nL = *l++;
+	for(idL = 0; idL < nL; ++idL)
+	{
+	  double dX,
+	  	 dY,
+		 dZ,
+		 l1,
+		 l2,
+		 l3;
+	  const double *bc;
+
+	  bc = lat->elmBC + (12 * l[idL]);
+	  dX = pos.vtX - bc[9];
+	  dY = pos.vtY - bc[10];
+	  dZ = pos.vtZ - bc[11];
+	  l1 = (bc[0] * dX) + (bc[1] * dY) + (bc[2] * dZ);
+	  l2 = (bc[3] * dX) + (bc[4] * dY) + (bc[5] * dZ);
+	  l3 = (bc[6] * dX) + (bc[7] * dY) + (bc[8] * dZ);
+	  if((l1 >= -WLZ_CMESH_LAT_BC_TOL) && (l2 >= -WLZ_CMESH_LAT_BC_TOL) &&
+	     (l3 >= -WLZ_CMESH_LAT_BC_TOL) &&
+	     (1.0 - l1 - l2 - l3 >= -WLZ_CMESH_LAT_BC_TOL))
+	  {
+	    idE = l[idL];
+	    break;
+	  }
+	}
+      }
+    }
+  }
+  return(idE);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Fills in the element tables of a 2D lattice along with
+* 		the element bounding boxes, areas and extents of the
+* 		workspace. Degenerate elements are not included in the
+* 		tables.
+* \param	lat			Lattice with allocated element tables.
+* \param	wSp			Lattice workspace.
+* \param	mObj			2D conforming mesh transform object.
+*/
+static WlzErrorNum		WlzCMeshLatElmTab2D(
+				  WlzCMeshLattice *lat,
+				  WlzCMeshLatWSp *wSp,
+				  WlzObject *mObj)
+{
+  int		idE;
+  WlzCMesh2D	*mesh;
+  WlzIndexedValues *ixv;
+
+  mesh = mObj->domain.cm2;
+  ixv = mObj->values.x;
+  for(idE = 0; idE < mesh->res.elm.maxEnt; ++idE)
+  {
+    WlzCMeshElm2D *elm;
+
+    elm = (WlzCMeshElm2D *)AlcVectorItemGet(mesh->res.elm.vec, idE);
+    if(elm->idx >= 0)
+    {
+      int	idN;
+      double	a2;
+      WlzDVertex2 sVx[3];
+
+      for(idN = 0; idN < 3; ++idN)
+      {
+        sVx[idN] = elm->edu[idN].nod->pos;
+      }
+      a2 = WlzGeomTriangleSnArea2(sVx[0], sVx[1], sVx[2]);
+      if(fabs(a2) > WLZ_MESH_TOLERANCE_SQ)
+      {
+	int	  n,
+		  mul;
+	double	  m,
+		  hh;
+	double	  *bc,
+		  *tr;
+	WlzDBox3  *box;
+        WlzDVertex2 e1,
+		  e2;
+	WlzDVertex2 dVx[3];
+
+	n = lat->nElm++;
+	lat->elmIdx[n] = idE;
+	bc = lat->elmBC + (6 * n);
+	tr = lat->elmTr + (6 * n);
+	WLZ_VTX_2_SUB(e1, sVx[1], sVx[0]);
+	WLZ_VTX_2_SUB(e2, sVx[2], sVx[0]);
+	bc[0] =  e2.vtY / a2;
+	bc[1] = -e2.vtX / a2;
+	bc[2] = -e1.vtY / a2;
+	bc[3] =  e1.vtX / a2;
+	bc[4] = sVx[0].vtX;
+	bc[5] = sVx[0].vtY;
+	if(ixv == NULL)
+	{
+	  tr[0] = 1.0; tr[1] = 0.0; tr[2] = 0.0;
+	  tr[3] = 0.0; tr[4] = 1.0; tr[5] = 0.0;
+	}
+	else
+	{
+	  for(idN = 0; idN < 3; ++idN)
+	  {
+	    double *dsp;
+
+	    dsp = (double *)WlzIndexedValueGet(ixv, elm->edu[idN].nod->idx);
+	    dVx[idN].vtX = sVx[idN].vtX + dsp[0];
+	    dVx[idN].vtY = sVx[idN].vtY + dsp[1];
+	  }
+	  (void )WlzGeomTriangleAffineSolve(tr, tr + 3, a2, sVx, dVx,
+	                                    WLZ_MESH_TOLERANCE_SQ);
+	}
+	box = wSp->box + n;
+	box->xMin = box->xMax = sVx[0].vtX;
+	box->yMin = box->yMax = sVx[0].vtY;
+	box->zMin = box->zMax = 0.0;
+	for(idN = 1; idN < 3; ++idN)
+	{
+	  box->xMin = WLZ_MIN(box->xMin, sVx[idN].vtX);
+	  box->xMax = WLZ_MAX(box->xMax, sVx[idN].vtX);
+	  box->yMin = WLZ_MIN(box->yMin, sVx[idN].vtY);
+	  box->yMax = WLZ_MAX(box->yMax, sVx[idN].vtY);
+	}
+	m = WLZ_MAX(box->xMax - box->xMin, box->yMax - box->yMin);
+	hh = 0.5 * m;
+	mul = 1;
+	for(idN = 1; mul && (idN < 3); ++idN)
+	{
+	  double q;
+
+	  q = (sVx[idN].vtX - sVx[0].vtX) / hh;
+	  mul = fabs(q - floor(q + 0.5)) < WLZ_CMESH_LAT_POS_TOL;
+	  if(mul)
+	  {
+	    q = (sVx[idN].vtY - sVx[0].vtY) / hh;
+	    mul = fabs(q - floor(q + 0.5)) < WLZ_CMESH_LAT_POS_TOL;
+	  }
+	}
+	wSp->vol[n] = 0.5 * fabs(a2);
+	wSp->ext[n] = m;
+	wSp->mul[n] = mul;
+	wSp->ref[n].vtX = sVx[0].vtX;
+	wSp->ref[n].vtY = sVx[0].vtY;
+	wSp->ref[n].vtZ = 0.0;
+      }
+    }
+  }
+  return(WLZ_ERR_NONE);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Fills in the element tables of a 3D lattice along with
+* 		the element bounding boxes, volumes and extents of the
+* 		workspace. Degenerate elements are not included in the
+* 		tables.
+* \param	lat			Lattice with allocated element tables.
+* \param	wSp			Lattice workspace.
+* \param	mObj			3D conforming mesh transform object.
+*/
+static WlzErrorNum		WlzCMeshLatElmTab3D(
+				  WlzCMeshLattice *lat,
+				  WlzCMeshLatWSp *wSp,
+				  WlzObject *mObj)
+{
+  int		idE;
+  WlzCMesh3D	*mesh;
+  WlzIndexedValues *ixv;
+
+  mesh = mObj->domain.cm3;
+  ixv = mObj->values.x;
+  for(idE = 0; idE < mesh->res.elm.maxEnt; ++idE)
+  {
+    WlzCMeshElm3D *elm;
+
+    elm = (WlzCMeshElm3D *)AlcVectorItemGet(mesh->res.elm.vec, idE);
+    if(elm->idx >= 0)
+    {
+      int	idN;
+      double	v6;
+      WlzCMeshNod3D *nod[4];
+      WlzDVertex3 sVx[4];
+
+      nod[0] = WLZ_CMESH_ELM3D_GET_NODE_0(elm);
+      nod[1] = WLZ_CMESH_ELM3D_GET_NODE_1(elm);
+      nod[2] = WLZ_CMESH_ELM3D_GET_NODE_2(elm);
+      nod[3] = WLZ_CMESH_ELM3D_GET_NODE_3(elm);
+      for(idN = 0; idN < 4; ++idN)
+      {
+        sVx[idN] = nod[idN]->pos;
+      }
+      v6 = WlzGeomTetraSnVolume6(sVx[0], sVx[1], sVx[2], sVx[3]);
+      if(fabs(v6) > WLZ_MESH_TOLERANCE_SQ)
+      {
+	int	  n,
+		  mul;
+	double	  d,
+		  m,
+		  hh;
+	double	  *bc,
+		  *tr;
+	double	  tr4[16];
+	WlzDBox3  *box;
+        WlzDVertex3 e1,
+		  e2,
+		  e3,
+		  c;
+	WlzDVertex3 dVx[4];
+
+	n = lat->nElm++;
+	lat->elmIdx[n] = idE;
+	bc = lat->elmBC + (12 * n);
+	tr = lat->elmTr + (12 * n);
+	WLZ_VTX_3_SUB(e1, sVx[1], sVx[0]);
+	WLZ_VTX_3_SUB(e2, sVx[2], sVx[0]);
+	WLZ_VTX_3_SUB(e3, sVx[3], sVx[0]);
+	WLZ_VTX_3_CROSS(c, e2, e3);
+	d = 1.0 / WLZ_VTX_3_DOT(e1, c);
+	bc[0] = c.vtX * d; bc[1] = c.vtY * d; bc[2] = c.vtZ * d;
+	WLZ_VTX_3_CROSS(c, e3, e1);
+	bc[3] = c.vtX * d; bc[4] = c.vtY * d; bc[5] = c.vtZ * d;
+	WLZ_VTX_3_CROSS(c, e1, e2);
+	bc[6] = c.vtX * d; bc[7] = c.vtY * d; bc[8] = c.vtZ * d;
+	bc[9] = sVx[0].vtX;
+	bc[10] = sVx[0].vtY;
+	bc[11] = sVx[0].vtZ;
+	if(ixv == NULL)
+	{
+	  tr[0] = 1.0; tr[1] = 0.0; tr[ 2] = 0.0; tr[ 3] = 0.0;
+	  tr[4] = 0.0; tr[5] = 1.0; tr[ 6] = 0.0; tr[ 7] = 0.0;
+	  tr[8] = 0.0; tr[9] = 0.0; tr[10] = 1.0; tr[11] = 0.0;
+	}
+	else
+	{
+	  for(idN = 0; idN < 4; ++idN)
+	  {
+	    double *dsp;
+
+	    dsp = (double *)WlzIndexedValueGet(ixv, nod[idN]->idx);
+	    dVx[idN].vtX = sVx[idN].vtX + dsp[0];
+	    dVx[idN].vtY = sVx[idN].vtY + dsp[1];
+	    dVx[idN].vtZ = sVx[idN].vtZ + dsp[2];
+	  }
+	  (void )WlzGeomTetraAffineSolve(tr4, sVx, dVx, WLZ_MESH_TOLERANCE_SQ);
+	  for(idN = 0; idN < 12; ++idN)
+	  {
+	    tr[idN] = tr4[idN];
+	  }
+	}
+	box = wSp->box + n;
+	box->xMin = box->xMax = sVx[0].vtX;
+	box->yMin = box->yMax = sVx[0].vtY;
+	box->zMin = box->zMax = sVx[0].vtZ;
+	for(idN = 1; idN < 4; ++idN)
+	{
+	  box->xMin = WLZ_MIN(box->xMin, sVx[idN].vtX);
+	  box->xMax = WLZ_MAX(box->xMax, sVx[idN].vtX);
+	  box->yMin = WLZ_MIN(box->yMin, sVx[idN].vtY);
+	  box->yMax = WLZ_MAX(box->yMax, sVx[idN].vtY);
+	  box->zMin = WLZ_MIN(box->zMin, sVx[idN].vtZ);
+	  box->zMax = WLZ_MAX(box->zMax, sVx[idN].vtZ);
+	}
+	m = WLZ_MAX(box->xMax - box->xMin, box->yMax - box->yMin);
+	m = WLZ_MAX(m, box->zMax - box->zMin);
+	hh = 0.5 * m;
+	mul = 1;
+	for(idN = 1; mul && (idN < 4); ++idN)
+	{
+	  double q;
+
+	  q = (sVx[idN].vtX - sVx[0].vtX) / hh;
+	  mul = fabs(q - floor(q + 0.5)) < WLZ_CMESH_LAT_POS_TOL;
+	  if(mul)
+	  {
+	    q = (sVx[idN].vtY - sVx[0].vtY) / hh;
+	    mul = fabs(q - floor(q + 0.5)) < WLZ_CMESH_LAT_POS_TOL;
+	  }
+	  if(mul)
+	  {
+	    q = (sVx[idN].vtZ - sVx[0].vtZ) / hh;
+	    mul = fabs(q - floor(q + 0.5)) < WLZ_CMESH_LAT_POS_TOL;
+	  }
+	}
+	wSp->vol[n] = fabs(v6) / 6.0;
+	wSp->ext[n] = m;
+	wSp->mul[n] = mul;
+	wSp->ref[n] = sVx[0];
+      }
+    }
+  }
+  return(WLZ_ERR_NONE);
+}
+
+/*!
+* \return	Level zero cell size or zero if no suitable cell size
+* 		could be found.
+* \ingroup	WlzTransform
+* \brief	Finds the level zero cell size from the elements which
+* 		have their nodes at multiples of half their maximum extent
+* 		from their first node, as is the case for the elements
+* 		of meshes built from balanced linear binary trees. The
+* 		most frequent of these extents is found and the cell size
+* 		is then the smallest of these extents which is a power of
+* 		two multiple of it.
+* \param	lat			Lattice with element tables.
+* \param	wSp			Lattice workspace.
+*/
+static double			WlzCMeshLatCellSz(
+				  WlzCMeshLattice *lat,
+				  WlzCMeshLatWSp *wSp)
+{
+  int		idE,
+  		nM = 0;
+  double	h = 0.0;
+  double	*m;
+
+  if((m = (double *)AlcMalloc(sizeof(double) * lat->nElm)) != NULL)
+  {
+    for(idE = 0; idE < lat->nElm; ++idE)
+    {
+      if(wSp->mul[idE])
+      {
+        m[nM++] = wSp->ext[idE];
+      }
+    }
+  }
+  if(nM > 0)
+  {
+    int		id0,
+    		id1,
+		bCnt = 0;
+    double	mode = 0.0;
+
+    qsort(m, nM, sizeof(double), WlzCMeshLatDblCmp);
+    for(id0 = 0; id0 < nM; id0 = id1)
+    {
+      for(id1 = id0 + 1; (id1 < nM) &&
+                         (m[id1] - m[id0] < WLZ_CMESH_LAT_POS_TOL * m[id0]);
+	  ++id1)
+      {
+        /* Empty loop body. */
+      }
+      if(id1 - id0 > bCnt)
+      {
+        bCnt = id1 - id0;
+	mode = m[id0];
+      }
+    }
+    h = mode;
+    for(id0 = 0; (id0 < nM) && (m[id0] < mode); ++id0)
+    {
+      double	q;
+
+      q = log(mode / m[id0]) / log(2.0);
+      if(fabs(q - floor(q + 0.5)) < WLZ_CMESH_LAT_POS_TOL)
+      {
+        h = m[id0];
+	break;
+      }
+    }
+  }
+  AlcFree(m);
+  return(h);
+}
+
+/*!
+* \return	Lattice origin.
+* \ingroup	WlzTransform
+* \brief	Finds the lattice origin. Elements with nodes at multiples
+* 		of half the cell size from their first node have their
+* 		first node at an offset from the origin which is a
+* 		multiple of half the cell size, so candidate origins at
+* 		offsets of zero or half a cell from the first node of
+* 		such an element are tried, the candidate chosen being
+* 		the one for which the most elements are within a single
+* 		cell at the level of their extent.
+* \param	lat			Lattice with element tables and the
+* 					level zero cell size set.
+* \param	wSp			Lattice workspace.
+* \param	nLvl			Number of levels.
+*/
+static WlzDVertex3		WlzCMeshLatOrg(
+				  WlzCMeshLattice *lat,
+				  WlzCMeshLatWSp *wSp,
+				  int nLvl)
+{
+  int		idE,
+  		idC,
+		bCnt = -1,
+		ref = -1;
+  double	h2;
+  WlzDVertex3	r,
+  		org;
+
+  WLZ_VTX_3_ZERO(r);
+  WLZ_VTX_3_ZERO(org);
+  h2 = 0.5 * lat->cellSz;
+  for(idE = 0; idE < lat->nElm; ++idE)
+  {
+    if(wSp->mul[idE] && (ref < 0 || (wSp->ext[idE] < wSp->ext[ref])))
+    {
+      ref = idE;
+    }
+  }
+  if(ref >= 0)
+  {
+    r.vtX = wSp->ref[ref].vtX - (h2 * floor(wSp->ref[ref].vtX / h2));
+    r.vtY = wSp->ref[ref].vtY - (h2 * floor(wSp->ref[ref].vtY / h2));
+    r.vtZ = wSp->ref[ref].vtZ - (h2 * floor(wSp->ref[ref].vtZ / h2));
+    if((r.vtX < WLZ_CMESH_LAT_POS_TOL * h2) ||
+       (r.vtX > (1.0 - WLZ_CMESH_LAT_POS_TOL) * h2))
+    {
+      r.vtX = 0.0;
+    }
+    if((r.vtY < WLZ_CMESH_LAT_POS_TOL * h2) ||
+       (r.vtY > (1.0 - WLZ_CMESH_LAT_POS_TOL) * h2))
+    {
+      r.vtY = 0.0;
+    }
+    if((wSp->dim == 2) ||
+       (r.vtZ < WLZ_CMESH_LAT_POS_TOL * h2) ||
+       (r.vtZ > (1.0 - WLZ_CMESH_LAT_POS_TOL) * h2))
+    {
+      r.vtZ = 0.0;
+    }
+    for(idC = 0; idC < wSp->nChd; ++idC)
+    {
+      int	cnt = 0;
+      WlzDVertex3 o;
+
+      o.vtX = r.vtX + (((idC & 1) != 0)? h2: 0.0);
+      o.vtY = r.vtY + (((idC & 2) != 0)? h2: 0.0);
+      o.vtZ = r.vtZ + (((idC & 4) != 0)? h2: 0.0);
+      for(idE = 0; idE < lat->nElm; ++idE)
+      {
+	int	k,
+		cel[3];
+	double	h;
+
+	h = lat->cellSz;
+	for(k = 0; (k < nLvl - 1) &&
+	           (h < (1.0 - WLZ_CMESH_LAT_POS_TOL) * wSp->ext[idE]); ++k)
+	{
+	  h *= 2.0;
+	}
+	cnt += WlzCMeshLatElmCell(wSp, o, h, idE, cel);
+      }
+      if(cnt > bCnt)
+      {
+        bCnt = cnt;
+	org = o;
+      }
+    }
+  }
+  return(org);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Builds the lattice cell trees from the finest level
+* 		upwards. At each level the element and sub cell records
+* 		are sorted by cell, cells which are exactly covered are
+* 		complete and get a tree node with a leaf list of their
+* 		elements, while the elements of incomplete cells are
+* 		passed up to the next level.
+* \param	lat			Lattice with element tables.
+* \param	wSp			Lattice workspace.
+* \param	cellSz			Side length of the level zero cells or
+* 					zero to find this from the elements.
+*/
+static WlzErrorNum		WlzCMeshLatBuild(
+				  WlzCMeshLattice *lat,
+				  WlzCMeshLatWSp *wSp,
+				  double cellSz)
+{
+  int		idE,
+  		nLvl = 0,
+		nRec = 0;
+  double	cVol = 0.0,
+  		tVol = 0.0,
+		maxExt = 0.0;
+  WlzCMeshLatRec *rec = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  lat->cellSz = (cellSz > 0.0)? cellSz: WlzCMeshLatCellSz(lat, wSp);
+  if(lat->cellSz > 0.0)
+  {
+    double	h;
+
+    for(idE = 0; idE < lat->nElm; ++idE)
+    {
+      maxExt = WLZ_MAX(maxExt, wSp->ext[idE]);
+      tVol += wSp->vol[idE];
+    }
+    /* One level more than is needed to enclose the largest element
+     * so that elements which straddle cell boundaries at the level of
+     * their extent may still be within a cell. */
+    h = lat->cellSz;
+    for(nLvl = 2; (nLvl < WLZ_CMESH_LAT_MAX_LVL) &&
+                  (h < (1.0 - WLZ_CMESH_LAT_POS_TOL) * maxExt); ++nLvl)
+    {
+      h *= 2.0;
+    }
+    lat->org = WlzCMeshLatOrg(lat, wSp, nLvl);
+    if((rec = (WlzCMeshLatRec *)
+              AlcMalloc(sizeof(WlzCMeshLatRec) * lat->nElm)) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (nLvl > 0))
+  {
+    int		k;
+    double	h;
+
+    /* Find the level of each element. */
+    for(idE = 0; idE < lat->nElm; ++idE)
+    {
+      int	cel[3];
+
+      wSp->lvl[idE] = -1;
+      h = lat->cellSz;
+      for(k = 0; k < nLvl; ++k)
+      {
+        if(WlzCMeshLatElmCell(wSp, lat->org, h, idE, cel))
+	{
+	  wSp->lvl[idE] = k;
+	  break;
+	}
+	h *= 2.0;
+      }
+    }
+    /* Build the trees level by level. */
+    h = lat->cellSz;
+    for(k = 0; (errNum == WLZ_ERR_NONE) && (k < nLvl); ++k)
+    {
+      int	idG,
+		nOut = 0;
+      double	hVol;
+
+      for(idE = 0; idE < lat->nElm; ++idE)
+      {
+        if(wSp->lvl[idE] == k)
+	{
+	  WlzCMeshLatRec *r;
+
+	  r = rec + nRec++;
+	  (void )WlzCMeshLatElmCell(wSp, lat->org, h, idE, r->cel);
+	  r->oct = 0;
+	  r->elm = idE;
+	  r->nod = -1;
+	  r->vol = wSp->vol[idE];
+	}
+      }
+      qsort(rec, nRec, sizeof(WlzCMeshLatRec), WlzCMeshLatRecCmp);
+      hVol = (wSp->dim == 2)? h * h: h * h * h;
+      for(idG = 0; (errNum == WLZ_ERR_NONE) && (idG < nRec); )
+      {
+	int	idR,
+		nE = 0,
+		nG = 0,
+		hasNod = 0,
+		nod = -1,
+		cmp;
+	int	cel[3];
+	double	eVol = 0.0,
+		sVol = 0.0;
+
+	cel[0] = rec[idG].cel[0];
+	cel[1] = rec[idG].cel[1];
+	cel[2] = rec[idG].cel[2];
+	for(idR = idG; (idR < nRec) && (rec[idR].cel[0] == cel[0]) &&
+	               (rec[idR].cel[1] == cel[1]) &&
+		       (rec[idR].cel[2] == cel[2]); ++idR)
+	{
+	  if(rec[idR].elm >= 0)
+	  {
+	    ++nE;
+	    eVol += rec[idR].vol;
+	  }
+	  else
+	  {
+	    sVol += rec[idR].vol;
+	    hasNod |= rec[idR].nod >= 0;
+	  }
+	}
+	nG = idR - idG;
+	cmp = fabs(eVol + sVol - hVol) < WLZ_CMESH_LAT_VOL_TOL * hVol;
+	if(cmp || hasNod)
+	{
+	  nod = WlzCMeshLatNodNew(lat, wSp, &errNum);
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    int	*b;
+
+	    b = lat->nod + (nod * (1 + wSp->nChd));
+	    for(idR = idG; idR < idG + nG; ++idR)
+	    {
+	      if(rec[idR].nod >= 0)
+	      {
+	        b[1 + rec[idR].oct] = rec[idR].nod;
+	      }
+	    }
+	    if(cmp && (nE > 0))
+	    {
+	      b[0] = WlzCMeshLatLeafNew(lat, wSp, rec + idG, nG, &cVol,
+	                                &errNum);
+	    }
+	  }
+	}
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  if(k == nLvl - 1)
+	  {
+	    /* Keep the top level nodes as records. */
+	    if(nod >= 0)
+	    {
+	      rec[nOut] = rec[idG];
+	      rec[nOut].nod = nod;
+	      ++nOut;
+	    }
+	  }
+	  else
+	  {
+	    int	oct;
+	    int pCel[3];
+
+	    pCel[0] = WlzCMeshLatHalf(cel[0]);
+	    pCel[1] = WlzCMeshLatHalf(cel[1]);
+	    pCel[2] = WlzCMeshLatHalf(cel[2]);
+	    oct = ((cel[0] - (2 * pCel[0])) << 0) |
+	          ((cel[1] - (2 * pCel[1])) << 1) |
+	          ((cel[2] - (2 * pCel[2])) << 2);
+	    if(!cmp)
+	    {
+	      /* Records are only ever moved down the array. */
+	      for(idR = idG; idR < idG + nG; ++idR)
+	      {
+		if(rec[idR].elm >= 0)
+		{
+		  WlzCMeshLatRec *r;
+
+		  r = rec + nOut++;
+		  *r = rec[idR];
+		  r->cel[0] = pCel[0];
+		  r->cel[1] = pCel[1];
+		  r->cel[2] = pCel[2];
+		}
+	      }
+	    }
+	    if(nod >= 0)
+	    {
+	      WlzCMeshLatRec *r;
+
+	      r = rec + nOut++;
+	      r->cel[0] = pCel[0];
+	      r->cel[1] = pCel[1];
+	      r->cel[2] = pCel[2];
+	      r->oct = oct;
+	      r->elm = -1;
+	      r->nod = nod;
+	      r->vol = (cmp)? hVol: sVol;
+	    }
+	  }
+	}
+	idG += nG;
+      }
+      nRec = nOut;
+      h *= 2.0;
+    }
+  }
+  /* Build the array of top level cells. */
+  if((errNum == WLZ_ERR_NONE) && (nRec > 0))
+  {
+    int		idR;
+    double	tSz;
+    WlzIVertex3	cMin,
+    		cMax;
+
+    cMin.vtX = cMax.vtX = rec[0].cel[0];
+    cMin.vtY = cMax.vtY = rec[0].cel[1];
+    cMin.vtZ = cMax.vtZ = rec[0].cel[2];
+    for(idR = 1; idR < nRec; ++idR)
+    {
+      cMin.vtX = WLZ_MIN(cMin.vtX, rec[idR].cel[0]);
+      cMin.vtY = WLZ_MIN(cMin.vtY, rec[idR].cel[1]);
+      cMin.vtZ = WLZ_MIN(cMin.vtZ, rec[idR].cel[2]);
+      cMax.vtX = WLZ_MAX(cMax.vtX, rec[idR].cel[0]);
+      cMax.vtY = WLZ_MAX(cMax.vtY, rec[idR].cel[1]);
+      cMax.vtZ = WLZ_MAX(cMax.vtZ, rec[idR].cel[2]);
+    }
+    lat->tOff = cMin;
+    lat->tSz.vtX = cMax.vtX - cMin.vtX + 1;
+    lat->tSz.vtY = cMax.vtY - cMin.vtY + 1;
+    lat->tSz.vtZ = cMax.vtZ - cMin.vtZ + 1;
+    tSz = (double )(lat->tSz.vtX) * (double )(lat->tSz.vtY) *
+          (double )(lat->tSz.vtZ);
+    if(tSz > INT_MAX / 2)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else if((lat->top = (int *)AlcMalloc(sizeof(int) * (size_t )tSz)) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      int	idT;
+
+      for(idT = 0; idT < (int )tSz; ++idT)
+      {
+        lat->top[idT] = -1;
+      }
+      for(idR = 0; idR < nRec; ++idR)
+      {
+	idT = (((rec[idR].cel[2] - cMin.vtZ) * lat->tSz.vtY) +
+	       (rec[idR].cel[1] - cMin.vtY)) * lat->tSz.vtX +
+	      (rec[idR].cel[0] - cMin.vtX);
+        lat->top[idT] = rec[idR].nod;
+      }
+      lat->nLvl = nLvl;
+      lat->coverage = (tVol > 0.0)? cVol / tVol: 0.0;
+    }
+  }
+  AlcFree(rec);
+  return(errNum);
+}
+
+/*!
+* \return	Non-zero if the element is within a single cell.
+* \ingroup	WlzTransform
+* \brief	Tests whether an element is within a single lattice cell
+* 		of the given size and if so sets the cell indices.
+* \param	wSp			Lattice workspace.
+* \param	org			Lattice origin.
+* \param	h			Cell side length.
+* \param	idE			Element table index.
+* \param	cel			Destination for the cell indices.
+*/
+static int			WlzCMeshLatElmCell(
+				  WlzCMeshLatWSp *wSp,
+				  WlzDVertex3 org,
+				  double h,
+				  int idE,
+				  int *cel)
+{
+  int		in;
+  double	lo,
+  		hi;
+  WlzDBox3	*b;
+
+  b = wSp->box + idE;
+  lo = floor(((b->xMin - org.vtX) / h) + WLZ_CMESH_LAT_POS_TOL);
+  hi = floor(((b->xMax - org.vtX) / h) - WLZ_CMESH_LAT_POS_TOL);
+  in = (lo == hi) && (fabs(lo) < INT_MAX / 2);
+  cel[0] = (int )lo;
+  if(in)
+  {
+    lo = floor(((b->yMin - org.vtY) / h) + WLZ_CMESH_LAT_POS_TOL);
+    hi = floor(((b->yMax - org.vtY) / h) - WLZ_CMESH_LAT_POS_TOL);
+    in = (lo == hi) && (fabs(lo) < INT_MAX / 2);
+    cel[1] = (int )lo;
+  }
+  if(in)
+  {
+    if(wSp->dim == 2)
+    {
+      cel[2] = 0;
+    }
+    else
+    {
+      lo = floor(((b->zMin - org.vtZ) / h) + WLZ_CMESH_LAT_POS_TOL);
+      hi = floor(((b->zMax - org.vtZ) / h) - WLZ_CMESH_LAT_POS_TOL);
+      in = (lo == hi) && (fabs(lo) < INT_MAX / 2);
+      cel[2] = (int )lo;
+    }
+  }
+  return(in);
+}
+
+/*!
+* \return	Index of the new tree node or -1 on error.
+* \ingroup	WlzTransform
+* \brief	Adds a new tree node with no leaf list and no children.
+* \param	lat			Lattice.
+* \param	wSp			Lattice workspace.
+* \param	dstErr			Destination error pointer.
+*/
+static int			WlzCMeshLatNodNew(
+				  WlzCMeshLattice *lat,
+				  WlzCMeshLatWSp *wSp,
+				  WlzErrorNum *dstErr)
+{
+  int		n = -1,
+  		nB;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  nB = 1 + wSp->nChd;
+  if(lat->nNod >= wSp->maxNod)
+  {
+    int		max;
+    int		*nod;
+
+    max = (wSp->maxNod < 1024)? 1024: 2 * wSp->maxNod;
+    if((nod = (int *)AlcRealloc(lat->nod, sizeof(int) * nB * max)) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      lat->nod = nod;
+      wSp->maxNod = max;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idB;
+    int		*b;
+
+    n = lat->nNod++;
+    b = lat->nod + (n * nB);
+    for(idB = 0; idB < nB; ++idB)
+    {
+      b[idB] = -1;
+    }
+  }
+  *dstErr = errNum;
+  return(n);
+}
+
+/*!
+* \return	Offset of the new leaf list or -1 on error.
+* \ingroup	WlzTransform
+* \brief	Adds a leaf list of the elements in the given records.
+* \param	lat			Lattice.
+* \param	wSp			Lattice workspace.
+* \param	rec			Records of a complete cell.
+* \param	nRec			Number of records.
+* \param	dstVol			Sum to which the element areas or
+* 					volumes are added.
+* \param	dstErr			Destination error pointer.
+*/
+static int			WlzCMeshLatLeafNew(
+				  WlzCMeshLattice *lat,
+				  WlzCMeshLatWSp *wSp,
+				  WlzCMeshLatRec *rec,
+				  int nRec,
+				  double *dstVol,
+				  WlzErrorNum *dstErr)
+{
+  int		off = -1;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(wSp->nLeaf + nRec + 1 > wSp->maxLeaf)
+  {
+    int		max;
+    int		*leaf;
+
+    max = WLZ_MAX(2 * wSp->maxLeaf, 4096);
+    max = WLZ_MAX(max, wSp->nLeaf + nRec + 1);
+    if((leaf = (int *)AlcRealloc(lat->leaf, sizeof(int) * max)) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      lat->leaf = leaf;
+      wSp->maxLeaf = max;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idR,
+    		n = 0;
+
+    off = wSp->nLeaf;
+    for(idR = 0; idR < nRec; ++idR)
+    {
+      if(rec[idR].elm >= 0)
+      {
+        lat->leaf[off + 1 + n++] = rec[idR].elm;
+	*dstVol += rec[idR].vol;
+      }
+    }
+    lat->leaf[off] = n;
+    wSp->nLeaf += n + 1;
+  }
+  *dstErr = errNum;
+  return(off);
+}
+
+/*!
+* \return	Given index divided by two and rounded towards minus
+* 		infinity.
+* \ingroup	WlzTransform
+* \brief	Computes the index of the cell at the next level which
+* 		contains the cell with the given index.
+* \param	i			Given cell index.
+*/
+static int			WlzCMeshLatHalf(
+				  int i)
+{
+  return((i >= 0)? i / 2: -((1 - i) / 2));
+}
+
+/*!
+* \return	Sorting value for qsort().
+* \ingroup	WlzTransform
+* \brief	Compares lattice records by cell, with the plane index
+* 		most significant.
+* \param	p0			Pointer to first record.
+* \param	p1			Pointer to second record.
+*/
+static int			WlzCMeshLatRecCmp(
+				  const void *p0,
+				  const void *p1)
+{
+  int		cmp;
+  const WlzCMeshLatRec *r0,
+  		*r1;
+
+  r0 = (const WlzCMeshLatRec *)p0;
+  r1 = (const WlzCMeshLatRec *)p1;
+  if((cmp = r0->cel[2] - r1->cel[2]) == 0)
+  {
+    if((cmp = r0->cel[1] - r1->cel[1]) == 0)
+    {
+      cmp = r0->cel[0] - r1->cel[0];
+    }
+  }
+  return(cmp);
+}
+
+/*!
+* \return	Sorting value for qsort().
+* \ingroup	WlzTransform
+* \brief	Compares double values into ascending order.
+* \param	p0			Pointer to first value.
+* \param	p1			Pointer to second value.
+*/
+static int			WlzCMeshLatDblCmp(
+				  const void *p0,
+				  const void *p1)
+{
+  int		cmp;
+  double	d;
+
+  d = *(const double *)p0 - *(const double *)p1;
+  cmp = (d < 0.0)? -1: (d > 0.0)? 1: 0;
+  return(cmp);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Either compares the key of a lattice cache with the nodes
+* 		and displacements of a mesh transform or, if the match
+* 		destination pointer is NULL, sets the key from them.
+* \param	cache			Given lattice cache.
+* \param	mObj			Given 2D or 3D conforming mesh
+* 					transform object with indexed
+* 					values.
+* \param	dstMatch		Destination pointer for non-zero if
+* 					the key matches, if NULL the key is
+* 					set.
+*/
+static WlzErrorNum		WlzCMeshLatCacheKey(
+				  WlzCMeshLatticeCache *cache,
+				  WlzObject *mObj,
+				  int *dstMatch)
+{
+  int		idN,
+  		dim,
+		nKey,
+  		nNod,
+		nElm,
+		maxElm,
+		match;
+  AlcVector	*nodVec;
+  WlzIndexedValues *ixv;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  ixv = mObj->values.x;
+  if(mObj->type == WLZ_CMESH_2D)
+  {
+    dim = 2;
+    nodVec = mObj->domain.cm2->res.nod.vec;
+    nNod = mObj->domain.cm2->res.nod.maxEnt;
+    nElm = mObj->domain.cm2->res.elm.numEnt;
+    maxElm = mObj->domain.cm2->res.elm.maxEnt;
+  }
+  else
+  {
+    dim = 3;
+    nodVec = mObj->domain.cm3->res.nod.vec;
+    nNod = mObj->domain.cm3->res.nod.maxEnt;
+    nElm = mObj->domain.cm3->res.elm.numEnt;
+    maxElm = mObj->domain.cm3->res.elm.maxEnt;
+  }
+  nKey = nNod * ((2 * dim) + 1);
+  if(dstMatch)
+  {
+    match = (cache->mesh == mObj->domain.core) &&
+	    (cache->nNod == nNod) && (cache->nElm == nElm) &&
+	    (cache->maxElm == maxElm);
+  }
+  else
+  {
+    match = 1;
+    if(nKey > cache->maxKey)
+    {
+      AlcFree(cache->key);
+      cache->maxKey = 0;
+      if((cache->key = (double *)AlcMalloc(sizeof(double) * nKey)) == NULL)
+      {
+	errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      else
+      {
+	cache->maxKey = nKey;
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      cache->mesh = mObj->domain.core;
+      cache->nNod = nNod;
+      cache->nElm = nElm;
+      cache->maxElm = maxElm;
+    }
+    else
+    {
+      cache->mesh = NULL;
+    }
+  }
+  for(idN = 0; match && (errNum == WLZ_ERR_NONE) && (idN < nNod); ++idN)
+  {
+    int		idK;
+    double	*key;
+    double	val[7];
+
+    key = cache->key + (idN * ((2 * dim) + 1));
+    if(dim == 2)
+    {
+      WlzCMeshNod2D *nod;
+
+      nod = (WlzCMeshNod2D *)AlcVectorItemGet(nodVec, idN);
+      val[0] = nod->idx;
+      val[1] = nod->pos.vtX;
+      val[2] = nod->pos.vtY;
+      val[3] = val[4] = 0.0;
+      if(nod->idx >= 0)
+      {
+	double	*dsp;
+
+	dsp = (double *)WlzIndexedValueGet(ixv, nod->idx);
+	val[3] = dsp[0];
+	val[4] = dsp[1];
+      }
+    }
+    else
+    {
+      WlzCMeshNod3D *nod;
+
+      nod = (WlzCMeshNod3D *)AlcVectorItemGet(nodVec, idN);
+      val[0] = nod->idx;
+      val[1] = nod->pos.vtX;
+      val[2] = nod->pos.vtY;
+      val[3] = nod->pos.vtZ;
+      val[4] = val[5] = val[6] = 0.0;
+      if(nod->idx >= 0)
+      {
+	double	*dsp;
+
+	dsp = (double *)WlzIndexedValueGet(ixv, nod->idx);
+	val[4] = dsp[0];
+	val[5] = dsp[1];
+	val[6] = dsp[2];
+      }
+    }
+    for(idK = 0; idK <= 2 * dim; ++idK)
+    {
+      if(dstMatch)
+      {
+	match = match && (key[idK] == val[idK]);
+      }
+      else
+      {
+	key[idK] = val[idK];
+      }
+    }
+  }
+  if(dstMatch)
+  {
+    *dstMatch = match;
+  }
+  return(errNum);
+}
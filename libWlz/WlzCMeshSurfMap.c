@@ -45,6 +45,11 @@ static char _WlzCMeshSurfMap_c[] = "University of Edinburgh $Id$";
 #include <float.h>
 #include <Wlz.h>
 
+static void			WlzCMeshSurfMapTriple(
+				  AlgMatrixTriple *t,
+				  int row,
+				  int col,
+				  double val);
 static int			WlzCMeshSurfMapIdxCmpFn(
 				  const void *p0,
 				  const void *p1);
@@ -627,11 +632,14 @@ WlzObject	*WlzCMeshCompSurfMapFT(WlzCMesh2D5 *mesh,
 					   are sorted when accessed via this
 					   index, ie:
 					   pIdx[sPidx[i+1]] > pIdx[sPidx[i]]. */
+  size_t	nT = 0,			/* Number of matrix triples. */
+		mT = 0;			/* Space allocated for triples. */
   double	*bV = NULL,
-		*lV = NULL,		/* The lambda values. */
 		*xV = NULL;
   AlgMatrix	aM,			/* Matrix A of nI x nI weights. */
                 wM; 			/* Rectangular matrix 4 x nI for CG. */
+  AlgMatrixTriple *tri = NULL;		/* Triples used to build A. */
+  AlgMatrixPrecond *pc = NULL;		/* Preconditioner for A. */
   WlzUByte	**qTab = NULL;		/* Table with qTab[i][j] set to 1
                                            iff i'th internal node is a
 					   neighbour of the j'th pinned
@@ -720,9 +728,9 @@ WlzObject	*WlzCMeshCompSurfMapFT(WlzCMesh2D5 *mesh,
          ((rIdx    = (int *)AlcMalloc(sizeof(int) * nM)) == NULL) ||
          ((sIdx    = (int *)AlcMalloc(sizeof(int) * nP)) == NULL) ||
          ((bV      = (double *)AlcMalloc(sizeof(double) * nI)) == NULL) ||
-         ((lV      = (double *)AlcMalloc(sizeof(double) * nI)) == NULL) ||
          ((xV      = (double *)AlcMalloc(sizeof(double) * nI)) == NULL) ||
-         ((aM.llr = AlgMatrixLLRNew(nI, nI, 10 * nI, tol, NULL)) == NULL) ||
+         ((tri     = (AlgMatrixTriple *)AlcMalloc(sizeof(AlgMatrixTriple) *
+	                                          (mT = 8 * nI))) == NULL) ||
          ((wM.rect = AlgMatrixRectNew(4, nI, NULL)) == NULL) ||
          (AlcUnchar2Calloc(&qTab, nI, nP) != ALC_ER_NONE))
       {
@@ -798,12 +806,15 @@ WlzObject	*WlzCMeshCompSurfMapFT(WlzCMesh2D5 *mesh,
 	}
       }
       /* Set values for matrix A (aM) and table (qTab) used to
-       * compute b. */
+       * compute b. The rows of the barycentric weights matrix are
+       * scaled by the number of neighbours to give the graph Laplacian,
+       * which is symmetric positive definite, so that the conjugate
+       * gradient solver may be used with incomplete Cholesky
+       * preconditioning. */
       if(errNum == WLZ_ERR_NONE)
       {
 	int	i;
 
-	AlgMatrixSetAll(aM, 0.0);
         for(i = 0; i < nI; ++i)
 	{
 	  WlzCMeshNod2D5 *iNod;
@@ -824,9 +835,21 @@ WlzObject	*WlzCMeshCompSurfMapFT(WlzCMesh2D5 *mesh,
 	    }
 	    while(edu != iNod->edu);
 	    /* Now set elements of matrix A. */
+	    if(nT + nCnt + 1 > mT)
+	    {
+	      AlgMatrixTriple *t;
+
+	      mT = 2 * (nT + nCnt + 1);
+	      if((t = (AlgMatrixTriple *)
+	              AlcRealloc(tri, sizeof(AlgMatrixTriple) * mT)) == NULL)
+	      {
+	        errNum = WLZ_ERR_MEM_ALLOC;
+		break;
+	      }
+	      tri = t;
+	    }
 	    if(nCnt > 0)
 	    {
-	      lV[i] = 1.0 / nCnt;
 	      edu = iNod->edu;
 	      do
 	      {
@@ -849,13 +872,16 @@ WlzObject	*WlzCMeshCompSurfMapFT(WlzCMesh2D5 *mesh,
 		  else
 		  {
 		    /* Neighbour is internal. */
-		    (void )AlgMatrixSet(aM, i, j, -lV[i]);
+		    tri[nT].row = i;
+		    tri[nT].col = j;
+		    tri[nT++].val = -1.0;
 		  }
 		}
 		edu = nnxt;
 	      }
 	      while(edu != iNod->edu);
-	      (void )AlgMatrixSet(aM, i, i, 1.0);
+	      tri[nT].row = tri[nT].col = i;
+	      tri[nT++].val = nCnt;
 	    }
 	    else
 	    {
@@ -865,6 +891,19 @@ WlzObject	*WlzCMeshCompSurfMapFT(WlzCMesh2D5 *mesh,
 	  }
 	}
       }
+      /* Build the compressed sparse row matrix A and its
+       * preconditioner. */
+      if(errNum == WLZ_ERR_NONE)
+      {
+        AlgError algErr = ALG_ERR_NONE;
+
+	aM.csr = AlgMatrixCSRFromTriples(nI, nI, nT, tri, tol, &algErr);
+	if(algErr == ALG_ERR_NONE)
+	{
+	  pc = AlgMatrixPrecondNew(aM, ALG_MATRIX_PRECOND_ICHOL, &algErr);
+	}
+	errNum = WlzErrorFromAlg(algErr);
+      }
       /* Set bV and xV using the pinned node X coordinates and the
        * table (qTab) then solve for xV */
       if(errNum == WLZ_ERR_NONE)
@@ -882,14 +921,14 @@ WlzObject	*WlzCMeshCompSurfMapFT(WlzCMesh2D5 *mesh,
 	  {
 	    if(q[j])
 	    {
-	      b += lV[i] * pV[sIdx[j]].vtX;
+	      b += pV[sIdx[j]].vtX;
 	    }
 	  }
 	  bV[i] = b;
 	  xV[i] = 0.0;
 	}
 	errNum = WlzErrorFromAlg(
-	    AlgMatrixCGSolve(aM, xV, bV, wM, NULL, NULL,
+	    AlgMatrixCGSolve(aM, xV, bV, wM, AlgMatrixPrecondApply, pc,
 	                     tol, itr, NULL, NULL));
       }
       /* Set X coordinates of the interior nodes in the new map object. */
@@ -925,14 +964,14 @@ WlzObject	*WlzCMeshCompSurfMapFT(WlzCMesh2D5 *mesh,
 	  {
 	    if(q[j])
 	    {
-	      b += lV[i] * pV[sIdx[j]].vtY;
+	      b += pV[sIdx[j]].vtY;
 	    }
 	  }
 	  bV[i] = b;
 	  xV[i] = 0.0;
 	}
 	errNum = WlzErrorFromAlg(
-	    AlgMatrixCGSolve(aM, xV, bV, wM, NULL, NULL,
+	    AlgMatrixCGSolve(aM, xV, bV, wM, AlgMatrixPrecondApply, pc,
 	                     tol, itr, NULL, NULL));
       }
       /* Set Y coordinates of the interior nodes in the new map object. */
@@ -953,11 +992,12 @@ WlzObject	*WlzCMeshCompSurfMapFT(WlzCMesh2D5 *mesh,
     }
   }
   AlcFree(bV);
-  AlcFree(lV);
   AlcFree(xV);
+  AlcFree(tri);
   AlcFree(nIdx);
   AlcFree(rIdx);
   AlcFree(sIdx);
+  AlgMatrixPrecondFree(pc);
   AlgMatrixFree(aM);
   AlgMatrixFree(wM);
   (void )Alc2Free((void **)qTab);
@@ -1012,11 +1052,15 @@ WlzObject	*WlzCMeshCompSurfMapLevy(WlzCMesh2D5 *mesh,
   		*eIdxTb = NULL,
   		*nIdxTb = NULL,
 		*pIdxSorted = NULL;
+  size_t	nA = 0,
+		nB = 0;
   double	*bV = NULL,
   		*bUV = NULL,
 		*xV = NULL;
   AlgMatrix	aM,
   		bPM;
+  AlgMatrixTriple *aT = NULL,
+		*bT = NULL;
   WlzObject	*mapObj = NULL;
   WlzIndexedValues *ixv = NULL;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
@@ -1047,8 +1091,10 @@ WlzObject	*WlzCMeshCompSurfMapLevy(WlzCMesh2D5 *mesh,
     nE2 = 2 * nE;
     nN2 = 2 * nN;
     nP2 = 2 * nP;
-    if(((aM.llr = AlgMatrixLLRNew(nE2, nN2, 6 * nE, tol, NULL)) == NULL) ||
-       ((bPM.llr = AlgMatrixLLRNew(nE2, nP2, 6 * nE, tol, NULL)) == NULL) ||
+    if(((aT = (AlgMatrixTriple *)
+              AlcMalloc(sizeof(AlgMatrixTriple) * 12 * nE)) == NULL) ||
+       ((bT = (AlgMatrixTriple *)
+              AlcMalloc(sizeof(AlgMatrixTriple) * 12 * nE)) == NULL) ||
        ((bUV = (double *)AlcMalloc(sizeof(double) * nP2)) == NULL) ||
        ((bV = (double *)AlcMalloc(sizeof(double) * nE2)) == NULL) ||
        ((xV = (double *)AlcCalloc(nE2, sizeof(double))) == NULL) ||
@@ -1168,10 +1214,10 @@ WlzObject	*WlzCMeshCompSurfMapLevy(WlzCMesh2D5 *mesh,
 		    WlzCMeshSurfMapIdxCmpFn)) == NULL)
 	    {
 	      /* Node is free. */
-	      (void )AlgMatrixSet(aM, idT,      idV,       wR[idN]);
-	      (void )AlgMatrixSet(aM, idT + nE, idV,      -wI[idN]);
-	      (void )AlgMatrixSet(aM, idT,      idV + nN,  wI[idN]);
-	      (void )AlgMatrixSet(aM, idT + nE, idV + nN,  wR[idN]);
+	      WlzCMeshSurfMapTriple(aT + nA++, idT,      idV,       wR[idN]);
+	      WlzCMeshSurfMapTriple(aT + nA++, idT + nE, idV,      -wI[idN]);
+	      WlzCMeshSurfMapTriple(aT + nA++, idT,      idV + nN,  wI[idN]);
+	      WlzCMeshSurfMapTriple(aT + nA++, idT + nE, idV + nN,  wR[idN]);
 	    }
 	    else
 	    {
@@ -1181,10 +1227,10 @@ WlzObject	*WlzCMeshCompSurfMapLevy(WlzCMesh2D5 *mesh,
 	      /* Node is pinned. */
 	      idQ = idPP - pIdxSorted;    /* Index into table pinned node. */
 	      idP = pIdxIdxTb[nod[idN]->idx];
-	      (void )AlgMatrixSet(bPM, idT,      idQ,       wR[idN]);
-	      (void )AlgMatrixSet(bPM, idT + nE, idQ,      -wI[idN]);
-	      (void )AlgMatrixSet(bPM, idT,      idQ + nP,  wI[idN]);
-	      (void )AlgMatrixSet(bPM, idT + nE, idQ + nP,  wR[idN]);
+	      WlzCMeshSurfMapTriple(bT + nB++, idT,      idQ,       wR[idN]);
+	      WlzCMeshSurfMapTriple(bT + nB++, idT + nE, idQ,      -wI[idN]);
+	      WlzCMeshSurfMapTriple(bT + nB++, idT,      idQ + nP,  wI[idN]);
+	      WlzCMeshSurfMapTriple(bT + nB++, idT + nE, idQ + nP,  wR[idN]);
 	      bUV[idQ     ] = dPV[idP].vtX;
 	      bUV[idQ + nP] = dPV[idP].vtY;
 	    }
@@ -1192,6 +1238,18 @@ WlzObject	*WlzCMeshCompSurfMapLevy(WlzCMesh2D5 *mesh,
 	}
       }
     }
+    /* Build the compressed sparse row matrices. */
+    if(errNum == WLZ_ERR_NONE)
+    {
+      AlgError	algErr = ALG_ERR_NONE;
+
+      aM.csr = AlgMatrixCSRFromTriples(nE2, nN2, nA, aT, tol, &algErr);
+      if(algErr == ALG_ERR_NONE)
+      {
+        bPM.csr = AlgMatrixCSRFromTriples(nE2, nP2, nB, bT, tol, &algErr);
+      }
+      errNum = WlzErrorFromAlg(algErr);
+    }
     /* Compute bV and solve for mapped vertices. */
     if(errNum == WLZ_ERR_NONE)
     {
@@ -1204,8 +1262,11 @@ WlzObject	*WlzCMeshCompSurfMapLevy(WlzCMesh2D5 *mesh,
       (void )AlcDouble1WriteAsci(stderr, bV, nE * 2);
       (void )fprintf(stderr, "]\n");
 #endif 
+      /* Preconditioning would change the damped (regularised) solution
+       * so the damped LSQR solve is not preconditioned. */
       errNum = WlzErrorFromAlg(
-	  AlgMatrixSolveLSQR(aM, bV, xV, 1.0e-3, 1.0e-9, 1.0e-9, 10000, 0,
+	  AlgMatrixSolveLSQRPrecond(aM, bV, xV, ALG_MATRIX_PRECOND_NONE,
+	    1.0e-3, 1.0e-9, 1.0e-9, 10000, 0,
 	    NULL, NULL, NULL, NULL, NULL, NULL, NULL));
     }
     if(errNum == WLZ_ERR_NONE)
@@ -1249,6 +1310,8 @@ WlzObject	*WlzCMeshCompSurfMapLevy(WlzCMesh2D5 *mesh,
   AlcFree(xV);
   AlcFree(bV);
   AlcFree(bUV);
+  AlcFree(aT);
+  AlcFree(bT);
   AlcFree(nIdxTb);
   AlcFree(eIdxTb);
   AlgMatrixFree(aM);
@@ -1263,6 +1326,22 @@ WlzObject	*WlzCMeshCompSurfMapLevy(WlzCMesh2D5 *mesh,
   return(mapObj);
 }
 
+/*!
+* \ingroup	WlzMesh
+* \brief	Sets the given matrix triple.
+* \param	t			Given triple.
+* \param	row			Matrix row.
+* \param	col			Matrix column.
+* \param	val			Matrix value.
+*/
+static void	WlzCMeshSurfMapTriple(AlgMatrixTriple *t, int row, int col,
+				      double val)
+{
+  t->row = row;
+  t->col = col;
+  t->val = val;
+}
+
 /*!
 * \return	Comparison value for qsort().
 * \ingroup	WlzMesh
@@ -168,6 +168,14 @@ typedef struct _WlzCMeshScanWSp3D
   					    mesh. */
 } WlzCMeshScanWSp3D;
 
+static WlzErrorNum		WlzCMeshTransformVtxAryGen2D(
+				  WlzObject *mObj,
+				  int nVtx,
+				  WlzDVertex2 *vtx);
+static WlzErrorNum		WlzCMeshTransformVtxAryGen3D(
+				  WlzObject *mObj,
+				  int nVtx,
+				  WlzDVertex3 *vtx);
 static void 			WlzCMeshUpdateScanElm2D(
 				  WlzObject *mObj,
 				  WlzCMeshScanElm2D *sElm,
@@ -290,6 +298,18 @@ static WlzObject 		*WlzCMeshProduct3D(
 				  WlzObject *tr0,
 				  WlzObject *tr1,
 				  WlzErrorNum *dstErr);
+static WlzErrorNum		WlzCMeshKrigNodDsp2D(
+				  WlzCMesh2D *mesh,
+				  WlzIndexedValues *ixv,
+				  int nQ,
+				  WlzDVertex2 *qPos,
+				  WlzDVertex2 *qDsp);
+static WlzErrorNum		WlzCMeshKrigNodDsp3D(
+				  WlzCMesh3D *mesh,
+				  WlzIndexedValues *ixv,
+				  int nQ,
+				  WlzDVertex3 *qPos,
+				  WlzDVertex3 *qDsp);
 static WlzErrorNum 		WlzCMeshTransformValues2D(
 				  WlzObject *dstObj,
 				  WlzObject *srcObj,
@@ -1129,7 +1149,7 @@ WlzErrorNum	WlzCMeshTransformVtxAry2I(WlzObject *mObj,
       errNum = WLZ_ERR_DOMAIN_DATA;
       break;
     }
-    if(sE.idx > 0)
+    if(sE.idx >= 0)
     {
       if((sE.idx != lastElmIdx) || ((sE.flags & WLZ_CMESH_SCANELM_FWD) == 0))
       {
@@ -1192,7 +1212,7 @@ WlzErrorNum	WlzCMeshTransformVtxAry3I(WlzObject *mObj,
       errNum = WLZ_ERR_DOMAIN_DATA;
       break;
     }
-    if(sE.idx > 0)
+    if(sE.idx >= 0)
     {
       if((sE.idx != lastElmIdx) || ((sE.flags & WLZ_CMESH_SCANELM_FWD) == 0))
       {
@@ -1260,7 +1280,7 @@ WlzErrorNum	WlzCMeshTransformVtxAry2F(WlzObject *mObj,
       errNum = WLZ_ERR_DOMAIN_DATA;
       break;
     }
-    if(sE.idx > 0)
+    if(sE.idx >= 0)
     {
       if((sE.idx != lastElmIdx) || ((sE.flags & WLZ_CMESH_SCANELM_FWD) == 0))
       {
@@ -1324,7 +1344,7 @@ WlzErrorNum	WlzCMeshTransformVtxAry3F(WlzObject *mObj,
       errNum = WLZ_ERR_DOMAIN_DATA;
       break;
     }
-    if(sE.idx > 0)
+    if(sE.idx >= 0)
     {
       if((sE.idx != lastElmIdx) || ((sE.flags & WLZ_CMESH_SCANELM_FWD) == 0))
       {
@@ -1360,12 +1380,151 @@ WlzErrorNum	WlzCMeshTransformVtxAry3F(WlzObject *mObj,
 *		transform. If a vertex is outside the mest it is
 *		displaced using the displacement of the closest node
 *		in the mesh.
+*		A lattice cached with the transform's displacements
+*		(see WlzCMeshLatticeCached()) is used to locate the
+*		vertices which are within lattice aligned parts of
+*		the mesh, once enough vertices have been transformed
+*		for it to be worth building.
 * \param	mObj			The mesh transform object.
 * \param	nVtx			Number of vertices in the array.
 * \param	vtx			Array of vertices.
 */
 WlzErrorNum	WlzCMeshTransformVtxAry2D(WlzObject *mObj,
 					 int nVtx, WlzDVertex2 *vtx)
+{
+  WlzCMeshLattice *lat;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  lat = WlzCMeshLatticeCached(mObj, nVtx, NULL);
+  errNum = WlzCMeshTransformVtxAryLat2D(mObj, lat, nVtx, vtx);
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Transforms the vertices in the given double vertex
+*		array in place and using the given conforming mesh
+*		transform and lattice. Vertices within complete
+*		lattice cells are located and transformed using the
+*		lattice, with the remaining vertices located by
+*		a general search of the mesh. If a vertex is outside
+*		the mesh it is displaced using the displacement of
+*		the closest node in the mesh.
+*		The lattice must have been built from the given
+*		mesh transform and with its current displacements.
+* \param	mObj			The mesh transform object.
+* \param	lat			Lattice built from the mesh
+*					transform, may be NULL.
+* \param	nVtx			Number of vertices in the array.
+* \param	vtx			Array of vertices.
+*/
+WlzErrorNum	WlzCMeshTransformVtxAryLat2D(WlzObject *mObj,
+					     WlzCMeshLattice *lat,
+					     int nVtx, WlzDVertex2 *vtx)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(lat && (lat->type != WLZ_CMESH_2D))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else if((lat == NULL) || (lat->nLvl == 0))
+  {
+    errNum = WlzCMeshTransformVtxAryGen2D(mObj, nVtx, vtx);
+  }
+  else
+  {
+    int		idN,
+    		nMis = 0;
+    unsigned char *mis = NULL;
+    WlzDVertex2	*mVtx = NULL;
+
+    if((mis = (unsigned char *)AlcMalloc(sizeof(unsigned char) *
+                                         nVtx)) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+#ifdef _OPENMP
+#pragma omp parallel for if(nVtx >= 1024) reduction(+:nMis)
+#endif
+      for(idN = 0; idN < nVtx; ++idN)
+      {
+	int	idE;
+
+	if((idE = WlzCMeshLatticeLocate2D(lat, vtx[idN])) >= 0)
+	{
+	  double *tr;
+	  WlzDVertex2 v;
+
+	  v = vtx[idN];
+	  tr = lat->elmTr + (6 * idE);
+	  vtx[idN].vtX = (tr[0] * v.vtX) + (tr[1] * v.vtY) + tr[2];
+	  vtx[idN].vtY = (tr[3] * v.vtX) + (tr[4] * v.vtY) + tr[5];
+	  mis[idN] = 0;
+	}
+	else
+	{
+	  mis[idN] = 1;
+	  ++nMis;
+	}
+      }
+    }
+    if((errNum == WLZ_ERR_NONE) && (nMis > 0))
+    {
+      if((mVtx = (WlzDVertex2 *)AlcMalloc(sizeof(WlzDVertex2) *
+                                          nMis)) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      else
+      {
+	int	idM = 0;
+
+	for(idN = 0; idN < nVtx; ++idN)
+	{
+	  if(mis[idN])
+	  {
+	    mVtx[idM++] = vtx[idN];
+	  }
+	}
+	errNum = WlzCMeshTransformVtxAryGen2D(mObj, nMis, mVtx);
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  idM = 0;
+	  for(idN = 0; idN < nVtx; ++idN)
+	  {
+	    if(mis[idN])
+	    {
+	      vtx[idN] = mVtx[idM++];
+	    }
+	  }
+	}
+      }
+    }
+    AlcFree(mis);
+    AlcFree(mVtx);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Transforms the vertices in the given double vertex
+*		array in place and using the given conforming mesh
+*		transform, locating each vertex by a general search
+*		of the mesh. If a vertex is outside the mest it is
+*		displaced using the displacement of the closest node
+*		in the mesh.
+* \param	mObj			The mesh transform object.
+* \param	nVtx			Number of vertices in the array.
+* \param	vtx			Array of vertices.
+*/
+static WlzErrorNum WlzCMeshTransformVtxAryGen2D(WlzObject *mObj,
+					        int nVtx, WlzDVertex2 *vtx)
 {
   int		idN,
 		nearNod,
@@ -1390,7 +1549,7 @@ WlzErrorNum	WlzCMeshTransformVtxAry2D(WlzObject *mObj,
       errNum = WLZ_ERR_DOMAIN_DATA;
       break;
     }
-    if(sE.idx > 0)
+    if(sE.idx >= 0)
     {
       if((sE.idx != lastElmIdx) || ((sE.flags & WLZ_CMESH_SCANELM_FWD) == 0))
       {
@@ -1451,7 +1610,7 @@ WlzErrorNum	WlzCMeshTransformVtxAry2D5(WlzObject *mObj,
       errNum = WLZ_ERR_DOMAIN_DATA;
       break;
     }
-    if(sE.idx > 0)
+    if(sE.idx >= 0)
     {
       if((sE.idx != lastElmIdx) || ((sE.flags & WLZ_CMESH_SCANELM_FWD) == 0))
       {
@@ -1485,12 +1644,155 @@ WlzErrorNum	WlzCMeshTransformVtxAry2D5(WlzObject *mObj,
 *		transform. If a vertex is outside the mest it is
 *		displaced using the displacement of the closest node
 *		in the mesh.
+*		A lattice cached with the transform's displacements
+*		(see WlzCMeshLatticeCached()) is used to locate the
+*		vertices which are within lattice aligned parts of
+*		the mesh, once enough vertices have been transformed
+*		for it to be worth building.
 * \param	mObj			The mesh transform object.
 * \param	nVtx			Number of vertices in the array.
 * \param	vtx			Array of vertices.
 */
 WlzErrorNum	WlzCMeshTransformVtxAry3D(WlzObject *mObj,
 					 int nVtx, WlzDVertex3 *vtx)
+{
+  WlzCMeshLattice *lat;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  lat = WlzCMeshLatticeCached(mObj, nVtx, NULL);
+  errNum = WlzCMeshTransformVtxAryLat3D(mObj, lat, nVtx, vtx);
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Transforms the vertices in the given double vertex
+*		array in place and using the given conforming mesh
+*		transform and lattice. Vertices within complete
+*		lattice cells are located and transformed using the
+*		lattice, with the remaining vertices located by
+*		a general search of the mesh. If a vertex is outside
+*		the mesh it is displaced using the displacement of
+*		the closest node in the mesh.
+*		The lattice must have been built from the given
+*		mesh transform and with its current displacements.
+* \param	mObj			The mesh transform object.
+* \param	lat			Lattice built from the mesh
+*					transform, may be NULL.
+* \param	nVtx			Number of vertices in the array.
+* \param	vtx			Array of vertices.
+*/
+WlzErrorNum	WlzCMeshTransformVtxAryLat3D(WlzObject *mObj,
+					     WlzCMeshLattice *lat,
+					     int nVtx, WlzDVertex3 *vtx)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(lat && (lat->type != WLZ_CMESH_3D))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else if((lat == NULL) || (lat->nLvl == 0))
+  {
+    errNum = WlzCMeshTransformVtxAryGen3D(mObj, nVtx, vtx);
+  }
+  else
+  {
+    int		idN,
+    		nMis = 0;
+    unsigned char *mis = NULL;
+    WlzDVertex3	*mVtx = NULL;
+
+    if((mis = (unsigned char *)AlcMalloc(sizeof(unsigned char) *
+                                         nVtx)) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+#ifdef _OPENMP
+#pragma omp parallel for if(nVtx >= 1024) reduction(+:nMis)
+#endif
+      for(idN = 0; idN < nVtx; ++idN)
+      {
+	int	idE;
+
+	if((idE = WlzCMeshLatticeLocate3D(lat, vtx[idN])) >= 0)
+	{
+	  double *tr;
+	  WlzDVertex3 v;
+
+	  v = vtx[idN];
+	  tr = lat->elmTr + (12 * idE);
+	  vtx[idN].vtX = (tr[ 0] * v.vtX) + (tr[ 1] * v.vtY) +
+	                 (tr[ 2] * v.vtZ) +  tr[ 3];
+	  vtx[idN].vtY = (tr[ 4] * v.vtX) + (tr[ 5] * v.vtY) +
+	                 (tr[ 6] * v.vtZ) +  tr[ 7];
+	  vtx[idN].vtZ = (tr[ 8] * v.vtX) + (tr[ 9] * v.vtY) +
+	                 (tr[10] * v.vtZ) +  tr[11];
+	  mis[idN] = 0;
+	}
+	else
+	{
+	  mis[idN] = 1;
+	  ++nMis;
+	}
+      }
+    }
+    if((errNum == WLZ_ERR_NONE) && (nMis > 0))
+    {
+      if((mVtx = (WlzDVertex3 *)AlcMalloc(sizeof(WlzDVertex3) *
+                                          nMis)) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      else
+      {
+	int	idM = 0;
+
+	for(idN = 0; idN < nVtx; ++idN)
+	{
+	  if(mis[idN])
+	  {
+	    mVtx[idM++] = vtx[idN];
+	  }
+	}
+	errNum = WlzCMeshTransformVtxAryGen3D(mObj, nMis, mVtx);
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  idM = 0;
+	  for(idN = 0; idN < nVtx; ++idN)
+	  {
+	    if(mis[idN])
+	    {
+	      vtx[idN] = mVtx[idM++];
+	    }
+	  }
+	}
+      }
+    }
+    AlcFree(mis);
+    AlcFree(mVtx);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Transforms the vertices in the given double vertex
+*		array in place and using the given conforming mesh
+*		transform, locating each vertex by a general search
+*		of the mesh. If a vertex is outside the mest it is
+*		displaced using the displacement of the closest node
+*		in the mesh.
+* \param	mObj			The mesh transform object.
+* \param	nVtx			Number of vertices in the array.
+* \param	vtx			Array of vertices.
+*/
+static WlzErrorNum WlzCMeshTransformVtxAryGen3D(WlzObject *mObj,
+					        int nVtx, WlzDVertex3 *vtx)
 {
   int		idN,
 		nearNod,
@@ -1515,7 +1817,7 @@ WlzErrorNum	WlzCMeshTransformVtxAry3D(WlzObject *mObj,
       errNum = WLZ_ERR_DOMAIN_DATA;
       break;
     }
-    if(sE.idx > 0)
+    if(sE.idx >= 0)
     {
       if((sE.idx != lastElmIdx) || ((sE.flags & WLZ_CMESH_SCANELM_FWD) == 0))
       {
@@ -2309,9 +2611,9 @@ static WlzErrorNum WlzCMeshInterpolateNod2DKrig(WlzGreyP dst,
     {
       if(nbrChange)
       {
-	/* Check for an increased number of neighbours and reallocate
-	 * the buffers if needed. */
-	if(nNbr1 > nNbr0)
+	/* Check for a changed number of neighbours and reallocate or
+	 * resize the buffers if needed. */
+	if(nNbr1 != nNbr0)
 	{
 	  errNum = WlzKrigReallocBuffers2D(&nbrPosBuf, &posSV, &wSp, &modelSV,
 	  			           &maxKrigBuf, nNbr1, nNbr0);
@@ -2332,9 +2634,12 @@ static WlzErrorNum WlzCMeshInterpolateNod2DKrig(WlzGreyP dst,
 	}
 	if(errNum == WLZ_ERR_NONE)
 	{
+	  /* The model semi-variogram is decomposed just once for all the
+	   * pixels which share this ring of nodes. */
 	  errNum = WlzKrigOSetModelSV2D(modelSV, &modelFn, nNbr1, nbrPosBuf,
 	  				wSp);
 	}
+	nbrChange = 0;
       }
       if(errNum == WLZ_ERR_NONE)
       {
@@ -9108,11 +9413,7 @@ WlzObject	*WlzCMeshProduct(WlzObject *tr0, WlzObject *tr1,
 static WlzObject *WlzCMeshProduct2D(WlzObject *tr0, WlzObject *tr1,
 				    WlzErrorNum *dstErr)
 {
-  int		nNbr0 = 0,
-  		nNbr1 = 0,
-		maxKrigBuf = 0,
-		maxNbrIdxBuf = 0;
-  double	dRange;
+  int		nQ = 0;
   WlzObject	*trR = NULL;
   WlzCMesh2D	*mesh0 = NULL,
   		*mesh1 = NULL,
@@ -9120,16 +9421,12 @@ static WlzObject *WlzCMeshProduct2D(WlzObject *tr0, WlzObject *tr1,
   WlzIndexedValues *ixv0 = NULL,
   		   *ixv1 = NULL,
 		   *ixvR = NULL;
-  int		*wSp = NULL,
-  		*nodTab = NULL,
-  		*nbrIdxBuf = NULL;
-  double	*posSV = NULL;
-  WlzKrigModelFn modelFn;
-  AlgMatrix	modelSV;
-  WlzDVertex2	*nbrPosBuf = NULL;
+  int		*nodTab = NULL,
+  		*qNod = NULL;
+  WlzDVertex2	*qPos = NULL,
+  		*qDsp = NULL;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
 
-  modelSV.core = NULL;
   if(((mesh0 = tr0->domain.cm2) == NULL) ||
      ((mesh1 = tr1->domain.cm2) == NULL))
   {
@@ -9175,12 +9472,26 @@ static WlzObject *WlzCMeshProduct2D(WlzObject *tr0, WlzObject *tr1,
                                 WLZ_VALUE_ATTACH_NOD, &errNum);
   }
   if(errNum == WLZ_ERR_NONE)
+  {
+    size_t	nNod;
+
+    /* Buffers for the nodes which are not within an element of tr1. */
+    nNod = ALG_MAX(mesh0->res.nod.maxEnt, 1);
+    if(((qNod = (int *)AlcMalloc(sizeof(int) * nNod)) == NULL) ||
+       ((qPos = (WlzDVertex2 *)
+		AlcMalloc(sizeof(WlzDVertex2) * nNod)) == NULL) ||
+       ((qDsp = (WlzDVertex2 *)
+		AlcMalloc(sizeof(WlzDVertex2) * nNod)) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
   {
     int		idN;
     WlzValues	val;
 
     val.x = ixvR;
-    dRange = sqrt(mesh1->maxSqEdgLen);
     trR->values = WlzAssignValues(val, &errNum);
     /* Set displacements for the new constrained mesh transform. */
     for(idN = 0; idN < mesh0->res.nod.maxEnt; ++idN)
@@ -9235,83 +9546,48 @@ static WlzObject *WlzCMeshProduct2D(WlzObject *tr0, WlzObject *tr1,
 					   dsp0[1][1],
 					   dsp0[2][1],
 					   v0);
+	  WLZ_VTX_2_ADD(v1, v1, v0);
+	  WLZ_VTX_2_SUB(v1, v1, nodR->pos);
+	  dspR = (double *)WlzIndexedValueGet(ixvR, nodR->idx);
+	  dspR[0] = v1.vtX;
+	  dspR[1] = v1.vtY;
 	}
-	else /* idE0 <0, the vertex is not in the mesh. Find the closest
-	      * node to the vertex in the mesh and then use kriging. */
+	else /* idE0 <0, the vertex is not in the mesh. Use kriging from
+	      * the ring of nodes around the closest node, which is done for
+	      * all such vertices together below. */
 	{
-	  int		idN0;
-          WlzCMeshNod2D	*nod0,
-	  		*nodN;
-
-	  idN0 = WlzCMeshClosestNod2D(mesh1, v0);
-          nod0 = (WlzCMeshNod2D *)AlcVectorItemGet(mesh1->res.nod.vec, idN0);
-	  nNbr1 = WlzCMeshNodRingNodIndices2D(nod0, &maxNbrIdxBuf,
-	  			              &nbrIdxBuf, &errNum);
-	  if(errNum == WLZ_ERR_NONE)
-	  {
-	    /* Reallocate buffers if required. */
-	    errNum = WlzKrigReallocBuffers2D(&nbrPosBuf, &posSV, &wSp,
-					     &modelSV, &maxKrigBuf,
-					     nNbr1, nNbr0);
-	    nNbr0 = nNbr1;
-	  }
-	  if(errNum == WLZ_ERR_NONE)
-	  {
-	    int	i;
-
-	    for(i = 0; i < nNbr1; ++i)
-	    {
-	      WlzCMeshNod2D *nod;
-	      nod = (WlzCMeshNod2D *)AlcVectorItemGet(mesh1->res.nod.vec,
-						      nbrIdxBuf[i]);
-	      nbrPosBuf[i] = nod->pos;
-	    }
-	    WlzKrigSetModelFn(&modelFn, WLZ_KRIG_MODELFN_LINEAR,
-			      0.0, 0.1, 2.0 * dRange);
-	  }
-	  if(errNum == WLZ_ERR_NONE)
-	  {
-	    errNum = WlzKrigOSetModelSV2D(modelSV, &modelFn, nNbr1, nbrPosBuf,
-					  wSp);
-	  }
-	  if(errNum == WLZ_ERR_NONE)
-	  {
-	    errNum = WlzKrigOSetPosSV2D(posSV, &modelFn, nNbr1, nbrPosBuf, v0);
-	  }
-	  if(errNum == WLZ_ERR_NONE)
-	  {
-	    int	i;
-
-	    v1.vtX = 0.0;
-	    v1.vtY = 0.0;
-	    WlzKrigOWeightsSolve(modelSV, posSV, wSp, WLZ_MESH_TOLERANCE);
-	    /* posSV now contains the weights. */
-	    for(i = 0; i < nNbr1; ++i) 
-	    {
-	      double *dsp0;
-
-	      nodN = (WlzCMeshNod2D *)AlcVectorItemGet(mesh1->res.nod.vec,
-	                                               nbrIdxBuf[i]);
-	      dsp0 = (double *)WlzIndexedValueGet(ixv1, nodN->idx);
-	      v1.vtX += posSV[i] * dsp0[0];
-	      v1.vtY += posSV[i] * dsp0[1];
-	    }
-	  }
+	  qNod[nQ] = nodR->idx;
+	  qPos[nQ++] = v0;
 	}
-	WLZ_VTX_2_ADD(v1, v1, v0);
-	WLZ_VTX_2_SUB(v1, v1, nodR->pos);
-	dspR = (double *)WlzIndexedValueGet(ixvR, nodR->idx);
-	dspR[0] = v1.vtX;
-	dspR[1] = v1.vtY;
       }
     }
   }
-  AlcFree(wSp);
-  AlcFree(posSV);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = WlzCMeshKrigNodDsp2D(mesh1, ixv1, nQ, qPos, qDsp);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idQ;
+
+    for(idQ = 0; idQ < nQ; ++idQ)
+    {
+      double	*dspR;
+      WlzCMeshNod2D *nodR;
+
+      nodR = (WlzCMeshNod2D *)AlcVectorItemGet(meshR->res.nod.vec,
+                                               qNod[idQ]);
+      WLZ_VTX_2_ADD(qDsp[idQ], qDsp[idQ], qPos[idQ]);
+      WLZ_VTX_2_SUB(qDsp[idQ], qDsp[idQ], nodR->pos);
+      dspR = (double *)WlzIndexedValueGet(ixvR, nodR->idx);
+      dspR[0] = qDsp[idQ].vtX;
+      dspR[1] = qDsp[idQ].vtY;
+    }
+  }
   AlcFree(nodTab);
-  AlcFree(nbrIdxBuf);
-  AlcFree(nbrPosBuf);
-  AlgMatrixFree(modelSV);
+  AlcFree(qNod);
+  AlcFree(qPos);
+  AlcFree(qDsp);
   if(dstErr)
   {
     *dstErr = errNum;
@@ -9332,11 +9608,7 @@ static WlzObject *WlzCMeshProduct2D(WlzObject *tr0, WlzObject *tr1,
 static WlzObject *WlzCMeshProduct3D(WlzObject *tr0, WlzObject *tr1,
 				    WlzErrorNum *dstErr)
 {
-  int		nNbr0 = 0,
-  		nNbr1 = 0,
-		maxKrigBuf = 0,
-		maxNbrIdxBuf = 0;
-  double	dRange;
+  int		nQ = 0;
   WlzObject	*trR = NULL;
   WlzCMesh3D	*mesh0 = NULL,
   		*mesh1 = NULL,
@@ -9344,16 +9616,12 @@ static WlzObject *WlzCMeshProduct3D(WlzObject *tr0, WlzObject *tr1,
   WlzIndexedValues *ixv0 = NULL,
   		   *ixv1 = NULL,
 		   *ixvR = NULL;
-  int		*wSp = NULL,
-  		*nodTab = NULL,
-  		*nbrIdxBuf = NULL;
-  double	*posSV = NULL;
-  WlzKrigModelFn modelFn;
-  AlgMatrix	modelSV;
-  WlzDVertex3	*nbrPosBuf = NULL;
+  int		*nodTab = NULL,
+  		*qNod = NULL;
+  WlzDVertex3	*qPos = NULL,
+  		*qDsp = NULL;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
 
-  modelSV.core = NULL;
   if(((mesh0 = tr0->domain.cm3) == NULL) ||
      ((mesh1 = tr1->domain.cm3) == NULL))
   {
@@ -9399,12 +9667,26 @@ static WlzObject *WlzCMeshProduct3D(WlzObject *tr0, WlzObject *tr1,
                                 WLZ_VALUE_ATTACH_NOD, &errNum);
   }
   if(errNum == WLZ_ERR_NONE)
+  {
+    size_t	nNod;
+
+    /* Buffers for the nodes which are not within an element of tr1. */
+    nNod = ALG_MAX(mesh0->res.nod.maxEnt, 1);
+    if(((qNod = (int *)AlcMalloc(sizeof(int) * nNod)) == NULL) ||
+       ((qPos = (WlzDVertex3 *)
+		AlcMalloc(sizeof(WlzDVertex3) * nNod)) == NULL) ||
+       ((qDsp = (WlzDVertex3 *)
+		AlcMalloc(sizeof(WlzDVertex3) * nNod)) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
   {
     int		idN;
     WlzValues	val;
 
     val.x = ixvR;
-    dRange = sqrt(mesh1->maxSqEdgLen);
     trR->values = WlzAssignValues(val, &errNum);
     /* Set displacements for the new constrained mesh transform. */
     for(idN = 0; idN < mesh0->res.nod.maxEnt; ++idN)
@@ -9464,91 +9746,454 @@ static WlzObject *WlzCMeshProduct3D(WlzObject *tr0, WlzObject *tr1,
 					   dsp0[0][2], dsp0[1][2],
 					   dsp0[2][2], dsp0[3][2],
 					   v0);
+	  WLZ_VTX_3_ADD(v1, v1, v0);
+	  WLZ_VTX_3_SUB(v1, v1, nodR->pos);
+	  dspR = (double *)WlzIndexedValueGet(ixvR, nodR->idx);
+	  dspR[0] = v1.vtX;
+	  dspR[1] = v1.vtY;
+	  dspR[2] = v1.vtZ;
 	}
-	else /* idE0 <0, the vertex is not in the mesh. Find the closest
-	      * node to the vertex in the mesh and then use kriging. */
+	else /* idE0 <0, the vertex is not in the mesh. Use kriging from
+	      * the ring of nodes around the closest node, which is done for
+	      * all such vertices together below. */
 	{
-	  int		idN0;
-          WlzCMeshNod3D	*nod0,
-	  		*nodN;
+	  qNod[nQ] = nodR->idx;
+	  qPos[nQ++] = v0;
+	}
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = WlzCMeshKrigNodDsp3D(mesh1, ixv1, nQ, qPos, qDsp);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idQ;
 
-	  idN0 = WlzCMeshClosestNod3D(mesh1, v0);
-          nod0 = (WlzCMeshNod3D *)AlcVectorItemGet(mesh1->res.nod.vec, idN0);
-	  nNbr1 = WlzCMeshNodRingNodIndices3D(nod0, &maxNbrIdxBuf,
-	  			              &nbrIdxBuf, &errNum);
-	  if(errNum == WLZ_ERR_NONE)
+    for(idQ = 0; idQ < nQ; ++idQ)
+    {
+      double	*dspR;
+      WlzCMeshNod3D *nodR;
+
+      nodR = (WlzCMeshNod3D *)AlcVectorItemGet(meshR->res.nod.vec,
+                                               qNod[idQ]);
+      WLZ_VTX_3_ADD(qDsp[idQ], qDsp[idQ], qPos[idQ]);
+      WLZ_VTX_3_SUB(qDsp[idQ], qDsp[idQ], nodR->pos);
+      dspR = (double *)WlzIndexedValueGet(ixvR, nodR->idx);
+      dspR[0] = qDsp[idQ].vtX;
+      dspR[1] = qDsp[idQ].vtY;
+      dspR[2] = qDsp[idQ].vtZ;
+    }
+  }
+  AlcFree(nodTab);
+  AlcFree(qNod);
+  AlcFree(qPos);
+  AlcFree(qDsp);
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(trR);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Uses ordinary kriging to compute the displacements of the
+* 		given query positions, which will usually be outside of
+* 		the given conforming mesh. The neighbourhood of a query
+* 		position is the ring of nodes around the mesh node which
+* 		is closest to it. Query positions are grouped by their
+* 		closest node so that the model semi-variogram of each
+* 		neighbourhood is only computed and decomposed once, with
+* 		the weights for all the group's query positions then
+* 		solved for together. The groups are processed in parallel.
+* \param	mesh			Given conforming mesh.
+* \param	ixv			Node displacements of the mesh.
+* \param	nQ			Number of query positions.
+* \param	qPos			The query positions.
+* \param	qDsp			Destination for the displacements
+* 					at the query positions.
+*/
+static WlzErrorNum		WlzCMeshKrigNodDsp2D(
+				  WlzCMesh2D *mesh,
+				  WlzIndexedValues *ixv,
+				  int nQ,
+				  WlzDVertex2 *qPos,
+				  WlzDVertex2 *qDsp)
+{
+  int		nGrp = 0;
+  int		*qNod = NULL,
+  		*qIdx = NULL,
+		*grp = NULL;
+  double	dRange;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  dRange = sqrt(mesh->maxSqEdgLen);
+  if((nQ > 0) &&
+     (((qNod = (int *)AlcMalloc(sizeof(int) * nQ)) == NULL) ||
+      ((qIdx = (int *)AlcMalloc(sizeof(int) * nQ)) == NULL) ||
+      ((grp = (int *)AlcMalloc(sizeof(int) * (nQ + 1))) == NULL)))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  if((errNum == WLZ_ERR_NONE) && (nQ > 0))
+  {
+    int		idQ;
+
+    /* Find the closest node to each of the query positions. */
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(idQ = 0; idQ < nQ; ++idQ)
+    {
+      qIdx[idQ] = idQ;
+      qNod[idQ] = WlzCMeshClosestNod2D(mesh, qPos[idQ]);
+    }
+    /* Sort the query positions by closest node and then find the groups
+     * of query positions with the same closest node. */
+    (void )AlgHeapSortIdx(qNod, qIdx, nQ, AlgHeapSortCmpIdxIFn);
+    for(idQ = 0; idQ < nQ; ++idQ)
+    {
+      if((idQ == 0) || (qNod[qIdx[idQ]] != qNod[qIdx[idQ - 1]]))
+      {
+        grp[nGrp++] = idQ;
+      }
+    }
+    grp[nGrp] = nQ;
+    if(qNod[qIdx[0]] < 0)
+    {
+      errNum = WLZ_ERR_DOMAIN_DATA;
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (nGrp > 0))
+  {
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      int	idG,
+		nNbr0 = 0,
+		maxKrigBuf = 0,
+		maxNbrIdxBuf = 0,
+		maxPosSVBuf = 0;
+      int	*wSp = NULL,
+		*nbrIdxBuf = NULL;
+      double	*posSV = NULL,
+      		*posSVBuf = NULL;
+      AlgMatrix	modelSV;
+      WlzKrigModelFn modelFn;
+      WlzDVertex2 *nbrPosBuf = NULL;
+      WlzErrorNum errNum2 = WLZ_ERR_NONE;
+
+      modelSV.core = NULL;
+      WlzKrigSetModelFn(&modelFn, WLZ_KRIG_MODELFN_LINEAR,
+			0.0, 0.1, 2.0 * dRange);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for(idG = 0; idG < nGrp; ++idG)
+      {
+	int	i,
+		j,
+		nG,
+		nNbr1 = 0;
+	WlzCMeshNod2D *nod;
+
+	if(errNum2 != WLZ_ERR_NONE)
+	{
+	  continue;
+	}
+	nG = grp[idG + 1] - grp[idG];
+	nod = (WlzCMeshNod2D *)AlcVectorItemGet(mesh->res.nod.vec,
+						qNod[qIdx[grp[idG]]]);
+	nNbr1 = WlzCMeshNodRingNodIndices2D(nod, &maxNbrIdxBuf,
+					    &nbrIdxBuf, &errNum2);
+	if(errNum2 == WLZ_ERR_NONE)
+	{
+	  /* Reallocate buffers if required. */
+	  errNum2 = WlzKrigReallocBuffers2D(&nbrPosBuf, &posSV, &wSp,
+					    &modelSV, &maxKrigBuf,
+					    nNbr1, nNbr0);
+	  nNbr0 = nNbr1;
+	}
+	if((errNum2 == WLZ_ERR_NONE) && (maxPosSVBuf < nG * (nNbr1 + 1)))
+	{
+	  maxPosSVBuf = 2 * nG * (nNbr1 + 1);
+	  if((posSVBuf = (double *)AlcRealloc(posSVBuf,
+	                          sizeof(double) * maxPosSVBuf)) == NULL)
 	  {
-	    /* Reallocate buffers if required. */
-	    errNum = WlzKrigReallocBuffers3D(&nbrPosBuf, &posSV, &wSp,
-					     &modelSV, &maxKrigBuf,
-					     nNbr1, nNbr0);
-	    nNbr0 = nNbr1;
+	    errNum2 = WLZ_ERR_MEM_ALLOC;
 	  }
-	  if(errNum == WLZ_ERR_NONE)
+	}
+	if(errNum2 == WLZ_ERR_NONE)
+	{
+	  for(i = 0; i < nNbr1; ++i)
 	  {
-	    int	i;
+	    nod = (WlzCMeshNod2D *)AlcVectorItemGet(mesh->res.nod.vec,
+						    nbrIdxBuf[i]);
+	    nbrPosBuf[i] = nod->pos;
+	  }
+	  errNum2 = WlzKrigOSetModelSV2D(modelSV, &modelFn, nNbr1, nbrPosBuf,
+					 wSp);
+	}
+	for(j = 0; (errNum2 == WLZ_ERR_NONE) && (j < nG); ++j)
+	{
+	  errNum2 = WlzKrigOSetPosSV2D(posSVBuf + (j * (nNbr1 + 1)),
+				       &modelFn, nNbr1, nbrPosBuf,
+				       qPos[qIdx[grp[idG] + j]]);
+	}
+	if(errNum2 == WLZ_ERR_NONE)
+	{
+	  (void )WlzKrigOWeightsSolveN(modelSV, nG, posSVBuf, wSp,
+				       WLZ_MESH_TOLERANCE);
+	  /* posSVBuf now contains the weights. */
+	  for(j = 0; j < nG; ++j)
+	  {
+	    double	*wgt;
+	    WlzDVertex2 *dsp;
 
+	    wgt = posSVBuf + (j * (nNbr1 + 1));
+	    dsp = qDsp + qIdx[grp[idG] + j];
+	    WLZ_VTX_2_ZERO(*dsp);
 	    for(i = 0; i < nNbr1; ++i)
 	    {
-	      WlzCMeshNod3D *nod;
-	      nod = (WlzCMeshNod3D *)AlcVectorItemGet(mesh1->res.nod.vec,
-						      nbrIdxBuf[i]);
-	      nbrPosBuf[i] = nod->pos;
+	      double	*dsp0;
+
+	      dsp0 = (double *)WlzIndexedValueGet(ixv, nbrIdxBuf[i]);
+	      dsp->vtX += wgt[i] * dsp0[0];
+	      dsp->vtY += wgt[i] * dsp0[1];
 	    }
-	    WlzKrigSetModelFn(&modelFn, WLZ_KRIG_MODELFN_LINEAR,
-			      0.0, 0.1, 2.0 * dRange);
 	  }
+	}
+      }
+      AlgMatrixFree(modelSV);
+      AlcFree(wSp);
+      AlcFree(posSV);
+      AlcFree(posSVBuf);
+      AlcFree(nbrIdxBuf);
+      AlcFree(nbrPosBuf);
+      if(errNum2 != WLZ_ERR_NONE)
+      {
+#ifdef _OPENMP
+#pragma omp critical (WlzCMeshKrigNodDsp2D)
+	{
+#endif
 	  if(errNum == WLZ_ERR_NONE)
 	  {
-	    errNum = WlzKrigOSetModelSV3D(modelSV, &modelFn, nNbr1, nbrPosBuf,
-					  wSp);
+	    errNum = errNum2;
 	  }
-	  if(errNum == WLZ_ERR_NONE)
+#ifdef _OPENMP
+	}
+#endif
+      }
+    }
+  }
+  AlcFree(qNod);
+  AlcFree(qIdx);
+  AlcFree(grp);
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Uses ordinary kriging to compute the displacements of the
+* 		given query positions, which will usually be outside of
+* 		the given conforming mesh. The neighbourhood of a query
+* 		position is the ring of nodes around the mesh node which
+* 		is closest to it. Query positions are grouped by their
+* 		closest node so that the model semi-variogram of each
+* 		neighbourhood is only computed and decomposed once, with
+* 		the weights for all the group's query positions then
+* 		solved for together. The groups are processed in parallel.
+* \param	mesh			Given conforming mesh.
+* \param	ixv			Node displacements of the mesh.
+* \param	nQ			Number of query positions.
+* \param	qPos			The query positions.
+* \param	qDsp			Destination for the displacements
+* 					at the query positions.
+*/
+static WlzErrorNum		WlzCMeshKrigNodDsp3D(
+				  WlzCMesh3D *mesh,
+				  WlzIndexedValues *ixv,
+				  int nQ,
+				  WlzDVertex3 *qPos,
+				  WlzDVertex3 *qDsp)
+{
+  int		nGrp = 0;
+  int		*qNod = NULL,
+  		*qIdx = NULL,
+		*grp = NULL;
+  double	dRange;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  dRange = sqrt(mesh->maxSqEdgLen);
+  if((nQ > 0) &&
+     (((qNod = (int *)AlcMalloc(sizeof(int) * nQ)) == NULL) ||
+      ((qIdx = (int *)AlcMalloc(sizeof(int) * nQ)) == NULL) ||
+      ((grp = (int *)AlcMalloc(sizeof(int) * (nQ + 1))) == NULL)))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  if((errNum == WLZ_ERR_NONE) && (nQ > 0))
+  {
+    int		idQ;
+
+    /* Find the closest node to each of the query positions. */
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(idQ = 0; idQ < nQ; ++idQ)
+    {
+      qIdx[idQ] = idQ;
+      qNod[idQ] = WlzCMeshClosestNod3D(mesh, qPos[idQ]);
+    }
+    /* Sort the query positions by closest node and then find the groups
+     * of query positions with the same closest node. */
+    (void )AlgHeapSortIdx(qNod, qIdx, nQ, AlgHeapSortCmpIdxIFn);
+    for(idQ = 0; idQ < nQ; ++idQ)
+    {
+      if((idQ == 0) || (qNod[qIdx[idQ]] != qNod[qIdx[idQ - 1]]))
+      {
+        grp[nGrp++] = idQ;
+      }
+    }
+    grp[nGrp] = nQ;
+    if(qNod[qIdx[0]] < 0)
+    {
+      errNum = WLZ_ERR_DOMAIN_DATA;
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (nGrp > 0))
+  {
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      int	idG,
+		nNbr0 = 0,
+		maxKrigBuf = 0,
+		maxNbrIdxBuf = 0,
+		maxPosSVBuf = 0;
+      int	*wSp = NULL,
+		*nbrIdxBuf = NULL;
+      double	*posSV = NULL,
+      		*posSVBuf = NULL;
+      AlgMatrix	modelSV;
+      WlzKrigModelFn modelFn;
+      WlzDVertex3 *nbrPosBuf = NULL;
+      WlzErrorNum errNum2 = WLZ_ERR_NONE;
+
+      modelSV.core = NULL;
+      WlzKrigSetModelFn(&modelFn, WLZ_KRIG_MODELFN_LINEAR,
+			0.0, 0.1, 2.0 * dRange);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for(idG = 0; idG < nGrp; ++idG)
+      {
+	int	i,
+		j,
+		nG,
+		nNbr1 = 0;
+	WlzCMeshNod3D *nod;
+
+	if(errNum2 != WLZ_ERR_NONE)
+	{
+	  continue;
+	}
+	nG = grp[idG + 1] - grp[idG];
+	nod = (WlzCMeshNod3D *)AlcVectorItemGet(mesh->res.nod.vec,
+						qNod[qIdx[grp[idG]]]);
+	nNbr1 = WlzCMeshNodRingNodIndices3D(nod, &maxNbrIdxBuf,
+					    &nbrIdxBuf, &errNum2);
+	if(errNum2 == WLZ_ERR_NONE)
+	{
+	  /* Reallocate buffers if required. */
+	  errNum2 = WlzKrigReallocBuffers3D(&nbrPosBuf, &posSV, &wSp,
+					    &modelSV, &maxKrigBuf,
+					    nNbr1, nNbr0);
+	  nNbr0 = nNbr1;
+	}
+	if((errNum2 == WLZ_ERR_NONE) && (maxPosSVBuf < nG * (nNbr1 + 1)))
+	{
+	  maxPosSVBuf = 2 * nG * (nNbr1 + 1);
+	  if((posSVBuf = (double *)AlcRealloc(posSVBuf,
+	                          sizeof(double) * maxPosSVBuf)) == NULL)
 	  {
-	    errNum = WlzKrigOSetPosSV3D(posSV, &modelFn, nNbr1, nbrPosBuf, v0);
+	    errNum2 = WLZ_ERR_MEM_ALLOC;
 	  }
-	  if(errNum == WLZ_ERR_NONE)
+	}
+	if(errNum2 == WLZ_ERR_NONE)
+	{
+	  for(i = 0; i < nNbr1; ++i)
 	  {
-	    int	i;
+	    nod = (WlzCMeshNod3D *)AlcVectorItemGet(mesh->res.nod.vec,
+						    nbrIdxBuf[i]);
+	    nbrPosBuf[i] = nod->pos;
+	  }
+	  errNum2 = WlzKrigOSetModelSV3D(modelSV, &modelFn, nNbr1, nbrPosBuf,
+					 wSp);
+	}
+	for(j = 0; (errNum2 == WLZ_ERR_NONE) && (j < nG); ++j)
+	{
+	  errNum2 = WlzKrigOSetPosSV3D(posSVBuf + (j * (nNbr1 + 1)),
+				       &modelFn, nNbr1, nbrPosBuf,
+				       qPos[qIdx[grp[idG] + j]]);
+	}
+	if(errNum2 == WLZ_ERR_NONE)
+	{
+	  (void )WlzKrigOWeightsSolveN(modelSV, nG, posSVBuf, wSp,
+				       WLZ_MESH_TOLERANCE);
+	  /* posSVBuf now contains the weights. */
+	  for(j = 0; j < nG; ++j)
+	  {
+	    double	*wgt;
+	    WlzDVertex3 *dsp;
 
-	    v1.vtX = 0.0;
-	    v1.vtY = 0.0;
-	    v1.vtZ = 0.0;
-	    WlzKrigOWeightsSolve(modelSV, posSV, wSp, WLZ_MESH_TOLERANCE);
-	    /* posSV now contains the weights. */
-	    for(i = 0; i < nNbr1; ++i) 
+	    wgt = posSVBuf + (j * (nNbr1 + 1));
+	    dsp = qDsp + qIdx[grp[idG] + j];
+	    WLZ_VTX_3_ZERO(*dsp);
+	    for(i = 0; i < nNbr1; ++i)
 	    {
-	      double *dsp0;
-
-	      nodN = (WlzCMeshNod3D *)AlcVectorItemGet(mesh1->res.nod.vec,
-	                                               nbrIdxBuf[i]);
-	      dsp0 = (double *)WlzIndexedValueGet(ixv1, nodN->idx);
-	      v1.vtX += posSV[i] * dsp0[0];
-	      v1.vtY += posSV[i] * dsp0[1];
-	      v1.vtZ += posSV[i] * dsp0[2];
+	      double	*dsp0;
+
+	      dsp0 = (double *)WlzIndexedValueGet(ixv, nbrIdxBuf[i]);
+	      dsp->vtX += wgt[i] * dsp0[0];
+	      dsp->vtY += wgt[i] * dsp0[1];
+	      dsp->vtZ += wgt[i] * dsp0[2];
 	    }
 	  }
 	}
-	WLZ_VTX_3_ADD(v1, v1, v0);
-	WLZ_VTX_3_SUB(v1, v1, nodR->pos);
-	dspR = (double *)WlzIndexedValueGet(ixvR, nodR->idx);
-	dspR[0] = v1.vtX;
-	dspR[1] = v1.vtY;
-	dspR[2] = v1.vtZ;
+      }
+      AlgMatrixFree(modelSV);
+      AlcFree(wSp);
+      AlcFree(posSV);
+      AlcFree(posSVBuf);
+      AlcFree(nbrIdxBuf);
+      AlcFree(nbrPosBuf);
+      if(errNum2 != WLZ_ERR_NONE)
+      {
+#ifdef _OPENMP
+#pragma omp critical (WlzCMeshKrigNodDsp3D)
+	{
+#endif
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    errNum = errNum2;
+	  }
+#ifdef _OPENMP
+	}
+#endif
       }
     }
   }
-  AlcFree(wSp);
-  AlcFree(posSV);
-  AlcFree(nodTab);
-  AlcFree(nbrIdxBuf);
-  AlcFree(nbrPosBuf);
-  AlgMatrixFree(modelSV);
-  if(dstErr)
-  {
-    *dstErr = errNum;
-  }
-  return(trR);
+  AlcFree(qNod);
+  AlcFree(qIdx);
+  AlcFree(grp);
+  return(errNum);
 }
 
 /*!
@@ -43,12 +43,21 @@ static char _WlzConstruct3D_c[] = "University of Edinburgh $Id$";
 #include <stdio.h>
 #include <Wlz.h>
 
+static WlzErrorNum		WlzConstruct3DPlaceSection(
+				  WlzDomain dom3D,
+				  WlzValues val3D,
+				  int idx,
+				  WlzObject *obj2D);
+
 /*!
 * \return	New 3D object.
 * \ingroup	WlzAllocation
 * \brief	Constructs a 3D domain object from 2D domain objects read
 *		from the given files. Each file is read in turn and added
-*		to the 3D object. An empty plane can be specified by
+*		to the 3D object. The sections are read and decoded
+*		concurrently when OpenMP is available, with each section
+*		placed directly in the preallocated plane domain and
+*		voxel value table. An empty plane can be specified by
 *		setting the file string to NULL. Either all or none of
 *		the 2D objects must have values. When the 2D objects
 *		have values then the background value of the first 2D
@@ -140,57 +149,65 @@ WlzObject	*WlzConstruct3DObjFromFile(int nFileStr, char **fileStr,
       }
     }				    
   }
-  idx = 0;
-  while((errNum == WLZ_ERR_NONE) && (idx < nFileStr))
+  /* Place the first section which has already been read. */
+  if(errNum == WLZ_ERR_NONE)
   {
-    if(obj2D)
+    errNum = WlzConstruct3DPlaceSection(dom3D, val3D, 0, obj2D);
+  }
+  (void )WlzFreeObj(obj2D);
+  obj2D = NULL;
+  /* Read and decode the remaining sections concurrently. Each section
+   * is placed in its own slot of the preallocated plane domain and voxel
+   * value table as soon as it has been decoded, so that at most one
+   * decoded but unplaced section is held by each thread. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for(idx = 1; idx < nFileStr; ++idx)
     {
-      switch(obj2D->type)
+      int	skip;
+      WlzErrorNum errNum2D = WLZ_ERR_NONE;
+
+      /* The shared error is only accessed in the critical section,
+       * sections after an error being skipped. */
+#ifdef _OPENMP
+#pragma omp critical (WlzConstruct3DObjFromFile)
+#endif
       {
-	case WLZ_EMPTY_OBJ:
-	  break;
-	case WLZ_2D_DOMAINOBJ:
-	  if(obj2D->domain.core == NULL)
-	  {
-	    errNum = WLZ_ERR_DOMAIN_NULL;
-	  }
-	  break;
-	default:
-	  errNum = WLZ_ERR_OBJECT_TYPE;
-	  break;
+        skip = (errNum != WLZ_ERR_NONE);
       }
-      if(errNum == WLZ_ERR_NONE)
+      if(!skip && (*(fileStr + idx) != NULL))
       {
-	*(dom3D.p->domains + idx) = WlzAssignDomain(obj2D->domain, NULL);
-	if(val3D.core)
+	FILE	*fP2D;
+	WlzObject *obj2DI = NULL;
+
+	if((fP2D = fopen(*(fileStr + idx), "r")) == NULL)
 	{
-	  if((obj2D->domain.core != NULL) && (obj2D->values.core == NULL))
-	  {
-	    errNum = WLZ_ERR_VALUES_NULL;
-	  }
-	  else
-	  {
-	    *(val3D.vox->values + idx) = WlzAssignValues(obj2D->values, NULL);
-	  }
+	  errNum2D = WLZ_ERR_READ_EOF;
 	}
-      }
-      WlzFreeObj(obj2D);
-      obj2D = NULL;
-    }
-    if(errNum == WLZ_ERR_NONE)
-    {
-      ++idx;
-      if((idx < nFileStr) && *(fileStr + idx))
-      {
-	if((fP = fopen(*(fileStr + idx), "r")) == NULL)
+	else
 	{
-	  errNum = WLZ_ERR_READ_EOF;
+	  obj2DI = WlzReadObj(fP2D, &errNum2D);
+	  (void )fclose(fP2D);
 	}
-	else
+	if(errNum2D == WLZ_ERR_NONE)
 	{
-	  obj2D = WlzReadObj(fP, &errNum);
-	  (void )fclose(fP);
-	  fP = NULL;
+	  errNum2D = WlzConstruct3DPlaceSection(dom3D, val3D, idx, obj2DI);
+	}
+	(void )WlzFreeObj(obj2DI);
+      }
+      if(errNum2D != WLZ_ERR_NONE)
+      {
+#ifdef _OPENMP
+#pragma omp critical (WlzConstruct3DObjFromFile)
+#endif
+	{
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    errNum = errNum2D;
+	  }
 	}
       }
     }
@@ -370,3 +387,56 @@ WlzObject	*WlzConstruct3DObjFromObj(int nObjs, WlzObject **objs,
   }
   return(obj3D);
 }
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzAllocation
+* \brief	Places the domain and values of the given 2D object in
+* 		the indexed plane of the given 3D domain and values.
+* 		Distinct planes may be placed concurrently.
+* \param	dom3D			Plane domain.
+* \param	val3D			Voxel value table, may be NULL.
+* \param	idx			Index of the plane relative to the
+* 					first plane.
+* \param	obj2D			Given 2D object, may be NULL.
+*/
+static WlzErrorNum WlzConstruct3DPlaceSection(WlzDomain dom3D,
+					WlzValues val3D,
+					int idx, WlzObject *obj2D)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(obj2D)
+  {
+    switch(obj2D->type)
+    {
+      case WLZ_EMPTY_OBJ:
+	break;
+      case WLZ_2D_DOMAINOBJ:
+	if(obj2D->domain.core == NULL)
+	{
+	  errNum = WLZ_ERR_DOMAIN_NULL;
+	}
+	break;
+      default:
+	errNum = WLZ_ERR_OBJECT_TYPE;
+	break;
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      *(dom3D.p->domains + idx) = WlzAssignDomain(obj2D->domain, NULL);
+      if(val3D.core)
+      {
+	if((obj2D->domain.core != NULL) && (obj2D->values.core == NULL))
+	{
+	  errNum = WLZ_ERR_VALUES_NULL;
+	}
+	else
+	{
+	  *(val3D.vox->values + idx) = WlzAssignValues(obj2D->values, NULL);
+	}
+      }
+    }
+  }
+  return(errNum);
+}
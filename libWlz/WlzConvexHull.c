@@ -74,6 +74,35 @@ static int 			WlzConvHullFcePlnIsn(
 				  int z,
 				  WlzDVertex2 *isn,
 				  int f);
+static int			WlzConvexHullLnEnds(
+				  WlzIntervalDomain *iDom,
+				  int ln,
+				  int *dstLft,
+				  int *dstRgt);
+static int			WlzConvexHullCull2(
+				  int nVtx,
+				  WlzIVertex2 *vtx);
+static int			WlzConvexHullCull3(
+				  int nVtx,
+				  WlzIVertex3 *vtx);
+static WlzIVertex2		*WlzConvexHullItvVtx2(
+				  WlzIntervalDomain *iDom,
+				  int *dstNVtx,
+				  WlzErrorNum *dstErr);
+static WlzIVertex3		*WlzConvexHullItvVtx3(
+				  WlzPlaneDomain *pDom,
+				  int *dstNVtx,
+				  WlzErrorNum *dstErr);
+static WlzErrorNum		WlzConvexHullMarkSlt(
+				  int n,
+				  WlzIVertex2 *pos,
+				  size_t *slt,
+				  WlzUByte *flg,
+				  WlzUByte bit);
+static WlzConvHullDomain3	*WlzConvexHullFromVtxI3(
+				  int nVtx,
+				  WlzIVertex3 *vtx,
+				  WlzErrorNum *dstErr);
 
 /*!
 * \return       New 2D convex hull domain.
@@ -541,152 +570,48 @@ WlzObject 			*WlzObjToConvexHull(
 	  {
 	    errNum = WLZ_ERR_DOMAIN_NULL;
 	  }
-	  else
-	  {
-	    bObj = WlzObjToBoundary(gObj, 0, &errNum);
-	  }
-	  if(errNum == WLZ_ERR_NONE)
-	  {
-	    cObj = WlzObjToConvexHull(bObj, &errNum);
-	  }
-	  (void )WlzFreeObj(bObj);
-	}
-        break;
-      case WLZ_3D_DOMAINOBJ:
-	{
-	  int 	nPln;
-	  WlzPlaneDomain *pDom;
-	  WlzObject	**allObj = NULL;
-
-	  if(gObj->domain.core == NULL)
-	  {
-	    errNum = WLZ_ERR_DOMAIN_NULL;
-	  }
-	  else
-	  {
-	    pDom = gObj->domain.p;
-	    /* Allocate an array for planar convex hulls. */
-	    if((nPln = pDom->lastpl - pDom->plane1 + 1) <= 0)
-	    {
-	      errNum = WLZ_ERR_DOMAIN_DATA;
-	    }
-	  }
-	  if(errNum == WLZ_ERR_NONE)
+	  else if((gObj->domain.core->type == WLZ_INTERVALDOMAIN_INTVL) ||
+	          (gObj->domain.core->type == WLZ_INTERVALDOMAIN_RECT))
 	  {
-	    if((allObj = (WlzObject **)
-	                 AlcCalloc(nPln, sizeof(WlzObject *))) == NULL)
+	    /* Only the first and last pixel of each line can be convex
+	     * hull vertices. */
+	    vType = WLZ_VERTEX_I2;
+	    vtx.i2 = WlzConvexHullItvVtx2(gObj->domain.i, &nVtx, &errNum);
+	    if(errNum == WLZ_ERR_NONE)
 	    {
-	      errNum = WLZ_ERR_MEM_ALLOC;
-	    }
-	  }
-	  /* For each plane compute the planar convex hull. */
-	  if(errNum == WLZ_ERR_NONE)
-	  {
-	    int		p;
-
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-	    for(p = 0; p < nPln; ++p)
-	    {
-	      WlzDomain	*dom2;
-	      WlzObject	*obj2D = NULL;
-	      WlzErrorNum errNum2 = WLZ_ERR_NONE;
-
-	      if(errNum == WLZ_ERR_NONE)
-	      {
-		dom2 = pDom->domains + p;
-		if((*dom2).core != NULL)
-		{
-		  obj2D = WlzAssignObject(
-			  WlzMakeMain(WLZ_2D_DOMAINOBJ, *dom2, nullVal,
-				      NULL, NULL, &errNum2), NULL);
-		  if(errNum2 == WLZ_ERR_NONE)
-		  {
-		    allObj[p] = WlzObjToConvexHull(obj2D, &errNum2);
-		  }
-		  if((errNum2 != WLZ_ERR_NONE) &&
-		     (errNum2 != WLZ_ERR_DEGENERATE))
-		  {
-#ifdef _OPENMP
-#pragma omp critical
-		    {
-#endif
-		      if(errNum == WLZ_ERR_NONE)
-		      {
-		        errNum = errNum2;
-		      }
-#ifdef _OPENMP
-		    }
-#endif
-		  }
-		  (void )WlzFreeObj(obj2D);
-		}
-	      }
+	      dom.cvh2 = WlzConvexHullFromVtx2(vType, nVtx, vtx, &errNum);
 	    }
 	  }
-	  /* Create an array of 3D integer vertices which are the vertices
-	   * of the planar convex hulls. */
-	  if(errNum == WLZ_ERR_NONE)           
+	  else
 	  {
-	    int		p;                     
-
-	    for(p = 0; p < nPln; ++p)          
-	    {
-	      if(allObj[p])
-	      {
-	        nVtx += allObj[p]->domain.cvh2->nVertices;
-	      }
-	    }
-	    if((vtx.i3 = (WlzIVertex3 *)
-	                 AlcMalloc(sizeof(WlzIVertex3) * nVtx)) == NULL)
+	    bObj = WlzObjToBoundary(gObj, 0, &errNum);
+	    if(errNum == WLZ_ERR_NONE)
 	    {
-	      errNum = WLZ_ERR_MEM_ALLOC;
+	      cObj = WlzObjToConvexHull(bObj, &errNum);
 	    }
+	    (void )WlzFreeObj(bObj);
 	  }
+	}
+        break;
+      case WLZ_3D_DOMAINOBJ:
+	if(gObj->domain.core == NULL)
+	{
+	  errNum = WLZ_ERR_DOMAIN_NULL;
+	}
+	else if(gObj->domain.core->type != WLZ_PLANEDOMAIN_DOMAIN)
+	{
+	  errNum = WLZ_ERR_DOMAIN_TYPE;
+	}
+	else
+	{
+	  /* Collect the candidate vertices, those line ends which are
+	   * vertices of the convex hulls of both their plane and line
+	   * sections, then compute the 3D convex hull of these. */
+	  vType = WLZ_VERTEX_I3;
+	  vtx.i3 = WlzConvexHullItvVtx3(gObj->domain.p, &nVtx, &errNum);
 	  if(errNum == WLZ_ERR_NONE)
 	  {
-	    int		p;         
-	    WlzIVertex3 *v0;
-
-	    v0 = vtx.i3;
-	    for(p = 0; p < nPln; ++p)
-	    {
-	      if(allObj[p])
-	      {
-		int	j,
-			z;
-                WlzIVertex2 *v1;
-		WlzConvHullDomain2 *cvh;
-		
-		z = pDom->plane1 + p;
-		cvh = allObj[p]->domain.cvh2;
-		v1 = cvh->vertices.i2;
-		for(j = 0; j < cvh->nVertices; ++j)
-		{
-		  WLZ_VTX_3_SET((*v0), v1->vtX, v1->vtY, z); 
-		  ++v0;
-		  ++v1;
-		}
-	      }
-	    }
-	  }
-	  /* Free all planar convex hulls. */
-	  if(allObj)
-	  {
-	    int		p;         
-
-	    for(p = 0; p < nPln; ++p)
-	    {
-	      (void )WlzFreeObj(allObj[p]);
-	    }
-	    AlcFree(allObj);
-	  }
-	  /* Compute the 3D convex hull of all the planar convex hulls. */
-	  if(errNum == WLZ_ERR_NONE)           
-	  {
-	    vType = WLZ_VERTEX_I3;
-	    dom.cvh3 = WlzConvexHullFromVtx3(vType, nVtx, vtx, &errNum);
+	    dom.cvh3 = WlzConvexHullFromVtxI3(nVtx, vtx.i3, &errNum);
 	  }
 	}
         break;
@@ -2073,3 +1998,785 @@ static WlzObject 		*WlzObjToConvexPolygon3d(
   return(polygon);
 }
 
+/*!
+* \return	Non-zero if the line of the domain is not empty.
+* \ingroup	WlzConvexHull
+* \brief	Finds the column coordinates of the first and last pixel
+* 		of the given line of an interval domain. Only these pixels
+* 		of the line can be vertices of a convex hull which
+* 		encloses the domain.
+* \param	iDom			Given interval domain, may be NULL.
+* \param	ln			Given line.
+* \param	dstLft			Destination pointer for the first
+* 					column of the line.
+* \param	dstRgt			Destination pointer for the last
+* 					column of the line.
+*/
+static int			WlzConvexHullLnEnds(
+				  WlzIntervalDomain *iDom,
+				  int ln,
+				  int *dstLft,
+				  int *dstRgt)
+{
+  int		nonEmpty = 0;
+
+  if((iDom != NULL) && (ln >= iDom->line1) && (ln <= iDom->lastln))
+  {
+    switch(iDom->type)
+    {
+      case WLZ_INTERVALDOMAIN_INTVL:
+	{
+	  WlzIntervalLine *itvLn;
+
+	  itvLn = iDom->intvlines + ln - iDom->line1;
+	  if(itvLn->nintvs > 0)
+	  {
+	    *dstLft = iDom->kol1 + itvLn->intvs[0].ileft;
+	    *dstRgt = iDom->kol1 + itvLn->intvs[itvLn->nintvs - 1].iright;
+	    nonEmpty = 1;
+	  }
+	}
+	break;
+      case WLZ_INTERVALDOMAIN_RECT:
+	*dstLft = iDom->kol1;
+	*dstRgt = iDom->lastkl;
+	nonEmpty = 1;
+	break;
+      default:
+	break;
+    }
+  }
+  return(nonEmpty);
+}
+
+/*!
+* \return	Array of candidate convex hull vertices or NULL on error.
+* \ingroup	WlzConvexHull
+* \brief	Collects the first and last pixel of each line of the
+* 		given 2D interval domain, these being the only pixels
+* 		that may be vertices of it's convex hull, and then culls
+* 		those which are inside the octagon of extreme pixels.
+* \param	iDom			Given interval domain.
+* \param	dstNVtx			Destination pointer for the number
+* 					of vertices.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+static WlzIVertex2		*WlzConvexHullItvVtx2(
+				  WlzIntervalDomain *iDom,
+				  int *dstNVtx,
+				  WlzErrorNum *dstErr)
+{
+  int		nLn,
+  		nVtx = 0;
+  WlzIVertex2	*vtx = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((nLn = iDom->lastln - iDom->line1 + 1) <= 0)
+  {
+    errNum = WLZ_ERR_DOMAIN_DATA;
+  }
+  else if((vtx = (WlzIVertex2 *)
+                 AlcMalloc(sizeof(WlzIVertex2) * 2 * nLn)) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    int		ln;
+
+    for(ln = iDom->line1; ln <= iDom->lastln; ++ln)
+    {
+      int	lft,
+      		rgt;
+
+      if(WlzConvexHullLnEnds(iDom, ln, &lft, &rgt))
+      {
+        WLZ_VTX_2_SET(vtx[nVtx], lft, ln);
+	++nVtx;
+	if(rgt != lft)
+	{
+	  WLZ_VTX_2_SET(vtx[nVtx], rgt, ln);
+	  ++nVtx;
+	}
+      }
+    }
+    if(nVtx == 0)
+    {
+      errNum = WLZ_ERR_DOMAIN_DATA;
+    }
+    else
+    {
+      nVtx = WlzConvexHullCull2(nVtx, vtx);
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    *dstNVtx = nVtx;
+  }
+  else
+  {
+    AlcFree(vtx);
+    vtx = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(vtx);
+}
+
+/*!
+* \return	Array of candidate convex hull vertices or NULL on error.
+* \ingroup	WlzConvexHull
+* \brief	Collects the candidate vertices for the convex hull of
+* 		the given 3D plane domain. Only the first and last voxel
+* 		of each line of each plane may be convex hull vertices.
+* 		Of these only those which are vertices of both the
+* 		2D convex hull of their plane and the 2D convex hull
+* 		of the same line through all planes are kept, since a
+* 		vertex of a convex hull must also be a vertex of the
+* 		convex hull of any section through it. The 2D convex
+* 		hulls of the planes and of the lines are computed in
+* 		parallel.
+* \param	pDom			Given plane domain.
+* \param	dstNVtx			Destination pointer for the number
+* 					of vertices.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+static WlzIVertex3		*WlzConvexHullItvVtx3(
+				  WlzPlaneDomain *pDom,
+				  int *dstNVtx,
+				  WlzErrorNum *dstErr)
+{
+  int		nPl,
+  		nLn,
+		nVtx = 0;
+  WlzUByte	*flg = NULL;
+  WlzIVertex3	*vtx = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  nPl = pDom->lastpl - pDom->plane1 + 1;
+  nLn = pDom->lastln - pDom->line1 + 1;
+  if((nPl <= 0) || (nLn <= 0))
+  {
+    errNum = WLZ_ERR_DOMAIN_DATA;
+  }
+  else if((flg = (WlzUByte *)
+                 AlcCalloc((size_t )nPl * nLn * 2, sizeof(WlzUByte))) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  /* Mark the line ends which are vertices of the convex hull of their
+   * plane. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		p;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(p = 0; p < nPl; ++p)
+    {
+      if(errNum == WLZ_ERR_NONE)
+      {
+	int	l,
+		n = 0;
+	size_t	*slt = NULL;
+	WlzIVertex2 *pos = NULL;
+	WlzErrorNum errNum2 = WLZ_ERR_NONE;
+
+	if(((pos = (WlzIVertex2 *)
+		   AlcMalloc(sizeof(WlzIVertex2) * 2 * nLn)) == NULL) ||
+	   ((slt = (size_t *)AlcMalloc(sizeof(size_t) * 2 * nLn)) == NULL))
+	{
+	  errNum2 = WLZ_ERR_MEM_ALLOC;
+	}
+	else
+	{
+	  for(l = 0; l < nLn; ++l)
+	  {
+	    int	lft,
+		rgt;
+
+	    if(WlzConvexHullLnEnds(pDom->domains[p].i, pDom->line1 + l,
+				   &lft, &rgt))
+	    {
+	      WLZ_VTX_2_SET(pos[n], lft, l);
+	      slt[n++] = (((size_t )p * nLn) + l) * 2;
+	      if(rgt != lft)
+	      {
+		WLZ_VTX_2_SET(pos[n], rgt, l);
+		slt[n++] = ((((size_t )p * nLn) + l) * 2) + 1;
+	      }
+	    }
+	  }
+	  errNum2 = WlzConvexHullMarkSlt(n, pos, slt, flg, 1);
+	}
+	AlcFree(pos);
+	AlcFree(slt);
+	if(errNum2 != WLZ_ERR_NONE)
+	{
+#ifdef _OPENMP
+#pragma omp critical (WlzConvexHullItvVtx3)
+	  {
+#endif
+	    if(errNum == WLZ_ERR_NONE)
+	    {
+	      errNum = errNum2;
+	    }
+#ifdef _OPENMP
+	  }
+#endif
+	}
+      }
+    }
+  }
+  /* Mark the line ends which are vertices of the convex hull of the same
+   * line through all planes. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		l;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(l = 0; l < nLn; ++l)
+    {
+      if(errNum == WLZ_ERR_NONE)
+      {
+	int	p,
+		n = 0;
+	size_t	*slt = NULL;
+	WlzIVertex2 *pos = NULL;
+	WlzErrorNum errNum2 = WLZ_ERR_NONE;
+
+	if(((pos = (WlzIVertex2 *)
+		   AlcMalloc(sizeof(WlzIVertex2) * 2 * nPl)) == NULL) ||
+	   ((slt = (size_t *)AlcMalloc(sizeof(size_t) * 2 * nPl)) == NULL))
+	{
+	  errNum2 = WLZ_ERR_MEM_ALLOC;
+	}
+	else
+	{
+	  for(p = 0; p < nPl; ++p)
+	  {
+	    int	lft,
+		rgt;
+
+	    if(WlzConvexHullLnEnds(pDom->domains[p].i, pDom->line1 + l,
+				   &lft, &rgt))
+	    {
+	      WLZ_VTX_2_SET(pos[n], lft, p);
+	      slt[n++] = (((size_t )p * nLn) + l) * 2;
+	      if(rgt != lft)
+	      {
+		WLZ_VTX_2_SET(pos[n], rgt, p);
+		slt[n++] = ((((size_t )p * nLn) + l) * 2) + 1;
+	      }
+	    }
+	  }
+	  errNum2 = WlzConvexHullMarkSlt(n, pos, slt, flg, 2);
+	}
+	AlcFree(pos);
+	AlcFree(slt);
+	if(errNum2 != WLZ_ERR_NONE)
+	{
+#ifdef _OPENMP
+#pragma omp critical (WlzConvexHullItvVtx3)
+	  {
+#endif
+	    if(errNum == WLZ_ERR_NONE)
+	    {
+	      errNum = errNum2;
+	    }
+#ifdef _OPENMP
+	  }
+#endif
+	}
+      }
+    }
+  }
+  /* Collect the line ends which have been marked by both the plane and
+   * line convex hulls. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    size_t	s,
+    		nSlt;
+
+    nSlt = (size_t )nPl * nLn * 2;
+    for(s = 0; s < nSlt; ++s)
+    {
+      nVtx += (flg[s] == 3);
+    }
+    if(nVtx == 0)
+    {
+      errNum = WLZ_ERR_DOMAIN_DATA;
+    }
+    else if((vtx = (WlzIVertex3 *)
+		   AlcMalloc(sizeof(WlzIVertex3) * nVtx)) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      int	n = 0;
+
+      for(s = 0; s < nSlt; s += 2)
+      {
+	if(flg[s] | flg[s + 1])
+	{
+	  int	p,
+		l,
+		lft,
+		rgt;
+
+	  p = (int )(s / (2 * (size_t )nLn));
+	  l = (int )((s / 2) % nLn);
+	  (void )WlzConvexHullLnEnds(pDom->domains[p].i, pDom->line1 + l,
+				     &lft, &rgt);
+	  if(flg[s] == 3)
+	  {
+	    WLZ_VTX_3_SET(vtx[n], lft, pDom->line1 + l, pDom->plane1 + p);
+	    ++n;
+	  }
+	  if(flg[s + 1] == 3)
+	  {
+	    WLZ_VTX_3_SET(vtx[n], rgt, pDom->line1 + l, pDom->plane1 + p);
+	    ++n;
+	  }
+	}
+      }
+      nVtx = WlzConvexHullCull3(nVtx, vtx);
+    }
+  }
+  AlcFree(flg);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    *dstNVtx = nVtx;
+  }
+  else
+  {
+    AlcFree(vtx);
+    vtx = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(vtx);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzConvexHull
+* \brief	Computes the 2D convex hull of the given positions and
+* 		sets the given bit in the flags of the slots of those
+* 		positions which are convex hull vertices.
+* \param	n			Number of positions.
+* \param	pos			Given positions.
+* \param	slt			Slot indices of the positions.
+* \param	flg			Array of slot flags.
+* \param	bit			Bit to set in the slot flags.
+*/
+static WlzErrorNum		WlzConvexHullMarkSlt(
+				  int n,
+				  WlzIVertex2 *pos,
+				  size_t *slt,
+				  WlzUByte *flg,
+				  WlzUByte bit)
+{
+  int		i;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(n < 3)
+  {
+    for(i = 0; i < n; ++i)
+    {
+      flg[slt[i]] |= bit;
+    }
+  }
+  else
+  {
+    int		nC;
+    int		*idx = NULL;
+
+    nC = WlzConvHullClarkson2I(pos, n, &idx, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      for(i = 0; i < nC; ++i)
+      {
+	flg[slt[idx[i]]] |= bit;
+      }
+    }
+    AlcFree(idx);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Number of vertices remaining.
+* \ingroup	WlzConvexHull
+* \brief	Culls the given 2D vertices using the Akl-Toussaint
+* 		heuristic. The vertices which are extreme in the eight
+* 		directions parallel to the axes and their diagonals form
+* 		a convex polygon and any vertex strictly within this
+* 		polygon can not be a vertex of the convex hull. The
+* 		remaining vertices are compacted to the start of the
+* 		array with their order preserved.
+* \param	nVtx			Number of vertices.
+* \param	vtx			Given vertices.
+*/
+static int			WlzConvexHullCull2(
+				  int nVtx,
+				  WlzIVertex2 *vtx)
+{
+  if(nVtx > 8)
+  {
+    int		i,
+    		j,
+		nC;
+    int		eIdx[8];
+    int		*idx = NULL;
+    WlzIVertex2	eVtx[8];
+    const int	dir[8][2] = {{ 1,  0}, {-1,  0}, { 0,  1}, { 0, -1},
+    			     { 1,  1}, {-1, -1}, { 1, -1}, {-1,  1}};
+
+    for(j = 0; j < 8; ++j)
+    {
+      eIdx[j] = 0;
+    }
+    for(i = 1; i < nVtx; ++i)
+    {
+      for(j = 0; j < 8; ++j)
+      {
+	WlzIVertex2 u,
+		    v;
+
+	u = vtx[i];
+	v = vtx[eIdx[j]];
+	if((dir[j][0] * (u.vtX - v.vtX)) + (dir[j][1] * (u.vtY - v.vtY)) > 0)
+	{
+	  eIdx[j] = i;
+	}
+      }
+    }
+    for(j = 0; j < 8; ++j)
+    {
+      eVtx[j] = vtx[eIdx[j]];
+    }
+    nC = WlzConvHullClarkson2I(eVtx, 8, &idx, NULL);
+    if(nC >= 3)
+    {
+      int	n = 0;
+      double	sgn,
+		area = 0.0;
+
+      /* Find the orientation of the octagon. */
+      for(j = 0; j < nC; ++j)
+      {
+	WlzIVertex2 v0,
+		    v1;
+
+	v0 = eVtx[idx[j]];
+	v1 = eVtx[idx[(j + 1) % nC]];
+	area += ((double )(v0.vtX) * v1.vtY) - ((double )(v1.vtX) * v0.vtY);
+      }
+      sgn = (area > 0.0)? 1.0: -1.0;
+      for(i = 0; i < nVtx; ++i)
+      {
+	int	inside = 1;
+
+	for(j = 0; inside && (j < nC); ++j)
+	{
+	  WlzIVertex2 v0,
+		      v1;
+
+	  v0 = eVtx[idx[j]];
+	  v1 = eVtx[idx[(j + 1) % nC]];
+	  inside = sgn * ((((double )(v1.vtX) - v0.vtX) *
+			   ((double )(vtx[i].vtY) - v0.vtY)) -
+			  (((double )(v1.vtY) - v0.vtY) *
+			   ((double )(vtx[i].vtX) - v0.vtX))) > 0.0;
+	}
+	if(!inside)
+	{
+	  vtx[n++] = vtx[i];
+	}
+      }
+      nVtx = n;
+    }
+    AlcFree(idx);
+  }
+  return(nVtx);
+}
+
+/*!
+* \return	Number of vertices remaining.
+* \ingroup	WlzConvexHull
+* \brief	Culls the given 3D vertices using the Akl-Toussaint
+* 		heuristic. The vertices which are extreme in the
+* 		directions of the axes and of the cube diagonals form
+* 		a convex polyhedron and any vertex strictly within it
+* 		can not be a vertex of the convex hull. The remaining
+* 		vertices are compacted to the start of the array with
+* 		their order preserved.
+* \param	nVtx			Number of vertices.
+* \param	vtx			Given vertices.
+*/
+static int			WlzConvexHullCull3(
+				  int nVtx,
+				  WlzIVertex3 *vtx)
+{
+  if(nVtx > 14)
+  {
+    int		i,
+    		j;
+    int		eIdx[14];
+    WlzIVertex3	eVtx[14];
+    WlzVertexP	eP;
+    WlzConvHullDomain3 *cvh = NULL;
+    WlzErrorNum	errNum = WLZ_ERR_NONE;
+    const int	dir[14][3] = {{ 1,  0,  0}, {-1,  0,  0},
+			      { 0,  1,  0}, { 0, -1,  0},
+			      { 0,  0,  1}, { 0,  0, -1},
+			      { 1,  1,  1}, {-1, -1, -1},
+			      { 1,  1, -1}, {-1, -1,  1},
+			      { 1, -1,  1}, {-1,  1, -1},
+			      {-1,  1,  1}, { 1, -1, -1}};
+
+    for(j = 0; j < 14; ++j)
+    {
+      eIdx[j] = 0;
+    }
+    for(i = 1; i < nVtx; ++i)
+    {
+      for(j = 0; j < 14; ++j)
+      {
+	WlzIVertex3 u,
+		    v;
+
+	u = vtx[i];
+	v = vtx[eIdx[j]];
+	if((dir[j][0] * (u.vtX - v.vtX)) + (dir[j][1] * (u.vtY - v.vtY)) +
+	   (dir[j][2] * (u.vtZ - v.vtZ)) > 0)
+	{
+	  eIdx[j] = i;
+	}
+      }
+    }
+    for(j = 0; j < 14; ++j)
+    {
+      eVtx[j] = vtx[eIdx[j]];
+    }
+    eP.i3 = eVtx;
+    cvh = WlzConvexHullFromVtx3(WLZ_VERTEX_I3, 14, eP, &errNum);
+    if((errNum == WLZ_ERR_NONE) && (cvh->nFaces >= 4))
+    {
+      int	n = 0,
+      		nF;
+      WlzDVertex3 c;
+      WlzDVertex3 *nrm = NULL;
+      double	*off = NULL;
+
+      nF = cvh->nFaces;
+      if(((nrm = (WlzDVertex3 *)
+                 AlcMalloc(sizeof(WlzDVertex3) * nF)) != NULL) &&
+         ((off = (double *)AlcMalloc(sizeof(double) * nF)) != NULL))
+      {
+	/* Compute outward directed face normals. */
+	WLZ_VTX_3_ZERO(c);
+	for(i = 0; i < cvh->nVertices; ++i)
+	{
+	  WLZ_VTX_3_ADD(c, c, cvh->vertices.i3[i]);
+	}
+	WLZ_VTX_3_SCALE(c, c, 1.0 / cvh->nVertices);
+	for(j = 0; j < nF; ++j)
+	{
+	  WlzDVertex3 v0,
+		      v1,
+		      v2;
+	  int	*f;
+
+	  f = cvh->faces + (3 * j);
+	  WLZ_VTX_3_SET(v0, cvh->vertices.i3[f[0]].vtX,
+	  		cvh->vertices.i3[f[0]].vtY,
+			cvh->vertices.i3[f[0]].vtZ);
+	  WLZ_VTX_3_SET(v1, cvh->vertices.i3[f[1]].vtX,
+	  		cvh->vertices.i3[f[1]].vtY,
+			cvh->vertices.i3[f[1]].vtZ);
+	  WLZ_VTX_3_SET(v2, cvh->vertices.i3[f[2]].vtX,
+	  		cvh->vertices.i3[f[2]].vtY,
+			cvh->vertices.i3[f[2]].vtZ);
+	  WLZ_VTX_3_SUB(v1, v1, v0);
+	  WLZ_VTX_3_SUB(v2, v2, v0);
+	  WLZ_VTX_3_CROSS(nrm[j], v1, v2);
+	  off[j] = WLZ_VTX_3_DOT(nrm[j], v0);
+	  if(WLZ_VTX_3_DOT(nrm[j], c) > off[j])
+	  {
+	    WLZ_VTX_3_NEGATE(nrm[j], nrm[j]);
+	    off[j] = -off[j];
+	  }
+	}
+	/* Keep only the vertices not strictly inside all faces. */
+	for(i = 0; i < nVtx; ++i)
+	{
+	  int	inside = 1;
+	  WlzDVertex3 v;
+
+	  WLZ_VTX_3_SET(v, vtx[i].vtX, vtx[i].vtY, vtx[i].vtZ);
+	  for(j = 0; inside && (j < nF); ++j)
+	  {
+	    inside = WLZ_VTX_3_DOT(nrm[j], v) < off[j];
+	  }
+	  if(!inside)
+	  {
+	    vtx[n++] = vtx[i];
+	  }
+	}
+	nVtx = n;
+      }
+      AlcFree(nrm);
+      AlcFree(off);
+    }
+    (void )WlzFreeConvexHullDomain3(cvh);
+  }
+  return(nVtx);
+}
+
+/*!
+* \return	New 3D convex hull domain or NULL on error.
+* \ingroup	WlzConvexHull
+* \brief	Computes the 3D convex hull of the given integer vertices
+* 		by divide and conquer. The vertices are split into
+* 		contiguous blocks, the convex hull of each block is
+* 		computed in parallel and then the convex hull of the
+* 		union of the block convex hull vertices is computed.
+* 		The number of blocks depends only on the number of
+* 		vertices, so that the same convex hull vertices are
+* 		found for any number of threads. If there are too few
+* 		vertices for the blocks to be worth while then the
+* 		convex hull is computed directly. The vertex array may
+* 		be modified.
+* 		As for WlzConvexHullFromVtx3() the error code may be
+* 		WLZ_ERR_DEGENERATE with a valid convex hull domain.
+* \param	nVtx			Number of vertices.
+* \param	vtx			Given vertices.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+static WlzConvHullDomain3	*WlzConvexHullFromVtxI3(
+				  int nVtx,
+				  WlzIVertex3 *vtx,
+				  WlzErrorNum *dstErr)
+{
+  int		nBlk;
+  WlzVertexP	vP;
+  WlzConvHullDomain3 *cvh = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const int	minBlk = 4096,
+  		maxBlk = 64;
+
+  nBlk = ALG_MIN(maxBlk, nVtx / minBlk);
+  if(nBlk > 1)
+  {
+    int		b,
+    		n = 0;
+    int		*bNVtx = NULL;
+    WlzIVertex3	**bVtx = NULL;
+
+    if(((bNVtx = (int *)AlcCalloc(nBlk, sizeof(int))) == NULL) ||
+       ((bVtx = (WlzIVertex3 **)
+		AlcCalloc(nBlk, sizeof(WlzIVertex3 *))) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for(b = 0; b < nBlk; ++b)
+      {
+	int	i0,
+		n2;
+	WlzVertexP bP;
+	WlzConvHullDomain3 *bCvh;
+	WlzErrorNum errNum2 = WLZ_ERR_NONE;
+
+	i0 = (int )(((long )nVtx * b) / nBlk);
+	n2 = (int )(((long )nVtx * (b + 1)) / nBlk) - i0;
+	bP.i3 = vtx + i0;
+	bCvh = WlzConvexHullFromVtx3(WLZ_VERTEX_I3, n2, bP, &errNum2);
+	if(errNum2 == WLZ_ERR_NONE)
+	{
+	  /* Keep just the vertices of this block's convex hull. */
+	  n2 = bCvh->nVertices;
+	  bP.i3 = bCvh->vertices.i3;
+	}
+	else if((errNum2 == WLZ_ERR_DEGENERATE) ||
+	        (errNum2 == WLZ_ERR_PARAM_DATA))
+	{
+	  /* Keep all of this block's vertices. */
+	  errNum2 = WLZ_ERR_NONE;
+	}
+	if(errNum2 == WLZ_ERR_NONE)
+	{
+	  if((bVtx[b] = (WlzIVertex3 *)
+			AlcMalloc(sizeof(WlzIVertex3) * n2)) == NULL)
+	  {
+	    errNum2 = WLZ_ERR_MEM_ALLOC;
+	  }
+	  else
+	  {
+	    (void )memcpy(bVtx[b], bP.i3, sizeof(WlzIVertex3) * n2);
+	    bNVtx[b] = n2;
+	  }
+	}
+	(void )WlzFreeConvexHullDomain3(bCvh);
+	if(errNum2 != WLZ_ERR_NONE)
+	{
+#ifdef _OPENMP
+#pragma omp critical (WlzConvexHullFromVtxI3)
+	  {
+#endif
+	    if(errNum == WLZ_ERR_NONE)
+	    {
+	      errNum = errNum2;
+	    }
+#ifdef _OPENMP
+	  }
+#endif
+	}
+      }
+    }
+    /* Gather the block convex hull vertices, these can't be more than
+     * the given vertices. */
+    if(errNum == WLZ_ERR_NONE)
+    {
+      for(b = 0; b < nBlk; ++b)
+      {
+	(void )memcpy(vtx + n, bVtx[b], sizeof(WlzIVertex3) * bNVtx[b]);
+	n += bNVtx[b];
+      }
+      nVtx = n;
+    }
+    if(bVtx)
+    {
+      for(b = 0; b < nBlk; ++b)
+      {
+        AlcFree(bVtx[b]);
+      }
+      AlcFree(bVtx);
+    }
+    AlcFree(bNVtx);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    vP.i3 = vtx;
+    cvh = WlzConvexHullFromVtx3(WLZ_VERTEX_I3, nVtx, vP, &errNum);
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(cvh);
+}
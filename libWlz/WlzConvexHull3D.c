@@ -54,1778 +54,904 @@ static char _WlzConvexHull3D_c[] = "University of Edinburgh $Id$";
 #define WLZ_CONVHULL_EPS	(1.0e-06)
 
 /*!
-* \struct	_WlzConvHullArc
-* \brief	A conflict arc connecting a face and a vertex these form
-* 		circular doubly linked lists for the faces and vertices.
-* 		Typedef: ::WlzConvHullArc
+* \struct	_WlzConvHullQFce
+* \brief	A face of the convex hull for use in the quickhull
+* 		workspace. Faces are held in an array and refer to
+* 		each other by their indices in this array.
+* 		Typedef: ::WlzConvHullQFce
 */
-typedef struct _WlzConvHullArc
+typedef struct _WlzConvHullQFce
 {
-  struct _WlzConvHullFce *fce;		/*!< Face of conflict. */
-  struct _WlzConvHullVtx *vtx;		/*!< Vertex in conflict. */
-  struct _WlzConvHullArc *prvVtx; 	/*!< Previous vertex arc. */
-  struct _WlzConvHullArc *nxtVtx; 	/*!< Next vertex arc, also used for
-  					     the stack of free arcs in the
-					     arc pool. */
-  struct _WlzConvHullArc *prvFce;	/*!< Previous face arc. */
-  struct _WlzConvHullArc *nxtFce;	/*!< Next face arc. */
-} WlzConvHullArc;
-
-/*!
-* \struct	_WlzConvHullVtx
-* \brief	A vertex of the convex hull for use in a convex hull
-* 		workspace.
-* 		Typedef: ::WlzConvHullVtx
-*/
-typedef struct _WlzConvHullVtx
-{
-  int			idx;		/*!< Index of the vertex. */
-  int			cvx;		/*!< Vertex is on the convex hull. */
-  struct _WlzConvHullArc *arc;		/*!< Conflict list. */
-  struct _WlzConvHullVtx *nxt;		/*!< Next vertex in list. */
-  struct _WlzConvHullVtx *prv;		/*!< Previous vertex in list. */
-} WlzConvHullVtx;
-
-/*!
-* \struct	_WlzConvHullFce
-* \brief	A face of the convex hull for use in a convex hull
-* 		workspace.
-* 		Typedef: ::WlzConvHullFce
-*/
-typedef struct _WlzConvHullFce
-{
-  int			vtx[3];		/*!< Indices of the vertices. */
-  struct _WlzConvHullFce *opp[3]; 	/*!< Opposite faces, opp[i] is the
+  int			vtx[3];		/*!< Indices of the vertices, ordered
+  					     counter-clockwise when viewed
+					     from outside of the convex hull. */
+  int			opp[3];		/*!< Opposite faces, opp[i] is the
   					     face opposite on the edge in
 					     this face directed from vtx[i]
 					     to vtx[(i + 1)%3]. */
-  WlzDVertex3		nrm;		/*!< Outward directed normal for
-  					     this face. */
-  struct _WlzConvHullArc *arc;		/*!< Conflict list. */
-  struct _WlzConvHullFce *nxt;		/*!< Next face in list. */
-  struct _WlzConvHullFce *prv;		/*!< Previous face in list. */
-} WlzConvHullFce;
+  int			alive;		/*!< Non-zero if the face is on the
+  					     current convex hull. */
+  int			visit;		/*!< Iteration in which the face was
+  					     last visited. */
+  int			outHd;		/*!< First of the vertices outside
+  					     this face or -1 if none. */
+  int			outFar;		/*!< Vertex outside this face which
+  					     is furthest from it or -1 if
+					     none. */
+  double		outFarD;	/*!< Distance of the furthest vertex
+  					     scaled by the normal length. */
+  double		thr;		/*!< Threshold for a vertex to be
+  					     outside this face, scaled by the
+					     normal length. */
+  WlzDVertex3		nrm;		/*!< Outward directed normal, not of
+  					     unit length. */
+} WlzConvHullQFce;
 
 /*!
-* \struct	_WlzConvHullArcPool
-* \brief	A pool of conflict arcs.
-* 		Typedef: ::WlzConvHullArcPool
+* \struct	_WlzConvHullQHrz
+* \brief	An edge of the horizon as seen from a vertex being added
+* 		to the convex hull.
+* 		Typedef: ::WlzConvHullQHrz
 */
-typedef struct _WlzConvHullArcPool
+typedef struct _WlzConvHullQHrz
 {
-  int			freeCnt;	/*!< Number of arcs in free pool. */
-  WlzConvHullArc 	*free;		/*!< Next arc available. */
-  AlcBlockStack		*blkStk;	/*!< Block stack for allocation. */
-} WlzConvHullArcPool;
+  int			vtx[2];		/*!< Edge vertices in the direction
+  					     of the visible face. */
+  int			fce;		/*!< Face which remains. */
+  int			edg;		/*!< Edge of the face which
+  					     remains. */
+} WlzConvHullQHrz;
 
 /*!
-* \struct	_WlzConvHullFcePool
-* \brief	A pool of faces.
-* 		Typedef: ::WlzConvHullFcePool
-*/
-typedef struct _WlzConvHullFcePool
-{
-  int			freeCnt;	/*!< Number of faces in free pool. */
-  WlzConvHullFce 	*free;		/*!< Next face available. */
-  AlcBlockStack		*blkStk;	/*!< Block stack for allocation. */
-} WlzConvHullFcePool;
-
-/*!
-* \struct	_WlzConvHullVtxPool
-* \brief	A pool of vertices.
-* 		Typedef: ::WlzConvHullVtxPool
-*/
-typedef struct _WlzConvHullVtxPool
-{
-  int			freeCnt;	/*!< Number of arcs in free pool. */
-  WlzConvHullVtx 	*free;		/*!< Next vertex available. */
-  AlcBlockStack		*blkStk;	/*!< Block stack for allocation. */
-} WlzConvHullVtxPool;
-
-/*!
-* \struct	_WlzConvHullHorEdg
-* \brief	A horizon edge as seen from an external vertex.
-* 		Typedef: ::WlzConvHullHorEdg
-*/
-typedef struct _WlzConvHullHorEdg
-{
-  WlzConvHullFce	*fce;		/*!< Face on horizon. */
-  int			edg;		/*!< Edge on horizon face. */
-} WlzConvHullHorEdg;
-
-/*!
-* \struct	_WlzConvHullWSp3
+* \struct	_WlzConvHullQWSp
 * \brief	A workspace for computing the 3D convex hull of vertices
-* 		with integral coordinates.
-* 		Typedef: ::WlzConvHullWSp3
+* 		using the quickhull algorithm.
+* 		Typedef: ::WlzConvHullQWSp
 */
-typedef struct _WlzConvHullWSp3
+typedef struct _WlzConvHullQWSp
 {
-  int			nHorizon;	/*!< Number of horizon edges. */
-  int			maxHorizon;	/*!< Maximum horizon edge space. */
-  int			nFceBuf;	/*!< Number of faces in face buffer. */
-  int			maxFceBuf;	/*!< Maximum face buffer space. */
-  WlzVertexType		vtxType;	/*!< Vertex type, either WLZ_VERTEX_I3
-  					     or WLZ_VERTEX_D3. */
-  WlzVertexP		vtxPos;		/*!< Pointer to vertex positions. */
-  int			*vtxPrm;	/*!< Vertex permutation table. */
-  WlzConvHullFce	*fceLst;	/*!< List of faces in the convex
-                                             hull so far. */
-  WlzConvHullVtx	*vtxLst;	/*!< List of vertices in the convex
-  					     hull so far. */
-  WlzConvHullVtx	*vtxQue;	/*!< Queue of vertices waiting to
-  					     be processed. */
-  WlzConvHullFce	**fceBuf;	/*!< Buffer for faces to be added
-  					     or deleted. */
-  WlzConvHullHorEdg	*horizon;	/*!< Buffer for horizon edges. */
-  WlzConvHullArcPool 	arcPool;	/*!< Pool for arc allocation. */
-  WlzConvHullFcePool 	fcePool;	/*!< Pool for face allocation. */
-  WlzConvHullVtxPool 	vtxPool;	/*!< Pool for vertex allocation. */
-} WlzConvHullWSp3;
+  int			nPos;		/*!< Number of vertex positions. */
+  WlzDVertex3		*pos;		/*!< Vertex positions. */
+  int			*pntNxt;	/*!< Next vertex in the outside list
+  					     of a face, -1 at list end. */
+  int			*hrzMap;	/*!< Map from a vertex index to the
+  					     new face with a horizon edge
+					     starting at the vertex. */
+  double		eps;		/*!< Distance tollerance. */
+  int			nFce;		/*!< Number of faces used. */
+  int			maxFce;		/*!< Space allocated for faces. */
+  int			freeFce;	/*!< First of the free faces or -1. */
+  WlzConvHullQFce	*fce;		/*!< Array of faces. */
+  int			nStk;		/*!< Number of faces on the stack. */
+  int			maxStk;		/*!< Space allocated for the stack. */
+  int			*stk;		/*!< Stack of face indices. */
+  int			nVis;		/*!< Number of visible faces. */
+  int			maxVis;		/*!< Space allocated for visible
+  					     faces. */
+  int			*vis;		/*!< Visible face indices. */
+  int			nHrz;		/*!< Number of horizon edges. */
+  int			maxHrz;		/*!< Space allocated for the horizon
+  					     edges. */
+  WlzConvHullQHrz	*hrz;		/*!< Horizon edges. */
+  int			*nwFce;		/*!< New faces, one for each horizon
+  					     edge. */
+} WlzConvHullQWSp;
+
+static int			WlzConvHullQNewFce(
+				  WlzConvHullQWSp *wSp,
+				  int v0,
+				  int v1,
+				  int v2,
+				  WlzErrorNum *dstErr);
+static int			WlzConvHullQAbove(
+				  WlzConvHullQWSp *wSp,
+				  WlzConvHullQFce *fce,
+				  int v,
+				  double *dstD);
+static void			WlzConvHullQLink(
+				  WlzConvHullQWSp *wSp,
+				  int f0,
+				  int f1);
+static void			WlzConvHullQAssign(
+				  WlzConvHullQWSp *wSp,
+				  int v,
+				  int nFce,
+				  int *fceIdx);
+static WlzErrorNum		WlzConvHullQPush(
+				  WlzConvHullQWSp *wSp,
+				  int f);
+static WlzErrorNum		WlzConvHullQInitTet(
+				  WlzConvHullQWSp *wSp);
+static WlzErrorNum		WlzConvHullQAddVtx(
+				  WlzConvHullQWSp *wSp,
+				  int f0,
+				  int itr);
+static WlzConvHullDomain3	*WlzConvHullQToDom(
+				  WlzConvHullQWSp *wSp,
+				  WlzVertexType pType,
+				  WlzVertexP pnt,
+				  int *prm,
+				  WlzErrorNum *dstErr);
+static WlzConvHullDomain3	*WlzConvexHullQuick3(
+				  WlzVertexType pType,
+				  int nPnt,
+				  WlzVertexP pnt,
+				  int *prm,
+				  WlzErrorNum *dstErr);
+static WlzConvHullDomain3	*WlzConvexHullDegenerate3(
+				  WlzVertexType pType,
+				  int nPnt,
+				  WlzVertexP pnt,
+				  WlzErrorNum *dstErr);
 
 /*!
-* \return	Woolz error code.
+* \return	Index of the new face or -1 on error.
 * \ingroup	WlzConvexHull
-* \brief	Expand the pool of conflict arcs to at least the given
-* 		minimum number of free arcs.
-* \param	pool			The arc pool.
-* \param	minElm			Given minimum number of elements.
+* \brief	Makes a new face in the quickhull workspace with the
+* 		given vertices, which should be ordered counter-clockwise
+* 		when viewed from outside of the convex hull. The face
+* 		array may be reallocated so pointers to faces are not
+* 		valid after calling this function.
+* \param	wSp			Quickhull workspace.
+* \param	v0			First vertex of the face.
+* \param	v1			Second vertex of the face.
+* \param	v2			Third vertex of the face.
+* \param	dstErr			Destination error pointer.
 */
-static WlzErrorNum		WlzConvHullArcPoolExpand(
-				  WlzConvHullArcPool *pool,
-				  int minElm)
+static int			WlzConvHullQNewFce(
+				  WlzConvHullQWSp *wSp,
+				  int v0,
+				  int v1,
+				  int v2,
+				  WlzErrorNum *dstErr)
 {
+  int		f = -1;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
-  const int	incStep = 4096;
 
-  if(pool->freeCnt < minElm)
+  if(wSp->freeFce >= 0)
   {
-    int		nElm;
-    AlcBlockStack *newBlk;
-
-    nElm = ((minElm / incStep) + 1) * incStep;
-    newBlk = AlcBlockStackNew(nElm, sizeof(WlzConvHullArc),
-                              pool->blkStk, NULL);
-    if(newBlk == NULL)
-    {
-      errNum = WLZ_ERR_MEM_ALLOC;
-    }
-    else
-    {
-      int		i;
-      WlzConvHullArc *arc;
-
-      pool->freeCnt += nElm;
-      arc = (WlzConvHullArc *)(newBlk->elements);
-      pool->blkStk = newBlk;
-      for(i = 0; i < nElm; ++i)
-      {
-	arc->nxtVtx = pool->free;
-	pool->free = arc;
-	++arc;
-      }
-    }
+    f = wSp->freeFce;
+    wSp->freeFce = wSp->fce[f].outHd;
   }
-  return(errNum);
-}
-
-/*!
-* \return	Woolz error code.
-* \ingroup	WlzConvexHull
-* \brief	Expand the pool of faces to at least the given
-* 		minimum number of free faces.
-* \param	pool			The face pool.
-* \param	minElm			Given minimum number of elements.
-*/
-static WlzErrorNum		WlzConvHullFcePoolExpand(
-				  WlzConvHullFcePool *pool,
-				  int minElm)
-{
-  WlzErrorNum	errNum = WLZ_ERR_NONE;
-  const int	incStep = 4096;
-
-  if(pool->freeCnt < minElm)
+  else
   {
-    int		nElm;
-    AlcBlockStack *newBlk;
-
-    nElm = ((minElm / incStep) + 1) * incStep;
-    newBlk = AlcBlockStackNew(nElm, sizeof(WlzConvHullFce),
-    		              pool->blkStk, NULL);
-    if(newBlk == NULL)
-    {
-      errNum = WLZ_ERR_MEM_ALLOC;
-    }
-    else
+    if(wSp->nFce >= wSp->maxFce)
     {
-      int		i;
-      WlzConvHullFce *fce;
+      int	max;
+      WlzConvHullQFce *fce;
 
-      pool->freeCnt += nElm;
-      fce = (WlzConvHullFce *)(newBlk->elements);
-      pool->blkStk = newBlk;
-      for(i = 0; i < nElm; ++i)
+      max = (wSp->maxFce > 0)? 2 * wSp->maxFce: 1024;
+      if((fce = (WlzConvHullQFce *)
+		AlcRealloc(wSp->fce, sizeof(WlzConvHullQFce) * max)) == NULL)
       {
-	fce->nxt = pool->free;
-	pool->free = fce;
-	++fce;
+	errNum = WLZ_ERR_MEM_ALLOC;
       }
-    }
-  }
-  return(errNum);
-}
-
-/*!
-* \return	Woolz error code.
-* \ingroup	WlzConvexHull
-* \brief	Expand the pool of vertices to at least the given
-* 		minimum number of free vertices.
-* \param	pool			The vertex pool.
-* \param	minElm			Given minimum number of elements.
-*/
-static WlzErrorNum		WlzConvHullVtxPoolExpand(
-				  WlzConvHullVtxPool *pool,
-				  int minElm)
-{
-  WlzErrorNum	errNum = WLZ_ERR_NONE;
-  const int	incStep = 4096;
-
-  if(pool->freeCnt < minElm)
-  {
-    int		nElm;
-    AlcBlockStack *newBlk;
-
-    nElm = ((minElm / incStep) + 1) * incStep;
-    newBlk = AlcBlockStackNew(nElm, sizeof(WlzConvHullVtx),
-    			      pool->blkStk, NULL);
-    if(newBlk == NULL)
-    {
-      errNum = WLZ_ERR_MEM_ALLOC;
-    }
-    else
-    {
-      int		i;
-      WlzConvHullVtx *vtx;
-
-      pool->freeCnt += nElm;
-      vtx = (WlzConvHullVtx *)(newBlk->elements);
-      pool->blkStk = newBlk;
-      for(i = 0; i < nElm; ++i)
+      else
       {
-	vtx->nxt = pool->free;
-	pool->free = vtx;
-	++vtx;
+	wSp->fce = fce;
+	wSp->maxFce = max;
       }
     }
-  }
-  return(errNum);
-}
-
-/*!
-* \return	Woolz error code.
-* \ingroup	WlzConvexHull
-* \brief	Expand the face buffer to at least the given
-* 		minimum number of face pointers.
-* \param	pool			Convex hull workspace.
-* \param	minElm			Given minimum number of elements.
-*/
-static WlzErrorNum		WlzConvHullFceBufExpand(
-				  WlzConvHullWSp3 *wSp,
-				  int nMaxElm)
-{
-  WlzErrorNum	errNum = WLZ_ERR_NONE;
-  const int	bufInc = 4096;
-
-  if(wSp->maxFceBuf < nMaxElm)
-  {
-    wSp->maxFceBuf += bufInc;
-    if((wSp->fceBuf = (WlzConvHullFce **)
-		      AlcRealloc(wSp->fceBuf,
-			  sizeof(WlzConvHullFce *) *
-			  wSp->maxFceBuf)) == NULL)
-    {
-      errNum = WLZ_ERR_MEM_ALLOC;
-    }
-  }
-  return(errNum);
-}
-
-/*!
-* \return	Woolz error code.
-* \ingroup	WlzConvexHull
-* \brief	Expand the horizon edge buffer to at least the given
-* 		minimum number of horizon edges.
-* \param	pool			Convex hull workspace.
-* \param	minElm			Given minimum number of elements.
-*/
-static WlzErrorNum		WlzConvHullHorizonExpand(
-				  WlzConvHullWSp3 *wSp,
-				  int nMaxElm)
-{
-  WlzErrorNum	errNum = WLZ_ERR_NONE;
-  const int	bufInc = 4096;
-
-  if(wSp->maxHorizon < nMaxElm)
-  {
-    wSp->maxHorizon += bufInc;
-    if((wSp->horizon = (WlzConvHullHorEdg *)
-		      AlcRealloc(wSp->horizon,
-			  sizeof(WlzConvHullHorEdg) *
-			  wSp->maxHorizon)) == NULL)
+    if(errNum == WLZ_ERR_NONE)
     {
-      errNum = WLZ_ERR_MEM_ALLOC;
+      f = wSp->nFce++;
     }
   }
-  return(errNum);
-}
-
-/*!
-* \return	New conflict arc.
-* \ingroup	WlzConvexHull
-* \brief	Get a conflict arc from the conflict arc pool. All fields of
-* 		the arc are cleared to zero.
-* \param	wSp			Convex hull workspace.
-* \param	dstErr			Destination error pointer, may be NULL.
-*/
-static WlzConvHullArc		*WlzConvHullNewArc(
-				  WlzConvHullWSp3 *wSp,
-				  WlzErrorNum *dstErr)
-{
-  WlzConvHullArc *arc = NULL;
-  WlzErrorNum	errNum = WLZ_ERR_NONE;
-
-  if(wSp->arcPool.free == NULL)
-  {
-    errNum = WlzConvHullArcPoolExpand(&(wSp->arcPool), 1);
-  }
   if(errNum == WLZ_ERR_NONE)
   {
-    --(wSp->arcPool.freeCnt);
-    arc = wSp->arcPool.free;
-    wSp->arcPool.free = wSp->arcPool.free->nxtVtx;
-    if(arc == wSp->arcPool.free)
-    {
-      wSp->arcPool.free = NULL;
-    }
-    (void )memset(arc, 0, sizeof(WlzConvHullArc));
-  }
-  if(dstErr)
-  {
-    *dstErr = errNum;
-  }
-  return(arc);
+    WlzDVertex3	u,
+    		w;
+    WlzConvHullQFce *fce;
+
+    fce = wSp->fce + f;
+    fce->vtx[0] = v0;
+    fce->vtx[1] = v1;
+    fce->vtx[2] = v2;
+    fce->opp[0] = fce->opp[1] = fce->opp[2] = -1;
+    fce->alive = 1;
+    fce->visit = -1;
+    fce->outHd = -1;
+    fce->outFar = -1;
+    fce->outFarD = 0.0;
+    WLZ_VTX_3_SUB(u, wSp->pos[v1], wSp->pos[v0]);
+    WLZ_VTX_3_SUB(w, wSp->pos[v2], wSp->pos[v0]);
+    WLZ_VTX_3_CROSS(fce->nrm, u, w);
+    fce->thr = wSp->eps * WLZ_VTX_3_LENGTH(fce->nrm);
+  }
+  *dstErr = errNum;
+  return(f);
 }
 
 /*!
-* \return	New face.
+* \return	Non-zero if the vertex is outside the face.
 * \ingroup	WlzConvexHull
-* \brief	Get a face from the face pool. All fields of the face are
-* 		cleared to zero.
-* \param	wSp			Convex hull workspace.
-* \param	dstErr			Destination error pointer, may be NULL.
+* \brief	Determines whether the given vertex is outside (strictly
+* 		above) the given face.
+* \param	wSp			Quickhull workspace.
+* \param	fce			Given face.
+* \param	v			Given vertex index.
+* \param	dstD			Destination pointer for the distance
+* 					of the vertex from the face scaled by
+* 					the length of the face normal.
 */
-static WlzConvHullFce		*WlzConvHullNewFce(
-				  WlzConvHullWSp3 *wSp,
-				  WlzErrorNum *dstErr)
+static int			WlzConvHullQAbove(
+				  WlzConvHullQWSp *wSp,
+				  WlzConvHullQFce *fce,
+				  int v,
+				  double *dstD)
 {
-  WlzConvHullFce *fce = NULL;
-  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  double	d;
+  WlzDVertex3	u;
 
-  if(wSp->fcePool.free == NULL)
-  {
-    errNum = WlzConvHullFcePoolExpand(&(wSp->fcePool), 1);
-  }
-  if(errNum == WLZ_ERR_NONE)
-  {
-    --(wSp->fcePool.freeCnt);
-    fce = wSp->fcePool.free;
-    wSp->fcePool.free = wSp->fcePool.free->nxt;
-    if(fce == wSp->fcePool.free)
-    {
-      wSp->fcePool.free = NULL;
-    }
-    (void )memset(fce, 0, sizeof(WlzConvHullFce));
-  }
-  if(dstErr)
-  {
-    *dstErr = errNum;
-  }
-  return(fce);
+  WLZ_VTX_3_SUB(u, wSp->pos[v], wSp->pos[fce->vtx[0]]);
+  d = WLZ_VTX_3_DOT(fce->nrm, u);
+  *dstD = d;
+  return(d > fce->thr);
 }
 
 /*!
-* \return	New vertex.
 * \ingroup	WlzConvexHull
-* \brief	Get a vertex from the vertex pool. All fields of the vertex
-* 		are cleared to zero.
-* \param	wSp			Convex hull workspace.
-* \param	dstErr			Destination error pointer, may be NULL.
+* \brief	Links the two given faces if they share an edge.
+* \param	wSp			Quickhull workspace.
+* \param	f0			First face.
+* \param	f1			Second face.
 */
-static WlzConvHullVtx		*WlzConvHullNewVtx(
-				  WlzConvHullWSp3 *wSp,
-				  WlzErrorNum *dstErr)
+static void			WlzConvHullQLink(
+				  WlzConvHullQWSp *wSp,
+				  int f0,
+				  int f1)
 {
-  WlzConvHullVtx *vtx = NULL;
-  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  int		i,
+  		j;
+  WlzConvHullQFce *fce0,
+  		*fce1;
 
-  if(wSp->vtxPool.free == NULL)
-  {
-    errNum = WlzConvHullVtxPoolExpand(&(wSp->vtxPool), 1);
-  }
-  if(errNum == WLZ_ERR_NONE)
+  fce0 = wSp->fce + f0;
+  fce1 = wSp->fce + f1;
+  for(i = 0; i < 3; ++i)
   {
-    --(wSp->vtxPool.freeCnt);
-    vtx = wSp->vtxPool.free;
-    wSp->vtxPool.free = wSp->vtxPool.free->nxt;
-    if(vtx == wSp->vtxPool.free)
+    for(j = 0; j < 3; ++j)
     {
-      wSp->vtxPool.free = NULL;
+      if((fce0->vtx[i] == fce1->vtx[(j + 1) % 3]) &&
+         (fce0->vtx[(i + 1) % 3] == fce1->vtx[j]))
+      {
+        fce0->opp[i] = f1;
+	fce1->opp[j] = f0;
+      }
     }
-    (void )memset(vtx, 0, sizeof(WlzConvHullVtx));
-  }
-  if(dstErr)
-  {
-    *dstErr = errNum;
-  }
-  return(vtx);
-}
-
-/*!
-* \return	New convex hull workspace.
-* \ingroup	WlzConvexHull
-* \brief	Creates a new 3D convex hull workspace.
-* \param	vtxType			Type of vertex, must be either
-* 					WLZ_VERTEX_I3 or WLZ_VERTEX_D3.
-* \param	nVtx			Number of vertices.
-* \param	vtx			The vertex positions.
-* \param	dstErr			Destination error pointer, may be NULL.
-*/
-static WlzConvHullWSp3		*WlzConvHullMakeWSp3(
-				  WlzVertexType vtxType,
-				  int nVtx,
-				  WlzVertexP vtx,
-				  WlzErrorNum *dstErr)
-{
-  WlzConvHullWSp3 *wSp = NULL;
-  WlzErrorNum	errNum = WLZ_ERR_NONE;
-
-  if((vtxType != WLZ_VERTEX_I3) && (vtxType != WLZ_VERTEX_D3))
-  {
-    errNum = WLZ_ERR_PARAM_TYPE;
-  }
-  else if(((wSp = AlcCalloc(1, sizeof(WlzConvHullWSp3))) == NULL) ||
-          ((wSp->vtxPrm = (int *)AlcMalloc(nVtx * sizeof(int))) == NULL))
-  {
-    errNum = WLZ_ERR_MEM_ALLOC;
-  }
-  else
-  {
-    wSp->vtxType = vtxType;
-    wSp->vtxPos = vtx;
-  }
-  if(dstErr)
-  {
-    *dstErr = errNum;
-  }
-  return(wSp);
-}
-
-/*!
-* \ingroup	WlzConvexHull
-* \brief	Frees the given workspace.
-* \param	wSp			Given convex hull workspace.
-*/
-static void			WlzConvHullFreeWSp3(
-				  WlzConvHullWSp3 *wSp)
-{
-  if(wSp)
-  {
-    AlcFree(wSp->vtxPrm);
-    AlcFree(wSp->fceBuf);
-    AlcFree(wSp->horizon);
-    AlcBlockStackFree(wSp->arcPool.blkStk);
-    AlcBlockStackFree(wSp->fcePool.blkStk);
-    AlcBlockStackFree(wSp->vtxPool.blkStk);
-    AlcFree(wSp);
-  }
-}
-
-/*!
-* \ingroup	WlzConvexHull
-* \brief	Frees an unused conflict arc by returning it to it's pool.
-* \param	wSp			Convex hull workspace.
-* \param	arc			Unused conflict arc to be freed.
-*/
-static void			WlzConvHullFreeArc(
-				  WlzConvHullWSp3 *wSp,
-				  WlzConvHullArc *arc)
-{
-  if(arc)
-  {
-    WlzConvHullArcPool *pool;
-
-    pool = &(wSp->arcPool);
-    (void )memset(arc, 0, sizeof(WlzConvHullArc));
-    arc->nxtVtx = pool->free;
-    pool->free = arc;
-    ++(pool->freeCnt);
-  }
-}
-
-/*!
-* \ingroup	WlzConvexHull
-* \brief	Frees an unused face by returning it to it's pool.
-* \param	wSp			Convex hull workspace.
-* \param	arc			Unused face to be freed.
-*/
-static void			WlzConvHullFreeFce(
-				  WlzConvHullWSp3 *wSp,
-				  WlzConvHullFce *fce)
-{
-  if(fce)
-  {
-    WlzConvHullFcePool *pool;
-
-    pool = &(wSp->fcePool);
-    (void )memset(fce, 0, sizeof(WlzConvHullFce));
-    fce->nxt = pool->free;
-    pool->free = fce;
-    ++(pool->freeCnt);
-  }
-}
-
-/*!
-* \ingroup	WlzConvexHull
-* \brief	Frees an unused vertex by returning it to it's pool.
-* \param	wSp			Convex hull workspace.
-* \param	arc			Unused vertex to be freed.
-*/
-static void			WlzConvHullFreeVtx(
-				  WlzConvHullWSp3 *wSp,
-				  WlzConvHullVtx *vtx)
-{
-  if(vtx)
-  {
-    WlzConvHullVtxPool *pool;
-
-    pool = &(wSp->vtxPool);
-    (void )memset(vtx, 0, sizeof(WlzConvHullVtx));
-    vtx->nxt = pool->free;
-    pool->free = vtx;
-    ++(pool->freeCnt);
-  }
-}
-
-/*!
-* \ingroup	WlzConvexHull
-* \brief	Push the given vertex onto the pending vertex queue.
-* 		Simple randomisation seems better than a queue ordered
-* 		by maximum distance from a face.
-* \param	wSp			Convex hull workspace.
-* \param	vtx			Vertex to push.
-*/
-static void			WlzConHullPushPendingVtx(
-				  WlzConvHullWSp3 *wSp,
-				  WlzConvHullVtx *vtx)
-{
-  if(wSp->vtxQue == NULL)
-  {
-    wSp->vtxQue = vtx->prv = vtx->nxt = vtx;
-  }
-  else
-  {
-    vtx->nxt = wSp->vtxQue;
-    vtx->prv = wSp->vtxQue->prv;
-    vtx->prv->nxt = vtx;
-    vtx->nxt->prv = vtx;
-    wSp->vtxQue = vtx;
-  }
-}
-
-/*!
-* \ingroup	WlzConvexHull
-* \brief	Adds the given face to the list of faces currently in the
-* 		convex hull.
-* \param	wSp			Convex hull workspace.
-* \param	fce			Face to add.
-*/
-static void			WlzConHullAddConvexFce(
-				  WlzConvHullWSp3 *wSp,
-				  WlzConvHullFce *fce)
-{
-  if(wSp->fceLst == NULL)
-  {
-    wSp->fceLst = fce->prv = fce->nxt = fce;
-  }
-  else
-  {
-    fce->nxt = wSp->fceLst;
-    fce->prv = wSp->fceLst->prv;
-    fce->nxt->prv = fce->prv->nxt = fce;
   }
 }
 
 /*!
 * \ingroup	WlzConvexHull
-* \brief	Adds the given vertex to the list of vertices currently in the
-* 		convex hull.
-* \param	wSp			Convex hull workspace.
-* \param	fce			Face to add.
+* \brief	Assigns the given vertex to the outside list of the first
+* 		of the given faces that it is outside of. If the vertex
+* 		is not outside of any of the faces then it is inside the
+* 		convex hull and is discarded.
+* \param	wSp			Quickhull workspace.
+* \param	v			Given vertex.
+* \param	nFce			Number of faces.
+* \param	fceIdx			Array with the face indices.
 */
-static void			WlzConHullAddConvexVtx(
-				  WlzConvHullWSp3 *wSp,
-				  WlzConvHullVtx *vtx)
+static void			WlzConvHullQAssign(
+				  WlzConvHullQWSp *wSp,
+				  int v,
+				  int nFce,
+				  int *fceIdx)
 {
-  if(wSp->vtxLst == NULL)
-  {
-    wSp->vtxLst = vtx->prv = vtx->nxt = vtx;
-  }
-  else
-  {
-    vtx->cvx = 1;
-    vtx->nxt = wSp->vtxLst;
-    vtx->prv = wSp->vtxLst->prv;
-    vtx->nxt->prv = vtx->prv->nxt = vtx;
-  }
-}
-
-/*!
-* \return	Non-zero if the vertex is behind the face, ie the vertex
-* 		lies on the face or on the convex hull side of the face.
-* \ingroup	WlzConvexHull
-* \brief	Determines whether the vertex is behind the face.
-* 		If a vertex is behind all faces of a convex hull then it
-* 		is within (or possibly on) te convex hull.
-* 		This function can consume most of the CPU cycles when
-* 		computing a convex hull.
-* \param	wSp			Convex hull workspace.
-* \param	fce			Given face.
-* \param	vtx			Given vertex index.
-*/
-static int 			WlzConvHullFceBehind(
-				  WlzConvHullWSp3 *wSp,
-				  WlzConvHullFce *fce,
-				  int vtx)
-{
-  int		b;
-  double	p;
-  WlzDVertex3	u;
+  int		i;
 
-  if(wSp->vtxType == WLZ_VERTEX_I3)
+  for(i = 0; i < nFce; ++i)
   {
-    WlzIVertex3   v0,
-		  v1;
+    double	d;
+    WlzConvHullQFce *fce;
 
-    v0 = wSp->vtxPos.i3[fce->vtx[0]];
-    v1 = wSp->vtxPos.i3[vtx];
-    WLZ_VTX_3_SUB(u, v1, v0);
-  }
-  else /* wSp->vtxType == WLZ_VERTEX_D3 */
-  {
-    WlzDVertex3   v0,
-		  v1;
-
-    v0 = wSp->vtxPos.d3[fce->vtx[0]];
-    v1 = wSp->vtxPos.d3[vtx];
-    WLZ_VTX_3_SUB(u, v1, v0);
-  }
-  p = WLZ_VTX_3_DOT(fce->nrm, u);
-  b = (p < WLZ_CONVHULL_EPS);
-  return(b);
-}
-
-/*!
-* \return	Woolz error code.
-* \ingroup	WlzConvexHull
-* \brief	Adds a conflict arc between the given face and vertex.
-* 		Arcs are maintained as joint circular doubly linked lists
-* 		through the faces and vertices.
-* \param	wSp			Convex hull workspace.
-* \param	fce			Given face.
-* \param	vtx			Given vertex.
-*/
-static WlzErrorNum		WlzConvHullConfAdd(
-				  WlzConvHullWSp3 *wSp,
-				  WlzConvHullFce *fce,
-				  WlzConvHullVtx *vtx)
-{
-  WlzConvHullArc *newArc;
-  WlzErrorNum	errNum = WLZ_ERR_NONE;
-
-  newArc = WlzConvHullNewArc(wSp, &errNum);
-  if(errNum == WLZ_ERR_NONE)
-  {
-    newArc->fce = fce;
-    newArc->vtx = vtx;
-    /* Insert arc into face list. */
-    if(fce->arc == NULL)
-    {
-      fce->arc = newArc;
-      newArc->nxtFce = newArc->prvFce = newArc;
-    }
-    else
+    fce = wSp->fce + fceIdx[i];
+    if(WlzConvHullQAbove(wSp, fce, v, &d))
     {
-      newArc->nxtFce = fce->arc;
-      newArc->prvFce = fce->arc->prvFce;
-      fce->arc->prvFce->nxtFce = newArc;
-      fce->arc->prvFce = newArc;
-    }
-    /* Insert arc into vertex list. */
-    if(vtx->arc == NULL)
-    {
-      vtx->arc = newArc;
-      newArc->nxtVtx = newArc->prvVtx = newArc;
-    }
-    else
-    {
-      newArc->nxtVtx = vtx->arc;
-      newArc->prvVtx = vtx->arc->prvVtx;
-      vtx->arc->prvVtx->nxtVtx = newArc;
-      vtx->arc->prvVtx = newArc;
+      wSp->pntNxt[v] = fce->outHd;
+      fce->outHd = v;
+      if((fce->outFar < 0) || (d > fce->outFarD))
+      {
+        fce->outFar = v;
+	fce->outFarD = d;
+      }
+      break;
     }
   }
-  return(errNum);
 }
 
 /*!
 * \return	Woolz error code.
-* \ingroup	WlzConvHull
-* \brief	Deletes (and recycles to the arc pool) a conflict arc
-* 		from the doubly linked lists through the faces and vertices.
-* 		If this is the only arc in a conflict list then the conflict
-* 		list will be set to NULL.
-* \param	wSp			Convex hull workspace.
-* \param	arc			Arc to be deleted.
-*/
-static void			WlzConvHullDelArc(
-				  WlzConvHullWSp3 *wSp,
-				  WlzConvHullArc *arc)
-{
-  WlzConvHullArc *nxtArc;
-  WlzConvHullFce *fce;
-  WlzConvHullVtx *vtx;
-
-  fce = arc->fce;
-  vtx = arc->vtx;
-  /* Unlink the arc from the confict list. */
-  if(arc == fce->arc)
-  {
-    if(arc == arc->nxtFce)
-    {
-      fce->arc = NULL;
-    }
-    else
-    {
-      nxtArc = arc->nxtFce;
-      fce->arc = nxtArc;
-      arc->prvFce->nxtFce = nxtArc;
-      nxtArc->prvFce = arc->prvFce;
-    }
-  }
-  else
-  {
-    nxtArc = arc->nxtFce;
-    arc->prvFce->nxtFce = nxtArc;
-    nxtArc->prvFce = arc->prvFce;
-  }
-  if(arc == vtx->arc)
-  {
-    if(arc == arc->nxtVtx)
-    {
-      vtx->arc = NULL;
-    }
-    else
-    {
-      nxtArc = arc->nxtVtx;
-      vtx->arc = nxtArc;
-      arc->prvVtx->nxtVtx = nxtArc;
-      nxtArc->prvVtx = arc->prvVtx;
-    }
-  }
-  else
-  {
-    nxtArc = arc->nxtVtx;
-    arc->prvVtx->nxtVtx = nxtArc;
-    nxtArc->prvVtx = arc->prvVtx;
-  }
-  /* Put the arc back into the free pool. */
-  WlzConvHullFreeArc(wSp, arc);
-}
-
-/*!
 * \ingroup	WlzConvexHull
-* \brief	Deletes a face and any conflicts it may have recycling
-* 		the face and conflict arcs back to their pools.
-* \param	wSp			Convex hull workspace.
-* \param	head			Head of the list of faces, may
-* 					be modified and may be NULL if the
-* 					list becomes empty.
-* \param	fce			Face to be deleted.
+* \brief	Pushes the given face onto the workspace stack of faces
+* 		which may have vertices outside of them.
+* \param	wSp			Quickhull workspace.
+* \param	f			Given face.
 */
-static void			WlzConvHullDelFce(
-				  WlzConvHullWSp3 *wSp,
-				  WlzConvHullFce **head,
-				  WlzConvHullFce *fce)
+static WlzErrorNum		WlzConvHullQPush(
+				  WlzConvHullQWSp *wSp,
+				  int f)
 {
-  WlzConvHullFce *nxtFce;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
 
-  /* Free all conflict arcs of this face. */
-  while(fce->arc)
-  {
-    WlzConvHullDelArc(wSp, fce->arc->nxtFce);
-  }
-  /* Unlink the face from it's queue or list. */
-  if(fce == *head)
+  if(wSp->nStk >= wSp->maxStk)
   {
-    if(fce == fce->nxt)
-    {
-      *head = NULL;
-    }
-    else
-    {
-      nxtFce = fce->nxt;
-      *head = nxtFce;
-      fce->prv->nxt = nxtFce;
-      nxtFce->prv = fce->prv;
-    }
-  }
-  else
-  {
-    nxtFce = fce->nxt;
-    fce->prv->nxt = nxtFce;
-    nxtFce->prv = fce->prv;
-  }
-  /* Free the face back to it's pool. */
-  WlzConvHullFreeFce(wSp, fce);
-}
-
-/*!
-* \ingroup	WlzConvexHull
-* \brief	Unlink a vertex from a list but don't free it.
-* \param	wSp			Convex hull workspace.
-* \param	head			Head of the list of vertices, may
-* 					be modified.
-* \param	vtx			Vertex to be unlinked.
-*/
-static void 			WlzConvHullUnkVtx(
-				  WlzConvHullWSp3 *wSp,
-				  WlzConvHullVtx **head,
-				  WlzConvHullVtx *vtx)
-{
-  WlzConvHullVtx *nxtVtx,
-  		 *prvVtx;
+    int		max,
+    		*stk;
 
-  if(vtx == *head)
-  {
-    if(vtx == vtx->nxt)
+    max = (wSp->maxStk > 0)? 2 * wSp->maxStk: 1024;
+    if((stk = (int *)AlcRealloc(wSp->stk, sizeof(int) * max)) == NULL)
     {
-      *head = NULL;
+      errNum = WLZ_ERR_MEM_ALLOC;
     }
     else
     {
-      nxtVtx = vtx->nxt;
-      prvVtx = vtx->prv;
-      prvVtx->nxt = nxtVtx;
-      nxtVtx->prv = prvVtx;
-      *head = nxtVtx;
+      wSp->stk = stk;
+      wSp->maxStk = max;
     }
   }
-  else
-  {
-    nxtVtx = vtx->nxt;
-    prvVtx = vtx->prv;
-    prvVtx->nxt = nxtVtx;
-    nxtVtx->prv = prvVtx;
-  }
-}
-
-/*!
-* \ingroup	WlzConvexHull
-* \brief	Deletes a vertex and any conflicts it may have recycling
-* 		the vertex and conflict arcs back to their pools.
-* \param	wSp			Convex hull workspace.
-* \param	head			Head of the list of vertices, may
-* 					be modified and may be NULL if the
-* 					list becomes empty. The head may
-* 					also be supplied as a NULL pointer
-* 					which implies that the vertex is not
-* 					in any list.
-* \param	vtx			Vertex to be deleted.
-*/
-static void			WlzConvHullDelVtx(
-				  WlzConvHullWSp3 *wSp,
-				  WlzConvHullVtx **head,
-				  WlzConvHullVtx *vtx)
-{
-  /* Free all conflict arcs of this vertex. */
-  while(vtx->arc)
-  {
-    WlzConvHullDelArc(wSp, vtx->arc->nxtVtx);
-  }
-  /* Unlink the vertex from it's queue or list. */
-  if(head)
-  {
-    WlzConvHullUnkVtx(wSp, head, vtx);
-  }
-  /* Free the vertex back to it's pool. */
-  WlzConvHullFreeVtx(wSp, vtx);
-}
-
-/*!
-* \return	Top pending vertex unlinked from queue.
-* \ingroup	WlzConvexHull
-* \brief	Pops the top vertex from the pending vertex queue.
-* \param	wSp			Convex hull workspace.
-*/
-static WlzConvHullVtx		*WlzConHullPopPendingVtx(
-				  WlzConvHullWSp3 *wSp)
-{
-  WlzConvHullVtx	*vtx;
-
-  if((vtx = wSp->vtxQue) != NULL)
+  if(errNum == WLZ_ERR_NONE)
   {
-    if(vtx == vtx->nxt)
-    {
-      wSp->vtxQue = NULL;
-    }
-    else
-    {
-      wSp->vtxQue = vtx->nxt;
-      wSp->vtxQue->prv = vtx->prv;
-      wSp->vtxQue->prv->nxt = wSp->vtxQue;
-    }
+    wSp->stk[wSp->nStk++] = f;
   }
-  return(vtx);
+  return(errNum);
 }
 
-
 /*!
-* \return	Woolz error code.
+* \return	Woolz error code, WLZ_ERR_DEGENERATE if the vertices
+* 		do not span a volume.
 * \ingroup	WlzConvexHull
-* \brief	Computes the face normal in place using the vertices of the
-* 		face.
-* \param	wSp			Convex hull workspace.
-* \param	fce			Given face.
+* \brief	Builds the initial tetrahedron of the quickhull algorithm
+* 		from the vertices which are extreme along the coordinate
+* 		axes and then assigns all other vertices to the outside
+* 		lists of it's faces.
+* \param	wSp			Quickhull workspace.
 */
-static WlzErrorNum		WlzConvHullFceNrm(
-				  WlzConvHullWSp3 *wSp,
-				  WlzConvHullFce *fce)
+static WlzErrorNum		WlzConvHullQInitTet(
+				  WlzConvHullQWSp *wSp)
 {
-  double	len;
-  WlzDVertex3 	nrm;
-  WlzDVertex3 	u[2];
+  int		i,
+  		j,
+		k;
+  int		ext[6],
+  		tet[4],
+		tetFce[4];
+  double	d,
+  		dMax;
+  WlzDVertex3	n,
+  		u,
+		w;
+  WlzDVertex3	*pos;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
 
-  if(wSp->vtxType == WLZ_VERTEX_I3)
+  pos = wSp->pos;
+  /* Find the vertices with minimum and maximum coordinates. */
+  for(j = 0; j < 6; ++j)
   {
-    WlzIVertex3 v[3];
-
-    v[0] = wSp->vtxPos.i3[fce->vtx[0]];
-    v[1] = wSp->vtxPos.i3[fce->vtx[1]];
-    v[2] = wSp->vtxPos.i3[fce->vtx[2]];
-    WLZ_VTX_3_SUB(u[0], v[1], v[0]);
-    WLZ_VTX_3_SUB(u[1], v[2], v[1]);
+    ext[j] = 0;
   }
-  else /* wSp->vtxType == WLZ_VERTEX_D3 */
+  for(i = 1; i < wSp->nPos; ++i)
   {
-    WlzDVertex3 v[3];
-
-    v[0] = wSp->vtxPos.d3[fce->vtx[0]];
-    v[1] = wSp->vtxPos.d3[fce->vtx[1]];
-    v[2] = wSp->vtxPos.d3[fce->vtx[2]];
-    WLZ_VTX_3_SUB(u[0], v[1], v[0]);
-    WLZ_VTX_3_SUB(u[1], v[2], v[1]);
+    if(pos[i].vtX < pos[ext[0]].vtX) ext[0] = i;
+    if(pos[i].vtX > pos[ext[1]].vtX) ext[1] = i;
+    if(pos[i].vtY < pos[ext[2]].vtY) ext[2] = i;
+    if(pos[i].vtY > pos[ext[3]].vtY) ext[3] = i;
+    if(pos[i].vtZ < pos[ext[4]].vtZ) ext[4] = i;
+    if(pos[i].vtZ > pos[ext[5]].vtZ) ext[5] = i;
   }
-  WLZ_VTX_3_CROSS(nrm, u[0], u[1]);
-  len = WLZ_VTX_3_LENGTH(nrm);
-  if(len < WLZ_CONVHULL_EPS)
+  /* Use the most distant pair of these for the first edge. */
+  dMax = -1.0;
+  tet[0] = tet[1] = 0;
+  for(j = 0; j < 6; ++j)
   {
-    WLZ_VTX_3_ZERO(fce->nrm);
-    errNum = WLZ_ERR_PARAM_DATA;
-  }
-  else
-  {
-    len = 1.0 / len;
-    WLZ_VTX_3_SCALE(fce->nrm, nrm, len);
-  }
-  return(errNum);
-}
-
-/*!
-* \return	Woolz error code.
-* \ingroup	WlzConvexHull
-* \brief	Builds the horizon edge array using the conflicting faces
-* 		of the vertex which are put into the face buffer array.
-* 		The horizon edges run in sequence and with a direction
-* 		correct in the non conflicting faces (those which surround
-* 		the conflicting ones).
-* 		These arrays are expanded as required.
-* \param	wSp			Convex hull workspace.
-* \param	vtx			Given vertex.
-*/
-static WlzErrorNum		WlzConvHullBuildHorizon(
-				  WlzConvHullWSp3 *wSp,
-				  WlzConvHullVtx *vtx)
-{
-  WlzErrorNum	errNum = WLZ_ERR_NONE;
-
-  wSp->nFceBuf = 0;
-  wSp->nHorizon = 0;
-  /* Make sure there's room for at least 3 horizon edges, the maximum
-   * possible from a single face. This simplifies buffer expansion. */
-  errNum = WlzConvHullHorizonExpand(wSp, 3);
-  /* Build array of faces that conflict with the given vertex. */
-  if((errNum == WLZ_ERR_NONE) && (vtx->arc != NULL))
-  {
-    WlzConvHullArc *arc;
-
-    arc = vtx->arc;
-    do
+    for(k = j + 1; k < 6; ++k)
     {
-      int 	f,
-      		fceIn = 0;
-      WlzConvHullFce *fce;
-
-      fce = arc->fce;
-      /* Check for face already in the face buffer. */
-      for(f = 0; f < wSp->nFceBuf; ++f)
-      {
-        if(fce == wSp->fceBuf[f])
-	{
-	  fceIn = 1;
-	  break;
-	}
-      }
-      /* If not then add it. */
-      if(fceIn == 0)
+      WLZ_VTX_3_SUB(u, pos[ext[j]], pos[ext[k]]);
+      if((d = WLZ_VTX_3_SQRLEN(u)) > dMax)
       {
-	if(wSp->nFceBuf + 1 >= wSp->maxFceBuf)
-	{
-	  errNum = WlzConvHullFceBufExpand(wSp, wSp->nFceBuf + 1);
-	  if(errNum != WLZ_ERR_NONE)
-	  {
-	      break;
-	  }
-	}
-	wSp->fceBuf[wSp->nFceBuf] = fce;
-	++(wSp->nFceBuf);
+        dMax = d;
+	tet[0] = ext[j];
+	tet[1] = ext[k];
       }
-      arc = arc->nxtVtx; 			/* Next arc for this vertex. */
-    } while(arc != vtx->arc);
+    }
   }
-  /* Build horizon from the faces that are in the face buffer. */
-  if((errNum == WLZ_ERR_NONE) && (wSp->nFceBuf > 0))
+  if(dMax <= wSp->eps * wSp->eps)
   {
-    int		f;
-
-    /* For each face of the face buffer. */
-    for(f = 0; (errNum == WLZ_ERR_NONE) && (f < wSp->nFceBuf); ++f)
-    {
-      int	o,
-      		oo,
-		prvNHorizon;
-      WlzConvHullFce *fce;
-
-      fce = wSp->fceBuf[f];
-      prvNHorizon = wSp->nHorizon;
-      /* For each face connected by an edge to the current face. */
-      for(o = 0; o < 3; ++o)
-      {
-	WlzConvHullArc *oArc;
-	WlzConvHullFce *oFce; 
-
-        oFce = fce->opp[o];
-	/* Is the opposite face in the face buffer, if not then edge on
-	 * the opposite face must form part of the horizon. */
-	if((oArc = oFce->arc) == NULL)
-	{
-	  /* There are no vertices in conflict with this face so it's edge
-	   * must form part of the horizon. */
-          for(oo = 0; oo < 3; ++oo)
-	  {
-	    if(oFce->opp[oo] == fce)
-	    {
-	      wSp->horizon[wSp->nHorizon].fce = oFce;
-	      wSp->horizon[wSp->nHorizon].edg = oo;
-	      ++(wSp->nHorizon);
-	    }
-	  }
-	}
-	else
-	{
-	  int 	b,
-	  	inBuf = 0;
-
-	  /* Look to see if the opposite face is in the face buffer,
-	   * if not must if form part of the horizon.. */
-
-	  for(b = 0; b < wSp->nFceBuf; ++b)
-	  {
-	    if(oFce == wSp->fceBuf[b])
-	    {
-	      inBuf = 1;
-	    }
-	  }
-	  if(inBuf == 0)
-	  {
-	    for(oo = 0; oo < 3; ++oo)
-	    {
-	      if(oFce->opp[oo] == fce)
-	      {
-		wSp->horizon[wSp->nHorizon].fce = oFce;
-		wSp->horizon[wSp->nHorizon].edg = oo;
-		++(wSp->nHorizon);
-	      }
-	    }
-	  }
-	}
-	if(wSp->nHorizon > prvNHorizon)
-	{
-	  /* Stay 3 horizon edges ahead to keep allocation simple. */
-	  errNum = WlzConvHullHorizonExpand(wSp, wSp->nHorizon + 3);
-	  if(errNum != WLZ_ERR_NONE)
-	  {
-	    break;
-	  }
-	}
-      }
-    }
+    errNum = WLZ_ERR_DEGENERATE;
   }
-  /* Squeeze out any repeated horizon edges and make them into a chain
-   * so that each follows the previous. */
-  if((errNum == WLZ_ERR_NONE) && (wSp->nHorizon > 1))
+  /* Then the vertex most distant from the line of the first edge. */
+  if(errNum == WLZ_ERR_NONE)
   {
-    int		i,
-    		vF, 			/* Vertex of first horizon edge, used
-					 * to check for closed loop of vertex
-					 * edges. */
-		cnt,
-		loopOK = 0;
-
-    cnt = 1;
-    vF = wSp->horizon[0].fce->vtx[wSp->horizon[0].edg];
-    for(i = 0; i < wSp->nHorizon; ++i)
+    dMax = -1.0;
+    tet[2] = 0;
+    WLZ_VTX_3_SUB(w, pos[tet[1]], pos[tet[0]]);
+    for(i = 0; i < wSp->nPos; ++i)
     {
-      int	j,
-      		vC;			/* Vertex of the current edge. */
-      WlzConvHullHorEdg	*edgC, 		/* Current horizon edge. */
-      			*edgN; 		/* Next horizon edge. */
-      
-      edgC = wSp->horizon + i;
-      vC = edgC->fce->vtx[(edgC->edg + 1) % 3];
-      if(vC == vF)
+      WLZ_VTX_3_SUB(u, pos[i], pos[tet[0]]);
+      WLZ_VTX_3_CROSS(n, u, w);
+      if((d = WLZ_VTX_3_SQRLEN(n)) > dMax)
       {
-	/* Have a complete loop of vertex edges. */
-	loopOK = 1;
-        break;
-      }
-      /* Find next edge and put it in after the current one. */
-      if(i < (wSp->nHorizon - 1))
-      {
-	edgN = edgC + 1;
-	for(j = i + 1; j < wSp->nHorizon; ++j)
-	{
-	  int	vT;
-	  WlzConvHullHorEdg *edgT;
-
-	  edgT = wSp->horizon + j;
-	  vT = edgT->fce->vtx[edgT->edg];
-	  if(vC == vT)
-	  {
-	    WlzConvHullHorEdg t;
-
-	    ++cnt;
-	    /* Found next edge swap it into position in the buffer. */
-	    t = *edgN;
-	    *edgN = *edgT;
-	    *edgT = t;
-	    break;
-	  }
-	}
+        dMax = d;
+	tet[2] = i;
       }
     }
-    if(loopOK && (cnt >= 3))
+    if(dMax <= wSp->eps * wSp->eps * WLZ_VTX_3_SQRLEN(w))
     {
-      wSp->nHorizon = cnt;
-    }
-    else
-    {
-      errNum = WLZ_ERR_PARAM_DATA;
-    }
-  }
-  return(errNum);
-}
-
-/*!
-* \return	New 3D convex hull domain.
-* \ingroup	WlzConvexHull
-* \brief	Creates a new 3D convex hull domain from the given
-* 		3D convex hull workspace using it's vertex and faces lists
-* 		together with it's vertex position pointer.
-* \param	wSp			Convex hull workspace.
-* \param	dstErr			Desination error pointer, may be NULL.
-*/
-static WlzConvHullDomain3	*WlzConvexHullFromWSp3(
-				  WlzConvHullWSp3 *wSp,
-				  WlzErrorNum *dstErr)
-{
-  int		nFce = 0,
-  		nVtx = 0;
-  WlzConvHullFce *fce;
-  WlzConvHullVtx *vtx;
-  WlzConvHullDomain3 *cvh = NULL;
-  WlzErrorNum	errNum = WLZ_ERR_NONE;
-
-  /* Find number of vertices and faces, building a lookup table (using
-   * the workspace permutation table) which maps given vertex array index
-   * to the convex hull domain vertex array index. */
-  if((vtx = wSp->vtxLst) != NULL)
-  {
-    int		i = 0;
-
-    do
-    {
-      wSp->vtxPrm[vtx->idx] = i++;
-      vtx = vtx->nxt;
-    } while(vtx != wSp->vtxLst);
-    nVtx = i;
-  }
-  if((nVtx > 0) && ((fce = wSp->fceLst) != NULL))
-  {
-    int		i = 0;
-
-    do
-    {
-      ++i;
-      fce = fce->nxt;
-    } while(fce != wSp->fceLst);
-    nFce = i;
-  }
-  if((nVtx <= 0) || (nFce <= 0))
-  {
-    errNum = WLZ_ERR_DOMAIN_DATA;
+      errNum = WLZ_ERR_DEGENERATE;
+    }
   }
-  /* Make convex hull domain. */
+  /* Then the vertex most distant from the plane of the first face. */
   if(errNum == WLZ_ERR_NONE)
   {
-    cvh = WlzMakeConvexHullDomain3(nVtx, nFce, wSp->vtxType, &errNum);
+    dMax = -1.0;
+    tet[3] = 0;
+    WLZ_VTX_3_SUB(u, pos[tet[1]], pos[tet[0]]);
+    WLZ_VTX_3_SUB(w, pos[tet[2]], pos[tet[0]]);
+    WLZ_VTX_3_CROSS(n, u, w);
+    for(i = 0; i < wSp->nPos; ++i)
+    {
+      WLZ_VTX_3_SUB(u, pos[i], pos[tet[0]]);
+      if((d = fabs(WLZ_VTX_3_DOT(n, u))) > dMax)
+      {
+        dMax = d;
+	tet[3] = i;
+      }
+    }
+    if(dMax <= wSp->eps * WLZ_VTX_3_LENGTH(n))
+    {
+      errNum = WLZ_ERR_DEGENERATE;
+    }
   }
-  /* Copy the vertices and translate the face indices into the new convex
-   * hull domain. */
-  if(errNum == WLZ_ERR_NONE)
+  /* Make the faces of the tetrahedron, each with it's vertices ordered
+   * so that the remaining vertex is inside. */
+  for(k = 0; (errNum == WLZ_ERR_NONE) && (k < 4); ++k)
   {
-    int		i;
-    int		*face;
-    WlzDVertex3 cen;
+    int		v[3];
 
-    i = 0;
-    vtx = wSp->vtxLst;
-    WLZ_VTX_3_ZERO(cen);
-    if(wSp->vtxType == WLZ_VERTEX_I3)
+    for(i = 0, j = 0; i < 4; ++i)
     {
-      do
+      if(i != k)
       {
-	WlzIVertex3 v;
-
-	v = wSp->vtxPos.i3[vtx->idx];
-	WLZ_VTX_3_ADD(cen, cen, v);
-	cvh->vertices.i3[i] = v;
-	++i;
-	vtx = vtx->nxt;
-      } while(vtx != wSp->vtxLst);
+        v[j++] = tet[i];
+      }
     }
-    else /* wSp->vtxType == WLZ_VERTEX_D3 */
+    WLZ_VTX_3_SUB(u, pos[v[1]], pos[v[0]]);
+    WLZ_VTX_3_SUB(w, pos[v[2]], pos[v[0]]);
+    WLZ_VTX_3_CROSS(n, u, w);
+    WLZ_VTX_3_SUB(u, pos[tet[k]], pos[v[0]]);
+    if(WLZ_VTX_3_DOT(n, u) > 0.0)
     {
-      do
-      {
-	WlzDVertex3 v;
-
-	v = wSp->vtxPos.d3[vtx->idx];
-	WLZ_VTX_3_ADD(cen, cen, v);
-	cvh->vertices.d3[i] = v;
-	++i;
-	vtx = vtx->nxt;
-      } while(vtx != wSp->vtxLst);
+      j = v[1]; v[1] = v[2]; v[2] = j;
     }
-    if(errNum == WLZ_ERR_NONE)
+    tetFce[k] = WlzConvHullQNewFce(wSp, v[0], v[1], v[2], &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    for(j = 0; j < 4; ++j)
     {
-      fce = wSp->fceLst;
-      i = 0;
-      do
+      for(k = j + 1; k < 4; ++k)
       {
-	int	j;
-
-	face = cvh->faces + i;
-	for(j = 0; j < 3; ++j)
-	{
-	  face[j] = wSp->vtxPrm[fce->vtx[j]];
-	}
-	i += 3;
-      fce = fce->nxt;
-      } while(fce != wSp->fceLst);
-      WLZ_VTX_3_SCALE(cen, cen, (1.0 / nVtx));
-      if(wSp->vtxType == WLZ_VERTEX_I3)
+        WlzConvHullQLink(wSp, tetFce[j], tetFce[k]);
+      }
+    }
+    /* Assign the remaining vertices to the faces. */
+    for(i = 0; i < wSp->nPos; ++i)
+    {
+      if((i != tet[0]) && (i != tet[1]) && (i != tet[2]) && (i != tet[3]))
       {
-	WLZ_VTX_3_NINT(cvh->centroid.i3, cen);
+        WlzConvHullQAssign(wSp, i, 4, tetFce);
       }
-      else /* wSp->vtxType == WLZ_VERTEX_D3 */
+    }
+    for(k = 0; (errNum == WLZ_ERR_NONE) && (k < 4); ++k)
+    {
+      if(wSp->fce[tetFce[k]].outHd >= 0)
       {
-	cvh->centroid.d3 = cen;
+        errNum = WlzConvHullQPush(wSp, tetFce[k]);
       }
-      cvh->vtxType = wSp->vtxType;
-      cvh->nVertices = nVtx;
-      cvh->nFaces = nFce;
     }
   }
-  if(dstErr)
-  {
-    *dstErr = errNum;
-  }
-  return(cvh);
+  return(errNum);
 }
 
-#ifdef WLZ_CONVHULL_DEBUG_FCE
 /*!
 * \return	Woolz error code.
 * \ingroup	WlzConvexHull
-* \brief	Checks the topology  of the given face.
-* 		This function is only intended for use in debugging
-* 		it is very compute hungry and quite inefficient.
-* \param	wSp			Given workspace.
-* \param	fce			Given face.
+* \brief	Adds the vertex which is furthest outside the given face
+* 		to the convex hull. All faces visible from this vertex,
+* 		including those which it lies in the plane of, are
+* 		replaced by a cone of new faces joining the vertex to the
+* 		horizon edges and the vertices outside of the visible
+* 		faces are reassigned to the new faces.
+* \param	wSp			Quickhull workspace.
+* \param	f0			Face with vertices outside of it.
+* \param	itr			Iteration number which is used to
+* 					mark visited faces.
 */
-static WlzErrorNum		WlzConvHullChkFce(
-				  WlzConvHullWSp3 *wSp,
-				  WlzConvHullFce *fce)
+static WlzErrorNum		WlzConvHullQAddVtx(
+				  WlzConvHullQWSp *wSp,
+				  int f0,
+				  int itr)
 {
+  int		i,
+  		q,
+		eye;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
 
-  if((fce == NULL) ||
-     (fce->opp[0] == NULL) || (fce->opp[1] == NULL) || (fce->opp[2] == NULL))
+  eye = wSp->fce[f0].outFar;
+  /* Find the visible faces and the horizon by a breadth first search
+   * from the given face. */
+  wSp->nVis = 0;
+  wSp->nHrz = 0;
+  wSp->fce[f0].visit = itr;
+  wSp->vis[wSp->nVis++] = f0;
+  for(q = 0; (errNum == WLZ_ERR_NONE) && (q < wSp->nVis); ++q)
   {
-    errNum = WLZ_ERR_PARAM_NULL;
-  }
-  /* Check the topology. */
-  if(errNum == WLZ_ERR_NONE) 
-  {
-    int		i;
+    int		f;
 
+    f = wSp->vis[q];
     for(i = 0; i < 3; ++i)
     {
-      int	j,
-      		v0,
-      		v1;
-      WlzConvHullFce *oFce;
-
-      v0 = fce->vtx[i];
-      v1 = fce->vtx[(i + 1) % 3];
-      oFce = fce->opp[i];
-      if((oFce->opp[0] == NULL) ||
-         (oFce->opp[1] == NULL) ||
-	 (oFce->opp[2] == NULL))
-      {
-        errNum = WLZ_ERR_PARAM_NULL;
-	break;
-      }
-      for(j = 0; j < 3; ++j)
+      int	g;
+      double	d;
+      WlzConvHullQFce *fce,
+      		*gFce;
+
+      fce = wSp->fce + f;
+      g = fce->opp[i];
+      gFce = wSp->fce + g;
+      if(gFce->visit != itr)
       {
-        if(oFce->vtx[j] == v1)
+	/* Faces with the eye in their plane are replaced too, otherwise
+	 * vertices may be left on the edges or within the faces of the
+	 * convex hull. */
+	(void )WlzConvHullQAbove(wSp, gFce, eye, &d);
+	if(d >= -(gFce->thr))
+	{
+	  if(wSp->nVis >= wSp->maxVis)
+	  {
+	    int	max,
+	    	*vis;
+
+	    max = 2 * wSp->maxVis;
+	    if((vis = (int *)AlcRealloc(wSp->vis, sizeof(int) * max)) == NULL)
+	    {
+	      errNum = WLZ_ERR_MEM_ALLOC;
+	      break;
+	    }
+	    wSp->vis = vis;
+	    wSp->maxVis = max;
+	  }
+	  gFce->visit = itr;
+	  wSp->vis[wSp->nVis++] = g;
+	}
+	else
 	{
-	  if((oFce->vtx[(j + 1) % 3] != v0) || (oFce->opp[j] != fce))
+	  int	j;
+	  WlzConvHullQHrz *hrz;
+
+	  if(wSp->nHrz >= wSp->maxHrz)
+	  {
+	    int	max,
+	    	*nwFce;
+
+	    max = 2 * wSp->maxHrz;
+	    if((hrz = (WlzConvHullQHrz *)
+	              AlcRealloc(wSp->hrz,
+		                 sizeof(WlzConvHullQHrz) * max)) != NULL)
+	    {
+	      wSp->hrz = hrz;
+	    }
+	    if((hrz == NULL) ||
+	       ((nwFce = (int *)AlcRealloc(wSp->nwFce,
+	                                   sizeof(int) * max)) == NULL))
+	    {
+	      errNum = WLZ_ERR_MEM_ALLOC;
+	      break;
+	    }
+	    wSp->nwFce = nwFce;
+	    wSp->maxHrz = max;
+	  }
+	  hrz = wSp->hrz + wSp->nHrz++;
+	  hrz->vtx[0] = fce->vtx[i];
+	  hrz->vtx[1] = fce->vtx[(i + 1) % 3];
+	  hrz->fce = g;
+	  for(j = 0; (j < 3) && (gFce->opp[j] != f); ++j)
 	  {
-	    errNum = WLZ_ERR_PARAM_DATA;
+	    ;
 	  }
-	  break;
+	  hrz->edg = j;
 	}
       }
-      if(j == 4)
-      {
-        errNum = WLZ_ERR_PARAM_DATA;
-	break;
-      }
     }
   }
-  return(errNum);
-}
-
-/*!
-* \return	Woolz error code.
-* \ingroup	WlzConvexHull
-* \brief	Checks the topology  of all the faces in the face
-* 		list of the workspace.
-* 		This function is only intended for use in debugging
-* 		it is very compute hungry and quite inefficient.
-* \param	wSp			Given workspace.
-*/
-static WlzErrorNum		WlzConvHullChkAll(
-				  WlzConvHullWSp3 *wSp)
-{
-  WlzErrorNum	errNum = WLZ_ERR_NONE;
-
-  if(wSp && wSp->fceLst && wSp->vtxLst)
+  /* Make a new face for each horizon edge, linking it to the face which
+   * remains on the horizon edge. */
+  for(q = 0; (errNum == WLZ_ERR_NONE) && (q < wSp->nHrz); ++q)
   {
-    int		cnt = 0;
-    const int	cntMax = 1000000;
-    WlzConvHullFce *fce;
+    int		f;
+    WlzConvHullQHrz *hrz;
 
-    fce = wSp->fceLst;
-    do
+    hrz = wSp->hrz + q;
+    f = WlzConvHullQNewFce(wSp, hrz->vtx[0], hrz->vtx[1], eye, &errNum);
+    if(errNum == WLZ_ERR_NONE)
     {
-      if((errNum = WlzConvHullChkFce(wSp, fce)) != WLZ_ERR_NONE)
+      wSp->nwFce[q] = f;
+      wSp->fce[f].opp[0] = hrz->fce;
+      wSp->fce[hrz->fce].opp[hrz->edg] = f;
+      if(wSp->hrzMap[hrz->vtx[0]] >= 0)
       {
-	break;
+	/* The horizon is not a simple cycle. */
+        errNum = WLZ_ERR_ALG;
       }
-      else if(cnt > cntMax)
+      else
       {
-        errNum = WLZ_ERR_PARAM_DATA;
-	break;
+	wSp->hrzMap[hrz->vtx[0]] = f;
       }
-      fce = fce->nxt;
-    } while(fce != wSp->fceLst);
+    }
   }
-  return(errNum);
-}
-#endif /* WLZ_CONVHULL_DEBUG_FCE */
-
-/*!
-* \return	Woolz error code. If the volume of the tetrahedron is
-* 		zero WLZ_ERR_DEGENERATE will be returned.
-* \ingroup	WlzConvexHull
-* \brief	Sets the vertex permutation indices so that the first
-* 		four are those of a tetrahedron with z_max, z_min
-* 		then the vertex giving the max area triangle followed
-* 		by the vertex giving the max volume tetrahedron.
-* \param	nPnt			Number of given vertex positions.
-* \param	wSp			Given workspace.
-* \param	dstZVol			Destination pointer used to set
-* 					for zero volume tetrahedron.
-*/
-static WlzErrorNum		WlzConvHullInitTet(
-				  int nPnt,
-				  WlzConvHullWSp3 *wSp)
-{
-  int		i,
-	      	m,
-	        n;
-  double	a,
-  		aMax;
-  WlzDVertex3	u0,
-  		pos;
-  int	      	tetIdx[4], /* Buffer of 4 indices to zMax, zMin, yMin, xMin. */
-		oldIdx[4],
-		addIdx[4],
-		delIdx[4];
-  WlzDVertex3   tetPos[4]; /* Buffer of 4 positions, zMax, zMin, yMin, xMin. */
-  WlzErrorNum   errNum = WLZ_ERR_NONE;
-  const double	eps = WLZ_CONVHULL_EPS;
-
-  tetIdx[0] = tetIdx[1] = tetIdx[2] = tetIdx[3] = 0;
-  /* Find vertices with max (tetPos[0]) and min (tetPos[1]) z */
-  if(wSp->vtxType == WLZ_VERTEX_I3)
+  /* Link the new faces to each other around the eye vertex. */
+  for(q = 0; (errNum == WLZ_ERR_NONE) && (q < wSp->nHrz); ++q)
   {
-    WlzIVertex3 v;
+    int		f,
+    		g;
 
-    v = wSp->vtxPos.i3[wSp->vtxPrm[0]];
-    WLZ_VTX_3_SET(tetPos[0], v.vtX, v.vtY, v.vtZ);
-  }
-  else
-  {
-    tetPos[0] = wSp->vtxPos.d3[wSp->vtxPrm[0]];
-  }
-  tetPos[1] = tetPos[2] = tetPos[3] = tetPos[0];
-  for(i = 1; i < nPnt; ++i)
-  {
-    if(wSp->vtxType == WLZ_VERTEX_I3)
+    f = wSp->nwFce[q];
+    if((g = wSp->hrzMap[wSp->hrz[q].vtx[1]]) < 0)
     {
-      WlzIVertex3 v;
-
-      v = wSp->vtxPos.i3[wSp->vtxPrm[i]];
-      WLZ_VTX_3_SET(pos, v.vtX, v.vtY, v.vtZ);
+      errNum = WLZ_ERR_ALG;
     }
     else
     {
-      pos = wSp->vtxPos.d3[wSp->vtxPrm[i]];
-    }
-    if(pos.vtZ > tetPos[0].vtZ)
-    {
-      tetIdx[0] = i;
-      tetPos[0] = pos;
-    }
-    else if(pos.vtZ < tetPos[1].vtZ)
-    {
-      tetIdx[1] = i;
-      tetPos[1] = pos;
+      wSp->fce[f].opp[1] = g;
+      wSp->fce[g].opp[2] = f;
     }
   }
-  WLZ_VTX_3_SUB(u0, tetPos[1], tetPos[0]);
-  a = WLZ_VTX_3_SQRLEN(u0);
-  if(a < eps)
+  for(q = 0; q < wSp->nHrz; ++q)
   {
-    errNum = WLZ_ERR_DEGENERATE;
+    wSp->hrzMap[wSp->hrz[q].vtx[0]] = -1;
   }
+  /* Reassign the vertices outside of the visible faces to the new faces
+   * and then free the visible faces. */
   if(errNum == WLZ_ERR_NONE)
   {
-    /* Find vertex creates max area triangle with this line segment. */
-    aMax = 0.0;
-    for(i = 0; i < nPnt; ++i)
+    for(q = 0; q < wSp->nVis; ++q)
     {
-      if((i != tetIdx[0]) && (i != tetIdx[1]))
-      {
-	WlzDVertex3 u1,
-		    u2;
+      int	f,
+      		v;
 
-	if(wSp->vtxType == WLZ_VERTEX_I3)
-	{
-	  WlzIVertex3 v;
+      f = wSp->vis[q];
+      v = wSp->fce[f].outHd;
+      while(v >= 0)
+      {
+	int	nxt;
 
-	  v = wSp->vtxPos.i3[wSp->vtxPrm[i]];
-	  WLZ_VTX_3_SET(pos, v.vtX, v.vtY, v.vtZ);
-	}
-	else
-	{
-	  pos = wSp->vtxPos.d3[wSp->vtxPrm[i]];
-	}
-	WLZ_VTX_3_SUB(u1, pos, tetPos[0]);
-	WLZ_VTX_3_CROSS(u2, u0, u1);
-	a = WLZ_VTX_3_SQRLEN(u2);
-	if(a > aMax)
+	nxt = wSp->pntNxt[v];
+	if(v != eye)
 	{
-	  tetIdx[2] = i;
-	  tetPos[2] = pos;
-	  aMax = a;
+	  WlzConvHullQAssign(wSp, v, wSp->nHrz, wSp->nwFce);
 	}
+	v = nxt;
       }
+      wSp->fce[f].alive = 0;
+      wSp->fce[f].outHd = wSp->freeFce;
+      wSp->freeFce = f;
     }
-    if(aMax < eps)
+    for(q = 0; (errNum == WLZ_ERR_NONE) && (q < wSp->nHrz); ++q)
     {
-      errNum = WLZ_ERR_DEGENERATE;
+      int	f;
+
+      f = wSp->nwFce[q];
+      if(wSp->fce[f].outHd >= 0)
+      {
+	errNum = WlzConvHullQPush(wSp, f);
+      }
     }
   }
-  if(errNum == WLZ_ERR_NONE)
+  return(errNum);
+}
+
+/*!
+* \return	New 3D convex hull domain or NULL on error.
+* \ingroup	WlzConvexHull
+* \brief	Creates a new 3D convex hull domain from the faces of
+* 		the quickhull workspace. The faces of the domain have
+* 		their vertices ordered clockwise when viewed from outside
+* 		of the convex hull.
+* \param	wSp			Quickhull workspace.
+* \param	pType			Type of the given vertices.
+* \param	pnt			The given vertices.
+* \param	prm			Indices of the given vertices used for
+* 					the workspace vertices.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzConvHullDomain3	*WlzConvHullQToDom(
+				  WlzConvHullQWSp *wSp,
+				  WlzVertexType pType,
+				  WlzVertexP pnt,
+				  int *prm,
+				  WlzErrorNum *dstErr)
+{
+  int		f,
+  		nFce = 0,
+		nVtx = 0;
+  int		*map;
+  WlzConvHullDomain3 *cvh = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  /* Map the workspace vertices used by the faces to convex hull domain
+   * vertices. */
+  map = wSp->hrzMap;
+  for(f = 0; f < wSp->nFce; ++f)
   {
-    /* Find vertex creates max volume tetrahedron with this triangle. */
-    aMax = 0.0;
-    for(i = 0; i < nPnt; ++i)
+    if(wSp->fce[f].alive)
     {
-      if((i != tetIdx[0]) && (i != tetIdx[1]) && (i != tetIdx[2]))
+      int	j;
+
+      ++nFce;
+      for(j = 0; j < 3; ++j)
       {
-	if(wSp->vtxType == WLZ_VERTEX_I3)
-	{
-	  WlzIVertex3 v;
+	int	v;
 
-	  v = wSp->vtxPos.i3[wSp->vtxPrm[i]];
-	  WLZ_VTX_3_SET(pos, v.vtX, v.vtY, v.vtZ);
-	}
-	else
-	{
-	  pos = wSp->vtxPos.d3[wSp->vtxPrm[i]];
-	}
-	a = WlzGeomTetraSnVolume6(tetPos[0], tetPos[1], tetPos[2], pos);
-	a *= a;
-        if(a > aMax)	
+	v = wSp->fce[f].vtx[j];
+        if(map[v] < 0)
 	{
-	  tetIdx[3] = i;
-	  tetPos[3] = pos;
-	  aMax = a;
+	  map[v] = nVtx++;
 	}
       }
     }
-    if(aMax < eps)
-    {
-      errNum = WLZ_ERR_DEGENERATE;
-    }
   }
+  cvh = WlzMakeConvexHullDomain3(nVtx, nFce, pType, &errNum);
   if(errNum == WLZ_ERR_NONE)
   {
-    a = WlzGeomTetraSnVolume6(tetPos[0], tetPos[1], tetPos[2], tetPos[3]);
-    if(a < 0)
-    {
-      m = tetIdx[3]; tetIdx[3] = tetIdx[2]; tetIdx[2] = m;
-      pos = tetPos[3]; tetPos[3] = tetPos[2]; tetPos[2] = pos;
-    }
-    /* Make the first four vertex indices of the permutation buffer the
-     * indices of the tetrahedron. */
-    for(i = 0; i < 4; ++i)
-    {
-      oldIdx[i] = wSp->vtxPrm[i];
-    }
-    for(i = 0; i < 4; ++i)
-    {
-      int	t;
+    int		v,
+    		i = 0;
+    WlzDVertex3 cen;
 
-      t = tetIdx[i];
-      if(t < 4)
-      {
-	wSp->vtxPrm[i] = oldIdx[t];
-      }
-      else
+    WLZ_VTX_3_ZERO(cen);
+    for(v = 0; v < wSp->nPos; ++v)
+    {
+      if(map[v] >= 0)
       {
-	wSp->vtxPrm[i] = wSp->vtxPrm[t];
+	if(pType == WLZ_VERTEX_I3)
+	{
+	  cvh->vertices.i3[map[v]] = pnt.i3[prm[v]];
+	}
+	else
+	{
+	  cvh->vertices.d3[map[v]] = pnt.d3[prm[v]];
+	}
+	WLZ_VTX_3_ADD(cen, cen, wSp->pos[v]);
       }
     }
-    m = n = 0;
-    for(i = 0; i < 4; ++i)
+    for(f = 0; f < wSp->nFce; ++f)
     {
-      int	t;
-
-      t = wSp->vtxPrm[i];
-      if((t != oldIdx[0]) && (t != oldIdx[1]) &&
-	 (t != oldIdx[2]) && (t != oldIdx[3]))
+      if(wSp->fce[f].alive)
       {
-	addIdx[n++] = t;
-      }
-      t = oldIdx[i];
-      if((t != wSp->vtxPrm[0]) && (t != wSp->vtxPrm[1]) &&
-	 (t != wSp->vtxPrm[2]) && (t != wSp->vtxPrm[3]))
-      {
-	delIdx[m++] = t;
+	cvh->faces[i++] = map[wSp->fce[f].vtx[0]];
+	cvh->faces[i++] = map[wSp->fce[f].vtx[2]];
+	cvh->faces[i++] = map[wSp->fce[f].vtx[1]];
       }
     }
-    for(i = 4; (n > 0) && (i < nPnt); ++i)
+    WLZ_VTX_3_SCALE(cen, cen, (1.0 / nVtx));
+    if(pType == WLZ_VERTEX_I3)
     {
-      int	j,
-		t;
-
-      t = wSp->vtxPrm[i];
-      for(j = n - 1; j >= 0; --j)
-      {
-	if(t == addIdx[j])
-	{
-	  wSp->vtxPrm[i] = delIdx[--m];
-	  break;
-	}
-      }
-      n = m;
+      WLZ_VTX_3_NINT(cvh->centroid.i3, cen);
     }
-    /* Randomise the indices above the first four of the tetrahderon. */
-    n = nPnt - 4;
-    srand(0);
-    for(i = 0; i < n; ++i)
+    else
     {
-      int		r,
-		  t;
-
-      r = (rand() % n) + 4;
-      t = wSp->vtxPrm[r];
-      wSp->vtxPrm[r] = wSp->vtxPrm[i + 4];
-      wSp->vtxPrm[i + 4] = t;
+      cvh->centroid.d3 = cen;
     }
+    cvh->nVertices = nVtx;
+    cvh->nFaces = nFce;
   }
-  return(errNum);
+  *dstErr = errNum;
+  return(cvh);
 }
 
 /*!
-* \return	Woolz error code.
+* \return	New 3D convex hull domain or NULL on error.
 * \ingroup	WlzConvexHull
-* \brief	Build the initial tetrahedron faces, check for vertices inside
-* 		the initial tetrahedron, adding vertices to the vertex list if
-* 		they're not in the tetrahedron and initialising the conflict
-* 		graph with all visible pairs of remaining vertices and faces.
-* \param	nPnt			Number of given vertex positions.
-* \param	wSp			Given workspace.
+* \brief	Computes the 3D convex hull of the given vertices using
+* 		the quickhull algorithm:
+* 		C. Bradford Barber, David P. Dobkin and Hannu Huhdanpaa.
+* 		"The Quickhull Algorithm for Convex Hulls", ACM Trans. on
+* 		Mathematical Software, 22(4):469-483, 1996.
+* 		Starting from a tetrahedron, each remaining vertex is
+* 		assigned to a face that it is outside of. The vertex
+* 		furthest outside a face is then added to the convex
+* 		hull, replacing the faces visible from it and the
+* 		vertices outside these faces are reassigned to the new
+* 		faces. Vertices which are not outside any of the new
+* 		faces are inside the convex hull and are discarded.
+* 		For integer vertices the visibility tests are exact.
+* \param	pType			Type of vertex given, must be either
+* 					WLZ_VERTEX_I3 or WLZ_VERTEX_D3.
+* \param	nPnt			Number of vertex indices.
+* \param	pnt			The given vertices.
+* \param	prm			Indices of the distinct given vertices.
+* \param	dstErr			Destination error pointer, the error
+* 					code will be WLZ_ERR_DEGENERATE and
+* 					no domain returned if the vertices
+* 					do not span a volume.
 */
-static WlzErrorNum		WlzConvHullBuildTet(
+static WlzConvHullDomain3	*WlzConvexHullQuick3(
+				  WlzVertexType pType,
 				  int nPnt,
-				  WlzConvHullWSp3 *wSp)
+				  WlzVertexP pnt,
+				  int *prm,
+				  WlzErrorNum *dstErr)
 {
   int		i;
-  WlzConvHullVtx *vtx[4];
-  WlzConvHullFce **fce;
+  WlzConvHullQWSp wSp;
+  WlzConvHullDomain3 *cvh = NULL;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
 
-  fce = wSp->fceBuf;
-  for(i = 0; i < 4; ++i)
+  (void )memset(&wSp, 0, sizeof(WlzConvHullQWSp));
+  wSp.nPos = nPnt;
+  wSp.freeFce = -1;
+  wSp.eps = (pType == WLZ_VERTEX_I3)? 0.0: WLZ_CONVHULL_EPS;
+  wSp.maxVis = wSp.maxHrz = 64;
+  if(((wSp.pos = (WlzDVertex3 *)
+		 AlcMalloc(sizeof(WlzDVertex3) * nPnt)) == NULL) ||
+     ((wSp.pntNxt = (int *)AlcMalloc(sizeof(int) * nPnt)) == NULL) ||
+     ((wSp.hrzMap = (int *)AlcMalloc(sizeof(int) * nPnt)) == NULL) ||
+     ((wSp.vis = (int *)AlcMalloc(sizeof(int) * wSp.maxVis)) == NULL) ||
+     ((wSp.hrz = (WlzConvHullQHrz *)
+                 AlcMalloc(sizeof(WlzConvHullQHrz) * wSp.maxHrz)) == NULL) ||
+     ((wSp.nwFce = (int *)AlcMalloc(sizeof(int) * wSp.maxHrz)) == NULL))
   {
-    fce[i] = WlzConvHullNewFce(wSp, NULL);
-    vtx[i] = WlzConvHullNewVtx(wSp, NULL);
-    vtx[i]->idx = wSp->vtxPrm[i];
+    errNum = WLZ_ERR_MEM_ALLOC;
   }
-  /* 0 */
-  fce[0]->vtx[0] = vtx[0]->idx;
-  fce[0]->vtx[1] = vtx[2]->idx;
-  fce[0]->vtx[2] = vtx[1]->idx;
-  fce[0]->opp[0] = fce[2];
-  fce[0]->opp[1] = fce[3];
-  fce[0]->opp[2] = fce[1];
-  /* 1 */
-  fce[1]->vtx[0] = vtx[1]->idx;
-  fce[1]->vtx[1] = vtx[3]->idx;
-  fce[1]->vtx[2] = vtx[0]->idx;
-  fce[1]->opp[0] = fce[3];
-  fce[1]->opp[1] = fce[2];
-  fce[1]->opp[2] = fce[0];
-  /* 2 */
-  fce[2]->vtx[0] = vtx[2]->idx;
-  fce[2]->vtx[1] = vtx[0]->idx;
-  fce[2]->vtx[2] = vtx[3]->idx;
-  fce[2]->opp[0] = fce[0];
-  fce[2]->opp[1] = fce[1];
-  fce[2]->opp[2] = fce[3];
-  /* 3 */
-  fce[3]->vtx[0] = vtx[3]->idx;
-  fce[3]->vtx[1] = vtx[1]->idx;
-  fce[3]->vtx[2] = vtx[2]->idx;
-  fce[3]->opp[0] = fce[1];
-  fce[3]->opp[1] = fce[0];
-  fce[3]->opp[2] = fce[2];
-  for(i = 0; i < 4; ++i)
+  if(errNum == WLZ_ERR_NONE)
   {
-    if((errNum = WlzConvHullFceNrm(wSp, fce[i])) != WLZ_ERR_NONE)
+    for(i = 0; i < nPnt; ++i)
     {
-      break;
+      if(pType == WLZ_VERTEX_I3)
+      {
+	WlzIVertex3 v;
+
+	v = pnt.i3[prm[i]];
+	WLZ_VTX_3_SET(wSp.pos[i], v.vtX, v.vtY, v.vtZ);
+      }
+      else
+      {
+        wSp.pos[i] = pnt.d3[prm[i]];
+      }
+      wSp.pntNxt[i] = -1;
+      wSp.hrzMap[i] = -1;
     }
-    WlzConHullAddConvexFce(wSp, fce[i]);
-    WlzConHullAddConvexVtx(wSp, vtx[i]);
+    errNum = WlzConvHullQInitTet(&wSp);
   }
   if(errNum == WLZ_ERR_NONE)
   {
-    int		i;
+    int		itr = 0;
 
-    for(i = 4; i < nPnt; ++i)
+    while((errNum == WLZ_ERR_NONE) && (wSp.nStk > 0))
     {
-      int	behind = 1;
-      WlzConvHullVtx *newVtx;
+      int	f;
 
-      newVtx = WlzConvHullNewVtx(wSp, &errNum);
-      if(errNum == WLZ_ERR_NONE)
+      f = wSp.stk[--(wSp.nStk)];
+      if(wSp.fce[f].alive && (wSp.fce[f].outHd >= 0))
       {
-	int		f;
-
-	newVtx->idx = wSp->vtxPrm[i];
-	for(f = 0; f < 4; ++f)
-	{
-	  WlzConvHullFce *qFce;
-
-	  qFce = wSp->fceBuf[f];
-	  if(WlzConvHullFceBehind(wSp, wSp->fceBuf[f], newVtx->idx) == 0)
-	  {
-	    behind = 0;
-	  }
-	  else
-	  {
-	    errNum = WlzConvHullConfAdd(wSp, qFce, newVtx);
-	    if(errNum != WLZ_ERR_NONE)
-	    {
-	      i = nPnt; 	    	    /* Break from outer vertex loop. */
-	      break;			      /* Break from inner face loop. */
-	    }
-	  }
-	}
-	if(behind)
-	{
-	  /* Remove vertex as behind all faces and conflicts of the current
-	   * convex hull. */
-	  WlzConvHullDelVtx(wSp, NULL, newVtx);
-	}
-	else
-	{
-	  /* Push vertex onto the pending vertex queue. */
-	  WlzConHullPushPendingVtx(wSp, newVtx);
-	}
+        errNum = WlzConvHullQAddVtx(&wSp, f, itr++);
       }
     }
   }
-  return(errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    cvh = WlzConvHullQToDom(&wSp, pType, pnt, prm, &errNum);
+  }
+  AlcFree(wSp.pos);
+  AlcFree(wSp.pntNxt);
+  AlcFree(wSp.hrzMap);
+  AlcFree(wSp.vis);
+  AlcFree(wSp.hrz);
+  AlcFree(wSp.nwFce);
+  AlcFree(wSp.fce);
+  AlcFree(wSp.stk);
+  *dstErr = errNum;
+  return(cvh);
 }
 
 /*!
@@ -2190,27 +1316,13 @@ static WlzConvHullDomain3	*WlzConvexHullDegenerate3(
 * \return	New 3D convex hull domain.
 * \ingroup	WlzConvexHull
 * \brief	Creates a new 3D convex hull domain which encloses the
-* 		given vertices using a randomized incremental algorithm
-* 		based on Clarkson and Shor's algorithm:
-* 		Kenneth L. Clarkson and PeterW. Shor. "Applications of Random
-* 		Sampling in Computational Geometry, II", Discrete &
-* 		Computational Geometry 4(1) 1989.
-* 		This algorithm is also described in a way more suited
-* 		for implementation in:
-* 		Mark de Berg, Otfried Cheong, Marc van Kreveld and
-* 		Mark Overmars. "Computational Geometry: Algorithms and
-* 		Applications", Springer.
-* 		The algorithm makes use of randomized insertion,
-* 		lists, queues and a conflict graph of conflicts between
-* 		vertices and faces. A vertex and face are said to be in
-* 		conflict when a vertex does not lie behind the face,
-* 		where behind means in the half-plane defined by the
-* 		face and the body of the convex hull. In practice the
-* 		vertex-behind-face test accounts for the almost all
-* 		the CPU time. The expected run time for this algorithm
-* 		is O(n log n). On a 3GHz Intel i7 the computation time
-* 		is a ~10ms for 10^4 vertices randomly distributed over
-* 		a cube but ~1s for 10^5 vertices.
+* 		given vertices using the quickhull algorithm, see
+* 		WlzConvexHullQuick3(). Duplicate vertices are removed
+* 		before the convex hull is computed.
+* 		The expected run time for this algorithm is O(n log n)
+* 		and for vertices from the boundary of a domain, most of
+* 		which are on the convex hull, it is O(n h) where h is
+* 		the number of convex hull faces.
 * 		When given a degenerate set of vertices (all on a single plane,
 * 		all on a single line or all coincident) this function will
 * 		still compute a 3D convex hull domain but will set the error
@@ -2220,10 +1332,8 @@ static WlzConvHullDomain3	*WlzConvexHullDegenerate3(
 * \param	nPnt			Number of given vertices.
 * \param	pnt			The given vertices.
 * \param	dstErr			Destination error pointer, may be NULL.
-* 					If the volume of the tetrahedron
-* 					with maximum/minimum z coordinate
-* 					and minimum x and y coordiantes is
-* 					zero the erro code will be
+* 					If the given vertices do not span
+* 					a volume the error code will be
 * 					WLZ_ERR_DEGENERATE.
 */
 WlzConvHullDomain3		*WlzConvexHullFromVtx3(
@@ -2232,7 +1342,8 @@ WlzConvHullDomain3		*WlzConvexHullFromVtx3(
 				  WlzVertexP pnt,
 				  WlzErrorNum *dstErr)
 {
-  WlzConvHullWSp3 *wSp = NULL;
+  int		nPrm = 0;
+  int		*prm = NULL;
   WlzConvHullDomain3 *cvh = NULL;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
   const double	eps = WLZ_CONVHULL_EPS;
@@ -2249,10 +1360,9 @@ WlzConvHullDomain3		*WlzConvexHullFromVtx3(
   {
     errNum = WLZ_ERR_PARAM_TYPE;
   }
-  if(errNum == WLZ_ERR_NONE)
+  else if((prm = (int *)AlcMalloc(sizeof(int) * nPnt)) == NULL)
   {
-    /* Allocate and initialise datastructures. */
-    wSp = WlzConvHullMakeWSp3(pType, nPnt, pnt, &errNum);
+    errNum = WLZ_ERR_MEM_ALLOC;
   }
   if(errNum == WLZ_ERR_NONE)
   {
@@ -2263,17 +1373,15 @@ WlzConvHullDomain3		*WlzConvexHullFromVtx3(
      * duplicates. */
     for(i = 0; i < nPnt; ++i)
     {
-      wSp->vtxPrm[i] = i;
+      prm[i] = i;
     }
     if(pType == WLZ_VERTEX_I3)
     {
-      (void )AlgHeapSortIdx(pnt.i3, wSp->vtxPrm, nPnt,
-                            WlzVertexHeapSortIdxFnI3);
+      (void )AlgHeapSortIdx(pnt.i3, prm, nPnt, WlzVertexHeapSortIdxFnI3);
     }
     else /* vtxType == WLZ_VERTEX_D3 */
     {
-      (void )AlgHeapSortIdx(pnt.d3, wSp->vtxPrm, nPnt,
-                            WlzVertexHeapSortIdxFnD3);
+      (void )AlgHeapSortIdx(pnt.d3, prm, nPnt, WlzVertexHeapSortIdxFnD3);
     }
     i = 0;
     j = 0;
@@ -2284,15 +1392,15 @@ WlzConvHullDomain3		*WlzConvexHullFromVtx3(
 	WlzIVertex3 v0,
 		    v1;
 
-	v0 = pnt.i3[wSp->vtxPrm[i]];
-	v1 = pnt.i3[wSp->vtxPrm[j]];
+	v0 = pnt.i3[prm[i]];
+	v1 = pnt.i3[prm[j]];
 	if((v0.vtX != v1.vtX) ||
 	   (v0.vtY != v1.vtY) ||
 	   (v0.vtZ != v1.vtZ))
 	{
 	  ++i;
 	}
-	wSp->vtxPrm[i] = wSp->vtxPrm[j];
+	prm[i] = prm[j];
 	++j;
       }
     }
@@ -2303,190 +1411,29 @@ WlzConvHullDomain3		*WlzConvexHullFromVtx3(
 	WlzDVertex3 v0,
 		    v1;
 
-	v0 = pnt.d3[wSp->vtxPrm[i]];
-	v1 = pnt.d3[wSp->vtxPrm[j]];
+	v0 = pnt.d3[prm[i]];
+	v1 = pnt.d3[prm[j]];
 	if((fabs(v0.vtX - v1.vtX) > eps) ||
 	   (fabs(v0.vtY - v1.vtY) > eps) ||
 	   (fabs(v0.vtZ - v1.vtZ) > eps))
 	{
 	  ++i;
 	}
-	wSp->vtxPrm[i] = wSp->vtxPrm[j];
+	prm[i] = prm[j];
 	++j;
       }
     }
-    nPnt = i + 1;
-    if(nPnt < 4)
+    nPrm = i + 1;
+    if(nPrm < 4)
     {
       errNum = WLZ_ERR_PARAM_DATA;
     }
   }
-  /* Make sure there's room for at least the 4 initial vertices and faces
-   * in the respective pools. */
-  if(errNum == WLZ_ERR_NONE)
-  {
-    errNum = WlzConvHullFcePoolExpand(&(wSp->fcePool), 4);
-  }
-  if(errNum == WLZ_ERR_NONE)
-  {
-    errNum = WlzConvHullVtxPoolExpand(&(wSp->vtxPool), 4);
-  }
   if(errNum == WLZ_ERR_NONE)
   {
-    errNum = WlzConvHullFceBufExpand(wSp, 4);
-  }
-  /* Find four vertices that form a tetrahedron with the max/min z and min
-   * y and x coordinates. Make these the first for in the permutation
-   * index table. Randomise the remaining indices. */
-  if(errNum == WLZ_ERR_NONE)
-  {
-    errNum = WlzConvHullInitTet(nPnt, wSp);
-    if(errNum != WLZ_ERR_DEGENERATE)
-    {
-      /* Build the initial faces, check for vertices inside the initial
-       * tetrahedron, adding vertices to the vertex list if they're not
-       * in the tetrahedron and initialise the conflict graph with all
-       * visible pairs of remaining vertices and faces. */
-      if(errNum == WLZ_ERR_NONE)
-      {
-	errNum = WlzConvHullBuildTet(nPnt, wSp);
-      }
-      if(errNum == WLZ_ERR_NONE)
-      {
-#ifdef WLZ_CONVHULL_DEBUG_ITR
-	int	itr = 0,
-		maxItr = INT_MAX;
-#endif /* WLZ_CONVHULL_DEBUG_ITR */
-	WlzConvHullVtx *vtx;
-
-	/* For each vertex in the pending vertex queue add it to the convex
-	 * hull. */ 
-	while((errNum == WLZ_ERR_NONE) &&
-#ifdef WLZ_CONVHULL_DEBUG_ITR
-	      (itr++ < maxItr) &&
-#endif /* WLZ_CONVHULL_DEBUG_ITR */
-	      ((vtx = WlzConHullPopPendingVtx(wSp)) != NULL))
-	{
-	  /* Are thre conflicts?. */
-	  if(vtx->arc)
-	  {
-	    int	f;
-
-	    /* Determine the horizon as an array with those faces/edges that
-	     * are to remain and while doing so build a list of faces to be
-	     * deleted. */
-	    errNum = WlzConvHullBuildHorizon(wSp, vtx);
-	    if(errNum == WLZ_ERR_NONE)
-	    {
-	      /* Delete all faces which conflict with the vertex. */
-	      for(f = 0; f < wSp->nFceBuf; ++f)
-	      {
-		WlzConvHullDelFce(wSp, &(wSp->fceLst), wSp->fceBuf[f]);
-	      }
-	      wSp->nFceBuf = 0;
-	      /* Make sure there's space allocated for a face per horizon edge
-	       * (more than enough). */
-	      errNum = WlzConvHullFcePoolExpand(&(wSp->fcePool),
-	                                        wSp->nHorizon);
-	    }
-	    /* Make sure there's enough space in the face buffer for the new
-	     * faces. */
-	    if(errNum == WLZ_ERR_NONE)
-	    {
-	      wSp->nFceBuf = wSp->nHorizon;
-	      errNum = WlzConvHullFceBufExpand(wSp, wSp->nHorizon);
-	    }
-	    if(errNum == WLZ_ERR_NONE)
-	    {
-	      /* Create new faces. */
-	      for(f = 0; f < wSp->nFceBuf; ++f)
-	      {
-		wSp->fceBuf[f] = WlzConvHullNewFce(wSp, NULL);
-	      }
-	      /* Link up new faces. The direction of the horizon edges is
-	       * correct for the remaining faces but the opposite of direction
-	       * in the new faces. */
-	      for(f = 0; f < wSp->nFceBuf; ++f)
-	      {
-		WlzConvHullFce *fce;
-		WlzConvHullHorEdg *edg;
-
-		fce = wSp->fceBuf[f];
-		edg = wSp->horizon + f;
-		fce->vtx[0] = edg->fce->vtx[(edg->edg + 1) % 3];
-		fce->vtx[1] = edg->fce->vtx[edg->edg];
-		fce->vtx[2] = vtx->idx;
-		fce->opp[0] = edg->fce;
-		fce->opp[1] = wSp->fceBuf[(f + wSp->nFceBuf - 1) %
-		                          wSp->nFceBuf];
-		fce->opp[2] = wSp->fceBuf[(f + 1) % wSp->nFceBuf];
-		edg->fce->opp[edg->edg] = fce;
-		if((errNum = WlzConvHullFceNrm(wSp, fce)) != WLZ_ERR_NONE)
-		{
-		  break;
-		}
-	      }
-	    }
-	    /* For each of the pending vertices, check for conflicts with
-	     * each of the new faces, delete those inside the new faces and
-	     * add new conflicts. */
-	    if(errNum == WLZ_ERR_NONE)
-	    {
-	      WlzConvHullVtx *pVtx;
-
-	      if((pVtx = wSp->vtxQue) != NULL)
-	      {
-		do
-		{
-		  WlzConvHullVtx *nxtPVtx;
-
-		  nxtPVtx = pVtx->nxt;
-		  for(f = 0; f < wSp->nFceBuf; ++f)
-		  {
-		    WlzConvHullFce *fce;
-
-		    fce = wSp->fceBuf[f];
-		    if(WlzConvHullFceBehind(wSp, fce, pVtx->idx) != 0)
-		    {
-		      errNum = WlzConvHullConfAdd(wSp, fce, pVtx);
-		    }
-		  }
-		  if((pVtx->arc == NULL) && (pVtx->cvx == 0) &&
-		     (pVtx != wSp->vtxQue))
-		  {
-		    WlzConvHullDelVtx(wSp, &(wSp->vtxQue), pVtx);
-		  }
-		  pVtx = nxtPVtx;
-		} while((errNum == WLZ_ERR_NONE) && (pVtx != wSp->vtxQue));
-	      }
-	    }
-#ifdef WLZ_CONVHULL_DEBUG_FCE
-	    if(errNum == WLZ_ERR_NONE)
-	    {
-	      errNum = WlzConvHullChkAll(wSp);
-	    }
-#endif
-	    /* Add new vertex and faces to the convex hull. */
-	    if(errNum == WLZ_ERR_NONE)
-	    {
-	      WlzConHullAddConvexVtx(wSp, vtx);
-	      for(f = 0; f < wSp->nFceBuf; ++f)
-	      {
-		WlzConHullAddConvexFce(wSp, wSp->fceBuf[f]);
-	      }
-	    }
-	  }
-	}
-      }
-      if(errNum == WLZ_ERR_NONE)
-      {
-	/* Make convex hull domain from the convex hull workspace. */
-	cvh = WlzConvexHullFromWSp3(wSp, &errNum);
-      }
-    }
+    cvh = WlzConvexHullQuick3(pType, nPrm, pnt, prm, &errNum);
   }
-  /* Free the workspace. */
-  WlzConvHullFreeWSp3(wSp);
+  AlcFree(prm);
   /* If the vertices were degenerate try mapping to a plane. */
   if(errNum == WLZ_ERR_DEGENERATE)
   {
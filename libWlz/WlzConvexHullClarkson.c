@@ -267,7 +267,7 @@ int		WlzConvHullClarkson2I(WlzIVertex2 *vtx, int n, int **dstIdx,
   		u = 0;
   int		*idx = NULL;
   WlzIVertex2	**v = NULL;
-  WlzIVertex2	*vSmall[WLZ_CONVHULL_CLARKSON_SM_2D];
+  WlzIVertex2	*vSmall[WLZ_CONVHULL_CLARKSON_SM_2D + 1];
   WlzErrorNum	errNum = WLZ_ERR_NONE;
   
   if(n < 1)
@@ -350,7 +350,7 @@ int		WlzConvHullClarkson2D(WlzDVertex2 *vtx, int n, int **dstIdx,
   		u = 0;
   int		*idx = NULL;
   WlzDVertex2	**v = NULL;
-  WlzDVertex2	*vSmall[WLZ_CONVHULL_CLARKSON_SM_2D];
+  WlzDVertex2	*vSmall[WLZ_CONVHULL_CLARKSON_SM_2D + 1];
   WlzErrorNum	errNum = WLZ_ERR_NONE;
   
   if(n < 1)
@@ -526,6 +526,14 @@ static int	WlzConvHullClarksonCmpIL(const void *a, const void *b)
   {
     cmp = 1;
   }
+  else if(((*(WlzIVertex2 **)a)->vtX - (*(WlzIVertex2 **)b)->vtX) < 0)
+  {
+    cmp = -1;
+  }
+  else if(((*(WlzIVertex2 **)b)->vtY - (*(WlzIVertex2 **)a)->vtY) > 0)
+  {
+    cmp = 1;
+  }
   else if(((*(WlzIVertex2 **)b)->vtY - (*(WlzIVertex2 **)a)->vtY) < 0)
   {
     cmp = -1;
@@ -541,6 +549,14 @@ static int	WlzConvHullClarksonCmpDL(const void *a, const void *b)
   {
     cmp = 1;
   }
+  else if(((*(WlzDVertex2 **)a)->vtX - (*(WlzDVertex2 **)b)->vtX) < 0.0)
+  {
+    cmp = -1;
+  }
+  else if(((*(WlzDVertex2 **)b)->vtY - (*(WlzDVertex2 **)a)->vtY) > 0.0)
+  {
+    cmp = 1;
+  }
   else if(((*(WlzDVertex2 **)b)->vtY - (*(WlzDVertex2 **)a)->vtY) < 0.0)
   {
     cmp = -1;
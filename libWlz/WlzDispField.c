@@ -0,0 +1,1888 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzDispField_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         libWlz/WlzDispField.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Displacement field transforms, in which the displacements
+* 		of some other transform are sampled once on a regular
+* 		lattice and then applied to any number of objects using
+* 		bilinear or trilinear interpolation.
+* \ingroup	WlzTransform
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <limits.h>
+#include <Wlz.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*!
+* \def		WLZ_DISPFIELD_INV_TOL
+* \ingroup	WlzTransform
+* \brief	Tolerance (in pixels) for the inversion of a displacement
+* 		field at a destination position.
+*/
+#define WLZ_DISPFIELD_INV_TOL	(1.0e-3)
+
+/*!
+* \def		WLZ_DISPFIELD_INV_ITR
+* \ingroup	WlzTransform
+* \brief	Maximum number of Newton iterations used to invert a
+* 		displacement field at a destination position.
+*/
+#define WLZ_DISPFIELD_INV_ITR	(32)
+
+/*!
+* \struct	_WlzDispFieldAcc
+* \ingroup	WlzTransform
+* \brief	Direct access to the displacement values of a displacement
+* 		field transform, which avoids the overhead of grey value
+* 		workspaces when interpolating the displacements.
+*		Typedef: ::WlzDispFieldAcc.
+*/
+typedef struct _WlzDispFieldAcc
+{
+  int		dim;			/*!< Dimension of the field. */
+  int		tiled;			/*!< Non-zero if the values are
+  					     tiled. */
+  WlzIVertex3	org;			/*!< Lattice origin. */
+  WlzIVertex3	sz;			/*!< Number of lattice positions
+  					     along each axis. */
+  int		tSh;			/*!< Base two log of the tile
+  					     width. */
+  int		tMsk;			/*!< Tile width less one. */
+  size_t	tSz;			/*!< Number of values in each tile. */
+  int		*nIdx;			/*!< Number of tile indices along
+  					     each axis. */
+  unsigned int	*idx[3];		/*!< Tile indices of the displacement
+  					     components. */
+  size_t	nTiles[3];		/*!< Number of tiles of the
+  					     displacement components, tile
+					     indices not less than this
+					     are of tiles which are not
+					     present. */
+  float		*tiles[3];		/*!< Tiles of the displacement
+  					     components. */
+  float		**pln[3];		/*!< Plane values of the displacement
+  					     components when not tiled. */
+} WlzDispFieldAcc;
+
+static void			WlzDispFieldAccFree(
+				  WlzDispFieldAcc *acc);
+static void			WlzDispFieldAccGet(
+				  const WlzDispFieldAcc *acc,
+				  WlzDVertex3 p,
+				  double *d,
+				  double *g);
+static int			WlzDispFieldAccInvert(
+				  const WlzDispFieldAcc *acc,
+				  WlzDVertex3 q,
+				  WlzDVertex3 *p);
+static float			*WlzDispFieldAccPtr(
+				  const WlzDispFieldAcc *acc,
+				  int c,
+				  int x,
+				  int y,
+				  int z);
+static double			WlzDispFieldAccVal(
+				  const WlzDispFieldAcc *acc,
+				  int c,
+				  int x,
+				  int y,
+				  int z);
+static WlzErrorNum		WlzDispFieldAccInit(
+				  WlzDispFieldAcc *acc,
+				  WlzDispFieldTransform *dft);
+static WlzErrorNum		WlzDispFieldDstBox(
+				  WlzDispFieldAcc *acc,
+				  WlzIBox3 sBox,
+				  WlzIBox3 *dBox);
+static WlzGreyV			WlzDispFieldSample(
+				  WlzGreyValueWSpace *gVWSp,
+				  int dim,
+				  WlzInterpolationType interp,
+				  WlzDVertex3 p);
+static void			WlzDispFieldSetGrey(
+				  WlzGreyP gP,
+				  size_t off,
+				  WlzGreyType gType,
+				  WlzGreyV gV);
+static WlzObject		*WlzDispFieldTransformPlane(
+				  WlzDispFieldAcc *acc,
+				  WlzObject *srcObj,
+				  WlzGreyValueWSpace **gVWSp,
+				  WlzInterpolationType interp,
+				  WlzObjectType tabType,
+				  WlzPixelV bgdV,
+				  WlzIBox3 dBox,
+				  int pln,
+				  WlzDVertex3 *posBuf,
+				  WlzUByte *mskBuf,
+				  WlzErrorNum *dstErr);
+static WlzObject		*WlzDispFieldTransformDomObj(
+				  WlzObject *srcObj,
+				  WlzDispFieldTransform *dft,
+				  WlzInterpolationType interp,
+				  WlzErrorNum *dstErr);
+static WlzObject		*WlzDispFieldTransformPoints(
+				  WlzObject *srcObj,
+				  WlzDispFieldTransform *dft,
+				  WlzErrorNum *dstErr);
+
+/*!
+* \return	New displacement field transform or NULL on error.
+* \ingroup	WlzTransform
+* \brief	Makes a new displacement field transform using the
+* 		given displacements. The compound array is assigned to
+* 		the transform and it's components must all be float
+* 		valued 2D (for a 2D transform) or 3D (for a 3D transform)
+* 		domain objects which share the same lattice and have
+* 		either rectangular or tiled value tables. For most uses
+* 		WlzDispFieldFromTransform() will be more convenient.
+* \param	type			Transform type, which must be either
+* 					WLZ_TRANSFORM_2D_DISP or
+* 					WLZ_TRANSFORM_3D_DISP.
+* \param	field			Compound array with one object for
+* 					each displacement component.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzDispFieldTransform *WlzMakeDispFieldTransform(WlzTransformType type,
+				WlzCompoundArray *field,
+				WlzErrorNum *dstErr)
+{
+  WlzDispFieldTransform *dft = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((type != WLZ_TRANSFORM_2D_DISP) && (type != WLZ_TRANSFORM_3D_DISP))
+  {
+    errNum = WLZ_ERR_TRANSFORM_TYPE;
+  }
+  else if(field == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if((dft = (WlzDispFieldTransform *)
+                 AlcCalloc(1, sizeof(WlzDispFieldTransform))) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    WlzDispFieldAcc acc;
+
+    dft->type = type;
+    dft->field = field;
+    errNum = WlzDispFieldAccInit(&acc, dft);
+    WlzDispFieldAccFree(&acc);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      dft->field = (WlzCompoundArray *)
+                   WlzAssignObject((WlzObject *)field, NULL);
+    }
+    else
+    {
+      AlcFree(dft);
+      dft = NULL;
+    }
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(dft);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Frees the given displacement field transform, which is
+* 		only freed when it's link count falls to zero.
+* \param	dft			Given displacement field transform.
+*/
+WlzErrorNum	WlzFreeDispFieldTransform(WlzDispFieldTransform *dft)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(dft != NULL)
+  {
+    if((dft->type != WLZ_TRANSFORM_2D_DISP) &&
+       (dft->type != WLZ_TRANSFORM_3D_DISP))
+    {
+      errNum = WLZ_ERR_TRANSFORM_TYPE;
+    }
+    else if(WlzUnlink(&(dft->linkcount), &errNum))
+    {
+      errNum = WlzFreeObj((WlzObject *)(dft->field));
+      AlcFree(dft);
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	New displacement field transform or NULL on error.
+* \ingroup	WlzTransform
+* \brief	Creates a new displacement field transform by evaluating
+* 		the given transform at every integer position within the
+* 		bounding box of the given reference object. The given
+* 		transform may be any 2D or 3D affine, basis function,
+* 		conforming mesh, displacement field or transform chain
+* 		transform or a 2D mesh transform. Conforming mesh
+* 		transform objects (type WLZ_CMESH_TRANS) are also
+* 		accepted. Positions outside of a 2D mesh transform
+* 		are given zero displacement. The transform is evaluated
+* 		in parallel and, once created, the displacement field
+* 		transform may be applied to any number of objects at the
+* 		cost of interpolating the displacements.
+* \param	tr			Given transform.
+* \param	refObj			Reference object the bounding box of
+* 					which defines the lattice.
+* \param	tileSz			If non-zero the displacements are
+* 					held in tiled values with this
+* 					number of values per tile, see
+* 					WlzMakeTiledValuesFromObj().
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzDispFieldTransform *WlzDispFieldFromTransform(WlzTransform tr,
+				WlzObject *refObj, size_t tileSz,
+				WlzErrorNum *dstErr)
+{
+  int		idC,
+  		dim = 0;
+  WlzIBox3	bBox;
+  WlzObject	*dObj = NULL;
+  WlzObject	*cObj[3] = {NULL};
+  WlzCompoundArray *ca = NULL;
+  WlzCMeshLattice *lat = NULL;
+  WlzDVertex3	*buf = NULL;
+  WlzTransformType type = WLZ_TRANSFORM_EMPTY;
+  WlzTransformChain *chain = NULL;
+  WlzTransformChain trChain;
+  WlzDispFieldTransform *dft = NULL;
+  WlzDispFieldAcc acc;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  (void )memset(&acc, 0, sizeof(WlzDispFieldAcc));
+  if(tr.core == NULL)
+  {
+    errNum = WLZ_ERR_TRANSFORM_NULL;
+  }
+  else if(refObj == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else
+  {
+    type = tr.core->type;
+    if(((WlzObjectType )type == WLZ_CMESH_TRANS) &&
+       (tr.obj->domain.core != NULL))
+    {
+      type = (tr.obj->domain.core->type == WLZ_CMESH_2D)?
+             WLZ_TRANSFORM_2D_CMESH:
+	     (tr.obj->domain.core->type == WLZ_CMESH_3D)?
+	     WLZ_TRANSFORM_3D_CMESH: WLZ_TRANSFORM_EMPTY;
+    }
+    switch(type)
+    {
+      case WLZ_TRANSFORM_2D_AFFINE:  /* FALLTHROUGH */
+      case WLZ_TRANSFORM_2D_REG:     /* FALLTHROUGH */
+      case WLZ_TRANSFORM_2D_TRANS:   /* FALLTHROUGH */
+      case WLZ_TRANSFORM_2D_NOSHEAR: /* FALLTHROUGH */
+      case WLZ_TRANSFORM_2D_BASISFN: /* FALLTHROUGH */
+      case WLZ_TRANSFORM_2D_MESH:    /* FALLTHROUGH */
+      case WLZ_TRANSFORM_2D_CMESH:   /* FALLTHROUGH */
+      case WLZ_TRANSFORM_2D_DISP:    /* FALLTHROUGH */
+      case WLZ_TRANSFORM_2D_CHAIN:
+        dim = 2;
+	break;
+      case WLZ_TRANSFORM_3D_AFFINE:  /* FALLTHROUGH */
+      case WLZ_TRANSFORM_3D_REG:     /* FALLTHROUGH */
+      case WLZ_TRANSFORM_3D_TRANS:   /* FALLTHROUGH */
+      case WLZ_TRANSFORM_3D_NOSHEAR: /* FALLTHROUGH */
+      case WLZ_TRANSFORM_3D_BASISFN: /* FALLTHROUGH */
+      case WLZ_TRANSFORM_3D_CMESH:   /* FALLTHROUGH */
+      case WLZ_TRANSFORM_3D_DISP:    /* FALLTHROUGH */
+      case WLZ_TRANSFORM_3D_CHAIN:
+        dim = 3;
+	break;
+      default:
+        errNum = WLZ_ERR_TRANSFORM_TYPE;
+	break;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    bBox = WlzBoundingBox3I(refObj, &errNum);
+  }
+  /* Make a domain object for the lattice and then the displacement
+   * component objects with float values on this domain. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    WlzPixelV	bgdV;
+
+    bgdV.type = WLZ_GREY_FLOAT;
+    bgdV.v.flv = 0.0f;
+    if(dim == 2)
+    {
+      bBox.zMin = bBox.zMax = 0;
+      dObj = WlzMakeRect(bBox.yMin, bBox.yMax, bBox.xMin, bBox.xMax,
+      			 WLZ_GREY_ERROR, NULL, bgdV, NULL, NULL, &errNum);
+    }
+    else
+    {
+      dObj = WlzMakeCuboid(bBox.zMin, bBox.zMax, bBox.yMin, bBox.yMax,
+      			   bBox.xMin, bBox.xMax, WLZ_GREY_ERROR, bgdV,
+			   NULL, NULL, &errNum);
+    }
+    for(idC = 0; (errNum == WLZ_ERR_NONE) && (idC < dim); ++idC)
+    {
+      if(tileSz > 0)
+      {
+        cObj[idC] = WlzMakeTiledValuesFromObj(dObj, tileSz, 0,
+					      WLZ_GREY_FLOAT, bgdV, &errNum);
+      }
+      else
+      {
+	WlzObjectType tabType;
+
+	tabType = WlzGreyTableType(WLZ_GREY_TAB_RECT, WLZ_GREY_FLOAT, NULL);
+        cObj[idC] = WlzNewObjectValues(dObj, tabType, bgdV, 0, bgdV,
+				       &errNum);
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      ca = WlzMakeCompoundArray(WLZ_COMPOUND_ARR_1, 3, dim, cObj,
+      				dObj->type, &errNum);
+    }
+    if(ca == NULL)
+    {
+      for(idC = 0; idC < dim; ++idC)
+      {
+        (void )WlzFreeObj(cObj[idC]);
+      }
+    }
+    (void )WlzFreeObj(dObj);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    dft = WlzMakeDispFieldTransform((dim == 2)? WLZ_TRANSFORM_2D_DISP:
+    						WLZ_TRANSFORM_3D_DISP,
+				    ca, &errNum);
+    if(dft == NULL)
+    {
+      (void )WlzFreeObj((WlzObject *)ca);
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = WlzDispFieldAccInit(&acc, dft);
+  }
+  /* Any transform other than a chain is evaluated as a single transform
+   * chain which does not own the transform. Conforming mesh transforms
+   * are evaluated using a lattice which is built once for the whole
+   * field. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((type == WLZ_TRANSFORM_2D_CHAIN) || (type == WLZ_TRANSFORM_3D_CHAIN))
+    {
+      chain = tr.chain;
+    }
+    else
+    {
+      if((type == WLZ_TRANSFORM_2D_CMESH) || (type == WLZ_TRANSFORM_3D_CMESH))
+      {
+	lat = WlzCMeshLatticeNew(tr.obj, 0.0, &errNum);
+      }
+      (void )memset(&trChain, 0, sizeof(WlzTransformChain));
+      trChain.type = (dim == 2)? WLZ_TRANSFORM_2D_CHAIN:
+                                 WLZ_TRANSFORM_3D_CHAIN;
+      trChain.nTr = trChain.maxTr = 1;
+      trChain.tr = &tr;
+      trChain.lat = &lat;
+      chain = &trChain;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((buf = (WlzDVertex3 *)AlcMalloc(sizeof(WlzDVertex3) *
+                                       acc.sz.vtX * acc.sz.vtY)) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  /* Evaluate the transform a plane at a time. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idZ,
+    		nPP;
+
+    nPP = acc.sz.vtX * acc.sz.vtY;
+    for(idZ = 0; (errNum == WLZ_ERR_NONE) && (idZ < acc.sz.vtZ); ++idZ)
+    {
+      int	idP;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for(idP = 0; idP < nPP; ++idP)
+      {
+        buf[idP].vtX = acc.org.vtX + (idP % acc.sz.vtX);
+        buf[idP].vtY = acc.org.vtY + (idP / acc.sz.vtX);
+        buf[idP].vtZ = acc.org.vtZ + idZ;
+      }
+      errNum = WlzTransformChainVtxAry(chain, nPP, buf);
+      if(errNum == WLZ_ERR_NONE)
+      {
+	int	idY;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for(idY = 0; idY < acc.sz.vtY; ++idY)
+	{
+	  int	idX;
+	  WlzDVertex3 *vP;
+	  float	*dP[3];
+
+	  vP = buf + (idY * acc.sz.vtX);
+	  dP[0] = WlzDispFieldAccPtr(&acc, 0, 0, idY, idZ);
+	  dP[1] = WlzDispFieldAccPtr(&acc, 1, 0, idY, idZ);
+	  dP[2] = (acc.dim == 3)? WlzDispFieldAccPtr(&acc, 2, 0, idY, idZ):
+	                          NULL;
+	  for(idX = 0; idX < acc.sz.vtX; ++idX)
+	  {
+	    if(acc.tiled)
+	    {
+	      dP[0] = WlzDispFieldAccPtr(&acc, 0, idX, idY, idZ);
+	      dP[1] = WlzDispFieldAccPtr(&acc, 1, idX, idY, idZ);
+	      if(acc.dim == 3)
+	      {
+		dP[2] = WlzDispFieldAccPtr(&acc, 2, idX, idY, idZ);
+	      }
+	    }
+	    /* Positions in tiles which are not present are skipped. */
+	    if(dP[0])
+	    {
+	      *(dP[0]) = (float )(vP[idX].vtX - (acc.org.vtX + idX));
+	    }
+	    if(dP[1])
+	    {
+	      *(dP[1]) = (float )(vP[idX].vtY - (acc.org.vtY + idY));
+	    }
+	    if((acc.dim == 3) && dP[2])
+	    {
+	      *(dP[2]) = (float )(vP[idX].vtZ - (acc.org.vtZ + idZ));
+	    }
+	    if(acc.tiled == 0)
+	    {
+	      ++(dP[0]);
+	      ++(dP[1]);
+	      if(acc.dim == 3)
+	      {
+		++(dP[2]);
+	      }
+	    }
+	  }
+	}
+      }
+    }
+  }
+  AlcFree(buf);
+  WlzDispFieldAccFree(&acc);
+  (void )WlzCMeshLatticeFree(lat);
+  if(errNum != WLZ_ERR_NONE)
+  {
+    (void )WlzFreeDispFieldTransform(dft);
+    dft = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(dft);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Transforms the vertices of the given array in place using
+* 		the given 2D displacement field transform. Displacements
+* 		are bilinearly interpolated within the lattice and
+* 		clamped to it's boundary outside of it.
+* \param	dft			Given 2D displacement field transform.
+* \param	nVtx			Number of vertices in the array.
+* \param	vtx			Array of vertices.
+*/
+WlzErrorNum	WlzDispFieldTransformVtxAry2D(WlzDispFieldTransform *dft,
+					      int nVtx, WlzDVertex2 *vtx)
+{
+  WlzDispFieldAcc acc;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  (void )memset(&acc, 0, sizeof(WlzDispFieldAcc));
+  if(dft == NULL)
+  {
+    errNum = WLZ_ERR_TRANSFORM_NULL;
+  }
+  else if(dft->type != WLZ_TRANSFORM_2D_DISP)
+  {
+    errNum = WLZ_ERR_TRANSFORM_TYPE;
+  }
+  else if((nVtx < 0) || ((nVtx > 0) && (vtx == NULL)))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else if((errNum = WlzDispFieldAccInit(&acc, dft)) == WLZ_ERR_NONE)
+  {
+    int		idN;
+
+#ifdef _OPENMP
+#pragma omp parallel for if(nVtx >= 1024)
+#endif
+    for(idN = 0; idN < nVtx; ++idN)
+    {
+      double	d[3];
+      WlzDVertex3 p;
+
+      p.vtX = vtx[idN].vtX;
+      p.vtY = vtx[idN].vtY;
+      p.vtZ = 0.0;
+      WlzDispFieldAccGet(&acc, p, d, NULL);
+      vtx[idN].vtX += d[0];
+      vtx[idN].vtY += d[1];
+    }
+  }
+  WlzDispFieldAccFree(&acc);
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Transforms the vertices of the given array in place using
+* 		the given 3D displacement field transform. Displacements
+* 		are trilinearly interpolated within the lattice and
+* 		clamped to it's boundary outside of it.
+* \param	dft			Given 3D displacement field transform.
+* \param	nVtx			Number of vertices in the array.
+* \param	vtx			Array of vertices.
+*/
+WlzErrorNum	WlzDispFieldTransformVtxAry3D(WlzDispFieldTransform *dft,
+					      int nVtx, WlzDVertex3 *vtx)
+{
+  WlzDispFieldAcc acc;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  (void )memset(&acc, 0, sizeof(WlzDispFieldAcc));
+  if(dft == NULL)
+  {
+    errNum = WLZ_ERR_TRANSFORM_NULL;
+  }
+  else if(dft->type != WLZ_TRANSFORM_3D_DISP)
+  {
+    errNum = WLZ_ERR_TRANSFORM_TYPE;
+  }
+  else if((nVtx < 0) || ((nVtx > 0) && (vtx == NULL)))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else if((errNum = WlzDispFieldAccInit(&acc, dft)) == WLZ_ERR_NONE)
+  {
+    int		idN;
+
+#ifdef _OPENMP
+#pragma omp parallel for if(nVtx >= 1024)
+#endif
+    for(idN = 0; idN < nVtx; ++idN)
+    {
+      double	d[3];
+
+      WlzDispFieldAccGet(&acc, vtx[idN], d, NULL);
+      vtx[idN].vtX += d[0];
+      vtx[idN].vtY += d[1];
+      vtx[idN].vtZ += d[2];
+    }
+  }
+  WlzDispFieldAccFree(&acc);
+  return(errNum);
+}
+
+/*!
+* \return	Transformed object or NULL on error.
+* \ingroup	WlzTransform
+* \brief	Transforms the given object using the given displacement
+* 		field transform. Domain objects (with or without values)
+* 		are transformed by inverting the displacement field at
+* 		each position within the bounding box of the transformed
+* 		object using Newton's method, with the position being in
+* 		the transformed domain if the inverse is within the
+* 		given object's domain. Grey values are then sampled from
+* 		the given object using the given interpolation. Point
+* 		objects are transformed directly, giving double precision
+* 		points without values.
+* \param	srcObj			Given object, which may be an empty,
+* 					points, 2D domain (for a 2D transform)
+* 					or 3D domain (for a 3D transform)
+* 					object.
+* \param	dft			Given displacement field transform.
+* \param	interp			Interpolation method, which must
+* 					be either WLZ_INTERPOLATION_NEAREST or
+* 					WLZ_INTERPOLATION_LINEAR.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzObject	*WlzDispFieldTransformObj(WlzObject *srcObj,
+				WlzDispFieldTransform *dft,
+				WlzInterpolationType interp,
+				WlzErrorNum *dstErr)
+{
+  WlzObject	*dstObj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(srcObj == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if(dft == NULL)
+  {
+    errNum = WLZ_ERR_TRANSFORM_NULL;
+  }
+  else if((dft->type != WLZ_TRANSFORM_2D_DISP) &&
+          (dft->type != WLZ_TRANSFORM_3D_DISP))
+  {
+    errNum = WLZ_ERR_TRANSFORM_TYPE;
+  }
+  else if((interp != WLZ_INTERPOLATION_NEAREST) &&
+          (interp != WLZ_INTERPOLATION_LINEAR))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else
+  {
+    switch(srcObj->type)
+    {
+      case WLZ_EMPTY_OBJ:
+        dstObj = WlzMakeEmpty(&errNum);
+	break;
+      case WLZ_2D_DOMAINOBJ: /* FALLTHROUGH */
+      case WLZ_3D_DOMAINOBJ:
+        if(srcObj->domain.core == NULL)
+	{
+	  errNum = WLZ_ERR_DOMAIN_NULL;
+	}
+	else if(((srcObj->type == WLZ_2D_DOMAINOBJ) &&
+	         (dft->type != WLZ_TRANSFORM_2D_DISP)) ||
+	        ((srcObj->type == WLZ_3D_DOMAINOBJ) &&
+	         (dft->type != WLZ_TRANSFORM_3D_DISP)))
+	{
+	  errNum = WLZ_ERR_TRANSFORM_TYPE;
+	}
+	else
+	{
+	  dstObj = WlzDispFieldTransformDomObj(srcObj, dft, interp, &errNum);
+	}
+	break;
+      case WLZ_POINTS:
+        if(srcObj->domain.core == NULL)
+	{
+	  errNum = WLZ_ERR_DOMAIN_NULL;
+	}
+	else
+	{
+	  dstObj = WlzDispFieldTransformPoints(srcObj, dft, &errNum);
+	}
+	break;
+      default:
+        errNum = WLZ_ERR_OBJECT_TYPE;
+	break;
+    }
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(dstObj);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Sets up direct access to the displacements of the given
+* 		displacement field transform, checking that the
+* 		displacement components are consistent. The access
+* 		structure should be freed using WlzDispFieldAccFree()
+* 		even when an error is returned.
+* \param	acc			Access structure to set up.
+* \param	dft			Given displacement field transform.
+*/
+static WlzErrorNum WlzDispFieldAccInit(WlzDispFieldAcc *acc,
+				       WlzDispFieldTransform *dft)
+{
+  int		idC;
+  WlzCompoundArray *ca;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  (void )memset(acc, 0, sizeof(WlzDispFieldAcc));
+  acc->dim = (dft->type == WLZ_TRANSFORM_3D_DISP)? 3: 2;
+  if((ca = dft->field) == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if((ca->type != WLZ_COMPOUND_ARR_1) || (ca->n != acc->dim))
+  {
+    errNum = WLZ_ERR_OBJECT_TYPE;
+  }
+  for(idC = 0; (errNum == WLZ_ERR_NONE) && (idC < acc->dim); ++idC)
+  {
+    WlzIVertex3	org,
+    		sz;
+    WlzObject	*obj;
+
+    obj = ca->o[idC];
+    if(obj == NULL)
+    {
+      errNum = WLZ_ERR_OBJECT_NULL;
+    }
+    else if(obj->type != ((acc->dim == 2)? WLZ_2D_DOMAINOBJ:
+    					   WLZ_3D_DOMAINOBJ))
+    {
+      errNum = WLZ_ERR_OBJECT_TYPE;
+    }
+    else if(obj->domain.core == NULL)
+    {
+      errNum = WLZ_ERR_DOMAIN_NULL;
+    }
+    else if(obj->values.core == NULL)
+    {
+      errNum = WLZ_ERR_VALUES_NULL;
+    }
+    else if(WlzGreyTypeFromObj(obj, &errNum) != WLZ_GREY_FLOAT)
+    {
+      if(errNum == WLZ_ERR_NONE)
+      {
+        errNum = WLZ_ERR_GREY_TYPE;
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if(acc->dim == 2)
+      {
+	WlzIntervalDomain *iDom;
+
+	iDom = obj->domain.i;
+	org.vtX = iDom->kol1;
+	org.vtY = iDom->line1;
+	org.vtZ = 0;
+	sz.vtX = iDom->lastkl - iDom->kol1 + 1;
+	sz.vtY = iDom->lastln - iDom->line1 + 1;
+	sz.vtZ = 1;
+      }
+      else
+      {
+	WlzPlaneDomain *pDom;
+
+	pDom = obj->domain.p;
+	org.vtX = pDom->kol1;
+	org.vtY = pDom->line1;
+	org.vtZ = pDom->plane1;
+	sz.vtX = pDom->lastkl - pDom->kol1 + 1;
+	sz.vtY = pDom->lastln - pDom->line1 + 1;
+	sz.vtZ = pDom->lastpl - pDom->plane1 + 1;
+      }
+      if(idC == 0)
+      {
+        acc->org = org;
+	acc->sz = sz;
+	acc->tiled = WlzGreyTableIsTiled(obj->values.core->type) ==
+	             WLZ_GREY_TAB_TILED;
+      }
+      else if((org.vtX != acc->org.vtX) || (org.vtY != acc->org.vtY) ||
+              (org.vtZ != acc->org.vtZ) || (sz.vtX != acc->sz.vtX) ||
+	      (sz.vtY != acc->sz.vtY) || (sz.vtZ != acc->sz.vtZ) ||
+	      (acc->tiled != (WlzGreyTableIsTiled(obj->values.core->type) ==
+	                      WLZ_GREY_TAB_TILED)))
+      {
+        errNum = WLZ_ERR_DOMAIN_DATA;
+      }
+      if((errNum == WLZ_ERR_NONE) &&
+         ((sz.vtX < 1) || (sz.vtY < 1) || (sz.vtZ < 1)))
+      {
+        errNum = WLZ_ERR_DOMAIN_DATA;
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if(acc->tiled)
+      {
+	WlzTiledValues *tv;
+
+	tv = obj->values.t;
+	if((tv->kol1 != org.vtX) || (tv->line1 != org.vtY) ||
+	   ((acc->dim == 3) && (tv->plane1 != org.vtZ)) ||
+	   ((idC > 0) && ((tv->tileSz != acc->tSz) ||
+	                  (tv->tileWidth != (size_t )(acc->tMsk + 1)))))
+	{
+	  errNum = WLZ_ERR_VALUES_DATA;
+	}
+	else if((errNum = WlzTiledValuesDecode(tv)) == WLZ_ERR_NONE)
+	{
+	  acc->tSz = tv->tileSz;
+	  acc->tMsk = (int )(tv->tileWidth) - 1;
+	  acc->tSh = 0;
+	  while(((size_t )1 << acc->tSh) < tv->tileWidth)
+	  {
+	    ++(acc->tSh);
+	  }
+	  acc->nIdx = tv->nIdx;
+	  acc->idx[idC] = tv->indices;
+	  acc->nTiles[idC] = tv->numTiles;
+	  acc->tiles[idC] = tv->tiles.flp;
+	}
+      }
+      else if((acc->pln[idC] = (float **)
+                               AlcMalloc(sizeof(float *) * sz.vtZ)) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      else
+      {
+        int	idZ;
+
+	for(idZ = 0; (errNum == WLZ_ERR_NONE) && (idZ < sz.vtZ); ++idZ)
+	{
+	  WlzValues val;
+
+	  val = (acc->dim == 2)? obj->values: obj->values.vox->values[idZ];
+	  if((val.core == NULL) ||
+	     (WlzGreyTableTypeToTableType(val.core->type, NULL) !=
+	      WLZ_GREY_TAB_RECT))
+	  {
+	    errNum = WLZ_ERR_VALUES_TYPE;
+	  }
+	  else if((val.r->kol1 != org.vtX) || (val.r->line1 != org.vtY) ||
+	          (val.r->width != sz.vtX) ||
+		  (val.r->lastln - val.r->line1 + 1 != sz.vtY))
+	  {
+	    errNum = WLZ_ERR_VALUES_DATA;
+	  }
+	  else
+	  {
+	    acc->pln[idC][idZ] = val.r->values.flp;
+	  }
+	}
+      }
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \ingroup	WlzTransform
+* \brief	Frees storage allocated by WlzDispFieldAccInit().
+* \param	acc			Access structure.
+*/
+static void	WlzDispFieldAccFree(WlzDispFieldAcc *acc)
+{
+  int		idC;
+
+  for(idC = 0; idC < 3; ++idC)
+  {
+    AlcFree(acc->pln[idC]);
+    acc->pln[idC] = NULL;
+  }
+}
+
+/*!
+* \return	Pointer to the displacement value or NULL if the value
+* 		is in a tile which is not present.
+* \ingroup	WlzTransform
+* \brief	Computes a pointer to a displacement value.
+* \param	acc			Access structure.
+* \param	c			Displacement component.
+* \param	x			Column relative to the lattice origin.
+* \param	y			Line relative to the lattice origin.
+* \param	z			Plane relative to the lattice origin.
+*/
+static float	*WlzDispFieldAccPtr(const WlzDispFieldAcc *acc, int c,
+				    int x, int y, int z)
+{
+  float		*p;
+
+  if(acc->tiled)
+  {
+    size_t	t,
+    		o;
+
+    t = (((size_t )(z >> acc->tSh) * acc->nIdx[1] +
+          (size_t )(y >> acc->tSh)) * acc->nIdx[0]) + (x >> acc->tSh);
+    t = acc->idx[c][t];
+    if(t >= acc->nTiles[c])
+    {
+      p = NULL;
+    }
+    else
+    {
+      o = (((((size_t )(z & acc->tMsk)) << acc->tSh) |
+	    (size_t )(y & acc->tMsk)) << acc->tSh) | (size_t )(x & acc->tMsk);
+      p = acc->tiles[c] + (t * acc->tSz) + o;
+    }
+  }
+  else
+  {
+    p = acc->pln[c][z] + ((size_t )y * acc->sz.vtX) + x;
+  }
+  return(p);
+}
+
+/*!
+* \return	Displacement value.
+* \ingroup	WlzTransform
+* \brief	Gets a displacement value, with values in tiles which
+* 		are not present being zero.
+* \param	acc			Access structure.
+* \param	c			Displacement component.
+* \param	x			Column relative to the lattice origin.
+* \param	y			Line relative to the lattice origin.
+* \param	z			Plane relative to the lattice origin.
+*/
+static double	WlzDispFieldAccVal(const WlzDispFieldAcc *acc, int c,
+				   int x, int y, int z)
+{
+  float		*p;
+
+  p = WlzDispFieldAccPtr(acc, c, x, y, z);
+  return((p)? *p: 0.0);
+}
+
+/*!
+* \ingroup	WlzTransform
+* \brief	Interpolates the displacement at the given position and
+* 		optionaly it's gradient. Outside of the lattice the
+* 		displacement is clamped to the lattice boundary and
+* 		the gradient along the clamped axes is zero.
+* \param	acc			Access structure.
+* \param	p			Given position.
+* \param	d			Destination for the three displacement
+* 					components, the z component of a 2D
+* 					field being zero.
+* \param	g			If non-NULL destination for the
+* 					gradient with \f$g_{3c+k} =
+* 					\partial d_c / \partial x_k\f$.
+*/
+static void	WlzDispFieldAccGet(const WlzDispFieldAcc *acc, WlzDVertex3 p,
+				   double *d, double *g)
+{
+  int		idC,
+  		idK;
+  int		i0[3],
+  		i1[3],
+		in[3],
+		sz[3];
+  double	f[3],
+  		r[3];
+
+  r[0] = p.vtX - acc->org.vtX;
+  r[1] = p.vtY - acc->org.vtY;
+  r[2] = p.vtZ - acc->org.vtZ;
+  sz[0] = acc->sz.vtX;
+  sz[1] = acc->sz.vtY;
+  sz[2] = acc->sz.vtZ;
+  for(idK = 0; idK < 3; ++idK)
+  {
+    if((idK >= acc->dim) || (sz[idK] < 2))
+    {
+      i0[idK] = i1[idK] = 0;
+      f[idK] = 0.0;
+      in[idK] = 0;
+    }
+    else
+    {
+      if(r[idK] < 0.0)
+      {
+        i0[idK] = 0;
+	f[idK] = 0.0;
+	in[idK] = 0;
+      }
+      else if(r[idK] > sz[idK] - 1)
+      {
+        i0[idK] = sz[idK] - 2;
+	f[idK] = 1.0;
+	in[idK] = 0;
+      }
+      else
+      {
+        i0[idK] = (int )floor(r[idK]);
+	if(i0[idK] > sz[idK] - 2)
+	{
+	  i0[idK] = sz[idK] - 2;
+	}
+	f[idK] = r[idK] - i0[idK];
+	in[idK] = 1;
+      }
+      i1[idK] = i0[idK] + 1;
+    }
+  }
+  d[2] = 0.0;
+  if(g)
+  {
+    for(idK = 0; idK < 9; ++idK)
+    {
+      g[idK] = 0.0;
+    }
+  }
+  for(idC = 0; idC < acc->dim; ++idC)
+  {
+    double	v000, v100, v010, v110,
+    		c00, c10;
+
+    v000 = WlzDispFieldAccVal(acc, idC, i0[0], i0[1], i0[2]);
+    v100 = WlzDispFieldAccVal(acc, idC, i1[0], i0[1], i0[2]);
+    v010 = WlzDispFieldAccVal(acc, idC, i0[0], i1[1], i0[2]);
+    v110 = WlzDispFieldAccVal(acc, idC, i1[0], i1[1], i0[2]);
+    c00 = v000 + f[0] * (v100 - v000);
+    c10 = v010 + f[0] * (v110 - v010);
+    if(acc->dim == 2)
+    {
+      d[idC] = c00 + f[1] * (c10 - c00);
+      if(g)
+      {
+        g[3 * idC] = in[0] * ((1.0 - f[1]) * (v100 - v000) +
+			      f[1] * (v110 - v010));
+        g[3 * idC + 1] = in[1] * (c10 - c00);
+      }
+    }
+    else
+    {
+      double	v001, v101, v011, v111,
+      		c01, c11, c0, c1;
+
+      v001 = WlzDispFieldAccVal(acc, idC, i0[0], i0[1], i1[2]);
+      v101 = WlzDispFieldAccVal(acc, idC, i1[0], i0[1], i1[2]);
+      v011 = WlzDispFieldAccVal(acc, idC, i0[0], i1[1], i1[2]);
+      v111 = WlzDispFieldAccVal(acc, idC, i1[0], i1[1], i1[2]);
+      c01 = v001 + f[0] * (v101 - v001);
+      c11 = v011 + f[0] * (v111 - v011);
+      c0 = c00 + f[1] * (c10 - c00);
+      c1 = c01 + f[1] * (c11 - c01);
+      d[idC] = c0 + f[2] * (c1 - c0);
+      if(g)
+      {
+        g[3 * idC] = in[0] *
+		     ((1.0 - f[2]) * ((1.0 - f[1]) * (v100 - v000) +
+		                      f[1] * (v110 - v010)) +
+		      f[2] * ((1.0 - f[1]) * (v101 - v001) +
+		              f[1] * (v111 - v011)));
+        g[3 * idC + 1] = in[1] * ((1.0 - f[2]) * (c10 - c00) +
+				  f[2] * (c11 - c01));
+        g[3 * idC + 2] = in[2] * (c1 - c0);
+      }
+    }
+  }
+}
+
+/*!
+* \return	Non-zero if the inverse was found.
+* \ingroup	WlzTransform
+* \brief	Uses Newton's method to find the position \f$\mathbf{p}\f$
+* 		which the displacement field maps to the given position
+* 		\f$\mathbf{q}\f$, ie \f$\mathbf{p} + \mathbf{D}(\mathbf{p})
+* 		= \mathbf{q}\f$.
+* \param	acc			Access structure.
+* \param	q			Given destination position.
+* \param	p			Initial estimate of the inverse which
+* 					is set to the final estimate on
+* 					return.
+*/
+static int	WlzDispFieldAccInvert(const WlzDispFieldAcc *acc,
+				      WlzDVertex3 q, WlzDVertex3 *p)
+{
+  int		itr,
+  		cnv = 0;
+  double	d[3],
+  		g[9];
+  WlzDVertex3	s;
+  const double	eps = 1.0e-6,
+  		tol = WLZ_DISPFIELD_INV_TOL;
+
+  s = *p;
+  for(itr = 0; itr < WLZ_DISPFIELD_INV_ITR; ++itr)
+  {
+    double	det;
+    WlzDVertex3	r;
+
+    WlzDispFieldAccGet(acc, s, d, g);
+    r.vtX = s.vtX + d[0] - q.vtX;
+    r.vtY = s.vtY + d[1] - q.vtY;
+    r.vtZ = s.vtZ + d[2] - q.vtZ;
+    if((fabs(r.vtX) < tol) && (fabs(r.vtY) < tol) && (fabs(r.vtZ) < tol))
+    {
+      cnv = 1;
+      break;
+    }
+    g[0] += 1.0;
+    g[4] += 1.0;
+    if(acc->dim == 2)
+    {
+      det = (g[0] * g[4]) - (g[1] * g[3]);
+      if(fabs(det) < eps)
+      {
+        break;
+      }
+      s.vtX -= ((g[4] * r.vtX) - (g[1] * r.vtY)) / det;
+      s.vtY -= ((g[0] * r.vtY) - (g[3] * r.vtX)) / det;
+    }
+    else
+    {
+      double	c[9];
+
+      g[8] += 1.0;
+      c[0] = (g[4] * g[8]) - (g[5] * g[7]);
+      c[1] = (g[2] * g[7]) - (g[1] * g[8]);
+      c[2] = (g[1] * g[5]) - (g[2] * g[4]);
+      c[3] = (g[5] * g[6]) - (g[3] * g[8]);
+      c[4] = (g[0] * g[8]) - (g[2] * g[6]);
+      c[5] = (g[2] * g[3]) - (g[0] * g[5]);
+      c[6] = (g[3] * g[7]) - (g[4] * g[6]);
+      c[7] = (g[1] * g[6]) - (g[0] * g[7]);
+      c[8] = (g[0] * g[4]) - (g[1] * g[3]);
+      det = (g[0] * c[0]) + (g[1] * c[3]) + (g[2] * c[6]);
+      if(fabs(det) < eps)
+      {
+        break;
+      }
+      s.vtX -= ((c[0] * r.vtX) + (c[1] * r.vtY) + (c[2] * r.vtZ)) / det;
+      s.vtY -= ((c[3] * r.vtX) + (c[4] * r.vtY) + (c[5] * r.vtZ)) / det;
+      s.vtZ -= ((c[6] * r.vtX) + (c[7] * r.vtY) + (c[8] * r.vtZ)) / det;
+    }
+  }
+  *p = s;
+  return(cnv);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Computes the bounding box of the given source box when
+* 		transformed by the displacement field, by displacing
+* 		every integer position within the source box.
+* \param	acc			Access structure.
+* \param	sBox			Given source bounding box.
+* \param	dBox			Destination pointer for the
+* 					transformed bounding box.
+*/
+static WlzErrorNum WlzDispFieldDstBox(WlzDispFieldAcc *acc, WlzIBox3 sBox,
+				      WlzIBox3 *dBox)
+{
+  int		idR,
+  		nLn,
+  		nRow;
+  WlzDBox3	*rBox = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  nLn = sBox.yMax - sBox.yMin + 1;
+  nRow = nLn * (sBox.zMax - sBox.zMin + 1);
+  if((rBox = (WlzDBox3 *)AlcMalloc(sizeof(WlzDBox3) * nRow)) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    WlzDBox3	box;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(idR = 0; idR < nRow; ++idR)
+    {
+      int	idX;
+      double	d[3];
+      WlzDVertex3 p;
+      WlzDBox3	*bP;
+
+      bP = rBox + idR;
+      bP->xMin = bP->yMin = bP->zMin = DBL_MAX;
+      bP->xMax = bP->yMax = bP->zMax = -DBL_MAX;
+      p.vtY = sBox.yMin + (idR % nLn);
+      p.vtZ = sBox.zMin + (idR / nLn);
+      for(idX = sBox.xMin; idX <= sBox.xMax; ++idX)
+      {
+	p.vtX = idX;
+	WlzDispFieldAccGet(acc, p, d, NULL);
+	d[0] += p.vtX;
+	d[1] += p.vtY;
+	d[2] += p.vtZ;
+	if(d[0] < bP->xMin) bP->xMin = d[0];
+	if(d[0] > bP->xMax) bP->xMax = d[0];
+	if(d[1] < bP->yMin) bP->yMin = d[1];
+	if(d[1] > bP->yMax) bP->yMax = d[1];
+	if(d[2] < bP->zMin) bP->zMin = d[2];
+	if(d[2] > bP->zMax) bP->zMax = d[2];
+      }
+    }
+    box = rBox[0];
+    for(idR = 1; idR < nRow; ++idR)
+    {
+      box = WlzBoundingBoxUnion3D(box, rBox[idR]);
+    }
+    dBox->xMin = (int )floor(box.xMin);
+    dBox->yMin = (int )floor(box.yMin);
+    dBox->zMin = (int )floor(box.zMin);
+    dBox->xMax = (int )ceil(box.xMax);
+    dBox->yMax = (int )ceil(box.yMax);
+    dBox->zMax = (int )ceil(box.zMax);
+    if(acc->dim == 2)
+    {
+      dBox->zMin = dBox->zMax = 0;
+    }
+  }
+  AlcFree(rBox);
+  return(errNum);
+}
+
+/*!
+* \return	Sampled grey value.
+* \ingroup	WlzTransform
+* \brief	Samples the grey value of the workspace's object at the
+* 		given position.
+* \param	gVWSp			Grey value workspace.
+* \param	dim			Dimension of the object.
+* \param	interp			Interpolation method.
+* \param	p			Given position.
+*/
+static WlzGreyV	WlzDispFieldSample(WlzGreyValueWSpace *gVWSp, int dim,
+				   WlzInterpolationType interp,
+				   WlzDVertex3 p)
+{
+  WlzGreyV	gV;
+
+  if(interp == WLZ_INTERPOLATION_NEAREST)
+  {
+    WlzGreyValueGet(gVWSp, p.vtZ, p.vtY, p.vtX);
+    gV = gVWSp->gVal[0];
+  }
+  else
+  {
+    int		idN,
+    		nN;
+    double	t,
+    		w[8],
+		s[4] = {0.0};
+    WlzDVertex3	f;
+
+    WlzGreyValueGetCon(gVWSp, p.vtZ, p.vtY, p.vtX);
+    f.vtX = p.vtX - WLZ_NINT(p.vtX - 0.5);
+    f.vtY = p.vtY - WLZ_NINT(p.vtY - 0.5);
+    f.vtZ = (dim == 3)? p.vtZ - WLZ_NINT(p.vtZ - 0.5): 0.0;
+    nN = (dim == 3)? 8: 4;
+    for(idN = 0; idN < nN; ++idN)
+    {
+      w[idN] = ((idN & 1)? f.vtX: 1.0 - f.vtX) *
+               ((idN & 2)? f.vtY: 1.0 - f.vtY) *
+               ((idN & 4)? f.vtZ: 1.0 - f.vtZ);
+    }
+    switch(gVWSp->gType)
+    {
+      case WLZ_GREY_INT:
+	for(idN = 0; idN < nN; ++idN)
+	{
+	  s[0] += w[idN] * gVWSp->gVal[idN].inv;
+	}
+	t = WLZ_CLAMP(s[0], (double )INT_MIN, (double )INT_MAX);
+	gV.inv = WLZ_NINT(t);
+        break;
+      case WLZ_GREY_SHORT:
+	for(idN = 0; idN < nN; ++idN)
+	{
+	  s[0] += w[idN] * gVWSp->gVal[idN].shv;
+	}
+	t = WLZ_CLAMP(s[0], (double )SHRT_MIN, (double )SHRT_MAX);
+	gV.shv = (short )WLZ_NINT(t);
+        break;
+      case WLZ_GREY_UBYTE:
+	for(idN = 0; idN < nN; ++idN)
+	{
+	  s[0] += w[idN] * gVWSp->gVal[idN].ubv;
+	}
+	t = WLZ_CLAMP(s[0], 0.0, 255.0);
+	gV.ubv = (WlzUByte )WLZ_NINT(t);
+        break;
+      case WLZ_GREY_FLOAT:
+	for(idN = 0; idN < nN; ++idN)
+	{
+	  s[0] += w[idN] * gVWSp->gVal[idN].flv;
+	}
+	gV.flv = (float )(s[0]);
+        break;
+      case WLZ_GREY_DOUBLE:
+	for(idN = 0; idN < nN; ++idN)
+	{
+	  s[0] += w[idN] * gVWSp->gVal[idN].dbv;
+	}
+	gV.dbv = s[0];
+        break;
+      case WLZ_GREY_RGBA:
+	for(idN = 0; idN < nN; ++idN)
+	{
+	  WlzUInt u;
+
+	  u = gVWSp->gVal[idN].rgbv;
+	  s[0] += w[idN] * WLZ_RGBA_RED_GET(u);
+	  s[1] += w[idN] * WLZ_RGBA_GREEN_GET(u);
+	  s[2] += w[idN] * WLZ_RGBA_BLUE_GET(u);
+	  s[3] += w[idN] * WLZ_RGBA_ALPHA_GET(u);
+	}
+	WLZ_RGBA_RGBA_SET(gV.rgbv,
+	                  WLZ_NINT(WLZ_CLAMP(s[0], 0.0, 255.0)),
+	                  WLZ_NINT(WLZ_CLAMP(s[1], 0.0, 255.0)),
+	                  WLZ_NINT(WLZ_CLAMP(s[2], 0.0, 255.0)),
+	                  WLZ_NINT(WLZ_CLAMP(s[3], 0.0, 255.0)));
+        break;
+      default:
+        gV = gVWSp->gVal[0];
+        break;
+    }
+  }
+  return(gV);
+}
+
+/*!
+* \ingroup	WlzTransform
+* \brief	Sets a single grey value.
+* \param	gP			Grey pointer.
+* \param	off			Offset from the grey pointer.
+* \param	gType			Grey type.
+* \param	gV			Grey value to set.
+*/
+static void	WlzDispFieldSetGrey(WlzGreyP gP, size_t off,
+				    WlzGreyType gType, WlzGreyV gV)
+{
+  switch(gType)
+  {
+    case WLZ_GREY_INT:
+      gP.inp[off] = gV.inv;
+      break;
+    case WLZ_GREY_SHORT:
+      gP.shp[off] = gV.shv;
+      break;
+    case WLZ_GREY_UBYTE:
+      gP.ubp[off] = gV.ubv;
+      break;
+    case WLZ_GREY_FLOAT:
+      gP.flp[off] = gV.flv;
+      break;
+    case WLZ_GREY_DOUBLE:
+      gP.dbp[off] = gV.dbv;
+      break;
+    case WLZ_GREY_RGBA:
+      gP.rgbp[off] = gV.rgbv;
+      break;
+    default:
+      break;
+  }
+}
+
+/*!
+* \return	New 2D domain object, NULL if the plane is empty or
+* 		on error.
+* \ingroup	WlzTransform
+* \brief	Transforms a single plane (or the only plane of a 2D
+* 		object) within the given destination bounding box. The
+* 		displacement field is inverted at each position in the
+* 		plane with positions for which the inverse is within the
+* 		source domain forming the transformed domain. If grey
+* 		value workspaces are given a rectangular value table
+* 		covering the transformed domain is created and filled
+* 		by sampling the source object.
+* \param	acc			Access structure.
+* \param	srcObj			Source object.
+* \param	gVWSp			Per thread grey value workspaces, NULL
+* 					if there are no values.
+* \param	interp			Interpolation method.
+* \param	tabType			Value table type for the plane.
+* \param	bgdV			Background value.
+* \param	dBox			Destination bounding box.
+* \param	pln			Destination plane.
+* \param	posBuf			Buffer for the inverse positions with
+* 					room for the whole plane.
+* \param	mskBuf			Buffer for the bit mask with room for
+* 					the whole plane.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzDispFieldTransformPlane(WlzDispFieldAcc *acc,
+				WlzObject *srcObj,
+				WlzGreyValueWSpace **gVWSp,
+				WlzInterpolationType interp,
+				WlzObjectType tabType, WlzPixelV bgdV,
+				WlzIBox3 dBox, int pln,
+				WlzDVertex3 *posBuf, WlzUByte *mskBuf,
+				WlzErrorNum *dstErr)
+{
+  int		idY,
+  		nIn = 0,
+		width,
+		height,
+		bWidth;
+  WlzObject	*dObj = NULL;
+  WlzDomain	dom;
+  WlzValues	val;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  dom.core = NULL;
+  val.core = NULL;
+  width = dBox.xMax - dBox.xMin + 1;
+  height = dBox.yMax - dBox.yMin + 1;
+  /* A spare byte on each line as WlzDynItvLnFromBitLn() may look at it. */
+  bWidth = (width + 8) / 8;
+  (void )memset(mskBuf, 0, height * bWidth);
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:nIn)
+#endif
+  for(idY = 0; idY < height; ++idY)
+  {
+    int		idX,
+    		cnv = 0;
+    WlzDVertex3	p,
+    		q;
+    WlzUByte	*msk;
+    WlzDVertex3	*pos;
+
+    msk = mskBuf + (idY * bWidth);
+    pos = posBuf + (idY * width);
+    q.vtY = dBox.yMin + idY;
+    q.vtZ = pln;
+    for(idX = 0; idX < width; ++idX)
+    {
+      q.vtX = dBox.xMin + idX;
+      if(cnv)
+      {
+	/* Start from the inverse of the previous position along the line. */
+        p.vtX += 1.0;
+      }
+      else
+      {
+        double	d[3];
+
+	WlzDispFieldAccGet(acc, q, d, NULL);
+	p.vtX = q.vtX - d[0];
+	p.vtY = q.vtY - d[1];
+	p.vtZ = q.vtZ - d[2];
+      }
+      cnv = WlzDispFieldAccInvert(acc, q, &p);
+      if(cnv && WlzInsideDomain(srcObj, p.vtZ, p.vtY, p.vtX, NULL))
+      {
+        msk[idX >> 3] |= (WlzUByte )(1 << (idX & 7));
+	pos[idX] = p;
+	++nIn;
+      }
+    }
+  }
+  if(nIn > 0)
+  {
+    WlzDynItvPool itvPool;
+
+    itvPool.offset = 0;
+    itvPool.itvBlock = NULL;
+    itvPool.itvsInBlock = 1024 + width;
+    dom.i = WlzMakeIntervalDomain(WLZ_INTERVALDOMAIN_INTVL,
+				  dBox.yMin, dBox.yMax, dBox.xMin, dBox.xMax,
+				  &errNum);
+    for(idY = 0; (errNum == WLZ_ERR_NONE) && (idY < height); ++idY)
+    {
+      errNum = WlzDynItvLnFromBitLn(dom.i, mskBuf + (idY * bWidth),
+				    dBox.yMin + idY, width, &itvPool);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      (void )WlzStandardIntervalDomain(dom.i);
+      dObj = WlzMakeMain(WLZ_2D_DOMAINOBJ, dom, val, NULL, NULL, &errNum);
+    }
+    if(dObj == NULL)
+    {
+      (void )WlzFreeDomain(dom);
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (dObj != NULL) && (gVWSp != NULL))
+  {
+    val.v = WlzNewValueTb(dObj, tabType, bgdV, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      dObj->values = WlzAssignValues(val, NULL);
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (dObj != NULL) && (gVWSp != NULL))
+  {
+    int		nLn;
+    WlzRectValues *rv;
+
+    rv = dObj->values.r;
+    nLn = rv->lastln - rv->line1 + 1;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(idY = 0; idY < nLn; ++idY)
+    {
+      int	idX,
+      		thrId = 0,
+		bY,
+		bX0;
+      size_t	off;
+      WlzUByte	*msk;
+      WlzDVertex3 *pos;
+
+#ifdef _OPENMP
+      thrId = omp_get_thread_num();
+#endif
+      bY = rv->line1 + idY - dBox.yMin;
+      bX0 = rv->kol1 - dBox.xMin;
+      msk = mskBuf + (bY * bWidth);
+      pos = posBuf + (bY * width);
+      off = (size_t )idY * rv->width;
+      for(idX = 0; idX < rv->width; ++idX)
+      {
+        int	bX;
+	WlzGreyV gV;
+
+	bX = bX0 + idX;
+	if(msk[bX >> 3] & (1 << (bX & 7)))
+	{
+	  gV = WlzDispFieldSample(gVWSp[thrId], acc->dim, interp, pos[bX]);
+	}
+	else
+	{
+	  gV = bgdV.v;
+	}
+	WlzDispFieldSetGrey(rv->values, off + idX, bgdV.type, gV);
+      }
+    }
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    (void )WlzFreeObj(dObj);
+    dObj = NULL;
+  }
+  *dstErr = errNum;
+  return(dObj);
+}
+
+/*!
+* \return	Transformed object or NULL on error.
+* \ingroup	WlzTransform
+* \brief	Transforms a 2D or 3D domain object, with or without
+* 		values, using the given displacement field transform.
+* \param	srcObj			Given domain object.
+* \param	dft			Given displacement field transform.
+* \param	interp			Interpolation method.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzDispFieldTransformDomObj(WlzObject *srcObj,
+				WlzDispFieldTransform *dft,
+				WlzInterpolationType interp,
+				WlzErrorNum *dstErr)
+{
+  int		idT,
+  		nThr = 1;
+  size_t	nPP = 0;
+  WlzIBox3	sBox,
+  		dBox;
+  WlzPixelV	bgdV;
+  WlzObjectType	tabType = WLZ_NULL;
+  WlzUByte	*mskBuf = NULL;
+  WlzDVertex3	*posBuf = NULL;
+  WlzGreyValueWSpace **gVWSp = NULL;
+  WlzObject	*dstObj = NULL;
+  WlzDispFieldAcc acc;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  bgdV.type = WLZ_GREY_ERROR;
+  bgdV.v.inv = 0;
+  errNum = WlzDispFieldAccInit(&acc, dft);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    sBox = WlzBoundingBox3I(srcObj, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(srcObj->type == WLZ_2D_DOMAINOBJ)
+    {
+      sBox.zMin = sBox.zMax = 0;
+    }
+    errNum = WlzDispFieldDstBox(&acc, sBox, &dBox);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    nPP = (size_t )(dBox.xMax - dBox.xMin + 1) * (dBox.yMax - dBox.yMin + 1);
+    if(((posBuf = (WlzDVertex3 *)
+                  AlcMalloc(sizeof(WlzDVertex3) * nPP)) == NULL) ||
+       ((mskBuf = (WlzUByte *)
+                  AlcMalloc(sizeof(WlzUByte) *
+		            (((dBox.xMax - dBox.xMin + 1) + 8) / 8) *
+			    (dBox.yMax - dBox.yMin + 1))) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  /* Create grey value workspaces for each thread. */
+  if((errNum == WLZ_ERR_NONE) && (srcObj->values.core != NULL))
+  {
+    WlzGreyType	gType;
+
+#ifdef _OPENMP
+    nThr = omp_get_max_threads();
+#endif
+    gType = WlzGreyTypeFromObj(srcObj, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      bgdV = WlzGetBackground(srcObj, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = WlzValueConvertPixel(&bgdV, bgdV, gType);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      tabType = WlzGreyTableType(WLZ_GREY_TAB_RECT, gType, &errNum);
+    }
+    if((errNum == WLZ_ERR_NONE) &&
+       ((gVWSp = (WlzGreyValueWSpace **)
+                 AlcCalloc(nThr, sizeof(WlzGreyValueWSpace *))) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    for(idT = 0; (errNum == WLZ_ERR_NONE) && (idT < nThr); ++idT)
+    {
+      gVWSp[idT] = WlzGreyValueMakeWSp(srcObj, &errNum);
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(srcObj->type == WLZ_2D_DOMAINOBJ)
+    {
+      dstObj = WlzDispFieldTransformPlane(&acc, srcObj, gVWSp, interp,
+      				tabType, bgdV, dBox, 0, posBuf, mskBuf,
+				&errNum);
+      if((errNum == WLZ_ERR_NONE) && (dstObj == NULL))
+      {
+        dstObj = WlzMakeEmpty(&errNum);
+      }
+    }
+    else
+    {
+      int	idZ,
+      		nPln = 0;
+      WlzDomain	dom;
+      WlzValues	val;
+
+      dom.core = NULL;
+      val.core = NULL;
+      dom.p = WlzMakePlaneDomain(WLZ_PLANEDOMAIN_DOMAIN,
+      				 dBox.zMin, dBox.zMax,
+				 dBox.yMin, dBox.yMax,
+				 dBox.xMin, dBox.xMax, &errNum);
+      if((errNum == WLZ_ERR_NONE) && (gVWSp != NULL))
+      {
+        val.vox = WlzMakeVoxelValueTb(WLZ_VOXELVALUETABLE_GREY,
+				      dBox.zMin, dBox.zMax, bgdV, NULL,
+				      &errNum);
+      }
+      for(idZ = dBox.zMin; (errNum == WLZ_ERR_NONE) && (idZ <= dBox.zMax);
+          ++idZ)
+      {
+        WlzObject *pObj;
+
+	pObj = WlzDispFieldTransformPlane(&acc, srcObj, gVWSp, interp,
+					  tabType, bgdV, dBox, idZ,
+					  posBuf, mskBuf, &errNum);
+        if(pObj != NULL)
+	{
+	  dom.p->domains[idZ - dBox.zMin] =
+	      WlzAssignDomain(pObj->domain, NULL);
+	  if(val.core != NULL)
+	  {
+	    val.vox->values[idZ - dBox.zMin] =
+	        WlzAssignValues(pObj->values, NULL);
+	  }
+	  (void )WlzFreeObj(pObj);
+	  ++nPln;
+	}
+      }
+      if((errNum == WLZ_ERR_NONE) && (nPln == 0))
+      {
+	dstObj = WlzMakeEmpty(&errNum);
+      }
+      else if(errNum == WLZ_ERR_NONE)
+      {
+	errNum = WlzStandardPlaneDomain(dom.p, val.vox);
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  dom.p->voxel_size[0] = srcObj->domain.p->voxel_size[0];
+	  dom.p->voxel_size[1] = srcObj->domain.p->voxel_size[1];
+	  dom.p->voxel_size[2] = srcObj->domain.p->voxel_size[2];
+	  dstObj = WlzMakeMain(WLZ_3D_DOMAINOBJ, dom, val, NULL, NULL,
+			       &errNum);
+	}
+      }
+      if(dstObj == NULL)
+      {
+	(void )WlzFreeDomain(dom);
+	(void )WlzFreeValues(val);
+      }
+      else if(dstObj->type == WLZ_EMPTY_OBJ)
+      {
+	(void )WlzFreeDomain(dom);
+	(void )WlzFreeValues(val);
+      }
+    }
+  }
+  if(gVWSp)
+  {
+    for(idT = 0; idT < nThr; ++idT)
+    {
+      WlzGreyValueFreeWSp(gVWSp[idT]);
+    }
+    AlcFree(gVWSp);
+  }
+  AlcFree(posBuf);
+  AlcFree(mskBuf);
+  WlzDispFieldAccFree(&acc);
+  *dstErr = errNum;
+  return(dstObj);
+}
+
+/*!
+* \return	Transformed points object or NULL on error.
+* \ingroup	WlzTransform
+* \brief	Transforms the points of a points object using the given
+* 		displacement field transform. The transformed points
+* 		have double precision and no values.
+* \param	srcObj			Given points object.
+* \param	dft			Given displacement field transform.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzDispFieldTransformPoints(WlzObject *srcObj,
+				WlzDispFieldTransform *dft,
+				WlzErrorNum *dstErr)
+{
+  int		idN,
+  		nPts;
+  WlzPoints	*sPts;
+  WlzDomain	dom;
+  WlzValues	val;
+  WlzVertexP	nullP;
+  WlzObject	*dstObj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  dom.core = NULL;
+  val.core = NULL;
+  nullP.v = NULL;
+  sPts = srcObj->domain.pts;
+  nPts = sPts->nPoints;
+  switch(sPts->type)
+  {
+    case WLZ_POINTS_2I: /* FALLTHROUGH */
+    case WLZ_POINTS_2D:
+      if(dft->type != WLZ_TRANSFORM_2D_DISP)
+      {
+        errNum = WLZ_ERR_TRANSFORM_TYPE;
+      }
+      else if((dom.pts = WlzMakePoints(WLZ_POINTS_2D, 0, nullP, nPts,
+                                       &errNum)) != NULL)
+      {
+	WlzDVertex2 *v;
+
+	v = dom.pts->points.d2;
+	for(idN = 0; idN < nPts; ++idN)
+	{
+	  if(sPts->type == WLZ_POINTS_2I)
+	  {
+	    v[idN].vtX = sPts->points.i2[idN].vtX;
+	    v[idN].vtY = sPts->points.i2[idN].vtY;
+	  }
+	  else
+	  {
+	    v[idN] = sPts->points.d2[idN];
+	  }
+	}
+	dom.pts->nPoints = nPts;
+	errNum = WlzDispFieldTransformVtxAry2D(dft, nPts, v);
+      }
+      break;
+    case WLZ_POINTS_3I: /* FALLTHROUGH */
+    case WLZ_POINTS_3D:
+      if(dft->type != WLZ_TRANSFORM_3D_DISP)
+      {
+        errNum = WLZ_ERR_TRANSFORM_TYPE;
+      }
+      else if((dom.pts = WlzMakePoints(WLZ_POINTS_3D, 0, nullP, nPts,
+                                       &errNum)) != NULL)
+      {
+	WlzDVertex3 *v;
+
+	v = dom.pts->points.d3;
+	for(idN = 0; idN < nPts; ++idN)
+	{
+	  if(sPts->type == WLZ_POINTS_3I)
+	  {
+	    v[idN].vtX = sPts->points.i3[idN].vtX;
+	    v[idN].vtY = sPts->points.i3[idN].vtY;
+	    v[idN].vtZ = sPts->points.i3[idN].vtZ;
+	  }
+	  else
+	  {
+	    v[idN] = sPts->points.d3[idN];
+	  }
+	}
+	dom.pts->nPoints = nPts;
+	errNum = WlzDispFieldTransformVtxAry3D(dft, nPts, v);
+      }
+      break;
+    default:
+      errNum = WLZ_ERR_DOMAIN_TYPE;
+      break;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    dstObj = WlzMakeMain(WLZ_POINTS, dom, val, NULL, NULL, &errNum);
+  }
+  if(dstObj == NULL)
+  {
+    (void )WlzFreeDomain(dom);
+  }
+  *dstErr = errNum;
+  return(dstObj);
+}
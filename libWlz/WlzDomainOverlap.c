@@ -0,0 +1,1122 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzDomainOverlap_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         libWlz/WlzDomainOverlap.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Computation of the pairwise overlap (intersection area or
+* 		volume) and adjacency of all the domains of large sets
+* 		of domains.
+* \ingroup	WlzDomainOps
+*
+* Rather than intersecting each pair of domains, each plane is swept
+* once, line by line. For each line the intervals of those domains
+* which include the line are gathered, sorted by their left column and
+* then swept while keeping a set of active intervals for each of the two
+* sets of domains. Each pair of overlapping intervals is found exactly
+* once and only domains which share a line are ever compared. Planes
+* are swept in parallel and the result is a sparse matrix.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <Wlz.h>
+
+/*!
+* \struct	_WlzDomOvlpItv
+* \ingroup	WlzDomainOps
+* \brief	An interval with absolute columns and the index of the
+* 		domain it belongs to.
+*/
+typedef struct _WlzDomOvlpItv
+{
+  int		lft;		/*!< Left (first) column of the interval. */
+  int		rgt;		/*!< Right (last) column of the interval. */
+  int		id;		/*!< Index of the domain. */
+} WlzDomOvlpItv;
+
+/*!
+* \struct	_WlzDomOvlpCnd
+* \ingroup	WlzDomainOps
+* \brief	A candidate domain within a single plane.
+*/
+typedef struct _WlzDomOvlpCnd
+{
+  int		id;		/*!< Index of the domain. */
+  WlzIntervalDomain *iDom;	/*!< Interval domain of the plane. */
+} WlzDomOvlpCnd;
+
+/*!
+* \struct	_WlzDomOvlpSet
+* \ingroup	WlzDomainOps
+* \brief	Workspace for one of the two sets of domains while a
+* 		plane is swept.
+*/
+typedef struct _WlzDomOvlpSet
+{
+  int		nCnd;		/*!< Number of candidate domains. */
+  int		nxtCnd;		/*!< Next candidate to become active. */
+  int		nAct;		/*!< Number of active candidates. */
+  int		nItv;		/*!< Number of intervals in the line. */
+  int		maxItv;		/*!< Space allocated for intervals. */
+  int		nActItv;	/*!< Number of active intervals. */
+  WlzDomOvlpCnd	*cnd;		/*!< Candidate domains sorted by first
+  				     line. */
+  int		*act;		/*!< Indices of the active candidates. */
+  WlzDomOvlpItv	*itv;		/*!< Intervals of the current line. */
+  WlzDomOvlpItv	**actItv;	/*!< Active intervals of the sweep. */
+} WlzDomOvlpSet;
+
+static int			WlzDomOvlpItvCmp(
+				  const void *p0,
+				  const void *p1);
+static int			WlzDomOvlpCndCmp(
+				  const void *p0,
+				  const void *p1);
+static int			WlzDomOvlpTriCmp(
+				  const void *p0,
+				  const void *p1);
+static size_t			WlzDomOvlpTriCompact(
+				  AlgMatrixTriple *tri,
+				  size_t nTri);
+static WlzIntervalDomain	*WlzDomOvlpPlaneDom(
+				  WlzObject *obj,
+				  int pl);
+static WlzErrorNum		WlzDomOvlpCheck(
+				  int nObj,
+				  WlzObject **objs,
+				  int *dim);
+static WlzErrorNum		WlzDomOvlpSetInit(
+				  WlzDomOvlpSet *set,
+				  int pl,
+				  int nObj,
+				  WlzObject **objs,
+				  char *use);
+static void			WlzDomOvlpSetFree(
+				  WlzDomOvlpSet *set);
+static WlzErrorNum		WlzDomOvlpSetLine(
+				  WlzDomOvlpSet *set,
+				  int ln);
+static WlzErrorNum		WlzDomOvlpAddTri(
+				  AlgMatrixTriple **tri,
+				  size_t *nTri,
+				  size_t *maxTri,
+				  int row,
+				  int col,
+				  int val);
+static WlzErrorNum		WlzDomOvlpSweepLine(
+				  WlzDomOvlpSet *aSet,
+				  WlzDomOvlpSet *bSet,
+				  AlgMatrixTriple **tri,
+				  size_t *nTri,
+				  size_t *maxTri);
+static WlzErrorNum		WlzDomOvlpPlane(
+				  int pl,
+				  int nA,
+				  WlzObject **aObj,
+				  char *aUse,
+				  int nB,
+				  WlzObject **bObj,
+				  char *bUse,
+				  AlgMatrixTriple **dstTri,
+				  size_t *dstNTri);
+
+/*!
+* \return	Sparse matrix of overlaps or NULL on error.
+* \ingroup	WlzDomainOps
+* \brief	Computes the overlap, ie the area or volume of the
+* 		intersection, of each domain of the first set with each
+* 		domain of the second set. The returned matrix has
+* 		\f$n_A\f$ rows and \f$n_B\f$ columns with entry
+* 		\f$(i,j)\f$ the number of pixels or voxels common to
+* 		the domains of \f$A_i\f$ and \f$B_j\f$. Pairs which do
+* 		not overlap have no matrix entry. If the second set is
+* 		the first set then the diagonal entries are the areas
+* 		or volumes of the domains.
+* 		Domains whose bounding box does not intersect any of the
+* 		bounding boxes of the other set are pruned before the
+* 		planes are swept.
+* 		All of the objects must be of the same dimension, ie
+* 		either 2D or 3D domain objects, but may also be empty
+* 		objects.
+* \param	nA			Number of objects in the first set.
+* \param	aObj			First set of objects.
+* \param	nB			Number of objects in the second set.
+* \param	bObj			Second set of objects, if NULL then
+* 					the first set is used.
+* \param	dstErr			Destination error pointer, may
+*                                       be NULL.
+*/
+AlgMatrixCSR	*WlzDomainOverlapMatrix(int nA, WlzObject **aObj,
+					int nB, WlzObject **bObj,
+					WlzErrorNum *dstErr)
+{
+  int		aDim = 0,
+  		bDim = 0;
+  int		nPl = 0;
+  int		zRng[2];
+  size_t	nGTri = 0;
+  size_t	*nPTri = NULL;
+  char		*aUse = NULL,
+  		*bUse = NULL;
+  WlzIBox3	*aBox = NULL,
+  		*bBox = NULL;
+  AlgMatrixTriple *gTri = NULL;
+  AlgMatrixTriple **pTri = NULL;
+  AlgMatrixCSR	*mat = NULL;
+  AlgError	algErr = ALG_ERR_NONE;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(bObj == NULL)
+  {
+    nB = nA;
+    bObj = aObj;
+  }
+  if((nA < 0) || (nB < 0))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else if(((nA > 0) && (aObj == NULL)) || ((nB > 0) && (bObj == NULL)))
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if(((errNum = WlzDomOvlpCheck(nA, aObj, &aDim)) == WLZ_ERR_NONE) &&
+          ((errNum = WlzDomOvlpCheck(nB, bObj, &bDim)) == WLZ_ERR_NONE))
+  {
+    if((aDim != 0) && (bDim != 0) && (aDim != bDim))
+    {
+      errNum = WLZ_ERR_OBJECT_TYPE;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(((aUse = (char *)AlcCalloc(nA + 1, sizeof(char))) == NULL) ||
+       ((bUse = (char *)AlcCalloc(nB + 1, sizeof(char))) == NULL) ||
+       ((aBox = (WlzIBox3 *)
+                AlcMalloc((nA + 1) * sizeof(WlzIBox3))) == NULL) ||
+       ((bBox = (WlzIBox3 *)
+                AlcMalloc((nB + 1) * sizeof(WlzIBox3))) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  /* Compute the bounding boxes of the (non-empty) domains. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idS;
+
+    for(idS = 0; idS < 2; ++idS)
+    {
+      int	idO,
+      		nObj;
+      char	*use;
+      WlzIBox3	*box;
+      WlzObject	**objs;
+
+      nObj = (idS == 0)? nA: nB;
+      objs = (idS == 0)? aObj: bObj;
+      use = (idS == 0)? aUse: bUse;
+      box = (idS == 0)? aBox: bBox;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for(idO = 0; idO < nObj; ++idO)
+      {
+	if(objs[idO]->type != WLZ_EMPTY_OBJ)
+	{
+	  WlzErrorNum errNum2 = WLZ_ERR_NONE;
+
+	  box[idO] = WlzBoundingBox3I(objs[idO], &errNum2);
+	  if(errNum2 == WLZ_ERR_NONE)
+	  {
+	    if(objs[idO]->type == WLZ_2D_DOMAINOBJ)
+	    {
+	      box[idO].zMin = box[idO].zMax = 0;
+	    }
+	    use[idO] = 1;
+	  }
+	  else
+	  {
+#ifdef _OPENMP
+#pragma omp critical (WlzDomainOverlapMatrix)
+#endif
+	    {
+	      errNum = errNum2;
+	    }
+	  }
+	}
+      }
+    }
+  }
+  /* Prune domains whose bounding box does not intersect any bounding box
+   * of the other set. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idS;
+
+    for(idS = 0; idS < 2; ++idS)
+    {
+      int	idO,
+      		nObj,
+		nOth;
+      char	*use,
+      		*oUse;
+      WlzIBox3	*box,
+      		*oBox;
+
+      nObj = (idS == 0)? nA: nB;
+      use = (idS == 0)? aUse: bUse;
+      box = (idS == 0)? aBox: bBox;
+      nOth = (idS == 0)? nB: nA;
+      oUse = (idS == 0)? bUse: aUse;
+      oBox = (idS == 0)? bBox: aBox;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for(idO = 0; idO < nObj; ++idO)
+      {
+	if(use[idO])
+	{
+	  int	idP,
+		  hit = 0;
+
+	  for(idP = 0; (hit == 0) && (idP < nOth); ++idP)
+	  {
+	    hit = (oUse[idP] != 0) &&
+		  (box[idO].xMin <= oBox[idP].xMax) &&
+		  (box[idO].xMax >= oBox[idP].xMin) &&
+		  (box[idO].yMin <= oBox[idP].yMax) &&
+		  (box[idO].yMax >= oBox[idP].yMin) &&
+		  (box[idO].zMin <= oBox[idP].zMax) &&
+		  (box[idO].zMax >= oBox[idP].zMin);
+	  }
+	  /* Mark as pruned only after the other set has been pruned. */
+	  use[idO] = (char )((hit)? 1: 2);
+	}
+      }
+    }
+    for(idS = 0; idS < 2; ++idS)
+    {
+      int	idO,
+      		nObj;
+      char	*use;
+
+      nObj = (idS == 0)? nA: nB;
+      use = (idS == 0)? aUse: bUse;
+      for(idO = 0; idO < nObj; ++idO)
+      {
+        use[idO] = (char )(use[idO] == 1);
+      }
+    }
+  }
+  /* Find the range of planes in which both sets have domains. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idO,
+    		aRng[2],
+		bRng[2];
+
+    aRng[0] = bRng[0] = INT_MAX;
+    aRng[1] = bRng[1] = INT_MIN;
+    for(idO = 0; idO < nA; ++idO)
+    {
+      if(aUse[idO])
+      {
+        aRng[0] = ALG_MIN(aRng[0], aBox[idO].zMin);
+        aRng[1] = ALG_MAX(aRng[1], aBox[idO].zMax);
+      }
+    }
+    for(idO = 0; idO < nB; ++idO)
+    {
+      if(bUse[idO])
+      {
+        bRng[0] = ALG_MIN(bRng[0], bBox[idO].zMin);
+        bRng[1] = ALG_MAX(bRng[1], bBox[idO].zMax);
+      }
+    }
+    zRng[0] = ALG_MAX(aRng[0], bRng[0]);
+    zRng[1] = ALG_MIN(aRng[1], bRng[1]);
+  }
+  /* Sweep the planes in parallel, keeping the overlaps of each plane
+   * in their own buffer. */
+  if((errNum == WLZ_ERR_NONE) && (zRng[0] <= zRng[1]))
+  {
+    nPl = zRng[1] - zRng[0] + 1;
+    if(((nPTri = (size_t *)AlcCalloc(nPl, sizeof(size_t))) == NULL) ||
+       ((pTri = (AlgMatrixTriple **)
+                AlcCalloc(nPl, sizeof(AlgMatrixTriple *))) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (nPl > 0))
+  {
+    int		idP;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(idP = 0; idP < nPl; ++idP)
+    {
+      if(errNum == WLZ_ERR_NONE)
+      {
+	WlzErrorNum errNum2;
+
+	errNum2 = WlzDomOvlpPlane(zRng[0] + idP, nA, aObj, aUse,
+				  nB, bObj, bUse, pTri + idP, nPTri + idP);
+	if(errNum2 != WLZ_ERR_NONE)
+	{
+#ifdef _OPENMP
+#pragma omp critical (WlzDomainOverlapMatrix)
+#endif
+	  {
+	    errNum = errNum2;
+	  }
+	}
+      }
+    }
+  }
+  /* Gather the overlaps of all planes, the matrix is built from these
+   * with the overlaps of pairs in more than one plane being summed. */
+  if((errNum == WLZ_ERR_NONE) && (nPl > 0))
+  {
+    int		idP;
+
+    for(idP = 0; idP < nPl; ++idP)
+    {
+      nGTri += nPTri[idP];
+    }
+    if((gTri = (AlgMatrixTriple *)
+               AlcMalloc((nGTri + 1) * sizeof(AlgMatrixTriple))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      size_t	idT = 0;
+
+      for(idP = 0; idP < nPl; ++idP)
+      {
+	if(nPTri[idP] > 0)
+	{
+	  (void )memcpy(gTri + idT, pTri[idP],
+			nPTri[idP] * sizeof(AlgMatrixTriple));
+	  idT += nPTri[idP];
+	}
+      }
+    }
+  }
+  if(pTri)
+  {
+    int		idP;
+
+    for(idP = 0; idP < nPl; ++idP)
+    {
+      AlcFree(pTri[idP]);
+    }
+    AlcFree(pTri);
+  }
+  AlcFree(nPTri);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    mat = AlgMatrixCSRFromTriples(nA, nB, nGTri, gTri, 0.5, &algErr);
+    errNum = WlzErrorFromAlg(algErr);
+  }
+  AlcFree(aUse);
+  AlcFree(bUse);
+  AlcFree(aBox);
+  AlcFree(bBox);
+  AlcFree(gTri);
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(mat);
+}
+
+/*!
+* \return	Sparse matrix of adjacencies or NULL on error.
+* \ingroup	WlzDomainOps
+* \brief	Computes the adjacency of each pair of domains in the
+* 		given set of domains at the given distance. The returned
+* 		matrix has entry \f$(i,j)\f$ with value
+* 		\f[
+		|D_d(O_i) \cap O_j|
+		\f]
+* 		where \f$D_d(O_i)\f$ is the domain of \f$O_i\f$ dilated
+* 		by a circle or sphere of radius \f$d\f$, or eroded if
+* 		\f$d < 0\f$, as in the WlzDomainAdjacencyMatrix binary.
+* 		If the distance is zero this is just the overlap matrix
+* 		computed by WlzDomainOverlapMatrix(). Each domain is
+* 		dilated (or eroded) once, in parallel, after which the
+* 		overlaps are computed in a single sweep rather than by
+* 		intersecting each pair.
+* \param	nObj			Number of objects.
+* \param	objs			Objects, which must all be either
+* 					2D or 3D domain objects or empty
+* 					objects.
+* \param	dist			Adjacency distance.
+* \param	dstErr			Destination error pointer, may
+*                                       be NULL.
+*/
+AlgMatrixCSR	*WlzDomainAdjacencyMatrix(int nObj, WlzObject **objs,
+					  int dist, WlzErrorNum *dstErr)
+{
+  int		dim = 0;
+  WlzObject	*sObj = NULL;
+  WlzObject	**mObjs = NULL;
+  AlgMatrixCSR	*mat = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(nObj < 0)
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else if((nObj > 0) && (objs == NULL))
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else
+  {
+    errNum = WlzDomOvlpCheck(nObj, objs, &dim);
+  }
+  if((errNum == WLZ_ERR_NONE) && (dist != 0))
+  {
+    if((mObjs = (WlzObject **)
+                AlcCalloc(nObj + 1, sizeof(WlzObject *))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else if(dim == 2)
+    {
+      sObj = WlzMakeCircleObject(abs(dist), 0.0, 0.0, &errNum);
+    }
+    else
+    {
+      sObj = WlzMakeSphereObject(WLZ_3D_DOMAINOBJ, abs(dist),
+				 0.0, 0.0, 0.0, &errNum);
+    }
+    sObj = WlzAssignObject(sObj, NULL);
+  }
+  if((errNum == WLZ_ERR_NONE) && (dist != 0))
+  {
+    int		idO;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(idO = 0; idO < nObj; ++idO)
+    {
+      WlzObject	*mObj = NULL;
+      WlzErrorNum errNum2 = WLZ_ERR_NONE;
+
+      if(objs[idO]->type == WLZ_EMPTY_OBJ)
+      {
+	mObj = WlzMakeEmpty(&errNum2);
+      }
+      else
+      {
+	mObj = (dist > 0)? WlzStructDilation(objs[idO], sObj, &errNum2):
+			   WlzStructErosion(objs[idO], sObj, &errNum2);
+      }
+      if(errNum2 == WLZ_ERR_NONE)
+      {
+	mObjs[idO] = WlzAssignObject(mObj, NULL);
+      }
+      else
+      {
+#ifdef _OPENMP
+#pragma omp critical (WlzDomainAdjacencyMatrix)
+#endif
+	{
+	  errNum = errNum2;
+	}
+      }
+    }
+  }
+  (void )WlzFreeObj(sObj);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    mat = WlzDomainOverlapMatrix(nObj, (mObjs)? mObjs: objs, nObj, objs,
+				 &errNum);
+  }
+  if(mObjs)
+  {
+    int		idO;
+
+    for(idO = 0; idO < nObj; ++idO)
+    {
+      (void )WlzFreeObj(mObjs[idO]);
+    }
+    AlcFree(mObjs);
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(mat);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzDomainOps
+* \brief	Checks the objects of a set and finds their dimension.
+* \param	nObj			Number of objects.
+* \param	objs			Objects.
+* \param	dim			Destination pointer for the
+* 					dimension which is set to zero if
+* 					all objects are empty.
+*/
+static WlzErrorNum WlzDomOvlpCheck(int nObj, WlzObject **objs, int *dim)
+{
+  int		idO;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  *dim = 0;
+  for(idO = 0; (errNum == WLZ_ERR_NONE) && (idO < nObj); ++idO)
+  {
+    int		d = 0;
+
+    if(objs[idO] == NULL)
+    {
+      errNum = WLZ_ERR_OBJECT_NULL;
+    }
+    else
+    {
+      switch(objs[idO]->type)
+      {
+        case WLZ_EMPTY_OBJ:
+	  break;
+	case WLZ_2D_DOMAINOBJ:
+	  d = 2;
+	  break;
+	case WLZ_3D_DOMAINOBJ:
+	  d = 3;
+	  break;
+	default:
+	  errNum = WLZ_ERR_OBJECT_TYPE;
+	  break;
+      }
+      if((errNum == WLZ_ERR_NONE) && (d != 0))
+      {
+	if(objs[idO]->domain.core == NULL)
+	{
+	  errNum = WLZ_ERR_DOMAIN_NULL;
+	}
+	else if((*dim != 0) && (*dim != d))
+	{
+	  errNum = WLZ_ERR_OBJECT_TYPE;
+	}
+	else
+	{
+	  *dim = d;
+	}
+      }
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzDomainOps
+* \brief	Sweeps a single plane, computing the overlaps of the
+* 		domains in the plane. The returned overlaps are sorted
+* 		by row and column with no duplicates.
+* \param	pl			The plane.
+* \param	nA			Number of objects in the first set.
+* \param	aObj			First set of objects.
+* \param	aUse			Non-zero for those objects of the
+* 					first set which were not pruned.
+* \param	nB			Number of objects in the second set.
+* \param	bObj			Second set of objects.
+* \param	bUse			Non-zero for those objects of the
+* 					second set which were not pruned.
+* \param	dstTri			Destination pointer for the overlaps.
+* \param	dstNTri			Destination pointer for the number of
+* 					overlaps.
+*/
+static WlzErrorNum WlzDomOvlpPlane(int pl,
+				   int nA, WlzObject **aObj, char *aUse,
+				   int nB, WlzObject **bObj, char *bUse,
+				   AlgMatrixTriple **dstTri, size_t *dstNTri)
+{
+  int		idC,
+  		ln,
+		ln0 = INT_MAX,
+		ln1 = INT_MIN;
+  size_t	nTri = 0,
+  		maxTri = 0;
+  AlgMatrixTriple *tri = NULL;
+  WlzDomOvlpSet	aSet,
+  		bSet;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(((errNum = WlzDomOvlpSetInit(&aSet, pl, nA, aObj,
+                                  aUse)) == WLZ_ERR_NONE) &&
+     ((errNum = WlzDomOvlpSetInit(&bSet, pl, nB, bObj,
+                                  bUse)) == WLZ_ERR_NONE) &&
+     (aSet.nCnd > 0) && (bSet.nCnd > 0))
+  {
+    for(idC = 0; idC < aSet.nCnd; ++idC)
+    {
+      ln0 = ALG_MIN(ln0, aSet.cnd[idC].iDom->line1);
+      ln1 = ALG_MAX(ln1, aSet.cnd[idC].iDom->lastln);
+    }
+    for(ln = ln0; (errNum == WLZ_ERR_NONE) && (ln <= ln1); ++ln)
+    {
+      if(((errNum = WlzDomOvlpSetLine(&aSet, ln)) == WLZ_ERR_NONE) &&
+         ((errNum = WlzDomOvlpSetLine(&bSet, ln)) == WLZ_ERR_NONE))
+      {
+        errNum = WlzDomOvlpSweepLine(&aSet, &bSet, &tri, &nTri, &maxTri);
+      }
+    }
+  }
+  WlzDomOvlpSetFree(&aSet);
+  WlzDomOvlpSetFree(&bSet);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    nTri = WlzDomOvlpTriCompact(tri, nTri);
+  }
+  else
+  {
+    AlcFree(tri);
+    tri = NULL;
+    nTri = 0;
+  }
+  *dstTri = tri;
+  *dstNTri = nTri;
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzDomainOps
+* \brief	Initialises the workspace of a set of domains for the
+* 		given plane, finding the candidate domains which have
+* 		intervals in the plane. The workspace is always
+* 		initialised so that it may be freed.
+* \param	set			Workspace to initialise.
+* \param	pl			The plane.
+* \param	nObj			Number of objects.
+* \param	objs			Objects.
+* \param	use			Non-zero for those objects which
+* 					were not pruned.
+*/
+static WlzErrorNum WlzDomOvlpSetInit(WlzDomOvlpSet *set, int pl,
+				     int nObj, WlzObject **objs, char *use)
+{
+  int		idO;
+  WlzIntervalDomain *iDom;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  (void )memset(set, 0, sizeof(WlzDomOvlpSet));
+  for(idO = 0; idO < nObj; ++idO)
+  {
+    if(use[idO] && (WlzDomOvlpPlaneDom(objs[idO], pl) != NULL))
+    {
+      ++(set->nCnd);
+    }
+  }
+  if(set->nCnd > 0)
+  {
+    if(((set->cnd = (WlzDomOvlpCnd *)
+                    AlcMalloc(set->nCnd * sizeof(WlzDomOvlpCnd))) == NULL) ||
+       ((set->act = (int *)AlcMalloc(set->nCnd * sizeof(int))) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      set->nCnd = 0;
+      for(idO = 0; idO < nObj; ++idO)
+      {
+	if(use[idO] && ((iDom = WlzDomOvlpPlaneDom(objs[idO], pl)) != NULL))
+	{
+	  set->cnd[set->nCnd].id = idO;
+	  set->cnd[set->nCnd].iDom = iDom;
+	  ++(set->nCnd);
+	}
+      }
+      qsort(set->cnd, set->nCnd, sizeof(WlzDomOvlpCnd), WlzDomOvlpCndCmp);
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \ingroup	WlzDomainOps
+* \brief	Frees the arrays of a set workspace.
+* \param	set			Given set workspace.
+*/
+static void	WlzDomOvlpSetFree(WlzDomOvlpSet *set)
+{
+  AlcFree(set->cnd);
+  AlcFree(set->act);
+  AlcFree(set->itv);
+  AlcFree(set->actItv);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzDomainOps
+* \brief	Advances the workspace of a set of domains to the given
+* 		line, which must be greater than the previous line.
+* 		Candidates are activated and retired using their line
+* 		ranges and then the intervals of the active candidates
+* 		on the line are gathered and sorted by their left column.
+* \param	set			Given set workspace.
+* \param	ln			The line.
+*/
+static WlzErrorNum WlzDomOvlpSetLine(WlzDomOvlpSet *set, int ln)
+{
+  int		idA,
+  		idI,
+		nAct = 0;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  /* Retire candidates which end before the line and activate those
+   * which start on it. */
+  for(idA = 0; idA < set->nAct; ++idA)
+  {
+    if(set->cnd[set->act[idA]].iDom->lastln >= ln)
+    {
+      set->act[nAct++] = set->act[idA];
+    }
+  }
+  while((set->nxtCnd < set->nCnd) &&
+        (set->cnd[set->nxtCnd].iDom->line1 <= ln))
+  {
+    if(set->cnd[set->nxtCnd].iDom->lastln >= ln)
+    {
+      set->act[nAct++] = set->nxtCnd;
+    }
+    ++(set->nxtCnd);
+  }
+  set->nAct = nAct;
+  /* Gather the intervals of the line. */
+  set->nItv = 0;
+  for(idA = 0; (errNum == WLZ_ERR_NONE) && (idA < set->nAct); ++idA)
+  {
+    int		nItv;
+    WlzInterval	rItv,
+    		*itv;
+    WlzDomOvlpCnd *cnd;
+
+    cnd = set->cnd + set->act[idA];
+    if(cnd->iDom->type == WLZ_INTERVALDOMAIN_RECT)
+    {
+      nItv = 1;
+      rItv.ileft = 0;
+      rItv.iright = cnd->iDom->lastkl - cnd->iDom->kol1;
+      itv = &rItv;
+    }
+    else
+    {
+      WlzIntervalLine *iLn;
+
+      iLn = cnd->iDom->intvlines + ln - cnd->iDom->line1;
+      nItv = iLn->nintvs;
+      itv = iLn->intvs;
+    }
+    if(set->nItv + nItv > set->maxItv)
+    {
+      set->maxItv = 2 * (set->nItv + nItv) + 64;
+      if(((set->itv = (WlzDomOvlpItv *)
+                      AlcRealloc(set->itv, set->maxItv *
+		                 sizeof(WlzDomOvlpItv))) == NULL) ||
+         ((set->actItv = (WlzDomOvlpItv **)
+	                 AlcRealloc(set->actItv, set->maxItv *
+			            sizeof(WlzDomOvlpItv *))) == NULL))
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      for(idI = 0; idI < nItv; ++idI)
+      {
+	WlzDomOvlpItv *sItv;
+
+	sItv = set->itv + set->nItv++;
+	sItv->lft = cnd->iDom->kol1 + itv[idI].ileft;
+	sItv->rgt = cnd->iDom->kol1 + itv[idI].iright;
+	sItv->id = cnd->id;
+      }
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (set->nItv > 1))
+  {
+    qsort(set->itv, set->nItv, sizeof(WlzDomOvlpItv), WlzDomOvlpItvCmp);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzDomainOps
+* \brief	Sweeps the sorted intervals of a line of the two sets
+* 		of domains. When an interval of one set is reached the
+* 		expired intervals of the other set's active intervals
+* 		are removed and all remaining active intervals of the
+* 		other set overlap it. Since the active intervals start
+* 		at or before the new interval the overlap starts at the
+* 		new interval's left column.
+* \param	aSet			First set workspace.
+* \param	bSet			Second set workspace.
+* \param	tri			Overlaps, may be reallocated.
+* \param	nTri			Number of overlaps.
+* \param	maxTri			Space allocated for overlaps.
+*/
+static WlzErrorNum WlzDomOvlpSweepLine(WlzDomOvlpSet *aSet,
+				       WlzDomOvlpSet *bSet,
+				       AlgMatrixTriple **tri,
+				       size_t *nTri, size_t *maxTri)
+{
+  int		idA = 0,
+  		idB = 0;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  aSet->nActItv = bSet->nActItv = 0;
+  if((aSet->nItv > 0) && (bSet->nItv > 0))
+  {
+    while((errNum == WLZ_ERR_NONE) &&
+          ((idA < aSet->nItv) || (idB < bSet->nItv)))
+    {
+      int	isA,
+      		idI,
+		nAct = 0;
+      WlzDomOvlpItv *itv;
+      WlzDomOvlpSet *oSet;
+
+      isA = (idB >= bSet->nItv) ||
+            ((idA < aSet->nItv) &&
+	     (aSet->itv[idA].lft <= bSet->itv[idB].lft));
+      if(isA)
+      {
+        itv = aSet->itv + idA++;
+	oSet = bSet;
+      }
+      else
+      {
+        itv = bSet->itv + idB++;
+	oSet = aSet;
+      }
+      for(idI = 0; (errNum == WLZ_ERR_NONE) && (idI < oSet->nActItv); ++idI)
+      {
+	WlzDomOvlpItv *oItv;
+
+	oItv = oSet->actItv[idI];
+	if(oItv->rgt >= itv->lft)
+	{
+	  int	ovl;
+
+	  oSet->actItv[nAct++] = oItv;
+	  ovl = ALG_MIN(itv->rgt, oItv->rgt) - itv->lft + 1;
+	  errNum = (isA)?
+	           WlzDomOvlpAddTri(tri, nTri, maxTri, itv->id, oItv->id, ovl):
+		   WlzDomOvlpAddTri(tri, nTri, maxTri, oItv->id, itv->id, ovl);
+	}
+      }
+      oSet->nActItv = nAct;
+      oSet = (isA)? aSet: bSet;
+      oSet->actItv[oSet->nActItv++] = itv;
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzDomainOps
+* \brief	Appends an overlap to an array of overlaps. When the
+* 		array is full it is first compacted, summing duplicates,
+* 		and is only reallocated if this does not free enough
+* 		space.
+* \param	tri			Overlaps, may be reallocated.
+* \param	nTri			Number of overlaps.
+* \param	maxTri			Space allocated for overlaps.
+* \param	row			Index of domain in the first set.
+* \param	col			Index of domain in the second set.
+* \param	val			Overlap.
+*/
+static WlzErrorNum WlzDomOvlpAddTri(AlgMatrixTriple **tri,
+				    size_t *nTri, size_t *maxTri,
+				    int row, int col, int val)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(*nTri >= *maxTri)
+  {
+    *nTri = WlzDomOvlpTriCompact(*tri, *nTri);
+    if(*nTri >= *maxTri / 2)
+    {
+      *maxTri = (*maxTri == 0)? 1024: 2 * *maxTri;
+      if((*tri = (AlgMatrixTriple *)
+                 AlcRealloc(*tri, *maxTri * sizeof(AlgMatrixTriple))) == NULL)
+      {
+	errNum = WLZ_ERR_MEM_ALLOC;
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    AlgMatrixTriple *t;
+
+    t = *tri + (*nTri)++;
+    t->row = row;
+    t->col = col;
+    t->val = val;
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Number of overlaps after compaction.
+* \ingroup	WlzDomainOps
+* \brief	Sorts the given overlaps by row and column and then
+* 		sums any with the same row and column.
+* \param	tri			Overlaps.
+* \param	nTri			Number of overlaps.
+*/
+static size_t	WlzDomOvlpTriCompact(AlgMatrixTriple *tri, size_t nTri)
+{
+  size_t	idT,
+  		nC = 0;
+
+  if(nTri > 1)
+  {
+    qsort(tri, nTri, sizeof(AlgMatrixTriple), WlzDomOvlpTriCmp);
+    for(idT = 1; idT < nTri; ++idT)
+    {
+      if((tri[idT].row == tri[nC].row) && (tri[idT].col == tri[nC].col))
+      {
+        tri[nC].val += tri[idT].val;
+      }
+      else
+      {
+        tri[++nC] = tri[idT];
+      }
+    }
+    nTri = nC + 1;
+  }
+  return(nTri);
+}
+
+/*!
+* \return	Interval domain of the plane or NULL if the object has
+* 		no intervals in the plane.
+* \ingroup	WlzDomainOps
+* \brief	Gets the interval domain of the given plane of an object.
+* 		2D domain objects are taken to lie on plane zero.
+* \param	obj			Given object.
+* \param	pl			The plane.
+*/
+static WlzIntervalDomain *WlzDomOvlpPlaneDom(WlzObject *obj, int pl)
+{
+  WlzIntervalDomain *iDom = NULL;
+
+  switch(obj->type)
+  {
+    case WLZ_2D_DOMAINOBJ:
+      if(pl == 0)
+      {
+        iDom = obj->domain.i;
+      }
+      break;
+    case WLZ_3D_DOMAINOBJ:
+      if((obj->domain.p->type == WLZ_PLANEDOMAIN_DOMAIN) &&
+         (pl >= obj->domain.p->plane1) && (pl <= obj->domain.p->lastpl))
+      {
+        iDom = obj->domain.p->domains[pl - obj->domain.p->plane1].i;
+      }
+      break;
+    default:
+      break;
+  }
+  if(iDom &&
+     (iDom->type != WLZ_INTERVALDOMAIN_INTVL) &&
+     (iDom->type != WLZ_INTERVALDOMAIN_RECT))
+  {
+    iDom = NULL;
+  }
+  return(iDom);
+}
+
+/*!
+* \return	Sorting value for qsort().
+* \ingroup	WlzDomainOps
+* \brief	Compares intervals by their left column.
+* \param	p0			Pointer to first interval.
+* \param	p1			Pointer to second interval.
+*/
+static int	WlzDomOvlpItvCmp(const void *p0, const void *p1)
+{
+  return(((const WlzDomOvlpItv *)p0)->lft -
+         ((const WlzDomOvlpItv *)p1)->lft);
+}
+
+/*!
+* \return	Sorting value for qsort().
+* \ingroup	WlzDomainOps
+* \brief	Compares candidate domains by their first line.
+* \param	p0			Pointer to first candidate.
+* \param	p1			Pointer to second candidate.
+*/
+static int	WlzDomOvlpCndCmp(const void *p0, const void *p1)
+{
+  return(((const WlzDomOvlpCnd *)p0)->iDom->line1 -
+         ((const WlzDomOvlpCnd *)p1)->iDom->line1);
+}
+
+/*!
+* \return	Sorting value for qsort().
+* \ingroup	WlzDomainOps
+* \brief	Compares overlaps by row and then by column.
+* \param	p0			Pointer to first overlap.
+* \param	p1			Pointer to second overlap.
+*/
+static int	WlzDomOvlpTriCmp(const void *p0, const void *p1)
+{
+  int		cmp;
+  const AlgMatrixTriple *t0,
+  		*t1;
+
+  t0 = (const AlgMatrixTriple *)p0;
+  t1 = (const AlgMatrixTriple *)p1;
+  cmp = (t0->row < t1->row)? -1: (t0->row > t1->row)? 1:
+        (t0->col < t1->col)? -1: (t0->col > t1->col)? 1: 0;
+  return(cmp);
+}
@@ -291,6 +291,13 @@ WlzErrorNum WlzFreeObj(WlzObject *obj)
       errNum = WlzFreeAffineTransform(obj->domain.t);
       break;
 
+    case WLZ_DISP_TRANS:
+      WLZ_DBG((WLZ_DBG_ALLOC|WLZ_DBG_LVL_1),
+      	      ("WlzFreeObj %p WLZ_DISP_TRANS\n",
+	       obj));
+      errNum = WlzFreeDispFieldTransform(obj->domain.df);
+      break;
+
     case WLZ_LUT:
       WLZ_DBG((WLZ_DBG_ALLOC|WLZ_DBG_LVL_1),
               ("WlzFreeObj %p WLZ_LUT\n",
@@ -774,6 +781,7 @@ WlzErrorNum	WlzFreeIndexedValues(WlzIndexedValues *ixv)
   else
   {
     (void )AlcVectorFree(ixv->values);
+    (void )WlzCMeshLatticeCacheFree(ixv->latCache);
     if(ixv->rank > 0)
     {
       AlcFree(ixv->dim);
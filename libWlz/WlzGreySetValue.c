@@ -47,6 +47,9 @@ static char _WlzGreySetValue_c[] = "University of Edinburgh $Id$";
 * \return       Woolz error code.
 * \ingroup      WlzValuesUtils
 * \brief        Set the grey value of every pixel/voxel to the given value.
+* 		The object is partitioned into chunks (see
+* 		WlzIteratePartitionMake()) which are set concurrently.
+* 		Objects with tiled values are supported.
 * \param    	obj				Input object.
 * \param    	val				New grey value.
 */
@@ -54,13 +57,8 @@ WlzErrorNum WlzGreySetValue(
   WlzObject	*obj,
   WlzPixelV	val)
 {
-  WlzIntervalWSpace	iwsp;
-  WlzGreyWSpace		gwsp;
-  WlzGreyP		gptr;
-  WlzPixelV		tmpVal;
-  WlzDomain		*domains;
-  WlzValues		*values;
-  int			i, nplanes;
+  int			idC;
+  WlzIteratePartition	*part = NULL;
   WlzErrorNum		errNum=WLZ_ERR_NONE;
 
   /* check object */
@@ -77,9 +75,6 @@ WlzErrorNum WlzGreySetValue(
       else if( obj->values.core == NULL ){
 	errNum = WLZ_ERR_VALUES_NULL;
       }
-      else if( WlzGreyTableIsTiled(obj->values.core->type) ){
-	errNum = WLZ_ERR_VALUES_TYPE;
-      }
       break;
 
     case WLZ_3D_DOMAINOBJ:
@@ -93,58 +88,11 @@ WlzErrorNum WlzGreySetValue(
       else if( obj->values.core == NULL ){
 	errNum = WLZ_ERR_VALUES_NULL;
       }
-      else if( obj->values.core->type != WLZ_VOXELVALUETABLE_GREY ){
+      else if( (obj->values.core->type != WLZ_VOXELVALUETABLE_GREY) &&
+	       !WlzGreyTableIsTiled(obj->values.core->type) ){
 	errNum = WLZ_ERR_VALUES_TYPE;
       }
-      else {
-	/* set range of each plane if non-empty - indicated by NULL */
-	domains = obj->domain.p->domains;
-	values = obj->values.vox->values;
-	nplanes = obj->domain.p->lastpl - obj->domain.p->plane1 + 1;
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-	for(i = 0; i < nplanes; ++i)
-	{
-	  if(errNum == WLZ_ERR_NONE)
-	  {
-	    WlzDomain    *doms;
-	    WlzValues    *vals;
-	    WlzErrorNum  errNum2D = WLZ_ERR_NONE;
-
-	    doms = domains + i;
-	    vals = values + i;
-	    if(((*doms).core != NULL) && ((*vals).core != NULL))
-	    {
-	      WlzObject *obj2D = NULL;
-
-	      if((obj2D = WlzAssignObject(
-		      WlzMakeMain(WLZ_2D_DOMAINOBJ, *doms, *vals,
-			NULL, NULL,
-			&errNum2D), NULL)) != NULL)
-	      {
-		errNum2D = WlzGreySetValue(obj2D, val);
-	        (void )WlzFreeObj(obj2D);
-	      }
-#ifdef _OPENMP
-	      {
-		if(errNum2D != WLZ_ERR_NONE)
-		{
-#pragma omp critical
-		  {
-		    if(errNum == WLZ_ERR_NONE)
-		    {
-		      errNum = errNum2D;
-		    }
-		  }
-		}
-	      }
-#endif
-	    }
-	  }
-	}
-      }
-      return errNum;
+      break;
 
     case WLZ_TRANS_OBJ:
       return WlzGreySetValue(obj->values.obj, val);
@@ -159,55 +107,90 @@ WlzErrorNum WlzGreySetValue(
   }
 
   if( errNum == WLZ_ERR_NONE ){
-    errNum = WlzInitGreyScan(obj, &iwsp, &gwsp);
+    part = WlzIteratePartitionMake(obj, 0, &errNum);
   }
   if( errNum == WLZ_ERR_NONE ){
-    WlzValueConvertPixel(&tmpVal, val, gwsp.pixeltype);
-    while( (errNum = WlzNextGreyInterval(&iwsp)) == WLZ_ERR_NONE ){
-
-      gptr = gwsp.u_grintptr;
-      switch (gwsp.pixeltype) {
-
-      case WLZ_GREY_INT:
-	for (i=0; i<iwsp.colrmn; i++, gptr.inp++)
-	  *gptr.inp = tmpVal.v.inv;
-	break;
-
-      case WLZ_GREY_SHORT:
-	for (i=0; i<iwsp.colrmn; i++, gptr.shp++)
-	  *gptr.shp = tmpVal.v.shv;
-	break;
-
-      case WLZ_GREY_UBYTE:
-	for (i=0; i<iwsp.colrmn; i++, gptr.ubp++)
-	  *gptr.ubp = tmpVal.v.ubv;
-	break;
-
-      case WLZ_GREY_FLOAT:
-	for (i=0; i<iwsp.colrmn; i++, gptr.flp++)
-	  *gptr.flp = tmpVal.v.flv;
-	break;
-
-      case WLZ_GREY_DOUBLE:
-	for (i=0; i<iwsp.colrmn; i++, gptr.dbp++)
-	  *gptr.dbp = tmpVal.v.dbv;
-	break;
-
-      case WLZ_GREY_RGBA:
-	for (i=0; i<iwsp.colrmn; i++, gptr.rgbp++)
-	  *gptr.rgbp = tmpVal.v.rgbv;
-	break;
-
-      default:
-	errNum = WLZ_ERR_GREY_TYPE;
-	break;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(idC = 0; idC < part->nChunk; ++idC)
+    {
+      if(errNum == WLZ_ERR_NONE)
+      {
+	int			i;
+	WlzGreyP		gptr;
+	WlzPixelV		tmpVal;
+	WlzIterateChunkWSpace	cWSp;
+	WlzErrorNum		errNum2D;
+
+	/* Planes without values are skipped as they always have been. */
+	errNum2D = WlzIterateChunkInit(&cWSp, part, idC, obj->values);
+	if( errNum2D == WLZ_ERR_VALUES_NULL ){
+	  errNum2D = WLZ_ERR_EOO;
+	}
+	else if( errNum2D == WLZ_ERR_NONE ){
+	  WlzValueConvertPixel(&tmpVal, val, cWSp.gWSp.pixeltype);
+	  while( (errNum2D = WlzIterateChunkNext(&cWSp)) == WLZ_ERR_NONE ){
+
+	    gptr = cWSp.gWSp.u_grintptr;
+	    switch (cWSp.gWSp.pixeltype) {
+
+	    case WLZ_GREY_INT:
+	      for (i=0; i<cWSp.iWSp.colrmn; i++, gptr.inp++)
+		*gptr.inp = tmpVal.v.inv;
+	      break;
+
+	    case WLZ_GREY_SHORT:
+	      for (i=0; i<cWSp.iWSp.colrmn; i++, gptr.shp++)
+		*gptr.shp = tmpVal.v.shv;
+	      break;
+
+	    case WLZ_GREY_UBYTE:
+	      for (i=0; i<cWSp.iWSp.colrmn; i++, gptr.ubp++)
+		*gptr.ubp = tmpVal.v.ubv;
+	      break;
+
+	    case WLZ_GREY_FLOAT:
+	      for (i=0; i<cWSp.iWSp.colrmn; i++, gptr.flp++)
+		*gptr.flp = tmpVal.v.flv;
+	      break;
+
+	    case WLZ_GREY_DOUBLE:
+	      for (i=0; i<cWSp.iWSp.colrmn; i++, gptr.dbp++)
+		*gptr.dbp = tmpVal.v.dbv;
+	      break;
+
+	    case WLZ_GREY_RGBA:
+	      for (i=0; i<cWSp.iWSp.colrmn; i++, gptr.rgbp++)
+		*gptr.rgbp = tmpVal.v.rgbv;
+	      break;
+
+	    default:
+	      errNum2D = WLZ_ERR_GREY_TYPE;
+	      break;
+	    }
+	    if( errNum2D != WLZ_ERR_NONE ){
+	      break;
+	    }
+	  }
+	  WlzIterateChunkEnd(&cWSp);
+	}
+	if( errNum2D != WLZ_ERR_EOO ){
+#ifdef _OPENMP
+#pragma omp critical
+	  {
+#endif
+	    if( errNum == WLZ_ERR_NONE ){
+	      errNum = errNum2D;
+	    }
+#ifdef _OPENMP
+	  }
+#endif
+	}
       }
     }
-    (void )WlzEndGreyScan(&iwsp, &gwsp);
-    if( errNum == WLZ_ERR_EOO ){
-      errNum = WLZ_ERR_NONE;
-    }
   }
+  WlzIteratePartitionFree(part);
 
   return errNum;
 }
@@ -1077,6 +1077,7 @@ static void	WlzGreyValueComputeGreyPTiled2D(WlzGreyP *baseGVP,
 	tOff.vtX = rPos.vtX % tVal->tileWidth;
 	tOff.vtY = rPos.vtY % tVal->tileWidth;
 	off = (tOff.vtY * tVal->tileWidth) + tOff.vtX;
+	(void )WlzTiledValuesDecodeTile(tVal, idx);
 	(*baseGVP).v = tVal->tiles.v;
 	*offset = (idx * tVal->tileSz) + off;
       }
@@ -1151,6 +1152,7 @@ static void	WlzGreyValueComputeGreyPTiled3D(WlzGreyP *baseGVP,
 	  tOff.vtZ = rPos.vtZ % tVal->tileWidth;
 	  off = ((tOff.vtZ * tVal->tileWidth + tOff.vtY) * tVal->tileWidth) +
 	        tOff.vtX;
+	  (void )WlzTiledValuesDecodeTile(tVal, idx);
 	  (*baseGVP).v = tVal->tiles.v;
 	  *offset = (idx * tVal->tileSz) + off;
 	}
@@ -1745,6 +1747,8 @@ static void	WlzGreyValueGet3DConTiled(WlzGreyValueWSpace *gVWSp,
             rPos.vtX = kol - tVal->kol1 + idK;
 	    tIdx.vtX = tIdx.vtY + (rPos.vtX / tVal->tileWidth);
             tOff.vtX = tOff.vtY + (rPos.vtX % tVal->tileWidth);
+            (void )WlzTiledValuesDecodeTile(tVal,
+	                                    *(tVal->indices + tIdx.vtX));
             offset = *(tVal->indices + tIdx.vtX) * tVal->tileSz + tOff.vtX;
 	    WlzGreyValueSetGreyP(gVWSp->gVal + idV, gVWSp->gPtr + idV,
 	                         gVWSp->gType, tVal->tiles, offset);
@@ -41,9 +41,15 @@ static char _WlzHistogram_c[] = "University of Edinburgh $Id$";
 */
 
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include <float.h>
 #include <Wlz.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 /*!
 * \return	Woolz error code.
 * \ingroup	WlzHistogram
@@ -170,53 +176,251 @@ static WlzErrorNum WlzHistogramCheckHistObj(WlzObject *histObj)
 }
 
 /*!
-* \return	void
+* \return	Number of parts.
 * \ingroup      WlzHistogram
-* \brief	Adds the bins of the second histogram domain to those
-*               of the first. Both histogram domains are assumed to
-*               be the same except for the bin values.
-*               Because this is a static function the object pointer
-*               doesn't need to be checked.
-* \param	dstHistDom		Destination histogram domain.
-* \param	srcHistDom		Source histogram domain.
+* \brief	Computes the number of parts into which the given 2D or
+* 		3D domain object is split for parallel processing. 3D
+* 		objects are split into their planes and 2D objects into
+* 		bands of lines, one for each thread.
+*               Because this is a static function there's no need to
+*               check the parameters.
+* \param	srcObj			Given 2D or 3D domain object.
+* \param	nThr			Number of threads.
 */
-static void	WlzHistogramAddIntBins(WlzHistogramDomain *dstHistDom,
-				       WlzHistogramDomain *srcHistDom)
+static int	WlzHistogramNParts(WlzObject *srcObj, int nThr)
 {
-  int		tI0;
-  int		*tIP0,
-		*tIP1;
+  int		nPart;
 
-  tIP0 = dstHistDom->binValues.inp;
-  tIP1 = srcHistDom->binValues.inp;
-  tI0 = dstHistDom->maxBins;
-  while(tI0-- > 0)
+  if(srcObj->type == WLZ_3D_DOMAINOBJ)
+  {
+    nPart = srcObj->domain.p->lastpl - srcObj->domain.p->plane1 + 1;
+  }
+  else
   {
-    *tIP0++ += *tIP1++;
+    nPart = srcObj->domain.i->lastln - srcObj->domain.i->line1 + 1;
+    nPart = ALG_MAX(ALG_MIN(nPart, nThr), 1);
+  }
+  return(nPart);
+}
+
+/*!
+* \return	New 2D domain object or NULL if the part is empty or
+* 		on error.
+* \ingroup      WlzHistogram
+* \brief	Makes a 2D domain object for one of the parts of the
+* 		given 2D or 3D domain object found by
+* 		WlzHistogramNParts(). For a 3D object this is a plane
+* 		and for a 2D object a band of lines. The new object shares
+* 		the given object's values so that the values of each part
+* 		may be read or set independently.
+*               Because this is a static function there's no need to
+*               check the parameters.
+* \param	srcObj			Given 2D or 3D domain object.
+* \param	isTiled			Non-zero if the object has tiled
+* 					values.
+* \param	idx			Index of the part.
+* \param	nPart			Number of parts.
+* \param	dstPln			Destination pointer for the plane
+* 					of the part.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzHistogramPartObj(WlzObject *srcObj, int isTiled,
+				      int idx, int nPart, int *dstPln,
+				      WlzErrorNum *dstErr)
+{
+  WlzDomain	dom;
+  WlzValues	val;
+  WlzObject	*obj2D = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  *dstPln = 0;
+  if(srcObj->type == WLZ_3D_DOMAINOBJ)
+  {
+    *dstPln = srcObj->domain.p->plane1 + idx;
+    dom = *(srcObj->domain.p->domains + idx);
+    val = (isTiled)? srcObj->values: *(srcObj->values.vox->values + idx);
+    if(dom.core && val.core &&
+       (dom.core->type != WLZ_EMPTY_DOMAIN) &&
+       (val.core->type != WLZ_EMPTY_OBJ))
+    {
+      obj2D = WlzMakeMain(WLZ_2D_DOMAINOBJ, dom, val, NULL, NULL, &errNum);
+    }
+  }
+  else if(nPart == 1)
+  {
+    obj2D = WlzMakeMain(WLZ_2D_DOMAINOBJ, srcObj->domain, srcObj->values,
+                        NULL, NULL, &errNum);
+  }
+  else
+  {
+    int		nLn;
+    WlzIBox2	box;
+
+    nLn = srcObj->domain.i->lastln - srcObj->domain.i->line1 + 1;
+    box.xMin = srcObj->domain.i->kol1;
+    box.xMax = srcObj->domain.i->lastkl;
+    box.yMin = srcObj->domain.i->line1 + ((nLn * idx) / nPart);
+    box.yMax = srcObj->domain.i->line1 + ((nLn * (idx + 1)) / nPart) - 1;
+    obj2D = WlzClipObjToBox2D(srcObj, box, &errNum);
+    if(obj2D && (obj2D->type != WLZ_2D_DOMAINOBJ))
+    {
+      (void )WlzFreeObj(obj2D);
+      obj2D = NULL;
+    }
+  }
+  *dstErr = errNum;
+  return(obj2D);
+}
+
+/*!
+* \ingroup      WlzHistogram
+* \brief	Adds the grey values of an interval to the given bins.
+* 		The bins have one extra bin (at index nBins) into which
+* 		all values which are outside of the histogram are put,
+* 		this allows the bin index to be selected without a
+* 		branch so that the loops may be vectorised by the
+* 		compiler.
+*               Because this is a static function there's no need to
+*               check the parameters.
+* \param	bin			Bins, with nBins + 1 entries.
+* \param	histDom			Histogram domain.
+* \param	gType			Grey type of the values.
+* \param	gP			Grey values of the interval.
+* \param	cnt			Number of values in the interval.
+*/
+static void	WlzHistogramBinItv(int *bin, WlzHistogramDomain *histDom,
+				   WlzGreyType gType, WlzGreyP gP, int cnt)
+{
+  int		idx,
+  		nBins,
+		originI,
+		unity;
+  double	origin,
+  		binScale;
+
+  nBins = histDom->nBins;
+  origin = histDom->origin;
+  binScale = 1.0 / histDom->binSize;
+  originI = (int )floor(histDom->origin + DBL_EPSILON);
+  unity = (histDom->binSize >= (1.0 - DBL_EPSILON)) &&
+          (histDom->binSize <= (1.0 + DBL_EPSILON)) &&
+	  (fabs(origin - originI) <= DBL_EPSILON);
+  switch(gType)
+  {
+    case WLZ_GREY_INT:
+      if(unity)
+      {
+	for(idx = 0; idx < cnt; ++idx)
+	{
+	  unsigned int b;
+
+	  b = (unsigned int )(gP.inp[idx] - originI);
+	  ++bin[(b < (unsigned int )nBins)? b: nBins];
+	}
+      }
+      else
+      {
+	for(idx = 0; idx < cnt; ++idx)
+	{
+	  double d;
+
+	  d = floor((gP.inp[idx] - origin) * binScale);
+	  ++bin[((d >= 0.0) && (d < nBins))? (int )d: nBins];
+	}
+      }
+      break;
+    case WLZ_GREY_SHORT:
+      if(unity)
+      {
+	for(idx = 0; idx < cnt; ++idx)
+	{
+	  unsigned int b;
+
+	  b = (unsigned int )(gP.shp[idx] - originI);
+	  ++bin[(b < (unsigned int )nBins)? b: nBins];
+	}
+      }
+      else
+      {
+	for(idx = 0; idx < cnt; ++idx)
+	{
+	  double d;
+
+	  d = floor((gP.shp[idx] - origin) * binScale);
+	  ++bin[((d >= 0.0) && (d < nBins))? (int )d: nBins];
+	}
+      }
+      break;
+    case WLZ_GREY_UBYTE:
+      if(unity && (originI == 0) && (nBins == 256))
+      {
+	for(idx = 0; idx < cnt; ++idx)
+	{
+	  ++bin[gP.ubp[idx]];
+	}
+      }
+      else if(unity)
+      {
+	for(idx = 0; idx < cnt; ++idx)
+	{
+	  unsigned int b;
+
+	  b = (unsigned int )(gP.ubp[idx] - originI);
+	  ++bin[(b < (unsigned int )nBins)? b: nBins];
+	}
+      }
+      else
+      {
+	for(idx = 0; idx < cnt; ++idx)
+	{
+	  double d;
+
+	  d = floor((gP.ubp[idx] - origin) * binScale);
+	  ++bin[((d >= 0.0) && (d < nBins))? (int )d: nBins];
+	}
+      }
+      break;
+    case WLZ_GREY_FLOAT:
+      for(idx = 0; idx < cnt; ++idx)
+      {
+	double	d;
+
+	d = floor((gP.flp[idx] - origin) * binScale);
+	++bin[((d >= 0.0) && (d < nBins))? (int )d: nBins];
+      }
+      break;
+    case WLZ_GREY_DOUBLE:
+      for(idx = 0; idx < cnt; ++idx)
+      {
+	double	d;
+
+	d = floor((gP.dbp[idx] - origin) * binScale);
+	++bin[((d >= 0.0) && (d < nBins))? (int )d: nBins];
+      }
+      break;
+    default:
+      break;
   }
 }
 
 /*!
 * \return	Woolz error code.
 * \ingroup      WlzHistogram
-* \brief	Computes the histogram occupancies of the histogram
-*               bins for the given histogram domain and 2D domain
+* \brief	Computes the histogram occupancies of the given bins
+*               for the given histogram domain and 2D domain
 *               object.
 *               Because this is a static function there's no need to
 *               check the parameters.
+* \param	bin			Bins to add to, with one more than
+* 					the number of histogram bins.
 * \param	histDom			Histogram domain.
 * \param	srcObj			Source 2D domain object.
-* \param	pln			Plane for 3D value tables.
+* \param	pln			Plane for 3D tiled value tables.
 */
-static WlzErrorNum WlzHistogramCompute2D(WlzHistogramDomain *histDom,
+static WlzErrorNum WlzHistogramCompute2D(int *bin,
+					 WlzHistogramDomain *histDom,
 					 WlzObject *srcObj, int pln)
 {
-  int		idx,
-  		ivCount,
-		originI,
-		unityBinSize;
-  int		*histBin;
-  WlzGreyP	objPix;
   WlzIntervalWSpace iWSp;
   WlzGreyWSpace	gWSp;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
@@ -224,131 +428,32 @@ static WlzErrorNum WlzHistogramCompute2D(WlzHistogramDomain *histDom,
   WLZ_DBG((WLZ_DBG_LVL_2),
 	  ("WlzHistogramCompute2D FE %p %p %d\n",
 	   histDom, srcObj, pln));
-  originI = (int )floor(histDom->origin + DBL_EPSILON);
-  unityBinSize = (histDom->binSize >= (1.0 - DBL_EPSILON)) &&
-                 (histDom->binSize <= (1.0 + DBL_EPSILON));
-  histBin = histDom->binValues.inp;
   if((errNum = WlzInitGreyScan(srcObj, &iWSp, &gWSp)) == WLZ_ERR_NONE)
   {
-    iWSp.plnpos = pln;
+    if(gWSp.tvb)
+    {
+      iWSp.plnpos = pln;
+    }
     while((errNum = WlzNextGreyInterval(&iWSp)) == WLZ_ERR_NONE)
     {
-      ivCount = iWSp.rgtpos - iWSp.lftpos + 1;
       switch(gWSp.pixeltype)
       {
-	case WLZ_GREY_INT:
-	  objPix.inp = gWSp.u_grintptr.inp;
-	  if(unityBinSize)
-	  {
-	    while(ivCount-- > 0)
-	    {
-	      idx = *(objPix.inp)++ - originI;
-	      if((idx >= 0) && (idx < histDom->nBins))
-	      {
-		++*(histBin + idx);
-	      }
-	    }
-	  }
-	  else
-	  {
-	    while(ivCount-- > 0)
-	    {
-	      idx = (int )floor((*(objPix.inp)++ - histDom->origin) /
-	                        histDom->binSize);
-	      if((idx >= 0) && (idx < histDom->nBins))
-	      {
-		++*(histBin + idx);
-	      }
-	    }
-	  }
-	  break;
-	case WLZ_GREY_SHORT:
-	  objPix.shp = gWSp.u_grintptr.shp;
-	  if(unityBinSize)
-	  {
-	    while(ivCount-- > 0)
-	    {
-	      idx = *(objPix.shp)++ - originI;
-	      if((idx >= 0) && (idx < histDom->nBins))
-	      {
-		++*(histBin + idx);
-	      }
-	    }
-	  }
-	  else
-	  {
-	    while(ivCount-- > 0)
-	    {
-	      idx = (int )floor((*(objPix.shp)++ - histDom->origin) /
-	                        histDom->binSize);
-	      if((idx >= 0) && (idx < histDom->nBins))
-	      {
-		++*(histBin + idx);
-	      }
-	    }
-	  }
-	  break;
-	case WLZ_GREY_UBYTE:
-	  objPix.ubp = gWSp.u_grintptr.ubp;
-	  if(unityBinSize)
-	  {
-	    if((originI == 0) && (histDom->nBins == 256))
-	    {
-	      while(ivCount-- > 0)
-	      {
-		++*(histBin + *(objPix.ubp)++);
-	      }
-	    }
-	    else
-	    {
-	      idx = *(objPix.ubp)++ - originI;
-	      if((idx >= 0) && (idx < histDom->nBins))
-	      {
-		++*(histBin + idx);
-	      }
-	    }
-	  }
-	  else
-	  {
-	    while(ivCount-- > 0)
-	    {
-	      idx = (int )floor((*(objPix.ubp)++ - histDom->origin) /
-	                        histDom->binSize);
-	      if((idx >= 0) && (idx < histDom->nBins))
-	      {
-		++*(histBin + idx);
-	      }
-	    }
-	  }
-	  break;
-	case WLZ_GREY_FLOAT:
-	  objPix.flp = gWSp.u_grintptr.flp;
-	  while(ivCount-- > 0)
-	  {
-	    idx = (int )floor((*(objPix.flp)++ - histDom->origin) /
-	    		      histDom->binSize);
-	    if((idx >= 0) && (idx < histDom->nBins))
-	    {
-	      ++*(histBin + idx);
-	    }
-	  }
-	  break;
+	case WLZ_GREY_INT:   /* FALLTHROUGH */
+	case WLZ_GREY_SHORT: /* FALLTHROUGH */
+	case WLZ_GREY_UBYTE: /* FALLTHROUGH */
+	case WLZ_GREY_FLOAT: /* FALLTHROUGH */
 	case WLZ_GREY_DOUBLE:
-	  objPix.dbp = gWSp.u_grintptr.dbp;
-	  while(ivCount-- > 0)
-	  {
-	    idx = (int )floor((*(objPix.dbp)++ - histDom->origin) / 
-	    		      histDom->binSize);
-	    if((idx >= 0) && (idx < histDom->nBins))
-	    {
-	      ++*(histBin + idx);
-	    }
-	  }
+	  WlzHistogramBinItv(bin, histDom, gWSp.pixeltype, gWSp.u_grintptr,
+	                     iWSp.rgtpos - iWSp.lftpos + 1);
 	  break;
         default:
 	  errNum = WLZ_ERR_GREY_TYPE;
 	  break;
       }
+      if(errNum != WLZ_ERR_NONE)
+      {
+        break;
+      }
     }
     (void )WlzEndGreyScan(&iWSp, &gWSp);
     if(errNum == WLZ_ERR_EOO)		/* Reset error from end of intervals */
@@ -362,6 +467,168 @@ static WlzErrorNum WlzHistogramCompute2D(WlzHistogramDomain *histDom,
   return(errNum);
 }
 
+/*!
+* \return	Woolz error code.
+* \ingroup      WlzHistogram
+* \brief	Computes the histogram occupancies of the bins of the
+* 		given histogram domain for the given 2D or 3D domain
+* 		object. The parts of the object (see WlzHistogramNParts())
+* 		are binned in parallel, each thread having it's own bins
+* 		which are summed once all parts have been binned.
+*               Because this is a static function there's no need to
+*               check the parameters.
+* \param	histDom			Histogram domain.
+* \param	srcObj			Source 2D or 3D domain object.
+* \param	isTiled			Non-zero if the object has tiled
+* 					values.
+*/
+static WlzErrorNum WlzHistogramCompute(WlzHistogramDomain *histDom,
+				       WlzObject *srcObj, int isTiled)
+{
+  int		idT,
+  		nPart,
+  		nThr = 1;
+  int		**thrBin = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+#ifdef _OPENMP
+#pragma omp parallel
+  {
+#pragma omp master
+    {
+      nThr = omp_get_num_threads();
+    }
+  }
+#endif
+  nPart = WlzHistogramNParts(srcObj, nThr);
+  if((thrBin = (int **)AlcCalloc(nThr, sizeof(int *))) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  for(idT = 0; (errNum == WLZ_ERR_NONE) && (idT < nThr); ++idT)
+  {
+    if((thrBin[idT] = (int *)AlcCalloc(histDom->nBins + 1,
+                                       sizeof(int))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idP;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(idP = 0; idP < nPart; ++idP)
+    {
+      if(errNum == WLZ_ERR_NONE)
+      {
+	int	pln,
+		thrId = 0;
+	WlzObject *obj2D;
+	WlzErrorNum errNum2 = WLZ_ERR_NONE;
+
+#ifdef _OPENMP
+	thrId = omp_get_thread_num();
+#endif
+	obj2D = WlzHistogramPartObj(srcObj, isTiled, idP, nPart, &pln,
+				    &errNum2);
+	if(obj2D)
+	{
+	  errNum2 = WlzHistogramCompute2D(thrBin[thrId], histDom, obj2D, pln);
+	  (void )WlzFreeObj(obj2D);
+	}
+	if(errNum2 != WLZ_ERR_NONE)
+	{
+#ifdef _OPENMP
+#pragma omp critical (WlzHistogramCompute)
+#endif
+	  {
+	    errNum = errNum2;
+	  }
+	}
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idB;
+    int		*histBin;
+
+    histBin = histDom->binValues.inp;
+    WlzValueSetInt(histBin, 0, histDom->maxBins);
+    for(idT = 0; idT < nThr; ++idT)
+    {
+      for(idB = 0; idB < histDom->nBins; ++idB)
+      {
+        histBin[idB] += thrBin[idT][idB];
+      }
+    }
+  }
+  if(thrBin)
+  {
+    for(idT = 0; idT < nThr; ++idT)
+    {
+      AlcFree(thrBin[idT]);
+    }
+    AlcFree(thrBin);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	void
+* \ingroup      WlzHistogram
+* \brief	Trims the given histogram domain so that it's first and
+* 		last bins are the first and last bins with non-zero
+* 		occupancy. If all bins are empty then the histogram is
+* 		reduced to the single bin containing zero, if it has
+* 		such a bin, otherwise it's first bin.
+*               The histogram is known to be of type
+*               WLZ_HISTOGRAMDOMAIN_INT with a bin size of 1.0.
+*               Because this is a static function there's no need to
+*               check the parameters.
+* \param	histDom			Histogram domain.
+*/
+static void	WlzHistogramTrim(WlzHistogramDomain *histDom)
+{
+  int		idF,
+  		idL;
+  int		*histBin;
+
+  histBin = histDom->binValues.inp;
+  idF = 0;
+  while((idF < histDom->nBins) && (histBin[idF] == 0))
+  {
+    ++idF;
+  }
+  if(idF >= histDom->nBins)
+  {
+    idF = -(int )floor(histDom->origin);
+    if((idF < 0) || (idF >= histDom->nBins))
+    {
+      idF = 0;
+    }
+    idL = idF;
+  }
+  else
+  {
+    idL = histDom->nBins - 1;
+    while(histBin[idL] == 0)
+    {
+      --idL;
+    }
+  }
+  if(idF > 0)
+  {
+    (void )memmove(histBin, histBin + idF, (idL - idF + 1) * sizeof(int));
+  }
+  histDom->nBins = idL - idF + 1;
+  histDom->origin += idF;
+  WlzValueSetInt(histBin + histDom->nBins, 0,
+                 histDom->maxBins - histDom->nBins);
+}
 
 /*!
 * \return	void
@@ -606,6 +873,12 @@ static double	WlzHistogramMapValuesDitherD(int *mapping, int mapIdx,
 		\endverbatim
 *               Where min(g) and max(g) are the minimum and maximum
 *               grey values in the source object.
+*               The histogram is computed in parallel, by plane for 3D
+*               objects and by bands of lines for 2D objects, using a
+*               set of bins for each thread. For WlzUByte and short grey
+*               values the object is only scanned once, for other grey
+*               types with zero bins requested the range of grey values
+*               is found first.
 * \param	srcObj			Given source object.
 * \param	nBins			Required number of histogram bins.
 * \param	binOrigin		Lowest grey value in first histogram
@@ -618,20 +891,13 @@ WlzObject	*WlzHistogramObj(WlzObject *srcObj, int nBins,
 				 double binOrigin, double binSize,
 				 WlzErrorNum *dstErrNum)
 {
-  int		planeCount,
-  		planeIdx,
-  		nBins0 = 0,
+  int		nBins0 = 0,
 		isTiled = 0;
   double	binOrigin0 = 0.0,
   		binSize0 = 1.0;
   WlzGreyType	greyType;
-  WlzHistogramDomain *histDom,
-  		*histDom2D;
-  WlzObject	*histObj = NULL,
-  		*histObj2D = NULL,
-		*srcObj2D = NULL;
-  WlzDomain	dummyDom;
-  WlzValues	dummyValues;
+  WlzHistogramDomain *histDom;
+  WlzObject	*histObj = NULL;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
   WlzPixelV	greyMinV,
   		greyMaxV;
@@ -639,8 +905,6 @@ WlzObject	*WlzHistogramObj(WlzObject *srcObj, int nBins,
   WLZ_DBG((WLZ_DBG_LVL_1),
 	  ("WlzHistogramObj FE %p %d %g %g %p\n",
 	   srcObj, nBins, binOrigin, binSize, dstErrNum));
-  dummyDom.core = NULL;
-  dummyValues.core = NULL;
   if(nBins < 0)
   {
     errNum = WLZ_ERR_PARAM_DATA;
@@ -660,7 +924,16 @@ WlzObject	*WlzHistogramObj(WlzObject *srcObj, int nBins,
 	  errNum = WLZ_ERR_UNSPECIFIED;
 	}
         break;
-      case WLZ_2D_DOMAINOBJ:
+      case WLZ_TRANS_OBJ:
+	if((errNum = WlzHistogramCheckDomainAndValues(&greyType, &isTiled,
+						      srcObj)) == WLZ_ERR_NONE)
+	{
+	  histObj = WlzHistogramObj(srcObj->values.obj, nBins,
+	  			    binOrigin, binSize, &errNum);
+	}
+	break;
+      case WLZ_2D_DOMAINOBJ: /* FALLTHROUGH */
+      case WLZ_3D_DOMAINOBJ:
 	if((errNum = WlzHistogramCheckDomainAndValues(&greyType, &isTiled,
 						      srcObj)) == WLZ_ERR_NONE)
 	{
@@ -671,25 +944,14 @@ WlzObject	*WlzHistogramObj(WlzObject *srcObj, int nBins,
 	      binOrigin0 = 0.0;
 	      binSize0 = 1.0;
 	      break;
-	    case WLZ_GREY_INT:
 	    case WLZ_GREY_SHORT:
-	    case WLZ_GREY_FLOAT:
-	    case WLZ_GREY_DOUBLE:
 	      if(nBins == 0)
 	      {
-	        if((errNum = WlzGreyRange(srcObj, &greyMinV,
-					  &greyMaxV)) == WLZ_ERR_NONE)
-		{
-		  (void )WlzValueConvertPixel(&greyMinV, greyMinV,
-					      WLZ_GREY_DOUBLE);
-		  (void )WlzValueConvertPixel(&greyMaxV, greyMaxV,
-					      WLZ_GREY_DOUBLE);
-		  nBins = (int )ceil(greyMaxV.v.dbv - greyMinV.v.dbv + 1.0);
-		  binOrigin = greyMinV.v.dbv;
-		  nBins0 = nBins;
-		  binOrigin0 = binOrigin;
-		  binSize0 = binSize;
-		}
+	        /* Bin all short values and then trim the histogram, which
+		 * avoids a pass through the values to find their range. */
+	        nBins0 = USHRT_MAX + 1;
+		binOrigin0 = SHRT_MIN;
+		binSize0 = 1.0;
 	      }
 	      else
 	      {
@@ -698,59 +960,7 @@ WlzObject	*WlzHistogramObj(WlzObject *srcObj, int nBins,
 		binSize0 = binSize;
 	      }
 	      break;
-	    case WLZ_GREY_RGBA: /* RGBA to be done RAB */
-	    default:
-	      errNum = WLZ_ERR_GREY_TYPE;
-	      break;
-	  }
-	}
-	if(errNum == WLZ_ERR_NONE)
-	{
-	  if(((histObj = WlzMakeHistogram(WLZ_HISTOGRAMDOMAIN_INT,
-	  				  nBins0, &errNum)) == NULL) &&
-	      (errNum == WLZ_ERR_NONE))
-	  {
-	    errNum = WLZ_ERR_UNSPECIFIED;
-	  }
-	  else
-	  {
-	    histDom = histObj->domain.hist;
-	    histDom->nBins = nBins0;
-	    histDom->origin = binOrigin0;
-	    histDom->binSize = binSize0;
-	    errNum = WlzHistogramCompute2D(histDom, srcObj, 0);
-	  }
-	}
-	if((errNum == WLZ_ERR_NONE) && (greyType == WLZ_GREY_UBYTE) &&
-	   ((nBins != nBins0) ||
-	    (fabs(binOrigin - binOrigin0) > DBL_EPSILON) ||
-	    (fabs(binSize - binSize0) > DBL_EPSILON)))
-	{
-	  WlzHistogramReBinUbyte(histObj->domain.hist, nBins, binOrigin,
-	  			 binSize);
-	}
-        break;
-      case WLZ_TRANS_OBJ:
-	if((errNum = WlzHistogramCheckDomainAndValues(&greyType, &isTiled,
-						      srcObj)) == WLZ_ERR_NONE)
-	{
-	  histObj = WlzHistogramObj(srcObj->values.obj, nBins,
-	  			    binOrigin, binSize, &errNum);
-	}
-	break;
-      case WLZ_3D_DOMAINOBJ:
-	if((errNum = WlzHistogramCheckDomainAndValues(&greyType, &isTiled,
-						      srcObj)) == WLZ_ERR_NONE)
-	{
-	  switch(greyType)
-	  {
-	    case WLZ_GREY_UBYTE:
-	      nBins0 = 256;
-	      binOrigin0 = 0.0;
-	      binSize0 = 1.0;
-	      break;
 	    case WLZ_GREY_INT:
-	    case WLZ_GREY_SHORT:
 	    case WLZ_GREY_FLOAT:
 	    case WLZ_GREY_DOUBLE:
 	      if(nBins == 0)
@@ -782,79 +992,35 @@ WlzObject	*WlzHistogramObj(WlzObject *srcObj, int nBins,
 	}
 	if(errNum == WLZ_ERR_NONE)
 	{
-	  histObj = WlzMakeHistogram(WLZ_HISTOGRAMDOMAIN_INT, nBins0,
-	  			     &errNum);
-	  if(errNum == WLZ_ERR_NONE)
-	  {
-	     histObj2D = WlzMakeHistogram(WLZ_HISTOGRAMDOMAIN_INT, nBins0,
-	     				  &errNum);
-	  }
-	  if(((histObj == NULL) || (histObj2D == NULL)) &&
-	     (errNum == WLZ_ERR_NONE))
+	  if(((histObj = WlzMakeHistogram(WLZ_HISTOGRAMDOMAIN_INT,
+	  				  nBins0, &errNum)) == NULL) &&
+	      (errNum == WLZ_ERR_NONE))
 	  {
 	    errNum = WLZ_ERR_UNSPECIFIED;
 	  }
-	  if(errNum == WLZ_ERR_NONE)
+	  else
 	  {
 	    histDom = histObj->domain.hist;
-	    histDom->nBins = nBins0;
-	    histDom->origin = binOrigin0;
-	    histDom->binSize = binSize0;
-	    histDom2D = histObj2D->domain.hist;
-	    histDom2D->nBins = nBins0;
-	    histDom2D->origin = binOrigin0;
-	    histDom2D->binSize = binSize0;
-	    planeCount = srcObj->domain.p->lastpl -
-	    		 srcObj->domain.p->plane1 + 1;
-	    srcObj2D = WlzMakeMain(WLZ_2D_DOMAINOBJ, dummyDom, dummyValues,
-	    			   NULL, NULL, &errNum);
-	    if((srcObj2D == NULL) && (errNum == WLZ_ERR_NONE))
-	    {
-	      errNum = WLZ_ERR_UNSPECIFIED;
-	    }
-	    else
-	    {
-	      planeIdx = 0;
-	      WlzValueSetInt(histDom->binValues.inp, 0, histDom->maxBins);
-	      while((errNum == WLZ_ERR_NONE) && (planeCount-- > 0))
-	      {
-		srcObj2D->domain = *(srcObj->domain.p->domains + planeIdx);
-		if(isTiled)
-		{
-		  srcObj2D->values = srcObj->values;
-		}
-		else
-		{
-		  srcObj2D->values = *(srcObj->values.vox->values + planeIdx);
-		}
-		if(srcObj2D->domain.core && srcObj2D->values.core &&
-		   (srcObj2D->domain.core->type != WLZ_EMPTY_OBJ) &&
-		   (srcObj2D->values.core->type != WLZ_EMPTY_OBJ))
-		{
-		  WlzValueSetInt(histDom2D->binValues.inp, 0,
-				 histDom2D->maxBins);
-		  if((errNum = WlzHistogramCompute2D(histDom2D, srcObj2D,
-		                                    planeIdx)) == WLZ_ERR_NONE)
-		  {
-		    WlzHistogramAddIntBins(histDom, histDom2D);
-		  }
-	        }
-		++planeIdx;
-	      }
-	      srcObj2D->domain = dummyDom;
-	      srcObj2D->values = dummyValues;
-	      WlzFreeObj(srcObj2D);
-	    }
-	    WlzFreeObj(histObj2D);
+	    histDom->nBins = nBins0;
+	    histDom->origin = binOrigin0;
+	    histDom->binSize = binSize0;
+	    errNum = WlzHistogramCompute(histDom, srcObj, isTiled);
 	  }
 	}
-	if((errNum == WLZ_ERR_NONE) && (greyType == WLZ_GREY_UBYTE) &&
-	   ((nBins != nBins0) ||
-	    (fabs(binOrigin - binOrigin0) > DBL_EPSILON) ||
-	    (fabs(binSize - binSize0) > DBL_EPSILON)))
+	if(errNum == WLZ_ERR_NONE)
 	{
-	  WlzHistogramReBinUbyte(histObj->domain.hist, nBins, binOrigin,
-	  			 binSize);
+	  if((greyType == WLZ_GREY_UBYTE) &&
+	     ((nBins != nBins0) ||
+	      (fabs(binOrigin - binOrigin0) > DBL_EPSILON) ||
+	      (fabs(binSize - binSize0) > DBL_EPSILON)))
+	  {
+	    WlzHistogramReBinUbyte(histObj->domain.hist, nBins, binOrigin,
+				   binSize);
+	  }
+	  else if((greyType == WLZ_GREY_SHORT) && (nBins == 0))
+	  {
+	    WlzHistogramTrim(histObj->domain.hist);
+	  }
 	}
 	break;
       default:
@@ -1524,6 +1690,203 @@ WlzErrorNum	WlzHistogramCummulative(WlzObject *srcHist)
   return(errNum);
 }
 
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzHistogram
+* \brief	Uses the given mapping histogram domain to remap the
+*               grey values of the given 2D domain object.
+*               Because this is a static function there's no need to
+*               check the parameters.
+* \param	srcObj			Given 2D domain object.
+* \param	mapHistDom		Mapping histogram domain.
+* \param	dither			If non zero then dither mapped
+*                                       values.
+*/
+static WlzErrorNum WlzHistogramMapValues2D(WlzObject *srcObj,
+					   WlzHistogramDomain *mapHistDom,
+					   int dither)
+{
+  int		tI0,
+		ivCount,
+		originI;
+  double	originD;
+  int		*mapping;
+  WlzGreyP	objPix;
+  WlzIntervalWSpace iWSp;
+  WlzGreyWSpace	gWSp;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((errNum = WlzInitGreyScan(srcObj, &iWSp, &gWSp)) == WLZ_ERR_NONE)
+  {
+    mapping = mapHistDom->binValues.inp;
+    originD = mapHistDom->origin;
+    originI = (int )floor(originD);
+    while((errNum = WlzNextGreyInterval(&iWSp)) == WLZ_ERR_NONE)
+    {
+      ivCount = iWSp.rgtpos - iWSp.lftpos + 1;
+      switch(gWSp.pixeltype)
+      {
+	case WLZ_GREY_INT:
+	  objPix.inp = gWSp.u_grintptr.inp;
+	  if(dither == 0)
+	  {
+	    if(originI)
+	    {
+	      while(ivCount-- > 0)
+	      {
+		*(objPix.inp) = *(mapping + *(objPix.inp) - originI);
+		++(objPix.inp);
+	      }
+	    }
+	    else
+	    {
+	      while(ivCount-- > 0)
+	      {
+		*(objPix.inp) = *(mapping + *(objPix.inp));
+		++(objPix.inp);
+	      }
+	    }
+	  }
+	  else
+	  {
+	    while(ivCount-- > 0)
+	    {
+	      *(objPix.inp) = WlzHistogramMapValuesDitherI(mapping,
+				  *(objPix.inp) - originI,
+				  mapHistDom->nBins);
+	      ++(objPix.inp);
+	    }
+
+	  }
+	  break;
+	case WLZ_GREY_SHORT:
+	  objPix.shp = gWSp.u_grintptr.shp;
+	  if(dither == 0)
+	  {
+	    if(originI)
+	    {
+	      while(ivCount-- > 0)
+	      {
+		*(objPix.shp) = (short )
+				*(mapping + *(objPix.shp) - originI);
+		++(objPix.shp);
+	      }
+	    }
+	    else
+	    {
+	      while(ivCount-- > 0)
+	      {
+		*(objPix.shp) = (short )
+				*(mapping + *(objPix.shp));
+		++(objPix.shp);
+	      }
+	    }
+	  }
+	  else
+	  {
+	    while(ivCount-- > 0)
+	    {
+	      *(objPix.shp) = (short )
+			      WlzHistogramMapValuesDitherI(mapping,
+				  *(objPix.shp) - originI,
+				  mapHistDom->nBins);
+	      ++(objPix.shp);
+	    }
+	  }
+	  break;
+	case WLZ_GREY_UBYTE:
+	  objPix.ubp = gWSp.u_grintptr.ubp;
+	  if(dither == 0)
+	  {
+	    if(originI)
+	    {
+	      while(ivCount-- > 0)
+	      {
+		*(objPix.ubp) = (WlzUByte )
+				*(mapping + *(objPix.ubp) - originI);
+		++(objPix.ubp);
+	      }
+	    }
+	    else
+	    {
+	      while(ivCount-- > 0)
+	      {
+		*(objPix.ubp) = (WlzUByte )*(mapping + *(objPix.ubp));
+		++(objPix.ubp);
+	      }
+	    }
+	  }
+	  else
+	  {
+	    while(ivCount-- > 0)
+	    {
+	      *(objPix.ubp) = (WlzUByte )
+			      WlzHistogramMapValuesDitherI(mapping,
+				  *(objPix.ubp) - originI,
+				  mapHistDom->nBins);
+	      ++(objPix.ubp);
+	    }
+	  }
+	  break;
+	case WLZ_GREY_FLOAT:
+	  objPix.flp = gWSp.u_grintptr.flp;
+	  if(dither == 0)
+	  {
+	    while(ivCount-- > 0)
+	    {
+	      tI0 = (int )floor(*(objPix.flp) - originD);
+	      *(objPix.flp) = (float )*(mapping + tI0);
+	      ++(objPix.flp);
+	    }
+	  }
+	  else
+	  {
+	    while(ivCount-- > 0)
+	    {
+	      *(objPix.flp) = (float )
+			      WlzHistogramMapValuesDitherD(mapping,
+				  (int )(floor(*(objPix.flp) - originD)),
+				  mapHistDom->nBins);
+	      ++(objPix.flp);
+	    }
+	  }
+	  break;
+	case WLZ_GREY_DOUBLE:
+	  objPix.dbp = gWSp.u_grintptr.dbp;
+	  if(dither == 0)
+	  {
+	    while(ivCount-- > 0)
+	    {
+	      tI0 = (int )floor(*(objPix.dbp) - originD);
+	      *(objPix.dbp) = *(mapping + tI0);
+	      ++(objPix.dbp);
+	    }
+	  }
+	  else
+	  {
+	    while(ivCount-- > 0)
+	    {
+	      *(objPix.dbp) = WlzHistogramMapValuesDitherD(mapping,
+				  (int )(floor(*(objPix.dbp) - originD)),
+				  mapHistDom->nBins);
+	      ++(objPix.dbp);
+	    }
+	  }
+	  break;
+	default:
+	  errNum = WLZ_ERR_GREY_TYPE;
+	  break;
+      }
+    }
+    (void )WlzEndGreyScan(&iWSp, &gWSp);
+    if(errNum == WLZ_ERR_EOO)		/* Reset error from end of intervals */
+    {
+      errNum = WLZ_ERR_NONE;
+    }
+  }
+  return(errNum);
+}
+
 /*!
 * \return	Woolz error code.
 * \ingroup	WlzHistogram
@@ -1532,6 +1895,11 @@ WlzErrorNum	WlzHistogramCummulative(WlzObject *srcHist)
 *               3D domain object.
 *               The mapping histogram MUST have integral bin values
 *               and bins appropriate for all domain object values.
+*               Unless dithering is used the values are mapped in
+*               parallel, by plane for 3D objects and by bands of
+*               lines for 2D objects. Dithered values are mapped by a
+*               single thread so that the sequence of random numbers
+*               used is repeatable.
 * \param	srcObj			Given 2D or 3D domain object.
 * \param	mapHistObj		Mapping histogram.
 * \param	dither			If non zero then dither mapped
@@ -1542,22 +1910,9 @@ WlzErrorNum	WlzHistogramMapValues(WlzObject *srcObj,
 				      WlzObject *mapHistObj,
 				      int dither)
 {
-  int		tI0,
-		ivCount,
-		originI,
-  		planeIdx,
-		planeCount,
-		isTiled = 0;
-  double	originD;
-  int		*mapping;
+  int		isTiled = 0;
   WlzGreyType	greyType;
   WlzHistogramDomain *mapHistDom = NULL;
-  WlzGreyP	objPix;
-  WlzObject	*srcObj2D = NULL;
-  WlzDomain	dummyDom;
-  WlzValues	dummyValues;
-  WlzIntervalWSpace iWSp;
-  WlzGreyWSpace	gWSp;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
 
   WLZ_DBG((WLZ_DBG_LVL_1),
@@ -1575,7 +1930,7 @@ WlzErrorNum	WlzHistogramMapValues(WlzObject *srcObj,
       errNum = WLZ_ERR_DOMAIN_DATA;
     }
   }
-  if((errNum = WLZ_ERR_NONE) && isTiled)
+  if((errNum == WLZ_ERR_NONE) && isTiled)
   {
     errNum = WLZ_ERR_VALUES_TYPE;
   }
@@ -1588,204 +1943,55 @@ WlzErrorNum	WlzHistogramMapValues(WlzObject *srcObj,
       case WLZ_TRANS_OBJ:
 	errNum = WlzHistogramMapValues(srcObj->values.obj, mapHistObj, dither);
         break;
+      case WLZ_2D_DOMAINOBJ: /* FALLTHROUGH */
       case WLZ_3D_DOMAINOBJ:
-	dummyDom.core = NULL;
-	dummyValues.core = NULL;
-	if(((srcObj2D = WlzMakeMain(WLZ_2D_DOMAINOBJ, dummyDom,
-				    dummyValues, NULL, NULL,
-				    &errNum)) == NULL) &&
-	   (errNum == WLZ_ERR_NONE))
 	{
-	  errNum = WLZ_ERR_UNSPECIFIED;
-	}
-	else
-	{
-	  planeIdx =  0;
-	  planeCount = srcObj->domain.p->lastpl - srcObj->domain.p->plane1 + 1;
-	  while((errNum == WLZ_ERR_NONE) && (planeCount-- > 0))
+	  int	idP,
+		nPart,
+		nThr = 1;
+
+#ifdef _OPENMP
+	  if(dither == 0)
 	  {
-	    srcObj2D->domain = *(srcObj->domain.p->domains + planeIdx);
-	    srcObj2D->values = *(srcObj->values.vox->values + planeIdx);
-	    if((srcObj2D->values.core) &&
-	       (srcObj2D->values.core->type != WLZ_EMPTY_OBJ))
+#pragma omp parallel
 	    {
-		errNum = WlzHistogramMapValues(srcObj2D, mapHistObj, dither);
+#pragma omp master
+	      {
+		nThr = omp_get_num_threads();
+	      }
 	    }
-	    ++planeIdx;
 	  }
-	  srcObj2D->domain.core = NULL;
-	  srcObj2D->values.core = NULL;
-	  WlzFreeObj(srcObj2D);
-	}
-        break;
-      case WLZ_2D_DOMAINOBJ:
-	if((errNum = WlzInitGreyScan(srcObj, &iWSp, &gWSp)) == WLZ_ERR_NONE)
-	{
-          mapping = mapHistDom->binValues.inp;
-	  originD = mapHistDom->origin;
-	  originI = (int )floor(originD);
-	  while((errNum = WlzNextGreyInterval(&iWSp)) == WLZ_ERR_NONE)
+#endif
+	  nPart = WlzHistogramNParts(srcObj, nThr);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if(dither == 0)
+#endif
+	  for(idP = 0; idP < nPart; ++idP)
 	  {
-	    ivCount = iWSp.rgtpos - iWSp.lftpos + 1;
-	    switch(gWSp.pixeltype)
+	    if(errNum == WLZ_ERR_NONE)
 	    {
-	      case WLZ_GREY_INT:
-		objPix.inp = gWSp.u_grintptr.inp;
-		if(dither == 0)
-		{
-		  if(originI)
-		  {
-		    while(ivCount-- > 0)
-		    {
-		      *(objPix.inp) = *(mapping + *(objPix.inp) - originI);
-		      ++(objPix.inp);
-		    }
-		  }
-		  else
-		  {
-		    while(ivCount-- > 0)
-		    {
-		      *(objPix.inp) = *(mapping + *(objPix.inp));
-		      ++(objPix.inp);
-		    }
-		  }
-		}
-		else
-		{
-		  while(ivCount-- > 0)
-		  {
-		    *(objPix.inp) = WlzHistogramMapValuesDitherI(mapping,
-		    			*(objPix.inp) - originI,
-					mapHistDom->nBins);
-		    ++(objPix.inp);
-		  }
+	      int	pln;
+	      WlzObject *obj2D;
+	      WlzErrorNum errNum2 = WLZ_ERR_NONE;
 
-		}
-		break;
-	      case WLZ_GREY_SHORT:
-		objPix.shp = gWSp.u_grintptr.shp;
-		if(dither == 0)
-		{
-		  if(originI)
-		  {
-		    while(ivCount-- > 0)
-		    {
-		      *(objPix.shp) = (short )
-		                      *(mapping + *(objPix.shp) - originI);
-		      ++(objPix.shp);
-		    }
-		  }
-		  else
-		  {
-		    while(ivCount-- > 0)
-		    {
-		      *(objPix.shp) = (short )
-		                      *(mapping + *(objPix.shp));
-		      ++(objPix.shp);
-		    }
-		  }
-		}
-		else
-		{
-		  while(ivCount-- > 0)
-		  {
-		    *(objPix.shp) = (short )
-		                    WlzHistogramMapValuesDitherI(mapping,
-		    			*(objPix.shp) - originI,
-					mapHistDom->nBins);
-		    ++(objPix.shp);
-		  }
-		}
-		break;
-	      case WLZ_GREY_UBYTE:
-		objPix.ubp = gWSp.u_grintptr.ubp;
-		if(dither == 0)
-		{
-		  if(originI)
-		  {
-		    while(ivCount-- > 0)
-		    {
-		      *(objPix.ubp) = (WlzUByte )
-		                      *(mapping + *(objPix.ubp) - originI);
-		      ++(objPix.ubp);
-		    }
-		  }
-		  else
-		  {
-		    while(ivCount-- > 0)
-		    {
-		      *(objPix.ubp) = (WlzUByte )*(mapping + *(objPix.ubp));
-		      ++(objPix.ubp);
-		    }
-		  }
-		}
-		else
-		{
-		  while(ivCount-- > 0)
-		  {
-		    *(objPix.ubp) = (WlzUByte )
-		                    WlzHistogramMapValuesDitherI(mapping,
-		    			*(objPix.ubp) - originI,
-					mapHistDom->nBins);
-		    ++(objPix.ubp);
-		  }
-		}
-		break;
-	      case WLZ_GREY_FLOAT:
-		objPix.flp = gWSp.u_grintptr.flp;
-		if(dither == 0)
-		{
-		  while(ivCount-- > 0)
-		  {
-		    tI0 = (int )floor(*(objPix.flp) - originD);
-		    *(objPix.flp) = (float )*(mapping + tI0);
-		    ++(objPix.flp);
-		  }
-		}
-		else
-		{
-		  while(ivCount-- > 0)
-		  {
-		    *(objPix.flp) = (float )
-		    		    WlzHistogramMapValuesDitherD(mapping,
-		    			(int )(floor(*(objPix.flp) - originD)),
-					mapHistDom->nBins);
-		    ++(objPix.flp);
-		  }
-		}
-		break;
-	      case WLZ_GREY_DOUBLE:
-		objPix.dbp = gWSp.u_grintptr.dbp;
-		if(dither == 0)
-		{
-		  while(ivCount-- > 0)
-		  {
-		    tI0 = (int )floor(*(objPix.dbp) - originD);
-		    *(objPix.dbp) = *(mapping + tI0);
-		    ++(objPix.dbp);
-		  }
-		}
-		else
+	      obj2D = WlzHistogramPartObj(srcObj, 0, idP, nPart, &pln,
+	      				  &errNum2);
+	      if(obj2D)
+	      {
+		errNum2 = WlzHistogramMapValues2D(obj2D, mapHistDom, dither);
+		(void )WlzFreeObj(obj2D);
+	      }
+	      if(errNum2 != WLZ_ERR_NONE)
+	      {
+#ifdef _OPENMP
+#pragma omp critical (WlzHistogramMapValues)
+#endif
 		{
-		  while(ivCount-- > 0)
-		  {
-		    *(objPix.dbp) = WlzHistogramMapValuesDitherD(mapping,
-		    			(int )(floor(*(objPix.flp) - originD)),
-					mapHistDom->nBins);
-		    ++(objPix.dbp);
-		  }
+		  errNum = errNum2;
 		}
-		break;
-	      default:
-	        errNum = WLZ_ERR_GREY_TYPE;
-	        break;
+	      }
 	    }
 	  }
-          (void )WlzEndGreyScan(&iWSp, &gWSp);
-	  if(errNum == WLZ_ERR_EOO)	/* Reset error from end of intervals */
-	  {
-	    errNum = WLZ_ERR_NONE;
-	  }
 	}
 	break;
       default:
@@ -2679,7 +2885,7 @@ WlzErrorNum	WlzHistogramMatchObj(WlzObject *srcObj, WlzObject *targetHist,
      ((errNum = WlzHistogramCheckHistObj(targetHist)) == WLZ_ERR_NONE) &&
      ((histDom = targetHist->domain.hist)->nBins > 0))
   {
-    if((errNum = WLZ_ERR_NONE) && isTiled)
+    if((errNum == WLZ_ERR_NONE) && isTiled)
     {
       errNum = WLZ_ERR_VALUES_TYPE;
     }
@@ -43,6 +43,12 @@ static char _WlzInsideDomain_c[] = "University of Edinburgh $Id$";
 #include <stdlib.h>
 #include <Wlz.h>
 
+static WlzErrorNum		WlzDomainQueryIdxPlane(
+				  WlzDomainQueryIdx *idx,
+				  WlzIntervalDomain *iDom,
+				  int idP,
+				  int fill);
+
 /*!
 * \return	Non zero if point is inside.
 * \ingroup      WlzAccess
@@ -251,3 +257,516 @@ int		WlzInsideDomain(WlzObject *obj,
 	   inside));
   return(inside);
 }
+
+/*!
+* \return	New domain query index or NULL on error.
+* \ingroup      WlzAccess
+* \brief	Builds an index from the domain of the given object for
+* 		fast repeated point in domain queries, see
+* 		WlzDomainQueryIdxInside() and the batch query functions
+* 		WlzDomainQueryIdxInsideI2(), WlzDomainQueryIdxInsideI3()
+* 		and WlzDomainQueryIdxInsideD3(). The intervals of each line
+* 		are copied into sorted arrays which are binary searched.
+* 		If the bitset flag is set a bitset covering the bounding
+* 		box is also built; this is only worthwhile for dense
+* 		domains for which the bounding box is not too large.
+* 		The index does not reference the object, which may be
+* 		free'd once the index has been built. The planes of a
+* 		3D domain are indexed in parallel.
+* \param	obj			Given 2 or 3D domain object.
+* \param	bitset			Build a bitset if non-zero.
+* \param	dstErr			Destination error pointer, may
+*                                       be NULL.
+*/
+WlzDomainQueryIdx *WlzMakeDomainQueryIdx(WlzObject *obj, int bitset,
+					 WlzErrorNum *dstErr)
+{
+  int		nPl = 1;
+  size_t	nLnT = 0;
+  WlzDomainQueryIdx *idx = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(obj == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if(obj->domain.core == NULL)
+  {
+    errNum = WLZ_ERR_DOMAIN_NULL;
+  }
+  else
+  {
+    switch(obj->type)
+    {
+      case WLZ_2D_DOMAINOBJ:
+	switch(obj->domain.core->type)
+	{
+	  case WLZ_INTERVALDOMAIN_INTVL: /* FALLTHROUGH */
+	  case WLZ_INTERVALDOMAIN_RECT:
+	    break;
+	  default:
+	    errNum = WLZ_ERR_DOMAIN_TYPE;
+	    break;
+	}
+        break;
+      case WLZ_3D_DOMAINOBJ:
+	if(obj->domain.core->type != WLZ_PLANEDOMAIN_DOMAIN)
+	{
+	  errNum = WLZ_ERR_PLANEDOMAIN_TYPE;
+	}
+        break;
+      default:
+        errNum = WLZ_ERR_OBJECT_TYPE;
+	break;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((idx = (WlzDomainQueryIdx *)
+              AlcCalloc(1, sizeof(WlzDomainQueryIdx))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      idx->bBox = WlzBoundingBox3I(obj, &errNum);
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(obj->type == WLZ_2D_DOMAINOBJ)
+    {
+      idx->dim = 2;
+      idx->bBox.zMin = idx->bBox.zMax = 0;
+    }
+    else
+    {
+      idx->dim = 3;
+      nPl = idx->bBox.zMax - idx->bBox.zMin + 1;
+    }
+    idx->nLn = idx->bBox.yMax - idx->bBox.yMin + 1;
+    nLnT = (size_t )nPl * idx->nLn;
+    if((idx->lnItv = (size_t *)AlcCalloc(nLnT + 1, sizeof(size_t))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  /* Count the intervals of each line, then compute the line offsets. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(idx->dim == 2)
+    {
+      errNum = WlzDomainQueryIdxPlane(idx, obj->domain.i, 0, 0);
+    }
+    else
+    {
+      int	idP;
+      WlzPlaneDomain *pDom;
+
+      pDom = obj->domain.p;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for(idP = 0; idP < nPl; ++idP)
+      {
+	int	p;
+
+	p = idP + idx->bBox.zMin - pDom->plane1;
+	if((p >= 0) && (p <= pDom->lastpl - pDom->plane1))
+	{
+	  WlzErrorNum errNum2D;
+
+	  errNum2D = WlzDomainQueryIdxPlane(idx, pDom->domains[p].i, idP, 0);
+	  if(errNum2D != WLZ_ERR_NONE)
+	  {
+#ifdef _OPENMP
+#pragma omp critical (WlzMakeDomainQueryIdx)
+#endif
+	    {
+	      errNum = errNum2D;
+	    }
+	  }
+	}
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    size_t	idL,
+    		cnt,
+		sum = 0;
+
+    for(idL = 0; idL <= nLnT; ++idL)
+    {
+      cnt = idx->lnItv[idL];
+      idx->lnItv[idL] = sum;
+      sum += cnt;
+    }
+    if((idx->itv = (int *)AlcMalloc((2 * sum + 1) * sizeof(int))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && bitset)
+  {
+    idx->bitLnSz = (idx->bBox.xMax - idx->bBox.xMin + 8) / 8;
+    if((idx->bits = (WlzUByte *)
+                    AlcCalloc(nLnT * idx->bitLnSz, sizeof(WlzUByte))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  /* Fill in the intervals and bitset. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(idx->dim == 2)
+    {
+      errNum = WlzDomainQueryIdxPlane(idx, obj->domain.i, 0, 1);
+    }
+    else
+    {
+      int	idP;
+      WlzPlaneDomain *pDom;
+
+      pDom = obj->domain.p;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for(idP = 0; idP < nPl; ++idP)
+      {
+	int	p;
+
+	p = idP + idx->bBox.zMin - pDom->plane1;
+	if((p >= 0) && (p <= pDom->lastpl - pDom->plane1))
+	{
+	  (void )WlzDomainQueryIdxPlane(idx, pDom->domains[p].i, idP, 1);
+	}
+      }
+    }
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    (void )WlzFreeDomainQueryIdx(idx);
+    idx = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(idx);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup      WlzAccess
+* \brief	Frees a domain query index.
+* \param	idx			Given domain query index.
+*/
+WlzErrorNum	WlzFreeDomainQueryIdx(WlzDomainQueryIdx *idx)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(idx == NULL)
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else
+  {
+    AlcFree(idx->lnItv);
+    AlcFree(idx->itv);
+    AlcFree(idx->bits);
+    AlcFree(idx);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Non zero if point is inside.
+* \ingroup      WlzAccess
+* \brief	Looks to see if the given point is within the domain
+* 		of the given domain query index.
+* \param	idx			Given domain query index.
+* \param	plane			Plane (z) position, ignored if
+* 					the index is 2D.
+* \param	line			Line (y) position.
+* \param	kol			Column (x) position.
+*/
+int		WlzDomainQueryIdxInside(WlzDomainQueryIdx *idx,
+					int plane, int line, int kol)
+{
+  int		inside = 0;
+
+  if(idx->dim == 2)
+  {
+    plane = 0;
+  }
+  if((plane >= idx->bBox.zMin) && (plane <= idx->bBox.zMax) &&
+     (line >= idx->bBox.yMin) && (line <= idx->bBox.yMax) &&
+     (kol >= idx->bBox.xMin) && (kol <= idx->bBox.xMax))
+  {
+    size_t	idL;
+
+    idL = ((size_t )(plane - idx->bBox.zMin) * idx->nLn) +
+          (line - idx->bBox.yMin);
+    if(idx->bits)
+    {
+      kol -= idx->bBox.xMin;
+      inside = (idx->bits[(idL * idx->bitLnSz) + (kol >> 3)] >>
+                (kol & 7)) & 1;
+    }
+    else
+    {
+      size_t	lo,
+      		hi,
+		mid;
+
+      /* Binary search for the last interval with a left column which
+       * is not greater than the given column. */
+      lo = idx->lnItv[idL];
+      hi = idx->lnItv[idL + 1];
+      while(lo + 1 < hi)
+      {
+        mid = (lo + hi) / 2;
+	if(idx->itv[2 * mid] <= kol)
+	{
+	  lo = mid;
+	}
+	else
+	{
+	  hi = mid;
+	}
+      }
+      if(lo < hi)
+      {
+        inside = (idx->itv[2 * lo] <= kol) && (kol <= idx->itv[2 * lo + 1]);
+      }
+    }
+  }
+  return(inside);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup      WlzAccess
+* \brief	Classifies each of the given 2D integer points as inside
+* 		or outside the domain of the given domain query index,
+* 		in parallel. For 3D indices the points are taken to lie
+* 		on plane zero.
+* \param	idx			Given domain query index.
+* \param	nPos			Number of points.
+* \param	pos			Array of points.
+* \param	dstIn			Destination array for the non-zero
+* 					if inside values, which must have
+* 					room for nPos values.
+*/
+WlzErrorNum	WlzDomainQueryIdxInsideI2(WlzDomainQueryIdx *idx,
+					  int nPos, WlzIVertex2 *pos,
+					  int *dstIn)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((idx == NULL) || (((pos == NULL) || (dstIn == NULL)) && (nPos > 0)))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else
+  {
+    int		idN;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(idN = 0; idN < nPos; ++idN)
+    {
+      dstIn[idN] = WlzDomainQueryIdxInside(idx, 0, pos[idN].vtY,
+                                           pos[idN].vtX);
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup      WlzAccess
+* \brief	Classifies each of the given 3D integer points as inside
+* 		or outside the domain of the given domain query index,
+* 		in parallel. For 2D indices the plane coordinates are
+* 		ignored.
+* \param	idx			Given domain query index.
+* \param	nPos			Number of points.
+* \param	pos			Array of points.
+* \param	dstIn			Destination array for the non-zero
+* 					if inside values, which must have
+* 					room for nPos values.
+*/
+WlzErrorNum	WlzDomainQueryIdxInsideI3(WlzDomainQueryIdx *idx,
+					  int nPos, WlzIVertex3 *pos,
+					  int *dstIn)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((idx == NULL) || (((pos == NULL) || (dstIn == NULL)) && (nPos > 0)))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else
+  {
+    int		idN;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(idN = 0; idN < nPos; ++idN)
+    {
+      dstIn[idN] = WlzDomainQueryIdxInside(idx, pos[idN].vtZ, pos[idN].vtY,
+                                           pos[idN].vtX);
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup      WlzAccess
+* \brief	Classifies each of the given 3D double precision points
+* 		as inside or outside the domain of the given domain query
+* 		index, in parallel. As for WlzInsideDomain() the points
+* 		are rounded to the nearest integer coordinates. For 2D
+* 		indices the plane coordinates are ignored.
+* \param	idx			Given domain query index.
+* \param	nPos			Number of points.
+* \param	pos			Array of points.
+* \param	dstIn			Destination array for the non-zero
+* 					if inside values, which must have
+* 					room for nPos values.
+*/
+WlzErrorNum	WlzDomainQueryIdxInsideD3(WlzDomainQueryIdx *idx,
+					  int nPos, WlzDVertex3 *pos,
+					  int *dstIn)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((idx == NULL) || (((pos == NULL) || (dstIn == NULL)) && (nPos > 0)))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else
+  {
+    int		idN;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(idN = 0; idN < nPos; ++idN)
+    {
+      dstIn[idN] = WlzDomainQueryIdxInside(idx,
+					   WLZ_NINT(pos[idN].vtZ),
+					   WLZ_NINT(pos[idN].vtY),
+					   WLZ_NINT(pos[idN].vtX));
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup      WlzAccess
+* \brief	Either counts the intervals of each line of the given
+* 		interval domain, storing the counts in the line interval
+* 		indices of the domain query index, or fills in the
+* 		intervals (and bitset if it exists) using the previously
+* 		computed line interval indices.
+* \param	idx			Given domain query index.
+* \param	iDom			Interval domain of the plane, may
+* 					be NULL.
+* \param	idP			Plane index relative to the first
+* 					plane of the domain query index.
+* \param	fill			Fill in the intervals if non-zero
+* 					otherwise count them.
+*/
+static WlzErrorNum WlzDomainQueryIdxPlane(WlzDomainQueryIdx *idx,
+					  WlzIntervalDomain *iDom,
+					  int idP, int fill)
+{
+  int		idL,
+  		idI,
+		ln,
+		nItv;
+  size_t	idL0;
+  WlzInterval	rItv;
+  WlzInterval	*itv;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(iDom != NULL)
+  {
+    switch(iDom->type)
+    {
+      case WLZ_INTERVALDOMAIN_INTVL: /* FALLTHROUGH */
+      case WLZ_INTERVALDOMAIN_RECT:
+        break;
+      case WLZ_EMPTY_DOMAIN:
+        iDom = NULL;
+	break;
+      default:
+        errNum = WLZ_ERR_DOMAIN_TYPE;
+	break;
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (iDom != NULL))
+  {
+    idL0 = (size_t )idP * idx->nLn;
+    rItv.ileft = 0;
+    rItv.iright = iDom->lastkl - iDom->kol1;
+    for(ln = iDom->line1; ln <= iDom->lastln; ++ln)
+    {
+      idL = ln - idx->bBox.yMin;
+      if((idL < 0) || (idL >= idx->nLn))
+      {
+        continue;
+      }
+      if(iDom->type == WLZ_INTERVALDOMAIN_RECT)
+      {
+        nItv = 1;
+	itv = &rItv;
+      }
+      else
+      {
+        nItv = iDom->intvlines[ln - iDom->line1].nintvs;
+	itv = iDom->intvlines[ln - iDom->line1].intvs;
+      }
+      if(fill == 0)
+      {
+	idx->lnItv[idL0 + idL] = nItv;
+      }
+      else
+      {
+	int	  *dI;
+
+	dI = idx->itv + 2 * idx->lnItv[idL0 + idL];
+	for(idI = 0; idI < nItv; ++idI)
+	{
+	  dI[2 * idI] = iDom->kol1 + itv[idI].ileft;
+	  dI[2 * idI + 1] = iDom->kol1 + itv[idI].iright;
+	}
+	if(idx->bits)
+	{
+	  int	  kl;
+	  WlzUByte *bLn;
+
+	  bLn = idx->bits + ((idL0 + idL) * idx->bitLnSz);
+	  for(idI = 0; idI < nItv; ++idI)
+	  {
+	    for(kl = dI[2 * idI]; kl <= dI[2 * idI + 1]; ++kl)
+	    {
+	      int   b;
+
+	      b = kl - idx->bBox.xMin;
+	      bLn[b >> 3] |= (WlzUByte )(1 << (b & 7));
+	    }
+	  }
+	}
+      }
+    }
+  }
+  return(errNum);
+}
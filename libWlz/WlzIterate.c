@@ -40,8 +40,19 @@ static char _WlzIterate_c[] = "University of Edinburgh $Id$";
 */
 
 #include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include <Wlz.h>
 
+/*!
+* \def		WLZ_ITERATE_CHUNKS_PER_THREAD
+* \brief	Default number of chunks per thread when partitioning an
+* 		object, more than one chunk per thread allows for chunks
+* 		which take differing times to process.
+*/
+#define WLZ_ITERATE_CHUNKS_PER_THREAD	(4)
+
 static WlzIterateWSpace 	*WlzIterateMakeWSp();
 static WlzErrorNum 		WlzIterateInitDomObj2D(
 				  WlzIterateWSpace *itWSp,
@@ -190,6 +201,417 @@ WlzErrorNum	WlzIterate(WlzIterateWSpace *itWSp)
   return(errNum);
 }
 
+/*!
+* \return	New partition of the given object or NULL on error.
+* \ingroup	WlzDomainOps
+* \brief	Partitions the given 2 or 3D domain object into chunks
+* 		so that the intervals of the object may be scanned
+* 		concurrently, with each thread using it's own chunk
+* 		workspace (see WlzIterateChunkInit()). Each chunk is a
+* 		contiguous range of lines within a single plane and the
+* 		chunks are balanced by interval count. If the object has
+* 		tiled values then chunks only start on tile boundaries,
+* 		so that concurrent threads do not share tiles.
+* 		The partition refers to, but is not linked to, the given
+* 		object which must not be freed before the partition.
+* 		A typical use is:
+* \verbatim
+  part = WlzIteratePartitionMake(obj, 0, &errNum);
+  #pragma omp parallel for schedule(dynamic)
+  for(idx = 0; idx < part->nChunk; ++idx)
+  {
+    WlzIterateChunkWSpace cWSp;
+
+    if(WlzIterateChunkInit(&cWSp, part, idx, obj->values) == WLZ_ERR_NONE)
+    {
+      while(WlzIterateChunkNext(&cWSp) == WLZ_ERR_NONE)
+      {
+        ... cWSp.iWSp and cWSp.gWSp as for WlzNextGreyInterval() ...
+      }
+      WlzIterateChunkEnd(&cWSp);
+    }
+  }
+  WlzIteratePartitionFree(part);
+  \endverbatim
+* \param	obj			Given object which must be either of
+* 					the type WLZ_2D_DOMAINOBJ or
+* 					WLZ_3D_DOMAINOBJ.
+* \param	nChunk			Required number of chunks, if less
+* 					than one then a number suitable for
+* 					the available threads is used. The
+* 					number of chunks in the partition may
+* 					differ from this.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzIteratePartition *WlzIteratePartitionMake(WlzObject *obj, int nChunk,
+				WlzErrorNum *dstErr)
+{
+  int		idP,
+		nPln = 1,
+		pln1 = 0,
+		tileLn1 = 0,
+		tileWidth = 0;
+  WlzDomain	*doms = NULL;
+  WlzIteratePartition *part = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(obj == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if(obj->domain.core == NULL)
+  {
+    errNum = WLZ_ERR_DOMAIN_NULL;
+  }
+  else
+  {
+    switch(obj->type)
+    {
+      case WLZ_2D_DOMAINOBJ:
+	doms = &(obj->domain);
+	break;
+      case WLZ_3D_DOMAINOBJ:
+	if(obj->domain.core->type != WLZ_PLANEDOMAIN_DOMAIN)
+	{
+	  errNum = WLZ_ERR_DOMAIN_TYPE;
+	}
+	else
+	{
+	  doms = obj->domain.p->domains;
+	  pln1 = obj->domain.p->plane1;
+	  nPln = obj->domain.p->lastpl - pln1 + 1;
+	}
+	break;
+      default:
+        errNum = WLZ_ERR_OBJECT_TYPE;
+	break;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(obj->values.core && WlzGreyTableIsTiled(obj->values.core->type))
+    {
+      tileLn1 = obj->values.t->line1;
+      tileWidth = obj->values.t->tileWidth;
+    }
+    if(nChunk < 1)
+    {
+#ifdef _OPENMP
+      nChunk = WLZ_ITERATE_CHUNKS_PER_THREAD * omp_get_max_threads();
+#else
+      nChunk = 1;
+#endif
+    }
+    if((part = (WlzIteratePartition *)
+               AlcCalloc(1, sizeof(WlzIteratePartition))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  /* Count the intervals while checking the domains of the planes. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    for(idP = 0; (errNum == WLZ_ERR_NONE) && (idP < nPln); ++idP)
+    {
+      WlzIntervalDomain *iDom;
+
+      if((iDom = doms[idP].i) != NULL)
+      {
+	switch(iDom->type)
+	{
+	  case WLZ_INTERVALDOMAIN_INTVL:
+	    {
+	      int	idL,
+			nLn;
+
+	      nLn = iDom->lastln - iDom->line1 + 1;
+	      for(idL = 0; idL < nLn; ++idL)
+	      {
+		part->nItv += iDom->intvlines[idL].nintvs;
+	      }
+	    }
+	    break;
+	  case WLZ_INTERVALDOMAIN_RECT:
+	    part->nItv += iDom->lastln - iDom->line1 + 1;
+	    break;
+	  case WLZ_EMPTY_DOMAIN:
+	    break;
+	  default:
+	    errNum = WLZ_ERR_DOMAIN_TYPE;
+	    break;
+	}
+      }
+    }
+  }
+  /* Each cut made within a plane has at least the target number of
+   * intervals before it, so there can be at most nChunk such cuts plus
+   * one final chunk per plane. */
+  if((errNum == WLZ_ERR_NONE) && (part->nItv > 0))
+  {
+    if((part->chunk = (WlzIterateChunk *)
+                      AlcMalloc(sizeof(WlzIterateChunk) *
+		                (nChunk + nPln))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (part->nItv > 0))
+  {
+    int		tgt;
+
+    tgt = (part->nItv + nChunk - 1) / nChunk;
+    for(idP = 0; idP < nPln; ++idP)
+    {
+      WlzIntervalDomain *iDom;
+
+      iDom = doms[idP].i;
+      if((iDom != NULL) && (iDom->type != WLZ_EMPTY_DOMAIN))
+      {
+	int	idL,
+		cnt = 0,
+		ln1;
+	WlzIterateChunk *chk;
+
+	ln1 = iDom->line1;
+	for(idL = iDom->line1; idL <= iDom->lastln; ++idL)
+	{
+	  if((cnt >= tgt) &&
+	     ((tileWidth == 0) || (((idL - tileLn1) % tileWidth) == 0)))
+	  {
+	    chk = part->chunk + part->nChunk++;
+	    chk->plane = pln1 + idP;
+	    chk->line1 = ln1;
+	    chk->lastln = idL - 1;
+	    chk->nItv = cnt;
+	    ln1 = idL;
+	    cnt = 0;
+	  }
+	  cnt += (iDom->type == WLZ_INTERVALDOMAIN_INTVL)?
+	         iDom->intvlines[idL - iDom->line1].nintvs: 1;
+	}
+	if(cnt > 0)
+	{
+	  chk = part->chunk + part->nChunk++;
+	  chk->plane = pln1 + idP;
+	  chk->line1 = ln1;
+	  chk->lastln = iDom->lastln;
+	  chk->nItv = cnt;
+	}
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    part->obj = obj;
+  }
+  else
+  {
+    WlzIteratePartitionFree(part);
+    part = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(part);
+}
+
+/*!
+* \ingroup	WlzDomainOps
+* \brief	Frees the given partition, but not it's object.
+* \param	part			Given partition.
+*/
+void		WlzIteratePartitionFree(WlzIteratePartition *part)
+{
+  if(part)
+  {
+    AlcFree(part->chunk);
+    AlcFree(part);
+  }
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzDomainOps
+* \brief	Initialises the given chunk workspace for scanning the
+* 		intervals of a single chunk of a partitioned object.
+* 		The chunk workspace must be ended by calling
+* 		WlzIterateChunkEnd() if this function succeeds.
+* \param	cWSp			Chunk workspace to be initialised.
+* \param	part			Given partition.
+* \param	idx			Index of the chunk in the partition.
+* \param	values			Values to be scanned within the
+* 					chunk, which must either be NULL
+* 					for no grey value access or the
+* 					(2D, voxel or tiled) values of an
+* 					object with the same domain as the
+* 					partitioned object. This allows the
+* 					values of several objects to be
+* 					scanned in step.
+*/
+WlzErrorNum	WlzIterateChunkInit(WlzIterateChunkWSpace *cWSp,
+				WlzIteratePartition *part, int idx,
+				WlzValues values)
+{
+  int		tiled = 0;
+  WlzDomain	dom;
+  WlzValues	val;
+  WlzIntervalDomain *iDom = NULL;
+  WlzIterateChunk *chk = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  dom.core = NULL;
+  val.core = NULL;
+  if((cWSp == NULL) || (part == NULL))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if((idx < 0) || (idx >= part->nChunk))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else
+  {
+    (void )memset(cWSp, 0, sizeof(WlzIterateChunkWSpace));
+    chk = part->chunk + idx;
+    cWSp->plane = chk->plane;
+    if(part->obj->type == WLZ_2D_DOMAINOBJ)
+    {
+      iDom = part->obj->domain.i;
+    }
+    else
+    {
+      iDom = part->obj->domain.p->domains[chk->plane -
+                                          part->obj->domain.p->plane1].i;
+    }
+    if(values.core != NULL)
+    {
+      if(WlzGreyTableIsTiled(values.core->type))
+      {
+	tiled = 1;
+	val = values;
+      }
+      else if(part->obj->type == WLZ_2D_DOMAINOBJ)
+      {
+	val = values;
+      }
+      else if(values.core->type != WLZ_VOXELVALUETABLE_GREY)
+      {
+	errNum = WLZ_ERR_VALUES_TYPE;
+      }
+      else if((chk->plane < values.vox->plane1) ||
+	      (chk->plane > values.vox->lastpl))
+      {
+	errNum = WLZ_ERR_VALUES_DATA;
+      }
+      else if((val = values.vox->values[chk->plane -
+	                                values.vox->plane1]).core == NULL)
+      {
+	errNum = WLZ_ERR_VALUES_NULL;
+      }
+    }
+  }
+  /* Make an interval domain for just the lines of the chunk, sharing the
+   * intervals of the partitioned object's domain. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    dom.i = WlzMakeIntervalDomain(iDom->type, chk->line1, chk->lastln,
+				  iDom->kol1, iDom->lastkl, &errNum);
+    if((errNum == WLZ_ERR_NONE) && (iDom->type == WLZ_INTERVALDOMAIN_INTVL))
+    {
+      (void )memcpy(dom.i->intvlines,
+                    iDom->intvlines + chk->line1 - iDom->line1,
+		    sizeof(WlzIntervalLine) * (chk->lastln - chk->line1 + 1));
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    cWSp->obj2D = WlzAssignObject(
+		  WlzMakeMain(WLZ_2D_DOMAINOBJ, dom, val, NULL, NULL,
+		              &errNum), NULL);
+    if(errNum != WLZ_ERR_NONE)
+    {
+      (void )WlzFreeDomain(dom);
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(val.core != NULL)
+    {
+      if((errNum = WlzInitGreyScan(cWSp->obj2D, &(cWSp->iWSp),
+                                   &(cWSp->gWSp))) == WLZ_ERR_NONE)
+      {
+	cWSp->grey = 1;
+	if(tiled)
+	{
+	  cWSp->iWSp.plnpos = chk->plane;
+	}
+      }
+    }
+    else
+    {
+      errNum = WlzInitRasterScan(cWSp->obj2D, &(cWSp->iWSp),
+                                 WLZ_RASTERDIR_ILIC);
+    }
+    if(errNum != WLZ_ERR_NONE)
+    {
+      (void )WlzFreeObj(cWSp->obj2D);
+      cWSp->obj2D = NULL;
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code, WLZ_ERR_EOO when there are no more
+* 		intervals in the chunk.
+* \ingroup	WlzDomainOps
+* \brief	Moves on to the next interval of the chunk for which the
+* 		given workspace was initialised. The interval (and grey
+* 		values if the workspace was initialised with values) are
+* 		then available through the workspace's interval and grey
+* 		workspaces just as for WlzNextGreyInterval().
+* \param	cWSp			Given chunk workspace.
+*/
+WlzErrorNum	WlzIterateChunkNext(WlzIterateChunkWSpace *cWSp)
+{
+  WlzErrorNum	errNum;
+
+  if((cWSp == NULL) || (cWSp->obj2D == NULL))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if(cWSp->grey)
+  {
+    errNum = WlzNextGreyInterval(&(cWSp->iWSp));
+  }
+  else
+  {
+    errNum = WlzNextInterval(&(cWSp->iWSp));
+  }
+  return(errNum);
+}
+
+/*!
+* \ingroup	WlzDomainOps
+* \brief	Ends the scan of a chunk, flushing any buffered values
+* 		and freeing the chunk's 2D object.
+* \param	cWSp			Given chunk workspace.
+*/
+void		WlzIterateChunkEnd(WlzIterateChunkWSpace *cWSp)
+{
+  if(cWSp)
+  {
+    if(cWSp->grey)
+    {
+      (void )WlzEndGreyScan(&(cWSp->iWSp), &(cWSp->gWSp));
+      cWSp->grey = 0;
+    }
+    (void )WlzFreeObj(cWSp->obj2D);
+    cWSp->obj2D = NULL;
+  }
+}
+
 /*!
 * \return	New iteration workspace data structure.
 * \ingroup	WlzDomainOps
@@ -52,7 +52,9 @@ static char _WlzKrig_c[] = "University of Edinburgh $Id$";
 * 		then for each position to be interpolated with this
 * 		model (ie all positions where the model is valid)
 * 		WlzKrigOSetPosSV2D() should be called followed by
-* 		WlzKrigOWeightsSolve().
+* 		WlzKrigOWeightsSolve(). When many positions share the
+* 		same model their position semi-variograms may be solved
+* 		for together using WlzKrigOWeightsSolveN().
 *
 * 		For a simple system in which there are \f$N\f$ known values
 * 		\f$\{v_i\}\f$ at positions \f$\{p_i\}\f$ (\f$i \in [1-N]\f$)
@@ -556,6 +558,57 @@ WlzErrorNum	WlzKrigOWeightsSolve(AlgMatrix modelSV, double *posSV,
   return(errNum);
 }
 
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzValuesUtils
+* \brief	Computes the ordinary kriging weights for many positions
+* 		which share the same model semi-variogram. The model
+* 		semi-variogram is decomposed once by WlzKrigOSetModelSV2D()
+* 		or WlzKrigOSetModelSV3D() and then each of the position
+* 		semi-variograms is solved for using this decomposition,
+* 		see WlzKrigOWeightsSolve().
+* \param	modelSV			Valid \f$(n + 1)\times(n + 1)\f$
+* 					matrix containing the model
+* 					semi-variogram.
+* \param	nPos			Number of positions.
+* \param	posSV			Array of nPos \f$(n + 1)\f$ column
+* 					vectors, stored one after another,
+* 					containing the position
+* 					semi-variograms and on return
+* 					containing the weights.
+* \param	wSp			Workspace for AlgMatrixLUBackSub()
+* 					with space for modelSV.core->nR
+* 					values.
+* \param	eps			Epsilon value used to test for
+* 					position semi-variogram value zero.
+*/
+WlzErrorNum	WlzKrigOWeightsSolveN(AlgMatrix modelSV, int nPos,
+				      double *posSV, int *wSp, double eps)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((modelSV.core == NULL) || (wSp == NULL) || (posSV == NULL))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if(nPos < 0)
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else
+  {
+    int		idP,
+    		n;
+
+    n = modelSV.core->nR;
+    for(idP = 0; (errNum == WLZ_ERR_NONE) && (idP < nPos); ++idP)
+    {
+      errNum = WlzKrigOWeightsSolve(modelSV, posSV + (idP * n), wSp, eps);
+    }
+  }
+  return(errNum);
+}
+
 /*!
 * \return	Woolz error code.
 * \ingroup	WlzValuesUtils
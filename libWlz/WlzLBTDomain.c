@@ -1373,8 +1373,10 @@ WlzErrorNum	WlzLBTBalanceDomain2D(WlzLBTDomain2D *lDom,
 * \ingroup	WlzDomainOps
 * \brief	Balances the given LBT domain so that the neighbouring
 *		nodes of each node are either of the same size or differ
-*		in size by a ratio of 2:1. The function also enforces
-*		maximum node size for all nodes and boundary nodes.
+*		in size by a ratio of 2:1, with the neighbours including
+*		nodes which share only an edge or a vertex. The function
+*		also enforces maximum node size for all nodes and boundary
+*		nodes.
 *		The neighbour finding algorithm used is quick and
 *		simple but it requires an object in which the values
 *		are set to the corresponding LBT domain indices.
@@ -2079,19 +2081,19 @@ void		WlzLBTClassifyNodeFace3D(WlzLBTDomain3D *lDom,
 				     WlzLBTNodeClass2D *dstCls,
 				     int *dstRot)
 {
-  int		idE,
+  int		idA,
+  		idE,
 		idO,
+		idP,
 		idNN,
 		nSz,
-		nNSz,
-		sSz;
+		sgn;
   unsigned	msk;
-  WlzDVertex3	off,
-  		pos;
-  const int 	offTbl0[6][3] = /* Offsets from 1st vertex of cube faces
-  				 * to neighbours. These are small
-				 * offsets to ensure the correct
-				 * neighbouring face is located. */
+  WlzIBox3	nBB;
+  int		alg[3],
+  		edg[3],
+		pos[3];
+  const int 	offTbl0[6][3] = /* Outward normals of the cube faces. */
      {
        { 0, -1,  0},
        { 0,  0, -1},
@@ -2100,12 +2102,13 @@ void		WlzLBTClassifyNodeFace3D(WlzLBTDomain3D *lDom,
        {-1,  0,  0},
        { 0,  1,  0}
      };
-  const	int	offTbl1[6][2][3] = /* Offsets from 1st vertex of cube faces
-				    * to neighbours. These are multiples
-				    * of the current cube size, with
-				    * all as defined in the function
+  const	int	offTbl1[6][2][3] = /* Directions from the centre of the
+				    * cube faces to the edges of the face,
+				    * as defined in the function
 				    * WlzCMeshFromBalLBTDom3D() for o1 and
-				    * o2, o3 = -o1 and o4 = -o2. */
+				    * o2, o3 = -o1 and o4 = -o2. Edge mask
+				    * bit i is for the edge in direction
+				    * o(i + 1). */
      {
        /*     o1            o2   */
        {{ 1,  0,  0}, { 0,  0,  1}},
@@ -2125,58 +2128,55 @@ void		WlzLBTClassifyNodeFace3D(WlzLBTDomain3D *lDom,
   }
   else
   {
-    /* First check the size of the neighbour which shares the current face.
-     * If the neighbour is smaller than the current node or the node is on
-     * the outer boundary, then set the flags for all it's edges, ie set
-     * the mask value to 0xf. */
-    off.vtX = offTbl0[idF][0];
-    off.vtY = offTbl0[idF][1];
-    off.vtZ = offTbl0[idF][2];
-    WLZ_VTX_3_ADD(pos, vtx[idF], off);
-    WlzGreyValueGet(iGVWSp, pos.vtZ, pos.vtY, pos.vtX);
-    if(iGVWSp->bkdFlag)
-    {
-      msk = 0xf;
-    }
-    else
+    /* An edge of the face is split if any of the voxels which share
+     * the edge with the node's own voxels (across the face, across the
+     * adjacent face and diagonally across the edge) is in a smaller
+     * LBT node. Because the LBT domain is balanced these need only be
+     * checked at the start and the middle of the edge. This test depends
+     * only on the edge and not on which of the cubes sharing it is being
+     * classified, so neighbouring cubes agree on the split edges and the
+     * mesh is conforming. */
+    nBB.xMin = WLZ_NINT(vtx[0].vtX);
+    nBB.yMin = WLZ_NINT(vtx[0].vtY);
+    nBB.zMin = WLZ_NINT(vtx[0].vtZ);
+    nBB.xMax = WLZ_NINT(vtx[1].vtX) - 1;
+    nBB.yMax = WLZ_NINT(vtx[5].vtY) - 1;
+    nBB.zMax = WLZ_NINT(vtx[2].vtZ) - 1;
+    for(idE = 0; idE < 4; ++idE)
     {
-      idNN = *(iGVWSp->gPtr[0].inp);
-      if(idNN >= 0)
+      idO = idE % 2;
+      sgn = (idE > 1)? -1: 1;
+      for(idA = 0; idA < 3; ++idA)
       {
-        nNSz = WlzLBTNodeSz3D(lDom->nodes + idNN);
-	if(nNSz < nSz)
-	{
-	  msk = 0xf;
-	}
+        edg[idA] = offTbl1[idF][idO][idA] * sgn;
+	alg[idA] = (edg[idA] == 0) && (offTbl0[idF][idA] == 0);
       }
-    }
-    /* If mask not set because of smaller node abutting face then check
-     * the neighbours which share the edges of the given face. */
-    if(msk == 0)
-    {
-      for(idE = 0; idE < 4; ++idE)
+      pos[0] = ((offTbl0[idF][0] > 0) || (edg[0] > 0))? nBB.xMax: nBB.xMin;
+      pos[1] = ((offTbl0[idF][1] > 0) || (edg[1] > 0))? nBB.yMax: nBB.yMin;
+      pos[2] = ((offTbl0[idF][2] > 0) || (edg[2] > 0))? nBB.zMax: nBB.zMin;
+      for(idP = 0; idP < 8; ++idP)
       {
-	idO = (idE + 1) % 2;
-	sSz = (idE > 1)? -nSz: nSz;
-        off.vtX = offTbl1[idF][idO][0] * sSz;
-	off.vtY = offTbl1[idF][idO][1] * sSz;
-	off.vtZ = offTbl1[idF][idO][2] * sSz;
-	WLZ_VTX_3_ADD(pos, vtx[idF], off);
-	WlzGreyValueGet(iGVWSp, pos.vtZ, pos.vtY, pos.vtX);
-	if(iGVWSp->bkdFlag)
+	int	nrmP,
+		edgP,
+		algP;
+
+	nrmP = idP & 1;
+	edgP = (idP >> 1) & 1;
+	algP = (idP >> 2) * nSz / 2;
+	if(nrmP || edgP)
 	{
-	  msk |= 1 << idE;
-	}
-	else
-	{
-	  idNN = *(iGVWSp->gPtr[0].inp);
-	  if(idNN >= 0)
+	  WlzGreyValueGet(iGVWSp,
+	       pos[2] + (nrmP * offTbl0[idF][2]) + (edgP * edg[2]) +
+	       (algP * alg[2]),
+	       pos[1] + (nrmP * offTbl0[idF][1]) + (edgP * edg[1]) +
+	       (algP * alg[1]),
+	       pos[0] + (nrmP * offTbl0[idF][0]) + (edgP * edg[0]) +
+	       (algP * alg[0]));
+	  idNN = iGVWSp->gVal[0].inv;
+	  if((idNN >= 0) && (WlzLBTNodeSz3D(lDom->nodes + idNN) < nSz))
 	  {
-	    nNSz = WlzLBTNodeSz3D(lDom->nodes + idNN);
-	    if(nNSz < nSz)
-	    {
-	      msk |= 1 << idE;
-	    }
+	    msk |= 1 << idE;
+	    break;
 	  }
 	}
       }
@@ -2640,9 +2640,9 @@ static int	WlzLBTBndEdgNbrDirIdx3D(WlzLBTDomain3D *lDom,
       pZ = nBB.zMin;
       WlzGreyValueGet(iGVWSp, pZ, pY, pX);
       isBnd = iGVWSp->gVal[0].inv < 0;
-      while(!isBnd && (++pZ <= nBB.zMax))
+      for(pZ = nBB.zMin; !isBnd && (pZ <= nBB.zMax); ++pZ)
       {
-	while(!isBnd && (++pY <= nBB.yMax))
+	for(pY = nBB.yMin; !isBnd && (pY <= nBB.yMax); ++pY)
 	{
 	  WlzGreyValueGet(iGVWSp, pZ, pY, pX);
 	  isBnd = iGVWSp->gVal[0].inv < 0;
@@ -2656,9 +2656,9 @@ static int	WlzLBTBndEdgNbrDirIdx3D(WlzLBTDomain3D *lDom,
       pZ = nBB.zMin;
       WlzGreyValueGet(iGVWSp, pZ, pY, pX);
       isBnd = iGVWSp->gVal[0].inv < 0;
-      while(!isBnd && (++pZ <= nBB.zMax))
+      for(pZ = nBB.zMin; !isBnd && (pZ <= nBB.zMax); ++pZ)
       {
-	while(!isBnd && (++pX <= nBB.xMax))
+	for(pX = nBB.xMin; !isBnd && (pX <= nBB.xMax); ++pX)
 	{
 	  WlzGreyValueGet(iGVWSp, pZ, pY, pX);
 	  isBnd = iGVWSp->gVal[0].inv < 0;
@@ -2672,9 +2672,9 @@ static int	WlzLBTBndEdgNbrDirIdx3D(WlzLBTDomain3D *lDom,
       pZ = (dir == WLZ_DIRECTION_IP)? nBB.zMax + 1: nBB.zMin - 1;
       WlzGreyValueGet(iGVWSp, pZ, pY, pX);
       isBnd = iGVWSp->gVal[0].inv < 0;
-      while(!isBnd && (++pY <= nBB.yMax))
+      for(pY = nBB.yMin; !isBnd && (pY <= nBB.yMax); ++pY)
       {
-	while(!isBnd && (++pX <= nBB.xMax))
+	for(pX = nBB.xMin; !isBnd && (pX <= nBB.xMax); ++pX)
 	{
 	  WlzGreyValueGet(iGVWSp, pZ, pY, pX);
 	  isBnd = iGVWSp->gVal[0].inv < 0;
@@ -2769,7 +2769,11 @@ static int	WlzLBTMinLogSzEdgeDirNbrIdx2D(WlzLBTDomain2D *lDom,
 *		-ve if there is no neighbour.
 * \ingroup	WlzDomainOps
 * \brief	Finds the size of the smallest neighbouring node in the
-*		given direction in a 3D LBT.
+*		given direction in a 3D LBT. The neighbours include the
+*		nodes which only share an edge or a vertex with the
+*		node's face in the given direction, so that balancing
+*		the domain also balances these, as is required for a
+*		conforming mesh to be built from the domain.
 * \param	lDom			Given LBT domain.
 * \param	iGVWSp			Grey workspace for index object.
 * \param	idN			Index of node in the LBT domain.
@@ -2801,9 +2805,9 @@ static int	WlzLBTMinLogSzEdgeDirNbrIdx3D(WlzLBTDomain3D *lDom,
       WlzGreyValueGet(iGVWSp, pZ, pY, pX);
       id1 = iGVWSp->gVal[0].inv;
       minSz = sz = (id1 >= 0)? WlzLBTNodeLogSz3D(lDom->nodes + id1): -1;
-      while(++pZ <= nBB.zMax)
+      for(pZ = nBB.zMin - 1; pZ <= nBB.zMax + 1; ++pZ)
       {
-	while(++pY <= nBB.yMax)
+	for(pY = nBB.yMin - 1; pY <= nBB.yMax + 1; ++pY)
 	{
 	  id0 = id1;
 	  WlzGreyValueGet(iGVWSp, pZ, pY, pX);
@@ -2827,9 +2831,9 @@ static int	WlzLBTMinLogSzEdgeDirNbrIdx3D(WlzLBTDomain3D *lDom,
       WlzGreyValueGet(iGVWSp, pZ, pY, pX);
       id1 = iGVWSp->gVal[0].inv;
       minSz = sz = (id1 >= 0)? WlzLBTNodeLogSz3D(lDom->nodes + id1): -1;
-      while(++pZ <= nBB.zMax)
+      for(pZ = nBB.zMin - 1; pZ <= nBB.zMax + 1; ++pZ)
       {
-	while(++pX <= nBB.xMax)
+	for(pX = nBB.xMin - 1; pX <= nBB.xMax + 1; ++pX)
 	{
 	  id0 = id1;
 	  WlzGreyValueGet(iGVWSp, pZ, pY, pX);
@@ -2853,9 +2857,9 @@ static int	WlzLBTMinLogSzEdgeDirNbrIdx3D(WlzLBTDomain3D *lDom,
       WlzGreyValueGet(iGVWSp, pZ, pY, pX);
       id1 = iGVWSp->gVal[0].inv;
       minSz = sz = (id1 >= 0)? WlzLBTNodeLogSz3D(lDom->nodes + id1): -1;
-      while(++pY <= nBB.yMax)
+      for(pY = nBB.yMin - 1; pY <= nBB.yMax + 1; ++pY)
       {
-	while(++pX <= nBB.xMax)
+	for(pX = nBB.xMin - 1; pX <= nBB.xMax + 1; ++pX)
 	{
 	  id0 = id1;
 	  WlzGreyValueGet(iGVWSp, pZ, pY, pX);
@@ -3026,6 +3030,8 @@ static int	WlzLBTMaxLogSzEdgeDirNbrIdx2D(WlzLBTDomain2D *lDom,
 * \ingroup	WlzDomainOps
 * \brief	Finds a maximum sized neighbour in the given direction
 *		in the 3D LBT and then returns it's index and size.
+*		As in WlzLBTMinLogSzEdgeDirNbrIdx3D() the neighbours
+*		include those which only share an edge or a vertex.
 * \param	lDom			Given LBT domain.
 * \param	iGVWSp			Grey workspace for index object.
 * \param	idN			Index of node in the LBT domain.
@@ -3061,9 +3067,9 @@ static int	WlzLBTMaxLogSzEdgeDirNbrIdx3D(WlzLBTDomain3D *lDom,
       WlzGreyValueGet(iGVWSp, pZ, pY, pX);
       idM = id1 = iGVWSp->gVal[0].inv;
       szM = sz = (id1 >= 0)? WlzLBTNodeLogSz3D(lDom->nodes + id1): -1;
-      while(++pZ <= nBB.zMax)
+      for(pZ = nBB.zMin - 1; pZ <= nBB.zMax + 1; ++pZ)
       {
-	while(++pY <= nBB.yMax)
+	for(pY = nBB.yMin - 1; pY <= nBB.yMax + 1; ++pY)
 	{
 	  id0 = id1;
 	  WlzGreyValueGet(iGVWSp, pZ, pY, pX);
@@ -3088,9 +3094,9 @@ static int	WlzLBTMaxLogSzEdgeDirNbrIdx3D(WlzLBTDomain3D *lDom,
       WlzGreyValueGet(iGVWSp, pZ, pY, pX);
       idM = id1 = iGVWSp->gVal[0].inv;
       szM = sz = (id1 >= 0)? WlzLBTNodeLogSz3D(lDom->nodes + id1): -1;
-      while(++pZ <= nBB.zMax)
+      for(pZ = nBB.zMin - 1; pZ <= nBB.zMax + 1; ++pZ)
       {
-	while(++pX <= nBB.xMax)
+	for(pX = nBB.xMin - 1; pX <= nBB.xMax + 1; ++pX)
 	{
 	  id0 = id1;
 	  WlzGreyValueGet(iGVWSp, pZ, pY, pX);
@@ -3115,9 +3121,9 @@ static int	WlzLBTMaxLogSzEdgeDirNbrIdx3D(WlzLBTDomain3D *lDom,
       WlzGreyValueGet(iGVWSp, pZ, pY, pX);
       idM = id1 = iGVWSp->gVal[0].inv;
       szM = sz = (id1 >= 0)? WlzLBTNodeLogSz3D(lDom->nodes + id1): -1;
-      while(++pY <= nBB.yMax)
+      for(pY = nBB.yMin - 1; pY <= nBB.yMax + 1; ++pY)
       {
-	while(++pX <= nBB.xMax)
+	for(pX = nBB.xMin - 1; pX <= nBB.xMax + 1; ++pX)
 	{
 	  id0 = id1;
 	  WlzGreyValueGet(iGVWSp, pZ, pY, pX);
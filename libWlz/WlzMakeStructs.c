@@ -422,6 +422,7 @@ WlzMakeMain(WlzObjectType 	type,
     case WLZ_CMESH_2D5:
     case WLZ_CMESH_3D:
     case WLZ_CONV_HULL:
+    case WLZ_DISP_TRANS:
     case WLZ_EMPTY_OBJ:
     case WLZ_HISTOGRAM:
     case WLZ_LUT:
@@ -1929,6 +1930,10 @@ WlzObject	*WlzMakeCuboid(int plane1, int lastpl,
     (void )WlzFreeDomain(dom);
     (void )WlzFreeValues(val);
   }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
   return(obj);
 }
 
@@ -121,24 +121,15 @@ typedef struct _WlzMatchICPTPPair2D
 } WlzMatchICPTPPair2D;
 
 static WlzErrorNum		WlzMatchICPRegShellLst(
-				  AlcKDTTree *tTree,
-				  WlzGMModel *tGM,
+				  WlzMatchICPTarget *tgt,
 				  WlzGMModel *sGM,
 				  WlzMatchICPShellList *sLst,
 				  WlzAffineTransform *globTr,
 				  WlzTransformType trType,
-				  WlzVertexType vType,
-				  int sgnNrm,
-				  int nTV,
-				  WlzVertexP tVx,
-				  WlzVertexP tNr,
 				  int nSV,
 				  WlzVertexP sVx,
 				  WlzVertexP sNr,
-				  int *iBuf,
-				  WlzVertexP tVBuf,
-				  WlzVertexP sVBuf,
-				  double *wBuf,
+				  int maxVI,
 				  int maxItr,
 				  double maxDisp,
 				  double maxAng,
@@ -149,6 +140,28 @@ static WlzErrorNum		WlzMatchICPRegShellLst(
 				  void *usrWgtData,
 				  double delta,
 				  double minDistWgt);
+static WlzErrorNum		WlzMatchICPRegShellVec(
+				  WlzMatchICPTarget *tgt,
+				  int nShl,
+				  WlzGMShell **shl,
+				  WlzAffineTransform *globTr,
+				  WlzTransformType trType,
+				  int nSV,
+				  WlzVertexP sVx,
+				  WlzVertexP sNr,
+				  int maxVI,
+				  int maxItr,
+				  double maxDisp,
+				  double maxAng,
+				  double maxDeform,
+				  WlzAffineTransform *initTr,
+				  WlzRegICPUsrWgtFn usrWgtFn,
+				  void *usrWgtData,
+				  double delta,
+				  double minDistWgt,
+				  WlzAffineTransform **dstTr,
+				  int *dstConv,
+				  WlzErrorNum *dstErr);
 static WlzAffineTransform 	*WlzMatchICPRegModel(
 				  AlcKDTTree *tTree,
 				  WlzTransformType trType,
@@ -325,6 +338,8 @@ static int			WlzMatchICPDblSortFnD(
 				  int *idx,
 				  int id0,
 				  int id1);
+static double			WlzMatchICPRandUniform(
+				  unsigned int *seed);
 static double			WlzMatchICPWeightMatches2D(
 				  WlzAffineTransform *curTr,
 				  AlcKDTTree *tree,
@@ -525,6 +540,110 @@ WlzErrorNum	WlzMatchICPObjs(WlzObject *tObj, WlzObject *sObj,
   return(errNum);
 }
 
+/*!
+* \return	Error code.
+* \ingroup	WlzTransform
+* \brief	Establishes matching points in two contours using ICP
+*		based registration algorithm. The object types and
+*		domains are checked as in WlzMatchICPObjs() but the
+*		target is given as a previously built matching target
+*		(see WlzMatchICPTargetNew()), which allows the target's
+*		kD-tree to be reused when matching many source objects
+*		to the same target.
+*		If the source object is a contour then it's model is
+*		modified in place. The target is not modified.
+* \param	tgt			The matching target.
+* \param	sObj			The source object to be
+*					matched with target.
+* \param	initTr			Initial affine transform
+*					to be applied to the source
+*					object prior to matching. May
+*					be NULL.
+* \param	dstNMatch		Destination pointer for the number
+*					of match points found. Required.
+* \param	dstTMatch		Destination pointer for the target
+*					match points found. Required.
+* \param	dstSMatch		Destination pointer for the source
+*					match points found. Required.
+* \param	maxItr			Maximum number of iterations.
+* \param	minSpx			Minimum number of simplicies in
+*					a contour shell for matching.
+* \param	minSegSpx		Minimum number of simplices per
+*					matched shell segment.
+* \param	brkFlg			Controls the breaking of the source
+*					shells, see WlzMatchICPObjs().
+* \param	maxDisp			The maximum displacement to the
+* 					geometry of a shell, from the global
+*					affine transformed position for
+*					an acceptable registration.
+* \param	maxAng			The maximum angle of rotation of a
+* 					shell geometry with respect to the
+* 					global affine transformed geometry for
+* 					an acceptable registration.
+* \param	maxDeform		The maximum deformation to the geometry
+* 					of a shell, from the global affine
+* 					transformed geometry, for an acceptable
+* 					registration.
+* \param	matchImpNN		Number match points in neighbourhood
+*					when removing implausible match
+*					points, must be \f$> 2\f$.
+* \param	matchImpThr		Implausibility threshold which should
+*					be \f$> 0\f$.
+* \param	delta			Tolerance for mean value of
+*					registration metric.
+*/
+WlzErrorNum	WlzMatchICPObjsTgt(WlzMatchICPTarget *tgt, WlzObject *sObj,
+				WlzAffineTransform *initTr,
+				int *dstNMatch, WlzVertexP *dstTMatch,
+				WlzVertexP *dstSMatch, int maxItr,
+				int minSpx, int minSegSpx, int brkFlg,
+				double maxDisp, double maxAng, 
+				double maxDeform,
+				int matchImpNN, double matchImpThr,
+				double delta)
+{
+  WlzMatchICPWeightCbData cbData;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const int	nScatter = 5;
+
+  if((tgt == NULL) || (sObj == NULL))
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if(sObj->type != WLZ_CONTOUR)
+  {
+    errNum = WLZ_ERR_OBJECT_TYPE;
+  }
+  else if((sObj->domain.core == NULL) || (sObj->domain.ctr->model == NULL))
+  {
+    errNum = WLZ_ERR_DOMAIN_NULL;
+  }
+  else if((dstNMatch == NULL) || (dstTMatch == NULL) || (dstSMatch == NULL))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if(tgt->model->type != sObj->domain.ctr->model->type)
+  {
+    errNum = WLZ_ERR_DOMAIN_TYPE;
+  }
+  else
+  {
+    /* Set up weighting function callback data. */
+    cbData.tGM = tgt->model;
+    cbData.sGM = sObj->domain.ctr->model;
+    cbData.maxDisp = maxDisp;
+    cbData.nScatter = nScatter;
+    errNum = WlzMatchICPCtrTgt(tgt, sObj->domain.ctr,
+			       initTr, maxItr, minSpx, minSegSpx,
+			       dstNMatch, dstTMatch, dstSMatch, brkFlg,
+			       maxDisp, maxAng, maxDeform,
+			       matchImpNN, matchImpThr,
+			       WlzMatchICPWeightMatches, &cbData,
+			       delta);
+  }
+  return(errNum);
+}
+
 /*!
 * \return	Error code.
 * \ingroup	WlzTransform
@@ -533,6 +652,11 @@ WlzErrorNum	WlzMatchICPObjs(WlzObject *tObj, WlzObject *sObj,
 *		checked so that their models are neither NULL or
 *		of different types.
 *		The source contour's model is modified in place.
+*		This function builds a matching target from the target
+*		contour and then calls WlzMatchICPCtrTgt(), when the
+*		same target contour is to be matched to several source
+*		contours it is more efficient to build the target once
+*		and call WlzMatchICPCtrTgt() directly.
 * \param	tCtr			The target contour.
 * \param	sCtr			The source contour to be
 *					matched with target contour.
@@ -606,14 +730,107 @@ WlzErrorNum  	WlzMatchICPCtr(WlzContour *tCtr, WlzContour *sCtr,
 			       int matchImpNN, double matchImpThr,
 			       WlzRegICPUsrWgtFn usrWgtFn, void *usrWgtData,
 			       double delta)
+{
+  WlzMatchICPTarget *tgt = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((tCtr == NULL) || (sCtr == NULL) ||
+     (tCtr->model == NULL) || (sCtr->model == NULL))
+  {
+    errNum = WLZ_ERR_DOMAIN_NULL;
+  }
+  else if(tCtr->model->type != sCtr->model->type)
+  {
+    errNum = WLZ_ERR_DOMAIN_TYPE;
+  }
+  else
+  {
+    tgt = WlzMatchICPTargetNew(tCtr, minSpx, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = WlzMatchICPCtrTgt(tgt, sCtr, initTr, maxItr, minSpx, minSegSpx,
+			       dstNMatch, dstTMatch, dstSMatch, brkFlg,
+			       maxDisp, maxAng, maxDeform,
+			       matchImpNN, matchImpThr,
+			       usrWgtFn, usrWgtData, delta);
+  }
+  (void )WlzMatchICPTargetFree(tgt);
+  return(errNum);
+}
+
+/*!
+* \return	Error code.
+* \ingroup	WlzTransform
+* \brief	Establishes matching points between the given matching
+*		target and a source contour using ICP based registration.
+*		The source contour's model is modified in place, but
+*		the target is only read so a single target may be used
+*		for many (possibly concurrent) matches.
+*		The source shells are registered to the target
+*		concurrently when OpenMP is enabled, in which case the
+*		user supplied weighting function must be reentrant.
+* \param	tgt			The matching target built by
+*					WlzMatchICPTargetNew().
+* \param	sCtr			The source contour to be
+*					matched with target.
+* \param	initTr			Initial affine transform
+*					to be applied to the source
+*					object prior to matching. May
+*					be NULL.
+* \param	maxItr			Maximum number of iterations.
+* \param	minSpx			Minimum number of simplicies in
+*					a contour shell for matching.
+* \param	minSegSpx		Minimum number of simplices per
+*					matched shell segment, with a tie
+*					point pair possibly being generated
+*					for each matched shell segment.
+* \param	dstNMatch		Destination pointer for the number
+*					of match points found.
+* \param	dstTMatch		Destination pointer for the target
+*					match points found.
+* \param	dstSMatch		Destination pointer for the source
+*					match points found.
+* \param	brkFlg			Controls the breaking of the source
+*					shells, see WlzMatchICPCtr().
+* \param	maxDisp			The maximum displacement to the
+* 					geometry of a shell for an acceptable
+* 					registration.
+* \param	maxAng			The maximum angle of rotation of a
+* 					shell geometry with respect to the
+* 					global affine transformed geometry for
+* 					an acceptable registration.
+* \param	maxDeform		The maximum deformation to the geometry
+* 					of a shell for an acceptable
+* 					registration.
+* \param	matchImpNN		Number match points in neighbourhood
+*					when removing implausible match
+*					points, must be \f$> 2\f$.
+* \param	matchImpThr		Implausibility threshold which should
+*					be \f$> 0\f$.
+* \param	usrWgtFn		User supplied weighting function.
+* \param	usrWgtData		User supplied weighting data.
+* \param	delta			Tolerance for mean value of
+*					registration metric.
+*/
+WlzErrorNum  	WlzMatchICPCtrTgt(WlzMatchICPTarget *tgt, WlzContour *sCtr,
+			       WlzAffineTransform *initTr,
+			       int maxItr, int minSpx, int minSegSpx,
+			       int *dstNMatch, WlzVertexP *dstTMatch,
+			       WlzVertexP *dstSMatch, int brkFlg,
+			       double  maxDisp, double maxAng,
+			       double maxDeform,
+			       int matchImpNN, double matchImpThr,
+			       WlzRegICPUsrWgtFn usrWgtFn, void *usrWgtData,
+			       double delta)
 {
   int		idS,
 		n0,
 		n1,
   		nTV,
   		nSV,
+		nShl,
 		maxVI,
-		maxTVI,
 		maxSVI,
 		brkIdx,
 		nOSS = 0,
@@ -622,7 +839,8 @@ WlzErrorNum  	WlzMatchICPCtr(WlzContour *tCtr, WlzContour *sCtr,
 		nMatch = 0,
   	 	dbgFlg = 0;
   size_t	vSz = 0;
-  int		*vIBuf = NULL;
+  int		*vIBuf = NULL,
+  		*shlConv = NULL;
   double	*wBuf = NULL;
   WlzGMModel	*tGM = NULL,
   		*sGM = NULL;
@@ -632,14 +850,15 @@ WlzErrorNum  	WlzMatchICPCtr(WlzContour *tCtr, WlzContour *sCtr,
 		sNr,
 		tVBuf,
 		sVBuf;
-  WlzVertexType	vType,
-  		tVType;
+  WlzVertexType	vType;
   WlzTransformType trType;
   AlcKDTTree	*tTree = NULL;
   WlzAffineTransform *tTr,
   		*globTr = NULL;
-  WlzGMShell 	*cSS,
-  		*nSS;
+  WlzAffineTransform **shlTr = NULL;
+  WlzGMShell 	*cSS;
+  WlzGMShell	**shlBuf = NULL;
+  WlzErrorNum	*shlErr = NULL;
   WlzMatchICPShell *sMS,
   		*sMSBuf = NULL;
   WlzMatchICPShellListElm *lElm0,
@@ -653,56 +872,38 @@ WlzErrorNum  	WlzMatchICPCtr(WlzContour *tCtr, WlzContour *sCtr,
   				 * output. */
 
   tVBuf.v = sVBuf.v = NULL;
-  tVx.v = tNr.v = sVx.v = sNr.v = NULL;
-  if((tCtr == NULL) || (sCtr == NULL) ||
-     ((tGM = tCtr->model) == NULL) || ((sGM = sCtr->model) == NULL))
+  sVx.v = sNr.v = NULL;
+  if((tgt == NULL) || (sCtr == NULL) || ((sGM = sCtr->model) == NULL))
   {
     errNum = WLZ_ERR_DOMAIN_NULL;
   }
-  else if(tGM->type != sGM->type)
+  else if(tgt->model->type != sGM->type)
   {
     errNum = WLZ_ERR_DOMAIN_TYPE;
   }
   else
   {
-    switch(tGM->type)
-    {
-      case WLZ_GMMOD_2I: /* FALLTHROUGH */
-      case WLZ_GMMOD_2D: /* FALLTHROUGH */
-      case WLZ_GMMOD_3I: /* FALLTHROUGH */
-      case WLZ_GMMOD_3D:
-        break;
-      case WLZ_GMMOD_2N: /* FALLTHROUGH */
-      case WLZ_GMMOD_3N:
-        sgnNrm = 1;
-	break;
-      default:
-        errNum = WLZ_ERR_DOMAIN_TYPE;
-	break;
-    }
-  }
-  /* Remove small shells from the models. */
-  if(errNum == WLZ_ERR_NONE)
-  {
-    errNum = WlzGMFilterRmSmShells(tGM, minSpx);
+    tGM = tgt->model;
+    tTree = tgt->tree;
+    nTV = tgt->nVx;
+    tVx = tgt->vx;
+    tNr = tgt->nr;
+    sgnNrm = tgt->sgnNrm;
   }
+  /* Remove small shells from the source model. */
   if(errNum == WLZ_ERR_NONE)
   {
     errNum = WlzGMFilterRmSmShells(sGM, minSpx);
   }
-  /* Get the vertices and normals from the target and source models. */
-  if(errNum == WLZ_ERR_NONE)
-  {
-    tVx = WlzVerticesFromGM(tCtr->model, &tNr, NULL, &nTV, &tVType, &errNum);
-  }
+  /* Get the vertices and normals from the source model. */
   if(errNum == WLZ_ERR_NONE)
   {
     sVx = WlzVerticesFromGM(sCtr->model, &sNr, NULL, &nSV, &vType, &errNum);
-    if(tVType != vType)
+    if(tgt->vType != vType)
     {
       errNum = WLZ_ERR_DOMAIN_TYPE;
     }
-    else if((nTV <= 0) || (nSV <= 0))
+    else if(nSV <= 0)
     {
       errNum = WLZ_ERR_DOMAIN_DATA;
     }
@@ -737,9 +938,8 @@ WlzErrorNum  	WlzMatchICPCtr(WlzContour *tCtr, WlzContour *sCtr,
   if(errNum == WLZ_ERR_NONE)
   {
     nOSS = (int )(sGM->res.shell.numElm);
-    maxTVI = (int )(tGM->res.vertex.numIdx);
     maxSVI = (int )(sGM->res.vertex.numIdx);
-    maxVI = WLZ_MAX(maxSVI, maxTVI);
+    maxVI = WLZ_MAX(maxSVI, tgt->maxVI);
     if(((vIBuf = (int *)AlcMalloc(maxVI * sizeof(int))) == NULL) ||
        ((tVBuf.v = AlcMalloc((size_t )maxVI * vSz)) == NULL) ||
        ((sVBuf.v = AlcMalloc((size_t )maxVI * vSz)) == NULL) ||
@@ -751,11 +951,6 @@ WlzErrorNum  	WlzMatchICPCtr(WlzContour *tCtr, WlzContour *sCtr,
       errNum = WLZ_ERR_MEM_ALLOC;
     }
   }
-  /* Build a kD-tree from the vertices of the the model. */
-  if(errNum == WLZ_ERR_NONE)
-  {
-    tTree = WlzVerticesBuildTree(vType, nTV, tVx, vIBuf, &errNum);
-  }
   /* Register the vertices of the source model to those of the target. */
   if(errNum == WLZ_ERR_NONE)
   {
@@ -781,40 +976,71 @@ WlzErrorNum  	WlzMatchICPCtr(WlzContour *tCtr, WlzContour *sCtr,
   }
   /* Register each of the shells of the source model to the target model,
    * deleting any shells which fail to register from the source model and
-   * putting all registered shells into match shell entries. */
+   * putting all registered shells into match shell entries. The shells
+   * are registered concurrently and then the failed shells are deleted
+   * in their original order. */
   if((errNum == WLZ_ERR_NONE) && (nOSS > 0) && (brkFlg > 0))
   {
-    nOSS = 0;
-    sMS = sMSBuf;
-    cSS = sGM->child;
-    do
+    if(((shlBuf = (WlzGMShell **)
+    		  AlcMalloc(nOSS * sizeof(WlzGMShell *))) == NULL) ||
+       ((shlTr = (WlzAffineTransform **)
+		 AlcCalloc(nOSS, sizeof(WlzAffineTransform *))) == NULL) ||
+       ((shlConv = (int *)AlcCalloc(nOSS, sizeof(int))) == NULL) ||
+       ((shlErr = (WlzErrorNum *)
+		  AlcCalloc(nOSS, sizeof(WlzErrorNum))) == NULL))
     {
-      tTr = WlzAssignAffineTransform(
-            WlzMatchICPRegShell(tTree, tGM, cSS, globTr, trType,
-	    			vType, sgnNrm,
-			        nTV, tVx, tNr, nSV, sVx, sNr,
-			        vIBuf, tVBuf, sVBuf, wBuf,
-			        maxItr, maxDisp, maxAng, maxDeform,
-				globTr, &convFlg,
-				usrWgtFn, usrWgtData,
-				delta, 0.0, &errNum), NULL);
-      nSS = cSS->next;
-      if((errNum == WLZ_ERR_NONE) && (convFlg == 1))
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      nShl = 0;
+      cSS = sGM->child;
+      do
       {
-	++nOSS;
-        sMS->tr = tTr;
-	sMS->shell = cSS;
-	sMS->size = WlzGMShellSimplexCnt(cSS);
-	++sMS;
-      }
-      else
+        *(shlBuf + nShl++) = cSS;
+	cSS = cSS->next;
+      } while((nShl < nOSS) && (cSS != sGM->child));
+      errNum = WlzMatchICPRegShellVec(tgt, nShl, shlBuf, globTr, trType,
+				      nSV, sVx, sNr, maxVI, maxItr,
+				      maxDisp, maxAng, maxDeform, globTr,
+				      usrWgtFn, usrWgtData, delta, 0.0,
+				      shlTr, shlConv, shlErr);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      idS = 0;
+      nOSS = 0;
+      sMS = sMSBuf;
+      do
       {
-        errNum = WlzGMModelDeleteS(sGM, cSS);
+	cSS = *(shlBuf + idS);
+	tTr = *(shlTr + idS);
+	*(shlTr + idS) = NULL;
+	if((*(shlErr + idS) == WLZ_ERR_NONE) && (*(shlConv + idS) == 1))
+	{
+	  ++nOSS;
+	  sMS->tr = tTr;
+	  sMS->shell = cSS;
+	  sMS->size = WlzGMShellSimplexCnt(cSS);
+	  ++sMS;
+	}
+	else
+	{
+	  (void )WlzFreeAffineTransform(tTr);
+	  errNum = WlzGMModelDeleteS(sGM, cSS);
+	}
+      } while((errNum == WLZ_ERR_NONE) && (++idS < nShl));
+      for(idS = 0; idS < nShl; ++idS)
+      {
+        (void )WlzFreeAffineTransform(*(shlTr + idS));
       }
-      cSS = nSS;
-    } while((errNum == WLZ_ERR_NONE) && cSS &&
-            sGM->child && (cSS != sGM->child));
+    }
+    AlcFree(shlBuf);
+    AlcFree(shlTr);
+    AlcFree(shlConv);
+    AlcFree(shlErr);
   }
+
   /* If only registering whole source shells to whole target model
    * then transform each of the source shells using the associated
    * transform. */
@@ -886,9 +1112,8 @@ WlzErrorNum  	WlzMatchICPCtr(WlzContour *tCtr, WlzContour *sCtr,
 	     * those which are above the size threshold to the target
 	     * model and removing any small shells or shells that do not
 	     * register from both the list and the source model. */
-	    errNum = WlzMatchICPRegShellLst(tTree, tGM, sGM, dSList, globTr,
-		trType, vType, sgnNrm, nTV, tVx, tNr, nSV, sVx, sNr,
-		vIBuf, tVBuf, sVBuf, wBuf, maxItr,
+	    errNum = WlzMatchICPRegShellLst(tgt, sGM, dSList, globTr,
+		trType, nSV, sVx, sNr, maxVI, maxItr,
 		maxDisp, maxAng, maxDeform, minSpx, tTr,
 		usrWgtFn, usrWgtData, delta, 0.0);
 	  }
@@ -950,9 +1175,8 @@ WlzErrorNum  	WlzMatchICPCtr(WlzContour *tCtr, WlzContour *sCtr,
 	   * those which are above the size threshold to the target
 	   * model and removing any small shells or shells that do not
 	   * register from both the list and the source model. */
-	  errNum = WlzMatchICPRegShellLst(tTree, tGM, sGM, dSList, globTr,
-	      trType, vType, sgnNrm, nTV, tVx, tNr, nSV, sVx, sNr,
-	      vIBuf, tVBuf, sVBuf, wBuf, maxItr,
+	  errNum = WlzMatchICPRegShellLst(tgt, sGM, dSList, globTr,
+	      trType, nSV, sVx, sNr, maxVI, maxItr,
 	      maxDisp, maxAng, maxDeform, minSpx, tTr,
 	      usrWgtFn, usrWgtData, delta, 0.0);
 	}
@@ -1051,16 +1275,132 @@ WlzErrorNum  	WlzMatchICPCtr(WlzContour *tCtr, WlzContour *sCtr,
   AlcFree(sMSBuf);
   AlcFree(vIBuf);
   AlcFree(wBuf);
-  AlcFree(tVx.v);
-  AlcFree(tNr.v);
   AlcFree(sVx.v);
   AlcFree(sNr.v);
   (void )WlzFreeAffineTransform(globTr);
-  (void )AlcKDTTreeFree(tTree);
 
   return(errNum);
 }
 
+/*!
+* \return	New matching target or NULL on error.
+* \ingroup	WlzTransform
+* \brief	Builds a matching target from the given target contour
+*		for use with WlzMatchICPObjsTgt() or WlzMatchICPCtrTgt().
+*		Small shells are removed from the contour's model (which
+*		is modified in place), the model's vertices and normals
+*		are extracted and a kD-tree is built from the vertices.
+*		The target holds a link to the contour's model and
+*		should be freed using WlzMatchICPTargetFree().
+* \param	tCtr			The target contour.
+* \param	minSpx			Minimum number of simplicies in
+*					a contour shell for matching.
+* \param	dstErr			Destination error pointer,
+*					may be NULL.
+*/
+WlzMatchICPTarget *WlzMatchICPTargetNew(WlzContour *tCtr, int minSpx,
+					WlzErrorNum *dstErr)
+{
+  int		*shfBuf = NULL;
+  WlzGMModel	*tGM = NULL;
+  WlzMatchICPTarget *tgt = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((tCtr == NULL) || ((tGM = tCtr->model) == NULL))
+  {
+    errNum = WLZ_ERR_DOMAIN_NULL;
+  }
+  else if((tgt = (WlzMatchICPTarget *)
+  		 AlcCalloc(1, sizeof(WlzMatchICPTarget))) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    switch(tGM->type)
+    {
+      case WLZ_GMMOD_2I: /* FALLTHROUGH */
+      case WLZ_GMMOD_2D: /* FALLTHROUGH */
+      case WLZ_GMMOD_3I: /* FALLTHROUGH */
+      case WLZ_GMMOD_3D:
+        break;
+      case WLZ_GMMOD_2N: /* FALLTHROUGH */
+      case WLZ_GMMOD_3N:
+        tgt->sgnNrm = 1;
+	break;
+      default:
+        errNum = WLZ_ERR_DOMAIN_TYPE;
+	break;
+    }
+  }
+  /* Remove small shells from the model. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    tgt->model = WlzAssignGMModel(tGM, NULL);
+    tgt->minSpx = minSpx;
+    errNum = WlzGMFilterRmSmShells(tGM, minSpx);
+  }
+  /* Get the vertices and normals from the model. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    tgt->vx = WlzVerticesFromGM(tGM, &(tgt->nr), NULL, &(tgt->nVx),
+    				&(tgt->vType), &errNum);
+    if((errNum == WLZ_ERR_NONE) && (tgt->nVx <= 0))
+    {
+      errNum = WLZ_ERR_DOMAIN_DATA;
+    }
+  }
+  /* Build a kD-tree from the vertices of the the model. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    tgt->maxVI = (int )(tGM->res.vertex.numIdx);
+    if((shfBuf = (int *)AlcMalloc(tgt->nVx * sizeof(int))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      tgt->tree = WlzVerticesBuildTree(tgt->vType, tgt->nVx, tgt->vx,
+				       shfBuf, &errNum);
+      AlcFree(shfBuf);
+    }
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    (void )WlzMatchICPTargetFree(tgt);
+    tgt = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(tgt);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Frees a matching target built by WlzMatchICPTargetNew().
+* \param	tgt			Given matching target, may be NULL.
+*/
+WlzErrorNum	WlzMatchICPTargetFree(WlzMatchICPTarget *tgt)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(tgt)
+  {
+    if(tgt->model && WlzUnlink(&(tgt->model->linkcount), &errNum))
+    {
+      (void )WlzGMModelFree(tgt->model);
+    }
+    (void )AlcKDTTreeFree(tgt->tree);
+    AlcFree(tgt->vx.v);
+    AlcFree(tgt->nr.v);
+    AlcFree(tgt);
+  }
+  return(errNum);
+}
+
 /*!
 * \return	Woolz error code.
 * \ingroup	WlzTransform
@@ -1162,35 +1502,21 @@ double		WlzMatchICPWeightMatches(WlzVertexType vType,
 *		shell sizes within the list, registering shells all
 *		above the size threshold to the target model and removing
 *		the list elements of any small shells or shells that do not
-*		register.
-* \param	tTree			Given kD-tree populated by the
-*					target vertices such that the
-*					nodes of the tree have the same
-*					indicies as the given target vertices
-*					and normals.
-* \param	tGM			Target geometric model.
+*		register. The shells are registered concurrently using
+*		WlzMatchICPRegShellVec() and then the list elements are
+*		removed in list order.
+* \param	tgt			The matching target.
 * \param	sGM			Source geometric model.
 * \param	sLst			The given list of shells.
 * \param	globTr			Global affine transform.
 * \param	trType			The required type of transform,
 *					must be either WLZ_TRANSFORM_2D_REG,
 *					or WLZ_TRANSFORM_2D_AFFINE.
-* \param	vType			Type of vertices.
-* \param	sgnNrm			Non zero if normals are consistant
-*					in component sign.
-* \param	nTV			Number of target vertices.
-* \param	tVx			The target vertices.
-* \param	tNr			The target normals.
 * \param        nSV			Number of source vertices.
 * \param        sVx 			The source vertices.
 * \param	sNr			The source normals.
-*		iBuf			Buffer with at least nSV ints.
-* \param	tVBuf			A buffer with room for at least
-*					nS vertices.
-*		sVBuf			A buffer with room for at least
-*					nS vertices.
-* \param	wBuf			A buffer with room for at least
-*					nS doubles.
+* \param	maxVI			Maximum vertex index of both the
+*					target and source models plus one.
 * \param	maxItr			Maximum number of iterations.
 * \param 	maxDisp			Maximum displacement.
 * \param	maxAng			maximum angle (radians).
@@ -1204,58 +1530,101 @@ double		WlzMatchICPWeightMatches(WlzVertexType vType,
 *					registration metric.
 * \param	minDistWgt		Minimum distance weight.
 */
-static WlzErrorNum	WlzMatchICPRegShellLst(AlcKDTTree *tTree,
-				WlzGMModel *tGM,
+static WlzErrorNum	WlzMatchICPRegShellLst(WlzMatchICPTarget *tgt,
 				WlzGMModel *sGM,
 				WlzMatchICPShellList *sLst,
 				WlzAffineTransform *globTr,
 				WlzTransformType trType,
-				WlzVertexType vType, int sgnNrm,
-				int nTV, WlzVertexP tVx, WlzVertexP tNr,
 				int nSV, WlzVertexP sVx, WlzVertexP sNr,
-				int *iBuf, WlzVertexP tVBuf, WlzVertexP sVBuf,
-				double *wBuf, int maxItr, 
+				int maxVI, int maxItr, 
 				double maxDisp, double maxAng, 
 				double maxDeform, int minSpx,
 				WlzAffineTransform *gInitTr,
 				WlzRegICPUsrWgtFn usrWgtFn, void *usrWgtData,
 				double delta, double minDistWgt)
 {
-  int		convFlg,
+  int		idR,
+  		nElm = 0,
+  		nReg = 0,
   		remFlg;
+  int		*regConv = NULL;
+  WlzGMShell	**regShl = NULL;
+  WlzErrorNum	*regErr = NULL;
   WlzMatchICPShellListElm *lElm0,
   		*lElm1;
+  WlzMatchICPShellListElm **regElm = NULL;
   WlzAffineTransform *initTr = NULL,
   		*tTr;
+  WlzAffineTransform **regTr = NULL;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
 
-  lElm0 = sLst->head;
   /* Copy the given initial affine transform as it may well belong to one of
    * the members of the list. */
   initTr = WlzAffineTransformCopy(gInitTr, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    for(lElm0 = sLst->head; lElm0 != NULL; lElm0 = lElm0->next)
+    {
+      ++nElm;
+    }
+    if(nElm > 0)
+    {
+      if(((regElm = (WlzMatchICPShellListElm **)
+                    AlcMalloc(nElm * sizeof(WlzMatchICPShellListElm *))) ==
+		    NULL) ||
+         ((regShl = (WlzGMShell **)
+		    AlcMalloc(nElm * sizeof(WlzGMShell *))) == NULL) ||
+	 ((regTr = (WlzAffineTransform **)
+		   AlcCalloc(nElm, sizeof(WlzAffineTransform *))) == NULL) ||
+	 ((regConv = (int *)AlcCalloc(nElm, sizeof(int))) == NULL) ||
+	 ((regErr = (WlzErrorNum *)
+		    AlcCalloc(nElm, sizeof(WlzErrorNum))) == NULL))
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+    }
+  }
+  /* Set the shell sizes and collect the shells to be registered. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    for(lElm0 = sLst->head; lElm0 != NULL; lElm0 = lElm0->next)
+    {
+      lElm0->mShell.size = WlzGMShellSimplexCnt(lElm0->mShell.shell);
+      if(lElm0->mShell.size >= minSpx)
+      {
+        *(regElm + nReg) = lElm0;
+        *(regShl + nReg) = lElm0->mShell.shell;
+	++nReg;
+      }
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (nReg > 0))
+  {
+    errNum = WlzMatchICPRegShellVec(tgt, nReg, regShl, globTr, trType,
+				    nSV, sVx, sNr, maxVI, maxItr,
+				    maxDisp, maxAng, maxDeform, initTr,
+				    usrWgtFn, usrWgtData, delta, minDistWgt,
+				    regTr, regConv, regErr);
+  }
+  /* Remove the list elements of small shells and shells which have failed
+   * to register. */
+  idR = 0;
+  lElm0 = sLst->head;
   while((errNum == WLZ_ERR_NONE) && (lElm0 != NULL))
   {
     tTr = NULL;
     remFlg = 1;
-    lElm0->mShell.size = WlzGMShellSimplexCnt(lElm0->mShell.shell);
-    if(lElm0->mShell.size >= minSpx)
-    {
-      tTr = WlzAssignAffineTransform(
-	    WlzMatchICPRegShell(tTree, tGM, lElm0->mShell.shell,
-			        globTr, trType, vType, sgnNrm,
-			        nTV, tVx, tNr, nSV, sVx, sNr,
-			        iBuf, tVBuf, sVBuf, wBuf,
-			        maxItr, maxDisp, maxAng, maxDeform,
-				initTr, &convFlg,
-				usrWgtFn, usrWgtData,
-				delta, minDistWgt, &errNum),
-	    NULL);
-      remFlg = !convFlg;
-      if(errNum == WLZ_ERR_ALG_CONVERGENCE)
+    if((idR < nReg) && (lElm0 == *(regElm + idR)))
+    {
+      tTr = *(regTr + idR);
+      *(regTr + idR) = NULL;
+      remFlg = !*(regConv + idR);
+      if((errNum = *(regErr + idR)) == WLZ_ERR_ALG_CONVERGENCE)
       {
 	/* Convergence flag will trap failures to register. */
         errNum = WLZ_ERR_NONE;
       }
+      ++idR;
     }
     if(errNum == WLZ_ERR_NONE)
     {
@@ -1278,11 +1647,146 @@ static WlzErrorNum	WlzMatchICPRegShellLst(AlcKDTTree *tTree,
       }
       lElm0 = lElm1;
     }
+    else
+    {
+      (void )WlzFreeAffineTransform(tTr);
+    }
+  }
+  for(idR = 0; idR < nReg; ++idR)
+  {
+    (void )WlzFreeAffineTransform(*(regTr + idR));
   }
+  AlcFree(regElm);
+  AlcFree(regShl);
+  AlcFree(regTr);
+  AlcFree(regConv);
+  AlcFree(regErr);
   (void )WlzFreeAffineTransform(initTr);
   return(errNum);
 }
 
+/*!
+* \return	Error code, only set for failures which prevent the
+*		shells from being registered.
+* \ingroup	WlzTransform
+* \brief	Registers each of the given source shells to the target
+*		model. The shells are independent and the target is only
+*		read, so when OpenMP is enabled the shells are registered
+*		concurrently, each thread having it's own vertex, index
+*		and weight buffers. The resulting transforms, convergence
+*		flags and error codes are set for each shell and are
+*		independent of the number of threads.
+* \param	tgt			The matching target.
+* \param	nShl			Number of shells.
+* \param	shl			The source shells.
+* \param	globTr			Global affine transform.
+* \param	trType			The required type of transform.
+* \param        nSV			Number of source vertices.
+* \param        sVx 			The source vertices.
+* \param	sNr			The source normals.
+* \param	maxVI			Maximum vertex index of both the
+*					target and source models plus one.
+* \param	maxItr			Maximum number of iterations.
+* \param 	maxDisp			Maximum displacement.
+* \param	maxAng			maximum angle (radians).
+* \param	maxDeform		Maximum deformation.
+* \param	initTr			Initial affine transform, may be NULL.
+* \param	usrWgtFn		User supplied weighting function,
+*					which must be reentrant.
+* \param	usrWgtData		User supplied weighting data.
+* \param	delta			Tolerance for mean value of
+*					registration metric.
+* \param	minDistWgt		Minimum distance weight.
+* \param	dstTr			Destination array for the nShl
+*					shell transforms.
+* \param	dstConv			Destination array for the nShl
+*					convergence flags.
+* \param	dstErr			Destination array for the nShl
+*					error codes.
+*/
+static WlzErrorNum	WlzMatchICPRegShellVec(WlzMatchICPTarget *tgt,
+				int nShl, WlzGMShell **shl,
+				WlzAffineTransform *globTr,
+				WlzTransformType trType,
+				int nSV, WlzVertexP sVx, WlzVertexP sNr,
+				int maxVI, int maxItr, 
+				double maxDisp, double maxAng, 
+				double maxDeform,
+				WlzAffineTransform *initTr,
+				WlzRegICPUsrWgtFn usrWgtFn, void *usrWgtData,
+				double delta, double minDistWgt,
+				WlzAffineTransform **dstTr, int *dstConv,
+				WlzErrorNum *dstErr)
+{
+  int		idS;
+  size_t	vSz;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  vSz = (tgt->vType == WLZ_VERTEX_D2)? sizeof(WlzDVertex2):
+                                       sizeof(WlzDVertex3);
+#ifdef _OPENMP
+#pragma omp parallel if(nShl > 1)
+#endif
+  {
+    int		*iBuf = NULL;
+    double	*wBuf = NULL;
+    WlzVertexP	tVBuf,
+    		sVBuf;
+    WlzErrorNum	errNum2 = WLZ_ERR_NONE;
+
+    tVBuf.v = sVBuf.v = NULL;
+    if(((iBuf = (int *)AlcMalloc(maxVI * sizeof(int))) == NULL) ||
+       ((tVBuf.v = AlcMalloc((size_t )maxVI * vSz)) == NULL) ||
+       ((sVBuf.v = AlcMalloc((size_t )maxVI * vSz)) == NULL) ||
+       ((wBuf = (double *)AlcMalloc((size_t )maxVI *
+				    sizeof(double))) == NULL))
+    {
+      errNum2 = WLZ_ERR_MEM_ALLOC;
+    }
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for(idS = 0; idS < nShl; ++idS)
+    {
+      *(dstConv + idS) = 0;
+      *(dstTr + idS) = NULL;
+      if(errNum2 == WLZ_ERR_NONE)
+      {
+	*(dstTr + idS) = WlzAssignAffineTransform(
+	    WlzMatchICPRegShell(tgt->tree, tgt->model, *(shl + idS),
+				globTr, trType, tgt->vType, tgt->sgnNrm,
+				tgt->nVx, tgt->vx, tgt->nr, nSV, sVx, sNr,
+				iBuf, tVBuf, sVBuf, wBuf,
+				maxItr, maxDisp, maxAng, maxDeform,
+				initTr, dstConv + idS,
+				usrWgtFn, usrWgtData,
+				delta, minDistWgt, dstErr + idS), NULL);
+      }
+      else
+      {
+        *(dstErr + idS) = errNum2;
+      }
+    }
+    AlcFree(iBuf);
+    AlcFree(tVBuf.v);
+    AlcFree(sVBuf.v);
+    AlcFree(wBuf);
+    if(errNum2 != WLZ_ERR_NONE)
+    {
+#ifdef _OPENMP
+#pragma omp critical (WlzMatchICPRegShellVec)
+#endif
+      {
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  errNum = errNum2;
+	}
+      }
+    }
+  }
+  return(errNum);
+}
+
 /*!
 * \return				Affine transform found, NULL
 *					on error.
@@ -2879,6 +3383,7 @@ static double	WlzMatchICPWeightMatches2D(WlzAffineTransform *curTr,
 				       	double maxDisp, int nScatter)
 {
   int		idN;
+  unsigned int	seed;
   double	wgt = 1.0;
   WlzDVertex2	disp,
    		tMVx0,
@@ -2900,12 +3405,16 @@ static double	WlzMatchICPWeightMatches2D(WlzAffineTransform *curTr,
     tMV = WlzGMModelMatchVertexG2D(tGM, tMVx);
     tMLT = tMV->diskT->vertexT->parent->parent;
     tMS = tMLT->parent;
+    /* Seed the pseudo-random displacements from the source vertex so that
+     * the weight doesn't depend on the order in which matches are
+     * weighted, allowing shells to be registered concurrently. */
+    seed = WlzGeomHashVtx2D(sMVx, WLZ_GM_TOLERANCE);
     for(idN = 0; idN < nScatter; ++idN)
     {
       /* Compute a new source vertex with a random displacement
       * (distance < maxDist) from the source vertex. */
-      disp.vtX = ((AlgRandUniform() * 2.0) - 1.0) * delta;
-      disp.vtY = ((AlgRandUniform() * 2.0) - 1.0) * delta;
+      disp.vtX = ((WlzMatchICPRandUniform(&seed) * 2.0) - 1.0) * delta;
+      disp.vtY = ((WlzMatchICPRandUniform(&seed) * 2.0) - 1.0) * delta;
       sMVx0.vtX = sMVx.vtX + disp.vtX;
       sMVx0.vtY = sMVx.vtY + disp.vtY;
       /* Transfrom the source vertex using the current affine transform. */
@@ -2945,6 +3454,24 @@ static double	WlzMatchICPWeightMatches2D(WlzAffineTransform *curTr,
   return(wgt);
 }
 
+/*!
+* \return	Pseudo-random value.
+* \ingroup	WlzTransform
+* \brief	Produces a pseudo-random value from a uniform distribution
+*		over the interval [0.0, 1.0] using a linear congruential
+*		generator with the given state. Unlike AlgRandUniform()
+*		this is reentrant.
+* \param	seed			Generator state which is updated.
+*/
+static double	WlzMatchICPRandUniform(unsigned int *seed)
+{
+  double	value;
+
+  *seed = (*seed * 1103515245u) + 12345u;
+  value = (double )((*seed >> 8) & 0xffffff) / (double )0xffffff;
+  return(value);
+}
+
 /*!
 * \return	Weight value in the range [0.0-1.0].
 * \ingroup      WlzTransform
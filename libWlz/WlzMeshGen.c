@@ -151,6 +151,13 @@ static int			WlzCMeshCompLBTFceNodPos3D(
 				  int idF,
 				  WlzLBTNodeClass2D cls,
 				  int rot);
+static int			WlzCMeshLBTFceQuarters3D(
+				  WlzLBTDomain3D *lDom,
+				  WlzGreyValueWSpace *iGVWSp,
+				  int idN,
+				  int nNod,
+				  WlzDVertex3 *nPos,
+				  int *qtr);
 static int			WlzCMeshElmWalkPos2D(
 				  WlzCMesh2D *mesh,
 				  int elmIdx,
@@ -226,6 +233,12 @@ static WlzErrorNum 		WlzCMeshElmFromLBTNode3D(
 				  WlzCMeshElm3D **mElm,
 				  WlzCMeshNod3D **mNod,
 				  WlzLBTNodeClass2D cls);
+static WlzErrorNum 		WlzCMeshElmsFromLBTFceQuarters3D(
+				  WlzCMesh3D *mesh,
+				  WlzCMeshNod3D **mNod,
+				  WlzDVertex3 *nPos,
+				  int nFNod,
+				  int *qtr);
 static WlzErrorNum 		WlzCMeshElmsFromLBTNode2D0(
 				  WlzCMesh2D *mesh,
 				  WlzCMeshElm2D **mElm,
@@ -7426,14 +7439,16 @@ static WlzErrorNum WlzCMeshAddLBTNode3D(WlzCMesh3D *mesh,
   int		idF,
 		idM,
 		rot,
-		nNod;
+		nNod,
+		nQtr;
   WlzIBox3	nBB;
   WlzDVertex3	vtx[8];
   WlzLBTNodeClass2D cls; /* The 2D node classification is valid for faces. */
   WlzDVertex3	nPos[27]; /* Nodes at cube vertices (8), edge midpoints (12),
                              face centres (6) and cube centre (1) = 27. */
+  int		qtr[4];
   WlzCMeshElm3D *mElm[8];
-  WlzCMeshNod3D	*mNod[10];
+  WlzCMeshNod3D	*mNod[14];
   WlzErrorNum	errNum = WLZ_ERR_NONE;
 
   /* For each face of the LBT node's cube:
@@ -7476,6 +7491,10 @@ static WlzErrorNum WlzCMeshAddLBTNode3D(WlzCMesh3D *mesh,
     WlzLBTClassifyNodeFace3D(lDom, iGVWSp, idN, idF, vtx, &cls, &rot);
     /* Compute the positions of the mesh nodes. */
     nNod = WlzCMeshCompLBTFceNodPos3D(nPos, lDom, idN,  idF, cls, rot);
+    /* Add nodes at the centres of any quarters of the face which abut
+     * smaller LBT nodes. */
+    nQtr = WlzCMeshLBTFceQuarters3D(lDom, iGVWSp, idN, nNod, nPos, qtr);
+    nNod += nQtr;
     /* Match mesh nodes to computed positions. */
     (void )WlzCMeshMatchNNod3D(mesh, nNod, nPos, WLZ_MESH_TOLERANCE, mNod);
     /* Create nodes that don't already exist. */
@@ -7493,7 +7512,15 @@ static WlzErrorNum WlzCMeshAddLBTNode3D(WlzCMesh3D *mesh,
     if(errNum == WLZ_ERR_NONE)
     {
       /* Create new mesh elements. */
-      errNum = WlzCMeshElmFromLBTNode3D(mesh, nPos, mElm, mNod, cls);
+      if(nQtr > 0)
+      {
+        errNum = WlzCMeshElmsFromLBTFceQuarters3D(mesh, mNod, nPos,
+						  nNod - nQtr, qtr);
+      }
+      else
+      {
+	errNum = WlzCMeshElmFromLBTNode3D(mesh, nPos, mElm, mNod, cls);
+      }
     }
     ++idF;
   }
@@ -7506,6 +7533,89 @@ static WlzErrorNum WlzCMeshAddLBTNode3D(WlzCMesh3D *mesh,
   return(errNum);
 }
 
+/*!
+* \return	Number of quarters of the face which abut smaller LBT
+*		nodes.
+* \ingroup	WlzMesh
+* \brief	Finds the quarters of a 3D LBT node's face which abut
+*		smaller LBT nodes. The faces of these smaller nodes have
+*		a node at their centre, so the quarters of the face must
+*		be meshed to match them rather than using the class
+*		pattern of the whole face. The positions of the quarter
+*		centres are appended to the face's node positions.
+* \param	lDom			Linear binary tree domain.
+* \param	iGVWSp			Grey workspace for index object.
+* \param	idN			Index of the LBT node.
+* \param	nNod			Number of face node positions, as
+*					computed by
+*					WlzCMeshCompLBTFceNodPos3D().
+* \param	nPos			Face node positions, with space for
+*					four more.
+* \param	qtr			Destination array for the indices
+*					of the quarter centre nodes for the
+*					quarters at each of the four face
+*					corners, -1 if the quarter does not
+*					abut smaller nodes.
+*/
+static int	WlzCMeshLBTFceQuarters3D(WlzLBTDomain3D *lDom,
+				 	 WlzGreyValueWSpace *iGVWSp,
+					 int idN, int nNod,
+					 WlzDVertex3 *nPos, int *qtr)
+{
+  int		idC,
+  		idM,
+		idNN,
+		nSz,
+		nQtr = 0;
+  WlzDVertex3	nrm;
+
+  nSz = WlzLBTNodeSz3D(lDom->nodes + idN);
+  WLZ_VTX_3_SUB(nrm, nPos[1], nPos[0]);
+  WLZ_VTX_3_SIGN(nrm, nrm);
+  for(idC = 0; idC < 4; ++idC)
+  {
+    qtr[idC] = -1;
+    if(nSz > 1)
+    {
+      int	mCnt = 0;
+      WlzDVertex3 cPos,
+      		dir,
+		prb;
+
+      /* Probe the voxel across the face in the corner of the quarter. */
+      cPos = nPos[2 + idC];
+      WLZ_VTX_3_SUB(dir, nPos[1], cPos);
+      WLZ_VTX_3_SIGN(dir, dir);
+      WLZ_VTX_3_ADD(dir, dir, nrm);
+      WLZ_VTX_3_SCALE_ADD(prb, dir, 0.5, cPos);
+      WlzGreyValueGet(iGVWSp, floor(prb.vtZ), floor(prb.vtY), floor(prb.vtX));
+      idNN = iGVWSp->gVal[0].inv;
+      if((idNN >= 0) && (WlzLBTNodeSz3D(lDom->nodes + idNN) < nSz))
+      {
+	/* The edges through the quarter's corner must both have been
+	 * split by the face classification. */
+	for(idM = 6; idM < nNod; ++idM)
+	{
+	  WlzDVertex3 d;
+
+	  WLZ_VTX_3_SUB(d, nPos[idM], cPos);
+	  if(WLZ_VTX_3_SQRLEN(d) < (0.25 * nSz * nSz) + WLZ_MESH_TOLERANCE)
+	  {
+	    ++mCnt;
+	  }
+	}
+	if(mCnt == 2)
+	{
+	  qtr[idC] = nNod + nQtr++;
+	  WLZ_VTX_3_ADD(nPos[qtr[idC]], nPos[1], cPos);
+	  WLZ_VTX_3_SCALE(nPos[qtr[idC]], nPos[qtr[idC]], 0.5);
+	}
+      }
+    }
+  }
+  return(nQtr);
+}
+
 /*!
 * \return	Number of nodes for the given LBT domain node.
 * \ingroup	WlzMesh
@@ -8002,6 +8112,117 @@ static WlzErrorNum WlzCMeshElmFromLBTNode3D(WlzCMesh3D *mesh,
   return(errNum);
 }
 
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzMesh
+* \brief	Creates the mesh elements for a face of a 3D LBT node
+*		which has quarters that abut smaller LBT nodes. Each of
+*		these quarters is meshed as four triangles about the
+*		quarter's centre, matching the face of the smaller node,
+*		while the rest of the face is meshed as triangles about
+*		the face centre, using the face's edge nodes. All
+*		pointers must be valid but this is not checked for
+*		because this is a static function.
+* \param	mesh			The mesh.
+* \param	mNod			Mesh nodes of the face.
+* \param	nPos			Node positions, as computed by
+*					WlzCMeshCompLBTFceNodPos3D() and
+*					WlzCMeshLBTFceQuarters3D().
+* \param	nFNod			Number of face nodes, excluding the
+*					quarter centres.
+* \param	qtr			Indices of the quarter centre nodes,
+*					as set by WlzCMeshLBTFceQuarters3D().
+*/
+static WlzErrorNum WlzCMeshElmsFromLBTFceQuarters3D(WlzCMesh3D *mesh,
+					WlzCMeshNod3D **mNod,
+					WlzDVertex3 *nPos,
+					int nFNod,
+					int *qtr)
+{
+  int		idC,
+  		idM,
+		idT,
+		nTri = 0;
+  int		mid[4],
+  		tri[16][3];
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  /* Find the edge nodes between each pair of face corners. */
+  for(idC = 0; idC < 4; ++idC)
+  {
+    WlzDVertex3	p;
+
+    mid[idC] = -1;
+    WLZ_VTX_3_ADD(p, nPos[2 + idC], nPos[2 + ((idC + 1) % 4)]);
+    WLZ_VTX_3_SCALE(p, p, 0.5);
+    for(idM = 6; idM < nFNod; ++idM)
+    {
+      WlzDVertex3 d;
+
+      WLZ_VTX_3_SUB(d, nPos[idM], p);
+      if(WLZ_VTX_3_SQRLEN(d) < WLZ_MESH_TOLERANCE_SQ)
+      {
+	mid[idC] = idM;
+	break;
+      }
+    }
+  }
+  /* Triangles about the face centre for the parts of the face edges in
+   * quarters which do not abut smaller nodes. */
+  for(idC = 0; idC < 4; ++idC)
+  {
+    int		idC1;
+
+    idC1 = (idC + 1) % 4;
+    if(mid[idC] < 0)
+    {
+      tri[nTri][0] = 2 + idC;
+      tri[nTri][1] = 2 + idC1;
+      tri[nTri++][2] = 1;
+    }
+    else
+    {
+      if(qtr[idC] < 0)
+      {
+	tri[nTri][0] = 2 + idC;
+	tri[nTri][1] = mid[idC];
+	tri[nTri++][2] = 1;
+      }
+      if(qtr[idC1] < 0)
+      {
+	tri[nTri][0] = mid[idC];
+	tri[nTri][1] = 2 + idC1;
+	tri[nTri++][2] = 1;
+      }
+    }
+  }
+  /* Triangles about the quarter centres. */
+  for(idC = 0; idC < 4; ++idC)
+  {
+    if(qtr[idC] >= 0)
+    {
+      int	m0,
+		m1;
+
+      m0 = mid[(idC + 3) % 4];
+      m1 = mid[idC];
+      tri[nTri][0] = 2 + idC; tri[nTri][1] = m1; tri[nTri++][2] = qtr[idC];
+      tri[nTri][0] = m1;      tri[nTri][1] = 1;  tri[nTri++][2] = qtr[idC];
+      tri[nTri][0] = 1;       tri[nTri][1] = m0; tri[nTri++][2] = qtr[idC];
+      tri[nTri][0] = m0; tri[nTri][1] = 2 + idC; tri[nTri++][2] = qtr[idC];
+    }
+  }
+  /* Create the tetrahedra from the triangles and the cube centre. */
+  idT = 0;
+  while((errNum == WLZ_ERR_NONE) && (idT < nTri))
+  {
+    (void )WlzCMeshNewElm3D(mesh, mNod[tri[idT][0]], mNod[tri[idT][1]],
+                            mNod[0], mNod[tri[idT][2]], 1, &errNum);
+    ++idT;
+  }
+  return(errNum);
+}
+
 /*!
 * \return	Woolz error code.
 * \ingroup	WlzMesh
@@ -0,0 +1,163 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzPlaneStream_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         libWlz/WlzPlaneStream.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Processing of 3D domain objects which are too large to fit
+* 		in memory, one plane at a time.
+* \ingroup	WlzIO
+*
+* A plane stream reads the planes of a 3D domain object from a file
+* one at a time (see WlzPlaneStreamReadOpen()) or writes them to a
+* file one at a time (see WlzPlaneStreamWriteOpen()). The functions
+* here free plane streams and apply plane-local operations such as
+* thresholding, look up tables, scalar arithmetic and 2D filters to
+* the planes of an object as they are read, so that only a few planes
+* are in memory at any time.
+*/
+
+#include <Wlz.h>
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Frees a plane stream. If the stream was opened for writing
+* 		and created its own spool file then the spool file is
+* 		closed (and so removed). The stream's file is not closed.
+* \param	pS			Given plane stream.
+*/
+WlzErrorNum	WlzPlaneStreamFree(WlzPlaneStream *pS)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(pS == NULL)
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else
+  {
+    if(pS->ownSpool && pS->spool)
+    {
+      (void )fclose(pS->spool);
+    }
+    if(pS->plist)
+    {
+      errNum = WlzFreePropertyList(pS->plist);
+    }
+    AlcFree(pS->off);
+    AlcFree(pS);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Reads a 3D domain object from the input file one plane at
+* 		a time, applies the given function to each non-empty plane
+* 		and writes the resulting planes to the output file as a
+* 		3D domain object. The object's property list is copied.
+* 		The input file must be seekable, see
+* 		WlzPlaneStreamReadOpen().
+* \param	inFP			Input file.
+* \param	outFP			Output file.
+* \param	spool			Spool file for the output, may be
+* 					NULL (see WlzPlaneStreamWriteOpen()).
+* \param	fn			Function applied to each non-empty
+* 					plane, if NULL the planes are copied.
+* \param	fnData			Data passed to the function.
+* \param	cmp			Compression method for the output
+* 					values.
+*/
+WlzErrorNum	WlzPlaneStreamApply(FILE *inFP, FILE *outFP, FILE *spool,
+				    WlzPlaneStreamFn fn, void *fnData,
+				    WlzIOCompression cmp)
+{
+  WlzDVertex3	voxSz;
+  WlzPlaneStream *rS = NULL,
+  		*wS = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  rS = WlzPlaneStreamReadOpen(inFP, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    voxSz.vtX = rS->voxelSz[0];
+    voxSz.vtY = rS->voxelSz[1];
+    voxSz.vtZ = rS->voxelSz[2];
+    wS = WlzPlaneStreamWriteOpen(outFP, spool, rS->plane1, rS->lastpl,
+                                 voxSz, cmp, &errNum);
+  }
+  while(errNum == WLZ_ERR_NONE)
+  {
+    int		pl;
+    WlzObject	*obj = NULL,
+    		*rObj = NULL;
+
+    pl = rS->plane;
+    obj = WlzAssignObject(WlzPlaneStreamReadPlane(rS, &errNum), NULL);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if((fn == NULL) || (obj->type != WLZ_2D_DOMAINOBJ))
+      {
+        rObj = WlzAssignObject(obj, NULL);
+      }
+      else
+      {
+        rObj = WlzAssignObject((*fn)(obj, pl, fnData, &errNum), NULL);
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = WlzPlaneStreamWritePlane(wS, rObj);
+    }
+    (void )WlzFreeObj(rObj);
+    (void )WlzFreeObj(obj);
+  }
+  if((errNum == WLZ_ERR_EOO) && (wS != NULL))
+  {
+    /* All planes have been read. */
+    wS->plist = WlzAssignPropertyList(rS->plist, NULL);
+    errNum = WlzPlaneStreamWriteClose(wS);
+  }
+  if(rS)
+  {
+    (void )WlzPlaneStreamFree(rS);
+  }
+  if(wS)
+  {
+    (void )WlzPlaneStreamFree(wS);
+  }
+  return(errNum);
+}
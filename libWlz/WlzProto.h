@@ -139,6 +139,15 @@ extern WlzObject		*WlzGetProjectionFromObject(
 				  Wlz3DProjectionIntFn intFunc,
 				  void *intFuncData,
 				  WlzErrorNum *dstErr);
+extern WlzObject		*WlzProjectObjRayCast(
+				  WlzObject *obj,
+				  WlzThreeDViewStruct *vStr,
+				  WlzProjectRayMode mode,
+				  double depth,
+				  double valMin,
+				  double valMax,
+				  double opacity,
+				  WlzErrorNum *dstErr);
 #endif /* WLZ_EXT_BIND */
 
 /************************************************************************
@@ -876,6 +885,24 @@ extern WlzObject		*WlzFromArray1D(
 				  WlzGreyP gDat,
 				  int noCopy,
 				  WlzErrorNum *dstErr);
+extern WlzObject		*WlzFromArrayMapped1D(
+				  WlzObjectType oType,
+				  WlzIVertex3 sz,
+				  WlzIVertex3 org,
+				  WlzGreyType gType,
+				  int fd,
+				  long offset,
+				  int swap,
+				  WlzErrorNum *dstErr);
+extern void			*WlzMapFileRegion(
+				  int fd,
+				  long offset,
+				  size_t len,
+				  int readOnly,
+				  void **freeptr,
+				  WlzErrorNum *dstErr);
+extern WlzErrorNum		WlzUnmapFileRegion(
+				  void **freeptr);
 extern WlzObject 		*WlzFromArray2D(
 				  void **arrayP,
 				   WlzIVertex2 arraySize,
@@ -1101,6 +1128,34 @@ extern WlzBasisFn 		*WlzBasisFnScalarMOS3DFromCPts(
 				  WlzErrorNum *dstErr);
 #endif
 
+/************************************************************************
+* WlzBasisFnTPSEdit.c							*
+************************************************************************/
+extern WlzBasisFnTPS2DEdit	*WlzBasisFnTPS2DEditNew(
+				  int nPts,
+				  WlzDVertex2 *dPts,
+				  WlzDVertex2 *sPts,
+				  WlzErrorNum *dstErr);
+extern WlzErrorNum		WlzBasisFnTPS2DEditFree(
+				  WlzBasisFnTPS2DEdit *edt);
+extern WlzErrorNum		WlzBasisFnTPS2DEditAdd(
+				  WlzBasisFnTPS2DEdit *edt,
+				  WlzDVertex2 dPt,
+				  WlzDVertex2 sPt);
+extern WlzErrorNum		WlzBasisFnTPS2DEditMove(
+				  WlzBasisFnTPS2DEdit *edt,
+				  int idx,
+				  WlzDVertex2 dPt,
+				  WlzDVertex2 sPt);
+extern WlzErrorNum		WlzBasisFnTPS2DEditRemove(
+				  WlzBasisFnTPS2DEdit *edt,
+				  int idx);
+extern WlzErrorNum		WlzBasisFnTPS2DEditSetMesh(
+				  WlzBasisFnTPS2DEdit *edt,
+				  WlzMeshTransform *mesh,
+				  double tol,
+				  int *dstCnt);
+
 /************************************************************************
 * WlzBasisFnTransform.c							*
 ************************************************************************/
@@ -1510,6 +1565,28 @@ extern WlzDVertex2		WlzCMeshClosePointDom2D5(
 				  double scale,
 				  WlzErrorNum *dstErr);
 
+/************************************************************************
+* WlzCMeshLattice.c							*
+************************************************************************/
+extern WlzCMeshLattice		*WlzCMeshLatticeNew(
+				  WlzObject *mObj,
+				  double cellSz,
+				  WlzErrorNum *dstErr);
+extern WlzErrorNum		WlzCMeshLatticeFree(
+				  WlzCMeshLattice *lat);
+extern WlzCMeshLattice		*WlzCMeshLatticeCached(
+				  WlzObject *mObj,
+				  int nVtx,
+				  WlzErrorNum *dstErr);
+extern WlzErrorNum		WlzCMeshLatticeCacheFree(
+				  WlzCMeshLatticeCache *cache);
+extern int			WlzCMeshLatticeLocate2D(
+				  WlzCMeshLattice *lat,
+				  WlzDVertex2 pos);
+extern int			WlzCMeshLatticeLocate3D(
+				  WlzCMeshLattice *lat,
+				  WlzDVertex3 pos);
+
 /************************************************************************
 * WlzCMeshScan.c							*
 ************************************************************************/
@@ -1642,6 +1719,16 @@ extern WlzErrorNum		WlzCMeshTransformVtxAry3D(
 				  WlzObject *mObj,
 				  int sizeArrayVtx,
 				  WlzDVertex3 *arrayVtx);
+extern WlzErrorNum		WlzCMeshTransformVtxAryLat2D(
+				  WlzObject *mObj,
+				  WlzCMeshLattice *lat,
+				  int sizeArrayVtx,
+				  WlzDVertex2 *arrayVtx);
+extern WlzErrorNum		WlzCMeshTransformVtxAryLat3D(
+				  WlzObject *mObj,
+				  WlzCMeshLattice *lat,
+				  int sizeArrayVtx,
+				  WlzDVertex3 *arrayVtx);
 extern WlzErrorNum		WlzScaleCMeshValue(
                                   double scale,
                                   WlzObject *obj);
@@ -2411,6 +2498,36 @@ extern WlzObject		*WlzDilation(
 				  WlzConnectType connectivity,
 				  WlzErrorNum *dstErr);
 
+/************************************************************************
+* WlzDispField.c							*
+************************************************************************/
+#ifndef WLZ_EXT_BIND
+extern WlzDispFieldTransform	*WlzMakeDispFieldTransform(
+				  WlzTransformType type,
+				  WlzCompoundArray *field,
+				  WlzErrorNum *dstErr);
+extern WlzErrorNum		WlzFreeDispFieldTransform(
+				  WlzDispFieldTransform *dft);
+extern WlzDispFieldTransform	*WlzDispFieldFromTransform(
+				  WlzTransform tr,
+				  WlzObject *refObj,
+				  size_t tileSz,
+				  WlzErrorNum *dstErr);
+extern WlzErrorNum		WlzDispFieldTransformVtxAry2D(
+				  WlzDispFieldTransform *dft,
+				  int sizeArrayVtx,
+				  WlzDVertex2 *arrayVtx);
+extern WlzErrorNum		WlzDispFieldTransformVtxAry3D(
+				  WlzDispFieldTransform *dft,
+				  int sizeArrayVtx,
+				  WlzDVertex3 *arrayVtx);
+extern WlzObject		*WlzDispFieldTransformObj(
+				  WlzObject *srcObj,
+				  WlzDispFieldTransform *dft,
+				  WlzInterpolationType interp,
+				  WlzErrorNum *dstErr);
+#endif /* WLZ_EXT_BIND */
+
 /************************************************************************
 * WlzDistMetric.c							*
 ************************************************************************/
@@ -2509,6 +2626,21 @@ extern WlzObject		*WlzDomainNearby(
 				  WlzErrorNum *dstErr);
 #endif /* WLZ_EXT_BIND */
 
+/************************************************************************
+* WlzDomainOverlap.c							*
+************************************************************************/
+extern AlgMatrixCSR		*WlzDomainOverlapMatrix(
+				  int nA,
+				  WlzObject **aObj,
+				  int nB,
+				  WlzObject **bObj,
+				  WlzErrorNum *dstErr);
+extern AlgMatrixCSR		*WlzDomainAdjacencyMatrix(
+				  int nObj,
+				  WlzObject **objs,
+				  int dist,
+				  WlzErrorNum *dstErr);
+
 /************************************************************************
 * WlzDomainUtils.c							*
 ************************************************************************/
@@ -3919,6 +4051,32 @@ extern int			WlzInsideDomain3D(
 				  int line,
 				  int kol,
 				  WlzErrorNum *dstErr);
+extern WlzDomainQueryIdx	*WlzMakeDomainQueryIdx(
+				  WlzObject *obj,
+				  int bitset,
+				  WlzErrorNum *dstErr);
+extern WlzErrorNum		WlzFreeDomainQueryIdx(
+				  WlzDomainQueryIdx *idx);
+extern int			WlzDomainQueryIdxInside(
+				  WlzDomainQueryIdx *idx,
+				  int plane,
+				  int line,
+				  int kol);
+extern WlzErrorNum		WlzDomainQueryIdxInsideI2(
+				  WlzDomainQueryIdx *idx,
+				  int nPos,
+				  WlzIVertex2 *pos,
+				  int *dstIn);
+extern WlzErrorNum		WlzDomainQueryIdxInsideI3(
+				  WlzDomainQueryIdx *idx,
+				  int nPos,
+				  WlzIVertex3 *pos,
+				  int *dstIn);
+extern WlzErrorNum		WlzDomainQueryIdxInsideD3(
+				  WlzDomainQueryIdx *idx,
+				  int nPos,
+				  WlzDVertex3 *pos,
+				  int *dstIn);
 
 /************************************************************************
 * WlzInteriority.c							*
@@ -3941,6 +4099,15 @@ extern WlzObject 		*WlzIntersect2(
 				  WlzObject *obj2,
 				  WlzErrorNum *dstErr);
 
+/************************************************************************
+* WlzIntersect3d.c							*
+************************************************************************/
+extern WlzObject		*WlzIntersect3d(
+				  WlzObject **objs,
+				  int n,
+				  int uvt,
+				  WlzErrorNum *wlzErr);
+
 /************************************************************************
 * WlzIntersectN.c							*
 ************************************************************************/
@@ -4011,6 +4178,21 @@ extern WlzIterateWSpace		*WlzIterateInit(
 				  WlzErrorNum *dstErr);
 extern WlzErrorNum		WlzIterate(
 				  WlzIterateWSpace *itWSp);
+extern WlzIteratePartition	*WlzIteratePartitionMake(
+				  WlzObject *obj,
+				  int nChunk,
+				  WlzErrorNum *dstErr);
+extern void			WlzIteratePartitionFree(
+				  WlzIteratePartition *part);
+extern WlzErrorNum		WlzIterateChunkInit(
+				  WlzIterateChunkWSpace *cWSp,
+				  WlzIteratePartition *part,
+				  int idx,
+				  WlzValues values);
+extern WlzErrorNum		WlzIterateChunkNext(
+				  WlzIterateChunkWSpace *cWSp);
+extern void			WlzIterateChunkEnd(
+				  WlzIterateChunkWSpace *cWSp);
 
 /************************************************************************
 * WlzKrig.c								*
@@ -4069,6 +4251,12 @@ extern WlzErrorNum     		WlzKrigOWeightsSolve(
 				  double *posSV,
 				  int *wSp,
 				  double eps);
+extern WlzErrorNum     		WlzKrigOWeightsSolveN(
+				  AlgMatrix modelSV,
+				  int nPos,
+				  double *posSV,
+				  int *wSp,
+				  double eps);
 extern WlzErrorNum		WlzKrigReallocBuffers2D(
 				  WlzDVertex2 **dstNbrPosBuf,
 				  double **dstPosSV,
@@ -4662,6 +4850,48 @@ extern WlzErrorNum  		WlzMatchICPCtr(
                                   WlzRegICPUsrWgtFn usrWgtFn,
                                   void *usrWgtData,
 				  double delta);
+extern WlzErrorNum		WlzMatchICPObjsTgt(
+				  WlzMatchICPTarget *tgt,
+				  WlzObject *sObj,
+				  WlzAffineTransform *initTr,
+				  int *dstNMatch,
+				  WlzVertexP *dstTMatch,
+				  WlzVertexP *dstSMatch,
+				  int maxItr,
+				  int minSpx,
+				  int minSegSpx,
+				  int brkFlg,
+				  double maxDisp,
+				  double maxAng,
+				  double maxDeform,
+				  int matchImpNN,
+				  double matchImpThr,
+				  double delta);
+extern WlzErrorNum  		WlzMatchICPCtrTgt(
+				  WlzMatchICPTarget *tgt,
+				  WlzContour *sCtr,
+                                  WlzAffineTransform *initTr,
+                                  int maxItr,
+				  int minSpx,
+				  int minSegSpx,
+                                  int *dstNMatch,
+				  WlzVertexP *dstTMatch,
+                                  WlzVertexP *dstSMatch,
+				  int brkFlg,
+                                  double  maxDisp,
+				  double maxAng,
+                                  double maxDeform,
+                                  int matchImpNN,
+				  double matchImpThr,
+                                  WlzRegICPUsrWgtFn usrWgtFn,
+                                  void *usrWgtData,
+				  double delta);
+extern WlzMatchICPTarget	*WlzMatchICPTargetNew(
+				  WlzContour *tCtr,
+				  int minSpx,
+				  WlzErrorNum *dstErr);
+extern WlzErrorNum		WlzMatchICPTargetFree(
+				  WlzMatchICPTarget *tgt);
 extern double          		WlzMatchICPWeightMatches(
 				  WlzVertexType vType,
 				  WlzAffineTransform *curTr,
@@ -5318,6 +5548,21 @@ extern WlzObject		*WlzOffsetDist(
 				  int maxDist,
 				  WlzErrorNum *dstErr);
 
+/************************************************************************
+* WlzPlaneStream.c							*
+************************************************************************/
+#ifndef WLZ_EXT_BIND
+extern WlzErrorNum		WlzPlaneStreamFree(
+				  WlzPlaneStream *pS);
+extern WlzErrorNum		WlzPlaneStreamApply(
+				  FILE *inFP,
+				  FILE *outFP,
+				  FILE *spool,
+				  WlzPlaneStreamFn fn,
+				  void *fnData,
+				  WlzIOCompression cmp);
+#endif /* WLZ_EXT_BIND */
+
 /************************************************************************
 * WlzPoints.c								*
 ************************************************************************/
@@ -5495,7 +5740,17 @@ extern WlzObjectType		WlzReadObjType(
 extern WlzObject		*WlzReadObj(
 				  FILE *fP,
 			          WlzErrorNum *dstErr);
+extern WlzObject		*WlzReadObjMapped(
+				  const char *fileName,
+				  int readOnly,
+				  WlzErrorNum *dstErr);
 #ifndef WLZ_EXT_BIND
+extern WlzPlaneStream		*WlzPlaneStreamReadOpen(
+				  FILE *fP,
+				  WlzErrorNum *dstErr);
+extern WlzObject		*WlzPlaneStreamReadPlane(
+				  WlzPlaneStream *pS,
+				  WlzErrorNum *dstErr);
 extern WlzMeshTransform3D 	*WlzReadMeshTransform3D(
 				  FILE *fP,
 				  WlzErrorNum *dstErr);
@@ -5601,6 +5856,24 @@ extern WlzAffineTransform	*WlzRegICPVertices(
 				  double delta,
 				  double minDistWgt,
 				  WlzErrorNum *dstErr);
+extern WlzAffineTransform	*WlzRegICPVerticesPlane(
+				  WlzVertexP tVx,
+				  WlzVertexP tNr,
+				  int tCnt,
+				  WlzVertexP sVx,
+				  WlzVertexP sNr,
+				  int sCnt,
+				  WlzVertexType vType,
+				  int sgnNrm,
+				  WlzAffineTransform *initTr,
+				  WlzTransformType trType,
+				  int *dstConv,
+				  int *dstItr,
+				  int maxItr,
+				  double trim,
+				  int nLvl,
+				  double relTol,
+				  WlzErrorNum *dstErr);
 extern WlzAffineTransform	*WlzRegICPTreeAndVertices(
 				  AlcKDTTree *tree,
 				  WlzTransformType trType,
@@ -5792,6 +6065,16 @@ extern WlzObject 		*WlzSeqPar(
 				  WlzErrorNum	*dstErr);
 #endif /* WLZ_EXT_BIND */
 
+/************************************************************************
+* WlzSetOpN.c								*
+************************************************************************/
+extern WlzObject		*WlzSetOpN(
+				  int n,
+				  WlzObject **objs,
+				  int minCov,
+				  int uvt,
+				  WlzErrorNum *dstErr);
+
 /************************************************************************
 * WlzShadeCorrect.c								*
 ************************************************************************/
@@ -6315,6 +6598,11 @@ extern WlzTiledValueBuffer	*WlzMakeTiledValueBuffer(
 extern int			WlzTiledValuesMode(
 				  WlzTiledValues *tv,
 				  WlzErrorNum *dstErr);
+extern WlzErrorNum		WlzTiledValuesDecodeTile(
+				  WlzTiledValues *tv,
+				  size_t idx);
+extern WlzErrorNum		WlzTiledValuesDecode(
+				  WlzTiledValues *tv);
 extern void			WlzFreeTiledValueBuffer(
 				  WlzTiledValueBuffer *tBuf);
 extern void			WlzTiledValueBufferFlush(
@@ -6341,6 +6629,33 @@ extern WlzTransform		WlzTransformProduct(
 				  WlzErrorNum *dstErr);
 #endif /* WLZ_EXT_BIND */
 
+/************************************************************************
+* WlzTransformChain.c							*
+************************************************************************/
+#ifndef WLZ_EXT_BIND
+extern WlzTransformChain	*WlzMakeTransformChain(
+				  WlzTransformType type,
+				  WlzErrorNum *dstErr);
+extern WlzErrorNum		WlzFreeTransformChain(
+				  WlzTransformChain *chain);
+extern WlzErrorNum		WlzTransformChainAppend(
+				  WlzTransformChain *chain,
+				  WlzTransform tr);
+extern WlzErrorNum		WlzTransformChainVtxAry(
+				  WlzTransformChain *chain,
+				  int sizeArrayVtx,
+				  WlzDVertex3 *arrayVtx);
+extern WlzErrorNum		WlzTransformChainVtxAry2D(
+				  WlzTransformChain *chain,
+				  int sizeArrayVtx,
+				  WlzDVertex2 *arrayVtx);
+extern WlzObject		*WlzTransformChainObj(
+				  WlzObject *srcObj,
+				  WlzTransformChain *chain,
+				  WlzInterpolationType interp,
+				  WlzErrorNum *dstErr);
+#endif /* WLZ_EXT_BIND */
+
 /************************************************************************
 * WlzTransposeObj.c							*
 ************************************************************************/
@@ -6356,6 +6671,15 @@ extern WlzObject		*WlzUnion2(
 				  WlzObject *obj2,
 				  WlzErrorNum *dstErr);
 
+/************************************************************************
+* WlzUnion3d.c								*
+************************************************************************/
+extern WlzObject		*WlzUnion3d(
+				  int n,
+				  WlzObject **objs,
+				  int uvt,
+				  WlzErrorNum *dstErr);
+
 /************************************************************************
 * WlzUnionN.c
 ************************************************************************/
@@ -6365,6 +6689,61 @@ extern WlzObject 		*WlzUnionN(
 				  int uvt,
 				  WlzErrorNum *dstErr);
 
+/************************************************************************
+* WlzValueCompress.c							*
+************************************************************************/
+#ifndef WLZ_EXT_BIND
+extern WlzUByte			*WlzValueCmpEncode(
+				  WlzIOCompression cmp,
+				  int eSz,
+				  int delta,
+				  size_t hdrSz,
+				  const WlzUByte *raw,
+				  size_t rawSz,
+				  size_t blkSz,
+				  size_t *dstSz,
+				  WlzErrorNum *dstErr);
+extern WlzUByte			*WlzValueCmpDecode(
+				  const WlzUByte *buf,
+				  size_t bufSz,
+				  size_t *dstSz,
+				  WlzErrorNum *dstErr);
+extern WlzErrorNum		WlzValueCmpDecodeBlk(
+				  const WlzUByte *buf,
+				  size_t bufSz,
+				  int blk,
+				  WlzUByte *dst,
+				  size_t *dstSz);
+extern WlzErrorNum		WlzValueCmpInfo(
+				  const WlzUByte *buf,
+				  size_t bufSz,
+				  size_t *dstHdrSz,
+				  size_t *dstRawSz,
+				  size_t *dstBlkSz,
+				  int *dstNBlk);
+extern WlzValueCmpStream	*WlzValueCmpStreamOpen(
+				  FILE *fP,
+				  WlzIOCompression cmp,
+				  int eSz,
+				  int delta,
+				  const WlzUByte *hdr,
+				  size_t hdrSz,
+				  size_t blkSz,
+				  WlzErrorNum *dstErr);
+extern WlzErrorNum		WlzValueCmpStreamPut(
+				  WlzValueCmpStream *str,
+				  const WlzUByte *raw,
+				  size_t n);
+extern WlzUByte			*WlzValueCmpStreamClose(
+				  WlzValueCmpStream *str,
+				  size_t *dstSz,
+				  WlzErrorNum *dstErr);
+extern WlzUByte			*WlzValueCmpRead(
+				  FILE *fP,
+				  size_t *dstSz,
+				  WlzErrorNum *dstErr);
+#endif /* WLZ_EXT_BIND */
+
 /************************************************************************
 * WlzValuesFromCoords.c							*
 ************************************************************************/
@@ -6948,6 +7327,25 @@ extern const char 		*WlzWindowFnName(
 extern WlzErrorNum 		WlzWriteObj(
 				  FILE *fp,
 			          WlzObject *obj);
+extern WlzErrorNum 		WlzWriteObjCmp(
+				  FILE *fp,
+			          WlzObject *obj,
+				  WlzIOCompression cmp);
+#ifndef WLZ_EXT_BIND
+extern WlzPlaneStream		*WlzPlaneStreamWriteOpen(
+				  FILE *fP,
+				  FILE *spool,
+				  int plane1,
+				  int lastpl,
+				  WlzDVertex3 voxSz,
+				  WlzIOCompression cmp,
+				  WlzErrorNum *dstErr);
+extern WlzErrorNum		WlzPlaneStreamWritePlane(
+				  WlzPlaneStream *pS,
+				  WlzObject *obj);
+extern WlzErrorNum		WlzPlaneStreamWriteClose(
+				  WlzPlaneStream *pS);
+#endif /* !WLZ_EXT_BIND */
 
 #ifndef WLZ_EXT_BIND
 extern WlzErrorNum  		WlzWriteMeshTransform3D(
@@ -7084,6 +7482,20 @@ extern WlzObject		*WlzXORDom(
 				  WlzObject *o0,
 				  WlzObject *o1,
 				  WlzErrorNum *dstErr);
+
+/************************************************************************
+* WlzZonalStats.c							*
+************************************************************************/
+extern WlzZonalStats		*WlzZonalGreyStats(
+				  WlzObject *gObj,
+				  WlzObject *lObj,
+				  int nZone,
+				  int nBin,
+				  double binOrg,
+				  double binWidth,
+				  WlzErrorNum *dstErr);
+extern WlzErrorNum		WlzFreeZonalStats(
+				  WlzZonalStats *zs);
 #endif /* !WLZ_EXT_BIND */
 
 #ifndef WLZ_EXT_BIND
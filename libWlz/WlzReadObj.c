@@ -50,6 +50,11 @@ static char _WlzReadObj_c[] = "University of Edinburgh $Id$";
 #include <sys/mman.h>
 #endif
 
+/* Value table mapping modes for WlzReadObjMapped(). */
+#define WLZ_READOBJ_MAP_NONE	(0)	/* Values are read. */
+#define WLZ_READOBJ_MAP_COW	(1)	/* Values are mapped copy on write. */
+#define WLZ_READOBJ_MAP_RDONLY	(2)	/* Values are mapped read only. */
+
 /* #define WLZ_DEBUG_READOBJ */
 #define WLZ_OLD_CMESH_TRANS_SUPPORT
 
@@ -63,20 +68,28 @@ static WlzIntervalDomain 	*WlzReadIntervalDomain(
 static WlzPlaneDomain 		*WlzReadPlaneDomain(
 				  FILE *fp,
 				  WlzErrorNum *);
+static WlzObject		*WlzReadObjWithMap(
+				  FILE *fp,
+				  int map,
+				  WlzErrorNum *dstErr);
 static WlzErrorNum		WlzReadGreyValues(
 				  FILE *fp,
 				  WlzObjectType type,
-				  WlzObject *obj);
+				  WlzObject *obj,
+				  int map);
 static WlzErrorNum		WlzReadRectVtb(
 				  FILE *fp,
 				  WlzObject *obj,
-				  WlzObjectType type);
+				  WlzObjectType type,
+				  int map);
 static WlzErrorNum 		WlzReadDomObjValues2D(
 				  FILE *fP,
-				  WlzObject *obj);
+				  WlzObject *obj,
+				  int map);
 static WlzErrorNum 		WlzReadDomObjValues3D(
 				  FILE *fP,
-				  WlzObject *obj);
+				  WlzObject *obj,
+				  int map);
 static WlzErrorNum 		WlzReadTiledValues(
 				  FILE *fP,
 				  WlzObject *obj,
@@ -85,6 +98,11 @@ static WlzErrorNum 		WlzReadTiledValues(
 				  int map);
 static WlzErrorNum		WlzReadVoxelValues(
 				  FILE *fp,
+				  WlzObject *obj,
+				  int map);
+static WlzErrorNum		WlzReadCmpGreyValues(
+				  WlzUByte *buf,
+				  size_t bufSz,
 				  WlzObject *obj);
 static WlzProperty	 	WlzReadProperty(
 				  FILE *fp,
@@ -107,10 +125,15 @@ static WlzHistogramDomain 	*WlzReadHistogramDomain(
 static WlzObject 		*WlzReadCompoundA(
 				  FILE *fp,
 				  WlzObjectType type,
+				  int map,
 				  WlzErrorNum *);
 static WlzAffineTransform 	*WlzReadAffineTransform(
 				  FILE *fp,
 				  WlzErrorNum *);
+static WlzDispFieldTransform 	*WlzReadDispFieldTransform(
+				  FILE *fp,
+				  int map,
+				  WlzErrorNum *);
 static WlzWarpTrans 		*WlzReadWarpTrans(
 				  FILE *fp,
 				  WlzErrorNum *);
@@ -411,6 +434,80 @@ WlzObjectType	WlzReadObjType(FILE *fP, WlzErrorNum *dstErr)
 * \param	dstErr			Destination error pointer, may be NULL.
 */
 WlzObject 	*WlzReadObj(FILE *fp, WlzErrorNum *dstErr)
+{
+  return(WlzReadObjWithMap(fp, WLZ_READOBJ_MAP_NONE, dstErr));
+}
+
+/*!
+* \return	New Woolz object or NULL on error.
+* \ingroup	WlzIO
+* \brief	Reads a woolz object from the given file, as WlzReadObj(),
+* 		but with the values of rectangular value tables memory
+* 		mapped from the file rather than read into allocated
+* 		memory wherever the values are stored uncompressed, with
+* 		the same grey type in the file as in the table and with
+* 		the file's byte ordering matching the host's. This
+* 		includes the planes of 3D objects and the rectangular
+* 		value tables of objects within compound and transformed
+* 		objects. Values which can not be mapped (eg floats, which
+* 		are not stored in native format, or compressed values)
+* 		are read as by WlzReadObj().
+* 		The mappings are private, so unless read only they are
+* 		copy on write and changes to the object's values never
+* 		modify the file. Processes mapping the same file share
+* 		its pages in the page cache until they are written to.
+* 		Tiled value tables are mapped as by WlzReadObj().
+* 		Each mapping is unmapped when the value table holding
+* 		it is free'd and the file is closed before this function
+* 		returns.
+* \param	fileName		Name of the file to read.
+* \param	readOnly		If non-zero the mappings are read only
+* 					and any attempt to modify the mapped
+* 					values will fault, otherwise the
+* 					mappings are copy on write.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzObject	*WlzReadObjMapped(const char *fileName, int readOnly,
+				  WlzErrorNum *dstErr)
+{
+  FILE		*fP = NULL;
+  WlzObject	*obj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(fileName == NULL)
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if((fP = fopen(fileName, "rb")) == NULL)
+  {
+    errNum = WLZ_ERR_READ_EOF;
+  }
+  else
+  {
+    obj = WlzReadObjWithMap(fP, (readOnly)? WLZ_READOBJ_MAP_RDONLY:
+    					    WLZ_READOBJ_MAP_COW, &errNum);
+    (void )fclose(fP);
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(obj);
+}
+
+/*!
+* \return	New Woolz object or NULL on error.
+* \ingroup	WlzIO
+* \brief	Reads a woolz object from the given input stream,
+* 		optionaly mapping rectangular value tables.
+* \param	fp			Input file.
+* \param	map			Value table mapping mode, one of
+* 					WLZ_READOBJ_MAP_NONE,
+* 					WLZ_READOBJ_MAP_COW or
+* 					WLZ_READOBJ_MAP_RDONLY.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+static WlzObject *WlzReadObjWithMap(FILE *fp, int map, WlzErrorNum *dstErr)
 {
   WlzObjectType		type;
   WlzObject 		*obj;
@@ -448,7 +545,7 @@ WlzObject 	*WlzReadObj(FILE *fp, WlzErrorNum *dstErr)
 	   ((obj = WlzMakeMain(type, domain, values, NULL, NULL,
 			       &errNum)) != NULL))
 	{
-	  if((errNum = WlzReadDomObjValues2D(fp, obj)) == WLZ_ERR_NONE)
+	  if((errNum = WlzReadDomObjValues2D(fp, obj, map)) == WLZ_ERR_NONE)
 	  {
 	    obj->plist = WlzAssignPropertyList(WlzReadPropertyList(fp, NULL),
 					       NULL);
@@ -463,7 +560,7 @@ WlzObject 	*WlzReadObj(FILE *fp, WlzErrorNum *dstErr)
 	   ((obj = WlzMakeMain(type, domain, values, NULL, NULL,
 			       &errNum)) != NULL ))
 	{
-	  if((errNum = WlzReadDomObjValues3D(fp, obj)) == WLZ_ERR_NONE)
+	  if((errNum = WlzReadDomObjValues3D(fp, obj, map)) == WLZ_ERR_NONE)
 	  {
 	    obj->plist = WlzAssignPropertyList(WlzReadPropertyList(fp, NULL),
 					       NULL);
@@ -475,7 +572,7 @@ WlzObject 	*WlzReadObj(FILE *fp, WlzErrorNum *dstErr)
 
       case WLZ_TRANS_OBJ:
 	if((domain.t = WlzReadAffineTransform(fp, &errNum)) != NULL){
-	  if((values.obj = WlzReadObj(fp, &errNum)) != NULL){
+	  if((values.obj = WlzReadObjWithMap(fp, map, &errNum)) != NULL){
 	    if((obj = WlzMakeMain(WLZ_TRANS_OBJ, domain, values,
 				  NULL, NULL, &errNum)) != NULL){
 	      obj->plist = WlzAssignPropertyList(WlzReadPropertyList(fp, NULL),
@@ -612,7 +709,7 @@ WlzObject 	*WlzReadObj(FILE *fp, WlzErrorNum *dstErr)
 
       case WLZ_COMPOUND_ARR_1:
       case WLZ_COMPOUND_ARR_2:
-	obj = (WlzObject *) WlzReadCompoundA(fp, type, &errNum);
+	obj = (WlzObject *) WlzReadCompoundA(fp, type, map, &errNum);
 	break;
 
       case WLZ_PROPERTY_OBJ:
@@ -624,6 +721,14 @@ WlzObject 	*WlzReadObj(FILE *fp, WlzErrorNum *dstErr)
 	  obj = WlzMakeMain(type, domain, values, NULL, NULL, &errNum);
 	}
 	break;
+      case WLZ_DISP_TRANS:
+	if((domain.df = WlzReadDispFieldTransform(fp, map, &errNum)) != NULL){
+	  if((obj = WlzMakeMain(type, domain, values, NULL, NULL,
+	                        &errNum)) == NULL){
+	    (void )WlzFreeDispFieldTransform(domain.df);
+	  }
+	}
+	break;
       case WLZ_CONV_HULL:
 	domain = WlzReadConvexHull(fp, &errNum);
 	if(errNum == WLZ_ERR_NONE)
@@ -650,6 +755,288 @@ WlzObject 	*WlzReadObj(FILE *fp, WlzErrorNum *dstErr)
   return(obj);
 }
 
+/*!
+* \return	New plane stream or NULL on error.
+* \ingroup	WlzIO
+* \brief	Opens a plane stream for reading the planes of a 3D domain
+* 		object, one at a time, from the given file. The file must
+* 		be positioned at the start of the object and must be
+* 		seekable because the plane domains and the plane values
+* 		are stored in separate sections of the file. The plane
+* 		domains are read (and then discarded) to find the start of
+* 		the values. The object's planes must have interval domains
+* 		and the values (if any) must not be tiled.
+* 		On error the file position is undefined.
+* 		The stream should be freed using WlzPlaneStreamFree().
+* \param	fP			Input file.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzPlaneStream	*WlzPlaneStreamReadOpen(FILE *fP, WlzErrorNum *dstErr)
+{
+  int		idP;
+  WlzObjectType	type;
+  WlzPlaneStream *pS = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(fP == NULL)
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else
+  {
+    type = WlzReadObjType(fP, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if(type == (WlzObjectType )EOF)
+      {
+        errNum = WLZ_ERR_READ_EOF;
+      }
+      else if(type == WLZ_NULL)
+      {
+        errNum = WLZ_ERR_EOO;
+      }
+      else if(type != WLZ_3D_DOMAINOBJ)
+      {
+        errNum = WLZ_ERR_OBJECT_TYPE;
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((pS = (WlzPlaneStream *)
+             AlcCalloc(1, sizeof(WlzPlaneStream))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      pS->flags = WLZ_IOFLAGS_READ;
+      pS->fP = fP;
+    }
+  }
+  /* Read the plane domain header. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    type = (WlzObjectType )getc(fP);
+    if(type == (WlzObjectType )EOF)
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+    }
+    else if((type != WLZ_PLANEDOMAIN_DOMAIN) && (type != (WlzObjectType )2))
+    {
+      errNum = WLZ_ERR_DOMAIN_TYPE;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    pS->plane1 = getword(fP);
+    pS->lastpl = getword(fP);
+    pS->line1 = getword(fP);
+    pS->lastln = getword(fP);
+    pS->kol1 = getword(fP);
+    pS->lastkl = getword(fP);
+    pS->voxelSz[0] = getfloat(fP);
+    pS->voxelSz[1] = getfloat(fP);
+    pS->voxelSz[2] = getfloat(fP);
+    pS->plane = pS->plane1;
+    for(idP = pS->plane1; idP <= pS->lastpl; ++idP)
+    {
+      (void )getfloat(fP);
+    }
+    if(feof(fP) != 0)
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+    }
+    else if((pS->domOff = ftell(fP)) < 0)
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+    }
+  }
+  /* Skip the plane domains to find the plane values. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    for(idP = pS->plane1; (errNum == WLZ_ERR_NONE) && (idP <= pS->lastpl);
+	++idP)
+    {
+      WlzIntervalDomain *iDom;
+
+      if((iDom = WlzReadIntervalDomain(fP, &errNum)) != NULL)
+      {
+	(void )WlzFreeIntervalDomain(iDom);
+      }
+      else if(errNum == WLZ_ERR_EOO)
+      {
+	errNum = WLZ_ERR_NONE;
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    type = (WlzObjectType )getc(fP);
+    if(type == (WlzObjectType )EOF)
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+    }
+    else if(type == WLZ_VOXELVALUETABLE_GREY)
+    {
+      pS->values = 1;
+      pS->bckgrnd = getword(fP);
+    }
+    else if(type != WLZ_NULL)
+    {
+      errNum = WLZ_ERR_VALUES_TYPE;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((feof(fP) != 0) || ((pS->valOff = ftell(fP)) < 0))
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+    }
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    AlcFree(pS);
+    pS = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(pS);
+}
+
+/*!
+* \return	New 2D domain object or empty object for the next plane,
+* 		NULL on error or when all planes have been read.
+* \ingroup	WlzIO
+* \brief	Reads the next plane from a plane stream which was opened
+* 		using WlzPlaneStreamReadOpen(). The plane coordinate of
+* 		the returned object is the stream's plane member before the
+* 		call. When all the planes have been read NULL is returned
+* 		with the error code WLZ_ERR_EOO. After the last plane has
+* 		been read the object's property list is read into the
+* 		stream and the file is left positioned after the object.
+* \param	pS			Given plane stream.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzObject	*WlzPlaneStreamReadPlane(WlzPlaneStream *pS,
+					 WlzErrorNum *dstErr)
+{
+  WlzDomain	dom;
+  WlzValues	val;
+  WlzObject	*obj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  dom.core = NULL;
+  val.core = NULL;
+  if(pS == NULL)
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if(pS->flags != WLZ_IOFLAGS_READ)
+  {
+    errNum = WLZ_ERR_PARAM_TYPE;
+  }
+  else if(pS->plane > pS->lastpl)
+  {
+    errNum = WLZ_ERR_EOO;
+  }
+  else if(fseek(pS->fP, pS->domOff, SEEK_SET) != 0)
+  {
+    errNum = WLZ_ERR_READ_INCOMPLETE;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((dom.i = WlzReadIntervalDomain(pS->fP, &errNum)) == NULL)
+    {
+      if(errNum == WLZ_ERR_EOO)
+      {
+        errNum = WLZ_ERR_NONE;
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if(((pS->domOff = ftell(pS->fP)) < 0) ||
+         (fseek(pS->fP, pS->valOff, SEEK_SET) != 0))
+      {
+        errNum = WLZ_ERR_READ_INCOMPLETE;
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(dom.core == NULL)
+    {
+      obj = WlzMakeEmpty(&errNum);
+    }
+    else
+    {
+      obj = WlzMakeMain(WLZ_2D_DOMAINOBJ, dom, val, NULL, NULL, &errNum);
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && pS->values)
+  {
+    WlzObjectType gtt;
+
+    gtt = (WlzObjectType )getc(pS->fP);
+    if(gtt == (WlzObjectType )WLZ_IOCMP_MARKER)
+    {
+      size_t	bufSz = 0;
+      WlzUByte	*buf;
+
+      buf = WlzValueCmpRead(pS->fP, &bufSz, &errNum);
+      if((errNum == WLZ_ERR_NONE) && (dom.core != NULL))
+      {
+	errNum = WlzReadCmpGreyValues(buf, bufSz, obj);
+      }
+      AlcFree(buf);
+    }
+    else if(dom.core != NULL)
+    {
+      errNum = WlzReadGreyValues(pS->fP, gtt, obj, WLZ_READOBJ_MAP_NONE);
+    }
+    else if(gtt != WLZ_NULL)
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((pS->valOff = ftell(pS->fP)) < 0)
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+    }
+    else if(++(pS->plane) > pS->lastpl)
+    {
+      pS->plist = WlzAssignPropertyList(
+                  WlzReadPropertyList(pS->fP, &errNum), NULL);
+      if(errNum == WLZ_ERR_EOO)
+      {
+        /* The object has no property list. */
+        errNum = WLZ_ERR_NONE;
+      }
+    }
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    if(obj)
+    {
+      (void )WlzFreeObj(obj);
+      obj = NULL;
+    }
+    else if(dom.core)
+    {
+      (void )WlzFreeDomain(dom);
+    }
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(obj);
+}
+
 /*!
 * \return	Woolz error code.
 * \ingroup	WlzIO
@@ -1466,9 +1853,11 @@ static WlzPlaneDomain *WlzReadPlaneDomain(FILE *fp,
 * \param	type			Type encoding grey and table type.
 * \param	obj			Object defining the domain of the
 *					grey values.
+* \param	map			Value table mapping mode, see
+* 					WlzReadObjWithMap().
 */
 static WlzErrorNum WlzReadGreyValues(FILE *fp, WlzObjectType type,
-				     WlzObject *obj)
+				     WlzObject *obj, int map)
 {
   WlzGreyType		gtype;
   WlzIntervalWSpace 	iwsp;
@@ -1881,7 +2270,7 @@ static WlzErrorNum WlzReadGreyValues(FILE *fp, WlzObjectType type,
   case WLZ_VALUETABLE_RECT_FLOAT:
   case WLZ_VALUETABLE_RECT_DOUBLE:
   case WLZ_VALUETABLE_RECT_RGBA:
-    return WlzReadRectVtb(fp, obj, type);
+    return WlzReadRectVtb(fp, obj, type, map);
 
   default:
     /* this can't happen because the domain type has been checked
@@ -1899,13 +2288,19 @@ static WlzErrorNum WlzReadGreyValues(FILE *fp, WlzObjectType type,
 * \param	obj			Object defining the domain of the
 *					grey values.
 * \param	type			Grey table type - encodes greytype.
+* \param	map			Value table mapping mode, see
+* 					WlzReadObjWithMap(). Values are
+* 					only mapped if they are stored
+* 					unpacked in native byte order.
 */
 static WlzErrorNum WlzReadRectVtb(FILE 		*fp,
 				  WlzObject 	*obj,
-				  WlzObjectType type)
+				  WlzObjectType type,
+				  int		map)
 {
   WlzGreyP		values;
   int 			i, num;
+  int			mapped = 0;
   WlzGreyType		packing;
   WlzIntervalDomain 	*idmn;
   WlzValues		vtb;
@@ -1931,42 +2326,89 @@ static WlzErrorNum WlzReadRectVtb(FILE 		*fp,
   switch( WlzGreyTableTypeToGreyType( type, NULL ) ){
   case WLZ_GREY_INT:
     vtb.r->bckgrnd.v.inv = getword(fp);
-    values.inp = (int *) AlcMalloc(num*sizeof(int));
     break;
   case WLZ_GREY_SHORT:
     vtb.r->bckgrnd.v.shv = (short )getword(fp);
-    values.shp = (short *) AlcMalloc(num*sizeof(short));
     break;
   case WLZ_GREY_UBYTE:
     vtb.r->bckgrnd.v.ubv = (WlzUByte )getword(fp);
-    values.ubp = (WlzUByte *) AlcMalloc(num*sizeof(WlzUByte));
     break;
   case WLZ_GREY_FLOAT:
     vtb.r->bckgrnd.v.flv = getfloat(fp);
-    values.flp = (float *) AlcMalloc(num*sizeof(float));
     break;
   case WLZ_GREY_DOUBLE:
     vtb.r->bckgrnd.v.dbv = getdouble(fp);
-    values.dbp = (double *) AlcMalloc(num*sizeof(double));
     break;
   case WLZ_GREY_RGBA:
     vtb.r->bckgrnd.v.rgbv = getword(fp);
-    values.rgbp = (WlzUInt *) AlcMalloc(num*sizeof(WlzUInt));
     break;
   default:
     return WLZ_ERR_GREY_TYPE;
     break;
   }
 
-  if( values.inp == NULL ){
-    WlzFreeValueTb(vtb.v);
-    return WLZ_ERR_MEM_ALLOC;
+  /* Map the values if they are stored exactly as they are held in memory,
+   * otherwise (or if mapping fails) allocate space and read them. Floats
+   * are never mapped as they are always converted. */
+  values.v = NULL;
+  if((map != WLZ_READOBJ_MAP_NONE) && (fileno(fp) >= 0)){
+    switch( WlzGreyTableTypeToGreyType( type, NULL ) ){
+    case WLZ_GREY_UBYTE:
+      mapped = 1;
+      break;
+#if defined (__x86) || defined (__alpha)
+    case WLZ_GREY_INT:    /* FALLTHROUGH */
+    case WLZ_GREY_SHORT:  /* FALLTHROUGH */
+    case WLZ_GREY_DOUBLE: /* FALLTHROUGH */
+    case WLZ_GREY_RGBA:
+      mapped = packing == WlzGreyTableTypeToGreyType( type, NULL );
+      break;
+#endif /* __x86 || __alpha */
+    default:
+      break;
+    }
+    if( mapped ){
+      long	off;
+      size_t	len;
+
+      len = num * WlzGreySize(WlzGreyTableTypeToGreyType( type, NULL ));
+      mapped = 0;
+      if((off = ftell(fp)) >= 0){
+        values.v = WlzMapFileRegion(fileno(fp), off, len,
+				    map == WLZ_READOBJ_MAP_RDONLY,
+				    &(vtb.r->freeptr), NULL);
+	if(values.v != NULL){
+	  if(fseek(fp, off + (long )len, SEEK_SET) == 0){
+	    mapped = 1;
+	  }
+	  else{
+	    /* Can't skip the mapped values so abandon the mapping and
+	     * read them from the unchanged file position. */
+	    (void )WlzUnmapFileRegion(&(vtb.r->freeptr));
+	    values.v = NULL;
+	  }
+	}
+      }
+    }
+  }
+  if( values.v == NULL ){
+    values.v = AlcMalloc(num *
+                   WlzGreySize(WlzGreyTableTypeToGreyType( type, NULL )));
+    if( values.v == NULL ){
+      WlzFreeValueTb(vtb.v);
+      return WLZ_ERR_MEM_ALLOC;
+    }
+    vtb.r->freeptr = AlcFreeStackPush(vtb.r->freeptr, (void *)values.inp,
+				      NULL);
   }
-  vtb.r->freeptr = AlcFreeStackPush(vtb.r->freeptr, (void *)values.inp, NULL);
   vtb.r->values = values;
   obj->values = WlzAssignValues(vtb, NULL);
 
-  switch( WlzGreyTableTypeToGreyType( type, NULL ) ) {
+  switch( (mapped)? WLZ_GREY_ERROR: WlzGreyTableTypeToGreyType( type, NULL ) ) {
+
+  case WLZ_GREY_ERROR:
+    /* Values are mapped. */
+    break;
 
   case WLZ_GREY_INT:
     switch (packing) {
@@ -2052,8 +2494,10 @@ static WlzErrorNum WlzReadRectVtb(FILE 		*fp,
 * \param	obj			Object defining the domain of the
 *					grey values. The domain is known to
 *					be non NULL.
+* \param	map			Value table mapping mode, see
+* 					WlzReadObjWithMap().
 */
-static WlzErrorNum WlzReadDomObjValues2D(FILE *fP, WlzObject *obj)
+static WlzErrorNum WlzReadDomObjValues2D(FILE *fP, WlzObject *obj, int map)
 {
   WlzObjectType	type;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
@@ -2067,6 +2511,18 @@ static WlzErrorNum WlzReadDomObjValues2D(FILE *fP, WlzObject *obj)
   {
     obj->values.core = NULL;
   }
+  else if(type == (WlzObjectType )WLZ_IOCMP_MARKER)
+  {
+    size_t	bufSz = 0;
+    WlzUByte	*buf;
+
+    buf = WlzValueCmpRead(fP, &bufSz, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = WlzReadCmpGreyValues(buf, bufSz, obj);
+    }
+    AlcFree(buf);
+  }
   else
   {
     switch(type)
@@ -2080,7 +2536,7 @@ static WlzErrorNum WlzReadDomObjValues2D(FILE *fP, WlzObject *obj)
 	errNum = WlzReadTiledValues(fP, obj, 2, type, 1);
 	break;
       default:
-        errNum = WlzReadGreyValues(fP, type, obj);
+        errNum = WlzReadGreyValues(fP, type, obj, map);
 	break;
     }
   }
@@ -2097,8 +2553,10 @@ static WlzErrorNum WlzReadDomObjValues2D(FILE *fP, WlzObject *obj)
 * \param	obj			Object defining the domain of the
 *					grey values. The domain is known to
 *					be non NULL.
+* \param	map			Value table mapping mode, see
+* 					WlzReadObjWithMap().
 */
-static WlzErrorNum WlzReadDomObjValues3D(FILE *fP, WlzObject *obj)
+static WlzErrorNum WlzReadDomObjValues3D(FILE *fP, WlzObject *obj, int map)
 {
   WlzObjectType	type;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
@@ -2117,7 +2575,7 @@ static WlzErrorNum WlzReadDomObjValues3D(FILE *fP, WlzObject *obj)
     switch(type)
     {
       case WLZ_VOXELVALUETABLE_GREY:
-        errNum = WlzReadVoxelValues(fP, obj);
+        errNum = WlzReadVoxelValues(fP, obj, map);
 	break;
       case WLZ_VALUETABLE_TILED_INT:    /* FALLTHROUGH */
       case WLZ_VALUETABLE_TILED_SHORT:  /* FALLTHROUGH */
@@ -2149,12 +2607,15 @@ static WlzErrorNum WlzReadDomObjValues3D(FILE *fP, WlzObject *obj)
 * 					encodes both the grey type and the
 * 					value table type.
 * \param	map			If non zero the tiles are memory
-* 					mapped rather than read.
+* 					mapped rather than read. Compressed
+* 					tiles and tiles when memory mapping
+* 					is not available are always read.
 */
 static WlzErrorNum WlzReadTiledValues(FILE *fP, WlzObject *obj,
 				      int dim, WlzObjectType type,
 				      int map)
 {
+  int		cmp = 0;
   WlzGreyType	gType;
   WlzTiledValues *tVal = NULL;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
@@ -2164,10 +2625,19 @@ static WlzErrorNum WlzReadTiledValues(FILE *fP, WlzObject *obj,
   {
     int		tDim;
 
-    if((tDim = getc(fP)) != dim)
+    /* Bit 7 of the dimension is set for compressed tiles. */
+    if((tDim = getc(fP)) == EOF)
     {
       errNum = WLZ_ERR_READ_INCOMPLETE;
     }
+    else
+    {
+      cmp = (tDim & 0x80) != 0;
+      if((tDim & 0x7f) != dim)
+      {
+	errNum = WLZ_ERR_READ_INCOMPLETE;
+      }
+    }
   }
   if(errNum == WLZ_ERR_NONE)
   {
@@ -2210,7 +2680,42 @@ static WlzErrorNum WlzReadTiledValues(FILE *fP, WlzObject *obj,
       errNum = WlzReadInt(fP, (int *)(tVal->indices), nIdx);
     }
   }
-  if(errNum == WLZ_ERR_NONE)
+  if((errNum == WLZ_ERR_NONE) && cmp)
+  {
+    /* Compressed tiles are never mapped, instead each tile is decoded
+     * into memory when it is first accessed. */
+    int		nBlk = 0;
+    size_t	gSz,
+    		hdrSz = 0,
+		blkSz = 0,
+    		rawSz = 0;
+
+    gSz = WlzGreySize(gType);
+    tVal->fd = -1;
+    tVal->cmpTiles = WlzValueCmpRead(fP, &(tVal->cmpTilesSz), &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = WlzValueCmpInfo(tVal->cmpTiles, tVal->cmpTilesSz,
+      			       &hdrSz, &rawSz, &blkSz, &nBlk);
+    }
+    if((errNum == WLZ_ERR_NONE) &&
+       ((hdrSz != 0) || (blkSz != tVal->tileSz * gSz) ||
+        ((size_t )nBlk != tVal->numTiles) ||
+        (rawSz != tVal->numTiles * tVal->tileSz * gSz)))
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if(((tVal->tiles.v = AlcMalloc(WLZ_MAX(rawSz, 1))) == NULL) ||
+         ((tVal->tileDecoded = (WlzUByte *)
+	                       AlcCalloc(WLZ_MAX(nBlk, 1), 1)) == NULL))
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+    }
+  }
+  else if(errNum == WLZ_ERR_NONE)
   {
     WlzLong	off[2];
 
@@ -2236,13 +2741,17 @@ static WlzErrorNum WlzReadTiledValues(FILE *fP, WlzObject *obj,
       tVal->tileOffset = (long )(off[1] << 32) | (long )(off[0]);
     }
   }
-  if(errNum == WLZ_ERR_NONE)
+  if((errNum == WLZ_ERR_NONE) && !cmp)
   {
     size_t	gSz,
       		tSz;
 
     gSz = WlzGreySize(gType);
     tSz = tVal->numTiles * tVal->tileSz;
+#ifndef WLZ_USE_MMAP
+    /* Without memory mapping the tiles are always read. */
+    map = 0;
+#endif /* WLZ_USE_MMAP */
     if(map == 0)
     {
       tVal->fd = -1;
@@ -2277,25 +2786,42 @@ static WlzErrorNum WlzReadTiledValues(FILE *fP, WlzObject *obj,
       }
       else
       {
-	tVal->tiles.v = mmap(NULL, tSz * gSz, PROT_READ | PROT_WRITE,
-			     MAP_SHARED | MAP_FILE |MAP_NORESERVE,
-			     tVal->fd, tVal->tileOffset);
-	if(tVal->tiles.v == MAP_FAILED)
+	long	pgSz,
+		pgOff;
+	void	*addr;
+
+	/* Mapping offsets must be page aligned but the tile offset is
+	 * only aligned to the tile size, so the mapping starts at the
+	 * page containing the first tile. */
+	pgSz = sysconf(_SC_PAGESIZE);
+	pgOff = (pgSz > 0)? tVal->tileOffset % pgSz: 0;
+	addr = mmap(NULL, (tSz * gSz) + pgOff, PROT_READ | PROT_WRITE,
+		    MAP_SHARED | MAP_FILE |MAP_NORESERVE,
+		    tVal->fd, tVal->tileOffset - pgOff);
+	if(addr == MAP_FAILED)
 	{
-	  tVal->tiles.v = mmap(NULL, tSz * gSz, PROT_READ,
-			       MAP_PRIVATE | MAP_FILE |MAP_NORESERVE,
-			       tVal->fd, tVal->tileOffset);
+	  addr = mmap(NULL, (tSz * gSz) + pgOff, PROT_READ,
+		      MAP_PRIVATE | MAP_FILE |MAP_NORESERVE,
+		      tVal->fd, tVal->tileOffset - pgOff);
 	}
-	if(tVal->tiles.v == MAP_FAILED)
+	if(addr == MAP_FAILED)
 	{
+	  (void )close(tVal->fd);
 	  tVal->fd = -1;
 	  tVal->tiles.v = NULL;
 	  errNum = WLZ_ERR_READ_INCOMPLETE;
 	}
+	else
+	{
+	  tVal->tiles.v = (WlzUByte *)addr + pgOff;
+	  /* Leave the file positioned after the tiles, as when they are
+	   * read, so that any following data can be read. */
+	  if(fseek(fP, tVal->tileOffset + (long )(tSz * gSz), SEEK_SET) != 0)
+	  {
+	    errNum = WLZ_ERR_READ_INCOMPLETE;
+	  }
+	}
       }
-#else /* WLZ_USE_MMAP */
-      tVal->tiles.v = NULL;
-      errNum = WLZ_ERR_READ_INCOMPLETE;
 #endif /* WLZ_USE_MMAP */
     }
   }
@@ -2365,13 +2891,20 @@ static WlzErrorNum WlzReadTiledValues(FILE *fP, WlzObject *obj,
 * \ingroup	WlzIO
 * \brief	Reads a Woolz voxel value table from the input file.
 * 		The table type has already been read and verified.
+* 		Compressed plane value tables are read in order and
+* 		then decompressed in parallel.
 * \param	fp			Input file.
 * \param	obj			Object defining the domain of the
 *					grey values.
+* \param	map			Value table mapping mode, see
+* 					WlzReadObjWithMap().
 */
-static WlzErrorNum WlzReadVoxelValues(FILE *fp, WlzObject *obj)
+static WlzErrorNum WlzReadVoxelValues(FILE *fp, WlzObject *obj, int map)
 {
-  int 			i, nplanes;
+  int 			i, nplanes,
+  			nCmp = 0;
+  size_t		*cSz = NULL;
+  WlzUByte		**cBuf = NULL;
   WlzObject 		*tmpobj;
   WlzDomain 		*domains;
   WlzValues		*values, value;
@@ -2402,6 +2935,12 @@ static WlzErrorNum WlzReadVoxelValues(FILE *fp, WlzObject *obj)
   else {
     return errNum;
   }
+  if(((cBuf = (WlzUByte **)AlcCalloc(nplanes, sizeof(WlzUByte *))) == NULL) ||
+     ((cSz = (size_t *)AlcCalloc(nplanes, sizeof(size_t))) == NULL)){
+    AlcFree(cBuf);
+    (void )WlzFreeVoxelValueTb(voxtab);
+    return WLZ_ERR_MEM_ALLOC;
+  }
 
   for(i=0; i < nplanes; i++, values++, domains++){
     (*values).core = NULL;
@@ -2410,7 +2949,13 @@ static WlzErrorNum WlzReadVoxelValues(FILE *fp, WlzObject *obj)
       WlzObjectType gtt;
 
       gtt = (WlzObjectType )getc(fp);
-      if( (errNum = WlzReadGreyValues(fp, gtt, tmpobj)) == WLZ_ERR_NONE ){
+      if(gtt == (WlzObjectType )WLZ_IOCMP_MARKER){
+        /* Compressed plane values are decompressed below. */
+        if((cBuf[i] = WlzValueCmpRead(fp, &(cSz[i]), &errNum)) != NULL){
+	  ++nCmp;
+	}
+      }
+      else if( (errNum = WlzReadGreyValues(fp, gtt, tmpobj, map)) == WLZ_ERR_NONE ){
 	*values = WlzAssignValues(tmpobj->values, NULL);
 	/* reset voxel-table background */
 	if( (*values).core != NULL ){
@@ -2445,12 +2990,123 @@ static WlzErrorNum WlzReadVoxelValues(FILE *fp, WlzObject *obj)
     /* WlzFreeVoxelValueTb( voxtab );*/
     errNum = WLZ_ERR_READ_INCOMPLETE;
   }
+  if(nCmp > 0){
+    domains = planedm->domains;
+    values = voxtab->values;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for(i = 0; i < nplanes; ++i){
+      if(cBuf[i] != NULL){
+	WlzObject	*pObj;
+	WlzErrorNum	errNum2 = WLZ_ERR_NONE;
+
+	if((pObj = WlzMakeMain(WLZ_2D_DOMAINOBJ, domains[i], values[i],
+			       NULL, NULL, &errNum2)) != NULL){
+	  if((errNum2 = WlzReadCmpGreyValues(cBuf[i], cSz[i],
+	                                     pObj)) == WLZ_ERR_NONE){
+	    values[i] = WlzAssignValues(pObj->values, NULL);
+	  }
+	  else {
+	    WlzFreeDomain(domains[i]);
+	    domains[i].core = NULL;
+	  }
+	  (void )WlzFreeObj(pObj);
+	}
+	if(errNum2 != WLZ_ERR_NONE){
+#ifdef _OPENMP
+#pragma omp critical (WlzReadVoxelValues)
+#endif
+	  {
+	    errNum = errNum2;
+	  }
+	}
+	AlcFree(cBuf[i]);
+	cBuf[i] = NULL;
+      }
+    }
+    /* reset voxel-table background from the last plane with values */
+    for(i = nplanes - 1; i >= 0; --i){
+      if(values[i].core != NULL){
+	WlzObjectType tabType;
+
+        tabType = WlzGreyTableTypeToTableType(values[i].core->type, NULL);
+	if(tabType == WLZ_GREY_TAB_RAGR){
+	  voxtab->bckgrnd = values[i].v->bckgrnd;
+	}
+	else if(tabType == WLZ_GREY_TAB_RECT){
+	  voxtab->bckgrnd = values[i].r->bckgrnd;
+	}
+	else if(tabType == WLZ_GREY_TAB_INTL){
+	  voxtab->bckgrnd = values[i].i->bckgrnd;
+	}
+	break;
+      }
+    }
+  }
+  for(i = 0; i < nplanes; ++i){
+    AlcFree(cBuf[i]);
+  }
+  AlcFree(cBuf);
+  AlcFree(cSz);
   value.vox = voxtab;
   obj->values = WlzAssignValues(value, NULL);
 
   return errNum;
 }
 
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Decompresses a 2D value table which was compressed by
+* 		WlzWriteObjCmp() and then reads it from a memory stream
+* 		using WlzReadGreyValues().
+* \param	buf			Compressed buffer.
+* \param	bufSz			Size of the compressed buffer.
+* \param	obj			Object defining the domain of the
+*					grey values.
+*/
+static WlzErrorNum WlzReadCmpGreyValues(WlzUByte *buf, size_t bufSz,
+					WlzObject *obj)
+{
+  size_t	rawSz = 0;
+  FILE		*mP = NULL;
+  WlzUByte	*raw = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  raw = WlzValueCmpDecode(buf, bufSz, &rawSz, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+#ifdef _WIN32
+    if((mP = tmpfile()) != NULL)
+    {
+      if((fwrite(raw, 1, rawSz, mP) != rawSz) ||
+         (fseek(mP, 0, SEEK_SET) != 0))
+      {
+        (void )fclose(mP);
+	mP = NULL;
+      }
+    }
+#else
+    mP = fmemopen(raw, rawSz, "rb");
+#endif
+    if(mP == NULL)
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    WlzObjectType gtt;
+
+    gtt = (WlzObjectType )getc(mP);
+    errNum = WlzReadGreyValues(mP, gtt, obj, WLZ_READOBJ_MAP_NONE);
+    (void )fclose(mP);
+  }
+  AlcFree(raw);
+  return(errNum);
+}
+
 /*!
 * \return	New Woolz property.
 * \ingroup	WlzIO
@@ -3129,10 +3785,13 @@ static WlzHistogramDomain *WlzReadHistogramDomain(FILE *fp,
 * \brief	Reads a Woolz compund object.
 * \param	fp			Input file.
 * \param	type			Object type as read by WlzReadObj().
+* \param	map			Value table mapping mode, see
+* 					WlzReadObjWithMap().
 * \param	dstErr			Destination error pointer, may be NULL.
 */
 static WlzObject *WlzReadCompoundA(FILE			*fp,
 				   WlzObjectType	type,
+				   int			map,
 				   WlzErrorNum		*dstErr)
 {
   WlzCompoundArray	*c=NULL;
@@ -3158,7 +3817,7 @@ static WlzObject *WlzReadCompoundA(FILE			*fp,
   if((errNum == WLZ_ERR_NONE) &&
      ((c = WlzMakeCompoundArray(type, 1, n, NULL, otype, &errNum)) != NULL)){
     for(i=0; (i<n) && (errNum == WLZ_ERR_NONE); i++){
-      c->o[i] = WlzAssignObject(WlzReadObj(fp, &errNum), NULL);
+      c->o[i] = WlzAssignObject(WlzReadObjWithMap(fp, map, &errNum), NULL);
     }
     if( errNum == WLZ_ERR_NONE ){
       c->plist = WlzAssignPropertyList(WlzReadPropertyList(fp, NULL), NULL);
@@ -3239,6 +3898,61 @@ static WlzAffineTransform *WlzReadAffineTransform(FILE *fp,
   return( trans );
 }
 
+/*!
+* \return	New displacement field transform or NULL on error.
+* \ingroup	WlzIO
+* \brief	Reads a displacement field transform, which is written as
+*		the transform type followed by the compound array object
+*		holding the displacements.
+* \param	fp			Input file.
+* \param	map			Passed to WlzReadObjWithMap() for
+*					reading the displacements.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+static WlzDispFieldTransform *WlzReadDispFieldTransform(FILE *fp, int map,
+						WlzErrorNum *dstErr)
+{
+  int		type;
+  WlzObject	*fObj = NULL;
+  WlzDispFieldTransform *dft = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  type = getc(fp);
+  if(type == EOF)
+  {
+    errNum = WLZ_ERR_READ_INCOMPLETE;
+  }
+  else if(type == WLZ_NULL)
+  {
+    errNum = WLZ_ERR_EOO;
+  }
+  else if((type != WLZ_TRANSFORM_2D_DISP) && (type != WLZ_TRANSFORM_3D_DISP))
+  {
+    errNum = WLZ_ERR_TRANSFORM_TYPE;
+  }
+  else if((fObj = WlzReadObjWithMap(fp, map, &errNum)) != NULL)
+  {
+    if(fObj->type != WLZ_COMPOUND_ARR_1)
+    {
+      errNum = WLZ_ERR_OBJECT_TYPE;
+    }
+    else
+    {
+      dft = WlzMakeDispFieldTransform((WlzTransformType )type,
+				      (WlzCompoundArray *)fObj, &errNum);
+    }
+    if(dft == NULL)
+    {
+      (void )WlzFreeObj(fObj);
+    }
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(dft);
+}
+
 /*!
 * \return	New transform.
 * \brief	Reads a Woolz FE warp transform.
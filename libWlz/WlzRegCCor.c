@@ -42,9 +42,52 @@ static char _WlzRegCCor_c[] = "University of Edinburgh $Id$";
 
 #include <float.h>
 #include <limits.h>
+#include <string.h>
 #include <Wlz.h>
 
 /* #define WLZ_REGCCOR_DEBUG */
+
+/*!
+* \struct	_WlzRegCCorTgt
+* \ingroup	WlzRegistration
+* \brief	Fourier transform of a preprocessed target object array.
+*		This is computed once at each resolution and then reused
+*		for all the translation (or rotation) searches at that
+*		resolution, since only the source object is transformed
+*		between iterations.
+*		Typedef: ::WlzRegCCorTgt.
+*/
+typedef struct _WlzRegCCorTgt
+{
+  int		valid;		/*!< Non-zero if the data are valid. */
+  double	sSq;		/*!< Sum of squares of the target array. */
+  WlzIBox2	oBox;		/*!< Bounding box of the preprocessed
+  				     target object. */
+  WlzIVertex2	aOrg;		/*!< Origin of the array. */
+  WlzIVertex2	aSz;		/*!< Size of the array. */
+  double	**ft;		/*!< Fourier transform of the target
+  				     array. */
+} WlzRegCCorTgt;
+
+static void			WlzRegCCorTgtFree(
+				  WlzRegCCorTgt *tgt);
+static WlzObject		*WlzRegCCorPolarObj2D(
+				  WlzObject *obj,
+				  double angInc,
+				  int angCnt,
+				  WlzWindowFnType winFn,
+				  WlzIBox2 *dstBox,
+				  WlzErrorNum *dstErr);
+static int			WlzRegCCorTgtContains(
+				  WlzRegCCorTgt *tgt,
+				  WlzIBox2 aBox);
+static WlzErrorNum		WlzRegCCorTgtSet(
+				  WlzRegCCorTgt *tgt,
+				  WlzObject *pObj,
+				  WlzIBox2 oBox,
+				  WlzIVertex2 aSz,
+				  WlzIVertex2 aOrg,
+				  int noise);
 static WlzObject 		*WlzRegCCorNormaliseObj2D(
 				  WlzObject *obj,
 				  int inv,
@@ -88,6 +131,7 @@ static WlzDVertex2		WlzRegCCorObjs2DTran(
 				  WlzDVertex2 maxTran,
 				  WlzWindowFnType winFn,
 				  int noise,
+				  WlzRegCCorTgt *tgt,
 				  double *dstCCor,
 				  WlzErrorNum *dstErr);
 static double			WlzRegCCorObjs2DRot(
@@ -97,6 +141,7 @@ static double			WlzRegCCorObjs2DRot(
 				  double maxRot,
 				  WlzWindowFnType winFn,
 				  int noise,
+				  WlzRegCCorTgt *tgt,
 				  WlzErrorNum *dstErr);
 
 /*!
@@ -505,6 +550,9 @@ static WlzAffineTransform *WlzRegCCorObjs2D(WlzObject *tObj, WlzObject *sObj,
       rot1 = rot0;
       tran1.vtX = tran0.vtX / *(samFac + samIdx);
       tran1.vtY = tran0.vtY / *(samFac + samIdx);
+      /* Free the previous level's registration transform which has been
+       * decomposed into rot0 and tran0. */
+      (void )WlzFreeAffineTransform(samRegTr0);
       samRegTr0 = WlzAffineTransformFromPrimVal(WLZ_TRANSFORM_2D_AFFINE,
       					        tran1.vtX, tran1.vtY, 0.0, 1.0, 
 						rot1, 0.0, 0.0, 0.0, 0.0, 0,
@@ -590,6 +638,8 @@ static WlzAffineTransform *WlzRegCCorObjs2D(WlzObject *tObj, WlzObject *sObj,
 *               frequency domain cross correlation.  An affine transform
 *               is computed, which when applied to the source object
 *               takes it into register with the target object.
+*		The Fourier transforms of the preprocessed target object
+*		are computed once and reused for all iterations.
 * \param	tObj			The target object. Must have
 *                                       been assigned.
 * \param	sObj			The source object to be
@@ -635,12 +685,16 @@ static WlzAffineTransform *WlzRegCCorObjs2D1(WlzObject *tObj, WlzObject *sObj,
   double	rot,
   		cCor;
   WlzDVertex2	tran;
+  WlzRegCCorTgt	tgtTran,
+  		tgtRot;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
   const double	tranTol = 0.5;
 
+  (void )memset(&tgtTran, 0, sizeof(WlzRegCCorTgt));
+  (void )memset(&tgtRot, 0, sizeof(WlzRegCCorTgt));
   /* Register for translation. */
   tran = WlzRegCCorObjs2DTran(tObj, sObj, initTr, maxTran, winFn, noise,
-  			      &cCor, &errNum);
+  			      &tgtTran, &cCor, &errNum);
   if(errNum == WLZ_ERR_NONE)
   {
     tTr0 = WlzAffineTransformFromPrimVal(WLZ_TRANSFORM_2D_AFFINE,
@@ -673,7 +727,7 @@ static WlzAffineTransform *WlzRegCCorObjs2D1(WlzObject *tObj, WlzObject *sObj,
     {
       /* Register for rotation. */
       rot = WlzRegCCorObjs2DRot(tObj, sObj, curTr, 
-				maxRot, winFn, noise, &errNum);
+				maxRot, winFn, noise, &tgtRot, &errNum);
       if(errNum == WLZ_ERR_NONE)
       {
 	tTr0 = WlzAffineTransformFromPrimVal(WLZ_TRANSFORM_2D_AFFINE,
@@ -695,7 +749,7 @@ static WlzAffineTransform *WlzRegCCorObjs2D1(WlzObject *tObj, WlzObject *sObj,
       if(errNum == WLZ_ERR_NONE)
       {
 	tran = WlzRegCCorObjs2DTran(tObj, sObj, curTr, maxTran, winFn, noise,
-				    &cCor, &errNum);
+				    &tgtTran, &cCor, &errNum);
       }
       if(errNum == WLZ_ERR_NONE)
       {
@@ -718,6 +772,8 @@ static WlzAffineTransform *WlzRegCCorObjs2D1(WlzObject *tObj, WlzObject *sObj,
     (void )WlzFreeAffineTransform(tTr0);
     (void )WlzFreeAffineTransform(tTr1);
   }
+  WlzRegCCorTgtFree(&tgtTran);
+  WlzRegCCorTgtFree(&tgtRot);
   if(errNum == WLZ_ERR_NONE)
   {
     regTr = curTr;
@@ -744,6 +800,10 @@ static WlzAffineTransform *WlzRegCCorObjs2D1(WlzObject *tObj, WlzObject *sObj,
 *               frequency domain cross correlation, to find
 *               the translation which has the highest cross
 *               correlation value.
+*		The Fourier transform of the preprocessed target object
+*		is kept in the given target data and is only recomputed
+*		if it is not valid or if its array does not cover the
+*		transformed source object and the search range.
 * \param	tObj			The target object. Must have
 *                                       been assigned.
 * \param	sObj			The source object to be
@@ -752,10 +812,11 @@ static WlzAffineTransform *WlzRegCCorObjs2D1(WlzObject *tObj, WlzObject *sObj,
 * \param	initTr			Initial affine transform
 *                                       to be applied to the source
 *                                       object prior to registration.
-* \param        maxTran    		Maximum translation.
 * \param	maxTran			Maximum translation.
 * \param	winFn			Window function.
 * \param	noise			Use Gaussian noise if non-zero.
+* \param	tgt			Target data for reuse between
+* 					calls.
 * \param	dstCCor			Destination ptr for the cross
 *                                       correlation value, may be NULL.
 * \param	dstErr			Destination error pointer,
@@ -765,132 +826,128 @@ static WlzDVertex2 WlzRegCCorObjs2DTran(WlzObject *tObj, WlzObject *sObj,
 					WlzAffineTransform *initTr,
 					WlzDVertex2 maxTran,
 					WlzWindowFnType winFn, int noise,
+					WlzRegCCorTgt *tgt,
 					double *dstCCor, WlzErrorNum *dstErr)
 {
-  int		oIdx;
-  double	cCor = 0.0;
-  double	sSq[2];
-  double	**oAr[2];
-  WlzIBox2	aBox;
-  WlzIBox2	oBox[2],
-  		pBox[2];
+  double	cCor = 0.0,
+  		sSq = 0.0;
+  double	**sAr = NULL;
+  WlzIBox2	aBox,
+  		oBox,
+  		pBox;
   WlzIVertex2	aSz,
   		aOrg,
 		centre,
 		radius,
 		tran;
   WlzDVertex2	dstTran;
-  WlzObject	*oObj[2],
-  		*pObj[2];
+  WlzObject	*oObj = NULL,
+  		*pObj = NULL;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
 
   dstTran.vtX = 0.0;
   dstTran.vtY = 0.0;
-  oAr[0] = oAr[1] = NULL;
-  oObj[0] = oObj[1] = NULL;
-  pObj[0] = pObj[1] = NULL;
-  oObj[0] = WlzAssignObject(tObj, NULL);
   /* Transform source object. */
   if((initTr == NULL) || WlzAffineTransformIsIdentity(initTr, NULL))
   {
-    oObj[1] = WlzAssignObject(sObj, NULL);
+    oObj = WlzAssignObject(sObj, NULL);
   }
   else
   {
-    oObj[1] = WlzAssignObject(
-              WlzAffineTransformObj(sObj, initTr, WLZ_INTERPOLATION_NEAREST,
-				    &errNum), NULL);
+    oObj = WlzAssignObject(
+           WlzAffineTransformObj(sObj, initTr, WLZ_INTERPOLATION_NEAREST,
+				 &errNum), NULL);
   }
-  /* Preprocess the objects. */
+  /* Preprocess the source object. */
   if(errNum == WLZ_ERR_NONE)
   {
-    oIdx = 0;
-    while((errNum == WLZ_ERR_NONE) && (oIdx < 2))
-    {
-      oBox[oIdx] = WlzBoundingBox2I(oObj[oIdx], &errNum);
-      ++oIdx;
-    }
+    oBox = WlzBoundingBox2I(oObj, &errNum);
   }
   if(errNum == WLZ_ERR_NONE)
   {
-    oIdx = 0;
-    while((errNum == WLZ_ERR_NONE) && (oIdx < 2))
-    {
-      centre.vtX = (oBox[oIdx].xMin + oBox[oIdx].xMax) / 2;
-      centre.vtY = (oBox[oIdx].yMin + oBox[oIdx].yMax) / 2;
-      radius.vtX = (oBox[oIdx].xMax - oBox[oIdx].xMin) / 2;
-      radius.vtY = (oBox[oIdx].yMax - oBox[oIdx].yMin) / 2;
-      pObj[oIdx] = WlzAssignObject(
-                   WlzRegCCorPProcessObj2D(oObj[oIdx], winFn, centre, radius,
-      					   &errNum), NULL);
-      ++oIdx;
-    }
+    centre.vtX = (oBox.xMin + oBox.xMax) / 2;
+    centre.vtY = (oBox.yMin + oBox.yMax) / 2;
+    radius.vtX = (oBox.xMax - oBox.xMin) / 2;
+    radius.vtY = (oBox.yMax - oBox.yMin) / 2;
+    pObj = WlzAssignObject(
+	   WlzRegCCorPProcessObj2D(oObj, winFn, centre, radius,
+				   &errNum), NULL);
   }
-  /* Create double arrays. */
   if(errNum == WLZ_ERR_NONE)
   {
-    oIdx = 0;
-    while((errNum == WLZ_ERR_NONE) && (oIdx < 2))
-    {
-      pBox[oIdx] = WlzBoundingBox2I(pObj[oIdx], &errNum);
-      ++oIdx;
-    }
+    pBox = WlzBoundingBox2I(pObj, &errNum);
   }
-  if(errNum == WLZ_ERR_NONE)
+  /* Check that the target array covers the source object and the search
+   * range, if not it must be recomputed. */
+  if((errNum == WLZ_ERR_NONE) && tgt->valid)
   {
-    aBox.xMin = WLZ_MIN(pBox[0].xMin, pBox[1].xMin) - (int )(maxTran.vtX) + 1;
-    aBox.yMin = WLZ_MIN(pBox[0].yMin, pBox[1].yMin) - (int )(maxTran.vtY) + 1;
-    aBox.xMax = WLZ_MAX(pBox[0].xMax, pBox[1].xMax) + (int )(maxTran.vtX) + 1;
-    aBox.yMax = WLZ_MAX(pBox[0].yMax, pBox[1].yMax) + (int )(maxTran.vtY) + 1;
-    aOrg.vtX = aBox.xMin;
-    aOrg.vtY = aBox.yMin;
-    aSz.vtX = aBox.xMax - aBox.xMin + 1;
-    aSz.vtY = aBox.yMax - aBox.yMin + 1;
-    (void )AlgBitNextPowerOfTwo((unsigned int *)&(aSz.vtX), aSz.vtX);
-    (void )AlgBitNextPowerOfTwo((unsigned int *)&(aSz.vtY), aSz.vtY);
-    oIdx = 0;
-    while((errNum == WLZ_ERR_NONE) && (oIdx < 2))
+    aBox.xMin = WLZ_MIN(tgt->oBox.xMin, pBox.xMin) - (int )(maxTran.vtX) + 1;
+    aBox.yMin = WLZ_MIN(tgt->oBox.yMin, pBox.yMin) - (int )(maxTran.vtY) + 1;
+    aBox.xMax = WLZ_MAX(tgt->oBox.xMax, pBox.xMax) + (int )(maxTran.vtX) + 1;
+    aBox.yMax = WLZ_MAX(tgt->oBox.yMax, pBox.yMax) + (int )(maxTran.vtY) + 1;
+    if(!WlzRegCCorTgtContains(tgt, aBox))
     {
-      errNum = WlzToArray2D((void ***)&(oAr[oIdx]), pObj[oIdx], aSz, aOrg,
-      			    noise, WLZ_GREY_DOUBLE);
-      ++oIdx;
+      WlzRegCCorTgtFree(tgt);
     }
   }
-  if((dstCCor != NULL) && (errNum == WLZ_ERR_NONE))
+  /* Preprocess the target object and compute its Fourier transform, only
+   * needed if the target data are not valid. */
+  if((errNum == WLZ_ERR_NONE) && (tgt->valid == 0))
   {
-    oIdx = 0;
-    while((errNum == WLZ_ERR_NONE) && (oIdx < 2))
+    WlzIBox2	tBox;
+    WlzObject	*tPObj = NULL;
+
+    tBox = WlzBoundingBox2I(tObj, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      centre.vtX = (tBox.xMin + tBox.xMax) / 2;
+      centre.vtY = (tBox.yMin + tBox.yMax) / 2;
+      radius.vtX = (tBox.xMax - tBox.xMin) / 2;
+      radius.vtY = (tBox.yMax - tBox.yMin) / 2;
+      tPObj = WlzAssignObject(
+	      WlzRegCCorPProcessObj2D(tObj, winFn, centre, radius,
+				      &errNum), NULL);
+    }
+    if(errNum == WLZ_ERR_NONE)
     {
-      WlzArrayStats2D((void **)(oAr[oIdx]), aSz, WLZ_GREY_DOUBLE, NULL, NULL,
-		      NULL, &(sSq[oIdx]), NULL, NULL);
-      ++oIdx;
+      tBox = WlzBoundingBox2I(tPObj, &errNum);
     }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      aBox.xMin = WLZ_MIN(tBox.xMin, pBox.xMin) - (int )(maxTran.vtX) + 1;
+      aBox.yMin = WLZ_MIN(tBox.yMin, pBox.yMin) - (int )(maxTran.vtY) + 1;
+      aBox.xMax = WLZ_MAX(tBox.xMax, pBox.xMax) + (int )(maxTran.vtX) + 1;
+      aBox.yMax = WLZ_MAX(tBox.yMax, pBox.yMax) + (int )(maxTran.vtY) + 1;
+      aOrg.vtX = aBox.xMin;
+      aOrg.vtY = aBox.yMin;
+      aSz.vtX = aBox.xMax - aBox.xMin + 1;
+      aSz.vtY = aBox.yMax - aBox.yMin + 1;
+      (void )AlgBitNextPowerOfTwo((unsigned int *)&(aSz.vtX), aSz.vtX);
+      (void )AlgBitNextPowerOfTwo((unsigned int *)&(aSz.vtY), aSz.vtY);
+      errNum = WlzRegCCorTgtSet(tgt, tPObj, tBox, aSz, aOrg, noise);
+    }
+    (void )WlzFreeObj(tPObj);
   }
-#ifdef WLZ_REGCCOR_DEBUG
+  /* Create double array for the source object. */
   if(errNum == WLZ_ERR_NONE)
   {
-    FILE	*fP = NULL;
-    WlzObject	*cCObjT = NULL;
-    
-    cCObjT = WlzFromArray2D((void **)(oAr[0]), aSz, aOrg,
-			    WLZ_GREY_DOUBLE, WLZ_GREY_DOUBLE,
-			    0.0, 1.0, 0, 0, &errNum);
-    if(cCObjT)
-    {
-      if((fP = fopen("oObjT0.wlz", "w")) != NULL)
-      {
-	(void )WlzWriteObj(fP, cCObjT);
-	(void )fclose(fP);
-      }
-      (void )WlzFreeObj(cCObjT);
-    }
+    aSz = tgt->aSz;
+    aOrg = tgt->aOrg;
+    errNum = WlzToArray2D((void ***)&sAr, pObj, aSz, aOrg,
+			  noise, WLZ_GREY_DOUBLE);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    WlzArrayStats2D((void **)sAr, aSz, WLZ_GREY_DOUBLE, NULL, NULL,
+		    NULL, &sSq, NULL, NULL);
   }
+#ifdef WLZ_REGCCOR_DEBUG
   if(errNum == WLZ_ERR_NONE)
   {
     FILE	*fP = NULL;
     WlzObject	*cCObjT = NULL;
     
-    cCObjT = WlzFromArray2D((void **)(oAr[1]), aSz, aOrg,
+    cCObjT = WlzFromArray2D((void **)sAr, aSz, aOrg,
 			    WLZ_GREY_DOUBLE, WLZ_GREY_DOUBLE,
 			    0.0, 1.0, 0, 0, &errNum);
     if(cCObjT)
@@ -907,8 +964,8 @@ static WlzDVertex2 WlzRegCCorObjs2DTran(WlzObject *tObj, WlzObject *sObj,
   /* Cross correlate. */
   if(errNum == WLZ_ERR_NONE)
   {
-    (void )AlgCrossCorrelate2D(oAr[0], oAr[1], aSz.vtX, aSz.vtY);
-    AlgCrossCorrPeakXY(&(tran.vtX), &(tran.vtY), &cCor, oAr[0],
+    (void )AlgCrossCorrelate2DFT(tgt->ft, sAr, aSz.vtX, aSz.vtY);
+    AlgCrossCorrPeakXY(&(tran.vtX), &(tran.vtY), &cCor, sAr,
 		       aSz.vtX, aSz.vtY, maxTran.vtX, maxTran.vtY);
   }
 #ifdef WLZ_REGCCOR_DEBUG
@@ -917,22 +974,12 @@ static WlzDVertex2 WlzRegCCorObjs2DTran(WlzObject *tObj, WlzObject *sObj,
     FILE	*fP = NULL;
     WlzObject	*cCObjT = NULL;
     
-    oIdx = 0;
-    while((errNum == WLZ_ERR_NONE) && (oIdx < 2))
-    {
-      (void )WlzGreyStats(pObj[oIdx], NULL, NULL, NULL, NULL, &(sSq[oIdx]),
-			  NULL, NULL, &errNum);
-      ++oIdx;
-    }
-    if(errNum == WLZ_ERR_NONE)
-    {
-      cCObjT = WlzFromArray2D((void **)(oAr[0]), aSz, aOrg,
-			      WLZ_GREY_DOUBLE, WLZ_GREY_DOUBLE,
-			      0.0,
-			      255.0 / (1.0 + (sqrt(sSq[0] * sSq[1]) *
-			      		      aSz.vtX * aSz.vtY)),
-			      0, 0, &errNum);
-    }
+    cCObjT = WlzFromArray2D((void **)sAr, aSz, aOrg,
+			    WLZ_GREY_DOUBLE, WLZ_GREY_DOUBLE,
+			    0.0,
+			    255.0 / (1.0 + (sqrt(tgt->sSq * sSq) *
+					    aSz.vtX * aSz.vtY)),
+			    0, 0, &errNum);
     if(cCObjT)
     {
       if((fP = fopen("cCObjT.wlz", "w")) != NULL)
@@ -944,19 +991,16 @@ static WlzDVertex2 WlzRegCCorObjs2DTran(WlzObject *tObj, WlzObject *sObj,
     }
   }
 #endif /* WLZ_REGCCOR_DEBUG */
-  for(oIdx = 0; oIdx < 2; ++oIdx)
-  {
-    (void )WlzFreeObj(oObj[oIdx]);
-    (void )WlzFreeObj(pObj[oIdx]);
-    AlcDouble2Free(oAr[oIdx]);
-  }
+  (void )WlzFreeObj(oObj);
+  (void )WlzFreeObj(pObj);
+  AlcDouble2Free(sAr);
   if(errNum == WLZ_ERR_NONE)
   {
     dstTran.vtX = tran.vtX;
     dstTran.vtY = tran.vtY;
     if(dstCCor)
     {
-      cCor = cCor / (1.0 + (sqrt(sSq[0] * sSq[1]) * aSz.vtX * aSz.vtY));
+      cCor = cCor / (1.0 + (sqrt(tgt->sSq * sSq) * aSz.vtX * aSz.vtY));
       *dstCCor = cCor;
     }
   }
@@ -975,6 +1019,10 @@ static WlzDVertex2 WlzRegCCorObjs2DTran(WlzObject *tObj, WlzObject *sObj,
 *               the angle of rotation about the given centre of rotation
 *               which has the highest cross correlation value.
 *		The rotation is always about the objects cente of mass.
+*		The Fourier transform of the polar sampled target object
+*		is kept in the given target data and is only recomputed
+*		if it is not valid or if its array differs from the one
+*		required for the polar sampled source object.
 * \param	tObj			The target object. Must have
 *                                       been assigned.
 * \param	sObj			The source object to be
@@ -986,136 +1034,106 @@ static WlzDVertex2 WlzRegCCorObjs2DTran(WlzObject *tObj, WlzObject *sObj,
 * \param	maxRot			Maximum rotation.
 * \param	winFn			Window function.
 * \param	noise			Use Gaussian noise if non-zero.
+* \param	tgt			Target data for reuse between
+* 					calls.
 * \param	dstErr			Destination error pointer,
 *                                       may be NULL.
 */
 static double	WlzRegCCorObjs2DRot(WlzObject *tObj, WlzObject *sObj,
 				    WlzAffineTransform *initTr, double maxRot,
 				    WlzWindowFnType winFn, int noise,
+				    WlzRegCCorTgt *tgt,
 				    WlzErrorNum *dstErr)
 {
-  int		oIdx,
-  		angCnt;
+  int		angCnt;
   double	angInc,
   		dstRot = 0.0;
-  WlzIBox2	aBox;
-  WlzIBox2	oBox[2];
+  WlzIBox2	aBox,
+  		sBox;
   WlzIVertex2	rot,
   		aSz,
   		aOrg,
-		winRad,
-		winOrg,
-		rotPad,
-		rotCentreI;
-  double	**oAr[2];
-  WlzObject	*oObj[2],
-  		*pObj[2],
-		*wObj[2];
+		rotPad;
+  double	**sAr = NULL;
+  WlzObject	*oObj = NULL,
+		*wObj = NULL;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
   const int	rotCnt = 500;
-  const double	distInc = 1.0;
 
-  /* Assign the target and transform source objects. */
-  oAr[0] = oAr[1] = NULL;
-  oAr[0] = oAr[1] = NULL;
-  oObj[0] = oObj[1] = NULL;
-  pObj[0] = pObj[1] = NULL;
-  wObj[0] = wObj[1] = NULL;
-  oObj[0] = WlzAssignObject(tObj, NULL);
+  /* Transform the source object. */
   if((initTr == NULL) || WlzAffineTransformIsIdentity(initTr, NULL))
   {
-    oObj[1] = WlzAssignObject(sObj, NULL);
+    oObj = WlzAssignObject(sObj, NULL);
   }
   else
   {
-    oObj[1] = WlzAssignObject(
-    	      WlzAffineTransformObj(sObj, initTr, WLZ_INTERPOLATION_NEAREST,
-				   &errNum), NULL);
+    oObj = WlzAssignObject(
+    	   WlzAffineTransformObj(sObj, initTr, WLZ_INTERPOLATION_NEAREST,
+				 &errNum), NULL);
   }
+  angInc = (2.0 * (maxRot + WLZ_M_PI)) / rotCnt;
+  angCnt = (2.0 * WLZ_M_PI) / angInc;
+  rotPad.vtY = 1 + WLZ_NINT(maxRot / angInc);
+  /* Compute the polar sampled source object. */
   if(errNum == WLZ_ERR_NONE)
   {
-    oIdx = 0;
-    while((errNum == WLZ_ERR_NONE) && (oIdx < 2))
-    {
-      tObj = WlzAutoCor(oObj[oIdx], &errNum);
-      (void )WlzFreeObj(oObj[oIdx]);
-      oObj[oIdx] = WlzAssignObject(tObj, NULL);
-      ++oIdx;
-    }
-  }
-  /* Compute rectangular to polar transformation. */
-  if(errNum == WLZ_ERR_NONE)
-  {
-    angInc = (2.0 * (maxRot + WLZ_M_PI)) / rotCnt;
-    angCnt = (2.0 * WLZ_M_PI) / angInc;
-    oIdx = 0;
-    while((errNum == WLZ_ERR_NONE) && (oIdx < 2))
-    {
-      rotCentreI.vtX = 0;
-      rotCentreI.vtY = 0;
-      if(errNum == WLZ_ERR_NONE)
-      {
-	pObj[oIdx] = WlzAssignObject(
-		     WlzPolarSample(oObj[oIdx], rotCentreI, angInc, distInc,
-				    angCnt, 0, &errNum), NULL);
-      }
-      ++oIdx;
-    }
+    wObj = WlzRegCCorPolarObj2D(oObj, angInc, angCnt, winFn, &sBox,
+				&errNum);
   }
-  /* Preproccess the objects using windows or noise. */
-  if(errNum == WLZ_ERR_NONE)
+  /* The polar arrays are not padded along the radius, so the circular
+   * cross correlation wraps and its peak depends on the array width.
+   * The target data are only reused if they have exactly the array that
+   * would be computed for this source object. */
+  if((errNum == WLZ_ERR_NONE) && tgt->valid)
   {
-    oIdx = 0;
-    while((errNum == WLZ_ERR_NONE) && (oIdx < 2))
+    aBox.xMin = WLZ_MIN(sBox.xMin, tgt->oBox.xMin);
+    aBox.yMin = WLZ_MIN(sBox.yMin, tgt->oBox.yMin) - rotPad.vtY;
+    aBox.xMax = WLZ_MAX(sBox.xMax, tgt->oBox.xMax);
+    aBox.yMax = WLZ_MAX(sBox.yMax, tgt->oBox.yMax) + rotPad.vtY;
+    aSz.vtX = aBox.xMax - aBox.xMin + 1;
+    aSz.vtY = aBox.yMax - aBox.yMin + 1;
+    (void )AlgBitNextPowerOfTwo((unsigned int *)&(aSz.vtX), aSz.vtX);
+    (void )AlgBitNextPowerOfTwo((unsigned int *)&(aSz.vtY), aSz.vtY);
+    if((aBox.xMin != tgt->aOrg.vtX) || (aBox.yMin != tgt->aOrg.vtY) ||
+       (aSz.vtX != tgt->aSz.vtX) || (aSz.vtY != tgt->aSz.vtY))
     {
-      oBox[oIdx] = WlzBoundingBox2I(pObj[oIdx], &errNum);
-      if(errNum == WLZ_ERR_NONE)
-      {
-	winOrg.vtX = (oBox[oIdx].xMax + oBox[oIdx].xMin) / 2;
-	winOrg.vtY = (oBox[oIdx].yMax + oBox[oIdx].yMin) / 2;
-	winRad.vtX = (oBox[oIdx].xMax - oBox[oIdx].xMin) / 2;
-	winRad.vtY = (oBox[oIdx].yMax - oBox[oIdx].yMin) / 2;
-	wObj[oIdx] = WlzAssignObject(
-		     WlzRegCCorPProcessObj2D(pObj[oIdx], winFn,
-					     winOrg, winRad, 
-					     &errNum), NULL);
-      }
-      ++oIdx;
+      WlzRegCCorTgtFree(tgt);
     }
   }
-  /* Create 2D double arrays from the polar sampled objects. */
-  if(errNum == WLZ_ERR_NONE)
+  /* Compute the polar sampled target object, its array and its Fourier
+   * transform, only needed if the target data are not valid. */
+  if((errNum == WLZ_ERR_NONE) && (tgt->valid == 0))
   {
-    oIdx = 0;
-    while((errNum == WLZ_ERR_NONE) && (oIdx < 2))
+    WlzIBox2	tBox;
+    WlzObject	*tWObj;
+
+    tWObj = WlzRegCCorPolarObj2D(tObj, angInc, angCnt, winFn, &tBox,
+				 &errNum);
+    if(errNum == WLZ_ERR_NONE)
     {
-      oBox[oIdx] = WlzBoundingBox2I(wObj[oIdx], &errNum);
-      ++oIdx;
+      aBox.xMin = WLZ_MIN(sBox.xMin, tBox.xMin);
+      aBox.yMin = WLZ_MIN(sBox.yMin, tBox.yMin) - rotPad.vtY;
+      aBox.xMax = WLZ_MAX(sBox.xMax, tBox.xMax);
+      aBox.yMax = WLZ_MAX(sBox.yMax, tBox.yMax) + rotPad.vtY;
+      aOrg.vtX = aBox.xMin;
+      aOrg.vtY = aBox.yMin;
+      aSz.vtX = aBox.xMax - aBox.xMin + 1;
+      aSz.vtY = aBox.yMax - aBox.yMin + 1;
+      (void )AlgBitNextPowerOfTwo((unsigned int *)&(aSz.vtX), aSz.vtX);
+      (void )AlgBitNextPowerOfTwo((unsigned int *)&(aSz.vtY), aSz.vtY);
+      errNum = WlzRegCCorTgtSet(tgt, tWObj, tBox, aSz, aOrg, noise);
     }
+    (void )WlzFreeObj(tWObj);
   }
+  /* Create 2D double array from the polar sampled source object. */
   if(errNum == WLZ_ERR_NONE)
   {
-    aBox.xMin = WLZ_MIN(oBox[0].xMin, oBox[1].xMin);
-    aBox.yMin = WLZ_MIN(oBox[0].yMin, oBox[1].yMin);
-    aBox.xMax = WLZ_MAX(oBox[0].xMax, oBox[1].xMax);
-    aBox.yMax = WLZ_MAX(oBox[0].yMax, oBox[1].yMax);
-    rotPad.vtX = (aBox.xMax - aBox.xMin) / 2;
-    rotPad.vtY = 1 + WLZ_NINT(maxRot / angInc);
-    aBox.yMin -= rotPad.vtY;
-    aBox.yMax += rotPad.vtY;
-    aOrg.vtX = aBox.xMin;
-    aOrg.vtY = aBox.yMin;
-    aSz.vtX = aBox.xMax - aBox.xMin + 1;
-    aSz.vtY = aBox.yMax - aBox.yMin + 1;
-    (void )AlgBitNextPowerOfTwo((unsigned int *)&(aSz.vtX), aSz.vtX);
-    (void )AlgBitNextPowerOfTwo((unsigned int *)&(aSz.vtY), aSz.vtY);
-    oIdx = 0;
-    while((errNum == WLZ_ERR_NONE) && (oIdx < 2))
-    {
-      errNum = WlzToArray2D((void ***)&(oAr[oIdx]), wObj[oIdx], aSz, aOrg,
-      			    noise, WLZ_GREY_DOUBLE);
-      ++oIdx;
-    }
+    rotPad.vtX = (WLZ_MAX(sBox.xMax, tgt->oBox.xMax) -
+                  WLZ_MIN(sBox.xMin, tgt->oBox.xMin)) / 2;
+    aSz = tgt->aSz;
+    aOrg = tgt->aOrg;
+    errNum = WlzToArray2D((void ***)&sAr, wObj, aSz, aOrg,
+			  noise, WLZ_GREY_DOUBLE);
   }
 #ifdef WLZ_REGCCOR_DEBUG
   if(errNum == WLZ_ERR_NONE)
@@ -1123,16 +1141,7 @@ static double	WlzRegCCorObjs2DRot(WlzObject *tObj, WlzObject *sObj,
     FILE	*fP = NULL;
     WlzObject	*aObj = NULL;
 
-    aObj = WlzFromArray2D((void **)(oAr[0]), aSz, aOrg,
-    			  WLZ_GREY_DOUBLE, WLZ_GREY_DOUBLE, 0.0, 1.0,
-			  0, 0, &errNum);
-    if((fP = fopen("cObjR0.wlz", "w")) != NULL) 
-    {
-      (void )WlzWriteObj(fP, aObj); 
-      (void )fclose(fP);
-    }
-    WlzFreeObj(aObj);
-    aObj = WlzFromArray2D((void **)(oAr[1]), aSz, aOrg,
+    aObj = WlzFromArray2D((void **)sAr, aSz, aOrg,
     			  WLZ_GREY_DOUBLE, WLZ_GREY_DOUBLE, 0.0, 1.0,
 			  0, 0, &errNum);
     if((fP = fopen("cObjR1.wlz", "w")) != NULL)
@@ -1146,56 +1155,181 @@ static double	WlzRegCCorObjs2DRot(WlzObject *tObj, WlzObject *sObj,
   /* Cross correlate. */
   if(errNum == WLZ_ERR_NONE)
   {
-    (void )AlgCrossCorrelate2D(oAr[0], oAr[1], aSz.vtX, aSz.vtY);
-    AlgCrossCorrPeakXY(&(rot.vtX), &(rot.vtY), NULL, oAr[0],
+    (void )AlgCrossCorrelate2DFT(tgt->ft, sAr, aSz.vtX, aSz.vtY);
+    AlgCrossCorrPeakXY(&(rot.vtX), &(rot.vtY), NULL, sAr,
 		       aSz.vtX, aSz.vtY, rotPad.vtX, rotPad.vtY);
     dstRot = rot.vtY * angInc;
     /* dstRot = -(rot.vtY) * angInc; */
   }
-#ifdef WLZ_REGCCOR_DEBUG
+  (void )WlzFreeObj(oObj);
+  (void )WlzFreeObj(wObj);
+  AlcDouble2Free(sAr);
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(dstRot);
+}
+
+/*!
+* \return	Polar sampled and preprocessed object, which has
+*		already been assigned.
+* \ingroup	WlzRegistration
+* \brief	Computes the auto correlation of the given object, polar
+*		samples it about the origin and then preprocesses it
+*		using the given window function. Without a window
+*		function the preprocessed object is the polar sampled
+*		object itself, so the returned object is assigned
+*		before the polar sampled object is freed.
+* \param	obj			Given object.
+* \param	angInc			Angle increment.
+* \param	angCnt			Number of angles.
+* \param	winFn			Window function.
+* \param	dstBox			Destination pointer for the bounding
+* 					box of the returned object.
+* \param	dstErr			Destination error pointer,
+*                                       may be NULL.
+*/
+static WlzObject *WlzRegCCorPolarObj2D(WlzObject *obj,
+				       double angInc, int angCnt,
+				       WlzWindowFnType winFn,
+				       WlzIBox2 *dstBox,
+				       WlzErrorNum *dstErr)
+{
+  WlzIBox2	pBox;
+  WlzIVertex2	winRad,
+		winOrg,
+  		rotCentreI;
+  WlzObject	*aObj = NULL,
+  		*pObj = NULL,
+		*wObj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const double	distInc = 1.0;
+
+  aObj = WlzAssignObject(WlzAutoCor(obj, &errNum), NULL);
   if(errNum == WLZ_ERR_NONE)
   {
-    double	sSq[2];
-    FILE	*fP = NULL;
-    WlzObject	*cCObjR = NULL;
-    
-    oIdx = 0;
-    while((errNum == WLZ_ERR_NONE) && (oIdx < 2))
-    {
-      (void )WlzGreyStats(wObj[oIdx], NULL, NULL, NULL, NULL, &(sSq[oIdx]),
-			  NULL, NULL, &errNum);
-      ++oIdx;
-    }
-    if(errNum == WLZ_ERR_NONE)
-    {
-      cCObjR = WlzFromArray2D((void **)(oAr[0]), aSz, aOrg,
-			      WLZ_GREY_DOUBLE, WLZ_GREY_DOUBLE,
-			      0.0,
-			      255.0 / (1.0 + (sqrt(sSq[0] * sSq[1]) *
-			      		      aSz.vtX * aSz.vtY)),
-			      0, 0, &errNum);
-    }
-    if(cCObjR)
-    {
-      if((fP = fopen("cCObjR.wlz", "w")) != NULL)
-      {
-	(void )WlzWriteObj(fP, cCObjR);
-	(void )fclose(fP);
-      }
-      (void )WlzFreeObj(cCObjR);
-    }
+    rotCentreI.vtX = 0;
+    rotCentreI.vtY = 0;
+    pObj = WlzAssignObject(
+	   WlzPolarSample(aObj, rotCentreI, angInc, distInc,
+			  angCnt, 0, &errNum), NULL);
   }
-#endif /* WLZ_REGCCOR_DEBUG */
-  for(oIdx = 0; oIdx < 2; ++oIdx)
+  if(errNum == WLZ_ERR_NONE)
+  {
+    pBox = WlzBoundingBox2I(pObj, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    winOrg.vtX = (pBox.xMax + pBox.xMin) / 2;
+    winOrg.vtY = (pBox.yMax + pBox.yMin) / 2;
+    winRad.vtX = (pBox.xMax - pBox.xMin) / 2;
+    winRad.vtY = (pBox.yMax - pBox.yMin) / 2;
+    wObj = WlzAssignObject(
+	   WlzRegCCorPProcessObj2D(pObj, winFn, winOrg, winRad,
+				   &errNum), NULL);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    *dstBox = WlzBoundingBox2I(wObj, &errNum);
+  }
+  (void )WlzFreeObj(aObj);
+  (void )WlzFreeObj(pObj);
+  if(errNum != WLZ_ERR_NONE)
   {
-    (void )WlzFreeObj(oObj[oIdx]);
-    (void )WlzFreeObj(pObj[oIdx]);
-    (void )WlzFreeObj(wObj[oIdx]);
-    AlcDouble2Free(oAr[oIdx]);
+    (void )WlzFreeObj(wObj);
+    wObj = NULL;
   }
   if(dstErr)
   {
     *dstErr = errNum;
   }
-  return(dstRot);
+  return(wObj);
+}
+
+/*!
+* \ingroup	WlzRegistration
+* \brief	Frees the Fourier transform of the given target data
+*		and marks the data as being invalid.
+* \param	tgt			Given target data.
+*/
+static void	WlzRegCCorTgtFree(WlzRegCCorTgt *tgt)
+{
+  if(tgt->ft)
+  {
+    AlcDouble2Free(tgt->ft);
+  }
+  tgt->ft = NULL;
+  tgt->valid = 0;
+}
+
+/*!
+* \return	Non-zero if the given box is within the target array.
+* \ingroup	WlzRegistration
+* \brief	Tests whether the array of the given target data is
+*		valid and covers the given box.
+* \param	tgt			Given target data.
+* \param	aBox			Given box.
+*/
+static int	WlzRegCCorTgtContains(WlzRegCCorTgt *tgt, WlzIBox2 aBox)
+{
+  int		con;
+
+  con = tgt->valid &&
+        (aBox.xMin >= tgt->aOrg.vtX) &&
+        (aBox.yMin >= tgt->aOrg.vtY) &&
+	(aBox.xMax < tgt->aOrg.vtX + tgt->aSz.vtX) &&
+	(aBox.yMax < tgt->aOrg.vtY + tgt->aSz.vtY);
+  return(con);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzRegistration
+* \brief	Sets the given target data by creating an array from
+*		the given preprocessed target object and then computing
+*		its Fourier transform.
+* \param	tgt			Given target data.
+* \param	pObj			Preprocessed target object.
+* \param	oBox			Bounding box of the preprocessed
+* 					target object.
+* \param	aSz			Array size, which must be an integer
+* 					power of two in each dimension.
+* \param	aOrg			Array origin.
+* \param	noise			Use Gaussian noise if non-zero.
+*/
+static WlzErrorNum WlzRegCCorTgtSet(WlzRegCCorTgt *tgt, WlzObject *pObj,
+				    WlzIBox2 oBox, WlzIVertex2 aSz,
+				    WlzIVertex2 aOrg, int noise)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  WlzRegCCorTgtFree(tgt);
+  errNum = WlzToArray2D((void ***)&(tgt->ft), pObj, aSz, aOrg,
+  			noise, WLZ_GREY_DOUBLE);
+  if(errNum == WLZ_ERR_NONE)
+  {
+#ifdef WLZ_REGCCOR_DEBUG
+    FILE	*fP = NULL;
+    WlzObject	*aObj = NULL;
+
+    aObj = WlzFromArray2D((void **)(tgt->ft), aSz, aOrg,
+			  WLZ_GREY_DOUBLE, WLZ_GREY_DOUBLE, 0.0, 1.0,
+			  0, 0, &errNum);
+    if((fP = fopen("oObjT0.wlz", "w")) != NULL)
+    {
+      (void )WlzWriteObj(fP, aObj);
+      (void )fclose(fP);
+    }
+    WlzFreeObj(aObj);
+#endif /* WLZ_REGCCOR_DEBUG */
+    WlzArrayStats2D((void **)(tgt->ft), aSz, WLZ_GREY_DOUBLE, NULL, NULL,
+		    NULL, &(tgt->sSq), NULL, NULL);
+    AlgFourReal2D(tgt->ft, 1, aSz.vtX, aSz.vtY);
+    tgt->oBox = oBox;
+    tgt->aOrg = aOrg;
+    tgt->aSz = aSz;
+    tgt->valid = 1;
+  }
+  return(errNum);
 }
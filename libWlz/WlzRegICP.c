@@ -46,9 +46,17 @@ static char _WlzRegICP_c[] = "University of Edinburgh $Id$";
 *                   registration of free-form curves and surfaces.
 *                   International Journal of Computer Vision,
 *                   13(2):119-152, 1994.
+*                 * Chen Y. and Medioni G. Object modelling by
+*                   registration of multiple range images. Image and
+*                   Vision Computing, 10(3):145-155, 1992.
+*                 * Chetverikov D., Stepanov D. and Krsek P. Robust
+*                   Euclidean alignment of 3D point sets: the trimmed
+*                   iterative closest point algorithm. Image and
+*                   Vision Computing, 23(3):299-309, 2005.
 * \ingroup      WlzTransform
 */
 
+#include <string.h>
 #include <float.h>
 #include <Wlz.h>
 
@@ -91,6 +99,38 @@ typedef struct _WlzRegICPWSp
   WlzAffineTransform *curTr;	/*!< Current affine transform */
 }  WlzRegICPWSp;
 
+/*!
+* \struct	_WlzRegICPPlaneWSp
+* \ingroup      WlzTransform
+* \brief	A workspace data structure for use in the point-to-plane
+*		ICP functions.
+*/
+typedef struct _WlzRegICPPlaneWSp
+{
+  WlzVertexType vType;		/*!< Type of vertices WLZ_VERTEX_D2 or
+  				     WLZ_VERTEX_D3 */
+  int		sgnNrm;		/*!< Non zero if normals have reliably signed
+  				     components. */
+  int		nS;		/*!< Number of source vertices/normals */
+  int		stride;		/*!< Source vertex stride for the current
+  				     level. */
+  int		nPrm;		/*!< Number of transform parameters for the
+  				     current stage. */
+  double	trim;		/*!< Fraction of matches used. */
+  WlzVertexP	gTVx;		/*!< Given target vertices */
+  WlzVertexP	gTNr;		/*!< Given target normals */
+  WlzVertexP	gSVx;		/*!< Given source vertices */
+  WlzVertexP	gSNr;		/*!< Given source normals */
+  WlzDVertex3	*tSVx;		/*!< Transformed source vertices of the
+  				     current level. */
+  int		*nNIdx;		/*!< Indicies of NN to source vertices */
+  double	*dist;		/*!< NN distances */
+  double	*dBuf;		/*!< Buffer for trimming rank selection */
+  double	*wgt;		/*!< Weights for matches */
+  AlcKDTTree	*tTree;		/*!< kD-tree of the target vertices */
+  WlzAffineTransform *curTr;	/*!< Current affine transform */
+} WlzRegICPPlaneWSp;
+
 static void     		WlzRegICPTrans(
 				  WlzRegICPWSp *wSp);
 static void			WlzRegICPFindNN(
@@ -113,6 +153,9 @@ static WlzErrorNum 		WlzRegICPCheckVertices(
 				  WlzVertexType *vType);
 static WlzErrorNum 		WlzRegICPBuildTree(
 				  WlzRegICPWSp *wSp);
+static WlzErrorNum		WlzRegICPPlaneStep(
+				  WlzRegICPPlaneWSp *wSp,
+				  double *dstMetric);
 static WlzAffineTransform 	*WlzRegICPTreeAndVerticesSimple(
 				  AlcKDTTree *tree,
 				  WlzTransformType trType,
@@ -885,6 +928,7 @@ WlzAffineTransform	*WlzRegICPVertices(WlzVertexP tVx, WlzVertexP tNr,
   AlcFree(wSp.tSVx.v);
   AlcFree(wSp.tSNr.v);
   AlcFree(wSp.nNTVx.v);
+  (void )AlcKDTTreeFree(wSp.tTree);
   (void )WlzFreeAffineTransform(wSp.prvTr);
   if(wSp.curTr)
   {
@@ -904,6 +948,234 @@ WlzAffineTransform	*WlzRegICPVertices(WlzVertexP tVx, WlzVertexP tNr,
   return(regTr);
 }
 
+/*!
+* \return				Affine transform which brings
+*					the two sets of vertices into
+*					register.
+* \ingroup	WlzTransform
+* \brief	Registers the two given sets of vertices using a
+*		point-to-plane variant of the iterative closest point
+*		algorithm. This converges in fewer iterations than
+*		WlzRegICPVertices() for smooth contours and surfaces.
+*		At each iteration the transform increment is that
+*		which minimises the sum of the squared distances from
+*		the transformed source vertices to the tangent lines
+*		(2D) or planes (3D) of their nearest target vertices.
+*		The correspondences are trimmed, with only the given
+*		fraction of matches having the smallest distances being
+*		used. The registration is coarse to fine with every
+*		\f$2^l\f$'th source vertex being used at level \f$l\f$,
+*		starting with level nLvl - 1 and finishing with all the
+*		source vertices at level 0. A rigid body transform is
+*		computed at each level, with a general affine transform
+*		(if required) only being computed at level 0 once the
+*		rigid body registration has converged. Iteration stops
+*		at each level and stage when the relative change in the
+*		root mean square point-to-plane distance is less than
+*		the given tolerance.
+* \param	tVx			Target vertices.
+* \param	tNr			Target normals, required.
+* \param	tCnt			Number of target vertices.
+* \param	sVx			Source vertices.
+* \param	sNr			Source normals, may be NULL.
+* \param	sCnt			Number of source vertices.
+* \param	vType			Type of the vertices.
+* \param	sgnNrm			Non zero if the normals have reliably
+*					signed components.
+* \param	initTr			Initial affine transform
+*					to be applied to the source
+*					object prior to using the ICP
+*					algorithm. May be NULL.
+* \param	trType			Required transform type.
+* \param	dstConv			Destination ptr for the
+*					convergence flag (non zero
+*					on convergence), may be NULL.
+* \param	dstItr			Destination ptr for the total number
+*					of iterations, may be NULL.
+* \param	maxItr			Maximum total number of iterations.
+* \param	trim			Fraction of the matches to be used
+*					at each iteration, range (0.0-1.0].
+* \param	nLvl			Number of coarse to fine levels,
+*					must be greater than zero.
+* \param	relTol			Relative tolerance for the change in
+*					the root mean square point-to-plane
+*					distance.
+* \param	dstErr			Destination error pointer,
+*					may be NULL.
+*/
+WlzAffineTransform	*WlzRegICPVerticesPlane(WlzVertexP tVx,
+					    WlzVertexP tNr, int tCnt,
+					    WlzVertexP sVx, WlzVertexP sNr,
+					    int sCnt,
+					    WlzVertexType vType, int sgnNrm,
+					    WlzAffineTransform *initTr,
+					    WlzTransformType trType,
+					    int *dstConv, int *dstItr,
+					    int maxItr, double trim,
+					    int nLvl, double relTol,
+					    WlzErrorNum *dstErr)
+{
+  int		lvl,
+  		stg,
+		nStg,
+		stride,
+		prvStride = 0,
+		conv = 0,
+		itr = 0;
+  int		*shfBuf = NULL;
+  double	curMetric,
+  		prvMetric;
+  WlzTransformType affType,
+  		regType;
+  WlzAffineTransform *regTr = NULL;
+  WlzRegICPPlaneWSp wSp;
+  WlzErrorNum 	errNum = WLZ_ERR_NONE;
+  const int	minSub = 64;	/* Minimum number of source vertices used
+  				 * at a coarse level. */
+
+  (void )memset(&wSp, 0, sizeof(WlzRegICPPlaneWSp));
+  if((tVx.v == NULL) || (tNr.v == NULL) || (sVx.v == NULL))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if((tCnt <= 0) || (sCnt <= 0) || (maxItr <= 0) || (nLvl <= 0) ||
+          (trim <= 0.0) || (trim > 1.0) || (relTol < 0.0))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else
+  {
+    switch(vType)
+    {
+      case WLZ_VERTEX_D2:
+        affType = WLZ_TRANSFORM_2D_AFFINE;
+	regType = WLZ_TRANSFORM_2D_REG;
+	wSp.nPrm = 3;
+	break;
+      case WLZ_VERTEX_D3:
+        affType = WLZ_TRANSFORM_3D_AFFINE;
+	regType = WLZ_TRANSFORM_3D_REG;
+	wSp.nPrm = 6;
+	break;
+      default:
+        errNum = WLZ_ERR_PARAM_TYPE;
+	break;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if(trType == affType)
+    {
+      nStg = 2;
+    }
+    else if(trType == regType)
+    {
+      nStg = 1;
+    }
+    else
+    {
+      errNum = WLZ_ERR_TRANSFORM_TYPE;
+    }
+  }
+  /* Setup workspace. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    wSp.vType = vType;
+    wSp.sgnNrm = sgnNrm;
+    wSp.nS = sCnt;
+    wSp.trim = trim;
+    wSp.gTVx = tVx;
+    wSp.gTNr = tNr;
+    wSp.gSVx = sVx;
+    wSp.gSNr = sNr;
+    if(((wSp.tSVx = (WlzDVertex3 *)
+		    AlcMalloc(sizeof(WlzDVertex3) * sCnt)) == NULL) ||
+       ((wSp.nNIdx = (int *)AlcMalloc(sizeof(int) * sCnt)) == NULL) ||
+       ((wSp.dist = (double *)AlcMalloc(sizeof(double) * sCnt)) == NULL) ||
+       ((wSp.dBuf = (double *)AlcMalloc(sizeof(double) * sCnt)) == NULL) ||
+       ((wSp.wgt = (double *)AlcMalloc(sizeof(double) * sCnt)) == NULL) ||
+       ((shfBuf = (int *)AlcMalloc(sizeof(int) * tCnt)) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    wSp.tTree = WlzVerticesBuildTree(vType, tCnt, tVx, shfBuf, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    wSp.curTr = (initTr)? WlzAffineTransformCopy(initTr, &errNum):
+                          WlzMakeAffineTransform(affType, &errNum);
+  }
+  /* Iterate from the coarsest to the finest level. */
+  lvl = nLvl;
+  while((errNum == WLZ_ERR_NONE) && (lvl-- > 0))
+  {
+    stride = 1 << WLZ_MIN(lvl, 30);
+    while((stride > 1) && ((sCnt / stride) < minSub))
+    {
+      stride /= 2;
+    }
+    if(stride != prvStride)
+    {
+      prvStride = wSp.stride = stride;
+      /* Rigid body and then (only at the finest level) general affine
+       * registration. */
+      stg = 0;
+      do
+      {
+	wSp.nPrm = (stg == 0)? ((vType == WLZ_VERTEX_D2)? 3: 6):
+			       ((vType == WLZ_VERTEX_D2)? 6: 12);
+	conv = 0;
+	prvMetric = DBL_MAX;
+	while((errNum == WLZ_ERR_NONE) && (conv == 0) && (itr < maxItr))
+	{
+	  ++itr;
+	  errNum = WlzRegICPPlaneStep(&wSp, &curMetric);
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    conv = ((prvMetric - curMetric) <= (relTol * prvMetric)) ||
+		   (curMetric < ALG_DBL_TOLLERANCE);
+	    prvMetric = curMetric;
+	  }
+	}
+      } while((errNum == WLZ_ERR_NONE) && conv &&
+              (lvl == 0) && (++stg < nStg));
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (conv == 0))
+  {
+    errNum = WLZ_ERR_ALG_CONVERGENCE;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    regTr = wSp.curTr;
+    wSp.curTr = NULL;
+  }
+  if(dstConv)
+  {
+    *dstConv = conv;
+  }
+  if(dstItr)
+  {
+    *dstItr = itr;
+  }
+  AlcFree(shfBuf);
+  AlcFree(wSp.tSVx);
+  AlcFree(wSp.nNIdx);
+  AlcFree(wSp.dist);
+  AlcFree(wSp.dBuf);
+  AlcFree(wSp.wgt);
+  (void )AlcKDTTreeFree(wSp.tTree);
+  (void )WlzFreeAffineTransform(wSp.curTr);
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(regTr);
+}
+
 /*!
 * \return				3D Woolz domain object.
 * \ingroup	WlzTransform
@@ -1089,6 +1361,7 @@ WlzObject	*WlzRegICPVerticesWSD2D(WlzVertexP tVx, WlzVertexP tNr,
   AlcFree(wSp.tSVx.v);
   AlcFree(wSp.tSNr.v);
   AlcFree(wSp.nNTVx.v);
+  (void )AlcKDTTreeFree(wSp.tTree);
   (void )WlzFreeAffineTransform(wSp.curTr);
   if(errNum != WLZ_ERR_NONE)
   {
@@ -1242,13 +1515,19 @@ static void     WlzRegICPTrans(WlzRegICPWSp *wSp)
 static void	WlzRegICPFindNN(WlzRegICPWSp *wSp)
 {
   int		idx;
-  WlzDVertex2	tVD2;
-  WlzDVertex3	tVD3;
-  double	datD[3];
-  AlcKDTNode	*node;
+  const int	minParN = 1024; /* Minimum number of matches for the search
+  				 * to be run in parallel. */
 
+#ifdef _OPENMP
+#pragma omp parallel for if(wSp->nMatch >= minParN)
+#endif
   for(idx = 0; idx < wSp->nMatch; ++idx)
   {
+    WlzDVertex2	tVD2;
+    WlzDVertex3	tVD3;
+    double	datD[3];
+    AlcKDTNode	*node;
+
     if(wSp->vType == WLZ_VERTEX_D2)
     {
       tVD2 = *(wSp->tSVx.d2 + idx);
@@ -1535,7 +1814,8 @@ static WlzErrorNum WlzRegICPCompTransform(WlzRegICPWSp *wSp,
 *					a non zero value if the registration
 *					converges.
 * \param	usrWgtFn		User supplied weight function, may be
-* 					NULL.
+* 					NULL. This may be called
+*					concurrently so must be reentrant.
 * \param	usrWgtData		User supplied weight data, may be NULL.
 * \param	delta			Tolerance for mean value of
 *					registration metric.
@@ -1664,7 +1944,8 @@ WlzAffineTransform *WlzRegICPTreeAndVertices(AlcKDTTree *tree,
 *					a non zero value if the registration
 *					converges.
 * \param	usrWgtFn		User supplied weight function, may be
-* 					NULL.
+* 					NULL. This may be called
+*					concurrently so must be reentrant.
 * \param	usrWgtData		User supplied weight data, may be NULL.
 * \param	delta			Tolerance for mean value of
 *					registration metric.
@@ -1689,37 +1970,36 @@ static WlzAffineTransform *WlzRegICPTreeAndVerticesSimple(AlcKDTTree *tree,
 {
   int		idS,
   		idM,
-		idV,
 		itr = 0,
 		conv = 0;
-  AlcKDTNode	*tNode;
+  double	*dstBuf = NULL;
   WlzAffineTransform *invTr = NULL,
 		*prvTr = NULL,
   		*curTr = NULL,
   		*newTr = NULL;
-  WlzVertex	dV,
-  		sV,
-		sN,
-		sTV,
-		sTN,
-  		tV,
-		tN;
   double	wgt0,
-		wgt1,
 		wgt2,
 		wMaxDist,
 		wMinDist,
 		dist,
-  		wNr,
-		wVx,
 		prvMetric = 0.0,
 		curMetric = 0.0;
-  double	vxD[3];
   WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const int	minParN = 1024;	/* Minimum number of source vertices for
+  				 * the correspondence search to be run
+				 * in parallel. */
  
-  curTr = (initTr == NULL)?
-  	  WlzMakeAffineTransform(WLZ_TRANSFORM_2D_AFFINE, &errNum):
-	  WlzAffineTransformCopy(initTr, &errNum);
+  if((dstBuf = (double *)AlcMalloc(((nS > 0)? nS: 1) *
+  				   sizeof(double))) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    curTr = (initTr == NULL)?
+	    WlzMakeAffineTransform(WLZ_TRANSFORM_2D_AFFINE, &errNum):
+	    WlzAffineTransformCopy(initTr, &errNum);
+  }
   curMetric = *gCurMetric;
   if(errNum == WLZ_ERR_NONE)
   {
@@ -1735,34 +2015,72 @@ static WlzAffineTransform *WlzRegICPTreeAndVerticesSimple(AlcKDTTree *tree,
       prvMetric = curMetric;
       curMetric = 0.0;
       /* Populate the buffers with source vertices, nearest neighbours
-       * in the target tree and scalar product of vertex normals. While
-       * doinf this also find maximum and minimum source - target vertex
-       * distances */
+       * in the target tree and scalar product of vertex normals. The
+       * nearest neighbour searches are independent and the tree is only
+       * read, so the buffers are populated concurrently using the source
+       * vertex index, with a negative distance for source vertices
+       * without a nearest neighbour. */
+#ifdef _OPENMP
+#pragma omp parallel for if(nS >= minParN)
+#endif
       for(idS = 0; idS < nS; ++idS)
       {
+	int	idV;
+	double	nnDist = -1.0;
+	double	vxD[3];
+	AlcKDTNode *tNode;
+	WlzVertex sN,
+		sTN,
+		sTV,
+		tN;
+
 	idV = *(sIdx + idS);
 	if(vType == WLZ_VERTEX_D2)
 	{
-	  sV.d2 = *(sVx.d2 + idV);
 	  sN.d2 = *(sNr.d2 + idV);
-	  sTV.d2 = WlzAffineTransformVertexD2(curTr, sV.d2, NULL);
+	  sTV.d2 = WlzAffineTransformVertexD2(curTr, *(sVx.d2 + idV), NULL);
 	  sTN.d2 = WlzAffineTransformNormalD2(curTr, sN.d2, NULL);
-	  *(sTVxBuf.d2 + idM) = sTV.d2;
+	  *(sTVxBuf.d2 + idS) = sTV.d2;
 	  vxD[0] = sTV.d2.vtX;
 	  vxD[1] = sTV.d2.vtY;
 	}
 	else /* vType == WLZ_VERTEX_D3 */
 	{
-	  sV.d3 = *(sVx.d3 + idV);
 	  sN.d3 = *(sNr.d3 + idV);
-	  sTV.d3 = WlzAffineTransformVertexD3(curTr, sV.d3, NULL);
+	  sTV.d3 = WlzAffineTransformVertexD3(curTr, *(sVx.d3 + idV), NULL);
 	  sTN.d3 = WlzAffineTransformNormalD3(curTr, sN.d3, NULL);
-	  *(sTVxBuf.d3 + idM) = sTV.d3;
+	  *(sTVxBuf.d3 + idS) = sTV.d3;
 	  vxD[0] = sTV.d3.vtX;
 	  vxD[1] = sTV.d3.vtY;
 	  vxD[2] = sTV.d3.vtZ;
 	}
-	if((tNode = AlcKDTGetNN(tree, vxD, DBL_MAX, &dist, NULL)) != NULL)
+	if((tNode = AlcKDTGetNN(tree, vxD, DBL_MAX, &nnDist, NULL)) != NULL)
+	{
+	  if(vType == WLZ_VERTEX_D2)
+	  {
+	    tN.d2 = *(tNr.d2 + tNode->idx);
+	    *(tVxBuf.d2 + idS) = *(tVx.d2 + tNode->idx);
+	    *(wgtBuf + idS) = WLZ_VTX_2_DOT(sTN.d2, tN.d2);
+	  }
+	  else /* vType == WLZ_VERTEX_D3 */
+	  {
+	    tN.d3 = *(tNr.d3 + tNode->idx);
+	    *(tVxBuf.d3 + idS) = *(tVx.d3 + tNode->idx);
+	    *(wgtBuf + idS) = WLZ_VTX_3_DOT(sTN.d3, tN.d3);
+	  }
+	}
+	else
+	{
+	  nnDist = -1.0;
+	}
+	*(dstBuf + idS) = nnDist;
+      }
+      /* Compact the buffers, removing source vertices without a nearest
+       * neighbour, while finding the maximum and minimum source - target
+       * vertex distances. */
+      for(idS = 0; idS < nS; ++idS)
+      {
+        if((dist = *(dstBuf + idS)) >= 0.0)
 	{
 	  if(wMinDist > dist)
 	  {
@@ -1772,19 +2090,19 @@ static WlzAffineTransform *WlzRegICPTreeAndVerticesSimple(AlcKDTTree *tree,
 	  {
 	    wMaxDist = dist;
 	  }
-	  if(vType == WLZ_VERTEX_D2)
+	  if(idM != idS)
 	  {
-	    tV.d2 = *(tVx.d2 + tNode->idx);
-	    tN.d2 = *(tNr.d2 + tNode->idx);
-	    *(tVxBuf.d2 + idM) = tV.d2;
-	    *(wgtBuf + idM) = WLZ_VTX_2_DOT(sTN.d2, tN.d2);
-	  }
-	  else /* vType == WLZ_VERTEX_D3 */
-	  {
-	    tV.d3 = *(tVx.d3 + tNode->idx);
-	    tN.d3 = *(tNr.d3 + tNode->idx);
-	    *(tVxBuf.d3 + idM) = tV.d3;
-	    *(wgtBuf + idM) = WLZ_VTX_3_DOT(sTN.d3, tN.d3);
+	    if(vType == WLZ_VERTEX_D2)
+	    {
+	      *(sTVxBuf.d2 + idM) = *(sTVxBuf.d2 + idS);
+	      *(tVxBuf.d2 + idM) = *(tVxBuf.d2 + idS);
+	    }
+	    else /* vType == WLZ_VERTEX_D3 */
+	    {
+	      *(sTVxBuf.d3 + idM) = *(sTVxBuf.d3 + idS);
+	      *(tVxBuf.d3 + idM) = *(tVxBuf.d3 + idS);
+	    }
+	    *(wgtBuf + idM) = *(wgtBuf + idS);
 	  }
 	  ++idM;
 	}
@@ -1795,29 +2113,41 @@ static WlzAffineTransform *WlzRegICPTreeAndVerticesSimple(AlcKDTTree *tree,
       }
       if(errNum == WLZ_ERR_NONE)
       {
-	/* Compute weightings. */
+	/* Compute weightings, these are also independent so are computed
+	 * concurrently with the weighted distances summed in order so that
+	 * the metric doesn't depend on the number of threads. */
 	wgt0 = wMaxDist - wMinDist;
-	wgt1 = 1.0 - minDistWgt;
-	wgt2 = (wgt0 > DBL_EPSILON)? wgt1 / wgt0: 1.0;
+	wgt2 = (wgt0 > DBL_EPSILON)? (1.0 - minDistWgt) / wgt0: 1.0;
+#ifdef _OPENMP
+#pragma omp parallel for if(idM >= minParN)
+#endif
 	for(idS = 0; idS < idM; ++idS)
 	{
+	  double    wDist,
+		    wNr,
+		    wVx;
+	  WlzVertex dV,
+		    sV,
+		    sTV,
+		    tV;
+
 	  if(vType == WLZ_VERTEX_D2)
 	  {
 	    sTV.d2 = *(sTVxBuf.d2 + idS);
 	    tV.d2 = *(tVxBuf.d2 + idS);
 	    WLZ_VTX_2_SUB(dV.d2, tV.d2, sTV.d2);
-	    dist = WLZ_VTX_2_LENGTH(dV.d2);
+	    wDist = WLZ_VTX_2_LENGTH(dV.d2);
 	  }
 	  else /* vType == WLZ_VERTEX_D3 */
 	  {
 	    sTV.d3 = *(sTVxBuf.d3 + idS);
 	    tV.d3 = *(tVxBuf.d3 + idS);
 	    WLZ_VTX_3_SUB(dV.d3, tV.d3, sTV.d3);
-	    dist = WLZ_VTX_3_LENGTH(dV.d3);
+	    wDist = WLZ_VTX_3_LENGTH(dV.d3);
 	  }
 	  if(wgt0 > DBL_EPSILON)
 	  {
-	    wVx = 1.0 - wgt2 * (dist - wMinDist);
+	    wVx = 1.0 - wgt2 * (wDist - wMinDist);
 	  }
 	  else
 	  {
@@ -1845,7 +2175,11 @@ static WlzAffineTransform *WlzRegICPTreeAndVerticesSimple(AlcKDTTree *tree,
 	  {
 	    *(wgtBuf + idS) = wVx * wNr;
 	  }
-	  curMetric += dist * *(wgtBuf + idS);
+	  *(dstBuf + idS) = wDist;
+	}
+	for(idS = 0; idS < idM; ++idS)
+	{
+	  curMetric += *(dstBuf + idS) * *(wgtBuf + idS);
 	}
 	curMetric /= idM;
       }
@@ -1914,6 +2248,7 @@ static WlzAffineTransform *WlzRegICPTreeAndVerticesSimple(AlcKDTTree *tree,
     errNum = WLZ_ERR_NONE;
     conv = 0;
   }
+  AlcFree(dstBuf);
   (void )WlzFreeAffineTransform(invTr);
   (void )WlzFreeAffineTransform(prvTr);
   *gPrvMetric = prvMetric;
@@ -1928,3 +2263,388 @@ static WlzAffineTransform *WlzRegICPTreeAndVerticesSimple(AlcKDTTree *tree,
   }
   return(curTr);
 }
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Performs a single iteration of the point-to-plane ICP
+*		registration for WlzRegICPVerticesPlane(). The current
+*		subset of source vertices is transformed, nearest
+*		neighbours are found in the target tree, the matches are
+*		weighted and trimmed and then the linearised least squares
+*		transform increment is computed and composed with the
+*		current transform. The point-to-plane distances are computed
+*		with respect to the weighted centroid of the matched source
+*		vertices and scaled by their root mean square distance
+*		from it to keep the least squares problem well conditioned.
+* \param	wSp			Point-to-plane ICP workspace.
+* \param	dstMetric		Destination pointer for the weighted
+*					root mean square point-to-plane
+*					distance prior to the update.
+*/
+static WlzErrorNum WlzRegICPPlaneStep(WlzRegICPPlaneWSp *wSp,
+				      double *dstMetric)
+{
+  int		idx,
+		idP,
+		idQ,
+		dim,
+  		nSub,
+		nMatch,
+		nKeep;
+  double	r,
+  		w,
+		sc,
+		sW = 0.0,
+		sR2 = 0.0,
+		sD2 = 0.0,
+		thr;
+  double	jV[12],
+  		bV[12];
+  double	trD[4][4];
+  double	*trA[4];
+  double	**aA;
+  WlzDVertex3	c,
+  		d,
+		p,
+		q,
+		n,
+		pxn,
+		tI;
+  AlgMatrix	aM;
+  WlzAffineTransform *incTr = NULL,
+  		*newTr = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  const int	minParN = 1024;	/* Minimum number of source vertices for
+  				 * the correspondence search to be run
+				 * in parallel. */
+
+  aM.core = NULL;
+  dim = (wSp->vType == WLZ_VERTEX_D2)? 2: 3;
+  nSub = (wSp->nS + wSp->stride - 1) / wSp->stride;
+  /* Transform the source vertices and normals, find nearest neighbours
+   * and compute normal compatibility weights. */
+#ifdef _OPENMP
+#pragma omp parallel for if(nSub >= minParN)
+#endif
+  for(idx = 0; idx < nSub; ++idx)
+  {
+    int		idV;
+    double	dot,
+    		nnDist = 0.0,
+		wN = 1.0;
+    double	datD[3];
+    AlcKDTNode	*node;
+    WlzDVertex2	v2;
+    WlzDVertex3	v3,
+    		tN;
+
+    idV = idx * wSp->stride;
+    if(wSp->vType == WLZ_VERTEX_D2)
+    {
+      v2 = WlzAffineTransformVertexD2(wSp->curTr, *(wSp->gSVx.d2 + idV),
+      				      NULL);
+      datD[0] = v2.vtX;
+      datD[1] = v2.vtY;
+      datD[2] = 0.0;
+    }
+    else /* wSp->vType == WLZ_VERTEX_D3 */
+    {
+      v3 = WlzAffineTransformVertexD3(wSp->curTr, *(wSp->gSVx.d3 + idV),
+      				      NULL);
+      datD[0] = v3.vtX;
+      datD[1] = v3.vtY;
+      datD[2] = v3.vtZ;
+    }
+    (wSp->tSVx + idx)->vtX = datD[0];
+    (wSp->tSVx + idx)->vtY = datD[1];
+    (wSp->tSVx + idx)->vtZ = datD[2];
+    node = AlcKDTGetNN(wSp->tTree, datD, DBL_MAX, &nnDist, NULL);
+    if(node == NULL)
+    {
+      *(wSp->nNIdx + idx) = -1;
+      *(wSp->wgt + idx) = 0.0;
+    }
+    else
+    {
+      *(wSp->nNIdx + idx) = node->idx;
+      if(wSp->gSNr.v)
+      {
+	if(wSp->vType == WLZ_VERTEX_D2)
+	{
+	  v2 = WlzAffineTransformNormalD2(wSp->curTr, *(wSp->gSNr.d2 + idV),
+	  				  NULL);
+	  dot = WLZ_VTX_2_DOT(v2, *(wSp->gTNr.d2 + node->idx));
+	}
+	else /* wSp->vType == WLZ_VERTEX_D3 */
+	{
+	  v3 = WlzAffineTransformNormalD3(wSp->curTr, *(wSp->gSNr.d3 + idV),
+	  				  NULL);
+	  tN = *(wSp->gTNr.d3 + node->idx);
+	  dot = WLZ_VTX_3_DOT(v3, tN);
+	}
+	wN = (wSp->sgnNrm)? ((dot > 0.0)? dot: 0.0): dot * dot;
+      }
+      *(wSp->wgt + idx) = wN;
+    }
+    *(wSp->dist + idx) = nnDist;
+  }
+  /* Trim the matches, keeping only the given fraction with the smallest
+   * nearest neighbour distances. */
+  nMatch = 0;
+  for(idx = 0; idx < nSub; ++idx)
+  {
+    if(*(wSp->nNIdx + idx) >= 0)
+    {
+      *(wSp->dBuf + nMatch++) = *(wSp->dist + idx);
+    }
+  }
+  nKeep = (int )ceil(wSp->trim * nMatch);
+  if((nKeep > 0) && (nKeep < nMatch))
+  {
+    AlgRankSelectD(wSp->dBuf, nMatch, nKeep - 1);
+    thr = *(wSp->dBuf + nKeep - 1);
+    for(idx = 0; idx < nSub; ++idx)
+    {
+      if(*(wSp->dist + idx) > thr)
+      {
+        *(wSp->wgt + idx) = 0.0;
+      }
+    }
+  }
+  /* Compute the weighted centroid of the matched source vertices and their
+   * root mean square distance from it. */
+  WLZ_VTX_3_ZERO(c);
+  for(idx = 0; idx < nSub; ++idx)
+  {
+    if((w = *(wSp->wgt + idx)) > 0.0)
+    {
+      sW += w;
+      WLZ_VTX_3_SCALE_ADD(c, *(wSp->tSVx + idx), w, c);
+    }
+  }
+  if(sW < DBL_EPSILON)
+  {
+    errNum = WLZ_ERR_ALG_CONVERGENCE;
+  }
+  else
+  {
+    WLZ_VTX_3_SCALE(c, c, 1.0 / sW);
+    for(idx = 0; idx < nSub; ++idx)
+    {
+      if((w = *(wSp->wgt + idx)) > 0.0)
+      {
+	WLZ_VTX_3_SUB(d, *(wSp->tSVx + idx), c);
+	sD2 += w * WLZ_VTX_3_SQRLEN(d);
+      }
+    }
+    sc = sqrt(sD2 / sW);
+    if(sc < DBL_EPSILON)
+    {
+      sc = 1.0;
+    }
+    if((aM.rect = AlgMatrixRectNew(wSp->nPrm, wSp->nPrm, NULL)) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  /* Accumulate the normal equations for the linearised point-to-plane
+   * distances. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    aA = aM.rect->array;
+    for(idP = 0; idP < wSp->nPrm; ++idP)
+    {
+      bV[idP] = 0.0;
+      for(idQ = 0; idQ < wSp->nPrm; ++idQ)
+      {
+        aA[idP][idQ] = 0.0;
+      }
+    }
+    for(idx = 0; idx < nSub; ++idx)
+    {
+      if((w = *(wSp->wgt + idx)) > 0.0)
+      {
+	idP = *(wSp->nNIdx + idx);
+	if(dim == 2)
+	{
+	  q.vtX = (wSp->gTVx.d2 + idP)->vtX;
+	  q.vtY = (wSp->gTVx.d2 + idP)->vtY;
+	  n.vtX = (wSp->gTNr.d2 + idP)->vtX;
+	  n.vtY = (wSp->gTNr.d2 + idP)->vtY;
+	  q.vtZ = n.vtZ = 0.0;
+	}
+	else
+	{
+	  q = *(wSp->gTVx.d3 + idP);
+	  n = *(wSp->gTNr.d3 + idP);
+	}
+	WLZ_VTX_3_SUB(p, *(wSp->tSVx + idx), c);
+	WLZ_VTX_3_SCALE(p, p, 1.0 / sc);
+	WLZ_VTX_3_SUB(q, q, c);
+	WLZ_VTX_3_SCALE(q, q, 1.0 / sc);
+	WLZ_VTX_3_SUB(d, p, q);
+	r = WLZ_VTX_3_DOT(n, d);
+	sR2 += w * r * r;
+	switch(wSp->nPrm)
+	{
+	  case 3:
+	    jV[0] = (p.vtX * n.vtY) - (p.vtY * n.vtX);
+	    jV[1] = n.vtX;
+	    jV[2] = n.vtY;
+	    break;
+	  case 6:
+	    if(dim == 2)
+	    {
+	      jV[0] = n.vtX * p.vtX;
+	      jV[1] = n.vtX * p.vtY;
+	      jV[2] = n.vtY * p.vtX;
+	      jV[3] = n.vtY * p.vtY;
+	      jV[4] = n.vtX;
+	      jV[5] = n.vtY;
+	    }
+	    else
+	    {
+	      WLZ_VTX_3_CROSS(pxn, p, n);
+	      jV[0] = pxn.vtX;
+	      jV[1] = pxn.vtY;
+	      jV[2] = pxn.vtZ;
+	      jV[3] = n.vtX;
+	      jV[4] = n.vtY;
+	      jV[5] = n.vtZ;
+	    }
+	    break;
+	  default: /* 12 */
+	    jV[0] = n.vtX * p.vtX;
+	    jV[1] = n.vtX * p.vtY;
+	    jV[2] = n.vtX * p.vtZ;
+	    jV[3] = n.vtY * p.vtX;
+	    jV[4] = n.vtY * p.vtY;
+	    jV[5] = n.vtY * p.vtZ;
+	    jV[6] = n.vtZ * p.vtX;
+	    jV[7] = n.vtZ * p.vtY;
+	    jV[8] = n.vtZ * p.vtZ;
+	    jV[9] = n.vtX;
+	    jV[10] = n.vtY;
+	    jV[11] = n.vtZ;
+	    break;
+	}
+	for(idP = 0; idP < wSp->nPrm; ++idP)
+	{
+	  bV[idP] -= w * jV[idP] * r;
+	  for(idQ = idP; idQ < wSp->nPrm; ++idQ)
+	  {
+	    aA[idP][idQ] += w * jV[idP] * jV[idQ];
+	  }
+	}
+      }
+    }
+    for(idP = 1; idP < wSp->nPrm; ++idP)
+    {
+      for(idQ = 0; idQ < idP; ++idQ)
+      {
+        aA[idP][idQ] = aA[idQ][idP];
+      }
+    }
+    *dstMetric = sc * sqrt(sR2 / sW);
+    /* Solve for the increment, with singular values for unconstrained
+     * parameters (eg rotation of a circle) being discarded. */
+    errNum = WlzErrorFromAlg(AlgMatrixSVSolve(aM, bV, 1.0e-06, NULL));
+  }
+  /* Build the increment transform in the scaled and centred coordinates
+   * then map it back: x' = M(x - c) + c + s t. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    for(idP = 0; idP < 4; ++idP)
+    {
+      trA[idP] = trD[idP];
+      for(idQ = 0; idQ < 4; ++idQ)
+      {
+        trD[idP][idQ] = (idP == idQ)? 1.0: 0.0;
+      }
+    }
+    if(dim == 2)
+    {
+      if(wSp->nPrm == 3)
+      {
+	trD[0][0] = trD[1][1] = cos(bV[0]);
+	trD[1][0] = sin(bV[0]);
+	trD[0][1] = -trD[1][0];
+	tI.vtX = bV[1];
+	tI.vtY = bV[2];
+      }
+      else
+      {
+	trD[0][0] += bV[0];
+	trD[0][1] = bV[1];
+	trD[1][0] = bV[2];
+	trD[1][1] += bV[3];
+	tI.vtX = bV[4];
+	tI.vtY = bV[5];
+      }
+      trD[0][2] = c.vtX + (sc * tI.vtX) -
+                  (trD[0][0] * c.vtX) - (trD[0][1] * c.vtY);
+      trD[1][2] = c.vtY + (sc * tI.vtY) -
+                  (trD[1][0] * c.vtX) - (trD[1][1] * c.vtY);
+      incTr = WlzAffineTransformFromMatrix(WLZ_TRANSFORM_2D_AFFINE, trA,
+      					   &errNum);
+    }
+    else
+    {
+      if(wSp->nPrm == 6)
+      {
+	double	cA, sA, cB, sB, cG, sG;
+
+	/* R = R_z(gamma) R_y(beta) R_x(alpha). */
+	cA = cos(bV[0]); sA = sin(bV[0]);
+	cB = cos(bV[1]); sB = sin(bV[1]);
+	cG = cos(bV[2]); sG = sin(bV[2]);
+	trD[0][0] = cG * cB;
+	trD[0][1] = (cG * sB * sA) - (sG * cA);
+	trD[0][2] = (cG * sB * cA) + (sG * sA);
+	trD[1][0] = sG * cB;
+	trD[1][1] = (sG * sB * sA) + (cG * cA);
+	trD[1][2] = (sG * sB * cA) - (cG * sA);
+	trD[2][0] = -sB;
+	trD[2][1] = cB * sA;
+	trD[2][2] = cB * cA;
+	tI.vtX = bV[3];
+	tI.vtY = bV[4];
+	tI.vtZ = bV[5];
+      }
+      else
+      {
+        for(idP = 0; idP < 3; ++idP)
+	{
+	  for(idQ = 0; idQ < 3; ++idQ)
+	  {
+	    trD[idP][idQ] += bV[(3 * idP) + idQ];
+	  }
+	}
+	tI.vtX = bV[9];
+	tI.vtY = bV[10];
+	tI.vtZ = bV[11];
+      }
+      trD[0][3] = c.vtX + (sc * tI.vtX) - (trD[0][0] * c.vtX) -
+		  (trD[0][1] * c.vtY) - (trD[0][2] * c.vtZ);
+      trD[1][3] = c.vtY + (sc * tI.vtY) - (trD[1][0] * c.vtX) -
+		  (trD[1][1] * c.vtY) - (trD[1][2] * c.vtZ);
+      trD[2][3] = c.vtZ + (sc * tI.vtZ) - (trD[2][0] * c.vtX) -
+		  (trD[2][1] * c.vtY) - (trD[2][2] * c.vtZ);
+      incTr = WlzAffineTransformFromMatrix(WLZ_TRANSFORM_3D_AFFINE, trA,
+      					   &errNum);
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    newTr = WlzAffineTransformProduct(wSp->curTr, incTr, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    (void )WlzFreeAffineTransform(wSp->curTr);
+    wSp->curTr = newTr;
+  }
+  (void )WlzFreeAffineTransform(incTr);
+  AlgMatrixFree(aM);
+  return(errNum);
+}
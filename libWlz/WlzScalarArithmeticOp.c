@@ -57,24 +57,29 @@ static WlzObject 		*WlzScalarMulAdd3D(
 				  WlzPixelV a,
 				  WlzGreyType rGType,
 				  WlzErrorNum *dstErr);
-static WlzErrorNum 		WlzScalarMulAddSet2D(
+static WlzErrorNum 		WlzScalarMulAddSet(
 				  WlzObject *rObj,
 				  WlzObject *iObj,
 				  double m,
 				  double a);
-static WlzErrorNum 		WlzGreyIncValuesInDomain2D(
+static WlzErrorNum 		WlzGreyIncValuesInDomainPrt(
 				  WlzObject *gObj,
 				  WlzObject *dObj);
 static WlzErrorNum 		WlzGreyIncValuesInDomain3D(
 				  WlzObject *gObj,
 				  WlzObject *dObj);
+static void			WlzGreyIncValuesItv(
+				  WlzGreyP gP,
+				  WlzGreyType gType,
+				  int len);
 
 /*!
 * \return	Woolz error code.
 * \ingroup	WlzArithmetic
 * \brief	Increments all valus of the firstobjct which are within
 * 		the domain of the second object. The domain of the first
-* 		object must cover that of the second.
+* 		object must cover that of the second. The first object
+* 		may have tiled values.
 * \param	gObj		First object.
 * \param	dObj		Second object.
 */
@@ -98,16 +103,12 @@ WlzErrorNum	WlzGreyIncValuesInDomain(WlzObject *gObj, WlzObject *dObj)
   {
     errNum = WLZ_ERR_VALUES_NULL;
   }
-  else if(WlzGreyTableIsTiled(gObj->values.core->type))
-  {
-    errNum = WLZ_ERR_VALUES_TYPE;
-  }
   else
   {
     switch(gObj->type)
     {
       case WLZ_2D_DOMAINOBJ:
-	errNum = WlzGreyIncValuesInDomain2D(gObj, dObj);
+	errNum = WlzGreyIncValuesInDomainPrt(gObj, dObj);
         break;
       case WLZ_3D_DOMAINOBJ:
 	errNum = WlzGreyIncValuesInDomain3D(gObj, dObj);
@@ -135,11 +136,9 @@ static WlzErrorNum WlzGreyIncValuesInDomain3D(WlzObject *gObj, WlzObject *dObj)
 {
   WlzPlaneDomain *gPD,
   		 *dPD;
-  WlzVoxelValues *gVV;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
 
   gPD = gObj->domain.p;
-  gVV = gObj->values.vox;
   dPD = dObj->domain.p;
   if((dPD->plane1 < gPD->plane1) || (dPD->lastpl > gPD->lastpl))
   {
@@ -147,81 +146,82 @@ static WlzErrorNum WlzGreyIncValuesInDomain3D(WlzObject *gObj, WlzObject *dObj)
   }
   else
   {
-    int		p,
-		p0,
-		p1;
+    errNum = WlzGreyIncValuesInDomainPrt(gObj, dObj);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzArithmetic
+* \brief	Increments all values of the first object which are within
+* 		the domain of the second object. The domain of the first
+* 		object must cover that of the second. The domain of the
+* 		second object is partitioned into chunks (see
+* 		WlzIteratePartitionMake()) which are incremented
+* 		concurrently.
+*		Because this is a static object it is assumed that the
+*		two 2 or 3D objects are known to be valid.
+* \param	gObj		First object.
+* \param	dObj		Second object.
+*/
+static WlzErrorNum WlzGreyIncValuesInDomainPrt(WlzObject *gObj,
+					WlzObject *dObj)
+{
+  int		idC;
+  WlzIteratePartition *part;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
 
-    p0 = ALG_MAX(dPD->plane1, gPD->plane1);
-    p1 = ALG_MIN(dPD->lastpl, gPD->lastpl);
+  part = WlzIteratePartitionMake(dObj, 0, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic)
 #endif
-    for(p = p0; p <= p1; ++p)
+    for(idC = 0; idC < part->nChunk; ++idC)
     {
       if(errNum == WLZ_ERR_NONE)
       {
-	WlzDomain    *doms;
-	WlzValues    *vals;
-	WlzErrorNum  errNum2D = WLZ_ERR_NONE;
+	WlzIterateChunkWSpace cWSp;
+	WlzErrorNum  errNum2D;
 
-	doms = dPD->domains + p - dPD->plane1;
-	vals = gVV->values + p - gPD->plane1;;
-	if(((*doms).core != NULL) && ((*vals).core != NULL))
+	/* Planes without values are skipped. */
+	errNum2D = WlzIterateChunkInit(&cWSp, part, idC, gObj->values);
+	if(errNum2D == WLZ_ERR_VALUES_NULL)
 	{
-	  WlzObject    *obj2D = NULL;
-
-	  if((obj2D = WlzAssignObject(
-		      WlzMakeMain(WLZ_2D_DOMAINOBJ, *doms, *vals, NULL, NULL,
-		                  &errNum2D), NULL)) != NULL)
+	  errNum2D = WLZ_ERR_NONE;
+	}
+	else if(errNum2D == WLZ_ERR_NONE)
+	{
+	  while((errNum2D = WlzIterateChunkNext(&cWSp)) == WLZ_ERR_NONE)
 	  {
-	    errNum2D = WlzGreyIncValues2D(obj2D);
-	    (void )WlzFreeObj(obj2D);
+	    WlzGreyIncValuesItv(cWSp.gWSp.u_grintptr, cWSp.gWSp.pixeltype,
+	    			cWSp.iWSp.colrmn);
 	  }
-	    if(errNum2D != WLZ_ERR_NONE)
+	  WlzIterateChunkEnd(&cWSp);
+	  if(errNum2D == WLZ_ERR_EOO)
 	  {
+	    errNum2D = WLZ_ERR_NONE;
+	  }
+	}
+	if(errNum2D != WLZ_ERR_NONE)
+	{
 #ifdef _OPENMP
 #pragma omp critical
-	    {
+	  {
 #endif
-	      if(errNum == WLZ_ERR_NONE)
-	      {
-		errNum = errNum2D;
-	      }
-#ifdef _OPENMP
+	    if(errNum == WLZ_ERR_NONE)
+	    {
+	      errNum = errNum2D;
 	    }
-#endif
+#ifdef _OPENMP
 	  }
+#endif
 	}
       }
     }
   }
-  return(errNum);
-}
-
-/*!
-* \return	Woolz error code.
-* \ingroup	WlzArithmetic
-* \brief	Increments all values of the firstobject which are within
-* 		the domain of the second object. The domain of the first
-* 		object must cover that of the second.
-*		Because this is a static object it is assumed that the
-*		two 2D objects are known to be valid.
-* \param	gObj		First object.
-* \param	dObj		Second object.
-*/
-static WlzErrorNum WlzGreyIncValuesInDomain2D(WlzObject *gObj, WlzObject *dObj)
-{
-  WlzObject	*tObj;
-  WlzErrorNum	errNum = WLZ_ERR_NONE;
-
-  tObj = WlzAssignObject(
-         WlzMakeMain(WLZ_2D_DOMAINOBJ, dObj->domain, gObj->values, NULL, NULL,
-	             &errNum), NULL);
-  if(errNum == WLZ_ERR_NONE)
-  {
-    errNum = WlzGreyIncValues2D(tObj);
-    (void )WlzFreeObj(tObj);
-  }
+  WlzIteratePartitionFree(part);
   return(errNum);
 }
 
@@ -243,47 +243,8 @@ WlzErrorNum 	WlzGreyIncValues2D(WlzObject *obj)
     while((errNum == WLZ_ERR_NONE) &&
 	  ((errNum = WlzNextGreyInterval(&iWSp)) == WLZ_ERR_NONE))
     {
-      int	     i,
-	       len;
-      WlzGreyP gP;
-      
-      gP = gWSp.u_grintptr;
-      len = iWSp.rgtpos - iWSp.lftpos + 1;
-      switch(gWSp.pixeltype)
-      {
-	case WLZ_GREY_INT:
-	  for(i = 0; i < len; ++i)
-	  {
-	    *(gP.inp)++ += 1;
-	  }
-	  break;
-	case WLZ_GREY_SHORT:
-	  for(i = 0; i < len; ++i)
-	  {
-	    *(gP.shp)++ += 1;
-	  }
-	  break;
-	case WLZ_GREY_UBYTE:
-	  for(i = 0; i < len; ++i)
-	  {
-	    *(gP.ubp)++ += 1;
-	  }
-	  break;
-	case WLZ_GREY_FLOAT:
-	  for(i = 0; i < len; ++i)
-	  {
-	    *(gP.flp)++ += 1.0f;
-	  }
-	  break;
-	case WLZ_GREY_DOUBLE:
-	  for(i = 0; i < len; ++i)
-	  {
-	    *(gP.dbp)++ += 1.0;
-	  }
-	  break;
-	default:
-	  break;
-      }
+      WlzGreyIncValuesItv(gWSp.u_grintptr, gWSp.pixeltype,
+      			  iWSp.rgtpos - iWSp.lftpos + 1);
     }
     (void )WlzEndGreyScan(&iWSp, &gWSp);
     if(errNum == WLZ_ERR_EOO)
@@ -294,6 +255,54 @@ WlzErrorNum 	WlzGreyIncValues2D(WlzObject *obj)
   return(errNum);
 }
 
+/*!
+* \ingroup	WlzArithmetic
+* \brief	Increments the given number of values of an interval.
+* \param	gP		Pointer to the first value of the interval.
+* \param	gType		Grey type of the values.
+* \param	len		Number of values.
+*/
+static void	WlzGreyIncValuesItv(WlzGreyP gP, WlzGreyType gType, int len)
+{
+  int		i;
+
+  switch(gType)
+  {
+    case WLZ_GREY_INT:
+      for(i = 0; i < len; ++i)
+      {
+	*(gP.inp)++ += 1;
+      }
+      break;
+    case WLZ_GREY_SHORT:
+      for(i = 0; i < len; ++i)
+      {
+	*(gP.shp)++ += 1;
+      }
+      break;
+    case WLZ_GREY_UBYTE:
+      for(i = 0; i < len; ++i)
+      {
+	*(gP.ubp)++ += 1;
+      }
+      break;
+    case WLZ_GREY_FLOAT:
+      for(i = 0; i < len; ++i)
+      {
+	*(gP.flp)++ += 1.0f;
+      }
+      break;
+    case WLZ_GREY_DOUBLE:
+      for(i = 0; i < len; ++i)
+      {
+	*(gP.dbp)++ += 1.0;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
 /*! 
 * \return       Object with transformed grey-values.
 * \ingroup      WlzArithmetic
@@ -677,6 +686,11 @@ static WlzObject *WlzScalarMulAdd2D(WlzObject *iObj, WlzPixelV m, WlzPixelV a,
   }
   if(errNum == WLZ_ERR_NONE)
   {
+    /* The returned values are never tiled, as for 3D objects. */
+    if(rVType == WLZ_GREY_TAB_TILED)
+    {
+      rVType = WLZ_GREY_TAB_RAGR;
+    }
     rVType = WlzGreyTableType(rVType, rGType, &errNum);
   }
   if(errNum == WLZ_ERR_NONE)
@@ -700,7 +714,7 @@ static WlzObject *WlzScalarMulAdd2D(WlzObject *iObj, WlzPixelV m, WlzPixelV a,
       case WLZ_GREY_DOUBLE:
 	WlzValueConvertPixel(&m, m, WLZ_GREY_DOUBLE);
 	WlzValueConvertPixel(&a, a, WLZ_GREY_DOUBLE);
-	errNum = WlzScalarMulAddSet2D(rObj, iObj, m.v.dbv, a.v.dbv);
+	errNum = WlzScalarMulAddSet(rObj, iObj, m.v.dbv, a.v.dbv);
 	break;
       default:
         errNum = WLZ_ERR_GREY_TYPE;
@@ -759,75 +773,27 @@ static WlzObject *WlzScalarMulAdd3D(WlzObject *iObj, WlzPixelV m, WlzPixelV a,
   }
   if(errNum == WLZ_ERR_NONE)
   {
-    int		idP,
-    		plMin,
-    		plMax;
-    WlzPlaneDomain *iPDom;
-    WlzVoxelValues *iVox,
-    		*rVox;
-
-    iPDom = iObj->domain.p;
-    iVox = iObj->values.vox;
-    rVox = rValues.vox;
-    plMin = iPDom->plane1;
-    plMax = iPDom->lastpl;
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-    for(idP = plMin; idP <= plMax; ++idP)
-    {
-      WlzErrorNum errNum2D = WLZ_ERR_NONE;
-
-      if(errNum == WLZ_ERR_NONE)
-      {
-	int	      idO;
-	WlzDomain *iDom2D;
-	WlzValues *iVal2D,
-		  *rVal2D;
-
-	idO = idP - iPDom->plane1;
-	iDom2D = iPDom->domains + idO;
-	iVal2D = iVox->values + idO;
-	rVal2D = rVox->values + idO;
-	if(((*iDom2D).core != NULL) && ((*iVal2D).core != NULL) &&
-	   ((*rVal2D).core != NULL))
-	{
-	  WlzObject *iObj2D = NULL,
-		    *rObj2D = NULL;
-	  
-	  if((iObj2D = WlzMakeMain(WLZ_2D_DOMAINOBJ, *iDom2D, *iVal2D,
-				   NULL, NULL, &errNum2D)) != NULL)
-	  {
-	    rObj2D = WlzScalarMulAdd2D(iObj2D, m, a, rGType, &errNum2D);
-	  }
-	  if(errNum2D == WLZ_ERR_NONE)
-	  {
-	    *rVal2D = WlzAssignValues(rObj2D->values, NULL);
-	  }
-	  (void )WlzFreeObj(iObj2D);
-	  (void )WlzFreeObj(rObj2D);
-	}
-      }
-      if(errNum2D != WLZ_ERR_NONE)
-      {
-#ifdef _OPENMP
-#pragma omp critical
-	{
-#endif
-	  if(errNum == WLZ_ERR_NONE)
-	  {
-	    errNum = errNum2D;
-	  }
-#ifdef _OPENMP
-	}
-#endif
-      }
-    }
+    rObj = WlzMakeMain(WLZ_3D_DOMAINOBJ, iObj->domain, rValues,
+    		       iObj->plist, iObj->assoc, &errNum);
   }
   if(errNum == WLZ_ERR_NONE)
   {
-    rObj = WlzMakeMain(WLZ_3D_DOMAINOBJ, iObj->domain, rValues,
-    		       iObj->plist, iObj->assoc, &errNum);
+    switch(rGType)
+    {
+      case WLZ_GREY_INT:   /* FALLTHROUGH */
+      case WLZ_GREY_SHORT: /* FALLTHROUGH */
+      case WLZ_GREY_UBYTE: /* FALLTHROUGH */
+      case WLZ_GREY_RGBA:  /* FALLTHROUGH */
+      case WLZ_GREY_FLOAT: /* FALLTHROUGH */
+      case WLZ_GREY_DOUBLE:
+	WlzValueConvertPixel(&m, m, WLZ_GREY_DOUBLE);
+	WlzValueConvertPixel(&a, a, WLZ_GREY_DOUBLE);
+	errNum = WlzScalarMulAddSet(rObj, iObj, m.v.dbv, a.v.dbv);
+	break;
+      default:
+        errNum = WLZ_ERR_GREY_TYPE;
+	break;
+    }
   }
   if(errNum != WLZ_ERR_NONE)
   {
@@ -853,146 +819,198 @@ static WlzObject *WlzScalarMulAdd3D(WlzObject *iObj, WlzPixelV m, WlzPixelV a,
 * \ingroup	WlzArithmetic
 * \brief	Sets the values of the return object from the input object
 * 		using simple linear scaling, see WlzScalarMulAdd(). The
-* 		objects are known to be 2D, have the same domain.
-* \param	rObj
-* \param	iObj
-* \param	m
-* \param	a
+* 		objects are known to be 2 or 3D, have the same domain.
+* 		The domain is partitioned into chunks (see
+* 		WlzIteratePartitionMake()) which are set concurrently.
+* \param	rObj			Return object.
+* \param	iObj			Input object.
+* \param	m			Value to multiply input values by.
+* \param	a			Value to add to product.
 */
-static WlzErrorNum WlzScalarMulAddSet2D(WlzObject *rObj, WlzObject *iObj,
+static WlzErrorNum WlzScalarMulAddSet(WlzObject *rObj, WlzObject *iObj,
 				     double m, double a)
 {
-  int		bufLen;
-  WlzGreyWSpace iGWSp,
-  		rGWSp;
-  WlzIntervalWSpace iIWSp = {0},
-  		    rIWSp = {0};
+  int		idC,
+  		bufLen;
+  WlzIteratePartition *part = NULL;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
 
-  bufLen = iObj->domain.i->lastkl - iObj->domain.i->kol1 + 1;
-  if((bufLen != iObj->domain.i->lastkl - iObj->domain.i->kol1 + 1) ||
-     (bufLen < 0))
+  if(iObj->type == WLZ_2D_DOMAINOBJ)
+  {
+    bufLen = iObj->domain.i->lastkl - iObj->domain.i->kol1 + 1;
+  }
+  else
+  {
+    bufLen = iObj->domain.p->lastkl - iObj->domain.p->kol1 + 1;
+  }
+  if(rObj->values.core == NULL)
+  {
+    errNum = WLZ_ERR_VALUES_NULL;
+  }
+  else if(bufLen < 0)
   {
     errNum = WLZ_ERR_DOMAIN_DATA;
   }
   else if(bufLen > 0)
   {
-    if(errNum == WLZ_ERR_NONE)
-    {
-      errNum = WlzInitGreyScan(iObj, &iIWSp, &iGWSp);
-    }
-    if(errNum == WLZ_ERR_NONE)
-    {
-      errNum = WlzInitGreyScan(rObj, &rIWSp, &rGWSp);
-    }
-    if(errNum == WLZ_ERR_NONE)
+    part = WlzIteratePartitionMake(iObj, 0, &errNum);
+  }
+  if((errNum == WLZ_ERR_NONE) && (part != NULL))
+  {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(idC = 0; idC < part->nChunk; ++idC)
     {
-      double	*buf = NULL;
-
-      if((buf = AlcMalloc(sizeof(double) * bufLen)) == NULL)
-      {
-        errNum = WLZ_ERR_MEM_ALLOC;
-      }
-      else
+      if(errNum == WLZ_ERR_NONE)
       {
-	while((errNum = WlzNextGreyInterval(&iIWSp)) == WLZ_ERR_NONE)
+	double	*buf = NULL;
+	WlzIterateChunkWSpace iCWSp,
+			rCWSp;
+	WlzErrorNum errNum2D;
+
+	/* Planes without values are skipped. */
+	if((errNum2D = WlzIterateChunkInit(&iCWSp, part, idC,
+	                                   iObj->values)) == WLZ_ERR_NONE)
 	{
-	  int	t,
-	  	idN,
-	  	itvLen;
-	  double f;
-
-
-	  itvLen = iIWSp.colrmn;
-	  (void )WlzNextGreyInterval(&rIWSp);
-	  switch(iGWSp.pixeltype)
+	  if((errNum2D = WlzIterateChunkInit(&rCWSp, part, idC,
+					     rObj->values)) != WLZ_ERR_NONE)
 	  {
-	    case WLZ_GREY_INT:
-	      WlzValueCopyIntToDouble(buf, iGWSp.u_grintptr.inp, itvLen);
-	      break;
-	    case WLZ_GREY_SHORT:
-	      WlzValueCopyShortToDouble(buf, iGWSp.u_grintptr.shp, itvLen);
-	      break;
-	    case WLZ_GREY_UBYTE:
-	      WlzValueCopyUByteToDouble(buf, iGWSp.u_grintptr.ubp, itvLen);
-	      break;
-	    case WLZ_GREY_FLOAT:
-	      WlzValueCopyFloatToDouble(buf, iGWSp.u_grintptr.flp, itvLen);
-	      break;
-	    case WLZ_GREY_DOUBLE:
-	      WlzValueCopyDoubleToDouble(buf, iGWSp.u_grintptr.dbp, itvLen);
-	      break;
-	    case WLZ_GREY_RGBA:
-	      WlzValueCopyRGBAToDouble(buf, iGWSp.u_grintptr.rgbp, itvLen);
-	      break;
-	    default:
-	      break;
+	    WlzIterateChunkEnd(&iCWSp);
 	  }
-	  switch(rGWSp.pixeltype)
+	}
+	if(errNum2D == WLZ_ERR_VALUES_NULL)
+	{
+	  errNum2D = WLZ_ERR_NONE;
+	}
+	else if(errNum2D == WLZ_ERR_NONE)
+	{
+	  if((buf = AlcMalloc(sizeof(double) * bufLen)) == NULL)
 	  {
-	    case WLZ_GREY_UBYTE:
-	      for(idN = 0; idN < itvLen; ++idN)
-	      {
-		f = (buf[idN] * m) + a;
-		f = WLZ_CLAMP(f, 0, 255);
-		rGWSp.u_grintptr.ubp[idN] = WLZ_NINT(f);
-	      }
-	      break;
-	    case WLZ_GREY_SHORT:
-	      for(idN = 0; idN < itvLen; ++idN)
-	      {
-		f = (buf[idN] * m) + a;
-		f = WLZ_CLAMP(f, SHRT_MIN, SHRT_MAX);
-		rGWSp.u_grintptr.shp[idN] = WLZ_NINT(f);
-	      }
-	      break;
-	    case WLZ_GREY_INT:
-	      for(idN = 0; idN < itvLen; ++idN)
-	      {
-		f = (buf[idN] * m) + a;
-		f = WLZ_CLAMP(f, INT_MIN, INT_MAX);
-		rGWSp.u_grintptr.inp[idN] = WLZ_NINT(f);
-	      }
-	      break;
-	    case WLZ_GREY_RGBA:
-	      for(idN = 0; idN < itvLen; ++idN)
-	      {
-		WlzUInt	u;
+	    errNum2D = WLZ_ERR_MEM_ALLOC;
+	  }
+	  else
+	  {
+	    WlzGreyWSpace *iGWSp,
+	    		  *rGWSp;
 
-		f = (buf[idN] * m) + a;
-		f = WLZ_CLAMP(f, 0, 255);
-		t = WLZ_NINT(f);
-                WLZ_RGBA_RGBA_SET(u, t, t, t, 255);
-		rGWSp.u_grintptr.inp[idN] = u;
-	      }
-	    case WLZ_GREY_FLOAT:
-	      for(idN = 0; idN < itvLen; ++idN)
+	    iGWSp = &(iCWSp.gWSp);
+	    rGWSp = &(rCWSp.gWSp);
+	    while((errNum2D = WlzIterateChunkNext(&iCWSp)) == WLZ_ERR_NONE)
+	    {
+	      int	t,
+			idN,
+			itvLen;
+	      double f;
+
+	      itvLen = iCWSp.iWSp.colrmn;
+	      (void )WlzIterateChunkNext(&rCWSp);
+	      switch(iGWSp->pixeltype)
 	      {
-		double	t;
-
-		t = (buf[idN] * m) + a;
-		rGWSp.u_grintptr.flp[idN] = WLZ_CLAMP(t, -(FLT_MAX), FLT_MAX);
+		case WLZ_GREY_INT:
+		  WlzValueCopyIntToDouble(buf, iGWSp->u_grintptr.inp, itvLen);
+		  break;
+		case WLZ_GREY_SHORT:
+		  WlzValueCopyShortToDouble(buf, iGWSp->u_grintptr.shp, itvLen);
+		  break;
+		case WLZ_GREY_UBYTE:
+		  WlzValueCopyUByteToDouble(buf, iGWSp->u_grintptr.ubp, itvLen);
+		  break;
+		case WLZ_GREY_FLOAT:
+		  WlzValueCopyFloatToDouble(buf, iGWSp->u_grintptr.flp, itvLen);
+		  break;
+		case WLZ_GREY_DOUBLE:
+		  WlzValueCopyDoubleToDouble(buf, iGWSp->u_grintptr.dbp,
+		                             itvLen);
+		  break;
+		case WLZ_GREY_RGBA:
+		  WlzValueCopyRGBAToDouble(buf, iGWSp->u_grintptr.rgbp, itvLen);
+		  break;
+		default:
+		  break;
 	      }
-	      break;
-	    case WLZ_GREY_DOUBLE:
-	      for(idN = 0; idN < itvLen; ++idN)
+	      switch(rGWSp->pixeltype)
 	      {
-		rGWSp.u_grintptr.dbp[idN] = (buf[idN] * m) + a;
+		case WLZ_GREY_UBYTE:
+		  for(idN = 0; idN < itvLen; ++idN)
+		  {
+		    f = (buf[idN] * m) + a;
+		    f = WLZ_CLAMP(f, 0, 255);
+		    rGWSp->u_grintptr.ubp[idN] = WLZ_NINT(f);
+		  }
+		  break;
+		case WLZ_GREY_SHORT:
+		  for(idN = 0; idN < itvLen; ++idN)
+		  {
+		    f = (buf[idN] * m) + a;
+		    f = WLZ_CLAMP(f, SHRT_MIN, SHRT_MAX);
+		    rGWSp->u_grintptr.shp[idN] = WLZ_NINT(f);
+		  }
+		  break;
+		case WLZ_GREY_INT:
+		  for(idN = 0; idN < itvLen; ++idN)
+		  {
+		    f = (buf[idN] * m) + a;
+		    f = WLZ_CLAMP(f, INT_MIN, INT_MAX);
+		    rGWSp->u_grintptr.inp[idN] = WLZ_NINT(f);
+		  }
+		  break;
+		case WLZ_GREY_RGBA:
+		  for(idN = 0; idN < itvLen; ++idN)
+		  {
+		    WlzUInt	u;
+
+		    f = (buf[idN] * m) + a;
+		    f = WLZ_CLAMP(f, 0, 255);
+		    t = WLZ_NINT(f);
+		    WLZ_RGBA_RGBA_SET(u, t, t, t, 255);
+		    rGWSp->u_grintptr.rgbp[idN] = u;
+		  }
+		  break;
+		case WLZ_GREY_FLOAT:
+		  for(idN = 0; idN < itvLen; ++idN)
+		  {
+		    f = (buf[idN] * m) + a;
+		    rGWSp->u_grintptr.flp[idN] = WLZ_CLAMP(f, -(FLT_MAX),
+		    					   FLT_MAX);
+		  }
+		  break;
+		case WLZ_GREY_DOUBLE:
+		  for(idN = 0; idN < itvLen; ++idN)
+		  {
+		    rGWSp->u_grintptr.dbp[idN] = (buf[idN] * m) + a;
+		  }
+		  break;
+		default:
+		  break;
 	      }
-	      break;
-	    default:
-	      break;
+	    }
+	    if(errNum2D == WLZ_ERR_EOO)
+	    {
+	      errNum2D = WLZ_ERR_NONE;
+	    }
+	    AlcFree(buf);
 	  }
+	  WlzIterateChunkEnd(&iCWSp);
+	  WlzIterateChunkEnd(&rCWSp);
 	}
-	if(errNum == WLZ_ERR_EOO)
+	if(errNum2D != WLZ_ERR_NONE)
 	{
-	  errNum = WLZ_ERR_NONE;
+#ifdef _OPENMP
+#pragma omp critical
+	  {
+#endif
+	    if(errNum == WLZ_ERR_NONE)
+	    {
+	      errNum = errNum2D;
+	    }
+#ifdef _OPENMP
+	  }
+#endif
 	}
       }
-      AlcFree(buf);
     }
-    (void )WlzEndGreyScan(&iIWSp, &iGWSp);
-    (void )WlzEndGreyScan(&rIWSp, &rGWSp);
   }
+  WlzIteratePartitionFree(part);
   return(errNum);
 }
@@ -0,0 +1,1074 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzSetOpN_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         libWlz/WlzSetOpN.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	N-ary set operations on domains using a k-way merge of
+* 		intervals.
+* \ingroup	WlzBinaryOps
+*
+* Each line of each plane is computed by a single sweep along the
+* line. A cursor is kept for each of the domains which has intervals
+* on the line and the cursors are kept in a min-heap ordered by the
+* column of their next interval end point. Popping end points from
+* the heap while counting the number of domains which cover the
+* current column gives the intervals of the union (count at least
+* one), the intersection (count equal to the number of domains) or
+* of any intermediate coverage. Only domains which include a line are
+* ever examined for that line, the intervals of the result are
+* allocated once using the counts of the given intervals and the
+* planes of 3D objects are computed in parallel.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <Wlz.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*!
+* \struct	_WlzSetOpNCursor
+* \ingroup	WlzBinaryOps
+* \brief	Cursor through the intervals of a single domain on a
+* 		single line.
+*/
+typedef struct _WlzSetOpNCursor
+{
+  int		off;		/*!< Column offset of the intervals. */
+  int		idx;		/*!< Index of the current interval. */
+  int		nItv;		/*!< Number of intervals on the line. */
+  int		in;		/*!< Non-zero once the current interval
+  				     has been entered. */
+  int		pos;		/*!< Column of the next end point, the
+  				     first column of the current interval
+				     or the column after it's last. */
+  WlzInterval	*itv;		/*!< Intervals on the line. */
+  WlzInterval	rItv;		/*!< Interval for rectangular domains. */
+} WlzSetOpNCursor;
+
+/*!
+* \struct	_WlzSetOpNWSp
+* \ingroup	WlzBinaryOps
+* \brief	Workspace for computing a single plane.
+*/
+typedef struct _WlzSetOpNWSp
+{
+  int		nDom;		/*!< Number of non-empty domains in the
+  				     plane. */
+  int		nAct;		/*!< Number of active domains. */
+  int		nxtAct;		/*!< Next domain (in the sorted order)
+  				     to become active. */
+  int		*key;		/*!< First line of each domain. */
+  int		*order;		/*!< Domain indices sorted by first
+  				     line. */
+  int		*act;		/*!< Indices of the active domains, those
+  				     which include the current line. */
+  int		*heap;		/*!< Min-heap of cursor indices. */
+  int		*pnd;		/*!< Non-zero while a grey scan has an
+  				     interval pending. */
+  int		*cnt;		/*!< Coverage count of each column. */
+  double	*acc;		/*!< Accumulated values of each column. */
+  WlzSetOpNCursor *cur;		/*!< Cursors, one for each domain. */
+  WlzObject	*obj;		/*!< 2D objects of the plane, these are
+  				     not allocated and have no linkcount. */
+  WlzIntervalWSpace *iWSp;	/*!< Interval workspaces for grey
+  				     scanning. */
+  WlzGreyWSpace	*gWSp;		/*!< Grey workspaces for grey scanning. */
+} WlzSetOpNWSp;
+
+static void			WlzSetOpNActive(
+				  WlzSetOpNWSp *wSp,
+				  int ln);
+static void			WlzSetOpNSiftDown(
+				  WlzSetOpNCursor *cur,
+				  int *heap,
+				  int nHeap,
+				  int idx);
+static int			WlzSetOpNLine(
+				  WlzSetOpNWSp *wSp,
+				  int minCov,
+				  int ln,
+				  int kol1,
+				  WlzInterval *itv);
+static WlzErrorNum		WlzSetOpNValues(
+				  WlzSetOpNWSp *wSp,
+				  WlzIntervalDomain *iDom,
+				  WlzRagRValues *vtb,
+				  WlzGreyType gType);
+static WlzErrorNum		WlzSetOpN2D(
+				  WlzSetOpNWSp *wSp,
+				  int minCov,
+				  int uvt,
+				  WlzGreyType gType,
+				  WlzPixelV bgd,
+				  WlzDomain *dstDom,
+				  WlzValues *dstVal);
+static WlzSetOpNWSp		*WlzSetOpNMakeWSp(
+				  int n,
+				  WlzErrorNum *dstErr);
+static void			WlzSetOpNFreeWSp(
+				  WlzSetOpNWSp *wSp);
+
+/*!
+* \return	New object or NULL on error.
+* \ingroup	WlzBinaryOps
+* \brief	Computes the domain of all pixels or voxels which are
+* 		within at least the given number of the given domain
+* 		objects. With a minimum coverage of one this is the
+* 		union of the objects and with a minimum coverage equal
+* 		to the number of objects it is their intersection.
+*
+* 		If grey values are required and all the objects have
+* 		values, then the values of the new object are the mean
+* 		of the values of the objects which cover each pixel or
+* 		voxel. The grey type and background value are those of
+* 		the first object. Tiled values are not supported.
+*
+* 		Empty objects may be given, these cover nothing. All the
+* 		other objects must be of the same type, either 2D or 3D
+* 		domain objects. If no pixels or voxels are within
+* 		the given number of objects then an empty object is
+* 		returned. The planes of 3D objects are computed in
+* 		parallel.
+* \param	n			Number of objects.
+* \param	objs			Array of objects.
+* \param	minCov			Minimum number of objects which must
+* 					cover a pixel or voxel for it to be
+* 					in the new domain, must be in the
+* 					range [1-n].
+* \param	uvt			Compute grey values if non-zero.
+* \param	dstErr			Destination error pointer, may be
+* 					NULL.
+*/
+WlzObject	*WlzSetOpN(int n, WlzObject **objs, int minCov, int uvt,
+			   WlzErrorNum *dstErr)
+{
+  int		idO,
+  		nObj = 0;
+  WlzObjectType	oType = WLZ_EMPTY_OBJ;
+  WlzGreyType	gType = WLZ_GREY_ERROR;
+  WlzPixelV	bgd;
+  WlzDomain	dom;
+  WlzValues	val;
+  WlzObject	*rObj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  dom.core = NULL;
+  val.core = NULL;
+  bgd.type = WLZ_GREY_INT;
+  bgd.v.inv = 0;
+  if((n < 1) || (minCov < 1) || (minCov > n))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else if(objs == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else
+  {
+    for(idO = 0; idO < n; ++idO)
+    {
+      WlzObject	*obj;
+
+      if((obj = objs[idO]) == NULL)
+      {
+        errNum = WLZ_ERR_OBJECT_NULL;
+      }
+      else if(obj->type != WLZ_EMPTY_OBJ)
+      {
+	if((obj->type != WLZ_2D_DOMAINOBJ) &&
+	   (obj->type != WLZ_3D_DOMAINOBJ))
+	{
+	  errNum = WLZ_ERR_OBJECT_TYPE;
+	}
+	else if((oType != WLZ_EMPTY_OBJ) && (obj->type != oType))
+	{
+	  errNum = WLZ_ERR_OBJECT_TYPE;
+	}
+	else if(obj->domain.core == NULL)
+	{
+	  errNum = WLZ_ERR_DOMAIN_NULL;
+	}
+	else if((obj->type == WLZ_3D_DOMAINOBJ) &&
+	        (obj->domain.core->type != WLZ_PLANEDOMAIN_DOMAIN))
+	{
+	  errNum = WLZ_ERR_DOMAIN_TYPE;
+	}
+	else
+	{
+	  oType = obj->type;
+	  if(obj->values.core == NULL)
+	  {
+	    uvt = 0;
+	  }
+	  else if(uvt)
+	  {
+	    if(WlzGreyTableIsTiled(obj->values.core->type) ||
+	       ((obj->type == WLZ_3D_DOMAINOBJ) &&
+		(obj->values.core->type != WLZ_VOXELVALUETABLE_GREY)))
+	    {
+	      errNum = WLZ_ERR_VALUES_TYPE;
+	    }
+	  }
+	  ++nObj;
+	}
+      }
+      if(errNum != WLZ_ERR_NONE)
+      {
+        break;
+      }
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (nObj >= minCov) && uvt)
+  {
+    for(idO = 0; objs[idO]->type == WLZ_EMPTY_OBJ; ++idO)
+    {
+      /* Find the first non-empty object. */
+    }
+    gType = WlzGreyTypeFromObj(objs[idO], &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      bgd = WlzGetBackground(objs[idO], &errNum);
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (nObj >= minCov))
+  {
+    if(oType == WLZ_2D_DOMAINOBJ)
+    {
+      WlzSetOpNWSp *wSp;
+
+      if((wSp = WlzSetOpNMakeWSp(n, &errNum)) != NULL)
+      {
+	for(idO = 0; idO < n; ++idO)
+	{
+	  if(objs[idO]->type == WLZ_2D_DOMAINOBJ)
+	  {
+	    wSp->obj[wSp->nDom].domain = objs[idO]->domain;
+	    wSp->obj[wSp->nDom].values = objs[idO]->values;
+	    ++(wSp->nDom);
+	  }
+	}
+	errNum = WlzSetOpN2D(wSp, minCov, uvt, gType, bgd, &dom, &val);
+	WlzSetOpNFreeWSp(wSp);
+      }
+      if((errNum == WLZ_ERR_NONE) && (dom.core != NULL))
+      {
+        rObj = WlzMakeMain(WLZ_2D_DOMAINOBJ, dom, val, NULL, NULL, &errNum);
+	if(rObj == NULL)
+	{
+	  (void )WlzFreeValueTb(val.v);
+	  (void )WlzFreeIntervalDomain(dom.i);
+	  dom.core = NULL;
+	}
+      }
+    }
+    else
+    {
+      int	idP,
+		nPln = 0,
+		plane1 = 0,
+		lastpl = 0;
+      WlzPlaneDomain *pDom = NULL,
+      		*pDom0 = NULL;
+      WlzVoxelValues *vox = NULL;
+
+      /* Compute the range of planes. */
+      for(idO = 0; idO < n; ++idO)
+      {
+        if(objs[idO]->type == WLZ_3D_DOMAINOBJ)
+	{
+	  WlzPlaneDomain *pD;
+
+	  pD = objs[idO]->domain.p;
+	  if(pDom0 == NULL)
+	  {
+	    pDom0 = pD;
+	    plane1 = pD->plane1;
+	    lastpl = pD->lastpl;
+	  }
+	  else if(minCov == nObj)
+	  {
+	    plane1 = ALG_MAX(plane1, pD->plane1);
+	    lastpl = ALG_MIN(lastpl, pD->lastpl);
+	  }
+	  else
+	  {
+	    plane1 = ALG_MIN(plane1, pD->plane1);
+	    lastpl = ALG_MAX(lastpl, pD->lastpl);
+	  }
+	}
+      }
+      if(plane1 <= lastpl)
+      {
+	pDom = WlzMakePlaneDomain(WLZ_PLANEDOMAIN_DOMAIN, plane1, lastpl,
+				  0, 0, 0, 0, &errNum);
+	if((errNum == WLZ_ERR_NONE) && uvt)
+	{
+	  vox = WlzMakeVoxelValueTb(WLZ_VOXELVALUETABLE_GREY, plane1, lastpl,
+				    bgd, NULL, &errNum);
+	}
+      }
+      if((errNum == WLZ_ERR_NONE) && (pDom != NULL))
+      {
+	/* Compute each plane in parallel. */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for(idP = plane1; idP <= lastpl; ++idP)
+	{
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    int		idQ;
+	    WlzDomain	dom2;
+	    WlzValues	val2;
+	    WlzSetOpNWSp *wSp;
+	    WlzErrorNum	errNum2 = WLZ_ERR_NONE;
+
+	    dom2.core = NULL;
+	    val2.core = NULL;
+	    if((wSp = WlzSetOpNMakeWSp(n, &errNum2)) != NULL)
+	    {
+	      for(idQ = 0; idQ < n; ++idQ)
+	      {
+		WlzObject *obj;
+
+		obj = objs[idQ];
+		if((obj->type == WLZ_3D_DOMAINOBJ) &&
+		   (idP >= obj->domain.p->plane1) &&
+		   (idP <= obj->domain.p->lastpl))
+		{
+		  WlzDomain d;
+
+		  d = obj->domain.p->domains[idP - obj->domain.p->plane1];
+		  if((d.core != NULL) && (d.core->type != WLZ_EMPTY_DOMAIN))
+		  {
+		    WlzObject *o2;
+
+		    o2 = wSp->obj + wSp->nDom;
+		    o2->domain = d;
+		    if(uvt)
+		    {
+		      WlzVoxelValues *vx;
+
+		      vx = obj->values.vox;
+		      if((idP >= vx->plane1) && (idP <= vx->lastpl))
+		      {
+			o2->values = vx->values[idP - vx->plane1];
+		      }
+		      if(o2->values.core == NULL)
+		      {
+			errNum2 = WLZ_ERR_VALUES_NULL;
+		      }
+		    }
+		    ++(wSp->nDom);
+		  }
+		}
+	      }
+	      if(errNum2 == WLZ_ERR_NONE)
+	      {
+		errNum2 = WlzSetOpN2D(wSp, minCov, uvt, gType, bgd,
+				      &dom2, &val2);
+	      }
+	      WlzSetOpNFreeWSp(wSp);
+	    }
+	    if(errNum2 == WLZ_ERR_NONE)
+	    {
+	      pDom->domains[idP - plane1] = WlzAssignDomain(dom2, NULL);
+	      if(vox)
+	      {
+		vox->values[idP - plane1] = WlzAssignValues(val2, NULL);
+	      }
+	    }
+	    else
+	    {
+#ifdef _OPENMP
+#pragma omp critical (WlzSetOpN)
+#endif
+	      {
+		errNum = errNum2;
+	      }
+	    }
+	  }
+	}
+      }
+      if((errNum == WLZ_ERR_NONE) && (pDom != NULL))
+      {
+	for(idP = plane1; idP <= lastpl; ++idP)
+	{
+	  if(pDom->domains[idP - plane1].core != NULL)
+	  {
+	    ++nPln;
+	  }
+	}
+      }
+      if((errNum == WLZ_ERR_NONE) && (nPln > 0))
+      {
+	pDom->voxel_size[0] = pDom0->voxel_size[0];
+	pDom->voxel_size[1] = pDom0->voxel_size[1];
+	pDom->voxel_size[2] = pDom0->voxel_size[2];
+	errNum = WlzStandardPlaneDomain(pDom, vox);
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  dom.p = pDom;
+	  val.vox = vox;
+	  rObj = WlzMakeMain(WLZ_3D_DOMAINOBJ, dom, val, NULL, NULL, &errNum);
+	}
+      }
+      if(rObj == NULL)
+      {
+	(void )WlzFreeVoxelValueTb(vox);
+	(void )WlzFreePlaneDomain(pDom);
+      }
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (rObj == NULL))
+  {
+    rObj = WlzMakeEmpty(&errNum);
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(rObj);
+}
+
+/*!
+* \ingroup	WlzBinaryOps
+* \brief	Updates the active domains of the workspace for the
+* 		given line, adding those domains which start on or
+* 		before the line and removing those which end before it.
+* 		Lines must be visited in increasing order after
+* 		resetting the number of active domains and the next
+* 		domain to become active to zero.
+* \param	wSp			Workspace.
+* \param	ln			Line.
+*/
+static void	WlzSetOpNActive(WlzSetOpNWSp *wSp, int ln)
+{
+  int		idA,
+  		idB;
+
+  while((wSp->nxtAct < wSp->nDom) &&
+        (wSp->key[wSp->order[wSp->nxtAct]] <= ln))
+  {
+    wSp->act[(wSp->nAct)++] = wSp->order[(wSp->nxtAct)++];
+  }
+  for(idA = idB = 0; idA < wSp->nAct; ++idA)
+  {
+    int		idD;
+
+    idD = wSp->act[idA];
+    if(wSp->obj[idD].domain.i->lastln >= ln)
+    {
+      wSp->act[idB++] = idD;
+    }
+  }
+  wSp->nAct = idB;
+}
+
+/*!
+* \ingroup	WlzBinaryOps
+* \brief	Sifts the given entry down the min-heap of cursor
+* 		indices.
+* \param	cur			Cursors.
+* \param	heap			Heap of cursor indices.
+* \param	nHeap			Number of entries in the heap.
+* \param	idx			Index of the entry to sift down.
+*/
+static void	WlzSetOpNSiftDown(WlzSetOpNCursor *cur, int *heap,
+				  int nHeap, int idx)
+{
+  int		c,
+  		h;
+
+  h = heap[idx];
+  while((c = (2 * idx) + 1) < nHeap)
+  {
+    if((c + 1 < nHeap) && (cur[heap[c + 1]].pos < cur[heap[c]].pos))
+    {
+      ++c;
+    }
+    if(cur[heap[c]].pos >= cur[h].pos)
+    {
+      break;
+    }
+    heap[idx] = heap[c];
+    idx = c;
+  }
+  heap[idx] = h;
+}
+
+/*!
+* \return	Number of intervals computed for the line.
+* \ingroup	WlzBinaryOps
+* \brief	Computes the intervals of the given line which are
+* 		covered by at least the given number of the active
+* 		domains. Adjacent and overlapping intervals are merged.
+* \param	wSp			Workspace with the active domains
+* 					set for the line.
+* \param	minCov			Minimum coverage.
+* \param	ln			Line.
+* \param	kol1			Column origin for the computed
+* 					intervals.
+* \param	itv			Destination for the intervals, there
+* 					must be room for at least the number
+* 					of intervals of the active domains
+* 					on the line.
+*/
+static int	WlzSetOpNLine(WlzSetOpNWSp *wSp, int minCov, int ln,
+			      int kol1, WlzInterval *itv)
+{
+  int		idA,
+  		cov = 0,
+		nHeap = 0,
+		nItv = 0,
+		wasIn = 0,
+		runLft = 0;
+
+  /* Set up a cursor for each active domain with intervals on the line. */
+  for(idA = 0; idA < wSp->nAct; ++idA)
+  {
+    WlzSetOpNCursor *c;
+    WlzIntervalDomain *iDom;
+
+    c = wSp->cur + nHeap;
+    iDom = wSp->obj[wSp->act[idA]].domain.i;
+    if(iDom->type == WLZ_INTERVALDOMAIN_INTVL)
+    {
+      WlzIntervalLine *iLn;
+
+      iLn = iDom->intvlines + ln - iDom->line1;
+      c->nItv = iLn->nintvs;
+      c->itv = iLn->intvs;
+    }
+    else
+    {
+      c->rItv.ileft = 0;
+      c->rItv.iright = iDom->lastkl - iDom->kol1;
+      c->nItv = 1;
+      c->itv = &(c->rItv);
+    }
+    if(c->nItv > 0)
+    {
+      c->off = iDom->kol1;
+      c->idx = 0;
+      c->in = 0;
+      c->pos = c->itv[0].ileft + c->off;
+      wSp->heap[nHeap] = nHeap;
+      ++nHeap;
+    }
+  }
+  if(nHeap >= minCov)
+  {
+    for(idA = (nHeap / 2) - 1; idA >= 0; --idA)
+    {
+      WlzSetOpNSiftDown(wSp->cur, wSp->heap, nHeap, idA);
+    }
+    /* Pop end points in column order, counting the coverage. */
+    while(nHeap > 0)
+    {
+      int	x,
+      		isIn;
+
+      x = wSp->cur[wSp->heap[0]].pos;
+      while((nHeap > 0) && (wSp->cur[wSp->heap[0]].pos == x))
+      {
+	WlzSetOpNCursor *c;
+
+	c = wSp->cur + wSp->heap[0];
+	if(c->in == 0)
+	{
+	  ++cov;
+	  c->in = 1;
+	  c->pos = c->itv[c->idx].iright + c->off + 1;
+	}
+	else
+	{
+	  --cov;
+	  c->in = 0;
+	  if(++(c->idx) < c->nItv)
+	  {
+	    c->pos = c->itv[c->idx].ileft + c->off;
+	  }
+	  else
+	  {
+	    wSp->heap[0] = wSp->heap[--nHeap];
+	  }
+	}
+	WlzSetOpNSiftDown(wSp->cur, wSp->heap, nHeap, 0);
+      }
+      isIn = cov >= minCov;
+      if(isIn && !wasIn)
+      {
+        runLft = x;
+      }
+      else if(wasIn && !isIn)
+      {
+        itv[nItv].ileft = runLft - kol1;
+        itv[nItv].iright = x - 1 - kol1;
+	++nItv;
+      }
+      wasIn = isIn;
+    }
+  }
+  return(nItv);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzBinaryOps
+* \brief	Sets the values of the given (standardised) interval
+* 		domain to the mean of the values of the domains which
+* 		cover each pixel. The values of each interval of the
+* 		given domains are added to a buffer for the line as
+* 		a contiguous run.
+* \param	wSp			Workspace.
+* \param	iDom			Interval domain of the values.
+* \param	vtb			Ragged rectangle values to be set.
+* \param	gType			Grey type of the values.
+*/
+static WlzErrorNum WlzSetOpNValues(WlzSetOpNWSp *wSp,
+				   WlzIntervalDomain *iDom,
+				   WlzRagRValues *vtb, WlzGreyType gType)
+{
+  int		idD,
+  		ln,
+		span,
+		nCh,
+		nInit = 0;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  nCh = (gType == WLZ_GREY_RGBA)? 4: 1;
+  span = iDom->lastkl - iDom->kol1 + 1;
+  if(((wSp->cnt = (int *)AlcMalloc(sizeof(int) * span)) == NULL) ||
+     ((wSp->acc = (double *)
+                  AlcMalloc(sizeof(double) * nCh * span)) == NULL))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  for(idD = 0; (errNum == WLZ_ERR_NONE) && (idD < wSp->nDom); ++idD)
+  {
+    errNum = WlzInitGreyScan(wSp->obj + idD, wSp->iWSp + idD,
+                             wSp->gWSp + idD);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      ++nInit;
+      if(wSp->gWSp[idD].pixeltype != gType)
+      {
+        errNum = WLZ_ERR_GREY_TYPE;
+      }
+      else
+      {
+        wSp->pnd[idD] = WlzNextGreyInterval(wSp->iWSp + idD) ==
+	                WLZ_ERR_NONE;
+      }
+    }
+  }
+  wSp->nAct = 0;
+  wSp->nxtAct = 0;
+  for(ln = iDom->line1; (errNum == WLZ_ERR_NONE) && (ln <= iDom->lastln);
+      ++ln)
+  {
+    int		idA,
+    		idI;
+    WlzIntervalLine *iLn;
+
+    iLn = iDom->intvlines + ln - iDom->line1;
+    WlzSetOpNActive(wSp, ln);
+    if(iLn->nintvs > 0)
+    {
+      WlzValueLine *vLn;
+
+      /* Clear the buffers for the intervals of the line. */
+      for(idI = 0; idI < iLn->nintvs; ++idI)
+      {
+	int	l,
+		r;
+
+	l = iLn->intvs[idI].ileft;
+	r = iLn->intvs[idI].iright;
+	(void )memset(wSp->cnt + l, 0, sizeof(int) * (r - l + 1));
+	(void )memset(wSp->acc + (nCh * l), 0,
+		      sizeof(double) * nCh * (r - l + 1));
+      }
+      /* Accumulate the values of the intervals of the active domains. */
+      for(idA = 0; idA < wSp->nAct; ++idA)
+      {
+	WlzIntervalWSpace *iWSp;
+	WlzGreyWSpace *gWSp;
+
+	idD = wSp->act[idA];
+	iWSp = wSp->iWSp + idD;
+	gWSp = wSp->gWSp + idD;
+	while(wSp->pnd[idD] && (iWSp->linpos < ln))
+	{
+	  wSp->pnd[idD] = WlzNextGreyInterval(iWSp) == WLZ_ERR_NONE;
+	}
+	while(wSp->pnd[idD] && (iWSp->linpos == ln))
+	{
+	  int	k,
+		l,
+		r;
+	  int	*cP;
+	  double *aP;
+	  WlzGreyP gP;
+
+	  l = ALG_MAX(iWSp->lftpos, iDom->kol1);
+	  r = ALG_MIN(iWSp->rgtpos, iDom->lastkl);
+	  cP = wSp->cnt + l - iDom->kol1;
+	  aP = wSp->acc + (nCh * (l - iDom->kol1));
+	  gP = gWSp->u_grintptr;
+	  k = l - iWSp->lftpos;
+	  for(; l <= r; ++l, ++k)
+	  {
+	    ++*cP++;
+	    switch(gType)
+	    {
+	      case WLZ_GREY_INT:
+		*aP++ += gP.inp[k];
+		break;
+	      case WLZ_GREY_SHORT:
+		*aP++ += gP.shp[k];
+		break;
+	      case WLZ_GREY_UBYTE:
+		*aP++ += gP.ubp[k];
+		break;
+	      case WLZ_GREY_FLOAT:
+		*aP++ += gP.flp[k];
+		break;
+	      case WLZ_GREY_DOUBLE:
+		*aP++ += gP.dbp[k];
+		break;
+	      case WLZ_GREY_RGBA:
+		*aP++ += WLZ_RGBA_RED_GET(gP.rgbp[k]);
+		*aP++ += WLZ_RGBA_GREEN_GET(gP.rgbp[k]);
+		*aP++ += WLZ_RGBA_BLUE_GET(gP.rgbp[k]);
+		*aP++ += WLZ_RGBA_ALPHA_GET(gP.rgbp[k]);
+		break;
+	      default:
+		break;
+	    }
+	  }
+	  wSp->pnd[idD] = WlzNextGreyInterval(iWSp) == WLZ_ERR_NONE;
+	}
+      }
+      /* Set the mean values of the intervals of the line. */
+      vLn = vtb->vtblines + ln - vtb->line1;
+      for(idI = 0; idI < iLn->nintvs; ++idI)
+      {
+	int	k,
+		l,
+		r;
+	WlzGreyP gP;
+
+	l = iLn->intvs[idI].ileft;
+	r = iLn->intvs[idI].iright;
+	k = l + iDom->kol1 - vtb->kol1 - vLn->vkol1;
+	gP = vLn->values;
+	for(; l <= r; ++l, ++k)
+	{
+	  double c,
+	  	 *aP;
+
+	  c = wSp->cnt[l];
+	  aP = wSp->acc + (nCh * l);
+	  switch(gType)
+	  {
+	    case WLZ_GREY_INT:
+	      gP.inp[k] = (int )(*aP / c);
+	      break;
+	    case WLZ_GREY_SHORT:
+	      gP.shp[k] = (short )(*aP / c);
+	      break;
+	    case WLZ_GREY_UBYTE:
+	      gP.ubp[k] = (WlzUByte )(*aP / c);
+	      break;
+	    case WLZ_GREY_FLOAT:
+	      gP.flp[k] = (float )(*aP / c);
+	      break;
+	    case WLZ_GREY_DOUBLE:
+	      gP.dbp[k] = *aP / c;
+	      break;
+	    case WLZ_GREY_RGBA:
+	      WLZ_RGBA_RGBA_SET(gP.rgbp[k],
+	                        (WlzUInt )(aP[0] / c), (WlzUInt )(aP[1] / c),
+	                        (WlzUInt )(aP[2] / c), (WlzUInt )(aP[3] / c));
+	      break;
+	    default:
+	      break;
+	  }
+	}
+      }
+    }
+  }
+  for(idD = 0; idD < nInit; ++idD)
+  {
+    (void )WlzEndGreyScan(wSp->iWSp + idD, wSp->gWSp + idD);
+  }
+  AlcFree(wSp->cnt);
+  AlcFree(wSp->acc);
+  wSp->cnt = NULL;
+  wSp->acc = NULL;
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzBinaryOps
+* \brief	Computes the domain, and if required the values, of
+* 		those pixels which are covered by at least the given
+* 		number of the 2D objects of the workspace.
+* \param	wSp			Workspace with the 2D objects set.
+* \param	minCov			Minimum coverage.
+* \param	uvt			Compute values if non-zero.
+* \param	gType			Grey type for values.
+* \param	bgd			Background value for values.
+* \param	dstDom			Destination pointer for the domain,
+* 					set to NULL if the domain is empty.
+* \param	dstVal			Destination pointer for the values.
+*/
+static WlzErrorNum WlzSetOpN2D(WlzSetOpNWSp *wSp, int minCov, int uvt,
+			       WlzGreyType gType, WlzPixelV bgd,
+			       WlzDomain *dstDom, WlzValues *dstVal)
+{
+  int		idD,
+  		ln,
+		nItv = 0,
+		line1 = 0,
+		lastln = -1,
+		kol1 = 0,
+		lastkl = -1;
+  WlzInterval	*itv = NULL,
+  		*itvP;
+  WlzIntervalDomain *iDom = NULL;
+  WlzRagRValues *vtb = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  /* Check the domains and compute the bounding box of the result, for an
+   * intersection this is the intersection of the bounding boxes. */
+  if(wSp->nDom >= minCov)
+  {
+    for(idD = 0; (errNum == WLZ_ERR_NONE) && (idD < wSp->nDom); ++idD)
+    {
+      WlzIntervalDomain *d;
+
+      d = wSp->obj[idD].domain.i;
+      if((d->type != WLZ_INTERVALDOMAIN_INTVL) &&
+         (d->type != WLZ_INTERVALDOMAIN_RECT))
+      {
+        errNum = WLZ_ERR_DOMAIN_TYPE;
+      }
+      else if(idD == 0)
+      {
+        line1 = d->line1;
+	lastln = d->lastln;
+	kol1 = d->kol1;
+	lastkl = d->lastkl;
+      }
+      else if(minCov == wSp->nDom)
+      {
+	line1 = ALG_MAX(line1, d->line1);
+	lastln = ALG_MIN(lastln, d->lastln);
+	kol1 = ALG_MAX(kol1, d->kol1);
+	lastkl = ALG_MIN(lastkl, d->lastkl);
+      }
+      else
+      {
+	line1 = ALG_MIN(line1, d->line1);
+	lastln = ALG_MAX(lastln, d->lastln);
+	kol1 = ALG_MIN(kol1, d->kol1);
+	lastkl = ALG_MAX(lastkl, d->lastkl);
+      }
+      if(errNum == WLZ_ERR_NONE)
+      {
+        nItv += WlzIntervalCount(d, &errNum);
+      }
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (line1 <= lastln) && (kol1 <= lastkl) &&
+     (nItv > 0))
+  {
+    /* Allocate the intervals using the counts of the given intervals:
+     * each interval of the result ends at the end of a given interval. */
+    if((iDom = WlzMakeIntervalDomain(WLZ_INTERVALDOMAIN_INTVL,
+				     line1, lastln, kol1, lastkl,
+				     &errNum)) != NULL)
+    {
+      if((itv = (WlzInterval *)
+                AlcMalloc(sizeof(WlzInterval) * nItv)) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      else
+      {
+	iDom->freeptr = AlcFreeStackPush(iDom->freeptr, (void *)itv, NULL);
+      }
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (iDom != NULL))
+  {
+    for(idD = 0; idD < wSp->nDom; ++idD)
+    {
+      wSp->key[idD] = wSp->obj[idD].domain.i->line1;
+      wSp->order[idD] = idD;
+    }
+    (void )AlgHeapSortIdx(wSp->key, wSp->order, wSp->nDom,
+                          AlgHeapSortCmpIdxIFn);
+    itvP = itv;
+    wSp->nAct = 0;
+    wSp->nxtAct = 0;
+    for(ln = line1; ln <= lastln; ++ln)
+    {
+      int	n;
+
+      WlzSetOpNActive(wSp, ln);
+      if(wSp->nAct >= minCov)
+      {
+	n = WlzSetOpNLine(wSp, minCov, ln, kol1, itvP);
+	if(n > 0)
+	{
+	  (void )WlzMakeInterval(ln, iDom, n, itvP);
+	  itvP += n;
+	}
+      }
+    }
+    if(itvP == itv)
+    {
+      (void )WlzFreeIntervalDomain(iDom);
+      iDom = NULL;
+    }
+    else
+    {
+      errNum = WlzStandardIntervalDomain(iDom);
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (iDom != NULL) && uvt)
+  {
+    WlzObject	tObj;
+    WlzObjectType vType;
+
+    tObj.type = WLZ_2D_DOMAINOBJ;
+    tObj.linkcount = 0;
+    tObj.domain.i = iDom;
+    tObj.values.core = NULL;
+    tObj.plist = NULL;
+    tObj.assoc = NULL;
+    vType = WlzGreyTableType(WLZ_GREY_TAB_RAGR, gType, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      vtb = WlzNewValueTb(&tObj, vType, bgd, &errNum);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = WlzSetOpNValues(wSp, iDom, vtb, gType);
+    }
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    (void )WlzFreeValueTb(vtb);
+    (void )WlzFreeIntervalDomain(iDom);
+    iDom = NULL;
+    vtb = NULL;
+  }
+  dstDom->i = iDom;
+  dstVal->v = vtb;
+  return(errNum);
+}
+
+/*!
+* \return	New workspace or NULL on error.
+* \ingroup	WlzBinaryOps
+* \brief	Makes a new workspace with room for the given number
+* 		of domains, the 2D objects of which are initialised to
+* 		have no domain or values.
+* \param	n			Maximum number of domains.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzSetOpNWSp *WlzSetOpNMakeWSp(int n, WlzErrorNum *dstErr)
+{
+  int		idD;
+  WlzSetOpNWSp	*wSp;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(((wSp = (WlzSetOpNWSp *)AlcCalloc(1, sizeof(WlzSetOpNWSp))) == NULL) ||
+     ((wSp->key = (int *)AlcMalloc(sizeof(int) * 5 * n)) == NULL) ||
+     ((wSp->cur = (WlzSetOpNCursor *)
+                  AlcMalloc(sizeof(WlzSetOpNCursor) * n)) == NULL) ||
+     ((wSp->obj = (WlzObject *)AlcCalloc(n, sizeof(WlzObject))) == NULL) ||
+     ((wSp->iWSp = (WlzIntervalWSpace *)
+                   AlcMalloc(sizeof(WlzIntervalWSpace) * n)) == NULL) ||
+     ((wSp->gWSp = (WlzGreyWSpace *)
+                   AlcMalloc(sizeof(WlzGreyWSpace) * n)) == NULL))
+  {
+    WlzSetOpNFreeWSp(wSp);
+    wSp = NULL;
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    wSp->order = wSp->key + n;
+    wSp->act = wSp->key + (2 * n);
+    wSp->heap = wSp->key + (3 * n);
+    wSp->pnd = wSp->key + (4 * n);
+    for(idD = 0; idD < n; ++idD)
+    {
+      wSp->obj[idD].type = WLZ_2D_DOMAINOBJ;
+    }
+  }
+  *dstErr = errNum;
+  return(wSp);
+}
+
+/*!
+* \ingroup	WlzBinaryOps
+* \brief	Frees a workspace.
+* \param	wSp			Given workspace, may be NULL.
+*/
+static void	WlzSetOpNFreeWSp(WlzSetOpNWSp *wSp)
+{
+  if(wSp)
+  {
+    AlcFree(wSp->key);
+    AlcFree(wSp->cur);
+    AlcFree(wSp->obj);
+    AlcFree(wSp->iWSp);
+    AlcFree(wSp->gWSp);
+    AlcFree(wSp->cnt);
+    AlcFree(wSp->acc);
+    AlcFree(wSp);
+  }
+}
@@ -171,6 +171,9 @@ const char	*WlzStringFromObjTypeValue(WlzObjectType objType,
     case WLZ_CMESH_TRANS:
       oTypeStr = "WLZ_CMESH_TRANS";
       break;
+    case WLZ_DISP_TRANS:
+      oTypeStr = "WLZ_DISP_TRANS";
+      break;
     case WLZ_LUT:
       oTypeStr = "WLZ_LUT";
       break;
@@ -234,6 +237,7 @@ WlzObjectType	WlzStringToObjType(const char *oTypeStr,
 		"WLZ_EMPTY_OBJ", WLZ_EMPTY_OBJ,
 		"WLZ_MESH_TRANS", WLZ_MESH_TRANS,
 		"WLZ_CMESH_TRANS", WLZ_CMESH_TRANS,
+		"WLZ_DISP_TRANS", WLZ_DISP_TRANS,
 		"WLZ_LUT", WLZ_LUT,
 		"WLZ_3D_VIEW_STRUCT", WLZ_3D_VIEW_STRUCT,
 		"WLZ_POINTS", WLZ_POINTS,
@@ -953,6 +957,18 @@ const char	*WlzStringFromTransformType(WlzTransformType tType,
     case WLZ_TRANSFORM_3D_CMESH:
       tStr = "WLZ_TRANSFORM_3D_CMESH";
       break;
+    case WLZ_TRANSFORM_2D_DISP:
+      tStr = "WLZ_TRANSFORM_2D_DISP";
+      break;
+    case WLZ_TRANSFORM_3D_DISP:
+      tStr = "WLZ_TRANSFORM_3D_DISP";
+      break;
+    case WLZ_TRANSFORM_2D_CHAIN:
+      tStr = "WLZ_TRANSFORM_2D_CHAIN";
+      break;
+    case WLZ_TRANSFORM_3D_CHAIN:
+      tStr = "WLZ_TRANSFORM_3D_CHAIN";
+      break;
     default:
       errNum = WLZ_ERR_TRANSFORM_TYPE;
       break;
@@ -997,6 +1013,10 @@ WlzTransformType WlzStringToTransformType(const char *tStr,
 		      "WLZ_TRANSFORM_3D_MESH", WLZ_TRANSFORM_3D_MESH,
 		      "WLZ_TRANSFORM_2D_CMESH", WLZ_TRANSFORM_2D_CMESH,
 		      "WLZ_TRANSFORM_3D_CMESH", WLZ_TRANSFORM_3D_CMESH,
+		      "WLZ_TRANSFORM_2D_DISP", WLZ_TRANSFORM_2D_DISP,
+		      "WLZ_TRANSFORM_3D_DISP", WLZ_TRANSFORM_3D_DISP,
+		      "WLZ_TRANSFORM_2D_CHAIN", WLZ_TRANSFORM_2D_CHAIN,
+		      "WLZ_TRANSFORM_3D_CHAIN", WLZ_TRANSFORM_3D_CHAIN,
 		      NULL))
   {
     tType = (WlzTransformType )tI0;
@@ -61,6 +61,9 @@ static WlzObject  		*WlzMakeTiledValuesObj2D(
 				  WlzGreyType gType,
 				  WlzPixelV bgdV,
 				  WlzErrorNum *dstErr);
+static WlzErrorNum		WlzTiledValuesDecodeTileAt(
+				  WlzTiledValues *tv,
+				  size_t idx);
 static WlzObject  		*WlzMakeTiledValuesObj3D(
 				  WlzObject *gObj,
 				  size_t tileSz,
@@ -69,6 +72,38 @@ static WlzObject  		*WlzMakeTiledValuesObj3D(
 				  WlzPixelV bgdV,
 				  WlzErrorNum *dstErr);
 
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzValuesUtils
+* \brief	Decodes a single tile from the compressed tiles of the
+* 		tiled values which own the tiles, setting the tile to the
+* 		background value if it can not be decoded.
+* \param	tv			Tiled values which own the tiles.
+* \param	idx			Index of the tile.
+*/
+static WlzErrorNum WlzTiledValuesDecodeTileAt(WlzTiledValues *tv,
+					      size_t idx)
+{
+  size_t	gSz,
+  		rSz = 0;
+  WlzGreyP	tP;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  gSz = WlzGreySize(WlzGreyTableTypeToGreyType(tv->type, NULL));
+  tP.ubp = tv->tiles.ubp + (idx * tv->tileSz * gSz);
+  errNum = WlzValueCmpDecodeBlk(tv->cmpTiles, tv->cmpTilesSz, (int )idx,
+  				tP.ubp, &rSz);
+  if((errNum == WLZ_ERR_NONE) && (rSz != tv->tileSz * gSz))
+  {
+    errNum = WLZ_ERR_READ_INCOMPLETE;
+  }
+  if(errNum != WLZ_ERR_NONE)
+  {
+    WlzValueSetGrey(tP, 0, tv->bckgrnd.v, tv->bckgrnd.type, tv->tileSz);
+  }
+  return(errNum);
+}
+
 /*!
 * \return	New tiled values.
 * \ingroup	WlzAllocation
@@ -144,19 +179,27 @@ WlzErrorNum	WlzFreeTiledValues(WlzTiledValues *tVal)
       else
       {
 	AlcFree(tVal->indices);
+	AlcFree(tVal->cmpTiles);
+	AlcFree(tVal->tileDecoded);
 	if(tVal->tiles.v)
 	{
 #ifdef WLZ_USE_MMAP
 	  if(tVal->fd >= 0)
 	  {
+	    long	  pgSz,
+	    		  pgOff;
 	    size_t        gSz,
 			  tSz;
 	    WlzGreyType	gType;
 
+	    /* The mapping starts at the page containing the first tile. */
 	    gType = WlzGreyTableTypeToGreyType(tVal->type, &errNum);
 	    gSz = WlzGreySize(gType);
 	    tSz = tVal->numTiles * tVal->tileSz;
-	    (void )munmap(tVal->tiles.v, tSz * gSz);
+	    pgSz = sysconf(_SC_PAGESIZE);
+	    pgOff = (pgSz > 0)? tVal->tileOffset % pgSz: 0;
+	    (void )munmap((WlzUByte *)(tVal->tiles.v) - pgOff,
+	                  (tSz * gSz) + pgOff);
 	    (void )close(tVal->fd);
 	  }
 	  else
@@ -330,6 +373,111 @@ WlzErrorNum	WlzMakeTiledValuesTiles(WlzTiledValues *tVal)
   return(errNum);
 }
 
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzValuesUtils
+* \brief	Makes sure that the tile with the given index is decoded.
+* 		Tiles which are read compressed are only decoded when
+* 		first accessed and this function should be called before
+* 		accessing the values of a tile directly. It may be called
+* 		concurrently from several threads. If the tile can not
+* 		be decoded it is set to the background value.
+* \param	tv			Given tiled values, which may share
+* 					the tiles of an original table.
+* \param	idx			Index of the tile.
+*/
+WlzErrorNum	WlzTiledValuesDecodeTile(WlzTiledValues *tv, size_t idx)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(tv == NULL)
+  {
+    errNum = WLZ_ERR_VALUES_NULL;
+  }
+  else
+  {
+    while(tv->original_table.core)
+    {
+      tv = tv->original_table.t;
+    }
+    if(tv->tileDecoded && (idx < tv->numTiles) && (tv->tileDecoded[idx] == 0))
+    {
+#ifdef _OPENMP
+#pragma omp critical (WlzTiledValuesDecodeTile)
+#endif
+      {
+	if(tv->tileDecoded[idx] == 0)
+	{
+	  errNum = WlzTiledValuesDecodeTileAt(tv, idx);
+	  tv->tileDecoded[idx] = 1;
+	}
+      }
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzValuesUtils
+* \brief	Decodes all the tiles which have not yet been decoded,
+* 		in parallel, and then frees the compressed tiles. This
+* 		should be called before accessing all the tiles as a
+* 		single buffer and must not be called while other threads
+* 		are accessing the tiles.
+* \param	tv			Given tiled values, which may share
+* 					the tiles of an original table.
+*/
+WlzErrorNum	WlzTiledValuesDecode(WlzTiledValues *tv)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(tv == NULL)
+  {
+    errNum = WLZ_ERR_VALUES_NULL;
+  }
+  else
+  {
+    while(tv->original_table.core)
+    {
+      tv = tv->original_table.t;
+    }
+    if(tv->tileDecoded)
+    {
+      long	idx;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+      for(idx = 0; idx < (long )(tv->numTiles); ++idx)
+      {
+	if(tv->tileDecoded[idx] == 0)
+	{
+	  WlzErrorNum	errNum2;
+
+	  errNum2 = WlzTiledValuesDecodeTileAt(tv, idx);
+	  tv->tileDecoded[idx] = 1;
+	  if(errNum2 != WLZ_ERR_NONE)
+	  {
+#ifdef _OPENMP
+#pragma omp critical (WlzTiledValuesDecode)
+#endif
+	    {
+	      errNum = errNum2;
+	    }
+	  }
+	}
+      }
+      AlcFree(tv->cmpTiles);
+      AlcFree(tv->tileDecoded);
+      tv->cmpTiles = NULL;
+      tv->cmpTilesSz = 0;
+      tv->tileDecoded = NULL;
+    }
+  }
+  return(errNum);
+}
+
 /*!
 * \return	Flags specifying how the value table may be used.
 * \ingroup	WlzValuesUtils
@@ -498,23 +646,26 @@ void		WlzTiledValueBufferFlush(WlzTiledValueBuffer *tvb,
     while(kol <= tvb->kl[1])
     {
       int	i,
+		ii,
       		io,
-		itc = 0,
+		itc,
 		rmn;
-      size_t	ii;
 
       ti = kol / tv->tileWidth;
       to = kol % tv->tileWidth;
       io = tvb->lo + to;
+      rmn = tvb->kl[1] - kol + 1;
+      itc = tv->tileWidth - to;
+      if(itc > rmn)
+      {
+	itc = rmn;
+      }
+      /* As in WlzTiledValueBufferFill(), a negative index is a missing
+       * tile which only has background values. */
       ii = *(tv->indices + tvb->li + ti);
-      if(ii > 0)
+      if(ii >= 0)
       {
-	rmn = tvb->kl[1] - kol + 1;
-	itc = tv->tileWidth - to;
-	if(itc > rmn)
-	{
-	  itc = rmn;
-	}
+	(void )WlzTiledValuesDecodeTile(tv, ii);
 	switch(tvb->gtype)
 	{
 	  case WLZ_GREY_LONG:
@@ -666,6 +817,10 @@ void		WlzTiledValueBufferFill(WlzTiledValueBuffer *tvb,
       }
       io = tvb->lo + to[0];
       ii = *(tv->indices + tvb->li + ti[0]);
+      if(ii >= 0)
+      {
+	(void )WlzTiledValuesDecodeTile(tv, ii);
+      }
       switch(tvb->gtype)
       {
 	case WLZ_GREY_LONG:
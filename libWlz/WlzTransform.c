@@ -139,6 +139,14 @@ WlzErrorNum	WlzFreeTransform(WlzTransform tr)
       case WLZ_TRANSFORM_3D_CMESH:
         errNum = WlzFreeObj(tr.obj);
 	break;
+      case WLZ_TRANSFORM_2D_DISP:		/* FALLTHROUGH */
+      case WLZ_TRANSFORM_3D_DISP:
+        errNum = WlzFreeDispFieldTransform(tr.disp);
+	break;
+      case WLZ_TRANSFORM_2D_CHAIN:		/* FALLTHROUGH */
+      case WLZ_TRANSFORM_3D_CHAIN:
+        errNum = WlzFreeTransformChain(tr.chain);
+	break;
       default:
 	errNum = WLZ_ERR_TRANSFORM_TYPE;
         break;
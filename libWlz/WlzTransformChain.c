@@ -0,0 +1,835 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzTransformChain_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         libWlz/WlzTransformChain.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Chains of transforms which are composed only when they
+* 		are applied, so that objects may be transformed by a
+* 		sequence of affine, basis function, mesh and displacement
+* 		field transforms using a single resampling pass.
+* \ingroup	WlzTransform
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <Wlz.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*!
+* \def		WLZ_TRANSFORMCHAIN_INC
+* \ingroup	WlzTransform
+* \brief	Number of transforms by which the space allocated for
+* 		a transform chain is increased.
+*/
+#define WLZ_TRANSFORMCHAIN_INC	(8)
+
+static int			WlzTransformChainContains(
+				  WlzTransformChain *chain,
+				  WlzTransformChain *target);
+static int			WlzTransformChainTrDim(
+				  WlzTransformType type);
+static WlzTransformType		WlzTransformChainTrType(
+				  WlzTransform tr);
+static WlzErrorNum		WlzTransformChainTrFree(
+				  WlzTransform tr);
+static WlzErrorNum		WlzTransformChainTrVtx(
+				  WlzTransform tr,
+				  WlzCMeshLattice *lat,
+				  int n,
+				  WlzDVertex3 *vtx,
+				  WlzDVertex2 *vtx2);
+static WlzObject		*WlzTransformChainPoints(
+				  WlzObject *srcObj,
+				  WlzTransformChain *chain,
+				  WlzErrorNum *dstErr);
+
+/*!
+* \return	New transform chain or NULL on error.
+* \ingroup	WlzTransform
+* \brief	Makes a new empty transform chain, which is an identity
+* 		transform until transforms are appended to it.
+* \param	type			Transform type, which must be either
+* 					WLZ_TRANSFORM_2D_CHAIN or
+* 					WLZ_TRANSFORM_3D_CHAIN.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzTransformChain *WlzMakeTransformChain(WlzTransformType type,
+				WlzErrorNum *dstErr)
+{
+  WlzTransformChain *chain = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((type != WLZ_TRANSFORM_2D_CHAIN) && (type != WLZ_TRANSFORM_3D_CHAIN))
+  {
+    errNum = WLZ_ERR_TRANSFORM_TYPE;
+  }
+  else if((chain = (WlzTransformChain *)
+                   AlcCalloc(1, sizeof(WlzTransformChain))) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    chain->type = type;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(chain);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Frees the given transform chain, which is only freed
+* 		when it's link count falls to zero. The transforms of
+* 		the chain are unlinked and freed if no longer used
+* 		elsewhere.
+* \param	chain			Given transform chain.
+*/
+WlzErrorNum	WlzFreeTransformChain(WlzTransformChain *chain)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(chain != NULL)
+  {
+    if((chain->type != WLZ_TRANSFORM_2D_CHAIN) &&
+       (chain->type != WLZ_TRANSFORM_3D_CHAIN))
+    {
+      errNum = WLZ_ERR_TRANSFORM_TYPE;
+    }
+    else if(WlzUnlink(&(chain->linkcount), &errNum))
+    {
+      int	idT;
+
+      for(idT = 0; idT < chain->nTr; ++idT)
+      {
+	WlzErrorNum errNum2;
+
+	(void )WlzCMeshLatticeFree(chain->lat[idT]);
+	errNum2 = WlzTransformChainTrFree(chain->tr[idT]);
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  errNum = errNum2;
+	}
+      }
+      AlcFree(chain->tr);
+      AlcFree(chain->lat);
+      AlcFree(chain);
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Appends the given transform to the given transform chain,
+* 		so that it is applied after all transforms already in the
+* 		chain. The transform is assigned to the chain and must
+* 		not be modified while the chain is in use. The transform
+* 		may be any affine, 2D or 3D multiquadric basis function,
+* 		2D mesh, conforming mesh (either a transform with type
+* 		WLZ_TRANSFORM_2D_CMESH or WLZ_TRANSFORM_3D_CMESH or a
+* 		WLZ_CMESH_TRANS object), displacement field or transform
+* 		chain transform with the same dimension as the chain.
+* 		A transform chain which is, or which contains at any
+* 		depth, the given chain is rejected since it would make
+* 		the chain cyclic.
+* \param	chain			Given transform chain.
+* \param	tr			Transform to append.
+*/
+WlzErrorNum	WlzTransformChainAppend(WlzTransformChain *chain,
+					WlzTransform tr)
+{
+  WlzTransformType type = WLZ_TRANSFORM_EMPTY;
+  WlzCMeshLattice *lat = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((chain == NULL) || (tr.core == NULL))
+  {
+    errNum = WLZ_ERR_TRANSFORM_NULL;
+  }
+  else if((chain->type != WLZ_TRANSFORM_2D_CHAIN) &&
+          (chain->type != WLZ_TRANSFORM_3D_CHAIN))
+  {
+    errNum = WLZ_ERR_TRANSFORM_TYPE;
+  }
+  else
+  {
+    type = WlzTransformChainTrType(tr);
+    if(WlzTransformChainTrDim(type) != WlzTransformChainTrDim(chain->type))
+    {
+      errNum = WLZ_ERR_TRANSFORM_TYPE;
+    }
+    else if(((type == WLZ_TRANSFORM_2D_CHAIN) ||
+             (type == WLZ_TRANSFORM_3D_CHAIN)) &&
+	    WlzTransformChainContains(tr.chain, chain))
+    {
+      errNum = WLZ_ERR_PARAM_DATA;
+    }
+    else if((type == WLZ_TRANSFORM_3D_BASISFN) &&
+            ((tr.basis->basisFn == NULL) ||
+	     ((tr.basis->basisFn->type != WLZ_FN_BASIS_3DMQ) &&
+	      (tr.basis->basisFn->type != WLZ_FN_BASIS_3DIMQ))))
+    {
+      errNum = WLZ_ERR_TRANSFORM_TYPE;
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (chain->nTr >= chain->maxTr))
+  {
+    int		maxTr;
+    WlzTransform *newTr;
+    WlzCMeshLattice **newLat;
+
+    maxTr = chain->maxTr + WLZ_TRANSFORMCHAIN_INC;
+    if((newTr = (WlzTransform *)
+                AlcRealloc(chain->tr, sizeof(WlzTransform) * maxTr)) != NULL)
+    {
+      chain->tr = newTr;
+    }
+    if((newLat = (WlzCMeshLattice **)
+                 AlcRealloc(chain->lat,
+		            sizeof(WlzCMeshLattice *) * maxTr)) != NULL)
+    {
+      chain->lat = newLat;
+    }
+    if((newTr == NULL) || (newLat == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      chain->maxTr = maxTr;
+    }
+  }
+  /* Conforming mesh transforms are evaluated using a lattice which is
+   * built once, here, rather than each time the chain is applied. */
+  if((errNum == WLZ_ERR_NONE) &&
+     ((type == WLZ_TRANSFORM_2D_CMESH) || (type == WLZ_TRANSFORM_3D_CMESH)))
+  {
+    lat = WlzCMeshLatticeNew(tr.obj, 0.0, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    chain->tr[chain->nTr] = WlzAssignTransform(tr, NULL);
+    chain->lat[chain->nTr] = lat;
+    ++(chain->nTr);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Transforms the vertices of the given array in place using
+* 		each transform of the given chain in turn. The array is
+* 		of 3D vertices for both 2D and 3D chains, with the z
+* 		component being ignored by 2D chains. Each transform is
+* 		applied to the whole array (in parallel where the
+* 		transform allows) before the next.
+* \param	chain			Given transform chain.
+* \param	nVtx			Number of vertices in the array.
+* \param	vtx			Array of vertices.
+*/
+WlzErrorNum	WlzTransformChainVtxAry(WlzTransformChain *chain,
+					int nVtx, WlzDVertex3 *vtx)
+{
+  WlzDVertex2	*vtx2 = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(chain == NULL)
+  {
+    errNum = WLZ_ERR_TRANSFORM_NULL;
+  }
+  else if((chain->type != WLZ_TRANSFORM_2D_CHAIN) &&
+          (chain->type != WLZ_TRANSFORM_3D_CHAIN))
+  {
+    errNum = WLZ_ERR_TRANSFORM_TYPE;
+  }
+  else if((nVtx < 0) || ((nVtx > 0) && (vtx == NULL)))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else if((nVtx > 0) && (chain->nTr > 0))
+  {
+    int		idT;
+
+    if((chain->type == WLZ_TRANSFORM_2D_CHAIN) &&
+       ((vtx2 = (WlzDVertex2 *)
+                AlcMalloc(sizeof(WlzDVertex2) * nVtx)) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    for(idT = 0; (errNum == WLZ_ERR_NONE) && (idT < chain->nTr); ++idT)
+    {
+      errNum = WlzTransformChainTrVtx(chain->tr[idT], chain->lat[idT],
+      				      nVtx, vtx, vtx2);
+    }
+  }
+  AlcFree(vtx2);
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Transforms the vertices of the given array in place using
+* 		each transform of the given 2D chain in turn.
+* \param	chain			Given 2D transform chain.
+* \param	nVtx			Number of vertices in the array.
+* \param	vtx			Array of vertices.
+*/
+WlzErrorNum	WlzTransformChainVtxAry2D(WlzTransformChain *chain,
+					  int nVtx, WlzDVertex2 *vtx)
+{
+  WlzDVertex3	*vtx3 = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(chain == NULL)
+  {
+    errNum = WLZ_ERR_TRANSFORM_NULL;
+  }
+  else if(chain->type != WLZ_TRANSFORM_2D_CHAIN)
+  {
+    errNum = WLZ_ERR_TRANSFORM_TYPE;
+  }
+  else if((nVtx < 0) || ((nVtx > 0) && (vtx == NULL)))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else if((nVtx > 0) && (chain->nTr > 0))
+  {
+    if((vtx3 = (WlzDVertex3 *)AlcMalloc(sizeof(WlzDVertex3) * nVtx)) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      int	idN;
+
+      for(idN = 0; idN < nVtx; ++idN)
+      {
+        vtx3[idN].vtX = vtx[idN].vtX;
+        vtx3[idN].vtY = vtx[idN].vtY;
+        vtx3[idN].vtZ = 0.0;
+      }
+      errNum = WlzTransformChainVtxAry(chain, nVtx, vtx3);
+      if(errNum == WLZ_ERR_NONE)
+      {
+	for(idN = 0; idN < nVtx; ++idN)
+	{
+	  vtx[idN].vtX = vtx3[idN].vtX;
+	  vtx[idN].vtY = vtx3[idN].vtY;
+	}
+      }
+    }
+  }
+  AlcFree(vtx3);
+  return(errNum);
+}
+
+/*!
+* \return	Transformed object or NULL on error.
+* \ingroup	WlzTransform
+* \brief	Transforms the given object using the given transform
+* 		chain. Rather than applying each transform in turn, with
+* 		an intermediate object being created and resampled by
+* 		each, the transforms of the chain are composed at every
+* 		position of the given object's bounding box and the
+* 		composite is then used to transform the object in a
+* 		single (parallel) resampling pass, so that grey values
+* 		are only interpolated once. The composite is held as a
+* 		displacement field, see WlzDispFieldFromTransform() and
+* 		WlzDispFieldTransformObj(). Points objects are
+* 		transformed exactly.
+* \param	srcObj			Given object, which may be an empty,
+* 					points, 2D domain (for a 2D chain)
+* 					or 3D domain (for a 3D chain)
+* 					object.
+* \param	chain			Given transform chain.
+* \param	interp			Interpolation method, which must
+* 					be either WLZ_INTERPOLATION_NEAREST or
+* 					WLZ_INTERPOLATION_LINEAR.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzObject	*WlzTransformChainObj(WlzObject *srcObj,
+				WlzTransformChain *chain,
+				WlzInterpolationType interp,
+				WlzErrorNum *dstErr)
+{
+  WlzObject	*dstObj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(srcObj == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if(chain == NULL)
+  {
+    errNum = WLZ_ERR_TRANSFORM_NULL;
+  }
+  else if((chain->type != WLZ_TRANSFORM_2D_CHAIN) &&
+          (chain->type != WLZ_TRANSFORM_3D_CHAIN))
+  {
+    errNum = WLZ_ERR_TRANSFORM_TYPE;
+  }
+  else
+  {
+    switch(srcObj->type)
+    {
+      case WLZ_EMPTY_OBJ:
+        dstObj = WlzMakeEmpty(&errNum);
+	break;
+      case WLZ_2D_DOMAINOBJ: /* FALLTHROUGH */
+      case WLZ_3D_DOMAINOBJ:
+        if(srcObj->domain.core == NULL)
+	{
+	  errNum = WLZ_ERR_DOMAIN_NULL;
+	}
+	else if(((srcObj->type == WLZ_2D_DOMAINOBJ) &&
+	         (chain->type != WLZ_TRANSFORM_2D_CHAIN)) ||
+	        ((srcObj->type == WLZ_3D_DOMAINOBJ) &&
+	         (chain->type != WLZ_TRANSFORM_3D_CHAIN)))
+	{
+	  errNum = WLZ_ERR_TRANSFORM_TYPE;
+	}
+	else
+	{
+	  WlzTransform tr;
+	  WlzDispFieldTransform *dft;
+
+	  tr.chain = chain;
+	  dft = WlzDispFieldFromTransform(tr, srcObj, 0, &errNum);
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    dstObj = WlzDispFieldTransformObj(srcObj, dft, interp, &errNum);
+	  }
+	  (void )WlzFreeDispFieldTransform(dft);
+	}
+	break;
+      case WLZ_POINTS:
+        if(srcObj->domain.core == NULL)
+	{
+	  errNum = WLZ_ERR_DOMAIN_NULL;
+	}
+	else
+	{
+	  dstObj = WlzTransformChainPoints(srcObj, chain, &errNum);
+	}
+	break;
+      default:
+        errNum = WLZ_ERR_OBJECT_TYPE;
+	break;
+    }
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(dstObj);
+}
+
+/*!
+* \return	Dimension of the transform type, zero if not supported
+* 		by transform chains.
+* \ingroup	WlzTransform
+* \brief	Gives the dimension of transforms of the given type.
+* \param	type			Given transform type.
+*/
+static int	WlzTransformChainTrDim(WlzTransformType type)
+{
+  int		dim = 0;
+
+  switch(type)
+  {
+    case WLZ_TRANSFORM_2D_AFFINE:  /* FALLTHROUGH */
+    case WLZ_TRANSFORM_2D_REG:     /* FALLTHROUGH */
+    case WLZ_TRANSFORM_2D_TRANS:   /* FALLTHROUGH */
+    case WLZ_TRANSFORM_2D_NOSHEAR: /* FALLTHROUGH */
+    case WLZ_TRANSFORM_2D_BASISFN: /* FALLTHROUGH */
+    case WLZ_TRANSFORM_2D_MESH:    /* FALLTHROUGH */
+    case WLZ_TRANSFORM_2D_CMESH:   /* FALLTHROUGH */
+    case WLZ_TRANSFORM_2D_DISP:    /* FALLTHROUGH */
+    case WLZ_TRANSFORM_2D_CHAIN:
+      dim = 2;
+      break;
+    case WLZ_TRANSFORM_3D_AFFINE:  /* FALLTHROUGH */
+    case WLZ_TRANSFORM_3D_REG:     /* FALLTHROUGH */
+    case WLZ_TRANSFORM_3D_TRANS:   /* FALLTHROUGH */
+    case WLZ_TRANSFORM_3D_NOSHEAR: /* FALLTHROUGH */
+    case WLZ_TRANSFORM_3D_BASISFN: /* FALLTHROUGH */
+    case WLZ_TRANSFORM_3D_CMESH:   /* FALLTHROUGH */
+    case WLZ_TRANSFORM_3D_DISP:    /* FALLTHROUGH */
+    case WLZ_TRANSFORM_3D_CHAIN:
+      dim = 3;
+      break;
+    default:
+      break;
+  }
+  return(dim);
+}
+
+/*!
+* \return	Non-zero if the chain contains the target.
+* \ingroup	WlzTransform
+* \brief	Checks whether the given chain either is the target chain
+* 		or contains it, directly or within any of the chains
+* 		nested in it.
+* \param	chain			Given transform chain.
+* \param	target			Target transform chain.
+*/
+static int	WlzTransformChainContains(WlzTransformChain *chain,
+					  WlzTransformChain *target)
+{
+  int		idT,
+  		found;
+
+  found = (chain == target);
+  for(idT = 0; (found == 0) && (idT < chain->nTr); ++idT)
+  {
+    WlzTransformType type;
+
+    type = WlzTransformChainTrType(chain->tr[idT]);
+    if((type == WLZ_TRANSFORM_2D_CHAIN) || (type == WLZ_TRANSFORM_3D_CHAIN))
+    {
+      found = WlzTransformChainContains(chain->tr[idT].chain, target);
+    }
+  }
+  return(found);
+}
+
+/*!
+* \return	Transform type.
+* \ingroup	WlzTransform
+* \brief	Gives the type of the given transform, with conforming
+* 		mesh transform objects (type WLZ_CMESH_TRANS) being given
+* 		the type of their mesh.
+* \param	tr			Given transform.
+*/
+static WlzTransformType WlzTransformChainTrType(WlzTransform tr)
+{
+  WlzTransformType type;
+
+  type = tr.core->type;
+  if((WlzObjectType )type == WLZ_CMESH_TRANS)
+  {
+    type = WLZ_TRANSFORM_EMPTY;
+    if(tr.obj->domain.core != NULL)
+    {
+      switch(tr.obj->domain.core->type)
+      {
+        case WLZ_CMESH_2D:
+	  type = WLZ_TRANSFORM_2D_CMESH;
+	  break;
+        case WLZ_CMESH_3D:
+	  type = WLZ_TRANSFORM_3D_CMESH;
+	  break;
+	default:
+	  break;
+      }
+    }
+  }
+  return(type);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Frees a transform of a chain, including conforming mesh
+* 		transform objects which WlzFreeTransform() does not
+* 		recognise.
+* \param	tr			Given transform.
+*/
+static WlzErrorNum WlzTransformChainTrFree(WlzTransform tr)
+{
+  WlzErrorNum	errNum;
+
+  if((WlzObjectType )(tr.core->type) == WLZ_CMESH_TRANS)
+  {
+    errNum = WlzFreeObj(tr.obj);
+  }
+  else
+  {
+    errNum = WlzFreeTransform(tr);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzTransform
+* \brief	Transforms the given array of vertices in place using a
+* 		single transform. For 2D transforms only the x and y
+* 		components of the vertices are used.
+* \param	tr			Given transform.
+* \param	lat			Lattice for conforming mesh
+* 					transforms, may be NULL.
+* \param	n			Number of vertices.
+* \param	vtx			Array of vertices.
+* \param	vtx2			Workspace with room for n 2D vertices,
+* 					which is only used (and so need only
+* 					be non-NULL) for 2D transforms.
+*/
+static WlzErrorNum WlzTransformChainTrVtx(WlzTransform tr,
+				WlzCMeshLattice *lat, int n,
+				WlzDVertex3 *vtx, WlzDVertex2 *vtx2)
+{
+  int		idN;
+  WlzTransformType type;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  type = WlzTransformChainTrType(tr);
+  switch(type)
+  {
+    case WLZ_TRANSFORM_2D_CMESH: /* FALLTHROUGH */
+    case WLZ_TRANSFORM_2D_DISP:
+      for(idN = 0; idN < n; ++idN)
+      {
+	vtx2[idN].vtX = vtx[idN].vtX;
+	vtx2[idN].vtY = vtx[idN].vtY;
+      }
+      if(type == WLZ_TRANSFORM_2D_CMESH)
+      {
+	errNum = WlzCMeshTransformVtxAryLat2D(tr.obj, lat, n, vtx2);
+      }
+      else
+      {
+	errNum = WlzDispFieldTransformVtxAry2D(tr.disp, n, vtx2);
+      }
+      for(idN = 0; idN < n; ++idN)
+      {
+	vtx[idN].vtX = vtx2[idN].vtX;
+	vtx[idN].vtY = vtx2[idN].vtY;
+      }
+      break;
+    case WLZ_TRANSFORM_3D_CMESH:
+      errNum = WlzCMeshTransformVtxAryLat3D(tr.obj, lat, n, vtx);
+      break;
+    case WLZ_TRANSFORM_3D_DISP:
+      errNum = WlzDispFieldTransformVtxAry3D(tr.disp, n, vtx);
+      break;
+    case WLZ_TRANSFORM_2D_CHAIN: /* FALLTHROUGH */
+    case WLZ_TRANSFORM_3D_CHAIN:
+      errNum = WlzTransformChainVtxAry(tr.chain, n, vtx);
+      break;
+    case WLZ_TRANSFORM_3D_BASISFN:
+      if((tr.basis->basisFn == NULL) ||
+         ((tr.basis->basisFn->type != WLZ_FN_BASIS_3DMQ) &&
+          (tr.basis->basisFn->type != WLZ_FN_BASIS_3DIMQ)))
+      {
+        errNum = WLZ_ERR_TRANSFORM_TYPE;
+	break;
+      }
+      /* FALLTHROUGH */
+    default:
+#ifdef _OPENMP
+#pragma omp parallel for if(n >= 1024)
+#endif
+      for(idN = 0; idN < n; ++idN)
+      {
+	WlzDVertex2 p2;
+	WlzDVertex3 d3;
+	WlzErrorNum errNum2 = WLZ_ERR_NONE;
+
+	switch(type)
+	{
+	  case WLZ_TRANSFORM_2D_AFFINE:  /* FALLTHROUGH */
+	  case WLZ_TRANSFORM_2D_REG:     /* FALLTHROUGH */
+	  case WLZ_TRANSFORM_2D_TRANS:   /* FALLTHROUGH */
+	  case WLZ_TRANSFORM_2D_NOSHEAR:
+	    p2.vtX = vtx[idN].vtX;
+	    p2.vtY = vtx[idN].vtY;
+	    p2 = WlzAffineTransformVertexD2(tr.affine, p2, &errNum2);
+	    vtx[idN].vtX = p2.vtX;
+	    vtx[idN].vtY = p2.vtY;
+	    break;
+	  case WLZ_TRANSFORM_3D_AFFINE:  /* FALLTHROUGH */
+	  case WLZ_TRANSFORM_3D_REG:     /* FALLTHROUGH */
+	  case WLZ_TRANSFORM_3D_TRANS:   /* FALLTHROUGH */
+	  case WLZ_TRANSFORM_3D_NOSHEAR:
+	    vtx[idN] = WlzAffineTransformVertexD3(tr.affine, vtx[idN],
+						  &errNum2);
+	    break;
+	  case WLZ_TRANSFORM_2D_BASISFN:
+	    p2.vtX = vtx[idN].vtX;
+	    p2.vtY = vtx[idN].vtY;
+	    p2 = WlzBasisFnTransformVertexD(tr.basis, p2, &errNum2);
+	    vtx[idN].vtX = p2.vtX;
+	    vtx[idN].vtY = p2.vtY;
+	    break;
+	  case WLZ_TRANSFORM_3D_BASISFN:
+	    d3 = (tr.basis->basisFn->type == WLZ_FN_BASIS_3DMQ)?
+		 WlzBasisFnValueMQ3D(tr.basis->basisFn, vtx[idN]):
+		 WlzBasisFnValueIMQ3D(tr.basis->basisFn, vtx[idN]);
+	    WLZ_VTX_3_ADD(vtx[idN], vtx[idN], d3);
+	    break;
+	  case WLZ_TRANSFORM_2D_MESH:
+	    /* Positions outside of the mesh are not displaced. */
+	    p2.vtX = vtx[idN].vtX;
+	    p2.vtY = vtx[idN].vtY;
+	    p2 = WlzMeshTransformVtx(p2, tr.mesh, &errNum2);
+	    if(errNum2 == WLZ_ERR_NONE)
+	    {
+	      vtx[idN].vtX = p2.vtX;
+	      vtx[idN].vtY = p2.vtY;
+	    }
+	    errNum2 = WLZ_ERR_NONE;
+	    break;
+	  default:
+	    errNum2 = WLZ_ERR_TRANSFORM_TYPE;
+	    break;
+	}
+	if(errNum2 != WLZ_ERR_NONE)
+	{
+#ifdef _OPENMP
+#pragma omp critical (WlzTransformChainTrVtx)
+#endif
+	  {
+	    errNum = errNum2;
+	  }
+	}
+      }
+      break;
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Transformed points object or NULL on error.
+* \ingroup	WlzTransform
+* \brief	Transforms the points of a points object using the given
+* 		transform chain. The transformed points have double
+* 		precision and no values.
+* \param	srcObj			Given points object.
+* \param	chain			Given transform chain.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzObject *WlzTransformChainPoints(WlzObject *srcObj,
+				WlzTransformChain *chain,
+				WlzErrorNum *dstErr)
+{
+  int		idN,
+  		nPts;
+  WlzPoints	*sPts;
+  WlzDomain	dom;
+  WlzValues	val;
+  WlzVertexP	nullP;
+  WlzObject	*dstObj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  dom.core = NULL;
+  val.core = NULL;
+  nullP.v = NULL;
+  sPts = srcObj->domain.pts;
+  nPts = sPts->nPoints;
+  switch(sPts->type)
+  {
+    case WLZ_POINTS_2I: /* FALLTHROUGH */
+    case WLZ_POINTS_2D:
+      if(chain->type != WLZ_TRANSFORM_2D_CHAIN)
+      {
+        errNum = WLZ_ERR_TRANSFORM_TYPE;
+      }
+      else if((dom.pts = WlzMakePoints(WLZ_POINTS_2D, 0, nullP, nPts,
+                                       &errNum)) != NULL)
+      {
+	WlzDVertex2 *v;
+
+	v = dom.pts->points.d2;
+	for(idN = 0; idN < nPts; ++idN)
+	{
+	  if(sPts->type == WLZ_POINTS_2I)
+	  {
+	    v[idN].vtX = sPts->points.i2[idN].vtX;
+	    v[idN].vtY = sPts->points.i2[idN].vtY;
+	  }
+	  else
+	  {
+	    v[idN] = sPts->points.d2[idN];
+	  }
+	}
+	dom.pts->nPoints = nPts;
+	errNum = WlzTransformChainVtxAry2D(chain, nPts, v);
+      }
+      break;
+    case WLZ_POINTS_3I: /* FALLTHROUGH */
+    case WLZ_POINTS_3D:
+      if(chain->type != WLZ_TRANSFORM_3D_CHAIN)
+      {
+        errNum = WLZ_ERR_TRANSFORM_TYPE;
+      }
+      else if((dom.pts = WlzMakePoints(WLZ_POINTS_3D, 0, nullP, nPts,
+                                       &errNum)) != NULL)
+      {
+	WlzDVertex3 *v;
+
+	v = dom.pts->points.d3;
+	for(idN = 0; idN < nPts; ++idN)
+	{
+	  if(sPts->type == WLZ_POINTS_3I)
+	  {
+	    v[idN].vtX = sPts->points.i3[idN].vtX;
+	    v[idN].vtY = sPts->points.i3[idN].vtY;
+	    v[idN].vtZ = sPts->points.i3[idN].vtZ;
+	  }
+	  else
+	  {
+	    v[idN] = sPts->points.d3[idN];
+	  }
+	}
+	dom.pts->nPoints = nPts;
+	errNum = WlzTransformChainVtxAry(chain, nPts, v);
+      }
+      break;
+    default:
+      errNum = WLZ_ERR_DOMAIN_TYPE;
+      break;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    dstObj = WlzMakeMain(WLZ_POINTS, dom, val, NULL, NULL, &errNum);
+  }
+  if(dstObj == NULL)
+  {
+    (void )WlzFreeDomain(dom);
+  }
+  *dstErr = errNum;
+  return(dstObj);
+}
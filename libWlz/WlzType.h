@@ -179,6 +179,10 @@ typedef enum _WlzObjectType
   					     occupies no space. */
   WLZ_EMPTY_VALUES,			/*!< Empty values: A values which
   					     has no values! */
+  WLZ_DISP_TRANS		= 132,	/*!< Displacement field transform,
+  					     either 2D or 3D. This value
+					     is written to files so must
+					     not change. */
   /**********************************************************************
   * Plane domain types.
   **********************************************************************/
@@ -499,8 +503,16 @@ typedef enum _WlzTransformType
   				              transform. */
   WLZ_TRANSFORM_2D5_CMESH = WLZ_CMESH_2D5, /*!< 3D conforming triangular mesh
   				                transform. */
-  WLZ_TRANSFORM_3D_CMESH = WLZ_CMESH_3D	/*!< 3D conforming tetrahedral mesh
+  WLZ_TRANSFORM_3D_CMESH = WLZ_CMESH_3D,	/*!< 3D conforming tetrahedral mesh
   					     transform. */
+  WLZ_TRANSFORM_2D_DISP = WLZ_TRANSFORM_2D5_CMESH + 1, /*!< 2D sampled
+  					     displacement field transform. */
+  WLZ_TRANSFORM_3D_DISP,		/*!< 3D sampled displacement field
+  					     transform. */
+  WLZ_TRANSFORM_2D_CHAIN,		/*!< Chain of 2D transforms applied
+  					     in order. */
+  WLZ_TRANSFORM_3D_CHAIN		/*!< Chain of 3D transforms applied
+  					     in order. */
 } WlzTransformType;
 
 /*!
@@ -1022,6 +1034,53 @@ typedef enum _WlzSampleFn
   WLZ_SAMPLEFN_MEDIAN			/*!< Median value sampling */
 } WlzSampleFn;
 
+/*!
+* \enum		_WlzIOCompression
+* \ingroup	WlzIO
+* \brief	Compression of grey values in the Woolz file format.
+* 		Typedef: ::WlzIOCompression.
+*/
+typedef enum _WlzIOCompression
+{
+  WLZ_IOCMP_NONE	= 0,		/*!< Values are not compressed. */
+  WLZ_IOCMP_RLE		= 1		/*!< Values are delta filtered, byte
+  					     shuffled and run length encoded
+					     in independent blocks. */
+} WlzIOCompression;
+
+/*!
+* \def		WLZ_IOCMP_MARKER
+* \ingroup	WlzIO
+* \brief	Value table type byte written in place of the grey type
+* 		to mark a compressed value table in the Woolz file format.
+*/
+#define WLZ_IOCMP_MARKER	(0xff)
+
+/*!
+* \struct	_WlzValueCmpStream
+* \ingroup	WlzIO
+* \brief	A stream which compresses raw bytes in blocks as they
+* 		are given and writes the compressed blocks to a file or
+* 		memory buffer (see WlzValueCmpStreamOpen()).
+* 		Typedef: ::WlzValueCmpStream.
+*/
+typedef struct _WlzValueCmpStream
+{
+  WlzIOCompression cmp;			/*!< Compression method. */
+  int		eSz;			/*!< Element size for the filter. */
+  int		delta;			/*!< Non-zero for a delta filter. */
+  size_t	blkSz;			/*!< Raw bytes per block. */
+  FILE		*fP;			/*!< File written to or NULL if
+  					     writing to memory. */
+  WlzUByte	*mem;			/*!< Memory buffer written to. */
+  size_t	memSz;			/*!< Bytes in the memory buffer. */
+  size_t	memMax;			/*!< Size of the memory buffer. */
+  WlzUByte	*raw;			/*!< Partial block of raw bytes. */
+  size_t	rawSz;			/*!< Bytes in the partial block. */
+  WlzUByte	*wSp;			/*!< Workspace for compression. */
+  size_t	wSpSz;			/*!< Size of the workspace. */
+} WlzValueCmpStream;
+
 /*!
 * \enum		_WlzScalarFeatureType
 * \ingroup	WlzFeatures
@@ -2400,6 +2459,7 @@ typedef union _WlzDomain
   struct _WlzConvHullDomain2 *cvh2;
   struct _WlzConvHullDomain3 *cvh3;
   struct _WlzThreeDViewStruct *vs3d;
+  struct _WlzDispFieldTransform *df;
 } WlzDomain;
 
 /*!
@@ -3024,6 +3084,10 @@ typedef struct _WlzIndexedValues
   WlzValueAttach attach;                /*!< Specifies what the values are
                                              attached to. */
   AlcVector     *values;                /*!< The indexed values. */
+  struct _WlzCMeshLatticeCache *latCache; /*!< Lattice cached when the
+  					     values are the displacements
+					     of a conforming mesh transform,
+					     may be NULL. */
 } WlzIndexedValues;
 
 /*!
@@ -3113,6 +3177,16 @@ typedef struct _WlzTiledValues
   					     file to the tiles. This may be
 					     set even if not memory mapped. */
   WlzGreyP 	tiles;			/*!< The tiles. */
+  WlzUByte	*cmpTiles;		/*!< If non-NULL, the tiles as read
+  					     compressed with one tile per
+					     block (see WlzValueCmpRead())
+					     from which tiles are decoded
+					     on demand by
+					     WlzTiledValuesDecodeTile(). */
+  size_t	cmpTilesSz;		/*!< Size of the compressed tiles. */
+  WlzUByte	*tileDecoded;		/*!< If the compressed tiles are
+  					     non-NULL, non-zero for each
+					     tile that has been decoded. */
 } WlzTiledValues;
 
 /*!
@@ -4199,6 +4273,87 @@ typedef union _WlzCMeshP
   WlzCMesh3D	*m3;
 } WlzCMeshP;
 
+/*!
+* \struct	_WlzCMeshLattice
+* \ingroup	WlzTransform
+* \brief	A lattice for fast point location and interpolation within
+*		a 2D or 3D conforming mesh transform which has elements
+*		aligned with the cells of a regular lattice, as for meshes
+*		made from balanced linear binary tree domains. Lattice
+*		cells have side lengths of \f$c 2^l\f$ for levels
+*		\f$l = 0, \ldots, n_l - 1\f$ and the cells are held in
+*		quad (2D) or oct (3D) trees, rooted in a regular array of
+*		top level cells. A cell is complete if it is exactly
+*		covered by the elements within it together with its
+*		complete sub cells. The elements of a complete cell which
+*		are not within a complete sub cell form a leaf list, so
+*		locating a point within a complete cell only needs index
+*		arithmetic and the testing of the leaf list elements.
+*		Points in incomplete cells must be located by a general
+*		mesh search.
+*		Typedef: ::WlzCMeshLattice.
+*/
+typedef struct _WlzCMeshLattice
+{
+  WlzObjectType	type;		/*!< Type of the mesh transform object,
+  				     WLZ_CMESH_2D or WLZ_CMESH_3D. */
+  int		nLvl;		/*!< Number of lattice levels, zero if
+  				     the lattice has no cells. */
+  double	cellSz;		/*!< Side length of the level zero cells. */
+  double	coverage;	/*!< Fraction of the mesh area (2D) or
+  				     volume (3D) within complete cells. */
+  WlzDVertex3	org;		/*!< Lattice origin. */
+  WlzIVertex3	tOff;		/*!< Index of the first top level cell. */
+  WlzIVertex3	tSz;		/*!< Number of top level cells. */
+  int		*top;		/*!< Tree node indices (or -1) of the top
+  				     level cells. */
+  int		nNod;		/*!< Number of tree nodes. */
+  int		*nod;		/*!< Tree nodes, each being a leaf list
+  				     offset (or -1) followed by 4 (2D) or
+				     8 (3D) child node indices (or -1)
+				     with bit 0 of the child index set
+				     for the upper column, bit 1 for the
+				     upper line and bit 2 for the upper
+				     plane. */
+  int		*leaf;		/*!< Leaf lists, each being an element
+  				     count followed by indices into the
+				     element tables. */
+  int		nElm;		/*!< Number of elements in the element
+  				     tables. */
+  int		*elmIdx;	/*!< Mesh element indices. */
+  double	*elmBC;		/*!< Barycentric coordinate coefficients,
+  				     6 (2D) or 12 (3D) per element. */
+  double	*elmTr;		/*!< Affine transform coefficients, 6 (2D)
+  				     or 12 (3D) per element. */
+} WlzCMeshLattice;
+
+/*!
+* \struct	_WlzCMeshLatticeCache
+* \ingroup	WlzTransform
+* \brief	A lattice cached with the displacements of a conforming
+*		mesh transform. The cache keeps a copy of the mesh node
+*		positions and displacements from which the lattice was
+*		built, so that the lattice can be found to be stale when
+*		either of these is changed.
+*		Typedef: ::WlzCMeshLatticeCache.
+*/
+typedef struct _WlzCMeshLatticeCache
+{
+  void		*mesh;		/*!< Mesh of the key. */
+  int		nNod;		/*!< Number of node entries in the key,
+  				     the maximum number of mesh nodes. */
+  int		nElm;		/*!< Number of mesh elements. */
+  int		maxElm;		/*!< Maximum number of mesh elements. */
+  int		maxKey;		/*!< Number of doubles allocated for the
+  				     key. */
+  double	*key;		/*!< For each node entry the node index
+  				     followed by the node position and
+				     displacement. */
+  int		nVtx;		/*!< Number of vertices transformed since
+  				     the key was set. */
+  WlzCMeshLattice *lat;		/*!< Cached lattice, NULL until built. */
+} WlzCMeshLatticeCache;
+
 /************************************************************************
 * Functions
 ************************************************************************/
@@ -4379,6 +4534,10 @@ typedef union _WlzTransform
   struct _WlzAffineTransform *affine;	/*!< Affine transforms, 2D or 3D. */
   struct _WlzBasisFnTransform *basis;	/*!< Any basis function transform. */
   struct _WlzMeshTransform *mesh;	/*!< Any convex mesh transform. */
+  struct _WlzDispFieldTransform *disp;	/*!< Sampled displacement field
+  					     transform, 2D or 3D. */
+  struct _WlzTransformChain *chain;	/*!< Chain of transforms, 2D or
+  					     3D. */
   struct _WlzObject *obj;               /*!< Some transforms are objects
   					     with a domain and values (eg
 					     conforming mesh transforms). */
@@ -4471,6 +4630,63 @@ typedef struct _WlzBasisFnTransform
   					     transform. */
 } WlzBasisFnTransform;
 
+/*!
+* \struct	_WlzBasisFnTPS2DEdit
+* \ingroup	WlzTransform
+* \brief	An editable 2D thin plate spline transform which supports
+*		the interactive addition, movement and removal of control
+*		points. The inverse of the design matrix is kept and is
+*		updated using low rank updates when control points are
+*		edited, with a full solution only being computed when the
+*		updated solution fails to interpolate the control points.
+*		A mesh transform's node displacements may also be cached
+*		and only updated where they may have changed by more
+*		than a given tolerance.
+*		Typedef: ::WlzBasisFnTPS2DEdit.
+*/
+typedef struct _WlzBasisFnTPS2DEdit
+{
+  int		nVtx;			/*!< Number of control points. */
+  int		maxVtx;			/*!< Number of control points space
+  					     has been allocated for. */
+  int		nUpd;			/*!< Number of low rank updates since
+  					     the last full solution. */
+  double	range;			/*!< Range used to normalise the
+  					     control point coordinates. */
+  WlzDVertex2	org;			/*!< Origin used to normalise the
+  					     control point coordinates. */
+  WlzDVertex2	*dVx;			/*!< Destination control points. */
+  WlzDVertex2	*sVx;			/*!< Source control points. */
+  WlzDVertex2	*nVx;			/*!< Normalised destination control
+  					     points. */
+  double	**aI;			/*!< Inverse of the design matrix,
+  					     allocated as a square
+					     AlcDouble2Malloc() array with
+					     side maxVtx + 3. */
+  double	*buf;			/*!< Workspace of 6 (maxVtx + 3)
+  					     doubles. */
+  WlzBasisFnTransform *basisTr;		/*!< The current transform. */
+  struct _WlzMeshTransform *mesh;	/*!< Mesh transform with cached node
+  					     displacements, not owned by the
+					     editable transform, may be
+					     NULL. */
+  WlzBasisFn	*mshFn;			/*!< Basis function used when the
+  					     mesh transform node displacements
+					     were last updated. */
+  double	mshBlkSz;		/*!< Side length of the blocks used
+  					     to group the mesh nodes. */
+  WlzDVertex2	mshBlkOrg;		/*!< Origin of the mesh node blocks. */
+  WlzIVertex2	mshBlkCnt;		/*!< Number of mesh node blocks. */
+  int		*mshBlkOff;		/*!< Offsets of the first node of each
+  					     block in mshBlkNod. */
+  int		*mshBlkNod;		/*!< Mesh node indices ordered by
+  					     block. */
+  double	*mshBlkErr;		/*!< Bound on the difference between
+  					     the cached and current node
+					     displacements within each
+					     block. */
+} WlzBasisFnTPS2DEdit;
+
 /*!
 * \struct	_WlzMeshNode
 * \ingroup	WlzTransform
@@ -4627,6 +4843,61 @@ typedef struct _WlzMeshTransform2D5
   WlzMeshNode2D5 	*nodes;		/*!< Mesh nodes */
 } WlzMeshTransform2D5;
 
+/*!
+* \struct	_WlzDispFieldTransform
+* \ingroup	WlzTransform
+* \brief	A displacement field transform in which the displacements
+*		of some other transform are sampled on a regular integer
+*		lattice. The displacements are held as a compound array
+*		object with one float valued rectangular (2D) or cuboid
+*		(3D) object per displacement component (x, y and for 3D
+*		z), all of which share the same lattice and which may
+*		have tiled values. A lattice position \f$\mathbf{p}\f$
+*		is transformed to \f$\mathbf{p} + \mathbf{D}(\mathbf{p})\f$
+*		with the displacements between lattice positions being
+*		interpolated and those outside the lattice being clamped
+*		to it's boundary.
+*		Typedef: ::WlzDispFieldTransform.
+*/
+typedef struct _WlzDispFieldTransform
+{
+  WlzTransformType type;       		/*!< From the core domain, either
+  					     WLZ_TRANSFORM_2D_DISP or
+					     WLZ_TRANSFORM_3D_DISP. */
+  int           linkcount;      	/*!< From the core domain. */
+  void 		*freeptr;		/*!< From the core domain. */
+  WlzCompoundArray *field;		/*!< Displacement components. */
+} WlzDispFieldTransform;
+
+/*!
+* \struct	_WlzTransformChain
+* \ingroup	WlzTransform
+* \brief	A chain of transforms which are applied in order, the
+*		first transform of the chain being applied first. The
+*		transforms of a chain are only composed when the chain
+*		is applied, so no intermediate objects are created.
+*		Conforming mesh transforms of the chain have a lattice
+*		which is built when the transform is appended to the
+*		chain.
+*		Typedef: ::WlzTransformChain.
+*/
+typedef struct _WlzTransformChain
+{
+  WlzTransformType type;       		/*!< From the core domain, either
+  					     WLZ_TRANSFORM_2D_CHAIN or
+					     WLZ_TRANSFORM_3D_CHAIN. */
+  int           linkcount;      	/*!< From the core domain. */
+  void 		*freeptr;		/*!< From the core domain. */
+  int		nTr;			/*!< Number of transforms in the
+  					     chain. */
+  int		maxTr;			/*!< Number of transforms for which
+  					     space has been allocated. */
+  WlzTransform	*tr;			/*!< Transforms of the chain. */
+  WlzCMeshLattice **lat;		/*!< Lattices of the conforming mesh
+  					     transforms of the chain, NULL
+					     for other transforms. */
+} WlzTransformChain;
+
 /************************************************************************
 * User weighting functions and callback data structures for ICP based
 * registration and matching.
@@ -4659,6 +4930,39 @@ typedef struct _WlzMatchICPWeightCbData
   double 	maxDisp;
 } WlzMatchICPWeightCbData;
 
+/*!
+* \struct	_WlzMatchICPTarget
+* \ingroup	WlzTransform
+* \brief	A target for ICP based matching. This holds the target
+*		contour's model together with its vertices, normals and
+*		a kD-tree built from the vertices so that the target may
+*		be matched to many source contours without rebuilding
+*		the spatial index. The target is not modified by matching
+*		and may be shared by concurrent matches.
+*		Typedef: ::WlzMatchICPTarget.
+*/
+typedef struct _WlzMatchICPTarget
+{
+  WlzGMModel	*model;			/*!< Target model with small shells
+  					     removed. */
+  int		minSpx;			/*!< Minimum number of simplices
+  					     in the model's shells. */
+  int		sgnNrm;			/*!< Non zero if the signs of the
+  					     normal components are
+					     consistent. */
+  int		nVx;			/*!< Number of vertices. */
+  int		maxVI;			/*!< Maximum vertex index in the
+  					     model plus one. */
+  WlzVertexType	vType;			/*!< Type of vertices, either
+  					     WLZ_VERTEX_D2 or
+					     WLZ_VERTEX_D3. */
+  WlzVertexP	vx;			/*!< Vertices indexed by the
+  					     nodes of the kD-tree. */
+  WlzVertexP	nr;			/*!< Vertex normals. */
+  AlcKDTTree	*tree;			/*!< kD-tree populated by the
+  					     vertices. */
+} WlzMatchICPTarget;
+
 #endif /* WLZ_EXT_BIND */
 
 /************************************************************************
@@ -4840,6 +5144,64 @@ typedef struct _WlzIterateWSpace
 					     is WLZ_GREY_ERROR. */
 } WlzIterateWSpace;
 
+/*!
+* \struct	_WlzIterateChunk
+* \ingroup	WlzAccess
+* \brief	A chunk of a partitioned domain object, this is a
+* 		contiguous range of lines within a single plane.
+*		Typedef: ::WlzIterateChunk.
+*/
+typedef struct _WlzIterateChunk
+{
+  int		plane;			/*!< Plane of the chunk, zero for
+  					     2D objects. */
+  int		line1;			/*!< First line of the chunk. */
+  int		lastln;			/*!< Last line of the chunk. */
+  int		nItv;			/*!< Number of intervals in the
+  					     chunk. */
+} WlzIterateChunk;
+
+/*!
+* \struct	_WlzIteratePartition
+* \ingroup	WlzAccess
+* \brief	A partition of a 2 or 3D domain object into chunks which
+* 		may be scanned independently, eg by concurrent threads.
+* 		Chunks are balanced by interval count, never span planes
+* 		and, when the object has tiled values, only start on tile
+* 		boundaries.
+*		Typedef: ::WlzIteratePartition.
+*/
+typedef struct _WlzIteratePartition
+{
+  WlzObject	*obj;			/*!< The partitioned object, which
+  					     is not linked. */
+  int		nItv;			/*!< Total number of intervals. */
+  int		nChunk;			/*!< Number of chunks. */
+  WlzIterateChunk *chunk;		/*!< Array of chunks. */
+} WlzIteratePartition;
+
+/*!
+* \struct	_WlzIterateChunkWSpace
+* \ingroup	WlzAccess
+* \brief	A workspace for scanning the intervals of a single chunk
+* 		of a partitioned object. Each thread scanning a chunk
+* 		should have it's own chunk workspace.
+*		Typedef: ::WlzIterateChunkWSpace.
+*/
+typedef struct _WlzIterateChunkWSpace
+{
+  WlzObject	*obj2D;			/*!< 2D object covering just the
+  					     chunk. */
+  int		plane;			/*!< Plane of the chunk. */
+  int		grey;			/*!< Non-zero if initialised for
+  					     grey values. */
+  WlzIntervalWSpace iWSp;		/*!< Interval workspace for the
+  					     chunk. */
+  WlzGreyWSpace gWSp;			/*!< Grey workspace for the chunk,
+  					     only valid if grey is
+					     non-zero. */
+} WlzIterateChunkWSpace;
+
 /*!
 * \struct	_WlzGreyValueWSpace
 * \ingroup	WlzAccess
@@ -4898,6 +5260,148 @@ typedef enum _WlzIOFlags
   WLZ_IOFLAGS_WRITE	= (1<<1)	/*!< Write flag bit. */
 } WlzIOFlags;
 
+#ifndef WLZ_EXT_BIND
+/*!
+* \struct	_WlzPlaneStream
+* \ingroup	WlzIO
+* \brief	State for reading or writing the planes of a 3D domain
+* 		object one plane at a time, so that objects which are
+* 		too large to fit in memory may be processed.
+* 		In the Woolz file format all the plane domains precede
+* 		all the plane values, so a plane stream which is being
+* 		read keeps file offsets for both the next domain and the
+* 		next values, while a plane stream which is being written
+* 		spools the plane values (and, if its header can not be
+* 		written first, the plane domains) and records their
+* 		offsets in the spool file.
+* 		Typedef: ::WlzPlaneStream.
+*/
+typedef struct _WlzPlaneStream
+{
+  WlzIOFlags	flags;			/*!< Either WLZ_IOFLAGS_READ or
+  					     WLZ_IOFLAGS_WRITE. */
+  FILE		*fP;			/*!< File being read or written. */
+  FILE		*spool;			/*!< Spool file used when writing. */
+  int		ownSpool;		/*!< Non-zero if the spool file was
+  					     created by the stream. */
+  int		plane1;			/*!< First plane. */
+  int		lastpl;			/*!< Last plane, when writing this is
+  					     the last non-empty plane
+					     written. */
+  int		plane;			/*!< Next plane to be read or written. */
+  int		endpl;			/*!< Last plane to be written, less
+  					     than the first plane if this
+					     is not known. */
+  int		line1;			/*!< First line of the bounding box. */
+  int		lastln;			/*!< Last line of the bounding box. */
+  int		kol1;			/*!< First column of the bounding
+  					     box. */
+  int		lastkl;			/*!< Last column of the bounding box. */
+  float		voxelSz[3];		/*!< Voxel size. */
+  int		values;			/*!< Non-zero if the object has
+  					     values. */
+  int		bckgrnd;		/*!< Background value as written
+  					     to the voxel value table. */
+  WlzIOCompression cmp;			/*!< Compression method for the
+  					     values when writing. */
+  long		domOff;			/*!< Offset of the next plane domain
+  					     when reading. */
+  long		valOff;			/*!< Offset of the next plane values
+  					     when reading. */
+  long		hdrOff;			/*!< Offset of the bounding box in
+  					     the header of the output file
+					     when writing, or -1 if the
+					     header is only written when
+					     the stream is closed. */
+  int		maxOff;			/*!< Space allocated for offsets. */
+  long		*off;			/*!< Spool file offsets of the domain
+  					     and values of each plane written
+					     followed by the end offset. */
+  WlzPropertyList *plist;		/*!< Property list of the object, read
+  					     after the last plane or written
+					     when the stream is closed. */
+} WlzPlaneStream;
+
+/*!
+* \typedef	WlzPlaneStreamFn
+* \ingroup	WlzIO
+* \brief	Callback function which is applied to each plane of a
+* 		3D domain object by WlzPlaneStreamApply(). The function
+* 		is given a 2D domain object and the plane coordinate and
+* 		should return a new 2D domain object or an empty object.
+* 		Parameters passed are: object, plane, data, destination
+* 		error pointer.
+*/
+typedef WlzObject *(*WlzPlaneStreamFn)(WlzObject *, int, void *,
+				       WlzErrorNum *);
+#endif /* WLZ_EXT_BIND */
+
+/*!
+* \struct	_WlzDomainQueryIdx
+* \ingroup	WlzAccess
+* \brief	An index built from a 2 or 3D domain for fast repeated
+* 		point in domain queries. The intervals of each line
+* 		(of each plane) are held as sorted arrays of absolute
+* 		column coordinates so that they may be binary searched.
+* 		For dense domains a bitset covering the bounding box
+* 		may also be built, in which case queries are answered
+* 		using the bitset alone.
+* 		Typedef: ::WlzDomainQueryIdx.
+*/
+typedef struct _WlzDomainQueryIdx
+{
+  int		dim;			/*!< Dimension of the domain, either
+  					     2 or 3. */
+  WlzIBox3	bBox;			/*!< Bounding box of the domain, for
+  					     2D domains zMin = zMax = 0. */
+  int		nLn;			/*!< Number of lines in each plane of
+  					     the bounding box. */
+  size_t	*lnItv;			/*!< Index of the first interval of
+  					     each line of each plane, with a
+					     final entry which is the total
+					     number of intervals. */
+  int		*itv;			/*!< Interval end columns, as left,
+  					     right pairs, sorted by column
+					     within each line. */
+  size_t	bitLnSz;		/*!< Number of bytes in each line of
+  					     the bitset. */
+  WlzUByte	*bits;			/*!< Bitset with a bit set for each
+  					     pixel/voxel in the domain, may
+					     be NULL. */
+} WlzDomainQueryIdx;
+
+/*!
+* \struct	_WlzZonalStats
+* \ingroup	WlzFeatures
+* \brief	Grey value statistics for each of the zones (labels) of
+* 		an index object, as computed by WlzZonalGreyStats().
+* 		The arrays are indexed by zone (label) value and the
+* 		histograms are held one after another, so that bin
+* 		\f$j\f$ of zone \f$i\f$ is \f$hist[i \times nBin + j]\f$.
+* 		Typedef: ::WlzZonalStats.
+*/
+typedef struct _WlzZonalStats
+{
+  int		nZone;			/*!< Number of zones, ie one more than
+  					     the maximum zone value. */
+  int		nBin;			/*!< Number of histogram bins per zone,
+  					     zero if no histograms. */
+  double	binOrg;			/*!< Grey value at the start of the
+  					     first histogram bin. */
+  double	binWidth;		/*!< Width of the histogram bins. */
+  WlzLong	*count;			/*!< Number of pixels/voxels in each
+  					     zone. */
+  double	*sum;			/*!< Sum of grey values in each zone. */
+  double	*sumSq;			/*!< Sum of squared grey values in
+  					     each zone. */
+  double	*min;			/*!< Minimum grey value in each zone,
+  					     only valid for non-zero counts. */
+  double	*max;			/*!< Maximum grey value in each zone,
+  					     only valid for non-zero counts. */
+  WlzLong	*hist;			/*!< Histograms of the zones, NULL if
+  					     there are no histograms. */
+} WlzZonalStats;
+
 /************************************************************************
 * Transform callback functions
 ************************************************************************/
@@ -5239,6 +5743,23 @@ typedef enum	_WlzProjectIntMode
   					     dependant density. */
 } WlzProjectIntMode;
 
+/*!
+* \typedef	WlzProjectRayMode
+* \ingroup	WlzTransform
+* \brief	Ray casting 3D to 2D projection modes.
+*/
+typedef enum	_WlzProjectRayMode
+{
+  WLZ_PROJECT_RAY_MODE_MIP,		/*!< Maximum intensity along the
+  					     ray. */
+  WLZ_PROJECT_RAY_MODE_MEAN,		/*!< Path length weighted mean of the
+  					     values along the ray. */
+  WLZ_PROJECT_RAY_MODE_SUM,		/*!< Path length weighted sum of the
+  					     values along the ray. */
+  WLZ_PROJECT_RAY_MODE_ALPHA		/*!< Front to back alpha compositing
+  					     of the values along the ray. */
+} WlzProjectRayMode;
+
 /*!
 * \enum         _WlzKrigModelFnType
 * \ingroup      WlzType
@@ -0,0 +1,1483 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzValueCompress_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         libWlz/WlzValueCompress.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Block compression of grey values for the Woolz file
+* 		format.
+* \ingroup	WlzIO
+*
+* Grey values are compressed in independent blocks, so that blocks
+* may be encoded and decoded in parallel and any single block may be
+* decoded without decoding the others. Each block is filtered and then
+* run length encoded. The filter optionally replaces integer values by
+* the difference from the previous value (delta filter) and then
+* shuffles the bytes of multi-byte values so that all the first bytes
+* are followed by all the second bytes and so on. Blocks which do not
+* compress are stored unfiltered.
+*
+* Compressed values have two forms, with all words being four byte
+* unsigned integers in little endian byte order. The stream form is
+* written block by block, as the raw bytes are given, by
+* WlzValueCmpStreamPut() and so the sizes are not known until the
+* end of the stream:
+* \verbatim
+  byte    compression method (WlzIOCompression)
+  byte    element size for the filter (1, 2, 4 or 8)
+  byte    filter flags (WLZ_VALUECMP_FLG_DELTA)
+  byte    reserved (zero)
+  word    header size, the number of leading bytes which are stored
+          verbatim and not compressed
+  word    block size (raw bytes per block, except for the last block)
+  byte[]  header bytes
+  then for each block
+  word    raw size of the block
+  word    compressed size of the block
+  byte[]  compressed block
+  then
+  word    zero
+\endverbatim
+* The stream form is read by WlzValueCmpRead() which converts it to
+* the buffer form, this being the form created by WlzValueCmpEncode().
+* The buffer form ends with a table of block offsets, so that any
+* block may be found without reference to the others:
+* \verbatim
+  byte    compression method (WlzIOCompression)
+  byte    element size for the filter (1, 2, 4 or 8)
+  byte    filter flags (WLZ_VALUECMP_FLG_DELTA)
+  byte    reserved (zero)
+  word    header size
+  word    raw size low 32 bits
+  word    raw size high 32 bits
+  word    block size
+  word    number of blocks
+  byte[]  header bytes
+  byte[]  compressed blocks
+  word[]  for each block the offset of its end from the start of
+          the first block, as two words, low then high 32 bits
+\endverbatim
+* The run length encoding uses a control byte c followed by either
+* c + 1 literal bytes (c < 128) or a single byte which is repeated
+* c - 125 times (c >= 128).
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <Wlz.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define WLZ_VALUECMP_HDRSZ	(24)
+#define WLZ_VALUECMP_STRHDRSZ	(12)
+#define WLZ_VALUECMP_BLKSZ	(1 << 20)
+#define WLZ_VALUECMP_BATCH	(16)
+#define WLZ_VALUECMP_FLG_DELTA	(1)
+#define WLZ_VALUECMP_RUNMIN	(3)
+#define WLZ_VALUECMP_RUNMAX	(130)
+#define WLZ_VALUECMP_LITMAX	(128)
+
+static void			WlzValueCmpPutWord(
+				  WlzUByte *buf,
+				  WlzUInt w);
+static WlzUInt			WlzValueCmpGetWord(
+				  const WlzUByte *buf);
+static void			WlzValueCmpPutOff(
+				  WlzUByte *buf,
+				  size_t off);
+static size_t			WlzValueCmpGetOff(
+				  const WlzUByte *buf);
+static void			WlzValueCmpFilter(
+				  WlzUByte *dst,
+				  const WlzUByte *src,
+				  size_t n,
+				  int eSz,
+				  int delta);
+static void			WlzValueCmpUnfilter(
+				  WlzUByte *dst,
+				  const WlzUByte *src,
+				  size_t n,
+				  int eSz,
+				  int delta);
+static size_t			WlzValueCmpRLEEnc(
+				  WlzUByte *dst,
+				  const WlzUByte *src,
+				  size_t n);
+static WlzErrorNum		WlzValueCmpRLEDec(
+				  WlzUByte *dst,
+				  size_t dstN,
+				  const WlzUByte *src,
+				  size_t srcN);
+static size_t			WlzValueCmpEncodeBlkTo(
+				  WlzUByte *dst,
+				  WlzUByte *wSp,
+				  const WlzUByte *src,
+				  size_t rSz,
+				  int eSz,
+				  int delta);
+static WlzErrorNum		WlzValueCmpDecodeBlkAt(
+				  const WlzUByte *buf,
+				  size_t off,
+				  size_t cSz,
+				  size_t rSz,
+				  int eSz,
+				  int flags,
+				  WlzUByte *dst);
+static WlzErrorNum		WlzValueCmpParseHdr(
+				  const WlzUByte *buf,
+				  size_t bufSz,
+				  int *dstESz,
+				  int *dstFlags,
+				  size_t *dstHdrSz,
+				  size_t *dstRawSz,
+				  size_t *dstBlkSz,
+				  int *dstNBlk);
+static WlzErrorNum		WlzValueCmpStreamOut(
+				  WlzValueCmpStream *str,
+				  const WlzUByte *buf,
+				  size_t n);
+static WlzErrorNum		WlzValueCmpStreamOutWord(
+				  WlzValueCmpStream *str,
+				  size_t w);
+static WlzErrorNum		WlzValueCmpStreamPutBlks(
+				  WlzValueCmpStream *str,
+				  const WlzUByte *raw,
+				  size_t n);
+
+/*!
+* \return	New buffer containing the compressed values or NULL on
+* 		error, this should be freed using AlcFree().
+* \ingroup	WlzIO
+* \brief	Compresses the given raw bytes. The bytes are divided into
+* 		blocks which are compressed in parallel.
+* \param	cmp			Compression method, which must not
+* 					be WLZ_IOCMP_NONE.
+* \param	eSz			Size of the elements for the filter,
+* 					which must be 1, 2, 4 or 8.
+* \param	delta			Apply a delta filter if non-zero and
+* 					the element size is 1, 2 or 4.
+* \param	hdrSz			Number of leading bytes to store
+* 					without compression, the remaining
+* 					bytes must be a sequence of elements.
+* \param	raw			Raw bytes.
+* \param	rawSz			Number of raw bytes.
+* \param	blkSz			Number of raw bytes per block, if
+* 					zero a default of 1Mb is used.
+* \param	dstSz			Destination pointer for the size of
+* 					the compressed buffer.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzUByte	*WlzValueCmpEncode(WlzIOCompression cmp, int eSz, int delta,
+				   size_t hdrSz, const WlzUByte *raw,
+				   size_t rawSz, size_t blkSz, size_t *dstSz,
+				   WlzErrorNum *dstErr)
+{
+  int		idB,
+		nBlk = 0;
+  size_t	datSz = 0;
+  size_t	*cmpSz = NULL;
+  WlzUByte	*buf = NULL;
+  WlzUByte	**cmpBuf = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(blkSz == 0)
+  {
+    blkSz = WLZ_VALUECMP_BLKSZ;
+  }
+  if((raw == NULL) || (dstSz == NULL))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if((cmp != WLZ_IOCMP_RLE) || (hdrSz > rawSz) ||
+          ((eSz != 1) && (eSz != 2) && (eSz != 4) && (eSz != 8)) ||
+	  ((blkSz % eSz) != 0) || (blkSz > 0x7fffffff) ||
+	  (hdrSz > 0x7fffffff))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else
+  {
+    nBlk = (int )((rawSz - hdrSz + blkSz - 1) / blkSz);
+    if(((cmpSz = (size_t *)AlcCalloc(nBlk + 1, sizeof(size_t))) == NULL) ||
+       ((cmpBuf = (WlzUByte **)
+                  AlcCalloc(nBlk + 1, sizeof(WlzUByte *))) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  /* Compress each block into its own buffer. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) if(nBlk > 1)
+#endif
+    for(idB = 0; idB < nBlk; ++idB)
+    {
+      size_t	rSz,
+      		cSz = 0;
+      const WlzUByte *rP;
+      WlzUByte	*wSp = NULL,
+		*cBuf = NULL;
+
+      rP = raw + hdrSz + (idB * blkSz);
+      rSz = WLZ_MIN(blkSz, rawSz - hdrSz - (idB * blkSz));
+      if(((wSp = (WlzUByte *)AlcMalloc(rSz)) != NULL) &&
+         ((cBuf = (WlzUByte *)AlcMalloc(rSz)) != NULL))
+      {
+	cSz = WlzValueCmpEncodeBlkTo(cBuf, wSp, rP, rSz, eSz, delta);
+	if(cSz == rSz)
+	{
+	  (void )memcpy(cBuf, rP, rSz);
+	}
+      }
+      AlcFree(wSp);
+      cmpBuf[idB] = cBuf;
+      cmpSz[idB] = cSz;
+    }
+    for(idB = 0; idB < nBlk; ++idB)
+    {
+      if(cmpBuf[idB] == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+	break;
+      }
+      datSz += cmpSz[idB];
+    }
+  }
+  /* Assemble the header bytes, compressed blocks and offset table. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((buf = (WlzUByte *)AlcMalloc(WLZ_VALUECMP_HDRSZ + hdrSz + datSz +
+                                    ((size_t )nBlk * 8))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    size_t	off = 0;
+    WlzUByte	*bP,
+    		*tP;
+
+    buf[0] = (WlzUByte )cmp;
+    buf[1] = (WlzUByte )eSz;
+    buf[2] = (WlzUByte )((delta && (eSz <= 4))? WLZ_VALUECMP_FLG_DELTA: 0);
+    buf[3] = 0;
+    WlzValueCmpPutWord(buf + 4, (WlzUInt )hdrSz);
+    WlzValueCmpPutOff(buf + 8, rawSz);
+    WlzValueCmpPutWord(buf + 16, (WlzUInt )blkSz);
+    WlzValueCmpPutWord(buf + 20, (WlzUInt )nBlk);
+    bP = buf + WLZ_VALUECMP_HDRSZ;
+    if(hdrSz > 0)
+    {
+      (void )memcpy(bP, raw, hdrSz);
+      bP += hdrSz;
+    }
+    tP = bP + datSz;
+    for(idB = 0; idB < nBlk; ++idB)
+    {
+      (void )memcpy(bP + off, cmpBuf[idB], cmpSz[idB]);
+      off += cmpSz[idB];
+      WlzValueCmpPutOff(tP, off);
+      tP += 8;
+    }
+    *dstSz = WLZ_VALUECMP_HDRSZ + hdrSz + datSz + ((size_t )nBlk * 8);
+  }
+  if(cmpBuf)
+  {
+    for(idB = 0; idB < nBlk; ++idB)
+    {
+      AlcFree(cmpBuf[idB]);
+    }
+    AlcFree(cmpBuf);
+  }
+  AlcFree(cmpSz);
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(buf);
+}
+
+/*!
+* \return	New buffer containing the raw bytes or NULL on error,
+* 		this should be freed using AlcFree().
+* \ingroup	WlzIO
+* \brief	Decompresses a buffer created by WlzValueCmpEncode() or
+* 		WlzValueCmpRead(). The blocks are decompressed in parallel.
+* \param	buf			Compressed buffer.
+* \param	bufSz			Size of the compressed buffer.
+* \param	dstSz			Destination pointer for the number
+* 					of raw bytes.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzUByte	*WlzValueCmpDecode(const WlzUByte *buf, size_t bufSz,
+				   size_t *dstSz, WlzErrorNum *dstErr)
+{
+  int		idB,
+  		eSz,
+		flags,
+		nBlk = 0;
+  size_t	hdrSz,
+  		rawSz = 0,
+		blkSz;
+  WlzUByte	*raw = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((buf == NULL) || (dstSz == NULL))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else
+  {
+    errNum = WlzValueCmpParseHdr(buf, bufSz, &eSz, &flags,
+    				 &hdrSz, &rawSz, &blkSz, &nBlk);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((raw = (WlzUByte *)AlcMalloc(WLZ_MAX(rawSz, 1))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      (void )memcpy(raw, buf + WLZ_VALUECMP_HDRSZ, hdrSz);
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) if(nBlk > 1)
+#endif
+    for(idB = 0; idB < nBlk; ++idB)
+    {
+      size_t	rSz;
+      WlzErrorNum errNum2;
+
+      rSz = WLZ_MIN(blkSz, rawSz - hdrSz - (idB * blkSz));
+      errNum2 = WlzValueCmpDecodeBlk(buf, bufSz, idB,
+				     raw + hdrSz + (idB * blkSz), &rSz);
+      if(errNum2 != WLZ_ERR_NONE)
+      {
+#ifdef _OPENMP
+#pragma omp critical (WlzValueCmpDecode)
+#endif
+	{
+	  errNum = errNum2;
+	}
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    *dstSz = rawSz;
+  }
+  else
+  {
+    AlcFree(raw);
+    raw = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(raw);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Decompresses a single block of a buffer created by
+* 		WlzValueCmpEncode() or WlzValueCmpRead(), allowing random
+* 		access to the raw bytes. The block is found in constant
+* 		time using the table of block offsets. The raw bytes of
+* 		block \f$i\f$ start at \f$h + i b\f$ where \f$h\f$ and
+* 		\f$b\f$ are the header and block sizes given by
+* 		WlzValueCmpInfo().
+* \param	buf			Compressed buffer.
+* \param	bufSz			Size of the compressed buffer.
+* \param	blk			Index of the block.
+* \param	dst			Destination for the raw bytes of the
+* 					block, which must have room for
+* 					the block size.
+* \param	dstSz			Destination pointer for the number
+* 					of raw bytes in the block.
+*/
+WlzErrorNum	WlzValueCmpDecodeBlk(const WlzUByte *buf, size_t bufSz,
+				     int blk, WlzUByte *dst, size_t *dstSz)
+{
+  int		eSz,
+		flags,
+		nBlk;
+  size_t	off0,
+  		off1,
+		datSz,
+		rSz = 0,
+  		hdrSz,
+  		rawSz,
+		blkSz;
+  const WlzUByte *tP;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((buf == NULL) || (dst == NULL) || (dstSz == NULL))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else
+  {
+    errNum = WlzValueCmpParseHdr(buf, bufSz, &eSz, &flags,
+    				 &hdrSz, &rawSz, &blkSz, &nBlk);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((blk < 0) || (blk >= nBlk))
+    {
+      errNum = WLZ_ERR_PARAM_DATA;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    datSz = bufSz - WLZ_VALUECMP_HDRSZ - hdrSz - ((size_t )nBlk * 8);
+    tP = buf + WLZ_VALUECMP_HDRSZ + hdrSz + datSz;
+    off0 = (blk > 0)? WlzValueCmpGetOff(tP + ((size_t )(blk - 1) * 8)): 0;
+    off1 = WlzValueCmpGetOff(tP + ((size_t )blk * 8));
+    rSz = WLZ_MIN(blkSz, rawSz - hdrSz - (blk * blkSz));
+    if((off0 > off1) || (off1 > datSz))
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+    }
+    else
+    {
+      errNum = WlzValueCmpDecodeBlkAt(buf, WLZ_VALUECMP_HDRSZ + hdrSz + off0,
+      				      off1 - off0, rSz, eSz, flags, dst);
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    *dstSz = rSz;
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Gets the sizes of a buffer created by WlzValueCmpEncode()
+* 		or WlzValueCmpRead().
+* \param	buf			Compressed buffer.
+* \param	bufSz			Size of the compressed buffer.
+* \param	dstHdrSz		Destination pointer for the header
+* 					size, may be NULL.
+* \param	dstRawSz		Destination pointer for the raw size,
+* 					may be NULL.
+* \param	dstBlkSz		Destination pointer for the block
+* 					size, may be NULL.
+* \param	dstNBlk			Destination pointer for the number
+* 					of blocks, may be NULL.
+*/
+WlzErrorNum	WlzValueCmpInfo(const WlzUByte *buf, size_t bufSz,
+				size_t *dstHdrSz, size_t *dstRawSz,
+				size_t *dstBlkSz, int *dstNBlk)
+{
+  int		eSz,
+  		flags,
+		nBlk;
+  size_t	hdrSz,
+  		rawSz,
+		blkSz;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(buf == NULL)
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if((errNum = WlzValueCmpParseHdr(buf, bufSz, &eSz, &flags,
+  				        &hdrSz, &rawSz, &blkSz,
+					&nBlk)) == WLZ_ERR_NONE)
+  {
+    if(dstHdrSz)
+    {
+      *dstHdrSz = hdrSz;
+    }
+    if(dstRawSz)
+    {
+      *dstRawSz = rawSz;
+    }
+    if(dstBlkSz)
+    {
+      *dstBlkSz = blkSz;
+    }
+    if(dstNBlk)
+    {
+      *dstNBlk = nBlk;
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	New compressed value stream or NULL on error.
+* \ingroup	WlzIO
+* \brief	Opens a compressed value stream and writes its header.
+* 		Raw bytes are then given to the stream using
+* 		WlzValueCmpStreamPut(), which compresses and writes each
+* 		block as soon as it is complete, so that the raw bytes
+* 		are never all held in memory. The stream must be closed
+* 		using WlzValueCmpStreamClose().
+* \param	fP			File to write to or NULL to write
+* 					to a memory buffer which is
+* 					returned by WlzValueCmpStreamClose().
+* \param	cmp			Compression method, which must not
+* 					be WLZ_IOCMP_NONE.
+* \param	eSz			Size of the elements for the filter,
+* 					which must be 1, 2, 4 or 8.
+* \param	delta			Apply a delta filter if non-zero and
+* 					the element size is 1, 2 or 4.
+* \param	hdr			Header bytes to store without
+* 					compression, may be NULL if the
+* 					header size is zero.
+* \param	hdrSz			Number of header bytes.
+* \param	blkSz			Number of raw bytes per block, if
+* 					zero a default of 1Mb is used.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzValueCmpStream *WlzValueCmpStreamOpen(FILE *fP, WlzIOCompression cmp,
+				int eSz, int delta,
+				const WlzUByte *hdr, size_t hdrSz,
+				size_t blkSz, WlzErrorNum *dstErr)
+{
+  WlzUByte	sHdr[WLZ_VALUECMP_STRHDRSZ];
+  WlzValueCmpStream *str = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(blkSz == 0)
+  {
+    blkSz = WLZ_VALUECMP_BLKSZ;
+  }
+  if((hdr == NULL) && (hdrSz > 0))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if((cmp != WLZ_IOCMP_RLE) ||
+          ((eSz != 1) && (eSz != 2) && (eSz != 4) && (eSz != 8)) ||
+	  ((blkSz % eSz) != 0) || (blkSz > 0x7fffffff) ||
+	  (hdrSz > 0x7fffffff))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else if(((str = (WlzValueCmpStream *)
+                  AlcCalloc(1, sizeof(WlzValueCmpStream))) == NULL) ||
+          ((str->raw = (WlzUByte *)AlcMalloc(blkSz)) == NULL))
+  {
+    AlcFree(str);
+    str = NULL;
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    str->fP = fP;
+    str->cmp = cmp;
+    str->eSz = eSz;
+    str->delta = delta && (eSz <= 4);
+    str->blkSz = blkSz;
+    sHdr[0] = (WlzUByte )cmp;
+    sHdr[1] = (WlzUByte )eSz;
+    sHdr[2] = (WlzUByte )((str->delta)? WLZ_VALUECMP_FLG_DELTA: 0);
+    sHdr[3] = 0;
+    WlzValueCmpPutWord(sHdr + 4, (WlzUInt )hdrSz);
+    WlzValueCmpPutWord(sHdr + 8, (WlzUInt )blkSz);
+    if(((errNum = WlzValueCmpStreamOut(str, sHdr,
+                                       WLZ_VALUECMP_STRHDRSZ)) ==
+        WLZ_ERR_NONE) && (hdrSz > 0))
+    {
+      errNum = WlzValueCmpStreamOut(str, hdr, hdrSz);
+    }
+    if(errNum != WLZ_ERR_NONE)
+    {
+      (void )WlzValueCmpStreamClose(str, NULL, NULL);
+      str = NULL;
+    }
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(str);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Gives raw bytes to a compressed value stream. Each block
+* 		is compressed and written as soon as it is complete.
+* 		When many complete blocks are given together they are
+* 		compressed in parallel (in batches to bound the memory
+* 		used) and then written in order.
+* \param	str			Compressed value stream.
+* \param	raw			Raw bytes.
+* \param	n			Number of raw bytes.
+*/
+WlzErrorNum	WlzValueCmpStreamPut(WlzValueCmpStream *str,
+				     const WlzUByte *raw, size_t n)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((str == NULL) || ((raw == NULL) && (n > 0)))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  while((errNum == WLZ_ERR_NONE) && (n > 0))
+  {
+    size_t	m;
+
+    if((str->rawSz == 0) && (n >= 2 * str->blkSz))
+    {
+      m = WLZ_MIN(WLZ_VALUECMP_BATCH, n / str->blkSz) * str->blkSz;
+      errNum = WlzValueCmpStreamPutBlks(str, raw, m);
+    }
+    else
+    {
+      m = WLZ_MIN(str->blkSz - str->rawSz, n);
+      (void )memcpy(str->raw + str->rawSz, raw, m);
+      str->rawSz += m;
+      if(str->rawSz == str->blkSz)
+      {
+        errNum = WlzValueCmpStreamPutBlks(str, str->raw, str->rawSz);
+	str->rawSz = 0;
+      }
+    }
+    raw += m;
+    n -= m;
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Memory buffer holding the stream if the stream was opened
+* 		without a file, otherwise NULL. A memory buffer should be
+* 		freed using AlcFree().
+* \ingroup	WlzIO
+* \brief	Compresses and writes any partial block, ends the stream
+* 		and then frees it.
+* \param	str			Compressed value stream.
+* \param	dstSz			Destination pointer for the size of
+* 					a memory buffer, may be NULL.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzUByte	*WlzValueCmpStreamClose(WlzValueCmpStream *str, size_t *dstSz,
+				        WlzErrorNum *dstErr)
+{
+  WlzUByte	*buf = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(str == NULL)
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else
+  {
+    if(str->rawSz > 0)
+    {
+      errNum = WlzValueCmpStreamPutBlks(str, str->raw, str->rawSz);
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = WlzValueCmpStreamOutWord(str, 0);
+    }
+    if((errNum == WLZ_ERR_NONE) && (str->fP == NULL))
+    {
+      buf = str->mem;
+      str->mem = NULL;
+      if(dstSz)
+      {
+        *dstSz = str->memSz;
+      }
+    }
+    AlcFree(str->mem);
+    AlcFree(str->raw);
+    AlcFree(str->wSp);
+    AlcFree(str);
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(buf);
+}
+
+/*!
+* \return	New buffer in the form created by WlzValueCmpEncode() or
+* 		NULL on error, this should be freed using AlcFree().
+* \ingroup	WlzIO
+* \brief	Reads compressed values written by a compressed value
+* 		stream (see WlzValueCmpStreamOpen()) from the given file.
+* 		The blocks are not decompressed, but a table of their
+* 		offsets is built so that they may be decompressed in
+* 		parallel or individually by WlzValueCmpDecodeBlk().
+* \param	fP			Input file.
+* \param	dstSz			Destination pointer for the size of
+* 					the buffer.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzUByte	*WlzValueCmpRead(FILE *fP, size_t *dstSz, WlzErrorNum *dstErr)
+{
+  int		nBlk = 0,
+  		maxBlk = 0;
+  size_t	hdrSz = 0,
+  		blkSz = 0,
+		rawSz = 0,
+		lastRSz = 0,
+  		datSz = 0,
+		bufMax = 0;
+  size_t	*off = NULL;
+  WlzUByte	*buf = NULL;
+  WlzUByte	sHdr[WLZ_VALUECMP_STRHDRSZ];
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((fP == NULL) || (dstSz == NULL))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if(fread(sHdr, 1, WLZ_VALUECMP_STRHDRSZ, fP) != WLZ_VALUECMP_STRHDRSZ)
+  {
+    errNum = WLZ_ERR_READ_INCOMPLETE;
+  }
+  else
+  {
+    hdrSz = WlzValueCmpGetWord(sHdr + 4);
+    blkSz = WlzValueCmpGetWord(sHdr + 8);
+    lastRSz = blkSz;
+    if((sHdr[0] != WLZ_IOCMP_RLE) ||
+       ((sHdr[1] != 1) && (sHdr[1] != 2) && (sHdr[1] != 4) &&
+        (sHdr[1] != 8)) ||
+       (blkSz == 0) || (blkSz > 0x7fffffff) || (hdrSz > 0x7fffffff))
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+    }
+    else
+    {
+      bufMax = WLZ_VALUECMP_HDRSZ + hdrSz + blkSz;
+      if((buf = (WlzUByte *)AlcMalloc(bufMax)) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      else if(fread(buf + WLZ_VALUECMP_HDRSZ, 1, hdrSz, fP) != hdrSz)
+      {
+        errNum = WLZ_ERR_READ_INCOMPLETE;
+      }
+    }
+  }
+  /* Read the blocks recording the offsets of their ends. */
+  while(errNum == WLZ_ERR_NONE)
+  {
+    size_t	rSz,
+    		cSz;
+    WlzUByte	bHdr[8];
+
+    if(fread(bHdr, 1, 4, fP) != 4)
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+      break;
+    }
+    if((rSz = WlzValueCmpGetWord(bHdr)) == 0)
+    {
+      break;
+    }
+    if(fread(bHdr + 4, 1, 4, fP) != 4)
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+      break;
+    }
+    cSz = WlzValueCmpGetWord(bHdr + 4);
+    /* Only the last block may be smaller than the block size. */
+    if((rSz > blkSz) || (lastRSz != blkSz) || (cSz > rSz) ||
+       (nBlk >= 0x7fffffff))
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+      break;
+    }
+    if(nBlk >= maxBlk)
+    {
+      size_t	*nOff;
+
+      maxBlk = (maxBlk > 0)? 2 * maxBlk: 64;
+      if((nOff = (size_t *)AlcRealloc(off, maxBlk * sizeof(size_t))) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+	break;
+      }
+      off = nOff;
+    }
+    if(WLZ_VALUECMP_HDRSZ + hdrSz + datSz + cSz > bufMax)
+    {
+      WlzUByte	*nBuf;
+
+      bufMax = 2 * (WLZ_VALUECMP_HDRSZ + hdrSz + datSz + cSz);
+      if((nBuf = (WlzUByte *)AlcRealloc(buf, bufMax)) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+	break;
+      }
+      buf = nBuf;
+    }
+    if(fread(buf + WLZ_VALUECMP_HDRSZ + hdrSz + datSz, 1, cSz, fP) != cSz)
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+      break;
+    }
+    datSz += cSz;
+    rawSz += rSz;
+    lastRSz = rSz;
+    off[nBlk++] = datSz;
+  }
+  /* Fill in the header and append the table of block offsets. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    size_t	bufSz;
+
+    bufSz = WLZ_VALUECMP_HDRSZ + hdrSz + datSz + ((size_t )nBlk * 8);
+    if(bufSz > bufMax)
+    {
+      WlzUByte	*nBuf;
+
+      if((nBuf = (WlzUByte *)AlcRealloc(buf, bufSz)) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      else
+      {
+        buf = nBuf;
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      int	idB;
+      WlzUByte	*tP;
+
+      buf[0] = sHdr[0];
+      buf[1] = sHdr[1];
+      buf[2] = sHdr[2];
+      buf[3] = 0;
+      WlzValueCmpPutWord(buf + 4, (WlzUInt )hdrSz);
+      WlzValueCmpPutOff(buf + 8, hdrSz + rawSz);
+      WlzValueCmpPutWord(buf + 16, (WlzUInt )blkSz);
+      WlzValueCmpPutWord(buf + 20, (WlzUInt )nBlk);
+      tP = buf + WLZ_VALUECMP_HDRSZ + hdrSz + datSz;
+      for(idB = 0; idB < nBlk; ++idB)
+      {
+        WlzValueCmpPutOff(tP, off[idB]);
+	tP += 8;
+      }
+      *dstSz = bufSz;
+    }
+  }
+  AlcFree(off);
+  if(errNum != WLZ_ERR_NONE)
+  {
+    AlcFree(buf);
+    buf = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(buf);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Compresses and writes the given raw bytes as a sequence
+* 		of blocks, of which only the last may be smaller than
+* 		the block size. The blocks are compressed in parallel
+* 		into the stream's workspace and then written in order.
+* \param	str			Compressed value stream.
+* \param	raw			Raw bytes.
+* \param	n			Number of raw bytes, which must not
+* 					be more than WLZ_VALUECMP_BATCH
+* 					blocks.
+*/
+static WlzErrorNum WlzValueCmpStreamPutBlks(WlzValueCmpStream *str,
+				const WlzUByte *raw, size_t n)
+{
+  int		idB,
+  		nBlk;
+  size_t	wSpSz;
+  size_t	cSz[WLZ_VALUECMP_BATCH];
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  nBlk = (int )((n + str->blkSz - 1) / str->blkSz);
+  wSpSz = 2 * (size_t )nBlk * str->blkSz;
+  if(wSpSz > str->wSpSz)
+  {
+    AlcFree(str->wSp);
+    str->wSpSz = 0;
+    if((str->wSp = (WlzUByte *)AlcMalloc(wSpSz)) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else
+    {
+      str->wSpSz = wSpSz;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) if(nBlk > 1)
+#endif
+    for(idB = 0; idB < nBlk; ++idB)
+    {
+      size_t	rSz;
+      WlzUByte	*cP;
+
+      rSz = WLZ_MIN(str->blkSz, n - (idB * str->blkSz));
+      cP = str->wSp + (2 * (size_t )idB * str->blkSz);
+      cSz[idB] = WlzValueCmpEncodeBlkTo(cP, cP + str->blkSz,
+      					raw + (idB * str->blkSz), rSz,
+      				        str->eSz, str->delta);
+    }
+    for(idB = 0; (errNum == WLZ_ERR_NONE) && (idB < nBlk); ++idB)
+    {
+      size_t	rSz;
+      const WlzUByte *cP;
+
+      rSz = WLZ_MIN(str->blkSz, n - (idB * str->blkSz));
+      cP = (cSz[idB] == rSz)? raw + (idB * str->blkSz):
+                              str->wSp + (2 * (size_t )idB * str->blkSz);
+      if(((errNum = WlzValueCmpStreamOutWord(str, rSz)) == WLZ_ERR_NONE) &&
+         ((errNum = WlzValueCmpStreamOutWord(str, cSz[idB])) == WLZ_ERR_NONE))
+      {
+        errNum = WlzValueCmpStreamOut(str, cP, cSz[idB]);
+      }
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Writes bytes to the file or memory buffer of a compressed
+* 		value stream.
+* \param	str			Compressed value stream.
+* \param	buf			Bytes to write.
+* \param	n			Number of bytes.
+*/
+static WlzErrorNum WlzValueCmpStreamOut(WlzValueCmpStream *str,
+				const WlzUByte *buf, size_t n)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(str->fP)
+  {
+    if(fwrite(buf, 1, n, str->fP) != n)
+    {
+      errNum = WLZ_ERR_WRITE_INCOMPLETE;
+    }
+  }
+  else
+  {
+    if(str->memSz + n > str->memMax)
+    {
+      size_t	mx;
+      WlzUByte	*mem;
+
+      mx = WLZ_MAX(2 * (str->memSz + n), 1024);
+      if((mem = (WlzUByte *)AlcRealloc(str->mem, mx)) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+      else
+      {
+        str->mem = mem;
+	str->memMax = mx;
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      (void )memcpy(str->mem + str->memSz, buf, n);
+      str->memSz += n;
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Writes a word to a compressed value stream.
+* \param	str			Compressed value stream.
+* \param	w			Value of the word, which must be
+* 					less than 2^32.
+*/
+static WlzErrorNum WlzValueCmpStreamOutWord(WlzValueCmpStream *str,
+				size_t w)
+{
+  WlzUByte	buf[4];
+
+  WlzValueCmpPutWord(buf, (WlzUInt )w);
+  return(WlzValueCmpStreamOut(str, buf, 4));
+}
+
+/*!
+* \return	Number of compressed bytes, which is equal to the number
+* 		of raw bytes if the block does not compress, in which
+* 		case the raw bytes should be stored in place of the
+* 		destination bytes.
+* \ingroup	WlzIO
+* \brief	Filters and then run length encodes a single block.
+* \param	dst			Destination for the compressed bytes,
+* 					with room for the raw size.
+* \param	wSp			Workspace with room for the raw size.
+* \param	src			Raw bytes of the block.
+* \param	rSz			Raw size of the block.
+* \param	eSz			Element size for the filter.
+* \param	delta			Delta filter if non-zero.
+*/
+static size_t	WlzValueCmpEncodeBlkTo(WlzUByte *dst, WlzUByte *wSp,
+				       const WlzUByte *src, size_t rSz,
+				       int eSz, int delta)
+{
+  size_t	cSz;
+
+  WlzValueCmpFilter(wSp, src, rSz, eSz, delta);
+  cSz = WlzValueCmpRLEEnc(dst, wSp, rSz);
+  if(cSz >= rSz)
+  {
+    cSz = rSz;
+  }
+  return(cSz);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Decompresses the block with the given offset and sizes.
+* \param	buf			Compressed buffer.
+* \param	off			Offset of the compressed block in
+* 					the buffer.
+* \param	cSz			Compressed size of the block.
+* \param	rSz			Raw size of the block.
+* \param	eSz			Element size for the filter.
+* \param	flags			Filter flags.
+* \param	dst			Destination for the raw bytes.
+*/
+static WlzErrorNum WlzValueCmpDecodeBlkAt(const WlzUByte *buf,
+				size_t off, size_t cSz, size_t rSz,
+				int eSz, int flags, WlzUByte *dst)
+{
+  WlzUByte	*fBuf = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(cSz > rSz)
+  {
+    errNum = WLZ_ERR_READ_INCOMPLETE;
+  }
+  else if(cSz == rSz)
+  {
+    (void )memcpy(dst, buf + off, rSz);
+  }
+  else if((fBuf = (WlzUByte *)AlcMalloc(rSz)) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else if((errNum = WlzValueCmpRLEDec(fBuf, rSz, buf + off,
+				      cSz)) == WLZ_ERR_NONE)
+  {
+    WlzValueCmpUnfilter(dst, fBuf, rSz, eSz,
+			(flags & WLZ_VALUECMP_FLG_DELTA) != 0);
+  }
+  AlcFree(fBuf);
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Parses and checks the fixed size header of a compressed
+* 		buffer and checks that the buffer is large enough for
+* 		the header bytes and the table of block offsets.
+* \param	buf			Compressed buffer.
+* \param	bufSz			Size of the compressed buffer.
+* \param	dstESz			Destination pointer for element size.
+* \param	dstFlags		Destination pointer for filter flags.
+* \param	dstHdrSz		Destination pointer for header size.
+* \param	dstRawSz		Destination pointer for raw size.
+* \param	dstBlkSz		Destination pointer for block size.
+* \param	dstNBlk			Destination pointer for number of
+* 					blocks.
+*/
+static WlzErrorNum WlzValueCmpParseHdr(const WlzUByte *buf, size_t bufSz,
+				int *dstESz, int *dstFlags,
+				size_t *dstHdrSz, size_t *dstRawSz,
+				size_t *dstBlkSz, int *dstNBlk)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(bufSz < WLZ_VALUECMP_HDRSZ)
+  {
+    errNum = WLZ_ERR_READ_INCOMPLETE;
+  }
+  else if((sizeof(size_t) < 8) && (WlzValueCmpGetWord(buf + 12) != 0))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    *dstESz = buf[1];
+    *dstFlags = buf[2];
+    *dstHdrSz = WlzValueCmpGetWord(buf + 4);
+    *dstRawSz = WlzValueCmpGetOff(buf + 8);
+    *dstBlkSz = WlzValueCmpGetWord(buf + 16);
+    *dstNBlk = (int )WlzValueCmpGetWord(buf + 20);
+    if((buf[0] != WLZ_IOCMP_RLE) ||
+       ((*dstESz != 1) && (*dstESz != 2) && (*dstESz != 4) &&
+        (*dstESz != 8)) ||
+       (*dstBlkSz == 0) || (*dstNBlk < 0) ||
+       (*dstHdrSz > *dstRawSz) ||
+       ((size_t )*dstNBlk !=
+        (*dstRawSz - *dstHdrSz + *dstBlkSz - 1) / *dstBlkSz))
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+    }
+    else if(WLZ_VALUECMP_HDRSZ + *dstHdrSz + ((size_t )*dstNBlk * 8) > bufSz)
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+    }
+  }
+  return(errNum);
+}
+
+
+/*!
+* \ingroup	WlzIO
+* \brief	Writes a four byte word in little endian byte order.
+* \param	buf			Destination buffer.
+* \param	w			Word to write.
+*/
+static void	WlzValueCmpPutWord(WlzUByte *buf, WlzUInt w)
+{
+  buf[0] = (WlzUByte )(w & 0xff);
+  buf[1] = (WlzUByte )((w >> 8) & 0xff);
+  buf[2] = (WlzUByte )((w >> 16) & 0xff);
+  buf[3] = (WlzUByte )((w >> 24) & 0xff);
+}
+
+/*!
+* \return	Word read.
+* \ingroup	WlzIO
+* \brief	Reads a four byte word in little endian byte order.
+* \param	buf			Source buffer.
+*/
+static WlzUInt	WlzValueCmpGetWord(const WlzUByte *buf)
+{
+  WlzUInt	w;
+
+  w = (WlzUInt )buf[0] | ((WlzUInt )buf[1] << 8) |
+      ((WlzUInt )buf[2] << 16) | ((WlzUInt )buf[3] << 24);
+  return(w);
+}
+
+
+/*!
+* \ingroup	WlzIO
+* \brief	Writes a size or offset as two words, low then high
+* 		32 bits.
+* \param	buf			Destination buffer.
+* \param	off			Size or offset to write.
+*/
+static void	WlzValueCmpPutOff(WlzUByte *buf, size_t off)
+{
+  WlzValueCmpPutWord(buf, (WlzUInt )(off & 0xffffffff));
+  WlzValueCmpPutWord(buf + 4, (sizeof(size_t) > 4)?
+                              (WlzUInt )((WlzLong )off >> 32): 0);
+}
+
+/*!
+* \return	Size or offset read.
+* \ingroup	WlzIO
+* \brief	Reads a size or offset written by WlzValueCmpPutOff().
+* 		The high word is ignored if size_t has only 32 bits.
+* \param	buf			Source buffer.
+*/
+static size_t	WlzValueCmpGetOff(const WlzUByte *buf)
+{
+  size_t	off;
+
+  off = WlzValueCmpGetWord(buf);
+  if(sizeof(size_t) > 4)
+  {
+    off |= (size_t )((WlzLong )WlzValueCmpGetWord(buf + 4) << 32);
+  }
+  return(off);
+}
+
+/*!
+* \ingroup	WlzIO
+* \brief	Filters a block of bytes prior to run length encoding.
+* 		If the delta flag is set and the element size is 1, 2 or 4
+* 		then each (little endian) element is replaced by its
+* 		difference from the previous element. Multi-byte elements
+* 		are then shuffled into byte planes. Any trailing bytes
+* 		which don't form a complete element are copied.
+* \param	dst			Destination for the filtered bytes.
+* \param	src			Source bytes.
+* \param	n			Number of bytes.
+* \param	eSz			Element size.
+* \param	delta			Delta filter if non-zero.
+*/
+static void	WlzValueCmpFilter(WlzUByte *dst, const WlzUByte *src,
+				  size_t n, int eSz, int delta)
+{
+  int		idB;
+  size_t	idE,
+  		nE;
+  WlzUInt	v,
+  		p = 0,
+		d;
+
+  nE = n / eSz;
+  if(delta && (eSz <= 4))
+  {
+    for(idE = 0; idE < nE; ++idE)
+    {
+      v = 0;
+      for(idB = 0; idB < eSz; ++idB)
+      {
+        v |= (WlzUInt )src[(idE * eSz) + idB] << (8 * idB);
+      }
+      d = v - p;
+      p = v;
+      for(idB = 0; idB < eSz; ++idB)
+      {
+        dst[(idB * nE) + idE] = (WlzUByte )((d >> (8 * idB)) & 0xff);
+      }
+    }
+  }
+  else
+  {
+    for(idE = 0; idE < nE; ++idE)
+    {
+      for(idB = 0; idB < eSz; ++idB)
+      {
+        dst[(idB * nE) + idE] = src[(idE * eSz) + idB];
+      }
+    }
+  }
+  for(idE = nE * eSz; idE < n; ++idE)
+  {
+    dst[idE] = src[idE];
+  }
+}
+
+/*!
+* \ingroup	WlzIO
+* \brief	Inverts the filter applied by WlzValueCmpFilter().
+* \param	dst			Destination for the raw bytes.
+* \param	src			Filtered bytes.
+* \param	n			Number of bytes.
+* \param	eSz			Element size.
+* \param	delta			Delta filter if non-zero.
+*/
+static void	WlzValueCmpUnfilter(WlzUByte *dst, const WlzUByte *src,
+				    size_t n, int eSz, int delta)
+{
+  int		idB;
+  size_t	idE,
+  		nE;
+  WlzUInt	p = 0,
+		d;
+
+  nE = n / eSz;
+  if(delta && (eSz <= 4))
+  {
+    for(idE = 0; idE < nE; ++idE)
+    {
+      d = 0;
+      for(idB = 0; idB < eSz; ++idB)
+      {
+        d |= (WlzUInt )src[(idB * nE) + idE] << (8 * idB);
+      }
+      p += d;
+      for(idB = 0; idB < eSz; ++idB)
+      {
+        dst[(idE * eSz) + idB] = (WlzUByte )((p >> (8 * idB)) & 0xff);
+      }
+    }
+  }
+  else
+  {
+    for(idE = 0; idE < nE; ++idE)
+    {
+      for(idB = 0; idB < eSz; ++idB)
+      {
+        dst[(idE * eSz) + idB] = src[(idB * nE) + idE];
+      }
+    }
+  }
+  for(idE = nE * eSz; idE < n; ++idE)
+  {
+    dst[idE] = src[idE];
+  }
+}
+
+/*!
+* \return	Number of encoded bytes, which is not less than the
+* 		number of source bytes if the encoding would be no
+* 		smaller than the source.
+* \ingroup	WlzIO
+* \brief	Run length encodes the given bytes. The destination
+* 		must have room for at least n bytes and encoding stops
+* 		as soon as it would exceed this.
+* \param	dst			Destination for encoded bytes.
+* \param	src			Source bytes.
+* \param	n			Number of source bytes.
+*/
+static size_t	WlzValueCmpRLEEnc(WlzUByte *dst, const WlzUByte *src,
+				  size_t n)
+{
+  size_t	iS = 0,
+  		iD = 0,
+		lit = 0,
+		run;
+
+  while((iS < n) && (iD < n))
+  {
+    /* Find the length of the run starting at iS. */
+    run = 1;
+    while((iS + run < n) && (run < WLZ_VALUECMP_RUNMAX) &&
+          (src[iS + run] == src[iS]))
+    {
+      ++run;
+    }
+    if(run >= WLZ_VALUECMP_RUNMIN)
+    {
+      if(iD + 2 > n)
+      {
+        iD = n;
+      }
+      else
+      {
+	dst[iD++] = (WlzUByte )(run + 128 - WLZ_VALUECMP_RUNMIN);
+	dst[iD++] = src[iS];
+	iS += run;
+      }
+    }
+    else
+    {
+      /* Gather literals until a run of the minimum length starts. */
+      lit = 0;
+      while((iS + lit < n) && (lit < WLZ_VALUECMP_LITMAX) &&
+            !((iS + lit + 2 < n) &&
+	      (src[iS + lit] == src[iS + lit + 1]) &&
+	      (src[iS + lit] == src[iS + lit + 2])))
+      {
+        ++lit;
+      }
+      if(iD + 1 + lit > n)
+      {
+        iD = n;
+      }
+      else
+      {
+	dst[iD++] = (WlzUByte )(lit - 1);
+	(void )memcpy(dst + iD, src + iS, lit);
+	iD += lit;
+	iS += lit;
+      }
+    }
+  }
+  if(iS < n)
+  {
+    iD = n;
+  }
+  return(iD);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Decodes run length encoded bytes.
+* \param	dst			Destination for the decoded bytes.
+* \param	dstN			Number of bytes expected.
+* \param	src			Encoded bytes.
+* \param	srcN			Number of encoded bytes.
+*/
+static WlzErrorNum WlzValueCmpRLEDec(WlzUByte *dst, size_t dstN,
+				     const WlzUByte *src, size_t srcN)
+{
+  size_t	iS = 0,
+  		iD = 0,
+		cnt;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  while((errNum == WLZ_ERR_NONE) && (iS < srcN))
+  {
+    if(src[iS] < 128)
+    {
+      cnt = src[iS] + 1;
+      if((iS + 1 + cnt > srcN) || (iD + cnt > dstN))
+      {
+        errNum = WLZ_ERR_READ_INCOMPLETE;
+      }
+      else
+      {
+        (void )memcpy(dst + iD, src + iS + 1, cnt);
+	iS += cnt + 1;
+	iD += cnt;
+      }
+    }
+    else
+    {
+      cnt = src[iS] - 128 + WLZ_VALUECMP_RUNMIN;
+      if((iS + 2 > srcN) || (iD + cnt > dstN))
+      {
+        errNum = WLZ_ERR_READ_INCOMPLETE;
+      }
+      else
+      {
+        (void )memset(dst + iD, src[iS + 1], cnt);
+	iS += 2;
+	iD += cnt;
+      }
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (iD != dstN))
+  {
+    errNum = WLZ_ERR_READ_INCOMPLETE;
+  }
+  return(errNum);
+}
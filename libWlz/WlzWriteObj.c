@@ -47,6 +47,12 @@ static char _WlzWriteObj_c[] = "University of Edinburgh $Id$";
 
 /* #define WLZ_DEBUG_WRITEOBJ */
 
+/* Number of planes compressed in parallel before being written. */
+#define WLZ_WRITEOBJ_CMP_BATCH	(64)
+
+/* Size of the buffer used to convert values before compression. */
+#define WLZ_WRITEOBJ_CMP_LNSZ	(4096)
+
 #if defined(_WIN32) && !defined(__x86)
 #define __x86
 #endif
@@ -67,13 +73,43 @@ static WlzErrorNum		WlzWriteProperty(
 static WlzErrorNum		WlzWriteValueTable(
 				  FILE	*fP,
 				  WlzObject *obj);
+static WlzErrorNum		WlzWriteValueTableCmp(
+				  FILE	*fP,
+				  WlzObject *obj,
+				  WlzIOCompression cmp);
 static WlzErrorNum		WlzWriteVoxelValueTable(
 				  FILE *fP,
-				  WlzObject *obj);
+				  WlzObject *obj,
+				  WlzIOCompression cmp);
 static WlzErrorNum		WlzWriteTiledValueTable(
 				  FILE *fP,
 				  WlzObject *obj,
-				  int writeTiles);
+				  int writeTiles,
+				  WlzIOCompression cmp);
+static WlzErrorNum		WlzPlaneStreamCopy(
+				  FILE *dP,
+				  FILE *sP,
+				  long off0,
+				  long off1,
+				  char *buf,
+				  size_t bufSz);
+static WlzUByte			*WlzWriteValueTableCmpStr(
+				  FILE *fP,
+				  WlzObject *obj,
+				  WlzIOCompression cmp,
+				  size_t *dstSz,
+				  WlzErrorNum *dstErr);
+static WlzGreyType		WlzWriteValuePacking(
+				  WlzObject *obj,
+				  WlzGreyType gType,
+				  WlzErrorNum *dstErr);
+static size_t			WlzWriteGreyBytes(
+				  WlzUByte *dst,
+				  WlzGreyP g,
+				  int off,
+				  int n,
+				  WlzGreyType gType,
+				  WlzGreyType packing);
 static WlzErrorNum		WlzWritePolygon(
 				  FILE *fP,
 				  WlzPolygonDomain *poly);
@@ -88,10 +124,15 @@ static WlzErrorNum		WlzWriteHistogramDomain(
 				  WlzHistogramDomain *hist);
 static WlzErrorNum		WlzWriteCompoundA(
 				  FILE *fP,
-				  WlzCompoundArray *c);
+				  WlzCompoundArray *c,
+				  WlzIOCompression cmp);
 static WlzErrorNum		WlzWriteAffineTransform(
 				  FILE *fP,
 				  WlzAffineTransform *trans);
+static WlzErrorNum		WlzWriteDispFieldTransform(
+				  FILE *fP,
+				  WlzDispFieldTransform *dft,
+				  WlzIOCompression cmp);
 static WlzErrorNum		WlzWriteWarpTrans(
 				  FILE *fP,
 				  WlzWarpTrans *obj);
@@ -345,6 +386,29 @@ static int putdouble(double d, FILE *fP)
 * \param    	obj			Ptr to top-level object to be written.
 */
 WlzErrorNum	WlzWriteObj(FILE *fP, WlzObject *obj)
+{
+  return(WlzWriteObjCmp(fP, obj, WLZ_IOCMP_NONE));
+}
+
+/*!
+* \return       Woolz error number code.
+* \ingroup      WlzIO
+* \brief        Writes an object to a file stream as WlzWriteObj() but
+* 		with the grey values of domain objects (including those of
+* 		any transformed or compound objects) compressed using the
+* 		given compression method. Each 2D value table, each plane
+* 		of a 3D value table and the tiles of tiled values are
+* 		compressed in independent blocks which are encoded in
+* 		parallel. Tiled values are compressed with one tile per
+* 		block. Objects written with compression can not be read by
+* 		versions of WlzReadObj() which predate this function and
+* 		tiled values read from them can not be memory mapped.
+* \param    	fP			File pointer for output.
+* \param    	obj			Ptr to top-level object to be written.
+* \param	cmp			Compression method, WLZ_IOCMP_NONE
+* 					for no compression.
+*/
+WlzErrorNum	WlzWriteObjCmp(FILE *fP, WlzObject *obj, WlzIOCompression cmp)
 {
   WlzErrorNum	errNum = WLZ_ERR_NONE;
 
@@ -383,11 +447,11 @@ WlzErrorNum	WlzWriteObj(FILE *fP, WlzObject *obj)
 	  if((obj->values.core == NULL) ||
 	     (WlzGreyTableIsTiled(obj->values.core->type) == 0))
 	  {
-	    errNum = WlzWriteValueTable(fP, obj);
+	    errNum = WlzWriteValueTableCmp(fP, obj, cmp);
 	  }
 	  else
 	  {
-	    errNum = WlzWriteTiledValueTable(fP, obj, 1);
+	    errNum = WlzWriteTiledValueTable(fP, obj, 1, cmp);
 	  }
 	}
 	if(errNum == WLZ_ERR_NONE)
@@ -402,11 +466,11 @@ WlzErrorNum	WlzWriteObj(FILE *fP, WlzObject *obj)
 	  if((obj->values.core == NULL) ||
 	     (WlzGreyTableIsTiled(obj->values.core->type) == 0))
 	  {
-	    errNum = WlzWriteVoxelValueTable(fP, obj);
+	    errNum = WlzWriteVoxelValueTable(fP, obj, cmp);
 	  }
 	  else
 	  {
-	    errNum = WlzWriteTiledValueTable(fP, obj, 1);
+	    errNum = WlzWriteTiledValueTable(fP, obj, 1, cmp);
 	  }
 	}
 	if(errNum == WLZ_ERR_NONE)
@@ -417,7 +481,8 @@ WlzErrorNum	WlzWriteObj(FILE *fP, WlzObject *obj)
       case WLZ_TRANS_OBJ:
 	if(((errNum = WlzWriteAffineTransform(fP,
 				obj->domain.t)) == WLZ_ERR_NONE) &&
-	   ((errNum = WlzWriteObj(fP, obj->values.obj)) == WLZ_ERR_NONE))
+	   ((errNum = WlzWriteObjCmp(fP, obj->values.obj,
+	                             cmp)) == WLZ_ERR_NONE))
 	{
 	  errNum = WlzWritePropertyList(fP, obj->plist);
 	}
@@ -482,7 +547,7 @@ WlzErrorNum	WlzWriteObj(FILE *fP, WlzObject *obj)
 	break;
       case WLZ_COMPOUND_ARR_1: /* FALLTHROUGH */
       case WLZ_COMPOUND_ARR_2:
-	errNum = WlzWriteCompoundA(fP, (WlzCompoundArray *)obj);
+	errNum = WlzWriteCompoundA(fP, (WlzCompoundArray *)obj, cmp);
 	break;
       case WLZ_PROPERTY_OBJ:
 	errNum = WlzWritePropertyList(fP, obj->plist);
@@ -503,6 +568,9 @@ WlzErrorNum	WlzWriteObj(FILE *fP, WlzObject *obj)
       case WLZ_MESH_TRANS:
 	errNum = WlzWriteMeshTransform2D(fP, obj->domain.mt);
 	break;
+      case WLZ_DISP_TRANS:
+	errNum = WlzWriteDispFieldTransform(fP, obj->domain.df, cmp);
+	break;
       case WLZ_LUT:
         if(((errNum = WlzWriteLUTDomain(fP, 
 	                                obj->domain.lut)) == WLZ_ERR_NONE) &&
@@ -533,6 +601,447 @@ WlzErrorNum	WlzWriteObj(FILE *fP, WlzObject *obj)
   return(errNum);
 }
 
+/*!
+* \return	New plane stream or NULL on error.
+* \ingroup	WlzIO
+* \brief	Opens a plane stream for writing a 3D domain object to the
+* 		given file one plane at a time. Planes are written to
+* 		the stream in order using WlzPlaneStreamWritePlane() and
+* 		the object is completed using WlzPlaneStreamWriteClose().
+* 		If the last plane is known and the output file is
+* 		seekable then the object's header is written when the
+* 		stream is opened, the plane domains are written directly
+* 		to the output file and only the plane values are spooled
+* 		(because in the file format all the plane domains precede
+* 		all the plane values). On closing the values are copied
+* 		from the spool file and the bounding box in the header is
+* 		set by seeking back to it, so a seekable output file must
+* 		not have been opened for appending. Otherwise both the
+* 		domains and values are spooled and the output file may
+* 		be a pipe.
+* 		Only the offsets of the planes in the spool file are kept
+* 		in memory and the spool file must be seekable.
+* 		The stream should be freed using WlzPlaneStreamFree().
+* \param	fP			Output file.
+* \param	spool			Spool file opened for both writing
+* 					and reading, if NULL a temporary
+* 					file is created and removed when
+* 					the stream is freed.
+* \param	plane1			Coordinate of the first plane.
+* \param	lastpl			Coordinate of the last plane, if less
+* 					than the first plane the number of
+* 					planes is not known.
+* \param	voxSz			Voxel size.
+* \param	cmp			Compression method for the values.
+* \param	dstErr			Destination error pointer, may be NULL.
+*/
+WlzPlaneStream	*WlzPlaneStreamWriteOpen(FILE *fP, FILE *spool, int plane1,
+					 int lastpl, WlzDVertex3 voxSz,
+					 WlzIOCompression cmp,
+					 WlzErrorNum *dstErr)
+{
+  int		idP;
+  WlzPlaneStream *pS = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(fP == NULL)
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if((pS = (WlzPlaneStream *)
+                AlcCalloc(1, sizeof(WlzPlaneStream))) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    pS->flags = WLZ_IOFLAGS_WRITE;
+    pS->fP = fP;
+    pS->plane1 = pS->plane = plane1;
+    pS->lastpl = plane1 - 1;
+    pS->endpl = (lastpl < plane1)? plane1 - 1: lastpl;
+    pS->hdrOff = -1;
+    pS->voxelSz[0] = (float )(voxSz.vtX);
+    pS->voxelSz[1] = (float )(voxSz.vtY);
+    pS->voxelSz[2] = (float )(voxSz.vtZ);
+    pS->values = -1;
+    pS->cmp = cmp;
+    if((pS->spool = spool) == NULL)
+    {
+      pS->ownSpool = 1;
+      if((pS->spool = tmpfile()) == NULL)
+      {
+        errNum = WLZ_ERR_WRITE_EOF;
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    pS->maxOff = 1024;
+    if(((pS->off = (long *)AlcMalloc(pS->maxOff * sizeof(long))) == NULL))
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    else if((pS->off[0] = ftell(pS->spool)) < 0)
+    {
+      errNum = WLZ_ERR_WRITE_INCOMPLETE;
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (pS->endpl >= pS->plane1) &&
+     (ftell(fP) >= 0))
+  {
+    /* Object type and plane domain header with the bounding box set
+     * when the stream is closed. */
+    if((putc((unsigned int )WLZ_3D_DOMAINOBJ, fP) == EOF) ||
+       (putc((unsigned int )WLZ_PLANEDOMAIN_DOMAIN, fP) == EOF) ||
+       !putword(pS->plane1, fP) ||
+       !putword(pS->endpl, fP) ||
+       ((pS->hdrOff = ftell(fP)) < 0) ||
+       !putword(0, fP) || !putword(0, fP) ||
+       !putword(0, fP) || !putword(0, fP) ||
+       !putfloat(pS->voxelSz[0], fP) ||
+       !putfloat(pS->voxelSz[1], fP) ||
+       !putfloat(pS->voxelSz[2], fP))
+    {
+      errNum = WLZ_ERR_WRITE_INCOMPLETE;
+    }
+    for(idP = pS->plane1; (errNum == WLZ_ERR_NONE) && (idP <= pS->endpl);
+        ++idP)
+    {
+      if(!putfloat(0.0, fP))
+      {
+	errNum = WLZ_ERR_WRITE_INCOMPLETE;
+      }
+    }
+  }
+  if((errNum != WLZ_ERR_NONE) && (pS != NULL))
+  {
+    (void )WlzPlaneStreamFree(pS);
+    pS = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(pS);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Writes the next plane of a plane stream which was opened
+* 		using WlzPlaneStreamWriteOpen(). The plane's domain is
+* 		written to the output file (or, if the header has not
+* 		been written, to the spool file) and its values are
+* 		written to the spool file. The plane's bounding box is
+* 		used to update that of the 3D object. Either all or none
+* 		of the non-empty planes must have (non-tiled) values.
+* \param	pS			Given plane stream.
+* \param	obj			2D domain object for the plane, may
+* 					be NULL or an empty object for an
+* 					empty plane.
+*/
+WlzErrorNum	WlzPlaneStreamWritePlane(WlzPlaneStream *pS, WlzObject *obj)
+{
+  int		idO;
+  WlzObject	tObj;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(pS == NULL)
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if(pS->flags != WLZ_IOFLAGS_WRITE)
+  {
+    errNum = WLZ_ERR_PARAM_TYPE;
+  }
+  else if((pS->endpl >= pS->plane1) && (pS->plane > pS->endpl))
+  {
+    errNum = WLZ_ERR_PLANE_DATA;
+  }
+  else if((obj != NULL) && (obj->type != WLZ_EMPTY_OBJ))
+  {
+    if(obj->type != WLZ_2D_DOMAINOBJ)
+    {
+      errNum = WLZ_ERR_OBJECT_TYPE;
+    }
+    else if(obj->domain.core == NULL)
+    {
+      errNum = WLZ_ERR_DOMAIN_NULL;
+    }
+    else if((obj->values.core != NULL) &&
+            WlzGreyTableIsTiled(obj->values.core->type))
+    {
+      errNum = WLZ_ERR_VALUES_TYPE;
+    }
+    else if((pS->values >= 0) && (pS->values != (obj->values.core != NULL)))
+    {
+      errNum = (pS->values)? WLZ_ERR_VALUES_NULL: WLZ_ERR_VALUES_TYPE;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    idO = 2 * (pS->plane - pS->plane1);
+    if(idO + 3 > pS->maxOff)
+    {
+      pS->maxOff *= 2;
+      if((pS->off = (long *)AlcRealloc(pS->off,
+                                       pS->maxOff * sizeof(long))) == NULL)
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    tObj.type = WLZ_2D_DOMAINOBJ;
+    tObj.linkcount = 0;
+    tObj.domain.core = NULL;
+    tObj.values.core = NULL;
+    tObj.plist = NULL;
+    tObj.assoc = NULL;
+    if((obj != NULL) && (obj->type == WLZ_2D_DOMAINOBJ))
+    {
+      WlzIntervalDomain *iDom;
+
+      tObj.domain = obj->domain;
+      tObj.values = obj->values;
+      iDom = obj->domain.i;
+      if(pS->lastpl < pS->plane1)
+      {
+        pS->line1 = iDom->line1;
+        pS->lastln = iDom->lastln;
+        pS->kol1 = iDom->kol1;
+        pS->lastkl = iDom->lastkl;
+      }
+      else
+      {
+        pS->line1 = WLZ_MIN(pS->line1, iDom->line1);
+        pS->lastln = WLZ_MAX(pS->lastln, iDom->lastln);
+        pS->kol1 = WLZ_MIN(pS->kol1, iDom->kol1);
+        pS->lastkl = WLZ_MAX(pS->lastkl, iDom->lastkl);
+      }
+      pS->lastpl = pS->plane;
+      if(pS->values < 0)
+      {
+        pS->values = obj->values.core != NULL;
+	if(pS->values)
+	{
+	  WlzPixelV	bgdV;
+
+	  bgdV = WlzGetBackground(obj, &errNum);
+	  if((errNum != WLZ_ERR_NONE) ||
+	     (WlzValueConvertPixel(&bgdV, bgdV,
+	                           WLZ_GREY_INT) != WLZ_ERR_NONE))
+	  {
+	    bgdV.v.inv = 0;
+	  }
+	  pS->bckgrnd = bgdV.v.inv;
+	  errNum = WLZ_ERR_NONE;
+	}
+      }
+    }
+    errNum = WlzWriteIntervalDomain((pS->hdrOff < 0)? pS->spool: pS->fP,
+    				    tObj.domain.i);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((pS->off[idO + 1] = ftell(pS->spool)) < 0)
+    {
+      errNum = WLZ_ERR_WRITE_INCOMPLETE;
+    }
+    else
+    {
+      errNum = WlzWriteValueTableCmp(pS->spool, &tObj, pS->cmp);
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((pS->off[idO + 2] = ftell(pS->spool)) < 0)
+    {
+      errNum = WLZ_ERR_WRITE_INCOMPLETE;
+    }
+    else
+    {
+      ++(pS->plane);
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Completes a plane stream which was opened using
+* 		WlzPlaneStreamWriteOpen() by writing the rest of the 3D
+* 		domain object to the output file. Any planes which have
+* 		not been written up to the last plane given when the
+* 		stream was opened are written as empty planes. If the
+* 		header has not yet been written then the header and the
+* 		plane domains are written, with the domains copied from
+* 		the spool file. The plane values are then copied from the
+* 		spool file and followed by the stream's property list.
+* 		If the header was written when the stream was opened,
+* 		its bounding box is then set by seeking back to it.
+* 		If no planes were written then an empty object is
+* 		written. The stream must still be freed using
+* 		WlzPlaneStreamFree().
+* \param	pS			Given plane stream.
+*/
+WlzErrorNum	WlzPlaneStreamWriteClose(WlzPlaneStream *pS)
+{
+  int		idP,
+  		nPl = 0;
+  long		endOff;
+  FILE		*fP;
+  char		*buf = NULL;
+  const size_t	bufSz = 1 << 16;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(pS == NULL)
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if(pS->flags != WLZ_IOFLAGS_WRITE)
+  {
+    errNum = WLZ_ERR_PARAM_TYPE;
+  }
+  else if((buf = (char *)AlcMalloc(bufSz)) == NULL)
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  else
+  {
+    fP = pS->fP;
+    while((errNum == WLZ_ERR_NONE) && (pS->plane <= pS->endpl))
+    {
+      errNum = WlzPlaneStreamWritePlane(pS, NULL);
+    }
+    nPl = pS->plane - pS->plane1;
+    if((errNum == WLZ_ERR_NONE) && (fflush(pS->spool) != 0))
+    {
+      errNum = WLZ_ERR_WRITE_INCOMPLETE;
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (nPl == 0))
+  {
+    if(putc((unsigned int )WLZ_EMPTY_OBJ, fP) == EOF)
+    {
+      errNum = WLZ_ERR_WRITE_EOF;
+    }
+  }
+  else if(errNum == WLZ_ERR_NONE)
+  {
+    if(pS->hdrOff < 0)
+    {
+      /* Object type and plane domain header. */
+      if((putc((unsigned int )WLZ_3D_DOMAINOBJ, fP) == EOF) ||
+	 (putc((unsigned int )WLZ_PLANEDOMAIN_DOMAIN, fP) == EOF) ||
+	 !putword(pS->plane1, fP) ||
+	 !putword(pS->plane1 + nPl - 1, fP) ||
+	 !putword(pS->line1, fP) ||
+	 !putword(pS->lastln, fP) ||
+	 !putword(pS->kol1, fP) ||
+	 !putword(pS->lastkl, fP) ||
+	 !putfloat(pS->voxelSz[0], fP) ||
+	 !putfloat(pS->voxelSz[1], fP) ||
+	 !putfloat(pS->voxelSz[2], fP))
+      {
+	errNum = WLZ_ERR_WRITE_INCOMPLETE;
+      }
+      for(idP = 0; (errNum == WLZ_ERR_NONE) && (idP < nPl); ++idP)
+      {
+	if(!putfloat(0.0, fP))
+	{
+	  errNum = WLZ_ERR_WRITE_INCOMPLETE;
+	}
+      }
+      /* Plane domains. */
+      for(idP = 0; (errNum == WLZ_ERR_NONE) && (idP < nPl); ++idP)
+      {
+	errNum = WlzPlaneStreamCopy(fP, pS->spool, pS->off[2 * idP],
+				    pS->off[(2 * idP) + 1], buf, bufSz);
+      }
+    }
+    /* Plane values if the object has values. */
+    if(errNum == WLZ_ERR_NONE)
+    {
+      if(pS->values > 0)
+      {
+	if((putc((unsigned int )WLZ_VOXELVALUETABLE_GREY, fP) == EOF) ||
+	   !putword(pS->bckgrnd, fP))
+	{
+	  errNum = WLZ_ERR_WRITE_INCOMPLETE;
+	}
+	for(idP = 0; (errNum == WLZ_ERR_NONE) && (idP < nPl); ++idP)
+	{
+	  errNum = WlzPlaneStreamCopy(fP, pS->spool, pS->off[(2 * idP) + 1],
+				      pS->off[(2 * idP) + 2], buf, bufSz);
+	}
+      }
+      else if(putc(0, fP) == EOF)
+      {
+	errNum = WLZ_ERR_WRITE_EOF;
+      }
+    }
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = WlzWritePropertyList(fP, pS->plist);
+    }
+    if((errNum == WLZ_ERR_NONE) && (pS->hdrOff >= 0))
+    {
+      /* Set the bounding box in the header. */
+      if(((endOff = ftell(fP)) < 0) ||
+         (fseek(fP, pS->hdrOff, SEEK_SET) != 0) ||
+	 !putword(pS->line1, fP) ||
+	 !putword(pS->lastln, fP) ||
+	 !putword(pS->kol1, fP) ||
+	 !putword(pS->lastkl, fP) ||
+         (fseek(fP, endOff, SEEK_SET) != 0))
+      {
+	errNum = WLZ_ERR_WRITE_INCOMPLETE;
+      }
+    }
+  }
+  AlcFree(buf);
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Copies the bytes in the given range of the source file
+* 		to the destination file.
+* \param	dP			Destination file.
+* \param	sP			Source file.
+* \param	off0			Offset of first byte to copy.
+* \param	off1			Offset one past the last byte to copy.
+* \param	buf			Buffer for copying.
+* \param	bufSz			Size of the buffer.
+*/
+static WlzErrorNum WlzPlaneStreamCopy(FILE *dP, FILE *sP,
+				      long off0, long off1,
+				      char *buf, size_t bufSz)
+{
+  size_t	n;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(fseek(sP, off0, SEEK_SET) != 0)
+  {
+    errNum = WLZ_ERR_WRITE_INCOMPLETE;
+  }
+  while((errNum == WLZ_ERR_NONE) && (off0 < off1))
+  {
+    n = (size_t )WLZ_MIN((long )bufSz, off1 - off0);
+    if((fread(buf, 1, n, sP) != n) || (fwrite(buf, 1, n, dP) != n))
+    {
+      errNum = WLZ_ERR_WRITE_INCOMPLETE;
+    }
+    off0 += n;
+  }
+  return(errNum);
+}
+
 /*!
 * \return	Woolz error code.
 * \ingroup	WlzIO
@@ -1666,14 +2175,371 @@ static WlzErrorNum WlzWriteValueTable(FILE *fP, WlzObject *obj)
   return(errNum);
 }
 
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Writes the 2D values of a Woolz 2D domain object to the
+* 		given file, compressing them unless the compression method
+* 		is WLZ_IOCMP_NONE or the object has no values. A compressed
+* 		value table is written as WLZ_IOCMP_MARKER followed by a
+* 		compressed value stream (see WlzValueCmpStreamOpen())
+* 		which holds the value table as it would have been written
+* 		by WlzWriteValueTable().
+* \param	fP			Given file.
+* \param	obj			Object containing values that
+*					are to be written to file.
+* \param	cmp			Compression method.
+*/
+static WlzErrorNum WlzWriteValueTableCmp(FILE *fP, WlzObject *obj,
+				         WlzIOCompression cmp)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((cmp == WLZ_IOCMP_NONE) || (obj->values.core == NULL))
+  {
+    errNum = WlzWriteValueTable(fP, obj);
+  }
+  else if(putc((unsigned int )WLZ_IOCMP_MARKER, fP) == EOF)
+  {
+    errNum = WLZ_ERR_WRITE_EOF;
+  }
+  else
+  {
+    (void )WlzWriteValueTableCmpStr(fP, obj, cmp, NULL, &errNum);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Memory buffer holding the compressed value stream if the
+* 		given file is NULL, otherwise NULL. A memory buffer should
+* 		be freed using AlcFree().
+* \ingroup	WlzIO
+* \brief	Writes the 2D values of a Woolz 2D domain object, exactly
+* 		as they would be written by WlzWriteValueTable(), to a
+* 		compressed value stream. The grey type, packing and
+* 		background are stored uncompressed and the filter used
+* 		for the values is chosen using the packing. The values
+* 		are compressed and written block by block as they are
+* 		scanned.
+* \param	fP			Given file or NULL to write to
+* 					a memory buffer.
+* \param	obj			Object with non-NULL values.
+* \param	cmp			Compression method.
+* \param	dstSz			Destination pointer for the size of
+* 					a memory buffer, may be NULL if the
+* 					given file is not NULL.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzUByte	*WlzWriteValueTableCmpStr(FILE *fP, WlzObject *obj,
+					  WlzIOCompression cmp,
+					  size_t *dstSz,
+					  WlzErrorNum *dstErr)
+{
+  int		eSz = 1,
+  		delta = 0;
+  size_t	hdrSz = 6;
+  WlzGreyType	gType = WLZ_GREY_ERROR,
+  		packing = WLZ_GREY_ERROR;
+  WlzPixelV	background;
+  WlzGreyV	in,
+  		out;
+  WlzUByte	*buf = NULL;
+  WlzValueCmpStream *str = NULL;
+  WlzUByte	hdr[10],
+  		lnBuf[WLZ_WRITEOBJ_CMP_LNSZ];
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  gType = WlzGreyTableTypeToGreyType(obj->values.core->type, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    background = WlzGetBackground(obj, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    packing = WlzWriteValuePacking(obj, gType, &errNum);
+  }
+  /* Grey type, packing and background in file byte order. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    hdr[0] = (WlzUByte )gType;
+    hdr[1] = (WlzUByte )packing;
+    switch(gType)
+    {
+      case WLZ_GREY_INT:
+	in.inv = background.v.inv;
+	break;
+      case WLZ_GREY_SHORT:
+	in.inv = background.v.shv;
+	break;
+      case WLZ_GREY_UBYTE:
+	in.inv = background.v.ubv;
+	break;
+      case WLZ_GREY_RGBA:
+	in.inv = background.v.rgbv;
+	break;
+      default:
+	break;
+    }
+    switch(gType)
+    {
+      case WLZ_GREY_FLOAT:
+	in.flv = background.v.flv;
+	WLZ_SWAP_OUT_FLOAT(out, in);
+	(void )memcpy(hdr + 2, out.ubytes, 4);
+	break;
+      case WLZ_GREY_DOUBLE:
+	in.dbv = background.v.dbv;
+	WLZ_SWAP_OUT_DOUBLE(out, in);
+	(void )memcpy(hdr + 2, out.ubytes, 8);
+	hdrSz = 10;
+	break;
+      default:
+	WLZ_SWAP_OUT_WORD(out, in);
+	(void )memcpy(hdr + 2, out.ubytes, 4);
+	break;
+    }
+    switch(packing)
+    {
+      case WLZ_GREY_INT:
+	eSz = 4;
+	delta = 1;
+	break;
+      case WLZ_GREY_SHORT:
+	eSz = 2;
+	delta = 1;
+	break;
+      case WLZ_GREY_UBYTE:
+	eSz = 1;
+	delta = 1;
+	break;
+      case WLZ_GREY_DOUBLE:
+	eSz = 8;
+	break;
+      default:
+	eSz = 4;
+	break;
+    }
+    str = WlzValueCmpStreamOpen(fP, cmp, eSz, delta, hdr, hdrSz, 0, &errNum);
+  }
+  /* Convert each interval to file byte order in line buffer sized
+   * chunks and give them to the stream. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		nLnBuf;
+    WlzIntervalWSpace iwsp;
+    WlzGreyWSpace gwsp;
+
+    nLnBuf = WLZ_WRITEOBJ_CMP_LNSZ / eSz;
+    if((errNum = WlzInitGreyScan(obj, &iwsp, &gwsp)) == WLZ_ERR_NONE)
+    {
+      while((errNum == WLZ_ERR_NONE) &&
+	    ((errNum = WlzNextGreyInterval(&iwsp)) == WLZ_ERR_NONE))
+      {
+	int	off;
+
+	for(off = 0; (errNum == WLZ_ERR_NONE) && (off < iwsp.colrmn);
+	    off += nLnBuf)
+	{
+	  size_t n;
+
+	  n = WlzWriteGreyBytes(lnBuf, gwsp.u_grintptr, off,
+	                        WLZ_MIN(nLnBuf, iwsp.colrmn - off),
+				gType, packing);
+	  errNum = WlzValueCmpStreamPut(str, lnBuf, n);
+	}
+      }
+      (void )WlzEndGreyScan(&iwsp, &gwsp);
+      if(errNum == WLZ_ERR_EOO)
+      {
+	errNum = WLZ_ERR_NONE;
+      }
+    }
+  }
+  if(str)
+  {
+    WlzErrorNum	errNum2;
+
+    buf = WlzValueCmpStreamClose(str, dstSz, &errNum2);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = errNum2;
+    }
+    else
+    {
+      AlcFree(buf);
+      buf = NULL;
+    }
+  }
+  *dstErr = errNum;
+  return(buf);
+}
+
+/*!
+* \return	Packing used for the values in the file.
+* \ingroup	WlzIO
+* \brief	Computes the packing used by WlzWriteValueTable() for the
+* 		values of a Woolz 2D domain object, this being the smallest
+* 		grey type that can hold the range of integer values.
+* \param	obj			Object with non-NULL values.
+* \param	gType			Grey type of the values.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzGreyType WlzWriteValuePacking(WlzObject *obj, WlzGreyType gType,
+				        WlzErrorNum *dstErr)
+{
+  WlzPixelV	min,
+  		max;
+  WlzGreyType	packing = WLZ_GREY_ERROR;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  switch(gType)
+  {
+    case WLZ_GREY_INT:
+      if((errNum = WlzGreyRange(obj, &min, &max)) == WLZ_ERR_NONE)
+      {
+	if((min.v.inv >= 0) && (max.v.inv <= 255))
+	{
+	  packing = WLZ_GREY_UBYTE;
+	}
+	else if((min.v.inv >= SHRT_MIN) && (max.v.inv <= SHRT_MAX))
+	{
+	  packing = WLZ_GREY_SHORT;
+	}
+	else
+	{
+	  packing = WLZ_GREY_INT;
+	}
+      }
+      break;
+    case WLZ_GREY_SHORT:
+      if((errNum = WlzGreyRange(obj, &min, &max)) == WLZ_ERR_NONE)
+      {
+	packing = ((min.v.shv >= 0) && (max.v.shv <= 255))?
+		  WLZ_GREY_UBYTE: WLZ_GREY_SHORT;
+      }
+      break;
+    case WLZ_GREY_UBYTE: /* FALLTHROUGH */
+    case WLZ_GREY_FLOAT: /* FALLTHROUGH */
+    case WLZ_GREY_DOUBLE: /* FALLTHROUGH */
+    case WLZ_GREY_RGBA:
+      packing = gType;
+      break;
+    default:
+      errNum = WLZ_ERR_GREY_TYPE;
+      break;
+  }
+  *dstErr = errNum;
+  return(packing);
+}
+
+/*!
+* \return	Number of bytes written to the destination.
+* \ingroup	WlzIO
+* \brief	Converts grey values to the packing and byte order used
+* 		by WlzWriteValueTable().
+* \param	dst			Destination for the bytes.
+* \param	g			Grey values.
+* \param	off			Offset of the first value.
+* \param	n			Number of values.
+* \param	gType			Grey type of the values.
+* \param	packing			Packing of the values, as given by
+* 					WlzWriteValuePacking().
+*/
+static size_t	WlzWriteGreyBytes(WlzUByte *dst, WlzGreyP g,
+				  int off, int n,
+				  WlzGreyType gType, WlzGreyType packing)
+{
+  int		i;
+  size_t	nB = 0;
+  WlzGreyV	in,
+  		out;
+
+  switch(packing)
+  {
+    case WLZ_GREY_INT:
+      for(i = 0; i < n; ++i)
+      {
+	in.inv = g.inp[off + i];
+	WLZ_SWAP_OUT_WORD(out, in);
+	(void )memcpy(dst + nB, out.ubytes, 4);
+	nB += 4;
+      }
+      break;
+    case WLZ_GREY_SHORT:
+      for(i = 0; i < n; ++i)
+      {
+	in.shv = (gType == WLZ_GREY_INT)? (short )(g.inp[off + i]):
+	                                  g.shp[off + i];
+	WLZ_SWAP_OUT_SHORT(out, in);
+	(void )memcpy(dst + nB, out.ubytes, 2);
+	nB += 2;
+      }
+      break;
+    case WLZ_GREY_UBYTE:
+      for(i = 0; i < n; ++i)
+      {
+	switch(gType)
+	{
+	  case WLZ_GREY_INT:
+	    dst[i] = (WlzUByte )(g.inp[off + i]);
+	    break;
+	  case WLZ_GREY_SHORT:
+	    dst[i] = (WlzUByte )(g.shp[off + i]);
+	    break;
+	  default:
+	    dst[i] = g.ubp[off + i];
+	    break;
+	}
+      }
+      nB = n;
+      break;
+    case WLZ_GREY_FLOAT:
+      for(i = 0; i < n; ++i)
+      {
+	in.flv = g.flp[off + i];
+	WLZ_SWAP_OUT_FLOAT(out, in);
+	(void )memcpy(dst + nB, out.ubytes, 4);
+	nB += 4;
+      }
+      break;
+    case WLZ_GREY_DOUBLE:
+      for(i = 0; i < n; ++i)
+      {
+	in.dbv = g.dbp[off + i];
+	WLZ_SWAP_OUT_DOUBLE(out, in);
+	(void )memcpy(dst + nB, out.ubytes, 8);
+	nB += 8;
+      }
+      break;
+    case WLZ_GREY_RGBA:
+      for(i = 0; i < n; ++i)
+      {
+	in.inv = g.rgbp[off + i];
+	WLZ_SWAP_OUT_WORD(out, in);
+	(void )memcpy(dst + nB, out.ubytes, 4);
+	nB += 4;
+      }
+      break;
+    default:
+      break;
+  }
+  return(nB);
+}
+
 /*!
 * \return	Woolz error code.
 * \ingroup	WlzIO
 * \brief	Writes the voxel values of a Woolz object to the given file.
+* 		If the values are to be compressed then the planes are
+* 		compressed in parallel to memory (in batches to bound the
+* 		memory used) and then written in order.
 * \param	fP			Given file.
 * \param	obj			Object with values.
+* \param	cmp			Compression method.
 */
-static WlzErrorNum WlzWriteVoxelValueTable(FILE *fP, WlzObject *obj)
+static WlzErrorNum WlzWriteVoxelValueTable(FILE *fP, WlzObject *obj,
+					   WlzIOCompression cmp)
 {
   int			i, nplanes;
   WlzObject		tempobj;
@@ -1715,12 +2581,79 @@ static WlzErrorNum WlzWriteVoxelValueTable(FILE *fP, WlzObject *obj)
 	  tempobj.linkcount = 0;
 	  tempobj.plist = NULL;
 	  tempobj.assoc = NULL;
-	  for(i=0; (i < nplanes) && (errNum == WLZ_ERR_NONE);
-	      i++, domains++, values++)
+	  if(cmp == WLZ_IOCMP_NONE)
 	  {
-	    tempobj.domain.i = (*domains).i;
-	    tempobj.values.v = (*values).v;
-	    errNum = WlzWriteValueTable(fP, &tempobj);
+	    for(i=0; (i < nplanes) && (errNum == WLZ_ERR_NONE);
+		i++, domains++, values++)
+	    {
+	      tempobj.domain.i = (*domains).i;
+	      tempobj.values.v = (*values).v;
+	      errNum = WlzWriteValueTable(fP, &tempobj);
+	    }
+	  }
+	  else
+	  {
+	    int		p0;
+	    size_t	bufSz[WLZ_WRITEOBJ_CMP_BATCH];
+	    WlzUByte	*buf[WLZ_WRITEOBJ_CMP_BATCH];
+
+	    for(p0 = 0; (p0 < nplanes) && (errNum == WLZ_ERR_NONE);
+	        p0 += WLZ_WRITEOBJ_CMP_BATCH)
+	    {
+	      int	nB;
+
+	      nB = WLZ_MIN(WLZ_WRITEOBJ_CMP_BATCH, nplanes - p0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+	      for(i = 0; i < nB; ++i)
+	      {
+		WlzObject	pObj;
+		WlzErrorNum	errNum2 = WLZ_ERR_NONE;
+
+		buf[i] = NULL;
+		bufSz[i] = 0;
+		pObj = tempobj;
+		pObj.domain.i = domains[p0 + i].i;
+		pObj.values.v = values[p0 + i].v;
+		if(pObj.values.core != NULL)
+		{
+		  buf[i] = WlzWriteValueTableCmpStr(NULL, &pObj, cmp,
+		  				    &(bufSz[i]), &errNum2);
+		  if(errNum2 != WLZ_ERR_NONE)
+		  {
+#ifdef _OPENMP
+#pragma omp critical (WlzWriteVoxelValueTable)
+#endif
+		    {
+		      errNum = errNum2;
+		    }
+		  }
+		}
+	      }
+	      for(i = 0; (i < nB) && (errNum == WLZ_ERR_NONE); ++i)
+	      {
+	        if(buf[i] == NULL)
+		{
+		  if(putc(0, fP) == EOF)
+		  {
+		    errNum = WLZ_ERR_WRITE_EOF;
+		  }
+		}
+		else if(putc((unsigned int )WLZ_IOCMP_MARKER, fP) == EOF)
+		{
+		  errNum = WLZ_ERR_WRITE_EOF;
+		}
+		else if(fwrite(buf[i], 1, bufSz[i], fP) != bufSz[i])
+		{
+		  errNum = WLZ_ERR_WRITE_INCOMPLETE;
+		}
+	      }
+	      for(i = 0; i < nB; ++i)
+	      {
+	        AlcFree(buf[i]);
+	      }
+	    }
 	  }
 	  break;
 	default:
@@ -2003,8 +2936,10 @@ static WlzErrorNum WlzWriteHistogramDomain(FILE *fP, WlzHistogramDomain *hist)
 * \brief	Writes a compound array object to the given file.
 * \param	fP			Given file.
 * \param	c			Compound array object.
+* \param	cmp			Compression method for grey values.
 */
-static WlzErrorNum WlzWriteCompoundA(FILE *fP, WlzCompoundArray *c)
+static WlzErrorNum WlzWriteCompoundA(FILE *fP, WlzCompoundArray *c,
+				     WlzIOCompression cmp)
 {
   int 		i;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
@@ -2028,7 +2963,7 @@ static WlzErrorNum WlzWriteCompoundA(FILE *fP, WlzCompoundArray *c)
       }
       else
       {
-	errNum = WlzWriteObj(fP, c->o[i]);
+	errNum = WlzWriteObjCmp(fP, c->o[i], cmp);
       }
     }
   }
@@ -2083,6 +3018,40 @@ static WlzErrorNum WlzWriteAffineTransform(FILE *fP, WlzAffineTransform *trans)
   return(errNum);
 }
 
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzIO
+* \brief	Writes a displacement field transform to the given file.
+*		The transform type is written followed by the compound
+*		array object which holds the displacements.
+* \param	fP			Given file.
+* \param	dft			Displacement field transform.
+* \param	cmp			Compression method for grey values.
+*/
+static WlzErrorNum WlzWriteDispFieldTransform(FILE *fP,
+					WlzDispFieldTransform *dft,
+					WlzIOCompression cmp)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(dft == NULL)
+  {
+    if(putc((unsigned int )0, fP) == EOF)
+    {
+      errNum = WLZ_ERR_WRITE_EOF;
+    }
+  }
+  else if(putc((unsigned int )(dft->type), fP) == EOF)
+  {
+    errNum = WLZ_ERR_WRITE_EOF;
+  }
+  else
+  {
+    errNum = WlzWriteObjCmp(fP, (WlzObject *)(dft->field), cmp);
+  }
+  return(errNum);
+}
+
 /*!
 * \return	Woolz error code.
 * \ingroup	WlzIO
@@ -3329,17 +4298,35 @@ static WlzErrorNum WlzWriteIndexedValues(FILE *fP, WlzObject *obj)
 * 					that's to be written to the file.
 * \param	writeTiles		Write tiles even if no tiles are
 * 					allocated for the valuetable.
+* \param	cmp			Compression method for the tiles,
+* 					which is only used if the tiles are
+* 					allocated. Compressed tiles are
+* 					marked by setting bit 7 of the
+* 					dimension and are written with one
+* 					tile per block in place of the tile
+* 					offset and aligned tiles.
 */
 static WlzErrorNum WlzWriteTiledValueTable(FILE *fP, WlzObject *obj,
-					   int writeTiles)
+					   int writeTiles,
+					   WlzIOCompression cmp)
 {
-  long		tMrk;
+  long		tMrk = 0;
   WlzGreyType   gType;
   WlzTiledValues *tVal = NULL;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
 
   tVal = obj->values.t;
   gType = WlzGreyTableTypeToGreyType(tVal->type, &errNum);
+  if(tVal->tiles.v == NULL)
+  {
+    cmp = WLZ_IOCMP_NONE;
+  }
+  else if(errNum == WLZ_ERR_NONE)
+  {
+    /* All the tiles are written so any that were read compressed and
+     * not yet accessed must be decoded. */
+    errNum = WlzTiledValuesDecode(tVal);
+  }
   if(errNum == WLZ_ERR_NONE)
   {
     if(putc((unsigned int )(tVal->type), fP) == EOF)
@@ -3349,7 +4336,7 @@ static WlzErrorNum WlzWriteTiledValueTable(FILE *fP, WlzObject *obj,
   }
   if(errNum == WLZ_ERR_NONE)
   {
-    putc(tVal->dim, fP);
+    putc(tVal->dim | ((cmp == WLZ_IOCMP_NONE)? 0: 0x80), fP);
     putword(tVal->kol1, fP);
     putword(tVal->lastkl, fP);
     putword(tVal->line1, fP);
@@ -3375,7 +4362,31 @@ static WlzErrorNum WlzWriteTiledValueTable(FILE *fP, WlzObject *obj,
     }
     errNum = WlzWriteInt(fP, (int *)(tVal->indices), nIdx);
   }
-  if(errNum == WLZ_ERR_NONE)
+  if((errNum == WLZ_ERR_NONE) && (cmp != WLZ_IOCMP_NONE))
+  {
+    int		delta;
+    size_t	gSz;
+    WlzValueCmpStream *str;
+
+    gSz = WlzGreySize(gType);
+    delta = (gType == WLZ_GREY_INT) || (gType == WLZ_GREY_SHORT) ||
+            (gType == WLZ_GREY_UBYTE);
+    str = WlzValueCmpStreamOpen(fP, cmp, (int )gSz, delta, NULL, 0,
+    				tVal->tileSz * gSz, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      WlzErrorNum errNum2;
+
+      errNum = WlzValueCmpStreamPut(str, (WlzUByte *)(tVal->tiles.v),
+      				    tVal->numTiles * tVal->tileSz * gSz);
+      (void )WlzValueCmpStreamClose(str, NULL, &errNum2);
+      if(errNum == WLZ_ERR_NONE)
+      {
+        errNum = errNum2;
+      }
+    }
+  }
+  else if(errNum == WLZ_ERR_NONE)
   {
     long	blks;
     WlzLong     off[2];
@@ -3392,7 +4403,7 @@ static WlzErrorNum WlzWriteTiledValueTable(FILE *fP, WlzObject *obj,
       errNum = WLZ_ERR_WRITE_INCOMPLETE;
     }
   }
-  if(errNum == WLZ_ERR_NONE)
+  if((errNum == WLZ_ERR_NONE) && (cmp == WLZ_IOCMP_NONE))
   {
     size_t      gSz,
     		tSz;
@@ -0,0 +1,636 @@
+#if defined(__GNUC__)
+#ident "University of Edinburgh $Id$"
+#else
+static char _WlzZonalStats_c[] = "University of Edinburgh $Id$";
+#endif
+/*!
+* \file         libWlz/WlzZonalStats.c
+* \author       Bill Hill
+* \date         October 2026
+* \version      $Id$
+* \par
+* Address:
+*               MRC Human Genetics Unit,
+*               MRC Institute of Genetics and Molecular Medicine,
+*               University of Edinburgh,
+*               Western General Hospital,
+*               Edinburgh, EH4 2XU, UK.
+* \par
+* Copyright (C), [2012],
+* The University Court of the University of Edinburgh,
+* Old College, Edinburgh, UK.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be
+* useful but WITHOUT ANY WARRANTY; without even the implied
+* warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public
+* License along with this program; if not, write to the Free
+* Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+* Boston, MA  02110-1301, USA.
+* \brief	Computes grey value statistics for each of the zones
+* 		(labels) of an index object in a single scan.
+* \ingroup	WlzFeatures
+*/
+
+#include <stdlib.h>
+#include <float.h>
+#include <Wlz.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+static WlzZonalStats		*WlzZonalStatsMake(
+				  int nZone,
+				  int nBin,
+				  double binOrg,
+				  double binWidth,
+				  WlzErrorNum *dstErr);
+static void			WlzZonalStatsMerge(
+				  WlzZonalStats *zs,
+				  WlzZonalStats *tZs);
+static WlzValues		WlzZonalStatsPlaneValues(
+				  WlzObject *obj,
+				  int pl);
+static WlzErrorNum		WlzZonalStatsItem(
+				  WlzZonalStats *zs,
+				  WlzObject *gObj,
+				  WlzObject *lObj,
+				  WlzObject *iObj,
+				  int item,
+				  int nItem);
+static WlzErrorNum		WlzZonalStats2D(
+				  WlzZonalStats *zs,
+				  WlzDomain dom,
+				  WlzValues gVal,
+				  WlzValues lVal,
+				  int pln);
+
+/*!
+* \return	New zonal statistics or NULL on error.
+* \ingroup	WlzFeatures
+* \brief	Computes grey value statistics of the given grey object
+* 		for each of the zones of the given index (label) object.
+* 		The zone of each pixel/voxel is given by the value of the
+* 		index object at that pixel/voxel, so a single scan of
+* 		the intersection of the two objects' domains computes
+* 		the count, sum, sum of squares, minimum, maximum and
+* 		optionally a histogram of the grey values of every zone.
+* 		This avoids splitting the index object into a compound
+* 		array (see WlzIndexObjToCompound()) and then computing
+* 		statistics for each of its objects in turn.
+* 		The scan is parallel, by plane for 3D objects and by
+* 		bands of lines for 2D objects, with each thread keeping
+* 		its own statistics which are merged at the end.
+* 		RGBA grey values are treated as in WlzGreyStats(), using
+* 		their modulus. Grey values outside of the histogram range
+* 		are counted in the first or last bin.
+* \param	gObj			Given 2 or 3D object with grey values.
+* \param	lObj			Index object with the same dimension
+* 					as the grey object and with grey
+* 					values of type WLZ_GREY_UBYTE,
+* 					WLZ_GREY_SHORT or WLZ_GREY_INT.
+* 					Pixels/voxels with negative index
+* 					values or values not less than the
+* 					number of zones are ignored.
+* \param	nZone			Number of zones, if not greater than
+* 					zero then the number of zones is
+* 					one more than the maximum value of
+* 					the index object.
+* \param	nBin			Number of histogram bins for each zone,
+* 					if zero no histograms are computed.
+* \param	binOrg			Grey value at the start of the first
+* 					histogram bin.
+* \param	binWidth		Width of the histogram bins.
+* \param	dstErr			Destination error pointer, may
+*                                       be NULL.
+*/
+WlzZonalStats	*WlzZonalGreyStats(WlzObject *gObj, WlzObject *lObj,
+				   int nZone, int nBin,
+				   double binOrg, double binWidth,
+				   WlzErrorNum *dstErr)
+{
+  int		nThr = 1,
+  		nItem = 0;
+  WlzObject	*iObj = NULL;
+  WlzZonalStats	*zs = NULL;
+  WlzZonalStats	**tZs = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((gObj == NULL) || (lObj == NULL))
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if(((gObj->type != WLZ_2D_DOMAINOBJ) &&
+           (gObj->type != WLZ_3D_DOMAINOBJ)) || (lObj->type != gObj->type))
+  {
+    errNum = WLZ_ERR_OBJECT_TYPE;
+  }
+  else if((gObj->domain.core == NULL) || (lObj->domain.core == NULL))
+  {
+    errNum = WLZ_ERR_DOMAIN_NULL;
+  }
+  else if((gObj->values.core == NULL) || (lObj->values.core == NULL))
+  {
+    errNum = WLZ_ERR_VALUES_NULL;
+  }
+  else if((nBin < 0) || ((nBin > 0) && !(binWidth > 0.0)))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    WlzGreyType	lGType;
+
+    lGType = WlzGreyTypeFromObj(lObj, &errNum);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      switch(lGType)
+      {
+	case WLZ_GREY_UBYTE: /* FALLTHROUGH */
+	case WLZ_GREY_SHORT: /* FALLTHROUGH */
+	case WLZ_GREY_INT:
+	  break;
+	default:
+	  errNum = WLZ_ERR_GREY_TYPE;
+	  break;
+      }
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (nZone <= 0))
+  {
+    WlzPixelV	minV,
+    		maxV;
+
+    errNum = WlzGreyRange(lObj, &minV, &maxV);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      WlzValueConvertPixel(&maxV, maxV, WLZ_GREY_INT);
+      nZone = (maxV.v.inv < 0)? 0: maxV.v.inv + 1;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    zs = WlzZonalStatsMake(nZone, nBin, binOrg, binWidth, &errNum);
+  }
+  /* Find the common domain and the work items, which are the planes for
+   * 3D objects or bands of lines for 2D objects. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+#ifdef _OPENMP
+#pragma omp parallel
+    {
+#pragma omp master
+      {
+        nThr = omp_get_num_threads();
+      }
+    }
+#endif
+    iObj = WlzAssignObject(WlzIntersect2(gObj, lObj, &errNum), NULL);
+  }
+  if((errNum == WLZ_ERR_NONE) && (iObj != NULL) &&
+     (iObj->type == gObj->type) && (nZone > 0))
+  {
+    if(iObj->type == WLZ_2D_DOMAINOBJ)
+    {
+      nItem = ALG_MIN(nThr, iObj->domain.i->lastln -
+                            iObj->domain.i->line1 + 1);
+    }
+    else
+    {
+      nItem = iObj->domain.p->lastpl - iObj->domain.p->plane1 + 1;
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (nItem > 0))
+  {
+    int		idT;
+
+    if((tZs = (WlzZonalStats **)
+              AlcCalloc(nThr, sizeof(WlzZonalStats *))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+    for(idT = 0; (errNum == WLZ_ERR_NONE) && (idT < nThr); ++idT)
+    {
+      tZs[idT] = WlzZonalStatsMake(nZone, nBin, binOrg, binWidth, &errNum);
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (nItem > 0))
+  {
+    int		idI;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(idI = 0; idI < nItem; ++idI)
+    {
+      if(errNum == WLZ_ERR_NONE)
+      {
+	int	thrId = 0;
+	WlzErrorNum errNum2;
+
+#ifdef _OPENMP
+	thrId = omp_get_thread_num();
+#endif
+	errNum2 = WlzZonalStatsItem(tZs[thrId], gObj, lObj, iObj,
+				    idI, nItem);
+	if(errNum2 != WLZ_ERR_NONE)
+	{
+#ifdef _OPENMP
+#pragma omp critical (WlzZonalGreyStats)
+#endif
+	  {
+	    errNum = errNum2;
+	  }
+	}
+      }
+    }
+  }
+  if(tZs)
+  {
+    int		idT;
+
+    for(idT = 0; idT < nThr; ++idT)
+    {
+      if(tZs[idT])
+      {
+	if(errNum == WLZ_ERR_NONE)
+	{
+	  WlzZonalStatsMerge(zs, tZs[idT]);
+	}
+	(void )WlzFreeZonalStats(tZs[idT]);
+      }
+    }
+    AlcFree(tZs);
+  }
+  (void )WlzFreeObj(iObj);
+  if(errNum != WLZ_ERR_NONE)
+  {
+    (void )WlzFreeZonalStats(zs);
+    zs = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(zs);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzFeatures
+* \brief	Frees zonal statistics.
+* \param	zs			Given zonal statistics.
+*/
+WlzErrorNum	WlzFreeZonalStats(WlzZonalStats *zs)
+{
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if(zs == NULL)
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else
+  {
+    AlcFree(zs->count);
+    AlcFree(zs->sum);
+    AlcFree(zs->sumSq);
+    AlcFree(zs->min);
+    AlcFree(zs->max);
+    AlcFree(zs->hist);
+    AlcFree(zs);
+  }
+  return(errNum);
+}
+
+/*!
+* \return	New zonal statistics with zero counts or NULL on error.
+* \ingroup	WlzFeatures
+* \brief	Allocates zonal statistics.
+* \param	nZone			Number of zones.
+* \param	nBin			Number of histogram bins per zone.
+* \param	binOrg			Grey value at the start of the first
+* 					histogram bin.
+* \param	binWidth		Width of the histogram bins.
+* \param	dstErr			Destination error pointer.
+*/
+static WlzZonalStats *WlzZonalStatsMake(int nZone, int nBin,
+				        double binOrg, double binWidth,
+				        WlzErrorNum *dstErr)
+{
+  size_t	nZ;
+  WlzZonalStats	*zs;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  nZ = (size_t )nZone + 1;
+  if(((zs = (WlzZonalStats *)AlcCalloc(1, sizeof(WlzZonalStats))) == NULL) ||
+     ((zs->count = (WlzLong *)AlcCalloc(nZ, sizeof(WlzLong))) == NULL) ||
+     ((zs->sum = (double *)AlcCalloc(nZ, sizeof(double))) == NULL) ||
+     ((zs->sumSq = (double *)AlcCalloc(nZ, sizeof(double))) == NULL) ||
+     ((zs->min = (double *)AlcCalloc(nZ, sizeof(double))) == NULL) ||
+     ((zs->max = (double *)AlcCalloc(nZ, sizeof(double))) == NULL) ||
+     ((nBin > 0) &&
+      ((zs->hist = (WlzLong *)AlcCalloc(nZ * nBin, sizeof(WlzLong))) == NULL)))
+  {
+    errNum = WLZ_ERR_MEM_ALLOC;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    zs->nZone = nZone;
+    zs->nBin = nBin;
+    zs->binOrg = binOrg;
+    zs->binWidth = binWidth;
+  }
+  else if(zs)
+  {
+    (void )WlzFreeZonalStats(zs);
+    zs = NULL;
+  }
+  *dstErr = errNum;
+  return(zs);
+}
+
+/*!
+* \ingroup	WlzFeatures
+* \brief	Merges the statistics of a thread into the given
+* 		zonal statistics.
+* \param	zs			Given zonal statistics.
+* \param	tZs			Statistics of a thread, which must
+* 					have the same number of zones and
+* 					bins.
+*/
+static void	WlzZonalStatsMerge(WlzZonalStats *zs, WlzZonalStats *tZs)
+{
+  int		idZ;
+
+  for(idZ = 0; idZ < zs->nZone; ++idZ)
+  {
+    if(tZs->count[idZ] > 0)
+    {
+      if(zs->count[idZ] == 0)
+      {
+	zs->min[idZ] = tZs->min[idZ];
+	zs->max[idZ] = tZs->max[idZ];
+      }
+      else
+      {
+	zs->min[idZ] = ALG_MIN(zs->min[idZ], tZs->min[idZ]);
+	zs->max[idZ] = ALG_MAX(zs->max[idZ], tZs->max[idZ]);
+      }
+      zs->count[idZ] += tZs->count[idZ];
+      zs->sum[idZ] += tZs->sum[idZ];
+      zs->sumSq[idZ] += tZs->sumSq[idZ];
+    }
+  }
+  if(zs->hist)
+  {
+    size_t	idH,
+    		nH;
+
+    nH = (size_t )(zs->nZone) * zs->nBin;
+    for(idH = 0; idH < nH; ++idH)
+    {
+      zs->hist[idH] += tZs->hist[idH];
+    }
+  }
+}
+
+/*!
+* \return	Values of the given plane, with a NULL pointer if the
+* 		object has no values for the plane.
+* \ingroup	WlzFeatures
+* \brief	Gets the 2D values of a plane of a 3D object. For tiled
+* 		values the object's values are returned.
+* \param	obj			Given 3D domain object with values.
+* \param	pl			The plane.
+*/
+static WlzValues WlzZonalStatsPlaneValues(WlzObject *obj, int pl)
+{
+  WlzValues	val;
+
+  val.core = NULL;
+  if(WlzGreyTableIsTiled(obj->values.core->type))
+  {
+    val = obj->values;
+  }
+  else if((obj->values.core->type == WLZ_VOXELVALUETABLE_GREY) &&
+          (pl >= obj->values.vox->plane1) && (pl <= obj->values.vox->lastpl))
+  {
+    val = obj->values.vox->values[pl - obj->values.vox->plane1];
+  }
+  return(val);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzFeatures
+* \brief	Accumulates the statistics of a single work item, which
+* 		is either a plane of 3D objects or a band of lines of 2D
+* 		objects.
+* \param	zs			Statistics of the thread.
+* \param	gObj			Given grey object.
+* \param	lObj			Given index object.
+* \param	iObj			Intersection of the grey and index
+* 					objects' domains.
+* \param	item			Index of the work item.
+* \param	nItem			Number of work items.
+*/
+static WlzErrorNum WlzZonalStatsItem(WlzZonalStats *zs,
+				     WlzObject *gObj, WlzObject *lObj,
+				     WlzObject *iObj, int item, int nItem)
+{
+  WlzDomain	dom;
+  WlzObject	*bObj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  dom.core = NULL;
+  if(iObj->type == WLZ_2D_DOMAINOBJ)
+  {
+    int		nLn;
+    WlzIBox2	box;
+
+    /* Clip the common domain to a band of lines. */
+    nLn = iObj->domain.i->lastln - iObj->domain.i->line1 + 1;
+    box.xMin = iObj->domain.i->kol1;
+    box.xMax = iObj->domain.i->lastkl;
+    box.yMin = iObj->domain.i->line1 + (int )(((WlzLong )nLn * item) / nItem);
+    box.yMax = iObj->domain.i->line1 +
+               (int )(((WlzLong )nLn * (item + 1)) / nItem) - 1;
+    bObj = WlzAssignObject(WlzClipObjToBox2D(iObj, box, &errNum), NULL);
+    if((errNum == WLZ_ERR_NONE) && (bObj->type == WLZ_2D_DOMAINOBJ))
+    {
+      errNum = WlzZonalStats2D(zs, bObj->domain, gObj->values, lObj->values,
+                               0);
+    }
+    (void )WlzFreeObj(bObj);
+  }
+  else
+  {
+    int		pl;
+    WlzValues	gVal,
+    		lVal;
+
+    pl = iObj->domain.p->plane1 + item;
+    dom = iObj->domain.p->domains[item];
+    gVal = WlzZonalStatsPlaneValues(gObj, pl);
+    lVal = WlzZonalStatsPlaneValues(lObj, pl);
+    if((dom.core != NULL) && (dom.core->type != WLZ_EMPTY_DOMAIN) &&
+       (gVal.core != NULL) && (lVal.core != NULL))
+    {
+      errNum = WlzZonalStats2D(zs, dom, gVal, lVal, pl);
+    }
+  }
+  return(errNum);
+}
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzFeatures
+* \brief	Accumulates the statistics of the grey values within
+* 		the given 2D domain, scanning the grey and index values
+* 		together.
+* \param	zs			Statistics of the thread.
+* \param	dom			Domain to scan, which must be covered
+* 					by both the grey and index values.
+* \param	gVal			Grey values.
+* \param	lVal			Index values.
+* \param	pln			Plane, only used for tiled values.
+*/
+static WlzErrorNum WlzZonalStats2D(WlzZonalStats *zs, WlzDomain dom,
+				   WlzValues gVal, WlzValues lVal, int pln)
+{
+  WlzObject	*gObj = NULL,
+  		*lObj = NULL;
+  WlzIntervalWSpace gIWSp,
+  		lIWSp;
+  WlzGreyWSpace	gGWSp,
+  		lGWSp;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  gObj = WlzMakeMain(WLZ_2D_DOMAINOBJ, dom, gVal, NULL, NULL, &errNum);
+  if(errNum == WLZ_ERR_NONE)
+  {
+    lObj = WlzMakeMain(WLZ_2D_DOMAINOBJ, dom, lVal, NULL, NULL, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    errNum = WlzInitGreyScan(gObj, &gIWSp, &gGWSp);
+    if(errNum == WLZ_ERR_NONE)
+    {
+      errNum = WlzInitGreyScan(lObj, &lIWSp, &lGWSp);
+      if(errNum == WLZ_ERR_NONE)
+      {
+	if(gGWSp.tvb)
+	{
+	  gIWSp.plnpos = pln;
+	}
+	if(lGWSp.tvb)
+	{
+	  lIWSp.plnpos = pln;
+	}
+	/* Both objects have the same domain so their intervals match. */
+	while((errNum == WLZ_ERR_NONE) &&
+	      ((errNum = WlzNextGreyInterval(&gIWSp)) == WLZ_ERR_NONE) &&
+	      ((errNum = WlzNextGreyInterval(&lIWSp)) == WLZ_ERR_NONE))
+	{
+	  int	idK,
+	  	cnt;
+	  WlzGreyP gP,
+	  	lP;
+
+	  gP = gGWSp.u_grintptr;
+	  lP = lGWSp.u_grintptr;
+	  cnt = gIWSp.rgtpos - gIWSp.lftpos + 1;
+	  for(idK = 0; (errNum == WLZ_ERR_NONE) && (idK < cnt); ++idK)
+	  {
+	    int	z = 0;
+	    double g = 0.0;
+
+	    switch(lGWSp.pixeltype)
+	    {
+	      case WLZ_GREY_INT:
+		z = lP.inp[idK];
+		break;
+	      case WLZ_GREY_SHORT:
+		z = lP.shp[idK];
+		break;
+	      case WLZ_GREY_UBYTE:
+		z = lP.ubp[idK];
+		break;
+	      default:
+		errNum = WLZ_ERR_GREY_TYPE;
+		break;
+	    }
+	    switch(gGWSp.pixeltype)
+	    {
+	      case WLZ_GREY_INT:
+		g = gP.inp[idK];
+		break;
+	      case WLZ_GREY_SHORT:
+		g = gP.shp[idK];
+		break;
+	      case WLZ_GREY_UBYTE:
+		g = gP.ubp[idK];
+		break;
+	      case WLZ_GREY_FLOAT:
+		g = gP.flp[idK];
+		break;
+	      case WLZ_GREY_DOUBLE:
+		g = gP.dbp[idK];
+		break;
+	      case WLZ_GREY_RGBA:
+		g = WLZ_RGBA_MODULUS(gP.rgbp[idK]);
+		break;
+	      default:
+		errNum = WLZ_ERR_GREY_TYPE;
+		break;
+	    }
+	    if((errNum == WLZ_ERR_NONE) && (z >= 0) && (z < zs->nZone))
+	    {
+	      if(zs->count[z] == 0)
+	      {
+		zs->min[z] = zs->max[z] = g;
+	      }
+	      else if(g < zs->min[z])
+	      {
+		zs->min[z] = g;
+	      }
+	      else if(g > zs->max[z])
+	      {
+		zs->max[z] = g;
+	      }
+	      ++(zs->count[z]);
+	      zs->sum[z] += g;
+	      zs->sumSq[z] += g * g;
+	      if(zs->hist)
+	      {
+		int	b;
+
+		b = (int )floor((g - zs->binOrg) / zs->binWidth);
+		b = WLZ_CLAMP(b, 0, zs->nBin - 1);
+		++(zs->hist[((size_t )z * zs->nBin) + b]);
+	      }
+	    }
+	  }
+	}
+	if(errNum == WLZ_ERR_EOO)
+	{
+	  errNum = WLZ_ERR_NONE;
+	}
+	(void )WlzEndGreyScan(&lIWSp, &lGWSp);
+      }
+      (void )WlzEndGreyScan(&gIWSp, &gGWSp);
+    }
+  }
+  (void )WlzFreeObj(gObj);
+  (void )WlzFreeObj(lObj);
+  return(errNum);
+}
@@ -94,6 +94,14 @@ static WlzErrorNum		WlzEffNiftiToWlzType(
 				  nifti_image *nim,
 				  int *dstNVPP,
 				  WlzGreyType *dstWGType);
+static WlzObject		*WlzEffNiftiMapToObj(
+				  nifti_image *nim);
+static WlzObject		*WlzEffReadNifti(
+				  const char *gvnFileName,
+				  int sTrans,
+				  int gTrans,
+				  int map,
+				  WlzErrorNum *dstErr);
 #endif
 
 /*!
@@ -144,6 +152,325 @@ WlzObject	*WlzEffReadObjNifti(const char *gvnFileName,
   return(obj);
 }
 #else
+{
+  return(WlzEffReadNifti(gvnFileName, sTrans, gTrans, 0, dstErr));
+}
+#endif
+
+/*!
+* \return	New Woolz object or NULL on error.
+* \ingroup	WlzExtFF
+* \brief	Reads a Woolz object from the given file using the
+*		NIfTI format, as WlzEffReadObjNifti(), but where the
+*		image is 2 or 3D, is not gzip compressed and has a
+*		voxel type which is used directly by Woolz (unsigned
+*		byte, short, int, float or double) the values of the
+*		returned domain object are memory mapped from the file
+*		rather than being read. Images with a byte order other
+*		than the host's are swapped in the (private) mapping.
+*		All other NIfTI images are read as by
+*		WlzEffReadObjNifti().
+* \param	gvnFileName		Given file name.
+* \param	sTrans			If non-zero the NIfTI spatial transform
+* 					is used to build a WLZ_TRANS_OBJ,
+* 					see WlzEffReadObjNifti().
+* \param	gTrans			Apply the NIfTI grey scaling if
+* 					non-zero, in which case the scaled
+* 					values are not mapped.
+* \param	dstErr			Destination error code, may be NULL.
+*/
+WlzObject	*WlzEffReadObjNiftiMapped(const char *gvnFileName,
+				    int sTrans,
+				    int gTrans,
+				    WlzErrorNum *dstErr)
+#if HAVE_NIFTI == 0
+{
+  WlzObject	*obj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_UNIMPLEMENTED;
+
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(obj);
+}
+#else
+{
+  return(WlzEffReadNifti(gvnFileName, sTrans, gTrans, 1, dstErr));
+}
+#endif
+
+/*!
+* \return	Woolz error code.
+* \ingroup	WlzExtFF
+* \brief	Writes the given Woolz object to the given file(s)
+*		using the NIfTI file format.
+* \param	gvnFileName		Given file name with .hdr, .img or no
+* 					extension.
+* \param	obj			Given woolz object.
+*/
+WlzErrorNum	WlzEffWriteObjNifti(const char *gvnFileName, WlzObject *obj)
+#if HAVE_NIFTI == 0
+{
+  WlzErrorNum	errNum = WLZ_ERR_UNIMPLEMENTED;
+  
+  return(errNum);
+}
+#else
+{
+  int		nDType;
+  nifti_image	*nim = NULL;
+  WlzGreyType	gType;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  if((gvnFileName == NULL) || (*gvnFileName == '\0'))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if(obj == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if(obj->domain.core == NULL)
+  {
+    errNum = WLZ_ERR_DOMAIN_NULL;
+  }
+  else if(obj->values.core == NULL)
+  {
+    errNum = WLZ_ERR_VALUES_NULL;
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gType = WlzGreyTypeFromObj(obj, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    nDType = WlzEffNiftiFromWlzGType(gType, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    switch(obj->type)
+    {
+      case WLZ_2D_DOMAINOBJ:
+	{
+	  WlzIBox2 bBox;
+	  void	  **datAry = NULL; 
+
+	  bBox.xMin = obj->domain.i->kol1;
+	  bBox.xMax = obj->domain.i->lastkl;
+	  bBox.yMin = obj->domain.i->line1;
+	  bBox.yMax = obj->domain.i->lastln;
+	  if((nim = (nifti_image *)AlcCalloc(1, sizeof(nifti_image))) == NULL)
+	  {
+	    errNum = WLZ_ERR_MEM_ALLOC;
+	  }
+	  else
+	  {
+            nim->dim[0] = nim->ndim = 2;
+	    nim->dim[1] = nim->nx = bBox.xMax - bBox.xMin + 1;
+	    nim->dim[2] = nim->ny = bBox.yMax - bBox.yMin + 1;
+	    nim->dim[3] = nim->nz = 1;
+	    nim->dim[4] = nim->nt = 1;
+	    nim->dim[5] = nim->nu = 1;
+	    nim->dim[6] = nim->nv = 1;
+	    nim->dim[7] = nim->nw = 1;
+	    nim->nvox = nim->nx * nim->ny;
+	    nim->datatype = nDType;
+	    nim->pixdim[1] = nim->dx = 1.0;
+	    nim->pixdim[2] = nim->dy = 1.0;
+	    nim->pixdim[3] = nim->dz = 1.0;
+	    nim->pixdim[4] = nim->dt = 1.0;
+	    nim->pixdim[5] = nim->du = 1.0;
+	    nim->pixdim[6] = nim->dv = 1.0;
+	    nim->pixdim[7] = nim->dw = 1.0;
+	    nim->scl_slope = 1.0;
+	    nim->scl_inter = 0.0;
+	    nim->sform_code = 1;
+	    nim->qto_xyz.m[0][0] = 1.0;
+	    nim->qto_xyz.m[1][1] = 1.0;
+	    nim->qto_xyz.m[2][2] = 1.0;
+	    nim->qto_xyz.m[3][3] = 1.0;
+	    nim->qto_ijk.m[0][0] = 1.0;
+	    nim->qto_ijk.m[1][1] = 1.0;
+	    nim->qto_ijk.m[2][2] = 1.0;
+	    nim->qto_ijk.m[3][3] = 1.0;
+	    nim->sto_xyz.m[0][0] = 1.0; nim->sto_xyz.m[0][3] = -(bBox.xMin);
+	    nim->sto_xyz.m[1][1] = 1.0; nim->sto_xyz.m[1][3] = -(bBox.yMin);
+	    nim->sto_xyz.m[2][2] = 1.0;
+	    nim->sto_xyz.m[3][3] = 1.0;
+	    nim->sto_ijk.m[0][0] = 1.0; nim->sto_ijk.m[0][3] = bBox.xMin;
+	    nim->sto_ijk.m[1][1] = 1.0; nim->sto_ijk.m[1][3] = bBox.yMin;
+	    nim->sto_ijk.m[2][2] = 1.0;
+	    nim->sto_ijk.m[3][3] = 1.0;
+	    nifti_mat44_to_quatern(nim->qto_xyz,
+	                           &(nim->quatern_b),
+	                           &(nim->quatern_c),
+	                           &(nim->quatern_d),
+	                           &(nim->qoffset_x),
+	                           &(nim->qoffset_y),
+	                           &(nim->qoffset_z),
+				   NULL, NULL, NULL, &(nim->qfac));
+	    nifti_datatype_sizes(nim->datatype,
+	                         &(nim->nbyper), &(nim->swapsize) ) ;
+            nim->byteorder = nifti_short_order();
+	    nim->nifti_type = NIFTI_FTYPE_NIFTI1_1;
+	    if(((nim->fname = nifti_strdup(gvnFileName)) == NULL) ||
+	       ((nim->iname = nifti_strdup(gvnFileName)) == NULL))
+	    {
+	      errNum = WLZ_ERR_MEM_ALLOC;
+	    }
+	  }
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    WlzIVertex2 sz,
+			org;
+	    sz.vtX = nim->nx;
+	    sz.vtY = nim->ny;
+	    org.vtX = bBox.xMin;
+	    org.vtY = bBox.yMin;
+	    errNum = WlzToArray2D(&datAry, obj, sz, org, 0, gType);
+	  }
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    nim->data = *(WlzUByte **)datAry;
+	    errno = 0;
+	    nifti_image_write(nim);
+	    if(errno != 0)
+	    {
+	      errNum = WLZ_ERR_WRITE_INCOMPLETE;
+	    }
+	    nim->data = NULL;
+	  }
+	  nifti_image_free(nim);
+	  (void )Alc2Free(datAry);
+	}
+        break;
+      case WLZ_3D_DOMAINOBJ:
+	{
+	  WlzIBox3 bBox;
+	  void	  ***datAry = NULL; 
+
+	  bBox.xMin = obj->domain.p->kol1;
+	  bBox.xMax = obj->domain.p->lastkl;
+	  bBox.yMin = obj->domain.p->line1;
+	  bBox.yMax = obj->domain.p->lastln;
+	  bBox.zMin = obj->domain.p->plane1;
+	  bBox.zMax = obj->domain.p->lastpl;
+	  if((nim = (nifti_image *)AlcCalloc(1, sizeof(nifti_image))) == NULL)
+	  {
+	    errNum = WLZ_ERR_MEM_ALLOC;
+	  }
+	  else
+	  {
+            nim->dim[0] = nim->ndim = 3;
+	    nim->dim[1] = nim->nx = bBox.xMax - bBox.xMin + 1;
+	    nim->dim[2] = nim->ny = bBox.yMax - bBox.yMin + 1;
+	    nim->dim[3] = nim->nz = bBox.zMax - bBox.zMin + 1;
+	    nim->dim[4] = nim->nt = 1;
+	    nim->dim[5] = nim->nu = 1;
+	    nim->dim[6] = nim->nv = 1;
+	    nim->dim[7] = nim->nw = 1;
+	    nim->nvox = nim->nx * nim->ny * nim->nz;
+	    nim->datatype = nDType;
+	    nim->pixdim[1] = nim->dx = obj->domain.p->voxel_size[0];
+	    nim->pixdim[2] = nim->dy = obj->domain.p->voxel_size[1];
+	    nim->pixdim[3] = nim->dz = obj->domain.p->voxel_size[2];
+	    nim->pixdim[4] = nim->dt = 1.0;
+	    nim->pixdim[5] = nim->du = 1.0;
+	    nim->pixdim[6] = nim->dv = 1.0;
+	    nim->pixdim[7] = nim->dw = 1.0;
+	    nim->scl_slope = 1.0;
+	    nim->scl_inter = 0.0;
+	    nim->sform_code = 1;
+	    nim->qto_xyz.m[0][0] = 1.0;
+	    nim->qto_xyz.m[1][1] = 1.0;
+	    nim->qto_xyz.m[2][2] = 1.0;
+	    nim->qto_xyz.m[3][3] = 1.0;
+	    nim->qto_ijk.m[0][0] = 1.0;
+	    nim->qto_ijk.m[1][1] = 1.0;
+	    nim->qto_ijk.m[2][2] = 1.0;
+	    nim->qto_ijk.m[3][3] = 1.0;
+	    nim->sto_xyz.m[0][0] = 1.0; nim->sto_xyz.m[0][3] = -(bBox.xMin);
+	    nim->sto_xyz.m[1][1] = 1.0; nim->sto_xyz.m[1][3] = -(bBox.yMin);
+	    nim->sto_xyz.m[2][2] = 1.0; nim->sto_xyz.m[2][3] = -(bBox.zMin);
+	    nim->sto_xyz.m[3][3] = 1.0;
+	    nim->sto_ijk.m[0][0] = 1.0; nim->sto_ijk.m[0][3] = bBox.xMin;
+	    nim->sto_ijk.m[1][1] = 1.0; nim->sto_ijk.m[1][3] = bBox.yMin;
+	    nim->sto_ijk.m[2][2] = 1.0; nim->sto_ijk.m[2][3] = bBox.zMin;
+	    nim->sto_ijk.m[3][3] = 1.0;
+	    nifti_mat44_to_quatern(nim->qto_xyz,
+	                           &(nim->quatern_b),
+	                           &(nim->quatern_c),
+	                           &(nim->quatern_d),
+	                           &(nim->qoffset_x),
+	                           &(nim->qoffset_y),
+	                           &(nim->qoffset_z),
+				   NULL, NULL, NULL, &(nim->qfac));
+	    nifti_datatype_sizes(nim->datatype,
+	                         &(nim->nbyper), &(nim->swapsize) ) ;
+            nim->byteorder = nifti_short_order();
+	    nim->nifti_type = NIFTI_FTYPE_NIFTI1_1;
+	    if(((nim->fname = nifti_strdup(gvnFileName)) == NULL) ||
+	       ((nim->iname = nifti_strdup(gvnFileName)) == NULL))
+	    {
+	      errNum = WLZ_ERR_MEM_ALLOC;
+	    }
+	  }
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    WlzIVertex3 sz,
+			org;
+	    sz.vtX = nim->nx;
+	    sz.vtY = nim->ny;
+	    sz.vtZ = nim->nz;
+	    org.vtX = bBox.xMin;
+	    org.vtY = bBox.yMin;
+	    org.vtZ = bBox.zMin;
+	    errNum = WlzToArray3D(&datAry, obj, sz, org, 0, gType);
+	  }
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    nim->data = **(WlzUByte ***)datAry;
+	    errno = 0;
+	    nifti_image_write(nim);
+	    if(errno != 0)
+	    {
+	      errNum = WLZ_ERR_WRITE_INCOMPLETE;
+	    }
+	    nim->data = NULL;
+	  }
+	  nifti_image_free(nim);
+	  (void )Alc3Free(datAry);
+	}
+        break;
+      default:
+        errNum = WLZ_ERR_OBJECT_TYPE;
+	break;
+    }
+  }
+  return(errNum);
+}
+#endif
+
+#if HAVE_NIFTI != 0
+/*!
+* \return	New Woolz object or NULL on error.
+* \ingroup	WlzExtFF
+* \brief	Reads a Woolz object from the given file using the
+*		NIfTI format. See WlzEffReadObjNifti() and
+*		WlzEffReadObjNiftiMapped().
+* \param	gvnFileName		Given file name.
+* \param	sTrans			If non-zero the NIfTI spatial transform
+* 					is used to build a WLZ_TRANS_OBJ.
+* \param	gTrans			Apply the NIfTI grey scaling if
+* 					non-zero.
+* \param	map			Memory map the values if non-zero and
+* 					possible.
+* \param	dstErr			Destination error code, may be NULL.
+*/
+static WlzObject *WlzEffReadNifti(const char *gvnFileName,
+				  int sTrans, int gTrans, int map,
+				  WlzErrorNum *dstErr)
 {
   nifti_image	*nim = NULL;
   WlzObject	*obj = NULL;
@@ -157,7 +484,8 @@ WlzObject	*WlzEffReadObjNifti(const char *gvnFileName,
   }
   else
   {
-    nim = nifti_image_read(gvnFileName, 1);
+    /* When mapping only the header is read here. */
+    nim = nifti_image_read(gvnFileName, (map)? 0: 1);
     if(nim == NULL)
     {
       errNum = WLZ_ERR_READ_EOF;
@@ -183,8 +511,18 @@ WlzObject	*WlzEffReadObjNifti(const char *gvnFileName,
       }
     }
   }
+  /* Memory map the values if required and possible, otherwise fall back to
+   * loading them. */
+  if((errNum == WLZ_ERR_NONE) && map)
+  {
+    obj = WlzEffNiftiMapToObj(nim);
+    if((obj == NULL) && (nifti_image_load(nim) != 0))
+    {
+      errNum = WLZ_ERR_READ_INCOMPLETE;
+    }
+  }
   /* Create basic Woolz domain object from the NIfTI image. */
-  if(errNum == WLZ_ERR_NONE)
+  if((errNum == WLZ_ERR_NONE) && (obj == NULL))
   {
     switch(nim->ndim)
     {
@@ -449,261 +787,83 @@ WlzObject	*WlzEffReadObjNifti(const char *gvnFileName,
   }
   return(obj);
 }
-#endif
 
 /*!
-* \return	Woolz error code.
+* \return	New Woolz object or NULL if the values can not be mapped.
 * \ingroup	WlzExtFF
-* \brief	Writes the given Woolz object to the given file(s)
-*		using the NIfTI file format.
-* \param	gvnFileName		Given file name with .hdr, .img or no
-* 					extension.
-* \param	obj			Given woolz object.
+* \brief	Creates a 2 or 3D domain object with values memory mapped
+* 		from the image file of the given NIfTI image, for which
+* 		only the header has been read. Only uncompressed single
+* 		channel images with a voxel type that Woolz uses directly
+* 		are mapped, for all others NULL is returned so that the
+* 		caller can load and copy the values instead. As for
+* 		WlzEffNiftiToObj2D() and WlzEffNiftiToObj3D() neither the
+* 		NIfTI transforms nor the value scaling are applied.
+* \param	nim			NIfTI image header.
 */
-WlzErrorNum	WlzEffWriteObjNifti(const char *gvnFileName, WlzObject *obj)
-#if HAVE_NIFTI == 0
-{
-  WlzErrorNum	errNum = WLZ_ERR_UNIMPLEMENTED;
-  
-  return(errNum);
-}
-#else
+static WlzObject *WlzEffNiftiMapToObj(nifti_image *nim)
 {
-  int		nDType;
-  nifti_image	*nim = NULL;
-  WlzGreyType	gType;
-  WlzErrorNum	errNum = WLZ_ERR_NONE;
+  int		swap;
+  FILE		*fP = NULL;
+  WlzIVertex3	sz,
+  		org;
+  WlzObject	*obj = NULL;
+  WlzObjectType	oType = WLZ_NULL;
+  WlzGreyType	gType = WLZ_GREY_ERROR;
 
-  if((gvnFileName == NULL) || (*gvnFileName == '\0'))
-  {
-    errNum = WLZ_ERR_PARAM_NULL;
-  }
-  else if(obj == NULL)
-  {
-    errNum = WLZ_ERR_OBJECT_NULL;
-  }
-  else if(obj->domain.core == NULL)
-  {
-    errNum = WLZ_ERR_DOMAIN_NULL;
-  }
-  else if(obj->values.core == NULL)
-  {
-    errNum = WLZ_ERR_VALUES_NULL;
-  }
-  if(errNum == WLZ_ERR_NONE)
+  switch(nim->datatype)
   {
-    gType = WlzGreyTypeFromObj(obj, &errNum);
+    case NIFTI_TYPE_UINT8:
+      gType = WLZ_GREY_UBYTE;
+      break;
+    case NIFTI_TYPE_INT16:
+      gType = WLZ_GREY_SHORT;
+      break;
+    case NIFTI_TYPE_INT32:
+      gType = WLZ_GREY_INT;
+      break;
+    case NIFTI_TYPE_FLOAT32:
+      gType = WLZ_GREY_FLOAT;
+      break;
+    case NIFTI_TYPE_FLOAT64:
+      gType = WLZ_GREY_DOUBLE;
+      break;
+    default:
+      break;
   }
-  if(errNum == WLZ_ERR_NONE)
+  switch(nim->ndim)
   {
-    nDType = WlzEffNiftiFromWlzGType(gType, &errNum);
+    case 2:
+      oType = WLZ_2D_DOMAINOBJ;
+      break;
+    case 3:
+      oType = WLZ_3D_DOMAINOBJ;
+      break;
+    default:
+      break;
   }
-  if(errNum == WLZ_ERR_NONE)
+  if((gType != WLZ_GREY_ERROR) && (oType != WLZ_NULL) &&
+     (nim->iname != NULL) && (nim->iname_offset >= 0) &&
+     (nifti_is_gzfile(nim->iname) == 0) &&
+     ((fP = fopen(nim->iname, "rb")) != NULL))
   {
-    switch(obj->type)
+    WLZ_VTX_3_SET(sz, nim->dim[1], nim->dim[2],
+                  (oType == WLZ_3D_DOMAINOBJ)? nim->dim[3]: 1);
+    WLZ_VTX_3_SET(org, 0, 0, 0);
+    swap = (nim->nbyper > 1) && (nim->byteorder != nifti_short_order());
+    obj = WlzFromArrayMapped1D(oType, sz, org, gType, fileno(fP),
+                               (long )(nim->iname_offset), swap, NULL);
+    (void )fclose(fP);
+    if((obj != NULL) && (oType == WLZ_3D_DOMAINOBJ))
     {
-      case WLZ_2D_DOMAINOBJ:
-	{
-	  WlzIBox2 bBox;
-	  void	  **datAry = NULL; 
-
-	  bBox.xMin = obj->domain.i->kol1;
-	  bBox.xMax = obj->domain.i->lastkl;
-	  bBox.yMin = obj->domain.i->line1;
-	  bBox.yMax = obj->domain.i->lastln;
-	  if((nim = (nifti_image *)AlcCalloc(1, sizeof(nifti_image))) == NULL)
-	  {
-	    errNum = WLZ_ERR_MEM_ALLOC;
-	  }
-	  else
-	  {
-            nim->dim[0] = nim->ndim = 2;
-	    nim->dim[1] = nim->nx = bBox.xMax - bBox.xMin + 1;
-	    nim->dim[2] = nim->ny = bBox.yMax - bBox.yMin + 1;
-	    nim->dim[3] = nim->nz = 1;
-	    nim->dim[4] = nim->nt = 1;
-	    nim->dim[5] = nim->nu = 1;
-	    nim->dim[6] = nim->nv = 1;
-	    nim->dim[7] = nim->nw = 1;
-	    nim->nvox = nim->nx * nim->ny;
-	    nim->datatype = nDType;
-	    nim->pixdim[1] = nim->dx = 1.0;
-	    nim->pixdim[2] = nim->dy = 1.0;
-	    nim->pixdim[3] = nim->dz = 1.0;
-	    nim->pixdim[4] = nim->dt = 1.0;
-	    nim->pixdim[5] = nim->du = 1.0;
-	    nim->pixdim[6] = nim->dv = 1.0;
-	    nim->pixdim[7] = nim->dw = 1.0;
-	    nim->scl_slope = 1.0;
-	    nim->scl_inter = 0.0;
-	    nim->sform_code = 1;
-	    nim->qto_xyz.m[0][0] = 1.0;
-	    nim->qto_xyz.m[1][1] = 1.0;
-	    nim->qto_xyz.m[2][2] = 1.0;
-	    nim->qto_xyz.m[3][3] = 1.0;
-	    nim->qto_ijk.m[0][0] = 1.0;
-	    nim->qto_ijk.m[1][1] = 1.0;
-	    nim->qto_ijk.m[2][2] = 1.0;
-	    nim->qto_ijk.m[3][3] = 1.0;
-	    nim->sto_xyz.m[0][0] = 1.0; nim->sto_xyz.m[0][3] = -(bBox.xMin);
-	    nim->sto_xyz.m[1][1] = 1.0; nim->sto_xyz.m[1][3] = -(bBox.yMin);
-	    nim->sto_xyz.m[2][2] = 1.0;
-	    nim->sto_xyz.m[3][3] = 1.0;
-	    nim->sto_ijk.m[0][0] = 1.0; nim->sto_ijk.m[0][3] = bBox.xMin;
-	    nim->sto_ijk.m[1][1] = 1.0; nim->sto_ijk.m[1][3] = bBox.yMin;
-	    nim->sto_ijk.m[2][2] = 1.0;
-	    nim->sto_ijk.m[3][3] = 1.0;
-	    nifti_mat44_to_quatern(nim->qto_xyz,
-	                           &(nim->quatern_b),
-	                           &(nim->quatern_c),
-	                           &(nim->quatern_d),
-	                           &(nim->qoffset_x),
-	                           &(nim->qoffset_y),
-	                           &(nim->qoffset_z),
-				   NULL, NULL, NULL, &(nim->qfac));
-	    nifti_datatype_sizes(nim->datatype,
-	                         &(nim->nbyper), &(nim->swapsize) ) ;
-            nim->byteorder = nifti_short_order();
-	    nim->nifti_type = NIFTI_FTYPE_NIFTI1_1;
-	    if(((nim->fname = nifti_strdup(gvnFileName)) == NULL) ||
-	       ((nim->iname = nifti_strdup(gvnFileName)) == NULL))
-	    {
-	      errNum = WLZ_ERR_MEM_ALLOC;
-	    }
-	  }
-	  if(errNum == WLZ_ERR_NONE)
-	  {
-	    WlzIVertex2 sz,
-			org;
-	    sz.vtX = nim->nx;
-	    sz.vtY = nim->ny;
-	    org.vtX = bBox.xMin;
-	    org.vtY = bBox.yMin;
-	    errNum = WlzToArray2D(&datAry, obj, sz, org, 0, gType);
-	  }
-	  if(errNum == WLZ_ERR_NONE)
-	  {
-	    nim->data = *(WlzUByte **)datAry;
-	    errno = 0;
-	    nifti_image_write(nim);
-	    if(errno != 0)
-	    {
-	      errNum = WLZ_ERR_WRITE_INCOMPLETE;
-	    }
-	    nim->data = NULL;
-	  }
-	  nifti_image_free(nim);
-	  (void )Alc2Free(datAry);
-	}
-        break;
-      case WLZ_3D_DOMAINOBJ:
-	{
-	  WlzIBox3 bBox;
-	  void	  ***datAry = NULL; 
-
-	  bBox.xMin = obj->domain.p->kol1;
-	  bBox.xMax = obj->domain.p->lastkl;
-	  bBox.yMin = obj->domain.p->line1;
-	  bBox.yMax = obj->domain.p->lastln;
-	  bBox.zMin = obj->domain.p->plane1;
-	  bBox.zMax = obj->domain.p->lastpl;
-	  if((nim = (nifti_image *)AlcCalloc(1, sizeof(nifti_image))) == NULL)
-	  {
-	    errNum = WLZ_ERR_MEM_ALLOC;
-	  }
-	  else
-	  {
-            nim->dim[0] = nim->ndim = 3;
-	    nim->dim[1] = nim->nx = bBox.xMax - bBox.xMin + 1;
-	    nim->dim[2] = nim->ny = bBox.yMax - bBox.yMin + 1;
-	    nim->dim[3] = nim->nz = bBox.zMax - bBox.zMin + 1;
-	    nim->dim[4] = nim->nt = 1;
-	    nim->dim[5] = nim->nu = 1;
-	    nim->dim[6] = nim->nv = 1;
-	    nim->dim[7] = nim->nw = 1;
-	    nim->nvox = nim->nx * nim->ny * nim->nz;
-	    nim->datatype = nDType;
-	    nim->pixdim[1] = nim->dx = obj->domain.p->voxel_size[0];
-	    nim->pixdim[2] = nim->dy = obj->domain.p->voxel_size[1];
-	    nim->pixdim[3] = nim->dz = obj->domain.p->voxel_size[2];
-	    nim->pixdim[4] = nim->dt = 1.0;
-	    nim->pixdim[5] = nim->du = 1.0;
-	    nim->pixdim[6] = nim->dv = 1.0;
-	    nim->pixdim[7] = nim->dw = 1.0;
-	    nim->scl_slope = 1.0;
-	    nim->scl_inter = 0.0;
-	    nim->sform_code = 1;
-	    nim->qto_xyz.m[0][0] = 1.0;
-	    nim->qto_xyz.m[1][1] = 1.0;
-	    nim->qto_xyz.m[2][2] = 1.0;
-	    nim->qto_xyz.m[3][3] = 1.0;
-	    nim->qto_ijk.m[0][0] = 1.0;
-	    nim->qto_ijk.m[1][1] = 1.0;
-	    nim->qto_ijk.m[2][2] = 1.0;
-	    nim->qto_ijk.m[3][3] = 1.0;
-	    nim->sto_xyz.m[0][0] = 1.0; nim->sto_xyz.m[0][3] = -(bBox.xMin);
-	    nim->sto_xyz.m[1][1] = 1.0; nim->sto_xyz.m[1][3] = -(bBox.yMin);
-	    nim->sto_xyz.m[2][2] = 1.0; nim->sto_xyz.m[2][3] = -(bBox.zMin);
-	    nim->sto_xyz.m[3][3] = 1.0;
-	    nim->sto_ijk.m[0][0] = 1.0; nim->sto_ijk.m[0][3] = bBox.xMin;
-	    nim->sto_ijk.m[1][1] = 1.0; nim->sto_ijk.m[1][3] = bBox.yMin;
-	    nim->sto_ijk.m[2][2] = 1.0; nim->sto_ijk.m[2][3] = bBox.zMin;
-	    nim->sto_ijk.m[3][3] = 1.0;
-	    nifti_mat44_to_quatern(nim->qto_xyz,
-	                           &(nim->quatern_b),
-	                           &(nim->quatern_c),
-	                           &(nim->quatern_d),
-	                           &(nim->qoffset_x),
-	                           &(nim->qoffset_y),
-	                           &(nim->qoffset_z),
-				   NULL, NULL, NULL, &(nim->qfac));
-	    nifti_datatype_sizes(nim->datatype,
-	                         &(nim->nbyper), &(nim->swapsize) ) ;
-            nim->byteorder = nifti_short_order();
-	    nim->nifti_type = NIFTI_FTYPE_NIFTI1_1;
-	    if(((nim->fname = nifti_strdup(gvnFileName)) == NULL) ||
-	       ((nim->iname = nifti_strdup(gvnFileName)) == NULL))
-	    {
-	      errNum = WLZ_ERR_MEM_ALLOC;
-	    }
-	  }
-	  if(errNum == WLZ_ERR_NONE)
-	  {
-	    WlzIVertex3 sz,
-			org;
-	    sz.vtX = nim->nx;
-	    sz.vtY = nim->ny;
-	    sz.vtZ = nim->nz;
-	    org.vtX = bBox.xMin;
-	    org.vtY = bBox.yMin;
-	    org.vtZ = bBox.zMin;
-	    errNum = WlzToArray3D(&datAry, obj, sz, org, 0, gType);
-	  }
-	  if(errNum == WLZ_ERR_NONE)
-	  {
-	    nim->data = **(WlzUByte ***)datAry;
-	    errno = 0;
-	    nifti_image_write(nim);
-	    if(errno != 0)
-	    {
-	      errNum = WLZ_ERR_WRITE_INCOMPLETE;
-	    }
-	    nim->data = NULL;
-	  }
-	  nifti_image_free(nim);
-	  (void )Alc3Free(datAry);
-	}
-        break;
-      default:
-        errNum = WLZ_ERR_OBJECT_TYPE;
-	break;
+      obj->domain.p->voxel_size[0] = nim->pixdim[1];
+      obj->domain.p->voxel_size[1] = nim->pixdim[2];
+      obj->domain.p->voxel_size[2] = nim->pixdim[3];
     }
   }
-  return(errNum);
+  return(obj);
 }
-#endif
 
-#if HAVE_NIFTI != 0
 /*!
 * \return	New Woolz object or NULL on error.
 * \ingroup	WlzExtFF
@@ -56,9 +56,14 @@ static char _WlzExtFFNrrd_c[] = "University of Edinburgh $Id$";
 static WlzErrorNum		WlzEffHeadReadNrrd(
 				  WlzEffNrrdHeader *header,
 				  FILE *fP);
+static WlzObject		*WlzEffReadNrrd(
+				  FILE *fP,
+				  int map,
+				  WlzErrorNum *dstErr);
 static WlzObject		*WlzEffReadImgNrrd(
 				  FILE *fP,
 				  WlzEffNrrdHeader *header,
+				  int map,
 				  WlzErrorNum *dstErr);
 static WlzErrorNum 		WlzEffWriteImgNrrd(
 				  FILE *fP,
@@ -83,6 +88,43 @@ static WlzErrorNum 		WlzEffWriteImgNrrd(
 * 					NULL.
 */
 WlzObject	*WlzEffReadObjNrrd(FILE *fP, WlzErrorNum *dstErr)
+{
+  return(WlzEffReadNrrd(fP, 0, dstErr));
+}
+
+/*!
+* \return	Object read from file.
+* \ingroup	WlzExtFF
+* \brief	Reads a Woolz object from the given stream using the
+* 		NRRD file format, as WlzEffReadObjNrrd(), but where the
+* 		data are raw, without line skips and of a type which
+* 		needs no promotion, the values of the returned object
+* 		are memory mapped from the file rather than being read.
+* 		Data with a byte order other than the host's are swapped
+* 		in the (private) mapping. All other NRRD files are read
+* 		as by WlzEffReadObjNrrd().
+* \param	fP			Input file stream which must be
+* 					a regular file.
+* \param	dstErr			Destination error number ptr, may be
+* 					NULL.
+*/
+WlzObject	*WlzEffReadObjNrrdMapped(FILE *fP, WlzErrorNum *dstErr)
+{
+  return(WlzEffReadNrrd(fP, 1, dstErr));
+}
+
+/*!
+* \return	Object read from file.
+* \ingroup	WlzExtFF
+* \brief	Reads a Woolz object from the given stream using the
+* 		NRRD file format, optionaly memory mapping the data.
+* \param	fP			Input file stream.
+* \param	map			Memory map the data if possible
+* 					when non-zero.
+* \param	dstErr			Destination error number ptr, may be
+* 					NULL.
+*/
+static WlzObject *WlzEffReadNrrd(FILE *fP, int map, WlzErrorNum *dstErr)
 {
   WlzObject	*obj = NULL;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
@@ -99,7 +141,7 @@ WlzObject	*WlzEffReadObjNrrd(FILE *fP, WlzErrorNum *dstErr)
     {
       if((header.dimension == 2) || (header.dimension == 3))
       {
-        obj = WlzEffReadImgNrrd(fP, &header, &errNum);
+        obj = WlzEffReadImgNrrd(fP, &header, map, &errNum);
       }
       else
       {
@@ -817,11 +859,14 @@ static WlzErrorNum WlzEffHeadReadNrrd(WlzEffNrrdHeader *header, FILE *fP)
 *		the NRRD file format.
 * \param	fP			Input file stream.
 * \param	header			Header data structure.
+* \param	map			Memory map the data rather than
+* 					reading them if non-zero and the
+* 					data are raw and need no promotion.
 * \param	dstErr			Destination error number ptr, may be
 * 					NULL.
 */
 static WlzObject *WlzEffReadImgNrrd(FILE *fP, WlzEffNrrdHeader *header,
-				    WlzErrorNum *dstErr)
+				    int map, WlzErrorNum *dstErr)
 {
   size_t	nData = 0,
   		nrrdSz = 0,
@@ -903,8 +948,46 @@ static WlzObject *WlzEffReadImgNrrd(FILE *fP, WlzEffNrrdHeader *header,
 	break;
     }
   }
-  /* Read the NRRD data. */
   if(errNum == WLZ_ERR_NONE)
+  {
+    objType = (header->dimension == 2)? WLZ_2D_DOMAINOBJ: WLZ_3D_DOMAINOBJ;
+    WLZ_VTX_3_SET(objSz,
+                  header->sizes[0],
+		  header->sizes[1],
+		  header->sizes[2]);
+    WLZ_VTX_3_SET(objOrg,
+                  ALG_NINT(header->origin[0]),
+                  ALG_NINT(header->origin[1]),
+		  ALG_NINT(header->origin[2]));
+  }
+  /* Memory map the NRRD data if required and possible, on failure fall
+   * back to reading them. */
+  if((errNum == WLZ_ERR_NONE) && map &&
+     (header->encoding == WLZEFF_NRRD_ENCODE_RAW) &&
+     (header->lineSkip == 0) && (header->byteSkip != (size_t )-1) &&
+     (nrrdSz == wlzSz))
+  {
+    long	pos;
+    int		swap = 0;
+    const unsigned int one = 1;
+
+    if(nrrdSz > 1)
+    {
+      WlzEffNrrdEndian hostEndian;
+
+      hostEndian = (*(const unsigned char *)&one)?
+                   WLZEFF_NRRD_ENDIAN_LITTLE: WLZEFF_NRRD_ENDIAN_BIG;
+      swap = (header->endian != WLZEFF_NRRD_ENDIAN_UNSUP) &&
+             (header->endian != hostEndian);
+    }
+    if((pos = ftell(fP)) >= 0)
+    {
+      obj = WlzFromArrayMapped1D(objType, objSz, objOrg, gType, fileno(fP),
+				 pos + (long )(header->byteSkip), swap, NULL);
+    }
+  }
+  /* Read the NRRD data. */
+  if((errNum == WLZ_ERR_NONE) && (obj == NULL))
   {
     size_t	maxSz,
 	  	nNrrdBytes;
@@ -1036,7 +1119,7 @@ static WlzObject *WlzEffReadImgNrrd(FILE *fP, WlzEffNrrdHeader *header,
       }
     }
   }
-  if(errNum == WLZ_ERR_NONE)
+  if((errNum == WLZ_ERR_NONE) && (obj == NULL))
   {
     /* Promote values if needed. */
     if(wlzSz != nrrdSz)
@@ -1063,18 +1146,9 @@ static WlzObject *WlzEffReadImgNrrd(FILE *fP, WlzEffNrrdHeader *header,
       }
     }
   }
-  if(errNum == WLZ_ERR_NONE)
+  if((errNum == WLZ_ERR_NONE) && (obj == NULL))
   {
     /* Create a Woolz object with values allocated. */
-    objType = (header->dimension == 2)? WLZ_2D_DOMAINOBJ: WLZ_3D_DOMAINOBJ;
-    WLZ_VTX_3_SET(objSz,
-                  header->sizes[0],
-		  header->sizes[1],
-		  header->sizes[2]);
-    WLZ_VTX_3_SET(objOrg,
-                  ALG_NINT(header->origin[0]),
-                  ALG_NINT(header->origin[1]),
-		  ALG_NINT(header->origin[2]));
     obj = WlzFromArray1D(objType, objSz, objOrg, gType, buf, 0, &errNum);
   }
   AlcFree(buf.v);
@@ -150,6 +150,11 @@ extern WlzObject 		*WlzEffReadObjNifti(
 				  int spatialTr,
 				  int greySc,
 				  WlzErrorNum *dstErr);
+extern WlzObject 		*WlzEffReadObjNiftiMapped(
+				  const char *gvnFileName,
+				  int spatialTr,
+				  int greySc,
+				  WlzErrorNum *dstErr);
 extern WlzErrorNum 		WlzEffWriteObjNifti(
 				  const char *gvnFileName,
 				  WlzObject *obj);
@@ -171,6 +176,9 @@ extern WlzErrorNum 		WlzEffWriteObjNodeEle(
 extern WlzObject		*WlzEffReadObjNrrd(
 				  FILE *fP,
 				  WlzErrorNum *dstErr);
+extern WlzObject		*WlzEffReadObjNrrdMapped(
+				  FILE *fP,
+				  WlzErrorNum *dstErr);
 extern WlzErrorNum		WlzEffWriteObjNrrd(
 				  FILE *fP,
 				  WlzObject *obj);
@@ -322,6 +330,15 @@ extern WlzObject 		*WlzEffReadObjTiff(
 				  const char *tiffFileName,
 				  int	split,
 				  WlzErrorNum *dstErr);
+extern WlzObject		*WlzEffReadObjTiffTiled(
+				  const char *tiffFileName,
+				  size_t tileSz,
+				  WlzErrorNum *dstErr);
+extern WlzErrorNum		WlzEffWriteObjTiffTiled(
+				  const char *tiffFileName,
+				  WlzObject *obj,
+				  int tileWidth,
+				  int bigTiff);
 
 /* From WlzExtFFJpeg.c */
 extern WlzObject		*WlzEffReadObjJpeg(
@@ -541,7 +541,9 @@ static WlzErrorNum WlzEffReadObjStackData2D(FILE *fP, WlzEffFormat fFmt,
 * \return	Object read from file.
 * \ingroup	WlzExtFF
 * \brief	Reads a 3D Woolz object from the given file(s) using the given
-* 		(2D) file format.
+* 		(2D) file format. The section file names are read from
+* 		the control file and the sections are then decoded
+* 		concurrently into the preallocated volume.
 * \param	gvnFileName		Given file name.
 * \param	fFmt			Given file format (must be a 2D file
 * 					format).
@@ -562,8 +564,8 @@ static WlzObject *WlzEffReadObjStack3D(const char *gvnFileName,
   		*fBodyStr = NULL,
   		*fExtStr = NULL,
 		*fCtrStr = NULL;
-  FILE		*fP = NULL,
-  		*fP2D = NULL;
+  char		**secStr = NULL;
+  FILE		*fP = NULL;
   WlzIVertex2	imgSz2D;
   WlzErrorNum	errNum = WLZ_ERR_NONE;
   WlzObject	*obj = NULL;
@@ -613,6 +615,15 @@ static WlzObject *WlzEffReadObjStack3D(const char *gvnFileName,
       errNum = WLZ_ERR_MEM_ALLOC;
     }
   }
+  /* Read the section file names from the control file. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((secStr = (char **)AlcCalloc(header.volSize.vtZ,
+                                    sizeof(char *))) == NULL)
+    {
+      errNum = WLZ_ERR_MEM_ALLOC;
+    }
+  }
   if(errNum == WLZ_ERR_NONE)
   {
     planeOff = 0;
@@ -637,31 +648,80 @@ static WlzObject *WlzEffReadObjStack3D(const char *gvnFileName,
 	{
 	  errNum = WLZ_ERR_READ_INCOMPLETE;
 	}
+	else if((*(secStr + planeOff) = (char *)
+	         AlcMalloc((strlen(fPathStr) + strlen(recTok) + 1) *
+			   sizeof(char))) == NULL)
+	{
+	  errNum = WLZ_ERR_MEM_ALLOC;
+	}
+	else
+	{
+	  sprintf(*(secStr + planeOff), "%s%s", fPathStr, recTok);
+	}
+      }
+      ++planeOff;
+      ++planeIdx;
+    }
+  }
+  /* Decode the sections concurrently, each directly into its own plane
+   * of the preallocated array, so that the only decoding state held is
+   * that of the section being read by each thread. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for(planeOff = 0; planeOff < header.volSize.vtZ; ++planeOff)
+    {
+      int	skip;
+      WlzErrorNum errNum2D = WLZ_ERR_NONE;
+
+      /* The shared error is only accessed in the critical section,
+       * sections after an error being skipped. */
+#ifdef _OPENMP
+#pragma omp critical (WlzEffReadObjStack3D)
+#endif
+      {
+        skip = (errNum != WLZ_ERR_NONE);
+      }
+      if(!skip)
+      {
+	FILE	*fP2D;
+	WlzIVertex2 secSz2D;
+
+	secSz2D = imgSz2D;
+	if((fP2D = fopen(*(secStr + planeOff), "r")) == NULL)
+	{
+	  errNum2D = WLZ_ERR_READ_EOF;
+	}
 	else
 	{
-	  sprintf(fNameStr, "%s%s", fPathStr, recTok);
-	  if((fP2D = fopen(fNameStr, "r")) == NULL)
+#ifdef _WIN32
+	  if(_setmode(_fileno(fP2D), 0x8000) == -1)
 	  {
-	    errNum = WLZ_ERR_READ_EOF;
+	    errNum2D = WLZ_ERR_READ_EOF;
 	  }
-	  else
+#endif
+	  if(errNum2D == WLZ_ERR_NONE)
 	  {
-		    #ifdef _WIN32
-  if (fP2D != NULL){
-	if(_setmode(_fileno(fP2D), 0x8000) == -1)
-	{
-		errNum = WLZ_ERR_READ_EOF;
+	    errNum2D = WlzEffReadObjStackData2D(fP2D, fFmt, &secSz2D,
+						(data + planeOff));
+	  }
+	  (void )fclose(fP2D);
 	}
-  }
-  #endif
-	    errNum = WlzEffReadObjStackData2D(fP2D, fFmt, &imgSz2D,
-					      (data + planeOff));
-	    fclose(fP2D);
+      }
+      if(errNum2D != WLZ_ERR_NONE)
+      {
+#ifdef _OPENMP
+#pragma omp critical (WlzEffReadObjStack3D)
+#endif
+	{
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    errNum = errNum2D;
 	  }
 	}
       }
-      ++planeOff;
-      ++planeIdx;
     }
   }
   if(errNum == WLZ_ERR_NONE)
@@ -716,6 +776,18 @@ static WlzObject *WlzEffReadObjStack3D(const char *gvnFileName,
   {
     AlcFree(fCtrStr);
   }
+  if(secStr)
+  {
+    for(planeOff = 0; planeOff < header.volSize.vtZ; ++planeOff)
+    {
+      AlcFree(*(secStr + planeOff));
+    }
+    AlcFree(secStr);
+  }
+  if(fP)
+  {
+    (void )fclose(fP);
+  }
   if(dstErr)
   {
     *dstErr = errNum;
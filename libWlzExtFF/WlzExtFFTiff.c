@@ -46,8 +46,12 @@ static char _WlzExtFFTiff_c[] = "University of Edinburgh $Id$";
 #include <Wlz.h>
 #include <WlzExtFF.h>
 #include <tiffio.h>
+#if HAVE_ZLIB != 0
+#include <zlib.h>
+#endif /* HAVE_ZLIB */
 
 #define	CVT(x)		(((x) * 255) / ((1L<<16)-1))
+#define WLZEFF_TIFF_TILE_BATCH	(64)
 
 static WlzErrorNum setPixelProperties(
   short		bitspersample,
@@ -260,6 +264,20 @@ static unsigned char *WlzEFFTiffToWlzRowData(
 	  break;
 
 	case WLZ_GREY_FLOAT: /* FALLTHROUGH */
+	default:
+	  errNum = WLZ_ERR_FILE_FORMAT;
+	  break;
+	}
+	break;
+      case 32:
+	/* Decoded samples are in native byte order. */
+	switch( newpixtype ){
+	case WLZ_GREY_INT:
+	case WLZ_GREY_FLOAT:
+	  (void )memcpy(wlzData.inp, inp, width * 4);
+	  offset = width;
+	  break;
+
 	default:
 	  errNum = WLZ_ERR_FILE_FORMAT;
 	  break;
@@ -1000,3 +1018,611 @@ WlzErrorNum WlzEffWriteObjTiff(
   }
   return errNum;
 }
+
+/*!
+* \ingroup	WlzExtFF
+* \brief	Copies a single row segment of converted values into the
+* 		tiles of a 2D tiled values table.
+* \param	tVal			Given 2D tiled values.
+* \param	gSz			Size of a single grey value.
+* \param	ln			Line relative to the first line of
+* 					the tiled values.
+* \param	kl			First column relative to the first
+* 					column of the tiled values.
+* \param	len			Number of values in the row segment.
+* \param	rowBuf			Converted values of the row segment.
+*/
+static void	WlzEffTiffRowToTiles(
+  WlzTiledValues *tVal,
+  size_t	gSz,
+  int		ln,
+  int		kl,
+  int		len,
+  unsigned char	*rowBuf)
+{
+  int		kol;
+  size_t	li,
+  		lo;
+
+  li = (ln / tVal->tileWidth) * tVal->nIdx[0];
+  lo = (ln % tVal->tileWidth) * tVal->tileWidth;
+  kol = 0;
+  while(kol < len)
+  {
+    int		idx,
+    		itc,
+		to;
+
+    to = (kl + kol) % tVal->tileWidth;
+    itc = ALG_MIN(len - kol, (int )(tVal->tileWidth) - to);
+    idx = *(int *)(tVal->indices + li + ((kl + kol) / tVal->tileWidth));
+    if(idx >= 0)
+    {
+      (void )memcpy(tVal->tiles.ubp +
+                    (((idx * tVal->tileSz) + lo + to) * gSz),
+		    rowBuf + (kol * gSz), itc * gSz);
+    }
+    kol += itc;
+  }
+}
+
+/*!
+* \return	New 2D object with tiled values or NULL on error.
+* \ingroup	WlzExtFF
+* \brief	Reads the first image of the given TIFF file directly into
+* 		a 2D object with a tiled values table. The TIFF tiles
+* 		(or strips if the image is not tiled) are decoded
+* 		concurrently, with each thread using its own TIFF handle
+* 		and converting the rows of each decoded tile or strip
+* 		straight into the Woolz value tiles, so that no full
+* 		resolution intermediate image is required.
+* \param	tiffFileName		Given file name.
+* \param	tileSz			Number of values in each Woolz tile,
+* 					this must be an integral power of
+* 					four.
+* \param	dstErr			Destination error number ptr, may be
+* 					NULL.
+*/
+WlzObject	*WlzEffReadObjTiffTiled(
+  const char	*tiffFileName,
+  size_t	tileSz,
+  WlzErrorNum	*dstErr)
+{
+  int		i,
+  		width = 0,
+		height = 0,
+		unitWidth = 0,
+		unitHeight = 0,
+		nUnit = 0,
+		tiled = 0,
+		wlzDepth = 0;
+  unsigned short bitspersample = 0,
+		samplesperpixel = 0,
+		sampleformat = SAMPLEFORMAT_UINT,
+		photometric = 0,
+		planarconfig = PLANARCONFIG_CONTIG;
+  float		xPosition,
+  		yPosition;
+  unsigned char	red[256],
+  		green[256],
+		blue[256];
+  TIFF		*tif = NULL;
+  WlzGreyType	newpixtype = WLZ_GREY_ERROR;
+  WlzPixelV	bckgrnd;
+  WlzDomain	dom;
+  WlzValues	val;
+  WlzObject	*rObj = NULL,
+  		*tObj = NULL;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  dom.core = NULL;
+  val.core = NULL;
+  if((tiffFileName == NULL) || (*tiffFileName == '\0'))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if((tif = TIFFOpen(tiffFileName, "r")) == NULL)
+  {
+    errNum = WLZ_ERR_READ_EOF;
+  }
+  /* Establish the pixel properties, image size and layout. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    TIFFGetField(tif, TIFFTAG_BITSPERSAMPLE, &bitspersample);
+    TIFFGetField(tif, TIFFTAG_SAMPLESPERPIXEL, &samplesperpixel);
+    TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometric);
+    TIFFGetField(tif, TIFFTAG_PLANARCONFIG, &planarconfig);
+    if(TIFFGetField(tif, TIFFTAG_SAMPLEFORMAT, &sampleformat) == 0)
+    {
+      sampleformat = SAMPLEFORMAT_UINT;
+    }
+    if((bitspersample < 4) || (planarconfig != PLANARCONFIG_CONTIG))
+    {
+      errNum = WLZ_ERR_IMAGE_TYPE;
+    }
+    else
+    {
+      errNum = setPixelProperties(bitspersample, samplesperpixel,
+      				  sampleformat, &wlzDepth, &newpixtype,
+				  &bckgrnd);
+    }
+  }
+  if((errNum == WLZ_ERR_NONE) && (photometric == PHOTOMETRIC_PALETTE))
+  {
+    unsigned short *rMap,
+    		*gMap,
+		*bMap;
+
+    (void )memset(red, 0, sizeof(red));
+    (void )memset(green, 0, sizeof(green));
+    (void )memset(blue, 0, sizeof(blue));
+    if(TIFFGetField(tif, TIFFTAG_COLORMAP, &rMap, &gMap, &bMap) == 0)
+    {
+      errNum = WLZ_ERR_IMAGE_TYPE;
+    }
+    else
+    {
+      for(i = 0; (i < 256) && (i < (1 << bitspersample)); ++i)
+      {
+	red[i] = (unsigned char )CVT(rMap[i]);
+	green[i] = (unsigned char )CVT(gMap[i]);
+	blue[i] = (unsigned char )CVT(bMap[i]);
+	if((red[i] != green[i]) || (red[i] != blue[i]))
+	{
+	  wlzDepth = sizeof(int);
+	  newpixtype = WLZ_GREY_RGBA;
+	}
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &width);
+    TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &height);
+    if(TIFFGetField(tif, TIFFTAG_XPOSITION, &xPosition) != 1)
+    {
+      xPosition = 0.0;
+    }
+    if(TIFFGetField(tif, TIFFTAG_YPOSITION, &yPosition) != 1)
+    {
+      yPosition = 0.0;
+    }
+    if((width <= 0) || (height <= 0))
+    {
+      errNum = WLZ_ERR_FILE_FORMAT;
+    }
+    else if((tiled = TIFFIsTiled(tif)) != 0)
+    {
+      TIFFGetField(tif, TIFFTAG_TILEWIDTH, &unitWidth);
+      TIFFGetField(tif, TIFFTAG_TILELENGTH, &unitHeight);
+      nUnit = TIFFNumberOfTiles(tif);
+    }
+    else
+    {
+      unitWidth = width;
+      if((TIFFGetField(tif, TIFFTAG_ROWSPERSTRIP, &unitHeight) == 0) ||
+         (unitHeight > height))
+      {
+        unitHeight = height;
+      }
+      nUnit = TIFFNumberOfStrips(tif);
+    }
+    if((unitWidth <= 0) || (unitHeight <= 0) || (nUnit <= 0))
+    {
+      errNum = WLZ_ERR_FILE_FORMAT;
+    }
+  }
+  /* Create a rectangular object with tiled values for the image. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		line1,
+    		kol1;
+
+    kol1 = WLZ_NINT(xPosition);
+    line1 = WLZ_NINT(yPosition);
+    dom.i = WlzMakeIntervalDomain(WLZ_INTERVALDOMAIN_RECT,
+    				  line1, line1 + height - 1,
+				  kol1, kol1 + width - 1, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    rObj = WlzMakeMain(WLZ_2D_DOMAINOBJ, dom, val, NULL, NULL, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    tObj = WlzMakeTiledValuesFromObj(rObj, tileSz, 0, newpixtype, bckgrnd,
+    				     &errNum);
+  }
+  (void )WlzFreeObj(rObj);
+  if(tif)
+  {
+    TIFFClose(tif);
+  }
+  /* Decode the TIFF tiles or strips concurrently, one TIFF handle per
+   * thread, converting each row into the Woolz tiles. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    WlzTiledValues *tVal;
+
+    tVal = tObj->values.t;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      int	idU;
+      tsize_t	bufSz = 0,
+      		rowSz = 0;
+      TIFF	*tifT = NULL;
+      unsigned char *buf = NULL,
+		*rowBuf = NULL;
+      WlzErrorNum errNumT = WLZ_ERR_NONE;
+
+      if((tifT = TIFFOpen(tiffFileName, "r")) == NULL)
+      {
+        errNumT = WLZ_ERR_READ_EOF;
+      }
+      else
+      {
+	bufSz = (tiled)? TIFFTileSize(tifT): TIFFStripSize(tifT);
+	rowSz = (tiled)? TIFFTileRowSize(tifT): TIFFScanlineSize(tifT);
+	if(((buf = (unsigned char *)AlcMalloc(bufSz)) == NULL) ||
+	   ((rowBuf = (unsigned char *)AlcMalloc(unitWidth *
+	                                         wlzDepth)) == NULL))
+	{
+	  errNumT = WLZ_ERR_MEM_ALLOC;
+	}
+      }
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+      for(idU = 0; idU < nUnit; ++idU)
+      {
+	if(errNumT == WLZ_ERR_NONE)
+	{
+	  int	col,
+	  	row,
+		len,
+		y,
+		yMax;
+
+	  if(tiled)
+	  {
+	    int	nTX;
+
+	    nTX = (width + unitWidth - 1) / unitWidth;
+	    col = (idU % nTX) * unitWidth;
+	    row = (idU / nTX) * unitHeight;
+	    if(TIFFReadEncodedTile(tifT, idU, buf, bufSz) < 0)
+	    {
+	      errNumT = WLZ_ERR_READ_INCOMPLETE;
+	    }
+	  }
+	  else
+	  {
+	    col = 0;
+	    row = idU * unitHeight;
+	    if(TIFFReadEncodedStrip(tifT, idU, buf, bufSz) < 0)
+	    {
+	      errNumT = WLZ_ERR_READ_INCOMPLETE;
+	    }
+	  }
+	  len = ALG_MIN(unitWidth, width - col);
+	  yMax = ALG_MIN(row + unitHeight, height);
+	  for(y = row; (errNumT == WLZ_ERR_NONE) && (y < yMax); ++y)
+	  {
+	    (void )WlzEFFTiffToWlzRowData(buf + (rowSz * (y - row)), rowBuf,
+	    				  len, photometric, samplesperpixel,
+					  bitspersample, newpixtype,
+					  red, green, blue, &errNumT);
+	    if(errNumT == WLZ_ERR_NONE)
+	    {
+	      WlzEffTiffRowToTiles(tVal, wlzDepth, y, col, len, rowBuf);
+	    }
+	  }
+	}
+      }
+      AlcFree(buf);
+      AlcFree(rowBuf);
+      if(tifT)
+      {
+	TIFFClose(tifT);
+      }
+      if(errNumT != WLZ_ERR_NONE)
+      {
+#ifdef _OPENMP
+#pragma omp critical (WlzEffReadObjTiffTiled)
+#endif
+	{
+	  if(errNum == WLZ_ERR_NONE)
+	  {
+	    errNum = errNumT;
+	  }
+	}
+      }
+    }
+  }
+  if((errNum != WLZ_ERR_NONE) && (tObj != NULL))
+  {
+    (void )WlzFreeObj(tObj);
+    tObj = NULL;
+  }
+  if(dstErr)
+  {
+    *dstErr = errNum;
+  }
+  return(tObj);
+}
+
+/*!
+* \return	Woolz error number.
+* \ingroup	WlzExtFF
+* \brief	Writes the given 2D Woolz object to a tiled TIFF file.
+* 		The object may have any values table for which the grey
+* 		values can be cut to a rectangle (eg rectangular or tiled
+* 		values). The TIFF tiles are cut from the object and (if
+* 		zlib is available) deflate compressed concurrently, in
+* 		batches to bound the memory used, with the encoded tiles
+* 		then written in order.
+* \param	tiffFileName		Given file name with .tif.
+* \param	obj			Given 2D woolz object.
+* \param	tileWidth		Width and height of the TIFF tiles
+* 					which must be a positive multiple
+* 					of 16.
+* \param	bigTiff			Non zero for a BigTIFF file which
+* 					is required if the encoded image
+* 					may exceed 4GB.
+*/
+WlzErrorNum	WlzEffWriteObjTiffTiled(
+  const char	*tiffFileName,
+  WlzObject	*obj,
+  int		tileWidth,
+  int		bigTiff)
+{
+  int		bps = 0,
+  		spp = 1,
+		width = 0,
+		height = 0,
+		nTX = 0,
+		nTiles = 0;
+  unsigned short fmt = SAMPLEFORMAT_UINT,
+  		pht = PHOTOMETRIC_MINISBLACK;
+  size_t	gSz = 0,
+  		tSz = 0,
+		cSz = 0;
+  size_t	encSz[WLZEFF_TIFF_TILE_BATCH];
+  unsigned char	*rawBuf[WLZEFF_TIFF_TILE_BATCH],
+  		*encBuf[WLZEFF_TIFF_TILE_BATCH];
+  TIFF		*out = NULL;
+  WlzIBox2	bBox;
+  WlzGreyType	gType = WLZ_GREY_ERROR;
+  WlzErrorNum	errNum = WLZ_ERR_NONE;
+
+  (void )memset(rawBuf, 0, WLZEFF_TIFF_TILE_BATCH * sizeof(unsigned char *));
+  (void )memset(encBuf, 0, WLZEFF_TIFF_TILE_BATCH * sizeof(unsigned char *));
+  if((tiffFileName == NULL) || (*tiffFileName == '\0'))
+  {
+    errNum = WLZ_ERR_PARAM_NULL;
+  }
+  else if(obj == NULL)
+  {
+    errNum = WLZ_ERR_OBJECT_NULL;
+  }
+  else if(obj->type != WLZ_2D_DOMAINOBJ)
+  {
+    errNum = WLZ_ERR_OBJECT_TYPE;
+  }
+  else if(obj->domain.core == NULL)
+  {
+    errNum = WLZ_ERR_DOMAIN_NULL;
+  }
+  else if(obj->values.core == NULL)
+  {
+    errNum = WLZ_ERR_VALUES_NULL;
+  }
+  else if((tileWidth <= 0) || ((tileWidth % 16) != 0))
+  {
+    errNum = WLZ_ERR_PARAM_DATA;
+  }
+  else
+  {
+    gType = WlzGreyTypeFromObj(obj, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    switch(gType)
+    {
+      case WLZ_GREY_UBYTE:
+        bps = 8;
+	break;
+      case WLZ_GREY_SHORT:
+        bps = 16;
+	fmt = SAMPLEFORMAT_INT;
+	break;
+      case WLZ_GREY_INT:
+        bps = 32;
+	fmt = SAMPLEFORMAT_INT;
+	break;
+      case WLZ_GREY_FLOAT:
+        bps = 32;
+	fmt = SAMPLEFORMAT_IEEEFP;
+	break;
+      case WLZ_GREY_RGBA:
+        bps = 8;
+	spp = 4;
+	pht = PHOTOMETRIC_RGB;
+	break;
+      default:
+        errNum = WLZ_ERR_FILE_FORMAT;
+	break;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    gSz = WlzGreySize(gType);
+    bBox = WlzBoundingBox2I(obj, &errNum);
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		idB;
+
+    width = bBox.xMax - bBox.xMin + 1;
+    height = bBox.yMax - bBox.yMin + 1;
+    nTX = (width + tileWidth - 1) / tileWidth;
+    nTiles = nTX * ((height + tileWidth - 1) / tileWidth);
+    tSz = tileWidth * tileWidth * gSz;
+#if HAVE_ZLIB != 0
+    cSz = compressBound(tSz);
+#else /* HAVE_ZLIB */
+    cSz = 0;
+#endif /* HAVE_ZLIB */
+    for(idB = 0; idB < WLZEFF_TIFF_TILE_BATCH; ++idB)
+    {
+      if(((rawBuf[idB] = (unsigned char *)AlcMalloc(tSz)) == NULL) ||
+         ((cSz > 0) &&
+	  ((encBuf[idB] = (unsigned char *)AlcMalloc(cSz)) == NULL)))
+      {
+        errNum = WLZ_ERR_MEM_ALLOC;
+	break;
+      }
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    if((out = TIFFOpen(tiffFileName, (bigTiff)? "w8": "w")) == NULL)
+    {
+      errNum = WLZ_ERR_FILE_OPEN;
+    }
+  }
+  if(errNum == WLZ_ERR_NONE)
+  {
+    TIFFSetField(out, TIFFTAG_IMAGEWIDTH, (uint32 )width);
+    TIFFSetField(out, TIFFTAG_IMAGELENGTH, (uint32 )height);
+    TIFFSetField(out, TIFFTAG_TILEWIDTH, (uint32 )tileWidth);
+    TIFFSetField(out, TIFFTAG_TILELENGTH, (uint32 )tileWidth);
+    TIFFSetField(out, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
+    TIFFSetField(out, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+    TIFFSetField(out, TIFFTAG_PHOTOMETRIC, pht);
+    TIFFSetField(out, TIFFTAG_SAMPLESPERPIXEL, spp);
+    TIFFSetField(out, TIFFTAG_BITSPERSAMPLE, bps);
+    TIFFSetField(out, TIFFTAG_SAMPLEFORMAT, fmt);
+    if(spp == 4)
+    {
+      unsigned short extra = EXTRASAMPLE_UNASSALPHA;
+
+      TIFFSetField(out, TIFFTAG_EXTRASAMPLES, 1, &extra);
+    }
+    TIFFSetField(out, TIFFTAG_XPOSITION, (float )WLZ_MAX(bBox.xMin, 0));
+    TIFFSetField(out, TIFFTAG_YPOSITION, (float )WLZ_MAX(bBox.yMin, 0));
+    TIFFSetField(out, TIFFTAG_XRESOLUTION, 1.0f);
+    TIFFSetField(out, TIFFTAG_YRESOLUTION, 1.0f);
+#if HAVE_ZLIB != 0
+    TIFFSetField(out, TIFFTAG_COMPRESSION, COMPRESSION_ADOBE_DEFLATE);
+#else /* HAVE_ZLIB */
+    TIFFSetField(out, TIFFTAG_COMPRESSION, COMPRESSION_NONE);
+#endif /* HAVE_ZLIB */
+  }
+  /* Cut and encode the tiles in batches concurrently, then write the
+   * encoded tiles of each batch in order. */
+  if(errNum == WLZ_ERR_NONE)
+  {
+    int		t0;
+
+    for(t0 = 0; (errNum == WLZ_ERR_NONE) && (t0 < nTiles);
+        t0 += WLZEFF_TIFF_TILE_BATCH)
+    {
+      int	idB,
+      		nB;
+
+      nB = ALG_MIN(WLZEFF_TIFF_TILE_BATCH, nTiles - t0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+      for(idB = 0; idB < nB; ++idB)
+      {
+	int	t;
+	WlzIBox2 cutBox;
+	WlzObject *cObj;
+	WlzErrorNum errNumT = WLZ_ERR_NONE;
+
+	t = t0 + idB;
+	cutBox.xMin = bBox.xMin + ((t % nTX) * tileWidth);
+	cutBox.yMin = bBox.yMin + ((t / nTX) * tileWidth);
+	cutBox.xMax = cutBox.xMin + tileWidth - 1;
+	cutBox.yMax = cutBox.yMin + tileWidth - 1;
+	cObj = WlzCutObjToValBox2D(obj, cutBox, gType, rawBuf[idB],
+				   0, 0.0, 0.0, &errNumT);
+	(void )WlzFreeObj(cObj);
+	if((errNumT == WLZ_ERR_NONE) && (gType == WLZ_GREY_RGBA))
+	{
+	  size_t  i;
+	  WlzUInt *rgbp;
+
+	  /* Write the RGBA components in byte order R, G, B, A. */
+	  rgbp = (WlzUInt *)(rawBuf[idB]);
+	  for(i = 0; i < tileWidth * tileWidth; ++i)
+	  {
+	    WlzUInt	v;
+
+	    v = rgbp[i];
+	    rawBuf[idB][4 * i] = WLZ_RGBA_RED_GET(v);
+	    rawBuf[idB][4 * i + 1] = WLZ_RGBA_GREEN_GET(v);
+	    rawBuf[idB][4 * i + 2] = WLZ_RGBA_BLUE_GET(v);
+	    rawBuf[idB][4 * i + 3] = WLZ_RGBA_ALPHA_GET(v);
+	  }
+	}
+#if HAVE_ZLIB != 0
+	if(errNumT == WLZ_ERR_NONE)
+	{
+	  uLongf  len;
+
+	  len = cSz;
+	  if(compress2(encBuf[idB], &len, rawBuf[idB], tSz,
+		       Z_DEFAULT_COMPRESSION) != Z_OK)
+	  {
+	    errNumT = WLZ_ERR_WRITE_INCOMPLETE;
+	  }
+	  encSz[idB] = len;
+	}
+#else /* HAVE_ZLIB */
+	encSz[idB] = tSz;
+#endif /* HAVE_ZLIB */
+	if(errNumT != WLZ_ERR_NONE)
+	{
+#ifdef _OPENMP
+#pragma omp critical (WlzEffWriteObjTiffTiled)
+#endif
+	  {
+	    if(errNum == WLZ_ERR_NONE)
+	    {
+	      errNum = errNumT;
+	    }
+	  }
+	}
+      }
+      for(idB = 0; (errNum == WLZ_ERR_NONE) && (idB < nB); ++idB)
+      {
+	unsigned char *enc;
+
+	enc = (cSz > 0)? encBuf[idB]: rawBuf[idB];
+        if(TIFFWriteRawTile(out, t0 + idB, enc, encSz[idB]) < 0)
+	{
+	  errNum = WLZ_ERR_WRITE_INCOMPLETE;
+	}
+      }
+    }
+  }
+  if(out)
+  {
+    TIFFClose(out);
+  }
+  {
+    int		idB;
+
+    for(idB = 0; idB < WLZEFF_TIFF_TILE_BATCH; ++idB)
+    {
+      AlcFree(rawBuf[idB]);
+      AlcFree(encBuf[idB]);
+    }
+  }
+  return(errNum);
+}